@@ -0,0 +1,122 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * AsyncLogDestination.cpp
+ * A LogDestination that writes from a background thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/base/AsyncLogDestination.h"
+
+namespace ola {
+
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+const unsigned int AsyncLogDestination::DEFAULT_MAX_QUEUED_LINES;
+
+AsyncLogDestination::AsyncLogDestination(LogDestination *destination,
+                                         unsigned int max_queued_lines)
+    : Thread(Thread::Options("ola-log")),
+      m_destination(destination),
+      m_max_queued_lines(max_queued_lines),
+      m_running(false),
+      m_queued(0),
+      m_dropped(0),
+      m_stop(false) {
+}
+
+AsyncLogDestination::~AsyncLogDestination() {
+  if (m_running) {
+    {
+      MutexLocker lock(&m_mutex);
+      m_stop = true;
+      m_condition.Signal();
+    }
+    Join();
+  }
+  vector<QueuedLine*> lines;
+  WriteQueuedLines(&lines);
+  delete m_destination;
+}
+
+bool AsyncLogDestination::Init() {
+  m_running = Start();
+  return m_running;
+}
+
+void AsyncLogDestination::Write(log_level level, const string &log_line) {
+  if (!m_running || level == OLA_LOG_FATAL) {
+    m_destination->Write(level, log_line);
+    return;
+  }
+
+  if (__atomic_add_fetch(&m_queued, 1, __ATOMIC_RELAXED) >
+      m_max_queued_lines) {
+    __atomic_sub_fetch(&m_queued, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&m_dropped, 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  // Only wake the thread for the first line of a batch.
+  if (m_queue.Push(new QueuedLine(level, log_line))) {
+    MutexLocker lock(&m_mutex);
+    m_condition.Signal();
+  }
+}
+
+void *AsyncLogDestination::Run() {
+  vector<QueuedLine*> lines;
+  while (true) {
+    {
+      MutexLocker lock(&m_mutex);
+      while (m_queue.Empty() && !m_stop) {
+        m_condition.Wait(&m_mutex);
+      }
+      if (m_stop) {
+        // The destructor writes anything that's left.
+        break;
+      }
+    }
+    WriteQueuedLines(&lines);
+  }
+  return NULL;
+}
+
+void AsyncLogDestination::WriteQueuedLines(vector<QueuedLine*> *lines) {
+  lines->clear();
+  unsigned int count = m_queue.PopAll(lines);
+  __atomic_sub_fetch(&m_queued, count, __ATOMIC_RELAXED);
+
+  vector<QueuedLine*>::iterator iter = lines->begin();
+  for (; iter != lines->end(); ++iter) {
+    m_destination->Write((*iter)->level, (*iter)->line);
+    delete *iter;
+  }
+
+  unsigned int dropped = __atomic_exchange_n(&m_dropped, 0, __ATOMIC_RELAXED);
+  if (dropped) {
+    std::ostringstream str;
+    str << "AsyncLogDestination: " << dropped
+        << " log messages were dropped\n";
+    m_destination->Write(OLA_LOG_WARN, str.str());
+  }
+}
+}  // namespace ola
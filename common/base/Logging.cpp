@@ -41,13 +41,19 @@
 
 #include <iostream>
 #include <string>
+#include "ola/Clock.h"
 #include "ola/Logging.h"
+#include "ola/base/AsyncLogDestination.h"
 #include "ola/base/Flags.h"
 
 /**@private*/
 DEFINE_s_int8(log_level, l, ola::OLA_LOG_WARN, "Set the logging level 0 .. 4.");
 /**@private*/
 DEFINE_default_bool(syslog, false, "Send to syslog rather than stderr.");
+/**@private*/
+DEFINE_default_bool(async_log, false,
+                    "Write the log from a background thread, so slow log "
+                    "writes don't block the caller.");
 
 namespace ola {
 
@@ -110,7 +116,17 @@ bool InitLoggingFromFlags() {
       break;
   }
 
-  return InitLogging(log_level, output);
+  if (!InitLogging(log_level, output)) {
+    return false;
+  }
+
+  if (FLAGS_async_log && log_target) {
+    AsyncLogDestination *async_target = new AsyncLogDestination(log_target);
+    // If the thread can't be started, it writes synchronously.
+    async_target->Init();
+    log_target = async_target;
+  }
+  return true;
 }
 
 
@@ -149,9 +165,11 @@ void InitLogging(log_level level, LogDestination *destination) {
 /**@cond HIDDEN_SYMBOLS*/
 LogLine::LogLine(const char *file,
                  int line,
-                 log_level level):
+                 log_level level,
+                 unsigned int suppressed):
   m_level(level),
-  m_stream(ostringstream::out) {
+  m_stream(ostringstream::out),
+  m_suppressed(suppressed) {
     m_stream << file << ":" << line << ": ";
     m_prefix_length = m_stream.str().length();
 }
@@ -169,12 +187,45 @@ void LogLine::Write() {
 
   string line = m_stream.str();
 
-  if (line.at(line.length() - 1) != '\n')
-    line.append("\n");
+  if (line.at(line.length() - 1) == '\n')
+    line.resize(line.length() - 1);
+  if (m_suppressed) {
+    ostringstream suffix;
+    suffix << " (" << m_suppressed << " similar messages suppressed)";
+    line.append(suffix.str());
+  }
+  line.append("\n");
 
   if (log_target)
     log_target->Write(m_level, line);
 }
+
+
+LogRateLimiter::LogRateLimiter(unsigned int interval, Clock *clock)
+    : m_interval(interval),
+      m_clock(clock),
+      m_next_allowed(0),
+      m_suppressed(0),
+      m_last_suppressed(0) {
+}
+
+bool LogRateLimiter::Allow() {
+  TimeStamp now;
+  if (m_clock) {
+    m_clock->CurrentTime(&now);
+  } else {
+    Clock().CurrentTime(&now);
+  }
+
+  if (now.Seconds() < m_next_allowed) {
+    m_suppressed++;
+    return false;
+  }
+  m_last_suppressed = m_suppressed;
+  m_suppressed = 0;
+  m_next_allowed = now.Seconds() + m_interval;
+  return true;
+}
 /**@endcond*/
 
 /**
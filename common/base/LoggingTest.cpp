@@ -24,25 +24,52 @@
 #include <utility>
 #include <vector>
 
+#include "ola/Clock.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/base/AsyncLogDestination.h"
+#include "ola/strings/Format.h"
 #include "ola/testing/TestUtils.h"
 
 
 using std::deque;
 using std::vector;
 using std::string;
+using ola::AsyncLogDestination;
 using ola::IncrementLogLevel;
 using ola::log_level;
+using ola::strings::IntToString;
 
 
 class LoggingTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(LoggingTest);
   CPPUNIT_TEST(testLogging);
+  CPPUNIT_TEST(testRateLimiter);
+  CPPUNIT_TEST(testRateLimitedMacro);
+  CPPUNIT_TEST(testAsyncLogDestination);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testLogging();
+    void testRateLimiter();
+    void testRateLimitedMacro();
+    void testAsyncLogDestination();
+};
+
+
+/*
+ * Records the lines written, the lines are owned by the caller so they can
+ * be checked after the destination is deleted.
+ */
+class RecordingLogDestination: public ola::LogDestination {
+ public:
+    explicit RecordingLogDestination(vector<string> *lines)
+        : m_lines(lines) {}
+    void Write(log_level, const string &log_line) {
+      m_lines->push_back(log_line);
+    }
+ private:
+    vector<string> *m_lines;
 };
 
 
@@ -125,3 +152,70 @@ void LoggingTest::testLogging() {
   OLA_FATAL << "fatal";
   OLA_ASSERT_EQ(destination->LinesRemaining(), 0);
 }
+
+
+/*
+ * Check the LogRateLimiter.
+ */
+void LoggingTest::testRateLimiter() {
+  ola::MockClock clock;
+  ola::LogRateLimiter limiter(10, &clock);
+  OLA_ASSERT_TRUE(limiter.Allow());
+  OLA_ASSERT_EQ(0u, limiter.Suppressed());
+  OLA_ASSERT_FALSE(limiter.Allow());
+  OLA_ASSERT_FALSE(limiter.Allow());
+
+  clock.AdvanceTime(9, 0);
+  OLA_ASSERT_FALSE(limiter.Allow());
+
+  clock.AdvanceTime(1, 0);
+  OLA_ASSERT_TRUE(limiter.Allow());
+  OLA_ASSERT_EQ(3u, limiter.Suppressed());
+  OLA_ASSERT_FALSE(limiter.Allow());
+}
+
+
+/*
+ * Check that OLA_LOG_RATE_LIMITED logs once per call site.
+ */
+void LoggingTest::testRateLimitedMacro() {
+  vector<string> lines;
+  InitLogging(ola::OLA_LOG_WARN, new RecordingLogDestination(&lines));
+  for (unsigned int i = 0; i < 5; i++) {
+    OLA_LOG_RATE_LIMITED(ola::OLA_LOG_WARN, 3600) << "burst " << i;
+    OLA_LOG_RATE_LIMITED(ola::OLA_LOG_INFO, 3600) << "not logged";
+  }
+  OLA_LOG_RATE_LIMITED(ola::OLA_LOG_WARN, 3600) << "other site";
+  InitLogging(ola::OLA_LOG_WARN, NULL);
+
+  OLA_ASSERT_EQ(static_cast<size_t>(2), lines.size());
+  OLA_ASSERT_TRUE(ola::StringEndsWith(lines[0], ": burst 0\n"));
+  OLA_ASSERT_TRUE(ola::StringEndsWith(lines[1], ": other site\n"));
+}
+
+
+/*
+ * Check that the AsyncLogDestination writes every line, in order.
+ */
+void LoggingTest::testAsyncLogDestination() {
+  vector<string> lines;
+  AsyncLogDestination *destination = new AsyncLogDestination(
+      new RecordingLogDestination(&lines));
+  OLA_ASSERT_TRUE(destination->Init());
+  for (unsigned int i = 0; i < 100; i++) {
+    destination->Write(ola::OLA_LOG_WARN, IntToString(i) + "\n");
+  }
+  delete destination;
+
+  OLA_ASSERT_EQ(static_cast<size_t>(100), lines.size());
+  for (unsigned int i = 0; i < 100; i++) {
+    OLA_ASSERT_EQ(IntToString(i) + "\n", lines[i]);
+  }
+
+  // Until Init() is called, lines are written straight away.
+  lines.clear();
+  destination = new AsyncLogDestination(new RecordingLogDestination(&lines));
+  destination->Write(ola::OLA_LOG_WARN, "sync\n");
+  OLA_ASSERT_EQ(static_cast<size_t>(1), lines.size());
+  delete destination;
+}
@@ -0,0 +1,407 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTPMerge.cpp
+ * Vectorized HTP & per-slot priority merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * Each kernel walks the destination a vector at a time, loading it once and
+ * then taking the max with every source that covers the whole vector. The
+ * slots at the end of the shorter sources are then merged one at a time.
+ *
+ * The per-slot priority kernels compute masks for the slots where the source
+ * priority is higher than, or equal to, the current priority and then select
+ * between the source value, the HTP value and the current value.
+ *
+ * The SSE2 & NEON kernels are selected at compile time, since they are part of
+ * the base x86-64 and AArch64 instruction sets. The AVX2 kernel is built with
+ * a function level target attribute and only used if the CPU supports it.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+
+#include "common/dmx/HTPMerge.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define OLA_HTP_MERGE_SSE2 1
+#include <emmintrin.h>
+#endif  // x86 && __SSE2__
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+     (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define OLA_HTP_MERGE_AVX2 1
+#include <immintrin.h>
+#endif  // x86 && (clang || gcc >= 4.9)
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_HTP_MERGE_NEON 1
+#include <arm_neon.h>
+#endif  // __ARM_NEON
+
+namespace ola {
+namespace dmx {
+
+namespace {
+
+/*
+ * Merge the slots that weren't handled by the vector loop. The vector loop
+ * covers [0, (length / width) * width) for each source.
+ */
+inline void MergeTails(uint8_t *dest,
+                       const uint8_t *const *sources,
+                       const unsigned int *lengths,
+                       unsigned int count,
+                       unsigned int width) {
+  for (unsigned int i = 0; i < count; i++) {
+    const uint8_t *source = sources[i];
+    for (unsigned int j = (lengths[i] / width) * width; j < lengths[i]; j++) {
+      dest[j] = std::max(dest[j], source[j]);
+    }
+  }
+}
+
+inline unsigned int MaxLength(const unsigned int *lengths,
+                              unsigned int count) {
+  unsigned int max_length = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    max_length = std::max(max_length, lengths[i]);
+  }
+  return max_length;
+}
+
+void ScalarMerge(uint8_t *dest,
+                 const uint8_t *const *sources,
+                 const unsigned int *lengths,
+                 unsigned int count) {
+  for (unsigned int i = 0; i < count; i++) {
+    const uint8_t *source = sources[i];
+    for (unsigned int j = 0; j < lengths[i]; j++) {
+      dest[j] = std::max(dest[j], source[j]);
+    }
+  }
+}
+
+void ScalarSlotPriorityMerge(uint8_t *dest,
+                             uint8_t *dest_priorities,
+                             const uint8_t *source,
+                             const uint8_t *source_priorities,
+                             unsigned int length) {
+  for (unsigned int i = 0; i < length; i++) {
+    if (source_priorities[i] > dest_priorities[i]) {
+      dest[i] = source[i];
+      dest_priorities[i] = source_priorities[i];
+    } else if (source_priorities[i] &&
+               source_priorities[i] == dest_priorities[i]) {
+      dest[i] = std::max(dest[i], source[i]);
+    }
+  }
+}
+
+#ifdef OLA_HTP_MERGE_SSE2
+void SSE2Merge(uint8_t *dest,
+               const uint8_t *const *sources,
+               const unsigned int *lengths,
+               unsigned int count) {
+  static const unsigned int WIDTH = 16;
+  const unsigned int max_length = MaxLength(lengths, count);
+  for (unsigned int offset = 0; offset + WIDTH <= max_length;
+       offset += WIDTH) {
+    __m128i merged = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(dest + offset));
+    for (unsigned int i = 0; i < count; i++) {
+      if (lengths[i] >= offset + WIDTH) {
+        merged = _mm_max_epu8(
+            merged,
+            _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(sources[i] + offset)));
+      }
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset), merged);
+  }
+  MergeTails(dest, sources, lengths, count, WIDTH);
+}
+
+void SSE2SlotPriorityMerge(uint8_t *dest,
+                           uint8_t *dest_priorities,
+                           const uint8_t *source,
+                           const uint8_t *source_priorities,
+                           unsigned int length) {
+  static const unsigned int WIDTH = 16;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_cmpeq_epi8(zero, zero);
+  unsigned int offset = 0;
+  for (; offset + WIDTH <= length; offset += WIDTH) {
+    __m128i *dest_ptr = reinterpret_cast<__m128i*>(dest + offset);
+    __m128i *dest_priority_ptr = reinterpret_cast<__m128i*>(
+        dest_priorities + offset);
+    __m128i current = _mm_loadu_si128(dest_ptr);
+    __m128i current_priority = _mm_loadu_si128(dest_priority_ptr);
+    __m128i value = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(source + offset));
+    __m128i priority = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(source_priorities + offset));
+
+    __m128i max_priority = _mm_max_epu8(priority, current_priority);
+    __m128i higher = _mm_xor_si128(
+        _mm_cmpeq_epi8(max_priority, current_priority), ones);
+    __m128i equal = _mm_andnot_si128(_mm_cmpeq_epi8(priority, zero),
+                                     _mm_cmpeq_epi8(priority,
+                                                    current_priority));
+
+    __m128i merged = _mm_or_si128(
+        _mm_and_si128(equal, _mm_max_epu8(current, value)),
+        _mm_andnot_si128(equal, current));
+    merged = _mm_or_si128(_mm_and_si128(higher, value),
+                          _mm_andnot_si128(higher, merged));
+    _mm_storeu_si128(dest_ptr, merged);
+    _mm_storeu_si128(dest_priority_ptr, max_priority);
+  }
+  ScalarSlotPriorityMerge(dest + offset, dest_priorities + offset,
+                          source + offset, source_priorities + offset,
+                          length - offset);
+}
+#endif  // OLA_HTP_MERGE_SSE2
+
+#ifdef OLA_HTP_MERGE_AVX2
+__attribute__((target("avx2")))
+void AVX2Merge(uint8_t *dest,
+               const uint8_t *const *sources,
+               const unsigned int *lengths,
+               unsigned int count) {
+  static const unsigned int WIDTH = 32;
+  const unsigned int max_length = MaxLength(lengths, count);
+  for (unsigned int offset = 0; offset + WIDTH <= max_length;
+       offset += WIDTH) {
+    __m256i merged = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(dest + offset));
+    for (unsigned int i = 0; i < count; i++) {
+      if (lengths[i] >= offset + WIDTH) {
+        merged = _mm256_max_epu8(
+            merged,
+            _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(sources[i] + offset)));
+      }
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + offset), merged);
+  }
+  MergeTails(dest, sources, lengths, count, WIDTH);
+}
+
+__attribute__((target("avx2")))
+void AVX2SlotPriorityMerge(uint8_t *dest,
+                           uint8_t *dest_priorities,
+                           const uint8_t *source,
+                           const uint8_t *source_priorities,
+                           unsigned int length) {
+  static const unsigned int WIDTH = 32;
+  const __m256i zero = _mm256_setzero_si256();
+  unsigned int offset = 0;
+  for (; offset + WIDTH <= length; offset += WIDTH) {
+    __m256i *dest_ptr = reinterpret_cast<__m256i*>(dest + offset);
+    __m256i *dest_priority_ptr = reinterpret_cast<__m256i*>(
+        dest_priorities + offset);
+    __m256i current = _mm256_loadu_si256(dest_ptr);
+    __m256i current_priority = _mm256_loadu_si256(dest_priority_ptr);
+    __m256i value = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(source + offset));
+    __m256i priority = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(source_priorities + offset));
+
+    __m256i max_priority = _mm256_max_epu8(priority, current_priority);
+    __m256i not_higher = _mm256_cmpeq_epi8(max_priority, current_priority);
+    __m256i equal = _mm256_andnot_si256(_mm256_cmpeq_epi8(priority, zero),
+                                        _mm256_cmpeq_epi8(priority,
+                                                          current_priority));
+
+    __m256i merged = _mm256_blendv_epi8(
+        current, _mm256_max_epu8(current, value), equal);
+    merged = _mm256_blendv_epi8(value, merged, not_higher);
+    _mm256_storeu_si256(dest_ptr, merged);
+    _mm256_storeu_si256(dest_priority_ptr, max_priority);
+  }
+  ScalarSlotPriorityMerge(dest + offset, dest_priorities + offset,
+                          source + offset, source_priorities + offset,
+                          length - offset);
+}
+
+bool CPUSupportsAVX2() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+#endif  // OLA_HTP_MERGE_AVX2
+
+#ifdef OLA_HTP_MERGE_NEON
+void NEONMerge(uint8_t *dest,
+               const uint8_t *const *sources,
+               const unsigned int *lengths,
+               unsigned int count) {
+  static const unsigned int WIDTH = 16;
+  const unsigned int max_length = MaxLength(lengths, count);
+  for (unsigned int offset = 0; offset + WIDTH <= max_length;
+       offset += WIDTH) {
+    uint8x16_t merged = vld1q_u8(dest + offset);
+    for (unsigned int i = 0; i < count; i++) {
+      if (lengths[i] >= offset + WIDTH) {
+        merged = vmaxq_u8(merged, vld1q_u8(sources[i] + offset));
+      }
+    }
+    vst1q_u8(dest + offset, merged);
+  }
+  MergeTails(dest, sources, lengths, count, WIDTH);
+}
+
+void NEONSlotPriorityMerge(uint8_t *dest,
+                           uint8_t *dest_priorities,
+                           const uint8_t *source,
+                           const uint8_t *source_priorities,
+                           unsigned int length) {
+  static const unsigned int WIDTH = 16;
+  unsigned int offset = 0;
+  for (; offset + WIDTH <= length; offset += WIDTH) {
+    uint8x16_t current = vld1q_u8(dest + offset);
+    uint8x16_t current_priority = vld1q_u8(dest_priorities + offset);
+    uint8x16_t value = vld1q_u8(source + offset);
+    uint8x16_t priority = vld1q_u8(source_priorities + offset);
+
+    uint8x16_t higher = vcgtq_u8(priority, current_priority);
+    uint8x16_t equal = vandq_u8(vceqq_u8(priority, current_priority),
+                                vtstq_u8(priority, priority));
+
+    uint8x16_t merged = vbslq_u8(equal, vmaxq_u8(current, value), current);
+    merged = vbslq_u8(higher, value, merged);
+    vst1q_u8(dest + offset, merged);
+    vst1q_u8(dest_priorities + offset,
+             vmaxq_u8(priority, current_priority));
+  }
+  ScalarSlotPriorityMerge(dest + offset, dest_priorities + offset,
+                          source + offset, source_priorities + offset,
+                          length - offset);
+}
+#endif  // OLA_HTP_MERGE_NEON
+
+HTPMergeImplementation SelectImplementation() {
+#ifdef OLA_HTP_MERGE_AVX2
+  if (CPUSupportsAVX2()) {
+    return HTP_MERGE_AVX2;
+  }
+#endif  // OLA_HTP_MERGE_AVX2
+#ifdef OLA_HTP_MERGE_SSE2
+  return HTP_MERGE_SSE2;
+#endif  // OLA_HTP_MERGE_SSE2
+#ifdef OLA_HTP_MERGE_NEON
+  return HTP_MERGE_NEON;
+#endif  // OLA_HTP_MERGE_NEON
+  return HTP_MERGE_SCALAR;
+}
+
+// Set on first use. All threads compute the same value so the race is benign.
+HTPMergeFunction default_merge_function = NULL;
+SlotPriorityMergeFunction default_slot_priority_function = NULL;
+HTPMergeImplementation default_implementation = HTP_MERGE_SCALAR;
+
+void SelectDefaultFunctions() {
+  if (!default_merge_function) {
+    default_implementation = SelectImplementation();
+    default_slot_priority_function = GetSlotPriorityMergeFunction(
+        default_implementation);
+    default_merge_function = GetHTPMergeFunction(default_implementation);
+  }
+}
+}  // namespace
+
+
+void HTPMergeBlocks(uint8_t *dest,
+                    const uint8_t *const *sources,
+                    const unsigned int *lengths,
+                    unsigned int count) {
+  SelectDefaultFunctions();
+  default_merge_function(dest, sources, lengths, count);
+}
+
+
+void SlotPriorityMerge(uint8_t *dest,
+                       uint8_t *dest_priorities,
+                       const uint8_t *source,
+                       const uint8_t *source_priorities,
+                       unsigned int length) {
+  SelectDefaultFunctions();
+  default_slot_priority_function(dest, dest_priorities, source,
+                                 source_priorities, length);
+}
+
+
+HTPMergeImplementation DefaultHTPMergeImplementation() {
+  SelectDefaultFunctions();
+  return default_implementation;
+}
+
+
+HTPMergeFunction GetHTPMergeFunction(HTPMergeImplementation implementation) {
+  switch (implementation) {
+    case HTP_MERGE_SCALAR:
+      return ScalarMerge;
+    case HTP_MERGE_SSE2:
+#ifdef OLA_HTP_MERGE_SSE2
+      return SSE2Merge;
+#else
+      return NULL;
+#endif  // OLA_HTP_MERGE_SSE2
+    case HTP_MERGE_AVX2:
+#ifdef OLA_HTP_MERGE_AVX2
+      return CPUSupportsAVX2() ? AVX2Merge : NULL;
+#else
+      return NULL;
+#endif  // OLA_HTP_MERGE_AVX2
+    case HTP_MERGE_NEON:
+#ifdef OLA_HTP_MERGE_NEON
+      return NEONMerge;
+#else
+      return NULL;
+#endif  // OLA_HTP_MERGE_NEON
+  }
+  return NULL;
+}
+
+
+SlotPriorityMergeFunction GetSlotPriorityMergeFunction(
+    HTPMergeImplementation implementation) {
+  switch (implementation) {
+    case HTP_MERGE_SCALAR:
+      return ScalarSlotPriorityMerge;
+    case HTP_MERGE_SSE2:
+#ifdef OLA_HTP_MERGE_SSE2
+      return SSE2SlotPriorityMerge;
+#else
+      return NULL;
+#endif  // OLA_HTP_MERGE_SSE2
+    case HTP_MERGE_AVX2:
+#ifdef OLA_HTP_MERGE_AVX2
+      return CPUSupportsAVX2() ? AVX2SlotPriorityMerge : NULL;
+#else
+      return NULL;
+#endif  // OLA_HTP_MERGE_AVX2
+    case HTP_MERGE_NEON:
+#ifdef OLA_HTP_MERGE_NEON
+      return NEONSlotPriorityMerge;
+#else
+      return NULL;
+#endif  // OLA_HTP_MERGE_NEON
+  }
+  return NULL;
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,128 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTPMerge.h
+ * Vectorized HTP & per-slot priority merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_HTPMERGE_H_
+#define COMMON_DMX_HTPMERGE_H_
+
+#include <stdint.h>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief The implementations of the HTP merge kernel.
+ */
+typedef enum {
+  HTP_MERGE_SCALAR,  /**< Plain C++ */
+  HTP_MERGE_SSE2,  /**< x86 SSE2, 16 slots at a time */
+  HTP_MERGE_AVX2,  /**< x86 AVX2, 32 slots at a time */
+  HTP_MERGE_NEON  /**< ARM NEON, 16 slots at a time */
+} HTPMergeImplementation;
+
+/**
+ * @brief A HTP merge kernel.
+ * @param dest the data to merge into. This must be at least as long as the
+ *   longest source.
+ * @param sources an array of count pointers to the source data.
+ * @param lengths an array of count source lengths.
+ * @param count the number of sources.
+ *
+ * Once this returns, each slot in dest holds the highest value of that slot
+ * from dest and all sources that contain the slot.
+ */
+typedef void (*HTPMergeFunction)(uint8_t *dest,
+                                 const uint8_t *const *sources,
+                                 const unsigned int *lengths,
+                                 unsigned int count);
+
+/**
+ * @brief A per-slot priority merge kernel.
+ * @param dest the data to merge into.
+ * @param dest_priorities the priorities of the slots in dest.
+ * @param source the source data.
+ * @param source_priorities the priorities of the slots in source.
+ * @param length the number of slots to merge.
+ *
+ * For each slot, if the source has a higher priority than dest, the source
+ * slot value & priority replace the ones in dest. If the priorities are equal
+ * the slots are HTP merged. A source slot with a priority of 0 isn't sourced
+ * and never changes dest.
+ */
+typedef void (*SlotPriorityMergeFunction)(uint8_t *dest,
+                                          uint8_t *dest_priorities,
+                                          const uint8_t *source,
+                                          const uint8_t *source_priorities,
+                                          unsigned int length);
+
+/**
+ * @brief HTP merge a number of sources in a single pass, using the fastest
+ * implementation supported by this CPU.
+ * @param dest the data to merge into. This must be at least as long as the
+ *   longest source.
+ * @param sources an array of count pointers to the source data.
+ * @param lengths an array of count source lengths.
+ * @param count the number of sources.
+ */
+void HTPMergeBlocks(uint8_t *dest,
+                    const uint8_t *const *sources,
+                    const unsigned int *lengths,
+                    unsigned int count);
+
+/**
+ * @brief Merge a source using per-slot priorities, using the fastest
+ * implementation supported by this CPU.
+ * @param dest the data to merge into.
+ * @param dest_priorities the priorities of the slots in dest.
+ * @param source the source data.
+ * @param source_priorities the priorities of the slots in source.
+ * @param length the number of slots to merge.
+ * @sa SlotPriorityMergeFunction
+ */
+void SlotPriorityMerge(uint8_t *dest,
+                       uint8_t *dest_priorities,
+                       const uint8_t *source,
+                       const uint8_t *source_priorities,
+                       unsigned int length);
+
+/**
+ * @brief Return the implementation used by HTPMergeBlocks() and
+ * SlotPriorityMerge().
+ */
+HTPMergeImplementation DefaultHTPMergeImplementation();
+
+/**
+ * @brief Return the kernel for a specific implementation.
+ * @param implementation the implementation to return.
+ * @returns the kernel, or NULL if the implementation isn't available on this
+ *   build or CPU.
+ */
+HTPMergeFunction GetHTPMergeFunction(HTPMergeImplementation implementation);
+
+/**
+ * @brief Return the per-slot priority kernel for a specific implementation.
+ * @param implementation the implementation to return.
+ * @returns the kernel, or NULL if the implementation isn't available on this
+ *   build or CPU.
+ */
+SlotPriorityMergeFunction GetSlotPriorityMergeFunction(
+    HTPMergeImplementation implementation);
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_HTPMERGE_H_
@@ -0,0 +1,234 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTPMergeTest.cpp
+ * Test fixture for the HTP & per-slot priority merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/dmx/HTPMerge.h"
+#include "ola/Constants.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::dmx::GetHTPMergeFunction;
+using ola::dmx::HTPMergeFunction;
+using ola::dmx::HTPMergeImplementation;
+using ola::dmx::GetSlotPriorityMergeFunction;
+using ola::dmx::SlotPriorityMergeFunction;
+
+class HTPMergeTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(HTPMergeTest);
+  CPPUNIT_TEST(testScalar);
+  CPPUNIT_TEST(testDefault);
+  CPPUNIT_TEST(testImplementations);
+  CPPUNIT_TEST(testScalarSlotPriority);
+  CPPUNIT_TEST(testSlotPriorityImplementations);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testScalar();
+    void testDefault();
+    void testImplementations();
+    void testScalarSlotPriority();
+    void testSlotPriorityImplementations();
+
+ private:
+    static const unsigned int SOURCE_COUNT = 5;
+
+    void checkImplementation(HTPMergeImplementation implementation);
+    void checkSlotPriorityImplementation(
+        HTPMergeImplementation implementation);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HTPMergeTest);
+
+
+/*
+ * Check the scalar kernel against hand computed results.
+ */
+void HTPMergeTest::testScalar() {
+  HTPMergeFunction merge = GetHTPMergeFunction(ola::dmx::HTP_MERGE_SCALAR);
+  OLA_ASSERT_NOT_NULL(merge);
+
+  uint8_t dest[] = {10, 20, 30, 40, 0};
+  const uint8_t source1[] = {0, 25, 30, 255, 1};
+  const uint8_t source2[] = {11, 0};
+  const uint8_t *sources[] = {source1, source2};
+  const unsigned int lengths[] = {sizeof(source1), sizeof(source2)};
+  merge(dest, sources, lengths, 2);
+
+  const uint8_t expected[] = {11, 25, 30, 255, 1};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), dest, sizeof(dest));
+
+  // no sources is a no-op
+  merge(dest, NULL, NULL, 0);
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), dest, sizeof(dest));
+}
+
+
+/*
+ * Check the default implementation is always available.
+ */
+void HTPMergeTest::testDefault() {
+  OLA_ASSERT_NOT_NULL(
+      GetHTPMergeFunction(ola::dmx::DefaultHTPMergeImplementation()));
+  checkImplementation(ola::dmx::DefaultHTPMergeImplementation());
+}
+
+
+/*
+ * Check every implementation this build & CPU supports matches the scalar
+ * kernel.
+ */
+void HTPMergeTest::testImplementations() {
+  checkImplementation(ola::dmx::HTP_MERGE_SSE2);
+  checkImplementation(ola::dmx::HTP_MERGE_AVX2);
+  checkImplementation(ola::dmx::HTP_MERGE_NEON);
+}
+
+
+/*
+ * Compare an implementation against the scalar kernel, using sources of
+ * lengths that don't line up with the vector width.
+ */
+void HTPMergeTest::checkImplementation(
+    HTPMergeImplementation implementation) {
+  HTPMergeFunction merge = GetHTPMergeFunction(implementation);
+  if (!merge) {
+    return;
+  }
+  HTPMergeFunction scalar_merge = GetHTPMergeFunction(
+      ola::dmx::HTP_MERGE_SCALAR);
+
+  const unsigned int test_lengths[] = {
+    0, 1, 15, 16, 17, 31, 32, 33, 63, 100, 511, ola::DMX_UNIVERSE_SIZE};
+  const unsigned int test_count = sizeof(test_lengths) / sizeof(unsigned int);
+
+  uint8_t source_data[SOURCE_COUNT][ola::DMX_UNIVERSE_SIZE];
+  const uint8_t *sources[SOURCE_COUNT];
+  unsigned int lengths[SOURCE_COUNT];
+  uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+  uint8_t actual[ola::DMX_UNIVERSE_SIZE];
+
+  srand(implementation);
+  for (unsigned int i = 0; i < test_count; i++) {
+    for (unsigned int count = 1; count <= SOURCE_COUNT; count++) {
+      for (unsigned int j = 0; j < count; j++) {
+        lengths[j] = test_lengths[(i + j * 5) % test_count];
+        for (unsigned int k = 0; k < ola::DMX_UNIVERSE_SIZE; k++) {
+          source_data[j][k] = rand() % 256;  // NOLINT(runtime/threadsafe_fn)
+        }
+        sources[j] = source_data[j];
+      }
+
+      for (unsigned int k = 0; k < ola::DMX_UNIVERSE_SIZE; k++) {
+        expected[k] = rand() % 256;  // NOLINT(runtime/threadsafe_fn)
+      }
+      memcpy(actual, expected, sizeof(actual));
+
+      scalar_merge(expected, sources, lengths, count);
+      merge(actual, sources, lengths, count);
+      OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected),
+                             actual, sizeof(actual));
+    }
+  }
+}
+
+
+/*
+ * Check the scalar per-slot priority kernel against hand computed results.
+ */
+void HTPMergeTest::testScalarSlotPriority() {
+  SlotPriorityMergeFunction merge = GetSlotPriorityMergeFunction(
+      ola::dmx::HTP_MERGE_SCALAR);
+  OLA_ASSERT_NOT_NULL(merge);
+
+  uint8_t dest[] = {10, 20, 30, 40, 50};
+  uint8_t dest_priorities[] = {100, 100, 100, 0, 0};
+  const uint8_t source[] = {5, 25, 255, 60, 70};
+  const uint8_t source_priorities[] = {101, 100, 99, 0, 1};
+  merge(dest, dest_priorities, source, source_priorities, sizeof(dest));
+
+  // higher, HTP, lower, not sourced, higher
+  const uint8_t expected[] = {5, 25, 30, 40, 70};
+  const uint8_t expected_priorities[] = {101, 100, 100, 0, 1};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), dest, sizeof(dest));
+  OLA_ASSERT_DATA_EQUALS(expected_priorities, sizeof(expected_priorities),
+                         dest_priorities, sizeof(dest_priorities));
+}
+
+
+/*
+ * Check every per-slot priority implementation matches the scalar kernel.
+ */
+void HTPMergeTest::testSlotPriorityImplementations() {
+  checkSlotPriorityImplementation(ola::dmx::DefaultHTPMergeImplementation());
+  checkSlotPriorityImplementation(ola::dmx::HTP_MERGE_SSE2);
+  checkSlotPriorityImplementation(ola::dmx::HTP_MERGE_AVX2);
+  checkSlotPriorityImplementation(ola::dmx::HTP_MERGE_NEON);
+}
+
+
+/*
+ * Compare a per-slot priority implementation against the scalar kernel. The
+ * priorities are drawn from a small range so there are plenty of ties.
+ */
+void HTPMergeTest::checkSlotPriorityImplementation(
+    HTPMergeImplementation implementation) {
+  SlotPriorityMergeFunction merge = GetSlotPriorityMergeFunction(
+      implementation);
+  if (!merge) {
+    return;
+  }
+  SlotPriorityMergeFunction scalar_merge = GetSlotPriorityMergeFunction(
+      ola::dmx::HTP_MERGE_SCALAR);
+
+  const unsigned int test_lengths[] = {
+    0, 1, 15, 16, 17, 31, 32, 33, 63, 100, 511, ola::DMX_UNIVERSE_SIZE};
+
+  uint8_t source[ola::DMX_UNIVERSE_SIZE];
+  uint8_t source_priorities[ola::DMX_UNIVERSE_SIZE];
+  uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+  uint8_t expected_priorities[ola::DMX_UNIVERSE_SIZE];
+  uint8_t actual[ola::DMX_UNIVERSE_SIZE];
+  uint8_t actual_priorities[ola::DMX_UNIVERSE_SIZE];
+
+  srand(implementation);
+  for (unsigned int i = 0; i < sizeof(test_lengths) / sizeof(unsigned int);
+       i++) {
+    for (unsigned int j = 0; j < ola::DMX_UNIVERSE_SIZE; j++) {
+      source[j] = rand() % 256;  // NOLINT(runtime/threadsafe_fn)
+      source_priorities[j] = rand() % 4;  // NOLINT(runtime/threadsafe_fn)
+      expected[j] = rand() % 256;  // NOLINT(runtime/threadsafe_fn)
+      expected_priorities[j] = rand() % 4;  // NOLINT(runtime/threadsafe_fn)
+    }
+    memcpy(actual, expected, sizeof(actual));
+    memcpy(actual_priorities, expected_priorities, sizeof(actual_priorities));
+
+    scalar_merge(expected, expected_priorities, source, source_priorities,
+                 test_lengths[i]);
+    merge(actual, actual_priorities, source, source_priorities,
+          test_lengths[i]);
+    OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected),
+                           actual, sizeof(actual));
+    OLA_ASSERT_DATA_EQUALS(expected_priorities, sizeof(expected_priorities),
+                           actual_priorities, sizeof(actual_priorities));
+  }
+}
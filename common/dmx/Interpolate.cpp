@@ -0,0 +1,137 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Interpolate.cpp
+ * Vectorized kernels to interpolate between two frames of DMX data.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * The weighted sum of a slot fits in 16 bits, so the vector kernels widen
+ * each slot to 16 bits, multiply & add, and then narrow the result. Like the
+ * HTP merge kernels, the SSE2 & NEON versions are selected at compile time.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "common/dmx/Interpolate.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define OLA_INTERPOLATE_SSE2 1
+#include <emmintrin.h>
+#endif  // x86 && __SSE2__
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_INTERPOLATE_NEON 1
+#include <arm_neon.h>
+#endif  // __ARM_NEON
+
+namespace ola {
+namespace dmx {
+
+namespace {
+
+inline void InterpolateTail(uint8_t *dest,
+                            const uint8_t *start,
+                            const uint8_t *target,
+                            unsigned int offset,
+                            unsigned int length,
+                            unsigned int step) {
+  const unsigned int start_weight = INTERPOLATE_STEPS - step;
+  for (unsigned int i = offset; i < length; i++) {
+    dest[i] = static_cast<uint8_t>(
+        (start[i] * start_weight + target[i] * step +
+         INTERPOLATE_STEPS / 2) / INTERPOLATE_STEPS);
+  }
+}
+}  // namespace
+
+
+void ScalarInterpolateSlots(uint8_t *dest,
+                            const uint8_t *start,
+                            const uint8_t *target,
+                            unsigned int length,
+                            unsigned int step) {
+  if (step >= INTERPOLATE_STEPS) {
+    memmove(dest, target, length);
+    return;
+  }
+  InterpolateTail(dest, start, target, 0, length, step);
+}
+
+
+void InterpolateSlots(uint8_t *dest,
+                      const uint8_t *start,
+                      const uint8_t *target,
+                      unsigned int length,
+                      unsigned int step) {
+  if (step >= INTERPOLATE_STEPS) {
+    memmove(dest, target, length);
+    return;
+  } else if (step == 0) {
+    memmove(dest, start, length);
+    return;
+  }
+
+  unsigned int offset = 0;
+#if defined(OLA_INTERPOLATE_SSE2)
+  static const unsigned int WIDTH = 16;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i start_weight = _mm_set1_epi16(
+      static_cast<int16_t>(INTERPOLATE_STEPS - step));
+  const __m128i target_weight = _mm_set1_epi16(static_cast<int16_t>(step));
+  const __m128i round = _mm_set1_epi16(INTERPOLATE_STEPS / 2);
+  for (; offset + WIDTH <= length; offset += WIDTH) {
+    const __m128i s = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(start + offset));
+    const __m128i t = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(target + offset));
+    // The sums are at most 255 * 256 + 128, so they fit in an unsigned 16
+    // bit lane.
+    __m128i low = _mm_add_epi16(
+        _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), start_weight),
+            _mm_mullo_epi16(_mm_unpacklo_epi8(t, zero), target_weight)),
+        round);
+    __m128i high = _mm_add_epi16(
+        _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), start_weight),
+            _mm_mullo_epi16(_mm_unpackhi_epi8(t, zero), target_weight)),
+        round);
+    low = _mm_srli_epi16(low, 8);
+    high = _mm_srli_epi16(high, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset),
+                     _mm_packus_epi16(low, high));
+  }
+#elif defined(OLA_INTERPOLATE_NEON)
+  static const unsigned int WIDTH = 16;
+  // step is between 1 & 255 here, so both weights fit in 8 bits.
+  const uint8x8_t start_weight = vdup_n_u8(
+      static_cast<uint8_t>(INTERPOLATE_STEPS - step));
+  const uint8x8_t target_weight = vdup_n_u8(static_cast<uint8_t>(step));
+  for (; offset + WIDTH <= length; offset += WIDTH) {
+    const uint8x16_t s = vld1q_u8(start + offset);
+    const uint8x16_t t = vld1q_u8(target + offset);
+    uint16x8_t low = vmull_u8(vget_low_u8(s), start_weight);
+    low = vmlal_u8(low, vget_low_u8(t), target_weight);
+    uint16x8_t high = vmull_u8(vget_high_u8(s), start_weight);
+    high = vmlal_u8(high, vget_high_u8(t), target_weight);
+    vst1q_u8(dest + offset,
+             vcombine_u8(vrshrn_n_u16(low, 8), vrshrn_n_u16(high, 8)));
+  }
+#endif  // OLA_INTERPOLATE_SSE2
+  InterpolateTail(dest, start, target, offset, length, step);
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,63 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Interpolate.h
+ * Vectorized kernels to interpolate between two frames of DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_INTERPOLATE_H_
+#define COMMON_DMX_INTERPOLATE_H_
+
+#include <stdint.h>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief The number of steps between the start & target of an interpolation.
+ */
+static const unsigned int INTERPOLATE_STEPS = 256;
+
+/**
+ * @brief Interpolate between two frames, using the fastest implementation
+ * for this build.
+ * @param dest the output, this must hold length slots.
+ * @param start the values at the start of the interpolation.
+ * @param target the values at the end of the interpolation.
+ * @param length the number of slots.
+ * @param step how far to move from start to target, from 0 to
+ *   INTERPOLATE_STEPS.
+ *
+ * Each slot is set to (start * (INTERPOLATE_STEPS - step) + target * step) /
+ * INTERPOLATE_STEPS, rounded to the nearest value.
+ */
+void InterpolateSlots(uint8_t *dest,
+                      const uint8_t *start,
+                      const uint8_t *target,
+                      unsigned int length,
+                      unsigned int step);
+
+/**
+ * @brief The plain C++ version of InterpolateSlots().
+ */
+void ScalarInterpolateSlots(uint8_t *dest,
+                            const uint8_t *start,
+                            const uint8_t *target,
+                            unsigned int length,
+                            unsigned int step);
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_INTERPOLATE_H_
@@ -0,0 +1,99 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InterpolateTest.cpp
+ * Test fixture for the interpolation kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdlib.h>
+
+#include "common/dmx/Interpolate.h"
+#include "ola/Constants.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::dmx::INTERPOLATE_STEPS;
+using ola::dmx::InterpolateSlots;
+using ola::dmx::ScalarInterpolateSlots;
+
+class InterpolateTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(InterpolateTest);
+  CPPUNIT_TEST(testScalar);
+  CPPUNIT_TEST(testDefault);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testScalar();
+    void testDefault();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(InterpolateTest);
+
+
+/*
+ * Check the plain C++ kernel.
+ */
+void InterpolateTest::testScalar() {
+  const uint8_t start[] = {0, 255, 100, 0, 255};
+  const uint8_t target[] = {255, 0, 100, 1, 254};
+  uint8_t dest[sizeof(start)];
+
+  ScalarInterpolateSlots(dest, start, target, sizeof(dest), 0);
+  OLA_ASSERT_DATA_EQUALS(start, sizeof(start), dest, sizeof(dest));
+
+  ScalarInterpolateSlots(dest, start, target, sizeof(dest),
+                         INTERPOLATE_STEPS);
+  OLA_ASSERT_DATA_EQUALS(target, sizeof(target), dest, sizeof(dest));
+
+  ScalarInterpolateSlots(dest, start, target, sizeof(dest),
+                         INTERPOLATE_STEPS / 2);
+  const uint8_t half[] = {128, 128, 100, 1, 255};
+  OLA_ASSERT_DATA_EQUALS(half, sizeof(half), dest, sizeof(dest));
+
+  ScalarInterpolateSlots(dest, start, target, sizeof(dest),
+                         INTERPOLATE_STEPS / 4);
+  const uint8_t quarter[] = {64, 191, 100, 0, 255};
+  OLA_ASSERT_DATA_EQUALS(quarter, sizeof(quarter), dest, sizeof(dest));
+}
+
+
+/*
+ * Check the default kernel matches the plain C++ one, for a range of lengths
+ * so the vector loop & the tail are both used.
+ */
+void InterpolateTest::testDefault() {
+  uint8_t start[ola::DMX_UNIVERSE_SIZE];
+  uint8_t target[ola::DMX_UNIVERSE_SIZE];
+  uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+  uint8_t dest[ola::DMX_UNIVERSE_SIZE];
+
+  srandom(7);
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    start[i] = random();
+    target[i] = random();
+  }
+
+  const unsigned int lengths[] = {0, 1, 15, 16, 17, 100, 511, 512};
+  const unsigned int steps[] = {0, 1, 64, 127, 128, 200, 255, 256};
+  for (unsigned int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    for (unsigned int j = 0; j < sizeof(steps) / sizeof(steps[0]); j++) {
+      ScalarInterpolateSlots(expected, start, target, lengths[i], steps[j]);
+      InterpolateSlots(dest, start, target, lengths[i], steps[j]);
+      OLA_ASSERT_DATA_EQUALS(expected, lengths[i], dest, lengths[i]);
+    }
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ *
+ * LayerBlend.h
+ * Vectorized kernels to blend a layer onto a universe.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_LAYERBLEND_H_
+#define COMMON_DMX_LAYERBLEND_H_
+
+#include <stdint.h>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief The implementations of the layer blend kernel.
+ */
+typedef enum {
+  LAYER_BLEND_SCALAR,  /**< Plain C++ */
+  LAYER_BLEND_SSE2,  /**< x86 SSE2, 16 slots at a time */
+  LAYER_BLEND_NEON  /**< ARM NEON, 16 slots at a time */
+} LayerBlendImplementation;
+
+/**
+ * @brief A layer blend kernel.
+ * @param dest the data to blend into.
+ * @param source the layer data.
+ * @param mask the per-slot mask, or NULL if every slot is fully masked in.
+ * @param opacity the opacity of the layer.
+ * @param length the number of slots to blend.
+ *
+ * The weight of each slot is mask * opacity / 255, and each slot of dest
+ * becomes (dest * (255 - weight) + source * weight) / 255. Both divisions
+ * are rounded to the nearest integer, so all implementations produce the
+ * same output.
+ */
+typedef void (*LayerBlendFunction)(uint8_t *dest,
+                                   const uint8_t *source,
+                                   const uint8_t *mask,
+                                   uint8_t opacity,
+                                   unsigned int length);
+
+/**
+ * @brief Blend a layer, using the fastest implementation supported by this
+ * CPU.
+ * @sa LayerBlendFunction
+ */
+void BlendLayer(uint8_t *dest,
+                const uint8_t *source,
+                const uint8_t *mask,
+                uint8_t opacity,
+                unsigned int length);
+
+/**
+ * @brief Return the implementation used by BlendLayer().
+ */
+LayerBlendImplementation DefaultLayerBlendImplementation();
+
+/**
+ * @brief Return the kernel for a specific implementation.
+ * @param implementation the implementation to return.
+ * @returns the kernel, or NULL if the implementation isn't available on this
+ *   build.
+ */
+LayerBlendFunction GetLayerBlendFunction(
+    LayerBlendImplementation implementation);
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_LAYERBLEND_H_
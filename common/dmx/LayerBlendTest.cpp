@@ -0,0 +1,185 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ *
+ * LayerBlendTest.cpp
+ * Test fixture for the layer blend kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/dmx/LayerBlend.h"
+#include "ola/Constants.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::dmx::GetLayerBlendFunction;
+using ola::dmx::LayerBlendFunction;
+using ola::dmx::LayerBlendImplementation;
+
+class LayerBlendTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(LayerBlendTest);
+  CPPUNIT_TEST(testScalar);
+  CPPUNIT_TEST(testRounding);
+  CPPUNIT_TEST(testDefault);
+  CPPUNIT_TEST(testImplementations);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testScalar();
+    void testRounding();
+    void testDefault();
+    void testImplementations();
+
+ private:
+    void checkImplementation(LayerBlendImplementation implementation);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LayerBlendTest);
+
+
+/*
+ * Check the scalar kernel against hand computed results.
+ */
+void LayerBlendTest::testScalar() {
+  LayerBlendFunction blend = GetLayerBlendFunction(
+      ola::dmx::LAYER_BLEND_SCALAR);
+  OLA_ASSERT_NOT_NULL(blend);
+
+  const uint8_t source[] = {255, 255, 255, 0, 100};
+  const uint8_t mask[] = {255, 0, 128, 255, 255};
+
+  uint8_t dest[] = {0, 10, 0, 200, 50};
+  blend(dest, source, NULL, 255, sizeof(dest));
+  OLA_ASSERT_DATA_EQUALS(source, sizeof(source), dest, sizeof(dest));
+
+  uint8_t dest2[] = {0, 10, 0, 200, 50};
+  blend(dest2, source, mask, 255, sizeof(dest2));
+  const uint8_t expected[] = {255, 10, 128, 0, 100};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), dest2, sizeof(dest2));
+
+  // Half opacity, half mask
+  uint8_t dest3[] = {0, 10, 0, 200, 50};
+  blend(dest3, source, mask, 128, sizeof(dest3));
+  const uint8_t expected3[] = {128, 10, 64, 100, 75};
+  OLA_ASSERT_DATA_EQUALS(expected3, sizeof(expected3), dest3, sizeof(dest3));
+
+  // A 0 opacity leaves dest alone
+  uint8_t dest4[] = {0, 10, 0, 200, 50};
+  const uint8_t original[] = {0, 10, 0, 200, 50};
+  blend(dest4, source, NULL, 0, sizeof(dest4));
+  OLA_ASSERT_DATA_EQUALS(original, sizeof(original), dest4, sizeof(dest4));
+}
+
+
+/*
+ * Check the scalar kernel rounds to the nearest value for every input.
+ */
+void LayerBlendTest::testRounding() {
+  LayerBlendFunction blend = GetLayerBlendFunction(
+      ola::dmx::LAYER_BLEND_SCALAR);
+
+  uint8_t dest[256];
+  uint8_t source[256];
+  for (unsigned int weight = 0; weight < 256; weight++) {
+    for (unsigned int a = 0; a < 256; a++) {
+      for (unsigned int b = 0; b < 256; b++) {
+        dest[b] = a;
+        source[b] = b;
+      }
+      blend(dest, source, NULL, weight, sizeof(dest));
+      for (unsigned int b = 0; b < 256; b++) {
+        const unsigned int expected =
+            (2 * (a * (255 - weight) + b * weight) + 255) / 510;
+        OLA_ASSERT_EQ(expected, static_cast<unsigned int>(dest[b]));
+      }
+    }
+  }
+}
+
+
+/*
+ * Check the default implementation is always available.
+ */
+void LayerBlendTest::testDefault() {
+  OLA_ASSERT_NOT_NULL(
+      GetLayerBlendFunction(ola::dmx::DefaultLayerBlendImplementation()));
+  checkImplementation(ola::dmx::DefaultLayerBlendImplementation());
+}
+
+
+/*
+ * Check every implementation this build supports matches the scalar kernel.
+ */
+void LayerBlendTest::testImplementations() {
+  checkImplementation(ola::dmx::LAYER_BLEND_SSE2);
+  checkImplementation(ola::dmx::LAYER_BLEND_NEON);
+}
+
+
+/*
+ * Compare an implementation against the scalar kernel, with and without a
+ * mask, for lengths that don't line up with the vector width.
+ */
+void LayerBlendTest::checkImplementation(
+    LayerBlendImplementation implementation) {
+  LayerBlendFunction blend = GetLayerBlendFunction(implementation);
+  if (!blend) {
+    return;
+  }
+  LayerBlendFunction scalar_blend = GetLayerBlendFunction(
+      ola::dmx::LAYER_BLEND_SCALAR);
+
+  const unsigned int lengths[] = {0, 1, 15, 16, 17, 100,
+                                  ola::DMX_UNIVERSE_SIZE};
+  const uint8_t opacities[] = {0, 1, 127, 128, 254, 255};
+  uint8_t dest[ola::DMX_UNIVERSE_SIZE];
+  uint8_t source[ola::DMX_UNIVERSE_SIZE];
+  uint8_t mask[ola::DMX_UNIVERSE_SIZE];
+  uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+  uint8_t actual[ola::DMX_UNIVERSE_SIZE];
+
+  srand(implementation);
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    dest[i] = rand() % 256;  // NOLINT(runtime/threadsafe_fn)
+    source[i] = rand() % 256;  // NOLINT(runtime/threadsafe_fn)
+    mask[i] = rand() % 256;  // NOLINT(runtime/threadsafe_fn)
+  }
+  // Make sure the extremes are covered.
+  mask[0] = 0;
+  mask[1] = 255;
+
+  for (unsigned int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    for (unsigned int j = 0; j < sizeof(opacities); j++) {
+      const unsigned int length = lengths[i];
+      memcpy(expected, dest, sizeof(dest));
+      memcpy(actual, dest, sizeof(dest));
+      scalar_blend(expected, source, NULL, opacities[j], length);
+      blend(actual, source, NULL, opacities[j], length);
+      OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), actual,
+                             sizeof(actual));
+
+      memcpy(expected, dest, sizeof(dest));
+      memcpy(actual, dest, sizeof(dest));
+      scalar_blend(expected, source, mask, opacities[j], length);
+      blend(actual, source, mask, opacities[j], length);
+      OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), actual,
+                             sizeof(actual));
+    }
+  }
+}
@@ -1,11 +1,61 @@
 # LIBRARIES
 ##################################################
-common_libolacommon_la_SOURCES += common/dmx/RunLengthEncoder.cpp
+common_libolacommon_la_SOURCES += \
+    common/dmx/HTPMerge.cpp \
+    common/dmx/HTPMerge.h \
+    common/dmx/Interpolate.cpp \
+    common/dmx/Interpolate.h \
+    common/dmx/LayerBlend.cpp \
+    common/dmx/LayerBlend.h \
+    common/dmx/PixelMap.cpp \
+    common/dmx/RunLengthEncoder.cpp \
+    common/dmx/SharedMemoryFrames.cpp \
+    common/dmx/SlotRemap.cpp
 
 # TESTS
 ##################################################
-test_programs += common/dmx/RunLengthEncoderTester
+test_programs += \
+    common/dmx/HTPMergeTester \
+    common/dmx/InterpolateTester \
+    common/dmx/LayerBlendTester \
+    common/dmx/PixelMapTester \
+    common/dmx/RunLengthEncoderTester \
+    common/dmx/SharedMemoryFramesTester \
+    common/dmx/SlotRemapTester
+
+common_dmx_HTPMergeTester_SOURCES = common/dmx/HTPMergeTest.cpp
+common_dmx_HTPMergeTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_HTPMergeTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_InterpolateTester_SOURCES = common/dmx/InterpolateTest.cpp
+common_dmx_InterpolateTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_InterpolateTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_LayerBlendTester_SOURCES = common/dmx/LayerBlendTest.cpp
+common_dmx_LayerBlendTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_LayerBlendTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_PixelMapTester_SOURCES = common/dmx/PixelMapTest.cpp
+common_dmx_PixelMapTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_PixelMapTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_dmx_RunLengthEncoderTester_SOURCES = common/dmx/RunLengthEncoderTest.cpp
 common_dmx_RunLengthEncoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_dmx_RunLengthEncoderTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_SharedMemoryFramesTester_SOURCES = \
+    common/dmx/SharedMemoryFramesTest.cpp
+common_dmx_SharedMemoryFramesTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_SharedMemoryFramesTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_SlotRemapTester_SOURCES = common/dmx/SlotRemapTest.cpp
+common_dmx_SlotRemapTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_SlotRemapTester_LDADD = $(COMMON_TESTING_LIBS)
+
+# BENCHMARKS
+################################################
+bench_programs += common/dmx/RunLengthEncoderBenchmark
+
+common_dmx_RunLengthEncoderBenchmark_SOURCES = \
+    common/dmx/RunLengthEncoderBenchmark.cpp
+common_dmx_RunLengthEncoderBenchmark_LDADD = $(COMMON_BENCHMARK_LIBS)
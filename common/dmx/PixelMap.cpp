@@ -0,0 +1,335 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PixelMap.cpp
+ * Map a 2D frame of RGB pixels onto DMX universes.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * The vector gather kernels only handle runs of adjacent pixels, which is the
+ * common case of a row of the frame. Other runs, such as columns or reversed
+ * rows, use the scalar kernel.
+ *
+ * The SSSE3 kernel reorders 5 pixels at a time with a single pshufb. It's
+ * built with a function level target attribute and only used if the CPU
+ * supports it. The NEON kernel de-interleaves 16 pixels with vld3q_u8 and
+ * stores them in the new order with vst3q_u8.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/PixelMap.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+     (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define OLA_PIXEL_GATHER_SSSE3 1
+#include <tmmintrin.h>
+#endif  // x86 && (clang || gcc >= 4.9)
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_PIXEL_GATHER_NEON 1
+#include <arm_neon.h>
+#endif  // __ARM_NEON
+
+namespace ola {
+namespace dmx {
+
+using std::vector;
+
+namespace {
+
+const int RGB_SIZE = 3;
+
+// The source color for each output color, indexed by ColorOrder.
+const uint8_t COLOR_ORDERS[][RGB_SIZE] = {
+  {0, 1, 2},  // RGB
+  {0, 2, 1},  // RBG
+  {1, 0, 2},  // GRB
+  {1, 2, 0},  // GBR
+  {2, 0, 1},  // BRG
+  {2, 1, 0},  // BGR
+};
+
+void ScalarGather(ColorOrder order, uint8_t *dest, const uint8_t *source,
+                  int stride, unsigned int pixels) {
+  if (order == COLOR_ORDER_RGB && stride == RGB_SIZE) {
+    memcpy(dest, source, pixels * RGB_SIZE);
+    return;
+  }
+
+  const unsigned int first = COLOR_ORDERS[order][0];
+  const unsigned int second = COLOR_ORDERS[order][1];
+  const unsigned int third = COLOR_ORDERS[order][2];
+  for (unsigned int i = 0; i < pixels; i++) {
+    dest[0] = source[first];
+    dest[1] = source[second];
+    dest[2] = source[third];
+    dest += RGB_SIZE;
+    source += stride;
+  }
+}
+
+#ifdef OLA_PIXEL_GATHER_SSSE3
+const unsigned int SSSE3_WIDTH = 5;
+
+__attribute__((target("ssse3")))
+void SSSE3Gather(ColorOrder order, uint8_t *dest, const uint8_t *source,
+                 int stride, unsigned int pixels) {
+  if (stride != RGB_SIZE || order == COLOR_ORDER_RGB) {
+    ScalarGather(order, dest, source, stride, pixels);
+    return;
+  }
+
+  uint8_t mask_bytes[16];
+  for (unsigned int i = 0; i < SSSE3_WIDTH * RGB_SIZE; i++) {
+    mask_bytes[i] = ((i / RGB_SIZE) * RGB_SIZE +
+                     COLOR_ORDERS[order][i % RGB_SIZE]);
+  }
+  mask_bytes[15] = 15;
+  const __m128i mask = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(mask_bytes));
+
+  // Each iteration reads & writes 16 bytes but only consumes 5 pixels, so
+  // stop while there is at least one more pixel to cover the extra byte. The
+  // extra byte written is then overwritten by the next iteration or the
+  // scalar tail.
+  unsigned int i = 0;
+  for (; i + SSSE3_WIDTH + 1 <= pixels; i += SSSE3_WIDTH) {
+    __m128i in = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(source + i * RGB_SIZE));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * RGB_SIZE),
+                     _mm_shuffle_epi8(in, mask));
+  }
+  ScalarGather(order, dest + i * RGB_SIZE, source + i * RGB_SIZE, stride,
+               pixels - i);
+}
+
+bool CPUSupportsSSSE3() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("ssse3");
+}
+#endif  // OLA_PIXEL_GATHER_SSSE3
+
+#ifdef OLA_PIXEL_GATHER_NEON
+const unsigned int NEON_WIDTH = 16;
+
+void NEONGather(ColorOrder order, uint8_t *dest, const uint8_t *source,
+                int stride, unsigned int pixels) {
+  if (stride != RGB_SIZE || order == COLOR_ORDER_RGB) {
+    ScalarGather(order, dest, source, stride, pixels);
+    return;
+  }
+
+  const unsigned int first = COLOR_ORDERS[order][0];
+  const unsigned int second = COLOR_ORDERS[order][1];
+  const unsigned int third = COLOR_ORDERS[order][2];
+  unsigned int i = 0;
+  for (; i + NEON_WIDTH <= pixels; i += NEON_WIDTH) {
+    uint8x16x3_t in = vld3q_u8(source + i * RGB_SIZE);
+    uint8x16x3_t out;
+    out.val[0] = in.val[first];
+    out.val[1] = in.val[second];
+    out.val[2] = in.val[third];
+    vst3q_u8(dest + i * RGB_SIZE, out);
+  }
+  ScalarGather(order, dest + i * RGB_SIZE, source + i * RGB_SIZE, stride,
+               pixels - i);
+}
+#endif  // OLA_PIXEL_GATHER_NEON
+
+PixelGatherFunction default_gather_function = NULL;
+
+void SelectDefaultFunction() {
+  if (!default_gather_function) {
+    default_gather_function = GetPixelGatherFunction(
+        DefaultPixelGatherImplementation());
+  }
+}
+}  // namespace
+
+
+void GatherPixels(ColorOrder order, uint8_t *dest, const uint8_t *source,
+                  int stride, unsigned int pixels) {
+  SelectDefaultFunction();
+  default_gather_function(order, dest, source, stride, pixels);
+}
+
+
+PixelGatherImplementation DefaultPixelGatherImplementation() {
+#ifdef OLA_PIXEL_GATHER_NEON
+  return PIXEL_GATHER_NEON;
+#endif  // OLA_PIXEL_GATHER_NEON
+#ifdef OLA_PIXEL_GATHER_SSSE3
+  if (CPUSupportsSSSE3()) {
+    return PIXEL_GATHER_SSSE3;
+  }
+#endif  // OLA_PIXEL_GATHER_SSSE3
+  return PIXEL_GATHER_SCALAR;
+}
+
+
+PixelGatherFunction GetPixelGatherFunction(
+    PixelGatherImplementation implementation) {
+  switch (implementation) {
+    case PIXEL_GATHER_SCALAR:
+      return ScalarGather;
+    case PIXEL_GATHER_SSSE3:
+#ifdef OLA_PIXEL_GATHER_SSSE3
+      return CPUSupportsSSSE3() ? SSSE3Gather : NULL;
+#else
+      return NULL;
+#endif  // OLA_PIXEL_GATHER_SSSE3
+    case PIXEL_GATHER_NEON:
+#ifdef OLA_PIXEL_GATHER_NEON
+      return NEONGather;
+#else
+      return NULL;
+#endif  // OLA_PIXEL_GATHER_NEON
+  }
+  return NULL;
+}
+
+
+bool BuildColorTable(double gamma, uint8_t brightness, uint8_t table[256]) {
+  for (unsigned int i = 0; i < 256; i++) {
+    double value = pow(i / 255.0, gamma) * brightness + 0.5;
+    table[i] = static_cast<uint8_t>(std::max(0.0, std::min(value, 255.0)));
+  }
+  return gamma != 1.0 || brightness != 255;
+}
+
+
+void ApplyColorTable(const uint8_t table[256], uint8_t *dest,
+                     const uint8_t *source, unsigned int length) {
+  for (unsigned int i = 0; i < length; i++) {
+    dest[i] = table[source[i]];
+  }
+}
+
+
+PixelMap::PixelMap(unsigned int width, unsigned int height)
+    : m_width(width),
+      m_height(height),
+      m_gamma(1.0),
+      m_brightness(255),
+      m_color_correction(false) {
+  BuildColorTable(m_gamma, m_brightness, m_color_table);
+}
+
+
+bool PixelMap::AddRun(const Run &run) {
+  if (!run.count ||
+      run.start_slot + run.count * RGB_SIZE > DMX_UNIVERSE_SIZE) {
+    return false;
+  }
+
+  // Check the first & last pixels, the ones in between are on the line.
+  const int64_t last = run.count - 1;
+  const int64_t last_x = run.x + last * run.x_step;
+  const int64_t last_y = run.y + last * run.y_step;
+  if (run.x >= m_width || run.y >= m_height ||
+      last_x < 0 || last_x >= m_width || last_y < 0 || last_y >= m_height) {
+    return false;
+  }
+
+  Gather gather;
+  gather.source = (run.y * m_width + run.x) * RGB_SIZE;
+  gather.stride = (run.y_step * static_cast<int>(m_width) + run.x_step) *
+                  RGB_SIZE;
+  gather.slot = run.start_slot;
+  gather.pixels = run.count;
+  gather.order = run.order;
+
+  MappedUniverse *universe = FindOrAddUniverse(run.universe);
+  universe->gathers.push_back(gather);
+  universe->size = std::max(universe->size,
+                            run.start_slot + run.count * RGB_SIZE);
+
+  // Lay the universes out one after another.
+  unsigned int offset = 0;
+  vector<MappedUniverse>::iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    iter->offset = offset;
+    offset += iter->size;
+  }
+  m_slots.resize(offset);
+  m_runs.push_back(run);
+  return true;
+}
+
+
+void PixelMap::SetColorCorrection(double gamma, uint8_t brightness) {
+  m_gamma = gamma;
+  m_brightness = brightness;
+  m_color_correction = BuildColorTable(gamma, brightness, m_color_table);
+}
+
+
+bool PixelMap::Map(const uint8_t *frame, unsigned int size) {
+  if (size != FrameSize()) {
+    return false;
+  }
+
+  if (m_slots.empty()) {
+    return true;
+  }
+
+  // The slots between runs must be 0.
+  memset(&m_slots[0], 0, m_slots.size());
+
+  vector<MappedUniverse>::iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    uint8_t *slots = &m_slots[iter->offset];
+    vector<Gather>::const_iterator gather = iter->gathers.begin();
+    for (; gather != iter->gathers.end(); ++gather) {
+      GatherPixels(gather->order, slots + gather->slot,
+                   frame + gather->source, gather->stride, gather->pixels);
+    }
+  }
+
+  if (m_color_correction) {
+    ApplyColorTable(m_color_table, &m_slots[0], &m_slots[0], m_slots.size());
+  }
+
+  for (iter = m_universes.begin(); iter != m_universes.end(); ++iter) {
+    iter->data.Set(&m_slots[iter->offset], iter->size);
+  }
+  return true;
+}
+
+
+PixelMap::MappedUniverse *PixelMap::FindOrAddUniverse(unsigned int id) {
+  vector<MappedUniverse>::iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    if (iter->id == id) {
+      return &(*iter);
+    }
+  }
+
+  MappedUniverse universe;
+  universe.id = id;
+  universe.offset = 0;
+  universe.size = 0;
+  m_universes.push_back(universe);
+  return &m_universes.back();
+}
+}  // namespace dmx
+}  // namespace ola
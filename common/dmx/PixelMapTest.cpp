@@ -0,0 +1,269 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PixelMapTest.cpp
+ * Test fixture for the PixelMap class and the gather kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ola/DmxBuffer.h"
+#include "ola/base/Array.h"
+#include "ola/dmx/PixelMap.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::dmx::GetPixelGatherFunction;
+using ola::dmx::PixelGatherFunction;
+using ola::dmx::PixelGatherImplementation;
+using ola::dmx::PixelMap;
+
+class PixelMapTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PixelMapTest);
+  CPPUNIT_TEST(testScalarGather);
+  CPPUNIT_TEST(testDefault);
+  CPPUNIT_TEST(testImplementations);
+  CPPUNIT_TEST(testColorTable);
+  CPPUNIT_TEST(testAddRun);
+  CPPUNIT_TEST(testMap);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testScalarGather();
+    void testDefault();
+    void testImplementations();
+    void testColorTable();
+    void testAddRun();
+    void testMap();
+
+ private:
+    void checkImplementation(PixelGatherImplementation implementation);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PixelMapTest);
+
+
+/*
+ * Check the scalar kernel against hand computed results.
+ */
+void PixelMapTest::testScalarGather() {
+  PixelGatherFunction gather = GetPixelGatherFunction(
+      ola::dmx::PIXEL_GATHER_SCALAR);
+  OLA_ASSERT_NOT_NULL(gather);
+
+  const uint8_t source[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  uint8_t dest[9];
+
+  gather(ola::dmx::COLOR_ORDER_RGB, dest, source, 3, 3);
+  OLA_ASSERT_DATA_EQUALS(source, sizeof(source), dest, sizeof(dest));
+
+  gather(ola::dmx::COLOR_ORDER_GRB, dest, source, 3, 3);
+  const uint8_t grb[] = {2, 1, 3, 5, 4, 6, 8, 7, 9};
+  OLA_ASSERT_DATA_EQUALS(grb, sizeof(grb), dest, sizeof(dest));
+
+  // Every other pixel, backwards
+  gather(ola::dmx::COLOR_ORDER_BGR, dest, source + 6, -6, 2);
+  const uint8_t reversed[] = {9, 8, 7, 3, 2, 1};
+  OLA_ASSERT_DATA_EQUALS(reversed, sizeof(reversed), dest, sizeof(reversed));
+}
+
+
+/*
+ * Check the default implementation is always available.
+ */
+void PixelMapTest::testDefault() {
+  OLA_ASSERT_NOT_NULL(
+      GetPixelGatherFunction(ola::dmx::DefaultPixelGatherImplementation()));
+  checkImplementation(ola::dmx::DefaultPixelGatherImplementation());
+}
+
+
+/*
+ * Check every implementation this build & CPU supports matches the scalar
+ * kernel.
+ */
+void PixelMapTest::testImplementations() {
+  checkImplementation(ola::dmx::PIXEL_GATHER_SSSE3);
+  checkImplementation(ola::dmx::PIXEL_GATHER_NEON);
+}
+
+
+/*
+ * Compare an implementation against the scalar kernel, for every color order
+ * and for pixel counts that don't line up with the vector width.
+ */
+void PixelMapTest::checkImplementation(
+    PixelGatherImplementation implementation) {
+  PixelGatherFunction gather = GetPixelGatherFunction(implementation);
+  if (!gather) {
+    return;
+  }
+  PixelGatherFunction scalar_gather = GetPixelGatherFunction(
+      ola::dmx::PIXEL_GATHER_SCALAR);
+
+  const unsigned int pixel_counts[] = {0, 1, 5, 6, 7, 15, 16, 17, 33, 170};
+  const int strides[] = {3, 6, -3};
+  const unsigned int max_pixels = 170;
+  uint8_t source[max_pixels * 6];
+  uint8_t expected[max_pixels * 3 + 1];
+  uint8_t actual[max_pixels * 3 + 1];
+
+  srand(implementation);
+  for (unsigned int i = 0; i < sizeof(source); i++) {
+    source[i] = rand() % 256;  // NOLINT(runtime/threadsafe_fn)
+  }
+
+  for (unsigned int order = ola::dmx::COLOR_ORDER_RGB;
+       order <= ola::dmx::COLOR_ORDER_BGR; order++) {
+    for (unsigned int i = 0; i < arraysize(pixel_counts); i++) {
+      for (unsigned int j = 0; j < arraysize(strides); j++) {
+        const unsigned int pixels = pixel_counts[i];
+        const int stride = strides[j];
+        const uint8_t *start = stride > 0 ? source :
+            source + (max_pixels - 1) * 3;
+        // Check nothing is written past the end.
+        memset(expected, 0xaa, sizeof(expected));
+        memset(actual, 0xaa, sizeof(actual));
+        scalar_gather(static_cast<ola::dmx::ColorOrder>(order), expected,
+                      start, stride, pixels);
+        gather(static_cast<ola::dmx::ColorOrder>(order), actual, start,
+               stride, pixels);
+        OLA_ASSERT_DATA_EQUALS(expected, pixels * 3 + 1, actual,
+                               pixels * 3 + 1);
+      }
+    }
+  }
+}
+
+
+/*
+ * Check the gamma & brightness tables.
+ */
+void PixelMapTest::testColorTable() {
+  uint8_t table[256];
+  OLA_ASSERT_FALSE(ola::dmx::BuildColorTable(1.0, 255, table));
+  for (unsigned int i = 0; i < 256; i++) {
+    OLA_ASSERT_EQ(static_cast<uint8_t>(i), table[i]);
+  }
+
+  OLA_ASSERT_TRUE(ola::dmx::BuildColorTable(1.0, 128, table));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), table[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(64), table[127]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(128), table[255]);
+
+  OLA_ASSERT_TRUE(ola::dmx::BuildColorTable(2.0, 255, table));
+  const uint8_t source[] = {0, 128, 255};
+  uint8_t output[3];
+  ola::dmx::ApplyColorTable(table, output, source, arraysize(source));
+  const uint8_t expected[] = {0, 64, 255};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output, sizeof(output));
+}
+
+
+/*
+ * Check invalid runs are rejected.
+ */
+void PixelMapTest::testAddRun() {
+  PixelMap map(10, 4);
+  OLA_ASSERT_EQ(120u, map.FrameSize());
+
+  PixelMap::Run run;
+  run.universe = 1;
+  // No pixels
+  OLA_ASSERT_FALSE(map.AddRun(run));
+
+  run.count = 10;
+  OLA_ASSERT_TRUE(map.AddRun(run));
+
+  // Off the right hand side
+  run.x = 1;
+  OLA_ASSERT_FALSE(map.AddRun(run));
+
+  // Off the bottom
+  run.x = 0;
+  run.x_step = 0;
+  run.y_step = 1;
+  run.count = 5;
+  OLA_ASSERT_FALSE(map.AddRun(run));
+
+  // Off the top
+  run.y = 3;
+  run.y_step = -1;
+  run.count = 4;
+  OLA_ASSERT_TRUE(map.AddRun(run));
+  run.count = 5;
+  OLA_ASSERT_FALSE(map.AddRun(run));
+
+  // Past the end of the universe
+  run.y = 0;
+  run.count = 1;
+  run.start_slot = 510;
+  OLA_ASSERT_FALSE(map.AddRun(run));
+  run.start_slot = 509;
+  OLA_ASSERT_TRUE(map.AddRun(run));
+
+  OLA_ASSERT_EQ(static_cast<size_t>(3), map.Runs().size());
+  OLA_ASSERT_EQ(1u, map.UniverseCount());
+}
+
+
+/*
+ * Check a snake layout across two universes.
+ */
+void PixelMapTest::testMap() {
+  PixelMap map(3, 2);
+
+  // Row 0 left to right, then row 1 right to left in GRB.
+  PixelMap::Run run;
+  run.universe = 5;
+  run.count = 3;
+  OLA_ASSERT_TRUE(map.AddRun(run));
+
+  run.universe = 6;
+  run.start_slot = 1;
+  run.x = 2;
+  run.y = 1;
+  run.x_step = -1;
+  run.order = ola::dmx::COLOR_ORDER_GRB;
+  OLA_ASSERT_TRUE(map.AddRun(run));
+  OLA_ASSERT_EQ(2u, map.UniverseCount());
+  OLA_ASSERT_EQ(5u, map.UniverseId(0));
+  OLA_ASSERT_EQ(6u, map.UniverseId(1));
+
+  uint8_t frame[18];
+  for (unsigned int i = 0; i < sizeof(frame); i++) {
+    frame[i] = i + 1;
+  }
+  OLA_ASSERT_FALSE(map.Map(frame, sizeof(frame) - 1));
+  OLA_ASSERT_TRUE(map.Map(frame, sizeof(frame)));
+
+  DmxBuffer expected;
+  expected.SetFromString("1,2,3,4,5,6,7,8,9");
+  OLA_ASSERT_EQ(expected, map.UniverseData(0));
+  expected.SetFromString("0,17,16,18,14,13,15,11,10,12");
+  OLA_ASSERT_EQ(expected, map.UniverseData(1));
+
+  // Brightness applies to every universe.
+  map.SetColorCorrection(1.0, 0);
+  OLA_ASSERT_TRUE(map.Map(frame, sizeof(frame)));
+  expected.SetFromString("0,0,0,0,0,0,0,0,0");
+  OLA_ASSERT_EQ(expected, map.UniverseData(0));
+  expected.SetFromString("0,0,0,0,0,0,0,0,0,0");
+  OLA_ASSERT_EQ(expected, map.UniverseData(1));
+}
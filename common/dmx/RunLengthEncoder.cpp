@@ -16,107 +16,229 @@
  * RunLengthEncoder.cpp
  * The Run Length Encoder
  * Copyright (C) 2005 Simon Newton
+ *
+ * The encoder spends most of its time finding where runs start and end. Both
+ * scans compare 16 slots at a time with SSE2 or NEON, which are part of the
+ * base x86-64 and AArch64 instruction sets, and fall back to a byte at a time
+ * for the tail of the frame.
+ *
+ * The decoder expands the frame into a buffer on the stack with memset &
+ * memcpy and then copies it into the DmxBuffer in a single call.
  */
 
 #include <string.h>
-#include <ola/dmx/RunLengthEncoder.h>
+#include <algorithm>
+
+#include "ola/Constants.h"
+#include "ola/dmx/RunLengthEncoder.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define OLA_RLE_SSE2 1
+#include <emmintrin.h>
+#endif  // x86 && __SSE2__
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && \
+    defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define OLA_RLE_NEON 1
+#include <arm_neon.h>
+#endif  // __ARM_NEON && little endian
 
 namespace ola {
 namespace dmx {
 
+namespace {
+
+// The largest run or literal segment, the top bit of the length is the
+// repeat flag.
+const unsigned int MAX_SEGMENT_LENGTH = 0x7f;
+const unsigned int WIDTH = 16;
+
+#ifdef OLA_RLE_SSE2
+inline unsigned int EqualMask(__m128i a, __m128i b) {
+  return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+}
+
+inline __m128i Load(const uint8_t *data) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+#endif  // OLA_RLE_SSE2
+
+#ifdef OLA_RLE_NEON
+/*
+ * Narrow a byte mask to 4 bits per byte, so the index of the first set byte is
+ * the number of trailing zeros / 4.
+ */
+inline uint64_t NarrowMask(uint8x16_t mask) {
+  return vget_lane_u64(vreinterpret_u64_u8(
+      vshrn_n_u16(vreinterpretq_u16_u8(mask), 4)), 0);
+}
+#endif  // OLA_RLE_NEON
+
+/*
+ * Return the index of the first slot in [start, end) that doesn't match
+ * data[value_index].
+ */
+unsigned int FindRunEnd(const uint8_t *data, unsigned int value_index,
+                        unsigned int start, unsigned int end) {
+  const uint8_t value = data[value_index];
+  unsigned int i = start;
+#if defined(OLA_RLE_SSE2)
+  const __m128i values = _mm_set1_epi8(static_cast<char>(value));
+  for (; i + WIDTH <= end; i += WIDTH) {
+    unsigned int mask = EqualMask(Load(data + i), values);
+    if (mask != 0xffff) {
+      return i + __builtin_ctz(~mask);
+    }
+  }
+#elif defined(OLA_RLE_NEON)
+  const uint8x16_t values = vdupq_n_u8(value);
+  for (; i + WIDTH <= end; i += WIDTH) {
+    uint64_t mask = ~NarrowMask(vceqq_u8(vld1q_u8(data + i), values));
+    if (mask) {
+      return i + __builtin_ctzll(mask) / 4;
+    }
+  }
+#endif  // OLA_RLE_SSE2
+  while (i < end && data[i] == value) {
+    i++;
+  }
+  return i;
+}
+
+/*
+ * Return the index of the first slot in [start, end) that begins a run of at
+ * least 3 slots, or end if there isn't one. size is the size of the frame.
+ */
+unsigned int FindRunStart(const uint8_t *data, unsigned int start,
+                          unsigned int end, unsigned int size) {
+  unsigned int i = start;
+#if defined(OLA_RLE_SSE2)
+  for (; i + WIDTH <= end && i + WIDTH + 2 <= size; i += WIDTH) {
+    const __m128i a = Load(data + i);
+    unsigned int mask = EqualMask(a, Load(data + i + 1)) &
+                        EqualMask(a, Load(data + i + 2));
+    if (mask) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+#elif defined(OLA_RLE_NEON)
+  for (; i + WIDTH <= end && i + WIDTH + 2 <= size; i += WIDTH) {
+    const uint8x16_t a = vld1q_u8(data + i);
+    uint64_t mask = NarrowMask(vandq_u8(vceqq_u8(a, vld1q_u8(data + i + 1)),
+                                        vceqq_u8(a, vld1q_u8(data + i + 2))));
+    if (mask) {
+      return i + __builtin_ctzll(mask) / 4;
+    }
+  }
+#endif  // OLA_RLE_SSE2
+  for (; i < end; i++) {
+    if (i + 2 < size && data[i] == data[i + 1] && data[i] == data[i + 2]) {
+      return i;
+    }
+  }
+  return end;
+}
+}  // namespace
+
+
 bool RunLengthEncoder::Encode(const DmxBuffer &src,
                               uint8_t *data,
                               unsigned int *data_size) {
-  unsigned int src_size = src.Size();
-  unsigned int dst_size = *data_size;
+  const uint8_t *src_data = src.GetRaw();
+  const unsigned int src_size = src.Size();
+  const unsigned int dst_size = *data_size;
   unsigned int &dst_index = *data_size;
   dst_index = 0;
 
-  unsigned int i;
-  for (i = 0; i < src_size && dst_index < dst_size;) {
+  unsigned int i = 0;
+  while (i < src_size && dst_index < dst_size) {
+    const unsigned int limit = std::min(src_size, i + MAX_SEGMENT_LENGTH);
+
     // j points to the first non-repeating value
-    unsigned int j = i + 1;
-    while (j < src_size && src.Get(i) == src.Get(j) && j - i < 0x7f) {
-      j++;
-    }
+    unsigned int j = FindRunEnd(src_data, i, i + 1, limit);
 
-    // if the number of repeats is more than 2
     // don't encode only two repeats,
     if (j - i > 2) {
       // if room left in dst buffer
       if (dst_size - dst_index > 1) {
         data[dst_index++] = (REPEAT_FLAG | (j - i));
-        data[dst_index++] = src.Get(i);
+        data[dst_index++] = src_data[i];
       } else {
         // else return what we have done so far
         return false;
       }
       i = j;
+      continue;
+    }
+
+    // this value doesn't repeat more than twice, the literal runs until the
+    // next run of 3 or more.
+    j = FindRunStart(src_data, i + 1, limit, src_size);
 
+    // if we have enough room left for all the values
+    if (dst_index + j - i < dst_size) {
+      data[dst_index++] = j - i;
+      memcpy(&data[dst_index], src_data + i, j - i);
+      dst_index += j - i;
+      i = j;
+
+    // see how much data we can get in
+    } else if (dst_size - dst_index > 1) {
+      unsigned int l = dst_size - dst_index - 1;
+      data[dst_index++] = l;
+      memcpy(&data[dst_index], src_data + i, l);
+      dst_index += l;
+      return false;
     } else {
-      // this value doesn't repeat more than twice
-      // find out where the next repeat starts
-
-      // postcondition: j is one more than the last value we want to send
-      for (j = i + 1; j < src_size - 2 && j - i < 0x7f; j++) {
-        // at the end  of the array
-        if (j == src_size - 2) {
-          j = src_size;
-          break;
-        }
-
-        // if we're found a repeat of 3 or more stop here
-        if (src.Get(j) == src.Get(j+1) && src.Get(j) == src.Get(j+2))
-          break;
-      }
-      if (j >= src_size - 2)
-        j = src_size;
-
-      // if we have enough room left for all the values
-      if (dst_index + j - i < dst_size) {
-        data[dst_index++] = j - i;
-        memcpy(&data[dst_index], src.GetRaw() + i, j-i);
-        dst_index += j - i;
-        i = j;
-
-      // see how much data we can get in
-      } else if (dst_size - dst_index > 1) {
-        unsigned int l = dst_size - dst_index -1;
-        data[dst_index++] = l;
-        memcpy(&data[dst_index], src.GetRaw() + i, l);
-        dst_index += l;
-        return false;
-      } else {
-        return false;
-      }
+      return false;
     }
   }
-
-  if (i < src_size)
-    return false;
-  else
-    return true;
+  return i >= src_size;
 }
 
 bool RunLengthEncoder::Decode(unsigned int start_channel,
                               const uint8_t *src_data,
                               unsigned int length,
                               DmxBuffer *dst) {
-  int destination_index = start_channel;
+  if (start_channel >= DMX_UNIVERSE_SIZE) {
+    return false;
+  }
+
+  uint8_t frame[DMX_UNIVERSE_SIZE];
+  const unsigned int capacity = DMX_UNIVERSE_SIZE - start_channel;
+  unsigned int frame_size = 0;
+  bool complete = true;
 
   for (unsigned int i = 0; i < length;) {
     unsigned int segment_length = src_data[i] & (~REPEAT_FLAG);
-    if (src_data[i] & REPEAT_FLAG) {
-      i++;
-      dst->SetRangeToValue(destination_index, src_data[i++], segment_length);
+    const bool repeat = src_data[i] & REPEAT_FLAG;
+    i++;
+    if (repeat) {
+      if (i == length) {
+        complete = false;
+        break;
+      }
+      const unsigned int count = std::min(segment_length,
+                                          capacity - frame_size);
+      memset(frame + frame_size, src_data[i++], count);
+      frame_size += count;
     } else {
-      i++;
-      dst->SetRange(destination_index, src_data + i, segment_length);
+      if (segment_length > length - i) {
+        segment_length = length - i;
+        complete = false;
+      }
+      const unsigned int count = std::min(segment_length,
+                                          capacity - frame_size);
+      memcpy(frame + frame_size, src_data + i, count);
+      frame_size += count;
       i += segment_length;
     }
-    destination_index += segment_length;
   }
-  return true;
+
+  if (frame_size) {
+    dst->SetRange(start_channel, frame, frame_size);
+  }
+  return complete;
 }
 }  // namespace dmx
 }  // namespace ola
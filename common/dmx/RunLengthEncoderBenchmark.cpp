@@ -0,0 +1,103 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RunLengthEncoderBenchmark.cpp
+ * Microbenchmarks for the RunLengthEncoder class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iostream>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/RunLengthEncoder.h"
+#include "ola/testing/Benchmark.h"
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::dmx::RunLengthEncoder;
+using ola::testing::Benchmark;
+
+namespace {
+
+/*
+ * The frames used by the benchmarks, the param of each result is the frame.
+ */
+enum FrameType {
+  FRAME_BLACKOUT = 0,  // a single long run
+  FRAME_RIG = 1,  // 16 slot fixtures, with most of the slots at the same value
+  FRAME_NOISE = 2,  // no runs at all
+};
+
+class RunLengthEncoderBenchmark {
+ public:
+  explicit RunLengthEncoderBenchmark(FrameType type) {
+    uint8_t data[ola::DMX_UNIVERSE_SIZE];
+    for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+      switch (type) {
+        case FRAME_BLACKOUT:
+          data[i] = 0;
+          break;
+        case FRAME_RIG:
+          data[i] = (i % 16 < 4) ? static_cast<uint8_t>(i * 7) : 0;
+          break;
+        case FRAME_NOISE:
+          data[i] = static_cast<uint8_t>(i * 7);
+          break;
+      }
+    }
+    m_source.Set(data, sizeof(data));
+    m_encoded_size = sizeof(m_encoded);
+    m_encoder.Encode(m_source, m_encoded, &m_encoded_size);
+  }
+
+  void Encode(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      unsigned int size = sizeof(m_encoded);
+      m_encoder.Encode(m_source, m_encoded, &size);
+    }
+  }
+
+  void Decode(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      m_encoder.Decode(0, m_encoded, m_encoded_size, &m_dest);
+    }
+  }
+
+ private:
+  RunLengthEncoder m_encoder;
+  DmxBuffer m_source;
+  DmxBuffer m_dest;
+  // Large enough for a frame with no runs.
+  uint8_t m_encoded[ola::DMX_UNIVERSE_SIZE + 8];
+  unsigned int m_encoded_size;
+};
+}  // namespace
+
+
+int main() {
+  Benchmark benchmark("RunLengthEncoder", &std::cout);
+  const FrameType types[] = {FRAME_BLACKOUT, FRAME_RIG, FRAME_NOISE};
+  for (unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+    RunLengthEncoderBenchmark fixture(types[i]);
+    benchmark.Run("Encode", types[i],
+                  NewCallback(&fixture, &RunLengthEncoderBenchmark::Encode));
+    benchmark.Run("Decode", types[i],
+                  NewCallback(&fixture, &RunLengthEncoderBenchmark::Decode));
+  }
+  return 0;
+}
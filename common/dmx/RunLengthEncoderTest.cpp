@@ -21,6 +21,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <string.h>
 #include <stdlib.h>
+#include <algorithm>
 
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
@@ -35,11 +36,17 @@ class RunLengthEncoderTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(RunLengthEncoderTest);
   CPPUNIT_TEST(testEncode);
   CPPUNIT_TEST(testEncode2);
+  CPPUNIT_TEST(testEncodeLongLiteral);
+  CPPUNIT_TEST(testDecodeTruncated);
+  CPPUNIT_TEST(testFuzz);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testEncode();
     void testEncode2();
+    void testEncodeLongLiteral();
+    void testDecodeTruncated();
+    void testFuzz();
     void testEncodeDecode();
     void setUp();
     void tearDown();
@@ -53,6 +60,8 @@ class RunLengthEncoderTest: public CppUnit::TestFixture {
                      const uint8_t *expected_data,
                      unsigned int expected_length);
     void checkEncodeDecode(const uint8_t *data, unsigned int data_size);
+    bool ReferenceEncode(const uint8_t *src, unsigned int src_size,
+                         uint8_t *data, unsigned int *data_size);
 };
 
 
@@ -167,3 +176,171 @@ void RunLengthEncoderTest::testEncodeDecode() {
   checkEncodeDecode(TEST_DATA2, sizeof(TEST_DATA2));
   checkEncodeDecode(TEST_DATA3, sizeof(TEST_DATA3));
 }
+
+
+/*
+ * Check that a literal segment is never longer than 127 slots, since the top
+ * bit of the length is the repeat flag.
+ */
+void RunLengthEncoderTest::testEncodeLongLiteral() {
+  uint8_t data[128];
+  for (unsigned int i = 0; i < sizeof(data); i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  DmxBuffer buffer(data, sizeof(data));
+  unsigned int dst_size = ola::DMX_UNIVERSE_SIZE;
+  OLA_ASSERT_TRUE(m_encoder.Encode(buffer, m_dst, &dst_size));
+  OLA_ASSERT_EQ(130u, dst_size);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(127), m_dst[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), m_dst[128]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(127), m_dst[129]);
+
+  DmxBuffer output;
+  OLA_ASSERT_TRUE(m_encoder.Decode(0, m_dst, dst_size, &output));
+  OLA_ASSERT_DATA_EQUALS(data, sizeof(data), output.GetRaw(), sizeof(data));
+
+  // A single slot
+  DmxBuffer single(data, 1);
+  const uint8_t expected[] = {1, 0};
+  checkEncode(single, ola::DMX_UNIVERSE_SIZE, true, expected,
+              sizeof(expected));
+}
+
+
+/*
+ * Check that truncated frames are rejected, and the data before the truncated
+ * segment is kept. Decoding into an empty buffer blacks it out first.
+ */
+void RunLengthEncoderTest::testDecodeTruncated() {
+  const uint8_t truncated_repeat[] = {0x83, 5, 0x82};
+  DmxBuffer output;
+  OLA_ASSERT_FALSE(m_encoder.Decode(0, truncated_repeat,
+                                    sizeof(truncated_repeat), &output));
+  const uint8_t expected[] = {5, 5, 5, 0};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output.GetRaw(),
+                         sizeof(expected));
+
+  const uint8_t truncated_literal[] = {4, 1, 2};
+  OLA_ASSERT_FALSE(m_encoder.Decode(1, truncated_literal,
+                                    sizeof(truncated_literal), &output));
+  const uint8_t expected2[] = {5, 1, 2, 0};
+  OLA_ASSERT_DATA_EQUALS(expected2, sizeof(expected2), output.GetRaw(),
+                         sizeof(expected2));
+
+  // Segments past the end of the universe are dropped.
+  const uint8_t long_frame[] = {0xff, 1, 0xff, 2, 0xff, 3, 0xff, 4, 0xff, 5};
+  OLA_ASSERT_TRUE(m_encoder.Decode(0, long_frame, sizeof(long_frame),
+                                   &output));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(4), output.Get(507));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(5), output.Get(508));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(5), output.Get(511));
+  OLA_ASSERT_FALSE(m_encoder.Decode(ola::DMX_UNIVERSE_SIZE, long_frame,
+                                    sizeof(long_frame), &output));
+}
+
+
+/*
+ * A byte at a time version of the encoder.
+ */
+bool RunLengthEncoderTest::ReferenceEncode(const uint8_t *src,
+                                           unsigned int src_size,
+                                           uint8_t *data,
+                                           unsigned int *data_size) {
+  const unsigned int dst_size = *data_size;
+  unsigned int dst_index = 0;
+  unsigned int i = 0;
+  bool complete = true;
+  while (i < src_size) {
+    if (dst_index >= dst_size) {
+      complete = false;
+      break;
+    }
+    const unsigned int limit = std::min(src_size, i + 0x7f);
+    unsigned int j = i + 1;
+    while (j < limit && src[j] == src[i]) {
+      j++;
+    }
+
+    if (j - i > 2) {
+      if (dst_size - dst_index < 2) {
+        complete = false;
+        break;
+      }
+      data[dst_index++] = 0x80 | (j - i);
+      data[dst_index++] = src[i];
+      i = j;
+      continue;
+    }
+
+    for (j = i + 1; j < limit; j++) {
+      if (j + 2 < src_size && src[j] == src[j + 1] && src[j] == src[j + 2]) {
+        break;
+      }
+    }
+    if (dst_index + j - i < dst_size) {
+      data[dst_index++] = j - i;
+      for (; i < j; i++) {
+        data[dst_index++] = src[i];
+      }
+    } else {
+      if (dst_size - dst_index > 1) {
+        unsigned int l = dst_size - dst_index - 1;
+        data[dst_index++] = l;
+        for (unsigned int k = 0; k < l; k++) {
+          data[dst_index++] = src[i + k];
+        }
+      }
+      complete = false;
+      break;
+    }
+  }
+  *data_size = dst_index;
+  return complete;
+}
+
+
+/*
+ * Compare the encoder with the reference encoder for random frames, and check
+ * the frames decode to the original data.
+ */
+void RunLengthEncoderTest::testFuzz() {
+  srand(42);
+  uint8_t frame[ola::DMX_UNIVERSE_SIZE];
+  uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+
+  for (unsigned int iteration = 0; iteration < 2000; iteration++) {
+    // Build a frame from a mix of runs and random values, like a rig of
+    // fixtures where many channels share a value.
+    const unsigned int size = rand() % (ola::DMX_UNIVERSE_SIZE + 1);
+    unsigned int i = 0;
+    while (i < size) {
+      const unsigned int length = std::min(
+          size - i, static_cast<unsigned int>(1 + rand() % 200));
+      if (rand() % 2) {
+        memset(frame + i, rand() % 4, length);
+      } else {
+        for (unsigned int j = 0; j < length; j++) {
+          frame[i + j] = rand() % 3;
+        }
+      }
+      i += length;
+    }
+    DmxBuffer buffer(frame, size);
+
+    unsigned int dst_size = (iteration % 4) ? ola::DMX_UNIVERSE_SIZE :
+                                              rand() % 64;
+    unsigned int expected_size = dst_size;
+    const bool expected_complete = ReferenceEncode(frame, size, expected,
+                                                   &expected_size);
+    OLA_ASSERT_EQ(expected_complete,
+                  m_encoder.Encode(buffer, m_dst, &dst_size));
+    OLA_ASSERT_EQ(expected_size, dst_size);
+    OLA_ASSERT_DATA_EQUALS(expected, expected_size, m_dst, dst_size);
+
+    if (expected_complete) {
+      DmxBuffer output;
+      OLA_ASSERT_TRUE(m_encoder.Decode(0, m_dst, dst_size, &output));
+      OLA_ASSERT_DATA_EQUALS(frame, size, output.GetRaw(), size);
+    }
+  }
+}
@@ -0,0 +1,350 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedMemoryFrames.cpp
+ * DMX512 frames passed between processes through shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // HAVE_SYS_MMAN_H
+
+#ifdef HAVE_LINUX_FUTEX_H
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif  // HAVE_LINUX_FUTEX_H
+
+#include <algorithm>
+#include <string>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/dmx/SharedMemoryFrames.h"
+#include "ola/strings/Format.h"
+
+namespace ola {
+namespace dmx {
+
+using std::string;
+
+const char SharedMemoryFrames::K_NAME_PREFIX[] = "/ola-dmx-";
+
+namespace {
+const uint32_t K_SEGMENT_MAGIC = 0x4f4c4153;  // OLAS
+const uint16_t K_SEGMENT_VERSION = 1;
+}  // namespace
+
+/*
+ * The segment starts with a header, followed by the slots. Both are padded to
+ * a multiple of the cache line size so the slots don't share lines.
+ */
+struct SharedMemoryFrames::SegmentHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t slot_count;
+  uint32_t slot_size;
+  // Incremented after each frame is written. Segments created by older
+  // writers leave this as 0.
+  uint32_t frame_count;
+  uint8_t padding[44];
+};
+
+struct SharedMemoryFrames::FrameSlot {
+  uint32_t sequence;
+  uint32_t universe;
+  uint16_t length;
+  uint8_t priority;
+  uint8_t in_use;
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  uint8_t padding[52];
+};
+
+SharedMemoryFrames::SharedMemoryFrames(const string &name,
+                                       bool writer,
+                                       uint8_t *segment,
+                                       size_t segment_size)
+    : m_name(name),
+      m_writer(writer),
+      m_segment(segment),
+      m_segment_size(segment_size),
+      m_slot_count(reinterpret_cast<SegmentHeader*>(segment)->slot_count),
+      m_slots(reinterpret_cast<FrameSlot*>(segment + sizeof(SegmentHeader))),
+      m_read_sequences(m_slot_count, 0) {
+}
+
+SharedMemoryFrames::~SharedMemoryFrames() {
+#ifdef HAVE_SYS_MMAN_H
+  munmap(m_segment, m_segment_size);
+  if (m_writer) {
+    shm_unlink(m_name.c_str());
+  }
+#endif  // HAVE_SYS_MMAN_H
+}
+
+SharedMemoryFrames *SharedMemoryFrames::Create(const string &name,
+                                               unsigned int slot_count,
+                                               bool replace) {
+  if (!ValidName(name) || slot_count == 0 || slot_count > MAX_SLOTS) {
+    OLA_WARN << "Invalid shared memory segment " << name << " with "
+             << slot_count << " slots";
+    return NULL;
+  }
+
+#ifdef HAVE_SYS_MMAN_H
+  if (replace) {
+    shm_unlink(name.c_str());
+  }
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << ") failed: " << strerror(errno);
+    return NULL;
+  }
+
+  const size_t size = SegmentSize(slot_count);
+  if (ftruncate(fd, size)) {
+    OLA_WARN << "ftruncate(" << name << ") failed: " << strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  void *segment = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << ") failed: " << strerror(errno);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  // ftruncate zero fills the segment, so all the slots start unused.
+  SegmentHeader *header = reinterpret_cast<SegmentHeader*>(segment);
+  header->magic = K_SEGMENT_MAGIC;
+  header->version = K_SEGMENT_VERSION;
+  header->slot_count = slot_count;
+  header->slot_size = sizeof(FrameSlot);
+  return new SharedMemoryFrames(name, true, static_cast<uint8_t*>(segment),
+                                size);
+#else
+  OLA_WARN << "Shared memory isn't supported on this platform";
+  return NULL;
+#endif  // HAVE_SYS_MMAN_H
+}
+
+SharedMemoryFrames *SharedMemoryFrames::Open(const string &name) {
+  if (!ValidName(name)) {
+    OLA_WARN << "Invalid shared memory segment " << name;
+    return NULL;
+  }
+
+#ifdef HAVE_SYS_MMAN_H
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << ") failed: " << strerror(errno);
+    return NULL;
+  }
+
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) ||
+      static_cast<size_t>(stat_buf.st_size) < sizeof(SegmentHeader)) {
+    OLA_WARN << "Shared memory segment " << name << " is too small";
+    close(fd);
+    return NULL;
+  }
+
+  const size_t size = stat_buf.st_size;
+  void *segment = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << ") failed: " << strerror(errno);
+    return NULL;
+  }
+
+  const SegmentHeader *header = reinterpret_cast<SegmentHeader*>(segment);
+  if (header->magic != K_SEGMENT_MAGIC ||
+      header->version != K_SEGMENT_VERSION ||
+      header->slot_size != sizeof(FrameSlot) ||
+      header->slot_count == 0 ||
+      header->slot_count > MAX_SLOTS ||
+      size < SegmentSize(header->slot_count)) {
+    OLA_WARN << "Shared memory segment " << name << " is invalid";
+    munmap(segment, size);
+    return NULL;
+  }
+  return new SharedMemoryFrames(name, false, static_cast<uint8_t*>(segment),
+                                size);
+#else
+  OLA_WARN << "Shared memory isn't supported on this platform";
+  return NULL;
+#endif  // HAVE_SYS_MMAN_H
+}
+
+string SharedMemoryFrames::UniqueName() {
+  static unsigned int counter = 0;
+  string name = K_NAME_PREFIX;
+#ifdef HAVE_SYS_MMAN_H
+  name.append(ola::strings::IntToString(getpid()));
+  name.append("-");
+#endif  // HAVE_SYS_MMAN_H
+  name.append(ola::strings::IntToString(counter++));
+  return name;
+}
+
+bool SharedMemoryFrames::Write(unsigned int universe,
+                               uint8_t priority,
+                               const DmxBuffer &data) {
+  if (!m_writer) {
+    return false;
+  }
+
+  std::map<unsigned int, unsigned int>::iterator iter =
+      m_universe_slots.find(universe);
+  if (iter == m_universe_slots.end()) {
+    if (m_universe_slots.size() >= m_slot_count) {
+      return false;
+    }
+    unsigned int slot_index = m_universe_slots.size();
+    iter = m_universe_slots.insert(
+        std::make_pair(universe, slot_index)).first;
+  }
+
+  FrameSlot *slot = &m_slots[iter->second];
+  // Only the writer modifies the sequence, so a relaxed load is enough.
+  uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->sequence, sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  slot->universe = universe;
+  slot->priority = priority;
+  slot->in_use = 1;
+  slot->length = data.Size();
+  if (data.Size()) {
+    memcpy(slot->data, data.GetRaw(), data.Size());
+  }
+
+  __atomic_store_n(&slot->sequence, sequence + 2, __ATOMIC_RELEASE);
+  __atomic_fetch_add(&Header()->frame_count, 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+bool SharedMemoryFrames::Read(unsigned int slot_index, Frame *frame) {
+  if (slot_index >= m_slot_count) {
+    return false;
+  }
+
+  const FrameSlot *slot = &m_slots[slot_index];
+  const uint32_t sequence = __atomic_load_n(&slot->sequence,
+                                            __ATOMIC_ACQUIRE);
+  if ((sequence & 1) || sequence == m_read_sequences[slot_index]) {
+    return false;
+  }
+
+  // The writer may be part way through the next frame, so copy everything
+  // out before checking the sequence hasn't changed.
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  const unsigned int universe = slot->universe;
+  const uint8_t priority = slot->priority;
+  const bool in_use = slot->in_use;
+  const unsigned int length = std::min(
+      static_cast<unsigned int>(slot->length),
+      static_cast<unsigned int>(DMX_UNIVERSE_SIZE));
+  memcpy(data, slot->data, length);
+
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != sequence) {
+    return false;
+  }
+
+  m_read_sequences[slot_index] = sequence;
+  if (!in_use) {
+    return false;
+  }
+  frame->universe = universe;
+  frame->priority = priority;
+  frame->data.Set(data, length);
+  return true;
+}
+
+uint32_t SharedMemoryFrames::FrameCount() const {
+  return __atomic_load_n(&Header()->frame_count, __ATOMIC_ACQUIRE);
+}
+
+void SharedMemoryFrames::WakeReaders() {
+#ifdef HAVE_LINUX_FUTEX_H
+  if (m_writer) {
+    syscall(SYS_futex, &Header()->frame_count, FUTEX_WAKE, INT_MAX, NULL,
+            NULL, 0);
+  }
+#endif  // HAVE_LINUX_FUTEX_H
+}
+
+bool SharedMemoryFrames::WaitForFrame(uint32_t frame_count,
+                                      const TimeInterval &timeout) {
+  MonotonicClock clock;
+  TimeStamp now;
+  clock.CurrentTime(&now);
+  const TimeStamp deadline = now + timeout;
+
+  while (FrameCount() == frame_count) {
+    clock.CurrentTime(&now);
+    if (now >= deadline) {
+      return false;
+    }
+    const TimeInterval remaining = deadline - now;
+#ifdef HAVE_LINUX_FUTEX_H
+    struct timespec wait;
+    wait.tv_sec = remaining.Seconds();
+    wait.tv_nsec = remaining.MicroSeconds() * ONE_THOUSAND;
+    // The segment is mapped read-only, so this has to be a shared futex. It
+    // returns straight away if the count has already changed.
+    syscall(SYS_futex, &Header()->frame_count, FUTEX_WAIT, frame_count,
+            &wait, NULL, 0);
+#else
+    usleep(std::min(remaining.AsInt(), static_cast<int64_t>(ONE_THOUSAND)));
+#endif  // HAVE_LINUX_FUTEX_H
+  }
+  return true;
+}
+
+bool SharedMemoryFrames::ValidName(const string &name) {
+  return name.size() > sizeof(K_NAME_PREFIX) - 1 &&
+         name.compare(0, sizeof(K_NAME_PREFIX) - 1, K_NAME_PREFIX) == 0 &&
+         name.find('/', 1) == string::npos;
+}
+
+SharedMemoryFrames::SegmentHeader *SharedMemoryFrames::Header() const {
+  return reinterpret_cast<SegmentHeader*>(m_segment);
+}
+
+size_t SharedMemoryFrames::SegmentSize(unsigned int slot_count) {
+  return sizeof(SegmentHeader) + slot_count * sizeof(FrameSlot);
+}
+}  // namespace dmx
+}  // namespace ola
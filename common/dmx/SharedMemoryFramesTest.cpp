@@ -0,0 +1,213 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedMemoryFramesTest.cpp
+ * Test fixture for the SharedMemoryFrames class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/SharedMemoryFrames.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::DmxBuffer;
+using ola::dmx::SharedMemoryFrames;
+using std::auto_ptr;
+using std::string;
+
+class SharedMemoryFramesTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SharedMemoryFramesTest);
+  CPPUNIT_TEST(testInvalidNames);
+  CPPUNIT_TEST(testWriteAndRead);
+  CPPUNIT_TEST(testSlotsExhausted);
+  CPPUNIT_TEST(testFrameCount);
+  CPPUNIT_TEST(testReplace);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testInvalidNames();
+  void testWriteAndRead();
+  void testSlotsExhausted();
+  void testFrameCount();
+  void testReplace();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SharedMemoryFramesTest);
+
+
+/*
+ * Check that segments outside our prefix are rejected.
+ */
+void SharedMemoryFramesTest::testInvalidNames() {
+  OLA_ASSERT_NULL(SharedMemoryFrames::Create("/foo"));
+  OLA_ASSERT_NULL(
+      SharedMemoryFrames::Create(SharedMemoryFrames::K_NAME_PREFIX));
+  OLA_ASSERT_NULL(SharedMemoryFrames::Open("/foo"));
+  OLA_ASSERT_NULL(SharedMemoryFrames::Open(
+      string(SharedMemoryFrames::K_NAME_PREFIX) + "a/b"));
+  OLA_ASSERT_NULL(SharedMemoryFrames::Create(SharedMemoryFrames::UniqueName(),
+                                             0));
+}
+
+
+/*
+ * Check that frames written by one side are read by the other.
+ */
+void SharedMemoryFramesTest::testWriteAndRead() {
+#ifdef HAVE_SYS_MMAN_H
+  auto_ptr<SharedMemoryFrames> writer(
+      SharedMemoryFrames::Create(SharedMemoryFrames::UniqueName(), 4));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  OLA_ASSERT_EQ(4u, writer->SlotCount());
+
+  // The name is unique, so creating it again fails.
+  OLA_ASSERT_NULL(SharedMemoryFrames::Create(writer->Name()));
+
+  auto_ptr<SharedMemoryFrames> reader(
+      SharedMemoryFrames::Open(writer->Name()));
+  OLA_ASSERT_NOT_NULL(reader.get());
+  OLA_ASSERT_EQ(4u, reader->SlotCount());
+
+  SharedMemoryFrames::Frame frame;
+  for (unsigned int i = 0; i < reader->SlotCount(); i++) {
+    OLA_ASSERT_FALSE(reader->Read(i, &frame));
+  }
+  OLA_ASSERT_FALSE(reader->Read(4, &frame));
+
+  DmxBuffer first, second;
+  first.SetFromString("1,2,3");
+  second.SetFromString("10,20,30,40");
+  OLA_ASSERT_TRUE(writer->Write(5, 100, first));
+  OLA_ASSERT_TRUE(writer->Write(9, 50, second));
+  OLA_ASSERT_FALSE(reader->Write(5, 100, first));
+
+  OLA_ASSERT_TRUE(reader->Read(0, &frame));
+  OLA_ASSERT_EQ(5u, frame.universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), frame.priority);
+  OLA_ASSERT_DATA_EQUALS(first.GetRaw(), first.Size(),
+                         frame.data.GetRaw(), frame.data.Size());
+
+  OLA_ASSERT_TRUE(reader->Read(1, &frame));
+  OLA_ASSERT_EQ(9u, frame.universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(50), frame.priority);
+  OLA_ASSERT_DATA_EQUALS(second.GetRaw(), second.Size(),
+                         frame.data.GetRaw(), frame.data.Size());
+
+  // Nothing has changed
+  OLA_ASSERT_FALSE(reader->Read(0, &frame));
+  OLA_ASSERT_FALSE(reader->Read(1, &frame));
+
+  // Only the latest frame is read
+  OLA_ASSERT_TRUE(writer->Write(5, 100, second));
+  OLA_ASSERT_TRUE(writer->Write(5, 120, first));
+  OLA_ASSERT_TRUE(reader->Read(0, &frame));
+  OLA_ASSERT_EQ(5u, frame.universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(120), frame.priority);
+  OLA_ASSERT_DATA_EQUALS(first.GetRaw(), first.Size(),
+                         frame.data.GetRaw(), frame.data.Size());
+  OLA_ASSERT_FALSE(reader->Read(1, &frame));
+
+  // Once the writer is gone, the segment can't be opened.
+  const string name = writer->Name();
+  writer.reset();
+  OLA_ASSERT_NULL(SharedMemoryFrames::Open(name));
+#endif  // HAVE_SYS_MMAN_H
+}
+
+
+/*
+ * Check that writes fail once all the slots are claimed.
+ */
+void SharedMemoryFramesTest::testSlotsExhausted() {
+#ifdef HAVE_SYS_MMAN_H
+  auto_ptr<SharedMemoryFrames> writer(
+      SharedMemoryFrames::Create(SharedMemoryFrames::UniqueName(), 2));
+  OLA_ASSERT_NOT_NULL(writer.get());
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT_TRUE(writer->Write(1, 100, buffer));
+  OLA_ASSERT_TRUE(writer->Write(2, 100, buffer));
+  OLA_ASSERT_FALSE(writer->Write(3, 100, buffer));
+  OLA_ASSERT_TRUE(writer->Write(1, 100, buffer));
+#endif  // HAVE_SYS_MMAN_H
+}
+
+
+/*
+ * Check the frame counter and waiting for frames.
+ */
+void SharedMemoryFramesTest::testFrameCount() {
+#ifdef HAVE_SYS_MMAN_H
+  auto_ptr<SharedMemoryFrames> writer(
+      SharedMemoryFrames::Create(SharedMemoryFrames::UniqueName(), 2));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  auto_ptr<SharedMemoryFrames> reader(
+      SharedMemoryFrames::Open(writer->Name()));
+  OLA_ASSERT_NOT_NULL(reader.get());
+  OLA_ASSERT_EQ(0u, reader->FrameCount());
+
+  // Nothing has been written, so this times out.
+  OLA_ASSERT_FALSE(reader->WaitForFrame(0, ola::TimeInterval(0, 1000)));
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT_TRUE(writer->Write(1, 100, buffer));
+  OLA_ASSERT_TRUE(writer->Write(2, 100, buffer));
+  writer->WakeReaders();
+  OLA_ASSERT_EQ(2u, reader->FrameCount());
+  OLA_ASSERT_EQ(2u, writer->FrameCount());
+  OLA_ASSERT_TRUE(reader->WaitForFrame(0, ola::TimeInterval(0, 1000)));
+  OLA_ASSERT_FALSE(reader->WaitForFrame(2, ola::TimeInterval(0, 1000)));
+
+  // Failed writes don't count.
+  OLA_ASSERT_FALSE(writer->Write(3, 100, buffer));
+  OLA_ASSERT_EQ(2u, reader->FrameCount());
+#endif  // HAVE_SYS_MMAN_H
+}
+
+
+/*
+ * Check a segment can replace one with the same name.
+ */
+void SharedMemoryFramesTest::testReplace() {
+#ifdef HAVE_SYS_MMAN_H
+  const string name = SharedMemoryFrames::UniqueName();
+  auto_ptr<SharedMemoryFrames> first(SharedMemoryFrames::Create(name, 2));
+  OLA_ASSERT_NOT_NULL(first.get());
+  OLA_ASSERT_NULL(SharedMemoryFrames::Create(name, 4));
+
+  auto_ptr<SharedMemoryFrames> second(
+      SharedMemoryFrames::Create(name, 4, true));
+  OLA_ASSERT_NOT_NULL(second.get());
+
+  auto_ptr<SharedMemoryFrames> reader(SharedMemoryFrames::Open(name));
+  OLA_ASSERT_NOT_NULL(reader.get());
+  OLA_ASSERT_EQ(4u, reader->SlotCount());
+  // first unlinks the name when it's deleted, which is the second segment.
+  first.reset();
+  OLA_ASSERT_NULL(SharedMemoryFrames::Open(name));
+#endif  // HAVE_SYS_MMAN_H
+}
@@ -0,0 +1,146 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SlotRemap.cpp
+ * Move slots around within a universe of DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/StringUtils.h"
+#include "ola/dmx/SlotRemap.h"
+
+namespace ola {
+namespace dmx {
+
+using std::string;
+using std::vector;
+
+bool SlotRemap::AddSpan(unsigned int destination, unsigned int source,
+                        unsigned int length) {
+  if (!length || destination + length > DMX_UNIVERSE_SIZE ||
+      source + length > DMX_UNIVERSE_SIZE) {
+    return false;
+  }
+
+  // Join spans that continue the previous one.
+  if (!m_spans.empty()) {
+    Span &last = m_spans.back();
+    if (last.destination + last.length == destination &&
+        last.source + last.length == source) {
+      last.length += length;
+      return true;
+    }
+  }
+
+  Span span;
+  span.destination = destination;
+  span.source = source;
+  span.length = length;
+  m_spans.push_back(span);
+  return true;
+}
+
+
+bool SlotRemap::FromString(const string &input) {
+  SlotRemap remap;
+  vector<string> spans;
+  StringSplit(input, &spans, ",");
+
+  vector<string>::const_iterator iter = spans.begin();
+  for (; iter != spans.end(); ++iter) {
+    if (iter->empty() && spans.size() == 1) {
+      continue;
+    }
+
+    vector<string> parts;
+    StringSplit(*iter, &parts, "=");
+    vector<string> range;
+    if (parts.size() == 2) {
+      StringSplit(parts[0], &range, "-");
+    }
+
+    unsigned int first, last, source;
+    if (range.empty() || range.size() > 2 ||
+        !StringToInt(range[0], &first) ||
+        !StringToInt(range.back(), &last) ||
+        !StringToInt(parts[1], &source) ||
+        first == 0 || source == 0 || last < first ||
+        !remap.AddSpan(first - 1, source - 1, last - first + 1)) {
+      return false;
+    }
+  }
+  m_spans.swap(remap.m_spans);
+  return true;
+}
+
+
+string SlotRemap::ToString() const {
+  std::ostringstream str;
+  vector<Span>::const_iterator iter = m_spans.begin();
+  for (; iter != m_spans.end(); ++iter) {
+    if (iter != m_spans.begin()) {
+      str << ",";
+    }
+    str << iter->destination + 1;
+    if (iter->length > 1) {
+      str << "-" << iter->destination + iter->length;
+    }
+    str << "=" << iter->source + 1;
+  }
+  return str.str();
+}
+
+
+void SlotRemap::Apply(const DmxBuffer &input, DmxBuffer *output) const {
+  if (m_spans.empty()) {
+    output->Set(input);
+    return;
+  }
+
+  const unsigned int input_size = input.Size();
+  const uint8_t *input_data = input.GetRaw();
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  unsigned int size = 0;
+
+  // Find the output size first, so only the slots in use are cleared.
+  vector<Span>::const_iterator iter = m_spans.begin();
+  for (; iter != m_spans.end(); ++iter) {
+    if (iter->source < input_size) {
+      unsigned int length = std::min<unsigned int>(iter->length,
+                                                   input_size - iter->source);
+      size = std::max(size, iter->destination + length);
+    }
+  }
+
+  memset(data, 0, size);
+  for (iter = m_spans.begin(); iter != m_spans.end(); ++iter) {
+    if (iter->source < input_size) {
+      unsigned int length = std::min<unsigned int>(iter->length,
+                                                   input_size - iter->source);
+      memcpy(data + iter->destination, input_data + iter->source, length);
+    }
+  }
+  output->Set(data, size);
+}
+}  // namespace dmx
+}  // namespace ola
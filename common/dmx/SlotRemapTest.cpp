@@ -0,0 +1,144 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SlotRemapTest.cpp
+ * Test fixture for the SlotRemap class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/SlotRemap.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::DmxBuffer;
+using ola::dmx::SlotRemap;
+using std::string;
+
+class SlotRemapTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SlotRemapTest);
+  CPPUNIT_TEST(testParse);
+  CPPUNIT_TEST(testApply);
+  CPPUNIT_TEST(testShortInput);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testParse();
+  void testApply();
+  void testShortInput();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SlotRemapTest);
+
+
+/*
+ * Check that remaps are parsed & serialized.
+ */
+void SlotRemapTest::testParse() {
+  SlotRemap remap;
+  OLA_ASSERT(remap.Empty());
+  OLA_ASSERT(remap.FromString(""));
+  OLA_ASSERT(remap.Empty());
+
+  OLA_ASSERT(remap.FromString("1-16=101,17=1"));
+  OLA_ASSERT_FALSE(remap.Empty());
+  OLA_ASSERT_EQ(string("1-16=101,17=1"), remap.ToString());
+
+  // Contiguous spans are joined
+  OLA_ASSERT(remap.FromString("1-4=11,5-8=15,9=19"));
+  OLA_ASSERT_EQ(string("1-9=11"), remap.ToString());
+
+  SlotRemap other;
+  OLA_ASSERT(other.FromString("1-9=11"));
+  OLA_ASSERT(remap == other);
+
+  // Invalid remaps don't change the existing one
+  OLA_ASSERT_FALSE(remap.FromString("0=1"));
+  OLA_ASSERT_FALSE(remap.FromString("1=0"));
+  OLA_ASSERT_FALSE(remap.FromString("5-4=1"));
+  OLA_ASSERT_FALSE(remap.FromString("1-513=1"));
+  OLA_ASSERT_FALSE(remap.FromString("11-512=12"));
+  OLA_ASSERT_FALSE(remap.FromString("1-2-3=1"));
+  OLA_ASSERT_FALSE(remap.FromString("1=2,"));
+  OLA_ASSERT_FALSE(remap.FromString("1"));
+  OLA_ASSERT_FALSE(remap.FromString("a=1"));
+  OLA_ASSERT_EQ(string("1-9=11"), remap.ToString());
+
+  remap.Clear();
+  OLA_ASSERT(remap.Empty());
+}
+
+
+/*
+ * Check that remaps are applied.
+ */
+void SlotRemapTest::testApply() {
+  const uint8_t input_data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  DmxBuffer input(input_data, sizeof(input_data));
+  DmxBuffer output;
+
+  // An empty remap copies the data
+  SlotRemap remap;
+  remap.Apply(input, &output);
+  OLA_ASSERT(input == output);
+
+  // Swap the two halves, and leave a gap
+  OLA_ASSERT(remap.FromString("1-4=5,7-10=1"));
+  remap.Apply(input, &output);
+  const uint8_t expected[] = {5, 6, 7, 8, 0, 0, 1, 2, 3, 4};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output.GetRaw(),
+                         output.Size());
+
+  // Later spans win
+  OLA_ASSERT(remap.FromString("1-4=1,2=8"));
+  remap.Apply(input, &output);
+  const uint8_t expected2[] = {1, 8, 3, 4};
+  OLA_ASSERT_DATA_EQUALS(expected2, sizeof(expected2), output.GetRaw(),
+                         output.Size());
+
+  // An offset
+  OLA_ASSERT(remap.FromString("11-512=1"));
+  remap.Apply(input, &output);
+  OLA_ASSERT_EQ(18u, output.Size());
+  OLA_ASSERT_EQ((uint8_t) 0, output.Get(9));
+  OLA_ASSERT_EQ((uint8_t) 1, output.Get(10));
+  OLA_ASSERT_EQ((uint8_t) 8, output.Get(17));
+}
+
+
+/*
+ * Check that spans beyond the end of the input are dropped.
+ */
+void SlotRemapTest::testShortInput() {
+  const uint8_t input_data[] = {1, 2, 3, 4};
+  DmxBuffer input(input_data, sizeof(input_data));
+  DmxBuffer output;
+
+  SlotRemap remap;
+  OLA_ASSERT(remap.FromString("1-2=3,3-4=100,5-8=1"));
+  remap.Apply(input, &output);
+  const uint8_t expected[] = {3, 4, 0, 0, 1, 2, 3, 4};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output.GetRaw(),
+                         output.Size());
+
+  OLA_ASSERT(remap.FromString("1-2=100"));
+  remap.Apply(input, &output);
+  OLA_ASSERT_EQ(0u, output.Size());
+}
@@ -18,6 +18,8 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <string>
 #include <map>
@@ -26,6 +28,7 @@
 #include "ola/ExportMap.h"
 #include "ola/StringUtils.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/util/Histogram.h"
 
 namespace ola {
 
@@ -34,9 +37,167 @@ using std::ostringstream;
 using std::string;
 using std::vector;
 
+namespace {
+
+// The upper bounds of the exported histogram buckets, each is the top of a
+// Histogram bucket so the counts are exact.
+const uint32_t HISTOGRAM_BOUNDS[] = {
+  15, 63, 255, 1023, 4095, 16383, 65535, 262143, 1048575, 4194303, 16777215,
+};
+const unsigned int HISTOGRAM_BOUND_COUNT =
+    sizeof(HISTOGRAM_BOUNDS) / sizeof(HISTOGRAM_BOUNDS[0]);
+
+void AppendUnsigned(uint64_t value, string *output) {
+  char buffer[20];
+  char *ptr = buffer + sizeof(buffer);
+  do {
+    *--ptr = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value);
+  output->append(ptr, buffer + sizeof(buffer) - ptr);
+}
+
+void AppendSigned(int64_t value, string *output) {
+  if (value < 0) {
+    output->push_back('-');
+    AppendUnsigned(~static_cast<uint64_t>(value) + 1, output);
+  } else {
+    AppendUnsigned(value, output);
+  }
+}
+
+/*
+ * Metric & label names may only contain [a-zA-Z0-9_].
+ */
+void AppendName(const string &name, string *output) {
+  for (string::const_iterator iter = name.begin(); iter != name.end();
+       ++iter) {
+    const char c = *iter;
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+        (c >= '0' && c <= '9') || c == '_') {
+      output->push_back(c);
+    } else {
+      output->push_back('_');
+    }
+  }
+}
+
+void AppendLabelValue(const string &value, string *output) {
+  output->push_back('"');
+  for (string::const_iterator iter = value.begin(); iter != value.end();
+       ++iter) {
+    switch (*iter) {
+      case '\\':
+        output->append("\\\\");
+        break;
+      case '"':
+        output->append("\\\"");
+        break;
+      case '\n':
+        output->append("\\n");
+        break;
+      default:
+        output->push_back(*iter);
+    }
+  }
+  output->push_back('"');
+}
+
+/*
+ * Append the # TYPE line and set metric to the full name.
+ */
+void StartFamily(const string &name, const char *type,
+                          string *metric, string *output) {
+  metric->assign("ola_");
+  AppendName(name, metric);
+  output->append("# TYPE ");
+  output->append(*metric);
+  output->push_back(' ');
+  output->append(type);
+  output->push_back('\n');
+}
+
+/*
+ * Append the start of a sample, up to the opening brace of the labels if
+ * there are any.
+ */
+void StartSample(const string &metric, const char *suffix, string *output) {
+  output->append(metric);
+  output->append(suffix);
+}
+
+void AppendLabel(const string &label, const string &value, string *output) {
+  AppendName(label.empty() ? "key" : label, output);
+  output->push_back('=');
+  AppendLabelValue(value, output);
+}
+
+template <typename Type>
+void RenderIntMap(const MapVariable<Type> &var, const char *type,
+                  string *metric, string *output) {
+  StartFamily(var.Name(), type, metric, output);
+  const map<string, Type> &values = var.Values();
+  typename map<string, Type>::const_iterator iter = values.begin();
+  for (; iter != values.end(); ++iter) {
+    StartSample(*metric, "{", output);
+    AppendLabel(var.Label(), iter->first, output);
+    output->append("} ");
+    AppendSigned(iter->second, output);
+    output->push_back('\n');
+  }
+}
+
+void RenderHistogram(const string &metric, const string &label,
+                     const string &key, const Histogram &histogram,
+                     string *output) {
+  uint64_t counts[HISTOGRAM_BOUND_COUNT];
+  histogram.CumulativeCounts(HISTOGRAM_BOUNDS, HISTOGRAM_BOUND_COUNT, counts);
+  for (unsigned int i = 0; i <= HISTOGRAM_BOUND_COUNT; i++) {
+    StartSample(metric, "_bucket{", output);
+    AppendLabel(label, key, output);
+    output->append(",le=\"");
+    if (i == HISTOGRAM_BOUND_COUNT) {
+      output->append("+Inf\"} ");
+      AppendUnsigned(histogram.Count(), output);
+    } else {
+      AppendUnsigned(HISTOGRAM_BOUNDS[i], output);
+      output->append("\"} ");
+      AppendUnsigned(counts[i], output);
+    }
+    output->push_back('\n');
+  }
+  StartSample(metric, "_count{", output);
+  AppendLabel(label, key, output);
+  output->append("} ");
+  AppendUnsigned(histogram.Count(), output);
+  output->push_back('\n');
+  StartSample(metric, "_sum{", output);
+  AppendLabel(label, key, output);
+  output->append("} ");
+  AppendUnsigned(histogram.Sum(), output);
+  output->push_back('\n');
+}
+}  // namespace
+
+
+/*
+ * The form is:
+ *   var_name  map:label_name key1:count1 key2:count2
+ */
+const string HistogramMap::Value() const {
+  ostringstream value;
+  value << "map:" << m_label;
+  map<string, const Histogram*>::const_iterator iter;
+  for (iter = m_histograms.begin(); iter != m_histograms.end(); ++iter) {
+    value << " " << iter->first << ":" << iter->second->Count();
+  }
+  return value.str();
+}
+
 ExportMap::~ExportMap() {
   STLDeleteValues(&m_bool_variables);
   STLDeleteValues(&m_counter_variables);
+  STLDeleteValues(&m_histogram_map_variables);
   STLDeleteValues(&m_int_map_variables);
   STLDeleteValues(&m_int_variables);
   STLDeleteValues(&m_str_map_variables);
@@ -94,6 +255,18 @@ UIntMap *ExportMap::GetUIntMapVar(const string &name, const string &label) {
 }
 
 
+/*
+ * Lookup or create a histogram map variable
+ * @param name the name of the variable
+ * @param label the label to use for the map (optional)
+ * @return a HistogramMap
+ */
+HistogramMap *ExportMap::GetHistogramMapVar(const string &name,
+                                            const string &label) {
+  return GetMapVar(&m_histogram_map_variables, name, label);
+}
+
+
 /*
  * Return a list of all variables.
  * @return a vector of all variables.
@@ -102,6 +275,7 @@ vector<BaseVariable*> ExportMap::AllVariables() const {
   vector<BaseVariable*> variables;
   STLValues(m_bool_variables, &variables);
   STLValues(m_counter_variables, &variables);
+  STLValues(m_histogram_map_variables, &variables);
   STLValues(m_int_map_variables, &variables);
   STLValues(m_int_variables, &variables);
   STLValues(m_str_map_variables, &variables);
@@ -113,6 +287,92 @@ vector<BaseVariable*> ExportMap::AllVariables() const {
 }
 
 
+/*
+ * This appends directly to the output, since it's called every time the
+ * metrics are scraped.
+ */
+void ExportMap::RenderOpenMetrics(string *output) const {
+  string metric;
+
+  map<string, BoolVariable*>::const_iterator bool_iter;
+  for (bool_iter = m_bool_variables.begin();
+       bool_iter != m_bool_variables.end(); ++bool_iter) {
+    StartFamily(bool_iter->first, "gauge", &metric, output);
+    StartSample(metric, " ", output);
+    output->append(bool_iter->second->Get() ? "1\n" : "0\n");
+  }
+
+  map<string, CounterVariable*>::const_iterator counter_iter;
+  for (counter_iter = m_counter_variables.begin();
+       counter_iter != m_counter_variables.end(); ++counter_iter) {
+    StartFamily(counter_iter->first, "counter", &metric, output);
+    StartSample(metric, "_total ", output);
+    AppendUnsigned(counter_iter->second->Get(), output);
+    output->push_back('\n');
+  }
+
+  map<string, IntegerVariable*>::const_iterator int_iter;
+  for (int_iter = m_int_variables.begin();
+       int_iter != m_int_variables.end(); ++int_iter) {
+    StartFamily(int_iter->first, "gauge", &metric, output);
+    StartSample(metric, " ", output);
+    AppendSigned(int_iter->second->Get(), output);
+    output->push_back('\n');
+  }
+
+  map<string, StringVariable*>::const_iterator string_iter;
+  for (string_iter = m_string_variables.begin();
+       string_iter != m_string_variables.end(); ++string_iter) {
+    StartFamily(string_iter->first, "info", &metric, output);
+    StartSample(metric, "_info{value=", output);
+    AppendLabelValue(string_iter->second->Get(), output);
+    output->append("} 1\n");
+  }
+
+  map<string, StringMap*>::const_iterator str_map_iter;
+  for (str_map_iter = m_str_map_variables.begin();
+       str_map_iter != m_str_map_variables.end(); ++str_map_iter) {
+    const StringMap &var = *str_map_iter->second;
+    StartFamily(var.Name(), "info", &metric, output);
+    const map<string, string> &values = var.Values();
+    map<string, string>::const_iterator iter = values.begin();
+    for (; iter != values.end(); ++iter) {
+      StartSample(metric, "_info{", output);
+      AppendLabel(var.Label(), iter->first, output);
+      output->append(",value=");
+      AppendLabelValue(iter->second, output);
+      output->append("} 1\n");
+    }
+  }
+
+  map<string, IntMap*>::const_iterator int_map_iter;
+  for (int_map_iter = m_int_map_variables.begin();
+       int_map_iter != m_int_map_variables.end(); ++int_map_iter) {
+    RenderIntMap(*int_map_iter->second, "gauge", &metric, output);
+  }
+
+  map<string, UIntMap*>::const_iterator uint_map_iter;
+  for (uint_map_iter = m_uint_map_variables.begin();
+       uint_map_iter != m_uint_map_variables.end(); ++uint_map_iter) {
+    RenderIntMap(*uint_map_iter->second, "unknown", &metric, output);
+  }
+
+  map<string, HistogramMap*>::const_iterator histogram_iter;
+  for (histogram_iter = m_histogram_map_variables.begin();
+       histogram_iter != m_histogram_map_variables.end(); ++histogram_iter) {
+    const HistogramMap &var = *histogram_iter->second;
+    StartFamily(var.Name(), "histogram", &metric, output);
+    const map<string, const Histogram*> &histograms = var.Histograms();
+    map<string, const Histogram*>::const_iterator iter = histograms.begin();
+    for (; iter != histograms.end(); ++iter) {
+      RenderHistogram(metric, var.Label(), iter->first, *iter->second,
+                      output);
+    }
+  }
+  output->append("# EOF\n");
+}
+
+
 template<typename Type>
 Type *ExportMap::GetVar(map<string, Type*> *var_map, const string &name) {
   typename map<string, Type*>::iterator iter;
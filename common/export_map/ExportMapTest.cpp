@@ -23,16 +23,21 @@
 #include <vector>
 
 #include "ola/ExportMap.h"
+#include "ola/strings/Format.h"
 #include "ola/testing/TestUtils.h"
+#include "ola/util/Histogram.h"
 
 using ola::BaseVariable;
 using ola::BoolVariable;
 using ola::CounterVariable;
 using ola::ExportMap;
+using ola::Histogram;
+using ola::HistogramMap;
 using ola::IntMap;
 using ola::IntegerVariable;
 using ola::StringMap;
 using ola::StringVariable;
+using ola::UIntMap;
 using std::string;
 using std::vector;
 
@@ -46,6 +51,7 @@ class ExportMapTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testStringMapVariable);
   CPPUNIT_TEST(testIntMapVariable);
   CPPUNIT_TEST(testExportMap);
+  CPPUNIT_TEST(testOpenMetrics);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -56,6 +62,7 @@ class ExportMapTest: public CppUnit::TestFixture {
     void testStringMapVariable();
     void testIntMapVariable();
     void testExportMap();
+    void testOpenMetrics();
 };
 
 
@@ -211,6 +218,16 @@ void ExportMapTest::testIntMapVariable() {
   // check increments work
   var.Increment(key1);
   OLA_ASSERT_EQ(var.Value(), string("map:count key1:1"));
+
+  // check handles remain valid as other keys are added
+  int *handle = var.Handle(key2);
+  OLA_ASSERT_EQ(0, *handle);
+  for (unsigned int i = 0; i < 100; i++) {
+    var.Increment("key" + ola::strings::IntToString(i + 100));
+  }
+  (*handle)++;
+  OLA_ASSERT_EQ(1, var[key2]);
+  OLA_ASSERT_EQ(handle, var.Handle(key2));
 }
 
 /*
@@ -241,3 +258,67 @@ void ExportMapTest::testExportMap() {
   vector<BaseVariable*> variables = map.AllVariables();
   OLA_ASSERT_EQ(variables.size(), (size_t) 4);
 }
+
+
+/*
+ * Check the variables are rendered in the OpenMetrics format.
+ */
+void ExportMapTest::testOpenMetrics() {
+  ExportMap map;
+  map.GetBoolVar("running")->Set(true);
+  (*map.GetCounterVar("rpc-sent"))++;
+  map.GetIntegerVar("queue-depth")->Set(-2);
+  map.GetStringVar("version")->Set("0.10 \"beta\"");
+  (*map.GetStringMapVar("universe-name", "universe"))["1"] = "Stage";
+  UIntMap *frames = map.GetUIntMapVar("universe-dmx-frames", "universe");
+  (*frames)["1"] = 40;
+  (*frames)["2"] = 0;
+
+  Histogram histogram;
+  histogram.Add(10);
+  histogram.Add(100);
+  histogram.Add(100000000);
+  HistogramMap *histograms = map.GetHistogramMapVar("latency", "universe");
+  histograms->Set("1", &histogram);
+  OLA_ASSERT_EQ(string("map:universe 1:3"), histograms->Value());
+
+  string output;
+  map.RenderOpenMetrics(&output);
+  OLA_ASSERT_EQ(
+      string("# TYPE ola_running gauge\n"
+             "ola_running 1\n"
+             "# TYPE ola_rpc_sent counter\n"
+             "ola_rpc_sent_total 1\n"
+             "# TYPE ola_queue_depth gauge\n"
+             "ola_queue_depth -2\n"
+             "# TYPE ola_version info\n"
+             "ola_version_info{value=\"0.10 \\\"beta\\\"\"} 1\n"
+             "# TYPE ola_universe_name info\n"
+             "ola_universe_name_info{universe=\"1\",value=\"Stage\"} 1\n"
+             "# TYPE ola_universe_dmx_frames unknown\n"
+             "ola_universe_dmx_frames{universe=\"1\"} 40\n"
+             "ola_universe_dmx_frames{universe=\"2\"} 0\n"
+             "# TYPE ola_latency histogram\n"
+             "ola_latency_bucket{universe=\"1\",le=\"15\"} 1\n"
+             "ola_latency_bucket{universe=\"1\",le=\"63\"} 1\n"
+             "ola_latency_bucket{universe=\"1\",le=\"255\"} 2\n"
+             "ola_latency_bucket{universe=\"1\",le=\"1023\"} 2\n"
+             "ola_latency_bucket{universe=\"1\",le=\"4095\"} 2\n"
+             "ola_latency_bucket{universe=\"1\",le=\"16383\"} 2\n"
+             "ola_latency_bucket{universe=\"1\",le=\"65535\"} 2\n"
+             "ola_latency_bucket{universe=\"1\",le=\"262143\"} 2\n"
+             "ola_latency_bucket{universe=\"1\",le=\"1048575\"} 2\n"
+             "ola_latency_bucket{universe=\"1\",le=\"4194303\"} 2\n"
+             "ola_latency_bucket{universe=\"1\",le=\"16777215\"} 2\n"
+             "ola_latency_bucket{universe=\"1\",le=\"+Inf\"} 3\n"
+             "ola_latency_count{universe=\"1\"} 3\n"
+             "ola_latency_sum{universe=\"1\"} 100000110\n"
+             "# EOF\n"),
+      output);
+
+  // Removed histograms aren't rendered.
+  histograms->Remove("1");
+  output.clear();
+  map.RenderOpenMetrics(&output);
+  OLA_ASSERT_EQ(string::npos, output.find("ola_latency_bucket"));
+}
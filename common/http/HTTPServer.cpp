@@ -23,11 +23,15 @@
 #endif  // HAVE_CONFIG_H
 
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <ola/Logging.h>
+#include <ola/StringUtils.h>
 #include <ola/base/Macro.h>
 #include <ola/file/Util.h>
 #include <ola/http/HTTPServer.h>
 #include <ola/io/Descriptor.h>
+#include <ola/thread/ThreadSettings.h>
 #include <ola/web/Json.h>
 #include <ola/web/JsonWriter.h>
 
@@ -35,14 +39,23 @@
 #include <ola/win/CleanWinSock2.h>
 #endif  // _WIN32
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
+// MHD_USE_EPOLL & MHD_DAEMON_INFO_EPOLL_FD were added in 0.9.53, older
+// versions only had the _LINUX_ONLY variants.
+#if defined(HAVE_EPOLL) && MHD_VERSION >= 0x00095300
+#define OLA_MHD_EPOLL_SUPPORTED 1
+#endif  // defined(HAVE_EPOLL) && MHD_VERSION >= 0x00095300
+
 namespace ola {
 namespace http {
 
@@ -68,6 +81,7 @@ using std::set;
 using std::string;
 using std::vector;
 using ola::io::UnmanagedFileDescriptor;
+using ola::web::JsonStreamWriter;
 using ola::web::JsonValue;
 using ola::web::JsonWriter;
 
@@ -81,6 +95,12 @@ const char HTTPServer::CONTENT_TYPE_JS[] = "text/javascript";
 const char HTTPServer::CONTENT_TYPE_OCT[] = "application/octet-stream";
 const char HTTPServer::CONTENT_TYPE_JSON[] = "application/json";
 const char HTTPServer::CONTENT_TYPE_XML[] = "application/xml";
+const char HTTPServer::CONTENT_TYPE_EVENT_STREAM[] = "text/event-stream";
+const char HTTPServer::CONTENT_TYPE_OPENMETRICS[] =
+    "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+// Static files are revalidated with the ETag after this.
+static const char STATIC_CACHE_CONTROL[] = "max-age=300";
 
 /**
  * @brief Called by MHD_get_connection_values to add headers to a request
@@ -201,6 +221,23 @@ void RequestCompleted(void*,
 }
 
 
+/**
+ * @brief Called by MHD when it's ready to write more of an event stream.
+ */
+static ssize_t ReadEventStream(void *cls, OLA_UNUSED uint64_t pos, char *buf,
+                               size_t max) {
+  return static_cast<HTTPEventStream*>(cls)->Read(buf, max);
+}
+
+
+/**
+ * @brief Called by MHD when an event stream's connection is closed.
+ */
+static void FreeEventStream(void *cls) {
+  delete static_cast<HTTPEventStream*>(cls);
+}
+
+
 /*
  * @brief HTTPRequest object
  *
@@ -391,11 +428,33 @@ void HTTPResponse::SetHeader(const string &key, const string &value) {
  * @return true on success, false on error
  */
 int HTTPResponse::SendJson(const JsonValue &json) {
-  const string output = JsonWriter::AsString(json);
-  struct MHD_Response *response = HTTPServer::BuildResponse(
-      static_cast<void*>(const_cast<char*>(output.data())),
-      output.length());
+  return SendData(JsonWriter::AsString(json));
+}
+
+
+/**
+ * @brief Send the JSON text from a JsonStreamWriter as the response.
+ * @return true on success, false on error
+ */
+int HTTPResponse::SendJson(const JsonStreamWriter &json) {
+  return SendData(json.AsString());
+}
+
+
+/**
+ * @brief Send the HTTP response
+ * @return true on success, false on error
+ */
+int HTTPResponse::Send() {
+  return SendData(m_data);
+}
+
+
+int HTTPResponse::SendData(const string &data) {
   HeadersMultiMap::const_iterator iter;
+  struct MHD_Response *response = HTTPServer::BuildResponse(
+      static_cast<void*>(const_cast<char*>(data.data())),
+      data.length());
   for (iter = m_headers.begin(); iter != m_headers.end(); ++iter) {
     MHD_add_response_header(response,
                             iter->first.c_str(),
@@ -408,14 +467,23 @@ int HTTPResponse::SendJson(const JsonValue &json) {
 
 
 /**
- * @brief Send the HTTP response
- * @return true on success, false on error
+ * @brief Send the headers for an event stream. The events are sent as they
+ * are added to the stream.
+ * @param stream the HTTPEventStream, ownership is transferred.
  */
-int HTTPResponse::Send() {
+int HTTPResponse::SendEventStream(HTTPEventStream *stream) {
+  // MHD_SIZE_UNKNOWN uses chunked encoding.
+  struct MHD_Response *response = MHD_create_response_from_callback(
+      MHD_SIZE_UNKNOWN, K_EVENT_STREAM_BLOCK_SIZE, ReadEventStream, stream,
+      FreeEventStream);
+  if (!response) {
+    delete stream;
+    return MHD_NO;
+  }
+
+  SetContentType(HTTPServer::CONTENT_TYPE_EVENT_STREAM);
+  SetNoCache();
   HeadersMultiMap::const_iterator iter;
-  struct MHD_Response *response = HTTPServer::BuildResponse(
-      static_cast<void*>(const_cast<char*>(m_data.data())),
-      m_data.length());
   for (iter = m_headers.begin(); iter != m_headers.end(); ++iter) {
     MHD_add_response_header(response,
                             iter->first.c_str(),
@@ -427,20 +495,89 @@ int HTTPResponse::Send() {
 }
 
 
+HTTPEventStream::HTTPEventStream()
+    : m_offset(0),
+      m_closed(false),
+      m_on_close(NULL) {
+}
+
+
+HTTPEventStream::~HTTPEventStream() {
+  if (m_on_close) {
+    m_on_close->Run();
+  }
+}
+
+
+bool HTTPEventStream::SendEvent(const string &event, const string &data) {
+  if (m_queued.size() - m_offset > K_MAX_QUEUED_BYTES) {
+    return false;
+  }
+
+  // Drop the data that has already been written.
+  if (m_offset) {
+    m_queued.erase(0, m_offset);
+    m_offset = 0;
+  }
+
+  if (!event.empty()) {
+    m_queued.append("event: ");
+    m_queued.append(event);
+    m_queued.append("\n");
+  }
+  m_queued.append("data: ");
+  m_queued.append(data);
+  m_queued.append("\n\n");
+  return true;
+}
+
+
+void HTTPEventStream::SetOnClose(ola::SingleUseCallback0<void> *callback) {
+  if (m_on_close) {
+    delete m_on_close;
+  }
+  m_on_close = callback;
+}
+
+
+ssize_t HTTPEventStream::Read(char *buffer, size_t size) {
+  size_t available = m_queued.size() - m_offset;
+  if (!available) {
+    return m_closed ? MHD_CONTENT_READER_END_OF_STREAM : 0;
+  }
+
+  size = std::min(size, available);
+  memcpy(buffer, m_queued.data() + m_offset, size);
+  m_offset += size;
+  return size;
+}
+
+
 /**
  * @brief Setup the HTTP server.
  * @param options the configuration options for the server
  */
 HTTPServer::HTTPServer(const HTTPServerOptions &options)
-    : Thread(Thread::Options("http")),
+    : Thread(Thread::Options("http", ola::thread::THREAD_CLASS_HTTP)),
       m_httpd(NULL),
       m_default_handler(NULL),
       m_port(options.port),
-      m_data_dir(options.data_dir) {
+      m_data_dir(options.data_dir),
+      m_use_epoll(false),
+      m_connection_timeout(options.connection_timeout) {
+#ifdef OLA_MHD_EPOLL_SUPPORTED
+  m_use_epoll = options.use_epoll;
+#else
+  if (options.use_epoll) {
+    OLA_WARN << "MHD doesn't support epoll, using select()";
+  }
+#endif  // OLA_MHD_EPOLL_SUPPORTED
+
   ola::io::SelectServer::Options ss_options;
-  // See issue #761. epoll/kqueue can't be used with the current
-  // implementation.
-  ss_options.force_select = true;
+  // See issue #761. epoll/kqueue can't be used with the descriptors from
+  // MHD_get_fdset(). In epoll mode there is only MHD's epoll descriptor, so
+  // any poller works.
+  ss_options.force_select = !m_use_epoll;
   m_select_server.reset(new ola::io::SelectServer(ss_options));
 }
 
@@ -479,7 +616,14 @@ bool HTTPServer::Init() {
     return false;
   }
 
-  m_httpd = MHD_start_daemon(MHD_NO_FLAG,
+  unsigned int flags = MHD_NO_FLAG;
+#ifdef OLA_MHD_EPOLL_SUPPORTED
+  if (m_use_epoll) {
+    flags |= MHD_USE_EPOLL;
+  }
+#endif  // OLA_MHD_EPOLL_SUPPORTED
+
+  m_httpd = MHD_start_daemon(flags,
                              m_port,
                              NULL,
                              NULL,
@@ -488,13 +632,22 @@ bool HTTPServer::Init() {
                              MHD_OPTION_NOTIFY_COMPLETED,
                              RequestCompleted,
                              NULL,
+                             MHD_OPTION_CONNECTION_TIMEOUT,
+                             m_connection_timeout,
                              MHD_OPTION_END);
 
-  if (m_httpd) {
-    m_select_server->RunInLoop(NewCallback(this, &HTTPServer::UpdateSockets));
+  if (!m_httpd) {
+    return false;
   }
 
-  return m_httpd ? true : false;
+  if (m_use_epoll && !SetupEpollDescriptor()) {
+    MHD_stop_daemon(m_httpd);
+    m_httpd = NULL;
+    return false;
+  }
+
+  m_select_server->RunInLoop(NewCallback(this, &HTTPServer::UpdateSockets));
+  return true;
 }
 
 
@@ -514,8 +667,13 @@ void *HTTPServer::Run() {
   // TODO(Lukas) investigate why the poller does not wake up on HTTP requests.
   m_select_server->SetDefaultInterval(TimeInterval(1, 0));
 #else
-  // set a long poll interval so we don't spin
-  m_select_server->SetDefaultInterval(TimeInterval(60, 0));
+  // set a long poll interval so we don't spin, but wake up often enough to
+  // time out idle connections.
+  unsigned int interval = 60;
+  if (m_connection_timeout) {
+    interval = std::min(interval, m_connection_timeout);
+  }
+  m_select_server->SetDefaultInterval(TimeInterval(interval, 0));
 #endif  // _WIN32
   m_select_server->Run();
 
@@ -525,6 +683,11 @@ void *HTTPServer::Run() {
     FreeSocket(*iter);
   }
   m_sockets.clear();
+
+  if (m_epoll_descriptor.get()) {
+    m_select_server->RemoveReadDescriptor(m_epoll_descriptor.get());
+    m_epoll_descriptor.reset();
+  }
   return NULL;
 }
 
@@ -556,6 +719,11 @@ void HTTPServer::UpdateSockets() {
     OLA_WARN << "MHD run failed";
   }
 
+  if (m_use_epoll) {
+    // MHD tracks the connections itself.
+    return;
+  }
+
   fd_set r_set, w_set, e_set;
   int max_fd = 0;
   FD_ZERO(&r_set);
@@ -639,7 +807,7 @@ int HTTPServer::DispatchRequest(const HTTPRequest *request,
       m_static_content.find(request->Url());
 
   if (file_iter != m_static_content.end()) {
-    return ServeStaticContent(&(file_iter->second), response);
+    return ServeStaticContent(request, &(file_iter->second), response);
   }
 
   if (m_default_handler) {
@@ -703,6 +871,7 @@ bool HTTPServer::RegisterFile(const std::string &path,
   static_file_info file_info;
   file_info.file_path = file;
   file_info.content_type = content_type;
+  file_info.loaded = false;
 
   pair<string, static_file_info> pair(path, file_info);
   m_static_content.insert(pair);
@@ -783,64 +952,266 @@ int HTTPServer::ServeRedirect(HTTPResponse *response, const string &location) {
   return r;
 }
 
+/**
+ * @brief Read a file into a string.
+ * @returns true if the file was read, false otherwise.
+ */
+static bool ReadFile(const string &path, string *data) {
+  ifstream i_stream(path.c_str(), ifstream::binary);
+  if (!i_stream.is_open()) {
+    return false;
+  }
+  data->assign(std::istreambuf_iterator<char>(i_stream),
+               std::istreambuf_iterator<char>());
+  return true;
+}
+
+
+/**
+ * @brief Read a precompressed variant of a file.
+ *
+ * A variant older than the file was made from an earlier version of it, so
+ * it's ignored rather than served in place of the edited file.
+ * @param path the path of the variant.
+ * @param file_mtime the modification time of the original file.
+ * @param data the string to read the variant into.
+ */
+static void ReadVariant(const string &path, time_t file_mtime,
+                        string *data) {
+  struct stat variant_stat;
+  if (stat(path.c_str(), &variant_stat)) {
+    return;
+  }
+  if (variant_stat.st_mtime < file_mtime) {
+    OLA_INFO << "Ignoring stale file: " << path;
+    return;
+  }
+  ReadFile(path, data);
+}
+
+
+/**
+ * @brief Generate the (unquoted) ETag for some content, this is the 64 bit
+ * FNV-1a hash & the size.
+ */
+static string ContentETag(const string &data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (string::const_iterator iter = data.begin(); iter != data.end();
+       ++iter) {
+    hash ^= static_cast<uint8_t>(*iter);
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream str;
+  str << std::hex << hash << "-" << data.size();
+  return str.str();
+}
+
+
+/**
+ * @brief Check if an Accept-Encoding header allows an encoding.
+ * @param accept_encoding the value of the Accept-Encoding header.
+ * @param encoding the content coding, e.g. gzip
+ */
+static bool AcceptsEncoding(const string &accept_encoding,
+                            const string &encoding) {
+  vector<string> codings;
+  StringSplit(accept_encoding, &codings, ",");
+  vector<string>::iterator iter = codings.begin();
+  for (; iter != codings.end(); ++iter) {
+    string params;
+    const string::size_type pos = iter->find(';');
+    if (pos != string::npos) {
+      params = iter->substr(pos + 1);
+      iter->erase(pos);
+    }
+    StringTrim(&(*iter));
+    ToLower(&(*iter));
+    if (*iter != encoding) {
+      continue;
+    }
+    // q=0 means the encoding isn't acceptable
+    StringTrim(&params);
+    return !(params.compare(0, 2, "q=") == 0 &&
+             params.find_first_not_of("0.", 2) == string::npos);
+  }
+  return false;
+}
+
+
+/**
+ * @brief Check if an If-None-Match header matches an ETag.
+ */
+static bool MatchesETag(const string &if_none_match, const string &etag) {
+  vector<string> tags;
+  StringSplit(if_none_match, &tags, ",");
+  vector<string>::iterator iter = tags.begin();
+  for (; iter != tags.end(); ++iter) {
+    StringTrim(&(*iter));
+    // If-None-Match uses the weak comparison
+    if (iter->compare(0, 2, "W/") == 0) {
+      iter->erase(0, 2);
+    }
+    if (*iter == "*" || *iter == etag) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
 /**
  * @brief Return the contents of a file
  */
 int HTTPServer::ServeStaticContent(const std::string &path,
                                    const std::string &content_type,
                                    HTTPResponse *response) {
-  static_file_info file_info;
-  file_info.file_path = path;
-  file_info.content_type = content_type;
-  return ServeStaticContent(&file_info, response);
+  string file_path = m_data_dir;
+  file_path.push_back(ola::file::PATH_SEPARATOR);
+  file_path.append(path);
+
+  string data;
+  if (!ReadFile(file_path, &data)) {
+    OLA_WARN << "Missing file: " << file_path;
+    return ServeNotFound(response);
+  }
+
+  struct MHD_Response *mhd_response = BuildResponse(
+      const_cast<char*>(data.data()), data.size());
+
+  if (!content_type.empty()) {
+    MHD_add_response_header(mhd_response,
+                            MHD_HTTP_HEADER_CONTENT_TYPE,
+                            content_type.c_str());
+  }
+
+  int ret = MHD_queue_response(response->Connection(),
+                               MHD_HTTP_OK,
+                               mhd_response);
+  MHD_destroy_response(mhd_response);
+  delete response;
+  return ret;
 }
 
 
 /**
- * @brief Serve static content.
- * @param file_info details on the file to server
- * @param response the response to use
+ * @brief Read a registered static file, and any precompressed variants that
+ * are up to date, into memory.
+ * @param file_info the file to load.
+ * @returns true if the file was loaded, false if it doesn't exist.
  */
-int HTTPServer::ServeStaticContent(static_file_info *file_info,
-                                   HTTPResponse *response) {
-  char *data;
-  unsigned int length;
+bool HTTPServer::LoadStaticContent(static_file_info *file_info) {
   string file_path = m_data_dir;
   file_path.push_back(ola::file::PATH_SEPARATOR);
   file_path.append(file_info->file_path);
-  ifstream i_stream(file_path.c_str(), ifstream::binary);
 
-  if (!i_stream.is_open()) {
+  if (!ReadFile(file_path, &file_info->data)) {
     OLA_WARN << "Missing file: " << file_path;
-    return ServeNotFound(response);
+    return false;
   }
+  struct stat file_stat;
+  time_t mtime = stat(file_path.c_str(), &file_stat) ? 0 : file_stat.st_mtime;
+  ReadVariant(file_path + ".br", mtime, &file_info->brotli_data);
+  ReadVariant(file_path + ".gz", mtime, &file_info->gzip_data);
+  file_info->etag = ContentETag(file_info->data);
+  file_info->loaded = true;
+  return true;
+}
 
-  i_stream.seekg(0, std::ios::end);
-  length = i_stream.tellg();
-  i_stream.seekg(0, std::ios::beg);
 
-  data = static_cast<char*>(malloc(length));
+/**
+ * @brief Serve static content.
+ *
+ * The file is served from memory, with an ETag so that clients can make
+ * conditional requests. The brotli or gzip variant is used if the client
+ * accepts it.
+ * @param request the HTTPRequest
+ * @param file_info details on the file to server
+ * @param response the response to use
+ */
+int HTTPServer::ServeStaticContent(const HTTPRequest *request,
+                                   static_file_info *file_info,
+                                   HTTPResponse *response) {
+  if (!file_info->loaded && !LoadStaticContent(file_info)) {
+    return ServeNotFound(response);
+  }
 
-  i_stream.read(data, length);
-  i_stream.close();
+  const string *data = &file_info->data;
+  const char *encoding = NULL;
+  const string accept_encoding = request->GetHeader(
+      MHD_HTTP_HEADER_ACCEPT_ENCODING);
+  if (!file_info->brotli_data.empty() &&
+      AcceptsEncoding(accept_encoding, "br")) {
+    data = &file_info->brotli_data;
+    encoding = "br";
+  } else if (!file_info->gzip_data.empty() &&
+             AcceptsEncoding(accept_encoding, "gzip")) {
+    data = &file_info->gzip_data;
+    encoding = "gzip";
+  }
 
-  struct MHD_Response *mhd_response = BuildResponse(static_cast<void*>(data),
-                                                    length);
+  // Each encoding is a different representation so it needs its own ETag.
+  string etag = "\"" + file_info->etag;
+  if (encoding) {
+    etag.push_back('-');
+    etag.append(encoding);
+  }
+  etag.push_back('"');
 
-  if (!file_info->content_type.empty()) {
-    MHD_add_response_header(mhd_response,
-                            MHD_HTTP_HEADER_CONTENT_TYPE,
-                            file_info->content_type.c_str());
+  unsigned int status = MHD_HTTP_OK;
+  struct MHD_Response *mhd_response;
+  if (MatchesETag(request->GetHeader(MHD_HTTP_HEADER_IF_NONE_MATCH), etag)) {
+    status = MHD_HTTP_NOT_MODIFIED;
+    mhd_response = BuildResponse(NULL, 0);
+  } else {
+    mhd_response = BuildPersistentResponse(*data);
+    if (!file_info->content_type.empty()) {
+      MHD_add_response_header(mhd_response,
+                              MHD_HTTP_HEADER_CONTENT_TYPE,
+                              file_info->content_type.c_str());
+    }
+    if (encoding) {
+      MHD_add_response_header(mhd_response,
+                              MHD_HTTP_HEADER_CONTENT_ENCODING,
+                              encoding);
+    }
   }
 
-  int ret = MHD_queue_response(response->Connection(),
-                               MHD_HTTP_OK,
-                               mhd_response);
+  MHD_add_response_header(mhd_response, MHD_HTTP_HEADER_ETAG, etag.c_str());
+  MHD_add_response_header(mhd_response, MHD_HTTP_HEADER_CACHE_CONTROL,
+                          STATIC_CACHE_CONTROL);
+  if (!file_info->brotli_data.empty() || !file_info->gzip_data.empty()) {
+    MHD_add_response_header(mhd_response, MHD_HTTP_HEADER_VARY,
+                            MHD_HTTP_HEADER_ACCEPT_ENCODING);
+  }
+
+  int ret = MHD_queue_response(response->Connection(), status, mhd_response);
   MHD_destroy_response(mhd_response);
   delete response;
   return ret;
 }
 
+/**
+ * @brief Watch MHD's epoll descriptor. This becomes readable when there is
+ * activity on any of the HTTP connections.
+ */
+bool HTTPServer::SetupEpollDescriptor() {
+#ifdef OLA_MHD_EPOLL_SUPPORTED
+  const union MHD_DaemonInfo *info = MHD_get_daemon_info(
+      m_httpd, MHD_DAEMON_INFO_EPOLL_FD);
+  if (!info) {
+    OLA_WARN << "Failed to get the MHD epoll descriptor";
+    return false;
+  }
+
+  m_epoll_descriptor.reset(new UnmanagedFileDescriptor(info->epoll_fd));
+  m_epoll_descriptor->SetOnData(NewCallback(this, &HTTPServer::HandleHTTPIO));
+  return m_select_server->AddReadDescriptor(m_epoll_descriptor.get());
+#else
+  return false;
+#endif  // OLA_MHD_EPOLL_SUPPORTED
+}
+
+
 void HTTPServer::InsertSocket(bool is_readable, bool is_writeable, int fd) {
 #ifdef _WIN32
   UnmanagedSocketDescriptor *socket = new UnmanagedSocketDescriptor(fd);
@@ -885,5 +1256,20 @@ struct MHD_Response *HTTPServer::BuildResponse(void *data, size_t size) {
   return MHD_create_response_from_data(size, data, MHD_NO, MHD_YES);
 #endif  // HAVE_MHD_CREATE_RESPONSE_FROM_BUFFER
 }
+
+
+/**
+ * @brief Build a response that refers to data rather than copying it.
+ * @param data the body of the response, this must outlive the response.
+ */
+struct MHD_Response *HTTPServer::BuildPersistentResponse(const string &data) {
+  void *buffer = const_cast<char*>(data.data());
+#ifdef HAVE_MHD_CREATE_RESPONSE_FROM_BUFFER
+  return MHD_create_response_from_buffer(data.size(), buffer,
+                                         MHD_RESPMEM_PERSISTENT);
+#else
+  return MHD_create_response_from_data(data.size(), buffer, MHD_NO, MHD_NO);
+#endif  // HAVE_MHD_CREATE_RESPONSE_FROM_BUFFER
+}
 }  // namespace http
 }  // namespace ola
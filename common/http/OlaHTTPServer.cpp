@@ -22,6 +22,7 @@
 #include <ola/http/OlaHTTPServer.h>
 #include <ola/ExportMap.h>
 #include <ola/Clock.h>
+#include <ola/util/Trace.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,6 +38,7 @@ using std::vector;
 
 const char OlaHTTPServer::K_DATA_DIR_VAR[] = "http_data_dir";
 const char OlaHTTPServer::K_UPTIME_VAR[] = "uptime-in-ms";
+const char OlaHTTPServer::K_SELECT_SERVER_VAR_PREFIX[] = "ss-";
 
 /**
  * Create a new OlaHTTPServer.
@@ -48,7 +50,12 @@ OlaHTTPServer::OlaHTTPServer(const HTTPServer::HTTPServerOptions &options,
     : m_export_map(export_map),
       m_server(options) {
   RegisterHandler("/debug", &OlaHTTPServer::DisplayDebug);
+  RegisterHandler("/debug/loop", &OlaHTTPServer::DisplayLoopDebug);
+#ifdef OLA_TRACING
+  RegisterHandler("/debug/trace", &OlaHTTPServer::DisplayTrace);
+#endif  // OLA_TRACING
   RegisterHandler("/help", &OlaHTTPServer::DisplayHandlers);
+  RegisterHandler("/metrics", &OlaHTTPServer::DisplayMetrics);
 
   StringVariable *data_dir_var = export_map->GetStringVar(K_DATA_DIR_VAR);
   data_dir_var->Set(m_server.DataDir());
@@ -72,12 +79,7 @@ bool OlaHTTPServer::Init() {
 int OlaHTTPServer::DisplayDebug(const HTTPRequest*,
                                 HTTPResponse *raw_response) {
   auto_ptr<HTTPResponse> response(raw_response);
-  ola::TimeStamp now;
-  m_clock.CurrentTime(&now);
-  ola::TimeInterval diff = now - m_start_time;
-  ostringstream str;
-  str << diff.InMilliSeconds();
-  m_export_map->GetStringVar(K_UPTIME_VAR)->Set(str.str());
+  UpdateUptime();
 
   vector<BaseVariable*> variables = m_export_map->AllVariables();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
@@ -93,6 +95,64 @@ int OlaHTTPServer::DisplayDebug(const HTTPRequest*,
 }
 
 
+/**
+ * Display the SelectServer variables from the ExportMap. This includes the
+ * per-callback timings if the loop is being profiled.
+ */
+int OlaHTTPServer::DisplayLoopDebug(const HTTPRequest*,
+                                    HTTPResponse *raw_response) {
+  auto_ptr<HTTPResponse> response(raw_response);
+  vector<BaseVariable*> variables = m_export_map->AllVariables();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+
+  const string prefix(K_SELECT_SERVER_VAR_PREFIX);
+  vector<BaseVariable*>::iterator iter;
+  for (iter = variables.begin(); iter != variables.end(); ++iter) {
+    if ((*iter)->Name().compare(0, prefix.size(), prefix) != 0) {
+      continue;
+    }
+    ostringstream out;
+    out << (*iter)->Name() << ": " << (*iter)->Value() << "\n";
+    response->Append(out.str());
+  }
+  int r = response->Send();
+  return r;
+}
+
+
+/**
+ * Display the recorded trace spans in the Chrome trace event format.
+ */
+int OlaHTTPServer::DisplayTrace(const HTTPRequest*,
+                                HTTPResponse *raw_response) {
+  auto_ptr<HTTPResponse> response(raw_response);
+  ostringstream out;
+  ola::trace::WriteChromeTrace(&out);
+  response->SetContentType(HTTPServer::CONTENT_TYPE_JSON);
+  response->Append(out.str());
+  int r = response->Send();
+  return r;
+}
+
+
+/**
+ * Display the contents of the ExportMap in the OpenMetrics format, for
+ * Prometheus.
+ */
+int OlaHTTPServer::DisplayMetrics(const HTTPRequest*,
+                                  HTTPResponse *raw_response) {
+  auto_ptr<HTTPResponse> response(raw_response);
+  UpdateUptime();
+
+  m_metrics.clear();
+  m_export_map->RenderOpenMetrics(&m_metrics);
+  response->SetContentType(HTTPServer::CONTENT_TYPE_OPENMETRICS);
+  response->Append(m_metrics);
+  int r = response->Send();
+  return r;
+}
+
+
 /**
  * Display a list of registered handlers
  */
@@ -111,5 +171,15 @@ int OlaHTTPServer::DisplayHandlers(const HTTPRequest*,
   int r = response->Send();
   return r;
 }
+
+
+void OlaHTTPServer::UpdateUptime() {
+  ola::TimeStamp now;
+  m_clock.CurrentTime(&now);
+  ola::TimeInterval diff = now - m_start_time;
+  ostringstream str;
+  str << diff.InMilliSeconds();
+  m_export_map->GetStringVar(K_UPTIME_VAR)->Set(str.str());
+}
 }  // namespace http
 }  // namespace ola
@@ -20,6 +20,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/types.h>
@@ -391,6 +392,11 @@ ssize_t ConnectedDescriptor::Send(IOQueue *ioqueue) {
     bytes_sent += bytes_written;
   }
 #else
+#ifdef IOV_MAX
+  // The kernel rejects longer arrays, the remaining blocks are sent on the
+  // next call.
+  iocnt = std::min(iocnt, static_cast<int>(IOV_MAX));
+#endif  // IOV_MAX
 #if HAVE_DECL_MSG_NOSIGNAL
   if (IsSocket()) {
     struct msghdr message;
@@ -465,7 +471,7 @@ int ConnectedDescriptor::Receive(
         return 0;
       }
       data_read += ret;
-      data += data_read;
+      data += ret;
     } else {
       OLA_WARN << "Descriptor type not implemented for reading: "
                << ReadDescriptor().m_type;
@@ -484,7 +490,7 @@ int ConnectedDescriptor::Receive(
       return 0;
     }
     data_read += ret;
-    data += data_read;
+    data += ret;
   }
 #endif  // _WIN32
   return 0;
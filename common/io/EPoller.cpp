@@ -20,9 +20,18 @@
 
 #include "common/io/EPoller.h"
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <string.h>
 #include <errno.h>
 #include <sys/epoll.h>
+#include <sys/socket.h>
+#ifdef HAVE_SYS_TIMERFD_H
+#include <sys/timerfd.h>
+#endif  // HAVE_SYS_TIMERFD_H
+#include <unistd.h>
 
 #include <algorithm>
 #include <queue>
@@ -34,6 +43,8 @@
 #include "ola/base/Macro.h"
 #include "ola/io/Descriptor.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/util/Trace.h"
+#include "common/io/LoopProfiler.h"
 
 namespace ola {
 namespace io {
@@ -46,30 +57,48 @@ using std::pair;
 class EPollData {
  public:
   EPollData()
-      : events(0),
+      : fd(INVALID_DESCRIPTOR),
+        events(0),
         read_descriptor(NULL),
         write_descriptor(NULL),
         connected_descriptor(NULL),
-        delete_connected_on_close(false) {
+        delete_connected_on_close(false),
+        pending_read(false) {
   }
 
   void Reset() {
+    fd = INVALID_DESCRIPTOR;
     events = 0;
     read_descriptor = NULL;
     write_descriptor = NULL;
     connected_descriptor = NULL;
     delete_connected_on_close = false;
+    pending_read = false;
   }
 
+  int fd;
   uint32_t events;
   ReadFileDescriptor *read_descriptor;
   WriteFileDescriptor *write_descriptor;
   ConnectedDescriptor *connected_descriptor;
   bool delete_connected_on_close;
+  // True if the fd is in m_pending_reads.
+  bool pending_read;
 };
 
 namespace {
 
+/*
+ * Check if an event is for a high priority read descriptor.
+ */
+bool IsHighPriority(const epoll_event &event) {
+  const EPollData *descriptor = reinterpret_cast<const EPollData*>(
+      event.data.ptr);
+  return (descriptor->read_descriptor &&
+          descriptor->read_descriptor->Priority() ==
+              DESCRIPTOR_PRIORITY_HIGH);
+}
+
 /*
  * Add the fd to the epoll_fd.
  * descriptor is the user data to associated with the event
@@ -139,15 +168,29 @@ const int EPoller::READ_FLAGS = EPOLLIN | EPOLLRDHUP;
  */
 const unsigned int EPoller::MAX_FREE_DESCRIPTORS = 10;
 
+/**
+ * @brief The number of times DrainRead() is called for an edge-triggered
+ * descriptor before moving on to the next one.
+ */
+const unsigned int EPoller::READ_BUDGET = 8;
+
 EPoller::EPoller(ExportMap *export_map, Clock* clock)
     : m_export_map(export_map),
       m_loop_iterations(NULL),
       m_loop_time(NULL),
+      m_timer_wakeups(NULL),
+      m_wake_latency(NULL),
+      m_max_wake_latency(NULL),
       m_epoll_fd(INVALID_DESCRIPTOR),
+      m_timer_fd(INVALID_DESCRIPTOR),
+      m_profiler(NULL),
       m_clock(clock) {
   if (m_export_map) {
     m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
     m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+    m_timer_wakeups = m_export_map->GetCounterVar(K_TIMER_WAKEUPS_VAR);
+    m_wake_latency = m_export_map->GetCounterVar(K_WAKE_LATENCY_VAR);
+    m_max_wake_latency = m_export_map->GetIntegerVar(K_MAX_WAKE_LATENCY_VAR);
   }
 
   m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
@@ -160,14 +203,17 @@ EPoller::~EPoller() {
   if (m_epoll_fd != INVALID_DESCRIPTOR) {
     close(m_epoll_fd);
   }
+  if (m_timer_fd != INVALID_DESCRIPTOR) {
+    close(m_timer_fd);
+  }
 
   {
-    DescriptorMap::iterator iter = m_descriptor_map.begin();
-    for (; iter != m_descriptor_map.end(); ++iter) {
-      if (iter->second->delete_connected_on_close) {
-        delete iter->second->connected_descriptor;
+    DescriptorList::iterator iter = m_descriptors.begin();
+    for (; iter != m_descriptors.end(); ++iter) {
+      if (*iter && (*iter)->delete_connected_on_close) {
+        delete (*iter)->connected_descriptor;
       }
-      delete iter->second;
+      delete *iter;
     }
   }
 
@@ -193,6 +239,10 @@ bool EPoller::AddReadDescriptor(ReadFileDescriptor *descriptor) {
     return false;
   }
 
+  if (!m_busy_poll.IsZero()) {
+    EnableBusyPoll(descriptor->ReadDescriptor());
+  }
+
   pair<EPollData*, bool> result = LookupOrCreateDescriptor(
       descriptor->ReadDescriptor());
   if (result.first->events & READ_FLAGS) {
@@ -203,6 +253,11 @@ bool EPoller::AddReadDescriptor(ReadFileDescriptor *descriptor) {
 
   result.first->events |= READ_FLAGS;
   result.first->read_descriptor = descriptor;
+  // Writes are level-triggered, so only use EPOLLET if this fd isn't in the
+  // write set.
+  if (descriptor->EdgeTriggered() && !result.first->write_descriptor) {
+    result.first->events |= EPOLLET;
+  }
 
   if (result.second) {
     return AddEvent(m_epoll_fd, descriptor->ReadDescriptor(), result.first);
@@ -222,6 +277,10 @@ bool EPoller::AddReadDescriptor(ConnectedDescriptor *descriptor,
     return false;
   }
 
+  if (!m_busy_poll.IsZero()) {
+    EnableBusyPoll(descriptor->ReadDescriptor());
+  }
+
   pair<EPollData*, bool> result = LookupOrCreateDescriptor(
       descriptor->ReadDescriptor());
 
@@ -270,6 +329,7 @@ bool EPoller::AddWriteDescriptor(WriteFileDescriptor *descriptor) {
   }
 
   result.first->events |= EPOLLOUT;
+  result.first->events &= ~EPOLLET;
   result.first->write_descriptor = descriptor;
 
   if (result.second) {
@@ -310,15 +370,25 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
       (*m_loop_iterations)++;
   }
 
-  int ms_to_sleep = sleep_interval.InMilliSeconds();
-  int ready = epoll_wait(m_epoll_fd, reinterpret_cast<epoll_event*>(&events),
-                         MAX_EVENTS, ms_to_sleep ? ms_to_sleep : 1);
+  const TimeStamp deadline = now + sleep_interval;
+  int ready = 0;
+  if (!m_pending_reads.empty()) {
+    // Don't block, there are descriptors with data left to drain.
+    ready = epoll_wait(m_epoll_fd, events, MAX_EVENTS, 0);
+  } else if (m_busy_poll.IsZero()) {
+    ready = Wait(events, sleep_interval);
+  } else {
+    const TimeStamp spin_end = now + std::min(m_busy_poll, sleep_interval);
+    while ((ready = epoll_wait(m_epoll_fd, events, MAX_EVENTS, 0)) == 0 &&
+           now < spin_end) {
+      m_clock->CurrentTime(&now);
+    }
+    if (ready == 0 && now < deadline) {
+      ready = Wait(events, deadline - now);
+    }
+  }
 
-  if (ready == 0) {
-    m_clock->CurrentTime(&m_wake_up_time);
-    timeout_manager->ExecuteTimeouts(&m_wake_up_time);
-    return true;
-  } else if (ready == -1) {
+  if (ready == -1) {
     if (errno == EINTR)
       return true;
     OLA_WARN << "epoll() error, " << strerror(errno);
@@ -327,11 +397,57 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
 
   m_clock->CurrentTime(&m_wake_up_time);
 
+  // Remove the timerfd event, if there is one.
+  for (int i = 0; i < ready; i++) {
+    if (events[i].data.ptr == NULL) {
+      uint64_t expirations;
+      if (read(m_timer_fd, &expirations, sizeof(expirations)) < 0) {
+        OLA_DEBUG << "Failed to read timerfd: " << strerror(errno);
+      }
+      events[i] = events[--ready];
+      break;
+    }
+  }
+
+  if (ready == 0 && m_pending_reads.empty()) {
+    // Only record the latency if a timeout was due, the poll interval may
+    // also have expired.
+    if (m_timer_wakeups && !next_event_in.IsZero() &&
+        next_event_in <= poll_interval && m_wake_up_time >= deadline) {
+      int latency = static_cast<int>((m_wake_up_time - deadline).AsInt());
+      (*m_timer_wakeups)++;
+      (*m_wake_latency) += latency;
+      if (latency > m_max_wake_latency->Get()) {
+        m_max_wake_latency->Set(latency);
+      }
+    }
+    timeout_manager->ExecuteTimeouts(&m_wake_up_time);
+    return true;
+  }
+
+  // Descriptors that are requeued while handling these events are drained on
+  // the next call.
+  m_draining.swap(m_pending_reads);
+
+  // Service the high priority descriptors first. This happens before any
+  // callbacks run, so all the descriptors are still valid.
+  std::stable_partition(events, events + ready, IsHighPriority);
+
   for (int i = 0; i < ready; i++) {
     EPollData *descriptor = reinterpret_cast<EPollData*>(
         events[i].data.ptr);
-    CheckDescriptor(&events[i], descriptor);
+    if (m_profiler) {
+      // Save the fd, the callback may remove the descriptor.
+      int fd = descriptor->fd;
+      TimeStamp start;
+      m_profiler->Start(&start);
+      CheckDescriptor(&events[i], descriptor);
+      m_profiler->RecordDescriptor(fd, start);
+    } else {
+      CheckDescriptor(&events[i], descriptor);
+    }
   }
+  DrainPendingReads();
 
   // Now that we're out of the callback phase, clean up descriptors that were
   // removed.
@@ -352,6 +468,81 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
 }
 
 
+void EPoller::SetBusyPoll(const TimeInterval &interval) {
+  m_busy_poll = interval;
+}
+
+bool EPoller::EnableHighResolutionTimers() {
+#ifdef HAVE_SYS_TIMERFD_H
+  if (m_timer_fd != INVALID_DESCRIPTOR) {
+    return true;
+  }
+  if (m_epoll_fd == INVALID_DESCRIPTOR) {
+    return false;
+  }
+
+  m_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (m_timer_fd < 0) {
+    OLA_WARN << "Failed to create timerfd: " << strerror(errno);
+    m_timer_fd = INVALID_DESCRIPTOR;
+    return false;
+  }
+
+  // The timerfd is identified by the NULL data pointer.
+  epoll_event event;
+  event.events = EPOLLIN;
+  event.data.ptr = NULL;
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_timer_fd, &event)) {
+    OLA_WARN << "EPOLL_CTL_ADD for timerfd failed: " << strerror(errno);
+    close(m_timer_fd);
+    m_timer_fd = INVALID_DESCRIPTOR;
+    return false;
+  }
+  return true;
+#else
+  OLA_WARN << "timerfd isn't available";
+  return false;
+#endif  // HAVE_SYS_TIMERFD_H
+}
+
+/*
+ * Block until there are events, or the interval has passed.
+ */
+int EPoller::Wait(epoll_event *events, const TimeInterval &interval) {
+#ifdef HAVE_SYS_TIMERFD_H
+  if (m_timer_fd != INVALID_DESCRIPTOR) {
+    if (interval.IsZero()) {
+      return epoll_wait(m_epoll_fd, events, MAX_EVENTS, 0);
+    }
+    struct itimerspec timer_spec;
+    memset(&timer_spec, 0, sizeof(timer_spec));
+    timer_spec.it_value.tv_sec = interval.Seconds();
+    timer_spec.it_value.tv_nsec = interval.MicroSeconds() * 1000;
+    if (timerfd_settime(m_timer_fd, 0, &timer_spec, NULL) == 0) {
+      return epoll_wait(m_epoll_fd, events, MAX_EVENTS, -1);
+    }
+    OLA_WARN << "timerfd_settime failed: " << strerror(errno);
+  }
+#endif  // HAVE_SYS_TIMERFD_H
+
+  int ms_to_sleep = interval.InMilliSeconds();
+  return epoll_wait(m_epoll_fd, events, MAX_EVENTS,
+                    ms_to_sleep ? ms_to_sleep : 1);
+}
+
+void EPoller::EnableBusyPoll(int fd) {
+#ifdef SO_BUSY_POLL
+  int usec = static_cast<int>(m_busy_poll.AsInt());
+  if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) &&
+      errno != ENOTSOCK) {
+    OLA_DEBUG << "Failed to set SO_BUSY_POLL on " << fd << ": "
+              << strerror(errno);
+  }
+#else
+  (void) fd;
+#endif  // SO_BUSY_POLL
+}
+
 /*
  * Check all the registered descriptors:
  *  - Execute the callback for descriptors with data
@@ -359,6 +550,7 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
  */
 void EPoller::CheckDescriptor(struct epoll_event *event,
                               EPollData *epoll_data) {
+  OLA_TRACE_SCOPE("io", "EPoller::CheckDescriptor");
   if (event->events & (EPOLLHUP | EPOLLRDHUP)) {
     if (epoll_data->read_descriptor) {
       epoll_data->read_descriptor->PerformRead();
@@ -392,13 +584,20 @@ void EPoller::CheckDescriptor(struct epoll_event *event,
 
   if (event->events & EPOLLIN) {
     if (epoll_data->read_descriptor) {
-      epoll_data->read_descriptor->PerformRead();
+      if (!(epoll_data->events & EPOLLET)) {
+        epoll_data->read_descriptor->PerformRead();
+      } else if (!epoll_data->pending_read) {
+        // If pending_read is set it's drained by DrainPendingReads().
+        DrainDescriptor(epoll_data);
+      }
     } else if (epoll_data->connected_descriptor) {
       epoll_data->connected_descriptor->PerformRead();
     }
   }
 
-  if (event->events & EPOLLOUT) {
+  // EPOLLERR is also used for MSG_ZEROCOPY completions, which are handled by
+  // the writer.
+  if (event->events & (EPOLLOUT | EPOLLERR)) {
     // epoll_data->write_descriptor may be null here if this descriptor was
     // removed between when kevent returned and now.
     if (epoll_data->write_descriptor) {
@@ -407,20 +606,72 @@ void EPoller::CheckDescriptor(struct epoll_event *event,
   }
 }
 
-std::pair<EPollData*, bool> EPoller::LookupOrCreateDescriptor(int fd) {
-  pair<DescriptorMap::iterator, bool> result = m_descriptor_map.insert(
-      DescriptorMap::value_type(fd, NULL));
-  bool new_descriptor = result.second;
+/*
+ * Call DrainRead() until the descriptor is empty or the budget is used up, in
+ * which case it's added to m_pending_reads.
+ */
+void EPoller::DrainDescriptor(EPollData *epoll_data) {
+  for (unsigned int i = 0; i < READ_BUDGET; i++) {
+    // The callback may remove the descriptor.
+    if (!epoll_data->read_descriptor ||
+        !epoll_data->read_descriptor->DrainRead()) {
+      return;
+    }
+  }
+  if (epoll_data->read_descriptor) {
+    epoll_data->pending_read = true;
+    m_pending_reads.push_back(epoll_data->fd);
+  }
+}
 
-  if (new_descriptor) {
-    if (m_free_descriptors.empty()) {
-      result.first->second = new EPollData();
+void EPoller::DrainPendingReads() {
+  std::vector<int>::const_iterator iter = m_draining.begin();
+  for (; iter != m_draining.end(); ++iter) {
+    // The descriptor may have been removed, or the fd reused, since it was
+    // queued.
+    EPollData *epoll_data = LookupDescriptor(*iter);
+    if (!epoll_data || !epoll_data->pending_read) {
+      continue;
+    }
+    epoll_data->pending_read = false;
+    if (m_profiler) {
+      int fd = epoll_data->fd;
+      TimeStamp start;
+      m_profiler->Start(&start);
+      DrainDescriptor(epoll_data);
+      m_profiler->RecordDescriptor(fd, start);
     } else {
-      result.first->second = m_free_descriptors.back();
-      m_free_descriptors.pop_back();
+      DrainDescriptor(epoll_data);
     }
   }
-  return std::make_pair(result.first->second, new_descriptor);
+  m_draining.clear();
+}
+
+std::pair<EPollData*, bool> EPoller::LookupOrCreateDescriptor(int fd) {
+  if (static_cast<unsigned int>(fd) >= m_descriptors.size()) {
+    m_descriptors.resize(fd + 1, NULL);
+  }
+
+  EPollData *&epoll_data = m_descriptors[fd];
+  if (epoll_data) {
+    return std::make_pair(epoll_data, false);
+  }
+
+  if (m_free_descriptors.empty()) {
+    epoll_data = new EPollData();
+  } else {
+    epoll_data = m_free_descriptors.back();
+    m_free_descriptors.pop_back();
+  }
+  epoll_data->fd = fd;
+  return std::make_pair(epoll_data, true);
+}
+
+EPollData *EPoller::LookupDescriptor(int fd) const {
+  if (fd < 0 || static_cast<unsigned int>(fd) >= m_descriptors.size()) {
+    return NULL;
+  }
+  return m_descriptors[fd];
 }
 
 bool EPoller::RemoveDescriptor(int fd, int event, bool warn_on_missing) {
@@ -429,7 +680,7 @@ bool EPoller::RemoveDescriptor(int fd, int event, bool warn_on_missing) {
     return false;
   }
 
-  EPollData *epoll_data = STLFindOrNull(m_descriptor_map, fd);
+  EPollData *epoll_data = LookupDescriptor(fd);
   if (!epoll_data) {
     if (warn_on_missing) {
       OLA_WARN << "Couldn't find EPollData for " << fd;
@@ -442,14 +693,16 @@ bool EPoller::RemoveDescriptor(int fd, int event, bool warn_on_missing) {
   if (event & EPOLLOUT) {
     epoll_data->write_descriptor = NULL;
   } else if (event & EPOLLIN) {
+    epoll_data->events &= ~EPOLLET;
     epoll_data->read_descriptor = NULL;
     epoll_data->connected_descriptor = NULL;
+    epoll_data->pending_read = false;
   }
 
   if (epoll_data->events == 0) {
     RemoveEvent(m_epoll_fd, fd);
-    m_orphaned_descriptors.push_back(
-        STLLookupAndRemovePtr(&m_descriptor_map, fd));
+    m_orphaned_descriptors.push_back(epoll_data);
+    m_descriptors[fd] = NULL;
   } else {
     return UpdateEvent(m_epoll_fd, fd, epoll_data);
   }
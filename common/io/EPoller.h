@@ -27,7 +27,6 @@
 #include <ola/io/Descriptor.h>
 #include <sys/epoll.h>
 
-#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -40,6 +39,7 @@ namespace ola {
 namespace io {
 
 class EPollData;
+class LoopProfiler;
 
 /**
  * @class EPoller
@@ -47,6 +47,12 @@ class EPollData;
  *
  * epoll() is more efficient than select() but only newer Linux systems support
  * it.
+ *
+ * Read descriptors that return true from EdgeTriggered() are registered with
+ * EPOLLET. When they become readable, DrainRead() is called until the
+ * descriptor is empty or the READ_BUDGET is used up. Descriptors that still
+ * have data are drained again on the next call to Poll(), after the new
+ * events, so one busy descriptor can't starve the others.
  */
 class EPoller : public PollerInterface {
  public :
@@ -73,11 +79,36 @@ class EPoller : public PollerInterface {
   bool Poll(TimeoutManager *timeout_manager,
             const TimeInterval &poll_interval);
 
+  /**
+   * @brief Spin checking for events before blocking.
+   * @param interval how long to spin for, zero disables spinning.
+   *
+   * This also sets SO_BUSY_POLL on sockets added after this is called, so the
+   * kernel polls the device queue rather than waiting for an interrupt.
+   * Setting SO_BUSY_POLL usually requires CAP_NET_ADMIN.
+   */
+  void SetBusyPoll(const TimeInterval &interval);
+
+  /**
+   * @brief Use a timerfd to wake up for timeouts.
+   * @returns true if the timerfd was set up, false otherwise.
+   *
+   * Without this, the epoll_wait() timeout has millisecond resolution.
+   */
+  bool EnableHighResolutionTimers();
+
+  /**
+   * @brief Record the execution time of each descriptor callback.
+   * @param profiler the LoopProfiler to use, ownership is not transferred. Use
+   *   NULL to stop profiling.
+   */
+  void SetProfiler(LoopProfiler *profiler) { m_profiler = profiler; }
+
  private:
-  typedef std::map<int, EPollData*> DescriptorMap;
   typedef std::vector<EPollData*> DescriptorList;
 
-  DescriptorMap m_descriptor_map;
+  // Indexed by fd, NULL if the fd isn't registered.
+  DescriptorList m_descriptors;
 
   // EPoller is re-enterant. Remove may be called while we hold a pointer to an
   // EPollData. To avoid deleting data out from underneath ourselves, we
@@ -86,21 +117,37 @@ class EPoller : public PollerInterface {
   DescriptorList m_orphaned_descriptors;
   // A list of pre-allocated descriptors we can use.
   DescriptorList m_free_descriptors;
+  // The fds of edge-triggered descriptors that used up their READ_BUDGET.
+  // m_draining holds the list that's being processed.
+  std::vector<int> m_pending_reads;
+  std::vector<int> m_draining;
   ExportMap *m_export_map;
   CounterVariable *m_loop_iterations;
   CounterVariable *m_loop_time;
+  CounterVariable *m_timer_wakeups;
+  CounterVariable *m_wake_latency;
+  IntegerVariable *m_max_wake_latency;
   int m_epoll_fd;
+  int m_timer_fd;
+  TimeInterval m_busy_poll;
+  LoopProfiler *m_profiler;
   Clock *m_clock;
   TimeStamp m_wake_up_time;
 
   std::pair<EPollData*, bool> LookupOrCreateDescriptor(int fd);
+  EPollData *LookupDescriptor(int fd) const;
 
   bool RemoveDescriptor(int fd, int event, bool warn_on_missing);
   void CheckDescriptor(struct epoll_event *event, EPollData *descriptor);
+  void DrainDescriptor(EPollData *descriptor);
+  void DrainPendingReads();
+  int Wait(epoll_event *events, const TimeInterval &interval);
+  void EnableBusyPoll(int fd);
 
   static const int MAX_EVENTS;
   static const int READ_FLAGS;
   static const unsigned int MAX_FREE_DESCRIPTORS;
+  static const unsigned int READ_BUDGET;
 
   DISALLOW_COPY_AND_ASSIGN(EPoller);
 };
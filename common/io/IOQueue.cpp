@@ -29,12 +29,14 @@
 #include <iostream>
 #include <queue>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace io {
 
 using std::min;
 using std::string;
+using std::vector;
 
 /**
  * @brief IOQueue.
@@ -174,6 +176,30 @@ void IOQueue::Pop(unsigned int n) {
 }
 
 
+void IOQueue::Pop(unsigned int n, vector<MemoryBlock*> *blocks) {
+  unsigned int bytes_popped = 0;
+  BlockVector::iterator iter = m_blocks.begin();
+  while (iter != m_blocks.end() && bytes_popped != n) {
+    MemoryBlock *block = *iter;
+    bytes_popped += block->PopFront(n - bytes_popped);
+    if (block->Empty()) {
+      blocks->push_back(block);
+      iter = m_blocks.erase(iter);
+    } else {
+      iter++;
+    }
+  }
+}
+
+
+void IOQueue::Release(const vector<MemoryBlock*> &blocks) {
+  vector<MemoryBlock*>::const_iterator iter = blocks.begin();
+  for (; iter != blocks.end(); ++iter) {
+    m_pool->Release(*iter);
+  }
+}
+
+
 /**
  * Return this IOQueue as an array of IOVec structures.
  * Note: The IOVec array points at internal memory structures. This array is
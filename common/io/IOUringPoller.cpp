@@ -0,0 +1,702 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IOUringPoller.cpp
+ * A Poller which uses io_uring
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/io/IOUringPoller.h"
+
+#include <endian.h>
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Macro.h"
+#include "ola/io/Descriptor.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace io {
+
+using std::pair;
+
+/*
+ * Represents a FD
+ */
+class IOUringData {
+ public:
+  IOUringData()
+      : events(0),
+        token(0),
+        armed(false),
+        read_descriptor(NULL),
+        write_descriptor(NULL),
+        connected_descriptor(NULL),
+        delete_connected_on_close(false) {
+  }
+
+  void Reset() {
+    events = 0;
+    token = 0;
+    armed = false;
+    read_descriptor = NULL;
+    write_descriptor = NULL;
+    connected_descriptor = NULL;
+    delete_connected_on_close = false;
+  }
+
+  uint32_t events;
+  // Identifies the current poll request, the fd in the upper 32 bits.
+  uint64_t token;
+  // True if there is a poll request for the current events.
+  bool armed;
+  ReadFileDescriptor *read_descriptor;
+  WriteFileDescriptor *write_descriptor;
+  ConnectedDescriptor *connected_descriptor;
+  bool delete_connected_on_close;
+};
+
+/*
+ * The submission & completion rings shared with the kernel.
+ */
+class IOUringRing {
+ public:
+  IOUringRing()
+      : m_fd(INVALID_DESCRIPTOR),
+        m_sq_ring(MAP_FAILED),
+        m_cq_ring(MAP_FAILED),
+        m_sqes(MAP_FAILED),
+        m_sq_ring_size(0),
+        m_cq_ring_size(0),
+        m_sqes_size(0),
+        m_sq_tail(0) {
+  }
+
+  ~IOUringRing();
+
+  bool Init(unsigned int entries);
+
+  bool QueuePollAdd(int fd, uint32_t events, uint64_t token);
+  bool QueuePollRemove(uint64_t token);
+
+  /*
+   * Submit the queued requests without waiting.
+   */
+  bool Submit() { return Enter(0, 0, NULL, 0); }
+
+  /*
+   * Submit the queued requests, and wait up to timeout for a completion.
+   * Returns false if there was an error other than the timeout expiring.
+   */
+  bool SubmitAndWait(const TimeInterval &timeout);
+
+  /*
+   * Move the completions into the vector.
+   */
+  void Reap(std::vector<pair<uint64_t, int32_t> > *completions);
+
+ private:
+  int m_fd;
+  void *m_sq_ring;
+  void *m_cq_ring;
+  void *m_sqes;
+  size_t m_sq_ring_size;
+  size_t m_cq_ring_size;
+  size_t m_sqes_size;
+
+  unsigned int *m_sq_head;
+  unsigned int *m_sq_tail_ptr;
+  unsigned int m_sq_mask;
+  unsigned int m_sq_entries;
+  unsigned int *m_sq_array;
+  unsigned int *m_cq_head;
+  unsigned int *m_cq_tail;
+  unsigned int m_cq_mask;
+  struct io_uring_cqe *m_cqes;
+  // Our copy of the submission tail, published on submit.
+  unsigned int m_sq_tail;
+
+  struct io_uring_sqe *NextSQE();
+  bool Enter(unsigned int min_complete, unsigned int flags, void *arg,
+             size_t arg_size);
+
+  // The done request from a poll remove. By the time it completes the
+  // removed poll is of no interest.
+  static const uint64_t REMOVE_TOKEN = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(IOUringRing);
+};
+
+namespace {
+template <typename T>
+T *RingOffset(void *ring, unsigned int offset) {
+  return reinterpret_cast<T*>(static_cast<uint8_t*>(ring) + offset);
+}
+}  // namespace
+
+IOUringRing::~IOUringRing() {
+  if (m_sqes != MAP_FAILED) {
+    munmap(m_sqes, m_sqes_size);
+  }
+  if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring) {
+    munmap(m_cq_ring, m_cq_ring_size);
+  }
+  if (m_sq_ring != MAP_FAILED) {
+    munmap(m_sq_ring, m_sq_ring_size);
+  }
+  if (m_fd != INVALID_DESCRIPTOR) {
+    close(m_fd);
+  }
+}
+
+bool IOUringRing::Init(unsigned int entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  m_fd = syscall(__NR_io_uring_setup, entries, &params);
+  if (m_fd < 0) {
+    OLA_WARN << "io_uring_setup failed: " << strerror(errno);
+    m_fd = INVALID_DESCRIPTOR;
+    return false;
+  }
+
+  if (!(params.features & IORING_FEAT_EXT_ARG)) {
+    OLA_WARN << "io_uring doesn't support IORING_ENTER_EXT_ARG";
+    return false;
+  }
+
+  m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  m_cq_ring_size = (params.cq_off.cqes +
+                    params.cq_entries * sizeof(struct io_uring_cqe));
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size,
+                                               m_cq_ring_size);
+  }
+
+  m_sq_ring = mmap(NULL, m_sq_ring_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+  if (m_sq_ring == MAP_FAILED) {
+    OLA_WARN << "Failed to map the io_uring submission ring: "
+             << strerror(errno);
+    return false;
+  }
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    m_cq_ring = m_sq_ring;
+  } else {
+    m_cq_ring = mmap(NULL, m_cq_ring_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+    if (m_cq_ring == MAP_FAILED) {
+      OLA_WARN << "Failed to map the io_uring completion ring: "
+               << strerror(errno);
+      return false;
+    }
+  }
+
+  m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  m_sqes = mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+  if (m_sqes == MAP_FAILED) {
+    OLA_WARN << "Failed to map the io_uring submission entries: "
+             << strerror(errno);
+    return false;
+  }
+
+  m_sq_head = RingOffset<unsigned int>(m_sq_ring, params.sq_off.head);
+  m_sq_tail_ptr = RingOffset<unsigned int>(m_sq_ring, params.sq_off.tail);
+  m_sq_mask = *RingOffset<unsigned int>(m_sq_ring, params.sq_off.ring_mask);
+  m_sq_entries = *RingOffset<unsigned int>(m_sq_ring,
+                                           params.sq_off.ring_entries);
+  m_sq_array = RingOffset<unsigned int>(m_sq_ring, params.sq_off.array);
+  m_sq_tail = *m_sq_tail_ptr;
+
+  m_cq_head = RingOffset<unsigned int>(m_cq_ring, params.cq_off.head);
+  m_cq_tail = RingOffset<unsigned int>(m_cq_ring, params.cq_off.tail);
+  m_cq_mask = *RingOffset<unsigned int>(m_cq_ring, params.cq_off.ring_mask);
+  m_cqes = RingOffset<struct io_uring_cqe>(m_cq_ring, params.cq_off.cqes);
+  return true;
+}
+
+bool IOUringRing::QueuePollAdd(int fd, uint32_t events, uint64_t token) {
+  struct io_uring_sqe *sqe = NextSQE();
+  if (!sqe) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+#if __BYTE_ORDER == __BIG_ENDIAN
+  events = (events << 16) | (events >> 16);
+#endif  // __BYTE_ORDER == __BIG_ENDIAN
+  sqe->poll32_events = events;
+  sqe->user_data = token;
+  return true;
+}
+
+bool IOUringRing::QueuePollRemove(uint64_t token) {
+  struct io_uring_sqe *sqe = NextSQE();
+  if (!sqe) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = token;
+  sqe->user_data = REMOVE_TOKEN;
+  return true;
+}
+
+bool IOUringRing::SubmitAndWait(const TimeInterval &timeout) {
+  struct __kernel_timespec ts;
+  ts.tv_sec = timeout.Seconds();
+  ts.tv_nsec = timeout.MicroSeconds() * 1000;
+
+  struct io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.ts = reinterpret_cast<uint64_t>(&ts);
+  return Enter(1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg,
+               sizeof(arg));
+}
+
+void IOUringRing::Reap(std::vector<pair<uint64_t, int32_t> > *completions) {
+  unsigned int head = *m_cq_head;
+  unsigned int tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+  for (; head != tail; head++) {
+    const struct io_uring_cqe &cqe = m_cqes[head & m_cq_mask];
+    if (cqe.user_data != REMOVE_TOKEN) {
+      completions->push_back(std::make_pair(cqe.user_data, cqe.res));
+    }
+  }
+  __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+}
+
+struct io_uring_sqe *IOUringRing::NextSQE() {
+  if (m_sq_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) ==
+      m_sq_entries) {
+    // The ring is full, submit what we have without waiting
+    if (!Submit()) {
+      return NULL;
+    }
+  }
+
+  unsigned int index = m_sq_tail & m_sq_mask;
+  struct io_uring_sqe *sqe = static_cast<struct io_uring_sqe*>(m_sqes) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  m_sq_array[index] = index;
+  m_sq_tail++;
+  return sqe;
+}
+
+bool IOUringRing::Enter(unsigned int min_complete, unsigned int flags,
+                        void *arg, size_t arg_size) {
+  __atomic_store_n(m_sq_tail_ptr, m_sq_tail, __ATOMIC_RELEASE);
+  unsigned int to_submit = m_sq_tail - __atomic_load_n(m_sq_head,
+                                                       __ATOMIC_ACQUIRE);
+  int r = syscall(__NR_io_uring_enter, m_fd, to_submit, min_complete, flags,
+                  arg, arg_size);
+  if (r < 0 && errno != ETIME && errno != EINTR) {
+    OLA_WARN << "io_uring_enter() error, " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief The size of the submission ring.
+ */
+const unsigned int IOUringPoller::RING_ENTRIES = 256;
+
+/**
+ * @brief the poll flags used for read descriptors.
+ */
+const uint32_t IOUringPoller::READ_FLAGS = POLLIN | POLLRDHUP;
+
+/**
+ * @brief The number of pre-allocated IOUringData to have.
+ */
+const unsigned int IOUringPoller::MAX_FREE_DESCRIPTORS = 10;
+
+IOUringPoller::IOUringPoller(ExportMap *export_map, Clock* clock)
+    : m_export_map(export_map),
+      m_loop_iterations(NULL),
+      m_loop_time(NULL),
+      m_ring(new IOUringRing()),
+      m_clock(clock),
+      m_next_serial(1) {
+  if (m_export_map) {
+    m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
+    m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+  }
+
+  if (!m_ring->Init(RING_ENTRIES)) {
+    delete m_ring;
+    m_ring = NULL;
+  }
+}
+
+IOUringPoller::~IOUringPoller() {
+  DescriptorMap::iterator iter = m_descriptor_map.begin();
+  if (m_ring) {
+    // The poll requests hold a reference to the file, remove them so the
+    // descriptors are closed when they're deleted.
+    for (; iter != m_descriptor_map.end(); ++iter) {
+      if (iter->second->armed) {
+        m_ring->QueuePollRemove(iter->second->token);
+      }
+    }
+    m_ring->Submit();
+  }
+
+  for (iter = m_descriptor_map.begin(); iter != m_descriptor_map.end();
+       ++iter) {
+    if (iter->second->delete_connected_on_close) {
+      delete iter->second->connected_descriptor;
+    }
+    delete iter->second;
+  }
+
+  DescriptorList::iterator orphan_iter = m_orphaned_descriptors.begin();
+  for (; orphan_iter != m_orphaned_descriptors.end(); ++orphan_iter) {
+    if ((*orphan_iter)->delete_connected_on_close) {
+      delete (*orphan_iter)->connected_descriptor;
+    }
+    delete *orphan_iter;
+  }
+
+  STLDeleteElements(&m_free_descriptors);
+  delete m_ring;
+}
+
+bool IOUringPoller::AddReadDescriptor(ReadFileDescriptor *descriptor) {
+  if (!m_ring) {
+    return false;
+  }
+
+  if (!descriptor->ValidReadDescriptor()) {
+    OLA_WARN << "AddReadDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOUringData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->ReadDescriptor());
+  if (result.first->events & READ_FLAGS) {
+    OLA_WARN << "Descriptor " << descriptor->ReadDescriptor()
+             << " already in read set";
+    return false;
+  }
+
+  result.first->events |= READ_FLAGS;
+  result.first->read_descriptor = descriptor;
+  return UpdateDescriptor(descriptor->ReadDescriptor(), result.first);
+}
+
+bool IOUringPoller::AddReadDescriptor(ConnectedDescriptor *descriptor,
+                                      bool delete_on_close) {
+  if (!m_ring) {
+    return false;
+  }
+
+  if (!descriptor->ValidReadDescriptor()) {
+    OLA_WARN << "AddReadDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOUringData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->ReadDescriptor());
+
+  if (result.first->events & READ_FLAGS) {
+    OLA_WARN << "Descriptor " << descriptor->ReadDescriptor()
+             << " already in read set";
+    return false;
+  }
+
+  result.first->events |= READ_FLAGS;
+  result.first->connected_descriptor = descriptor;
+  result.first->delete_connected_on_close = delete_on_close;
+  return UpdateDescriptor(descriptor->ReadDescriptor(), result.first);
+}
+
+bool IOUringPoller::RemoveReadDescriptor(ReadFileDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->ReadDescriptor(), READ_FLAGS, true);
+}
+
+bool IOUringPoller::RemoveReadDescriptor(ConnectedDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->ReadDescriptor(), READ_FLAGS, true);
+}
+
+bool IOUringPoller::AddWriteDescriptor(WriteFileDescriptor *descriptor) {
+  if (!m_ring) {
+    return false;
+  }
+
+  if (!descriptor->ValidWriteDescriptor()) {
+    OLA_WARN << "AddWriteDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOUringData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->WriteDescriptor());
+
+  if (result.first->events & POLLOUT) {
+    OLA_WARN << "Descriptor " << descriptor->WriteDescriptor()
+             << " already in write set";
+    return false;
+  }
+
+  result.first->events |= POLLOUT;
+  result.first->write_descriptor = descriptor;
+  return UpdateDescriptor(descriptor->WriteDescriptor(), result.first);
+}
+
+bool IOUringPoller::RemoveWriteDescriptor(WriteFileDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->WriteDescriptor(), POLLOUT, true);
+}
+
+bool IOUringPoller::Poll(TimeoutManager *timeout_manager,
+                         const TimeInterval &poll_interval) {
+  if (!m_ring) {
+    return false;
+  }
+
+  TimeInterval sleep_interval = poll_interval;
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  TimeInterval next_event_in = timeout_manager->ExecuteTimeouts(&now);
+  if (!next_event_in.IsZero()) {
+    sleep_interval = std::min(next_event_in, sleep_interval);
+  }
+
+  // take care of stats accounting
+  if (m_wake_up_time.IsSet()) {
+    TimeInterval loop_time = now - m_wake_up_time;
+    OLA_DEBUG << "ss process time was " << loop_time.ToString();
+    if (m_loop_time)
+      (*m_loop_time) += loop_time.AsInt();
+    if (m_loop_iterations)
+      (*m_loop_iterations)++;
+  }
+
+  // The poll requests for new descriptors, and those that completed last
+  // time, are submitted along with the wait.
+  if (!ArmDescriptors() || !m_ring->SubmitAndWait(sleep_interval)) {
+    return false;
+  }
+
+  m_completions.clear();
+  m_ring->Reap(&m_completions);
+  m_clock->CurrentTime(&m_wake_up_time);
+
+  if (m_completions.empty()) {
+    timeout_manager->ExecuteTimeouts(&m_wake_up_time);
+    return true;
+  }
+
+  std::vector<pair<uint64_t, int32_t> >::const_iterator completion_iter =
+      m_completions.begin();
+  for (; completion_iter != m_completions.end(); ++completion_iter) {
+    // The descriptor may have been removed, or its events changed, since the
+    // request was submitted.
+    int fd = static_cast<int>(completion_iter->first >> 32);
+    IOUringData *data = STLFindOrNull(m_descriptor_map, fd);
+    if (!data || data->token != completion_iter->first) {
+      continue;
+    }
+
+    data->armed = false;
+    if (completion_iter->second < 0) {
+      if (completion_iter->second != -ECANCELED) {
+        OLA_WARN << "Poll of " << fd << " failed: "
+                 << strerror(-completion_iter->second);
+      }
+      continue;
+    }
+    m_unarmed_descriptors.push_back(fd);
+    CheckDescriptor(completion_iter->second, data);
+  }
+
+  // Now that we're out of the callback phase, clean up descriptors that were
+  // removed.
+  DescriptorList::iterator iter = m_orphaned_descriptors.begin();
+  for (; iter != m_orphaned_descriptors.end(); ++iter) {
+    if (m_free_descriptors.size() == MAX_FREE_DESCRIPTORS) {
+      delete *iter;
+    } else {
+      (*iter)->Reset();
+      m_free_descriptors.push_back(*iter);
+    }
+  }
+  m_orphaned_descriptors.clear();
+
+  m_clock->CurrentTime(&m_wake_up_time);
+  timeout_manager->ExecuteTimeouts(&m_wake_up_time);
+  return true;
+}
+
+/*
+ * Check a descriptor with events:
+ *  - Execute the callback for descriptors with data
+ *  - Excute OnClose if a remote end closed the connection
+ */
+void IOUringPoller::CheckDescriptor(uint32_t events, IOUringData *data) {
+  if (events & (POLLHUP | POLLRDHUP)) {
+    if (data->read_descriptor) {
+      data->read_descriptor->PerformRead();
+    } else if (data->write_descriptor) {
+      data->write_descriptor->PerformWrite();
+    } else if (data->connected_descriptor) {
+      ConnectedDescriptor::OnCloseCallback *on_close =
+          data->connected_descriptor->TransferOnClose();
+      if (on_close)
+        on_close->Run();
+
+      // At this point the descriptor may be sitting in the orphan list if the
+      // OnClose handler called into RemoveReadDescriptor()
+      if (data->delete_connected_on_close && data->connected_descriptor) {
+        bool removed = RemoveDescriptor(
+            data->connected_descriptor->ReadDescriptor(), READ_FLAGS, false);
+        if (removed && m_export_map) {
+          (*m_export_map->GetIntegerVar(K_CONNECTED_DESCRIPTORS_VAR))--;
+        }
+        delete data->connected_descriptor;
+        data->connected_descriptor = NULL;
+      }
+    } else {
+      OLA_FATAL << "HUP event for " << data
+                << " but no write or connected descriptor found!";
+    }
+    events = 0;
+  }
+
+  if (events & POLLIN) {
+    if (data->read_descriptor) {
+      data->read_descriptor->PerformRead();
+    } else if (data->connected_descriptor) {
+      data->connected_descriptor->PerformRead();
+    }
+  }
+
+  if (events & POLLOUT) {
+    // data->write_descriptor may be null here if this descriptor was
+    // removed by the read callback.
+    if (data->write_descriptor) {
+      data->write_descriptor->PerformWrite();
+    }
+  }
+}
+
+std::pair<IOUringData*, bool> IOUringPoller::LookupOrCreateDescriptor(
+    int fd) {
+  pair<DescriptorMap::iterator, bool> result = m_descriptor_map.insert(
+      DescriptorMap::value_type(fd, NULL));
+  bool new_descriptor = result.second;
+
+  if (new_descriptor) {
+    if (m_free_descriptors.empty()) {
+      result.first->second = new IOUringData();
+    } else {
+      result.first->second = m_free_descriptors.back();
+      m_free_descriptors.pop_back();
+    }
+  }
+  return std::make_pair(result.first->second, new_descriptor);
+}
+
+/*
+ * Called when the events for a descriptor change. Any existing request is
+ * removed and a new one is submitted on the next call to Poll().
+ */
+bool IOUringPoller::UpdateDescriptor(int fd, IOUringData *data) {
+  bool ok = true;
+  if (data->armed) {
+    ok = m_ring->QueuePollRemove(data->token);
+    data->armed = false;
+  }
+  // Completions for the old request are ignored.
+  data->token = (static_cast<uint64_t>(fd) << 32) | m_next_serial++;
+  if (!m_next_serial) {
+    m_next_serial++;
+  }
+  if (data->events) {
+    m_unarmed_descriptors.push_back(fd);
+  }
+  return ok;
+}
+
+bool IOUringPoller::RemoveDescriptor(int fd, uint32_t event,
+                                     bool warn_on_missing) {
+  if (fd == INVALID_DESCRIPTOR) {
+    OLA_WARN << "Attempt to remove an invalid file descriptor";
+    return false;
+  }
+
+  IOUringData *data = STLFindOrNull(m_descriptor_map, fd);
+  if (!data) {
+    if (warn_on_missing) {
+      OLA_WARN << "Couldn't find IOUringData for " << fd;
+    }
+    return false;
+  }
+
+  data->events &= (~event);
+
+  if (event & POLLOUT) {
+    data->write_descriptor = NULL;
+  } else if (event & POLLIN) {
+    data->read_descriptor = NULL;
+    data->connected_descriptor = NULL;
+  }
+
+  bool ok = UpdateDescriptor(fd, data);
+  if (data->events == 0) {
+    m_orphaned_descriptors.push_back(
+        STLLookupAndRemovePtr(&m_descriptor_map, fd));
+    // The poll request holds a reference to the file, so remove it now in
+    // case the descriptor is about to be closed.
+    ok &= m_ring->Submit();
+  }
+  return ok;
+}
+
+/*
+ * Queue a poll request for each descriptor that doesn't have one.
+ */
+bool IOUringPoller::ArmDescriptors() {
+  std::vector<int>::const_iterator iter = m_unarmed_descriptors.begin();
+  for (; iter != m_unarmed_descriptors.end(); ++iter) {
+    IOUringData *data = STLFindOrNull(m_descriptor_map, *iter);
+    if (!data || data->armed || !data->events) {
+      continue;
+    }
+    if (!m_ring->QueuePollAdd(*iter, data->events, data->token)) {
+      return false;
+    }
+    data->armed = true;
+  }
+  m_unarmed_descriptors.clear();
+  return true;
+}
+}  // namespace io
+}  // namespace ola
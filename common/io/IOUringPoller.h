@@ -0,0 +1,124 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IOUringPoller.h
+ * A Poller which uses io_uring
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_IOURINGPOLLER_H_
+#define COMMON_IO_IOURINGPOLLER_H_
+
+#include <ola/base/Macro.h>
+#include <ola/Clock.h>
+#include <ola/ExportMap.h>
+#include <ola/io/Descriptor.h>
+#include <stdint.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "common/io/PollerInterface.h"
+#include "common/io/TimeoutManager.h"
+
+namespace ola {
+namespace io {
+
+class IOUringData;
+class IOUringRing;
+
+/**
+ * @class IOUringPoller
+ * @brief An implementation of PollerInterface that uses io_uring.
+ *
+ * Each descriptor has a poll request in the submission ring. Requests are
+ * re-armed once they complete, and all the changes are submitted in the same
+ * io_uring_enter() call that waits for completions, so each iteration of the
+ * loop is a single system call regardless of the number of descriptors.
+ *
+ * This requires Linux 5.11 or later. Use Valid() to check that the ring was
+ * set up.
+ */
+class IOUringPoller : public PollerInterface {
+ public :
+  /**
+   * @brief Create a new IOUringPoller.
+   * @param export_map the ExportMap to use
+   * @param clock the Clock to use
+   */
+  IOUringPoller(ExportMap *export_map, Clock *clock);
+
+  ~IOUringPoller();
+
+  /**
+   * @brief Check if the io_uring was set up.
+   * @returns true if the poller can be used, false otherwise.
+   */
+  bool Valid() const { return m_ring != NULL; }
+
+  bool AddReadDescriptor(class ReadFileDescriptor *descriptor);
+  bool AddReadDescriptor(class ConnectedDescriptor *descriptor,
+                         bool delete_on_close);
+  bool RemoveReadDescriptor(class ReadFileDescriptor *descriptor);
+  bool RemoveReadDescriptor(class ConnectedDescriptor *descriptor);
+
+  bool AddWriteDescriptor(class WriteFileDescriptor *descriptor);
+  bool RemoveWriteDescriptor(class WriteFileDescriptor *descriptor);
+
+  const TimeStamp *WakeUpTime() const { return &m_wake_up_time; }
+
+  bool Poll(TimeoutManager *timeout_manager,
+            const TimeInterval &poll_interval);
+
+ private:
+  typedef std::map<int, IOUringData*> DescriptorMap;
+  typedef std::vector<IOUringData*> DescriptorList;
+
+  DescriptorMap m_descriptor_map;
+
+  // As with the EPoller, descriptors removed from within a callback are
+  // moved to this list and cleaned up outside the callback loop.
+  DescriptorList m_orphaned_descriptors;
+  // A list of pre-allocated descriptors we can use.
+  DescriptorList m_free_descriptors;
+  // The descriptors which need a new poll request.
+  std::vector<int> m_unarmed_descriptors;
+  // The completions from the last wait, as (user data, result) pairs.
+  std::vector<std::pair<uint64_t, int32_t> > m_completions;
+  ExportMap *m_export_map;
+  CounterVariable *m_loop_iterations;
+  CounterVariable *m_loop_time;
+  IOUringRing *m_ring;
+  Clock *m_clock;
+  TimeStamp m_wake_up_time;
+  uint32_t m_next_serial;
+
+  std::pair<IOUringData*, bool> LookupOrCreateDescriptor(int fd);
+
+  bool UpdateDescriptor(int fd, IOUringData *data);
+  bool RemoveDescriptor(int fd, uint32_t events, bool warn_on_missing);
+  bool ArmDescriptors();
+  void CheckDescriptor(uint32_t events, IOUringData *data);
+
+  static const unsigned int RING_ENTRIES;
+  static const uint32_t READ_FLAGS;
+  static const unsigned int MAX_FREE_DESCRIPTORS;
+
+  DISALLOW_COPY_AND_ASSIGN(IOUringPoller);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_IOURINGPOLLER_H_
@@ -19,24 +19,29 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <string>
 
 #include "ola/Logging.h"
 #include "ola/io/MemoryBuffer.h"
 #include "ola/io/BigEndianStream.h"
 #include "ola/testing/TestUtils.h"
 
+using ola::io::BigEndianBufferInputStream;
 using ola::io::BigEndianInputStream;
 using ola::io::MemoryBuffer;
+using std::string;
 
 
 class InputStreamTest: public CppUnit::TestFixture {
  public:
   CPPUNIT_TEST_SUITE(InputStreamTest);
   CPPUNIT_TEST(testRead);
+  CPPUNIT_TEST(testBufferRead);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testRead();
+  void testBufferRead();
 };
 
 
@@ -84,3 +89,39 @@ void InputStreamTest::testRead() {
 
   OLA_ASSERT_FALSE(stream >> uint16);
 }
+
+
+/*
+ * Confirm that reading from a concrete buffer works.
+ */
+void InputStreamTest::testBufferRead() {
+  uint8_t data[] = {
+    0x81,
+    0x83, 0x01,
+    0x87, 0x65, 0x43, 0x21,
+    'f', 'o', 'o',
+    0x12,
+  };
+
+  MemoryBuffer buffer(data, sizeof(data));
+  BigEndianBufferInputStream<MemoryBuffer> stream(&buffer);
+
+  uint8_t uint8;
+  OLA_ASSERT_TRUE(stream >> uint8);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(129), uint8);
+
+  uint16_t uint16;
+  OLA_ASSERT_TRUE(stream >> uint16);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(33537), uint16);
+
+  int32_t int32;
+  OLA_ASSERT_TRUE(stream >> int32);
+  OLA_ASSERT_EQ(static_cast<int32_t>(-2023406815), int32);
+
+  string output;
+  OLA_ASSERT_EQ(3u, stream.ReadString(&output, 3));
+  OLA_ASSERT_EQ(string("foo"), output);
+
+  // Only one byte remains.
+  OLA_ASSERT_FALSE(stream >> uint16);
+}
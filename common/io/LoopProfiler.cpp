@@ -0,0 +1,124 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * LoopProfiler.cpp
+ * Records the execution time of event loop callbacks.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/io/LoopProfiler.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/strings/Format.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace io {
+
+const char LoopProfiler::K_CALLBACKS_VAR[] = "ss-loop-callbacks";
+const char LoopProfiler::K_SLOW_CALLBACKS_VAR[] = "ss-loop-slow-callbacks";
+const char LoopProfiler::K_CALLBACK_P50_VAR[] = "ss-loop-callback-p50-us";
+const char LoopProfiler::K_CALLBACK_P99_VAR[] = "ss-loop-callback-p99-us";
+const char LoopProfiler::K_CALLBACK_MAX_VAR[] = "ss-loop-callback-max-us";
+const char LoopProfiler::K_SLOW_THRESHOLD_VAR[] = "ss-loop-slow-threshold-us";
+
+LoopProfiler::LoopProfiler(ExportMap *export_map,
+                           const Clock *clock,
+                           const TimeInterval &slow_threshold)
+    : m_clock(clock),
+      m_slow_threshold(slow_threshold),
+      m_callbacks_var(NULL),
+      m_slow_callbacks_var(NULL),
+      m_p50_var(NULL),
+      m_p99_var(NULL),
+      m_max_var(NULL) {
+  if (export_map) {
+    m_callbacks_var = export_map->GetUIntMapVar(K_CALLBACKS_VAR, "callback");
+    m_slow_callbacks_var = export_map->GetUIntMapVar(K_SLOW_CALLBACKS_VAR,
+                                                     "callback");
+    m_p50_var = export_map->GetUIntMapVar(K_CALLBACK_P50_VAR, "callback");
+    m_p99_var = export_map->GetUIntMapVar(K_CALLBACK_P99_VAR, "callback");
+    m_max_var = export_map->GetUIntMapVar(K_CALLBACK_MAX_VAR, "callback");
+    export_map->GetIntegerVar(K_SLOW_THRESHOLD_VAR)->Set(
+        static_cast<int>(m_slow_threshold.AsInt()));
+  }
+}
+
+LoopProfiler::~LoopProfiler() {
+  STLDeleteValues(&m_descriptor_stats);
+  STLDeleteValues(&m_timeout_stats);
+}
+
+void LoopProfiler::RecordDescriptor(int fd, const TimeStamp &start) {
+  CallbackStats *&stats = m_descriptor_stats[fd];
+  if (!stats) {
+    stats = new CallbackStats();
+    stats->name = "fd-" + ola::strings::IntToString(fd);
+    stats->unexported_samples = 0;
+  }
+  Record(stats, start);
+}
+
+void LoopProfiler::RecordTimeout(const TimeInterval &interval,
+                                 const TimeStamp &start) {
+  CallbackStats *&stats = m_timeout_stats[interval.AsInt()];
+  if (!stats) {
+    stats = new CallbackStats();
+    stats->name = "timeout-" +
+        ola::strings::IntToString(
+            static_cast<int>(interval.InMilliSeconds())) + "ms";
+    stats->unexported_samples = 0;
+  }
+  Record(stats, start);
+}
+
+void LoopProfiler::Record(CallbackStats *stats, const TimeStamp &start) {
+  TimeStamp end;
+  m_clock->CurrentTime(&end);
+  const TimeInterval duration = end - start;
+  stats->histogram.Add(static_cast<uint32_t>(
+      std::min(duration.AsInt(), static_cast<int64_t>(0xffffffff))));
+
+  if (duration >= m_slow_threshold) {
+    OLA_INFO << "Slow callback " << stats->name << " took " << duration;
+    if (m_slow_callbacks_var) {
+      m_slow_callbacks_var->Increment(stats->name);
+    }
+  }
+
+  if (stats->histogram.Count() == 1 ||
+      ++stats->unexported_samples >= EXPORT_SAMPLES) {
+    stats->unexported_samples = 0;
+    Export(*stats);
+  }
+}
+
+void LoopProfiler::Export(const CallbackStats &stats) {
+  if (!m_callbacks_var) {
+    return;
+  }
+  (*m_callbacks_var)[stats.name] = static_cast<unsigned int>(
+      stats.histogram.Count());
+  (*m_p50_var)[stats.name] = stats.histogram.Percentile(50);
+  (*m_p99_var)[stats.name] = stats.histogram.Percentile(99);
+  (*m_max_var)[stats.name] = stats.histogram.Max();
+}
+}  // namespace io
+}  // namespace ola
@@ -0,0 +1,116 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * LoopProfiler.h
+ * Records the execution time of event loop callbacks.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_LOOPPROFILER_H_
+#define COMMON_IO_LOOPPROFILER_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/util/Histogram.h"
+
+namespace ola {
+namespace io {
+
+/**
+ * @class LoopProfiler
+ * @brief Records how long each descriptor and timeout callback takes to run.
+ *
+ * Descriptor callbacks are keyed by the file descriptor, e.g. "fd-7", and
+ * timeouts by their interval, e.g. "timeout-1000ms". Since descriptor numbers
+ * are reused, the stats for a key may cover more than one descriptor.
+ *
+ * The p50, p99 and maximum execution times are exported as map variables,
+ * refreshed on the first sample for a key and then every 64 samples. Callbacks
+ * that take longer than the slow threshold are counted, and logged at INFO.
+ */
+class LoopProfiler {
+ public:
+  /**
+   * @brief Create a new LoopProfiler.
+   * @param export_map the ExportMap to export the results to.
+   * @param clock the Clock to use.
+   * @param slow_threshold callbacks that run for at least this long are
+   *   counted as slow.
+   */
+  LoopProfiler(ExportMap *export_map, const Clock *clock,
+               const TimeInterval &slow_threshold);
+  ~LoopProfiler();
+
+  /**
+   * @brief Record the start time of a callback.
+   */
+  void Start(TimeStamp *start) const { m_clock->CurrentTime(start); }
+
+  /**
+   * @brief Record the end of a descriptor callback.
+   * @param fd the descriptor the callback was run for.
+   * @param start the time passed to Start().
+   */
+  void RecordDescriptor(int fd, const TimeStamp &start);
+
+  /**
+   * @brief Record the end of a timeout callback.
+   * @param interval the interval of the timeout.
+   * @param start the time passed to Start().
+   */
+  void RecordTimeout(const TimeInterval &interval, const TimeStamp &start);
+
+  static const char K_CALLBACKS_VAR[];
+  static const char K_SLOW_CALLBACKS_VAR[];
+  static const char K_CALLBACK_P50_VAR[];
+  static const char K_CALLBACK_P99_VAR[];
+  static const char K_CALLBACK_MAX_VAR[];
+  static const char K_SLOW_THRESHOLD_VAR[];
+
+ private:
+  struct CallbackStats {
+    std::string name;
+    Histogram histogram;
+    unsigned int unexported_samples;
+  };
+
+  typedef std::map<int, CallbackStats*> DescriptorStatsMap;
+  typedef std::map<int64_t, CallbackStats*> TimeoutStatsMap;
+
+  const Clock *m_clock;
+  const TimeInterval m_slow_threshold;
+  DescriptorStatsMap m_descriptor_stats;
+  TimeoutStatsMap m_timeout_stats;
+  UIntMap *m_callbacks_var;
+  UIntMap *m_slow_callbacks_var;
+  UIntMap *m_p50_var;
+  UIntMap *m_p99_var;
+  UIntMap *m_max_var;
+
+  void Record(CallbackStats *stats, const TimeStamp &start);
+  void Export(const CallbackStats &stats);
+
+  static const unsigned int EXPORT_SAMPLES = 64;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopProfiler);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_LOOPPROFILER_H_
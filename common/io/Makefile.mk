@@ -7,11 +7,18 @@ common_libolacommon_la_SOURCES += \
     common/io/IOQueue.cpp \
     common/io/IOStack.cpp \
     common/io/IOUtils.cpp \
+    common/io/LoopProfiler.cpp \
+    common/io/LoopProfiler.h \
+    common/io/MemoryBlockPool.cpp \
     common/io/NonBlockingSender.cpp \
     common/io/PollerInterface.cpp \
     common/io/PollerInterface.h \
+    common/io/RingBuffer.cpp \
     common/io/SelectServer.cpp \
+    common/io/SelectServerPool.cpp \
     common/io/Serial.cpp \
+    common/io/SerialPacer.cpp \
+    common/io/SerialPacer.h \
     common/io/StdinHandler.cpp \
     common/io/TimeoutManager.cpp \
     common/io/TimeoutManager.h
@@ -32,6 +39,12 @@ common_libolacommon_la_SOURCES += \
     common/io/EPoller.cpp
 endif
 
+if HAVE_IO_URING
+common_libolacommon_la_SOURCES += \
+    common/io/IOUringPoller.h \
+    common/io/IOUringPoller.cpp
+endif
+
 if HAVE_KQUEUE
 common_libolacommon_la_SOURCES += \
     common/io/KQueuePoller.h \
@@ -45,6 +58,7 @@ test_programs += \
     common/io/IOQueueTester \
     common/io/IOStackTester \
     common/io/MemoryBlockTester \
+    common/io/RingBufferTester \
     common/io/SelectServerTester \
     common/io/StreamTester \
     common/io/TimeoutManagerTester
@@ -61,16 +75,22 @@ common_io_DescriptorTester_SOURCES = common/io/DescriptorTest.cpp
 common_io_DescriptorTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_DescriptorTester_LDADD = $(COMMON_TESTING_LIBS)
 
-common_io_MemoryBlockTester_SOURCES = common/io/MemoryBlockTest.cpp
+common_io_MemoryBlockTester_SOURCES = common/io/MemoryBlockTest.cpp \
+                                      common/io/MemoryBlockPoolTest.cpp
 common_io_MemoryBlockTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_MemoryBlockTester_LDADD = $(COMMON_TESTING_LIBS)
 
+common_io_RingBufferTester_SOURCES = common/io/RingBufferTest.cpp
+common_io_RingBufferTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_io_RingBufferTester_LDADD = $(COMMON_TESTING_LIBS)
+
 common_io_SelectServerTester_SOURCES = common/io/SelectServerTest.cpp \
                                        common/io/SelectServerThreadTest.cpp
 common_io_SelectServerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_SelectServerTester_LDADD = $(COMMON_TESTING_LIBS)
 
-common_io_TimeoutManagerTester_SOURCES = common/io/TimeoutManagerTest.cpp
+common_io_TimeoutManagerTester_SOURCES = common/io/SerialPacerTest.cpp \
+                                         common/io/TimeoutManagerTest.cpp
 common_io_TimeoutManagerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_TimeoutManagerTester_LDADD = $(COMMON_TESTING_LIBS)
 
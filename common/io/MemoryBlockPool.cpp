@@ -0,0 +1,389 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MemoryBlockPool.cpp
+ * Allocates and Releases MemoryBlocks.
+ * Copyright (C) 2013 Simon Newton
+ */
+
+#include <pthread.h>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/ExportMap.h"
+#include "ola/Logging.h"
+#include "ola/io/MemoryBlock.h"
+#include "ola/io/MemoryBlockPool.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+namespace io {
+
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+const char MemoryBlockPool::K_POOL_HITS_VAR[] = "memory-block-pool-hits";
+const char MemoryBlockPool::K_POOL_MISSES_VAR[] = "memory-block-pool-misses";
+
+/*
+ * The free blocks held by one thread.
+ */
+struct MemoryBlockPool::ThreadCache {
+  ThreadCache(ThreadState *state, unsigned int size_classes)
+      : state(state),
+        free_blocks(size_classes),
+        hits(size_classes, 0) {
+  }
+
+  ThreadState *state;
+  vector<BlockVector> free_blocks;
+  // Hits that haven't been added to the ExportMap yet.
+  vector<unsigned int> hits;
+};
+
+/*
+ * The state used by thread safe pools.
+ */
+struct MemoryBlockPool::ThreadState {
+  explicit ThreadState(MemoryBlockPool *pool)
+      : pool(pool) {
+    pthread_key_create(&cache_key, MemoryBlockPool::ThreadExit);
+  }
+
+  ~ThreadState() {
+    pthread_key_delete(cache_key);
+  }
+
+  MemoryBlockPool *pool;
+  pthread_key_t cache_key;
+  ola::thread::Mutex mutex;
+  std::set<ThreadCache*> caches;
+};
+
+MemoryBlockPool::MemoryBlockPool(unsigned int block_size)
+    : m_blocks_allocated(0),
+      m_thread_cache_size(0),
+      m_thread_state(NULL),
+      m_hits_var(NULL),
+      m_misses_var(NULL) {
+  Options options;
+  options.block_size = block_size;
+  Init(options);
+}
+
+MemoryBlockPool::MemoryBlockPool(const Options &options)
+    : m_blocks_allocated(0),
+      m_thread_cache_size(std::max(options.thread_cache_size, 1u)),
+      m_thread_state(NULL),
+      m_hits_var(NULL),
+      m_misses_var(NULL) {
+  Init(options);
+}
+
+MemoryBlockPool::~MemoryBlockPool() {
+  if (m_thread_state) {
+    // Threads that have exited have already returned their blocks, so this
+    // only deletes the caches of threads that are still running.
+    std::set<ThreadCache*>::iterator iter = m_thread_state->caches.begin();
+    for (; iter != m_thread_state->caches.end(); ++iter) {
+      vector<BlockVector>::iterator class_iter = (*iter)->free_blocks.begin();
+      for (; class_iter != (*iter)->free_blocks.end(); ++class_iter) {
+        STLDeleteElements(&(*class_iter));
+      }
+      delete *iter;
+    }
+    delete m_thread_state;
+    m_thread_state = NULL;
+  }
+  Purge();
+}
+
+MemoryBlock *MemoryBlockPool::Allocate() {
+  return AllocateFromClass(0);
+}
+
+MemoryBlock *MemoryBlockPool::Allocate(unsigned int size) {
+  int size_class = 0;
+  while (static_cast<unsigned int>(size_class) < m_block_sizes.size() &&
+         m_block_sizes[size_class] < size) {
+    size_class++;
+  }
+  if (static_cast<unsigned int>(size_class) == m_block_sizes.size()) {
+    OLA_WARN << "Requested block of " << size << " bytes, the largest is "
+             << MaxBlockSize();
+    return NULL;
+  }
+  return AllocateFromClass(size_class);
+}
+
+void MemoryBlockPool::Release(MemoryBlock *block) {
+  if (!block) {
+    return;
+  }
+
+  int size_class = SizeClass(block->Capacity());
+  if (size_class < 0) {
+    // Not one of ours.
+    delete block;
+    return;
+  }
+
+  block->Reset();
+  if (!m_thread_state) {
+    m_free_blocks[size_class].push_back(block);
+    return;
+  }
+
+  ThreadCache *cache = GetThreadCache();
+  BlockVector *blocks = &cache->free_blocks[size_class];
+  blocks->push_back(block);
+  if (blocks->size() > m_thread_cache_size) {
+    // Keep half, so a thread alternating between allocate & release doesn't
+    // hit the depot each time.
+    ReturnToDepot(cache, size_class, m_thread_cache_size / 2);
+  }
+}
+
+unsigned int MemoryBlockPool::FreeBlocks() const {
+  if (!m_thread_state) {
+    return DepotBlocks();
+  }
+
+  unsigned int free_blocks = 0;
+  ThreadCache *cache = GetThreadCache();
+  vector<BlockVector>::const_iterator iter = cache->free_blocks.begin();
+  for (; iter != cache->free_blocks.end(); ++iter) {
+    free_blocks += iter->size();
+  }
+  MutexLocker lock(&m_thread_state->mutex);
+  return free_blocks + DepotBlocks();
+}
+
+void MemoryBlockPool::Purge(unsigned int remaining) {
+  if (m_thread_state) {
+    ThreadCache *cache = GetThreadCache();
+    for (unsigned int i = 0; i < m_block_sizes.size(); i++) {
+      ReturnToDepot(cache, i, 0);
+    }
+    m_thread_state->mutex.Lock();
+  }
+
+  unsigned int free_blocks = DepotBlocks();
+  // Free the largest blocks first.
+  vector<BlockVector>::reverse_iterator iter = m_free_blocks.rbegin();
+  for (; iter != m_free_blocks.rend() && free_blocks > remaining; ++iter) {
+    while (!iter->empty() && free_blocks > remaining) {
+      delete iter->back();
+      iter->pop_back();
+      m_blocks_allocated--;
+      free_blocks--;
+    }
+  }
+
+  if (m_thread_state) {
+    m_thread_state->mutex.Unlock();
+  }
+}
+
+unsigned int MemoryBlockPool::BlocksAllocated() const {
+  if (!m_thread_state) {
+    return m_blocks_allocated;
+  }
+  MutexLocker lock(&m_thread_state->mutex);
+  return m_blocks_allocated;
+}
+
+void MemoryBlockPool::Init(const Options &options) {
+  unsigned int block_size = std::max(options.block_size, 1u);
+  unsigned int size_classes = std::max(options.size_classes, 1u);
+  for (unsigned int i = 0; i < size_classes; i++) {
+    m_block_sizes.push_back(block_size << i);
+  }
+  m_free_blocks.resize(size_classes);
+
+  if (options.thread_safe) {
+    m_thread_state = new ThreadState(this);
+  }
+
+  if (options.export_map) {
+    m_hits_var = options.export_map->GetUIntMapVar(K_POOL_HITS_VAR, "pool");
+    m_misses_var = options.export_map->GetUIntMapVar(K_POOL_MISSES_VAR,
+                                                     "pool");
+    for (unsigned int i = 0; i < size_classes; i++) {
+      m_stat_keys.push_back(
+          options.name + ":" + ola::strings::IntToString(m_block_sizes[i]));
+      (*m_hits_var)[m_stat_keys.back()] = 0;
+      (*m_misses_var)[m_stat_keys.back()] = 0;
+    }
+  }
+}
+
+/*
+ * Return the size class for a block of the given capacity, or -1 if the
+ * capacity doesn't match any size class.
+ */
+int MemoryBlockPool::SizeClass(unsigned int capacity) const {
+  vector<unsigned int>::const_iterator iter = std::lower_bound(
+      m_block_sizes.begin(), m_block_sizes.end(), capacity);
+  if (iter == m_block_sizes.end() || *iter != capacity) {
+    return -1;
+  }
+  return static_cast<int>(iter - m_block_sizes.begin());
+}
+
+MemoryBlock *MemoryBlockPool::AllocateFromClass(unsigned int size_class) {
+  if (!m_thread_state) {
+    return AllocateFromDepot(size_class, NULL);
+  }
+
+  ThreadCache *cache = GetThreadCache();
+  BlockVector *blocks = &cache->free_blocks[size_class];
+  if (blocks->empty()) {
+    MutexLocker lock(&m_thread_state->mutex);
+    return AllocateFromDepot(size_class, cache);
+  }
+
+  MemoryBlock *block = blocks->back();
+  blocks->pop_back();
+  cache->hits[size_class]++;
+  return block;
+}
+
+/*
+ * Take a block from the depot. For a thread safe pool, the mutex must be held
+ * and the cache is refilled with up to half of thread_cache_size blocks.
+ */
+MemoryBlock *MemoryBlockPool::AllocateFromDepot(unsigned int size_class,
+                                                ThreadCache *cache) {
+  if (cache) {
+    FlushHits(cache);
+  }
+
+  BlockVector *depot = &m_free_blocks[size_class];
+  if (depot->empty()) {
+    if (m_misses_var) {
+      (*m_misses_var)[m_stat_keys[size_class]]++;
+    }
+    return NewBlock(size_class);
+  }
+
+  if (m_hits_var) {
+    (*m_hits_var)[m_stat_keys[size_class]]++;
+  }
+  MemoryBlock *block = depot->back();
+  depot->pop_back();
+
+  if (cache) {
+    BlockVector *blocks = &cache->free_blocks[size_class];
+    unsigned int refill = std::min(
+        static_cast<unsigned int>(depot->size()), m_thread_cache_size / 2);
+    blocks->insert(blocks->end(), depot->end() - refill, depot->end());
+    depot->resize(depot->size() - refill);
+  }
+  return block;
+}
+
+MemoryBlock *MemoryBlockPool::NewBlock(unsigned int size_class) {
+  unsigned int block_size = m_block_sizes[size_class];
+  uint8_t* data = new uint8_t[block_size];
+  OLA_DEBUG << "new block allocated at @" << reinterpret_cast<int*>(data);
+  if (data) {
+    m_blocks_allocated++;
+    return new MemoryBlock(data, block_size);
+  } else {
+    return NULL;
+  }
+}
+
+/*
+ * Move all but remaining blocks of a size class from the cache to the depot.
+ */
+void MemoryBlockPool::ReturnToDepot(ThreadCache *cache,
+                                    unsigned int size_class,
+                                    unsigned int remaining) {
+  BlockVector *blocks = &cache->free_blocks[size_class];
+  MutexLocker lock(&m_thread_state->mutex);
+  FlushHits(cache);
+  if (blocks->size() <= remaining) {
+    return;
+  }
+  BlockVector *depot = &m_free_blocks[size_class];
+  depot->insert(depot->end(), blocks->begin() + remaining, blocks->end());
+  blocks->resize(remaining);
+}
+
+/*
+ * Add the cache's hits to the ExportMap. The mutex must be held.
+ */
+void MemoryBlockPool::FlushHits(ThreadCache *cache) {
+  for (unsigned int i = 0; i < cache->hits.size(); i++) {
+    if (m_hits_var && cache->hits[i]) {
+      (*m_hits_var)[m_stat_keys[i]] += cache->hits[i];
+    }
+    cache->hits[i] = 0;
+  }
+}
+
+MemoryBlockPool::ThreadCache *MemoryBlockPool::GetThreadCache() const {
+  ThreadCache *cache = static_cast<ThreadCache*>(
+      pthread_getspecific(m_thread_state->cache_key));
+  if (!cache) {
+    cache = new ThreadCache(m_thread_state, m_block_sizes.size());
+    pthread_setspecific(m_thread_state->cache_key, cache);
+    MutexLocker lock(&m_thread_state->mutex);
+    m_thread_state->caches.insert(cache);
+  }
+  return cache;
+}
+
+/*
+ * Return all the blocks in a cache to the depot, and delete the cache.
+ */
+void MemoryBlockPool::DeleteThreadCache(ThreadCache *cache) {
+  for (unsigned int i = 0; i < m_block_sizes.size(); i++) {
+    ReturnToDepot(cache, i, 0);
+  }
+  MutexLocker lock(&m_thread_state->mutex);
+  m_thread_state->caches.erase(cache);
+  delete cache;
+}
+
+/*
+ * The number of blocks in the depot. For a thread safe pool, the mutex must
+ * be held.
+ */
+unsigned int MemoryBlockPool::DepotBlocks() const {
+  unsigned int free_blocks = 0;
+  vector<BlockVector>::const_iterator iter = m_free_blocks.begin();
+  for (; iter != m_free_blocks.end(); ++iter) {
+    free_blocks += iter->size();
+  }
+  return free_blocks;
+}
+
+/*
+ * Called when a thread that used a thread safe pool exits.
+ */
+void MemoryBlockPool::ThreadExit(void *data) {
+  ThreadCache *cache = static_cast<ThreadCache*>(data);
+  cache->state->pool->DeleteThreadCache(cache);
+}
+}  // namespace io
+}  // namespace ola
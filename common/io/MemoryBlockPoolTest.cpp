@@ -0,0 +1,246 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MemoryBlockPoolTest.cpp
+ * Test fixture for the MemoryBlockPool class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/ExportMap.h"
+#include "ola/io/MemoryBlock.h"
+#include "ola/io/MemoryBlockPool.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Thread.h"
+
+using ola::ExportMap;
+using ola::UIntMap;
+using ola::io::MemoryBlock;
+using ola::io::MemoryBlockPool;
+using std::vector;
+
+class MemoryBlockPoolTest: public CppUnit::TestFixture {
+ public:
+  CPPUNIT_TEST_SUITE(MemoryBlockPoolTest);
+  CPPUNIT_TEST(testAllocate);
+  CPPUNIT_TEST(testSizeClasses);
+  CPPUNIT_TEST(testThreadSafe);
+  CPPUNIT_TEST(testExportMap);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testAllocate();
+  void testSizeClasses();
+  void testThreadSafe();
+  void testExportMap();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MemoryBlockPoolTest);
+
+
+/*
+ * A thread which allocates & releases blocks.
+ */
+class PoolThread: public ola::thread::Thread {
+ public:
+  explicit PoolThread(MemoryBlockPool *pool)
+      : m_pool(pool),
+        m_failed(false) {
+  }
+
+  void *Run() {
+    vector<MemoryBlock*> blocks;
+    for (unsigned int i = 0; i < 1000; i++) {
+      for (unsigned int j = 0; j < 40; j++) {
+        MemoryBlock *block = m_pool->Allocate();
+        if (!block || !block->Empty()) {
+          m_failed = true;
+        } else {
+          block->Append(reinterpret_cast<const uint8_t*>(&j), sizeof(j));
+          blocks.push_back(block);
+        }
+      }
+      vector<MemoryBlock*>::iterator iter = blocks.begin();
+      for (; iter != blocks.end(); ++iter) {
+        m_pool->Release(*iter);
+      }
+      blocks.clear();
+    }
+    return NULL;
+  }
+
+  bool Failed() const { return m_failed; }
+
+ private:
+  MemoryBlockPool *m_pool;
+  bool m_failed;
+};
+
+
+/*
+ * Check that blocks are reused, and can be purged.
+ */
+void MemoryBlockPoolTest::testAllocate() {
+  MemoryBlockPool pool(4);
+  OLA_ASSERT_EQ(4u, pool.BlockSize());
+  OLA_ASSERT_EQ(4u, pool.MaxBlockSize());
+
+  MemoryBlock *block1 = pool.Allocate();
+  MemoryBlock *block2 = pool.Allocate();
+  OLA_ASSERT_NOT_NULL(block1);
+  OLA_ASSERT_NOT_NULL(block2);
+  OLA_ASSERT_EQ(4u, block1->Capacity());
+  OLA_ASSERT_EQ(2u, pool.BlocksAllocated());
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+
+  // Released blocks are emptied, and reused.
+  const uint8_t data[] = {1, 2, 3};
+  block1->Append(data, sizeof(data));
+  pool.Release(block1);
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+  MemoryBlock *block3 = pool.Allocate();
+  OLA_ASSERT_EQ(block1, block3);
+  OLA_ASSERT_TRUE(block3->Empty());
+  OLA_ASSERT_EQ(4u, block3->Remaining());
+  OLA_ASSERT_EQ(2u, pool.BlocksAllocated());
+
+  pool.Release(block2);
+  pool.Release(block3);
+  OLA_ASSERT_EQ(2u, pool.FreeBlocks());
+  pool.Purge(1);
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(1u, pool.BlocksAllocated());
+  pool.Purge();
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(0u, pool.BlocksAllocated());
+
+  // Blocks that don't match a size class are deleted.
+  pool.Release(new MemoryBlock(new uint8_t[10], 10));
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+}
+
+
+/*
+ * Check that blocks are allocated from the right size class.
+ */
+void MemoryBlockPoolTest::testSizeClasses() {
+  MemoryBlockPool::Options options;
+  options.block_size = 16;
+  options.size_classes = 3;
+  MemoryBlockPool pool(options);
+  OLA_ASSERT_EQ(16u, pool.BlockSize());
+  OLA_ASSERT_EQ(64u, pool.MaxBlockSize());
+
+  MemoryBlock *small = pool.Allocate();
+  OLA_ASSERT_EQ(16u, small->Capacity());
+  MemoryBlock *medium = pool.Allocate(17);
+  OLA_ASSERT_EQ(32u, medium->Capacity());
+  MemoryBlock *large = pool.Allocate(64);
+  OLA_ASSERT_EQ(64u, large->Capacity());
+  OLA_ASSERT_NULL(pool.Allocate(65));
+  OLA_ASSERT_EQ(3u, pool.BlocksAllocated());
+
+  pool.Release(small);
+  pool.Release(medium);
+  pool.Release(large);
+  OLA_ASSERT_EQ(3u, pool.FreeBlocks());
+
+  // Each size class has its own free list.
+  OLA_ASSERT_EQ(medium, pool.Allocate(20));
+  OLA_ASSERT_EQ(small, pool.Allocate(1));
+  OLA_ASSERT_EQ(large, pool.Allocate(33));
+  OLA_ASSERT_EQ(3u, pool.BlocksAllocated());
+
+  pool.Release(small);
+  pool.Release(medium);
+  pool.Release(large);
+}
+
+
+/*
+ * Check that a thread safe pool can be used from many threads at once.
+ */
+void MemoryBlockPoolTest::testThreadSafe() {
+  MemoryBlockPool::Options options;
+  options.block_size = 64;
+  options.thread_safe = true;
+  options.thread_cache_size = 8;
+  MemoryBlockPool pool(options);
+
+  vector<PoolThread*> threads;
+  for (unsigned int i = 0; i < 4; i++) {
+    threads.push_back(new PoolThread(&pool));
+  }
+  vector<PoolThread*>::iterator iter = threads.begin();
+  for (; iter != threads.end(); ++iter) {
+    OLA_ASSERT_TRUE((*iter)->Start());
+  }
+  for (iter = threads.begin(); iter != threads.end(); ++iter) {
+    OLA_ASSERT_TRUE((*iter)->Join());
+    OLA_ASSERT_FALSE((*iter)->Failed());
+  }
+  ola::STLDeleteElements(&threads);
+
+  // The caches of the exited threads have been returned to the depot.
+  OLA_ASSERT_TRUE(pool.BlocksAllocated() >= 40);
+  OLA_ASSERT_TRUE(pool.BlocksAllocated() <= 160);
+  OLA_ASSERT_EQ(pool.BlocksAllocated(), pool.FreeBlocks());
+
+  // A block allocated in this thread can be released by another.
+  MemoryBlock *block = pool.Allocate();
+  OLA_ASSERT_NOT_NULL(block);
+  pool.Purge();
+  OLA_ASSERT_EQ(1u, pool.BlocksAllocated());
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+  pool.Release(block);
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+}
+
+
+/*
+ * Check the hit & miss counts are exported.
+ */
+void MemoryBlockPoolTest::testExportMap() {
+  ExportMap export_map;
+  MemoryBlockPool::Options options;
+  options.block_size = 16;
+  options.size_classes = 2;
+  options.export_map = &export_map;
+  options.name = "test";
+  MemoryBlockPool pool(options);
+
+  UIntMap *hits = export_map.GetUIntMapVar(
+      MemoryBlockPool::K_POOL_HITS_VAR);
+  UIntMap *misses = export_map.GetUIntMapVar(
+      MemoryBlockPool::K_POOL_MISSES_VAR);
+  OLA_ASSERT_EQ(0u, (*hits)["test:16"]);
+  OLA_ASSERT_EQ(0u, (*misses)["test:32"]);
+
+  MemoryBlock *block = pool.Allocate();
+  OLA_ASSERT_EQ(1u, (*misses)["test:16"]);
+  pool.Release(block);
+  block = pool.Allocate();
+  OLA_ASSERT_EQ(1u, (*hits)["test:16"]);
+  OLA_ASSERT_EQ(1u, (*misses)["test:16"]);
+  pool.Release(block);
+
+  block = pool.Allocate(32);
+  OLA_ASSERT_EQ(1u, (*misses)["test:32"]);
+  OLA_ASSERT_EQ(0u, (*hits)["test:32"]);
+  pool.Release(block);
+}
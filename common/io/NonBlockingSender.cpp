@@ -17,15 +17,45 @@
  * Copyright (C) 2013 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <string.h>
+#ifndef _WIN32
+#include <limits.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif  // _WIN32
+#ifdef HAVE_LINUX_ERRQUEUE_H
+#include <linux/errqueue.h>
+#endif  // HAVE_LINUX_ERRQUEUE_H
+
+#include <algorithm>
+#include <vector>
+
 #include "ola/Callback.h"
+#include "ola/Logging.h"
 #include "ola/io/IOQueue.h"
 #include "ola/io/IOStack.h"
 #include "ola/io/NonBlockingSender.h"
 
+#if defined(HAVE_LINUX_ERRQUEUE_H) && HAVE_DECL_MSG_NOSIGNAL && \
+    defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && \
+    defined(SO_EE_ORIGIN_ZEROCOPY)
+#define USE_ZEROCOPY 1
+#endif  // HAVE_LINUX_ERRQUEUE_H ...
+
 namespace ola {
 namespace io {
 
+using std::vector;
+
 const unsigned int NonBlockingSender::DEFAULT_MAX_BUFFER_SIZE = 1024;
+const unsigned int NonBlockingSender::DEFAULT_ZEROCOPY_THRESHOLD = 16384;
+const unsigned int NonBlockingSender::ZEROCOPY_POLL_INTERVAL_MS = 1;
 
 NonBlockingSender::NonBlockingSender(ola::io::ConnectedDescriptor *descriptor,
                                      ola::io::SelectServerInterface *ss,
@@ -35,7 +65,12 @@ NonBlockingSender::NonBlockingSender(ola::io::ConnectedDescriptor *descriptor,
     m_ss(ss),
     m_output_buffer(memory_pool),
     m_associated(false),
-    m_max_buffer_size(max_buffer_size) {
+    m_max_buffer_size(max_buffer_size),
+    m_zerocopy(false),
+    m_zerocopy_threshold(DEFAULT_ZEROCOPY_THRESHOLD),
+    m_zerocopy_next(0),
+    m_zerocopy_completed(0),
+    m_zerocopy_timeout(ola::thread::INVALID_TIMEOUT) {
   m_descriptor->SetOnWritable(
       ola::NewCallback(this, &NonBlockingSender::PerformWrite));
 }
@@ -45,12 +80,35 @@ NonBlockingSender::~NonBlockingSender() {
     m_ss->RemoveWriteDescriptor(m_descriptor);
   }
   m_descriptor->SetOnWritable(NULL);
+
+  if (m_zerocopy_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_zerocopy_timeout);
+  }
+  ReapZeroCopyCompletions();
+  if (!m_zerocopy_pending.empty()) {
+    OLA_INFO << m_zerocopy_pending.size()
+             << " blocks still pending zero copy completion";
+  }
+  vector<MemoryBlock*> blocks;
+  std::deque<PendingBlock>::iterator iter = m_zerocopy_pending.begin();
+  for (; iter != m_zerocopy_pending.end(); ++iter) {
+    blocks.push_back(iter->block);
+  }
+  m_output_buffer.Release(blocks);
 }
 
 bool NonBlockingSender::LimitReached() const {
   return m_output_buffer.Size() >= m_max_buffer_size;
 }
 
+bool NonBlockingSender::Empty() const {
+  return m_output_buffer.Empty();
+}
+
+void NonBlockingSender::SetOnDrain(ola::Callback0<void> *callback) {
+  m_on_drain.reset(callback);
+}
+
 bool NonBlockingSender::SendMessage(ola::io::IOStack *stack) {
   if (LimitReached()) {
     return false;
@@ -71,14 +129,54 @@ bool NonBlockingSender::SendMessage(IOQueue *queue) {
   return true;
 }
 
+bool NonBlockingSender::EnableZeroCopy(unsigned int threshold) {
+#ifdef USE_ZEROCOPY
+  int enable = 1;
+  if (setsockopt(m_descriptor->WriteDescriptor(), SOL_SOCKET, SO_ZEROCOPY,
+                 &enable, sizeof(enable)) < 0) {
+    OLA_INFO << "Failed to enable SO_ZEROCOPY on "
+             << m_descriptor->WriteDescriptor() << ": " << strerror(errno);
+    return false;
+  }
+  m_zerocopy = true;
+  m_zerocopy_threshold = threshold;
+  return true;
+#else
+  (void) threshold;
+  return false;
+#endif  // USE_ZEROCOPY
+}
+
 /*
  * Called when the descriptor is writeable, this does the actual write() call.
  */
 void NonBlockingSender::PerformWrite() {
-  m_descriptor->Send(&m_output_buffer);
+  if (m_zerocopy || !m_zerocopy_pending.empty()) {
+    ReapZeroCopyCompletions();
+    ZeroCopyWrite();
+  } else {
+    m_descriptor->Send(&m_output_buffer);
+  }
+
+  bool drained = false;
   if (m_output_buffer.Empty() && m_associated) {
     m_ss->RemoveWriteDescriptor(m_descriptor);
     m_associated = false;
+    drained = true;
+  }
+
+  if (!m_zerocopy_pending.empty() &&
+      m_zerocopy_timeout == ola::thread::INVALID_TIMEOUT) {
+    // The completions arrive on the socket's error queue, which isn't
+    // checked by the SelectServer once we stop writing.
+    m_zerocopy_timeout = m_ss->RegisterRepeatingTimeout(
+        ZEROCOPY_POLL_INTERVAL_MS,
+        ola::NewCallback(this, &NonBlockingSender::ZeroCopyTimeout));
+  }
+
+  // This is last, since the callback may send more data.
+  if (drained && m_on_drain.get()) {
+    m_on_drain->Run();
   }
 }
 
@@ -92,5 +190,118 @@ void NonBlockingSender::AssociateIfRequired() {
   m_ss->AddWriteDescriptor(m_descriptor);
   m_associated = true;
 }
+
+/*
+ * Write the buffered data, using MSG_ZEROCOPY if there is enough of it. The
+ * emptied blocks are held until the kernel is done with them.
+ */
+void NonBlockingSender::ZeroCopyWrite() {
+#ifdef USE_ZEROCOPY
+  if (m_output_buffer.Empty()) {
+    return;
+  }
+
+  bool zerocopy = m_zerocopy &&
+                  m_output_buffer.Size() >= m_zerocopy_threshold;
+  int iocnt;
+  const struct IOVec *iov = m_output_buffer.AsIOVec(&iocnt);
+
+  struct msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = reinterpret_cast<iovec*>(const_cast<IOVec*>(iov));
+  message.msg_iovlen = std::min(iocnt, static_cast<int>(IOV_MAX));
+  int flags = MSG_NOSIGNAL | (zerocopy ? MSG_ZEROCOPY : 0);
+  ssize_t bytes_sent = sendmsg(m_descriptor->WriteDescriptor(), &message,
+                               flags);
+  m_output_buffer.FreeIOVec(iov);
+
+  if (bytes_sent < 0) {
+    OLA_INFO << "Failed to send on " << m_descriptor->WriteDescriptor()
+             << ": " << strerror(errno);
+    return;
+  }
+
+  vector<MemoryBlock*> blocks;
+  m_output_buffer.Pop(bytes_sent, &blocks);
+  if (!zerocopy && m_zerocopy_pending.empty()) {
+    m_output_buffer.Release(blocks);
+    return;
+  }
+
+  // A copied send can still empty a block that was partly sent by an earlier
+  // zero copy send, so it has to wait for that send to complete.
+  uint32_t sequence = zerocopy ? m_zerocopy_next++ : m_zerocopy_next - 1;
+  vector<MemoryBlock*>::const_iterator iter = blocks.begin();
+  for (; iter != blocks.end(); ++iter) {
+    m_zerocopy_pending.push_back(PendingBlock(sequence, *iter));
+  }
+#endif  // USE_ZEROCOPY
+}
+
+/*
+ * Read the zero copy completions from the socket's error queue, and release
+ * the blocks that are no longer in use by the kernel.
+ */
+void NonBlockingSender::ReapZeroCopyCompletions() {
+#ifdef USE_ZEROCOPY
+  if (m_zerocopy_pending.empty()) {
+    return;
+  }
+
+  while (true) {
+    uint8_t control[128];
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (recvmsg(m_descriptor->WriteDescriptor(), &message,
+                MSG_ERRQUEUE) < 0) {
+      break;
+    }
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+    for (; cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+            (cmsg->cmsg_level == SOL_IPV6 &&
+             cmsg->cmsg_type == IPV6_RECVERR))) {
+        continue;
+      }
+      const struct sock_extended_err *error =
+          reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cmsg));
+      if (error->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      // ee_info to ee_data is the range of sends that completed.
+      uint32_t completed = error->ee_data + 1;
+      if (static_cast<int32_t>(completed - m_zerocopy_completed) > 0) {
+        m_zerocopy_completed = completed;
+      }
+      if (m_zerocopy && (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)) {
+        OLA_DEBUG << "Kernel copied the data for a zero copy send on "
+                  << m_descriptor->WriteDescriptor() << ", disabling";
+        m_zerocopy = false;
+      }
+    }
+  }
+
+  vector<MemoryBlock*> blocks;
+  while (!m_zerocopy_pending.empty() &&
+         static_cast<int32_t>(m_zerocopy_pending.front().sequence -
+                              m_zerocopy_completed) < 0) {
+    blocks.push_back(m_zerocopy_pending.front().block);
+    m_zerocopy_pending.pop_front();
+  }
+  m_output_buffer.Release(blocks);
+#endif  // USE_ZEROCOPY
+}
+
+bool NonBlockingSender::ZeroCopyTimeout() {
+  ReapZeroCopyCompletions();
+  if (m_zerocopy_pending.empty()) {
+    m_zerocopy_timeout = ola::thread::INVALID_TIMEOUT;
+    return false;
+  }
+  return true;
+}
 }  // namespace io
 }  // namespace ola
@@ -26,11 +26,14 @@
 #include "ola/Logging.h"
 #include "ola/io/BigEndianStream.h"
 #include "ola/io/IOQueue.h"
+#include "ola/io/MemoryBuffer.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/testing/TestUtils.h"
 
 using ola::io::IOQueue;
+using ola::io::BigEndianBufferOutputStream;
 using ola::io::BigEndianOutputStream;
+using ola::io::MemoryOutputBuffer;
 using ola::network::HostToNetwork;
 using std::auto_ptr;
 using std::string;
@@ -41,11 +44,15 @@ class OutputStreamTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OutputStreamTest);
   CPPUNIT_TEST(testBasicWrite);
   CPPUNIT_TEST(testWritePrimatives);
+  CPPUNIT_TEST(testBufferStream);
+  CPPUNIT_TEST(testMemoryOutputBuffer);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testBasicWrite();
   void testWritePrimatives();
+  void testBufferStream();
+  void testMemoryOutputBuffer();
 
  private:
   IOQueue m_buffer;
@@ -101,3 +108,54 @@ void OutputStreamTest::testWritePrimatives() {
   OLA_ASSERT_DATA_EQUALS(data1, sizeof(data1), output_data, output_size);
   delete[] output_data;
 }
+
+
+/*
+ * Check the stream over a concrete buffer matches BigEndianOutputStream.
+ */
+void OutputStreamTest::testBufferStream() {
+  BigEndianBufferOutputStream<IOQueue> stream(&m_buffer);
+  stream << 4;
+  stream << (1u << 31);
+  stream << static_cast<uint8_t>(10) << static_cast<uint16_t>(2400);
+  const uint8_t extra[] = {1, 2};
+  stream.Write(extra, sizeof(extra));
+  OLA_ASSERT_EQ(13u, m_buffer.Size());
+
+  uint8_t output_data[20];
+  const uint8_t expected[] = {0, 0, 0, 4, 0x80, 0, 0, 0, 0xa, 0x9, 0x60,
+                              1, 2};
+  unsigned int output_size = m_buffer.Peek(output_data, sizeof(output_data));
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output_data,
+                         output_size);
+}
+
+
+/*
+ * Check writing to a block of memory.
+ */
+void OutputStreamTest::testMemoryOutputBuffer() {
+  uint8_t memory[7];
+  MemoryOutputBuffer buffer(memory, sizeof(memory));
+  OLA_ASSERT_TRUE(buffer.Empty());
+
+  BigEndianBufferOutputStream<MemoryOutputBuffer> stream(&buffer);
+  stream << static_cast<uint16_t>(0x1234) << static_cast<int8_t>(-1);
+  OLA_ASSERT_EQ(3u, buffer.Size());
+  OLA_ASSERT_FALSE(buffer.Overflowed());
+
+  // Only 4 bytes remain.
+  stream << static_cast<uint32_t>(0x01020304) << static_cast<uint8_t>(5);
+  OLA_ASSERT_EQ(7u, buffer.Size());
+  OLA_ASSERT_TRUE(buffer.Overflowed());
+
+  const uint8_t expected[] = {0x12, 0x34, 0xff, 1, 2, 3, 4};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), memory, buffer.Size());
+
+  buffer.Reset();
+  OLA_ASSERT_TRUE(buffer.Empty());
+  OLA_ASSERT_FALSE(buffer.Overflowed());
+  stream << static_cast<uint8_t>(9);
+  OLA_ASSERT_EQ(1u, buffer.Size());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(9), memory[0]);
+}
@@ -41,6 +41,23 @@ const char PollerInterface::K_WRITE_DESCRIPTOR_VAR[] = "ss-write-descriptor";
 const char PollerInterface::K_CONNECTED_DESCRIPTORS_VAR[] =
     "ss-connected-descriptors";
 
+/**
+ * @brief The number of times the loop woke up for a timeout.
+ */
+const char PollerInterface::K_TIMER_WAKEUPS_VAR[] = "ss-timer-wakeups";
+
+/**
+ * @brief The total time in microseconds between when timeouts were due, and
+ * when the loop woke up for them.
+ */
+const char PollerInterface::K_WAKE_LATENCY_VAR[] = "ss-wake-latency-us";
+
+/**
+ * @brief The largest wake up latency seen, in microseconds.
+ */
+const char PollerInterface::K_MAX_WAKE_LATENCY_VAR[] =
+    "ss-max-wake-latency-us";
+
 /**
  * @brief The time spent in the event loop.
  */
@@ -143,6 +143,9 @@ class PollerInterface {
   static const char K_READ_DESCRIPTOR_VAR[];
   static const char K_WRITE_DESCRIPTOR_VAR[];
   static const char K_CONNECTED_DESCRIPTORS_VAR[];
+  static const char K_TIMER_WAKEUPS_VAR[];
+  static const char K_WAKE_LATENCY_VAR[];
+  static const char K_MAX_WAKE_LATENCY_VAR[];
 
  protected:
   static const char K_LOOP_TIME[];
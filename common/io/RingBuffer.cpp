@@ -0,0 +1,250 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RingBuffer.cpp
+ * A contiguous byte queue.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_MEMFD_CREATE
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // HAVE_MEMFD_CREATE
+
+#include <algorithm>
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/io/RingBuffer.h"
+
+namespace ola {
+namespace io {
+
+using std::min;
+using std::string;
+
+RingBuffer::RingBuffer(unsigned int capacity)
+    : m_base(NULL),
+      m_capacity(0),
+      m_read(0),
+      m_size(0),
+      m_mapped(false) {
+  Grow(std::max(capacity, 1u));
+}
+
+RingBuffer::~RingBuffer() {
+  Free();
+}
+
+void RingBuffer::Write(const uint8_t *data, unsigned int length) {
+  uint8_t *space = Reserve(length);
+  if (!space) {
+    OLA_WARN << "Failed to grow RingBuffer to " << m_size + length
+             << " bytes";
+    return;
+  }
+  memcpy(space, data, length);
+  m_size += length;
+}
+
+unsigned int RingBuffer::Read(uint8_t *data, unsigned int length) {
+  const unsigned int bytes_read = Peek(data, length);
+  Pop(bytes_read);
+  return bytes_read;
+}
+
+unsigned int RingBuffer::Read(string *output, unsigned int length) {
+  const unsigned int bytes_read = min(length, m_size);
+  output->append(reinterpret_cast<const char*>(Data()), bytes_read);
+  Pop(bytes_read);
+  return bytes_read;
+}
+
+unsigned int RingBuffer::Peek(uint8_t *data, unsigned int length) const {
+  const unsigned int bytes_read = min(length, m_size);
+  memcpy(data, Data(), bytes_read);
+  return bytes_read;
+}
+
+uint8_t *RingBuffer::Reserve(unsigned int length) {
+  if (WritableSize() < length) {
+    if (!m_mapped && m_capacity - m_size >= length) {
+      // There is enough space, it's just split between the front and the
+      // end of the buffer.
+      memmove(m_base, Data(), m_size);
+      m_read = 0;
+    } else if (!Grow(m_size + length)) {
+      return NULL;
+    }
+  }
+  return m_base + WriteOffset();
+}
+
+unsigned int RingBuffer::WritableSize() const {
+  if (m_mapped) {
+    return m_capacity - m_size;
+  }
+  return m_capacity - m_read - m_size;
+}
+
+void RingBuffer::Commit(unsigned int length) {
+  m_size += min(length, WritableSize());
+}
+
+const struct IOVec *RingBuffer::AsIOVec(int *io_count) const {
+  if (Empty()) {
+    *io_count = 0;
+    return NULL;
+  }
+
+  struct IOVec *vector = new struct IOVec[1];
+  vector->iov_base = const_cast<uint8_t*>(Data());
+  vector->iov_len = m_size;
+  *io_count = 1;
+  return vector;
+}
+
+void RingBuffer::Pop(unsigned int n) {
+  n = min(n, m_size);
+  m_size -= n;
+  m_read += n;
+  if (m_read >= m_capacity) {
+    m_read -= m_capacity;
+  }
+  if (!m_size) {
+    m_read = 0;
+  }
+}
+
+void RingBuffer::Clear() {
+  m_read = 0;
+  m_size = 0;
+}
+
+unsigned int RingBuffer::WriteOffset() const {
+  const unsigned int offset = m_read + m_size;
+  if (m_mapped && offset >= m_capacity) {
+    return offset - m_capacity;
+  }
+  return offset;
+}
+
+/*
+ * Move the data to a larger buffer.
+ * @param required the minimum capacity.
+ * @returns false if the memory couldn't be allocated, in which case the
+ *   buffer is unchanged.
+ */
+bool RingBuffer::Grow(unsigned int required) {
+  unsigned int capacity = std::max(required, m_capacity * 2);
+  bool mapped = false;
+  uint8_t *base = NULL;
+
+#ifdef HAVE_MEMFD_CREATE
+  const unsigned int page_size = sysconf(_SC_PAGESIZE);
+  const unsigned int ring_capacity =
+      (capacity + page_size - 1) / page_size * page_size;
+  base = MapRing(ring_capacity);
+  if (base) {
+    capacity = ring_capacity;
+    mapped = true;
+  }
+#endif  // HAVE_MEMFD_CREATE
+
+  if (!base) {
+    base = static_cast<uint8_t*>(malloc(capacity));
+    if (!base) {
+      return false;
+    }
+  }
+
+  if (m_size) {
+    memcpy(base, Data(), m_size);
+  }
+  Free();
+  m_base = base;
+  m_capacity = capacity;
+  m_read = 0;
+  m_mapped = mapped;
+  return true;
+}
+
+void RingBuffer::Free() {
+  if (m_mapped) {
+    UnmapRing(m_base, m_capacity);
+  } else {
+    free(m_base);
+  }
+  m_base = NULL;
+}
+
+/*
+ * Map the same memory twice, one copy straight after the other.
+ * @param capacity the size of the ring, a multiple of the page size.
+ * @returns the start of the first mapping, or NULL if the ring couldn't be
+ *   mapped.
+ */
+uint8_t *RingBuffer::MapRing(OLA_UNUSED unsigned int capacity) {
+#ifdef HAVE_MEMFD_CREATE
+  int fd = memfd_create("ola-ring-buffer", MFD_CLOEXEC);
+  if (fd < 0) {
+    return NULL;
+  }
+  if (ftruncate(fd, capacity)) {
+    close(fd);
+    return NULL;
+  }
+
+  // Reserve the address range, then map the ring into each half of it.
+  void *region = mmap(NULL, 2 * capacity, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (region == MAP_FAILED) {
+    close(fd);
+    return NULL;
+  }
+
+  uint8_t *base = static_cast<uint8_t*>(region);
+  if (mmap(base, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+           fd, 0) == MAP_FAILED ||
+      mmap(base + capacity, capacity, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+    munmap(region, 2 * capacity);
+    close(fd);
+    return NULL;
+  }
+  // The mappings hold a reference to the memory.
+  close(fd);
+  return base;
+#else
+  return NULL;
+#endif  // HAVE_MEMFD_CREATE
+}
+
+void RingBuffer::UnmapRing(OLA_UNUSED uint8_t *base,
+                           OLA_UNUSED unsigned int capacity) {
+#ifdef HAVE_MEMFD_CREATE
+  munmap(base, 2 * capacity);
+#endif  // HAVE_MEMFD_CREATE
+}
+}  // namespace io
+}  // namespace ola
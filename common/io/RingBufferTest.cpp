@@ -0,0 +1,212 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RingBufferTest.cpp
+ * Test fixture for the RingBuffer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+
+#include "ola/io/IOVecInterface.h"
+#include "ola/io/RingBuffer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::io::IOVec;
+using ola::io::RingBuffer;
+using std::string;
+
+
+class RingBufferTest: public CppUnit::TestFixture {
+ public:
+  CPPUNIT_TEST_SUITE(RingBufferTest);
+  CPPUNIT_TEST(testWriteAndRead);
+  CPPUNIT_TEST(testWrap);
+  CPPUNIT_TEST(testGrow);
+  CPPUNIT_TEST(testReserve);
+  CPPUNIT_TEST(testIOVec);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testWriteAndRead();
+  void testWrap();
+  void testGrow();
+  void testReserve();
+  void testIOVec();
+
+ private:
+  static string AsString(const RingBuffer &buffer) {
+    return string(reinterpret_cast<const char*>(buffer.Data()),
+                  buffer.Size());
+  }
+
+  static void Write(RingBuffer *buffer, const string &data) {
+    buffer->Write(reinterpret_cast<const uint8_t*>(data.data()),
+                  data.size());
+  }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RingBufferTest);
+
+
+/*
+ * Check the basic operations.
+ */
+void RingBufferTest::testWriteAndRead() {
+  RingBuffer buffer;
+  OLA_ASSERT_TRUE(buffer.Empty());
+  OLA_ASSERT_EQ(0u, buffer.Size());
+  OLA_ASSERT_TRUE(buffer.Capacity() >= RingBuffer::DEFAULT_CAPACITY);
+
+  Write(&buffer, "hello world");
+  OLA_ASSERT_FALSE(buffer.Empty());
+  OLA_ASSERT_EQ(11u, buffer.Size());
+  OLA_ASSERT_EQ(string("hello world"), AsString(buffer));
+
+  uint8_t data[5];
+  OLA_ASSERT_EQ(5u, buffer.Peek(data, sizeof(data)));
+  OLA_ASSERT_DATA_EQUALS(reinterpret_cast<const uint8_t*>("hello"), 5,
+                         data, sizeof(data));
+  OLA_ASSERT_EQ(11u, buffer.Size());
+
+  OLA_ASSERT_EQ(5u, buffer.Read(data, sizeof(data)));
+  OLA_ASSERT_EQ(string(" world"), AsString(buffer));
+
+  string output("foo");
+  OLA_ASSERT_EQ(6u, buffer.Read(&output, 100));
+  OLA_ASSERT_EQ(string("foo world"), output);
+  OLA_ASSERT_TRUE(buffer.Empty());
+  OLA_ASSERT_EQ(0u, buffer.Read(data, sizeof(data)));
+
+  Write(&buffer, "abc");
+  buffer.Pop(1);
+  OLA_ASSERT_EQ(string("bc"), AsString(buffer));
+  buffer.Pop(10);
+  OLA_ASSERT_TRUE(buffer.Empty());
+
+  Write(&buffer, "abc");
+  buffer.Clear();
+  OLA_ASSERT_TRUE(buffer.Empty());
+}
+
+
+/*
+ * Check the data stays contiguous as it moves around the buffer.
+ */
+void RingBufferTest::testWrap() {
+  RingBuffer buffer(16);
+  const unsigned int capacity = buffer.Capacity();
+
+  // Walk a 7 byte message around the buffer several times, so that it
+  // straddles the end of the ring at some point.
+  const string message("0123456");
+  string expected;
+  for (unsigned int i = 0; i < 3 * capacity / message.size() + 3; i++) {
+    Write(&buffer, message);
+    expected.append(message);
+    if (buffer.Size() >= 2 * message.size()) {
+      buffer.Pop(message.size());
+      expected.erase(0, message.size());
+    }
+    OLA_ASSERT_EQ(expected, AsString(buffer));
+  }
+  // The buffer never needed to grow.
+  OLA_ASSERT_EQ(capacity, buffer.Capacity());
+}
+
+
+/*
+ * Check the buffer grows, keeping the data.
+ */
+void RingBufferTest::testGrow() {
+  RingBuffer buffer(16);
+  const unsigned int capacity = buffer.Capacity();
+
+  Write(&buffer, "abc");
+  buffer.Pop(1);
+  string expected("bc");
+  while (expected.size() <= capacity) {
+    Write(&buffer, "0123456789");
+    expected.append("0123456789");
+  }
+  OLA_ASSERT_TRUE(buffer.Capacity() > capacity);
+  OLA_ASSERT_EQ(expected, AsString(buffer));
+}
+
+
+/*
+ * Check data can be written directly into the buffer.
+ */
+void RingBufferTest::testReserve() {
+  RingBuffer buffer(16);
+  Write(&buffer, "abc");
+
+  uint8_t *space = buffer.Reserve(4);
+  OLA_ASSERT_NOT_NULL(space);
+  OLA_ASSERT_TRUE(buffer.WritableSize() >= 4);
+  memcpy(space, "defg", 4);
+  buffer.Commit(4);
+  OLA_ASSERT_EQ(string("abcdefg"), AsString(buffer));
+
+  // Ask for more than is free.
+  const unsigned int capacity = buffer.Capacity();
+  buffer.Pop(2);
+  space = buffer.Reserve(capacity);
+  OLA_ASSERT_NOT_NULL(space);
+  OLA_ASSERT_TRUE(buffer.WritableSize() >= capacity);
+  OLA_ASSERT_EQ(string("cdefg"), AsString(buffer));
+  memset(space, 'x', capacity);
+  buffer.Commit(capacity);
+  OLA_ASSERT_EQ(string("cdefg") + string(capacity, 'x'), AsString(buffer));
+
+  // Commit is limited to the space available.
+  buffer.Reserve(0);
+  const unsigned int size = buffer.Size();
+  const unsigned int writable = buffer.WritableSize();
+  buffer.Commit(writable + 10);
+  OLA_ASSERT_EQ(size + writable, buffer.Size());
+}
+
+
+/*
+ * Check AsIOVec returns a single IOVec.
+ */
+void RingBufferTest::testIOVec() {
+  RingBuffer buffer(16);
+  int io_count;
+  const struct IOVec *iov = buffer.AsIOVec(&io_count);
+  OLA_ASSERT_EQ(0, io_count);
+  OLA_ASSERT_NULL(iov);
+
+  // Put the data across the end of the ring.
+  const unsigned int capacity = buffer.Capacity();
+  Write(&buffer, string(capacity - 2, 'a'));
+  buffer.Pop(capacity - 2);
+  Write(&buffer, "0123456789");
+
+  iov = buffer.AsIOVec(&io_count);
+  OLA_ASSERT_EQ(1, io_count);
+  OLA_ASSERT_EQ(static_cast<size_t>(10), iov->iov_len);
+  OLA_ASSERT_EQ(string("0123456789"),
+                string(reinterpret_cast<const char*>(iov->iov_base),
+                       iov->iov_len));
+  RingBuffer::FreeIOVec(iov);
+
+  buffer.Pop(4);
+  OLA_ASSERT_EQ(string("456789"), AsString(buffer));
+}
@@ -39,6 +39,7 @@
 #include "ola/base/Macro.h"
 #include "ola/io/Descriptor.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/util/Trace.h"
 
 namespace ola {
 namespace io {
@@ -362,13 +363,27 @@ bool SelectPoller::AddDescriptorsToSet(fd_set *r_set,
  *  - Excute OnClose if a remote end closed the connection
  */
 void SelectPoller::CheckDescriptors(fd_set *r_set, fd_set *w_set) {
+  OLA_TRACE_SCOPE("io", "SelectPoller::CheckDescriptors");
   // Remember the add / remove methods above may be called during
   // PerformRead(), PerformWrite() or the on close handler. Our iterators are
   // safe because we only ever call erase from within AddDescriptorsToSet(),
   // which isn't called from any of the Add / Remove methods.
+  //
+  // The high priority descriptors are serviced first.
   ReadDescriptorMap::iterator iter = m_read_descriptors.begin();
   for (; iter != m_read_descriptors.end(); ++iter) {
-    if (iter->second && FD_ISSET(iter->second->ReadDescriptor(), r_set)) {
+    if (iter->second &&
+        iter->second->Priority() == DESCRIPTOR_PRIORITY_HIGH &&
+        FD_ISSET(iter->second->ReadDescriptor(), r_set)) {
+      iter->second->PerformRead();
+    }
+  }
+
+  for (iter = m_read_descriptors.begin(); iter != m_read_descriptors.end();
+       ++iter) {
+    if (iter->second &&
+        iter->second->Priority() != DESCRIPTOR_PRIORITY_HIGH &&
+        FD_ISSET(iter->second->ReadDescriptor(), r_set)) {
       iter->second->PerformRead();
     }
   }
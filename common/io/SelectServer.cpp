@@ -32,8 +32,12 @@
 
 #include <string.h>
 #include <errno.h>
+#if HAVE_DECL_SCHED_SETAFFINITY
+#include <sched.h>
+#endif  // HAVE_DECL_SCHED_SETAFFINITY
 
 #include <algorithm>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -41,12 +45,11 @@
 #ifdef _WIN32
 #include "common/io/WindowsPoller.h"
 #else
-#include "ola/base/Flags.h"
-
-
 #include "common/io/SelectPoller.h"
 #endif  // _WIN32
 
+#include "common/io/LoopProfiler.h"
+#include "ola/base/Flags.h"
 #include "ola/io/Descriptor.h"
 #include "ola/Logging.h"
 #include "ola/network/Socket.h"
@@ -58,12 +61,25 @@ DEFINE_default_bool(use_epoll, true,
                     "Disable the use of epoll(), revert to select()");
 #endif  // HAVE_EPOLL
 
+#ifdef HAVE_IO_URING
+#include "common/io/IOUringPoller.h"
+DEFINE_default_bool(use_io_uring, false,
+                    "Use io_uring rather than epoll() or select()");
+#endif  // HAVE_IO_URING
+
 #ifdef HAVE_KQUEUE
 #include "common/io/KQueuePoller.h"
 DEFINE_default_bool(use_kqueue, false,
                     "Use kqueue() rather than select()");
 #endif  // HAVE_KQUEUE
 
+DEFINE_default_bool(use_timer_wheel, false,
+                    "Use a timer wheel rather than a priority queue for "
+                    "timeouts");
+
+DEFINE_default_bool(profile_loop, false,
+                    "Record the execution time of each event loop callback");
+
 namespace ola {
 namespace io {
 
@@ -80,8 +96,13 @@ SelectServer::SelectServer(ExportMap *export_map,
       m_terminate(false),
       m_is_running(false),
       m_poll_interval(POLL_INTERVAL_SECOND, POLL_INTERVAL_USECOND),
+      m_cpu_affinity(-1),
       m_clock(clock),
-      m_free_clock(false) {
+      m_free_clock(false),
+      m_execute_callbacks(NULL),
+      m_execute_wakeups(NULL),
+      m_execute_queue_depth(NULL),
+      m_bulk_queue_depth(NULL) {
   Options options;
   Init(options);
 }
@@ -91,14 +112,22 @@ SelectServer::SelectServer(const Options &options)
       m_terminate(false),
       m_is_running(false),
       m_poll_interval(POLL_INTERVAL_SECOND, POLL_INTERVAL_USECOND),
+      m_cpu_affinity(options.cpu_affinity),
       m_clock(options.clock),
-      m_free_clock(false) {
+      m_free_clock(false),
+      m_execute_callbacks(NULL),
+      m_execute_wakeups(NULL),
+      m_execute_queue_depth(NULL),
+      m_bulk_queue_depth(NULL) {
   Init(options);
 }
 
 SelectServer::~SelectServer() {
   DrainCallbacks();
 
+  // The bulk callbacks may refer to objects that have already been deleted,
+  // so they're not run.
+  STLDeleteElements(&m_bulk_callbacks);
   STLDeleteElements(&m_loop_callbacks);
   if (m_free_clock) {
     delete m_clock;
@@ -131,6 +160,7 @@ void SelectServer::Run() {
 
   m_is_running = true;
   m_terminate = false;
+  SetAffinity();
   while (!m_terminate) {
     // false indicates an error in CheckForEvents();
     if (!CheckForEvents(m_poll_interval)) {
@@ -251,32 +281,30 @@ void SelectServer::RunInLoop(Callback0<void> *callback) {
 }
 
 void SelectServer::Execute(ola::BaseCallback0<void> *callback) {
-  {
-    ola::thread::MutexLocker locker(&m_incoming_mutex);
-    m_incoming_callbacks.push_back(callback);
-  }
-
   // kick select(), we do this even if we're in the same thread as select() is
   // called. If we don't do this there is a race condition because a callback
   // may be added just prior to select(). Without this kick, select() will
   // sleep for the poll_interval before executing the callback.
-  uint8_t wake_up = 'a';
-  m_incoming_descriptor.Send(&wake_up, sizeof(wake_up));
+  //
+  // If the queue already had callbacks in it, the loop has been woken up and
+  // hasn't collected them yet, so it'll pick this one up as well.
+  if (m_incoming_callbacks.Push(callback)) {
+    uint8_t wake_up = 'a';
+    m_incoming_descriptor.Send(&wake_up, sizeof(wake_up));
+  }
 }
 
 
+void SelectServer::ExecuteBulk(ola::BaseCallback0<void> *callback) {
+  m_bulk_callbacks.push_back(callback);
+}
+
 void SelectServer::DrainCallbacks() {
   Callbacks callbacks_to_run;
-  while (true) {
-    {
-      ola::thread::MutexLocker locker(&m_incoming_mutex);
-      if (m_incoming_callbacks.empty()) {
-        return;
-      }
-      callbacks_to_run.swap(m_incoming_callbacks);
-    }
+  while (m_incoming_callbacks.PopAll(&callbacks_to_run)) {
     RunCallbacks(&callbacks_to_run);
   }
+
 }
 
 void SelectServer::Init(const Options &options) {
@@ -289,20 +317,68 @@ void SelectServer::Init(const Options &options) {
     m_export_map->GetIntegerVar(PollerInterface::K_READ_DESCRIPTOR_VAR);
     m_export_map->GetIntegerVar(PollerInterface::K_WRITE_DESCRIPTOR_VAR);
     m_export_map->GetIntegerVar(PollerInterface::K_CONNECTED_DESCRIPTORS_VAR);
+    m_execute_callbacks = m_export_map->GetCounterVar("ss-execute-callbacks");
+    m_execute_wakeups = m_export_map->GetCounterVar("ss-execute-wakeups");
+    m_execute_queue_depth = m_export_map->GetIntegerVar(
+        "ss-execute-queue-depth");
+    m_bulk_queue_depth = m_export_map->GetIntegerVar("ss-bulk-queue-depth");
+  }
+  m_bulk_budget = TimeInterval(static_cast<int64_t>(options.bulk_budget_usec));
+
+  m_timeout_manager.reset(new TimeoutManager(
+      m_export_map, m_clock, FLAGS_use_timer_wheel || options.timer_wheel));
+
+  const bool profile_loop = FLAGS_profile_loop || options.profile_loop;
+  if (profile_loop && m_export_map) {
+    m_profiler.reset(new LoopProfiler(
+        m_export_map, m_clock,
+        TimeInterval(static_cast<int64_t>(options.slow_callback_usec))));
+    m_timeout_manager->SetProfiler(m_profiler.get());
+  } else if (profile_loop) {
+    OLA_WARN << "Profiling the event loop requires an export map";
   }
-
-  m_timeout_manager.reset(new TimeoutManager(m_export_map, m_clock));
 #ifdef _WIN32
   m_poller.reset(new WindowsPoller(m_export_map, m_clock));
   (void) options;
 #else
 
+#ifdef HAVE_IO_URING
+  bool using_io_uring = false;
+  if (FLAGS_use_io_uring && !options.force_select) {
+    std::auto_ptr<IOUringPoller> poller(
+        new IOUringPoller(m_export_map, m_clock));
+    if (poller->Valid()) {
+      m_poller.reset(poller.release());
+      using_io_uring = true;
+    } else {
+      OLA_WARN << "Failed to set up io_uring, falling back";
+    }
+  }
+  if (m_export_map) {
+    m_export_map->GetBoolVar("using-io-uring")->Set(using_io_uring);
+  }
+#endif  // HAVE_IO_URING
+
 #ifdef HAVE_EPOLL
-  if (FLAGS_use_epoll && !options.force_select) {
-    m_poller.reset(new EPoller(m_export_map, m_clock));
+  bool using_epoll = false;
+  if (FLAGS_use_epoll && !m_poller.get() && !options.force_select) {
+    EPoller *poller = new EPoller(m_export_map, m_clock);
+    if (options.busy_poll_usec) {
+      const TimeInterval busy_poll(
+          static_cast<int64_t>(options.busy_poll_usec));
+      poller->SetBusyPoll(busy_poll);
+    }
+    if (options.high_resolution_timers) {
+      poller->EnableHighResolutionTimers();
+    }
+    poller->SetProfiler(m_profiler.get());
+    m_poller.reset(poller);
+    using_epoll = true;
+  } else if (options.busy_poll_usec || options.high_resolution_timers) {
+    OLA_WARN << "Busy polling and high resolution timers require epoll";
   }
   if (m_export_map) {
-    m_export_map->GetBoolVar("using-epoll")->Set(FLAGS_use_epoll);
+    m_export_map->GetBoolVar("using-epoll")->Set(using_epoll);
   }
 #endif  // HAVE_EPOLL
 
@@ -351,10 +427,40 @@ bool SelectServer::CheckForEvents(const TimeInterval &poll_interval) {
     default_poll_interval = std::min(
         default_poll_interval, TimeInterval(0, 1000));
   }
-  return m_poller->Poll(m_timeout_manager.get(), default_poll_interval);
+  // Don't block if there's bulk work left over from the last pass.
+  if (!m_bulk_callbacks.empty()) {
+    default_poll_interval = TimeInterval(0, 0);
+  }
+  bool ok = m_poller->Poll(m_timeout_manager.get(), default_poll_interval);
+  RunBulkCallbacks();
+  return ok;
+}
+
+/*
+ * Pin the calling thread to a CPU, if requested.
+ */
+void SelectServer::SetAffinity() {
+  if (m_cpu_affinity < 0) {
+    return;
+  }
+#if HAVE_DECL_SCHED_SETAFFINITY
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(m_cpu_affinity, &cpu_set);
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set)) {
+    OLA_WARN << "Failed to pin the SelectServer to CPU " << m_cpu_affinity
+             << ": " << strerror(errno);
+  }
+#else
+  OLA_WARN << "CPU affinity isn't supported on this platform";
+#endif  // HAVE_DECL_SCHED_SETAFFINITY
+  // Only do this on the first call to Run().
+  m_cpu_affinity = -1;
 }
 
 void SelectServer::DrainAndExecute() {
+  // This must be done before we collect the callbacks. Otherwise a callback
+  // queued in between would have its wake up discarded.
   while (m_incoming_descriptor.DataRemaining()) {
     // try to get everything in one read
     uint8_t message[100];
@@ -363,18 +469,40 @@ void SelectServer::DrainAndExecute() {
                                   sizeof(message), size);
   }
 
-  // We can't hold the mutex while we execute the callback, so instead we swap
-  // out the vector under a lock, release the lock and then run all the
-  // callbacks.
   Callbacks callbacks_to_run;
-  {
-    thread::MutexLocker lock(&m_incoming_mutex);
-    callbacks_to_run.swap(m_incoming_callbacks);
+  unsigned int queue_depth = m_incoming_callbacks.PopAll(&callbacks_to_run);
+  if (m_execute_wakeups) {
+    (*m_execute_wakeups)++;
+    (*m_execute_callbacks) += queue_depth;
+    m_execute_queue_depth->Set(queue_depth);
   }
 
   RunCallbacks(&callbacks_to_run);
 }
 
+/*
+ * Run the bulk callbacks until the budget is used up. At least one callback
+ * is run, so the queue always makes progress.
+ */
+void SelectServer::RunBulkCallbacks() {
+  if (m_bulk_callbacks.empty()) {
+    return;
+  }
+
+  TimeStamp start, now;
+  m_clock->CurrentTime(&start);
+  do {
+    ola::BaseCallback0<void> *callback = m_bulk_callbacks.front();
+    m_bulk_callbacks.pop_front();
+    callback->Run();
+    m_clock->CurrentTime(&now);
+  } while (!m_bulk_callbacks.empty() && now - start < m_bulk_budget);
+
+  if (m_bulk_queue_depth) {
+    m_bulk_queue_depth->Set(m_bulk_callbacks.size());
+  }
+}
+
 void SelectServer::RunCallbacks(Callbacks *callbacks) {
   Callbacks::iterator iter = callbacks->begin();
   for (; iter != callbacks->end(); ++iter) {
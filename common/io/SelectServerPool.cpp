@@ -0,0 +1,95 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SelectServerPool.cpp
+ * A number of SelectServers, each running in its own thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/io/SelectServerPool.h"
+
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+#include "ola/thread/CallbackThread.h"
+
+namespace ola {
+namespace io {
+
+using ola::thread::CallbackThread;
+using ola::thread::Thread;
+
+SelectServerPool::SelectServerPool(unsigned int size,
+                                   const SelectServer::Options &options) {
+  SelectServer::Options loop_options = options;
+  loop_options.export_map = NULL;
+  for (unsigned int i = 0; i < size; i++) {
+    if (options.cpu_affinity >= 0) {
+      loop_options.cpu_affinity = options.cpu_affinity + i;
+    }
+    m_servers.push_back(new SelectServer(loop_options));
+  }
+}
+
+SelectServerPool::~SelectServerPool() {
+  Stop();
+  STLDeleteElements(&m_servers);
+}
+
+bool SelectServerPool::Start() {
+  if (!m_threads.empty()) {
+    OLA_WARN << "SelectServerPool already started";
+    return false;
+  }
+
+  for (unsigned int i = 0; i < m_servers.size(); i++) {
+    Thread::Options thread_options(
+        "ss-pool-" + ola::strings::IntToString(i));
+    CallbackThread *thread = new CallbackThread(
+        NewSingleCallback(m_servers[i], &SelectServer::Run),
+        thread_options);
+    m_threads.push_back(thread);
+    if (!thread->Start()) {
+      OLA_WARN << "Failed to start thread for SelectServer " << i;
+      Stop();
+      return false;
+    }
+  }
+  return true;
+}
+
+void SelectServerPool::Stop() {
+  // Terminate() is a no-op if Run() hasn't been entered yet, so schedule it
+  // to run from within the loop.
+  std::vector<CallbackThread*>::iterator iter = m_threads.begin();
+  for (unsigned int i = 0; iter != m_threads.end(); ++iter, ++i) {
+    if ((*iter)->IsRunning()) {
+      m_servers[i]->Execute(
+          NewSingleCallback(m_servers[i], &SelectServer::Terminate));
+    }
+  }
+
+  for (iter = m_threads.begin(); iter != m_threads.end(); ++iter) {
+    if ((*iter)->IsRunning()) {
+      (*iter)->Join();
+    }
+  }
+  STLDeleteElements(&m_threads);
+}
+}  // namespace io
+}  // namespace ola
@@ -23,6 +23,10 @@
  * turn means implementations of PollerInterface also need to be reentrant.
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #ifdef _WIN32
 #include <ola/win/CleanWinSock2.h>
 #endif  // _WIN32
@@ -30,6 +34,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <set>
 #include <sstream>
+#include <vector>
 
 #include "common/io/PollerInterface.h"
 #include "ola/Callback.h"
@@ -41,17 +46,22 @@
 #include "ola/network/Socket.h"
 #include "ola/testing/TestUtils.h"
 
+using ola::CounterVariable;
 using ola::ExportMap;
 using ola::IntegerVariable;
 using ola::NewCallback;
 using ola::NewSingleCallback;
+using ola::TimeInterval;
 using ola::TimeStamp;
 using ola::io::ConnectedDescriptor;
+using ola::io::DESCRIPTOR_PRIORITY_HIGH;
 using ola::io::LoopbackDescriptor;
 using ola::io::PollerInterface;
 using ola::io::SelectServer;
 using ola::io::UnixSocket;
 using ola::io::WriteFileDescriptor;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
 using ola::network::UDPSocket;
 using std::auto_ptr;
 using std::set;
@@ -95,6 +105,11 @@ class SelectServerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testTimeout);
   CPPUNIT_TEST(testOffByOneTimeout);
   CPPUNIT_TEST(testLoopCallbacks);
+  CPPUNIT_TEST(testExecute);
+  CPPUNIT_TEST(testLowLatency);
+  CPPUNIT_TEST(testEdgeTriggeredRead);
+  CPPUNIT_TEST(testDescriptorPriority);
+  CPPUNIT_TEST(testBulkCallbacks);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -115,6 +130,11 @@ class SelectServerTest: public CppUnit::TestFixture {
   void testTimeout();
   void testOffByOneTimeout();
   void testLoopCallbacks();
+  void testExecute();
+  void testLowLatency();
+  void testEdgeTriggeredRead();
+  void testDescriptorPriority();
+  void testBulkCallbacks();
 
   void FatalTimeout() {
     OLA_FAIL("Fatal Timeout");
@@ -187,9 +207,27 @@ class SelectServerTest: public CppUnit::TestFixture {
 
   void IncrementLoopCounter() { m_loop_counter++; }
 
+  void ReadDatagram(UDPSocket *socket) {
+    uint8_t data[10];
+    ssize_t size = arraysize(data);
+    if (socket->RecvFrom(data, &size)) {
+      m_read_counter++;
+    }
+  }
+
+  void RecordDatagram(UDPSocket *socket) {
+    uint8_t data[10];
+    ssize_t size = arraysize(data);
+    if (socket->RecvFrom(data, &size)) {
+      m_read_order.push_back(socket);
+    }
+  }
+
  private:
   unsigned int m_timeout_counter;
   unsigned int m_loop_counter;
+  unsigned int m_read_counter;
+  std::vector<UDPSocket*> m_read_order;
   ExportMap m_map;
   IntegerVariable *connected_read_descriptor_count;
   IntegerVariable *read_descriptor_count;
@@ -211,6 +249,7 @@ void SelectServerTest::setUp() {
   m_ss = new SelectServer(&m_map);
   m_timeout_counter = 0;
   m_loop_counter = 0;
+  m_read_counter = 0;
 
 #if _WIN32
   WSADATA wsa_data;
@@ -660,3 +699,195 @@ void SelectServerTest::testLoopCallbacks() {
   // we should have at least 5 calls to IncrementLoopCounter
   OLA_ASSERT_TRUE(m_loop_counter >= 5);
 }
+
+
+/*
+ * Check that callbacks passed to Execute() are run in order, and that a batch
+ * of them only wakes up the loop once.
+ */
+void SelectServerTest::testExecute() {
+  for (unsigned int i = 0; i < 3; i++) {
+    m_ss->Execute(
+        ola::NewSingleCallback(this, &SelectServerTest::IncrementLoopCounter));
+  }
+  OLA_ASSERT_EQ(0u, m_loop_counter);
+
+  m_ss->RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(3u, m_loop_counter);
+
+  CounterVariable *callbacks = m_map.GetCounterVar("ss-execute-callbacks");
+  CounterVariable *wakeups = m_map.GetCounterVar("ss-execute-wakeups");
+  OLA_ASSERT_EQ(3u, callbacks->Get());
+  OLA_ASSERT_EQ(1u, wakeups->Get());
+  OLA_ASSERT_EQ(3, m_map.GetIntegerVar("ss-execute-queue-depth")->Get());
+
+  // The next callback needs a new wake up.
+  m_ss->Execute(
+      ola::NewSingleCallback(this, &SelectServerTest::IncrementLoopCounter));
+  m_ss->RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(4u, m_loop_counter);
+  OLA_ASSERT_EQ(4u, callbacks->Get());
+  OLA_ASSERT_EQ(2u, wakeups->Get());
+  OLA_ASSERT_EQ(1, m_map.GetIntegerVar("ss-execute-queue-depth")->Get());
+}
+
+
+/*
+ * Check timeouts still run with busy polling & high resolution timers.
+ */
+void SelectServerTest::testLowLatency() {
+  ExportMap export_map;
+  SelectServer::Options options;
+  options.busy_poll_usec = 200;
+  options.high_resolution_timers = true;
+  options.export_map = &export_map;
+  SelectServer ss(options);
+
+  m_timeout_counter = 0;
+  for (unsigned int i = 1; i <= 3; i++) {
+    ss.RegisterSingleTimeout(
+        i,
+        NewSingleCallback(this, &SelectServerTest::SingleIncrementTimeout));
+  }
+  ss.RegisterSingleTimeout(
+      10, NewSingleCallback(&ss, &SelectServer::Terminate));
+  ss.Run();
+  OLA_ASSERT_EQ(3u, m_timeout_counter);
+
+#ifdef HAVE_EPOLL
+  // The wake up latency is only recorded by the EPoller.
+  if (export_map.GetBoolVar("using-epoll")->Get()) {
+    CounterVariable *wakeups = export_map.GetCounterVar(
+        PollerInterface::K_TIMER_WAKEUPS_VAR);
+    OLA_ASSERT_TRUE(wakeups->Get() >= 1u);
+    OLA_ASSERT_TRUE(export_map.GetIntegerVar(
+        PollerInterface::K_MAX_WAKE_LATENCY_VAR)->Get() >= 0);
+  }
+#endif  // HAVE_EPOLL
+}
+
+/*
+ * Check that edge-triggered sockets are drained, up to the read budget.
+ */
+void SelectServerTest::testEdgeTriggeredRead() {
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+
+  socket.SetEdgeTriggered(true);
+  socket.SetOnData(
+      NewCallback(this, &SelectServerTest::ReadDatagram, &socket));
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(&socket));
+
+  const uint8_t data[] = {1, 2, 3};
+  for (unsigned int i = 0; i < 12; i++) {
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(data)),
+                  socket.SendTo(data, sizeof(data), local_address));
+  }
+
+  // Each call to ReadDatagram() reads a single datagram.
+  m_ss->RunOnce(TimeInterval(1, 0));
+#ifdef HAVE_EPOLL
+  if (m_map.GetBoolVar("using-epoll")->Get()) {
+    OLA_ASSERT_EQ(8u, m_read_counter);
+    // The rest are read without a new edge.
+    m_ss->RunOnce(TimeInterval(1, 0));
+    OLA_ASSERT_EQ(12u, m_read_counter);
+
+    // Once empty, the next datagram triggers a new edge.
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(data)),
+                  socket.SendTo(data, sizeof(data), local_address));
+    m_ss->RunOnce(TimeInterval(1, 0));
+    OLA_ASSERT_EQ(13u, m_read_counter);
+  }
+#endif  // HAVE_EPOLL
+  m_ss->RemoveReadDescriptor(&socket);
+}
+
+
+/*
+ * Check that high priority descriptors are serviced first.
+ */
+void SelectServerTest::testDescriptorPriority() {
+  // Check the default poller, and the select() fallback.
+  for (unsigned int i = 0; i < 2; i++) {
+    SelectServer::Options options;
+    options.force_select = i;
+    SelectServer ss(options);
+
+    UDPSocket normal_socket, high_socket;
+    OLA_ASSERT_TRUE(normal_socket.Init());
+    OLA_ASSERT_TRUE(high_socket.Init());
+    OLA_ASSERT_TRUE(normal_socket.Bind(
+        IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+    OLA_ASSERT_TRUE(high_socket.Bind(
+        IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+    IPV4SocketAddress normal_address, high_address;
+    OLA_ASSERT_TRUE(normal_socket.GetSocketAddress(&normal_address));
+    OLA_ASSERT_TRUE(high_socket.GetSocketAddress(&high_address));
+
+    high_socket.SetPriority(DESCRIPTOR_PRIORITY_HIGH);
+    normal_socket.SetOnData(NewCallback(
+        this, &SelectServerTest::RecordDatagram, &normal_socket));
+    high_socket.SetOnData(NewCallback(
+        this, &SelectServerTest::RecordDatagram, &high_socket));
+    OLA_ASSERT_TRUE(ss.AddReadDescriptor(&normal_socket));
+    OLA_ASSERT_TRUE(ss.AddReadDescriptor(&high_socket));
+
+    // The normal socket becomes readable first.
+    const uint8_t data[] = {1, 2, 3};
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(data)),
+                  normal_socket.SendTo(data, sizeof(data), normal_address));
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(data)),
+                  normal_socket.SendTo(data, sizeof(data), high_address));
+
+    m_read_order.clear();
+    ss.RunOnce(TimeInterval(1, 0));
+    OLA_ASSERT_EQ(static_cast<size_t>(2), m_read_order.size());
+    OLA_ASSERT_EQ(&high_socket, m_read_order[0]);
+    OLA_ASSERT_EQ(&normal_socket, m_read_order[1]);
+
+    ss.RemoveReadDescriptor(&normal_socket);
+    ss.RemoveReadDescriptor(&high_socket);
+  }
+}
+
+
+/*
+ * Check bulk callbacks are limited by the budget.
+ */
+void SelectServerTest::testBulkCallbacks() {
+  // With the default budget, a few quick callbacks all run in one pass.
+  for (unsigned int i = 0; i < 3; i++) {
+    m_ss->ExecuteBulk(
+        ola::NewSingleCallback(this, &SelectServerTest::IncrementLoopCounter));
+  }
+  OLA_ASSERT_EQ(0u, m_loop_counter);
+  m_ss->RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(3u, m_loop_counter);
+  OLA_ASSERT_EQ(0, m_map.GetIntegerVar("ss-bulk-queue-depth")->Get());
+
+  // With no budget, one callback runs in each pass.
+  ExportMap export_map;
+  SelectServer::Options options;
+  options.bulk_budget_usec = 0;
+  options.export_map = &export_map;
+  auto_ptr<SelectServer> ss(new SelectServer(options));
+  for (unsigned int i = 0; i < 3; i++) {
+    ss->ExecuteBulk(
+        ola::NewSingleCallback(this, &SelectServerTest::IncrementLoopCounter));
+  }
+
+  // The pending bulk work means this doesn't block.
+  ss->RunOnce(ola::TimeInterval(10, 0));
+  OLA_ASSERT_EQ(4u, m_loop_counter);
+  OLA_ASSERT_EQ(2, export_map.GetIntegerVar("ss-bulk-queue-depth")->Get());
+  ss->RunOnce(ola::TimeInterval(10, 0));
+  OLA_ASSERT_EQ(5u, m_loop_counter);
+
+  // The remaining callback is discarded.
+  ss.reset();
+  OLA_ASSERT_EQ(5u, m_loop_counter);
+}
@@ -0,0 +1,68 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SerialPacer.cpp
+ * Paces the frames sent over a slow serial link.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/io/SerialPacer.h"
+
+#include <stdint.h>
+
+namespace ola {
+namespace io {
+
+SerialPacer::SerialPacer(uint32_t baud_rate, unsigned int bits_per_byte)
+    : m_baud_rate(baud_rate),
+      m_bits_per_byte(bits_per_byte),
+      m_interval_frames(0),
+      m_frame_rate(0) {
+}
+
+TimeInterval SerialPacer::TimeUntilIdle(const TimeStamp &now) const {
+  if (!m_baud_rate || !m_idle_at.IsSet() || now >= m_idle_at) {
+    return TimeInterval();
+  }
+  return m_idle_at - now;
+}
+
+void SerialPacer::FrameSent(const TimeStamp &now, unsigned int length) {
+  if (m_baud_rate) {
+    // If the link is still busy the new bytes are queued behind the old ones.
+    const TimeStamp start = (m_idle_at.IsSet() && m_idle_at > now) ?
+        m_idle_at : now;
+    const int64_t duration = static_cast<int64_t>(length) * m_bits_per_byte *
+                             USEC_IN_SECONDS / m_baud_rate;
+    m_idle_at = start + TimeInterval(duration);
+  }
+
+  // The frame rate is the number of frames sent after the start of the
+  // interval, divided by its length.
+  if (!m_interval_start.IsSet()) {
+    m_interval_start = now;
+    return;
+  }
+  m_interval_frames++;
+  const int64_t elapsed = (now - m_interval_start).AsInt();
+  if (elapsed >= USEC_IN_SECONDS) {
+    m_frame_rate = static_cast<unsigned int>(
+        m_interval_frames * USEC_IN_SECONDS / elapsed);
+    m_interval_start = now;
+    m_interval_frames = 0;
+  }
+}
+}  // namespace io
+}  // namespace ola
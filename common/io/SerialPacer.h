@@ -0,0 +1,84 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SerialPacer.h
+ * Paces the frames sent over a slow serial link.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_SERIALPACER_H_
+#define COMMON_IO_SERIALPACER_H_
+
+#include <stdint.h>
+
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace io {
+
+/**
+ * @class SerialPacer
+ * @brief Tracks when a slow serial link will be idle, and the frame rate
+ * achieved on it.
+ *
+ * Each frame occupies the link for the time it takes to clock its bytes out.
+ * Rather than queue a new frame behind one that's still being sent, which
+ * only adds latency, the caller can hold the latest frame back until the link
+ * is idle. The rate then adapts to the size of the frames.
+ */
+class SerialPacer {
+ public:
+  /**
+   * @brief Create a new SerialPacer.
+   * @param baud_rate the baud rate of the link, or 0 if the link isn't rate
+   *   limited, e.g. it's a TCP connection.
+   * @param bits_per_byte the bits sent for each byte, 10 for 8N1.
+   */
+  explicit SerialPacer(uint32_t baud_rate, unsigned int bits_per_byte = 10);
+
+  /**
+   * @brief Return how long it is until the link is idle.
+   * @param now the current time.
+   * @returns the time until the link is idle, zero if it's idle now.
+   */
+  TimeInterval TimeUntilIdle(const TimeStamp &now) const;
+
+  /**
+   * @brief Record that a frame was sent.
+   * @param now the current time.
+   * @param length the number of bytes sent.
+   */
+  void FrameSent(const TimeStamp &now, unsigned int length);
+
+  /**
+   * @brief The number of frames sent per second, measured over the last
+   * complete interval of at least a second.
+   */
+  unsigned int FrameRate() const { return m_frame_rate; }
+
+ private:
+  const uint32_t m_baud_rate;
+  const unsigned int m_bits_per_byte;
+  TimeStamp m_idle_at;
+  TimeStamp m_interval_start;
+  unsigned int m_interval_frames;
+  unsigned int m_frame_rate;
+
+  DISALLOW_COPY_AND_ASSIGN(SerialPacer);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_SERIALPACER_H_
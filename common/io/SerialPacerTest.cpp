@@ -0,0 +1,88 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SerialPacerTest.cpp
+ * Test fixture for the SerialPacer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "common/io/SerialPacer.h"
+#include "ola/Clock.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::SerialPacer;
+
+class SerialPacerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SerialPacerTest);
+  CPPUNIT_TEST(testPacing);
+  CPPUNIT_TEST(testUnlimited);
+  CPPUNIT_TEST(testFrameRate);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testPacing();
+  void testUnlimited();
+  void testFrameRate();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SerialPacerTest);
+
+
+/*
+ * Check the link is busy while the bytes are clocked out.
+ */
+void SerialPacerTest::testPacing() {
+  // 10 bits per byte at 100k baud is 100us a byte.
+  SerialPacer pacer(100000);
+  TimeStamp now(TimeStamp() + TimeInterval(10, 0));
+  OLA_ASSERT_TRUE(pacer.TimeUntilIdle(now).IsZero());
+
+  pacer.FrameSent(now, 50);
+  OLA_ASSERT_EQ(TimeInterval(5000), pacer.TimeUntilIdle(now));
+  OLA_ASSERT_EQ(TimeInterval(3000),
+                pacer.TimeUntilIdle(now + TimeInterval(2000)));
+
+  // A frame sent while the link is busy is queued behind the first one.
+  now += TimeInterval(1000);
+  pacer.FrameSent(now, 10);
+  OLA_ASSERT_EQ(TimeInterval(5000), pacer.TimeUntilIdle(now));
+  OLA_ASSERT_TRUE(pacer.TimeUntilIdle(now + TimeInterval(6000)).IsZero());
+}
+
+
+void SerialPacerTest::testUnlimited() {
+  SerialPacer pacer(0);
+  TimeStamp now(TimeStamp() + TimeInterval(10, 0));
+  pacer.FrameSent(now, 512);
+  OLA_ASSERT_TRUE(pacer.TimeUntilIdle(now).IsZero());
+}
+
+
+void SerialPacerTest::testFrameRate() {
+  SerialPacer pacer(0);
+  TimeStamp now(TimeStamp() + TimeInterval(10, 0));
+  OLA_ASSERT_EQ(0u, pacer.FrameRate());
+
+  // 26 frames, 40ms apart, cover a whole second at 25 fps.
+  for (unsigned int i = 0; i < 26; i++) {
+    pacer.FrameSent(now, 10);
+    now += TimeInterval(40000);
+  }
+  OLA_ASSERT_EQ(25u, pacer.FrameRate());
+}
@@ -18,11 +18,17 @@
  * Copyright (C) 2013 Simon Newton
  */
 
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
 #include <queue>
 #include <set>
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/util/Trace.h"
+#include "common/io/LoopProfiler.h"
 #include "common/io/TimeoutManager.h"
 
 namespace ola {
@@ -36,13 +42,51 @@ using ola::ExportMap;
 using ola::thread::INVALID_TIMEOUT;
 using ola::thread::timeout_id;
 
+namespace {
+/*
+ * Return the index of the first set bit at or above start, or 64 if there
+ * isn't one.
+ */
+unsigned int FirstSetBit(uint64_t bits, unsigned int start) {
+  if (start >= 64) {
+    return 64;
+  }
+  bits &= ~static_cast<uint64_t>(0) << start;
+  if (!bits) {
+    return 64;
+  }
+#ifdef __GNUC__
+  return __builtin_ctzll(bits);
+#else
+  unsigned int index = start;
+  while (!(bits & (static_cast<uint64_t>(1) << index))) {
+    index++;
+  }
+  return index;
+#endif  // __GNUC__
+}
+}  // namespace
+
 TimeoutManager::TimeoutManager(ExportMap *export_map,
-                               Clock *clock)
+                               Clock *clock,
+                               bool use_timer_wheel)
     : m_export_map(export_map),
-      m_clock(clock) {
+      m_timer_var(NULL),
+      m_clock(clock),
+      m_profiler(NULL),
+      m_use_timer_wheel(use_timer_wheel),
+      m_current_tick(0),
+      m_overflow_events(NULL),
+      m_expired_events(NULL),
+      m_running_event(NULL),
+      m_running_event_cancelled(false),
+      m_wheel_event_count(0) {
   if (m_export_map) {
-    m_export_map->GetIntegerVar(K_TIMER_VAR);
+    m_timer_var = m_export_map->GetIntegerVar(K_TIMER_VAR);
   }
+  m_clock->CurrentTime(&m_wheel_start);
+  memset(m_wheel, 0, sizeof(m_wheel));
+  memset(m_occupied_slots, 0, sizeof(m_occupied_slots));
 }
 
 TimeoutManager::~TimeoutManager() {
@@ -52,6 +96,14 @@ TimeoutManager::~TimeoutManager() {
     delete m_events.top();
     m_events.pop();
   }
+
+  for (unsigned int level = 0; level < WHEEL_LEVELS; level++) {
+    for (unsigned int slot = 0; slot < WHEEL_SLOTS; slot++) {
+      DeleteEvents(m_wheel[level][slot]);
+    }
+  }
+  DeleteEvents(m_overflow_events);
+  DeleteEvents(m_expired_events);
 }
 
 timeout_id TimeoutManager::RegisterRepeatingTimeout(
@@ -60,11 +112,11 @@ timeout_id TimeoutManager::RegisterRepeatingTimeout(
   if (!closure)
     return INVALID_TIMEOUT;
 
-  if (m_export_map)
-    (*m_export_map->GetIntegerVar(K_TIMER_VAR))++;
+  if (m_timer_var)
+    (*m_timer_var)++;
 
   Event *event = new RepeatingEvent(interval, m_clock, closure);
-  m_events.push(event);
+  AddEvent(event);
   return event;
 }
 
@@ -74,11 +126,11 @@ timeout_id TimeoutManager::RegisterSingleTimeout(
   if (!closure)
     return INVALID_TIMEOUT;
 
-  if (m_export_map)
-    (*m_export_map->GetIntegerVar(K_TIMER_VAR))++;
+  if (m_timer_var)
+    (*m_timer_var)++;
 
   Event *event = new SingleEvent(interval, m_clock, closure);
-  m_events.push(event);
+  AddEvent(event);
   return event;
 }
 
@@ -88,11 +140,31 @@ void TimeoutManager::CancelTimeout(timeout_id id) {
   if (id == INVALID_TIMEOUT)
     return;
 
+  if (m_use_timer_wheel) {
+    Event *event = static_cast<Event*>(id);
+    if (event == m_running_event) {
+      // Cancelled from within its own callback, it's deleted once the
+      // callback returns.
+      m_running_event_cancelled = true;
+      return;
+    }
+    WheelUnlink(event);
+    delete event;
+    m_wheel_event_count--;
+    if (m_timer_var)
+      (*m_timer_var)--;
+    return;
+  }
+
   if (!m_removed_timeouts.insert(id).second)
     OLA_WARN << "timeout " << id << " already in remove set";
 }
 
 TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
+  OLA_TRACE_SCOPE("io", "TimeoutManager::ExecuteTimeouts");
+  if (m_use_timer_wheel)
+    return ExecuteWheelTimeouts(now);
+
   Event *e;
   if (m_events.empty())
     return TimeInterval();
@@ -104,19 +176,19 @@ TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
     // if this was removed, skip it
     if (m_removed_timeouts.erase(e)) {
       delete e;
-      if (m_export_map)
-        (*m_export_map->GetIntegerVar(K_TIMER_VAR))--;
+      if (m_timer_var)
+        (*m_timer_var)--;
       continue;
     }
 
-    if (e->Trigger()) {
+    if (TriggerEvent(e)) {
       // true implies we need to run this again
       e->UpdateTime(*now);
       m_events.push(e);
     } else {
       delete e;
-      if (m_export_map)
-        (*m_export_map->GetIntegerVar(K_TIMER_VAR))--;
+      if (m_timer_var)
+        (*m_timer_var)--;
     }
     m_clock->CurrentTime(now);
   }
@@ -126,5 +198,268 @@ TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
   else
     return m_events.top()->NextTime() - *now;
 }
+
+void TimeoutManager::AddEvent(Event *event) {
+  if (m_use_timer_wheel) {
+    WheelInsert(event);
+    m_wheel_event_count++;
+  } else {
+    m_events.push(event);
+  }
+}
+
+/*
+ * Run an event, recording how long it took if we're profiling.
+ */
+bool TimeoutManager::TriggerEvent(Event *event) {
+  if (!m_profiler) {
+    return event->Trigger();
+  }
+  TimeStamp start;
+  m_profiler->Start(&start);
+  bool repeat = event->Trigger();
+  m_profiler->RecordTimeout(event->Interval(), start);
+  return repeat;
+}
+
+TimeInterval TimeoutManager::ExecuteWheelTimeouts(TimeStamp *now) {
+  const uint64_t now_tick = WheelTick(*now);
+  while (m_current_tick < now_tick) {
+    // Everything in the current slot is due.
+    unsigned int index = m_current_tick & WHEEL_SLOT_MASK;
+    while (m_wheel[0][index]) {
+      RunExpiredEvents(true, now);
+    }
+
+    // Skip to the next tick that has events to run or cascade.
+    m_current_tick = std::min(NextWheelTick(), now_tick);
+    if ((m_current_tick & WHEEL_SLOT_MASK) == 0) {
+      CascadeWheel();
+    }
+  }
+
+  // The current slot may contain events later in this tick.
+  RunExpiredEvents(false, now);
+
+  const Event *event = EarliestWheelEvent();
+  if (!event) {
+    return TimeInterval();
+  }
+  TimeInterval delay = event->NextTime() - *now;
+  // A zero interval means there are no events.
+  return delay > TimeInterval(0, 0) ? delay : TimeInterval(0, 1);
+}
+
+/*
+ * Return the next tick that either has events to run, or on which occupied
+ * slots are cascaded.
+ */
+uint64_t TimeoutManager::NextWheelTick() const {
+  const uint64_t level_size = static_cast<uint64_t>(1) << WHEEL_SLOT_BITS;
+  uint64_t next_tick = std::numeric_limits<uint64_t>::max();
+  for (unsigned int level = 0; level < WHEEL_LEVELS; level++) {
+    if (!m_occupied_slots[level]) {
+      continue;
+    }
+    const unsigned int shift = WHEEL_SLOT_BITS * level;
+    const uint64_t block = m_current_tick >> shift;
+    const unsigned int index = block & WHEEL_SLOT_MASK;
+    unsigned int slot = FirstSetBit(m_occupied_slots[level], index + 1);
+    if (slot == WHEEL_SLOTS) {
+      slot = FirstSetBit(m_occupied_slots[level], 0);
+    }
+    // The slots at or before the current index are in the next rotation.
+    uint64_t offset = slot > index ? slot - index : level_size + slot - index;
+    next_tick = std::min(next_tick, (block + offset) << shift);
+  }
+  if (m_overflow_events) {
+    const unsigned int shift = WHEEL_SLOT_BITS * WHEEL_LEVELS;
+    next_tick = std::min(next_tick, ((m_current_tick >> shift) + 1) << shift);
+  }
+  return next_tick;
+}
+
+/*
+ * Run the events in the current slot.
+ * @param all if false, only run the events that are due by now.
+ */
+void TimeoutManager::RunExpiredEvents(bool all, TimeStamp *now) {
+  unsigned int index = m_current_tick & WHEEL_SLOT_MASK;
+  m_expired_events = m_wheel[0][index];
+  m_wheel[0][index] = NULL;
+  m_occupied_slots[0] &= ~(static_cast<uint64_t>(1) << index);
+  for (Event *e = m_expired_events; e; e = e->position.next) {
+    e->position.level = EXPIRED_LEVEL;
+  }
+
+  // Events may be cancelled by the callbacks so pop them one at a time.
+  while (m_expired_events) {
+    Event *e = m_expired_events;
+    WheelUnlink(e);
+    if (!all && e->NextTime() > *now) {
+      WheelInsert(e);
+      continue;
+    }
+
+    m_running_event = e;
+    m_running_event_cancelled = false;
+    bool repeat = TriggerEvent(e);
+    m_running_event = NULL;
+
+    if (repeat && !m_running_event_cancelled) {
+      e->UpdateTime(*now);
+      WheelInsert(e);
+    } else {
+      delete e;
+      m_wheel_event_count--;
+      if (m_timer_var)
+        (*m_timer_var)--;
+    }
+    m_clock->CurrentTime(now);
+  }
+}
+
+/*
+ * Called as the current tick starts a new rotation of the first level, this
+ * moves the events from the upper levels down.
+ */
+void TimeoutManager::CascadeWheel() {
+  unsigned int level = 1;
+  while (level < WHEEL_LEVELS &&
+         ((m_current_tick >> (WHEEL_SLOT_BITS * level)) & WHEEL_SLOT_MASK) ==
+            0) {
+    level++;
+  }
+
+  if (level == WHEEL_LEVELS) {
+    Event *e = m_overflow_events;
+    m_overflow_events = NULL;
+    while (e) {
+      Event *next = e->position.next;
+      WheelInsert(e);
+      e = next;
+    }
+    level--;
+  }
+
+  // Higher levels first, so their events can be cascaded again.
+  for (; level > 0; level--) {
+    unsigned int index = (m_current_tick >> (WHEEL_SLOT_BITS * level)) &
+                         WHEEL_SLOT_MASK;
+    Event *e = m_wheel[level][index];
+    m_wheel[level][index] = NULL;
+    m_occupied_slots[level] &= ~(static_cast<uint64_t>(1) << index);
+    while (e) {
+      Event *next = e->position.next;
+      WheelInsert(e);
+      e = next;
+    }
+  }
+}
+
+void TimeoutManager::WheelInsert(Event *event) {
+  uint64_t tick = std::max(WheelTick(event->NextTime()), m_current_tick);
+  uint64_t delta = tick - m_current_tick;
+
+  unsigned int level = 0;
+  while (level < WHEEL_LEVELS &&
+         delta >= (static_cast<uint64_t>(1) <<
+                   (WHEEL_SLOT_BITS * (level + 1)))) {
+    level++;
+  }
+
+  unsigned int slot = 0;
+  if (level < WHEEL_LEVELS) {
+    slot = (tick >> (WHEEL_SLOT_BITS * level)) & WHEEL_SLOT_MASK;
+    m_occupied_slots[level] |= static_cast<uint64_t>(1) << slot;
+  }
+
+  Event **head = WheelList(level, slot);
+  event->position.prev = NULL;
+  event->position.next = *head;
+  event->position.level = level;
+  event->position.slot = slot;
+  if (*head) {
+    (*head)->position.prev = event;
+  }
+  *head = event;
+}
+
+void TimeoutManager::WheelUnlink(Event *event) {
+  Event::WheelPosition *position = &event->position;
+  if (position->prev) {
+    position->prev->position.next = position->next;
+  } else {
+    Event **head = WheelList(position->level, position->slot);
+    *head = position->next;
+    if (!*head && position->level < WHEEL_LEVELS) {
+      m_occupied_slots[position->level] &=
+          ~(static_cast<uint64_t>(1) << position->slot);
+    }
+  }
+  if (position->next) {
+    position->next->position.prev = position->prev;
+  }
+  position->prev = NULL;
+  position->next = NULL;
+}
+
+TimeoutManager::Event **TimeoutManager::WheelList(unsigned int level,
+                                                  unsigned int slot) {
+  if (level < WHEEL_LEVELS) {
+    return &m_wheel[level][slot];
+  } else if (level == OVERFLOW_LEVEL) {
+    return &m_overflow_events;
+  } else {
+    return &m_expired_events;
+  }
+}
+
+/*
+ * The slots of each level are in time order starting from the current tick,
+ * so the earliest event is in the first occupied slot of one of the levels.
+ */
+const TimeoutManager::Event *TimeoutManager::EarliestWheelEvent() const {
+  const Event *earliest = NULL;
+  for (unsigned int level = 0; level <= WHEEL_LEVELS; level++) {
+    const Event *e = m_overflow_events;
+    if (level < WHEEL_LEVELS) {
+      // The slot of the current tick on the upper levels holds events for
+      // the next rotation.
+      unsigned int start = (m_current_tick >> (WHEEL_SLOT_BITS * level)) &
+                           WHEEL_SLOT_MASK;
+      if (level) {
+        start++;
+      }
+      unsigned int index = FirstSetBit(m_occupied_slots[level], start);
+      if (index == WHEEL_SLOTS) {
+        index = FirstSetBit(m_occupied_slots[level], 0);
+      }
+      e = index < WHEEL_SLOTS ? m_wheel[level][index] : NULL;
+    }
+
+    for (; e; e = e->position.next) {
+      if (!earliest || e->NextTime() < earliest->NextTime()) {
+        earliest = e;
+      }
+    }
+  }
+  return earliest;
+}
+
+uint64_t TimeoutManager::WheelTick(const TimeStamp &time) const {
+  if (time <= m_wheel_start) {
+    return 0;
+  }
+  return (time - m_wheel_start).AsInt() / WHEEL_TICK_US;
+}
+
+void TimeoutManager::DeleteEvents(Event *head) {
+  while (head) {
+    Event *next = head->position.next;
+    delete head;
+    head = next;
+  }
+}
 }  // namespace io
 }  // namespace ola
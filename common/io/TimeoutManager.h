@@ -21,6 +21,7 @@
 #ifndef COMMON_IO_TIMEOUTMANAGER_H_
 #define COMMON_IO_TIMEOUTMANAGER_H_
 
+#include <stdint.h>
 #include <queue>
 #include <set>
 #include <vector>
@@ -34,6 +35,7 @@
 namespace ola {
 namespace io {
 
+class LoopProfiler;
 
 /**
  * @class TimeoutManager
@@ -41,6 +43,12 @@ namespace io {
  *
  * The TimeoutManager allows Callbacks to trigger at some point in the future.
  * Callbacks can be invoked once, or periodically.
+ *
+ * By default events are held in a priority queue. Alternatively a
+ * hierarchical timer wheel can be used, which makes registering and
+ * cancelling a timeout O(1) at the cost of millisecond granularity; events
+ * never run early but may run up to a millisecond late. With the timer
+ * wheel, a timeout must not be cancelled once it has run.
  */
 class TimeoutManager {
  public :
@@ -48,8 +56,10 @@ class TimeoutManager {
    * @brief Create a new TimeoutManager.
    * @param export_map an ExportMap to update
    * @param clock the Clock to use.
+   * @param use_timer_wheel use a timer wheel rather than a priority queue.
    */
-  TimeoutManager(ola::ExportMap *export_map, Clock *clock);
+  TimeoutManager(ola::ExportMap *export_map, Clock *clock,
+                 bool use_timer_wheel = false);
 
   ~TimeoutManager();
 
@@ -85,11 +95,12 @@ class TimeoutManager {
 
   /**
    * @brief Check if there are any events in the queue.
-   * Events remain in the queue even if they have been cancelled.
+   * Events remain in the queue even if they have been cancelled, the timer
+   * wheel removes them immediately.
    * @returns true if there are events pending, false otherwise.
    */
   bool EventsPending() const {
-    return !m_events.empty();
+    return m_use_timer_wheel ? m_wheel_event_count > 0 : !m_events.empty();
   }
 
   /**
@@ -100,6 +111,13 @@ class TimeoutManager {
    */
   TimeInterval ExecuteTimeouts(TimeStamp *now);
 
+  /**
+   * @brief Record the execution time of each timeout.
+   * @param profiler the LoopProfiler to use, ownership is not transferred. Use
+   *   NULL to stop profiling.
+   */
+  void SetProfiler(LoopProfiler *profiler) { m_profiler = profiler; }
+
   static const char K_TIMER_VAR[];
 
  private :
@@ -119,6 +137,16 @@ class TimeoutManager {
     }
 
     TimeStamp NextTime() const { return m_next; }
+    const TimeInterval &Interval() const { return m_interval; }
+
+    // The list this event is on, only used by the timer wheel.
+    struct WheelPosition {
+      Event *prev;
+      Event *next;
+      unsigned int level;
+      unsigned int slot;
+    };
+    WheelPosition position;
 
    private:
     TimeInterval m_interval;
@@ -187,12 +215,50 @@ class TimeoutManager {
   typedef std::priority_queue<Event*, std::vector<Event*>, ltevent>
       event_queue_t;
 
+  // Each level of the wheel has 64 slots, each slot covers 64 times the
+  // ticks of the level below. With 1ms ticks the five levels cover about 12
+  // days, later events are held in the overflow list.
+  static const unsigned int WHEEL_LEVELS = 5;
+  static const unsigned int WHEEL_SLOT_BITS = 6;
+  static const unsigned int WHEEL_SLOTS = 1 << WHEEL_SLOT_BITS;
+  static const unsigned int WHEEL_SLOT_MASK = WHEEL_SLOTS - 1;
+  static const unsigned int OVERFLOW_LEVEL = WHEEL_LEVELS;
+  static const unsigned int EXPIRED_LEVEL = WHEEL_LEVELS + 1;
+  static const int64_t WHEEL_TICK_US = 1000;
+
   ola::ExportMap *m_export_map;
+  ola::IntegerVariable *m_timer_var;
   Clock *m_clock;
+  LoopProfiler *m_profiler;
 
   event_queue_t m_events;
   std::set<ola::thread::timeout_id> m_removed_timeouts;
 
+  const bool m_use_timer_wheel;
+  TimeStamp m_wheel_start;
+  // All events due before this tick have been run.
+  uint64_t m_current_tick;
+  Event *m_wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+  uint64_t m_occupied_slots[WHEEL_LEVELS];
+  Event *m_overflow_events;
+  Event *m_expired_events;
+  Event *m_running_event;
+  bool m_running_event_cancelled;
+  unsigned int m_wheel_event_count;
+
+  void AddEvent(Event *event);
+  bool TriggerEvent(Event *event);
+  TimeInterval ExecuteWheelTimeouts(TimeStamp *now);
+  void RunExpiredEvents(bool all, TimeStamp *now);
+  uint64_t NextWheelTick() const;
+  void CascadeWheel();
+  void WheelInsert(Event *event);
+  void WheelUnlink(Event *event);
+  Event **WheelList(unsigned int level, unsigned int slot);
+  const Event *EarliestWheelEvent() const;
+  uint64_t WheelTick(const TimeStamp &time) const;
+  void DeleteEvents(Event *head);
+
   DISALLOW_COPY_AND_ASSIGN(TimeoutManager);
 };
 }  // namespace io
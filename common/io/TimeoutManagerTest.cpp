@@ -21,7 +21,9 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <map>
+#include <vector>
 
+#include "common/io/LoopProfiler.h"
 #include "common/io/TimeoutManager.h"
 #include "ola/Callback.h"
 #include "ola/Clock.h"
@@ -35,15 +37,38 @@ using ola::NewSingleCallback;
 using ola::NewCallback;
 using ola::TimeInterval;
 using ola::TimeStamp;
+using ola::UIntMap;
+using ola::io::LoopProfiler;
 using ola::io::TimeoutManager;
 using ola::thread::timeout_id;
 
+/*
+ * A Clock which only moves when it's advanced. The MockClock follows the
+ * wall clock, so it can't be used to check execution times exactly.
+ */
+class StoppedClock: public ola::Clock {
+ public:
+  StoppedClock() : ola::Clock() {}
+
+  void AdvanceTime(int32_t sec, int32_t usec) {
+    m_now += TimeInterval(sec, usec);
+  }
+
+  void CurrentTime(TimeStamp *timestamp) const { *timestamp = m_now; }
+
+ private:
+  TimeStamp m_now;
+};
+
 class TimeoutManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(TimeoutManagerTest);
   CPPUNIT_TEST(testSingleTimeouts);
   CPPUNIT_TEST(testRepeatingTimeouts);
   CPPUNIT_TEST(testAbortedRepeatingTimeouts);
   CPPUNIT_TEST(testPendingEventShutdown);
+  CPPUNIT_TEST(testTimerWheel);
+  CPPUNIT_TEST(testTimerWheelCancel);
+  CPPUNIT_TEST(testProfiler);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -51,6 +76,9 @@ class TimeoutManagerTest: public CppUnit::TestFixture {
     void testRepeatingTimeouts();
     void testAbortedRepeatingTimeouts();
     void testPendingEventShutdown();
+    void testTimerWheel();
+    void testTimerWheelCancel();
+    void testProfiler();
 
     void HandleEvent(unsigned int event_id) {
       m_event_counters[event_id]++;
@@ -67,12 +95,32 @@ class TimeoutManagerTest: public CppUnit::TestFixture {
       return m_event_counters[event_id] < 2;
     }
 
+    // cancels m_timeout_to_cancel, which may be this timeout.
+    bool HandleCancellingEvent(unsigned int event_id) {
+      m_event_counters[event_id]++;
+      m_timeout_manager->CancelTimeout(m_timeout_to_cancel);
+      return true;
+    }
+
+    // advances the clock by the given number of ms.
+    bool HandleSlowEvent(StoppedClock *clock, unsigned int ms) {
+      clock->AdvanceTime(0, ms * 1000);
+      return true;
+    }
+
     unsigned int GetEventCounter(unsigned int event_id) {
       return m_event_counters[event_id];
     }
 
  private:
     ExportMap m_map;
+    TimeoutManager *m_timeout_manager;
+    ola::thread::timeout_id m_timeout_to_cancel;
+
+    void CheckSingleTimeouts(bool use_timer_wheel);
+    void CheckRepeatingTimeouts(bool use_timer_wheel);
+    void CheckAbortedRepeatingTimeouts(bool use_timer_wheel);
+    void CheckPendingEventShutdown(bool use_timer_wheel);
     std::map<unsigned int, unsigned int> m_event_counters;
 };
 
@@ -83,8 +131,14 @@ CPPUNIT_TEST_SUITE_REGISTRATION(TimeoutManagerTest);
  * Check RegisterSingleTimeout works.
  */
 void TimeoutManagerTest::testSingleTimeouts() {
+  CheckSingleTimeouts(false);
+  CheckSingleTimeouts(true);
+}
+
+void TimeoutManagerTest::CheckSingleTimeouts(bool use_timer_wheel) {
+  m_event_counters.clear();
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, use_timer_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -137,8 +191,14 @@ void TimeoutManagerTest::testSingleTimeouts() {
  * Check RegisterRepeatingTimeout works.
  */
 void TimeoutManagerTest::testRepeatingTimeouts() {
+  CheckRepeatingTimeouts(false);
+  CheckRepeatingTimeouts(true);
+}
+
+void TimeoutManagerTest::CheckRepeatingTimeouts(bool use_timer_wheel) {
+  m_event_counters.clear();
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, use_timer_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -191,8 +251,14 @@ void TimeoutManagerTest::testRepeatingTimeouts() {
  * Check returning false from a repeating timeout cancels the timeout.
  */
 void TimeoutManagerTest::testAbortedRepeatingTimeouts() {
+  CheckAbortedRepeatingTimeouts(false);
+  CheckAbortedRepeatingTimeouts(true);
+}
+
+void TimeoutManagerTest::CheckAbortedRepeatingTimeouts(bool use_timer_wheel) {
+  m_event_counters.clear();
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, use_timer_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -223,8 +289,14 @@ void TimeoutManagerTest::testAbortedRepeatingTimeouts() {
  * destroyed.
  */
 void TimeoutManagerTest::testPendingEventShutdown() {
+  CheckPendingEventShutdown(false);
+  CheckPendingEventShutdown(true);
+}
+
+void TimeoutManagerTest::CheckPendingEventShutdown(bool use_timer_wheel) {
+  m_event_counters.clear();
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, use_timer_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -241,3 +313,177 @@ void TimeoutManagerTest::testPendingEventShutdown() {
 
   OLA_ASSERT_TRUE(timeout_manager.EventsPending());
 }
+
+
+/*
+ * Check the timer wheel runs events at the right time, across all the levels
+ * of the wheel.
+ */
+void TimeoutManagerTest::testTimerWheel() {
+  MockClock clock;
+  TimeoutManager timeout_manager(&m_map, &clock, true);
+
+  // The MockClock follows the real clock, so the events are registered
+  // between start and end.
+  TimeStamp start, end;
+  clock.CurrentTime(&start);
+
+  // From 0.5ms to about 35 days, so the overflow list is used.
+  const unsigned int EVENT_COUNT = 32;
+  int64_t intervals[EVENT_COUNT];
+  int64_t interval = 500;
+  for (unsigned int i = 0; i < EVENT_COUNT; i++) {
+    intervals[i] = interval;
+    timeout_manager.RegisterSingleTimeout(
+        TimeInterval(interval),
+        NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, i));
+    interval = interval * 7 / 4 + 13;
+  }
+  // A 7ms repeating event
+  timeout_manager.RegisterRepeatingTimeout(
+      TimeInterval(0, 7000),
+      NewCallback(this, &TimeoutManagerTest::HandleRepeatingEvent,
+                  EVENT_COUNT));
+
+  clock.CurrentTime(&end);
+  TimeStamp now = end;
+  for (unsigned int i = 0; i < EVENT_COUNT; i++) {
+    // Skip to just before the event, using the returned interval to wake up
+    // as the SelectServer would.
+    TimeStamp due = start + TimeInterval(intervals[i]);
+    while (true) {
+      TimeInterval next = timeout_manager.ExecuteTimeouts(&now);
+      OLA_ASSERT_FALSE(next.IsZero());
+      if (GetEventCounter(i)) {
+        break;
+      }
+      // Events run within a millisecond of their due time.
+      OLA_ASSERT_LT(now, end + TimeInterval(intervals[i] + 1000));
+      // Don't step one repeating event at a time for the long timeouts.
+      TimeStamp wake_up = now + next;
+      if (next < due - now && wake_up < due - TimeInterval(0, 7000)) {
+        wake_up = due - TimeInterval(0, 7000);
+      }
+      clock.AdvanceTime(wake_up - now);
+      clock.CurrentTime(&now);
+    }
+    // But never early.
+    OLA_ASSERT_LTE(due, now);
+    OLA_ASSERT_EQ(1u, GetEventCounter(i));
+    if (i + 1 < EVENT_COUNT) {
+      OLA_ASSERT_EQ(0u, GetEventCounter(i + 1));
+    }
+  }
+  OLA_ASSERT_TRUE(GetEventCounter(EVENT_COUNT) > 0);
+  OLA_ASSERT_TRUE(timeout_manager.EventsPending());
+}
+
+
+/*
+ * Check timeouts can be cancelled from the timer wheel, including from
+ * within a callback.
+ */
+void TimeoutManagerTest::testTimerWheelCancel() {
+  m_event_counters.clear();
+  MockClock clock;
+  TimeoutManager timeout_manager(&m_map, &clock, true);
+  m_timeout_manager = &timeout_manager;
+
+  const unsigned int EVENT_COUNT = 1000;
+  std::vector<timeout_id> ids;
+  for (unsigned int i = 0; i < EVENT_COUNT; i++) {
+    ids.push_back(timeout_manager.RegisterSingleTimeout(
+        TimeInterval(0, (i % 200) * 1000 + 100),
+        NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, i)));
+  }
+  OLA_ASSERT_EQ(EVENT_COUNT, static_cast<unsigned int>(
+                    m_map.GetIntegerVar(TimeoutManager::K_TIMER_VAR)->Get()));
+  for (unsigned int i = 0; i < EVENT_COUNT; i += 2) {
+    timeout_manager.CancelTimeout(ids[i]);
+  }
+  OLA_ASSERT_EQ(EVENT_COUNT / 2, static_cast<unsigned int>(
+                    m_map.GetIntegerVar(TimeoutManager::K_TIMER_VAR)->Get()));
+
+  TimeStamp now;
+  clock.AdvanceTime(1, 0);
+  clock.CurrentTime(&now);
+  OLA_ASSERT_TRUE(timeout_manager.ExecuteTimeouts(&now).IsZero());
+  for (unsigned int i = 0; i < EVENT_COUNT; i++) {
+    OLA_ASSERT_EQ(i % 2, GetEventCounter(i));
+  }
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+
+  // A repeating event that cancels itself
+  m_event_counters.clear();
+  m_timeout_to_cancel = timeout_manager.RegisterRepeatingTimeout(
+      TimeInterval(0, 5000),
+      NewCallback(this, &TimeoutManagerTest::HandleCancellingEvent, 1u));
+  clock.AdvanceTime(0, 10000);
+  clock.CurrentTime(&now);
+  OLA_ASSERT_TRUE(timeout_manager.ExecuteTimeouts(&now).IsZero());
+  OLA_ASSERT_EQ(1u, GetEventCounter(1));
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+
+  // And one that cancels another event due in the same tick. Events in the
+  // same slot run most recently registered first.
+  m_timeout_to_cancel = timeout_manager.RegisterSingleTimeout(
+      TimeInterval(0, 5000),
+      NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, 2u));
+  timeout_id id = timeout_manager.RegisterRepeatingTimeout(
+      TimeInterval(0, 5000),
+      NewCallback(this, &TimeoutManagerTest::HandleCancellingEvent, 3u));
+  clock.AdvanceTime(0, 5000);
+  clock.CurrentTime(&now);
+  timeout_manager.ExecuteTimeouts(&now);
+  OLA_ASSERT_EQ(0u, GetEventCounter(2));
+  OLA_ASSERT_EQ(1u, GetEventCounter(3));
+  OLA_ASSERT_EQ(1, m_map.GetIntegerVar(TimeoutManager::K_TIMER_VAR)->Get());
+
+  timeout_manager.CancelTimeout(id);
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+  OLA_ASSERT_EQ(0, m_map.GetIntegerVar(TimeoutManager::K_TIMER_VAR)->Get());
+  m_timeout_manager = NULL;
+}
+
+
+/*
+ * Check the LoopProfiler records the execution time of each timeout.
+ */
+void TimeoutManagerTest::testProfiler() {
+  ExportMap export_map;
+  StoppedClock clock;
+  LoopProfiler profiler(&export_map, &clock, TimeInterval(0, 10000));
+  TimeoutManager timeout_manager(&m_map, &clock);
+  timeout_manager.SetProfiler(&profiler);
+
+  timeout_manager.RegisterRepeatingTimeout(
+      TimeInterval(0, 100000),
+      NewCallback(this, &TimeoutManagerTest::HandleSlowEvent, &clock, 2u));
+  timeout_manager.RegisterRepeatingTimeout(
+      TimeInterval(1, 0),
+      NewCallback(this, &TimeoutManagerTest::HandleSlowEvent, &clock, 20u));
+
+  TimeStamp now;
+  for (unsigned int i = 0; i < 10; i++) {
+    clock.AdvanceTime(0, 100000);
+    clock.CurrentTime(&now);
+    timeout_manager.ExecuteTimeouts(&now);
+  }
+
+  UIntMap *callbacks = export_map.GetUIntMapVar(LoopProfiler::K_CALLBACKS_VAR);
+  UIntMap *slow_callbacks = export_map.GetUIntMapVar(
+      LoopProfiler::K_SLOW_CALLBACKS_VAR);
+  UIntMap *max_time = export_map.GetUIntMapVar(
+      LoopProfiler::K_CALLBACK_MAX_VAR);
+
+  // Stats are exported on the first sample.
+  OLA_ASSERT_EQ(1u, (*callbacks)["timeout-100ms"]);
+  OLA_ASSERT_EQ(0u, (*slow_callbacks)["timeout-100ms"]);
+  OLA_ASSERT_EQ(2000u, (*max_time)["timeout-100ms"]);
+
+  OLA_ASSERT_EQ(1u, (*callbacks)["timeout-1000ms"]);
+  OLA_ASSERT_EQ(1u, (*slow_callbacks)["timeout-1000ms"]);
+  OLA_ASSERT_EQ(20000u, (*max_time)["timeout-1000ms"]);
+  OLA_ASSERT_EQ(10000, export_map.GetIntegerVar(
+      LoopProfiler::K_SLOW_THRESHOLD_VAR)->Get());
+}
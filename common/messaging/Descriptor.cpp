@@ -19,6 +19,7 @@
  */
 
 #include <ola/messaging/Descriptor.h>
+#include <ola/messaging/DescriptorLayout.h>
 #include <vector>
 
 namespace ola {
@@ -102,10 +103,21 @@ void FieldDescriptorGroup::PopulateIfRequired() const {
 }
 
 
+Descriptor::~Descriptor() {}
+
+
 void Descriptor::Accept(FieldDescriptorVisitor *visitor) const {
   vector<const FieldDescriptor*>::const_iterator iter = m_fields.begin();
   for (; iter != m_fields.end(); ++iter)
     (*iter)->Accept(visitor);
 }
+
+
+const DescriptorLayout &Descriptor::Layout() const {
+  if (!m_layout.get()) {
+    m_layout.reset(new DescriptorLayout(this));
+  }
+  return *m_layout;
+}
 }  // namespace messaging
 }  // namespace ola
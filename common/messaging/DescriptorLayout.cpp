@@ -0,0 +1,182 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DescriptorLayout.cpp
+ * A flattened form of a Descriptor, used to unpack messages.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/messaging/Descriptor.h>
+#include <ola/messaging/DescriptorLayout.h>
+#include <ola/messaging/DescriptorVisitor.h>
+#include <vector>
+
+namespace ola {
+namespace messaging {
+
+using std::vector;
+
+namespace {
+
+/*
+ * Walks the descriptor and appends an op for each field.
+ */
+class LayoutBuilder: public FieldDescriptorVisitor {
+ public:
+    explicit LayoutBuilder(DescriptorLayout::OpList *ops)
+        : m_ops(ops),
+          m_fixed_size(0) {
+    }
+
+    bool Descend() const { return true; }
+
+    void Visit(const BoolFieldDescriptor *descriptor) {
+      AddOp(DescriptorLayout::BOOL, descriptor);
+    }
+
+    void Visit(const IPV4FieldDescriptor *descriptor) {
+      AddOp(DescriptorLayout::IPV4, descriptor);
+    }
+
+    void Visit(const MACFieldDescriptor *descriptor) {
+      AddOp(DescriptorLayout::MAC, descriptor);
+    }
+
+    void Visit(const UIDFieldDescriptor *descriptor) {
+      AddOp(DescriptorLayout::UID, descriptor);
+    }
+
+    void Visit(const StringFieldDescriptor *descriptor) {
+      DescriptorLayout::Op &op = AddOp(DescriptorLayout::STRING, descriptor);
+      if (!descriptor->FixedSize()) {
+        op.size = 0;
+        op.variable = m_groups.empty();
+        if (op.variable) {
+          m_variable_strings.push_back(descriptor);
+        }
+      }
+    }
+
+    void Visit(const UInt8FieldDescriptor *descriptor) {
+      AddIntOp(DescriptorLayout::UINT8, descriptor);
+    }
+
+    void Visit(const UInt16FieldDescriptor *descriptor) {
+      AddIntOp(DescriptorLayout::UINT16, descriptor);
+    }
+
+    void Visit(const UInt32FieldDescriptor *descriptor) {
+      AddIntOp(DescriptorLayout::UINT32, descriptor);
+    }
+
+    void Visit(const Int8FieldDescriptor *descriptor) {
+      AddIntOp(DescriptorLayout::INT8, descriptor);
+    }
+
+    void Visit(const Int16FieldDescriptor *descriptor) {
+      AddIntOp(DescriptorLayout::INT16, descriptor);
+    }
+
+    void Visit(const Int32FieldDescriptor *descriptor) {
+      AddIntOp(DescriptorLayout::INT32, descriptor);
+    }
+
+    void Visit(const FieldDescriptorGroup *descriptor) {
+      const bool top_level = m_groups.empty();
+      DescriptorLayout::Op &op = AddOp(DescriptorLayout::GROUP, descriptor);
+      op.blocks = descriptor->MinBlocks();
+      if (!descriptor->FixedSize()) {
+        op.size = 0;
+        op.variable = top_level;
+        if (op.variable) {
+          m_variable_groups.push_back(descriptor);
+        }
+      }
+      m_groups.push_back(m_ops->size() - 1);
+    }
+
+    void PostVisit(const FieldDescriptorGroup*) {
+      (*m_ops)[m_groups.back()].end = m_ops->size();
+      m_groups.pop_back();
+    }
+
+    unsigned int FixedSize() const { return m_fixed_size; }
+
+    const vector<const StringFieldDescriptor*> &VariableStrings() const {
+      return m_variable_strings;
+    }
+
+    const vector<const FieldDescriptorGroup*> &VariableGroups() const {
+      return m_variable_groups;
+    }
+
+ private:
+    DescriptorLayout::OpList *m_ops;
+    unsigned int m_fixed_size;
+    // The index of the op for each group we're within.
+    vector<unsigned int> m_groups;
+    vector<const StringFieldDescriptor*> m_variable_strings;
+    vector<const FieldDescriptorGroup*> m_variable_groups;
+
+    DescriptorLayout::Op &AddOp(DescriptorLayout::OpCode code,
+                                const FieldDescriptor *descriptor) {
+      DescriptorLayout::Op op;
+      op.code = code;
+      op.descriptor = descriptor;
+      op.size = descriptor->MaxSize();
+      op.little_endian = false;
+      op.variable = false;
+      op.blocks = 0;
+      op.end = 0;
+      if (m_groups.empty() && descriptor->FixedSize()) {
+        m_fixed_size += op.size;
+      }
+      m_ops->push_back(op);
+      return m_ops->back();
+    }
+
+    template <typename int_type>
+    void AddIntOp(DescriptorLayout::OpCode code,
+                  const IntegerFieldDescriptor<int_type> *descriptor) {
+      AddOp(code, descriptor).little_endian = descriptor->IsLittleEndian();
+    }
+};
+}  // namespace
+
+
+DescriptorLayout::DescriptorLayout(const Descriptor *descriptor)
+    : m_fixed_size(0),
+      m_variable_type(NO_VARIABLE_FIELD),
+      m_variable_string(NULL),
+      m_variable_group(NULL) {
+  LayoutBuilder builder(&m_ops);
+  descriptor->Accept(&builder);
+  m_fixed_size = builder.FixedSize();
+
+  const unsigned int variable_fields = (builder.VariableStrings().size() +
+                                        builder.VariableGroups().size());
+  if (variable_fields > 1) {
+    m_variable_type = MULTIPLE_VARIABLE_FIELDS;
+  } else if (!builder.VariableStrings().empty()) {
+    m_variable_type = VARIABLE_STRING;
+    m_variable_string = builder.VariableStrings()[0];
+  } else if (!builder.VariableGroups().empty()) {
+    m_variable_group = builder.VariableGroups()[0];
+    m_variable_type = m_variable_group->FixedBlockSize() ?
+        VARIABLE_GROUP : NESTED_VARIABLE_GROUP;
+  }
+}
+}  // namespace messaging
+}  // namespace ola
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "ola/messaging/Descriptor.h"
+#include "ola/messaging/DescriptorLayout.h"
 #include "ola/testing/TestUtils.h"
 
 
@@ -31,6 +32,8 @@ using std::vector;
 
 
 using ola::messaging::BoolFieldDescriptor;
+using ola::messaging::Descriptor;
+using ola::messaging::DescriptorLayout;
 using ola::messaging::FieldDescriptor;
 using ola::messaging::FieldDescriptorGroup;
 using ola::messaging::IPV4FieldDescriptor;
@@ -45,6 +48,7 @@ class DescriptorTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testFieldDescriptors);
   CPPUNIT_TEST(testFieldDescriptorGroup);
   CPPUNIT_TEST(testIntervalsAndLabels);
+  CPPUNIT_TEST(testLayout);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -52,6 +56,7 @@ class DescriptorTest: public CppUnit::TestFixture {
     void testFieldDescriptors();
     void testFieldDescriptorGroup();
     void testIntervalsAndLabels();
+    void testLayout();
 };
 
 
@@ -347,3 +352,66 @@ void DescriptorTest::testIntervalsAndLabels() {
   OLA_ASSERT_TRUE(uint16_descriptor2.IsValid(255));
   OLA_ASSERT_TRUE(uint16_descriptor2.IsValid(65535));
 }
+
+
+/**
+ * Check the layout is built correctly
+ */
+void DescriptorTest::testLayout() {
+  // A fixed group, followed by a variable string
+  vector<const FieldDescriptor*> group_fields;
+  group_fields.push_back(new BoolFieldDescriptor("bool"));
+  group_fields.push_back(new UInt16FieldDescriptor("uint16", true));
+
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new UInt8FieldDescriptor("uint8"));
+  fields.push_back(new FieldDescriptorGroup("group", group_fields, 2, 2));
+  fields.push_back(new StringFieldDescriptor("string", 0, 32));
+  Descriptor descriptor("test", fields);
+
+  const DescriptorLayout &layout = descriptor.Layout();
+  OLA_ASSERT_EQ(&layout, &descriptor.Layout());
+  OLA_ASSERT_EQ(7u, layout.FixedSize());
+  OLA_ASSERT_EQ(DescriptorLayout::VARIABLE_STRING, layout.VariableType());
+  OLA_ASSERT_EQ(fields[2], static_cast<const FieldDescriptor*>(
+      layout.VariableString()));
+
+  const DescriptorLayout::OpList &ops = layout.Ops();
+  OLA_ASSERT_EQ(static_cast<size_t>(5), ops.size());
+  OLA_ASSERT_EQ(DescriptorLayout::UINT8, ops[0].code);
+  OLA_ASSERT_EQ(DescriptorLayout::GROUP, ops[1].code);
+  OLA_ASSERT_EQ(2u, ops[1].blocks);
+  OLA_ASSERT_EQ(4u, ops[1].end);
+  OLA_ASSERT_FALSE(ops[1].variable);
+  OLA_ASSERT_EQ(DescriptorLayout::BOOL, ops[2].code);
+  OLA_ASSERT_EQ(DescriptorLayout::UINT16, ops[3].code);
+  OLA_ASSERT_TRUE(ops[3].little_endian);
+  OLA_ASSERT_EQ(2u, ops[3].size);
+  OLA_ASSERT_EQ(DescriptorLayout::STRING, ops[4].code);
+  OLA_ASSERT_TRUE(ops[4].variable);
+
+  // Two variable fields
+  vector<const FieldDescriptor*> repeated_fields;
+  repeated_fields.push_back(new BoolFieldDescriptor("bool"));
+  vector<const FieldDescriptor*> multiple_fields;
+  multiple_fields.push_back(new StringFieldDescriptor("string", 0, 32));
+  multiple_fields.push_back(
+      new FieldDescriptorGroup("group", repeated_fields, 0, 3));
+  Descriptor multiple_descriptor("multiple", multiple_fields);
+  OLA_ASSERT_EQ(DescriptorLayout::MULTIPLE_VARIABLE_FIELDS,
+                multiple_descriptor.Layout().VariableType());
+  OLA_ASSERT_EQ(0u, multiple_descriptor.Layout().FixedSize());
+
+  // A variable group within a variable group
+  vector<const FieldDescriptor*> inner_fields;
+  inner_fields.push_back(new BoolFieldDescriptor("bool"));
+  vector<const FieldDescriptor*> outer_fields;
+  outer_fields.push_back(
+      new FieldDescriptorGroup("inner", inner_fields, 0, 3));
+  vector<const FieldDescriptor*> nested_fields;
+  nested_fields.push_back(
+      new FieldDescriptorGroup("outer", outer_fields, 0, 3));
+  Descriptor nested_descriptor("nested", nested_fields);
+  OLA_ASSERT_EQ(DescriptorLayout::NESTED_VARIABLE_GROUP,
+                nested_descriptor.Layout().VariableType());
+}
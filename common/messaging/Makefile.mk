@@ -2,6 +2,7 @@
 ##################################################
 common_libolacommon_la_SOURCES += \
     common/messaging/Descriptor.cpp \
+    common/messaging/DescriptorLayout.cpp \
     common/messaging/Message.cpp \
     common/messaging/MessagePrinter.cpp \
     common/messaging/SchemaPrinter.cpp
@@ -17,35 +17,60 @@
  * Copyright (C) 2012 Simon Newton
  */
 
+
 #include <ola/Callback.h>
 #include <ola/Logging.h>
 #include <ola/io/SelectServerInterface.h>
 #include <ola/network/AdvancedTCPConnector.h>
 #include <ola/network/TCPConnector.h>
 
+#include <algorithm>
 
 namespace ola {
 namespace network {
 
 using std::pair;
 
+namespace {
+/*
+ * Compare a ConnectionInfo with a key, used to search the ConnectionTable.
+ */
+struct KeyLessThan {
+  template <typename Entry, typename Key>
+  bool operator()(const Entry &entry, const Key &key) const {
+    return entry.key < key;
+  }
+};
+}  // namespace
+
 AdvancedTCPConnector::AdvancedTCPConnector(
     ola::io::SelectServerInterface *ss,
     TCPSocketFactoryInterface *socket_factory,
-    const ola::TimeInterval &connection_timeout)
+    const ola::TimeInterval &connection_timeout,
+    unsigned int max_concurrent_connects)
     : m_socket_factory(socket_factory),
       m_ss(ss),
       m_connector(ss),
-      m_connection_timeout(connection_timeout) {
+      m_connection_timeout(connection_timeout),
+      m_max_concurrent_connects(max_concurrent_connects),
+      m_retry_timeout(ola::thread::INVALID_TIMEOUT),
+      m_connects_in_progress(0) {
 }
 
 AdvancedTCPConnector::~AdvancedTCPConnector() {
-  ConnectionMap::iterator iter = m_connections.begin();
+  // Make sure aborting one connect doesn't start a queued one.
+  m_connect_queue.clear();
+
+  ConnectionTable::iterator iter = m_connections.begin();
   for (; iter != m_connections.end(); ++iter) {
-    AbortConnection(iter->second);
-    delete iter->second;
+    AbortConnection(&(*iter));
   }
   m_connections.clear();
+  m_retries.clear();
+
+  if (m_retry_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_retry_timeout);
+  }
 }
 
 
@@ -53,34 +78,41 @@ void AdvancedTCPConnector::AddEndpoint(const IPV4SocketAddress &endpoint,
                                        BackOffPolicy *backoff_policy,
                                        bool paused) {
   IPPortPair key(endpoint.Host(), endpoint.Port());
-  ConnectionMap::iterator iter = m_connections.find(key);
-  if (iter != m_connections.end())
+  ConnectionTable::iterator iter = std::lower_bound(
+      m_connections.begin(), m_connections.end(), key, KeyLessThan());
+  if (iter != m_connections.end() && iter->key == key)
     return;
 
   // new ip:port
-  ConnectionInfo *state = new ConnectionInfo;
-  state->state = paused ? PAUSED : DISCONNECTED;
-  state->failed_attempts = 0;
-  state->retry_timeout = ola::thread::INVALID_TIMEOUT;
-  state->connection_id = 0;
-  state->policy = backoff_policy;
-  state->reconnect = true;
-
-  m_connections[key] = state;
+  ConnectionInfo state;
+  state.key = key;
+  state.state = paused ? PAUSED : DISCONNECTED;
+  state.failed_attempts = 0;
+  state.connection_id = 0;
+  state.policy = backoff_policy;
+  state.retry_scheduled = false;
+  state.connecting = false;
+  state.queued = false;
+  state.reconnect = true;
+
+  iter = m_connections.insert(iter, state);
 
   if (!paused)
-    AttemptConnection(key, state);
+    AttemptConnection(&(*iter));
 }
 
 void AdvancedTCPConnector::RemoveEndpoint(const IPV4SocketAddress &endpoint) {
   IPPortPair key(endpoint.Host(), endpoint.Port());
-  ConnectionMap::iterator iter = m_connections.find(key);
-  if (iter == m_connections.end())
+  ConnectionInfo *info = Lookup(key);
+  if (!info)
     return;
 
-  AbortConnection(iter->second);
-  delete iter->second;
-  m_connections.erase(iter);
+  AbortConnection(info);
+
+  // Aborting may start a queued connect, which can change the table.
+  ConnectionTable::iterator iter = Find(key);
+  if (iter != m_connections.end())
+    m_connections.erase(iter);
 }
 
 bool AdvancedTCPConnector::GetEndpointState(
@@ -88,79 +120,152 @@ bool AdvancedTCPConnector::GetEndpointState(
     ConnectionState *connected,
     unsigned int *failed_attempts) const {
   IPPortPair key(endpoint.Host(), endpoint.Port());
-  ConnectionMap::const_iterator iter = m_connections.find(key);
+  ConnectionTable::const_iterator iter = Find(key);
   if (iter == m_connections.end())
     return false;
 
-  *connected = iter->second->state;
-  *failed_attempts = iter->second->failed_attempts;
+  *connected = iter->state;
+  *failed_attempts = iter->failed_attempts;
   return true;
 }
 
 void AdvancedTCPConnector::Disconnect(const IPV4SocketAddress &endpoint,
                                       bool pause) {
   IPPortPair key(endpoint.Host(), endpoint.Port());
-  ConnectionMap::iterator iter = m_connections.find(key);
-  if (iter == m_connections.end())
+  ConnectionInfo *info = Lookup(key);
+  if (!info)
     return;
 
-  if (iter->second->state != CONNECTED)
+  if (info->state != CONNECTED)
     return;
 
-  iter->second->failed_attempts = 0;
+  info->failed_attempts = 0;
 
   if (pause) {
-    iter->second->state = PAUSED;
+    info->state = PAUSED;
   } else {
     // schedule a retry as if this endpoint failed once
-    iter->second->state = DISCONNECTED;
-    iter->second->retry_timeout = m_ss->RegisterSingleTimeout(
-        iter->second->policy->BackOffTime(1),
-        ola::NewSingleCallback(
-          this,
-          &AdvancedTCPConnector::RetryTimeout,
-          iter->first));
+    info->state = DISCONNECTED;
+    ScheduleRetry(info, info->policy->BackOffTime(1));
   }
 }
 
 void AdvancedTCPConnector::Resume(const IPV4SocketAddress &endpoint) {
   IPPortPair key(endpoint.Host(), endpoint.Port());
-  ConnectionMap::iterator iter = m_connections.find(key);
-  if (iter == m_connections.end())
+  ConnectionInfo *info = Lookup(key);
+  if (!info)
     return;
 
-  if (iter->second->state == PAUSED) {
-    iter->second->state = DISCONNECTED;
-    AttemptConnection(iter->first, iter->second);
+  if (info->state == PAUSED) {
+    info->state = DISCONNECTED;
+    AttemptConnection(info);
   }
 }
 
+
+AdvancedTCPConnector::ConnectionTable::iterator AdvancedTCPConnector::Find(
+    const IPPortPair &key) {
+  ConnectionTable::iterator iter = std::lower_bound(
+      m_connections.begin(), m_connections.end(), key, KeyLessThan());
+  if (iter != m_connections.end() && iter->key == key)
+    return iter;
+  return m_connections.end();
+}
+
+
+AdvancedTCPConnector::ConnectionTable::const_iterator
+    AdvancedTCPConnector::Find(const IPPortPair &key) const {
+  ConnectionTable::const_iterator iter = std::lower_bound(
+      m_connections.begin(), m_connections.end(), key, KeyLessThan());
+  if (iter != m_connections.end() && iter->key == key)
+    return iter;
+  return m_connections.end();
+}
+
+
+/**
+ * Return the ConnectionInfo for a key, or NULL if it doesn't exist. The
+ * pointer is invalidated when endpoints are added or removed.
+ */
+AdvancedTCPConnector::ConnectionInfo *AdvancedTCPConnector::Lookup(
+    const IPPortPair &key) {
+  ConnectionTable::iterator iter = Find(key);
+  return iter == m_connections.end() ? NULL : &(*iter);
+}
+
+
 /**
  * Schedule the re-try attempt for this connection
  */
-void AdvancedTCPConnector::ScheduleRetry(const IPPortPair &key,
-                                         ConnectionInfo *info) {
-  info->retry_timeout = m_ss->RegisterSingleTimeout(
-      info->policy->BackOffTime(info->failed_attempts),
-      ola::NewSingleCallback(
-        this,
-        &AdvancedTCPConnector::RetryTimeout,
-        key));
+void AdvancedTCPConnector::ScheduleRetry(ConnectionInfo *info,
+                                         const TimeInterval &delay) {
+  CancelRetry(info);
+  info->retry_time = *m_ss->WakeUpTime() + delay;
+  info->retry_scheduled = true;
+  m_retries.insert(Retry(info->retry_time, info->key));
+  UpdateRetryTimeout();
+}
+
+
+/**
+ * Remove the retry for a connection. This leaves the shared timeout as it is,
+ * if it fires early it'll just be re-registered.
+ */
+void AdvancedTCPConnector::CancelRetry(ConnectionInfo *info) {
+  if (info->retry_scheduled) {
+    m_retries.erase(Retry(info->retry_time, info->key));
+    info->retry_scheduled = false;
+  }
 }
 
 
 /**
- * Called when it's time to retry
+ * Make sure the shared timeout fires no later than the earliest retry.
  */
-void AdvancedTCPConnector::RetryTimeout(IPPortPair key) {
-  ConnectionMap::iterator iter = m_connections.find(key);
-  if (iter == m_connections.end()) {
-    OLA_FATAL << "Re-connect timer expired but unable to find state entry for "
-      << key.first << ":" << key.second;
+void AdvancedTCPConnector::UpdateRetryTimeout() {
+  if (m_retries.empty())
     return;
+
+  const TimeStamp &next = m_retries.begin()->first;
+  if (m_retry_timeout != ola::thread::INVALID_TIMEOUT) {
+    if (m_retry_timeout_time <= next)
+      return;
+    m_ss->RemoveTimeout(m_retry_timeout);
+  }
+
+  const TimeStamp &now = *m_ss->WakeUpTime();
+  m_retry_timeout_time = next;
+  m_retry_timeout = m_ss->RegisterSingleTimeout(
+      next > now ? next - now : TimeInterval(0, 0),
+      ola::NewSingleCallback(this, &AdvancedTCPConnector::RetryTimeout));
+}
+
+
+/**
+ * Called when it's time to retry one or more connections.
+ */
+void AdvancedTCPConnector::RetryTimeout() {
+  m_retry_timeout = ola::thread::INVALID_TIMEOUT;
+
+  // Anything due by the time the timeout was scheduled for is run, even if the
+  // wake up time is slightly earlier.
+  const TimeStamp &now = *m_ss->WakeUpTime();
+  const TimeStamp limit = now > m_retry_timeout_time ?
+      now : m_retry_timeout_time;
+  while (!m_retries.empty() && m_retries.begin()->first <= limit) {
+    IPPortPair key = m_retries.begin()->second;
+    m_retries.erase(m_retries.begin());
+
+    ConnectionInfo *info = Lookup(key);
+    if (!info) {
+      OLA_FATAL << "Re-connect timer expired but unable to find state entry "
+                << "for " << key.first << ":" << key.second;
+      continue;
+    }
+    info->retry_scheduled = false;
+    AttemptConnection(info);
   }
-  iter->second->retry_timeout = ola::thread::INVALID_TIMEOUT;
-  AttemptConnection(key, iter->second);
+  UpdateRetryTimeout();
 }
 
 
@@ -168,60 +273,118 @@ void AdvancedTCPConnector::RetryTimeout(IPPortPair key) {
  * Called by the TCPConnector when a connection is ready or it times out.
  */
 void AdvancedTCPConnector::ConnectionResult(IPPortPair key, int fd, int) {
+  m_connects_in_progress--;
+
   if (fd != -1) {
     OLA_INFO << "TCP Connection established to " << key.first << ":" <<
       key.second;
   }
 
-  ConnectionMap::iterator iter = m_connections.find(key);
-  if (iter == m_connections.end()) {
+  ConnectionInfo *info = Lookup(key);
+  if (!info) {
     OLA_FATAL << "Unable to find state for " << key.first << ":" <<
       key.second << ", leaking sockets";
+    StartQueuedConnects();
     return;
   }
-  ConnectionInfo *info = iter->second;
 
   info->connection_id = 0;
+  info->connecting = false;
   if (fd != -1) {
     // ok
     info->state = CONNECTED;
+    // This may add or remove endpoints, so info is no longer valid.
     m_socket_factory->NewTCPSocket(fd);
   } else {
     // error
     info->failed_attempts++;
     if (info->reconnect) {
-      ScheduleRetry(key, info);
+      ScheduleRetry(info, info->policy->BackOffTime(info->failed_attempts));
     }
   }
+  StartQueuedConnects();
+}
+
+
+/**
+ * Connect to this ip:port pair, or queue the connect if there are too many in
+ * progress.
+ */
+void AdvancedTCPConnector::AttemptConnection(ConnectionInfo *info) {
+  if (info->connecting || info->queued)
+    return;
+
+  if (m_max_concurrent_connects &&
+      m_connects_in_progress >= m_max_concurrent_connects) {
+    info->queued = true;
+    m_connect_queue.push_back(info->key);
+    return;
+  }
+  StartConnection(info);
 }
 
 
 /**
  * Initiate a connection to this ip:port pair
  */
-void AdvancedTCPConnector::AttemptConnection(const IPPortPair &key,
-                                             ConnectionInfo *state) {
-  state->connection_id = m_connector.Connect(
+void AdvancedTCPConnector::StartConnection(ConnectionInfo *info) {
+  const IPPortPair key = info->key;
+  info->connecting = true;
+  m_connects_in_progress++;
+
+  TCPConnector::TCPConnectionID connection_id = m_connector.Connect(
       IPV4SocketAddress(key.first, key.second),
       m_connection_timeout,
       ola::NewSingleCallback(this,
                              &AdvancedTCPConnector::ConnectionResult,
                              key));
+  // If the connect completed immediately, ConnectionResult() has already run
+  // and info may no longer be valid.
+  if (connection_id) {
+    info->connection_id = connection_id;
+  }
+}
+
+
+/**
+ * Start queued connects until we reach the limit.
+ */
+void AdvancedTCPConnector::StartQueuedConnects() {
+  while (!m_connect_queue.empty() &&
+         (!m_max_concurrent_connects ||
+          m_connects_in_progress < m_max_concurrent_connects)) {
+    IPPortPair key = m_connect_queue.front();
+    m_connect_queue.pop_front();
+
+    ConnectionInfo *info = Lookup(key);
+    if (info) {
+      info->queued = false;
+      StartConnection(info);
+    }
+  }
 }
 
 
 /**
  * Abort and clean up a pending connection
- * @param state the ConnectionInfo to cleanup.
+ * @param info the ConnectionInfo to cleanup.
  */
-void AdvancedTCPConnector::AbortConnection(ConnectionInfo *state) {
-  if (state->connection_id) {
-    state->reconnect = false;
-    if (!m_connector.Cancel(state->connection_id))
-      OLA_WARN << "Failed to cancel connection " << state->connection_id;
-  }
-  if (state->retry_timeout != ola::thread::INVALID_TIMEOUT)
-    m_ss->RemoveTimeout(state->retry_timeout);
+void AdvancedTCPConnector::AbortConnection(ConnectionInfo *info) {
+  CancelRetry(info);
+
+  if (info->queued) {
+    std::deque<IPPortPair>::iterator iter = std::find(
+        m_connect_queue.begin(), m_connect_queue.end(), info->key);
+    if (iter != m_connect_queue.end())
+      m_connect_queue.erase(iter);
+    info->queued = false;
+  }
+
+  if (info->connecting) {
+    info->reconnect = false;
+    if (!m_connector.Cancel(info->connection_id))
+      OLA_WARN << "Failed to cancel connection " << info->connection_id;
+  }
 }
 }  // namespace network
 }  // namespace ola
@@ -23,6 +23,7 @@
 #include <string.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "ola/Callback.h"
 #include "ola/Clock.h"
@@ -49,6 +50,7 @@ using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
 using std::auto_ptr;
 using std::string;
+using std::vector;
 
 // used to set a timeout which aborts the tests
 static const int CONNECT_TIMEOUT_IN_MS = 500;
@@ -61,6 +63,7 @@ class AdvancedTCPConnectorTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testPause);
   CPPUNIT_TEST(testBackoff);
   CPPUNIT_TEST(testEarlyDestruction);
+  CPPUNIT_TEST(testConcurrencyLimit);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -76,6 +79,7 @@ class AdvancedTCPConnectorTest: public CppUnit::TestFixture {
   void testPause();
   void testBackoff();
   void testEarlyDestruction();
+  void testConcurrencyLimit();
 
   // timing out indicates something went wrong
   void Timeout() {
@@ -95,6 +99,7 @@ class AdvancedTCPConnectorTest: public CppUnit::TestFixture {
   IPV4SocketAddress m_server_address;
   ola::thread::timeout_id m_timeout_id;
   TCPSocket *m_connected_socket;
+  vector<TCPSocket*> m_connected_sockets;
 
   void ConfirmState(const ola::testing::SourceLine &source_line,
                     const AdvancedTCPConnector &connector,
@@ -105,6 +110,7 @@ class AdvancedTCPConnectorTest: public CppUnit::TestFixture {
   uint16_t ReservePort();
   void AcceptedConnection(TCPSocket *socket);
   void OnConnect(TCPSocket *socket);
+  void CollectSocket(TCPSocket *socket);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(AdvancedTCPConnectorTest);
@@ -332,6 +338,66 @@ void AdvancedTCPConnectorTest::testEarlyDestruction() {
   }
 }
 
+
+/*
+ * Test that only max_concurrent_connects connects run at once, and the queued
+ * connects are started as the others complete.
+ */
+void AdvancedTCPConnectorTest::testConcurrencyLimit() {
+  ola::network::TCPSocketFactory socket_factory(
+      ola::NewCallback(this, &AdvancedTCPConnectorTest::AcceptedConnection));
+  TCPAcceptingSocket listening_socket1(&socket_factory);
+  SetupListeningSocket(&listening_socket1);
+  const IPV4SocketAddress server1 = m_server_address;
+  TCPAcceptingSocket listening_socket2(&socket_factory);
+  SetupListeningSocket(&listening_socket2);
+  const IPV4SocketAddress server2 = m_server_address;
+
+  ola::network::TCPSocketFactory collecting_factory(
+      ola::NewCallback(this, &AdvancedTCPConnectorTest::CollectSocket));
+  AdvancedTCPConnector connector(
+      m_ss,
+      &collecting_factory,
+      TimeInterval(0, CONNECT_TIMEOUT_IN_MS * 1000),
+      1);
+
+  LinearBackoffPolicy policy(TimeInterval(5, 0), TimeInterval(30, 0));
+  connector.AddEndpoint(server1, &policy);
+  connector.AddEndpoint(server2, &policy);
+  OLA_ASSERT_EQ(2u, connector.EndpointCount());
+
+  // Connects may complete immediately depending on the platform, but there is
+  // never more than one in progress, and the second only waits behind the
+  // first.
+  OLA_ASSERT_TRUE(connector.ConnectsInProgress() <= 1);
+  OLA_ASSERT_TRUE(connector.QueuedConnects() <= connector.ConnectsInProgress());
+
+  if (m_connected_sockets.size() < 2) {
+    m_ss->Run();
+  }
+
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_connected_sockets.size());
+  OLA_ASSERT_EQ(0u, connector.ConnectsInProgress());
+  OLA_ASSERT_EQ(0u, connector.QueuedConnects());
+  ConfirmState(OLA_SOURCELINE(), connector, server1,
+               AdvancedTCPConnector::CONNECTED, 0);
+  ConfirmState(OLA_SOURCELINE(), connector, server2,
+               AdvancedTCPConnector::CONNECTED, 0);
+
+  vector<TCPSocket*>::iterator iter = m_connected_sockets.begin();
+  for (; iter != m_connected_sockets.end(); ++iter) {
+    (*iter)->Close();
+    delete *iter;
+  }
+  m_connected_sockets.clear();
+
+  connector.RemoveEndpoint(server1);
+  connector.RemoveEndpoint(server2);
+  OLA_ASSERT_EQ(0u, connector.EndpointCount());
+  m_ss->RemoveReadDescriptor(&listening_socket1);
+  m_ss->RemoveReadDescriptor(&listening_socket2);
+}
+
 /**
  * Confirm the state & failed attempts matches what we expected
  */
@@ -421,3 +487,15 @@ void AdvancedTCPConnectorTest::OnConnect(TCPSocket *socket) {
   m_connected_socket = socket;
   m_ss->Terminate();
 }
+
+
+/*
+ * Called when a connection completes, terminates once there are two.
+ */
+void AdvancedTCPConnectorTest::CollectSocket(TCPSocket *socket) {
+  OLA_ASSERT_NOT_NULL(socket);
+  m_connected_sockets.push_back(socket);
+  if (m_connected_sockets.size() == 2) {
+    m_ss->Terminate();
+  }
+}
@@ -0,0 +1,112 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IPV6Address.cpp
+ * A IPV6 address
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#ifdef HAVE_WINSOCK2_H
+#include <ola/win/CleanWinSock2.h>
+#include <ws2tcpip.h>
+#endif  // HAVE_WINSOCK2_H
+
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>  // Required by FreeBSD
+#endif  // HAVE_SYS_SOCKET_H
+#ifdef HAVE_ARPA_INET_H
+#include <arpa/inet.h>
+#endif  // HAVE_ARPA_INET_H
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>  // Required by FreeBSD
+#endif  // HAVE_NETINET_IN_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/network/IPV6Address.h"
+
+namespace ola {
+namespace network {
+
+using std::string;
+
+namespace {
+bool IPV6StringToAddress(const string &address, uint8_t *addr) {
+  if (address.empty()) {
+    // Don't bother trying to extract an address if we weren't given one
+    return false;
+  }
+
+  struct in6_addr in6;
+  if (inet_pton(AF_INET6, address.c_str(), &in6) != 1) {
+    OLA_WARN << "Could not convert address " << address;
+    return false;
+  }
+  memcpy(addr, in6.s6_addr, IPV6Address::LENGTH);
+  return true;
+}
+}  // namespace
+
+bool IPV6Address::IsWildcard() const {
+  return *this == WildCard();
+}
+
+string IPV6Address::ToString() const {
+  struct in6_addr in6;
+  memcpy(in6.s6_addr, m_address, LENGTH);
+  char str[INET6_ADDRSTRLEN];
+  if (inet_ntop(AF_INET6, &in6, str, INET6_ADDRSTRLEN) == NULL) {
+    OLA_WARN << "Failed to convert IPv6 address to a string";
+    return "";
+  }
+  return str;
+}
+
+bool IPV6Address::FromString(const string &address, IPV6Address *target) {
+  uint8_t addr[LENGTH];
+  if (!IPV6StringToAddress(address, addr)) {
+    return false;
+  }
+  *target = IPV6Address(addr);
+  return true;
+}
+
+IPV6Address IPV6Address::FromStringOrDie(const string &address) {
+  IPV6Address target;
+  bool ok = FromString(address, &target);
+  assert(ok);
+  (void) ok;
+  return target;
+}
+
+IPV6Address IPV6Address::WildCard() {
+  return IPV6Address();
+}
+
+IPV6Address IPV6Address::Loopback() {
+  uint8_t addr[LENGTH];
+  memset(addr, 0, LENGTH);
+  addr[LENGTH - 1] = 1;
+  return IPV6Address(addr);
+}
+}  // namespace network
+}  // namespace ola
@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * IPV6AddressTest.cpp
+ * Test fixture for the IPV6Address class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ola/network/IPV6Address.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::network::IPV6Address;
+using std::string;
+using std::vector;
+
+class IPV6AddressTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(IPV6AddressTest);
+  CPPUNIT_TEST(testIPV6Address);
+  CPPUNIT_TEST(testWildcardAndLoopback);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testIPV6Address();
+    void testWildcardAndLoopback();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IPV6AddressTest);
+
+
+/*
+ * Test the IPV6 Address class works
+ */
+void IPV6AddressTest::testIPV6Address() {
+  IPV6Address wildcard_address;
+  OLA_ASSERT_EQ(string("::"), wildcard_address.ToString());
+  OLA_ASSERT_TRUE(wildcard_address.IsWildcard());
+  OLA_ASSERT_FALSE(wildcard_address.IsMulticast());
+
+  const uint8_t raw[] = {0xff, 0x18, 0, 0, 0, 0, 0, 0,
+                         0, 0, 0, 0, 0x83, 0, 0, 1};
+  IPV6Address address1(raw);
+  OLA_ASSERT_NE(wildcard_address, address1);
+  OLA_ASSERT_FALSE(address1.IsWildcard());
+  OLA_ASSERT_TRUE(address1.IsMulticast());
+
+  // Test Get()
+  uint8_t addr[IPV6Address::LENGTH];
+  address1.Get(addr);
+  OLA_ASSERT_EQ(0, memcmp(addr, raw, sizeof(raw)));
+
+  // test copy and assignment
+  IPV6Address address2(address1);
+  OLA_ASSERT_EQ(address1, address2);
+  IPV6Address address3 = address1;
+  OLA_ASSERT_EQ(address1, address3);
+
+  // test stringification
+  OLA_ASSERT_EQ(string("ff18::8300:1"), address1.ToString());
+  std::ostringstream str;
+  str << address1;
+  OLA_ASSERT_EQ(string("ff18::8300:1"), str.str());
+
+  // test from string
+  IPV6Address string_address;
+  OLA_ASSERT_TRUE(IPV6Address::FromString("ff18::8300:1", &string_address));
+  OLA_ASSERT_EQ(address1, string_address);
+  OLA_ASSERT_EQ(IPV6Address::FromStringOrDie("fe80::1"),
+                IPV6Address::FromStringOrDie("fe80:0:0:0:0:0:0:1"));
+
+  IPV6Address string_address2;
+  OLA_ASSERT_FALSE(IPV6Address::FromString("", &string_address2));
+  OLA_ASSERT_FALSE(IPV6Address::FromString("foo", &string_address2));
+  OLA_ASSERT_FALSE(IPV6Address::FromString("192.168.1.1",
+                                           &string_address2));
+
+  // make sure sorting works
+  vector<IPV6Address> addresses;
+  addresses.push_back(address1);
+  addresses.push_back(IPV6Address::FromStringOrDie("fe80::1"));
+  addresses.push_back(IPV6Address::FromStringOrDie("2001:db8::1"));
+  std::sort(addresses.begin(), addresses.end());
+  OLA_ASSERT_EQ(string("2001:db8::1"), addresses[0].ToString());
+  OLA_ASSERT_EQ(string("fe80::1"), addresses[1].ToString());
+  OLA_ASSERT_EQ(string("ff18::8300:1"), addresses[2].ToString());
+  OLA_ASSERT_TRUE(addresses[0] < addresses[1]);
+  OLA_ASSERT_TRUE(addresses[2] > addresses[1]);
+}
+
+
+/*
+ * Test the wildcard and loopback addresses
+ */
+void IPV6AddressTest::testWildcardAndLoopback() {
+  OLA_ASSERT_TRUE(IPV6Address::WildCard().IsWildcard());
+  OLA_ASSERT_EQ(string("::"), IPV6Address::WildCard().ToString());
+
+  IPV6Address loopback = IPV6Address::Loopback();
+  OLA_ASSERT_FALSE(loopback.IsWildcard());
+  OLA_ASSERT_EQ(string("::1"), loopback.ToString());
+  OLA_ASSERT_EQ(IPV6Address::FromStringOrDie("::1"), loopback);
+}
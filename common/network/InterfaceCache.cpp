@@ -0,0 +1,207 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InterfaceCache.cpp
+ * A process wide cache of the network interfaces.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include "ola/network/InterfaceCache.h"
+
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+#define USE_NETLINK_FOR_NOTIFICATIONS 1
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+
+namespace ola {
+namespace network {
+
+using ola::thread::MutexLocker;
+using std::vector;
+
+namespace {
+
+/*
+ * An InterfacePicker that reads from an InterfaceCache.
+ */
+class CachedInterfacePicker: public InterfacePicker {
+ public:
+  explicit CachedInterfacePicker(InterfaceCache *cache)
+      : InterfacePicker(),
+        m_cache(cache) {
+  }
+
+  vector<Interface> GetInterfaces(bool include_loopback) const {
+    return m_cache->GetInterfaces(include_loopback);
+  }
+
+ private:
+  InterfaceCache *m_cache;
+};
+}  // namespace
+
+InterfaceCache *InterfaceCache::s_installed = NULL;
+
+InterfaceCache::InterfaceCache(InterfacePicker *picker)
+    : m_picker(picker ? picker : InterfacePicker::NewSystemPicker()),
+      m_ss(NULL),
+      m_valid(false),
+      m_enumeration_count(0) {
+}
+
+InterfaceCache::~InterfaceCache() {
+  if (s_installed == this) {
+    s_installed = NULL;
+  }
+
+  if (m_netlink_descriptor.get()) {
+    m_ss->RemoveReadDescriptor(m_netlink_descriptor.get());
+#ifdef USE_NETLINK_FOR_NOTIFICATIONS
+    close(m_netlink_descriptor->ReadDescriptor());
+#endif  // USE_NETLINK_FOR_NOTIFICATIONS
+  }
+}
+
+vector<Interface> InterfaceCache::GetInterfaces(bool include_loopback) {
+  MutexLocker locker(&m_mutex);
+  if (!m_valid) {
+    m_interfaces = m_picker->GetInterfaces(true);
+    m_valid = true;
+    m_enumeration_count++;
+    OLA_DEBUG << "Found " << m_interfaces.size() << " interfaces";
+  }
+
+  if (include_loopback) {
+    return m_interfaces;
+  }
+
+  vector<Interface> interfaces;
+  vector<Interface>::const_iterator iter = m_interfaces.begin();
+  for (; iter != m_interfaces.end(); ++iter) {
+    if (!iter->loopback) {
+      interfaces.push_back(*iter);
+    }
+  }
+  return interfaces;
+}
+
+void InterfaceCache::Invalidate() {
+  MutexLocker locker(&m_mutex);
+  m_valid = false;
+}
+
+bool InterfaceCache::Watch(ola::io::SelectServerInterface *ss) {
+  if (m_netlink_descriptor.get()) {
+    return true;
+  }
+
+#ifdef USE_NETLINK_FOR_NOTIFICATIONS
+  int sd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+  if (sd < 0) {
+    OLA_WARN << "Could not create netlink socket: " << strerror(errno);
+    return false;
+  }
+
+  struct sockaddr_nl address;
+  memset(&address, 0, sizeof(address));
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+  if (bind(sd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) < 0) {
+    OLA_WARN << "Could not bind netlink socket: " << strerror(errno);
+    close(sd);
+    return false;
+  }
+
+  m_netlink_descriptor.reset(new ola::io::UnmanagedFileDescriptor(sd));
+  m_netlink_descriptor->SetOnData(
+      NewCallback(this, &InterfaceCache::ReceiveNotifications));
+  m_ss = ss;
+  m_ss->AddReadDescriptor(m_netlink_descriptor.get());
+  // Anything that changed before now was missed.
+  Invalidate();
+  return true;
+#else
+  OLA_INFO << "Interface change notifications aren't available";
+  (void) ss;
+  return false;
+#endif  // USE_NETLINK_FOR_NOTIFICATIONS
+}
+
+unsigned int InterfaceCache::EnumerationCount() const {
+  MutexLocker locker(&m_mutex);
+  return m_enumeration_count;
+}
+
+InterfacePicker *InterfaceCache::NewPicker() {
+  return new CachedInterfacePicker(this);
+}
+
+void InterfaceCache::Install(InterfaceCache *cache) {
+  s_installed = cache;
+}
+
+InterfaceCache *InterfaceCache::Installed() {
+  return s_installed;
+}
+
+/*
+ * Drain the netlink socket. We only subscribe to the link and address
+ * groups, so any message, or an overrun, means the cache is stale.
+ */
+void InterfaceCache::ReceiveNotifications() {
+#ifdef USE_NETLINK_FOR_NOTIFICATIONS
+  uint8_t buffer[4096];
+  bool changed = false;
+  while (true) {
+    ssize_t r = recv(m_netlink_descriptor->ReadDescriptor(), buffer,
+                     sizeof(buffer), MSG_DONTWAIT);
+    if (r > 0) {
+      changed = true;
+    } else if (r < 0 && errno == EINTR) {
+      continue;
+    } else {
+      if (r < 0 && errno == ENOBUFS) {
+        // We lost some notifications.
+        changed = true;
+      } else if (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        OLA_WARN << "Failed to read from netlink socket: " << strerror(errno);
+      }
+      break;
+    }
+  }
+
+  if (changed) {
+    OLA_DEBUG << "Network interfaces changed";
+    Invalidate();
+  }
+#endif  // USE_NETLINK_FOR_NOTIFICATIONS
+}
+}  // namespace network
+}  // namespace ola
@@ -0,0 +1,157 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InterfaceCacheTest.cpp
+ * Test fixture for the InterfaceCache class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/network/InterfaceCache.h"
+#include "ola/network/InterfacePicker.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::network::IPV4Address;
+using ola::network::Interface;
+using ola::network::InterfaceCache;
+using ola::network::InterfacePicker;
+using ola::network::MACAddress;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+class InterfaceCacheTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(InterfaceCacheTest);
+  CPPUNIT_TEST(testCaching);
+  CPPUNIT_TEST(testInstall);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testCaching();
+    void testInstall();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(InterfaceCacheTest);
+
+namespace {
+
+/*
+ * A picker which counts how many times the interfaces are enumerated.
+ */
+class CountingInterfacePicker: public InterfacePicker {
+ public:
+  CountingInterfacePicker(const vector<Interface> &interfaces,
+                          unsigned int *count)
+      : m_interfaces(interfaces),
+        m_count(count) {
+  }
+
+  vector<Interface> GetInterfaces(bool include_loopback) const {
+    (*m_count)++;
+    vector<Interface> interfaces;
+    vector<Interface>::const_iterator iter = m_interfaces.begin();
+    for (; iter != m_interfaces.end(); ++iter) {
+      if (include_loopback || !iter->loopback) {
+        interfaces.push_back(*iter);
+      }
+    }
+    return interfaces;
+  }
+
+ private:
+  const vector<Interface> m_interfaces;
+  unsigned int *m_count;
+};
+
+vector<Interface> TestInterfaces() {
+  vector<Interface> interfaces;
+  interfaces.push_back(Interface(
+      "lo", IPV4Address::Loopback(), IPV4Address::Loopback(),
+      IPV4Address::FromStringOrDie("255.0.0.0"), MACAddress(), true, 1));
+  interfaces.push_back(Interface(
+      "eth0", IPV4Address::FromStringOrDie("10.0.0.1"),
+      IPV4Address::FromStringOrDie("10.0.0.255"),
+      IPV4Address::FromStringOrDie("255.255.255.0"), MACAddress(), false, 2));
+  return interfaces;
+}
+}  // namespace
+
+
+/*
+ * Check the interfaces are only enumerated once until the cache is
+ * invalidated.
+ */
+void InterfaceCacheTest::testCaching() {
+  unsigned int count = 0;
+  InterfaceCache cache(new CountingInterfacePicker(TestInterfaces(), &count));
+  OLA_ASSERT_EQ(0u, cache.EnumerationCount());
+
+  vector<Interface> interfaces = cache.GetInterfaces(true);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), interfaces.size());
+  OLA_ASSERT_EQ(string("lo"), interfaces[0].name);
+  OLA_ASSERT_EQ(string("eth0"), interfaces[1].name);
+
+  interfaces = cache.GetInterfaces(false);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), interfaces.size());
+  OLA_ASSERT_EQ(string("eth0"), interfaces[0].name);
+  OLA_ASSERT_EQ(1u, count);
+  OLA_ASSERT_EQ(1u, cache.EnumerationCount());
+
+  cache.Invalidate();
+  OLA_ASSERT_EQ(1u, count);
+  interfaces = cache.GetInterfaces(false);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), interfaces.size());
+  cache.GetInterfaces(true);
+  OLA_ASSERT_EQ(2u, count);
+  OLA_ASSERT_EQ(2u, cache.EnumerationCount());
+}
+
+
+/*
+ * Check NewPicker reads from the installed cache.
+ */
+void InterfaceCacheTest::testInstall() {
+  unsigned int count = 0;
+  OLA_ASSERT_NULL(InterfaceCache::Installed());
+  {
+    InterfaceCache cache(new CountingInterfacePicker(TestInterfaces(),
+                                                     &count));
+    InterfaceCache::Install(&cache);
+    OLA_ASSERT_EQ(&cache, InterfaceCache::Installed());
+
+    auto_ptr<InterfacePicker> picker1(InterfacePicker::NewPicker());
+    auto_ptr<InterfacePicker> picker2(InterfacePicker::NewPicker());
+
+    Interface iface;
+    OLA_ASSERT_TRUE(picker1->ChooseInterface(&iface, "10.0.0.1"));
+    OLA_ASSERT_EQ(string("eth0"), iface.name);
+    OLA_ASSERT_TRUE(picker2->ChooseInterface(&iface, 2));
+    OLA_ASSERT_EQ(string("eth0"), iface.name);
+
+    InterfacePicker::Options options;
+    options.include_loopback = true;
+    options.specific_only = true;
+    OLA_ASSERT_TRUE(picker2->ChooseInterface(&iface, "lo", options));
+    OLA_ASSERT_EQ(string("lo"), iface.name);
+    OLA_ASSERT_EQ(1u, count);
+  }
+  // The cache removes itself when it's destroyed.
+  OLA_ASSERT_NULL(InterfaceCache::Installed());
+}
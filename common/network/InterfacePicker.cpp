@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/network/InterfaceCache.h"
 #include "ola/network/InterfacePicker.h"
 #include "ola/network/NetworkUtils.h"
 
@@ -137,9 +138,22 @@ bool InterfacePicker::ChooseInterface(
 
 
 /*
- * Create the appropriate picker
+ * Create the appropriate picker, this reads from the installed cache if
+ * there is one.
  */
 InterfacePicker *InterfacePicker::NewPicker() {
+  InterfaceCache *cache = InterfaceCache::Installed();
+  if (cache) {
+    return cache->NewPicker();
+  }
+  return NewSystemPicker();
+}
+
+
+/*
+ * Create the picker for this platform
+ */
+InterfacePicker *InterfacePicker::NewSystemPicker() {
 #ifdef _WIN32
   return new WindowsInterfacePicker();
 #else
@@ -5,18 +5,26 @@ common_libolacommon_la_SOURCES += \
     common/network/FakeInterfacePicker.h \
     common/network/HealthCheckedConnection.cpp \
     common/network/IPV4Address.cpp \
+    common/network/IPV6Address.cpp \
     common/network/Interface.cpp \
+    common/network/InterfaceCache.cpp \
     common/network/InterfacePicker.cpp \
     common/network/MACAddress.cpp \
     common/network/NetworkUtils.cpp \
     common/network/NetworkUtilsInternal.h \
+    common/network/ReusePortGroup.cpp \
     common/network/Socket.cpp \
     common/network/SocketAddress.cpp \
     common/network/SocketCloser.cpp \
     common/network/SocketHelper.cpp \
     common/network/SocketHelper.h \
     common/network/TCPConnector.cpp \
-    common/network/TCPSocket.cpp
+    common/network/TCPSocket.cpp \
+    common/network/UDPNode.cpp \
+    common/network/UDPNode.h \
+    common/network/UDPReceiveStats.cpp \
+    common/network/UnixDomainSocket.cpp \
+    common/network/XDPReceiver.cpp
 
 common_libolacommon_la_LIBADD += $(RESOLV_LIBS)
 
@@ -44,12 +52,16 @@ common_network_HealthCheckedConnectionTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_network_NetworkTester_SOURCES = \
     common/network/IPV4AddressTest.cpp \
+    common/network/IPV6AddressTest.cpp \
+    common/network/InterfaceCacheTest.cpp \
     common/network/InterfacePickerTest.cpp \
     common/network/InterfaceTest.cpp \
     common/network/MACAddressTest.cpp \
     common/network/NetworkUtilsTest.cpp \
     common/network/SocketAddressTest.cpp \
-    common/network/SocketTest.cpp
+    common/network/SocketTest.cpp \
+    common/network/UDPNodeTest.cpp \
+    common/network/XDPReceiverTest.cpp
 common_network_NetworkTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_network_NetworkTester_LDADD = $(COMMON_TESTING_LIBS)
 
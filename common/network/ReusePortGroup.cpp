@@ -0,0 +1,160 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ReusePortGroup.cpp
+ * A group of UDP sockets sharing a port with SO_REUSEPORT.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/network/ReusePortGroup.h"
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif  // HAVE_SYS_SOCKET_H
+
+#ifdef HAVE_LINUX_FILTER_H
+#include <linux/filter.h>
+#endif  // HAVE_LINUX_FILTER_H
+
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/base/Array.h"
+#include "ola/io/Descriptor.h"
+
+namespace ola {
+namespace network {
+
+#if HAVE_DECL_SO_ATTACH_REUSEPORT_CBPF && defined(HAVE_LINUX_FILTER_H)
+#define OLA_HAVE_REUSEPORT_CBPF 1
+#endif  // HAVE_DECL_SO_ATTACH_REUSEPORT_CBPF && HAVE_LINUX_FILTER_H
+
+ReusePortGroup::ReusePortGroup(unsigned int size)
+    : m_sockets(size, static_cast<UDPSocket*>(NULL)) {
+}
+
+ReusePortGroup::~ReusePortGroup() {
+  CloseSockets();
+}
+
+bool ReusePortGroup::Bind(const IPV4SocketAddress &endpoint,
+                          const Options &options) {
+#if !HAVE_DECL_SO_REUSEPORT
+  if (m_sockets.size() > 1) {
+    OLA_WARN << "SO_REUSEPORT isn't supported on this platform";
+    return false;
+  }
+#endif  // !HAVE_DECL_SO_REUSEPORT
+
+  CloseSockets();
+  IPV4SocketAddress bind_address = endpoint;
+  for (unsigned int i = 0; i < m_sockets.size(); i++) {
+    UDPSocket *socket = new UDPSocket();
+    m_sockets[i] = socket;
+    if (!socket->Init() || !socket->Bind(bind_address)) {
+      CloseSockets();
+      return false;
+    }
+
+    if (i == 0 && bind_address.Port() == 0) {
+      if (!socket->GetSocketAddress(&bind_address)) {
+        CloseSockets();
+        return false;
+      }
+    }
+  }
+
+  if (options.steering != STEER_BY_KERNEL_HASH && !m_sockets.empty() &&
+      !AttachSteeringProgram(options)) {
+    OLA_WARN << "Failed to attach the steering program for "
+             << bind_address << ", using the kernel hash";
+  }
+  return true;
+}
+
+void ReusePortGroup::CloseSockets() {
+  std::vector<UDPSocket*>::iterator iter = m_sockets.begin();
+  for (; iter != m_sockets.end(); ++iter) {
+    if (*iter) {
+      (*iter)->Close();
+      delete *iter;
+      *iter = NULL;
+    }
+  }
+}
+
+/*
+ * Attach a classic BPF program which returns the index of the socket. The
+ * kernel runs the program with the UDP header already pulled, so offsets are
+ * relative to the start of the payload.
+ */
+bool ReusePortGroup::AttachSteeringProgram(const Options &options) {
+#ifdef OLA_HAVE_REUSEPORT_CBPF
+  struct sock_filter load;
+  memset(&load, 0, sizeof(load));
+  if (options.steering == STEER_BY_SOURCE_ADDRESS) {
+    load.code = BPF_LD | BPF_W | BPF_ABS;
+    load.k = SKF_NET_OFF + 12;
+  } else {
+    switch (options.payload_width) {
+      case 1:
+        load.code = BPF_LD | BPF_B | BPF_ABS;
+        break;
+      case 2:
+        load.code = BPF_LD | BPF_H | BPF_ABS;
+        break;
+      case 4:
+        load.code = BPF_LD | BPF_W | BPF_ABS;
+        break;
+      default:
+        OLA_WARN << "Invalid payload width " << options.payload_width;
+        return false;
+    }
+    load.k = options.payload_offset;
+  }
+
+  struct sock_filter code[] = {
+    load,
+    BPF_STMT(BPF_ALU | BPF_MOD | BPF_K,
+             static_cast<uint32_t>(m_sockets.size())),
+    BPF_STMT(BPF_RET | BPF_A, 0),
+  };
+  struct sock_fprog program;
+  program.len = arraysize(code);
+  program.filter = code;
+
+  int fd = ola::io::ToFD(m_sockets[0]->ReadDescriptor());
+  if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program,
+                 sizeof(program))) {
+    OLA_WARN << "Failed to set SO_ATTACH_REUSEPORT_CBPF: " << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  (void) options;
+  OLA_WARN << "Steering programs aren't supported on this platform";
+  return false;
+#endif  // OLA_HAVE_REUSEPORT_CBPF
+}
+}  // namespace network
+}  // namespace ola
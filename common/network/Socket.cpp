@@ -48,7 +48,9 @@
 #include <netinet/in.h>
 #endif  // HAVE_NETINET_IN_H
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "common/network/SocketHelper.h"
 #include "ola/Logging.h"
@@ -61,31 +63,136 @@ namespace network {
 namespace {
 
 bool ReceiveFrom(int fd, uint8_t *buffer, ssize_t *data_read,
-                 struct sockaddr_in *source, socklen_t *src_size) {
+                 struct sockaddr *source, socklen_t *src_size,
+                 int flags = 0, bool *would_block = NULL) {
   *data_read = recvfrom(
     fd, reinterpret_cast<char*>(buffer), *data_read,
-    0, reinterpret_cast<struct sockaddr*>(source), source ? src_size : NULL);
+    flags, source, source ? src_size : NULL);
   if (*data_read < 0) {
 #ifdef _WIN32
+    (void) would_block;
     OLA_WARN << "recvfrom fd: " << fd << " failed: " << WSAGetLastError();
 #else
-    OLA_WARN << "recvfrom fd: " << fd << " failed: " << strerror(errno);
+    if (would_block && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      *would_block = true;
+    } else {
+      OLA_WARN << "recvfrom fd: " << fd << " failed: " << strerror(errno);
+    }
 #endif  // _WIN32
     return false;
   }
   return true;
 }
 
+socklen_t SockAddrLength(const SocketAddress &address) {
+  return address.Family() == AF_INET6 ? sizeof(struct sockaddr_in6) :
+                                        sizeof(struct sockaddr_in);
+}
+
 }  // namespace
 
+// DatagramBatch
+// ------------------------------------------------
+
+const char DatagramBatch::K_RECV_BATCH_SIZE_VAR[] = "udp-recv-batch-size";
+
+DatagramBatch::DatagramBatch(unsigned int capacity,
+                             unsigned int datagram_size)
+    : m_capacity(std::max(capacity, 1u)),
+      m_datagram_size(datagram_size),
+      m_size(0),
+      m_buffer(m_capacity * datagram_size),
+      m_lengths(m_capacity),
+      m_sources(m_capacity) {
+}
+
+bool DatagramBatch::Append(unsigned int length,
+                           const IPV4SocketAddress &source) {
+  if (m_size == m_capacity) {
+    return false;
+  }
+  m_lengths[m_size] = length;
+  m_sources[m_size] = source;
+  m_size++;
+  return true;
+}
+
 // UDPSocket
 // ------------------------------------------------
 
+struct UDPSocket::BatchState {
+  BatchState() : send_depth(0) {}
+
+  struct QueuedDatagram {
+    unsigned int offset;
+    unsigned int size;
+    // v6_destination is used if ipv6 is true, otherwise destination.
+    bool ipv6;
+    IPV4SocketAddress destination;
+    IPV6SocketAddress v6_destination;
+
+    const SocketAddress &Destination() const {
+      if (ipv6) {
+        return v6_destination;
+      }
+      return destination;
+    }
+  };
+
+#ifdef HAVE_RECVMMSG
+  std::vector<struct mmsghdr> recv_headers;
+  std::vector<struct iovec> recv_iovecs;
+  std::vector<struct sockaddr_storage> recv_addresses;
+  // Only used once the receive stats are enabled.
+  std::vector<uint8_t> recv_control;
+#endif  // HAVE_RECVMMSG
+
+  // The nesting depth of BeginSendBatch() calls.
+  unsigned int send_depth;
+  // The data for all the queued datagrams.
+  std::vector<uint8_t> send_data;
+  std::vector<QueuedDatagram> send_queue;
+#ifdef HAVE_SENDMMSG
+  std::vector<struct mmsghdr> send_headers;
+  std::vector<struct iovec> send_iovecs;
+  std::vector<struct sockaddr_storage> send_addresses;
+#endif  // HAVE_SENDMMSG
+};
+
+// The most datagrams we pass to a single sendmmsg() call, this is UIO_MAXIOV
+// on Linux.
+static const unsigned int MAX_SEND_BATCH = 1024;
+
+UDPSocket::~UDPSocket() {
+  Close();
+  delete m_batch_state;
+}
+
 bool UDPSocket::Init() {
+  return CreateSocket(PF_INET);
+}
+
+bool UDPSocket::InitV6() {
+  if (!CreateSocket(PF_INET6))
+    return false;
+
+  m_ipv6 = true;
+  // Don't accept IPv4 mapped addresses, so this can share a port with an
+  // IPv4 socket.
+  int v6_only = 1;
+  if (setsockopt(ola::io::ToFD(m_handle), IPPROTO_IPV6, IPV6_V6ONLY,
+                 reinterpret_cast<char*>(&v6_only), sizeof(v6_only)) < 0) {
+    OLA_WARN << "can't set IPV6_V6ONLY for " << m_handle << ", " <<
+      strerror(errno);
+  }
+  return true;
+}
+
+bool UDPSocket::CreateSocket(int domain) {
   if (m_handle != ola::io::INVALID_DESCRIPTOR)
     return false;
 
-  int sd = socket(PF_INET, SOCK_DGRAM, 0);
+  int sd = socket(domain, SOCK_DGRAM, 0);
 
   if (sd < 0) {
     OLA_WARN << "Could not create socket " << strerror(errno);
@@ -105,11 +212,22 @@ bool UDPSocket::Init() {
 }
 
 bool UDPSocket::Bind(const IPV4SocketAddress &endpoint) {
+  return BindTo(endpoint);
+}
+
+bool UDPSocket::Bind(const IPV6SocketAddress &endpoint) {
+  return BindTo(endpoint);
+}
+
+bool UDPSocket::BindTo(const SocketAddress &endpoint) {
   if (m_handle == ola::io::INVALID_DESCRIPTOR)
     return false;
 
-  struct sockaddr server_address;
-  if (!endpoint.ToSockAddr(&server_address, sizeof(server_address)))
+  struct sockaddr_storage storage;
+  struct sockaddr *server_address =
+      reinterpret_cast<struct sockaddr*>(&storage);
+  const socklen_t address_length = SockAddrLength(endpoint);
+  if (!endpoint.ToSockAddr(server_address, sizeof(storage)))
     return false;
 
   #if HAVE_DECL_SO_REUSEADDR
@@ -143,10 +261,9 @@ bool UDPSocket::Bind(const IPV4SocketAddress &endpoint) {
 
   OLA_DEBUG << "Binding to " << endpoint;
 #ifdef _WIN32
-  if (bind(m_handle.m_handle.m_fd, &server_address, sizeof(server_address))
-      == -1) {
+  if (bind(m_handle.m_handle.m_fd, server_address, address_length) == -1) {
 #else
-  if (bind(m_handle, &server_address, sizeof(server_address)) == -1) {
+  if (bind(m_handle, server_address, address_length) == -1) {
 #endif  // _WIN32
     OLA_WARN << "bind(" << endpoint << "): " << strerror(errno);
     return false;
@@ -179,6 +296,9 @@ bool UDPSocket::Close() {
 #endif  // _WIN32
   m_handle = ola::io::INVALID_DESCRIPTOR;
   m_bound_to_port = false;
+  m_ipv6 = false;
+  delete m_receive_stats;
+  m_receive_stats = NULL;
 #ifdef _WIN32
   if (closesocket(fd)) {
 #else
@@ -200,10 +320,29 @@ ssize_t UDPSocket::SendTo(const uint8_t *buffer,
 ssize_t UDPSocket::SendTo(const uint8_t *buffer,
                           unsigned int size,
                           const IPV4SocketAddress &dest) const {
+  return SendBuffer(buffer, size, dest);
+}
+
+ssize_t UDPSocket::SendTo(const uint8_t *buffer,
+                          unsigned int size,
+                          const IPV6SocketAddress &dest) const {
+  return SendBuffer(buffer, size, dest);
+}
+
+ssize_t UDPSocket::SendBuffer(const uint8_t *buffer,
+                              unsigned int size,
+                              const SocketAddress &dest) const {
   if (!ValidWriteDescriptor())
     return 0;
 
-  struct sockaddr_in destination;
+  if (InSendBatch()) {
+    ola::io::IOVec iov;
+    iov.iov_base = const_cast<uint8_t*>(buffer);
+    iov.iov_len = size;
+    return QueueDatagram(&iov, 1, dest);
+  }
+
+  struct sockaddr_storage destination;
   if (!dest.ToSockAddr(reinterpret_cast<sockaddr*>(&destination),
                        sizeof(destination))) {
     return 0;
@@ -219,7 +358,7 @@ ssize_t UDPSocket::SendTo(const uint8_t *buffer,
     size,
     0,
     reinterpret_cast<const struct sockaddr*>(&destination),
-    sizeof(struct sockaddr));
+    SockAddrLength(dest));
   if (bytes_sent < 0 || static_cast<unsigned int>(bytes_sent) != size)
     OLA_INFO << "sendto failed: " << dest << " : " << strerror(errno);
   return bytes_sent;
@@ -233,10 +372,20 @@ ssize_t UDPSocket::SendTo(ola::io::IOVecInterface *data,
 
 ssize_t UDPSocket::SendTo(ola::io::IOVecInterface *data,
                           const IPV4SocketAddress &dest) const {
+  return SendIOVec(data, dest);
+}
+
+ssize_t UDPSocket::SendTo(ola::io::IOVecInterface *data,
+                          const IPV6SocketAddress &dest) const {
+  return SendIOVec(data, dest);
+}
+
+ssize_t UDPSocket::SendIOVec(ola::io::IOVecInterface *data,
+                             const SocketAddress &dest) const {
   if (!ValidWriteDescriptor())
     return 0;
 
-  struct sockaddr_in destination;
+  struct sockaddr_storage destination;
   if (!dest.ToSockAddr(reinterpret_cast<sockaddr*>(&destination),
                        sizeof(destination))) {
     return 0;
@@ -248,18 +397,25 @@ ssize_t UDPSocket::SendTo(ola::io::IOVecInterface *data,
   if (iov == NULL)
     return 0;
 
+  if (InSendBatch()) {
+    ssize_t bytes_queued = QueueDatagram(iov, io_len, dest);
+    data->FreeIOVec(iov);
+    data->Pop(bytes_queued);
+    return bytes_queued;
+  }
+
 #ifdef _WIN32
   ssize_t bytes_sent = 0;
 
   for (int buffer = 0; buffer < io_len; ++buffer) {
-    bytes_sent += SendTo(reinterpret_cast<uint8_t*>(iov[buffer].iov_base),
+    bytes_sent += SendBuffer(reinterpret_cast<uint8_t*>(iov[buffer].iov_base),
         iov[buffer].iov_len, dest);
   }
 
 #else
   struct msghdr message;
   message.msg_name = &destination;
-  message.msg_namelen = sizeof(destination);
+  message.msg_namelen = SockAddrLength(dest);
   message.msg_iov = reinterpret_cast<iovec*>(const_cast<io::IOVec*>(iov));
   message.msg_iovlen = io_len;
   message.msg_control = NULL;
@@ -279,27 +435,70 @@ ssize_t UDPSocket::SendTo(ola::io::IOVecInterface *data,
   return bytes_sent;
 }
 
-bool UDPSocket::RecvFrom(uint8_t *buffer, ssize_t *data_read) const {
-  socklen_t length = 0;
+/*
+ * Read a single datagram. Once the receive stats are enabled, this uses
+ * recvmsg() so the control messages can be passed to the UDPReceiveStats.
+ */
+bool UDPSocket::Receive(uint8_t *buffer, ssize_t *data_read,
+                        struct sockaddr *source,
+                        unsigned int source_size) const {
+  socklen_t src_size = source_size;
 #ifdef _WIN32
-  return ReceiveFrom(m_handle.m_handle.m_fd, buffer, data_read, NULL, &length);
+  return ReceiveFrom(m_handle.m_handle.m_fd, buffer, data_read, source,
+                     &src_size);
 #else
-  return ReceiveFrom(m_handle, buffer, data_read, NULL, &length);
+  // Edge-triggered sockets are read until the queue is empty.
+  const int flags = m_edge_triggered ? MSG_DONTWAIT : 0;
+  if (!m_receive_stats) {
+    if (!ReceiveFrom(m_handle, buffer, data_read, source, &src_size, flags,
+                     &m_would_block)) {
+      return false;
+    }
+    m_read_progress = true;
+    return true;
+  }
+
+  struct iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = *data_read;
+  uint8_t control[UDPReceiveStats::CONTROL_SIZE];
+  struct msghdr header;
+  memset(&header, 0, sizeof(header));
+  header.msg_name = source;
+  header.msg_namelen = source ? src_size : 0;
+  header.msg_iov = &iov;
+  header.msg_iovlen = 1;
+  header.msg_control = control;
+  header.msg_controllen = sizeof(control);
+
+  *data_read = recvmsg(m_handle, &header, flags);
+  if (*data_read < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      m_would_block = true;
+    } else {
+      OLA_WARN << "recvmsg fd: " << m_handle << " failed: "
+               << strerror(errno);
+    }
+    return false;
+  }
+  m_read_progress = true;
+  m_receive_stats->Update(&header);
+  return true;
 #endif  // _WIN32
 }
 
+bool UDPSocket::RecvFrom(uint8_t *buffer, ssize_t *data_read) const {
+  return Receive(buffer, data_read, NULL, 0);
+}
+
 bool UDPSocket::RecvFrom(
     uint8_t *buffer,
     ssize_t *data_read,
     IPV4Address &source) const {  // NOLINT(runtime/references)
   struct sockaddr_in src_sockaddr;
-  socklen_t src_size = sizeof(src_sockaddr);
-#ifdef _WIN32
-  bool ok = ReceiveFrom(m_handle.m_handle.m_fd, buffer, data_read,
-                        &src_sockaddr, &src_size);
-#else
-  bool ok = ReceiveFrom(m_handle, buffer, data_read, &src_sockaddr, &src_size);
-#endif  // _WIN32
+  bool ok = Receive(buffer, data_read,
+                    reinterpret_cast<struct sockaddr*>(&src_sockaddr),
+                    sizeof(src_sockaddr));
   if (ok)
     source = IPV4Address(src_sockaddr.sin_addr.s_addr);
   return ok;
@@ -310,13 +509,9 @@ bool UDPSocket::RecvFrom(uint8_t *buffer,
                          IPV4Address &source,  // NOLINT(runtime/references)
                          uint16_t &port) const {  // NOLINT(runtime/references)
   struct sockaddr_in src_sockaddr;
-  socklen_t src_size = sizeof(src_sockaddr);
-#ifdef _WIN32
-  bool ok = ReceiveFrom(m_handle.m_handle.m_fd, buffer, data_read,
-                        &src_sockaddr, &src_size);
-#else
-  bool ok = ReceiveFrom(m_handle, buffer, data_read, &src_sockaddr, &src_size);
-#endif  // _WIN32
+  bool ok = Receive(buffer, data_read,
+                    reinterpret_cast<struct sockaddr*>(&src_sockaddr),
+                    sizeof(src_sockaddr));
   if (ok) {
     source = IPV4Address(src_sockaddr.sin_addr.s_addr);
     port = NetworkToHost(src_sockaddr.sin_port);
@@ -328,17 +523,202 @@ bool UDPSocket::RecvFrom(uint8_t *buffer,
                          ssize_t *data_read,
                          IPV4SocketAddress *source) {
   struct sockaddr_in src_sockaddr;
-  socklen_t src_size = sizeof(src_sockaddr);
-#ifdef _WIN32
-  bool ok = ReceiveFrom(m_handle.m_handle.m_fd, buffer, data_read,
-                        &src_sockaddr, &src_size);
-#else
-  bool ok = ReceiveFrom(m_handle, buffer, data_read, &src_sockaddr, &src_size);
-#endif  // _WIN32
-  if (ok) {
+  bool ok = Receive(buffer, data_read,
+                    reinterpret_cast<struct sockaddr*>(&src_sockaddr),
+                    sizeof(src_sockaddr));
+  if (ok && src_sockaddr.sin_family == AF_INET) {
     *source = IPV4SocketAddress(IPV4Address(src_sockaddr.sin_addr.s_addr),
                                 NetworkToHost(src_sockaddr.sin_port));
+  } else if (ok) {
+    *source = IPV4SocketAddress();
+  }
+  return ok;
+}
+
+bool UDPSocket::RecvBatch(DatagramBatch *batch) {
+  batch->Clear();
+#ifdef HAVE_RECVMMSG
+  const unsigned int capacity = batch->Capacity();
+  if (!m_batch_state) {
+    m_batch_state = new BatchState();
+  }
+  if (m_batch_state->recv_headers.size() < capacity) {
+    m_batch_state->recv_headers.resize(capacity);
+    m_batch_state->recv_iovecs.resize(capacity);
+    m_batch_state->recv_addresses.resize(capacity);
+  }
+  if (m_receive_stats && m_batch_state->recv_control.size() <
+      capacity * UDPReceiveStats::CONTROL_SIZE) {
+    m_batch_state->recv_control.resize(
+        capacity * UDPReceiveStats::CONTROL_SIZE);
+  }
+
+  for (unsigned int i = 0; i < capacity; i++) {
+    struct iovec &iov = m_batch_state->recv_iovecs[i];
+    iov.iov_base = batch->Data(i);
+    iov.iov_len = batch->DatagramSize();
+
+    struct mmsghdr &header = m_batch_state->recv_headers[i];
+    memset(&header, 0, sizeof(header));
+    header.msg_hdr.msg_name = &m_batch_state->recv_addresses[i];
+    header.msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+    header.msg_hdr.msg_iov = &iov;
+    header.msg_hdr.msg_iovlen = 1;
+    if (m_receive_stats) {
+      header.msg_hdr.msg_control =
+          &m_batch_state->recv_control[i * UDPReceiveStats::CONTROL_SIZE];
+      header.msg_hdr.msg_controllen = UDPReceiveStats::CONTROL_SIZE;
+    }
+  }
+
+  // The socket is readable, so this returns at least one datagram unless
+  // someone else got there first. MSG_DONTWAIT stops us blocking once the
+  // queue is empty.
+  int received = recvmmsg(m_handle, &m_batch_state->recv_headers[0], capacity,
+                          MSG_DONTWAIT, NULL);
+  if (received < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      m_would_block = true;
+    } else {
+      OLA_WARN << "recvmmsg fd: " << m_handle << " failed: "
+               << strerror(errno);
+    }
+    return false;
+  }
+  m_read_progress = received > 0;
+  // A short batch means the queue was emptied. Datagrams that arrive after
+  // this trigger a new edge.
+  if (static_cast<unsigned int>(received) < capacity) {
+    m_would_block = true;
+  }
+
+  for (int i = 0; i < received; i++) {
+    const struct sockaddr_in *src = reinterpret_cast<struct sockaddr_in*>(
+        &m_batch_state->recv_addresses[i]);
+    IPV4SocketAddress source;
+    if (src->sin_family == AF_INET) {
+      source = IPV4SocketAddress(IPV4Address(src->sin_addr.s_addr),
+                                 NetworkToHost(src->sin_port));
+    }
+    batch->Append(m_batch_state->recv_headers[i].msg_len, source);
+    if (m_receive_stats) {
+      m_receive_stats->Update(&m_batch_state->recv_headers[i].msg_hdr);
+    }
+  }
+  return received > 0;
+#else
+  // Without recvmmsg we only read a single datagram per call.
+  ssize_t data_read = batch->DatagramSize();
+  IPV4SocketAddress source;
+  if (!RecvFrom(batch->Data(0), &data_read, &source)) {
+    return false;
+  }
+  batch->Append(static_cast<unsigned int>(data_read), source);
+  return true;
+#endif  // HAVE_RECVMMSG
+}
+
+void UDPSocket::BeginSendBatch() {
+  if (!m_batch_state) {
+    m_batch_state = new BatchState();
+  }
+  m_batch_state->send_depth++;
+}
+
+bool UDPSocket::EndSendBatch() {
+  if (!InSendBatch()) {
+    OLA_WARN << "EndSendBatch() called without a BeginSendBatch()";
+    return false;
   }
+  if (--m_batch_state->send_depth) {
+    return true;
+  }
+  return SendQueue();
+}
+
+bool UDPSocket::InSendBatch() const {
+  return m_batch_state && m_batch_state->send_depth;
+}
+
+ssize_t UDPSocket::QueueDatagram(const struct ola::io::IOVec *iov,
+                                 int io_len,
+                                 const SocketAddress &dest) const {
+  BatchState::QueuedDatagram datagram;
+  datagram.offset = m_batch_state->send_data.size();
+  datagram.size = 0;
+  datagram.ipv6 = dest.Family() == AF_INET6;
+  if (datagram.ipv6) {
+    datagram.v6_destination = static_cast<const IPV6SocketAddress&>(dest);
+  } else {
+    datagram.destination = static_cast<const IPV4SocketAddress&>(dest);
+  }
+  for (int i = 0; i < io_len; i++) {
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(iov[i].iov_base);
+    m_batch_state->send_data.insert(m_batch_state->send_data.end(),
+                                    data, data + iov[i].iov_len);
+    datagram.size += iov[i].iov_len;
+  }
+  m_batch_state->send_queue.push_back(datagram);
+  return datagram.size;
+}
+
+bool UDPSocket::SendQueue() {
+  std::vector<BatchState::QueuedDatagram> &queue = m_batch_state->send_queue;
+  uint8_t *data = m_batch_state->send_data.empty() ?
+      NULL : &m_batch_state->send_data[0];
+  bool ok = ValidWriteDescriptor();
+
+#ifdef HAVE_SENDMMSG
+  const unsigned int count = ok ? queue.size() : 0;
+  if (m_batch_state->send_headers.size() < count) {
+    m_batch_state->send_headers.resize(count);
+    m_batch_state->send_iovecs.resize(count);
+    m_batch_state->send_addresses.resize(count);
+  }
+
+  for (unsigned int i = 0; i < count; i++) {
+    struct iovec &iov = m_batch_state->send_iovecs[i];
+    iov.iov_base = data + queue[i].offset;
+    iov.iov_len = queue[i].size;
+
+    struct sockaddr_storage &destination = m_batch_state->send_addresses[i];
+    queue[i].Destination().ToSockAddr(
+        reinterpret_cast<struct sockaddr*>(&destination), sizeof(destination));
+
+    struct mmsghdr &header = m_batch_state->send_headers[i];
+    memset(&header, 0, sizeof(header));
+    header.msg_hdr.msg_name = &destination;
+    header.msg_hdr.msg_namelen = SockAddrLength(queue[i].Destination());
+    header.msg_hdr.msg_iov = &iov;
+    header.msg_hdr.msg_iovlen = 1;
+  }
+
+  unsigned int sent = 0;
+  while (sent < count) {
+    int result = sendmmsg(m_handle, &m_batch_state->send_headers[sent],
+                          std::min(count - sent, MAX_SEND_BATCH), 0);
+    if (result < 0) {
+      // Only the first datagram failed, skip it and carry on.
+      OLA_INFO << "sendmmsg failed: " << queue[sent].Destination() << " : "
+               << strerror(errno);
+      ok = false;
+      sent++;
+    } else {
+      sent += result;
+    }
+  }
+#else
+  std::vector<BatchState::QueuedDatagram>::const_iterator iter = queue.begin();
+  for (; iter != queue.end() && ValidWriteDescriptor(); ++iter) {
+    ssize_t bytes_sent = SendBuffer(data + iter->offset, iter->size,
+                                    iter->Destination());
+    if (bytes_sent < 0 || static_cast<unsigned int>(bytes_sent) != iter->size)
+      ok = false;
+  }
+#endif  // HAVE_SENDMMSG
+
+  queue.clear();
+  m_batch_state->send_data.clear();
   return ok;
 }
 
@@ -447,8 +827,90 @@ bool UDPSocket::LeaveMulticast(const IPV4Address &iface,
   return true;
 }
 
+bool UDPSocket::SetMulticastInterfaceIndex(unsigned int if_index) {
+  int ok = setsockopt(ola::io::ToFD(m_handle),
+                      IPPROTO_IPV6,
+                      IPV6_MULTICAST_IF,
+                      reinterpret_cast<const char*>(&if_index),
+                      sizeof(if_index));
+  if (ok < 0) {
+    OLA_WARN << "Failed to set outgoing multicast interface to index " <<
+      if_index << ": " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool UDPSocket::JoinMulticast(unsigned int if_index,
+                              const IPV6Address &group,
+                              bool multicast_loop) {
+  struct ipv6_mreq mreq;
+  group.Get(mreq.ipv6mr_multiaddr.s6_addr);
+  mreq.ipv6mr_interface = if_index;
+
+  const int fd = ola::io::ToFD(m_handle);
+  int ok = setsockopt(fd,
+                      IPPROTO_IPV6,
+                      IPV6_JOIN_GROUP,
+                      reinterpret_cast<char*>(&mreq),
+                      sizeof(mreq));
+  if (ok < 0) {
+    OLA_WARN << "Failed to join multicast group " << group <<
+    ": " << strerror(errno);
+    return false;
+  }
+
+  if (!multicast_loop) {
+    unsigned int loop = 0;
+    ok = setsockopt(fd, IPPROTO_IPV6, IPV6_MULTICAST_LOOP,
+                    reinterpret_cast<char*>(&loop), sizeof(loop));
+    if (ok < 0) {
+      OLA_WARN << "Failed to disable looping for " << m_handle << ":" <<
+        strerror(errno);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool UDPSocket::LeaveMulticast(unsigned int if_index,
+                               const IPV6Address &group) {
+  struct ipv6_mreq mreq;
+  group.Get(mreq.ipv6mr_multiaddr.s6_addr);
+  mreq.ipv6mr_interface = if_index;
+
+  int ok = setsockopt(ola::io::ToFD(m_handle),
+                      IPPROTO_IPV6,
+                      IPV6_LEAVE_GROUP,
+                      reinterpret_cast<char*>(&mreq),
+                      sizeof(mreq));
+  if (ok < 0) {
+    OLA_WARN << "Failed to leave multicast group " << group <<
+    ": " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
 bool UDPSocket::SetTos(uint8_t tos) {
   unsigned int value = tos & 0xFC;  // zero the ECN fields
+#ifdef IPV6_TCLASS
+  if (m_ipv6) {
+    // The traffic class holds the DSCP & ECN bits, just like the TOS byte.
+    int class_value = static_cast<int>(value);
+    int ok = setsockopt(ola::io::ToFD(m_handle),
+                        IPPROTO_IPV6,
+                        IPV6_TCLASS,
+                        reinterpret_cast<char*>(&class_value),
+                        sizeof(class_value));
+    if (ok < 0) {
+      OLA_WARN << "Failed to set traffic class for " << m_handle << ", "
+               << strerror(errno);
+      return false;
+    }
+    return true;
+  }
+#endif  // IPV6_TCLASS
 #ifdef _WIN32
   int ok = setsockopt(m_handle.m_handle.m_fd,
 #else
@@ -464,5 +926,46 @@ bool UDPSocket::SetTos(uint8_t tos) {
   }
   return true;
 }
+
+bool UDPSocket::SetMaxPacingRate(uint32_t bytes_per_second) {
+#ifdef SO_MAX_PACING_RATE
+  // 0 means no limit to us, but ~0U to the kernel.
+  unsigned int value = bytes_per_second ? bytes_per_second : ~0U;
+  int ok = setsockopt(m_handle,
+                      SOL_SOCKET,
+                      SO_MAX_PACING_RATE,
+                      reinterpret_cast<char*>(&value),
+                      sizeof(value));
+  if (ok < 0) {
+    OLA_WARN << "Failed to set the pacing rate for " << m_handle << ", "
+             << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  if (bytes_per_second) {
+    OLA_WARN << "Pacing isn't supported on this platform";
+    return false;
+  }
+  return true;
+#endif  // SO_MAX_PACING_RATE
+}
+
+bool UDPSocket::EnableReceiveStats(const UDPReceiveOptions &options) {
+  if (m_handle == ola::io::INVALID_DESCRIPTOR) {
+    return false;
+  }
+  if (!m_receive_stats) {
+    m_receive_stats = new UDPReceiveStats();
+  }
+  return m_receive_stats->Enable(ola::io::ToFD(m_handle), options);
+}
+
+bool UDPSocket::DrainRead() {
+  m_read_progress = false;
+  m_would_block = false;
+  PerformRead();
+  return m_read_progress && !m_would_block;
+}
 }  // namespace network
 }  // namespace ola
@@ -68,6 +68,31 @@ bool IPV4SocketAddress::ToSockAddr(struct sockaddr *addr,
 }
 
 
+string IPV6SocketAddress::ToString() const {
+  std::ostringstream str;
+  str << "[" << Host() << "]:" << Port();
+  return str.str();
+}
+
+/**
+ * Copy this IPV6SocketAddress into a sockaddr.
+ */
+bool IPV6SocketAddress::ToSockAddr(struct sockaddr *addr,
+                                   unsigned int size) const {
+  if (size < sizeof(struct sockaddr_in6)) {
+    OLA_FATAL << "Length passed to ToSockAddr is too small.";
+    return false;
+  }
+  struct sockaddr_in6 *v6_addr = reinterpret_cast<struct sockaddr_in6*>(addr);
+
+  memset(v6_addr, 0, size);
+  v6_addr->sin6_family = AF_INET6;
+  v6_addr->sin6_port = HostToNetwork(m_port);
+  m_host.Get(v6_addr->sin6_addr.s6_addr);
+  return true;
+}
+
+
 /**
  * Extract a IPV4SocketAddress from a string.
  */
@@ -33,23 +33,28 @@
 #include <string>
 
 #include "ola/network/IPV4Address.h"
+#include "ola/network/IPV6Address.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/network/SocketAddress.h"
 #include "ola/testing/TestUtils.h"
 
 using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
+using ola::network::IPV6Address;
+using ola::network::IPV6SocketAddress;
 using std::string;
 
 class SocketAddressTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SocketAddressTest);
   CPPUNIT_TEST(testIPV4SocketAddress);
   CPPUNIT_TEST(testIPV4SocketAddressFromString);
+  CPPUNIT_TEST(testIPV6SocketAddress);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testIPV4SocketAddress();
     void testIPV4SocketAddressFromString();
+    void testIPV6SocketAddress();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SocketAddressTest);
@@ -122,3 +127,32 @@ void SocketAddressTest::testIPV4SocketAddressFromString() {
   OLA_ASSERT_FALSE(IPV4SocketAddress::FromString("foo", &socket_address));
   OLA_ASSERT_FALSE(IPV4SocketAddress::FromString(":80", &socket_address));
 }
+
+
+/*
+ * Test the IPV6 SocketAddress class works
+ */
+void SocketAddressTest::testIPV6SocketAddress() {
+  IPV6Address group = IPV6Address::FromStringOrDie("ff18::8300:1");
+  IPV6SocketAddress socket_address(group, 5568);
+  OLA_ASSERT_EQ(group, socket_address.Host());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(5568), socket_address.Port());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(AF_INET6), socket_address.Family());
+  OLA_ASSERT_EQ(string("[ff18::8300:1]:5568"), socket_address.ToString());
+
+  IPV6SocketAddress socket_address2(socket_address);
+  OLA_ASSERT_EQ(socket_address, socket_address2);
+  socket_address2.Port(5569);
+  OLA_ASSERT_NE(socket_address, socket_address2);
+  OLA_ASSERT_TRUE(socket_address < socket_address2);
+
+  struct sockaddr_in6 addr;
+  OLA_ASSERT_FALSE(socket_address.ToSockAddr(
+      reinterpret_cast<struct sockaddr*>(&addr), sizeof(struct sockaddr_in)));
+  OLA_ASSERT_TRUE(socket_address.ToSockAddr(
+      reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)));
+  OLA_ASSERT_EQ(static_cast<sa_family_t>(AF_INET6), addr.sin6_family);
+  OLA_ASSERT_EQ(ola::network::HostToNetwork(static_cast<uint16_t>(5568)),
+                addr.sin6_port);
+  OLA_ASSERT_EQ(group, IPV6Address(addr.sin6_addr.s6_addr));
+}
@@ -18,32 +18,55 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <cppunit/extensions/HelperMacros.h>
 #include <stdint.h>
 #include <string.h>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif  // !_WIN32
 #include <string>
 
 #include "ola/Callback.h"
 #include "ola/Logging.h"
+#include "ola/base/Array.h"
 #include "ola/io/Descriptor.h"
 #include "ola/io/IOQueue.h"
+#include "ola/io/MemoryBlockPool.h"
+#include "ola/io/NonBlockingSender.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/NetworkUtils.h"
+#include "ola/network/ReusePortGroup.h"
 #include "ola/network/Socket.h"
 #include "ola/network/TCPSocketFactory.h"
+#include "ola/network/UDPReceiveStats.h"
+#include "ola/network/UnixDomainSocket.h"
+#include "ola/strings/Format.h"
 #include "ola/testing/TestUtils.h"
 
 
 using ola::io::ConnectedDescriptor;
 using ola::io::IOQueue;
+using ola::io::MemoryBlockPool;
+using ola::io::NonBlockingSender;
 using ola::io::SelectServer;
+using ola::network::DatagramBatch;
 using ola::network::IPV4Address;
 using ola::network::GenericSocketAddress;
 using ola::network::IPV4SocketAddress;
+using ola::network::ReusePortGroup;
 using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
+using ola::network::UDPReceiveOptions;
+using ola::network::UDPReceiveStats;
 using ola::network::UDPSocket;
+using ola::network::UnixDomainAcceptingSocket;
+using ola::network::UnixDomainSocket;
 using std::string;
 
 static const unsigned char test_cstring[] = "Foo";
@@ -54,8 +77,14 @@ class SocketTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SocketTest);
   CPPUNIT_TEST(testTCPSocketClientClose);
   CPPUNIT_TEST(testTCPSocketServerClose);
+  CPPUNIT_TEST(testTCPZeroCopySend);
   CPPUNIT_TEST(testUDPSocket);
   CPPUNIT_TEST(testIOQueueUDPSend);
+  CPPUNIT_TEST(testUDPBatchReceive);
+  CPPUNIT_TEST(testUDPBatchSend);
+  CPPUNIT_TEST(testUDPReceiveStats);
+  CPPUNIT_TEST(testReusePortGroup);
+  CPPUNIT_TEST(testUnixDomainSocket);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -63,8 +92,14 @@ class SocketTest: public CppUnit::TestFixture {
     void tearDown();
     void testTCPSocketClientClose();
     void testTCPSocketServerClose();
+    void testTCPZeroCopySend();
     void testUDPSocket();
     void testIOQueueUDPSend();
+    void testUDPBatchReceive();
+    void testUDPBatchSend();
+    void testUDPReceiveStats();
+    void testReusePortGroup();
+    void testUnixDomainSocket();
 
     // timing out indicates something went wrong
     void Timeout() {
@@ -80,6 +115,9 @@ class SocketTest: public CppUnit::TestFixture {
     void ReceiveSendAndClose(ConnectedDescriptor *socket);
     void NewConnectionSend(TCPSocket *socket);
     void NewConnectionSendAndClose(TCPSocket *socket);
+    void NewConnectionZeroCopySend(TCPSocket *socket);
+    void NewUnixConnectionSend(UnixDomainSocket *socket);
+    void ReceiveAll(ConnectedDescriptor *socket);
     void UDPReceiveAndTerminate(UDPSocket *socket);
     void UDPReceiveAndSend(UDPSocket *socket);
 
@@ -88,9 +126,19 @@ class SocketTest: public CppUnit::TestFixture {
       m_ss->Terminate();
     }
 
+    void SenderDrained() {
+      m_drain_count++;
+    }
+
  private:
     SelectServer *m_ss;
     ola::SingleUseCallback0<void> *m_timeout_closure;
+    MemoryBlockPool m_pool;
+    TCPSocket *m_server_socket;
+    NonBlockingSender *m_sender;
+    unsigned int m_drain_count;
+    string m_expected;
+    string m_received;
 
     void SocketClientClose(ConnectedDescriptor *socket,
                            ConnectedDescriptor *socket2);
@@ -106,6 +154,11 @@ CPPUNIT_TEST_SUITE_REGISTRATION(SocketTest);
  */
 void SocketTest::setUp() {
   m_ss = new SelectServer();
+  m_server_socket = NULL;
+  m_sender = NULL;
+  m_drain_count = 0;
+  m_expected.clear();
+  m_received.clear();
   m_timeout_closure = ola::NewSingleCallback(this, &SocketTest::Timeout);
   OLA_ASSERT_TRUE(m_ss->RegisterSingleTimeout(ABORT_TIMEOUT_IN_MS,
                                               m_timeout_closure));
@@ -162,6 +215,43 @@ void SocketTest::testTCPSocketClientClose() {
 }
 
 
+/*
+ * Test a NonBlockingSender with zero copy enabled sends the data intact.
+ */
+void SocketTest::testTCPZeroCopySend() {
+  for (unsigned int i = 0; i < 100000; i++) {
+    m_expected.push_back(static_cast<char>(i % 251));
+  }
+
+  IPV4SocketAddress socket_address(IPV4Address::Loopback(), 0);
+  ola::network::TCPSocketFactory socket_factory(
+      ola::NewCallback(this, &SocketTest::NewConnectionZeroCopySend));
+  TCPAcceptingSocket socket(&socket_factory);
+  OLA_ASSERT_TRUE_MSG(socket.Listen(socket_address),
+                      "Check for another instance of olad running");
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(&socket));
+
+  TCPSocket *client_socket = TCPSocket::Connect(socket.GetLocalAddress());
+  OLA_ASSERT_NOT_NULL(client_socket);
+  client_socket->SetOnData(ola::NewCallback(
+        this, &SocketTest::ReceiveAll,
+        static_cast<ConnectedDescriptor*>(client_socket)));
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(client_socket));
+  m_ss->Run();
+  OLA_ASSERT_EQ(m_expected.size(), m_received.size());
+  OLA_ASSERT_TRUE(m_expected == m_received);
+  OLA_ASSERT_TRUE(m_sender->Empty());
+  OLA_ASSERT_EQ(1u, m_drain_count);
+
+  m_ss->RemoveReadDescriptor(&socket);
+  m_ss->RemoveReadDescriptor(client_socket);
+  delete m_sender;
+  delete m_server_socket;
+  delete client_socket;
+  OLA_ASSERT_EQ(m_pool.BlocksAllocated(), m_pool.FreeBlocks());
+}
+
+
 /*
  * Test TCP sockets work correctly.
  * The client connects and the server then sends some data and closes the
@@ -279,6 +369,226 @@ void SocketTest::testIOQueueUDPSend() {
 }
 
 
+/*
+ * Test receiving a batch of datagrams.
+ */
+void SocketTest::testUDPBatchReceive() {
+  IPV4SocketAddress socket_address(IPV4Address::Loopback(), 0);
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(socket_address));
+
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+
+  const uint8_t datagrams[][2] = {{1, 2}, {3, 4}, {5, 6}};
+  for (unsigned int i = 0; i < arraysize(datagrams); i++) {
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(datagrams[i])),
+                  client_socket.SendTo(datagrams[i], sizeof(datagrams[i]),
+                                       local_address));
+  }
+
+  IPV4SocketAddress client_address;
+  OLA_ASSERT_TRUE(client_socket.GetSocketAddress(&client_address));
+
+  DatagramBatch batch(2, 10);
+  OLA_ASSERT_EQ(2u, batch.Capacity());
+  OLA_ASSERT_EQ(10u, batch.DatagramSize());
+  OLA_ASSERT_EQ(0u, batch.Size());
+
+  unsigned int received = 0;
+  while (received < arraysize(datagrams)) {
+    OLA_ASSERT_TRUE(socket.RecvBatch(&batch));
+    OLA_ASSERT_TRUE(batch.Size() > 0);
+    OLA_ASSERT_TRUE(batch.Size() <= batch.Capacity());
+#ifdef HAVE_RECVMMSG
+    // Loopback datagrams are queued by the time SendTo() returns.
+    OLA_ASSERT_EQ(received ? 1u : 2u, batch.Size());
+#endif  // HAVE_RECVMMSG
+
+    for (unsigned int i = 0; i < batch.Size(); i++) {
+      OLA_ASSERT_EQ(static_cast<unsigned int>(sizeof(datagrams[received])),
+                    batch.Length(i));
+      OLA_ASSERT_DATA_EQUALS(datagrams[received], sizeof(datagrams[received]),
+                             batch.Data(i), batch.Length(i));
+      OLA_ASSERT_EQ(IPV4Address::Loopback(), batch.Source(i).Host());
+      OLA_ASSERT_EQ(client_address.Port(), batch.Source(i).Port());
+      received++;
+    }
+  }
+#ifdef HAVE_RECVMMSG
+  // Nothing left, this shouldn't block.
+  OLA_ASSERT_FALSE(socket.RecvBatch(&batch));
+  OLA_ASSERT_EQ(0u, batch.Size());
+#endif  // HAVE_RECVMMSG
+}
+
+
+/*
+ * Test the kernel drops are counted, and the receive buffer grows.
+ */
+void SocketTest::testUDPReceiveStats() {
+#ifdef SO_RXQ_OVFL
+  IPV4SocketAddress socket_address(IPV4Address::Loopback(), 0);
+  UDPSocket socket;
+  OLA_ASSERT_EQ(static_cast<const UDPReceiveStats*>(NULL),
+                socket.ReceiveStats());
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(socket_address));
+
+  // The kernel rounds this up to its minimum.
+  UDPReceiveOptions options;
+  options.min_recv_buffer = 1;
+  options.max_recv_buffer = 1 << 20;
+  OLA_ASSERT_TRUE(socket.EnableReceiveStats(options));
+  const UDPReceiveStats *stats = socket.ReceiveStats();
+  OLA_ASSERT_NOT_NULL(stats);
+  const unsigned int initial_size = stats->RecvBufferSize();
+
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+
+  // Overflow the receive queue.
+  uint8_t data[1000];
+  memset(data, 0, sizeof(data));
+  for (unsigned int i = 0; i < 100; i++) {
+    client_socket.SendTo(data, sizeof(data), local_address);
+  }
+
+  // The drop count is attached to the datagrams queued after the drops, so
+  // empty the queue and then send one more.
+  OLA_ASSERT_TRUE(ola::io::ConnectedDescriptor::SetNonBlocking(
+      socket.ReadDescriptor()));
+  ssize_t data_read = sizeof(data);
+  while (socket.RecvFrom(data, &data_read)) {
+    data_read = sizeof(data);
+  }
+  OLA_ASSERT_EQ(0u, static_cast<unsigned int>(stats->Drops()));
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(data)),
+                client_socket.SendTo(data, sizeof(data), local_address));
+  data_read = sizeof(data);
+  OLA_ASSERT_TRUE(socket.RecvFrom(data, &data_read));
+  OLA_ASSERT_TRUE(stats->Drops() > 0);
+  OLA_ASSERT_TRUE(stats->RecvBufferSize() > initial_size);
+
+  // The stats go away with the socket.
+  socket.Close();
+  OLA_ASSERT_EQ(static_cast<const UDPReceiveStats*>(NULL),
+                socket.ReceiveStats());
+#endif  // SO_RXQ_OVFL
+}
+
+
+/*
+ * Test queuing datagrams and sending them as a batch.
+ */
+void SocketTest::testUDPBatchSend() {
+  IPV4SocketAddress socket_address(IPV4Address::Loopback(), 0);
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(socket_address));
+
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+  OLA_ASSERT_FALSE(client_socket.EndSendBatch());
+
+  const uint8_t datagrams[][3] = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+  client_socket.BeginSendBatch();
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(datagrams[0])),
+                client_socket.SendTo(datagrams[0], sizeof(datagrams[0]),
+                                     local_address));
+
+  // Nested batches are sent by the outer EndSendBatch().
+  client_socket.BeginSendBatch();
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(datagrams[1])),
+                client_socket.SendTo(datagrams[1], sizeof(datagrams[1]),
+                                     local_address));
+  OLA_ASSERT_TRUE(client_socket.EndSendBatch());
+
+  IOQueue output;
+  output.Write(datagrams[2], sizeof(datagrams[2]));
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(datagrams[2])),
+                client_socket.SendTo(&output, local_address));
+  OLA_ASSERT_TRUE(output.Empty());
+
+  DatagramBatch batch(arraysize(datagrams) + 1, 10);
+#ifdef HAVE_RECVMMSG
+  // Nothing has been sent yet.
+  OLA_ASSERT_FALSE(socket.RecvBatch(&batch));
+#endif  // HAVE_RECVMMSG
+
+  OLA_ASSERT_TRUE(client_socket.EndSendBatch());
+
+  unsigned int received = 0;
+  while (received < arraysize(datagrams)) {
+    OLA_ASSERT_TRUE(socket.RecvBatch(&batch));
+    for (unsigned int i = 0; i < batch.Size(); i++) {
+      OLA_ASSERT_DATA_EQUALS(datagrams[received], sizeof(datagrams[received]),
+                             batch.Data(i), batch.Length(i));
+      received++;
+    }
+  }
+}
+
+
+/*
+ * Test that a ReusePortGroup binds each socket to the same port, and that
+ * datagrams are steered by the payload.
+ */
+void SocketTest::testReusePortGroup() {
+#if HAVE_DECL_SO_REUSEPORT
+  ReusePortGroup group(2);
+  OLA_ASSERT_EQ(2u, group.Size());
+
+  ReusePortGroup::Options options;
+  options.steering = ReusePortGroup::STEER_BY_PAYLOAD;
+  options.payload_offset = 0;
+  options.payload_width = 1;
+  OLA_ASSERT_TRUE(group.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0),
+                             options));
+
+  IPV4SocketAddress address0, address1;
+  OLA_ASSERT_TRUE(group.Socket(0)->GetSocketAddress(&address0));
+  OLA_ASSERT_TRUE(group.Socket(1)->GetSocketAddress(&address1));
+  OLA_ASSERT_NE(static_cast<uint16_t>(0), address0.Port());
+  OLA_ASSERT_EQ(address0, address1);
+
+#if HAVE_DECL_SO_ATTACH_REUSEPORT_CBPF
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+
+  // loopback delivery is synchronous, so the datagrams are queued by the time
+  // SendTo returns.
+  for (uint8_t i = 0; i < 4; i++) {
+    const uint8_t data[] = {i, 'x'};
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(data)),
+                  client_socket.SendTo(data, sizeof(data), address0));
+  }
+
+  for (unsigned int socket_index = 0; socket_index < group.Size();
+       socket_index++) {
+    for (unsigned int i = 0; i < 2; i++) {
+      uint8_t buffer[10];
+      ssize_t data_read = sizeof(buffer);
+      OLA_ASSERT_TRUE(group.Socket(socket_index)->RecvFrom(buffer,
+                                                           &data_read));
+      OLA_ASSERT_EQ(static_cast<ssize_t>(2), data_read);
+      OLA_ASSERT_EQ(socket_index, buffer[0] % group.Size());
+    }
+  }
+#endif  // HAVE_DECL_SO_ATTACH_REUSEPORT_CBPF
+#endif  // HAVE_DECL_SO_REUSEPORT
+}
+
+
 /*
  * Receive some data and close the socket
  */
@@ -313,6 +623,20 @@ void SocketTest::Receive(ConnectedDescriptor *socket) {
 }
 
 
+/*
+ * Receive data until we have all of m_expected.
+ */
+void SocketTest::ReceiveAll(ConnectedDescriptor *socket) {
+  uint8_t buffer[4096];
+  unsigned int data_read;
+  OLA_ASSERT_FALSE(socket->Receive(buffer, sizeof(buffer), data_read));
+  m_received.append(reinterpret_cast<char*>(buffer), data_read);
+  if (m_received.size() >= m_expected.size()) {
+    m_ss->Terminate();
+  }
+}
+
+
 /*
  * Receive some data and send it back
  */
@@ -355,6 +679,28 @@ void SocketTest::NewConnectionSend(TCPSocket *new_socket) {
 }
 
 
+/*
+ * Accept a new connection, and send m_expected with a zero copy sender.
+ */
+void SocketTest::NewConnectionZeroCopySend(TCPSocket *new_socket) {
+  OLA_ASSERT_NOT_NULL(new_socket);
+  m_server_socket = new_socket;
+  m_sender = new NonBlockingSender(new_socket, m_ss, &m_pool,
+                                   m_expected.size());
+  // This fails on kernels without SO_ZEROCOPY, the data should still arrive.
+  if (!m_sender->EnableZeroCopy(1024)) {
+    OLA_INFO << "Zero copy isn't supported";
+  }
+  m_sender->SetOnDrain(ola::NewCallback(this, &SocketTest::SenderDrained));
+
+  IOQueue queue(&m_pool);
+  queue.Write(reinterpret_cast<const uint8_t*>(m_expected.data()),
+              m_expected.size());
+  OLA_ASSERT_TRUE(m_sender->SendMessage(&queue));
+  OLA_ASSERT_TRUE(queue.Empty());
+}
+
+
 /*
  * Accept a new connect, send some data and close
  */
@@ -467,3 +813,56 @@ void SocketTest::SocketServerClose(ConnectedDescriptor *socket,
   m_ss->RemoveReadDescriptor(socket2);
   delete socket2;
 }
+
+
+/*
+ * Check that unix domain sockets work. The server sends some data and the
+ * client closes the connection.
+ */
+void SocketTest::testUnixDomainSocket() {
+#ifndef _WIN32
+  const string path = "/tmp/ola-socket-test-" +
+                      ola::strings::IntToString(getpid());
+  UnixDomainAcceptingSocket socket(
+      ola::NewCallback(this, &SocketTest::NewUnixConnectionSend));
+  OLA_ASSERT_TRUE(socket.Listen(path));
+  OLA_ASSERT_FALSE(socket.Listen(path));
+  OLA_ASSERT_EQ(path, socket.Path());
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(&socket));
+
+  UnixDomainSocket *client_socket = UnixDomainSocket::Connect(path);
+  OLA_ASSERT_NOT_NULL(client_socket);
+  client_socket->SetOnData(ola::NewCallback(
+        this, &SocketTest::ReceiveAndClose,
+        static_cast<ConnectedDescriptor*>(client_socket)));
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(client_socket));
+  m_ss->Run();
+  m_ss->RemoveReadDescriptor(&socket);
+  m_ss->RemoveReadDescriptor(client_socket);
+  delete client_socket;
+
+  // The path is removed once the socket is closed.
+  socket.Close();
+  OLA_ASSERT_NULL(UnixDomainSocket::Connect(path));
+#endif  // !_WIN32
+}
+
+
+void SocketTest::NewUnixConnectionSend(UnixDomainSocket *new_socket) {
+  OLA_ASSERT_TRUE(new_socket);
+#ifndef _WIN32
+  uid_t uid;
+  gid_t gid;
+  if (new_socket->GetPeerCredentials(&uid, &gid)) {
+    OLA_ASSERT_EQ(getuid(), uid);
+    OLA_ASSERT_EQ(getgid(), gid);
+  }
+#endif  // !_WIN32
+  ssize_t bytes_sent = new_socket->Send(
+      static_cast<const uint8_t*>(test_cstring),
+      sizeof(test_cstring));
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(test_cstring)), bytes_sent);
+  new_socket->SetOnClose(ola::NewSingleCallback(this,
+                                               &SocketTest::TerminateOnClose));
+  m_ss->AddReadDescriptor(new_socket, true);
+}
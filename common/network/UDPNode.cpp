@@ -0,0 +1,130 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPNode.cpp
+ * The shared receive path for the simple UDP DMX protocols.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/network/UDPNode.h"
+
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace network {
+
+using std::string;
+using std::vector;
+
+const char UDPNode::K_PACKETS_VAR[] = "udp-node-packets";
+const char UDPNode::K_DROPPED_PACKETS_VAR[] = "udp-node-dropped-packets";
+const char UDPNode::K_DMX_FRAMES_VAR[] = "udp-node-dmx-frames";
+
+namespace {
+const char PROTOCOL_KEY[] = "protocol";
+
+unsigned int *ExportCounter(ola::ExportMap *export_map, const char *name,
+                            const string &protocol) {
+  UIntMap *var = export_map->GetUIntMapVar(name, PROTOCOL_KEY);
+  unsigned int &counter = (*var)[protocol];
+  counter = 0;
+  return &counter;
+}
+}  // namespace
+
+
+UDPNode::UDPNode(const string &protocol,
+                 unsigned int max_packet_size,
+                 ola::ExportMap *export_map)
+    : m_recv_batch(RECV_BATCH_SIZE, max_packet_size) {
+  m_local_counters[0] = 0;
+  m_local_counters[1] = 0;
+  m_local_counters[2] = 0;
+  if (export_map) {
+    m_packets = ExportCounter(export_map, K_PACKETS_VAR, protocol);
+    m_dropped_packets = ExportCounter(export_map, K_DROPPED_PACKETS_VAR,
+                                      protocol);
+    m_dmx_frames = ExportCounter(export_map, K_DMX_FRAMES_VAR, protocol);
+  } else {
+    m_packets = &m_local_counters[0];
+    m_dropped_packets = &m_local_counters[1];
+    m_dmx_frames = &m_local_counters[2];
+  }
+}
+
+
+UDPNode::~UDPNode() {
+  vector<UniverseHandler>::iterator iter = m_handlers.begin();
+  for (; iter != m_handlers.end(); ++iter) {
+    delete iter->callback;
+  }
+  m_handlers.clear();
+}
+
+
+bool UDPNode::SetUniverseHandler(unsigned int universe, DmxBuffer *buffer,
+                                 DmxCallback *callback) {
+  if (!callback) {
+    return false;
+  }
+
+  if (universe >= m_handlers.size()) {
+    UniverseHandler empty = {NULL, NULL};
+    m_handlers.resize(universe + 1, empty);
+  }
+
+  UniverseHandler &handler = m_handlers[universe];
+  if (handler.callback && handler.callback != callback) {
+    delete handler.callback;
+  }
+  handler.buffer = buffer;
+  handler.callback = callback;
+  return true;
+}
+
+
+bool UDPNode::RemoveUniverseHandler(unsigned int universe) {
+  if (universe >= m_handlers.size() || !m_handlers[universe].callback) {
+    return false;
+  }
+  UniverseHandler &handler = m_handlers[universe];
+  delete handler.callback;
+  handler.buffer = NULL;
+  handler.callback = NULL;
+
+  // Shrink the table if this was the highest universe.
+  while (!m_handlers.empty() && !m_handlers.back().callback) {
+    m_handlers.pop_back();
+  }
+  return true;
+}
+
+
+void UDPNode::ReceivePackets(UDPSocketInterface *socket) {
+  if (!socket->RecvBatch(&m_recv_batch)) {
+    return;
+  }
+
+  for (unsigned int i = 0; i < m_recv_batch.Size(); i++) {
+    (*m_packets)++;
+    if (!HandlePacket(m_recv_batch.Data(i), m_recv_batch.Length(i),
+                      m_recv_batch.Source(i))) {
+      (*m_dropped_packets)++;
+    }
+  }
+}
+}  // namespace network
+}  // namespace ola
@@ -0,0 +1,150 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPNode.h
+ * The shared receive path for the simple UDP DMX protocols.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_NETWORK_UDPNODE_H_
+#define COMMON_NETWORK_UDPNODE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+
+namespace ola {
+namespace network {
+
+/**
+ * @brief The base class for the nodes of the simple UDP DMX protocols.
+ *
+ * All the datagrams pending on a socket are read with RecvBatch() and passed
+ * to HandlePacket() straight from the batch buffers, so the subclass can
+ * decode the DMX data directly into the buffer registered for the universe.
+ *
+ * The handlers are held in a table indexed by the universe key, which is
+ * whatever the protocol uses to identify a universe.
+ *
+ * If an ExportMap is provided, the number of packets, dropped packets and
+ * DMX frames are exported, keyed by the protocol name. A packet is dropped if
+ * it's malformed, was sent by us, or isn't for a universe we're listening
+ * to.
+ */
+class UDPNode {
+ public:
+  typedef ola::Callback0<void> DmxCallback;
+
+  virtual ~UDPNode();
+
+  static const char K_PACKETS_VAR[];
+  static const char K_DROPPED_PACKETS_VAR[];
+  static const char K_DMX_FRAMES_VAR[];
+
+ protected:
+  /**
+   * @brief A buffer and the callback to run when it's updated.
+   */
+  struct UniverseHandler {
+    DmxBuffer *buffer;
+    DmxCallback *callback;
+  };
+
+  /**
+   * @brief Create a new UDPNode.
+   * @param protocol the protocol name, used as the key for the exported
+   *   variables.
+   * @param max_packet_size the size of the largest packet for the protocol.
+   * @param export_map the ExportMap to use, may be NULL.
+   */
+  UDPNode(const std::string &protocol,
+          unsigned int max_packet_size,
+          ola::ExportMap *export_map);
+
+  /**
+   * @brief Set the buffer and callback for a universe.
+   * @param universe the key for the universe.
+   * @param buffer the buffer to decode the data into, ownership is not
+   *   transferred.
+   * @param callback the callback to run once the buffer has been updated,
+   *   ownership is transferred.
+   */
+  bool SetUniverseHandler(unsigned int universe, DmxBuffer *buffer,
+                          DmxCallback *callback);
+
+  /**
+   * @brief Remove the handler for a universe.
+   * @returns true if removed, false if it didn't exist.
+   */
+  bool RemoveUniverseHandler(unsigned int universe);
+
+  /**
+   * @brief Find the handler for a universe.
+   * @returns the UniverseHandler or NULL if there isn't one.
+   */
+  UniverseHandler *LookupUniverse(unsigned int universe) {
+    if (universe >= m_handlers.size() || !m_handlers[universe].callback) {
+      return NULL;
+    }
+    return &m_handlers[universe];
+  }
+
+  /**
+   * @brief Run the callback for a universe, once the buffer has been updated.
+   */
+  void DmxReceived(UniverseHandler *handler) {
+    (*m_dmx_frames)++;
+    handler->callback->Run();
+  }
+
+  /**
+   * @brief Read all the datagrams pending on a socket, and pass each one to
+   * HandlePacket().
+   */
+  void ReceivePackets(UDPSocketInterface *socket);
+
+  /**
+   * @brief Handle a received datagram.
+   * @param data the datagram. This is only valid for the duration of the call.
+   * @param length the length of the datagram.
+   * @param source the source of the datagram.
+   * @returns false if the datagram was dropped.
+   */
+  virtual bool HandlePacket(const uint8_t *data, unsigned int length,
+                            const IPV4SocketAddress &source) = 0;
+
+ private:
+  std::vector<UniverseHandler> m_handlers;
+  DatagramBatch m_recv_batch;
+  // These point to the exported variables, or the local counters if there
+  // isn't an ExportMap.
+  unsigned int *m_packets;
+  unsigned int *m_dropped_packets;
+  unsigned int *m_dmx_frames;
+  unsigned int m_local_counters[3];
+
+  static const unsigned int RECV_BATCH_SIZE = 16;
+
+  DISALLOW_COPY_AND_ASSIGN(UDPNode);
+};
+}  // namespace network
+}  // namespace ola
+#endif  // COMMON_NETWORK_UDPNODE_H_
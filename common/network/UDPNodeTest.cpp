@@ -0,0 +1,183 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPNodeTest.cpp
+ * Test fixture for the UDPNode class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "common/network/UDPNode.h"
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::NewCallback;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::UDPNode;
+using ola::testing::MockUDPSocket;
+
+namespace {
+
+/*
+ * A node where the first byte of each packet is the universe and the rest is
+ * the DMX data.
+ */
+class TestNode: public UDPNode {
+ public:
+  explicit TestNode(ExportMap *export_map)
+      : UDPNode("test", 600, export_map),
+        m_socket(NULL) {
+  }
+
+  void SetSocket(MockUDPSocket *socket) {
+    m_socket = socket;
+    socket->SetOnData(NewCallback(this, &TestNode::SocketReady));
+  }
+
+  using UDPNode::SetUniverseHandler;
+  using UDPNode::RemoveUniverseHandler;
+
+ protected:
+  bool HandlePacket(const uint8_t *data, unsigned int length,
+                    const IPV4SocketAddress&) {
+    if (!length) {
+      return false;
+    }
+    UniverseHandler *handler = LookupUniverse(data[0]);
+    if (!handler) {
+      return false;
+    }
+    handler->buffer->Set(data + 1, length - 1);
+    DmxReceived(handler);
+    return true;
+  }
+
+ private:
+  MockUDPSocket *m_socket;
+
+  void SocketReady() {
+    ReceivePackets(m_socket);
+  }
+};
+}  // namespace
+
+
+class UDPNodeTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(UDPNodeTest);
+  CPPUNIT_TEST(testDispatch);
+  CPPUNIT_TEST(testCounters);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp() {
+      m_callback_count = 0;
+      m_socket.Init();
+    }
+
+    void testDispatch();
+    void testCounters();
+
+ private:
+    MockUDPSocket m_socket;
+    unsigned int m_callback_count;
+
+    void DmxReceived() { m_callback_count++; }
+
+    void Inject(const uint8_t *data, unsigned int size) {
+      m_socket.InjectData(data, size, IPV4Address::Loopback(), 5000);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UDPNodeTest);
+
+
+/*
+ * Check that packets are decoded into the buffer for the universe.
+ */
+void UDPNodeTest::testDispatch() {
+  TestNode node(NULL);
+  node.SetSocket(&m_socket);
+
+  DmxBuffer buffer1, buffer2;
+  OLA_ASSERT_FALSE(node.SetUniverseHandler(1, &buffer1, NULL));
+  OLA_ASSERT_TRUE(node.SetUniverseHandler(
+      1, &buffer1, NewCallback(this, &UDPNodeTest::DmxReceived)));
+  OLA_ASSERT_TRUE(node.SetUniverseHandler(
+      300, &buffer2, NewCallback(this, &UDPNodeTest::DmxReceived)));
+
+  const uint8_t packet1[] = {1, 10, 11, 12};
+  Inject(packet1, sizeof(packet1));
+  OLA_ASSERT_EQ(1u, m_callback_count);
+  OLA_ASSERT_EQ(DmxBuffer(packet1 + 1, sizeof(packet1) - 1), buffer1);
+  OLA_ASSERT_EQ(0u, buffer2.Size());
+
+  // No handler for universe 2
+  const uint8_t packet2[] = {2, 1, 2};
+  Inject(packet2, sizeof(packet2));
+  OLA_ASSERT_EQ(1u, m_callback_count);
+
+  // Replacing the handler updates the buffer
+  OLA_ASSERT_TRUE(node.SetUniverseHandler(
+      1, &buffer2, NewCallback(this, &UDPNodeTest::DmxReceived)));
+  Inject(packet1, sizeof(packet1));
+  OLA_ASSERT_EQ(2u, m_callback_count);
+  OLA_ASSERT_EQ(buffer1, buffer2);
+
+  OLA_ASSERT_TRUE(node.RemoveUniverseHandler(1));
+  OLA_ASSERT_FALSE(node.RemoveUniverseHandler(1));
+  OLA_ASSERT_FALSE(node.RemoveUniverseHandler(2));
+  Inject(packet1, sizeof(packet1));
+  OLA_ASSERT_EQ(2u, m_callback_count);
+
+  OLA_ASSERT_TRUE(node.RemoveUniverseHandler(300));
+}
+
+
+/*
+ * Check the exported counters.
+ */
+void UDPNodeTest::testCounters() {
+  ExportMap export_map;
+  TestNode node(&export_map);
+  node.SetSocket(&m_socket);
+
+  DmxBuffer buffer;
+  node.SetUniverseHandler(
+      0, &buffer, NewCallback(this, &UDPNodeTest::DmxReceived));
+
+  const uint8_t packet[] = {0, 1, 2, 3};
+  const uint8_t other_universe[] = {1, 1, 2, 3};
+  Inject(packet, sizeof(packet));
+  Inject(other_universe, sizeof(other_universe));
+  Inject(packet, sizeof(packet));
+
+  OLA_ASSERT_EQ(2u, m_callback_count);
+  OLA_ASSERT_EQ(3u, (*export_map.GetUIntMapVar(
+      UDPNode::K_PACKETS_VAR))["test"]);
+  OLA_ASSERT_EQ(1u, (*export_map.GetUIntMapVar(
+      UDPNode::K_DROPPED_PACKETS_VAR))["test"]);
+  OLA_ASSERT_EQ(2u, (*export_map.GetUIntMapVar(
+      UDPNode::K_DMX_FRAMES_VAR))["test"]);
+}
@@ -0,0 +1,228 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPReceiveStats.cpp
+ * Kernel drop counts & receive queue latency for UDP sockets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/network/UDPReceiveStats.h"
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <ola/win/CleanWinSock2.h>
+#endif  // _WIN32
+
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif  // HAVE_SYS_SOCKET_H
+
+#ifdef HAVE_LINUX_NET_TSTAMP_H
+#include <linux/net_tstamp.h>
+#endif  // HAVE_LINUX_NET_TSTAMP_H
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "ola/ExportMap.h"
+#include "ola/Logging.h"
+
+namespace ola {
+namespace network {
+
+const char UDPReceiveStats::K_KERNEL_DROPS_VAR[] = "udp-kernel-drops";
+const char UDPReceiveStats::K_RECV_BUFFER_SIZE_VAR[] = "udp-recv-buffer-size";
+const char UDPReceiveStats::K_RECV_LATENCY_VAR[] = "udp-recv-latency-us";
+
+UDPReceiveStats::UDPReceiveStats()
+    : m_fd(-1),
+      m_last_drop_count(0),
+      m_drops(0),
+      m_recv_buffer_size(0),
+      m_can_grow(false),
+      m_drops_var(NULL),
+      m_recv_buffer_size_var(NULL) {
+}
+
+UDPReceiveStats::~UDPReceiveStats() {
+  ExportMap *export_map = m_options.export_map;
+  if (export_map) {
+    const std::string &key = m_options.export_key;
+    export_map->GetUIntMapVar(K_KERNEL_DROPS_VAR)->Remove(key);
+    export_map->GetUIntMapVar(K_RECV_BUFFER_SIZE_VAR)->Remove(key);
+    export_map->GetHistogramMapVar(K_RECV_LATENCY_VAR)->Remove(key);
+  }
+}
+
+bool UDPReceiveStats::Enable(int fd, const UDPReceiveOptions &options) {
+  m_fd = fd;
+  m_options = options;
+  m_can_grow = options.max_recv_buffer != 0;
+
+  if (options.export_map) {
+    const std::string &key = options.export_key;
+    m_drops_var = options.export_map->GetUIntMapVar(
+        K_KERNEL_DROPS_VAR, "socket")->Handle(key);
+    m_recv_buffer_size_var = options.export_map->GetUIntMapVar(
+        K_RECV_BUFFER_SIZE_VAR, "socket")->Handle(key);
+    options.export_map->GetHistogramMapVar(
+        K_RECV_LATENCY_VAR, "socket")->Set(key, &m_latency);
+  }
+
+  UpdateRecvBufferSize();
+  if (options.min_recv_buffer &&
+      m_recv_buffer_size < options.min_recv_buffer) {
+    SetRecvBufferSize(options.min_recv_buffer);
+  }
+
+#if defined(HAVE_LINUX_NET_TSTAMP_H) && defined(SO_TIMESTAMPING)
+  if (options.timestamps) {
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING,
+                   reinterpret_cast<char*>(&flags), sizeof(flags)) < 0) {
+      OLA_WARN << "Failed to set SO_TIMESTAMPING for " << fd << ", "
+               << strerror(errno);
+    }
+  }
+#else
+  if (options.timestamps) {
+    OLA_WARN << "Receive timestamps aren't supported on this platform";
+  }
+#endif  // defined(HAVE_LINUX_NET_TSTAMP_H) && defined(SO_TIMESTAMPING)
+
+#ifdef SO_RXQ_OVFL
+  int enable = 1;
+  if (setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL,
+                 reinterpret_cast<char*>(&enable), sizeof(enable)) < 0) {
+    OLA_WARN << "Failed to set SO_RXQ_OVFL for " << fd << ", "
+             << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif  // SO_RXQ_OVFL
+}
+
+void UDPReceiveStats::Update(const struct msghdr *header) {
+#if defined(SO_RXQ_OVFL) || defined(SO_TIMESTAMPING)
+  // The cmsg macros aren't const correct.
+  struct msghdr *msg = const_cast<struct msghdr*>(header);
+  for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL;
+       cmsg = CMSG_NXTHDR(msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET) {
+      continue;
+    }
+#ifdef SO_RXQ_OVFL
+    if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+      uint32_t drop_count;
+      memcpy(&drop_count, CMSG_DATA(cmsg), sizeof(drop_count));
+      if (drop_count != m_last_drop_count) {
+        Drop(drop_count);
+      }
+    }
+#endif  // SO_RXQ_OVFL
+#ifdef SO_TIMESTAMPING
+    if (cmsg->cmsg_type == SO_TIMESTAMPING) {
+      // The software timestamp is the first of the three.
+      struct timespec received;
+      memcpy(&received, CMSG_DATA(cmsg), sizeof(received));
+      struct timespec now;
+      clock_gettime(CLOCK_REALTIME, &now);
+      int64_t latency = (
+          static_cast<int64_t>(now.tv_sec - received.tv_sec) * 1000000 +
+          (now.tv_nsec - received.tv_nsec) / 1000);
+      if (received.tv_sec && latency >= 0) {
+        m_latency.Add(static_cast<uint32_t>(
+            std::min<int64_t>(latency,
+                              std::numeric_limits<uint32_t>::max())));
+      }
+    }
+#endif  // SO_TIMESTAMPING
+  }
+#else
+  (void) header;
+#endif  // defined(SO_RXQ_OVFL) || defined(SO_TIMESTAMPING)
+}
+
+/*
+ * The kernel reports the total number of datagrams dropped from the socket.
+ */
+void UDPReceiveStats::Drop(uint32_t drop_count) {
+  uint32_t dropped = drop_count - m_last_drop_count;
+  m_last_drop_count = drop_count;
+  m_drops += dropped;
+  if (m_drops_var) {
+    *m_drops_var += dropped;
+  }
+  OLA_DEBUG << "Kernel dropped " << dropped << " datagrams on " << m_fd;
+  if (m_can_grow) {
+    GrowRecvBuffer();
+  }
+}
+
+void UDPReceiveStats::GrowRecvBuffer() {
+  if (m_recv_buffer_size >= m_options.max_recv_buffer) {
+    m_can_grow = false;
+    return;
+  }
+
+  const unsigned int previous_size = m_recv_buffer_size;
+  SetRecvBufferSize(std::min(m_options.max_recv_buffer,
+                             std::max(previous_size, 1024u) * 2));
+  if (m_recv_buffer_size <= previous_size) {
+    OLA_WARN << "Unable to grow the receive buffer for " << m_fd
+             << " beyond " << m_recv_buffer_size
+             << " bytes, check net.core.rmem_max";
+    m_can_grow = false;
+  } else {
+    OLA_INFO << "Grew the receive buffer for " << m_fd << " to "
+             << m_recv_buffer_size << " bytes";
+  }
+}
+
+bool UDPReceiveStats::SetRecvBufferSize(unsigned int size) {
+  int value = static_cast<int>(size);
+  bool ok = setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF,
+                       reinterpret_cast<char*>(&value), sizeof(value)) == 0;
+  if (!ok) {
+    OLA_WARN << "Failed to set SO_RCVBUF for " << m_fd << ", "
+             << strerror(errno);
+  }
+  UpdateRecvBufferSize();
+  return ok;
+}
+
+void UDPReceiveStats::UpdateRecvBufferSize() {
+  int value = 0;
+  socklen_t length = sizeof(value);
+  if (getsockopt(m_fd, SOL_SOCKET, SO_RCVBUF,
+                 reinterpret_cast<char*>(&value), &length) == 0) {
+    m_recv_buffer_size = static_cast<unsigned int>(value);
+  }
+  if (m_recv_buffer_size_var) {
+    *m_recv_buffer_size_var = m_recv_buffer_size;
+  }
+}
+}  // namespace network
+}  // namespace ola
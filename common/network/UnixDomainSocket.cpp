@@ -0,0 +1,279 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UnixDomainSocket.cpp
+ * Stream sockets bound to a path in the filesystem.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif  // !_WIN32
+
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/network/SocketCloser.h"
+#include "ola/network/UnixDomainSocket.h"
+
+namespace ola {
+namespace network {
+
+using std::string;
+
+#ifndef _WIN32
+namespace {
+bool PathToSockAddr(const string &path, struct sockaddr_un *addr) {
+  if (path.empty() || path.size() >= sizeof(addr->sun_path)) {
+    OLA_WARN << "Invalid unix domain socket path " << path;
+    return false;
+  }
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  memcpy(addr->sun_path, path.c_str(), path.size());
+  return true;
+}
+}  // namespace
+
+// UnixDomainSocket
+// ------------------------------------------------
+
+UnixDomainSocket::UnixDomainSocket(int sd)
+    : m_handle(sd) {
+  SetNoSigPipe(m_handle);
+}
+
+bool UnixDomainSocket::Close() {
+  if (m_handle != ola::io::INVALID_DESCRIPTOR) {
+    close(m_handle);
+    m_handle = ola::io::INVALID_DESCRIPTOR;
+  }
+  return true;
+}
+
+bool UnixDomainSocket::GetPeerCredentials(uid_t *uid, gid_t *gid) const {
+#if defined(SO_PEERCRED)
+  struct ucred credentials;
+  socklen_t length = sizeof(credentials);
+  if (getsockopt(m_handle, SOL_SOCKET, SO_PEERCRED, &credentials, &length)) {
+    OLA_WARN << "getsockopt(SO_PEERCRED) failed: " << strerror(errno);
+    return false;
+  }
+  *uid = credentials.uid;
+  *gid = credentials.gid;
+  return true;
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || \
+      defined(__OpenBSD__)
+  if (getpeereid(m_handle, uid, gid)) {
+    OLA_WARN << "getpeereid() failed: " << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  (void) uid;
+  (void) gid;
+  return false;
+#endif  // SO_PEERCRED
+}
+
+UnixDomainSocket* UnixDomainSocket::Connect(const string &path) {
+  struct sockaddr_un server_address;
+  if (!PathToSockAddr(path, &server_address)) {
+    return NULL;
+  }
+
+  int sd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sd < 0) {
+    OLA_WARN << "socket() failed, " << strerror(errno);
+    return NULL;
+  }
+
+  SocketCloser closer(sd);
+  if (connect(sd, reinterpret_cast<struct sockaddr*>(&server_address),
+              sizeof(server_address))) {
+    OLA_WARN << "connect(" << path << "): " << strerror(errno);
+    return NULL;
+  }
+  UnixDomainSocket *socket = new UnixDomainSocket(closer.Release());
+  socket->SetReadNonBlocking();
+  return socket;
+}
+
+
+// UnixDomainAcceptingSocket
+// ------------------------------------------------
+
+UnixDomainAcceptingSocket::UnixDomainAcceptingSocket(
+    NewSocketCallback *on_accept)
+    : ReadFileDescriptor(),
+      m_handle(ola::io::INVALID_DESCRIPTOR),
+      m_on_accept(on_accept) {
+}
+
+UnixDomainAcceptingSocket::~UnixDomainAcceptingSocket() {
+  Close();
+}
+
+bool UnixDomainAcceptingSocket::Listen(const string &path, mode_t mode,
+                                       int backlog) {
+  if (m_handle != ola::io::INVALID_DESCRIPTOR) {
+    return false;
+  }
+
+  struct sockaddr_un server_address;
+  if (!PathToSockAddr(path, &server_address)) {
+    return false;
+  }
+
+  // Remove a socket left behind by a previous instance. Anything else at this
+  // path is left alone.
+  struct stat stat_buf;
+  if (lstat(path.c_str(), &stat_buf) == 0) {
+    if (!S_ISSOCK(stat_buf.st_mode)) {
+      OLA_WARN << path << " exists and isn't a socket";
+      return false;
+    }
+    unlink(path.c_str());
+  }
+
+  int sd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sd < 0) {
+    OLA_WARN << "socket() failed: " << strerror(errno);
+    return false;
+  }
+
+  SocketCloser closer(sd);
+
+  if (!ola::io::ConnectedDescriptor::SetNonBlocking(sd)) {
+    OLA_WARN << "Failed to mark unix domain accept socket as non-blocking";
+    return false;
+  }
+
+  if (bind(sd, reinterpret_cast<struct sockaddr*>(&server_address),
+           sizeof(server_address)) == -1) {
+    OLA_WARN << "bind to " << path << " failed, " << strerror(errno);
+    return false;
+  }
+
+  if (chmod(path.c_str(), mode)) {
+    OLA_WARN << "chmod(" << path << ") failed, " << strerror(errno);
+    unlink(path.c_str());
+    return false;
+  }
+
+  if (listen(sd, backlog)) {
+    OLA_WARN << "listen on " << path << " failed, " << strerror(errno);
+    unlink(path.c_str());
+    return false;
+  }
+  m_handle = closer.Release();
+  m_path = path;
+  return true;
+}
+
+bool UnixDomainAcceptingSocket::Close() {
+  bool ret = true;
+  if (m_handle != ola::io::INVALID_DESCRIPTOR) {
+    if (close(m_handle)) {
+      OLA_WARN << "close() failed " << strerror(errno);
+      ret = false;
+    }
+    unlink(m_path.c_str());
+    m_path.clear();
+  }
+  m_handle = ola::io::INVALID_DESCRIPTOR;
+  return ret;
+}
+
+void UnixDomainAcceptingSocket::PerformRead() {
+  if (m_handle == ola::io::INVALID_DESCRIPTOR) {
+    return;
+  }
+
+  while (1) {
+    int sd = accept(m_handle, NULL, NULL);
+    if (sd < 0) {
+      if (errno != EWOULDBLOCK) {
+        OLA_WARN << "accept() failed, " << strerror(errno);
+      }
+      return;
+    }
+
+    if (m_on_accept.get()) {
+      UnixDomainSocket *socket = new UnixDomainSocket(sd);
+      socket->SetReadNonBlocking();
+      m_on_accept->Run(socket);
+    } else {
+      OLA_WARN << "Accepted new unix domain connection but no callback "
+               << "registered";
+      close(sd);
+    }
+  }
+}
+#else
+// Unix domain sockets aren't supported on Windows.
+
+UnixDomainSocket::UnixDomainSocket(int sd)
+    : m_handle(ola::io::INVALID_DESCRIPTOR) {
+  (void) sd;
+}
+
+bool UnixDomainSocket::Close() {
+  return true;
+}
+
+bool UnixDomainSocket::GetPeerCredentials(uid_t*, gid_t*) const {
+  return false;
+}
+
+UnixDomainSocket* UnixDomainSocket::Connect(const string &path) {
+  OLA_WARN << "Unix domain sockets aren't supported, can't connect to "
+           << path;
+  return NULL;
+}
+
+UnixDomainAcceptingSocket::UnixDomainAcceptingSocket(
+    NewSocketCallback *on_accept)
+    : ReadFileDescriptor(),
+      m_handle(ola::io::INVALID_DESCRIPTOR),
+      m_on_accept(on_accept) {
+}
+
+UnixDomainAcceptingSocket::~UnixDomainAcceptingSocket() {}
+
+bool UnixDomainAcceptingSocket::Listen(const string &path, mode_t, int) {
+  OLA_WARN << "Unix domain sockets aren't supported, can't listen on "
+           << path;
+  return false;
+}
+
+bool UnixDomainAcceptingSocket::Close() {
+  return true;
+}
+
+void UnixDomainAcceptingSocket::PerformRead() {}
+#endif  // !_WIN32
+}  // namespace network
+}  // namespace ola
@@ -0,0 +1,568 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * XDPReceiver.cpp
+ * Receive UDP datagrams with an AF_XDP socket.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/network/XDPReceiver.h"
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if HAVE_DECL_BPF_LINK_CREATE && defined(HAVE_LINUX_IF_XDP_H)
+#define OLA_HAVE_XDP 1
+#endif  // HAVE_DECL_BPF_LINK_CREATE && HAVE_LINUX_IF_XDP_H
+
+#ifdef OLA_HAVE_XDP
+#include <arpa/inet.h>
+#include <linux/bpf.h>
+#include <linux/if_ether.h>
+#include <linux/if_xdp.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // OLA_HAVE_XDP
+
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/util/Trace.h"
+
+namespace ola {
+namespace network {
+
+namespace {
+
+const unsigned int ETHERNET_HEADER_SIZE = 14;
+const unsigned int IP_HEADER_SIZE = 20;
+const unsigned int UDP_HEADER_SIZE = 8;
+const unsigned int HEADERS_SIZE = (ETHERNET_HEADER_SIZE + IP_HEADER_SIZE +
+                                   UDP_HEADER_SIZE);
+
+#ifdef OLA_HAVE_XDP
+// This puts the UDP payload on a 16 byte boundary.
+const unsigned int UMEM_HEADROOM = 6;
+const unsigned int PORT_COUNT = 1 << 16;
+
+int Bpf(int command, union bpf_attr *attr) {
+  return static_cast<int>(syscall(__NR_bpf, command, attr, sizeof(*attr)));
+}
+
+struct bpf_insn Instruction(uint8_t code, uint8_t dst, uint8_t src,
+                            int16_t offset, int32_t imm) {
+  struct bpf_insn insn;
+  insn.code = code;
+  insn.dst_reg = dst;
+  insn.src_reg = src;
+  insn.off = offset;
+  insn.imm = imm;
+  return insn;
+}
+
+/*
+ * Append a 64 bit load of a map fd, this takes two instructions.
+ */
+void LoadMap(std::vector<struct bpf_insn> *program, uint8_t dst, int map_fd) {
+  program->push_back(Instruction(BPF_LD | BPF_DW | BPF_IMM, dst,
+                                 BPF_PSEUDO_MAP_FD, 0, map_fd));
+  program->push_back(Instruction(0, 0, 0, 0, 0));
+}
+
+int CreateMap(uint32_t type, uint32_t value_size, uint32_t max_entries) {
+  union bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_type = type;
+  attr.key_size = sizeof(uint32_t);
+  attr.value_size = value_size;
+  attr.max_entries = max_entries;
+  return Bpf(BPF_MAP_CREATE, &attr);
+}
+
+bool UpdateMap(int map_fd, uint32_t key, const void *value) {
+  union bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = map_fd;
+  attr.key = reinterpret_cast<uint64_t>(&key);
+  attr.value = reinterpret_cast<uint64_t>(value);
+  attr.flags = BPF_ANY;
+  return Bpf(BPF_MAP_UPDATE_ELEM, &attr) == 0;
+}
+
+void CloseFD(int *fd) {
+  if (*fd >= 0) {
+    close(*fd);
+    *fd = -1;
+  }
+}
+#endif  // OLA_HAVE_XDP
+}  // namespace
+
+XDPReceiver::XDPReceiver(const Interface &iface,
+                         const XDPReceiverOptions &options)
+    : m_if_index(iface.index),
+      m_if_name(iface.name),
+      m_options(options),
+      m_handle(ola::io::INVALID_DESCRIPTOR),
+      m_umem(NULL),
+      m_ports_map_fd(-1),
+      m_xsks_map_fd(-1),
+      m_program_fd(-1),
+      m_link_fd(-1) {
+  memset(&m_rx, 0, sizeof(m_rx));
+  memset(&m_fill, 0, sizeof(m_fill));
+}
+
+XDPReceiver::~XDPReceiver() {
+  Close();
+  STLDeleteValues(&m_handlers);
+}
+
+bool XDPReceiver::Init() {
+#ifdef OLA_HAVE_XDP
+  if (m_if_index <= 0) {
+    OLA_WARN << "Unknown interface index for " << m_if_name;
+    return false;
+  }
+  const unsigned int frames = m_options.frame_count;
+  if (frames == 0 || (frames & (frames - 1))) {
+    OLA_WARN << "The XDP frame count must be a power of two, was " << frames;
+    return false;
+  }
+
+  if (!(SetupSocket() && SetupProgram())) {
+    Close();
+    return false;
+  }
+  OLA_INFO << "Receiving with AF_XDP on " << m_if_name << " queue "
+           << m_options.queue_id;
+  return true;
+#else
+  OLA_WARN << "AF_XDP isn't supported on this platform";
+  return false;
+#endif  // OLA_HAVE_XDP
+}
+
+bool XDPReceiver::AddPort(uint16_t port, DatagramHandler *handler) {
+  if (!STLInsertIfNotPresent(&m_handlers, port, handler)) {
+    OLA_WARN << "Port " << port << " is already registered with the "
+             << "XDPReceiver";
+    delete handler;
+    return false;
+  }
+  if (!SetPortEnabled(port, true)) {
+    STLRemoveAndDelete(&m_handlers, port);
+    return false;
+  }
+  return true;
+}
+
+bool XDPReceiver::RemovePort(uint16_t port) {
+  if (!STLRemoveAndDelete(&m_handlers, port)) {
+    return false;
+  }
+  SetPortEnabled(port, false);
+  return true;
+}
+
+/*
+ * Each datagram is dispatched from the shared memory area, then the frame is
+ * handed back to the kernel on the fill ring.
+ */
+void XDPReceiver::PerformRead() {
+#ifdef OLA_HAVE_XDP
+  OLA_TRACE_SCOPE("network", "XDPReceiver::PerformRead");
+  uint32_t rx_consumer = *m_rx.consumer;
+  const uint32_t rx_producer = __atomic_load_n(m_rx.producer,
+                                               __ATOMIC_ACQUIRE);
+  uint32_t fill_producer = *m_fill.producer;
+  const struct xdp_desc *descriptors =
+      static_cast<const struct xdp_desc*>(m_rx.descriptors);
+  uint64_t *fill = static_cast<uint64_t*>(m_fill.descriptors);
+
+  for (; rx_consumer != rx_producer; rx_consumer++) {
+    const struct xdp_desc &descriptor = descriptors[rx_consumer & m_rx.mask];
+    uint16_t port;
+    IPV4SocketAddress source;
+    const uint8_t *payload;
+    unsigned int payload_length;
+    if (ParseFrame(m_umem + descriptor.addr, descriptor.len, &port, &source,
+                   &payload, &payload_length)) {
+      DatagramHandler *handler = STLFindOrNull(m_handlers, port);
+      if (handler) {
+        handler->Run(payload, payload_length, source);
+      }
+    }
+    fill[fill_producer++ & m_fill.mask] = (
+        descriptor.addr & ~static_cast<uint64_t>(FRAME_SIZE - 1));
+  }
+  __atomic_store_n(m_rx.consumer, rx_consumer, __ATOMIC_RELEASE);
+  __atomic_store_n(m_fill.producer, fill_producer, __ATOMIC_RELEASE);
+#endif  // OLA_HAVE_XDP
+}
+
+bool XDPReceiver::ParseFrame(const uint8_t *frame,
+                             unsigned int length,
+                             uint16_t *port,
+                             IPV4SocketAddress *source,
+                             const uint8_t **payload,
+                             unsigned int *payload_length) {
+  if (length < HEADERS_SIZE) {
+    return false;
+  }
+  // Ethertype 0x0800, IPv4 with no options, UDP and not a fragment.
+  const uint8_t *ip = frame + ETHERNET_HEADER_SIZE;
+  if (frame[12] != 0x08 || frame[13] != 0x00 || ip[0] != 0x45 ||
+      ip[9] != 17 || (ip[6] & 0x3f) || ip[7]) {
+    return false;
+  }
+
+  const uint8_t *udp = ip + IP_HEADER_SIZE;
+  const unsigned int udp_length = (udp[4] << 8) + udp[5];
+  if (udp_length < UDP_HEADER_SIZE ||
+      udp_length > length - ETHERNET_HEADER_SIZE - IP_HEADER_SIZE) {
+    return false;
+  }
+
+  uint32_t source_ip;
+  memcpy(&source_ip, ip + 12, sizeof(source_ip));
+  *source = IPV4SocketAddress(IPV4Address(source_ip),
+                              static_cast<uint16_t>((udp[0] << 8) + udp[1]));
+  *port = static_cast<uint16_t>((udp[2] << 8) + udp[3]);
+  *payload = udp + UDP_HEADER_SIZE;
+  *payload_length = udp_length - UDP_HEADER_SIZE;
+  return true;
+}
+
+/*
+ * Create the UMEM, the AF_XDP socket and its rings, and bind it to the queue.
+ */
+bool XDPReceiver::SetupSocket() {
+#ifdef OLA_HAVE_XDP
+  const unsigned int frames = m_options.frame_count;
+  void *umem = mmap(NULL, frames * FRAME_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (umem == MAP_FAILED) {
+    OLA_WARN << "Failed to allocate the XDP UMEM: " << strerror(errno);
+    return false;
+  }
+  m_umem = static_cast<uint8_t*>(umem);
+
+  int fd = socket(AF_XDP, SOCK_RAW, 0);
+  if (fd < 0) {
+    OLA_WARN << "Failed to create an AF_XDP socket: " << strerror(errno);
+    return false;
+  }
+  m_handle = fd;
+
+  struct xdp_umem_reg umem_reg;
+  memset(&umem_reg, 0, sizeof(umem_reg));
+  umem_reg.addr = reinterpret_cast<uint64_t>(m_umem);
+  umem_reg.len = frames * FRAME_SIZE;
+  umem_reg.chunk_size = FRAME_SIZE;
+  umem_reg.headroom = UMEM_HEADROOM;
+  if (setsockopt(fd, SOL_XDP, XDP_UMEM_REG, &umem_reg, sizeof(umem_reg))) {
+    OLA_WARN << "Failed to register the XDP UMEM: " << strerror(errno);
+    return false;
+  }
+
+  // The completion ring is only used for transmit, but it must exist.
+  int ring_size = static_cast<int>(frames);
+  if (setsockopt(fd, SOL_XDP, XDP_UMEM_FILL_RING, &ring_size,
+                 sizeof(ring_size)) ||
+      setsockopt(fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &ring_size,
+                 sizeof(ring_size)) ||
+      setsockopt(fd, SOL_XDP, XDP_RX_RING, &ring_size, sizeof(ring_size))) {
+    OLA_WARN << "Failed to size the XDP rings: " << strerror(errno);
+    return false;
+  }
+
+  struct xdp_mmap_offsets offsets;
+  socklen_t offsets_size = sizeof(offsets);
+  if (getsockopt(fd, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &offsets_size)) {
+    OLA_WARN << "Failed to get the XDP ring offsets: " << strerror(errno);
+    return false;
+  }
+
+  struct {
+    Ring *ring;
+    const struct xdp_ring_offset *offsets;
+    off_t page_offset;
+    size_t descriptor_size;
+  } rings[] = {
+    {&m_rx, &offsets.rx, XDP_PGOFF_RX_RING, sizeof(struct xdp_desc)},
+    {&m_fill, &offsets.fr, XDP_UMEM_PGOFF_FILL_RING, sizeof(uint64_t)},
+  };
+  for (unsigned int i = 0; i < sizeof(rings) / sizeof(rings[0]); i++) {
+    Ring *ring = rings[i].ring;
+    size_t map_size = rings[i].offsets->desc +
+                      frames * rings[i].descriptor_size;
+    void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd, rings[i].page_offset);
+    if (map == MAP_FAILED) {
+      OLA_WARN << "Failed to map an XDP ring: " << strerror(errno);
+      return false;
+    }
+    uint8_t *base = static_cast<uint8_t*>(map);
+    ring->map = map;
+    ring->map_size = map_size;
+    ring->producer = reinterpret_cast<uint32_t*>(
+        base + rings[i].offsets->producer);
+    ring->consumer = reinterpret_cast<uint32_t*>(
+        base + rings[i].offsets->consumer);
+    ring->descriptors = base + rings[i].offsets->desc;
+    ring->mask = frames - 1;
+  }
+
+  // Give all the frames to the kernel.
+  uint64_t *fill = static_cast<uint64_t*>(m_fill.descriptors);
+  for (unsigned int i = 0; i < frames; i++) {
+    fill[i] = static_cast<uint64_t>(i) * FRAME_SIZE;
+  }
+  __atomic_store_n(m_fill.producer, frames, __ATOMIC_RELEASE);
+
+  // With no flags the kernel uses zero copy mode if the driver supports it.
+  struct sockaddr_xdp address;
+  memset(&address, 0, sizeof(address));
+  address.sxdp_family = AF_XDP;
+  address.sxdp_ifindex = m_if_index;
+  address.sxdp_queue_id = m_options.queue_id;
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address))) {
+    OLA_WARN << "Failed to bind the AF_XDP socket to " << m_if_name
+             << " queue " << m_options.queue_id << ": " << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif  // OLA_HAVE_XDP
+}
+
+/*
+ * Create the maps, load the program and attach it to the interface.
+ */
+bool XDPReceiver::SetupProgram() {
+#ifdef OLA_HAVE_XDP
+  m_ports_map_fd = CreateMap(BPF_MAP_TYPE_ARRAY, sizeof(uint8_t), PORT_COUNT);
+  m_xsks_map_fd = CreateMap(BPF_MAP_TYPE_XSKMAP, sizeof(uint32_t),
+                            m_options.queue_id + 1);
+  if (m_ports_map_fd < 0 || m_xsks_map_fd < 0) {
+    OLA_WARN << "Failed to create the XDP maps: " << strerror(errno);
+    return false;
+  }
+
+  uint32_t fd = static_cast<uint32_t>(m_handle);
+  if (!UpdateMap(m_xsks_map_fd, m_options.queue_id, &fd)) {
+    OLA_WARN << "Failed to add the AF_XDP socket to the map: "
+             << strerror(errno);
+    return false;
+  }
+
+  // Ports may have been added before Init() was called.
+  HandlerMap::const_iterator iter = m_handlers.begin();
+  for (; iter != m_handlers.end(); ++iter) {
+    SetPortEnabled(iter->first, true);
+  }
+
+  if (!LoadProgram()) {
+    return false;
+  }
+
+  union bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.link_create.prog_fd = m_program_fd;
+  attr.link_create.target_ifindex = m_if_index;
+  attr.link_create.attach_type = BPF_XDP;
+  m_link_fd = Bpf(BPF_LINK_CREATE, &attr);
+  if (m_link_fd < 0) {
+    OLA_WARN << "Failed to attach the XDP program to " << m_if_name << ": "
+             << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif  // OLA_HAVE_XDP
+}
+
+/*
+ * The program redirects unfragmented IPv4 UDP datagrams, without IP options,
+ * for the enabled ports to the AF_XDP socket for the queue. It matches
+ * ParseFrame().
+ */
+bool XDPReceiver::LoadProgram() {
+#ifdef OLA_HAVE_XDP
+  std::vector<struct bpf_insn> program;
+  std::vector<unsigned int> jumps_to_pass;
+
+  // r6 = ctx, r2 = data, r3 = data_end
+  program.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_X, 6, 1, 0, 0));
+  program.push_back(Instruction(BPF_LDX | BPF_MEM | BPF_W, 2, 6,
+                                offsetof(struct xdp_md, data), 0));
+  program.push_back(Instruction(BPF_LDX | BPF_MEM | BPF_W, 3, 6,
+                                offsetof(struct xdp_md, data_end), 0));
+
+  // if (data + HEADERS_SIZE > data_end) goto pass
+  program.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_X, 4, 2, 0, 0));
+  program.push_back(Instruction(BPF_ALU64 | BPF_ADD | BPF_K, 4, 0, 0,
+                                HEADERS_SIZE));
+  jumps_to_pass.push_back(program.size());
+  program.push_back(Instruction(BPF_JMP | BPF_JGT | BPF_X, 4, 3, 0, 0));
+
+  // The packet loads are in network byte order.
+  struct {
+    uint8_t size;
+    int16_t offset;
+    int32_t mask;
+    int32_t value;
+  } checks[] = {
+    {BPF_H, 12, 0, htons(ETH_P_IP)},
+    {BPF_B, ETHERNET_HEADER_SIZE, 0, 0x45},
+    {BPF_B, ETHERNET_HEADER_SIZE + 9, 0, IPPROTO_UDP},
+    {BPF_H, ETHERNET_HEADER_SIZE + 6, htons(0x3fff), 0},
+  };
+  for (unsigned int i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+    program.push_back(Instruction(BPF_LDX | BPF_MEM | checks[i].size, 4, 2,
+                                  checks[i].offset, 0));
+    if (checks[i].mask) {
+      program.push_back(Instruction(BPF_ALU64 | BPF_AND | BPF_K, 4, 0, 0,
+                                    checks[i].mask));
+    }
+    jumps_to_pass.push_back(program.size());
+    program.push_back(Instruction(BPF_JMP | BPF_JNE | BPF_K, 4, 0, 0,
+                                  checks[i].value));
+  }
+
+  // key = ntohs(udp->dest), if (!ports[key]) goto pass
+  program.push_back(Instruction(
+      BPF_LDX | BPF_MEM | BPF_H, 4, 2,
+      ETHERNET_HEADER_SIZE + IP_HEADER_SIZE + 2, 0));
+  program.push_back(Instruction(BPF_ALU | BPF_END | BPF_TO_BE, 4, 0, 0, 16));
+  program.push_back(Instruction(BPF_STX | BPF_MEM | BPF_W, 10, 4, -4, 0));
+  program.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_X, 2, 10, 0, 0));
+  program.push_back(Instruction(BPF_ALU64 | BPF_ADD | BPF_K, 2, 0, 0, -4));
+  LoadMap(&program, 1, m_ports_map_fd);
+  program.push_back(Instruction(BPF_JMP | BPF_CALL, 0, 0, 0,
+                                BPF_FUNC_map_lookup_elem));
+  jumps_to_pass.push_back(program.size());
+  program.push_back(Instruction(BPF_JMP | BPF_JEQ | BPF_K, 0, 0, 0, 0));
+  program.push_back(Instruction(BPF_LDX | BPF_MEM | BPF_B, 1, 0, 0, 0));
+  jumps_to_pass.push_back(program.size());
+  program.push_back(Instruction(BPF_JMP | BPF_JEQ | BPF_K, 1, 0, 0, 0));
+
+  // return bpf_redirect_map(&xsks, ctx->rx_queue_index, XDP_PASS)
+  program.push_back(Instruction(BPF_LDX | BPF_MEM | BPF_W, 2, 6,
+                                offsetof(struct xdp_md, rx_queue_index), 0));
+  LoadMap(&program, 1, m_xsks_map_fd);
+  program.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_K, 3, 0, 0,
+                                XDP_PASS));
+  program.push_back(Instruction(BPF_JMP | BPF_CALL, 0, 0, 0,
+                                BPF_FUNC_redirect_map));
+  program.push_back(Instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+  // pass: return XDP_PASS
+  const unsigned int pass = program.size();
+  program.push_back(Instruction(BPF_ALU64 | BPF_MOV | BPF_K, 0, 0, 0,
+                                XDP_PASS));
+  program.push_back(Instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+  std::vector<unsigned int>::const_iterator iter = jumps_to_pass.begin();
+  for (; iter != jumps_to_pass.end(); ++iter) {
+    program[*iter].off = static_cast<int16_t>(pass - *iter - 1);
+  }
+
+  static const char license[] = "GPL";
+  char log[4096] = "";
+  union bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.prog_type = BPF_PROG_TYPE_XDP;
+  attr.insns = reinterpret_cast<uint64_t>(&program[0]);
+  attr.insn_cnt = program.size();
+  attr.license = reinterpret_cast<uint64_t>(license);
+  attr.log_buf = reinterpret_cast<uint64_t>(log);
+  attr.log_size = sizeof(log);
+  attr.log_level = 1;
+  m_program_fd = Bpf(BPF_PROG_LOAD, &attr);
+  if (m_program_fd < 0) {
+    OLA_WARN << "Failed to load the XDP program: " << strerror(errno);
+    OLA_DEBUG << log;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif  // OLA_HAVE_XDP
+}
+
+bool XDPReceiver::SetPortEnabled(uint16_t port, bool enabled) {
+#ifdef OLA_HAVE_XDP
+  if (m_ports_map_fd < 0) {
+    // Not initialized yet, SetupProgram() enables the ports.
+    return true;
+  }
+  uint8_t value = enabled;
+  if (!UpdateMap(m_ports_map_fd, port, &value)) {
+    OLA_WARN << "Failed to update the XDP port map: " << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  (void) port;
+  (void) enabled;
+  return true;
+#endif  // OLA_HAVE_XDP
+}
+
+void XDPReceiver::Close() {
+#ifdef OLA_HAVE_XDP
+  // Closing the link detaches the program.
+  CloseFD(&m_link_fd);
+  CloseFD(&m_program_fd);
+  CloseFD(&m_xsks_map_fd);
+  CloseFD(&m_ports_map_fd);
+
+  Ring *rings[] = {&m_rx, &m_fill};
+  for (unsigned int i = 0; i < sizeof(rings) / sizeof(rings[0]); i++) {
+    if (rings[i]->map) {
+      munmap(rings[i]->map, rings[i]->map_size);
+    }
+    memset(rings[i], 0, sizeof(*rings[i]));
+  }
+
+  if (m_handle != ola::io::INVALID_DESCRIPTOR) {
+    close(m_handle);
+    m_handle = ola::io::INVALID_DESCRIPTOR;
+  }
+  if (m_umem) {
+    munmap(m_umem, m_options.frame_count * FRAME_SIZE);
+    m_umem = NULL;
+  }
+#endif  // OLA_HAVE_XDP
+}
+}  // namespace network
+}  // namespace ola
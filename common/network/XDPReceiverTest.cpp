@@ -0,0 +1,141 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * XDPReceiverTest.cpp
+ * Test fixture for the XDPReceiver class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/network/XDPReceiver.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::XDPReceiver;
+
+class XDPReceiverTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(XDPReceiverTest);
+  CPPUNIT_TEST(testParseFrame);
+  CPPUNIT_TEST(testInvalidFrames);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testParseFrame();
+  void testInvalidFrames();
+
+  void setUp();
+
+ private:
+  uint8_t m_frame[64];
+
+  bool Parse(unsigned int length);
+
+  uint16_t m_port;
+  IPV4SocketAddress m_source;
+  const uint8_t *m_payload;
+  unsigned int m_payload_length;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(XDPReceiverTest);
+
+
+/*
+ * Build a frame from 10.0.0.1:1234 to port 5568, with a 4 byte payload.
+ */
+void XDPReceiverTest::setUp() {
+  static const uint8_t frame[] = {
+    // Ethernet
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55,
+    0x08, 0x00,
+    // IPv4
+    0x45, 0x00, 0x00, 0x20, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11, 0x00, 0x00,
+    10, 0, 0, 1, 10, 0, 0, 255,
+    // UDP
+    0x04, 0xd2, 0x15, 0xc0, 0x00, 0x0c, 0x00, 0x00,
+    // Payload
+    'a', 'b', 'c', 'd',
+  };
+  memset(m_frame, 0, sizeof(m_frame));
+  memcpy(m_frame, frame, sizeof(frame));
+  m_port = 0;
+  m_payload = NULL;
+  m_payload_length = 0;
+}
+
+
+bool XDPReceiverTest::Parse(unsigned int length) {
+  return XDPReceiver::ParseFrame(m_frame, length, &m_port, &m_source,
+                                 &m_payload, &m_payload_length);
+}
+
+
+/*
+ * Check the payload is found, ignoring the Ethernet padding.
+ */
+void XDPReceiverTest::testParseFrame() {
+  OLA_ASSERT_TRUE(Parse(60));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(5568), m_port);
+  IPV4Address source_ip;
+  OLA_ASSERT_TRUE(IPV4Address::FromString("10.0.0.1", &source_ip));
+  OLA_ASSERT_EQ(IPV4SocketAddress(source_ip, 1234), m_source);
+  OLA_ASSERT_EQ(static_cast<const uint8_t*>(m_frame + 42), m_payload);
+  OLA_ASSERT_EQ(4u, m_payload_length);
+}
+
+
+/*
+ * Check frames the XDP program wouldn't redirect are rejected.
+ */
+void XDPReceiverTest::testInvalidFrames() {
+  // Truncated
+  OLA_ASSERT_FALSE(Parse(41));
+  OLA_ASSERT_FALSE(Parse(45));
+
+  // Not IPv4
+  m_frame[12] = 0x86;
+  m_frame[13] = 0xdd;
+  OLA_ASSERT_FALSE(Parse(60));
+  setUp();
+
+  // IP options
+  m_frame[14] = 0x46;
+  OLA_ASSERT_FALSE(Parse(60));
+  setUp();
+
+  // TCP
+  m_frame[23] = 6;
+  OLA_ASSERT_FALSE(Parse(60));
+  setUp();
+
+  // More fragments
+  m_frame[20] = 0x20;
+  OLA_ASSERT_FALSE(Parse(60));
+  setUp();
+
+  // A later fragment
+  m_frame[21] = 0x01;
+  OLA_ASSERT_FALSE(Parse(60));
+  setUp();
+
+  // UDP length shorter than the header
+  m_frame[39] = 0x07;
+  OLA_ASSERT_FALSE(Parse(60));
+}
@@ -18,6 +18,8 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <algorithm>
+
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/rdm/DiscoveryAgent.h"
@@ -42,10 +44,15 @@ DiscoveryAgent::DiscoveryAgent(DiscoveryTargetInterface *target)
         ola::NewCallback(this, &DiscoveryAgent::BranchMuteComplete)),
       m_branch_callback(
         ola::NewCallback(this, &DiscoveryAgent::BranchComplete)),
+      m_termination_callback(
+        ola::NewCallback(this, &DiscoveryAgent::TerminationBranchComplete)),
       m_muting_uid(0, 0),
       m_unmute_count(0),
       m_mute_attempts(0),
-      m_tree_corrupt(false) {
+      m_tree_corrupt(false),
+      m_early_termination(false),
+      m_expected_count(0),
+      m_check_termination(false) {
 }
 
 DiscoveryAgent::~DiscoveryAgent() {
@@ -103,17 +110,27 @@ void DiscoveryAgent::InitDiscovery(
     FreeCurrentRange();
   }
 
-  if (incremental) {
-    UIDSet::Iterator iter = m_uids.Begin();
-    for (; iter != m_uids.End(); ++iter) {
-      m_uids_to_mute.push(*iter);
-    }
-  } else {
+  m_expected_count = m_uids.Size();
+  if (!incremental) {
     m_uids.Clear();
   }
 
+  // Cached UIDs are verified by muting them, the same as incremental
+  // discovery does for the UIDs we already know about.
+  if (!m_cached_uids.Empty()) {
+    m_uids = m_uids.Union(m_cached_uids);
+    m_expected_count = std::max(m_expected_count, m_uids.Size());
+    m_cached_uids.Clear();
+  }
+
+  UIDSet::Iterator iter = m_uids.Begin();
+  for (; iter != m_uids.End(); ++iter) {
+    m_uids_to_mute.push(*iter);
+  }
+
   m_bad_uids.Clear();
   m_tree_corrupt = false;
+  m_check_termination = false;
 
   // push the first range on to the branch stack
   UID lower(0, 0);
@@ -126,7 +143,7 @@ void DiscoveryAgent::InitDiscovery(
 /*
  * Called when the UnMute completes. This resends the Unmute command up to
  * BROADCAST_UNMUTE_REPEATS times and then starts muting previously known
- * devices (incremental only).
+ * devices (incremental or cached only).
  */
 void DiscoveryAgent::UnMuteComplete() {
   if (m_uid_ranges.empty()) {
@@ -143,8 +160,8 @@ void DiscoveryAgent::UnMuteComplete() {
 }
 
 /*
- * If we're in incremental mode, mute previously discovered devices. Otherwise
- * proceed to the branch stage.
+ * If we're in incremental mode, or have cached UIDs, mute previously
+ * discovered devices. Otherwise proceed to the branch stage.
  */
 void DiscoveryAgent::MaybeMuteNextDevice() {
   if (m_uids_to_mute.empty()) {
@@ -184,6 +201,11 @@ void DiscoveryAgent::SendDiscovery() {
     }
     return;
   }
+
+  if (MaybeTerminateEarly()) {
+    return;
+  }
+
   UIDRange *range = m_uid_ranges.top();
   if (range->uids_discovered == 0) {
     range->attempt++;
@@ -208,6 +230,43 @@ void DiscoveryAgent::SendDiscovery() {
   }
 }
 
+/*
+ * If early termination is enabled and we've found at least as many responders
+ * as the previous run, send a DUB for the entire UID range. Every responder
+ * we know about is muted, so if nothing replies there is no need to visit the
+ * remaining branches.
+ * @returns true if the DUB was sent, false otherwise.
+ */
+bool DiscoveryAgent::MaybeTerminateEarly() {
+  if (!m_early_termination || !m_check_termination || !m_expected_count ||
+      m_uids.Size() < m_expected_count || m_uid_ranges.size() < 2) {
+    return false;
+  }
+
+  m_check_termination = false;
+  OLA_DEBUG << "Found " << m_uids.Size() << " of " << m_expected_count
+            << " expected responders, checking for others";
+  m_target->Branch(UID(0, 0), UID::AllDevices(),
+                   m_termination_callback.get());
+  return true;
+}
+
+/*
+ * Handle the response to the DUB sent by MaybeTerminateEarly().
+ */
+void DiscoveryAgent::TerminationBranchComplete(const uint8_t*,
+                                               unsigned int length) {
+  if (length == 0) {
+    OLA_DEBUG << "No unmuted responders, skipping " << m_uid_ranges.size()
+              << " branches";
+    while (!m_uid_ranges.empty()) {
+      FreeCurrentRange();
+    }
+  }
+  // Otherwise there are other responders, continue with the current branch.
+  SendDiscovery();
+}
+
 /*
  * Handle a DUB response (inc. timeouts).
  * @param data the raw response, excluding the start code
@@ -331,6 +390,7 @@ void DiscoveryAgent::BranchMuteComplete(bool status) {
   if (status) {
     m_uids.AddUID(m_muting_uid);
     m_uid_ranges.top()->uids_discovered++;
+    m_check_termination = true;
   } else {
     // failed to mute, if we haven't reached the limit try it again
     if (m_mute_attempts < MAX_MUTE_ATTEMPTS) {
@@ -51,6 +51,8 @@ class DiscoveryAgentTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testNonMutingResponder);
   CPPUNIT_TEST(testFlakeyResponder);
   CPPUNIT_TEST(testProxy);
+  CPPUNIT_TEST(testCachedUIDs);
+  CPPUNIT_TEST(testEarlyTermination);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -69,6 +71,8 @@ class DiscoveryAgentTest: public CppUnit::TestFixture {
     void testNonMutingResponder();
     void testFlakeyResponder();
     void testProxy();
+    void testCachedUIDs();
+    void testEarlyTermination();
 
  private:
     bool m_callback_run;
@@ -479,3 +483,85 @@ void DiscoveryAgentTest::testProxy() {
   OLA_ASSERT_TRUE(m_callback_run);
   m_callback_run = false;
 }
+
+
+/**
+ * Test seeding discovery with cached UIDs.
+ */
+void DiscoveryAgentTest::testCachedUIDs() {
+  UIDSet uids;
+  ResponderList responders;
+  uids.AddUID(UID(0x7a70, 0x00002001));
+  uids.AddUID(UID(0x7a70, 0x00002002));
+  uids.AddUID(UID(0x7a77, 0x00002002));
+  PopulateResponderListFromUIDs(uids, &responders);
+  MockDiscoveryTarget target(responders);
+
+  // The cache contains a responder that has since gone
+  UIDSet cached_uids = uids;
+  cached_uids.AddUID(UID(0x8080, 0x00103456));
+
+  DiscoveryAgent agent(&target);
+  agent.SetCachedUIDs(cached_uids);
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+  // All the responders were muted, so only a single DUB is required.
+  OLA_ASSERT_EQ(1u, target.BranchCallCount());
+  m_callback_run = false;
+
+  // The cache is only used once, so this finds the responders by branching.
+  target.ResetCounters();
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+  OLA_ASSERT_TRUE(target.BranchCallCount() > 1);
+}
+
+
+/**
+ * Test that branching stops once the expected responders have been found.
+ */
+void DiscoveryAgentTest::testEarlyTermination() {
+  UIDSet uids;
+  ResponderList responders;
+  uids.AddUID(UID(0x7a70, 0x00000001));
+  uids.AddUID(UID(0x7a70, 0x00000002));
+  uids.AddUID(UID(0x7a70, 0x00000003));
+  PopulateResponderListFromUIDs(uids, &responders);
+  MockDiscoveryTarget target(responders);
+
+  DiscoveryAgent agent(&target);
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+  unsigned int full_branch_count = target.BranchCallCount();
+  m_callback_run = false;
+
+  agent.SetEarlyTermination(true);
+  target.ResetCounters();
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+  OLA_ASSERT_TRUE(target.BranchCallCount() < full_branch_count);
+  m_callback_run = false;
+
+  // A new responder is still found, even though the expected count is reached
+  // before it's discovered.
+  UID new_uid(0x7a70, 0x00000004);
+  uids.AddUID(new_uid);
+  target.AddResponder(new MockResponder(new_uid));
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+}
@@ -340,7 +340,8 @@ class MockDiscoveryTarget: public ola::rdm::DiscoveryTargetInterface {
  public:
     explicit MockDiscoveryTarget(const ResponderList &responders)
         : m_responders(responders),
-          m_unmute_calls(0) {
+          m_unmute_calls(0),
+          m_branch_calls(0) {
     }
 
     ~MockDiscoveryTarget() {
@@ -351,12 +352,17 @@ class MockDiscoveryTarget: public ola::rdm::DiscoveryTargetInterface {
 
     void ResetCounters() {
       m_unmute_calls = 0;
+      m_branch_calls = 0;
     }
 
     unsigned int UnmuteCallCount() const {
       return m_unmute_calls;
     }
 
+    unsigned int BranchCallCount() const {
+      return m_branch_calls;
+    }
+
     // Mute a device
     void MuteDevice(const ola::rdm::UID &target,
                     MuteDeviceCallback *mute_complete) {
@@ -385,6 +391,7 @@ class MockDiscoveryTarget: public ola::rdm::DiscoveryTargetInterface {
     void Branch(const ola::rdm::UID &lower,
                 const ola::rdm::UID &upper,
                 BranchCallback *callback) {
+      m_branch_calls++;
       // alloc twice the amount we need
       unsigned int data_size = 2 * MockResponder::DISCOVERY_RESPONSE_SIZE;
       uint8_t data[data_size];
@@ -426,5 +433,6 @@ class MockDiscoveryTarget: public ola::rdm::DiscoveryTargetInterface {
  private:
     ResponderList m_responders;
     unsigned int m_unmute_calls;
+    unsigned int m_branch_calls;
 };
 #endif  // COMMON_RDM_DISCOVERYAGENTTESTHELPER_H_
@@ -27,6 +27,8 @@ common_libolacommon_la_SOURCES += \
     common/rdm/NetworkManager.h \
     common/rdm/NetworkResponder.cpp \
     common/rdm/OpenLightingEnums.cpp \
+    common/rdm/PidIndex.cpp \
+    common/rdm/PidIndex.h \
     common/rdm/PidStore.cpp \
     common/rdm/PidStoreHelper.cpp \
     common/rdm/PidStoreLoader.cpp \
@@ -35,6 +37,7 @@ common_libolacommon_la_SOURCES += \
     common/rdm/RDMAPI.cpp \
     common/rdm/RDMCommand.cpp \
     common/rdm/RDMCommandSerializer.cpp \
+    common/rdm/RDMCommandView.cpp \
     common/rdm/RDMFrame.cpp \
     common/rdm/RDMHelper.cpp \
     common/rdm/RDMReply.cpp \
@@ -119,6 +122,7 @@ common_rdm_RDMAPITester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_rdm_RDMCommandTester_SOURCES = \
     common/rdm/RDMCommandTest.cpp \
+    common/rdm/RDMCommandViewTest.cpp \
     common/rdm/TestHelper.h
 common_rdm_RDMCommandTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_RDMCommandTester_LDADD = $(COMMON_TESTING_LIBS)
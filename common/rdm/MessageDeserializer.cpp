@@ -19,6 +19,8 @@
  */
 
 #include <ola/StringUtils.h>
+#include <ola/messaging/Descriptor.h>
+#include <ola/messaging/DescriptorLayout.h>
 #include <ola/messaging/Message.h>
 #include <ola/network/NetworkUtils.h>
 #include <ola/rdm/MessageDeserializer.h>
@@ -31,10 +33,94 @@
 namespace ola {
 namespace rdm {
 
+using ola::messaging::DescriptorLayout;
 using ola::messaging::MessageFieldInterface;
 using std::string;
 using std::vector;
 
+namespace {
+
+/*
+ * Deserialize an integer value, converting from little endian if needed
+ */
+template <typename int_type>
+const MessageFieldInterface *InflateInt(const DescriptorLayout::Op &op,
+                                        const uint8_t *data) {
+  int_type value;
+  memcpy(reinterpret_cast<uint8_t*>(&value), data, sizeof(int_type));
+
+  if (op.little_endian) {
+    value = ola::network::LittleEndianToHost(value);
+  } else {
+    value = ola::network::NetworkToHost(value);
+  }
+
+  return new ola::messaging::BasicMessageField<int_type>(
+      static_cast<const ola::messaging::IntegerFieldDescriptor<int_type>*>(
+          op.descriptor),
+      value);
+}
+
+/*
+ * Deserialize a single field, the caller has checked there is enough data.
+ */
+const MessageFieldInterface *InflateField(const DescriptorLayout::Op &op,
+                                          const uint8_t *data,
+                                          unsigned int size) {
+  switch (op.code) {
+    case DescriptorLayout::BOOL:
+      return new ola::messaging::BoolMessageField(
+          static_cast<const ola::messaging::BoolFieldDescriptor*>(
+              op.descriptor),
+          data[0]);
+    case DescriptorLayout::UINT8:
+      return InflateInt<uint8_t>(op, data);
+    case DescriptorLayout::UINT16:
+      return InflateInt<uint16_t>(op, data);
+    case DescriptorLayout::UINT32:
+      return InflateInt<uint32_t>(op, data);
+    case DescriptorLayout::INT8:
+      return InflateInt<int8_t>(op, data);
+    case DescriptorLayout::INT16:
+      return InflateInt<int16_t>(op, data);
+    case DescriptorLayout::INT32:
+      return InflateInt<int32_t>(op, data);
+    case DescriptorLayout::IPV4:
+      {
+        uint32_t address;
+        memcpy(&address, data, sizeof(address));
+        return new ola::messaging::IPV4MessageField(
+            static_cast<const ola::messaging::IPV4FieldDescriptor*>(
+                op.descriptor),
+            ola::network::IPV4Address(address));
+      }
+    case DescriptorLayout::MAC:
+      return new ola::messaging::MACMessageField(
+          static_cast<const ola::messaging::MACFieldDescriptor*>(
+              op.descriptor),
+          ola::network::MACAddress(data));
+    case DescriptorLayout::UID:
+      return new ola::messaging::UIDMessageField(
+          static_cast<const ola::messaging::UIDFieldDescriptor*>(
+              op.descriptor),
+          UID(data));
+    case DescriptorLayout::STRING:
+      {
+        string value(reinterpret_cast<const char*>(data), size);
+        ShortenString(&value);
+        return new ola::messaging::StringMessageField(
+            static_cast<const ola::messaging::StringFieldDescriptor*>(
+                op.descriptor),
+            value);
+      }
+    case DescriptorLayout::GROUP:
+      break;
+  }
+  return NULL;
+}
+}  // namespace
+
+
 MessageDeserializer::MessageDeserializer()
     : m_data(NULL),
       m_length(0),
@@ -44,9 +130,7 @@ MessageDeserializer::MessageDeserializer()
 }
 
 
-MessageDeserializer::~MessageDeserializer() {
-  CleanUpVector();
-}
+MessageDeserializer::~MessageDeserializer() {}
 
 
 /**
@@ -66,8 +150,6 @@ const ola::messaging::Message *MessageDeserializer::InflateMessage(
   m_offset = 0;
   m_insufficient_data = false;
 
-  CleanUpVector();
-
   VariableFieldSizeCalculator calculator;
   VariableFieldSizeCalculator::calculator_state state =
     calculator.CalculateFieldSize(
@@ -89,216 +171,59 @@ const ola::messaging::Message *MessageDeserializer::InflateMessage(
         return NULL;
   }
 
-  message_vector root_messages;
-  m_message_stack.push(root_messages);
+  const DescriptorLayout::OpList &ops = descriptor->Layout().Ops();
+  message_vector fields;
+  InflateFields(ops, 0, ops.size(), &fields);
 
-  descriptor->Accept(this);
+  const ola::messaging::Message *message =  new ola::messaging::Message(
+      fields);
 
   // this should never trigger because we check the length in the
   // VariableFieldSizeCalculator
   if (m_insufficient_data) {
+    delete message;
     return NULL;
   }
-
-  const ola::messaging::Message *message =  new ola::messaging::Message(
-      m_message_stack.top());
-  m_message_stack.top().clear();
   return message;
 }
 
 
-void MessageDeserializer::Visit(
-    const ola::messaging::BoolFieldDescriptor *descriptor) {
-  if (!CheckForData(descriptor->MaxSize())) {
-    return;
-  }
-
-  m_message_stack.top().push_back(
-    new ola::messaging::BoolMessageField(descriptor, m_data[m_offset++]));
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::IPV4FieldDescriptor *descriptor) {
-  if (!CheckForData(descriptor->MaxSize())) {
-    return;
-  }
-
-  uint32_t data;
-  memcpy(&data, m_data + m_offset, sizeof(data));
-  m_offset += sizeof(data);
-  m_message_stack.top().push_back(
-    new ola::messaging::IPV4MessageField(
-      descriptor,
-      ola::network::IPV4Address(data)));
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::MACFieldDescriptor *descriptor) {
-  if (!CheckForData(descriptor->MaxSize())) {
-    return;
-  }
-
-  ola::network::MACAddress mac_address(m_data + m_offset);
-  m_offset += descriptor->MaxSize();
-  m_message_stack.top().push_back(
-    new ola::messaging::MACMessageField(descriptor, mac_address));
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::UIDFieldDescriptor *descriptor) {
-  if (!CheckForData(descriptor->MaxSize())) {
-    return;
-  }
-
-  ola::rdm::UID uid(m_data + m_offset);
-  m_offset += descriptor->MaxSize();
-  m_message_stack.top().push_back(
-    new ola::messaging::UIDMessageField(descriptor, uid));
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::StringFieldDescriptor *descriptor) {
-  unsigned int string_size;
-
-  if (descriptor->FixedSize()) {
-    string_size = descriptor->MaxSize();
-  } else {
-    // variable sized string, the length is in m_variable_field_size
-    string_size = m_variable_field_size;
-  }
-
-  if (!CheckForData(string_size)) {
-    return;
-  }
-
-  string value(reinterpret_cast<const char *>(m_data + m_offset), string_size);
-  ShortenString(&value);
-  m_offset += string_size;
-  m_message_stack.top().push_back(
-    new ola::messaging::StringMessageField(descriptor, value));
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::IntegerFieldDescriptor<uint8_t> *descriptor) {
-  IntVisit(descriptor);
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::IntegerFieldDescriptor<uint16_t> *descriptor) {
-  IntVisit(descriptor);
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::IntegerFieldDescriptor<uint32_t> *descriptor) {
-  IntVisit(descriptor);
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::IntegerFieldDescriptor<int8_t> *descriptor) {
-  IntVisit(descriptor);
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::IntegerFieldDescriptor<int16_t> *descriptor) {
-  IntVisit(descriptor);
-}
-
-
-void MessageDeserializer::Visit(
-    const ola::messaging::IntegerFieldDescriptor<int32_t> *descriptor) {
-  IntVisit(descriptor);
-}
-
-
 /**
- * @brief Visit a group field
+ * @brief Deserialize the fields for the ops in the range [begin, end).
  */
-void MessageDeserializer::Visit(
-    const ola::messaging::FieldDescriptorGroup *descriptor) {
-
-  unsigned int iterations = descriptor->FixedSize() ? descriptor->MinBlocks() :
-    m_variable_field_size;
-
-  for (unsigned int i = 0; i < iterations; ++i) {
-    vector<const MessageFieldInterface*> fields;
-    m_message_stack.push(fields);
-
-    for (unsigned int j = 0; j < descriptor->FieldCount(); ++j) {
-      descriptor->GetField(j)->Accept(this);
+void MessageDeserializer::InflateFields(const DescriptorLayout::OpList &ops,
+                                        unsigned int begin,
+                                        unsigned int end,
+                                        message_vector *fields) {
+  unsigned int i = begin;
+  while (i < end && !m_insufficient_data) {
+    const DescriptorLayout::Op &op = ops[i];
+    if (op.code == DescriptorLayout::GROUP) {
+      const ola::messaging::FieldDescriptorGroup *descriptor =
+          static_cast<const ola::messaging::FieldDescriptorGroup*>(
+              op.descriptor);
+      unsigned int iterations = op.variable ? m_variable_field_size :
+          op.blocks;
+      for (unsigned int j = 0; j < iterations && !m_insufficient_data; ++j) {
+        message_vector group_fields;
+        InflateFields(ops, i + 1, op.end, &group_fields);
+        fields->push_back(
+            new ola::messaging::GroupMessageField(descriptor, group_fields));
+      }
+      i = op.end;
+      continue;
     }
 
-    const vector<const MessageFieldInterface*> &populated_fields =
-        m_message_stack.top();
-    const ola::messaging::MessageFieldInterface *message =
-        new ola::messaging::GroupMessageField(descriptor, populated_fields);
-    m_message_stack.pop();
-    m_message_stack.top().push_back(message);
-  }
-}
-
-
-/**
- * @brief Check that there is at least required_size bytes of data left.
- */
-bool MessageDeserializer::CheckForData(unsigned int required_size) {
-  if (required_size <= m_length - m_offset) {
-    return true;
-  }
-  m_insufficient_data = true;
-  return false;
-}
-
-
-
-/**
- * @brief Remove any old messages from the stack.
- */
-void MessageDeserializer::CleanUpVector() {
-  while (!m_message_stack.empty()) {
-    const message_vector &fields = m_message_stack.top();
-    message_vector::const_iterator iter = fields.begin();
-    for (; iter != fields.end(); ++iter) {
-      delete *iter;
+    // A variable sized string has the length in m_variable_field_size
+    unsigned int size = op.variable ? m_variable_field_size : op.size;
+    if (size > m_length - m_offset) {
+      m_insufficient_data = true;
+      return;
     }
-    m_message_stack.pop();
+    fields->push_back(InflateField(op, m_data + m_offset, size));
+    m_offset += size;
+    i++;
   }
 }
-
-
-/**
- * @brief Deserialize an integer value, converting from little endian if needed
- */
-template <typename int_type>
-void MessageDeserializer::IntVisit(
-    const ola::messaging::IntegerFieldDescriptor<int_type> *descriptor) {
-  if (!CheckForData(sizeof(int_type))) {
-    return;
-  }
-
-  int_type value;
-
-  memcpy(reinterpret_cast<uint8_t*>(&value),
-         m_data + m_offset,
-         sizeof(int_type));
-  m_offset += sizeof(int_type);
-
-  if (descriptor->IsLittleEndian()) {
-    value = ola::network::LittleEndianToHost(value);
-  } else {
-    value = ola::network::NetworkToHost(value);
-  }
-
-  m_message_stack.top().push_back(
-    new ola::messaging::BasicMessageField<int_type>(descriptor, value));
-}
 }  // namespace rdm
 }  // namespace ola
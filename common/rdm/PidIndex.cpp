@@ -0,0 +1,125 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PidIndex.cpp
+ * Flat hash indexes for looking up PidDescriptors.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string>
+#include <vector>
+
+#include "common/rdm/PidIndex.h"
+#include "ola/rdm/PidStore.h"
+
+namespace ola {
+namespace rdm {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * Return the shift that gives a power of two table at most half full.
+ */
+unsigned int TableShift(unsigned int entries) {
+  unsigned int bits = 3;
+  while ((1u << bits) < entries * 2) {
+    bits++;
+  }
+  return 32 - bits;
+}
+
+/*
+ * Fibonacci hashing, the top bits of the product are the slot.
+ */
+inline unsigned int SlotForHash(uint32_t hash, unsigned int shift) {
+  return (hash * 2654435769u) >> shift;
+}
+
+/*
+ * The 32 bit FNV-1a hash.
+ */
+uint32_t NameHash(const string &name) {
+  uint32_t hash = 2166136261u;
+  for (string::const_iterator iter = name.begin(); iter != name.end();
+       ++iter) {
+    hash ^= static_cast<uint8_t>(*iter);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+}  // namespace
+
+PidValueIndex::PidValueIndex(const vector<Entry> &entries)
+    : m_shift(TableShift(entries.size())) {
+  const Slot empty = {0, NULL};
+  m_slots.resize(1u << (32 - m_shift), empty);
+  const unsigned int mask = m_slots.size() - 1;
+
+  vector<Entry>::const_iterator iter = entries.begin();
+  for (; iter != entries.end(); ++iter) {
+    unsigned int i = SlotForHash(iter->first, m_shift);
+    while (m_slots[i].descriptor) {
+      i = (i + 1) & mask;
+    }
+    m_slots[i].key = iter->first;
+    m_slots[i].descriptor = iter->second;
+  }
+}
+
+const PidDescriptor *PidValueIndex::Lookup(uint32_t key) const {
+  const unsigned int mask = m_slots.size() - 1;
+  for (unsigned int i = SlotForHash(key, m_shift); m_slots[i].descriptor;
+       i = (i + 1) & mask) {
+    if (m_slots[i].key == key) {
+      return m_slots[i].descriptor;
+    }
+  }
+  return NULL;
+}
+
+PidNameIndex::PidNameIndex(const vector<const PidDescriptor*> &pids)
+    : m_shift(TableShift(pids.size())) {
+  const Slot empty = {0, NULL};
+  m_slots.resize(1u << (32 - m_shift), empty);
+  const unsigned int mask = m_slots.size() - 1;
+
+  vector<const PidDescriptor*>::const_iterator iter = pids.begin();
+  for (; iter != pids.end(); ++iter) {
+    const uint32_t hash = NameHash((*iter)->Name());
+    unsigned int i = SlotForHash(hash, m_shift);
+    while (m_slots[i].descriptor) {
+      i = (i + 1) & mask;
+    }
+    m_slots[i].hash = hash;
+    m_slots[i].descriptor = *iter;
+  }
+}
+
+const PidDescriptor *PidNameIndex::Lookup(const string &name) const {
+  const uint32_t hash = NameHash(name);
+  const unsigned int mask = m_slots.size() - 1;
+  for (unsigned int i = SlotForHash(hash, m_shift); m_slots[i].descriptor;
+       i = (i + 1) & mask) {
+    if (m_slots[i].hash == hash && m_slots[i].descriptor->Name() == name) {
+      return m_slots[i].descriptor;
+    }
+  }
+  return NULL;
+}
+}  // namespace rdm
+}  // namespace ola
@@ -0,0 +1,103 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PidIndex.h
+ * Flat hash indexes for looking up PidDescriptors.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_RDM_PIDINDEX_H_
+#define COMMON_RDM_PIDINDEX_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ola {
+namespace rdm {
+
+class PidDescriptor;
+
+/**
+ * @brief An open addressing hash table from a 32 bit key to a PidDescriptor.
+ *
+ * The table is built once and never modified. It's kept at most half full,
+ * so a lookup is usually a single probe into a contiguous array.
+ */
+class PidValueIndex {
+ public:
+  typedef std::pair<uint32_t, const PidDescriptor*> Entry;
+
+  /**
+   * @brief Build the index.
+   * @param entries the keys & descriptors. The keys must be unique.
+   */
+  explicit PidValueIndex(const std::vector<Entry> &entries);
+
+  /**
+   * @brief Lookup a descriptor.
+   * @returns the descriptor, or NULL if the key isn't in the index.
+   */
+  const PidDescriptor *Lookup(uint32_t key) const;
+
+ private:
+  struct Slot {
+    uint32_t key;
+    const PidDescriptor *descriptor;
+  };
+
+  std::vector<Slot> m_slots;
+  unsigned int m_shift;
+
+  DISALLOW_COPY_AND_ASSIGN(PidValueIndex);
+};
+
+
+/**
+ * @brief An open addressing hash table from a PID name to a PidDescriptor.
+ *
+ * The hash of each name is stored in the table, so the names are only
+ * compared when the hashes match.
+ */
+class PidNameIndex {
+ public:
+  /**
+   * @brief Build the index.
+   * @param pids the descriptors to index. The names must be unique.
+   */
+  explicit PidNameIndex(const std::vector<const PidDescriptor*> &pids);
+
+  /**
+   * @brief Lookup a descriptor by name.
+   * @returns the descriptor, or NULL if the name isn't in the index.
+   */
+  const PidDescriptor *Lookup(const std::string &name) const;
+
+ private:
+  struct Slot {
+    uint32_t hash;
+    const PidDescriptor *descriptor;
+  };
+
+  std::vector<Slot> m_slots;
+  unsigned int m_shift;
+
+  DISALLOW_COPY_AND_ASSIGN(PidNameIndex);
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // COMMON_RDM_PIDINDEX_H_
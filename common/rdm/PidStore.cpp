@@ -18,9 +18,11 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#include "common/rdm/PidIndex.h"
 #include "common/rdm/PidStoreLoader.h"
 #include "ola/StringUtils.h"
 #include "ola/rdm/PidStore.h"
@@ -33,6 +35,35 @@ namespace rdm {
 using std::string;
 using std::vector;
 
+namespace {
+
+bool ComparePidValues(const PidDescriptor *first,
+                      const PidDescriptor *second) {
+  return first->Value() < second->Value();
+}
+}  // namespace
+
+RootPidStore::RootPidStore(const PidStore *esta_store,
+                           const ManufacturerMap &manufacturer_stores,
+                           uint64_t version)
+    : m_esta_store(esta_store),
+      m_manufacturer_store(manufacturer_stores),
+      m_version(version) {
+  vector<PidValueIndex::Entry> entries;
+  ManufacturerMap::const_iterator iter = m_manufacturer_store.begin();
+  for (; iter != m_manufacturer_store.end(); ++iter) {
+    vector<const PidDescriptor*> pids;
+    iter->second->AllPids(&pids);
+    vector<const PidDescriptor*>::const_iterator pid_iter = pids.begin();
+    for (; pid_iter != pids.end(); ++pid_iter) {
+      entries.push_back(PidValueIndex::Entry(
+          (static_cast<uint32_t>(iter->first) << 16) | (*pid_iter)->Value(),
+          *pid_iter));
+    }
+  }
+  m_manufacturer_index.reset(new PidValueIndex(entries));
+}
+
 RootPidStore::~RootPidStore() {
   m_esta_store.reset();
   STLDeleteValues(&m_manufacturer_store);
@@ -86,13 +117,8 @@ const PidDescriptor *RootPidStore::GetDescriptor(
     return descriptor;
 
   // now try the specific manufacturer store
-  const PidStore *store = ManufacturerStore(manufacturer_id);
-  if (store) {
-    const PidDescriptor *descriptor = store->LookupPID(pid_value);
-    if (descriptor)
-      return descriptor;
-  }
-  return NULL;
+  return m_manufacturer_index->Lookup(
+      (static_cast<uint32_t>(manufacturer_id) << 16) | pid_value);
 }
 
 const PidDescriptor *RootPidStore::InternalESTANameLookup(
@@ -128,26 +154,28 @@ const string RootPidStore::DataLocation() {
   return PID_DATA_DIR;
 }
 
-PidStore::PidStore(const vector<const PidDescriptor*> &pids) {
-  vector<const PidDescriptor*>::const_iterator iter = pids.begin();
-  for (; iter != pids.end(); ++iter) {
-    m_pid_by_value[(*iter)->Value()] = *iter;
-    m_pid_by_name[(*iter)->Name()] = *iter;
+PidStore::PidStore(const vector<const PidDescriptor*> &pids)
+    : m_pids(pids) {
+  std::sort(m_pids.begin(), m_pids.end(), ComparePidValues);
+
+  vector<PidValueIndex::Entry> entries;
+  entries.reserve(m_pids.size());
+  vector<const PidDescriptor*>::const_iterator iter = m_pids.begin();
+  for (; iter != m_pids.end(); ++iter) {
+    entries.push_back(PidValueIndex::Entry((*iter)->Value(), *iter));
   }
+  m_value_index.reset(new PidValueIndex(entries));
+  m_name_index.reset(new PidNameIndex(m_pids));
 }
 
 PidStore::~PidStore() {
-  STLDeleteValues(&m_pid_by_value);
-  m_pid_by_name.clear();
+  m_value_index.reset();
+  m_name_index.reset();
+  STLDeleteElements(&m_pids);
 }
 
 void PidStore::AllPids(vector<const PidDescriptor*> *pids) const {
-  pids->reserve(pids->size() + m_pid_by_value.size());
-
-  PidMap::const_iterator iter = m_pid_by_value.begin();
-  for (; iter != m_pid_by_value.end(); ++iter) {
-    pids->push_back(iter->second);
-  }
+  pids->insert(pids->end(), m_pids.begin(), m_pids.end());
 }
 
 
@@ -167,11 +195,7 @@ PidDescriptor::~PidDescriptor() {
  * @param pid_value the 16 bit pid value.
  */
 const PidDescriptor *PidStore::LookupPID(uint16_t pid_value) const {
-  PidMap::const_iterator iter = m_pid_by_value.find(pid_value);
-  if (iter == m_pid_by_value.end())
-    return NULL;
-  else
-    return iter->second;
+  return m_value_index->Lookup(pid_value);
 }
 
 
@@ -180,11 +204,7 @@ const PidDescriptor *PidStore::LookupPID(uint16_t pid_value) const {
  * @param pid_name the name of the pid.
  */
 const PidDescriptor *PidStore::LookupPID(const string &pid_name) const {
-  PidNameMap::const_iterator iter = m_pid_by_name.find(pid_name);
-  if (iter == m_pid_by_name.end())
-    return NULL;
-  else
-    return iter->second;
+  return m_name_index->Lookup(pid_name);
 }
 
 
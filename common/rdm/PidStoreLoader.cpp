@@ -49,7 +49,25 @@ using std::set;
 using std::string;
 using std::vector;
 
+namespace {
+
+/*
+ * The 64 bit FNV-1a hash, used to check the text files haven't changed
+ * since a store was compiled.
+ */
+uint64_t Checksum(const string &data) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (string::const_iterator iter = data.begin(); iter != data.end();
+       ++iter) {
+    hash ^= static_cast<uint8_t>(*iter);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+}  // namespace
+
 const char PidStoreLoader::OVERRIDE_FILE_NAME[] = "overrides.proto";
+const char PidStoreLoader::COMPILED_FILE_NAME[] = "compiled_pids.bin";
 const uint16_t PidStoreLoader::ESTA_MANUFACTURER_ID = 0;
 const uint16_t PidStoreLoader::MANUFACTURER_PID_MIN = 0x8000;
 const uint16_t PidStoreLoader::MANUFACTURER_PID_MAX = 0xffe0;
@@ -71,48 +89,68 @@ const RootPidStore *PidStoreLoader::LoadFromFile(const string &file,
 const RootPidStore *PidStoreLoader::LoadFromDirectory(
     const string &directory,
     bool validate) {
-  vector<string> files;
+  SourceFiles sources;
+  if (!ReadDirectory(directory, &sources)) {
+    return NULL;
+  }
 
-  string override_file;
-  vector<string> all_files;
-  ola::file::ListDirectory(directory, &all_files);
-  vector<string>::const_iterator file_iter = all_files.begin();
-  for (; file_iter != all_files.end(); ++file_iter) {
-    if (ola::file::FilenameFromPath(*file_iter) == OVERRIDE_FILE_NAME) {
-      override_file = *file_iter;
-    } else if (StringEndsWith(*file_iter, ".proto")) {
-      files.push_back(*file_iter);
-    }
+  ola::rdm::pid::CompiledPidStore compiled_pb;
+  if (ReadCompiledFile(ola::file::JoinPaths(directory, COMPILED_FILE_NAME),
+                       sources, &compiled_pb)) {
+    return BuildStore(compiled_pb.store(), compiled_pb.overrides(),
+                      validate);
   }
 
   ola::rdm::pid::PidStore pid_store_pb;
-  vector<string>::const_iterator iter = files.begin();
-  for (; iter != files.end(); ++iter) {
-    std::ifstream proto_file(iter->data());
-    if (!proto_file.is_open()) {
-      OLA_WARN << "Failed to open " << *iter << ": " << strerror(errno);
-      return NULL;
-    }
-
-    google::protobuf::io::IstreamInputStream input_stream(&proto_file);
-    bool ok = google::protobuf::TextFormat::Merge(&input_stream,
-                                                  &pid_store_pb);
-    proto_file.close();
+  ola::rdm::pid::PidStore override_pb;
+  if (!ParseSources(sources, &pid_store_pb, &override_pb)) {
+    return NULL;
+  }
+  return BuildStore(pid_store_pb, override_pb, validate);
+}
 
-    if (!ok) {
-      OLA_WARN << "Failed to load " << *iter;
-      return NULL;
-    }
+bool PidStoreLoader::CompileDirectory(const string &directory,
+                                      const string &output_file) {
+  SourceFiles sources;
+  if (!ReadDirectory(directory, &sources)) {
+    return false;
   }
 
+  ola::rdm::pid::CompiledPidStore compiled_pb;
   ola::rdm::pid::PidStore override_pb;
-  if (!override_file.empty()) {
-    if (!ReadFile(override_file, &override_pb)) {
-      return NULL;
-    }
+  if (!ParseSources(sources, compiled_pb.mutable_store(), &override_pb)) {
+    return false;
+  }
+  if (STLContains(sources, OVERRIDE_FILE_NAME)) {
+    *compiled_pb.mutable_overrides() = override_pb;
   }
 
-  return BuildStore(pid_store_pb, override_pb, validate);
+  // Check the data is valid before writing it out.
+  auto_ptr<const RootPidStore> store(
+      BuildStore(compiled_pb.store(), override_pb, true));
+  if (!store.get()) {
+    return false;
+  }
+
+  SourceFiles::const_iterator iter = sources.begin();
+  for (; iter != sources.end(); ++iter) {
+    ola::rdm::pid::CompiledPidStore::SourceFile *source =
+        compiled_pb.add_source();
+    source->set_name(iter->first);
+    source->set_checksum(Checksum(iter->second));
+  }
+
+  std::ofstream output(output_file.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!output.is_open()) {
+    OLA_WARN << "Failed to open " << output_file << ": " << strerror(errno);
+    return false;
+  }
+  if (!compiled_pb.SerializeToOstream(&output)) {
+    OLA_WARN << "Failed to write " << output_file;
+    return false;
+  }
+  return true;
 }
 
 const RootPidStore *PidStoreLoader::LoadFromStream(std::istream *data,
@@ -128,22 +166,80 @@ const RootPidStore *PidStoreLoader::LoadFromStream(std::istream *data,
   return BuildStore(pid_store_pb, override_pb, validate);
 }
 
-bool PidStoreLoader::ReadFile(const std::string &file_path,
-                              ola::rdm::pid::PidStore *proto) {
-  std::ifstream proto_file(file_path.c_str());
-  if (!proto_file.is_open()) {
-    OLA_WARN << "Failed to open " << file_path << ": " << strerror(errno);
+/*
+ * Read the contents of the text files in a directory.
+ */
+bool PidStoreLoader::ReadDirectory(const string &directory,
+                                   SourceFiles *sources) {
+  vector<string> all_files;
+  ola::file::ListDirectory(directory, &all_files);
+  vector<string>::const_iterator iter = all_files.begin();
+  for (; iter != all_files.end(); ++iter) {
+    if (!StringEndsWith(*iter, ".proto")) {
+      continue;
+    }
+
+    std::ifstream proto_file(iter->c_str(), std::ios::in | std::ios::binary);
+    if (!proto_file.is_open()) {
+      OLA_WARN << "Failed to open " << *iter << ": " << strerror(errno);
+      return false;
+    }
+    ostringstream contents;
+    contents << proto_file.rdbuf();
+    (*sources)[ola::file::FilenameFromPath(*iter)] = contents.str();
+  }
+  return true;
+}
+
+/*
+ * Parse the text files, the override file is parsed separately.
+ */
+bool PidStoreLoader::ParseSources(const SourceFiles &sources,
+                                  ola::rdm::pid::PidStore *store_pb,
+                                  ola::rdm::pid::PidStore *override_pb) {
+  SourceFiles::const_iterator iter = sources.begin();
+  for (; iter != sources.end(); ++iter) {
+    ola::rdm::pid::PidStore *proto =
+        iter->first == OVERRIDE_FILE_NAME ? override_pb : store_pb;
+    if (!google::protobuf::TextFormat::MergeFromString(iter->second,
+                                                       proto)) {
+      OLA_WARN << "Failed to load " << iter->first;
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Read a compiled store, this fails if the store is missing or wasn't built
+ * from the same text files.
+ */
+bool PidStoreLoader::ReadCompiledFile(
+    const string &file_path,
+    const SourceFiles &sources,
+    ola::rdm::pid::CompiledPidStore *proto) {
+  std::ifstream compiled_file(file_path.c_str(),
+                              std::ios::in | std::ios::binary);
+  if (!compiled_file.is_open()) {
     return false;
   }
 
-  google::protobuf::io::IstreamInputStream input_stream(&proto_file);
-  bool ok = google::protobuf::TextFormat::Merge(&input_stream, proto);
-  proto_file.close();
+  if (!proto->ParseFromIstream(&compiled_file)) {
+    OLA_WARN << "Failed to load " << file_path << ", using the text files";
+    return false;
+  }
 
-  if (!ok) {
-    OLA_WARN << "Failed to load " << file_path;
+  bool up_to_date = static_cast<size_t>(proto->source_size()) ==
+      sources.size();
+  for (int i = 0; up_to_date && i < proto->source_size(); ++i) {
+    const string *contents = STLFind(&sources, proto->source(i).name());
+    up_to_date = contents &&
+        Checksum(*contents) == proto->source(i).checksum();
+  }
+  if (!up_to_date) {
+    OLA_INFO << file_path << " is out of date, using the text files";
   }
-  return ok;
+  return up_to_date;
 }
 
 /*
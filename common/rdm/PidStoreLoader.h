@@ -60,10 +60,24 @@ class PidStoreLoader {
    * @returns A pointer to a new RootPidStore or NULL if loading failed.
    *
    * This is an all-or-nothing load. Any error with cause us to abort the load.
+   *
+   * If the directory contains a compiled store, built from the same text
+   * files, that is loaded instead, which avoids parsing the text.
    */
   const RootPidStore *LoadFromDirectory(const std::string &directory,
                                         bool validate = true);
 
+  /**
+   * @brief Compile the PID information in a directory to a binary file.
+   * @param directory the directory to load the text files from.
+   * @param output_file the file to write. This should be named
+   *   COMPILED_FILE_NAME and placed in the same directory as the text files
+   *   for LoadFromDirectory() to use it.
+   * @returns true if the data was valid and the file was written.
+   */
+  bool CompileDirectory(const std::string &directory,
+                        const std::string &output_file);
+
   /**
    * @brief Load Pid information from a stream
    * @param data the input stream.
@@ -74,14 +88,26 @@ class PidStoreLoader {
   const RootPidStore *LoadFromStream(std::istream *data,
                                      bool validate = true);
 
+  /**
+   * @brief The name of the compiled store within a PID directory.
+   */
+  static const char COMPILED_FILE_NAME[];
+
  private:
   typedef std::map<uint16_t, const PidDescriptor*> PidMap;
   typedef std::map<uint16_t, PidMap*> ManufacturerMap;
+  // Maps the file name to the contents.
+  typedef std::map<std::string, std::string> SourceFiles;
 
   DescriptorConsistencyChecker m_checker;
 
-  bool ReadFile(const std::string &file_path,
-                ola::rdm::pid::PidStore *proto);
+  bool ReadDirectory(const std::string &directory, SourceFiles *sources);
+  bool ParseSources(const SourceFiles &sources,
+                    ola::rdm::pid::PidStore *store_pb,
+                    ola::rdm::pid::PidStore *override_pb);
+  bool ReadCompiledFile(const std::string &file_path,
+                        const SourceFiles &sources,
+                        ola::rdm::pid::CompiledPidStore *proto);
 
   const RootPidStore *BuildStore(const ola::rdm::pid::PidStore &store_pb,
                                  const ola::rdm::pid::PidStore &override_pb,
@@ -20,6 +20,9 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -28,10 +31,13 @@
 #include "common/rdm/PidStoreLoader.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
+#include "ola/base/Array.h"
+#include "ola/file/Util.h"
 #include "ola/messaging/Descriptor.h"
 #include "ola/messaging/SchemaPrinter.h"
 #include "ola/rdm/PidStore.h"
 #include "ola/rdm/RDMEnums.h"
+#include "ola/strings/Format.h"
 #include "ola/testing/TestUtils.h"
 
 
@@ -53,9 +59,11 @@ class PidStoreTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PidStoreTest);
   CPPUNIT_TEST(testPidDescriptor);
   CPPUNIT_TEST(testPidStore);
+  CPPUNIT_TEST(testLargePidStore);
   CPPUNIT_TEST(testPidStoreLoad);
   CPPUNIT_TEST(testPidStoreFileLoad);
   CPPUNIT_TEST(testPidStoreDirectoryLoad);
+  CPPUNIT_TEST(testPidStoreCompiledLoad);
   CPPUNIT_TEST(testPidStoreLoadMissingFile);
   CPPUNIT_TEST(testPidStoreLoadDuplicateManufacturer);
   CPPUNIT_TEST(testPidStoreLoadDuplicateValue);
@@ -67,9 +75,11 @@ class PidStoreTest: public CppUnit::TestFixture {
  public:
   void testPidDescriptor();
   void testPidStore();
+  void testLargePidStore();
   void testPidStoreLoad();
   void testPidStoreFileLoad();
   void testPidStoreDirectoryLoad();
+  void testPidStoreCompiledLoad();
   void testPidStoreLoadMissingFile();
   void testPidStoreLoadDuplicateManufacturer();
   void testPidStoreLoadDuplicateValue();
@@ -180,6 +190,57 @@ void PidStoreTest::testPidStore() {
 }
 
 
+/**
+ * Check lookups in stores large enough to have hash collisions, and that
+ * manufacturer PIDs are found in the right store.
+ */
+void PidStoreTest::testLargePidStore() {
+  const uint16_t MANUFACTURERS[] = {0x00a1, 0x7a70};
+  const unsigned int PID_COUNT = 500;
+
+  RootPidStore::ManufacturerMap manufacturer_stores;
+  for (unsigned int i = 0; i < arraysize(MANUFACTURERS); i++) {
+    vector<const PidDescriptor*> pids;
+    for (unsigned int j = 0; j < PID_COUNT; j++) {
+      // Insert in reverse order, AllPids() returns them sorted.
+      const uint16_t value = 0x8000 + (PID_COUNT - j) * 3;
+      pids.push_back(new PidDescriptor(
+          ola::strings::IntToString(MANUFACTURERS[i]) + "_" +
+          ola::strings::IntToString(value),
+          value, NULL, NULL, NULL, NULL,
+          PidDescriptor::ANY_SUB_DEVICE, PidDescriptor::ANY_SUB_DEVICE));
+    }
+    manufacturer_stores[MANUFACTURERS[i]] = new PidStore(pids);
+  }
+  RootPidStore root_store(new PidStore(vector<const PidDescriptor*>()),
+                          manufacturer_stores);
+
+  for (unsigned int i = 0; i < arraysize(MANUFACTURERS); i++) {
+    const PidStore *store = root_store.ManufacturerStore(MANUFACTURERS[i]);
+    OLA_ASSERT_NOT_NULL(store);
+    OLA_ASSERT_EQ(PID_COUNT, store->PidCount());
+
+    vector<const PidDescriptor*> all_pids;
+    store->AllPids(&all_pids);
+    OLA_ASSERT_EQ(static_cast<size_t>(PID_COUNT), all_pids.size());
+    for (unsigned int j = 0; j < all_pids.size(); j++) {
+      const PidDescriptor *pid = all_pids[j];
+      OLA_ASSERT_EQ(static_cast<uint16_t>(0x8000 + (j + 1) * 3),
+                    pid->Value());
+      OLA_ASSERT_EQ(pid, store->LookupPID(pid->Value()));
+      OLA_ASSERT_EQ(pid, store->LookupPID(pid->Name()));
+      OLA_ASSERT_EQ(pid, root_store.GetDescriptor(pid->Value(),
+                                                  MANUFACTURERS[i]));
+      OLA_ASSERT_EQ(pid, root_store.GetDescriptor(pid->Name(),
+                                                  MANUFACTURERS[i]));
+      OLA_ASSERT_NULL(store->LookupPID(pid->Value() + 1));
+      OLA_ASSERT_NULL(root_store.GetDescriptor(pid->Value()));
+    }
+  }
+  OLA_ASSERT_NULL(root_store.GetDescriptor(0x8003, 0x1234));
+}
+
+
 /**
  * Check we can load a PidStore from a string
  */
@@ -443,6 +504,67 @@ void PidStoreTest::testPidStoreDirectoryLoad() {
 }
 
 
+/**
+ * Check that a compiled store loads the same data as the text files, and that
+ * it's ignored once the text files change.
+ */
+void PidStoreTest::testPidStoreCompiledLoad() {
+  const string directory = TEST_BUILD_DIR "/common/rdm/compiled_pids";
+  mkdir(directory.c_str(), 0755);
+  const char *files[] = {"overrides.proto", "pids1.proto", "pids2.proto"};
+  for (unsigned int i = 0; i < arraysize(files); i++) {
+    std::ifstream input(GetTestDataFile(string("pids/") + files[i]).c_str());
+    std::ofstream output(
+        ola::file::JoinPaths(directory, files[i]).c_str());
+    output << input.rdbuf();
+  }
+  const string compiled_file = ola::file::JoinPaths(
+      directory, PidStoreLoader::COMPILED_FILE_NAME);
+
+  PidStoreLoader loader;
+  OLA_ASSERT_TRUE(loader.CompileDirectory(directory, compiled_file));
+
+  auto_ptr<const RootPidStore> root_store(
+      loader.LoadFromDirectory(directory));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1302986774), root_store->Version());
+  vector<const PidDescriptor*> all_pids;
+  root_store->EstaStore()->AllPids(&all_pids);
+  OLA_ASSERT_EQ(static_cast<size_t>(4), all_pids.size());
+  const PidStore *open_lighting_store =
+    root_store->ManufacturerStore(ola::OPEN_LIGHTING_ESTA_CODE);
+  OLA_ASSERT_NOT_NULL(open_lighting_store);
+  OLA_ASSERT_NULL(open_lighting_store->LookupPID("SERIAL_NUMBER"));
+  OLA_ASSERT_NOT_NULL(open_lighting_store->LookupPID("FOO_BAR"));
+
+  // Add a PID to one of the text files, the compiled store is now stale.
+  {
+    std::ofstream output(
+        ola::file::JoinPaths(directory, "pids2.proto").c_str(),
+        std::ios::app);
+    output << "pid {\n  name: \"NEW_PID\"\n  value: 40\n}\n";
+  }
+  root_store.reset(loader.LoadFromDirectory(directory));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_NOT_NULL(root_store->EstaStore()->LookupPID("NEW_PID"));
+
+  // A corrupt store is ignored as well.
+  {
+    std::ofstream output(compiled_file.c_str());
+    output << "not a pid store";
+  }
+  root_store.reset(loader.LoadFromDirectory(directory));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_NOT_NULL(root_store->EstaStore()->LookupPID("NEW_PID"));
+
+  unlink(compiled_file.c_str());
+  for (unsigned int i = 0; i < arraysize(files); i++) {
+    unlink(ola::file::JoinPaths(directory, files[i]).c_str());
+  }
+  rmdir(directory.c_str());
+}
+
+
 /**
  * Check that loading a missing file fails.
  */
@@ -43,17 +43,17 @@ using std::vector;
 
 /*
  * A new QueueingRDMController. This takes another controller as a argument,
- * and ensures that we only send one request at a time.
+ * and limits how many requests are sent to it at once.
  */
 QueueingRDMController::QueueingRDMController(
     RDMControllerInterface *controller,
-    unsigned int max_queue_size)
+    unsigned int max_queue_size,
+    unsigned int max_in_flight)
   : m_controller(controller),
     m_max_queue_size(max_queue_size),
-    m_rdm_request_pending(false),
-    m_active(true),
-    m_callback(ola::NewCallback(this,
-                                &QueueingRDMController::HandleRDMResponse)) {
+    m_max_in_flight(max_in_flight ? max_in_flight : 1),
+    m_in_flight(0),
+    m_active(true) {
 }
 
 
@@ -86,7 +86,7 @@ void QueueingRDMController::Pause() {
  */
 void QueueingRDMController::Resume() {
   m_active = true;
-  MaybeSendRDMRequest();
+  TakeNextAction();
 }
 
 
@@ -95,7 +95,7 @@ void QueueingRDMController::Resume() {
  */
 void QueueingRDMController::SendRDMRequest(RDMRequest *request,
                                            RDMCallback *on_complete) {
-  if (m_pending_requests.size() >= m_max_queue_size) {
+  if (m_pending_requests.size() + m_in_flight >= m_max_queue_size) {
     OLA_WARN << "RDM Queue is full, dropping request";
     if (on_complete) {
       RunRDMCallback(on_complete, RDM_FAILED_TO_SEND);
@@ -113,13 +113,11 @@ void QueueingRDMController::SendRDMRequest(RDMRequest *request,
 
 
 /**
- * Do the next action.
+ * Do the next action, this sends requests until the window is full.
  */
 void QueueingRDMController::TakeNextAction() {
-  if (CheckForBlockingCondition())
-    return;
-
-  MaybeSendRDMRequest();
+  while (!CheckForBlockingCondition() && MaybeSendRDMRequest()) {
+  }
 }
 
 
@@ -130,106 +128,105 @@ void QueueingRDMController::TakeNextAction() {
  * @returns true if some other action is running, false otherwise.
  */
 bool QueueingRDMController::CheckForBlockingCondition() {
-  return !m_active || m_rdm_request_pending;
+  return !m_active || m_in_flight >= m_max_in_flight;
 }
 
 
 /*
- * If we're not paused, send the next request.
+ * Send the next request, if there is one.
+ * @returns true if a request was sent, false if the queue was empty.
  */
-void QueueingRDMController::MaybeSendRDMRequest() {
+bool QueueingRDMController::MaybeSendRDMRequest() {
   if (m_pending_requests.empty())
-    return;
+    return false;
+
+  outstanding_rdm_request outstanding_request = m_pending_requests.front();
+  m_pending_requests.pop();
 
-  m_rdm_request_pending = true;
-  DispatchNextRequest();
+  InFlightRequest *in_flight = new InFlightRequest();
+  in_flight->request = outstanding_request.request;
+  in_flight->on_complete = outstanding_request.on_complete;
+  m_in_flight++;
+  DispatchRequest(in_flight);
+  return true;
 }
 
 
 /*
- * Send the next RDM request.
+ * Send a request to the underlying controller.
  */
-void QueueingRDMController::DispatchNextRequest() {
-  outstanding_rdm_request outstanding_request = m_pending_requests.front();
+void QueueingRDMController::DispatchRequest(InFlightRequest *in_flight) {
   // We have to make a copy here because we pass ownership of the request to
   // the underlying controller.
   // We need to have the original request because we use it if we receive an
   // ACK_OVERFLOW.
-  m_controller->SendRDMRequest(outstanding_request.request->Duplicate(),
-                               m_callback.get());
+  m_controller->SendRDMRequest(
+      in_flight->request->Duplicate(),
+      NewSingleCallback(this, &QueueingRDMController::HandleRDMResponse,
+                        in_flight));
 }
 
 
 /*
- * Handle the response to a RemoteGet command
+ * Handle the response to a request.
  */
-void QueueingRDMController::HandleRDMResponse(RDMReply *reply) {
-  m_rdm_request_pending = false;
-
-  if (m_pending_requests.empty()) {
-    OLA_FATAL << "Received a response but the queue was empty!";
-    return;
-  }
-
+void QueueingRDMController::HandleRDMResponse(InFlightRequest *in_flight,
+                                              RDMReply *reply) {
   bool was_ack_overflow = reply->StatusCode() == RDM_COMPLETED_OK &&
                           reply->Response() &&
                           reply->Response()->ResponseType() == ACK_OVERFLOW;
   // Check for ACK_OVERFLOW
-  if (m_response.get()) {
+  if (in_flight->response.get()) {
+    in_flight->frames.insert(in_flight->frames.end(),
+                             reply->Frames().begin(), reply->Frames().end());
+
     if (reply->StatusCode() != RDM_COMPLETED_OK || reply->Response() == NULL) {
       // We failed part way through an ACK_OVERFLOW
-      m_frames.insert(m_frames.end(), reply->Frames().begin(),
-                      reply->Frames().end());
-      RDMReply new_reply(reply->StatusCode(), NULL, m_frames);
-      RunCallback(&new_reply);
-      m_response.reset();
-      m_frames.clear();
-      TakeNextAction();
-    } else {
-      // Combine the data.
-      m_response.reset(RDMResponse::CombineResponses(
-          m_response.get(), reply->Response()));
-      m_frames.insert(m_frames.end(), reply->Frames().begin(),
-                      reply->Frames().end());
-
-      if (!m_response.get()) {
-        // The response was invalid
-        RDMReply new_reply(RDM_INVALID_RESPONSE, NULL, m_frames);
-        RunCallback(&new_reply);
-        m_frames.clear();
-        TakeNextAction();
-      } else if (reply->Response()->ResponseType() != ACK_OVERFLOW) {
-        RDMReply new_reply(RDM_COMPLETED_OK, m_response.release(), m_frames);
-        RunCallback(&new_reply);
-        m_response.reset();
-        m_frames.clear();
-        TakeNextAction();
-      } else {
-        DispatchNextRequest();
-      }
+      RDMReply new_reply(reply->StatusCode(), NULL, in_flight->frames);
+      RunCallback(in_flight, &new_reply);
       return;
     }
+
+    // Combine the data.
+    in_flight->response.reset(RDMResponse::CombineResponses(
+        in_flight->response.get(), reply->Response()));
+
+    if (!in_flight->response.get()) {
+      // The response was invalid
+      RDMReply new_reply(RDM_INVALID_RESPONSE, NULL, in_flight->frames);
+      RunCallback(in_flight, &new_reply);
+    } else if (reply->Response()->ResponseType() != ACK_OVERFLOW) {
+      RDMReply new_reply(RDM_COMPLETED_OK, in_flight->response.release(),
+                         in_flight->frames);
+      RunCallback(in_flight, &new_reply);
+    } else {
+      DispatchRequest(in_flight);
+    }
   } else if (was_ack_overflow) {
     // We're in an ACK_OVERFLOW sequence.
-    m_frames.clear();
-    m_response.reset(reply->Response()->Duplicate());
-    m_frames.insert(m_frames.end(), reply->Frames().begin(),
-                    reply->Frames().end());
-    DispatchNextRequest();
+    in_flight->response.reset(reply->Response()->Duplicate());
+    in_flight->frames.insert(in_flight->frames.end(),
+                             reply->Frames().begin(), reply->Frames().end());
+    DispatchRequest(in_flight);
   } else {
     // Just pass the RDMReply on.
-    RunCallback(reply);
-    TakeNextAction();
+    RunCallback(in_flight, reply);
   }
 }
 
-void QueueingRDMController::RunCallback(RDMReply *reply) {
-  outstanding_rdm_request outstanding_request = m_pending_requests.front();
-  m_pending_requests.pop();
-  if (outstanding_request.on_complete) {
-    outstanding_request.on_complete->Run(reply);
+
+/*
+ * Complete a request & move on to the next action.
+ */
+void QueueingRDMController::RunCallback(InFlightRequest *in_flight,
+                                        RDMReply *reply) {
+  m_in_flight--;
+  if (in_flight->on_complete) {
+    in_flight->on_complete->Run(reply);
   }
-  delete outstanding_request.request;
+  delete in_flight->request;
+  delete in_flight;
+  TakeNextAction();
 }
 
 
@@ -238,8 +235,9 @@ void QueueingRDMController::RunCallback(RDMReply *reply) {
  */
 DiscoverableQueueingRDMController::DiscoverableQueueingRDMController(
         DiscoverableRDMControllerInterface *controller,
-        unsigned int max_queue_size)
-    : QueueingRDMController(controller, max_queue_size),
+        unsigned int max_queue_size,
+        unsigned int max_in_flight)
+    : QueueingRDMController(controller, max_queue_size, max_in_flight),
       m_discoverable_controller(controller) {
 }
 
@@ -268,14 +266,18 @@ void DiscoverableQueueingRDMController::RunIncrementalDiscovery(
  * Override this so we can prioritize the discovery requests.
  */
 void DiscoverableQueueingRDMController::TakeNextAction() {
-  if (CheckForBlockingCondition())
-    return;
-
-  // prioritize discovery above RDM requests
-  if (!m_pending_discovery_callbacks.empty())
-    StartRDMDiscovery();
-  else
-    MaybeSendRDMRequest();
+  while (!CheckForBlockingCondition()) {
+    // prioritize discovery above RDM requests
+    if (!m_pending_discovery_callbacks.empty()) {
+      // Discovery needs the line to itself, so wait for any requests in
+      // flight to complete.
+      if (!m_in_flight)
+        StartRDMDiscovery();
+      return;
+    }
+    if (!MaybeSendRDMRequest())
+      return;
+  }
 }
 
 
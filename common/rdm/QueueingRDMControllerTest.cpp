@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <deque>
 #include <memory>
 #include <queue>
 #include <string>
@@ -84,6 +85,7 @@ class QueueingRDMControllerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testMultipleDiscovery);
   CPPUNIT_TEST(testReentrantDiscovery);
   CPPUNIT_TEST(testRequestAndDiscovery);
+  CPPUNIT_TEST(testPipelinedRequests);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -102,6 +104,7 @@ class QueueingRDMControllerTest: public CppUnit::TestFixture {
   void testMultipleDiscovery();
   void testReentrantDiscovery();
   void testRequestAndDiscovery();
+  void testPipelinedRequests();
 
   void VerifyResponse(RDMReply *expected_reply, RDMReply *reply) {
     OLA_ASSERT_EQ(*expected_reply, *reply);
@@ -137,8 +140,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION(QueueingRDMControllerTest);
  */
 class MockRDMController: public ola::rdm::DiscoverableRDMControllerInterface {
  public:
-    MockRDMController()
-        : m_rdm_callback(NULL),
+    explicit MockRDMController(unsigned int max_in_flight = 1)
+        : m_max_in_flight(max_in_flight),
           m_discovery_callback(NULL) {
     }
 
@@ -158,6 +161,7 @@ class MockRDMController: public ola::rdm::DiscoverableRDMControllerInterface {
     void RunIncrementalDiscovery(RDMDiscoveryCallback *callback);
 
     void RunRDMCallback(RDMReply *reply);
+    void RunLatestRDMCallback(RDMReply *reply);
 
     void RunDiscoveryCallback(const UIDSet &uids);
     void Verify();
@@ -176,7 +180,8 @@ class MockRDMController: public ola::rdm::DiscoverableRDMControllerInterface {
 
     std::queue<expected_call> m_expected_calls;
     std::queue<expected_discovery_call> m_expected_discover_calls;
-    RDMCallback *m_rdm_callback;
+    unsigned int m_max_in_flight;
+    std::deque<RDMCallback*> m_rdm_callbacks;
     RDMDiscoveryCallback *m_discovery_callback;
 };
 
@@ -193,8 +198,8 @@ void MockRDMController::SendRDMRequest(RDMRequest *request,
     on_complete->Run(call.reply);
     delete call.reply;
   } else {
-    OLA_ASSERT_FALSE(m_rdm_callback);
-    m_rdm_callback = on_complete;
+    OLA_ASSERT_TRUE(m_rdm_callbacks.size() < m_max_in_flight);
+    m_rdm_callbacks.push_back(on_complete);
   }
 }
 
@@ -260,12 +265,23 @@ void MockRDMController::AddExpectedDiscoveryCall(bool full,
 
 
 /**
- * Run the current RDM callback
+ * Run the oldest RDM callback
  */
 void MockRDMController::RunRDMCallback(RDMReply *reply) {
-  OLA_ASSERT_TRUE(m_rdm_callback);
-  RDMCallback *callback = m_rdm_callback;
-  m_rdm_callback = NULL;
+  OLA_ASSERT_FALSE(m_rdm_callbacks.empty());
+  RDMCallback *callback = m_rdm_callbacks.front();
+  m_rdm_callbacks.pop_front();
+  callback->Run(reply);
+}
+
+
+/**
+ * Run the most recent RDM callback
+ */
+void MockRDMController::RunLatestRDMCallback(RDMReply *reply) {
+  OLA_ASSERT_FALSE(m_rdm_callbacks.empty());
+  RDMCallback *callback = m_rdm_callbacks.back();
+  m_rdm_callbacks.pop_back();
   callback->Run(reply);
 }
 
@@ -851,3 +867,54 @@ void QueueingRDMControllerTest::testRequestAndDiscovery() {
   OLA_ASSERT_TRUE(m_discovery_complete_count);
   mock_controller.Verify();
 }
+
+
+/*
+ * Check that requests are pipelined up to the window size, and that
+ * discovery waits for the requests in flight.
+ */
+void QueueingRDMControllerTest::testPipelinedRequests() {
+  MockRDMController mock_controller(2);
+  ola::rdm::DiscoverableQueueingRDMController controller(&mock_controller, 10,
+                                                         2);
+
+  RDMRequest *requests[3];
+  for (unsigned int i = 0; i < arraysize(requests); i++) {
+    requests[i] = NewGetRequest(m_source, m_destination);
+    mock_controller.ExpectCallAndCapture(requests[i]);
+  }
+
+  RDMReply expected_reply(
+      ola::rdm::RDM_COMPLETED_OK,
+      NewGetResponse(m_destination, m_source));
+
+  // The first two are sent straight away, the third is queued.
+  for (unsigned int i = 0; i < arraysize(requests); i++) {
+    controller.SendRDMRequest(
+        requests[i],
+        ola::NewSingleCallback(
+            this,
+            &QueueingRDMControllerTest::VerifyResponse,
+            &expected_reply));
+  }
+
+  // Completing the second request out of order sends the third.
+  mock_controller.RunLatestRDMCallback(&expected_reply);
+  mock_controller.Verify();
+
+  // Discovery doesn't start until both requests in flight are done.
+  UIDSet uids;
+  uids.AddUID(UID(2, 3));
+  controller.RunFullDiscovery(
+      NewSingleCallback(
+          this,
+          &QueueingRDMControllerTest::VerifyDiscoveryComplete,
+          &uids));
+  mock_controller.RunRDMCallback(&expected_reply);
+  OLA_ASSERT_FALSE(m_discovery_complete_count);
+
+  mock_controller.AddExpectedDiscoveryCall(true, &uids);
+  mock_controller.RunRDMCallback(&expected_reply);
+  OLA_ASSERT_EQ(1, m_discovery_complete_count);
+  mock_controller.Verify();
+}
@@ -47,6 +47,34 @@ using ola::network::HostToNetwork;
 using ola::network::NetworkToHost;
 
 
+/*
+ * Tracks the outstanding requests in a batch, and runs the callback once the
+ * last one completes. This deletes itself once the callback has run.
+ */
+class RDMAPI::BatchRequest {
+ public:
+  explicit BatchRequest(SingleUseCallback0<void> *callback)
+      : m_callback(callback),
+        m_pending(1) {
+  }
+
+  void Add() { m_pending++; }
+
+  void Done() {
+    if (--m_pending == 0) {
+      m_callback->Run();
+      delete this;
+    }
+  }
+
+ private:
+  SingleUseCallback0<void> *m_callback;
+  unsigned int m_pending;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchRequest);
+};
+
+
 /*
  * Return the number of queues messages for a UID. Note that this is cached on
  * the client side so this number may not be correct.
@@ -2822,6 +2850,48 @@ bool RDMAPI::SetPresetPlaybackMode(
 }
 
 
+/*
+ * Fetch the device information for a number of UIDs.
+ * @param uids the UIDs to fetch the device information for
+ * @param sub_device the sub device to use
+ * @param results the array to store the results in, one per UID
+ * @param callback the callback to invoke when all the requests complete
+ * @param error a pointer to a string which it set if an error occurs
+ * @return true if the requests are sent correctly, false otherwise
+ */
+bool RDMAPI::GetDeviceInfoBatch(
+    unsigned int universe,
+    const vector<UID> &uids,
+    uint16_t sub_device,
+    BatchResult<DeviceDescriptor> *results,
+    SingleUseCallback0<void> *callback,
+    string *error) {
+  return SendBatch(universe, uids, sub_device, PID_DEVICE_INFO, results,
+                   &RDMAPI::_HandleBatchDeviceDescriptor, callback, error);
+}
+
+
+/*
+ * Fetch the DMX start address for a number of UIDs.
+ * @param uids the UIDs to fetch the start address for
+ * @param sub_device the sub device to use
+ * @param results the array to store the results in, one per UID
+ * @param callback the callback to invoke when all the requests complete
+ * @param error a pointer to a string which it set if an error occurs
+ * @return true if the requests are sent correctly, false otherwise
+ */
+bool RDMAPI::GetDMXAddressBatch(
+    unsigned int universe,
+    const vector<UID> &uids,
+    uint16_t sub_device,
+    BatchResult<uint16_t> *results,
+    SingleUseCallback0<void> *callback,
+    string *error) {
+  return SendBatch(universe, uids, sub_device, PID_DMX_START_ADDRESS, results,
+                   &RDMAPI::_HandleBatchDMXAddress, callback, error);
+}
+
+
 // Handlers follow. These are invoked by the RDMAPIImpl when responses arrive
 // ----------------------------------------------------------------------------
 
@@ -3246,30 +3316,25 @@ void RDMAPI::_HandleGetDeviceDescriptor(
     const string &data) {
   ResponseStatus response_status = status;
   DeviceDescriptor device_info;
-
-  if (response_status.WasAcked()) {
-    unsigned int data_size = data.size();
-    if (data_size == sizeof(device_info)) {
-      memcpy(&device_info, data.data(), sizeof(device_info));
-      device_info.device_model = NetworkToHost(device_info.device_model);
-      device_info.product_category =
-        NetworkToHost(device_info.product_category);
-      device_info.software_version =
-        NetworkToHost(device_info.software_version);
-      device_info.dmx_footprint =
-        NetworkToHost(device_info.dmx_footprint);
-      device_info.dmx_start_address =
-        NetworkToHost(device_info.dmx_start_address);
-      device_info.sub_device_count =
-        NetworkToHost(device_info.sub_device_count);
-    } else {
-      SetIncorrectPDL(&response_status, data.size(), sizeof(device_info));
-    }
-  }
+  UnpackDeviceDescriptor(data, &response_status, &device_info);
   callback->Run(response_status, device_info);
 }
 
 
+/*
+ * Handle a DEVICE_INFO response for a batch request
+ */
+void RDMAPI::_HandleBatchDeviceDescriptor(
+    BatchRequest *batch,
+    BatchResult<DeviceDescriptor> *result,
+    const ResponseStatus &status,
+    const string &data) {
+  result->status = status;
+  UnpackDeviceDescriptor(data, &result->status, &result->value);
+  batch->Done();
+}
+
+
 /*
  * Handle a PRODUCT_DETAIL_ID_LIST response
  */
@@ -3464,20 +3529,26 @@ void RDMAPI::_HandleGetDMXAddress(
     const ResponseStatus &status,
     const string &data) {
   ResponseStatus response_status = status;
-  static const unsigned int DATA_SIZE = 2;
   uint16_t start_address = 0;
-  if (response_status.WasAcked()) {
-    if (data.size() != DATA_SIZE) {
-      SetIncorrectPDL(&response_status, data.size(), DATA_SIZE);
-    } else {
-      start_address = *(reinterpret_cast<const uint16_t*>(data.data()));
-      start_address = NetworkToHost(start_address);
-    }
-  }
+  UnpackDMXAddress(data, &response_status, &start_address);
   callback->Run(response_status, start_address);
 }
 
 
+/*
+ * Handle a get DMX_START_ADDRESS response for a batch request
+ */
+void RDMAPI::_HandleBatchDMXAddress(
+    BatchRequest *batch,
+    BatchResult<uint16_t> *result,
+    const ResponseStatus &status,
+    const string &data) {
+  result->status = status;
+  UnpackDMXAddress(data, &result->status, &result->value);
+  batch->Done();
+}
+
+
 /*
  * Handle a get SLOT_INFO response
  */
@@ -3903,12 +3974,104 @@ bool RDMAPI::GenericSetU32(
 
 
 // Checks the status of a rdm command and sets error appropriately
+/*
+ * Send a GET to each UID in a batch.
+ */
+template <typename value_type>
+bool RDMAPI::SendBatch(
+    unsigned int universe,
+    const vector<UID> &uids,
+    uint16_t sub_device,
+    uint16_t pid,
+    BatchResult<value_type> *results,
+    void (RDMAPI::*handler)(BatchRequest*,
+                            BatchResult<value_type>*,
+                            const ResponseStatus&,
+                            const string&),
+    SingleUseCallback0<void> *callback,
+    string *error) {
+  if (CheckCallback(error, callback))
+    return false;
+  if (CheckValidSubDevice(sub_device, false, error, callback))
+    return false;
+
+  BatchRequest *batch = new BatchRequest(callback);
+  for (unsigned int i = 0; i < uids.size(); i++) {
+    BatchResult<value_type> *result = &results[i];
+    result->status = ResponseStatus();
+    result->value = value_type();
+    if (uids[i].IsBroadcast()) {
+      result->status.error = "Cannot send to broadcast address";
+      continue;
+    }
+
+    batch->Add();
+    RDMAPIImplInterface::rdm_callback *cb = NewSingleCallback(
+      this, handler, batch, result);
+    if (!CheckReturnStatus(
+          m_impl->RDMGet(cb, universe, uids[i], sub_device, pid),
+          &result->status.error)) {
+      batch->Done();
+    }
+  }
+  // Release the reference held while sending.
+  batch->Done();
+  return true;
+}
+
+
 bool RDMAPI::CheckReturnStatus(bool status, string *error) {
   if (!status && error)
     *error = "Unable to send RDM command";
   return status;
 }
 
+/*
+ * Unpack a DEVICE_INFO response
+ */
+void RDMAPI::UnpackDeviceDescriptor(const string &data,
+                                    ResponseStatus *status,
+                                    DeviceDescriptor *device_info) {
+  if (!status->WasAcked())
+    return;
+
+  if (data.size() != sizeof(*device_info)) {
+    SetIncorrectPDL(status, data.size(), sizeof(*device_info));
+    return;
+  }
+  memcpy(device_info, data.data(), sizeof(*device_info));
+  device_info->device_model = NetworkToHost(device_info->device_model);
+  device_info->product_category =
+    NetworkToHost(device_info->product_category);
+  device_info->software_version =
+    NetworkToHost(device_info->software_version);
+  device_info->dmx_footprint = NetworkToHost(device_info->dmx_footprint);
+  device_info->dmx_start_address =
+    NetworkToHost(device_info->dmx_start_address);
+  device_info->sub_device_count =
+    NetworkToHost(device_info->sub_device_count);
+}
+
+
+/*
+ * Unpack a DMX_START_ADDRESS response
+ */
+void RDMAPI::UnpackDMXAddress(const string &data,
+                              ResponseStatus *status,
+                              uint16_t *start_address) {
+  static const unsigned int DATA_SIZE = 2;
+  if (!status->WasAcked())
+    return;
+
+  if (data.size() != DATA_SIZE) {
+    SetIncorrectPDL(status, data.size(), DATA_SIZE);
+    return;
+  }
+  memcpy(start_address, data.data(), DATA_SIZE);
+  *start_address = NetworkToHost(*start_address);
+}
+
+
 // Mark a ResponseStatus as malformed due to a length mismatch
 void RDMAPI::SetIncorrectPDL(ResponseStatus *status,
                              unsigned int actual,
@@ -228,6 +228,7 @@ class RDMAPITest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testRDMInformation);
   CPPUNIT_TEST(testProductInformation);
   CPPUNIT_TEST(testDmxSetup);
+  CPPUNIT_TEST(testBatch);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -237,13 +238,15 @@ class RDMAPITest: public CppUnit::TestFixture {
       m_bcast_uid(UID::AllDevices()),
       m_group_uid(UID::VendorcastAddress(52)),
       m_test_uid1(4, 5),
-      m_test_uid2(7, 9) {
+      m_test_uid2(7, 9),
+      m_batch_complete(false) {
     }
     void testProxyCommands();
     void testNetworkCommands();
     void testRDMInformation();
     void testProductInformation();
     void testDmxSetup();
+    void testBatch();
     void setUp() {}
     void tearDown();
 
@@ -260,6 +263,7 @@ class RDMAPITest: public CppUnit::TestFixture {
     UID m_group_uid;
     UID m_test_uid1;
     UID m_test_uid2;
+    bool m_batch_complete;
 
     // check that a RDM call failed because we tried to send to the bcast UID
     void CheckForBroadcastError(string *error) {
@@ -398,6 +402,10 @@ class RDMAPITest: public CppUnit::TestFixture {
       OLA_ASSERT_EQ(static_cast<uint16_t>(0xaa00), params[2]);
     }
 
+    void BatchComplete() {
+      m_batch_complete = true;
+    }
+
     void CheckDMXStartAddress(const ResponseStatus &status,
                               uint16_t start_address) {
       CheckResponseStatus(status);
@@ -1106,3 +1114,70 @@ void RDMAPITest::testDmxSetup() {
     &error));
   CheckForDeviceRangeBcastError(&error);
 }
+
+
+/*
+ * Check the batch methods.
+ */
+void RDMAPITest::testBatch() {
+  string error;
+  uint16_t sub_device = 1;
+
+  vector<UID> uids;
+  uids.push_back(m_uid);
+  uids.push_back(m_bcast_uid);
+  uids.push_back(m_test_uid1);
+  ola::rdm::BatchResult<uint16_t> addresses[3];
+
+  OLA_ASSERT_FALSE(m_api.GetDMXAddressBatch(
+    UNIVERSE,
+    uids,
+    0x0201,
+    addresses,
+    NewSingleCallback(this, &RDMAPITest::BatchComplete),
+    &error));
+  CheckForDeviceRangeError(&error);
+
+  uint16_t start_address = HostToNetwork(static_cast<uint16_t>(44));
+  string s(reinterpret_cast<char*>(&start_address), sizeof(start_address));
+  m_impl.AddExpectedGet(s,
+                        UNIVERSE,
+                        m_uid,
+                        sub_device,
+                        ola::rdm::PID_DMX_START_ADDRESS);
+  // The second device sends a short response.
+  m_impl.AddExpectedGet(s.substr(1),
+                        UNIVERSE,
+                        m_test_uid1,
+                        sub_device,
+                        ola::rdm::PID_DMX_START_ADDRESS);
+  OLA_ASSERT_TRUE(m_api.GetDMXAddressBatch(
+    UNIVERSE,
+    uids,
+    sub_device,
+    addresses,
+    NewSingleCallback(this, &RDMAPITest::BatchComplete),
+    &error));
+  OLA_ASSERT_TRUE(m_batch_complete);
+
+  OLA_ASSERT_TRUE(addresses[0].status.WasAcked());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(44), addresses[0].value);
+  OLA_ASSERT_EQ(string(BROADCAST_ERROR), addresses[1].status.error);
+  OLA_ASSERT_FALSE(addresses[2].status.WasAcked());
+  OLA_ASSERT_EQ(string("PDL mismatch, 1 != 2 (expected)"),
+                addresses[2].status.error);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0), addresses[2].value);
+
+  // An empty batch completes right away.
+  m_batch_complete = false;
+  uids.clear();
+  ola::rdm::BatchResult<ola::rdm::DeviceDescriptor> device_info;
+  OLA_ASSERT_TRUE(m_api.GetDeviceInfoBatch(
+    UNIVERSE,
+    uids,
+    ola::rdm::ROOT_RDM_DEVICE,
+    &device_info,
+    NewSingleCallback(this, &RDMAPITest::BatchComplete),
+    &error));
+  OLA_ASSERT_TRUE(m_batch_complete);
+}
@@ -109,25 +109,70 @@ bool RDMCommandSerializer::Write(const RDMCommand &command,
   RDMCommandHeader header;
   PopulateHeader(&header, command);
 
-  uint16_t checksum = START_CODE;
-  const uint8_t *ptr = reinterpret_cast<uint8_t*>(&header);
-  for (unsigned int i = 0; i < sizeof(header); i++) {
-    checksum += ptr[i];
-  }
-  ptr = command.ParamData();
-  for (unsigned int i = 0; i < command.ParamDataSize(); i++) {
-    checksum += ptr[i];
+  uint16_t checksum = command.Checksum(
+      HeaderChecksum(header, command.ParamData(), command.ParamDataSize()));
+  // now perform the write in reverse order (since it's a stack).
+  ola::io::BigEndianOutputStream output(stack);
+  output << checksum;
+  output.Write(command.ParamData(), command.ParamDataSize());
+  output.Write(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+  return true;
+}
+
+bool RDMCommandSerializer::Pack(const RDMCommandView &command,
+                                uint8_t *buffer,
+                                unsigned int *size) {
+  const RDMCommandHeader &header = command.Header();
+  const unsigned int packet_length =
+      sizeof(header) + command.ParamDataSize() + CHECKSUM_LENGTH;
+  if (*size < packet_length) {
+    return false;
   }
 
-  checksum = command.Checksum(checksum);
+  memcpy(buffer, &header, sizeof(header));
+  memcpy(buffer + sizeof(header), command.ParamData(),
+         command.ParamDataSize());
+
+  uint16_t checksum = HeaderChecksum(header, command.ParamData(),
+                                     command.ParamDataSize());
+  buffer[packet_length - CHECKSUM_LENGTH] = checksum >> 8;
+  buffer[packet_length - CHECKSUM_LENGTH + 1] = checksum & 0xff;
+
+  *size = packet_length;
+  return true;
+}
+
+bool RDMCommandSerializer::Write(const RDMCommandView &command,
+                                 ola::io::IOStack *stack) {
+  const RDMCommandHeader &header = command.Header();
+  uint16_t checksum = HeaderChecksum(header, command.ParamData(),
+                                     command.ParamDataSize());
+
   // now perform the write in reverse order (since it's a stack).
   ola::io::BigEndianOutputStream output(stack);
   output << checksum;
   output.Write(command.ParamData(), command.ParamDataSize());
-  output.Write(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+  output.Write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
   return true;
 }
 
+/**
+ * Calculate the checksum of a header and the parameter data.
+ */
+uint16_t RDMCommandSerializer::HeaderChecksum(const RDMCommandHeader &header,
+                                              const uint8_t *param_data,
+                                              unsigned int param_data_length) {
+  uint16_t checksum = START_CODE;
+  const uint8_t *ptr = reinterpret_cast<const uint8_t*>(&header);
+  for (unsigned int i = 0; i < sizeof(header); i++) {
+    checksum += ptr[i];
+  }
+  for (unsigned int i = 0; i < param_data_length; i++) {
+    checksum += param_data[i];
+  }
+  return checksum;
+}
+
 /**
  * Populate the RDMCommandHeader struct.
  * @param header a pointer to the RDMCommandHeader to populate
@@ -0,0 +1,89 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMCommandView.cpp
+ * A read only view of an RDM message in a receive buffer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMCommandView.h"
+#include "ola/rdm/UID.h"
+#include "ola/util/Utils.h"
+
+namespace ola {
+namespace rdm {
+
+using ola::utils::JoinUInt8;
+
+RDMCommandView::RDMCommandView()
+    : m_command_class(RDMCommand::INVALID_COMMAND),
+      m_param_data(NULL) {
+  memset(&m_header, 0, sizeof(m_header));
+}
+
+RDMStatusCode RDMCommandView::Parse(const uint8_t *data,
+                                    unsigned int length) {
+  m_command_class = RDMCommand::INVALID_COMMAND;
+  m_param_data = NULL;
+
+  RDMStatusCode status_code = RDMCommand::VerifyData(data, length, &m_header);
+  if (status_code != RDM_COMPLETED_OK) {
+    return status_code;
+  }
+
+  m_command_class = RDMCommand::ConvertCommandClass(m_header.command_class);
+  m_param_data = data + sizeof(RDMCommandHeader);
+  return RDM_COMPLETED_OK;
+}
+
+UID RDMCommandView::SourceUID() const {
+  return UID(m_header.source_uid);
+}
+
+void RDMCommandView::SetSourceUID(const UID &uid) {
+  uid.Pack(m_header.source_uid, UID::UID_SIZE);
+}
+
+UID RDMCommandView::DestinationUID() const {
+  return UID(m_header.destination_uid);
+}
+
+void RDMCommandView::SetDestinationUID(const UID &uid) {
+  uid.Pack(m_header.destination_uid, UID::UID_SIZE);
+}
+
+uint16_t RDMCommandView::SubDevice() const {
+  return JoinUInt8(m_header.sub_device[0], m_header.sub_device[1]);
+}
+
+uint16_t RDMCommandView::ParamId() const {
+  return JoinUInt8(m_header.param_id[0], m_header.param_id[1]);
+}
+
+bool RDMCommandView::IsRequest() const {
+  return (m_command_class == RDMCommand::DISCOVER_COMMAND ||
+          m_command_class == RDMCommand::GET_COMMAND ||
+          m_command_class == RDMCommand::SET_COMMAND);
+}
+
+bool RDMCommandView::IsResponse() const {
+  return (m_command_class == RDMCommand::DISCOVER_COMMAND_RESPONSE ||
+          m_command_class == RDMCommand::GET_COMMAND_RESPONSE ||
+          m_command_class == RDMCommand::SET_COMMAND_RESPONSE);
+}
+}  // namespace rdm
+}  // namespace ola
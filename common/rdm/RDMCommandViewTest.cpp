@@ -0,0 +1,197 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMCommandViewTest.cpp
+ * Test fixture for the RDMCommandView class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <memory>
+
+#include "ola/base/Array.h"
+#include "ola/io/IOStack.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMCommandSerializer.h"
+#include "ola/rdm/RDMCommandView.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::io::IOStack;
+using ola::rdm::RDMCommand;
+using ola::rdm::RDMCommandSerializer;
+using ola::rdm::RDMCommandView;
+using ola::rdm::RDMGetResponse;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::UID;
+
+class RDMCommandViewTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMCommandViewTest);
+  CPPUNIT_TEST(testParseRequest);
+  CPPUNIT_TEST(testParseResponse);
+  CPPUNIT_TEST(testInvalidData);
+  CPPUNIT_TEST(testRewrite);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  RDMCommandViewTest()
+    : m_source(1, 2),
+      m_destination(3, 4) {
+  }
+
+  void testParseRequest();
+  void testParseResponse();
+  void testInvalidData();
+  void testRewrite();
+
+ private:
+  UID m_source;
+  UID m_destination;
+
+  static const uint8_t PARAM_DATA[];
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMCommandViewTest);
+
+const uint8_t RDMCommandViewTest::PARAM_DATA[] = {0xa5, 0xa5, 0xa5, 0xa5};
+
+
+/*
+ * Check a request can be parsed.
+ */
+void RDMCommandViewTest::testParseRequest() {
+  RDMSetRequest request(m_source, m_destination,
+                        0,  // transaction #
+                        1,  // port id
+                        10,  // sub device
+                        296,  // param id
+                        PARAM_DATA, arraysize(PARAM_DATA));
+
+  uint8_t buffer[64];
+  unsigned int size = sizeof(buffer);
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(request, buffer, &size));
+
+  RDMCommandView view;
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, view.Parse(buffer, size));
+  OLA_ASSERT_EQ(m_source, view.SourceUID());
+  OLA_ASSERT_EQ(m_destination, view.DestinationUID());
+  OLA_ASSERT_EQ((uint8_t) 0, view.TransactionNumber());
+  OLA_ASSERT_EQ((uint8_t) 1, view.PortIdResponseType());
+  OLA_ASSERT_EQ((uint16_t) 10, view.SubDevice());
+  OLA_ASSERT_EQ(RDMCommand::SET_COMMAND, view.CommandClass());
+  OLA_ASSERT_EQ((uint16_t) 296, view.ParamId());
+  OLA_ASSERT_TRUE(view.IsRequest());
+  OLA_ASSERT_FALSE(view.IsResponse());
+
+  // The param data refers into the buffer
+  OLA_ASSERT_EQ(static_cast<unsigned int>(arraysize(PARAM_DATA)),
+                view.ParamDataSize());
+  OLA_ASSERT_TRUE(view.ParamData() >= buffer &&
+                  view.ParamData() < buffer + size);
+  OLA_ASSERT_DATA_EQUALS(PARAM_DATA, arraysize(PARAM_DATA),
+                         view.ParamData(), view.ParamDataSize());
+}
+
+
+/*
+ * Check a response can be parsed.
+ */
+void RDMCommandViewTest::testParseResponse() {
+  RDMGetResponse response(m_source, m_destination,
+                          3,  // transaction #
+                          ola::rdm::RDM_ACK,
+                          0,  // message count
+                          0,  // sub device
+                          296,  // param id
+                          NULL, 0);
+
+  uint8_t buffer[64];
+  unsigned int size = sizeof(buffer);
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(response, buffer, &size));
+
+  RDMCommandView view;
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, view.Parse(buffer, size));
+  OLA_ASSERT_EQ(RDMCommand::GET_COMMAND_RESPONSE, view.CommandClass());
+  OLA_ASSERT_EQ((uint8_t) ola::rdm::RDM_ACK, view.PortIdResponseType());
+  OLA_ASSERT_FALSE(view.IsRequest());
+  OLA_ASSERT_TRUE(view.IsResponse());
+  OLA_ASSERT_EQ(0u, view.ParamDataSize());
+}
+
+
+/*
+ * Check invalid data is rejected.
+ */
+void RDMCommandViewTest::testInvalidData() {
+  RDMCommandView view;
+  OLA_ASSERT_EQ(ola::rdm::RDM_PACKET_TOO_SHORT, view.Parse(NULL, 0));
+  OLA_ASSERT_FALSE(view.IsRequest());
+
+  RDMSetRequest request(m_source, m_destination, 0, 1, 10, 296,
+                        PARAM_DATA, arraysize(PARAM_DATA));
+  uint8_t buffer[64];
+  unsigned int size = sizeof(buffer);
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(request, buffer, &size));
+
+  buffer[size - 1]++;
+  OLA_ASSERT_EQ(ola::rdm::RDM_CHECKSUM_INCORRECT, view.Parse(buffer, size));
+  OLA_ASSERT_FALSE(view.IsRequest());
+  OLA_ASSERT_EQ(RDMCommand::INVALID_COMMAND, view.CommandClass());
+}
+
+
+/*
+ * Check a modified view serializes to the same bytes as the equivalent
+ * RDMCommand.
+ */
+void RDMCommandViewTest::testRewrite() {
+  RDMSetRequest request(m_source, m_destination, 0, 1, 10, 296,
+                        PARAM_DATA, arraysize(PARAM_DATA));
+  uint8_t buffer[64];
+  unsigned int size = sizeof(buffer);
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(request, buffer, &size));
+
+  RDMCommandView view;
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, view.Parse(buffer, size));
+  UID new_source(5, 6);
+  view.SetSourceUID(new_source);
+  view.SetTransactionNumber(7);
+  view.SetPortIdResponseType(2);
+
+  RDMSetRequest expected(new_source, m_destination, 7, 2, 10, 296,
+                         PARAM_DATA, arraysize(PARAM_DATA));
+  uint8_t expected_buffer[64];
+  unsigned int expected_size = sizeof(expected_buffer);
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(expected, expected_buffer,
+                                             &expected_size));
+
+  uint8_t output[64];
+  unsigned int output_size = sizeof(output);
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(view, output, &output_size));
+  OLA_ASSERT_DATA_EQUALS(expected_buffer, expected_size, output, output_size);
+
+  // Too small a buffer fails
+  output_size = 10;
+  OLA_ASSERT_FALSE(RDMCommandSerializer::Pack(view, output, &output_size));
+
+  IOStack stack;
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Write(view, &stack));
+  OLA_ASSERT_EQ(expected_size, stack.Size());
+  uint8_t stack_output[64];
+  OLA_ASSERT_EQ(expected_size, stack.Read(stack_output, stack.Size()));
+  OLA_ASSERT_DATA_EQUALS(expected_buffer, expected_size, stack_output,
+                         expected_size);
+}
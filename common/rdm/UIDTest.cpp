@@ -226,6 +226,23 @@ void UIDTest::testUIDSet() {
 
   difference = set3.SetDifference(set1);
   OLA_ASSERT_EQ(0u, difference.Size());
+
+  // UIDs added out of order are kept sorted
+  UIDSet set4;
+  UID uid3(1, 1);
+  set4.AddUID(uid2);
+  set4.AddUID(uid);
+  set4.AddUID(uid3);
+  set4.AddUID(uid);
+  OLA_ASSERT_EQ(3u, set4.Size());
+  OLA_ASSERT_EQ(string("0001:00000001,0001:00000002,0002:0000000a"),
+                set4.ToString());
+  OLA_ASSERT_TRUE(set4.Contains(uid3));
+  set4.RemoveUID(uid);
+  set4.RemoveUID(uid);
+  OLA_ASSERT_EQ(2u, set4.Size());
+  OLA_ASSERT_FALSE(set4.Contains(uid));
+  OLA_ASSERT_EQ(string("0001:00000001,0002:0000000a"), set4.ToString());
 }
 
 
@@ -19,12 +19,13 @@
 
 
 #include <ola/messaging/Descriptor.h>
-#include <vector>
+#include <ola/messaging/DescriptorLayout.h>
 #include "common/rdm/VariableFieldSizeCalculator.h"
 
 namespace ola {
 namespace rdm {
 
+using ola::messaging::DescriptorLayout;
 using ola::messaging::FieldDescriptorGroup;
 using ola::messaging::StringFieldDescriptor;
 
@@ -35,7 +36,8 @@ using ola::messaging::StringFieldDescriptor;
  * length fields are not supported as this doesn't allow us to determine the
  * boundary of the individual fields within a message.
  *
- * This method is *not* re-entrant.
+ * The fixed & variable fields are found when the descriptor's layout is
+ * built, so this doesn't need to walk the descriptor.
  * @param data_size the size in bytes of the data in this message
  * @param descriptor The descriptor to use to build the Message
  * @param variable_field_size a pointer to a int which is set to the length of
@@ -48,145 +50,77 @@ VariableFieldSizeCalculator::calculator_state
         unsigned int data_size,
         const class ola::messaging::Descriptor *descriptor,
         unsigned int *variable_field_size) {
-  m_fixed_size_sum = 0;
-  m_variable_string_fields.clear();
-  m_variable_group_fields.clear();
+  const DescriptorLayout &layout = descriptor->Layout();
 
-  // split out the fields into fixed and variable length
-  for (unsigned int i = 0; i < descriptor->FieldCount(); ++i)
-    descriptor->GetField(i)->Accept(this);
-
-  if (data_size < m_fixed_size_sum)
+  if (data_size < layout.FixedSize())
     return TOO_SMALL;
 
-  unsigned int variable_string_field_count = m_variable_string_fields.size();
-  unsigned int variable_group_field_count = m_variable_group_fields.size();
-
-  if (variable_string_field_count + variable_group_field_count > 1)
-    return MULTIPLE_VARIABLE_FIELDS;
-
-  if (variable_string_field_count + variable_group_field_count == 0)
-    return data_size > m_fixed_size_sum ? TOO_LARGE : FIXED_SIZE;
-
-  // we know there is only one, now we need to work out the number of
+  // we know there is at most one, now we need to work out the number of
   // repeatitions or length if it's a string
-  unsigned int bytes_remaining = data_size - m_fixed_size_sum;
-  if (variable_string_field_count) {
-    // variable string
-    const StringFieldDescriptor *string_descriptor =
-      m_variable_string_fields[0];
-
-    if (bytes_remaining < string_descriptor->MinSize())
-      return TOO_SMALL;
-    if (bytes_remaining > string_descriptor->MaxSize())
-      return TOO_LARGE;
-    *variable_field_size = bytes_remaining;
-    return VARIABLE_STRING;
-  } else {
-    // variable group
-    const FieldDescriptorGroup *group_descriptor = m_variable_group_fields[0];
-    if (!group_descriptor->FixedBlockSize())
+  unsigned int bytes_remaining = data_size - layout.FixedSize();
+  switch (layout.VariableType()) {
+    case DescriptorLayout::NO_VARIABLE_FIELD:
+      return bytes_remaining ? TOO_LARGE : FIXED_SIZE;
+    case DescriptorLayout::MULTIPLE_VARIABLE_FIELDS:
+      return MULTIPLE_VARIABLE_FIELDS;
+    case DescriptorLayout::NESTED_VARIABLE_GROUP:
       return NESTED_VARIABLE_GROUPS;
-
-    unsigned int block_size = group_descriptor->BlockSize();
-    if (group_descriptor->LimitedSize() &&
-        bytes_remaining > block_size * group_descriptor->MaxBlocks())
-      return TOO_LARGE;
-
-    if (bytes_remaining % block_size)
-      return MISMATCHED_SIZE;
-
-    unsigned int repeat_count = bytes_remaining / block_size;
-    if (repeat_count < group_descriptor->MinBlocks())
-      return TOO_SMALL;
-
-    if (group_descriptor->MaxBlocks() !=
-          FieldDescriptorGroup::UNLIMITED_BLOCKS &&
-        repeat_count >
-          static_cast<unsigned int>(group_descriptor->MaxBlocks()))
-      return TOO_LARGE;
-
-    *variable_field_size = repeat_count;
-    return VARIABLE_GROUP;
+    case DescriptorLayout::VARIABLE_STRING:
+      return CalculateStringSize(layout.VariableString(), bytes_remaining,
+                                 variable_field_size);
+    case DescriptorLayout::VARIABLE_GROUP:
+      return CalculateGroupSize(layout.VariableGroup(), bytes_remaining,
+                                variable_field_size);
   }
+  return MULTIPLE_VARIABLE_FIELDS;
 }
 
 
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::BoolFieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
-}
-
-
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::IPV4FieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
-}
-
-
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::MACFieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
-}
-
-
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::UIDFieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
-}
-
-
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::StringFieldDescriptor *descriptor) {
-  if (descriptor->FixedSize())
-    m_fixed_size_sum += descriptor->MaxSize();
-  else
-    m_variable_string_fields.push_back(descriptor);
-}
-
-
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::UInt8FieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
-}
-
-
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::UInt16FieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
-}
-
-
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::UInt32FieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
-}
-
-
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::Int8FieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
+/**
+ * Work out the length of a variable string.
+ */
+VariableFieldSizeCalculator::calculator_state
+    VariableFieldSizeCalculator::CalculateStringSize(
+        const StringFieldDescriptor *string_descriptor,
+        unsigned int bytes_remaining,
+        unsigned int *variable_field_size) {
+  if (bytes_remaining < string_descriptor->MinSize())
+    return TOO_SMALL;
+  if (bytes_remaining > string_descriptor->MaxSize())
+    return TOO_LARGE;
+  *variable_field_size = bytes_remaining;
+  return VARIABLE_STRING;
 }
 
 
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::Int16FieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
-}
+/**
+ * Work out the number of repeatitions of a variable group.
+ */
+VariableFieldSizeCalculator::calculator_state
+    VariableFieldSizeCalculator::CalculateGroupSize(
+        const FieldDescriptorGroup *group_descriptor,
+        unsigned int bytes_remaining,
+        unsigned int *variable_field_size) {
+  unsigned int block_size = group_descriptor->BlockSize();
+  if (group_descriptor->LimitedSize() &&
+      bytes_remaining > block_size * group_descriptor->MaxBlocks())
+    return TOO_LARGE;
 
+  if (bytes_remaining % block_size)
+    return MISMATCHED_SIZE;
 
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::Int32FieldDescriptor *descriptor) {
-  m_fixed_size_sum += descriptor->MaxSize();
-}
+  unsigned int repeat_count = bytes_remaining / block_size;
+  if (repeat_count < group_descriptor->MinBlocks())
+    return TOO_SMALL;
 
+  if (group_descriptor->MaxBlocks() !=
+        FieldDescriptorGroup::UNLIMITED_BLOCKS &&
+      repeat_count >
+        static_cast<unsigned int>(group_descriptor->MaxBlocks()))
+    return TOO_LARGE;
 
-void VariableFieldSizeCalculator::Visit(
-    const ola::messaging::FieldDescriptorGroup *descriptor) {
-  if (descriptor->FixedSize())
-    m_fixed_size_sum += descriptor->MaxSize();
-  else
-    m_variable_group_fields.push_back(descriptor);
+  *variable_field_size = repeat_count;
+  return VARIABLE_GROUP;
 }
 }  // namespace rdm
 }  // namespace ola
@@ -18,7 +18,9 @@ common_libolacommon_la_SOURCES += \
     common/rpc/RpcPeer.h \
     common/rpc/RpcServer.cpp \
     common/rpc/RpcServer.h \
-    common/rpc/RpcService.h
+    common/rpc/RpcService.h \
+    common/rpc/WireReader.cpp \
+    common/rpc/WireReader.h
 nodist_common_libolacommon_la_SOURCES += common/rpc/Rpc.pb.cc
 common_libolacommon_la_LIBADD += $(libprotobuf_LIBS)
 
@@ -47,6 +49,7 @@ common_rpc_RpcTester_SOURCES = \
     common/rpc/RpcControllerTest.cpp \
     common/rpc/RpcChannelTest.cpp \
     common/rpc/RpcHeaderTest.cpp \
+    common/rpc/WireReaderTest.cpp \
     $(common_rpc_TEST_SOURCES)
 nodist_common_rpc_RpcTester_SOURCES = \
     common/rpc/TestService.pb.cc \
@@ -20,22 +20,26 @@
 
 #include "common/rpc/RpcChannel.h"
 
-#include <errno.h>
+#include <string.h>
 #include <google/protobuf/service.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/dynamic_message.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "common/rpc/Rpc.pb.h"
 #include "common/rpc/RpcSession.h"
 #include "common/rpc/RpcController.h"
 #include "common/rpc/RpcHeader.h"
 #include "common/rpc/RpcService.h"
+#include "common/rpc/WireReader.h"
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/util/Trace.h"
 
 namespace ola {
 namespace rpc {
@@ -113,12 +117,17 @@ RpcChannel::RpcChannel(
     : m_session(new RpcSession(this)),
       m_service(service),
       m_descriptor(descriptor),
-      m_buffer(NULL),
-      m_buffer_size(0),
-      m_expected_size(0),
-      m_current_size(0),
+      m_read_buffer(INITIAL_BUFFER_SIZE),
       m_export_map(export_map),
-      m_recv_type_map(NULL) {
+      m_sent_var(NULL),
+      m_sent_error_var(NULL),
+      m_received_var(NULL),
+      m_received_type_vars(STREAM_REQUEST + 1,
+                           static_cast<unsigned int*>(NULL)),
+      m_incoming_message(new RpcMessage()),
+      m_stream_method(NULL),
+      m_scheduler(NULL),
+      m_flush_timeout(ola::thread::INVALID_TIMEOUT) {
   if (descriptor) {
     descriptor->SetOnData(
         ola::NewCallback(this, &RpcChannel::DescriptorReady));
@@ -126,76 +135,73 @@ RpcChannel::RpcChannel(
         ola::NewSingleCallback(this, &RpcChannel::HandleChannelClose));
   }
 
+  // These are updated for every message, so fetch them once.
   if (m_export_map) {
     for (unsigned int i = 0; i < arraysize(K_RPC_VARIABLES); ++i) {
       m_export_map->GetCounterVar(string(K_RPC_VARIABLES[i]));
     }
-    m_recv_type_map = m_export_map->GetUIntMapVar(K_RPC_RECEIVED_TYPE_VAR,
-                                                  "type");
+    m_sent_var = m_export_map->GetCounterVar(K_RPC_SENT_VAR);
+    m_sent_error_var = m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR);
+    m_received_var = m_export_map->GetCounterVar(K_RPC_RECEIVED_VAR);
+
+    UIntMap *type_map = m_export_map->GetUIntMapVar(K_RPC_RECEIVED_TYPE_VAR,
+                                                    "type");
+    m_received_type_vars[REQUEST] = type_map->Handle("request");
+    m_received_type_vars[RESPONSE] = type_map->Handle("response");
+    m_received_type_vars[RESPONSE_CANCEL] = type_map->Handle("cancelled");
+    m_received_type_vars[RESPONSE_FAILED] = type_map->Handle("failed");
+    m_received_type_vars[RESPONSE_NOT_IMPLEMENTED] = type_map->Handle(
+        "not-implemented");
+    m_received_type_vars[STREAM_REQUEST] = type_map->Handle("stream_request");
   }
 }
 
 RpcChannel::~RpcChannel() {
-  free(m_buffer);
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_flush_timeout);
+  }
+  STLDeleteValues(&m_request_messages);
 }
 
 void RpcChannel::DescriptorReady() {
-  if (!m_expected_size) {
-    // this is a new msg
-    unsigned int version;
-    if (ReadHeader(&version, &m_expected_size) < 0)
-      return;
-
-    if (!m_expected_size)
-      return;
-
-    if (version != PROTOCOL_VERSION) {
-      OLA_WARN << "protocol mismatch " << version << " != " <<
-        PROTOCOL_VERSION;
-      return;
-    }
-
-    if (m_expected_size > MAX_BUFFER_SIZE) {
-      OLA_WARN << "Incoming message size " << m_expected_size
-                << " is larger than MAX_BUFFER_SIZE: " << MAX_BUFFER_SIZE;
-      m_descriptor->Close();
-      return;
-    }
-
-    m_current_size = 0;
-    m_buffer_size = AllocateMsgBuffer(m_expected_size);
+  OLA_TRACE_SCOPE("rpc", "RpcChannel::DescriptorReady");
+  if (!m_descriptor) {
+    return;
+  }
 
-    if (m_buffer_size < m_expected_size) {
-      OLA_WARN << "buffer size to small " << m_buffer_size << " < " <<
-        m_expected_size;
-      return;
+  // If the partial message is larger than the free space, grow the buffer.
+  unsigned int required = INITIAL_BUFFER_SIZE;
+  if (m_read_buffer.Size() >= sizeof(uint32_t)) {
+    unsigned int version, size;
+    DecodeHeader(m_read_buffer.Data(), &version, &size);
+    if (size <= MAX_BUFFER_SIZE) {
+      required = std::max(
+          required,
+          static_cast<unsigned int>(sizeof(uint32_t)) + size -
+              m_read_buffer.Size());
     }
   }
-
-  if (!m_descriptor) {
+  uint8_t *space = m_read_buffer.Reserve(required);
+  if (!space) {
+    OLA_WARN << "Failed to allocate a " << required << " byte RPC buffer";
+    m_descriptor->Close();
     return;
   }
 
   unsigned int data_read;
-  if (m_descriptor->Receive(m_buffer + m_current_size,
-                            m_expected_size - m_current_size,
+  if (m_descriptor->Receive(space, m_read_buffer.WritableSize(),
                             data_read) < 0) {
     OLA_WARN << "something went wrong in descriptor recv\n";
     return;
   }
+  m_read_buffer.Commit(data_read);
 
-  m_current_size += data_read;
-
-  if (m_current_size == m_expected_size) {
-    // we've got all of this message so parse it.
-    if (!HandleNewMsg(m_buffer, m_expected_size)) {
-      // this probably means we've messed the framing up, close the channel
-      OLA_WARN << "Errors detected on RPC channel, closing";
-      m_descriptor->Close();
-    }
-    m_expected_size = 0;
+  if (!HandleBufferedMsgs()) {
+    // this probably means we've messed the framing up, close the channel
+    OLA_WARN << "Errors detected on RPC channel, closing";
+    m_descriptor->Close();
+    m_read_buffer.Clear();
   }
-  return;
 }
 
 void RpcChannel::SetChannelCloseHandler(CloseCallback *callback) {
@@ -207,8 +213,16 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
                             const Message *request,
                             Message *reply,
                             SingleUseCallback0<void> *done) {
+  request->SerializeToString(&m_request_buffer);
+  CallMethod(method, controller, m_request_buffer, reply, done);
+}
+
+void RpcChannel::CallMethod(const MethodDescriptor *method,
+                            RpcController *controller,
+                            const string &serialized_request,
+                            Message *reply,
+                            SingleUseCallback0<void> *done) {
   // TODO(simonn): reduce the number of copies here
-  string output;
   RpcMessage message;
   bool is_streaming = false;
 
@@ -227,8 +241,7 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
   message.set_id(m_sequence.Next());
   message.set_name(method->name());
 
-  request->SerializeToString(&output);
-  message.set_buffer(output);
+  message.set_buffer(serialized_request);
   bool r = SendMsg(&message);
 
   if (is_streaming)
@@ -284,31 +297,74 @@ RpcSession *RpcChannel::Session() {
  * Write an RpcMessage to the write descriptor.
  */
 bool RpcChannel::SendMsg(RpcMessage *msg) {
+  OLA_TRACE_SCOPE("rpc", "RpcChannel::SendMsg");
   if (!(m_descriptor && m_descriptor->ValidReadDescriptor())) {
     OLA_WARN << "RPC descriptor closed, not sending messages";
     return false;
   }
 
+  if (!m_scheduler) {
+    m_send_buffer.clear();
+  }
+
   uint32_t header;
   // reserve the first 4 bytes for the header
-  string output(sizeof(header), 0);
-  msg->AppendToString(&output);
-  int length = output.size();
+  const unsigned int offset = m_send_buffer.size();
+  m_send_buffer.append(sizeof(header), 0);
+  msg->AppendToString(&m_send_buffer);
+  unsigned int length = m_send_buffer.size() - offset;
 
   RpcHeader::EncodeHeader(&header, PROTOCOL_VERSION,
                                 length - sizeof(header));
-  output.replace(
-      0, sizeof(header),
+  m_send_buffer.replace(
+      offset, sizeof(header),
       reinterpret_cast<const char*>(&header), sizeof(header));
 
+  if (m_sent_var) {
+    (*m_sent_var)++;
+  }
+
+  if (!m_scheduler) {
+    return Flush();
+  }
+
+  if (m_send_buffer.size() >= MAX_BUFFER_SIZE) {
+    return Flush();
+  }
+  if (m_flush_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_flush_timeout = m_scheduler->RegisterSingleTimeout(
+        0, NewSingleCallback(this, &RpcChannel::FlushTimeout));
+  }
+  return true;
+}
+
+bool RpcChannel::Flush() {
+  OLA_TRACE_SCOPE("rpc", "RpcChannel::Flush");
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_flush_timeout);
+    m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  if (m_send_buffer.empty()) {
+    return true;
+  }
+
+  if (!(m_descriptor && m_descriptor->ValidReadDescriptor())) {
+    OLA_WARN << "RPC descriptor closed, not sending messages";
+    m_send_buffer.clear();
+    return false;
+  }
+
+  const ssize_t length = m_send_buffer.size();
   ssize_t ret = m_descriptor->Send(
-      reinterpret_cast<const uint8_t*>(output.data()), length);
+      reinterpret_cast<const uint8_t*>(m_send_buffer.data()), length);
+  m_send_buffer.clear();
 
   if (ret != length) {
     OLA_WARN << "Failed to send full RPC message, closing channel";
 
-    if (m_export_map) {
-      (*m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR))++;
+    if (m_sent_error_var) {
+      (*m_sent_error_var)++;
     }
 
     // At this point there is no point using the descriptor since framing has
@@ -320,111 +376,107 @@ bool RpcChannel::SendMsg(RpcMessage *msg) {
     HandleChannelClose();
     return false;
   }
+  return true;
+}
 
-  if (m_export_map) {
-    (*m_export_map->GetCounterVar(K_RPC_SENT_VAR))++;
+void RpcChannel::SetWriteCoalescing(
+    ola::thread::SchedulerInterface *scheduler) {
+  if (scheduler != m_scheduler) {
+    Flush();
   }
-  return true;
+  m_scheduler = scheduler;
+}
+
+void RpcChannel::FlushTimeout() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  Flush();
 }
 
 
 /*
- * Allocate an incoming message buffer
- * @param size the size of the new buffer to allocate
- * @returns the size of the new buffer
+ * Handle each of the complete messages in the read buffer.
+ * @returns false if the framing is broken.
  */
-int RpcChannel::AllocateMsgBuffer(unsigned int size) {
-  unsigned int requested_size = size;
-  uint8_t *new_buffer;
-
-  if (size < m_buffer_size)
-    return size;
+bool RpcChannel::HandleBufferedMsgs() {
+  const unsigned int header_size = sizeof(uint32_t);
+  while (m_read_buffer.Size() >= header_size) {
+    unsigned int version, size;
+    DecodeHeader(m_read_buffer.Data(), &version, &size);
 
-  if (m_buffer_size == 0 && size < INITIAL_BUFFER_SIZE)
-    requested_size = INITIAL_BUFFER_SIZE;
+    if (version != PROTOCOL_VERSION) {
+      OLA_WARN << "protocol mismatch " << version << " != " <<
+        PROTOCOL_VERSION;
+      return false;
+    }
 
-  if (requested_size > MAX_BUFFER_SIZE) {
-    OLA_WARN << "Incoming message size " << requested_size
-              << " is larger than MAX_BUFFER_SIZE: " << MAX_BUFFER_SIZE;
-    return m_buffer_size;
-  }
+    if (size > MAX_BUFFER_SIZE) {
+      OLA_WARN << "Incoming message size " << size
+                << " is larger than MAX_BUFFER_SIZE: " << MAX_BUFFER_SIZE;
+      return false;
+    }
 
-  new_buffer = static_cast<uint8_t*>(realloc(m_buffer, requested_size));
-  if (!new_buffer)
-    return m_buffer_size;
+    if (m_read_buffer.Size() - header_size < size) {
+      // Wait for the rest of the message.
+      break;
+    }
 
-  m_buffer = new_buffer;
-  m_buffer_size = requested_size;
-  return requested_size;
+    // Popping the message doesn't touch the data, it stays valid until the
+    // next read.
+    const uint8_t *data = m_read_buffer.Data() + header_size;
+    m_read_buffer.Pop(header_size + size);
+    // Empty messages are skipped.
+    if (size && !HandleNewMsg(data, size)) {
+      return false;
+    }
+  }
+  return true;
 }
 
 
 /*
- * Read 4 bytes and decode the header fields.
- * @returns: -1 if there is no data is available, version and size are 0
+ * Decode the header at the start of a message.
  */
-int RpcChannel::ReadHeader(unsigned int *version,
-                                 unsigned int *size) const {
+void RpcChannel::DecodeHeader(const uint8_t *data, unsigned int *version,
+                              unsigned int *size) {
   uint32_t header;
-  unsigned int data_read = 0;
-  *version = *size = 0;
-
-  if (m_descriptor->Receive(reinterpret_cast<uint8_t*>(&header),
-                            sizeof(header), data_read)) {
-    OLA_WARN << "read header error: " << strerror(errno);
-    return -1;
-  }
-
-  if (!data_read)
-    return 0;
-
+  memcpy(&header, data, sizeof(header));
   RpcHeader::DecodeHeader(header, version, size);
-  return 0;
 }
 
 
 /*
  * Parse a new message and handle it.
  */
-bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
-  RpcMessage msg;
+bool RpcChannel::HandleNewMsg(const uint8_t *data, unsigned int size) {
+  if (HandleRawStreamRequest(data, size)) {
+    CountReceived(STREAM_REQUEST);
+    return true;
+  }
+
+  RpcMessage &msg = *m_incoming_message;
   if (!msg.ParseFromArray(data, size)) {
     OLA_WARN << "Failed to parse RPC";
     return false;
   }
-
-  if (m_export_map)
-    (*m_export_map->GetCounterVar(K_RPC_RECEIVED_VAR))++;
+  CountReceived(msg.type());
 
   switch (msg.type()) {
     case REQUEST:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["request"]++;
       HandleRequest(&msg);
       break;
     case RESPONSE:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["response"]++;
       HandleResponse(&msg);
       break;
     case RESPONSE_CANCEL:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["cancelled"]++;
       HandleCanceledResponse(&msg);
       break;
     case RESPONSE_FAILED:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["failed"]++;
       HandleFailedResponse(&msg);
       break;
     case RESPONSE_NOT_IMPLEMENTED:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["not-implemented"]++;
       HandleNotImplemented(&msg);
       break;
     case STREAM_REQUEST:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["stream_request"]++;
       HandleStreamRequest(&msg);
       break;
     default:
@@ -435,6 +487,109 @@ bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
 }
 
 
+void RpcChannel::CountReceived(unsigned int type) {
+  if (m_received_var) {
+    (*m_received_var)++;
+  }
+  if (type < m_received_type_vars.size() && m_received_type_vars[type]) {
+    (*m_received_type_vars[type])++;
+  }
+}
+
+
+/*
+ * Pass a streaming request to the service without parsing the RpcMessage or
+ * the request, if the service supports it. Anything unexpected is left for
+ * the normal path, which also reports the errors.
+ * @returns true if the service handled the request.
+ */
+bool RpcChannel::HandleRawStreamRequest(const uint8_t *data,
+                                        unsigned int size) {
+  if (!m_service) {
+    return false;
+  }
+
+  WireReader reader(data, size);
+  WireField field;
+  bool is_stream_request = false;
+  const uint8_t *name = NULL;
+  unsigned int name_size = 0;
+  const uint8_t *request = data;
+  unsigned int request_size = 0;
+
+  // See Rpc.proto, the type comes first so other messages are skipped
+  // quickly.
+  while (reader.Next(&field)) {
+    switch (field.number) {
+      case 1:
+        if (field.type != WireField::VARINT ||
+            field.value != STREAM_REQUEST) {
+          return false;
+        }
+        is_stream_request = true;
+        break;
+      case 2:
+        // The id isn't used for streaming requests.
+        break;
+      case 3:
+        if (field.type != WireField::LENGTH_DELIMITED) {
+          return false;
+        }
+        name = field.data;
+        name_size = field.size;
+        break;
+      case 4:
+        if (field.type != WireField::LENGTH_DELIMITED) {
+          return false;
+        }
+        request = field.data;
+        request_size = field.size;
+        break;
+      default:
+        return false;
+    }
+  }
+
+  if (reader.Failed() || !is_stream_request || !name) {
+    return false;
+  }
+
+  const MethodDescriptor *method = StreamingMethod(name, name_size);
+  if (!method) {
+    return false;
+  }
+  RpcController controller(m_session.get());
+  return m_service->CallStreamingMethod(method, &controller, request,
+                                        request_size);
+}
+
+
+/*
+ * Find a streaming method by name. Clients tend to call the same streaming
+ * method over and over, so the last one is cached.
+ */
+const MethodDescriptor *RpcChannel::StreamingMethod(const uint8_t *name,
+                                                    unsigned int size) {
+  if (m_stream_method && m_stream_method_name.size() == size &&
+      !memcmp(m_stream_method_name.data(), name, size)) {
+    return m_stream_method;
+  }
+
+  const ServiceDescriptor *service = m_service->GetDescriptor();
+  if (!service) {
+    return NULL;
+  }
+  const string method_name(reinterpret_cast<const char*>(name), size);
+  const MethodDescriptor *method = service->FindMethodByName(method_name);
+  if (!method || method->output_type()->name() != STREAMING_NO_RESPONSE) {
+    return NULL;
+  }
+  m_stream_method_name = method_name;
+  m_stream_method = method;
+  return method;
+}
+
+
 /*
  * Handle a new RPC method call.
  */
@@ -456,7 +611,7 @@ void RpcChannel::HandleRequest(RpcMessage *msg) {
     return;
   }
 
-  Message* request_pb = m_service->GetRequestPrototype(method).New();
+  Message* request_pb = RequestMessage(method);
   Message* response_pb = m_service->GetResponsePrototype(method).New();
 
   if (!request_pb || !response_pb) {
@@ -466,6 +621,7 @@ void RpcChannel::HandleRequest(RpcMessage *msg) {
 
   if (!request_pb->ParseFromString(msg->buffer())) {
     OLA_WARN << "parsing of request pb failed";
+    delete response_pb;
     return;
   }
 
@@ -482,7 +638,6 @@ void RpcChannel::HandleRequest(RpcMessage *msg) {
       this, &RpcChannel::RequestComplete, request);
   m_service->CallMethod(method, request->controller, request_pb, response_pb,
                         callback);
-  delete request_pb;
 }
 
 
@@ -513,7 +668,7 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
     return;
   }
 
-  Message* request_pb = m_service->GetRequestPrototype(method).New();
+  Message* request_pb = RequestMessage(method);
 
   if (!request_pb) {
     OLA_WARN << "failed to get request or response objects";
@@ -527,7 +682,19 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
 
   RpcController controller(m_session.get());
   m_service->CallMethod(method, &controller, request_pb, NULL, NULL);
-  delete request_pb;
+}
+
+/*
+ * Return the request message for a method. Services don't hold on to the
+ * request once CallMethod() returns, so one message per method is reused for
+ * all calls.
+ */
+Message *RpcChannel::RequestMessage(const MethodDescriptor *method) {
+  Message *&request = m_request_messages[method];
+  if (!request) {
+    request = m_service->GetRequestPrototype(method).New();
+  }
+  return request;
 }
 
 
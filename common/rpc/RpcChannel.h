@@ -29,8 +29,13 @@
 #include <google/protobuf/service.h>
 #include <ola/Callback.h>
 #include <ola/io/Descriptor.h>
+#include <ola/io/RingBuffer.h>
+#include <ola/thread/SchedulerInterface.h>
 #include <ola/util/SequenceNumber.h>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "ola/ExportMap.h"
 
@@ -117,6 +122,23 @@ class RpcChannel {
                     google::protobuf::Message *response,
                     SingleUseCallback0<void> *done);
 
+    /**
+     * @brief Invoke an RPC method with a request that's already serialized.
+     * @param method the method to invoke.
+     * @param controller the RpcController for the call.
+     * @param serialized_request the serialized request message.
+     * @param response the message to store the response in.
+     * @param done the callback to run once the call completes.
+     *
+     * This allows the same request to be sent on many channels while only
+     * serializing it once.
+     */
+    void CallMethod(const google::protobuf::MethodDescriptor *method,
+                    class RpcController *controller,
+                    const std::string &serialized_request,
+                    google::protobuf::Message *response,
+                    SingleUseCallback0<void> *done);
+
     /**
      * @brief Invoked by the RPC completion handler when the server side
      * response is ready.
@@ -124,6 +146,24 @@ class RpcChannel {
      */
     void RequestComplete(class OutstandingRequest *request);
 
+    /**
+     * @brief Coalesce the messages sent in the same loop iteration into a
+     *   single write.
+     * @param scheduler the scheduler used to flush the messages, or NULL to
+     *   send each message as it's generated. Ownership is not transferred.
+     *
+     * This reduces the number of system calls and packets when many RPCs are
+     * sent in a row. Any messages that haven't been sent when the channel is
+     * destroyed are discarded, so call Flush() first.
+     */
+    void SetWriteCoalescing(ola::thread::SchedulerInterface *scheduler);
+
+    /**
+     * @brief Send any messages held back by write coalescing.
+     * @returns false if the write failed, true otherwise.
+     */
+    bool Flush();
+
     /**
      * @brief Return the RpcSession associated with this channel.
      * @returns the RpcSession associated with this channel.
@@ -145,21 +185,42 @@ class RpcChannel {
     // the descriptor to read/write to.
     class ola::io::ConnectedDescriptor *m_descriptor;
     SequenceNumber<uint32_t> m_sequence;
-    uint8_t *m_buffer;  // buffer for incoming msgs
-    unsigned int m_buffer_size;  // size of the buffer
-    unsigned int m_expected_size;  // the total size of the current msg
-    unsigned int m_current_size;  // the amount of data read for the current msg
+    // Incoming data is read in large chunks, and all the complete messages
+    // are handled directly from this buffer.
+    ola::io::RingBuffer m_read_buffer;
     HASH_NAMESPACE::HASH_MAP_CLASS<int, class OutstandingRequest*> m_requests;
     ResponseMap m_responses;
     ExportMap *m_export_map;
-    UIntMap *m_recv_type_map;
+    CounterVariable *m_sent_var;
+    CounterVariable *m_sent_error_var;
+    CounterVariable *m_received_var;
+    // Indexed by the RpcMessage type, NULL for types that aren't counted.
+    std::vector<unsigned int*> m_received_type_vars;
+    // These are reused so that steady state streaming doesn't allocate.
+    std::auto_ptr<RpcMessage> m_incoming_message;
+    std::map<const google::protobuf::MethodDescriptor*,
+             google::protobuf::Message*> m_request_messages;
+    std::string m_request_buffer;
+    // The last method called by HandleRawStreamRequest().
+    std::string m_stream_method_name;
+    const google::protobuf::MethodDescriptor *m_stream_method;
+    // The framed messages waiting to be written.
+    std::string m_send_buffer;
+    ola::thread::SchedulerInterface *m_scheduler;
+    ola::thread::timeout_id m_flush_timeout;
 
     bool SendMsg(RpcMessage *msg);
-    int AllocateMsgBuffer(unsigned int size);
-    int ReadHeader(unsigned int *version, unsigned int *size) const;
-    bool HandleNewMsg(uint8_t *buffer, unsigned int size);
+    void FlushTimeout();
+    bool HandleBufferedMsgs();
+    bool HandleNewMsg(const uint8_t *buffer, unsigned int size);
+    void CountReceived(unsigned int type);
+    bool HandleRawStreamRequest(const uint8_t *data, unsigned int size);
+    const google::protobuf::MethodDescriptor *StreamingMethod(
+        const uint8_t *name, unsigned int size);
     void HandleRequest(RpcMessage *msg);
     void HandleStreamRequest(RpcMessage *msg);
+    google::protobuf::Message *RequestMessage(
+        const google::protobuf::MethodDescriptor *method);
 
     // server end
     void SendRequestFailed(class OutstandingRequest *request);
@@ -174,13 +235,16 @@ class RpcChannel {
 
     void HandleChannelClose();
 
+    static void DecodeHeader(const uint8_t *data, unsigned int *version,
+                             unsigned int *size);
+
     static const char K_RPC_RECEIVED_TYPE_VAR[];
     static const char K_RPC_RECEIVED_VAR[];
     static const char K_RPC_SENT_ERROR_VAR[];
     static const char K_RPC_SENT_VAR[];
     static const char *K_RPC_VARIABLES[];
     static const char STREAMING_NO_RESPONSE[];
-    static const unsigned int INITIAL_BUFFER_SIZE = 1 << 11;  // 2k
+    static const unsigned int INITIAL_BUFFER_SIZE = 1 << 14;  // 16k
     static const unsigned int MAX_BUFFER_SIZE = 1 << 20;  // 1M
 };
 }  // namespace rpc
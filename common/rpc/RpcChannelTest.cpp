@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <google/protobuf/descriptor.h>
 #include <google/protobuf/stubs/common.h>
 #include <memory>
 #include <string>
@@ -48,27 +49,38 @@ using ola::rpc::TestService_Stub;
 using std::auto_ptr;
 using std::string;
 
+// The number of RPCs sent at once by testBatchedReads.
+const unsigned int BATCH_SIZE = 3;
+
 class RpcChannelTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(RpcChannelTest);
   CPPUNIT_TEST(testEcho);
+  CPPUNIT_TEST(testSerializedEcho);
   CPPUNIT_TEST(testFailedEcho);
   CPPUNIT_TEST(testStreamRequest);
+  CPPUNIT_TEST(testWriteCoalescing);
+  CPPUNIT_TEST(testBatchedReads);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void setUp();
   void tearDown();
   void testEcho();
+  void testSerializedEcho();
   void testFailedEcho();
   void testStreamRequest();
+  void testWriteCoalescing();
+  void testBatchedReads();
   void EchoComplete();
   void FailedEchoComplete();
+  void BatchedEchoComplete();
 
  private:
   RpcController m_controller;
   EchoRequest m_request;
   EchoReply m_reply;
   SelectServer m_ss;
+  unsigned int m_echo_count;
 
   auto_ptr<TestServiceImpl> m_service;
   auto_ptr<RpcChannel> m_channel;
@@ -80,6 +92,7 @@ class RpcChannelTest: public CppUnit::TestFixture {
 CPPUNIT_TEST_SUITE_REGISTRATION(RpcChannelTest);
 
 void RpcChannelTest::setUp() {
+  m_echo_count = 0;
   m_socket.reset(new LoopbackDescriptor());
   m_socket->Init();
 
@@ -104,6 +117,12 @@ void RpcChannelTest::FailedEchoComplete() {
   OLA_ASSERT_TRUE(m_controller.Failed());
 }
 
+void RpcChannelTest::BatchedEchoComplete() {
+  if (++m_echo_count == BATCH_SIZE) {
+    m_ss.Terminate();
+  }
+}
+
 /*
  * Check that we can call the echo method in the TestServiceImpl.
  */
@@ -118,6 +137,24 @@ void RpcChannelTest::testEcho() {
   m_ss.Run();
 }
 
+/*
+ * Check that we can call a method with a request that's already serialized.
+ */
+void RpcChannelTest::testSerializedEcho() {
+  m_request.set_data("foo");
+  m_request.set_session_ptr(0);
+  string serialized;
+  m_request.SerializeToString(&serialized);
+  m_channel->CallMethod(
+      TestService::descriptor()->FindMethodByName("Echo"),
+      &m_controller,
+      serialized,
+      &m_reply,
+      NewSingleCallback(this, &RpcChannelTest::EchoComplete));
+
+  m_ss.Run();
+}
+
 /*
  * Check that method that fail return correctly
  */
@@ -139,3 +176,43 @@ void RpcChannelTest::testStreamRequest() {
   m_stub->Stream(NULL, &m_request, NULL, NULL);
   m_ss.Run();
 }
+
+/*
+ * Check that RPCs still complete when writes are coalesced.
+ */
+void RpcChannelTest::testWriteCoalescing() {
+  m_channel->SetWriteCoalescing(&m_ss);
+  m_request.set_data("foo");
+  m_request.set_session_ptr(0);
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_stub->Echo(&m_controller,
+               &m_request,
+               &m_reply,
+               NewSingleCallback(this, &RpcChannelTest::EchoComplete));
+  m_ss.Run();
+}
+
+/*
+ * Check that all the messages are handled when many arrive in one read, and
+ * that messages larger than the initial read buffer are reassembled.
+ */
+void RpcChannelTest::testBatchedReads() {
+  RpcController controllers[BATCH_SIZE];
+  EchoReply replies[BATCH_SIZE];
+
+  m_channel->SetWriteCoalescing(&m_ss);
+  m_request.set_data(string(18000, 'x'));
+  m_request.set_session_ptr(0);
+  for (unsigned int i = 0; i < BATCH_SIZE; i++) {
+    m_stub->Echo(&controllers[i], &m_request, &replies[i],
+                 NewSingleCallback(this,
+                                   &RpcChannelTest::BatchedEchoComplete));
+  }
+  m_ss.Run();
+
+  OLA_ASSERT_EQ(BATCH_SIZE, m_echo_count);
+  for (unsigned int i = 0; i < BATCH_SIZE; i++) {
+    OLA_ASSERT_FALSE(controllers[i].Failed());
+    OLA_ASSERT_EQ(string(18000, 'x'), replies[i].data());
+  }
+}
@@ -24,6 +24,7 @@
 #include <ola/Logging.h>
 #include <ola/network/SocketAddress.h>
 #include <ola/network/TCPSocket.h>
+#include <ola/network/UnixDomainSocket.h>
 #include <ola/rpc/RpcSessionHandler.h>
 #include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcSession.h"
@@ -38,6 +39,8 @@ using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
 using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
+using ola::network::UnixDomainAcceptingSocket;
+using ola::network::UnixDomainSocket;
 
 namespace {
 void CleanupChannel(RpcChannel *channel,
@@ -81,6 +84,10 @@ RpcServer::~RpcServer() {
   if (m_accepting_socket.get() && m_accepting_socket->ValidReadDescriptor()) {
     m_ss->RemoveReadDescriptor(m_accepting_socket.get());
   }
+
+  if (m_unix_socket.get() && m_unix_socket->ValidReadDescriptor()) {
+    m_ss->RemoveReadDescriptor(m_unix_socket.get());
+  }
 }
 
 bool RpcServer::Init() {
@@ -115,6 +122,22 @@ bool RpcServer::Init() {
   }
 
   m_accepting_socket.reset(accepting_socket.release());
+
+  if (!m_options.unix_socket_path.empty()) {
+    auto_ptr<UnixDomainAcceptingSocket> unix_socket(
+        new UnixDomainAcceptingSocket(
+            ola::NewCallback(this, &RpcServer::NewUnixConnection)));
+    if (!unix_socket->Listen(m_options.unix_socket_path)) {
+      OLA_FATAL << "Could not listen on the RPC socket "
+                << m_options.unix_socket_path;
+      return false;
+    }
+    if (!m_ss->AddReadDescriptor(unix_socket.get())) {
+      OLA_WARN << "Failed to add RPC unix socket to SelectServer";
+      return false;
+    }
+    m_unix_socket.reset(unix_socket.release());
+  }
   return true;
 }
 
@@ -130,6 +153,9 @@ bool RpcServer::AddClient(ConnectedDescriptor *descriptor) {
   // ownership of the socket here.
   RpcChannel *channel = new RpcChannel(m_service, descriptor,
                                        m_options.export_map);
+  if (m_options.coalesce_writes) {
+    channel->SetWriteCoalescing(m_ss);
+  }
 
   if (m_session_handler) {
     m_session_handler->NewClient(channel->Session());
@@ -156,6 +182,19 @@ void RpcServer::NewTCPConnection(TCPSocket *socket) {
   AddClient(socket);
 }
 
+void RpcServer::NewUnixConnection(UnixDomainSocket *socket) {
+  if (!socket)
+    return;
+
+  uid_t uid;
+  gid_t gid;
+  if (socket->GetPeerCredentials(&uid, &gid)) {
+    OLA_DEBUG << "New RPC client on " << m_options.unix_socket_path
+              << ", uid " << uid << ", gid " << gid;
+  }
+  AddClient(socket);
+}
+
 void RpcServer::ChannelClosed(ConnectedDescriptor *descriptor,
                               RpcSession *session) {
   if (m_session_handler) {
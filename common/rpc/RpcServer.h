@@ -24,9 +24,11 @@
 #include <stdint.h>
 #include <ola/io/SelectServerInterface.h>
 #include <ola/network/TCPSocketFactory.h>
+#include <ola/network/UnixDomainSocket.h>
 
 #include <set>
 #include <memory>
+#include <string>
 
 namespace ola {
 
@@ -72,10 +74,23 @@ class RpcServer {
      */
     ola::network::TCPAcceptingSocket *listen_socket;
 
+    /**
+     * @brief Coalesce the messages sent to each client in the same loop
+     *   iteration into a single write.
+     */
+    bool coalesce_writes;
+
+    /**
+     * @brief If not empty, also listen for clients on a unix domain socket
+     *   at this path.
+     */
+    std::string unix_socket_path;
+
     Options()
       : listen_port(0),
         export_map(NULL),
-        listen_socket(NULL) {
+        listen_socket(NULL),
+        coalesce_writes(false) {
     }
   };
 
@@ -123,9 +138,11 @@ class RpcServer {
 
   ola::network::TCPSocketFactory m_tcp_socket_factory;
   std::auto_ptr<ola::network::TCPAcceptingSocket> m_accepting_socket;
+  std::auto_ptr<ola::network::UnixDomainAcceptingSocket> m_unix_socket;
   ClientDescriptors m_connected_sockets;
 
   void NewTCPConnection(ola::network::TCPSocket *socket);
+  void NewUnixConnection(ola::network::UnixDomainSocket *socket);
   void ChannelClosed(ola::io::ConnectedDescriptor *socket,
                      class RpcSession *session);
 
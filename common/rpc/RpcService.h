@@ -24,8 +24,10 @@
 #define COMMON_RPC_RPCSERVICE_H_
 
 #include <google/protobuf/service.h>
+#include <stdint.h>
 #include <string>
 #include "ola/Callback.h"
+#include "ola/base/Macro.h"
 
 namespace ola {
 namespace rpc {
@@ -53,6 +55,26 @@ class RpcService {
         const google::protobuf::MethodDescriptor *method) const = 0;
     virtual const google::protobuf::Message& GetResponsePrototype(
         const google::protobuf::MethodDescriptor *method) const = 0;
+
+    /**
+     * @brief Invoke a streaming method with the serialized request.
+     * @param method the streaming method.
+     * @param controller the RpcController for the call.
+     * @param data the serialized request, only valid during the call.
+     * @param size the size of the request.
+     * @returns true if the request was handled, false if it should be parsed
+     *   and passed to CallMethod().
+     *
+     * Services can override this for high rate requests, where parsing into
+     * a Message costs more than handling the request.
+     */
+    virtual bool CallStreamingMethod(
+        OLA_UNUSED const google::protobuf::MethodDescriptor *method,
+        OLA_UNUSED RpcController *controller,
+        OLA_UNUSED const uint8_t *data,
+        OLA_UNUSED unsigned int size) {
+      return false;
+    }
 };
 }  // namespace rpc
 }  // namespace ola
@@ -0,0 +1,96 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WireReader.cpp
+ * Walk the fields of a serialized protobuf without copying them.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stddef.h>
+#include "common/rpc/WireReader.h"
+
+namespace ola {
+namespace rpc {
+
+bool WireReader::Next(WireField *field) {
+  if (m_failed || m_data == m_end) {
+    return false;
+  }
+
+  uint64_t tag;
+  if (!ReadVarint(&tag)) {
+    return Fail();
+  }
+  field->number = static_cast<unsigned int>(tag >> 3);
+  if (field->number == 0) {
+    return Fail();
+  }
+  field->value = 0;
+  field->data = NULL;
+  field->size = 0;
+
+  unsigned int size;
+  switch (tag & 0x7) {
+    case WireField::VARINT:
+      field->type = WireField::VARINT;
+      return ReadVarint(&field->value) || Fail();
+    case WireField::FIXED64:
+      field->type = WireField::FIXED64;
+      size = 8;
+      break;
+    case WireField::LENGTH_DELIMITED:
+      field->type = WireField::LENGTH_DELIMITED;
+      if (!ReadVarint(&field->value) ||
+          field->value > static_cast<uint64_t>(m_end - m_data)) {
+        return Fail();
+      }
+      size = static_cast<unsigned int>(field->value);
+      field->value = 0;
+      break;
+    case WireField::FIXED32:
+      field->type = WireField::FIXED32;
+      size = 4;
+      break;
+    default:
+      return Fail();
+  }
+
+  if (size > static_cast<unsigned int>(m_end - m_data)) {
+    return Fail();
+  }
+  field->data = m_data;
+  field->size = size;
+  m_data += size;
+  return true;
+}
+
+bool WireReader::ReadVarint(uint64_t *value) {
+  *value = 0;
+  for (unsigned int shift = 0; shift < 64 && m_data != m_end; shift += 7) {
+    const uint8_t byte = *m_data++;
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool WireReader::Fail() {
+  m_failed = true;
+  return false;
+}
+}  // namespace rpc
+}  // namespace ola
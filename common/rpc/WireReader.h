@@ -0,0 +1,88 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WireReader.h
+ * Walk the fields of a serialized protobuf without copying them.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_RPC_WIREREADER_H_
+#define COMMON_RPC_WIREREADER_H_
+
+#include <stdint.h>
+
+namespace ola {
+namespace rpc {
+
+/**
+ * @brief A field read by WireReader.
+ */
+struct WireField {
+  enum WireType {
+    VARINT = 0,
+    FIXED64 = 1,
+    LENGTH_DELIMITED = 2,
+    FIXED32 = 5,
+  };
+
+  unsigned int number;
+  WireType type;
+  // Set for VARINT fields.
+  uint64_t value;
+  // Set for the other types, this points into the serialized data.
+  const uint8_t *data;
+  unsigned int size;
+};
+
+/**
+ * @brief Reads the fields of a serialized protobuf message in order.
+ *
+ * This is for the few places where parsing into a Message costs more than
+ * the data it carries. Length delimited fields point into the original data,
+ * so nothing is copied. Groups aren't supported and are treated as invalid
+ * data.
+ */
+class WireReader {
+ public:
+  WireReader(const uint8_t *data, unsigned int size)
+      : m_data(data),
+        m_end(data + size),
+        m_failed(false) {
+  }
+
+  /**
+   * @brief Read the next field.
+   * @param field the WireField to fill in.
+   * @returns true if a field was read, false at the end of the data or if
+   *   the data is invalid, see Failed().
+   */
+  bool Next(WireField *field);
+
+  /**
+   * @brief Check if the data was invalid.
+   */
+  bool Failed() const { return m_failed; }
+
+ private:
+  const uint8_t *m_data;
+  const uint8_t *m_end;
+  bool m_failed;
+
+  bool ReadVarint(uint64_t *value);
+  bool Fail();
+};
+}  // namespace rpc
+}  // namespace ola
+#endif  // COMMON_RPC_WIREREADER_H_
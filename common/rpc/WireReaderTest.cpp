@@ -0,0 +1,146 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WireReaderTest.cpp
+ * Test fixture for the WireReader class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "common/rpc/Rpc.pb.h"
+#include "common/rpc/WireReader.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::rpc::WireField;
+using ola::rpc::WireReader;
+using std::string;
+
+class WireReaderTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(WireReaderTest);
+  CPPUNIT_TEST(testRead);
+  CPPUNIT_TEST(testInvalid);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testRead();
+    void testInvalid();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WireReaderTest);
+
+
+/*
+ * Check we can read the fields of a serialized message.
+ */
+void WireReaderTest::testRead() {
+  ola::rpc::RpcMessage message;
+  message.set_type(ola::rpc::STREAM_REQUEST);
+  message.set_id(300);
+  message.set_name("Stream");
+  message.set_buffer(string("\x00\x01\xff", 3));
+  const string serialized = message.SerializeAsString();
+
+  WireReader reader(reinterpret_cast<const uint8_t*>(serialized.data()),
+                    serialized.size());
+  WireField field;
+  OLA_ASSERT_TRUE(reader.Next(&field));
+  OLA_ASSERT_EQ(1u, field.number);
+  OLA_ASSERT_EQ(WireField::VARINT, field.type);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(ola::rpc::STREAM_REQUEST), field.value);
+
+  OLA_ASSERT_TRUE(reader.Next(&field));
+  OLA_ASSERT_EQ(2u, field.number);
+  OLA_ASSERT_EQ(WireField::VARINT, field.type);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(300), field.value);
+
+  OLA_ASSERT_TRUE(reader.Next(&field));
+  OLA_ASSERT_EQ(3u, field.number);
+  OLA_ASSERT_EQ(WireField::LENGTH_DELIMITED, field.type);
+  OLA_ASSERT_EQ(string("Stream"),
+                string(reinterpret_cast<const char*>(field.data),
+                       field.size));
+
+  OLA_ASSERT_TRUE(reader.Next(&field));
+  OLA_ASSERT_EQ(4u, field.number);
+  OLA_ASSERT_EQ(WireField::LENGTH_DELIMITED, field.type);
+  OLA_ASSERT_EQ(message.buffer(),
+                string(reinterpret_cast<const char*>(field.data),
+                       field.size));
+  // The data points into the serialized message.
+  OLA_ASSERT_TRUE(
+      field.data > reinterpret_cast<const uint8_t*>(serialized.data()));
+
+  OLA_ASSERT_FALSE(reader.Next(&field));
+  OLA_ASSERT_FALSE(reader.Failed());
+
+  // Fixed width types.
+  const uint8_t fixed[] = {
+    0x0d, 1, 2, 3, 4,  // field 1, fixed32
+    0x11, 1, 2, 3, 4, 5, 6, 7, 8,  // field 2, fixed64
+  };
+  WireReader fixed_reader(fixed, sizeof(fixed));
+  OLA_ASSERT_TRUE(fixed_reader.Next(&field));
+  OLA_ASSERT_EQ(1u, field.number);
+  OLA_ASSERT_EQ(WireField::FIXED32, field.type);
+  OLA_ASSERT_EQ(4u, field.size);
+  OLA_ASSERT_TRUE(fixed_reader.Next(&field));
+  OLA_ASSERT_EQ(2u, field.number);
+  OLA_ASSERT_EQ(WireField::FIXED64, field.type);
+  OLA_ASSERT_EQ(8u, field.size);
+  OLA_ASSERT_FALSE(fixed_reader.Next(&field));
+  OLA_ASSERT_FALSE(fixed_reader.Failed());
+}
+
+
+/*
+ * Check invalid data is detected.
+ */
+void WireReaderTest::testInvalid() {
+  WireField field;
+
+  const uint8_t truncated_varint[] = {0x08, 0x80};
+  WireReader reader1(truncated_varint, sizeof(truncated_varint));
+  OLA_ASSERT_FALSE(reader1.Next(&field));
+  OLA_ASSERT_TRUE(reader1.Failed());
+
+  const uint8_t truncated_string[] = {0x12, 0x05, 'a', 'b'};
+  WireReader reader2(truncated_string, sizeof(truncated_string));
+  OLA_ASSERT_FALSE(reader2.Next(&field));
+  OLA_ASSERT_TRUE(reader2.Failed());
+
+  const uint8_t truncated_fixed[] = {0x0d, 1, 2};
+  WireReader reader3(truncated_fixed, sizeof(truncated_fixed));
+  OLA_ASSERT_FALSE(reader3.Next(&field));
+  OLA_ASSERT_TRUE(reader3.Failed());
+
+  // Field 0 isn't valid, nor are groups.
+  const uint8_t field_zero[] = {0x00, 0x01};
+  WireReader reader4(field_zero, sizeof(field_zero));
+  OLA_ASSERT_FALSE(reader4.Next(&field));
+  OLA_ASSERT_TRUE(reader4.Failed());
+
+  const uint8_t group[] = {0x0b, 0x0c};
+  WireReader reader5(group, sizeof(group));
+  OLA_ASSERT_FALSE(reader5.Next(&field));
+  OLA_ASSERT_TRUE(reader5.Failed());
+
+  // Once failed, the reader stays failed.
+  OLA_ASSERT_FALSE(reader5.Next(&field));
+  OLA_ASSERT_TRUE(reader5.Failed());
+}
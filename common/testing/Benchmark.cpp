@@ -0,0 +1,150 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Benchmark.cpp
+ * A minimal harness for the microbenchmarks run by `make bench`.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/testing/Benchmark.h"
+
+// Dynamic exception specifications are deprecated from C++11.
+#if __cplusplus >= 201103L
+#define BENCHMARK_THROWS_BAD_ALLOC
+#define BENCHMARK_NO_THROW noexcept
+#else
+#define BENCHMARK_THROWS_BAD_ALLOC throw(std::bad_alloc)
+#define BENCHMARK_NO_THROW throw()
+#endif
+
+namespace {
+uint64_t allocation_count = 0;
+
+void *CountedAllocate(size_t size) {
+  allocation_count++;
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+}  // namespace
+
+void *operator new(size_t size) BENCHMARK_THROWS_BAD_ALLOC {
+  return CountedAllocate(size);
+}
+
+void *operator new[](size_t size) BENCHMARK_THROWS_BAD_ALLOC {
+  return CountedAllocate(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t&) BENCHMARK_NO_THROW {
+  allocation_count++;
+  return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t&) BENCHMARK_NO_THROW {
+  allocation_count++;
+  return malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) BENCHMARK_NO_THROW {
+  free(ptr);
+}
+
+void operator delete[](void *ptr) BENCHMARK_NO_THROW {
+  free(ptr);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void *ptr, size_t) BENCHMARK_NO_THROW {
+  free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) BENCHMARK_NO_THROW {
+  free(ptr);
+}
+#endif  // __cpp_sized_deallocation
+
+void operator delete(void *ptr, const std::nothrow_t&) BENCHMARK_NO_THROW {
+  free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t&) BENCHMARK_NO_THROW {
+  free(ptr);
+}
+
+namespace ola {
+namespace testing {
+
+using std::string;
+
+Benchmark::Benchmark(const string &suite, std::ostream *output)
+    : m_suite(suite),
+      m_output(output) {
+}
+
+
+void Benchmark::Run(const string &name, unsigned int param,
+                    BenchmarkFunction *function) {
+  std::auto_ptr<BenchmarkFunction> function_ptr(function);
+
+  // Warm up the caches & any lazy initialization.
+  function->Run(1);
+
+  unsigned int iterations = 1;
+  TimeInterval elapsed;
+  uint64_t allocations;
+  while (true) {
+    TimeStamp start, end;
+    uint64_t start_allocations = allocation_count;
+    m_clock.CurrentTime(&start);
+    function->Run(iterations);
+    m_clock.CurrentTime(&end);
+    allocations = allocation_count - start_allocations;
+    elapsed = end - start;
+    if (elapsed.InMilliSeconds() >= MIN_DURATION_MS ||
+        iterations >= MAX_ITERATIONS) {
+      break;
+    }
+    iterations *= 2;
+  }
+
+  double ns_per_op = elapsed.AsInt() * 1000.0 / iterations;
+  double ops_per_sec = ns_per_op > 0 ? 1e9 / ns_per_op : 0;
+  double allocs_per_op = static_cast<double>(allocations) / iterations;
+  *m_output << "{\"suite\": \"" << m_suite << "\", \"benchmark\": \"" << name
+            << "\", \"param\": " << param << ", \"iterations\": "
+            << iterations << ", \"ns_per_op\": " << std::fixed
+            << std::setprecision(3) << ns_per_op << ", \"ops_per_sec\": "
+            << std::setprecision(0) << ops_per_sec << ", \"allocs_per_op\": "
+            << std::setprecision(3) << allocs_per_op << "}" << std::endl;
+}
+
+
+uint64_t Benchmark::AllocationCount() {
+  return allocation_count;
+}
+}  // namespace testing
+}  // namespace ola
@@ -1,5 +1,10 @@
 # LIBRARIES
 ##################################################
+noinst_LTLIBRARIES += common/testing/libolabenchmark.la
+common_testing_libolabenchmark_la_SOURCES = \
+    common/testing/Benchmark.cpp \
+    common/testing/UDPCapture.cpp
+
 if BUILD_TESTS
 noinst_LTLIBRARIES += common/testing/libolatesting.la \
                       common/testing/libtestmain.la
@@ -8,3 +13,14 @@ common_testing_libolatesting_la_SOURCES = \
     common/testing/TestUtils.cpp
 common_testing_libtestmain_la_SOURCES = common/testing/GenericTester.cpp
 endif
+
+# BENCHMARKS
+##################################################
+if BUILD_TESTS
+bench_programs += common/testing/MockUDPSocketBenchmark
+
+common_testing_MockUDPSocketBenchmark_SOURCES = \
+    common/testing/MockUDPSocketBenchmark.cpp
+common_testing_MockUDPSocketBenchmark_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_testing_MockUDPSocketBenchmark_LDADD = $(COMMON_SOCKET_BENCHMARK_LIBS)
+endif
@@ -52,7 +52,9 @@ MockUDPSocket::MockUDPSocket()
       m_broadcast_set(false),
       m_port(0),
       m_tos(0),
-      m_discard_mode(false) {
+      m_max_pacing_rate(0),
+      m_discard_mode(false),
+      m_send_batch_depth(0) {
 }
 
 
@@ -206,6 +208,26 @@ bool MockUDPSocket::RecvFrom(
 }
 
 
+bool MockUDPSocket::RecvBatch(ola::network::DatagramBatch *batch) {
+  batch->Clear();
+  OLA_ASSERT_FALSE(m_received_data.empty());
+  while (!m_received_data.empty() && batch->Size() < batch->Capacity()) {
+    ssize_t data_read = batch->DatagramSize();
+    IPV4SocketAddress source;
+    RecvFrom(batch->Data(batch->Size()), &data_read, &source);
+    batch->Append(static_cast<unsigned int>(data_read), source);
+  }
+  return true;
+}
+
+
+bool MockUDPSocket::EndSendBatch() {
+  OLA_ASSERT_TRUE(m_send_batch_depth > 0);
+  m_send_batch_depth--;
+  return true;
+}
+
+
 bool MockUDPSocket::EnableBroadcast() {
   m_broadcast_set = true;
   return true;
@@ -239,6 +261,21 @@ bool MockUDPSocket::SetTos(uint8_t tos) {
 }
 
 
+bool MockUDPSocket::SetMaxPacingRate(uint32_t bytes_per_second) {
+  m_max_pacing_rate = bytes_per_second;
+  return true;
+}
+
+
+/*
+ * The mock doesn't have a kernel queue to drop from.
+ */
+bool MockUDPSocket::EnableReceiveStats(
+    const ola::network::UDPReceiveOptions&) {
+  return false;
+}
+
+
 void MockUDPSocket::AddExpectedData(const uint8_t *data,
                                     unsigned int size,
                                     const IPV4Address &ip,
@@ -303,6 +340,7 @@ void MockUDPSocket::Verify() {
     std::ostringstream msg;
     msg << m_expected_calls.size() << " packets remain on the MockUDPSocket";
     OLA_ASSERT_TRUE_MSG(m_expected_calls.empty(), msg.str());
+    OLA_ASSERT_EQ(0u, m_send_batch_depth);
   }
 }
 
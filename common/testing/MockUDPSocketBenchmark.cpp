@@ -0,0 +1,103 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MockUDPSocketBenchmark.cpp
+ * The cost of injecting packets into a MockUDPSocket. This is the baseline
+ * for the protocol node benchmarks, which inject packets the same way.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iostream>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/testing/Benchmark.h"
+#include "ola/testing/MockUDPSocket.h"
+
+using ola::NewCallback;
+using ola::network::DatagramBatch;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::testing::Benchmark;
+using ola::testing::MockUDPSocket;
+
+namespace {
+
+const unsigned int PACKET_SIZE = 530;
+
+class MockUDPSocketBenchmark {
+ public:
+  MockUDPSocketBenchmark()
+      : m_batch(16, PACKET_SIZE) {
+    for (unsigned int i = 0; i < PACKET_SIZE; i++) {
+      m_packet[i] = static_cast<uint8_t>(i);
+    }
+    ola::network::IPV4Address::FromString("10.0.0.10", &m_peer);
+  }
+
+  void InjectRecvFrom(unsigned int iterations) {
+    m_socket.SetOnData(
+        NewCallback(this, &MockUDPSocketBenchmark::RecvFrom));
+    Inject(iterations);
+  }
+
+  void InjectRecvBatch(unsigned int iterations) {
+    m_socket.SetOnData(
+        NewCallback(this, &MockUDPSocketBenchmark::RecvBatch));
+    Inject(iterations);
+  }
+
+ private:
+  MockUDPSocket m_socket;
+  DatagramBatch m_batch;
+  uint8_t m_packet[PACKET_SIZE];
+  uint8_t m_buffer[PACKET_SIZE];
+  IPV4Address m_peer;
+
+  void Inject(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      m_socket.InjectData(m_packet, PACKET_SIZE, m_peer, 1234);
+    }
+  }
+
+  void RecvFrom() {
+    ssize_t size = sizeof(m_buffer);
+    IPV4SocketAddress source;
+    m_socket.RecvFrom(m_buffer, &size, &source);
+  }
+
+  void RecvBatch() {
+    m_socket.RecvBatch(&m_batch);
+  }
+};
+}  // namespace
+
+
+int main() {
+  ola::InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_STDERR);
+
+  MockUDPSocketBenchmark fixture;
+  Benchmark benchmark("MockUDPSocket", &std::cout);
+  benchmark.Run("RecvFrom", PACKET_SIZE,
+                NewCallback(&fixture, &MockUDPSocketBenchmark::InjectRecvFrom));
+  benchmark.Run("RecvBatch", PACKET_SIZE,
+                NewCallback(&fixture,
+                            &MockUDPSocketBenchmark::InjectRecvBatch));
+  return 0;
+}
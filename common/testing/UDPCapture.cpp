@@ -0,0 +1,188 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPCapture.cpp
+ * Reads UDP datagrams from a pcap file so they can be replayed.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/testing/UDPCapture.h"
+
+namespace ola {
+namespace testing {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+enum {
+  PCAP_HEADER_SIZE = 24,
+  PCAP_RECORD_HEADER_SIZE = 16,
+};
+
+enum {
+  LINKTYPE_ETHERNET = 1,
+  LINKTYPE_RAW = 101,
+  LINKTYPE_LINUX_SLL = 113,
+};
+
+const uint32_t PCAP_MAGIC = 0xa1b2c3d4;
+const uint32_t PCAP_NANOSECOND_MAGIC = 0xa1b23c4d;
+const uint16_t ETHERTYPE_IPV4 = 0x0800;
+const uint16_t ETHERTYPE_VLAN = 0x8100;
+const uint8_t IP_PROTOCOL_UDP = 17;
+
+uint16_t ReadBigEndian16(const uint8_t *data) {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+uint32_t ReadUInt32(const uint8_t *data, bool swap) {
+  if (swap) {
+    return (static_cast<uint32_t>(data[3]) << 24) |
+           (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[1]) << 8) | data[0];
+  }
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+/*
+ * Find the start of the IPv4 header in a frame, returns false if the frame
+ * isn't IPv4.
+ */
+bool FindIPHeader(uint32_t link_type, const string &frame,
+                  unsigned int *offset) {
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(frame.data());
+  uint16_t ether_type;
+  switch (link_type) {
+    case LINKTYPE_ETHERNET:
+      if (frame.size() < 14) {
+        return false;
+      }
+      *offset = 14;
+      ether_type = ReadBigEndian16(data + 12);
+      if (ether_type == ETHERTYPE_VLAN && frame.size() >= 18) {
+        ether_type = ReadBigEndian16(data + 16);
+        *offset = 18;
+      }
+      return ether_type == ETHERTYPE_IPV4;
+    case LINKTYPE_LINUX_SLL:
+      if (frame.size() < 16) {
+        return false;
+      }
+      *offset = 16;
+      return ReadBigEndian16(data + 14) == ETHERTYPE_IPV4;
+    case LINKTYPE_RAW:
+      *offset = 0;
+      return !frame.empty() && (data[0] >> 4) == 4;
+    default:
+      return false;
+  }
+}
+
+/*
+ * Extract the payload of a UDP datagram sent to port, returns false if the
+ * frame doesn't contain one.
+ */
+bool ExtractPayload(uint32_t link_type, const string &frame, uint16_t port,
+                    string *payload) {
+  unsigned int offset;
+  if (!FindIPHeader(link_type, frame, &offset) ||
+      frame.size() < offset + 20) {
+    return false;
+  }
+
+  const uint8_t *ip = reinterpret_cast<const uint8_t*>(frame.data()) + offset;
+  unsigned int header_length = (ip[0] & 0x0f) * 4;
+  unsigned int total_length = ReadBigEndian16(ip + 2);
+  // Skip fragments, other than the first with the more fragments bit clear.
+  uint16_t fragment = ReadBigEndian16(ip + 6);
+  if (ip[9] != IP_PROTOCOL_UDP || (fragment & 0x3fff) || header_length < 20 ||
+      total_length < header_length + 8 ||
+      frame.size() < offset + total_length) {
+    return false;
+  }
+
+  const uint8_t *udp = ip + header_length;
+  unsigned int udp_length = ReadBigEndian16(udp + 4);
+  if (ReadBigEndian16(udp + 2) != port || udp_length < 8 ||
+      udp_length > total_length - header_length) {
+    return false;
+  }
+  payload->assign(reinterpret_cast<const char*>(udp + 8), udp_length - 8);
+  return true;
+}
+}  // namespace
+
+
+bool LoadUDPCapture(const string &filename, uint16_t port,
+                    vector<string> *payloads) {
+  std::ifstream input(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!input.is_open()) {
+    OLA_WARN << "Failed to open " << filename;
+    return false;
+  }
+
+  uint8_t header[PCAP_HEADER_SIZE];
+  if (!input.read(reinterpret_cast<char*>(header), sizeof(header))) {
+    OLA_WARN << filename << " is too short to be a pcap file";
+    return false;
+  }
+
+  bool swap = false;
+  uint32_t magic = ReadUInt32(header, false);
+  if (magic != PCAP_MAGIC && magic != PCAP_NANOSECOND_MAGIC) {
+    swap = true;
+    magic = ReadUInt32(header, true);
+    if (magic != PCAP_MAGIC && magic != PCAP_NANOSECOND_MAGIC) {
+      OLA_WARN << filename << " isn't a pcap file, pcapng isn't supported";
+      return false;
+    }
+  }
+
+  uint32_t link_type = ReadUInt32(header + 20, swap);
+  if (link_type != LINKTYPE_ETHERNET && link_type != LINKTYPE_RAW &&
+      link_type != LINKTYPE_LINUX_SLL) {
+    OLA_WARN << "Unsupported link type " << link_type << " in " << filename;
+    return false;
+  }
+
+  uint8_t record_header[PCAP_RECORD_HEADER_SIZE];
+  string frame, payload;
+  while (input.read(reinterpret_cast<char*>(record_header),
+                    sizeof(record_header))) {
+    uint32_t captured_length = ReadUInt32(record_header + 8, swap);
+    frame.resize(captured_length);
+    if (captured_length && !input.read(&frame[0], captured_length)) {
+      OLA_WARN << "Truncated record in " << filename;
+      break;
+    }
+    if (ExtractPayload(link_type, frame, port, &payload)) {
+      payloads->push_back(payload);
+    }
+  }
+  return true;
+}
+}  // namespace testing
+}  // namespace ola
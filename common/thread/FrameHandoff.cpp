@@ -0,0 +1,88 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameHandoff.cpp
+ * Passes DMX frames to a thread that writes them to a device.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/thread/FrameHandoff.h"
+
+#include <stdint.h>
+#include <algorithm>
+
+#include "ola/Clock.h"
+
+namespace ola {
+namespace thread {
+
+FrameHandoff::FrameHandoff()
+    : m_pending(&m_buffers[0]),
+      m_current(&m_buffers[1]),
+      m_changed(false),
+      m_term(false) {
+}
+
+
+void FrameHandoff::SetFrame(const DmxBuffer &buffer) {
+  {
+    MutexLocker locker(&m_mutex);
+    // Set() copies the data, rather than sharing it between threads.
+    m_pending->Set(buffer);
+    m_changed = true;
+  }
+  m_condition.Signal();
+}
+
+
+void FrameHandoff::Terminate() {
+  {
+    MutexLocker locker(&m_mutex);
+    m_term = true;
+  }
+  m_condition.Signal();
+}
+
+
+bool FrameHandoff::WaitForFrame(unsigned int timeout_us,
+                                const DmxBuffer **frame,
+                                bool *changed) {
+  MutexLocker locker(&m_mutex);
+  if (timeout_us && !m_changed && !m_term) {
+    Clock clock;
+    TimeStamp wake_up;
+    clock.CurrentTime(&wake_up);
+    wake_up += TimeInterval(static_cast<int64_t>(timeout_us));
+    while (!m_changed && !m_term) {
+      if (!m_condition.TimedWait(&m_mutex, wake_up)) {
+        break;
+      }
+    }
+  }
+
+  if (m_term) {
+    return false;
+  }
+
+  *changed = m_changed;
+  if (m_changed) {
+    std::swap(m_pending, m_current);
+    m_changed = false;
+  }
+  *frame = m_current;
+  return true;
+}
+}  // namespace thread
+}  // namespace ola
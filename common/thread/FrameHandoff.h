@@ -0,0 +1,84 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameHandoff.h
+ * Passes DMX frames to a thread that writes them to a device.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_THREAD_FRAMEHANDOFF_H_
+#define COMMON_THREAD_FRAMEHANDOFF_H_
+
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief Hands frames from the main thread to a device writer thread.
+ *
+ * The frame is double buffered. SetFrame() copies into the pending buffer
+ * and the writer takes it by swapping pointers, so the writer never copies
+ * a frame while holding the lock, and the main thread only waits for a
+ * pointer swap.
+ *
+ * The writer can block until a new frame arrives, which lets devices that
+ * hold their last values sit idle rather than resending the same frame.
+ */
+class FrameHandoff {
+ public:
+  FrameHandoff();
+
+  /**
+   * @brief Set the next frame to write, this can be called from any thread.
+   */
+  void SetFrame(const DmxBuffer &buffer);
+
+  /**
+   * @brief Wake the writer and make WaitForFrame() return false.
+   */
+  void Terminate();
+
+  /**
+   * @brief Get the frame to write next.
+   * @param timeout_us if non-0, wait up to this long for a new frame to
+   *   arrive. If 0, return the latest frame without waiting.
+   * @param[out] frame the frame to write. This is only valid until the next
+   *   call to WaitForFrame().
+   * @param[out] changed set to true if this is a new frame, false if it's the
+   *   same frame as last time.
+   * @returns false if Terminate() has been called.
+   *
+   * This must only be called from the writer thread.
+   */
+  bool WaitForFrame(unsigned int timeout_us, const DmxBuffer **frame,
+                    bool *changed);
+
+ private:
+  Mutex m_mutex;
+  ConditionVariable m_condition;
+  DmxBuffer m_buffers[2];
+  DmxBuffer *m_pending;
+  DmxBuffer *m_current;
+  bool m_changed;
+  bool m_term;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameHandoff);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // COMMON_THREAD_FRAMEHANDOFF_H_
@@ -0,0 +1,142 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameHandoffTest.cpp
+ * Test fixture for the FrameHandoff class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+
+#include "common/thread/FrameHandoff.h"
+#include "common/thread/FrameTimer.h"
+#include "ola/DmxBuffer.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Thread.h"
+
+using ola::DmxBuffer;
+using ola::thread::FrameHandoff;
+using ola::thread::FrameTimer;
+
+namespace {
+
+/*
+ * Sets a frame after a short delay.
+ */
+class DelayedFrameThread: public ola::thread::Thread {
+ public:
+  DelayedFrameThread(FrameHandoff *handoff, const DmxBuffer &frame)
+      : Thread(),
+        m_handoff(handoff),
+        m_frame(frame) {
+  }
+
+  void *Run() {
+    usleep(10000);
+    m_handoff->SetFrame(m_frame);
+    return NULL;
+  }
+
+ private:
+  FrameHandoff *m_handoff;
+  DmxBuffer m_frame;
+};
+}  // namespace
+
+
+class FrameHandoffTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FrameHandoffTest);
+  CPPUNIT_TEST(testHandoff);
+  CPPUNIT_TEST(testTimeout);
+  CPPUNIT_TEST(testWakeUp);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testHandoff();
+  void testTimeout();
+  void testWakeUp();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameHandoffTest);
+
+
+/*
+ * Check that the latest frame is returned, and flagged as changed once.
+ */
+void FrameHandoffTest::testHandoff() {
+  FrameHandoff handoff;
+  const DmxBuffer *frame = NULL;
+  bool changed = true;
+  OLA_ASSERT_TRUE(handoff.WaitForFrame(0, &frame, &changed));
+  OLA_ASSERT_FALSE(changed);
+  OLA_ASSERT_EQ(0u, frame->Size());
+
+  const uint8_t data1[] = {1, 2, 3};
+  const uint8_t data2[] = {4, 5};
+  handoff.SetFrame(DmxBuffer(data1, sizeof(data1)));
+  handoff.SetFrame(DmxBuffer(data2, sizeof(data2)));
+  OLA_ASSERT_TRUE(handoff.WaitForFrame(0, &frame, &changed));
+  OLA_ASSERT_TRUE(changed);
+  OLA_ASSERT_EQ(DmxBuffer(data2, sizeof(data2)), *frame);
+
+  OLA_ASSERT_TRUE(handoff.WaitForFrame(0, &frame, &changed));
+  OLA_ASSERT_FALSE(changed);
+  OLA_ASSERT_EQ(DmxBuffer(data2, sizeof(data2)), *frame);
+
+  handoff.Terminate();
+  OLA_ASSERT_FALSE(handoff.WaitForFrame(0, &frame, &changed));
+}
+
+
+/*
+ * Check that waiting without a new frame returns the last one.
+ */
+void FrameHandoffTest::testTimeout() {
+  FrameHandoff handoff;
+  const uint8_t data[] = {1, 2, 3};
+  handoff.SetFrame(DmxBuffer(data, sizeof(data)));
+
+  const DmxBuffer *frame = NULL;
+  bool changed = false;
+  OLA_ASSERT_TRUE(handoff.WaitForFrame(10000, &frame, &changed));
+  OLA_ASSERT_TRUE(changed);
+
+  const int64_t start = FrameTimer::CurrentTime();
+  OLA_ASSERT_TRUE(handoff.WaitForFrame(10000, &frame, &changed));
+  OLA_ASSERT_TRUE(FrameTimer::CurrentTime() - start >= 9000);
+  OLA_ASSERT_FALSE(changed);
+  OLA_ASSERT_EQ(DmxBuffer(data, sizeof(data)), *frame);
+}
+
+
+/*
+ * Check that a new frame wakes up the writer.
+ */
+void FrameHandoffTest::testWakeUp() {
+  FrameHandoff handoff;
+  const uint8_t data[] = {1, 2, 3};
+  DelayedFrameThread thread(&handoff, DmxBuffer(data, sizeof(data)));
+  OLA_ASSERT_TRUE(thread.Start());
+
+  const DmxBuffer *frame = NULL;
+  bool changed = false;
+  const int64_t start = FrameTimer::CurrentTime();
+  OLA_ASSERT_TRUE(handoff.WaitForFrame(5000000, &frame, &changed));
+  OLA_ASSERT_TRUE(FrameTimer::CurrentTime() - start < 1000000);
+  OLA_ASSERT_TRUE(changed);
+  OLA_ASSERT_EQ(DmxBuffer(data, sizeof(data)), *frame);
+  OLA_ASSERT_TRUE(thread.Join());
+}
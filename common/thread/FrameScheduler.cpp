@@ -0,0 +1,217 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameScheduler.cpp
+ * Generates the DMX frames for many outputs from a single thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/thread/FrameScheduler.h"
+
+#include <map>
+
+#include "ola/thread/ThreadSettings.h"
+
+namespace ola {
+namespace thread {
+
+FrameOutput::FrameOutput() {
+  m_stats.frames = 0;
+  m_stats.late_frames = 0;
+  m_stats.jitter_us = 0;
+  m_stats.max_jitter_us = 0;
+}
+
+
+void FrameOutput::SetFrame(const DmxBuffer &buffer) {
+  MutexLocker locker(&m_mutex);
+  m_next_frame = buffer;
+}
+
+
+void FrameOutput::GetStats(FrameTimerStats *stats) const {
+  MutexLocker locker(&m_mutex);
+  *stats = m_stats;
+}
+
+
+/*
+ * Copy the latest frame. DmxBuffer is copy-on-write, so this doesn't copy
+ * the data.
+ */
+void FrameOutput::TakeFrame(DmxBuffer *frame) {
+  MutexLocker locker(&m_mutex);
+  *frame = m_next_frame;
+}
+
+
+void FrameOutput::RecordWakeUp(unsigned int jitter) {
+  MutexLocker locker(&m_mutex);
+  m_stats.jitter_us = (m_stats.jitter_us * 7 + jitter) / 8;
+  if (jitter > m_stats.max_jitter_us) {
+    m_stats.max_jitter_us = jitter;
+  }
+}
+
+
+void FrameOutput::RecordFrame(bool late) {
+  MutexLocker locker(&m_mutex);
+  m_stats.frames++;
+  if (late) {
+    m_stats.late_frames++;
+  }
+}
+
+
+FrameScheduler::FrameScheduler()
+    : Thread(Thread::Options("frame-scheduler", THREAD_CLASS_OUTPUT)),
+      m_term(false) {
+}
+
+
+FrameScheduler::~FrameScheduler() {
+  Stop();
+}
+
+
+bool FrameScheduler::Stop() {
+  {
+    MutexLocker locker(&m_mutex);
+    m_term = true;
+  }
+  m_condition.Signal();
+  return Join();
+}
+
+
+void FrameScheduler::AddOutput(FrameOutput *output) {
+  {
+    MutexLocker locker(&m_mutex);
+    const int64_t first_frame = FrameTimer::CurrentTime() +
+        m_outputs.size() * STAGGER_US;
+    OutputSchedule &schedule = m_outputs[output];
+    schedule.step = BREAK_STEP;
+    schedule.deadline = first_frame;
+    schedule.frame_deadline = first_frame;
+    schedule.frame_start = first_frame;
+  }
+  m_condition.Signal();
+}
+
+
+void FrameScheduler::RemoveOutput(FrameOutput *output) {
+  MutexLocker locker(&m_mutex);
+  m_outputs.erase(output);
+}
+
+
+void *FrameScheduler::Run() {
+  // The frame timing needs real-time scheduling, but if ola-threads.conf sets
+  // the scheduling for output threads, that's already been applied.
+  ThreadSettings settings;
+  if (!GetThreadClassSettings(THREAD_CLASS_OUTPUT, &settings) ||
+      !settings.set_scheduling) {
+    FrameTimer::UseRealTimeScheduling();
+  }
+
+  m_mutex.Lock();
+  while (!m_term) {
+    if (m_outputs.empty()) {
+      m_condition.Wait(&m_mutex);
+      continue;
+    }
+
+    OutputMap::iterator next = m_outputs.begin();
+    OutputMap::iterator iter = next;
+    for (++iter; iter != m_outputs.end(); ++iter) {
+      if (iter->second.deadline < next->second.deadline) {
+        next = iter;
+      }
+    }
+    FrameOutput *output = next->first;
+    const int64_t deadline = next->second.deadline;
+
+    // Outputs added while we sleep wait for this deadline, which is at most
+    // one frame away.
+    m_mutex.Unlock();
+    FrameTimer::SleepUntilTime(deadline);
+    m_mutex.Lock();
+
+    // The output may have been removed, or re-added, while we were asleep.
+    iter = m_outputs.find(output);
+    if (!m_term && iter != m_outputs.end() &&
+        iter->second.deadline == deadline) {
+      RunStep(output, &iter->second);
+    }
+  }
+  m_mutex.Unlock();
+  return NULL;
+}
+
+
+/*
+ * Run the next step of the frame for an output, and schedule the one after.
+ */
+void FrameScheduler::RunStep(FrameOutput *output, OutputSchedule *schedule) {
+  const int64_t now = FrameTimer::CurrentTime();
+  output->RecordWakeUp(static_cast<unsigned int>(
+      now > schedule->deadline ? now - schedule->deadline : 0));
+
+  bool frame_done = false;
+  switch (schedule->step) {
+    case BREAK_STEP:
+      schedule->frame_start = now;
+      if (output->SetBreak(true)) {
+        schedule->step = MARK_STEP;
+        schedule->deadline = now + output->BreakTime();
+      } else {
+        frame_done = true;
+      }
+      break;
+    case MARK_STEP:
+      if (output->SetBreak(false)) {
+        schedule->step = DATA_STEP;
+        schedule->deadline = schedule->frame_start + output->BreakTime() +
+                             output->MarkAfterBreakTime();
+      } else {
+        frame_done = true;
+      }
+      break;
+    case DATA_STEP:
+      output->TakeFrame(&schedule->frame);
+      output->WriteFrame(schedule->frame);
+      frame_done = true;
+      break;
+  }
+
+  if (!frame_done) {
+    return;
+  }
+
+  // If we've fallen more than a period behind, start the next frame now
+  // rather than sending a burst of frames.
+  const unsigned int period = output->FramePeriod(schedule->frame);
+  int64_t next_frame = schedule->frame_deadline + period;
+  const bool late = now - next_frame > period;
+  if (late) {
+    next_frame = now;
+  }
+  output->RecordFrame(late);
+  schedule->step = BREAK_STEP;
+  schedule->frame_deadline = next_frame;
+  schedule->deadline = next_frame;
+}
+}  // namespace thread
+}  // namespace ola
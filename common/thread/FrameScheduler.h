@@ -0,0 +1,165 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameScheduler.h
+ * Generates the DMX frames for many outputs from a single thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_THREAD_FRAMESCHEDULER_H_
+#define COMMON_THREAD_FRAMESCHEDULER_H_
+
+#include <stdint.h>
+#include <map>
+#include "common/thread/FrameTimer.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief An output that the host generates the DMX stream for, e.g. a UART.
+ *
+ * The frame to send is double buffered, so SetFrame() can be called from any
+ * thread without waiting for the frame that's being sent.
+ */
+class FrameOutput {
+ public:
+  FrameOutput();
+  virtual ~FrameOutput() {}
+
+  /**
+   * @brief Set the data to send in the next frame.
+   */
+  void SetFrame(const DmxBuffer &buffer);
+
+  /**
+   * @brief Get the timing statistics for this output.
+   */
+  void GetStats(FrameTimerStats *stats) const;
+
+  /**
+   * @brief The length of the break in microseconds.
+   */
+  virtual unsigned int BreakTime() const = 0;
+
+  /**
+   * @brief The length of the mark after break in microseconds.
+   */
+  virtual unsigned int MarkAfterBreakTime() const = 0;
+
+  /**
+   * @brief The time from the start of a frame to the start of the next one.
+   * @param frame the frame that was sent.
+   */
+  virtual unsigned int FramePeriod(const DmxBuffer &frame) const = 0;
+
+  /**
+   * @brief Turn the break on or off.
+   */
+  virtual bool SetBreak(bool on) = 0;
+
+  /**
+   * @brief Write the start code and the slot data.
+   */
+  virtual bool WriteFrame(const DmxBuffer &frame) = 0;
+
+ private:
+  mutable Mutex m_mutex;
+  DmxBuffer m_next_frame;
+  FrameTimerStats m_stats;
+
+  void TakeFrame(DmxBuffer *frame);
+  void RecordWakeUp(unsigned int jitter);
+  void RecordFrame(bool late);
+
+  friend class FrameScheduler;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameOutput);
+};
+
+
+/**
+ * @brief Drives many FrameOutputs from one thread.
+ *
+ * Each step of a frame (the break, the mark after break and the data) is
+ * scheduled against an absolute deadline, and the thread sleeps until the
+ * earliest deadline of all the outputs. The outputs are staggered as they're
+ * added, so their breaks don't line up.
+ */
+class FrameScheduler: public Thread {
+ public:
+  FrameScheduler();
+  ~FrameScheduler();
+
+  /**
+   * @brief Stop the thread.
+   */
+  bool Stop();
+
+  /**
+   * @brief Start generating frames for an output.
+   * @param output the output, ownership is not transferred.
+   */
+  void AddOutput(FrameOutput *output);
+
+  /**
+   * @brief Stop generating frames for an output.
+   *
+   * Once this returns the output is no longer used by the thread, so it can be
+   * deleted.
+   */
+  void RemoveOutput(FrameOutput *output);
+
+ protected:
+  void *Run();
+
+ private:
+  enum FrameStep {
+    BREAK_STEP,
+    MARK_STEP,
+    DATA_STEP
+  };
+
+  struct OutputSchedule {
+    FrameStep step;
+    int64_t deadline;
+    // When the current frame was due, and when it actually started.
+    int64_t frame_deadline;
+    int64_t frame_start;
+    DmxBuffer frame;
+  };
+
+  typedef std::map<FrameOutput*, OutputSchedule> OutputMap;
+
+  // m_mutex protects everything below, and is held while a step is run.
+  Mutex m_mutex;
+  ConditionVariable m_condition;
+  bool m_term;
+  OutputMap m_outputs;
+
+  void RunStep(FrameOutput *output, OutputSchedule *schedule);
+
+  // The spacing between the first frames of the outputs.
+  static const unsigned int STAGGER_US = 1000;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameScheduler);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // COMMON_THREAD_FRAMESCHEDULER_H_
@@ -0,0 +1,186 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameSchedulerTest.cpp
+ * Test fixture for the FrameScheduler class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "common/thread/FrameScheduler.h"
+#include "ola/DmxBuffer.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/ThreadSettings.h"
+
+using ola::DmxBuffer;
+using ola::thread::FrameOutput;
+using ola::thread::FrameScheduler;
+using ola::thread::FrameTimerStats;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using ola::thread::ThreadSettings;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * An output that records the calls made to it.
+ */
+class MockFrameOutput: public FrameOutput {
+ public:
+  MockFrameOutput() : FrameOutput(), m_policy(-1) {}
+
+  unsigned int BreakTime() const { return 100; }
+  unsigned int MarkAfterBreakTime() const { return 20; }
+  unsigned int FramePeriod(const DmxBuffer&) const { return 2000; }
+
+  bool SetBreak(bool on) {
+    MutexLocker locker(&m_mutex);
+    m_calls.push_back(on ? "break" : "mark");
+    struct sched_param param;
+    pthread_getschedparam(pthread_self(), &m_policy, &param);
+    return true;
+  }
+
+  bool WriteFrame(const DmxBuffer &frame) {
+    MutexLocker locker(&m_mutex);
+    m_calls.push_back("data");
+    m_last_frame = frame;
+    return true;
+  }
+
+  vector<string> Calls() const {
+    MutexLocker locker(&m_mutex);
+    return m_calls;
+  }
+
+  DmxBuffer LastFrame() const {
+    MutexLocker locker(&m_mutex);
+    return m_last_frame;
+  }
+
+  // The scheduling policy of the thread that sent the last break.
+  int Policy() const {
+    MutexLocker locker(&m_mutex);
+    return m_policy;
+  }
+
+ private:
+  mutable Mutex m_mutex;
+  vector<string> m_calls;
+  DmxBuffer m_last_frame;
+  int m_policy;
+};
+}  // namespace
+
+
+class FrameSchedulerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FrameSchedulerTest);
+  CPPUNIT_TEST(testFrameSteps);
+  CPPUNIT_TEST(testRemoveOutput);
+  CPPUNIT_TEST(testOutputClassScheduling);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void tearDown() { ola::thread::ClearThreadClassSettings(); }
+
+  void testFrameSteps();
+  void testRemoveOutput();
+  void testOutputClassScheduling();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameSchedulerTest);
+
+
+/*
+ * Check that each frame is a break, a mark and then the latest data.
+ */
+void FrameSchedulerTest::testFrameSteps() {
+  MockFrameOutput output1, output2;
+  const uint8_t data[] = {1, 2, 3, 4};
+  output1.SetFrame(DmxBuffer(data, sizeof(data)));
+
+  FrameScheduler scheduler;
+  OLA_ASSERT_TRUE(scheduler.Start());
+  scheduler.AddOutput(&output1);
+  scheduler.AddOutput(&output2);
+  usleep(30000);
+  scheduler.RemoveOutput(&output1);
+  scheduler.RemoveOutput(&output2);
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  vector<string> calls = output1.Calls();
+  OLA_ASSERT_TRUE(calls.size() >= 6);
+  for (unsigned int i = 0; i < calls.size(); i++) {
+    const string expected[] = {"break", "mark", "data"};
+    OLA_ASSERT_EQ(expected[i % 3], calls[i]);
+  }
+  OLA_ASSERT_EQ(DmxBuffer(data, sizeof(data)), output1.LastFrame());
+  OLA_ASSERT_TRUE(output2.Calls().size() >= 6);
+
+  FrameTimerStats stats;
+  output1.GetStats(&stats);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(calls.size() / 3), stats.frames);
+  OLA_ASSERT_TRUE(stats.max_jitter_us >= stats.jitter_us);
+}
+
+
+/*
+ * Check that a removed output isn't used again.
+ */
+void FrameSchedulerTest::testRemoveOutput() {
+  MockFrameOutput output;
+  FrameScheduler scheduler;
+  OLA_ASSERT_TRUE(scheduler.Start());
+  scheduler.AddOutput(&output);
+  usleep(10000);
+  scheduler.RemoveOutput(&output);
+
+  const size_t call_count = output.Calls().size();
+  OLA_ASSERT_TRUE(call_count > 0);
+  usleep(10000);
+  OLA_ASSERT_EQ(call_count, output.Calls().size());
+  OLA_ASSERT_TRUE(scheduler.Stop());
+}
+
+
+/*
+ * Check that the scheduling set for output threads isn't overridden.
+ */
+void FrameSchedulerTest::testOutputClassScheduling() {
+  ThreadSettings settings;
+  settings.set_scheduling = true;
+  settings.policy = SCHED_OTHER;
+  ola::thread::SetThreadClassSettings(ola::thread::THREAD_CLASS_OUTPUT,
+                                      settings);
+
+  MockFrameOutput output;
+  FrameScheduler scheduler;
+  OLA_ASSERT_TRUE(scheduler.Start());
+  scheduler.AddOutput(&output);
+  usleep(10000);
+  scheduler.RemoveOutput(&output);
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  OLA_ASSERT_EQ(static_cast<int>(SCHED_OTHER), output.Policy());
+}
@@ -0,0 +1,151 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameTimer.cpp
+ * Absolute deadline timing for the threads that generate DMX frames.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include "common/thread/FrameTimer.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ola/Logging.h"
+
+namespace ola {
+namespace thread {
+
+namespace {
+const int64_t ONE_MILLION = 1000000;
+}  // namespace
+
+FrameTimer::FrameTimer()
+    : m_frame_start(0) {
+  m_stats.frames = 0;
+  m_stats.late_frames = 0;
+  m_stats.jitter_us = 0;
+  m_stats.max_jitter_us = 0;
+}
+
+
+void FrameTimer::StartFrame() {
+  m_frame_start = CurrentTime();
+  MutexLocker locker(&m_stats_mutex);
+  m_stats.frames++;
+}
+
+
+void FrameTimer::SleepUntil(unsigned int offset_us) {
+  WaitUntil(m_frame_start + offset_us);
+}
+
+
+void FrameTimer::StartNextFrame(unsigned int period_us) {
+  const int64_t deadline = m_frame_start + period_us;
+  const int64_t now = WaitUntil(deadline);
+
+  MutexLocker locker(&m_stats_mutex);
+  m_stats.frames++;
+  if (now - deadline > period_us) {
+    m_stats.late_frames++;
+    m_frame_start = now;
+  } else {
+    m_frame_start = deadline;
+  }
+}
+
+
+void FrameTimer::GetStats(FrameTimerStats *stats) const {
+  MutexLocker locker(&m_stats_mutex);
+  *stats = m_stats;
+}
+
+
+bool FrameTimer::UseRealTimeScheduling() {
+#ifdef _WIN32
+  return false;
+#else
+  struct sched_param param;
+  memset(&param, 0, sizeof(param));
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+  int r = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+  if (r) {
+    OLA_INFO << "Unable to use SCHED_FIFO for DMX timing: " << strerror(r);
+    return false;
+  }
+  return true;
+#endif  // _WIN32
+}
+
+
+void FrameTimer::SleepUntilTime(int64_t deadline) {
+#if HAVE_CLOCK_NANOSLEEP
+  struct timespec wake_time;
+  wake_time.tv_sec = deadline / ONE_MILLION;
+  wake_time.tv_nsec = (deadline % ONE_MILLION) * 1000;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake_time, NULL) ==
+         EINTR) {
+  }
+#else
+  int64_t remaining = deadline - CurrentTime();
+  if (remaining > 0) {
+    usleep(remaining);
+  }
+#endif  // HAVE_CLOCK_NANOSLEEP
+}
+
+
+/*
+ * Sleep until a deadline and record how late we woke up.
+ * @returns the time we woke up.
+ */
+int64_t FrameTimer::WaitUntil(int64_t deadline) {
+  SleepUntilTime(deadline);
+  const int64_t now = CurrentTime();
+  const unsigned int jitter = static_cast<unsigned int>(
+      now > deadline ? now - deadline : 0);
+
+  MutexLocker locker(&m_stats_mutex);
+  m_stats.jitter_us = (m_stats.jitter_us * 7 + jitter) / 8;
+  if (jitter > m_stats.max_jitter_us) {
+    m_stats.max_jitter_us = jitter;
+  }
+  return now;
+}
+
+
+int64_t FrameTimer::CurrentTime() {
+#ifdef CLOCK_MONOTONIC
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * ONE_MILLION + now.tv_nsec / 1000;
+#else
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return now.tv_sec * ONE_MILLION + now.tv_usec;
+#endif  // CLOCK_MONOTONIC
+}
+}  // namespace thread
+}  // namespace ola
@@ -0,0 +1,115 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameTimer.h
+ * Absolute deadline timing for the threads that generate DMX frames.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_THREAD_FRAMETIMER_H_
+#define COMMON_THREAD_FRAMETIMER_H_
+
+#include <stdint.h>
+#include "ola/base/Macro.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief Timing statistics from a FrameTimer.
+ */
+struct FrameTimerStats {
+  // The number of frames started.
+  unsigned int frames;
+  // The number of times the thread fell a whole period behind and the
+  // schedule was reset.
+  unsigned int late_frames;
+  // The average and largest time we woke up after a deadline.
+  unsigned int jitter_us;
+  unsigned int max_jitter_us;
+};
+
+/**
+ * @brief Sleeps until deadlines relative to the start of a DMX frame.
+ *
+ * Each deadline is measured from the start of the frame rather than from the
+ * previous sleep, so oversleeping doesn't accumulate over the frame. Where
+ * clock_nanosleep() is available the sleeps use absolute CLOCK_MONOTONIC
+ * deadlines.
+ *
+ * The methods other than GetStats() must only be called from the thread that
+ * generates the frames.
+ */
+class FrameTimer {
+ public:
+  FrameTimer();
+
+  /**
+   * @brief Mark the start of a frame at the current time.
+   */
+  void StartFrame();
+
+  /**
+   * @brief Sleep until a time after the start of the frame.
+   * @param offset_us the offset in microseconds from the start of the frame.
+   */
+  void SleepUntil(unsigned int offset_us);
+
+  /**
+   * @brief Sleep until the start of the next frame, and start it.
+   * @param period_us the frame period in microseconds.
+   *
+   * If we've fallen more than a period behind, the next frame starts now,
+   * rather than sending a burst of frames to catch up.
+   */
+  void StartNextFrame(unsigned int period_us);
+
+  /**
+   * @brief Get the statistics, this can be called from any thread.
+   */
+  void GetStats(FrameTimerStats *stats) const;
+
+  /**
+   * @brief Try to switch the calling thread to the SCHED_FIFO policy.
+   * @returns true if the policy was changed, false if we don't have
+   *   permission, or it's not supported.
+   */
+  static bool UseRealTimeScheduling();
+
+  /**
+   * @brief The current time in microseconds, from the monotonic clock if
+   *   there is one.
+   */
+  static int64_t CurrentTime();
+
+  /**
+   * @brief Sleep until an absolute time.
+   * @param deadline the time to wake up, as returned by CurrentTime().
+   */
+  static void SleepUntilTime(int64_t deadline);
+
+ private:
+  int64_t m_frame_start;
+  FrameTimerStats m_stats;
+  mutable Mutex m_stats_mutex;
+
+  int64_t WaitUntil(int64_t deadline);
+
+  DISALLOW_COPY_AND_ASSIGN(FrameTimer);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // COMMON_THREAD_FRAMETIMER_H_
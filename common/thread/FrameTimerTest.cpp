@@ -0,0 +1,110 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameTimerTest.cpp
+ * Test fixture for the FrameTimer class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+
+#include "common/thread/FrameTimer.h"
+#include "ola/Clock.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::thread::FrameTimer;
+using ola::thread::FrameTimerStats;
+
+class FrameTimerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FrameTimerTest);
+  CPPUNIT_TEST(testSleepUntil);
+  CPPUNIT_TEST(testStartNextFrame);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testSleepUntil();
+  void testStartNextFrame();
+
+ private:
+  Clock m_clock;
+
+  int64_t ElapsedSince(const TimeStamp &start) {
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    return (now - start).AsInt();
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameTimerTest);
+
+
+/*
+ * Check that the deadlines are measured from the start of the frame.
+ */
+void FrameTimerTest::testSleepUntil() {
+  FrameTimer timer;
+  TimeStamp start;
+  m_clock.CurrentTime(&start);
+  timer.StartFrame();
+  timer.SleepUntil(1000);
+  OLA_ASSERT_TRUE(ElapsedSince(start) >= 1000);
+  timer.SleepUntil(3000);
+  OLA_ASSERT_TRUE(ElapsedSince(start) >= 3000);
+
+  // A deadline that has passed returns straight away
+  timer.SleepUntil(500);
+
+  FrameTimerStats stats;
+  timer.GetStats(&stats);
+  OLA_ASSERT_EQ(1u, stats.frames);
+  OLA_ASSERT_EQ(0u, stats.late_frames);
+  OLA_ASSERT_TRUE(stats.max_jitter_us >= stats.jitter_us);
+}
+
+
+/*
+ * Check the frame schedule, and that it's reset if we fall behind.
+ */
+void FrameTimerTest::testStartNextFrame() {
+  FrameTimer timer;
+  TimeStamp start;
+  m_clock.CurrentTime(&start);
+  timer.StartFrame();
+  timer.StartNextFrame(2000);
+  timer.StartNextFrame(2000);
+  OLA_ASSERT_TRUE(ElapsedSince(start) >= 4000);
+
+  FrameTimerStats stats;
+  timer.GetStats(&stats);
+  OLA_ASSERT_EQ(3u, stats.frames);
+  const unsigned int late_frames = stats.late_frames;
+
+  // Miss several frames
+  usleep(20000);
+  timer.StartNextFrame(2000);
+  timer.GetStats(&stats);
+  OLA_ASSERT_EQ(4u, stats.frames);
+  OLA_ASSERT_EQ(late_frames + 1, stats.late_frames);
+  OLA_ASSERT_TRUE(stats.max_jitter_us >= 16000);
+
+  // The next frame is a whole period after the reset, not a burst.
+  m_clock.CurrentTime(&start);
+  timer.StartNextFrame(2000);
+  OLA_ASSERT_TRUE(ElapsedSince(start) >= 1000);
+}
@@ -0,0 +1,138 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MPSCQueueTest.cpp
+ * Test fixture for the MPSCQueue class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/MPSCQueue.h"
+#include "ola/thread/Thread.h"
+
+using ola::thread::MPSCQueue;
+using ola::thread::Thread;
+using std::vector;
+
+class MPSCQueueTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(MPSCQueueTest);
+  CPPUNIT_TEST(testPushAndPop);
+  CPPUNIT_TEST(testMultipleProducers);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testPushAndPop();
+  void testMultipleProducers();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MPSCQueueTest);
+
+namespace {
+
+/*
+ * Push count values, tagged with the producer id, onto a queue.
+ */
+class Producer: public Thread {
+ public:
+  Producer(MPSCQueue<unsigned int> *queue, unsigned int id,
+           unsigned int count)
+      : Thread(Thread::Options("Producer")),
+        m_queue(queue),
+        m_id(id),
+        m_count(count) {
+  }
+
+  void *Run() {
+    for (unsigned int i = 0; i < m_count; i++) {
+      m_queue->Push((m_id << 24) | i);
+    }
+    return NULL;
+  }
+
+ private:
+  MPSCQueue<unsigned int> *m_queue;
+  unsigned int m_id;
+  unsigned int m_count;
+};
+}  // namespace
+
+
+/*
+ * Check items are returned in the order they were pushed.
+ */
+void MPSCQueueTest::testPushAndPop() {
+  MPSCQueue<int> queue;
+  vector<int> output;
+  OLA_ASSERT_TRUE(queue.Empty());
+  OLA_ASSERT_EQ(0u, queue.PopAll(&output));
+
+  OLA_ASSERT_TRUE(queue.Push(1));
+  OLA_ASSERT_FALSE(queue.Push(2));
+  OLA_ASSERT_FALSE(queue.Push(3));
+  OLA_ASSERT_FALSE(queue.Empty());
+
+  output.push_back(0);
+  OLA_ASSERT_EQ(3u, queue.PopAll(&output));
+  OLA_ASSERT_TRUE(queue.Empty());
+  OLA_ASSERT_EQ(static_cast<size_t>(4), output.size());
+  for (int i = 0; i < 4; i++) {
+    OLA_ASSERT_EQ(i, output[i]);
+  }
+
+  // Once drained, the next push reports the queue was empty.
+  OLA_ASSERT_TRUE(queue.Push(4));
+  // Items still in the queue are freed by the destructor.
+}
+
+
+/*
+ * Check that nothing is lost or re-ordered with concurrent producers.
+ */
+void MPSCQueueTest::testMultipleProducers() {
+  const unsigned int PRODUCERS = 4;
+  const unsigned int COUNT = 20000;
+  MPSCQueue<unsigned int> queue;
+
+  vector<Producer*> producers;
+  for (unsigned int i = 0; i < PRODUCERS; i++) {
+    producers.push_back(new Producer(&queue, i, COUNT));
+    OLA_ASSERT_TRUE(producers.back()->Start());
+  }
+
+  vector<unsigned int> next_value(PRODUCERS, 0);
+  vector<unsigned int> output;
+  unsigned int received = 0;
+  while (received < PRODUCERS * COUNT) {
+    output.clear();
+    received += queue.PopAll(&output);
+    vector<unsigned int>::const_iterator iter = output.begin();
+    for (; iter != output.end(); ++iter) {
+      unsigned int id = *iter >> 24;
+      OLA_ASSERT_TRUE(id < PRODUCERS);
+      OLA_ASSERT_EQ(next_value[id], *iter & 0xffffff);
+      next_value[id]++;
+    }
+  }
+
+  for (unsigned int i = 0; i < PRODUCERS; i++) {
+    OLA_ASSERT_TRUE(producers[i]->Join());
+    OLA_ASSERT_EQ(COUNT, next_value[i]);
+    delete producers[i];
+  }
+  OLA_ASSERT_TRUE(queue.Empty());
+}
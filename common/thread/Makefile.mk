@@ -3,12 +3,20 @@
 common_libolacommon_la_SOURCES += \
     common/thread/ConsumerThread.cpp \
     common/thread/ExecutorThread.cpp \
+    common/thread/FrameHandoff.cpp \
+    common/thread/FrameHandoff.h \
+    common/thread/FrameScheduler.cpp \
+    common/thread/FrameScheduler.h \
+    common/thread/FrameTimer.cpp \
+    common/thread/FrameTimer.h \
     common/thread/Mutex.cpp \
     common/thread/PeriodicThread.cpp \
     common/thread/SignalThread.cpp \
     common/thread/Thread.cpp \
     common/thread/ThreadPool.cpp \
-    common/thread/Utils.cpp
+    common/thread/ThreadSettings.cpp \
+    common/thread/Utils.cpp \
+    common/thread/WorkStealingPool.cpp
 
 # TESTS
 ##################################################
@@ -17,8 +25,14 @@ test_programs += common/thread/ExecutorThreadTester \
                  common/thread/FutureTester
 
 common_thread_ThreadTester_SOURCES = \
+    common/thread/FrameHandoffTest.cpp \
+    common/thread/FrameSchedulerTest.cpp \
+    common/thread/FrameTimerTest.cpp \
+    common/thread/MPSCQueueTest.cpp \
     common/thread/ThreadPoolTest.cpp \
-    common/thread/ThreadTest.cpp
+    common/thread/ThreadSettingsTest.cpp \
+    common/thread/ThreadTest.cpp \
+    common/thread/WorkStealingPoolTest.cpp
 common_thread_ThreadTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_thread_ThreadTester_LDADD = $(COMMON_TESTING_LIBS)
 
@@ -32,10 +32,13 @@
 
 
 #include <string>
+#include <vector>
 
 #include "ola/Logging.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/ThreadSettings.h"
 #include "ola/thread/Utils.h"
+#include "ola/util/Trace.h"
 
 namespace  {
 
@@ -53,9 +56,11 @@ namespace thread {
 
 using std::string;
 
-Thread::Options::Options(const std::string &name)
+Thread::Options::Options(const std::string &name,
+                         const std::string &thread_class)
   : name(name),
-    inheritsched(PTHREAD_EXPLICIT_SCHED) {
+    inheritsched(PTHREAD_EXPLICIT_SCHED),
+    thread_class(thread_class) {
   // Default the scheduling options to the system-default values.
   pthread_attr_t attrs;
   pthread_attr_init(&attrs);
@@ -167,6 +172,7 @@ bool Thread::IsRunning() {
 
 void *Thread::_InternalRun() {
   string truncated_name = m_options.name.substr(0, 15);
+  OLA_TRACE_THREAD_NAME(m_options.name);
 
 // There are 4 different variants of pthread_setname_np !
 #ifdef HAVE_PTHREAD_SETNAME_NP_2
@@ -187,6 +193,8 @@ void *Thread::_InternalRun() {
   pthread_setname_np(pthread_self(), truncated_name.c_str(), NULL);
 #endif  // HAVE_PTHREAD_SETNAME_NP_3
 
+  ApplyThreadSettings();
+
   int policy;
   struct sched_param param;
   pthread_getschedparam(pthread_self(), &policy, &param);
@@ -200,5 +208,33 @@ void *Thread::_InternalRun() {
   m_condition.Signal();
   return Run();
 }
+
+/*
+ * Apply the affinity & scheduling settings for this thread. This runs within
+ * the new thread. Real-time scheduling usually needs extra privileges, so
+ * failures are logged and the thread continues with the settings it has.
+ */
+void Thread::ApplyThreadSettings() {
+  ThreadSettings settings;
+  if (!m_options.thread_class.empty()) {
+    GetThreadClassSettings(m_options.thread_class, &settings);
+  }
+
+  const std::vector<unsigned int> &cpus = m_options.cpu_affinity.empty() ?
+      settings.cpus : m_options.cpu_affinity;
+  if (!cpus.empty() && !SetCurrentThreadAffinity(cpus)) {
+    OLA_WARN << "Failed to set the CPU affinity for " << Name();
+  }
+
+  if (settings.set_scheduling) {
+    struct sched_param param;
+    param.sched_priority = settings.priority;
+    if (!SetSchedParam(pthread_self(), settings.policy, param)) {
+      OLA_WARN << "Failed to set the scheduling for " << Name() << " to "
+               << PolicyToString(settings.policy) << ", priority "
+               << settings.priority;
+    }
+  }
+}
 }  // namespace thread
 }  // namespace ola
@@ -0,0 +1,165 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ThreadSettings.cpp
+ * CPU affinity & scheduling settings for classes of threads.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#if HAVE_DECL_SCHED_SETAFFINITY
+#include <sched.h>
+#endif  // HAVE_DECL_SCHED_SETAFFINITY
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/ThreadSettings.h"
+
+namespace ola {
+namespace thread {
+
+using std::map;
+using std::string;
+using std::vector;
+
+const char THREAD_CLASS_OUTPUT[] = "output";
+const char THREAD_CLASS_USB[] = "usb";
+const char THREAD_CLASS_HTTP[] = "http";
+const char THREAD_CLASS_PREFERENCES[] = "preferences";
+
+namespace {
+
+typedef map<string, ThreadSettings> ClassSettingsMap;
+
+Mutex class_settings_mutex;
+ClassSettingsMap class_settings;
+
+bool ParsePolicy(const string &input, int *policy) {
+  if (input == "other") {
+    *policy = SCHED_OTHER;
+  } else if (input == "fifo") {
+    *policy = SCHED_FIFO;
+  } else if (input == "rr") {
+    *policy = SCHED_RR;
+  } else {
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+
+bool ParseThreadSettings(const string &cpus,
+                         const string &policy,
+                         const string &priority,
+                         ThreadSettings *settings) {
+  ThreadSettings result;
+
+  if (!cpus.empty()) {
+    vector<string> tokens;
+    StringSplit(cpus, &tokens, ",");
+    vector<string>::const_iterator iter = tokens.begin();
+    for (; iter != tokens.end(); ++iter) {
+      unsigned int cpu;
+      if (!StringToInt(*iter, &cpu, true)) {
+        OLA_WARN << "Invalid CPU " << *iter;
+        return false;
+      }
+      result.cpus.push_back(cpu);
+    }
+  }
+
+  if (!policy.empty()) {
+    if (!ParsePolicy(policy, &result.policy)) {
+      OLA_WARN << "Invalid scheduling policy " << policy;
+      return false;
+    }
+    result.set_scheduling = true;
+  }
+
+  if (!priority.empty()) {
+    if (!result.set_scheduling) {
+      OLA_WARN << "A thread priority requires a policy";
+      return false;
+    }
+    if (!StringToInt(priority, &result.priority, true)) {
+      OLA_WARN << "Invalid thread priority " << priority;
+      return false;
+    }
+  }
+  *settings = result;
+  return true;
+}
+
+
+void SetThreadClassSettings(const string &thread_class,
+                            const ThreadSettings &settings) {
+  MutexLocker locker(&class_settings_mutex);
+  class_settings[thread_class] = settings;
+}
+
+
+bool GetThreadClassSettings(const string &thread_class,
+                            ThreadSettings *settings) {
+  MutexLocker locker(&class_settings_mutex);
+  const ThreadSettings *class_setting = STLFind(&class_settings,
+                                                thread_class);
+  if (!class_setting) {
+    return false;
+  }
+  *settings = *class_setting;
+  return true;
+}
+
+
+void ClearThreadClassSettings() {
+  MutexLocker locker(&class_settings_mutex);
+  class_settings.clear();
+}
+
+
+bool SetCurrentThreadAffinity(const vector<unsigned int> &cpus) {
+#if HAVE_DECL_SCHED_SETAFFINITY
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  vector<unsigned int>::const_iterator iter = cpus.begin();
+  for (; iter != cpus.end(); ++iter) {
+    CPU_SET(*iter, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set)) {
+    OLA_WARN << "Failed to set the CPU affinity: " << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  OLA_WARN << "CPU affinity isn't supported on this platform";
+  (void) cpus;
+  return false;
+#endif  // HAVE_DECL_SCHED_SETAFFINITY
+}
+}  // namespace thread
+}  // namespace ola
@@ -0,0 +1,139 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ThreadSettingsTest.cpp
+ * Test fixture for the thread class settings.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <pthread.h>
+
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
+#include "ola/thread/ThreadSettings.h"
+
+using ola::thread::GetThreadClassSettings;
+using ola::thread::MutexLocker;
+using ola::thread::ParseThreadSettings;
+using ola::thread::SetThreadClassSettings;
+using ola::thread::Thread;
+using ola::thread::ThreadSettings;
+
+namespace {
+
+// Records the scheduling policy the thread ran with.
+class PolicyThread: public Thread {
+ public:
+  explicit PolicyThread(const Options &options)
+      : Thread(options),
+        m_policy(-1) {
+  }
+
+  void *Run() {
+    MutexLocker locker(&m_mutex);
+    struct sched_param param;
+    pthread_getschedparam(pthread_self(), &m_policy, &param);
+    return NULL;
+  }
+
+  int Policy() {
+    MutexLocker locker(&m_mutex);
+    return m_policy;
+  }
+
+ private:
+  ola::thread::Mutex m_mutex;
+  int m_policy;
+};
+}  // namespace
+
+
+class ThreadSettingsTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ThreadSettingsTest);
+  CPPUNIT_TEST(testParse);
+  CPPUNIT_TEST(testClassSettings);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void tearDown() {
+    ola::thread::ClearThreadClassSettings();
+  }
+
+  void testParse();
+  void testClassSettings();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ThreadSettingsTest);
+
+
+/*
+ * Check that parsing the settings works.
+ */
+void ThreadSettingsTest::testParse() {
+  ThreadSettings settings;
+  OLA_ASSERT_TRUE(ParseThreadSettings("", "", "", &settings));
+  OLA_ASSERT_TRUE(settings.cpus.empty());
+  OLA_ASSERT_FALSE(settings.set_scheduling);
+
+  OLA_ASSERT_TRUE(ParseThreadSettings("2,3", "fifo", "50", &settings));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), settings.cpus.size());
+  OLA_ASSERT_EQ(2u, settings.cpus[0]);
+  OLA_ASSERT_EQ(3u, settings.cpus[1]);
+  OLA_ASSERT_TRUE(settings.set_scheduling);
+  OLA_ASSERT_EQ(static_cast<int>(SCHED_FIFO), settings.policy);
+  OLA_ASSERT_EQ(50, settings.priority);
+
+  OLA_ASSERT_TRUE(ParseThreadSettings("", "rr", "", &settings));
+  OLA_ASSERT_TRUE(settings.cpus.empty());
+  OLA_ASSERT_EQ(static_cast<int>(SCHED_RR), settings.policy);
+  OLA_ASSERT_EQ(0, settings.priority);
+
+  // Invalid input leaves the settings untouched.
+  OLA_ASSERT_FALSE(ParseThreadSettings("1,a", "", "", &settings));
+  OLA_ASSERT_FALSE(ParseThreadSettings("1,", "", "", &settings));
+  OLA_ASSERT_FALSE(ParseThreadSettings("", "idle", "", &settings));
+  OLA_ASSERT_FALSE(ParseThreadSettings("", "", "10", &settings));
+  OLA_ASSERT_FALSE(ParseThreadSettings("", "fifo", "high", &settings));
+  OLA_ASSERT_EQ(static_cast<int>(SCHED_RR), settings.policy);
+}
+
+
+/*
+ * Check that threads pick up the settings for their class.
+ */
+void ThreadSettingsTest::testClassSettings() {
+  ThreadSettings settings;
+  OLA_ASSERT_FALSE(GetThreadClassSettings("test", &settings));
+
+  // SCHED_OTHER with priority 0 doesn't need any privileges.
+  OLA_ASSERT_TRUE(ParseThreadSettings("", "other", "", &settings));
+  SetThreadClassSettings("test", settings);
+
+  ThreadSettings class_settings;
+  OLA_ASSERT_TRUE(GetThreadClassSettings("test", &class_settings));
+  OLA_ASSERT_TRUE(class_settings.set_scheduling);
+  OLA_ASSERT_EQ(static_cast<int>(SCHED_OTHER), class_settings.policy);
+
+  Thread::Options options("PolicyThread", "test");
+  PolicyThread thread(options);
+  OLA_ASSERT_TRUE(thread.Start());
+  OLA_ASSERT_TRUE(thread.Join());
+  OLA_ASSERT_EQ(static_cast<int>(SCHED_OTHER), thread.Policy());
+
+  ola::thread::ClearThreadClassSettings();
+  OLA_ASSERT_FALSE(GetThreadClassSettings("test", &class_settings));
+}
@@ -0,0 +1,272 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WorkStealingPool.cpp
+ * A pool of worker threads, each with its own queue of actions.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <pthread.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+#include "ola/thread/WorkStealingPool.h"
+
+namespace ola {
+namespace thread {
+
+using std::deque;
+
+WorkStealingPool::WorkStealingPool(unsigned int thread_count)
+    : m_thread_count(thread_count),
+      m_pending(0),
+      m_next_worker(0),
+      m_running(false),
+      m_shutdown(false) {
+}
+
+
+WorkStealingPool::~WorkStealingPool() {
+  JoinAllThreads();
+}
+
+
+bool WorkStealingPool::Init() {
+  if (!m_workers.empty()) {
+    OLA_WARN << "Work stealing pool already started";
+    return false;
+  }
+
+  for (unsigned int i = 0; i < m_thread_count; i++) {
+    m_workers.push_back(new Worker());
+  }
+
+  // The workers are all created before any thread starts, since a running
+  // worker may steal from any of them.
+  for (unsigned int i = 0; i < m_thread_count; i++) {
+    Thread::Options options("worker-" + ola::strings::IntToString(i));
+    m_workers[i]->thread = new CallbackThread(
+        NewSingleCallback(this, &WorkStealingPool::RunWorker, i),
+        options);
+    if (!m_workers[i]->thread->Start()) {
+      OLA_WARN << "Failed to start thread " << i
+               << ", aborting WorkStealingPool::Init()";
+      delete m_workers[i]->thread;
+      m_workers[i]->thread = NULL;
+      JoinAllThreads();
+      return false;
+    }
+  }
+
+  MutexLocker locker(&m_mutex);
+  m_running = true;
+  return true;
+}
+
+
+void WorkStealingPool::JoinAll() {
+  JoinAllThreads();
+}
+
+
+void WorkStealingPool::Execute(Action action, Priority priority) {
+  int index = CurrentWorker();
+
+  m_mutex.Lock();
+  if (!m_running) {
+    m_mutex.Unlock();
+    action->Run();
+    return;
+  }
+  if (index < 0) {
+    index = m_next_worker;
+    m_next_worker = (m_next_worker + 1) % m_workers.size();
+  }
+  m_mutex.Unlock();
+
+  // The action must be on a queue before m_pending counts it, so a worker
+  // that claims it is guaranteed to find it.
+  Worker *worker = m_workers[index];
+  {
+    MutexLocker locker(&worker->mutex);
+    worker->queues[priority].push_back(action);
+  }
+
+  MutexLocker locker(&m_mutex);
+  m_pending++;
+  m_condition.Signal();
+}
+
+
+Future<void> WorkStealingPool::Submit(BaseCallback0<void> *callback,
+                                      Priority priority) {
+  Future<void> future;
+  Execute(NewSingleCallback(&WorkStealingPool::RunAndSetVoid, callback,
+                            future),
+          priority);
+  return future;
+}
+
+
+void WorkStealingPool::ExecuteAndReply(Action action,
+                                       ExecutorInterface *executor,
+                                       Action reply,
+                                       Priority priority) {
+  Execute(NewSingleCallback(&WorkStealingPool::RunAndReply, action, executor,
+                            reply),
+          priority);
+}
+
+
+unsigned int WorkStealingPool::QueueDepth() const {
+  MutexLocker locker(&m_mutex);
+  return m_pending;
+}
+
+
+uint64_t WorkStealingPool::StealCount() const {
+  uint64_t steals = 0;
+  std::vector<Worker*>::const_iterator iter = m_workers.begin();
+  for (; iter != m_workers.end(); ++iter) {
+    MutexLocker locker(&(*iter)->mutex);
+    steals += (*iter)->steals;
+  }
+  return steals;
+}
+
+
+/*
+ * The loop run by each worker thread. This exits once the pool is shutting
+ * down and all actions have been run.
+ */
+void WorkStealingPool::RunWorker(unsigned int index) {
+  while (true) {
+    {
+      MutexLocker locker(&m_mutex);
+      while (!m_pending && !m_shutdown) {
+        m_condition.Wait(&m_mutex);
+      }
+      if (!m_pending) {
+        return;
+      }
+      m_pending--;
+    }
+    Action action = TakeAction(index);
+    if (action) {
+      action->Run();
+    }
+  }
+}
+
+
+/*
+ * Take the next action, in priority order. Within a priority, the worker's
+ * own queue is used first, oldest action first. Steals take the newest action
+ * from the back of another worker's queue.
+ */
+WorkStealingPool::Action WorkStealingPool::TakeAction(unsigned int index) {
+  const unsigned int worker_count = m_workers.size();
+  for (unsigned int priority = 0; priority < PRIORITY_COUNT; priority++) {
+    for (unsigned int i = 0; i < worker_count; i++) {
+      Worker *worker = m_workers[(index + i) % worker_count];
+      MutexLocker locker(&worker->mutex);
+      deque<Action> *queue = &worker->queues[priority];
+      if (queue->empty()) {
+        continue;
+      }
+
+      Action action;
+      if (i == 0) {
+        action = queue->front();
+        queue->pop_front();
+      } else {
+        action = queue->back();
+        queue->pop_back();
+        worker->steals++;
+      }
+      return action;
+    }
+  }
+  OLA_WARN << "Worker " << index << " claimed an action but found none";
+  return NULL;
+}
+
+
+/*
+ * Return the index of the worker running the calling thread, or -1 if it isn't
+ * one of our workers.
+ */
+int WorkStealingPool::CurrentWorker() const {
+  const ThreadId self = Thread::Self();
+  for (unsigned int i = 0; i < m_workers.size(); i++) {
+    const CallbackThread *thread = m_workers[i]->thread;
+    if (thread && pthread_equal(thread->Id(), self)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+
+void WorkStealingPool::JoinAllThreads() {
+  if (m_workers.empty()) {
+    return;
+  }
+
+  {
+    MutexLocker locker(&m_mutex);
+    m_shutdown = true;
+    m_condition.Broadcast();
+  }
+
+  std::vector<Worker*>::iterator iter = m_workers.begin();
+  for (; iter != m_workers.end(); ++iter) {
+    if ((*iter)->thread) {
+      (*iter)->thread->Join();
+    }
+  }
+
+  {
+    MutexLocker locker(&m_mutex);
+    m_running = false;
+    m_shutdown = false;
+  }
+
+  for (iter = m_workers.begin(); iter != m_workers.end(); ++iter) {
+    delete (*iter)->thread;
+  }
+  STLDeleteElements(&m_workers);
+}
+
+
+void WorkStealingPool::RunAndReply(Action action,
+                                   ExecutorInterface *executor,
+                                   Action reply) {
+  action->Run();
+  executor->Execute(reply);
+}
+
+
+void WorkStealingPool::RunAndSetVoid(BaseCallback0<void> *callback,
+                                     Future<void> future) {
+  callback->Run();
+  future.Set();
+}
+}  // namespace thread
+}  // namespace ola
@@ -0,0 +1,278 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WorkStealingPoolTest.cpp
+ * Test fixture for the WorkStealingPool class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/thread/ExecutorInterface.h"
+#include "ola/thread/Future.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/WorkStealingPool.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::thread::ConditionVariable;
+using ola::thread::Future;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using ola::thread::WorkStealingPool;
+using std::vector;
+
+namespace {
+
+/*
+ * An executor that just stores the callbacks.
+ */
+class RecordingExecutor : public ola::thread::ExecutorInterface {
+ public:
+  ~RecordingExecutor() { DrainCallbacks(); }
+
+  void Execute(ola::BaseCallback0<void> *callback) {
+    MutexLocker locker(&m_mutex);
+    m_callbacks.push_back(callback);
+    m_condition.Signal();
+  }
+
+  void DrainCallbacks() {
+    MutexLocker locker(&m_mutex);
+    vector<ola::BaseCallback0<void>*>::iterator iter = m_callbacks.begin();
+    for (; iter != m_callbacks.end(); ++iter) {
+      (*iter)->Run();
+    }
+    m_callbacks.clear();
+  }
+
+  void WaitForCallback() {
+    MutexLocker locker(&m_mutex);
+    while (m_callbacks.empty()) {
+      m_condition.Wait(&m_mutex);
+    }
+  }
+
+ private:
+  Mutex m_mutex;
+  ConditionVariable m_condition;
+  vector<ola::BaseCallback0<void>*> m_callbacks;
+};
+
+unsigned int Square(unsigned int value) {
+  return value * value;
+}
+}  // namespace
+
+
+class WorkStealingPoolTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(WorkStealingPoolTest);
+  CPPUNIT_TEST(testExecute);
+  CPPUNIT_TEST(testNestedExecute);
+  CPPUNIT_TEST(testPriority);
+  CPPUNIT_TEST(testSubmit);
+  CPPUNIT_TEST(testExecuteAndReply);
+  CPPUNIT_TEST(testNotRunning);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testExecute();
+  void testNestedExecute();
+  void testPriority();
+  void testSubmit();
+  void testExecuteAndReply();
+  void testNotRunning();
+
+  void setUp() {
+    m_counter = 0;
+    m_blocked = false;
+    m_in_block = false;
+    m_order.clear();
+  }
+
+ private:
+  unsigned int m_counter;
+  bool m_blocked;
+  bool m_in_block;
+  vector<unsigned int> m_order;
+  Mutex m_mutex;
+  ConditionVariable m_condition;
+
+  void IncrementCounter() {
+    MutexLocker locker(&m_mutex);
+    m_counter++;
+  }
+
+  void AddMore(WorkStealingPool *pool, unsigned int count) {
+    for (unsigned int i = 0; i < count; i++) {
+      pool->Execute(ola::NewSingleCallback(
+          this, &WorkStealingPoolTest::IncrementCounter));
+    }
+  }
+
+  void Record(unsigned int value) {
+    MutexLocker locker(&m_mutex);
+    m_order.push_back(value);
+  }
+
+  void Block() {
+    MutexLocker locker(&m_mutex);
+    m_in_block = true;
+    m_condition.Broadcast();
+    while (m_blocked) {
+      m_condition.Wait(&m_mutex);
+    }
+  }
+
+  void Unblock() {
+    MutexLocker locker(&m_mutex);
+    m_blocked = false;
+    m_condition.Broadcast();
+  }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WorkStealingPoolTest);
+
+
+/*
+ * Check all the actions are run before JoinAll() returns.
+ */
+void WorkStealingPoolTest::testExecute() {
+  WorkStealingPool pool(4);
+  OLA_ASSERT_TRUE(pool.Init());
+  OLA_ASSERT_FALSE(pool.Init());
+
+  for (unsigned int i = 0; i < 1000; i++) {
+    pool.Execute(
+        ola::NewSingleCallback(this, &WorkStealingPoolTest::IncrementCounter));
+  }
+  pool.JoinAll();
+  OLA_ASSERT_EQ(1000u, m_counter);
+  OLA_ASSERT_EQ(0u, pool.QueueDepth());
+}
+
+
+/*
+ * Actions added by the workers are queued locally, and can be stolen by the
+ * other workers.
+ */
+void WorkStealingPoolTest::testNestedExecute() {
+  WorkStealingPool pool(4);
+  OLA_ASSERT_TRUE(pool.Init());
+
+  for (unsigned int i = 0; i < 10; i++) {
+    pool.Execute(
+        ola::NewSingleCallback(this, &WorkStealingPoolTest::AddMore, &pool,
+                               100u));
+  }
+  pool.JoinAll();
+  OLA_ASSERT_EQ(1000u, m_counter);
+}
+
+
+/*
+ * Check higher priority actions are run first.
+ */
+void WorkStealingPoolTest::testPriority() {
+  WorkStealingPool pool(1);
+  OLA_ASSERT_TRUE(pool.Init());
+
+  // Hold the only worker so the rest of the actions queue up.
+  m_blocked = true;
+  pool.Execute(ola::NewSingleCallback(this, &WorkStealingPoolTest::Block));
+  {
+    MutexLocker locker(&m_mutex);
+    while (!m_in_block) {
+      m_condition.Wait(&m_mutex);
+    }
+  }
+  pool.Execute(ola::NewSingleCallback(this, &WorkStealingPoolTest::Record, 3u),
+               WorkStealingPool::PRIORITY_LOW);
+  pool.Execute(ola::NewSingleCallback(this, &WorkStealingPoolTest::Record, 2u));
+  pool.Execute(ola::NewSingleCallback(this, &WorkStealingPoolTest::Record, 1u),
+               WorkStealingPool::PRIORITY_HIGH);
+  OLA_ASSERT_EQ(3u, pool.QueueDepth());
+  Unblock();
+  pool.JoinAll();
+
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_order.size());
+  OLA_ASSERT_EQ(1u, m_order[0]);
+  OLA_ASSERT_EQ(2u, m_order[1]);
+  OLA_ASSERT_EQ(3u, m_order[2]);
+}
+
+
+/*
+ * Check Submit() completes the Future.
+ */
+void WorkStealingPoolTest::testSubmit() {
+  WorkStealingPool pool(2);
+  OLA_ASSERT_TRUE(pool.Init());
+
+  Future<unsigned int> result = pool.Submit(
+      ola::NewSingleCallback(&Square, 12u));
+  OLA_ASSERT_EQ(144u, result.Get());
+
+  Future<void> done = pool.Submit(
+      ola::NewSingleCallback(this, &WorkStealingPoolTest::IncrementCounter));
+  done.Get();
+  OLA_ASSERT_TRUE(done.IsComplete());
+  OLA_ASSERT_EQ(1u, m_counter);
+}
+
+
+/*
+ * Check the reply is queued on the executor once the action has run.
+ */
+void WorkStealingPoolTest::testExecuteAndReply() {
+  WorkStealingPool pool(2);
+  OLA_ASSERT_TRUE(pool.Init());
+  RecordingExecutor executor;
+
+  pool.ExecuteAndReply(
+      ola::NewSingleCallback(this, &WorkStealingPoolTest::Record, 1u),
+      &executor,
+      ola::NewSingleCallback(this, &WorkStealingPoolTest::Record, 2u));
+  executor.WaitForCallback();
+
+  // The reply hasn't run until the executor runs it.
+  {
+    MutexLocker locker(&m_mutex);
+    OLA_ASSERT_EQ(static_cast<size_t>(1), m_order.size());
+  }
+  executor.DrainCallbacks();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_order.size());
+  OLA_ASSERT_EQ(2u, m_order[1]);
+}
+
+
+/*
+ * Actions are run immediately if the pool isn't running.
+ */
+void WorkStealingPoolTest::testNotRunning() {
+  WorkStealingPool pool(2);
+  pool.Execute(
+      ola::NewSingleCallback(this, &WorkStealingPoolTest::IncrementCounter));
+  OLA_ASSERT_EQ(1u, m_counter);
+
+  OLA_ASSERT_TRUE(pool.Init());
+  pool.JoinAll();
+  pool.Execute(
+      ola::NewSingleCallback(this, &WorkStealingPoolTest::IncrementCounter));
+  OLA_ASSERT_EQ(2u, m_counter);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), pool.StealCount());
+}
@@ -73,6 +73,27 @@ bool TimeCode::IsValid() const {
   return false;
 }
 
+TimeCode& TimeCode::operator++() {
+  if (++m_frames < FramesPerSecond()) {
+    return *this;
+  }
+
+  m_frames = 0;
+  if (++m_seconds > MAX_SECONDS) {
+    m_seconds = 0;
+    if (++m_minutes > MAX_MINUTES) {
+      m_minutes = 0;
+      if (++m_hours > MAX_HOURS) {
+        m_hours = 0;
+      }
+    }
+    if (m_type == TIMECODE_DF && m_minutes % 10) {
+      m_frames = 2;
+    }
+  }
+  return *this;
+}
+
 string TimeCode::AsString() const {
   std::ostringstream str;
   str << setw(2) << setfill('0') << static_cast<int>(m_hours) << ":"
@@ -98,5 +119,21 @@ bool TimeCode::operator==(const TimeCode &other) const {
 bool TimeCode::operator!=(const TimeCode &other) const {
   return !(*this == other);
 }
+
+/**
+ * Returns the number of frame numbers in each second.
+ */
+uint8_t TimeCode::FramesPerSecond() const {
+  switch (m_type) {
+    case TIMECODE_FILM:
+      return 24;
+    case TIMECODE_EBU:
+      return 25;
+    case TIMECODE_DF:
+    case TIMECODE_SMPTE:
+      return 30;
+  }
+  return 30;
+}
 }  // namespace timecode
 }  // namespace ola
@@ -39,11 +39,13 @@ class TimeCodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(TimeCodeTest);
   CPPUNIT_TEST(testTimeCode);
   CPPUNIT_TEST(testIsValid);
+  CPPUNIT_TEST(testIncrement);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testTimeCode();
     void testIsValid();
+    void testIncrement();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TimeCodeTest);
@@ -97,3 +99,27 @@ void TimeCodeTest::testIsValid() {
   TimeCode t4(TIMECODE_SMPTE, 0, 0, 0, 30);
   OLA_ASSERT_FALSE(t4.IsValid());
 }
+
+/**
+ * test advancing to the next frame
+ */
+void TimeCodeTest::testIncrement() {
+  TimeCode t1(TIMECODE_FILM, 0, 0, 0, 22);
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_FILM, 0, 0, 0, 23), ++t1);
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_FILM, 0, 0, 1, 0), ++t1);
+
+  TimeCode t2(TIMECODE_EBU, 1, 59, 59, 24);
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 2, 0, 0, 0), ++t2);
+
+  TimeCode t3(TIMECODE_SMPTE, 23, 59, 59, 29);
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_SMPTE, 0, 0, 0, 0), ++t3);
+
+  // Drop frame skips frames 0 & 1, except every tenth minute.
+  TimeCode t4(TIMECODE_DF, 0, 0, 59, 29);
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_DF, 0, 1, 0, 2), ++t4);
+  TimeCode t5(TIMECODE_DF, 0, 9, 59, 29);
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_DF, 0, 10, 0, 0), ++t5);
+  TimeCode t6(TIMECODE_DF, 0, 10, 0, 29);
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_DF, 0, 10, 1, 0), ++t6);
+  OLA_ASSERT_TRUE(t6.IsValid());
+}
@@ -0,0 +1,137 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * CallbackPool.cpp
+ * Per-thread memory pools for Callback objects.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/CallbackPool.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <new>
+
+namespace ola {
+
+namespace {
+
+// Blocks are rounded up to a multiple of this.
+const size_t GRANULARITY = 16;
+// Callbacks larger than this always come from the heap.
+const size_t MAX_POOLED_SIZE = 128;
+const unsigned int SIZE_CLASSES = MAX_POOLED_SIZE / GRANULARITY;
+// The most free blocks we keep per size class, per thread.
+const unsigned int MAX_FREE_BLOCKS = 256;
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+struct ThreadPool {
+  FreeBlock *free_blocks[SIZE_CLASSES];
+  unsigned int free_count[SIZE_CLASSES];
+};
+
+bool pool_enabled = false;
+pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+pthread_key_t pool_key;
+
+void DeleteThreadPool(void *data) {
+  ThreadPool *pool = static_cast<ThreadPool*>(data);
+  for (unsigned int i = 0; i < SIZE_CLASSES; i++) {
+    FreeBlock *block = pool->free_blocks[i];
+    while (block) {
+      FreeBlock *next = block->next;
+      ::operator delete(block);
+      block = next;
+    }
+  }
+  delete pool;
+}
+
+void CreatePoolKey() {
+  pthread_key_create(&pool_key, DeleteThreadPool);
+}
+
+ThreadPool *GetThreadPool() {
+  pthread_once(&pool_key_once, CreatePoolKey);
+  ThreadPool *pool = static_cast<ThreadPool*>(pthread_getspecific(pool_key));
+  if (!pool) {
+    pool = new ThreadPool;
+    memset(pool, 0, sizeof(*pool));
+    pthread_setspecific(pool_key, pool);
+  }
+  return pool;
+}
+
+/*
+ * Return the size class for an allocation, or SIZE_CLASSES if it's too big.
+ */
+unsigned int SizeClass(size_t size) {
+  if (size == 0 || size > MAX_POOLED_SIZE) {
+    return SIZE_CLASSES;
+  }
+  return (size - 1) / GRANULARITY;
+}
+}  // namespace
+
+void SetCallbackPoolEnabled(bool enabled) {
+  __atomic_store_n(&pool_enabled, enabled, __ATOMIC_RELAXED);
+}
+
+bool CallbackPoolEnabled() {
+  return __atomic_load_n(&pool_enabled, __ATOMIC_RELAXED);
+}
+
+void *AllocateCallback(size_t size) {
+  unsigned int size_class = SizeClass(size);
+  if (size_class == SIZE_CLASSES) {
+    return ::operator new(size);
+  }
+
+  if (CallbackPoolEnabled()) {
+    ThreadPool *pool = GetThreadPool();
+    FreeBlock *block = pool->free_blocks[size_class];
+    if (block) {
+      pool->free_blocks[size_class] = block->next;
+      pool->free_count[size_class]--;
+      return block;
+    }
+  }
+  // Always allocate the full size class, so the block can be added to a free
+  // list if the pool is enabled later.
+  return ::operator new((size_class + 1) * GRANULARITY);
+}
+
+void FreeCallback(void *ptr, size_t size) {
+  if (!ptr) {
+    return;
+  }
+
+  unsigned int size_class = SizeClass(size);
+  if (size_class != SIZE_CLASSES && CallbackPoolEnabled()) {
+    ThreadPool *pool = GetThreadPool();
+    if (pool->free_count[size_class] < MAX_FREE_BLOCKS) {
+      FreeBlock *block = static_cast<FreeBlock*>(ptr);
+      block->next = pool->free_blocks[size_class];
+      pool->free_blocks[size_class] = block;
+      pool->free_count[size_class]++;
+      return;
+    }
+  }
+  ::operator delete(ptr);
+}
+}  // namespace ola
@@ -0,0 +1,137 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * CallbackPoolTest.cpp
+ * Test fixture for the CallbackPool.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/CallbackPool.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::BaseCallback0;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using std::string;
+
+class CallbackPoolTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(CallbackPoolTest);
+  CPPUNIT_TEST(testDisabled);
+  CPPUNIT_TEST(testReuse);
+  CPPUNIT_TEST(testToggle);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp() {
+    m_was_enabled = ola::CallbackPoolEnabled();
+    m_count = 0;
+  }
+  void tearDown() { ola::SetCallbackPoolEnabled(m_was_enabled); }
+
+  void testDisabled();
+  void testReuse();
+  void testToggle();
+
+  void Increment() { m_count++; }
+  void Add(unsigned int value) { m_count += value; }
+  void Append(string s, unsigned int, unsigned int, unsigned int) {
+    m_string.append(s);
+  }
+
+ private:
+  bool m_was_enabled;
+  unsigned int m_count;
+  string m_string;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CallbackPoolTest);
+
+
+/*
+ * Check callbacks still work with the pool disabled.
+ */
+void CallbackPoolTest::testDisabled() {
+  ola::SetCallbackPoolEnabled(false);
+  OLA_ASSERT_FALSE(ola::CallbackPoolEnabled());
+
+  BaseCallback0<void> *callback = NewSingleCallback(
+      this, &CallbackPoolTest::Increment);
+  callback->Run();
+  OLA_ASSERT_EQ(1u, m_count);
+}
+
+
+/*
+ * Check the memory from a deleted callback is reused by the next callback of
+ * the same size.
+ */
+void CallbackPoolTest::testReuse() {
+  ola::SetCallbackPoolEnabled(true);
+  OLA_ASSERT_TRUE(ola::CallbackPoolEnabled());
+
+  BaseCallback0<void> *callback = NewSingleCallback(
+      this, &CallbackPoolTest::Increment);
+  const void *address = callback;
+  callback->Run();
+
+  callback = NewSingleCallback(this, &CallbackPoolTest::Increment);
+  OLA_ASSERT_EQ(address, static_cast<const void*>(callback));
+  callback->Run();
+
+  // A multi-use callback is the same size, so it also reuses it.
+  BaseCallback0<void> *increment = NewCallback(
+      this, &CallbackPoolTest::Increment);
+  OLA_ASSERT_EQ(address, static_cast<const void*>(increment));
+  increment->Run();
+  delete increment;
+
+  // This has a bound argument, and is a different size.
+  BaseCallback0<void> *add = NewCallback(this, &CallbackPoolTest::Add, 2u);
+  add->Run();
+  delete add;
+  OLA_ASSERT_EQ(5u, m_count);
+
+  // Callbacks with a larger closure still work.
+  BaseCallback0<void> *append = NewSingleCallback(
+      this, &CallbackPoolTest::Append, string("foo"), 1u, 2u, 3u);
+  append->Run();
+  OLA_ASSERT_EQ(string("foo"), m_string);
+}
+
+
+/*
+ * Check memory can be freed after the pool is toggled.
+ */
+void CallbackPoolTest::testToggle() {
+  ola::SetCallbackPoolEnabled(false);
+  BaseCallback0<void> *callback1 = NewSingleCallback(
+      this, &CallbackPoolTest::Increment);
+
+  ola::SetCallbackPoolEnabled(true);
+  BaseCallback0<void> *callback2 = NewSingleCallback(
+      this, &CallbackPoolTest::Increment);
+  // callback1 was allocated from the heap, but goes to the free list.
+  callback1->Run();
+
+  ola::SetCallbackPoolEnabled(false);
+  // callback2 came from the pool, but is returned to the heap.
+  callback2->Run();
+  OLA_ASSERT_EQ(2u, m_count);
+}
@@ -29,6 +29,7 @@
 #include <ola/Clock.h>
 #include <stdint.h>
 #include <sys/time.h>
+#include <time.h>
 
 #if HAVE_CONFIG_H
 #include <config.h>
@@ -257,6 +258,33 @@ void Clock::CurrentTime(TimeStamp *timestamp) const {
   *timestamp = tv;
 }
 
+MonotonicClock::MonotonicClock(bool coarse)
+    : Clock(),
+      m_clock_id(0) {
+#ifdef CLOCK_MONOTONIC
+  m_clock_id = CLOCK_MONOTONIC;
+#endif  // CLOCK_MONOTONIC
+#ifdef CLOCK_MONOTONIC_COARSE
+  if (coarse) {
+    m_clock_id = CLOCK_MONOTONIC_COARSE;
+  }
+#endif  // CLOCK_MONOTONIC_COARSE
+  (void) coarse;
+}
+
+void MonotonicClock::CurrentTime(TimeStamp *timestamp) const {
+#ifdef CLOCK_MONOTONIC
+  struct timespec now;
+  clock_gettime(static_cast<clockid_t>(m_clock_id), &now);
+  struct timeval tv;
+  tv.tv_sec = now.tv_sec;
+  tv.tv_usec = now.tv_nsec / 1000;
+  *timestamp = tv;
+#else
+  Clock::CurrentTime(timestamp);
+#endif  // CLOCK_MONOTONIC
+}
+
 void MockClock::AdvanceTime(const TimeInterval &interval) {
   m_offset += interval;
 }
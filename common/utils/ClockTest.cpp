@@ -38,6 +38,8 @@ class ClockTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testTimeIntervalMutliplication);
   CPPUNIT_TEST(testClock);
   CPPUNIT_TEST(testMockClock);
+  CPPUNIT_TEST(testCachedClock);
+  CPPUNIT_TEST(testMonotonicClock);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -46,13 +48,17 @@ class ClockTest: public CppUnit::TestFixture {
     void testTimeIntervalMutliplication();
     void testClock();
     void testMockClock();
+    void testCachedClock();
+    void testMonotonicClock();
 };
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ClockTest);
 
+using ola::CachedClock;
 using ola::Clock;
 using ola::MockClock;
+using ola::MonotonicClock;
 using ola::TimeStamp;
 using ola::TimeInterval;
 using std::string;
@@ -188,3 +194,51 @@ void ClockTest::testMockClock() {
   OLA_ASSERT_LT(second, third);
   OLA_ASSERT_TRUE(ten_point_five_seconds <= (third - second));
 }
+
+
+/**
+ * test the Cached Clock
+ */
+void ClockTest::testCachedClock() {
+  TimeStamp now(TimeStamp() + TimeInterval(100, 0));
+  CachedClock clock(&now);
+
+  TimeStamp first;
+  clock.CurrentTime(&first);
+  OLA_ASSERT_EQ(now, first);
+
+  // The time only changes when the owner updates it.
+  now += TimeInterval(0, 500);
+  TimeStamp second;
+  clock.CurrentTime(&second);
+  OLA_ASSERT_EQ(now, second);
+  OLA_ASSERT_EQ(TimeInterval(0, 500), second - first);
+}
+
+
+/**
+ * test the Monotonic Clock
+ */
+void ClockTest::testMonotonicClock() {
+  MonotonicClock clock;
+  MonotonicClock coarse_clock(true);
+
+  TimeStamp first, coarse_first;
+  clock.CurrentTime(&first);
+  coarse_clock.CurrentTime(&coarse_first);
+  OLA_ASSERT_TRUE(first.IsSet());
+  OLA_ASSERT_TRUE(coarse_first.IsSet());
+
+#ifdef _WIN32
+  Sleep(100);
+#else
+  usleep(100000);
+#endif  // _WIN32
+
+  TimeStamp second, coarse_second;
+  clock.CurrentTime(&second);
+  coarse_clock.CurrentTime(&coarse_second);
+  OLA_ASSERT_LT(first, second);
+  OLA_ASSERT_LT(coarse_first, coarse_second);
+  OLA_ASSERT_TRUE(TimeInterval(0, 90000) <= (second - first));
+}
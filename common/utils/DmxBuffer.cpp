@@ -27,22 +27,55 @@
  * @file DmxBuffer.cpp
  */
 
+#include <ctype.h>
 #include <string.h>
 #include <algorithm>
 #include <iostream>
 #include <string>
-#include <vector>
+#include "common/dmx/HTPMerge.h"
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
-#include "ola/StringUtils.h"
 
 namespace ola {
 
 using std::min;
 using std::max;
 using std::string;
-using std::vector;
+
+namespace {
+
+/*
+ * Parse a single slot value, stopping at the next , or the end of the input.
+ */
+uint8_t ParseSlot(const char **input, const char *end) {
+  const char *ptr = *input;
+  while (ptr != end && isspace(static_cast<unsigned char>(*ptr))) {
+    ptr++;
+  }
+
+  bool negative = false;
+  if (ptr != end && (*ptr == '-' || *ptr == '+')) {
+    negative = (*ptr == '-');
+    ptr++;
+  }
+
+  // Values over 255 wrap, as they did with atoi.
+  unsigned int value = 0;
+  for (; ptr != end; ptr++) {
+    const unsigned int digit = static_cast<unsigned char>(*ptr) - '0';
+    if (digit > 9) {
+      break;
+    }
+    value = value * 10 + digit;
+  }
+
+  ptr = static_cast<const char*>(memchr(ptr, ',', end - ptr));
+  *input = ptr ? ptr : end;
+  return static_cast<uint8_t>(negative ? 0u - value : value);
+}
+}  // namespace
+
 
 DmxBuffer::DmxBuffer()
     : m_ref_count(NULL),
@@ -82,6 +115,15 @@ DmxBuffer::DmxBuffer(const string &data)
 }
 
 
+DmxBuffer::DmxBuffer(const DmxView &view)
+    : m_ref_count(0),
+      m_copy_on_write(false),
+      m_data(NULL),
+      m_length(0) {
+  Set(view);
+}
+
+
 DmxBuffer::~DmxBuffer() {
   CleanupMemory();
 }
@@ -98,6 +140,14 @@ DmxBuffer& DmxBuffer::operator=(const DmxBuffer &other) {
 }
 
 
+void DmxBuffer::Swap(DmxBuffer &other) {
+  std::swap(m_ref_count, other.m_ref_count);
+  std::swap(m_copy_on_write, other.m_copy_on_write);
+  std::swap(m_data, other.m_data);
+  std::swap(m_length, other.m_length);
+}
+
+
 bool DmxBuffer::operator==(const DmxBuffer &other) const {
   return (m_length == other.m_length &&
           (m_data == other.m_data ||
@@ -111,24 +161,47 @@ bool DmxBuffer::operator!=(const DmxBuffer &other) const {
 
 
 bool DmxBuffer::HTPMerge(const DmxBuffer &other) {
+  const DmxBuffer *buffers[] = {&other};
+  return HTPMerge(buffers, 1);
+}
+
+
+bool DmxBuffer::HTPMerge(const DmxBuffer *const *buffers, unsigned int count) {
   if (!m_data) {
     if (!Init())
       return false;
   }
   DuplicateIfNeeded();
 
-  unsigned int other_length = min((unsigned int) DMX_UNIVERSE_SIZE,
-                                  other.m_length);
-  unsigned int merge_length = min(m_length, other.m_length);
-
-  for (unsigned int i = 0; i < merge_length; i++) {
-    m_data[i] = max(m_data[i], other.m_data[i]);
-  }
+  // The kernel takes the sources in batches, so we don't need to allocate
+  // memory for the pointer & length arrays.
+  static const unsigned int BATCH_SIZE = 16;
+  const uint8_t *sources[BATCH_SIZE];
+  unsigned int lengths[BATCH_SIZE];
 
-  if (other_length > m_length) {
-    memcpy(m_data + merge_length, other.m_data + merge_length,
-           other_length - merge_length);
-    m_length = other_length;
+  unsigned int i = 0;
+  while (i < count) {
+    unsigned int batch_size = 0;
+    for (; i < count && batch_size < BATCH_SIZE; i++) {
+      const DmxBuffer *other = buffers[i];
+      unsigned int other_length = min((unsigned int) DMX_UNIVERSE_SIZE,
+                                      other->m_length);
+      if (!other_length) {
+        continue;
+      }
+
+      // Slots past the end of our data are zero, so the max is the slot from
+      // the other buffer.
+      if (other_length > m_length) {
+        memset(m_data + m_length, DMX_MIN_SLOT_VALUE,
+               other_length - m_length);
+        m_length = other_length;
+      }
+      sources[batch_size] = other->m_data;
+      lengths[batch_size] = other_length;
+      batch_size++;
+    }
+    ola::dmx::HTPMergeBlocks(m_data, sources, lengths, batch_size);
   }
   return true;
 }
@@ -138,14 +211,18 @@ bool DmxBuffer::Set(const uint8_t *data, unsigned int length) {
   if (!data)
     return false;
 
-  if (m_copy_on_write)
-    CleanupMemory();
+  if (m_copy_on_write) {
+    // If the other copies have gone away the memory can be reused.
+    if (m_ref_count && *m_ref_count > 1)
+      CleanupMemory();
+    m_copy_on_write = false;
+  }
   if (!m_data) {
     if (!Init())
       return false;
   }
   m_length = min(length, (unsigned int) DMX_UNIVERSE_SIZE);
-  memcpy(m_data, data, m_length);
+  memmove(m_data, data, m_length);
   return true;
 }
 
@@ -160,11 +237,12 @@ bool DmxBuffer::Set(const DmxBuffer &other) {
 }
 
 
-bool DmxBuffer::SetFromString(const string &input) {
-  unsigned int i = 0;
-  vector<string> dmx_values;
-  vector<string>::const_iterator iter;
+bool DmxBuffer::Set(const DmxView &view) {
+  return Set(view.GetRaw(), view.Size());
+}
 
+
+bool DmxBuffer::SetFromString(const string &input) {
   if (m_copy_on_write)
     CleanupMemory();
   if (!m_data)
@@ -175,10 +253,18 @@ bool DmxBuffer::SetFromString(const string &input) {
     m_length = 0;
     return true;
   }
-  StringSplit(input, &dmx_values, ",");
-  for (iter = dmx_values.begin();
-      iter != dmx_values.end() && i < DMX_UNIVERSE_SIZE; ++iter, ++i) {
-    m_data[i] = atoi(iter->data());
+
+  // Each slot is parsed in place. Like atoi, leading whitespace and a sign
+  // are accepted, and anything after the digits is ignored.
+  const char *ptr = input.data();
+  const char *end = ptr + input.size();
+  unsigned int i = 0;
+  while (i < DMX_UNIVERSE_SIZE) {
+    m_data[i++] = ParseSlot(&ptr, end);
+    if (ptr == end) {
+      break;
+    }
+    ptr++;  // skip the ,
   }
   m_length = i;
   return true;
@@ -318,15 +404,23 @@ string DmxBuffer::ToString() const {
     return "";
   }
 
-  // TODO(Peter): Change to the uint8_t version of StringJoin
-  std::ostringstream str;
-  for (unsigned int i = 0; i < Size(); i++) {
-    if (i) {
-      str << ",";
+  // Up to 3 digits and a , per slot.
+  char output[DMX_UNIVERSE_SIZE * 4];
+  char *ptr = output;
+  for (unsigned int i = 0; i < m_length; i++) {
+    unsigned int value = m_data[i];
+    *ptr = ',';
+    ptr += (i != 0);
+    if (value >= 100) {
+      *ptr++ = '0' + value / 100;
+      value %= 100;
+      *ptr++ = '0' + value / 10;
+    } else if (value >= 10) {
+      *ptr++ = '0' + value / 10;
     }
-    str << static_cast<int>(m_data[i]);
+    *ptr++ = '0' + value % 10;
   }
-  return str.str();
+  return string(output, ptr - output);
 }
 
 
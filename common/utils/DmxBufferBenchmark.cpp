@@ -0,0 +1,100 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxBufferBenchmark.cpp
+ * Microbenchmarks for the DmxBuffer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/testing/Benchmark.h"
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::testing::Benchmark;
+
+namespace {
+
+class DmxBufferBenchmark {
+ public:
+  DmxBufferBenchmark() {
+    for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+      m_data[i] = static_cast<uint8_t>(i * 7);
+    }
+    m_source.Set(m_data, sizeof(m_data));
+    m_dest.Blackout();
+    m_string = m_source.ToString();
+  }
+
+  void HTPMerge(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      m_dest.HTPMerge(m_source);
+    }
+  }
+
+  void Set(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      m_dest.Set(m_data, sizeof(m_data));
+    }
+  }
+
+  void SetRange(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      // A 16 slot fixture in the middle of the universe.
+      m_dest.SetRange(256, m_data, 16);
+    }
+  }
+
+  void SetFromString(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      m_dest.SetFromString(m_string);
+    }
+  }
+
+  void ToString(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      m_string = m_source.ToString();
+    }
+  }
+
+ private:
+  uint8_t m_data[ola::DMX_UNIVERSE_SIZE];
+  DmxBuffer m_source;
+  DmxBuffer m_dest;
+  std::string m_string;
+};
+}  // namespace
+
+
+int main() {
+  DmxBufferBenchmark fixture;
+  Benchmark benchmark("DmxBuffer", &std::cout);
+  benchmark.Run("HTPMerge", 0,
+                NewCallback(&fixture, &DmxBufferBenchmark::HTPMerge));
+  benchmark.Run("Set", 0, NewCallback(&fixture, &DmxBufferBenchmark::Set));
+  benchmark.Run("SetRange", 0,
+                NewCallback(&fixture, &DmxBufferBenchmark::SetRange));
+  benchmark.Run("SetFromString", 0,
+                NewCallback(&fixture, &DmxBufferBenchmark::SetFromString));
+  benchmark.Run("ToString", 0,
+                NewCallback(&fixture, &DmxBufferBenchmark::ToString));
+  return 0;
+}
@@ -21,6 +21,8 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <string.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
@@ -29,6 +31,7 @@
 using std::ostringstream;
 using std::string;
 using ola::DmxBuffer;
+using ola::DmxView;
 
 class DmxBufferTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DmxBufferTest);
@@ -37,7 +40,10 @@ class DmxBufferTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testStringGetSet);
   CPPUNIT_TEST(testAssign);
   CPPUNIT_TEST(testCopy);
+  CPPUNIT_TEST(testSwap);
+  CPPUNIT_TEST(testView);
   CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testMultiMerge);
   CPPUNIT_TEST(testStringToDmx);
   CPPUNIT_TEST(testCopyOnWrite);
   CPPUNIT_TEST(testSetRange);
@@ -52,7 +58,10 @@ class DmxBufferTest: public CppUnit::TestFixture {
     void testAssign();
     void testStringGetSet();
     void testCopy();
+    void testSwap();
+    void testView();
     void testMerge();
+    void testMultiMerge();
     void testStringToDmx();
     void testCopyOnWrite();
     void testSetRange();
@@ -254,6 +263,94 @@ void DmxBufferTest::testCopy() {
 }
 
 
+/*
+ * Check that Swap() and the move operations work
+ */
+void DmxBufferTest::testSwap() {
+  DmxBuffer buffer(TEST_DATA, sizeof(TEST_DATA));
+  DmxBuffer buffer2(TEST_DATA2, sizeof(TEST_DATA2));
+  const uint8_t *data = buffer.GetRaw();
+  const uint8_t *data2 = buffer2.GetRaw();
+
+  buffer.Swap(buffer2);
+  OLA_ASSERT_EQ(data2, buffer.GetRaw());
+  OLA_ASSERT_EQ(data, buffer2.GetRaw());
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA2, sizeof(TEST_DATA2), buffer.GetRaw(),
+                         buffer.Size());
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA, sizeof(TEST_DATA), buffer2.GetRaw(),
+                         buffer2.Size());
+
+  // swap with an empty buffer
+  DmxBuffer empty;
+  empty.Swap(buffer);
+  OLA_ASSERT_EQ(0u, buffer.Size());
+  OLA_ASSERT_EQ(data2, empty.GetRaw());
+
+  // swapping a copy-on-write buffer keeps the copy intact
+  DmxBuffer copy(buffer2);
+  copy.Swap(empty);
+  empty.SetChannel(0, 99);
+  OLA_ASSERT_EQ((uint8_t) 99, empty.Get(0));
+  OLA_ASSERT_EQ(TEST_DATA[0], buffer2.Get(0));
+
+#if __cplusplus >= 201103L
+  DmxBuffer moved(std::move(buffer2));
+  OLA_ASSERT_EQ(data, moved.GetRaw());
+  OLA_ASSERT_EQ(0u, buffer2.Size());
+  OLA_ASSERT_NULL(buffer2.GetRaw());
+
+  buffer2 = std::move(moved);
+  OLA_ASSERT_EQ(data, buffer2.GetRaw());
+  OLA_ASSERT_EQ(0u, moved.Size());
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA, sizeof(TEST_DATA), buffer2.GetRaw(),
+                         buffer2.Size());
+#endif  // __cplusplus >= 201103L
+}
+
+
+/*
+ * Check that DmxView works
+ */
+void DmxBufferTest::testView() {
+  DmxView empty_view;
+  OLA_ASSERT_EQ(0u, empty_view.Size());
+  OLA_ASSERT_NULL(empty_view.GetRaw());
+  OLA_ASSERT_EQ((uint8_t) 0, empty_view.Get(0));
+  OLA_ASSERT_EQ(0u, DmxBuffer().View().Size());
+
+  DmxBuffer buffer(TEST_DATA, sizeof(TEST_DATA));
+  DmxView view = buffer.View();
+  OLA_ASSERT_EQ(buffer.GetRaw(), view.GetRaw());
+  OLA_ASSERT_EQ(buffer.Size(), view.Size());
+  OLA_ASSERT_EQ(TEST_DATA[4], view.Get(4));
+  OLA_ASSERT_EQ((uint8_t) 0, view.Get(5));
+
+  // A view doesn't share the buffer, so this doesn't need to copy
+  const uint8_t *data = buffer.GetRaw();
+  buffer.SetChannel(0, 99);
+  OLA_ASSERT_EQ(data, buffer.GetRaw());
+
+  DmxBuffer copy(buffer.View());
+  OLA_ASSERT_TRUE(copy == buffer);
+  OLA_ASSERT_NE(buffer.GetRaw(), copy.GetRaw());
+
+  DmxBuffer other;
+  OLA_ASSERT_TRUE(other.Set(DmxView(TEST_DATA2, sizeof(TEST_DATA2))));
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA2, sizeof(TEST_DATA2), other.GetRaw(),
+                         other.Size());
+  OLA_ASSERT_FALSE(other.Set(DmxView()));
+
+  // Once the other copies have gone, Set() reuses the memory
+  data = other.GetRaw();
+  {
+    DmxBuffer shared(other);
+  }
+  OLA_ASSERT_TRUE(other.Set(buffer.View()));
+  OLA_ASSERT_EQ(data, other.GetRaw());
+  OLA_ASSERT_TRUE(other == buffer);
+}
+
+
 /*
  * Check that HTP Merging works
  */
@@ -286,6 +383,49 @@ void DmxBufferTest::testMerge() {
 }
 
 
+/*
+ * Check that merging a number of buffers at once works
+ */
+void DmxBufferTest::testMultiMerge() {
+  DmxBuffer buffer1(TEST_DATA, sizeof(TEST_DATA));
+  DmxBuffer buffer2(TEST_DATA3, sizeof(TEST_DATA3));
+  DmxBuffer merge_result(MERGE_RESULT, sizeof(MERGE_RESULT));
+  DmxBuffer empty_buffer;
+
+  // no buffers leaves the data as is
+  DmxBuffer result;
+  OLA_ASSERT_TRUE(result.HTPMerge(NULL, 0));
+  OLA_ASSERT_EQ(0u, result.Size());
+
+  const DmxBuffer *buffers[] = {&buffer1, &empty_buffer, &buffer2};
+  OLA_ASSERT_TRUE(result.HTPMerge(buffers, 3));
+  OLA_ASSERT_TRUE(merge_result == result);
+
+  // more buffers than fit in a single pass of the kernel
+  DmxBuffer full_buffer;
+  full_buffer.Blackout();
+  std::vector<DmxBuffer> many_buffers(40, full_buffer);
+  std::vector<const DmxBuffer*> pointers;
+  for (unsigned int i = 0; i < many_buffers.size(); i++) {
+    many_buffers[i].SetChannel(i * 11, i + 1);
+    pointers.push_back(&many_buffers[i]);
+  }
+
+  result.Reset();
+  OLA_ASSERT_TRUE(result.HTPMerge(&pointers[0], pointers.size()));
+  OLA_ASSERT_EQ((unsigned int) ola::DMX_UNIVERSE_SIZE, result.Size());
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    unsigned int expected = (i % 11 == 0 && i / 11 < many_buffers.size()) ?
+        i / 11 + 1 : 0;
+    OLA_ASSERT_EQ(expected, (unsigned int) result.Get(i));
+  }
+
+  // the sources aren't modified
+  OLA_ASSERT_EQ((uint8_t) 1, many_buffers[0].Get(0));
+  OLA_ASSERT_EQ((uint8_t) 0, many_buffers[0].Get(11));
+}
+
+
 /*
  * Run the StringToDmxTest
  * @param input the string to parse
@@ -330,6 +470,19 @@ void DmxBufferTest::testStringToDmx() {
   input = "";
   uint8_t expected7[] = {};
   runStringToDmx(input, DmxBuffer(expected7, sizeof(expected7)));
+
+  input = "+7,-1, \t12x,99 , 1000";
+  uint8_t expected8[] = {7, 255, 12, 99, 232};
+  runStringToDmx(input, DmxBuffer(expected8, sizeof(expected8)));
+
+  // Values past the end of the universe are ignored
+  input = "1";
+  for (unsigned int i = 1; i < ola::DMX_UNIVERSE_SIZE + 10; i++) {
+    input.append(",1");
+  }
+  uint8_t expected9[ola::DMX_UNIVERSE_SIZE];
+  memset(expected9, 1, sizeof(expected9));
+  runStringToDmx(input, DmxBuffer(expected9, sizeof(expected9)));
 }
 
 
@@ -519,6 +672,19 @@ void DmxBufferTest::testToString() {
   buffer.SetRangeToValue(0, 255, 5);
   OLA_ASSERT_EQ(string("255,255,255,255,255"), buffer.ToString());
 
+  buffer.SetFromString("0,9,10,99,100,199,200,255");
+  OLA_ASSERT_EQ(string("0,9,10,99,100,199,200,255"), buffer.ToString());
+
+  // A full universe round trips
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  for (unsigned int i = 0; i < sizeof(data); i++) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  buffer.Set(data, sizeof(data));
+  DmxBuffer copy;
+  OLA_ASSERT_TRUE(copy.SetFromString(buffer.ToString()));
+  OLA_ASSERT_EQ(buffer, copy);
+
   buffer.SetFromString("1,2,3,4");
   ostringstream str;
   str << buffer;
@@ -0,0 +1,106 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Histogram.cpp
+ * A fixed size, log-linear histogram.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/util/Histogram.h"
+
+#include <string.h>
+#include <algorithm>
+
+namespace ola {
+
+void Histogram::Add(uint32_t value) {
+  unsigned int index = BucketIndex(value);
+  // Saturate rather than wrap if a bucket fills up.
+  if (m_buckets[index] != 0xffffffff) {
+    m_buckets[index]++;
+  }
+  m_count++;
+  m_sum += value;
+  m_max = std::max(m_max, value);
+}
+
+
+void Histogram::Reset() {
+  memset(m_buckets, 0, sizeof(m_buckets));
+  m_count = 0;
+  m_sum = 0;
+  m_max = 0;
+}
+
+
+uint32_t Histogram::Percentile(double percentile) const {
+  if (!m_count) {
+    return 0;
+  }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t target = static_cast<uint64_t>(m_count * percentile / 100.0 + 0.5);
+  target = std::max(target, static_cast<uint64_t>(1));
+
+  uint64_t total = 0;
+  for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+    total += m_buckets[i];
+    if (total >= target) {
+      return std::min(BucketUpperBound(i), m_max);
+    }
+  }
+  return m_max;
+}
+
+
+void Histogram::CumulativeCounts(const uint32_t *bounds, unsigned int size,
+                                 uint64_t *counts) const {
+  uint64_t total = 0;
+  unsigned int bucket = 0;
+  for (unsigned int i = 0; i < size; i++) {
+    const unsigned int last = BucketIndex(bounds[i]);
+    for (; bucket <= last; bucket++) {
+      total += m_buckets[bucket];
+    }
+    counts[i] = total;
+  }
+}
+
+
+/*
+ * Values with a most significant bit of n, where n >= SUB_BUCKET_BITS, are
+ * split into SUB_BUCKETS buckets of width 2 ^ (n - SUB_BUCKET_BITS).
+ */
+unsigned int Histogram::BucketIndex(uint32_t value) {
+  if (value < 2 * SUB_BUCKETS) {
+    return value;
+  }
+  unsigned int shift = 0;
+  while ((value >> shift) >= 2 * SUB_BUCKETS) {
+    shift++;
+  }
+  return (shift + 1) * SUB_BUCKETS + (value >> shift) - SUB_BUCKETS;
+}
+
+
+uint32_t Histogram::BucketUpperBound(unsigned int index) {
+  if (index < 2 * SUB_BUCKETS) {
+    return index;
+  }
+  const unsigned int shift = index / SUB_BUCKETS - 1;
+  const uint64_t next = static_cast<uint64_t>(
+      index % SUB_BUCKETS + SUB_BUCKETS + 1) << shift;
+  return static_cast<uint32_t>(std::min<uint64_t>(next - 1, 0xffffffff));
+}
+}  // namespace ola
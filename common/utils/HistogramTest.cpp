@@ -0,0 +1,156 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HistogramTest.cpp
+ * Test fixture for the Histogram class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "ola/util/Histogram.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::Histogram;
+
+class HistogramTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(HistogramTest);
+  CPPUNIT_TEST(testEmpty);
+  CPPUNIT_TEST(testSmallValues);
+  CPPUNIT_TEST(testPrecision);
+  CPPUNIT_TEST(testPercentiles);
+  CPPUNIT_TEST(testCumulativeCounts);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEmpty();
+    void testSmallValues();
+    void testPrecision();
+    void testPercentiles();
+    void testCumulativeCounts();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HistogramTest);
+
+
+/**
+ * Check an empty histogram.
+ */
+void HistogramTest::testEmpty() {
+  Histogram histogram;
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), histogram.Count());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), histogram.Sum());
+  OLA_ASSERT_EQ(0u, histogram.Max());
+  OLA_ASSERT_EQ(0u, histogram.Percentile(50));
+  OLA_ASSERT_EQ(0u, histogram.Percentile(99.9));
+}
+
+
+/**
+ * Check that small values are recorded exactly.
+ */
+void HistogramTest::testSmallValues() {
+  Histogram histogram;
+  for (uint32_t i = 1; i <= 20; i++) {
+    histogram.Add(i);
+  }
+  OLA_ASSERT_EQ(static_cast<uint64_t>(20), histogram.Count());
+  OLA_ASSERT_EQ(20u, histogram.Max());
+  OLA_ASSERT_EQ(1u, histogram.Percentile(0));
+  OLA_ASSERT_EQ(10u, histogram.Percentile(50));
+  OLA_ASSERT_EQ(19u, histogram.Percentile(95));
+  OLA_ASSERT_EQ(20u, histogram.Percentile(100));
+
+  histogram.Reset();
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), histogram.Count());
+  OLA_ASSERT_EQ(0u, histogram.Percentile(50));
+}
+
+
+/**
+ * Check that large values are within the precision of the histogram.
+ */
+void HistogramTest::testPrecision() {
+  const uint32_t values[] = {32, 33, 100, 1000, 22675, 1000000, 0xfffffffe};
+  for (unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    Histogram histogram;
+    histogram.Add(values[i]);
+    // Add one larger value, so the percentile isn't capped by the max.
+    histogram.Add(0xffffffff);
+
+    uint32_t value = histogram.Percentile(50);
+    OLA_ASSERT_TRUE(value >= values[i]);
+    OLA_ASSERT_TRUE(value - values[i] <= values[i] / 16);
+  }
+}
+
+
+/**
+ * Check the percentiles of a spread of values.
+ */
+void HistogramTest::testPercentiles() {
+  Histogram histogram;
+  // 990 fast values, 9 slower ones & one very slow one.
+  for (unsigned int i = 0; i < 990; i++) {
+    histogram.Add(200);
+  }
+  for (unsigned int i = 0; i < 9; i++) {
+    histogram.Add(5000);
+  }
+  histogram.Add(100000);
+
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1000), histogram.Count());
+  OLA_ASSERT_EQ(100000u, histogram.Max());
+
+  uint32_t p50 = histogram.Percentile(50);
+  OLA_ASSERT_TRUE(p50 >= 200 && p50 < 213);
+  uint32_t p99 = histogram.Percentile(99);
+  OLA_ASSERT_TRUE(p99 >= 200 && p99 < 213);
+  uint32_t p999 = histogram.Percentile(99.9);
+  OLA_ASSERT_TRUE(p999 >= 5000 && p999 < 5313);
+  OLA_ASSERT_EQ(100000u, histogram.Percentile(100));
+}
+
+
+/**
+ * Check the cumulative counts & the sum.
+ */
+void HistogramTest::testCumulativeCounts() {
+  Histogram histogram;
+  histogram.Add(0);
+  histogram.Add(31);
+  histogram.Add(32);
+  histogram.Add(1023);
+  histogram.Add(1024);
+  histogram.Add(0xffffffff);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x100000000ULL + 2109),
+                histogram.Sum());
+
+  const uint32_t bounds[] = {0, 31, 1023, 65535, 0xffffffff};
+  uint64_t counts[5];
+  histogram.CumulativeCounts(bounds, 5, counts);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), counts[0]);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(2), counts[1]);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(4), counts[2]);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(5), counts[3]);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(6), counts[4]);
+
+  histogram.Reset();
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), histogram.Sum());
+  histogram.CumulativeCounts(bounds, 5, counts);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), counts[4]);
+}
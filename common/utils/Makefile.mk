@@ -2,10 +2,13 @@
 ################################################
 common_libolacommon_la_SOURCES += \
     common/utils/ActionQueue.cpp \
+    common/utils/CallbackPool.cpp \
     common/utils/Clock.cpp \
     common/utils/DmxBuffer.cpp \
+    common/utils/Histogram.cpp \
     common/utils/StringUtils.cpp \
     common/utils/TokenBucket.cpp \
+    common/utils/Trace.cpp \
     common/utils/Watchdog.cpp
 
 # TESTS
@@ -15,13 +18,23 @@ test_programs += common/utils/UtilsTester
 common_utils_UtilsTester_SOURCES = \
     common/utils/ActionQueueTest.cpp \
     common/utils/BackoffTest.cpp \
+    common/utils/CallbackPoolTest.cpp \
     common/utils/CallbackTest.cpp \
     common/utils/ClockTest.cpp \
     common/utils/DmxBufferTest.cpp \
+    common/utils/HistogramTest.cpp \
     common/utils/MultiCallbackTest.cpp \
     common/utils/StringUtilsTest.cpp \
     common/utils/TokenBucketTest.cpp \
+    common/utils/TraceTest.cpp \
     common/utils/UtilsTest.cpp \
     common/utils/WatchdogTest.cpp
 common_utils_UtilsTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_utils_UtilsTester_LDADD = $(COMMON_TESTING_LIBS)
+
+# BENCHMARKS
+################################################
+bench_programs += common/utils/DmxBufferBenchmark
+
+common_utils_DmxBufferBenchmark_SOURCES = common/utils/DmxBufferBenchmark.cpp
+common_utils_DmxBufferBenchmark_LDADD = $(COMMON_BENCHMARK_LIBS)
@@ -0,0 +1,201 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Trace.cpp
+ * Records spans of time in per-thread ring buffers.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/util/Trace.h"
+
+#include <pthread.h>
+#include <unistd.h>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/StringUtils.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+namespace trace {
+
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+namespace {
+
+struct Span {
+  const char *category;
+  const char *name;
+  int64_t start;
+  int64_t duration;
+};
+
+/*
+ * The spans recorded by one thread. The mutex is only contended while a
+ * trace is being written.
+ */
+struct ThreadBuffer {
+  explicit ThreadBuffer(unsigned int thread_id)
+      : thread_id(thread_id),
+        spans(SPANS_PER_THREAD),
+        next(0),
+        wrapped(false) {
+  }
+
+  Mutex mutex;
+  const unsigned int thread_id;
+  string name;
+  vector<Span> spans;
+  unsigned int next;
+  bool wrapped;
+};
+
+/*
+ * The buffers of all running threads. This is never deleted, since threads
+ * may still be tracing while the program exits.
+ */
+struct Registry {
+  Registry() : next_thread_id(1) {}
+
+  Mutex mutex;
+  std::set<ThreadBuffer*> buffers;
+  unsigned int next_thread_id;
+};
+
+const MonotonicClock trace_clock;
+pthread_once_t registry_once = PTHREAD_ONCE_INIT;
+pthread_key_t buffer_key;
+Registry *registry = NULL;
+
+void DeleteThreadBuffer(void *data) {
+  ThreadBuffer *buffer = static_cast<ThreadBuffer*>(data);
+  {
+    MutexLocker locker(&registry->mutex);
+    registry->buffers.erase(buffer);
+  }
+  delete buffer;
+}
+
+void CreateRegistry() {
+  registry = new Registry();
+  pthread_key_create(&buffer_key, DeleteThreadBuffer);
+}
+
+ThreadBuffer *GetThreadBuffer() {
+  pthread_once(&registry_once, CreateRegistry);
+  ThreadBuffer *buffer = static_cast<ThreadBuffer*>(
+      pthread_getspecific(buffer_key));
+  if (!buffer) {
+    MutexLocker locker(&registry->mutex);
+    buffer = new ThreadBuffer(registry->next_thread_id++);
+    registry->buffers.insert(buffer);
+    pthread_setspecific(buffer_key, buffer);
+  }
+  return buffer;
+}
+
+void WriteSpan(std::ostream *output, unsigned int thread_id,
+               const Span &span) {
+  *output << ",\n{\"name\": \"" << span.name << "\", \"cat\": \""
+          << span.category << "\", \"ph\": \"X\", \"ts\": " << span.start
+          << ", \"dur\": " << span.duration << ", \"pid\": " << getpid()
+          << ", \"tid\": " << thread_id << "}";
+}
+}  // namespace
+
+
+ScopedTrace::ScopedTrace(const char *category, const char *name)
+    : m_category(category),
+      m_name(name),
+      m_start(Now()) {
+}
+
+
+ScopedTrace::~ScopedTrace() {
+  RecordSpan(m_category, m_name, m_start, Now() - m_start);
+}
+
+
+int64_t Now() {
+  TimeStamp now;
+  trace_clock.CurrentTime(&now);
+  return static_cast<int64_t>(now.Seconds()) * USEC_IN_SECONDS +
+         now.MicroSeconds();
+}
+
+
+void RecordSpan(const char *category, const char *name, int64_t start,
+                int64_t duration) {
+  ThreadBuffer *buffer = GetThreadBuffer();
+  MutexLocker locker(&buffer->mutex);
+  Span &span = buffer->spans[buffer->next];
+  span.category = category;
+  span.name = name;
+  span.start = start;
+  span.duration = duration;
+  if (++buffer->next == buffer->spans.size()) {
+    buffer->next = 0;
+    buffer->wrapped = true;
+  }
+}
+
+
+void SetThreadName(const string &name) {
+  ThreadBuffer *buffer = GetThreadBuffer();
+  MutexLocker locker(&buffer->mutex);
+  buffer->name = name;
+}
+
+
+void WriteChromeTrace(std::ostream *output) {
+  pthread_once(&registry_once, CreateRegistry);
+
+  *output << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n"
+          << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": "
+          << getpid() << ", \"args\": {\"name\": \"ola\"}}";
+
+  MutexLocker registry_locker(&registry->mutex);
+  std::set<ThreadBuffer*>::const_iterator iter = registry->buffers.begin();
+  for (; iter != registry->buffers.end(); ++iter) {
+    ThreadBuffer *buffer = *iter;
+    MutexLocker locker(&buffer->mutex);
+    if (!buffer->name.empty()) {
+      *output << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": "
+              << getpid() << ", \"tid\": " << buffer->thread_id
+              << ", \"args\": {\"name\": \"" << EscapeString(buffer->name)
+              << "\"}}";
+    }
+
+    // Oldest first.
+    if (buffer->wrapped) {
+      for (unsigned int i = buffer->next; i < buffer->spans.size(); i++) {
+        WriteSpan(output, buffer->thread_id, buffer->spans[i]);
+      }
+    }
+    for (unsigned int i = 0; i < buffer->next; i++) {
+      WriteSpan(output, buffer->thread_id, buffer->spans[i]);
+    }
+  }
+  *output << "\n]}\n";
+}
+}  // namespace trace
+}  // namespace ola
@@ -0,0 +1,127 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TraceTest.cpp
+ * Test fixture for the trace span recorder.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
+#include <string>
+
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Thread.h"
+#include "ola/util/Trace.h"
+
+using std::string;
+
+namespace {
+
+unsigned int CountOf(const string &haystack, const string &needle) {
+  unsigned int count = 0;
+  string::size_type pos = haystack.find(needle);
+  while (pos != string::npos) {
+    count++;
+    pos = haystack.find(needle, pos + needle.size());
+  }
+  return count;
+}
+
+/*
+ * Records spans on a new thread, so the buffer starts empty. The trace is
+ * written before the thread exits, since that discards the thread's spans.
+ */
+class WrappingThread: public ola::thread::Thread {
+ public:
+  WrappingThread()
+      : ola::thread::Thread(ola::thread::Thread::Options("trace-test")) {
+  }
+
+  void *Run() {
+    ola::trace::SetThreadName("trace \"test\"");
+    ola::trace::RecordSpan("test", "wrap-old", 1, 1);
+    for (unsigned int i = 0; i < ola::trace::SPANS_PER_THREAD; i++) {
+      ola::trace::RecordSpan("test", "wrap-new", i, 1);
+    }
+    std::ostringstream out;
+    ola::trace::WriteChromeTrace(&out);
+    m_trace = out.str();
+    return NULL;
+  }
+
+  string m_trace;
+};
+}  // namespace
+
+
+class TraceTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TraceTest);
+  CPPUNIT_TEST(testScopedTrace);
+  CPPUNIT_TEST(testWrap);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testScopedTrace();
+  void testWrap();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TraceTest);
+
+
+/*
+ * Check a ScopedTrace records a span when it goes out of scope.
+ */
+void TraceTest::testScopedTrace() {
+  int64_t start = ola::trace::Now();
+  {
+    ola::trace::ScopedTrace trace("test", "scoped-span");
+  }
+  OLA_ASSERT_TRUE(ola::trace::Now() >= start);
+
+  std::ostringstream out;
+  ola::trace::WriteChromeTrace(&out);
+  const string trace = out.str();
+  OLA_ASSERT_EQ(0u, static_cast<unsigned int>(trace.find("{")));
+  OLA_ASSERT_EQ(string("]}\n"), trace.substr(trace.size() - 3));
+  OLA_ASSERT_EQ(1u, CountOf(trace,
+                            "\"name\": \"scoped-span\", \"cat\": \"test\", "
+                            "\"ph\": \"X\""));
+}
+
+
+/*
+ * Check the oldest spans are dropped once the buffer is full.
+ */
+void TraceTest::testWrap() {
+  WrappingThread thread;
+  OLA_ASSERT_TRUE(thread.Start());
+  OLA_ASSERT_TRUE(thread.Join());
+
+  OLA_ASSERT_EQ(0u, CountOf(thread.m_trace, "wrap-old"));
+  OLA_ASSERT_EQ(ola::trace::SPANS_PER_THREAD,
+                CountOf(thread.m_trace, "\"wrap-new\""));
+  OLA_ASSERT_EQ(1u, CountOf(thread.m_trace,
+                            "\"args\": {\"name\": \"trace \\\"test\\\"\"}"));
+  // The first remaining span is the oldest.
+  OLA_ASSERT_TRUE(thread.m_trace.find("\"ts\": 0,") <
+                  thread.m_trace.find("\"ts\": 1,"));
+
+  // The thread's spans are discarded when it exits.
+  std::ostringstream out;
+  ola::trace::WriteChromeTrace(&out);
+  OLA_ASSERT_EQ(0u, CountOf(out.str(), "wrap-new"));
+}
@@ -40,7 +40,17 @@ using std::auto_ptr;
 using std::string;
 
 static bool ParseTrimmedInput(const char **input,
-                              JsonParserInterface *parser);
+                              JsonParserInterface *parser,
+                              string *scratch);
+
+/*
+ * Non-zero for the JSON whitespace characters.
+ */
+static const uint8_t WHITESPACE[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 0,  // \t \n \r
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1,  // space
+};
 
 /**
  * @brief Trim leading whitespace from a string.
@@ -52,24 +62,26 @@ static bool ParseTrimmedInput(const char **input,
  * because I think we'll need a wchar on Windows.
  */
 static bool TrimWhitespace(const char **input) {
-  while (**input != 0 &&
-         (**input == ' ' || **input == '\t' || **input == '\r' ||
-          **input == '\n')) {
-    (*input)++;
+  const char *ptr = *input;
+  while (WHITESPACE[static_cast<uint8_t>(*ptr)]) {
+    ptr++;
   }
-  return **input != 0;
+  *input = ptr;
+  return *ptr != 0;
 }
 
 /**
  * @brief Extract a string token from the input.
  * @param input A pointer to a pointer with the data. This should point to the
  * first character after the quote (") character.
- * @param str A string object to store the extracted string.
+ * @param str A string object to store the extracted string, this is cleared
+ *   first.
  * @param parser the JsonParserInterface to pass tokens to.
  * @returns true if the string was extracted correctly, false otherwise.
  */
 static bool ParseString(const char **input, string* str,
                         JsonParserInterface *parser) {
+  str->clear();
   while (true) {
     size_t size = strcspn(*input, "\"\\");
     char c = (*input)[size];
@@ -251,7 +263,8 @@ static bool ParseNumber(const char **input, JsonParserInterface *parser) {
 /**
  * Starts from the first character after the  '['.
  */
-static bool ParseArray(const char **input, JsonParserInterface *parser) {
+static bool ParseArray(const char **input, JsonParserInterface *parser,
+                       string *scratch) {
   if (!TrimWhitespace(input)) {
     parser->SetError("Unterminated array");
     return false;
@@ -271,7 +284,7 @@ static bool ParseArray(const char **input, JsonParserInterface *parser) {
       return false;
     }
 
-    bool result = ParseTrimmedInput(input, parser);
+    bool result = ParseTrimmedInput(input, parser, scratch);
     if (!result) {
       OLA_INFO << "Invalid input";
       return false;
@@ -300,7 +313,8 @@ static bool ParseArray(const char **input, JsonParserInterface *parser) {
 /**
  * Starts from the first character after the  '{'.
  */
-static bool ParseObject(const char **input, JsonParserInterface *parser) {
+static bool ParseObject(const char **input, JsonParserInterface *parser,
+                        string *scratch) {
   if (!TrimWhitespace(input)) {
     parser->SetError("Unterminated object");
     return false;
@@ -327,11 +341,10 @@ static bool ParseObject(const char **input, JsonParserInterface *parser) {
     }
     (*input)++;
 
-    string key;
-    if (!ParseString(input, &key, parser)) {
+    if (!ParseString(input, scratch, parser)) {
       return false;
     }
-    parser->ObjectKey(key);
+    parser->ObjectKey(*scratch);
 
     if (!TrimWhitespace(input)) {
       parser->SetError("Missing : after key");
@@ -349,7 +362,7 @@ static bool ParseObject(const char **input, JsonParserInterface *parser) {
       return false;
     }
 
-    bool result = ParseTrimmedInput(input, parser);
+    bool result = ParseTrimmedInput(input, parser, scratch);
     if (!result) {
       return false;
     }
@@ -374,17 +387,21 @@ static bool ParseObject(const char **input, JsonParserInterface *parser) {
   }
 }
 
+/*
+ * scratch is reused for each string in the input, which saves an allocation
+ * per string.
+ */
 static bool ParseTrimmedInput(const char **input,
-                             JsonParserInterface *parser) {
+                              JsonParserInterface *parser,
+                              string *scratch) {
   static const char TRUE_STR[] = "true";
   static const char FALSE_STR[] = "false";
   static const char NULL_STR[] = "null";
 
   if (**input == '"') {
     (*input)++;
-    string str;
-    if (ParseString(input, &str, parser)) {
-      parser->String(str);
+    if (ParseString(input, scratch, parser)) {
+      parser->String(*scratch);
       return true;
     }
     return false;
@@ -404,10 +421,10 @@ static bool ParseTrimmedInput(const char **input,
     return ParseNumber(input, parser);
   } else if (**input == '[') {
     (*input)++;
-    return ParseArray(input, parser);
+    return ParseArray(input, parser, scratch);
   } else if (**input == '{') {
     (*input)++;
-    return ParseObject(input, parser);
+    return ParseObject(input, parser, scratch);
   }
   parser->SetError("Invalid JSON value");
   return false;
@@ -421,7 +438,8 @@ bool ParseRaw(const char *input, JsonParserInterface *parser) {
   }
 
   parser->Begin();
-  bool result = ParseTrimmedInput(&input, parser);
+  string scratch;
+  bool result = ParseTrimmedInput(&input, parser, &scratch);
   if (!result) {
     return false;
   }
@@ -433,13 +451,9 @@ bool JsonLexer::Parse(const string &input,
                       JsonParserInterface *parser) {
   // TODO(simon): Do we need to convert to unicode here? I think this may be
   // an issue on Windows. Consider mbstowcs.
-  // Copying the input sucks though, so we should use input.c_str() if we can.
-  char* input_data = new char[input.size() + 1];
-  strncpy(input_data, input.c_str(), input.size() + 1);
-
-  bool result = ParseRaw(input_data, parser);
-  delete[] input_data;
-  return result;
+  // c_str() is NUL terminated, which is all the lexer needs. Like the copy
+  // we used to make, parsing stops at the first NUL.
+  return ParseRaw(input.c_str(), parser);
 }
 }  // namespace web
 }  // namespace ola
@@ -40,6 +40,33 @@ using std::set;
 using std::string;
 using std::vector;
 
+namespace {
+
+/*
+ * Adds the value of a JsonString to a set, so the string enums can be checked
+ * with a lookup.
+ */
+class StringEnumCollector : public JsonValueConstVisitorInterface {
+ public:
+  explicit StringEnumCollector(set<string> *strings) : m_strings(strings) {}
+
+  void Visit(const JsonString &value) { m_strings->insert(value.Value()); }
+  void Visit(const JsonBool &) {}
+  void Visit(const JsonNull &) {}
+  void Visit(const JsonRawValue &) {}
+  void Visit(const JsonObject &) {}
+  void Visit(const JsonArray &) {}
+  void Visit(const JsonUInt &) {}
+  void Visit(const JsonUInt64 &) {}
+  void Visit(const JsonInt &) {}
+  void Visit(const JsonInt64 &) {}
+  void Visit(const JsonDouble &) {}
+
+ private:
+  set<string> *m_strings;
+};
+}  // namespace
+
 // BaseValidator
 // -----------------------------------------------------------------------------
 BaseValidator::~BaseValidator() {
@@ -106,6 +133,14 @@ const JsonValue *BaseValidator::GetDefaultValue() const {
 
 void BaseValidator::AddEnumValue(const JsonValue *value) {
   m_enums.push_back(value);
+
+  StringEnumCollector collector(&m_string_enums);
+  value->Accept(&collector);
+}
+
+bool BaseValidator::CheckEnums(const JsonString &value) {
+  // A string can only be equal to one of the string enums.
+  return m_enums.empty() || STLContains(m_string_enums, value.Value());
 }
 
 bool BaseValidator::CheckEnums(const JsonValue &value) {
@@ -334,14 +369,11 @@ void ObjectValidator::Visit(const JsonObject &obj) {
   m_seen_properties.clear();
   obj.VisitProperties(this);
 
-  StringSet missing_properties;
-  std::set_difference(m_options.required_properties.begin(),
-                      m_options.required_properties.end(),
-                      m_seen_properties.begin(),
-                      m_seen_properties.end(),
-                      std::inserter(missing_properties,
-                                    missing_properties.end()));
-  if (!missing_properties.empty()) {
+  // Both sets are sorted, so this doesn't need to build the set of missing
+  // properties.
+  if (!std::includes(m_seen_properties.begin(), m_seen_properties.end(),
+                     m_options.required_properties.begin(),
+                     m_options.required_properties.end())) {
     m_is_valid = false;
   }
 
@@ -467,7 +499,9 @@ ArrayValidator::ArrayValidator(Items *items, AdditionalItems *additional_items,
     m_items(items),
     m_additional_items(additional_items),
     m_options(options),
-    m_wildcard_validator(new WildcardValidator()) {
+    m_wildcard_validator(new WildcardValidator()),
+    m_default_item_validator(NULL) {
+  SetupItemValidators();
 }
 
 ArrayValidator::~ArrayValidator() {}
@@ -491,19 +525,21 @@ void ArrayValidator::Visit(const JsonArray &array) {
   }
 
 
-  auto_ptr<ArrayElementValidator> element_validator(
-      ConstructElementValidator());
-
   for (unsigned int i = 0; i < array.Size(); i++) {
-    array.ElementAt(i)->Accept(element_validator.get());
-    if (!element_validator->IsValid()) {
-      break;
+    ValidatorInterface *validator = i < m_item_validators.size() ?
+        m_item_validators[i] : m_default_item_validator;
+    if (!validator) {
+      // additional items aren't allowed
+      m_is_valid = false;
+      return;
+    }
+    array.ElementAt(i)->Accept(validator);
+    if (!validator->IsValid()) {
+      m_is_valid = false;
+      return;
     }
   }
-  m_is_valid = element_validator->IsValid();
-  if (!m_is_valid) {
-    return;
-  }
+  m_is_valid = true;
 
   if (m_options.unique_items) {
     for (unsigned int i = 0; i < array.Size(); i++) {
@@ -561,116 +597,35 @@ void ArrayValidator::ExtendSchema(JsonObject *schema) const {
   }
 }
 
-// TODO(simon): do this once at construction, rather than on every visit?
-ArrayValidator::ArrayElementValidator*
-    ArrayValidator::ConstructElementValidator() const {
-  if (m_items.get()) {
-    if (m_items->Validator()) {
-      // 8.2.3.1, items is an object.
-      ValidatorList empty_validators;
-      return new ArrayElementValidator(empty_validators, m_items->Validator());
-    } else {
-      // 8.2.3.3, items is an array.
-      const ValidatorList &validators = m_items->Validators();
-      ValidatorInterface *default_validator = NULL;
-
-      // Check to see if additionalItems it defined.
-      if (m_additional_items.get()) {
-        if (m_additional_items->Validator()) {
-          // additionalItems is an object
-          default_validator = m_additional_items->Validator();
-        } else if (m_additional_items->AllowAdditional()) {
-          // additionalItems is a bool, and true
-          default_validator = m_wildcard_validator.get();
-        }
-      } else {
-        // additionalItems not provided, so it defaults to the empty schema
-        // (wildcard).
-        default_validator = m_wildcard_validator.get();
-      }
-      return new ArrayElementValidator(validators, default_validator);
-    }
-  } else {
+/*
+ * Work out which validator applies to each element.
+ */
+void ArrayValidator::SetupItemValidators() {
+  if (!m_items.get()) {
     // no items, therefore it defaults to the empty (wildcard) schema.
-    ValidatorList empty_validators;
-    return new ArrayElementValidator(
-        empty_validators, m_wildcard_validator.get());
-  }
-}
-
-// ArrayValidator::ArrayElementValidator
-// -----------------------------------------------------------------------------
-ArrayValidator::ArrayElementValidator::ArrayElementValidator(
-    const ValidatorList &validators,
-    ValidatorInterface *default_validator)
-    : BaseValidator(JSON_UNDEFINED),
-      m_item_validators(validators.begin(), validators.end()),
-      m_default_validator(default_validator) {
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(
-    const JsonString &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(const JsonBool &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(const JsonNull &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(const JsonRawValue &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(const JsonObject &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(const JsonArray &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(const JsonUInt &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(
-    const JsonUInt64 &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(const JsonInt &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(const JsonInt64 &value) {
-  ValidateItem(value);
-}
-
-void ArrayValidator::ArrayElementValidator::Visit(
-    const JsonDouble &value) {
-  ValidateItem(value);
-}
-
-template <typename T>
-void ArrayValidator::ArrayElementValidator::ValidateItem(const T &item) {
-  ValidatorInterface *validator = NULL;
-
-  if (!m_item_validators.empty()) {
-    validator = m_item_validators.front();
-    m_item_validators.pop_front();
-  } else if (!m_default_validator) {
-    // additional items aren't allowed
-    m_is_valid = false;
-    return;
+    m_default_item_validator = m_wildcard_validator.get();
+  } else if (m_items->Validator()) {
+    // 8.2.3.1, items is an object.
+    m_default_item_validator = m_items->Validator();
   } else {
-    validator = m_default_validator;
+    // 8.2.3.3, items is an array.
+    m_item_validators = m_items->Validators();
+
+    // Check to see if additionalItems it defined.
+    if (m_additional_items.get()) {
+      if (m_additional_items->Validator()) {
+        // additionalItems is an object
+        m_default_item_validator = m_additional_items->Validator();
+      } else if (m_additional_items->AllowAdditional()) {
+        // additionalItems is a bool, and true
+        m_default_item_validator = m_wildcard_validator.get();
+      }
+    } else {
+      // additionalItems not provided, so it defaults to the empty schema
+      // (wildcard).
+      m_default_item_validator = m_wildcard_validator.get();
+    }
   }
-  item.Accept(validator);
-  m_is_valid = validator->IsValid();
 }
 
 // ConjunctionValidator
@@ -0,0 +1,195 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonStreamWriter.cpp
+ * Write JSON text without building a tree of JsonValues.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ctype.h>
+#include <string>
+
+#include "ola/web/JsonStreamWriter.h"
+
+namespace ola {
+namespace web {
+
+using std::string;
+
+JsonStreamWriter::JsonStreamWriter()
+    : m_after_key(false) {
+}
+
+void JsonStreamWriter::StartObject() {
+  StartValue();
+  m_output.push_back('{');
+  m_has_values.push_back(false);
+}
+
+void JsonStreamWriter::StartObject(const string &key) {
+  Key(key);
+  StartObject();
+}
+
+void JsonStreamWriter::EndObject() {
+  m_output.push_back('}');
+  m_has_values.pop_back();
+}
+
+void JsonStreamWriter::StartArray() {
+  StartValue();
+  m_output.push_back('[');
+  m_has_values.push_back(false);
+}
+
+void JsonStreamWriter::StartArray(const string &key) {
+  Key(key);
+  StartArray();
+}
+
+void JsonStreamWriter::EndArray() {
+  m_output.push_back(']');
+  m_has_values.pop_back();
+}
+
+void JsonStreamWriter::Key(const string &key) {
+  StartValue();
+  WriteString(key);
+  m_output.push_back(':');
+  m_after_key = true;
+}
+
+void JsonStreamWriter::Value(const string &value) {
+  StartValue();
+  WriteString(value);
+}
+
+void JsonStreamWriter::Value(const char *value) {
+  StartValue();
+  WriteString(value);
+}
+
+void JsonStreamWriter::Value(bool value) {
+  StartValue();
+  m_output.append(value ? "true" : "false");
+}
+
+void JsonStreamWriter::Value(int value) {
+  Value(static_cast<int64_t>(value));
+}
+
+void JsonStreamWriter::Value(unsigned int value) {
+  StartValue();
+  WriteUnsigned(value, false);
+}
+
+void JsonStreamWriter::Value(int64_t value) {
+  StartValue();
+  if (value < 0) {
+    // Negate as unsigned so INT64_MIN doesn't overflow.
+    WriteUnsigned(~static_cast<uint64_t>(value) + 1, true);
+  } else {
+    WriteUnsigned(value, false);
+  }
+}
+
+void JsonStreamWriter::Value(uint64_t value) {
+  StartValue();
+  WriteUnsigned(value, false);
+}
+
+void JsonStreamWriter::Null() {
+  StartValue();
+  m_output.append("null");
+}
+
+void JsonStreamWriter::Raw(const string &value) {
+  StartValue();
+  m_output.append(value);
+}
+
+void JsonStreamWriter::Reset() {
+  m_output.clear();
+  m_has_values.clear();
+  m_after_key = false;
+}
+
+/*
+ * Add the separator if this isn't the first value in an object or array. The
+ * value after a key never needs one.
+ */
+void JsonStreamWriter::StartValue() {
+  if (m_after_key) {
+    m_after_key = false;
+    return;
+  }
+  if (m_has_values.empty()) {
+    return;
+  }
+  if (m_has_values.back()) {
+    m_output.push_back(',');
+  } else {
+    m_has_values.back() = true;
+  }
+}
+
+/*
+ * This matches EscapeString(EncodeString(value)), which JsonWriter uses, but
+ * without the temporary strings. Runs of characters that don't need escaping
+ * are appended in one go.
+ */
+void JsonStreamWriter::WriteString(const string &value) {
+  static const char HEX_DIGITS[] = "0123456789abcdef";
+
+  m_output.push_back('"');
+  const char *run = value.data();
+  const char *end = value.data() + value.size();
+  for (const char *ptr = run; ptr != end; ++ptr) {
+    const char c = *ptr;
+    const bool printable = isprint(static_cast<unsigned char>(c));
+    if (printable && c != '"' && c != '\\' && c != '/') {
+      continue;
+    }
+    m_output.append(run, ptr - run);
+    run = ptr + 1;
+    if (printable) {
+      m_output.push_back('\\');
+      m_output.push_back(c);
+    } else {
+      const uint8_t byte = static_cast<uint8_t>(c);
+      m_output.append("\\\\x");
+      m_output.push_back(HEX_DIGITS[byte >> 4]);
+      m_output.push_back(HEX_DIGITS[byte & 0x0f]);
+    }
+  }
+  m_output.append(run, end - run);
+  m_output.push_back('"');
+}
+
+void JsonStreamWriter::WriteUnsigned(uint64_t value, bool negative) {
+  // 20 digits for UINT64_MAX, plus the sign.
+  char buffer[21];
+  char *ptr = buffer + sizeof(buffer);
+  do {
+    *--ptr = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value);
+  if (negative) {
+    *--ptr = '-';
+  }
+  m_output.append(ptr, buffer + sizeof(buffer) - ptr);
+}
+}  // namespace web
+}  // namespace ola
@@ -0,0 +1,152 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonStreamWriterTest.cpp
+ * Unittest for the JsonStreamWriter class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <string>
+
+#include "ola/testing/TestUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonStreamWriter.h"
+#include "ola/web/JsonWriter.h"
+
+using ola::web::JsonStreamWriter;
+using ola::web::JsonString;
+using ola::web::JsonWriter;
+using std::string;
+
+class JsonStreamWriterTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(JsonStreamWriterTest);
+  CPPUNIT_TEST(testValues);
+  CPPUNIT_TEST(testIntegers);
+  CPPUNIT_TEST(testEscaping);
+  CPPUNIT_TEST(testNesting);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testValues();
+  void testIntegers();
+  void testEscaping();
+  void testNesting();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JsonStreamWriterTest);
+
+
+/*
+ * Test the simple values.
+ */
+void JsonStreamWriterTest::testValues() {
+  JsonStreamWriter writer;
+  writer.StartArray();
+  writer.Value("foo");
+  writer.Value(string("bar"));
+  writer.Value(true);
+  writer.Value(false);
+  writer.Null();
+  writer.Raw("[1,2]");
+  writer.EndArray();
+  OLA_ASSERT_EQ(string("[\"foo\",\"bar\",true,false,null,[1,2]]"),
+                writer.AsString());
+
+  writer.Reset();
+  OLA_ASSERT_EQ(string(""), writer.AsString());
+  writer.Value(1u);
+  OLA_ASSERT_EQ(string("1"), writer.AsString());
+}
+
+
+/*
+ * Test the integer types, including the limits.
+ */
+void JsonStreamWriterTest::testIntegers() {
+  JsonStreamWriter writer;
+  writer.StartArray();
+  writer.Value(0);
+  writer.Value(-10);
+  writer.Value(10u);
+  writer.Value(static_cast<int64_t>(INT64_MIN));
+  writer.Value(static_cast<int64_t>(INT64_MAX));
+  writer.Value(static_cast<uint64_t>(UINT64_MAX));
+  writer.Value(static_cast<uint16_t>(65535));
+  writer.EndArray();
+  OLA_ASSERT_EQ(string("[0,-10,10,-9223372036854775808,9223372036854775807,"
+                       "18446744073709551615,65535]"),
+                writer.AsString());
+}
+
+
+/*
+ * Check strings are escaped the same way as JsonWriter.
+ */
+void JsonStreamWriterTest::testEscaping() {
+  const string inputs[] = {
+    "",
+    "foo\"bar\"",
+    "a\\b/c",
+    "line\nbreak\ttab",
+    "\x01\x7f\xff",
+  };
+
+  for (unsigned int i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+    JsonStreamWriter writer;
+    writer.Value(inputs[i]);
+    OLA_ASSERT_EQ(JsonWriter::AsString(JsonString(inputs[i])),
+                  writer.AsString());
+  }
+
+  // Keys are escaped too
+  JsonStreamWriter writer;
+  writer.StartObject();
+  writer.Add("a\"b", 1);
+  writer.EndObject();
+  OLA_ASSERT_EQ(string("{\"a\\\"b\":1}"), writer.AsString());
+}
+
+
+/*
+ * Test nested objects & arrays.
+ */
+void JsonStreamWriterTest::testNesting() {
+  JsonStreamWriter writer;
+  writer.StartObject();
+  writer.Add("universe", 1);
+  writer.StartArray("uids");
+  for (unsigned int i = 0; i < 2; i++) {
+    writer.StartObject();
+    writer.Add("device_id", i);
+    writer.Add("manufacturer", "Open Lighting");
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.StartArray("empty");
+  writer.EndArray();
+  writer.StartObject("object");
+  writer.EndObject();
+  writer.Add("ok", true);
+  writer.EndObject();
+
+  OLA_ASSERT_EQ(
+      string("{\"universe\":1,\"uids\":["
+             "{\"device_id\":0,\"manufacturer\":\"Open Lighting\"},"
+             "{\"device_id\":1,\"manufacturer\":\"Open Lighting\"}],"
+             "\"empty\":[],\"object\":{},\"ok\":true}"),
+      writer.AsString());
+}
@@ -26,6 +26,7 @@ common_web_libolaweb_la_SOURCES = \
     common/web/JsonPointer.cpp \
     common/web/JsonSchema.cpp \
     common/web/JsonSections.cpp \
+    common/web/JsonStreamWriter.cpp \
     common/web/JsonTypes.cpp \
     common/web/JsonWriter.cpp \
     common/web/PointerTracker.cpp \
@@ -49,6 +50,7 @@ endif
 # Patch test names are abbreviated to prevent Windows' UAC from blocking them.
 test_programs += \
     common/web/JsonTester \
+    common/web/JsonStreamWriterTester \
     common/web/ParserTester \
     common/web/PtchParserTester \
     common/web/PtchTester \
@@ -65,6 +67,11 @@ common_web_JsonTester_SOURCES = common/web/JsonTest.cpp
 common_web_JsonTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_web_JsonTester_LDADD = $(COMMON_WEB_TEST_LDADD)
 
+common_web_JsonStreamWriterTester_SOURCES = \
+    common/web/JsonStreamWriterTest.cpp
+common_web_JsonStreamWriterTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_web_JsonStreamWriterTester_LDADD = $(COMMON_WEB_TEST_LDADD)
+
 common_web_ParserTester_SOURCES = common/web/ParserTest.cpp
 common_web_ParserTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_web_ParserTester_LDADD = $(COMMON_WEB_TEST_LDADD)
@@ -357,6 +357,15 @@ void JsonParserTest::testObject() {
   OLA_ASSERT_EQ(string("{\n  \"key1\": 1,\n  \"key2\": [1, 2]\n}"),
                 JsonWriter::AsString(*value.get()));
 
+  // All the whitespace characters, and string keys & values
+  value.reset(JsonParser::Parse(
+        "\t{\r\n\"name\" :\t\"foo\",\n \"other\": \"a longer string\"}\r\n",
+        &error));
+  OLA_ASSERT_NOT_NULL(value.get());
+  OLA_ASSERT_EQ(
+      string("{\n  \"name\": \"foo\",\n  \"other\": \"a longer string\"\n}"),
+      JsonWriter::AsString(*value.get()));
+
   // double key test
   value.reset(JsonParser::Parse("{\"key\"  : 1, \"key\"  : 2} ", &error));
   OLA_ASSERT_NOT_NULL(value.get());
@@ -831,6 +831,12 @@ void JsonSchemaTest::testEnums() {
   baz_value.Accept(&string_validator);
   OLA_ASSERT_FALSE(string_validator.IsValid());
 
+  // A string never matches a non-string enum
+  StringValidator int_enum_validator((StringValidator::Options()));
+  int_enum_validator.AddEnumValue(new JsonInt(1));
+  bar_value.Accept(&int_enum_validator);
+  OLA_ASSERT_FALSE(int_enum_validator.IsValid());
+
   IntegerValidator integer_validator;
   integer_validator.AddEnumValue(new JsonInt(1));
   integer_validator.AddEnumValue(new JsonInt(2));
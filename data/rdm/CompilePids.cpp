@@ -0,0 +1,53 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * CompilePids.cpp
+ * Compiles the PID data files into the binary store loaded by olad.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/Logging.h>
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+#include <ola/file/Util.h>
+#include <string>
+
+#include "common/rdm/PidStoreLoader.h"
+
+using ola::rdm::PidStoreLoader;
+using std::string;
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "<pid_directory> [output_file]",
+               "Compile the PID data in a directory, so it loads without "
+               "parsing the text files. The output defaults to the compiled "
+               "store in the directory.");
+
+  if (argc < 2 || argc > 3) {
+    ola::DisplayUsageAndExit();
+  }
+
+  const string directory = argv[1];
+  const string output_file = argc == 3 ? argv[2] :
+      ola::file::JoinPaths(directory, PidStoreLoader::COMPILED_FILE_NAME);
+
+  PidStoreLoader loader;
+  if (!loader.CompileDirectory(directory, output_file)) {
+    OLA_FATAL << "Failed to compile " << directory;
+    return ola::EXIT_DATAERR;
+  }
+  return ola::EXIT_OK;
+}
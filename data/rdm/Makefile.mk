@@ -5,6 +5,23 @@ dist_piddata_DATA = \
     data/rdm/pids.proto \
     data/rdm/manufacturer_pids.proto
 
+# The compiled PID store, which is loaded in place of the text files. It's
+# skipped when cross-compiling, unless --with-ola-compile-pids is given, and
+# the text files are loaded instead.
+if BUILD_COMPILED_PIDS
+nodist_piddata_DATA = data/rdm/compiled_pids.bin
+CLEANFILES += data/rdm/compiled_pids.bin
+
+data/rdm/compiled_pids.bin: $(OLA_COMPILE_PIDS_DEP) $(dist_piddata_DATA)
+	$(OLA_COMPILE_PIDS) $(srcdir)/data/rdm $@
+endif
+
+# PROGRAMS
+################################################
+noinst_PROGRAMS += data/rdm/ola_compile_pids
+data_rdm_ola_compile_pids_SOURCES = data/rdm/CompilePids.cpp
+data_rdm_ola_compile_pids_LDADD = common/libolacommon.la
+
 # SCRIPTS
 ################################################
 dist_noinst_SCRIPTS += \
@@ -0,0 +1,538 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BinaryShow.cpp
+ * Read and write the binary show format.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "examples/BinaryShow.h"
+
+using ola::DmxBuffer;
+using std::string;
+
+const char BinaryShow::MAGIC[] = "OLASHOWB";
+
+namespace {
+
+// A literal run holds up to 128 slots, a repeat up to 130.
+const unsigned int MAX_LITERAL = 128;
+const unsigned int MIN_REPEAT = 3;
+const unsigned int MAX_REPEAT = 130;
+const uint8_t REPEAT_FLAG = 0x80;
+const uint8_t REPEAT_BIAS = 0x7d;
+// Changes separated by fewer unchanged slots than this are merged, since
+// each change has a 3 byte header.
+const unsigned int DELTA_GAP = 3;
+const unsigned int MAX_DELTA_LENGTH = 255;
+
+void PushUInt8(uint8_t value, string *output) {
+  output->push_back(static_cast<char>(value));
+}
+
+void PushUInt16(uint16_t value, string *output) {
+  PushUInt8(value >> 8, output);
+  PushUInt8(value & 0xff, output);
+}
+
+void PushUInt32(uint32_t value, string *output) {
+  PushUInt16(value >> 16, output);
+  PushUInt16(value & 0xffff, output);
+}
+
+void PushUInt64(uint64_t value, string *output) {
+  PushUInt32(value >> 32, output);
+  PushUInt32(value & 0xffffffff, output);
+}
+
+uint16_t ReadUInt16(const uint8_t *data) {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+uint32_t ReadUInt32(const uint8_t *data) {
+  return (static_cast<uint32_t>(ReadUInt16(data)) << 16) |
+         ReadUInt16(data + 2);
+}
+
+uint64_t ReadUInt64(const uint8_t *data) {
+  return (static_cast<uint64_t>(ReadUInt32(data)) << 32) |
+         ReadUInt32(data + 4);
+}
+
+/*
+ * Run length encode the slot data.
+ */
+void EncodeFull(const uint8_t *data, unsigned int size, string *output) {
+  unsigned int i = 0;
+  while (i < size) {
+    unsigned int run = 1;
+    while (i + run < size && run < MAX_REPEAT && data[i + run] == data[i]) {
+      run++;
+    }
+    if (run >= MIN_REPEAT) {
+      PushUInt8(REPEAT_BIAS + run, output);
+      PushUInt8(data[i], output);
+      i += run;
+      continue;
+    }
+
+    // Copy slots until the next repeat starts.
+    const unsigned int start = i;
+    while (i < size && i - start < MAX_LITERAL) {
+      if (i + 2 < size && data[i] == data[i + 1] && data[i] == data[i + 2]) {
+        break;
+      }
+      i++;
+    }
+    PushUInt8(i - start - 1, output);
+    output->append(reinterpret_cast<const char*>(data + start), i - start);
+  }
+}
+
+bool DecodeFull(const uint8_t *payload, unsigned int length, uint8_t *slots,
+                unsigned int size) {
+  unsigned int i = 0;
+  unsigned int slot = 0;
+  while (i < length) {
+    const uint8_t control = payload[i++];
+    if (control & REPEAT_FLAG) {
+      const unsigned int run = control - REPEAT_BIAS;
+      if (i >= length || slot + run > size) {
+        return false;
+      }
+      memset(slots + slot, payload[i++], run);
+      slot += run;
+    } else {
+      const unsigned int run = control + 1;
+      if (i + run > length || slot + run > size) {
+        return false;
+      }
+      memcpy(slots + slot, payload + i, run);
+      i += run;
+      slot += run;
+    }
+  }
+  return slot == size;
+}
+
+/*
+ * Encode the slots that differ from the previous frame, both frames must be
+ * the same size.
+ */
+void EncodeDelta(const uint8_t *previous, const uint8_t *data,
+                 unsigned int size, string *output) {
+  unsigned int i = 0;
+  while (i < size) {
+    if (previous[i] == data[i]) {
+      i++;
+      continue;
+    }
+
+    const unsigned int start = i;
+    unsigned int end = i + 1;
+    for (unsigned int j = end; j < size && j - start < MAX_DELTA_LENGTH; j++) {
+      if (previous[j] != data[j]) {
+        end = j + 1;
+      } else if (j - end >= DELTA_GAP) {
+        break;
+      }
+    }
+    PushUInt16(start, output);
+    PushUInt8(end - start, output);
+    output->append(reinterpret_cast<const char*>(data + start), end - start);
+    i = end;
+  }
+}
+
+bool DecodeDelta(const uint8_t *payload, unsigned int length, uint8_t *slots,
+                 unsigned int size) {
+  unsigned int i = 0;
+  while (i < length) {
+    if (i + 3 > length) {
+      return false;
+    }
+    const unsigned int offset = ReadUInt16(payload + i);
+    const unsigned int run = payload[i + 2];
+    i += 3;
+    if (i + run > length || offset + run > size) {
+      return false;
+    }
+    memcpy(slots + offset, payload + i, run);
+    i += run;
+  }
+  return true;
+}
+
+void BuildHeader(uint32_t frame_count, uint64_t index_offset,
+                 uint32_t duration, string *header) {
+  header->assign(BinaryShow::MAGIC, BinaryShow::MAGIC_SIZE);
+  PushUInt16(BinaryShow::VERSION, header);
+  PushUInt16(0, header);
+  PushUInt32(frame_count, header);
+  PushUInt64(index_offset, header);
+  PushUInt32(duration, header);
+  PushUInt32(0, header);
+}
+}  // namespace
+
+
+BinaryShowWriter::BinaryShowWriter(const string &filename)
+    : m_filename(filename),
+      m_last_time(0),
+      m_frame_count(0),
+      m_offset(0) {
+}
+
+
+BinaryShowWriter::~BinaryShowWriter() {
+  Close();
+}
+
+
+bool BinaryShowWriter::Open() {
+  m_show_file.open(m_filename.data(),
+                   std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_show_file.is_open()) {
+    OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  // The header is rewritten by Close(), once the index has been written.
+  string header;
+  BuildHeader(0, 0, 0, &header);
+  m_offset = 0;
+  return Write(header);
+}
+
+
+void BinaryShowWriter::Close() {
+  if (!m_show_file.is_open()) {
+    return;
+  }
+
+  const uint64_t index_offset = m_offset;
+  string index;
+  PushUInt32(m_index.size(), &index);
+  Index::const_iterator iter = m_index.begin();
+  for (; iter != m_index.end(); ++iter) {
+    PushUInt32(iter->first, &index);
+    PushUInt64(iter->second, &index);
+  }
+  Write(index);
+
+  string header;
+  BuildHeader(m_frame_count, index_offset, m_last_time, &header);
+  m_show_file.seekp(0);
+  m_show_file.write(header.data(), header.size());
+  m_show_file.close();
+}
+
+
+bool BinaryShowWriter::NewFrame(const ola::TimeStamp &arrival_time,
+                                unsigned int universe,
+                                const DmxBuffer &data) {
+  if (!m_start.IsSet()) {
+    m_start = arrival_time;
+  }
+  const int64_t time = (arrival_time - m_start).InMilliSeconds();
+  if (time > 0) {
+    m_last_time = std::max(m_last_time, static_cast<uint32_t>(time));
+  }
+
+  if (m_index.empty() ||
+      m_last_time >= m_index.back().first + BinaryShow::INDEX_INTERVAL_MS) {
+    // Start again with full frames, so playback can start here.
+    m_index.push_back(std::make_pair(m_last_time, m_offset));
+    m_last_frames.clear();
+  }
+
+  m_payload.clear();
+  BinaryShow::FrameType type = BinaryShow::FULL_FRAME;
+  DmxBuffer *previous = NULL;
+  UniverseFrames::iterator iter = m_last_frames.find(universe);
+  if (iter != m_last_frames.end()) {
+    previous = &iter->second;
+  }
+
+  if (previous && previous->Size() == data.Size()) {
+    EncodeDelta(previous->GetRaw(), data.GetRaw(), data.Size(), &m_payload);
+    type = BinaryShow::DELTA_FRAME;
+  }
+
+  string full;
+  if (type == BinaryShow::FULL_FRAME || m_payload.size() > data.Size() / 2) {
+    EncodeFull(data.GetRaw(), data.Size(), &full);
+    if (type == BinaryShow::FULL_FRAME || full.size() < m_payload.size()) {
+      m_payload.swap(full);
+      type = BinaryShow::FULL_FRAME;
+    }
+  }
+
+  string frame;
+  PushUInt32(m_last_time, &frame);
+  PushUInt32(universe, &frame);
+  PushUInt8(type, &frame);
+  PushUInt16(data.Size(), &frame);
+  PushUInt16(m_payload.size(), &frame);
+  frame.append(m_payload);
+
+  if (previous) {
+    previous->Set(data);
+  } else {
+    m_last_frames[universe] = data;
+  }
+  m_frame_count++;
+  return Write(frame);
+}
+
+
+bool BinaryShowWriter::Write(const string &data) {
+  m_show_file.write(data.data(), data.size());
+  m_offset += data.size();
+  if (!m_show_file.good()) {
+    OLA_WARN << "Failed to write to " << m_filename;
+    return false;
+  }
+  return true;
+}
+
+
+BinaryShowReader::BinaryShowReader(const string &filename)
+    : m_filename(filename),
+      m_data(NULL),
+      m_size(0),
+      m_frames_end(0),
+      m_offset(0),
+      m_frame_count(0),
+      m_duration(0),
+      m_frame_time(0) {
+}
+
+
+BinaryShowReader::~BinaryShowReader() {
+  Unmap();
+}
+
+
+bool BinaryShowReader::Load() {
+  int fd = open(m_filename.data(), O_RDONLY);
+  if (fd < 0) {
+    OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat)) {
+    OLA_WARN << "Failed to stat " << m_filename << ": " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  m_size = file_stat.st_size;
+  if (m_size < BinaryShow::HEADER_SIZE) {
+    OLA_WARN << m_filename << " is too short to be a show file";
+    close(fd);
+    return false;
+  }
+
+  void *data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    OLA_WARN << "Failed to map " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+  m_data = reinterpret_cast<const uint8_t*>(data);
+
+  if (memcmp(m_data, BinaryShow::MAGIC, BinaryShow::MAGIC_SIZE)) {
+    OLA_WARN << "Invalid show file, expecting " << BinaryShow::MAGIC;
+    Unmap();
+    return false;
+  }
+
+  const uint16_t version = ReadUInt16(m_data + 8);
+  if (version != BinaryShow::VERSION) {
+    OLA_WARN << "Unknown show file version " << version;
+    Unmap();
+    return false;
+  }
+
+  m_frame_count = ReadUInt32(m_data + 12);
+  m_duration = ReadUInt32(m_data + 24);
+  if (!LoadIndex(ReadUInt64(m_data + 16))) {
+    // The recording wasn't closed, seeks will decode from the start.
+    OLA_WARN << m_filename << " has no index";
+    m_frames_end = m_size;
+    m_index.clear();
+  }
+  if (m_index.empty()) {
+    m_index.push_back(std::make_pair(0, BinaryShow::HEADER_SIZE));
+  }
+  Reset();
+  return true;
+}
+
+
+void BinaryShowReader::Reset() {
+  m_offset = BinaryShow::HEADER_SIZE;
+  m_frame_time = 0;
+  m_frames.clear();
+}
+
+
+ShowLoader::State BinaryShowReader::NextTimeout(unsigned int *timeout) {
+  if (m_offset >= m_frames_end) {
+    return ShowLoader::END_OF_FILE;
+  }
+  if (m_offset + BinaryShow::FRAME_HEADER_SIZE > m_frames_end) {
+    OLA_WARN << "Truncated frame at offset " << m_offset;
+    return ShowLoader::INVALID_LINE;
+  }
+
+  const uint32_t next_time = ReadUInt32(m_data + m_offset);
+  if (next_time < m_frame_time) {
+    OLA_WARN << "Frame at offset " << m_offset << " is out of order";
+    return ShowLoader::INVALID_LINE;
+  }
+  *timeout = next_time - m_frame_time;
+  return ShowLoader::OK;
+}
+
+
+ShowLoader::State BinaryShowReader::NextFrame(unsigned int *universe,
+                                              DmxBuffer *data) {
+  return ReadFrame(&m_frame_time, universe, data);
+}
+
+
+bool BinaryShowReader::Seek(unsigned int offset_ms) {
+  // Find the last index entry at or before the offset.
+  Index::const_iterator iter = m_index.begin();
+  Index::const_iterator entry = iter;
+  for (; iter != m_index.end() && iter->first <= offset_ms; ++iter) {
+    entry = iter;
+  }
+
+  m_frames.clear();
+  m_offset = entry->second;
+  m_frame_time = entry->first;
+
+  // Decode the frames before the offset, so the deltas after it apply.
+  while (m_offset + BinaryShow::FRAME_HEADER_SIZE <= m_frames_end &&
+         ReadUInt32(m_data + m_offset) < offset_ms) {
+    unsigned int universe;
+    DmxBuffer data;
+    if (ReadFrame(&m_frame_time, &universe, &data) != ShowLoader::OK) {
+      return false;
+    }
+  }
+  return m_offset < m_frames_end;
+}
+
+
+bool BinaryShowReader::LoadIndex(uint64_t index_offset) {
+  if (index_offset < BinaryShow::HEADER_SIZE || index_offset + 4 > m_size) {
+    return false;
+  }
+
+  const uint32_t entries = ReadUInt32(m_data + index_offset);
+  if (index_offset + 4 + static_cast<uint64_t>(entries) *
+      BinaryShow::INDEX_ENTRY_SIZE > m_size) {
+    return false;
+  }
+
+  m_index.clear();
+  const uint8_t *entry = m_data + index_offset + 4;
+  for (uint32_t i = 0; i < entries; i++) {
+    const uint32_t time = ReadUInt32(entry);
+    const uint64_t offset = ReadUInt64(entry + 4);
+    if (offset < BinaryShow::HEADER_SIZE || offset > index_offset) {
+      return false;
+    }
+    m_index.push_back(std::make_pair(time, offset));
+    entry += BinaryShow::INDEX_ENTRY_SIZE;
+  }
+  m_frames_end = index_offset;
+  return true;
+}
+
+
+ShowLoader::State BinaryShowReader::ReadFrame(uint32_t *time,
+                                              unsigned int *universe,
+                                              DmxBuffer *data) {
+  if (m_offset >= m_frames_end) {
+    return ShowLoader::END_OF_FILE;
+  }
+  if (m_offset + BinaryShow::FRAME_HEADER_SIZE > m_frames_end) {
+    OLA_WARN << "Truncated frame at offset " << m_offset;
+    return ShowLoader::INVALID_LINE;
+  }
+
+  const uint8_t *header = m_data + m_offset;
+  const uint8_t type = header[8];
+  const unsigned int size = ReadUInt16(header + 9);
+  const unsigned int length = ReadUInt16(header + 11);
+  const uint8_t *payload = header + BinaryShow::FRAME_HEADER_SIZE;
+  if (m_offset + BinaryShow::FRAME_HEADER_SIZE + length > m_frames_end ||
+      size > ola::DMX_UNIVERSE_SIZE) {
+    OLA_WARN << "Invalid frame at offset " << m_offset;
+    return ShowLoader::INVALID_LINE;
+  }
+
+  *universe = ReadUInt32(header + 4);
+  uint8_t slots[ola::DMX_UNIVERSE_SIZE];
+  bool ok = false;
+  if (type == BinaryShow::FULL_FRAME) {
+    ok = DecodeFull(payload, length, slots, size);
+  } else if (type == BinaryShow::DELTA_FRAME) {
+    UniverseFrames::const_iterator iter = m_frames.find(*universe);
+    if (iter != m_frames.end() && iter->second.Size() == size) {
+      memcpy(slots, iter->second.GetRaw(), size);
+      ok = DecodeDelta(payload, length, slots, size);
+    }
+  }
+  if (!ok) {
+    OLA_WARN << "Failed to decode frame at offset " << m_offset;
+    return ShowLoader::INVALID_LINE;
+  }
+
+  *time = ReadUInt32(header);
+  data->Set(slots, size);
+  m_frames[*universe].Set(slots, size);
+  m_offset += BinaryShow::FRAME_HEADER_SIZE + length;
+  return ShowLoader::OK;
+}
+
+
+void BinaryShowReader::Unmap() {
+  if (m_data) {
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = NULL;
+  }
+}
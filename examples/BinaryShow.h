@@ -0,0 +1,167 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BinaryShow.h
+ * Read and write the binary show format.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <stdint.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "examples/ShowLoader.h"
+
+#ifndef EXAMPLES_BINARYSHOW_H_
+#define EXAMPLES_BINARYSHOW_H_
+
+/**
+ * @brief Constants for the binary show format.
+ *
+ * All values are big endian. The file starts with a 32 byte header:
+ *   - the magic "OLASHOWB"
+ *   - uint16 version, uint16 reserved
+ *   - uint32 frame count
+ *   - uint64 offset of the index, 0 if the index wasn't written
+ *   - uint32 time of the last frame in ms, uint32 reserved
+ *
+ * Then the frames, each with a 13 byte header:
+ *   - uint32 time in ms since the first frame
+ *   - uint32 universe
+ *   - uint8 frame type
+ *   - uint16 number of slots
+ *   - uint16 payload length
+ *
+ * A FULL_FRAME payload is the slot data, run length encoded. Control bytes
+ * below 0x80 are followed by (control + 1) literal slots, control bytes of
+ * 0x80 or more are followed by one slot value repeated (control - 0x7d)
+ * times. A DELTA_FRAME payload is a list of changes from the previous frame
+ * for the universe, each a uint16 offset, a uint8 length and the new slots.
+ *
+ * The index is a uint32 entry count, followed by entries of uint32 time in
+ * ms and uint64 file offset. The first frame for each universe after an
+ * indexed offset is always a full frame, so playback can start from any
+ * index entry.
+ */
+namespace BinaryShow {
+  extern const char MAGIC[];
+  static const unsigned int MAGIC_SIZE = 8;
+  static const uint16_t VERSION = 1;
+  static const unsigned int HEADER_SIZE = 32;
+  static const unsigned int FRAME_HEADER_SIZE = 13;
+  static const unsigned int INDEX_ENTRY_SIZE = 12;
+  // The time between index entries.
+  static const unsigned int INDEX_INTERVAL_MS = 1000;
+
+  typedef enum {
+    FULL_FRAME = 0,
+    DELTA_FRAME = 1,
+  } FrameType;
+}  // namespace BinaryShow
+
+
+/**
+ * @brief Writes shows in the binary format.
+ */
+class BinaryShowWriter {
+ public:
+  explicit BinaryShowWriter(const std::string &filename);
+  ~BinaryShowWriter();
+
+  bool Open();
+
+  /**
+   * @brief Write the index and complete the header.
+   */
+  void Close();
+
+  bool NewFrame(const ola::TimeStamp &arrival_time,
+                unsigned int universe,
+                const ola::DmxBuffer &data);
+
+ private:
+  typedef std::map<unsigned int, ola::DmxBuffer> UniverseFrames;
+  typedef std::vector<std::pair<uint32_t, uint64_t> > Index;
+
+  const std::string m_filename;
+  std::ofstream m_show_file;
+  ola::TimeStamp m_start;
+  uint32_t m_last_time;
+  uint32_t m_frame_count;
+  uint64_t m_offset;
+  UniverseFrames m_last_frames;
+  Index m_index;
+  std::string m_payload;
+
+  bool Write(const std::string &data);
+};
+
+
+/**
+ * @brief Reads shows in the binary format.
+ *
+ * The file is memory mapped, so frames are decoded in place.
+ */
+class BinaryShowReader {
+ public:
+  explicit BinaryShowReader(const std::string &filename);
+  ~BinaryShowReader();
+
+  bool Load();
+  void Reset();
+
+  ShowLoader::State NextTimeout(unsigned int *timeout);
+  ShowLoader::State NextFrame(unsigned int *universe, ola::DmxBuffer *data);
+
+  /**
+   * @brief Skip to a time in the show.
+   * @param offset_ms the time in ms from the start of the show.
+   * @returns true if there is a frame at or after this time.
+   *
+   * The next call to NextFrame() returns the first frame at or after
+   * offset_ms.
+   */
+  bool Seek(unsigned int offset_ms);
+
+  uint32_t FrameCount() const { return m_frame_count; }
+  uint32_t Duration() const { return m_duration; }
+
+ private:
+  typedef std::map<unsigned int, ola::DmxBuffer> UniverseFrames;
+  typedef std::vector<std::pair<uint32_t, uint64_t> > Index;
+
+  const std::string m_filename;
+  const uint8_t *m_data;
+  uint64_t m_size;
+  uint64_t m_frames_end;
+  uint64_t m_offset;
+  uint32_t m_frame_count;
+  uint32_t m_duration;
+  uint32_t m_frame_time;
+  UniverseFrames m_frames;
+  Index m_index;
+
+  bool LoadIndex(uint64_t index_offset);
+  ShowLoader::State ReadFrame(uint32_t *time,
+                              unsigned int *universe,
+                              ola::DmxBuffer *data);
+  void Unmap();
+};
+#endif  // EXAMPLES_BINARYSHOW_H_
@@ -72,6 +72,10 @@ examples_ola_rdm_discover_LDADD = $(EXAMPLE_COMMON_LIBS)
 
 examples_ola_recorder_SOURCES = \
     examples/ola-recorder.cpp \
+    examples/BinaryShow.h \
+    examples/BinaryShow.cpp \
+    examples/ShowDecoder.h \
+    examples/ShowDecoder.cpp \
     examples/ShowLoader.h \
     examples/ShowLoader.cpp \
     examples/ShowPlayer.h \
@@ -96,11 +100,15 @@ examples_ola_dmxmonitor_SOURCES = examples/ola-dmxmonitor.cpp
 examples_ola_dmxmonitor_LDADD = $(EXAMPLE_COMMON_LIBS) -lncurses
 endif
 
-noinst_PROGRAMS += examples/ola_throughput examples/ola_latency
+noinst_PROGRAMS += examples/ola_throughput examples/ola_latency \
+                   examples/ola_load
 examples_ola_throughput_SOURCES = examples/ola-throughput.cpp
 examples_ola_throughput_LDADD = $(EXAMPLE_COMMON_LIBS)
 examples_ola_latency_SOURCES = examples/ola-latency.cpp
 examples_ola_latency_LDADD = $(EXAMPLE_COMMON_LIBS)
+examples_ola_load_SOURCES = examples/ola-load.cpp
+examples_ola_load_LDADD = common/web/libolaweb.la \
+                          $(EXAMPLE_COMMON_LIBS)
 
 if USING_WIN32
 # rename this program, otherwise UAC will block it
@@ -135,11 +143,18 @@ EXTRA_DIST += \
 
 # TESTS
 ##################################################
-test_scripts += examples/RecorderVerifyTest.sh
+test_scripts += examples/RecorderVerifyTest.sh \
+                examples/RecorderConvertTest.sh
 
 examples/RecorderVerifyTest.sh: examples/Makefile.mk
 	echo "for FILE in ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Checking \$$FILE\"; ${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$FILE; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: \$$FILE caused ola_recorder to exit with status \$$STATUS\"; exit \$$STATUS; fi; done; exit 0" > examples/RecorderVerifyTest.sh
 	chmod +x examples/RecorderVerifyTest.sh
 
-CLEANFILES += examples/RecorderVerifyTest.sh
+examples/RecorderConvertTest.sh: examples/Makefile.mk
+	echo "for FILE in ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Converting \$$FILE\"; ${top_builddir}/examples/ola_recorder${EXEEXT} --convert \$$FILE --format binary --output examples/RecorderConvertTest.show && ${top_builddir}/examples/ola_recorder${EXEEXT} --verify examples/RecorderConvertTest.show; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: \$$FILE failed to convert with status \$$STATUS\"; exit \$$STATUS; fi; done; exit 0" > examples/RecorderConvertTest.sh
+	chmod +x examples/RecorderConvertTest.sh
+
+CLEANFILES += examples/RecorderVerifyTest.sh \
+              examples/RecorderConvertTest.sh \
+              examples/RecorderConvertTest.show
 endif
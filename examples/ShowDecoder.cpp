@@ -0,0 +1,113 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowDecoder.cpp
+ * Decodes show frames ahead of playback on a separate thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+
+#include "examples/ShowDecoder.h"
+
+using ola::thread::MutexLocker;
+
+ShowDecoder::ShowDecoder(ShowLoader *loader, unsigned int queue_size)
+    : ola::thread::Thread(ola::thread::Thread::Options("show-decoder")),
+      m_loader(loader),
+      m_queue_size(queue_size),
+      m_generation(0),
+      m_restart(false),
+      m_done(false),
+      m_stop(false) {
+}
+
+
+bool ShowDecoder::Stop() {
+  {
+    MutexLocker locker(&m_mutex);
+    m_stop = true;
+    m_condition.Broadcast();
+  }
+  return Join();
+}
+
+
+void ShowDecoder::Next(Entry *entry) {
+  MutexLocker locker(&m_mutex);
+  while (m_queue.empty()) {
+    m_condition.Wait(&m_mutex);
+  }
+  *entry = m_queue.front();
+  m_queue.pop_front();
+  m_condition.Broadcast();
+}
+
+
+void ShowDecoder::Restart() {
+  MutexLocker locker(&m_mutex);
+  m_queue.clear();
+  m_generation++;
+  m_restart = true;
+  m_condition.Broadcast();
+}
+
+
+void *ShowDecoder::Run() {
+  while (true) {
+    unsigned int generation;
+    {
+      MutexLocker locker(&m_mutex);
+      while (!m_stop && !m_restart &&
+             (m_done || m_queue.size() >= m_queue_size)) {
+        m_condition.Wait(&m_mutex);
+      }
+      if (m_stop) {
+        return NULL;
+      }
+      if (m_restart) {
+        // Nothing else uses the loader, so it's safe to reset it here.
+        m_loader->Reset();
+        m_restart = false;
+        m_done = false;
+      }
+      generation = m_generation;
+    }
+
+    Entry entry;
+    Decode(&entry);
+
+    MutexLocker locker(&m_mutex);
+    if (generation != m_generation) {
+      continue;
+    }
+    m_done = entry.frame_state != ShowLoader::OK ||
+             entry.timeout_state != ShowLoader::OK;
+    m_queue.push_back(entry);
+    m_condition.Broadcast();
+  }
+}
+
+
+void ShowDecoder::Decode(Entry *entry) {
+  entry->timeout = 0;
+  entry->frame_state = m_loader->NextFrame(&entry->universe, &entry->data);
+  if (entry->frame_state == ShowLoader::OK) {
+    entry->timeout_state = m_loader->NextTimeout(&entry->timeout);
+  } else {
+    entry->timeout_state = entry->frame_state;
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowDecoder.h
+ * Decodes show frames ahead of playback on a separate thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/DmxBuffer.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+
+#include <deque>
+
+#include "examples/ShowLoader.h"
+
+#ifndef EXAMPLES_SHOWDECODER_H_
+#define EXAMPLES_SHOWDECODER_H_
+
+/**
+ * @brief Reads frames from a ShowLoader into a bounded queue.
+ *
+ * Once the end of the show, or an error, has been queued the thread waits
+ * until Restart() is called.
+ */
+class ShowDecoder: public ola::thread::Thread {
+ public:
+  /**
+   * @brief A frame and the delay until the following frame.
+   */
+  struct Entry {
+    ShowLoader::State frame_state;
+    unsigned int universe;
+    ola::DmxBuffer data;
+    ShowLoader::State timeout_state;
+    unsigned int timeout;
+  };
+
+  /**
+   * @brief Create a new ShowDecoder.
+   * @param loader the ShowLoader to read from. It must not be used by
+   *   anything else while the thread is running.
+   * @param queue_size the maximum number of decoded frames to hold.
+   */
+  ShowDecoder(ShowLoader *loader, unsigned int queue_size);
+
+  /**
+   * @brief Stop the thread.
+   */
+  bool Stop();
+
+  /**
+   * @brief Take the next entry, blocking until one is available.
+   */
+  void Next(Entry *entry);
+
+  /**
+   * @brief Discard the queued frames and start again from the beginning of
+   *   the show.
+   */
+  void Restart();
+
+  void *Run();
+
+ private:
+  ShowLoader *m_loader;
+  const unsigned int m_queue_size;
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_condition;
+  std::deque<Entry> m_queue;
+  // Incremented by Restart(), so a frame being decoded across a restart is
+  // discarded.
+  unsigned int m_generation;
+  bool m_restart;
+  bool m_done;
+  bool m_stop;
+
+  void Decode(Entry *entry);
+};
+#endif  // EXAMPLES_SHOWDECODER_H_
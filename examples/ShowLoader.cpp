@@ -24,6 +24,7 @@
  */
 
 #include <errno.h>
+#include <stdint.h>
 #include <string.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
@@ -35,6 +36,7 @@
 #include <string>
 #include <vector>
 
+#include "examples/BinaryShow.h"
 #include "examples/ShowLoader.h"
 
 using std::vector;
@@ -70,6 +72,12 @@ bool ShowLoader::Load() {
 
   string line;
   ReadLine(&line);
+  if (line.compare(0, BinaryShow::MAGIC_SIZE, BinaryShow::MAGIC) == 0) {
+    m_show_file.close();
+    m_binary_reader.reset(new BinaryShowReader(m_filename));
+    return m_binary_reader->Load();
+  }
+
   if (line != OLA_SHOW_HEADER) {
     OLA_WARN << "Invalid show file, expecting " << OLA_SHOW_HEADER << " got "
              << line;
@@ -83,6 +91,11 @@ bool ShowLoader::Load() {
  * Reset to the start of the show
  */
 void ShowLoader::Reset() {
+  if (m_binary_reader.get()) {
+    m_binary_reader->Reset();
+    return;
+  }
+
   m_show_file.clear();
   m_show_file.seekg(0, std::ios::beg);
   // skip over the first line
@@ -96,6 +109,10 @@ void ShowLoader::Reset() {
  * @param timeout a pointer to the timeout in ms
  */
 ShowLoader::State ShowLoader::NextTimeout(unsigned int *timeout) {
+  if (m_binary_reader.get()) {
+    return m_binary_reader->NextTimeout(timeout);
+  }
+
   string line;
   ReadLine(&line);
   if (line.empty()) {
@@ -117,6 +134,10 @@ ShowLoader::State ShowLoader::NextTimeout(unsigned int *timeout) {
  */
 ShowLoader::State ShowLoader::NextFrame(unsigned int *universe,
                                         DmxBuffer *data) {
+  if (m_binary_reader.get()) {
+    return m_binary_reader->NextFrame(universe, data);
+  }
+
   string line;
   ReadLine(&line);
 
@@ -141,6 +162,27 @@ ShowLoader::State ShowLoader::NextFrame(unsigned int *universe,
 }
 
 
+bool ShowLoader::Seek(unsigned int offset_ms) {
+  if (m_binary_reader.get()) {
+    return m_binary_reader->Seek(offset_ms);
+  }
+
+  // The text format has no index, so read through from the start.
+  Reset();
+  uint64_t time = 0;
+  while (time < offset_ms) {
+    unsigned int universe;
+    DmxBuffer data;
+    unsigned int timeout;
+    if (NextFrame(&universe, &data) != OK || NextTimeout(&timeout) != OK) {
+      return false;
+    }
+    time += timeout;
+  }
+  return true;
+}
+
+
 void ShowLoader::ReadLine(string *line) {
   getline(m_show_file, *line);
   ola::StripSuffix(line, "\r");
@@ -20,6 +20,7 @@
 
 #include <ola/DmxBuffer.h>
 
+#include <memory>
 #include <string>
 #include <fstream>
 
@@ -29,6 +30,11 @@
 /**
  * Loads a show file and reads the DMX data.
  */
+class BinaryShowReader;
+
+/**
+ * @brief Loads show files, in either the text or the binary format.
+ */
 class ShowLoader {
  public:
   explicit ShowLoader(const std::string &filename);
@@ -46,10 +52,18 @@ class ShowLoader {
   State NextTimeout(unsigned int *timeout);
   State NextFrame(unsigned int *universe, ola::DmxBuffer *data);
 
+  /**
+   * @brief Skip to a time in the show.
+   * @param offset_ms the time in ms from the start of the show.
+   * @returns true if there is a frame at or after this time.
+   */
+  bool Seek(unsigned int offset_ms);
+
  private:
   const std::string m_filename;
   std::ifstream m_show_file;
   unsigned int m_line;
+  std::auto_ptr<BinaryShowReader> m_binary_reader;
 
   static const char OLA_SHOW_HEADER[];
 
@@ -26,14 +26,19 @@
 #include <errno.h>
 #include <string.h>
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
 #include <ola/base/SysExits.h>
 #include <ola/client/ClientWrapper.h>
 #include <ola/client/OlaClient.h>
+#include <ola/client/StreamingClient.h>
+#include <ola/timecode/TimeCode.h>
+#include <ola/timecode/TimeCodeEnums.h>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -42,19 +47,66 @@
 using std::vector;
 using std::string;
 using ola::DmxBuffer;
+using ola::client::StreamingClient;
+using ola::timecode::TimeCode;
+using ola::timecode::TimeCodeType;
+
+namespace {
+
+/*
+ * Convert a position in ms to TimeCode. Drop frame TimeCode runs at 29.97
+ * frames per second and skips frame numbers 0 & 1 each minute, except every
+ * tenth minute.
+ */
+TimeCode PositionToTimeCode(TimeCodeType type, uint64_t position_ms,
+                            uint64_t *frame) {
+  unsigned int fps = 30;
+  if (type == ola::timecode::TIMECODE_FILM) {
+    fps = 24;
+  } else if (type == ola::timecode::TIMECODE_EBU) {
+    fps = 25;
+  }
+
+  uint64_t frames;
+  if (type == ola::timecode::TIMECODE_DF) {
+    frames = position_ms * 30000 / 1001000;
+    *frame = frames;
+    const uint64_t ten_minutes = frames / 17982;
+    const uint64_t remainder = frames % 17982;
+    frames += 18 * ten_minutes;
+    if (remainder > 1) {
+      frames += 2 * ((remainder - 2) / 1798);
+    }
+  } else {
+    frames = position_ms * fps / 1000;
+    *frame = frames;
+  }
+
+  return TimeCode(type,
+                  (frames / (fps * 3600)) % 24,
+                  (frames / (fps * 60)) % 60,
+                  (frames / fps) % 60,
+                  frames % fps);
+}
+}  // namespace
 
 
 ShowPlayer::ShowPlayer(const string &filename)
     : m_loader(filename),
       m_infinite_loop(false),
       m_iteration_remaining(0),
-      m_loop_delay(0) {
+      m_loop_delay(0),
+      m_playback_time(0),
+      m_show_position(0),
+      m_send_timecode(false),
+      m_timecode_type(ola::timecode::TIMECODE_SMPTE),
+      m_last_timecode_frame(std::numeric_limits<uint64_t>::max()) {
 }
 
 ShowPlayer::~ShowPlayer() {}
 
 int ShowPlayer::Init() {
-  if (!m_client.Setup()) {
+  if (!m_client.Setup() || !m_streaming_client.Setup()) {
     OLA_FATAL << "Client Setup failed";
     return ola::EXIT_UNAVAILABLE;
   }
@@ -66,12 +118,34 @@ int ShowPlayer::Init() {
   return ola::EXIT_OK;
 }
 
+
+void ShowPlayer::SendTimeCode(TimeCodeType type) {
+  m_send_timecode = true;
+  m_timecode_type = type;
+}
+
+
 int ShowPlayer::Playback(unsigned int iterations,
                          unsigned int duration,
-                         unsigned int delay) {
+                         unsigned int delay,
+                         unsigned int start) {
   m_infinite_loop = iterations == 0 || duration != 0;
   m_iteration_remaining = iterations;
   m_loop_delay = delay;
+  if (start && !m_loader.Seek(start)) {
+    OLA_FATAL << "The show is shorter than " << start << "ms";
+    return ola::EXIT_DATAERR;
+  }
+  m_show_position = start;
+  m_playback_time = 0;
+
+  m_decoder.reset(new ShowDecoder(&m_loader, DECODE_QUEUE_SIZE));
+  if (!m_decoder->Start()) {
+    OLA_FATAL << "Failed to start the decoder thread";
+    return ola::EXIT_SOFTWARE;
+  }
+
+  m_clock.CurrentTime(&m_start_time);
   SendNextFrame();
 
   ola::io::SelectServer *ss = m_client.GetSelectServer();
@@ -82,58 +156,117 @@ int ShowPlayer::Playback(unsigned int iterations,
         ola::NewSingleCallback(ss, &ola::io::SelectServer::Terminate));
   }
   ss->Run();
+  m_decoder->Stop();
   return ola::EXIT_OK;
 }
 
+
+/**
+ * Send all the frames due now, then schedule the next ones.
+ */
 void ShowPlayer::SendNextFrame() {
-  DmxBuffer buffer;
-  unsigned int universe;
-  ShowLoader::State state = m_loader.NextFrame(&universe, &buffer);
-  switch (state) {
-    case ShowLoader::END_OF_FILE:
-      HandleEndOfFile();
+  SendCurrentTimeCode();
+
+  StreamingClient::SendArgs args;
+  ShowDecoder::Entry entry;
+  while (true) {
+    m_decoder->Next(&entry);
+    if (entry.frame_state != ShowLoader::OK) {
+      if (Flush()) {
+        HandleEndOfShow(entry.frame_state);
+      }
       return;
-    case ShowLoader::INVALID_LINE:
+    }
+
+    OLA_INFO << "Universe: " << entry.universe << ": "
+             << entry.data.ToString();
+    if (!m_streaming_client.BufferDMX(entry.universe, entry.data, args)) {
+      OLA_WARN << "Failed to send DMX, the connection to olad was closed";
       m_client.GetSelectServer()->Terminate();
       return;
-    default:
-      {}
-  }
+    }
 
-  state = RegisterNextTimeout();
+    if (entry.timeout_state != ShowLoader::OK) {
+      if (Flush()) {
+        HandleEndOfShow(entry.timeout_state);
+      }
+      return;
+    }
 
-  OLA_INFO << "Universe: " << universe << ": " << buffer.ToString();
-  ola::client::SendDMXArgs args;
-  m_client.GetClient()->SendDMX(universe, buffer, args);
+    m_playback_time += entry.timeout;
+    m_show_position += entry.timeout;
+    if (entry.timeout) {
+      break;
+    }
+  }
 
-  switch (state) {
-    case ShowLoader::END_OF_FILE:
-      HandleEndOfFile();
-      return;
-    case ShowLoader::INVALID_LINE:
-      m_client.GetSelectServer()->Terminate();
-      return;
-    default:
-      {}
+  if (Flush()) {
+    ScheduleNextFrame();
   }
 }
 
 
 /**
- * Get the next time offset
+ * Register a timeout for when the next frame is due.
  */
-ShowLoader::State ShowPlayer::RegisterNextTimeout() {
-  unsigned int timeout;
-  ShowLoader::State state = m_loader.NextTimeout(&timeout);
-  if (state != ShowLoader::OK) {
-    return state;
+void ShowPlayer::ScheduleNextFrame() {
+  const ola::TimeStamp due = m_start_time + ola::TimeInterval(
+      static_cast<int64_t>(m_playback_time * 1000));
+  ola::TimeStamp now;
+  m_clock.CurrentTime(&now);
+
+  ola::TimeInterval delay;
+  if (due > now) {
+    delay = due - now;
   }
 
-  OLA_INFO << "Registering timeout for " << timeout << "ms";
+  OLA_INFO << "Registering timeout for " << delay;
   m_client.GetSelectServer()->RegisterSingleTimeout(
-      timeout,
+      delay,
       ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
-  return state;
+}
+
+
+/**
+ * Send the buffered frames.
+ */
+bool ShowPlayer::Flush() {
+  if (!m_streaming_client.Flush()) {
+    OLA_WARN << "Failed to send DMX, the connection to olad was closed";
+    m_client.GetSelectServer()->Terminate();
+    return false;
+  }
+  return true;
+}
+
+
+/**
+ * Send TimeCode if the position has moved on to a new TimeCode frame.
+ */
+void ShowPlayer::SendCurrentTimeCode() {
+  if (!m_send_timecode) {
+    return;
+  }
+
+  uint64_t frame;
+  const TimeCode timecode = PositionToTimeCode(m_timecode_type,
+                                               m_show_position, &frame);
+  if (frame == m_last_timecode_frame) {
+    return;
+  }
+  m_last_timecode_frame = frame;
+  m_client.GetClient()->SendTimeCode(
+      timecode,
+      ola::NewSingleCallback(this, &ShowPlayer::TimeCodeSent));
+}
+
+
+void ShowPlayer::HandleEndOfShow(ShowLoader::State state) {
+  if (state == ShowLoader::END_OF_FILE) {
+    HandleEndOfFile();
+  } else {
+    m_client.GetSelectServer()->Terminate();
+  }
 }
 
 
@@ -143,13 +276,20 @@ ShowLoader::State ShowPlayer::RegisterNextTimeout() {
 void ShowPlayer::HandleEndOfFile() {
   m_iteration_remaining--;
   if (m_infinite_loop || m_iteration_remaining > 0) {
-    m_loader.Reset();
-    m_client.GetSelectServer()->RegisterSingleTimeout(
-        m_loop_delay,
-        ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
+    m_decoder->Restart();
+    m_show_position = 0;
+    m_playback_time += m_loop_delay;
+    ScheduleNextFrame();
     return;
   } else {
     // stop the show
     m_client.GetSelectServer()->Terminate();
   }
 }
+
+
+void ShowPlayer::TimeCodeSent(const ola::client::Result &result) {
+  if (!result.Success()) {
+    OLA_WARN << "Failed to send TimeCode: " << result.Error();
+  }
+}
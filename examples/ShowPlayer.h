@@ -18,12 +18,18 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/client/ClientWrapper.h>
+#include <ola/client/StreamingClient.h>
+#include <ola/timecode/TimeCodeEnums.h>
+#include <stdint.h>
 
+#include <memory>
 #include <string>
 #include <fstream>
 
+#include "examples/ShowDecoder.h"
 #include "examples/ShowLoader.h"
 
 #ifndef EXAMPLES_SHOWPLAYER_H_
@@ -31,6 +37,11 @@
 
 /**
  * @brief A class which plays back recorded show files.
+ *
+ * Frames are scheduled relative to the time playback started, so delays in
+ * sending one frame don't push back the rest of the show. The show is decoded
+ * ahead of time on a separate thread, and frames with the same timestamp are
+ * sent to olad in a single batch.
  */
 class ShowPlayer {
  public:
@@ -47,27 +58,51 @@ class ShowPlayer {
    */
   int Init();
 
+  /**
+   * @brief Send TimeCode for the position in the show during playback.
+   * @param type the type of TimeCode to send.
+   */
+  void SendTimeCode(ola::timecode::TimeCodeType type);
+
   /**
    * @brief Playback the show
    * @param iterations the number of iterations of the show to play.
    * @param duration the duration in seconds after which playback is stopped.
    * @param delay the hold time at the end of a show before playback starts
    * from the beginning again.
+   * @param start the time in ms to start the first iteration from.
    */
   int Playback(unsigned int iterations,
                unsigned int duration,
-               unsigned int delay);
+               unsigned int delay,
+               unsigned int start = 0);
 
  private:
   ola::client::OlaClientWrapper m_client;
+  ola::client::StreamingClient m_streaming_client;
   ShowLoader m_loader;
+  std::auto_ptr<ShowDecoder> m_decoder;
+  ola::Clock m_clock;
   bool m_infinite_loop;
   unsigned int m_iteration_remaining;
   unsigned int m_loop_delay;
+  // The time playback started, and the offset from then to the next frame.
+  ola::TimeStamp m_start_time;
+  uint64_t m_playback_time;
+  // The position in the show of the next frame.
+  uint64_t m_show_position;
+  bool m_send_timecode;
+  ola::timecode::TimeCodeType m_timecode_type;
+  uint64_t m_last_timecode_frame;
 
   void SendNextFrame();
-  ShowLoader::State RegisterNextTimeout();
-  bool ReadNextFrame(unsigned int *universe, ola::DmxBuffer *data);
+  void ScheduleNextFrame();
+  bool Flush();
+  void SendCurrentTimeCode();
+  void HandleEndOfShow(ShowLoader::State state);
   void HandleEndOfFile();
+  void TimeCodeSent(const ola::client::Result &result);
+
+  static const unsigned int DECODE_QUEUE_SIZE = 100;
 };
 #endif  // EXAMPLES_SHOWPLAYER_H_
@@ -31,6 +31,7 @@
 #include <iostream>
 #include <string>
 
+#include "examples/BinaryShow.h"
 #include "examples/ShowSaver.h"
 
 using std::string;
@@ -40,8 +41,11 @@ using std::endl;
 
 const char ShowSaver::OLA_SHOW_HEADER[] = "OLA Show";
 
-ShowSaver::ShowSaver(const string &filename)
+ShowSaver::ShowSaver(const string &filename, Format format)
     : m_filename(filename) {
+  if (format == BINARY_FORMAT) {
+    m_binary_writer.reset(new BinaryShowWriter(filename));
+  }
 }
 
 
@@ -55,6 +59,10 @@ ShowSaver::~ShowSaver() {
  * @returns true if we could open the file, false otherwise.
  */
 bool ShowSaver::Open() {
+  if (m_binary_writer.get()) {
+    return m_binary_writer->Open();
+  }
+
   m_show_file.open(m_filename.data());
   if (!m_show_file.is_open()) {
     OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
@@ -71,6 +79,11 @@ bool ShowSaver::Open() {
  * Close the show file
  */
 void ShowSaver::Close() {
+  if (m_binary_writer.get()) {
+    m_binary_writer->Close();
+    return;
+  }
+
   if (m_show_file.is_open()) {
     m_show_file.close();
   }
@@ -83,6 +96,10 @@ void ShowSaver::Close() {
 bool ShowSaver::NewFrame(const ola::TimeStamp &arrival_time,
                          unsigned int universe,
                          const ola::DmxBuffer &data) {
+  if (m_binary_writer.get()) {
+    return m_binary_writer->NewFrame(arrival_time, universe, data);
+  }
+
   // TODO(simon): add much better error handling here
   if (m_last_frame.IsSet()) {
     // this is not the first frame so write the delay in ms
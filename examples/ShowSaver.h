@@ -21,6 +21,7 @@
 #include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 
+#include <memory>
 #include <string>
 #include <fstream>
 
@@ -30,9 +31,20 @@
 /**
  * Write show data to a file.
  */
+class BinaryShowWriter;
+
+/**
+ * @brief Saves show files, in either the text or the binary format.
+ */
 class ShowSaver {
  public:
-  explicit ShowSaver(const std::string &filename);
+  typedef enum {
+    TEXT_FORMAT,
+    BINARY_FORMAT,
+  } Format;
+
+  explicit ShowSaver(const std::string &filename,
+                     Format format = TEXT_FORMAT);
   ~ShowSaver();
 
   bool Open();
@@ -46,6 +58,7 @@ class ShowSaver {
   const std::string m_filename;
   std::ofstream m_show_file;
   ola::TimeStamp m_last_frame;
+  std::auto_ptr<BinaryShowWriter> m_binary_writer;
 
   static const char OLA_SHOW_HEADER[];
 };
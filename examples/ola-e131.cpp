@@ -39,6 +39,8 @@ DEFINE_s_default_bool(input, i, false,
                       "Set an input port, otherwise set an output port.");
 DEFINE_bool(preview_mode, false, "Set the preview mode bit on|off");
 DEFINE_default_bool(discovery, false, "Get the discovery state");
+DEFINE_default_bool(source_stats, false,
+                    "Get the receive statistics for each source");
 
 /*
  * A class that configures E131 devices
@@ -52,6 +54,7 @@ class E131Configurator: public OlaConfigurator {
  private:
   void DisplayOptions(const ola::plugin::e131::PortInfoReply &reply);
   void DisplaySourceList(const ola::plugin::e131::SourceListReply &reply);
+  void DisplaySourceStats(const ola::plugin::e131::SourceStatsReply &reply);
 };
 
 
@@ -86,6 +89,13 @@ void E131Configurator::HandleConfigResponse(const string &reply,
         cout << "Missing source_list field in reply" << endl;
       }
       break;
+    case ola::plugin::e131::Reply::E131_SOURCE_STATS:
+      if (reply_pb.has_source_stats()) {
+        DisplaySourceStats(reply_pb.source_stats());
+      } else {
+        cout << "Missing source_stats field in reply" << endl;
+      }
+      break;
     default:
       cout << "Invalid response type" << endl;
   }
@@ -117,6 +127,8 @@ void E131Configurator::SendConfigRequest() {
     ola::plugin::e131::SourceListRequest *source_list_request =
         request.mutable_source_list();
     (void) source_list_request;  // no options for now.
+  } else if (FLAGS_source_stats) {
+    request.set_type(ola::plugin::e131::Request::E131_SOURCE_STATS);
   } else {
     request.set_type(ola::plugin::e131::Request::E131_PORT_INFO);
   }
@@ -163,6 +175,22 @@ void E131Configurator::DisplaySourceList(
   }
 }
 
+void E131Configurator::DisplaySourceStats(
+    const ola::plugin::e131::SourceStatsReply &reply) {
+  for (int i = 0; i < reply.source_size(); i++) {
+    const ola::plugin::e131::SourceStats &stats = reply.source(i);
+    cout << "Universe " << stats.universe() << ", " << stats.cid()
+         << ", priority " << stats.priority()
+         << (stats.merged() ? " (merged)" : "") << endl;
+    cout << "  packets " << stats.packets()
+         << ", gaps " << stats.sequence_gaps()
+         << ", out of order " << stats.out_of_order()
+         << ", duplicates " << stats.duplicates() << endl;
+    cout << "  interval " << stats.mean_interval() / 1000.0
+         << "ms, jitter " << stats.jitter() / 1000.0 << "ms" << endl;
+  }
+}
+
 /*
  * The main function
  */
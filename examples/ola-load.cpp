@@ -0,0 +1,621 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ola-load.cpp
+ * Generate DMX load on olad from many clients and report the throughput,
+ * end to end latency and CPU usage as JSON.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+#include <ola/StringUtils.h>
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+#include <ola/client/ClientWrapper.h>
+#include <ola/client/OlaClient.h>
+#include <ola/client/StreamingClient.h>
+#include <ola/io/SelectServer.h>
+#include <ola/stl/STLUtils.h>
+#include <ola/thread/Thread.h>
+#include <ola/util/Histogram.h>
+#include <ola/web/Json.h>
+#include <ola/web/JsonWriter.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using ola::DmxBuffer;
+using ola::Histogram;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::client::DMXMetadata;
+using ola::client::OlaClientWrapper;
+using ola::client::Result;
+using ola::client::StreamingClient;
+using ola::io::SelectServer;
+using ola::web::JsonObject;
+using ola::web::JsonUInt64;
+using ola::web::JsonWriter;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+DEFINE_s_string(mode, m, "stream",
+                "How to send data, one of send_dmx, stream, batch or "
+                "shared_memory.");
+DEFINE_s_uint32(clients, c, 1, "The number of client connections to open.");
+DEFINE_s_uint32(universes, u, 1, "The number of universes for each client.");
+DEFINE_uint32(first_universe, 1, "The first universe to send on.");
+DEFINE_s_uint32(rate, r, 44, "The frame rate for each universe, in Hz.");
+DEFINE_uint32(slots, 512, "The number of slots in each frame.");
+DEFINE_s_uint32(duration, d, 10, "How long to run for, in seconds.");
+DEFINE_uint32(drain_ms, 500,
+              "How long to wait for frames in flight once sending stops.");
+DEFINE_uint32(max_in_flight, 1000,
+              "In send_dmx mode, skip a frame if a client has this many "
+              "unacknowledged frames.");
+DEFINE_uint32(olad_pid, 0,
+              "The pid of olad, used to report olad's CPU usage (Linux only).");
+DEFINE_string(socket, "",
+              "Connect through the unix domain socket at this path rather "
+              "than TCP.");
+DEFINE_s_string(output, o, "", "Write the JSON report to this file rather "
+                "than stdout.");
+DEFINE_default_bool(no_receive, false,
+                    "Don't register for the universes, so latency isn't "
+                    "measured.");
+
+namespace {
+
+enum SendMode {
+  MODE_SEND_DMX,
+  MODE_STREAM,
+  MODE_BATCH,
+  MODE_SHARED_MEMORY,
+};
+
+/*
+ * Each frame starts with the time it was sent, in microseconds since the
+ * start of the run. All the clients are in this process so they share a
+ * clock, which lets the receiver measure the end to end latency without
+ * tracking each frame.
+ */
+const unsigned int TIMESTAMP_SIZE = 6;
+
+bool StringToMode(const string &mode_str, SendMode *mode) {
+  if (mode_str == "send_dmx") {
+    *mode = MODE_SEND_DMX;
+  } else if (mode_str == "stream") {
+    *mode = MODE_STREAM;
+  } else if (mode_str == "batch") {
+    *mode = MODE_BATCH;
+  } else if (mode_str == "shared_memory") {
+    *mode = MODE_SHARED_MEMORY;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+uint64_t MicroSecondsSince(const TimeStamp &epoch) {
+  ola::Clock clock;
+  TimeStamp now;
+  clock.CurrentTime(&now);
+  return (now - epoch).AsInt();
+}
+
+/*
+ * CPU time used by a process, in microseconds.
+ */
+struct CpuUsage {
+  bool valid;
+  uint64_t user;
+  uint64_t system;
+
+  CpuUsage() : valid(false), user(0), system(0) {}
+};
+
+CpuUsage OurCpuUsage() {
+  CpuUsage usage;
+  struct rusage rusage;
+  if (getrusage(RUSAGE_SELF, &rusage) == 0) {
+    usage.valid = true;
+    usage.user = rusage.ru_utime.tv_sec * 1000000ull + rusage.ru_utime.tv_usec;
+    usage.system = (rusage.ru_stime.tv_sec * 1000000ull +
+                    rusage.ru_stime.tv_usec);
+  }
+  return usage;
+}
+
+CpuUsage ProcessCpuUsage(unsigned int pid) {
+  CpuUsage usage;
+  if (!pid) {
+    return usage;
+  }
+
+  std::ostringstream path;
+  path << "/proc/" << pid << "/stat";
+  std::ifstream stat_file(path.str().c_str());
+  string line;
+  if (!std::getline(stat_file, line)) {
+    OLA_WARN << "Failed to read " << path.str();
+    return usage;
+  }
+
+  // The command name may contain spaces, so skip to the closing bracket.
+  string::size_type end = line.rfind(')');
+  if (end == string::npos) {
+    return usage;
+  }
+  vector<string> fields;
+  ola::StringSplit(line.substr(end + 2), &fields, " ");
+  // utime and stime are fields 14 and 15, and the state (field 3) is first.
+  unsigned int user_ticks, system_ticks;
+  long ticks_per_second = sysconf(_SC_CLK_TCK);  // NOLINT(runtime/int)
+  if (fields.size() < 13 || ticks_per_second <= 0 ||
+      !ola::StringToInt(fields[11], &user_ticks) ||
+      !ola::StringToInt(fields[12], &system_ticks)) {
+    OLA_WARN << "Failed to parse " << path.str();
+    return usage;
+  }
+  usage.valid = true;
+  usage.user = static_cast<uint64_t>(user_ticks) * 1000000 / ticks_per_second;
+  usage.system = (static_cast<uint64_t>(system_ticks) * 1000000 /
+                  ticks_per_second);
+  return usage;
+}
+
+void AddCpuUsage(JsonObject *json, const string &key, const CpuUsage &start,
+                 const CpuUsage &end, uint64_t elapsed_us) {
+  if (!start.valid || !end.valid) {
+    json->Add(key);
+    return;
+  }
+  JsonObject *cpu = json->AddObject(key);
+  uint64_t user = end.user - start.user;
+  uint64_t system = end.system - start.system;
+  cpu->Add("user_s", user / 1000000.0);
+  cpu->Add("system_s", system / 1000000.0);
+  // 100 is one core.
+  cpu->Add("percent",
+           elapsed_us ? 100.0 * (user + system) / elapsed_us : 0.0);
+}
+
+void AddCount(JsonObject *json, const string &key, uint64_t value) {
+  json->AddValue(key, new JsonUInt64(value));
+}
+
+void AddRate(JsonObject *json, const string &key, uint64_t count,
+             uint64_t elapsed_us) {
+  json->Add(key, elapsed_us ? count * 1000000.0 / elapsed_us : 0.0);
+}
+}  // namespace
+
+
+/*
+ * A client connection which sends frames for a range of universes, in its
+ * own thread.
+ */
+class Sender : public ola::thread::Thread {
+ public:
+  struct Stats {
+    uint64_t frames;
+    uint64_t skipped;
+    uint64_t send_failures;
+    uint64_t acks;
+    uint64_t ack_errors;
+
+    Stats()
+        : frames(0),
+          skipped(0),
+          send_failures(0),
+          acks(0),
+          ack_errors(0) {
+    }
+  };
+
+  Sender(SendMode mode, unsigned int first_universe,
+         unsigned int universe_count, const TimeStamp &epoch)
+      : Thread(Thread::Options("ola-load-sender")),
+        m_mode(mode),
+        m_first_universe(first_universe),
+        m_universe_count(universe_count),
+        m_epoch(epoch),
+        m_ss(NULL),
+        m_in_flight(0) {
+    uint8_t data[ola::DMX_UNIVERSE_SIZE];
+    memset(data, 0, sizeof(data));
+    m_buffer.Set(data, FLAGS_slots);
+  }
+
+  bool Setup();
+  void *Run();
+  void Stop();
+
+  const Stats &GetStats() const { return m_stats; }
+
+ private:
+  const SendMode m_mode;
+  const unsigned int m_first_universe;
+  const unsigned int m_universe_count;
+  const TimeStamp m_epoch;
+  SelectServer *m_ss;
+  SelectServer m_streaming_ss;
+  auto_ptr<OlaClientWrapper> m_wrapper;
+  auto_ptr<StreamingClient> m_streaming_client;
+  auto_ptr<ola::client::GeneralSetCallback> m_ack_callback;
+  DmxBuffer m_buffer;
+  unsigned int m_in_flight;
+  Stats m_stats;
+
+  bool SendFrames();
+  bool SendFrame(unsigned int universe);
+  void Ack(const Result &result);
+
+  DISALLOW_COPY_AND_ASSIGN(Sender);
+};
+
+
+bool Sender::Setup() {
+  if (m_mode == MODE_SEND_DMX) {
+    m_wrapper.reset(new OlaClientWrapper());
+    if (!FLAGS_socket.str().empty()) {
+      m_wrapper->SetSocketPath(FLAGS_socket.str());
+    }
+    if (!m_wrapper->Setup()) {
+      return false;
+    }
+    m_ss = m_wrapper->GetSelectServer();
+    m_ack_callback.reset(NewCallback(this, &Sender::Ack));
+  } else {
+    StreamingClient::Options options;
+    options.use_shared_memory = m_mode == MODE_SHARED_MEMORY;
+    options.socket_path = FLAGS_socket.str();
+    m_streaming_client.reset(new StreamingClient(options));
+    if (!m_streaming_client->Setup()) {
+      return false;
+    }
+    m_ss = &m_streaming_ss;
+  }
+
+  m_ss->RegisterRepeatingTimeout(
+      TimeInterval(0, 1000000 / FLAGS_rate),
+      NewCallback(this, &Sender::SendFrames));
+  return true;
+}
+
+
+void *Sender::Run() {
+  m_ss->Run();
+  return NULL;
+}
+
+
+void Sender::Stop() {
+  m_ss->Terminate();
+  Join();
+  if (m_streaming_client.get()) {
+    m_streaming_client->Stop();
+  }
+}
+
+
+bool Sender::SendFrames() {
+  for (unsigned int i = 0; i < m_universe_count; i++) {
+    if (!SendFrame(m_first_universe + i)) {
+      m_ss->Terminate();
+      return false;
+    }
+  }
+  if (m_mode == MODE_BATCH && !m_streaming_client->Flush()) {
+    m_stats.send_failures++;
+    m_ss->Terminate();
+    return false;
+  }
+  return true;
+}
+
+
+/*
+ * Send a frame for a universe.
+ * @returns false if the connection to olad was lost.
+ */
+bool Sender::SendFrame(unsigned int universe) {
+  if (m_mode == MODE_SEND_DMX && m_in_flight >= FLAGS_max_in_flight) {
+    m_stats.skipped++;
+    return true;
+  }
+
+  uint64_t now = MicroSecondsSince(m_epoch);
+  for (unsigned int i = 0; i < TIMESTAMP_SIZE; i++) {
+    m_buffer.SetChannel(i, (now >> (8 * (TIMESTAMP_SIZE - 1 - i))) & 0xff);
+  }
+
+  bool ok = true;
+  StreamingClient::SendArgs args;
+  switch (m_mode) {
+    case MODE_SEND_DMX:
+      m_wrapper->GetClient()->SendDMX(
+          universe, m_buffer,
+          ola::client::SendDMXArgs(m_ack_callback.get()));
+      m_in_flight++;
+      break;
+    case MODE_BATCH:
+      ok = m_streaming_client->BufferDMX(universe, m_buffer, args);
+      break;
+    case MODE_STREAM:
+    case MODE_SHARED_MEMORY:
+      ok = m_streaming_client->SendDMX(universe, m_buffer, args);
+      break;
+  }
+
+  if (!ok) {
+    m_stats.send_failures++;
+    return false;
+  }
+  m_stats.frames++;
+  return true;
+}
+
+
+void Sender::Ack(const Result &result) {
+  m_in_flight--;
+  if (result.Success()) {
+    m_stats.acks++;
+  } else {
+    m_stats.ack_errors++;
+  }
+}
+
+
+/*
+ * Registers for all the universes and records the latency of each frame.
+ */
+class Receiver {
+ public:
+  explicit Receiver(const TimeStamp &epoch)
+      : m_epoch(epoch),
+        m_frames(0),
+        m_invalid_frames(0) {
+  }
+
+  bool Setup(unsigned int first_universe, unsigned int universe_count);
+
+  SelectServer *GetSelectServer() { return m_wrapper.GetSelectServer(); }
+  uint64_t Frames() const { return m_frames; }
+  uint64_t InvalidFrames() const { return m_invalid_frames; }
+  const Histogram &Latency() const { return m_latency; }
+
+ private:
+  const TimeStamp m_epoch;
+  OlaClientWrapper m_wrapper;
+  Histogram m_latency;
+  uint64_t m_frames;
+  uint64_t m_invalid_frames;
+
+  void NewDmx(const DMXMetadata &metadata, const DmxBuffer &data);
+};
+
+
+bool Receiver::Setup(unsigned int first_universe,
+                     unsigned int universe_count) {
+  if (!FLAGS_socket.str().empty()) {
+    m_wrapper.SetSocketPath(FLAGS_socket.str());
+  }
+  if (!m_wrapper.Setup()) {
+    return false;
+  }
+
+  ola::client::OlaClient *client = m_wrapper.GetClient();
+  client->SetDMXCallback(NewCallback(this, &Receiver::NewDmx));
+  for (unsigned int i = 0; i < universe_count; i++) {
+    client->RegisterUniverse(first_universe + i, ola::client::REGISTER, NULL);
+  }
+  return true;
+}
+
+
+void Receiver::NewDmx(const DMXMetadata&, const DmxBuffer &data) {
+  if (data.Size() < TIMESTAMP_SIZE) {
+    m_invalid_frames++;
+    return;
+  }
+
+  uint64_t sent = 0;
+  for (unsigned int i = 0; i < TIMESTAMP_SIZE; i++) {
+    sent = (sent << 8) | data.Get(i);
+  }
+  uint64_t now = MicroSecondsSince(m_epoch);
+  if (sent > now) {
+    // Not one of our frames.
+    m_invalid_frames++;
+    return;
+  }
+  m_frames++;
+  m_latency.Add(static_cast<uint32_t>(std::min(
+      now - sent,
+      static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()))));
+}
+
+
+/*
+ * Main
+ */
+int main(int argc, char *argv[]) {
+  ola::AppInit(
+      &argc, argv, "[options]",
+      "Send DMX data to olad from many clients and report the throughput, "
+      "latency and CPU usage as JSON.");
+
+  SendMode mode;
+  if (!StringToMode(FLAGS_mode.str(), &mode)) {
+    OLA_FATAL << "Unknown mode " << FLAGS_mode.str();
+    exit(ola::EXIT_USAGE);
+  }
+  if (!FLAGS_clients || !FLAGS_universes || !FLAGS_rate ||
+      FLAGS_rate > 1000000) {
+    OLA_FATAL << "--clients, --universes and --rate must be non-0";
+    exit(ola::EXIT_USAGE);
+  }
+  if (FLAGS_slots < TIMESTAMP_SIZE || FLAGS_slots > ola::DMX_UNIVERSE_SIZE) {
+    OLA_FATAL << "--slots must be between " << TIMESTAMP_SIZE << " and "
+              << ola::DMX_UNIVERSE_SIZE;
+    exit(ola::EXIT_USAGE);
+  }
+
+  ola::Clock clock;
+  TimeStamp epoch;
+  clock.CurrentTime(&epoch);
+
+  const unsigned int universe_count = FLAGS_clients * FLAGS_universes;
+  Receiver receiver(epoch);
+  SelectServer local_ss;
+  SelectServer *ss = &local_ss;
+  if (!FLAGS_no_receive) {
+    if (!receiver.Setup(FLAGS_first_universe, universe_count)) {
+      OLA_FATAL << "Failed to setup the receiver";
+      exit(ola::EXIT_UNAVAILABLE);
+    }
+    ss = receiver.GetSelectServer();
+  }
+
+  vector<Sender*> senders;
+  for (unsigned int i = 0; i < FLAGS_clients; i++) {
+    Sender *sender = new Sender(
+        mode, FLAGS_first_universe + i * FLAGS_universes, FLAGS_universes,
+        epoch);
+    senders.push_back(sender);
+    if (!sender->Setup()) {
+      OLA_FATAL << "Failed to setup client " << i;
+      ola::STLDeleteElements(&senders);
+      exit(ola::EXIT_UNAVAILABLE);
+    }
+  }
+
+  CpuUsage olad_start = ProcessCpuUsage(FLAGS_olad_pid);
+  CpuUsage our_start = OurCpuUsage();
+  uint64_t start = MicroSecondsSince(epoch);
+
+  vector<Sender*>::iterator iter = senders.begin();
+  for (; iter != senders.end(); ++iter) {
+    (*iter)->Start();
+  }
+
+  ss->RegisterSingleTimeout(
+      FLAGS_duration * 1000,
+      NewSingleCallback(ss, &SelectServer::Terminate));
+  ss->Run();
+
+  for (iter = senders.begin(); iter != senders.end(); ++iter) {
+    (*iter)->Stop();
+  }
+  uint64_t elapsed = MicroSecondsSince(epoch) - start;
+  CpuUsage olad_end = ProcessCpuUsage(FLAGS_olad_pid);
+  CpuUsage our_end = OurCpuUsage();
+
+  // Pick up the frames still in flight.
+  if (!FLAGS_no_receive) {
+    ss->RegisterSingleTimeout(
+        FLAGS_drain_ms,
+        NewSingleCallback(ss, &SelectServer::Terminate));
+    ss->Run();
+  }
+
+  Sender::Stats totals;
+  for (iter = senders.begin(); iter != senders.end(); ++iter) {
+    const Sender::Stats &stats = (*iter)->GetStats();
+    totals.frames += stats.frames;
+    totals.skipped += stats.skipped;
+    totals.send_failures += stats.send_failures;
+    totals.acks += stats.acks;
+    totals.ack_errors += stats.ack_errors;
+  }
+  ola::STLDeleteElements(&senders);
+
+  JsonObject report;
+  JsonObject *config = report.AddObject("config");
+  config->Add("mode", FLAGS_mode.str());
+  config->Add("clients", static_cast<unsigned int>(FLAGS_clients));
+  config->Add("universes_per_client",
+              static_cast<unsigned int>(FLAGS_universes));
+  config->Add("rate", static_cast<unsigned int>(FLAGS_rate));
+  config->Add("slots", static_cast<unsigned int>(FLAGS_slots));
+  config->Add("duration_s", static_cast<unsigned int>(FLAGS_duration));
+  report.Add("elapsed_s", elapsed / 1000000.0);
+
+  JsonObject *sent = report.AddObject("sent");
+  AddCount(sent, "frames", totals.frames);
+  AddRate(sent, "frames_per_second", totals.frames, elapsed);
+  AddCount(sent, "skipped_frames", totals.skipped);
+  AddCount(sent, "send_failures", totals.send_failures);
+  if (mode == MODE_SEND_DMX) {
+    AddCount(sent, "acks", totals.acks);
+    AddCount(sent, "ack_errors", totals.ack_errors);
+  }
+
+  if (FLAGS_no_receive) {
+    report.Add("received");
+    report.Add("latency_us");
+  } else {
+    JsonObject *received = report.AddObject("received");
+    AddCount(received, "frames", receiver.Frames());
+    AddRate(received, "frames_per_second", receiver.Frames(), elapsed);
+    AddCount(received, "invalid_frames", receiver.InvalidFrames());
+
+    const Histogram &latency = receiver.Latency();
+    JsonObject *latency_json = report.AddObject("latency_us");
+    AddCount(latency_json, "count", latency.Count());
+    latency_json->Add("p50", latency.Percentile(50));
+    latency_json->Add("p90", latency.Percentile(90));
+    latency_json->Add("p99", latency.Percentile(99));
+    latency_json->Add("p99.9", latency.Percentile(99.9));
+    latency_json->Add("max", latency.Max());
+  }
+
+  AddCpuUsage(&report, "olad_cpu", olad_start, olad_end, elapsed);
+  AddCpuUsage(&report, "client_cpu", our_start, our_end, elapsed);
+
+  if (FLAGS_output.str().empty()) {
+    JsonWriter::Write(&std::cout, report);
+    std::cout << std::endl;
+  } else {
+    std::ofstream output(FLAGS_output.str().c_str());
+    if (!output.is_open()) {
+      OLA_FATAL << "Failed to open " << FLAGS_output.str();
+      exit(ola::EXIT_CANTCREAT);
+    }
+    JsonWriter::Write(&output, report);
+    output << std::endl;
+  }
+  return totals.send_failures ? ola::EXIT_SOFTWARE : ola::EXIT_OK;
+}
@@ -19,6 +19,7 @@
  */
 
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
@@ -26,6 +27,7 @@
 #include <ola/base/Init.h>
 #include <ola/base/SysExits.h>
 #include <ola/thread/SignalThread.h>
+#include <ola/timecode/TimeCodeEnums.h>
 #include <signal.h>
 #include <iostream>
 #include <map>
@@ -36,6 +38,7 @@
 #include "examples/ShowPlayer.h"
 #include "examples/ShowLoader.h"
 #include "examples/ShowRecorder.h"
+#include "examples/ShowSaver.h"
 
 using std::auto_ptr;
 using std::cout;
@@ -47,6 +50,10 @@ using std::string;
 DEFINE_s_string(playback, p, "", "The show file to playback.");
 DEFINE_s_string(record, r, "", "The show file to record data to.");
 DEFINE_string(verify, "", "The show file to verify.");
+DEFINE_string(convert, "", "The show file to convert, see --output.");
+DEFINE_string(output, "", "The file to write the converted show to.");
+DEFINE_string(format, "text",
+              "The format for --record and --convert, text or binary.");
 DEFINE_s_string(universes, u, "",
                 "A comma separated list of universes to record");
 DEFINE_s_uint32(delay, d, 0, "The delay in ms between successive iterations.");
@@ -54,11 +61,47 @@ DEFINE_uint32(duration, 0, "The length of time (seconds) to run for.");
 // 0 means infinite looping
 DEFINE_s_uint32(iterations, i, 1,
                 "The number of times to repeat the show, 0 means unlimited.");
+DEFINE_uint32(start, 0, "The time in ms to start playback from.");
+DEFINE_string(timecode, "",
+              "Send TimeCode during playback, one of FILM, EBU, DF, SMPTE.");
 
 void TerminateRecorder(ShowRecorder *recorder) {
   recorder->Stop();
 }
 
+/**
+ * Get the show format from the --format flag
+ */
+ShowSaver::Format ShowFormat() {
+  const string format = FLAGS_format.str();
+  if (format == "text") {
+    return ShowSaver::TEXT_FORMAT;
+  } else if (format == "binary") {
+    return ShowSaver::BINARY_FORMAT;
+  }
+  OLA_FATAL << "Unknown show format " << format << ", use text or binary";
+  exit(ola::EXIT_USAGE);
+}
+
+/**
+ * Get the TimeCode type from the --timecode flag
+ */
+ola::timecode::TimeCodeType TimeCodeType() {
+  string type = FLAGS_timecode.str();
+  ola::ToLower(&type);
+  if (type == "film") {
+    return ola::timecode::TIMECODE_FILM;
+  } else if (type == "ebu") {
+    return ola::timecode::TIMECODE_EBU;
+  } else if (type == "df") {
+    return ola::timecode::TIMECODE_DF;
+  } else if (type == "smpte") {
+    return ola::timecode::TIMECODE_SMPTE;
+  }
+  OLA_FATAL << "Invalid TimeCode format " << type;
+  exit(ola::EXIT_USAGE);
+}
+
 /**
  * Record a show
  */
@@ -81,7 +124,7 @@ int RecordShow() {
     universes.push_back(universe);
   }
 
-  ShowRecorder show_recorder(FLAGS_record.str(), universes);
+  ShowRecorder show_recorder(FLAGS_record.str(), universes, ShowFormat());
   int status = show_recorder.Init();
   if (status)
     return status;
@@ -151,28 +194,84 @@ int VerifyShow(const string &filename) {
   }
 }
 
+/**
+ * Convert a show file to the format given by --format
+ */
+int ConvertShow(const string &filename) {
+  if (FLAGS_output.str().empty()) {
+    OLA_FATAL << "No output file specified, use --output";
+    exit(ola::EXIT_USAGE);
+  }
+
+  ShowLoader loader(filename);
+  if (!loader.Load())
+    return ola::EXIT_NOINPUT;
+
+  ShowSaver saver(FLAGS_output.str(), ShowFormat());
+  if (!saver.Open())
+    return ola::EXIT_CANTCREAT;
+
+  ola::Clock clock;
+  ola::TimeStamp arrival_time;
+  clock.CurrentTime(&arrival_time);
+
+  unsigned int universe;
+  ola::DmxBuffer buffer;
+  unsigned int timeout;
+  unsigned int frames = 0;
+  ShowLoader::State state;
+  while (true) {
+    state = loader.NextFrame(&universe, &buffer);
+    if (state != ShowLoader::OK)
+      break;
+    if (!saver.NewFrame(arrival_time, universe, buffer))
+      return ola::EXIT_IOERR;
+    frames++;
+
+    state = loader.NextTimeout(&timeout);
+    if (state != ShowLoader::OK)
+      break;
+    arrival_time += ola::TimeInterval(static_cast<int64_t>(timeout) * 1000);
+  }
+  saver.Close();
+
+  if (state != ShowLoader::END_OF_FILE) {
+    OLA_FATAL << "Error loading show, got state " << state;
+    return ola::EXIT_DATAERR;
+  }
+  cout << "Converted " << frames << " frames" << endl;
+  return ola::EXIT_OK;
+}
+
 /*
  * Main
  */
 int main(int argc, char *argv[]) {
   ola::AppInit(&argc, argv,
                "[--record <file> --universes <universe_list>] [--playback "
-               "<file>] [--verify <file>]",
+               "<file>] [--verify <file>] [--convert <file> --output <file>]",
                "Record a series of universes, or playback a previously "
                "recorded show.");
 
   if (!FLAGS_playback.str().empty()) {
     ShowPlayer player(FLAGS_playback.str());
+    if (!FLAGS_timecode.str().empty()) {
+      player.SendTimeCode(TimeCodeType());
+    }
     int status = player.Init();
     if (!status)
-      status = player.Playback(FLAGS_iterations, FLAGS_duration, FLAGS_delay);
+      status = player.Playback(FLAGS_iterations, FLAGS_duration, FLAGS_delay,
+                               FLAGS_start);
     return status;
   } else if (!FLAGS_record.str().empty()) {
     return RecordShow();
   } else if (!FLAGS_verify.str().empty()) {
     return VerifyShow(FLAGS_verify.str());
+  } else if (!FLAGS_convert.str().empty()) {
+    return ConvertShow(FLAGS_convert.str());
   } else {
-    OLA_FATAL << "One of --record or --playback or --verify must be provided";
+    OLA_FATAL << "One of --record, --playback, --verify or --convert must be "
+                 "provided";
     ola::DisplayUsage();
   }
   return ola::EXIT_OK;
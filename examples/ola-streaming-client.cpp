@@ -41,6 +41,12 @@ DEFINE_s_string(dmx, d, "", "Comma separated DMX values to send, e.g. "
 DEFINE_s_uint32(universe, u, 1, "The universe to send data for");
 DEFINE_uint8(priority, ola::dmx::SOURCE_PRIORITY_DEFAULT,
              "The source priority to send data at");
+DEFINE_default_bool(shared_memory, false,
+                    "Send the data to olad through shared memory, olad must "
+                    "be run with --shared-memory-poll-ms.");
+DEFINE_string(socket, "",
+              "Connect to olad through the unix domain socket at this path, "
+              "olad must be run with --rpc-socket.");
 
 bool terminate = false;
 
@@ -70,7 +76,10 @@ int main(int argc, char *argv[]) {
                "Send DMX512 data to OLA. If DMX512 data isn't provided, it "
                "will read from STDIN.");
 
-  StreamingClient ola_client;
+  StreamingClient::Options options;
+  options.use_shared_memory = FLAGS_shared_memory;
+  options.socket_path = FLAGS_socket.str();
+  StreamingClient ola_client(options);
   if (!ola_client.Setup()) {
     OLA_FATAL << "Setup failed";
     exit(1);
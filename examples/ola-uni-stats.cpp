@@ -14,7 +14,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  *
  * ola-uni-stats.cpp
- * Display some simple universe stats.
+ * Display the health of universes, using the stats olad keeps for each one.
  * Copyright (C) 2012 Simon Newton
  */
 
@@ -22,29 +22,30 @@
 #include <signal.h>
 #include <stdlib.h>
 
+#include <ola/Callback.h>
 #include <ola/Clock.h>
-#include <ola/Constants.h>
-#include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
-#include <ola/OlaCallbackClient.h>
-#include <ola/OlaClientWrapper.h>
 #include <ola/StringUtils.h>
 #include <ola/base/Flags.h>
 #include <ola/base/Init.h>
 #include <ola/base/SysExits.h>
+#include <ola/client/ClientWrapper.h>
+#include <ola/client/OlaClient.h>
 #include <ola/io/StdinHandler.h>
 
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
-using ola::DmxBuffer;
-using ola::OlaCallbackClientWrapper;
 using ola::StringToInt;
 using ola::TimeInterval;
 using ola::TimeStamp;
+using ola::client::OlaClientWrapper;
+using ola::client::Result;
+using ola::client::UniverseStats;
 using ola::io::SelectServer;
 using std::cerr;
 using std::cout;
@@ -53,11 +54,20 @@ using std::setw;
 using std::string;
 using std::vector;
 
+DEFINE_s_uint32(interval, i, 1000, "The time between updates, in ms.");
 
+/**
+ * Poll olad for the universe stats and display the rates.
+ *
+ * Registering for DMX would send every frame to this program, which costs
+ * olad as much as another output. Instead olad keeps counters for each
+ * universe, and the rates are worked out from the change between polls.
+ */
 class UniverseTracker {
  public:
-    UniverseTracker(OlaCallbackClientWrapper *wrapper,
-                    const vector<unsigned int> &universes);
+    UniverseTracker(OlaClientWrapper *wrapper,
+                    const vector<unsigned int> &universes,
+                    const TimeInterval &interval);
     ~UniverseTracker() {}
 
     bool Run();
@@ -69,112 +79,94 @@ class UniverseTracker {
     void Input(int c);
 
  private:
-    struct UniverseStats {
-     public:
-      uint16_t shortest_frame;
-      uint16_t longest_frame;
-      uint64_t frame_count;
-      uint64_t frame_changes;
-      DmxBuffer frame_data;
-
-      UniverseStats() { Reset(); }
-
-      void Reset() {
-        shortest_frame = ola::DMX_UNIVERSE_SIZE + 1,
-        longest_frame = 0;
-        frame_count = 0;
-        frame_changes = 0;
-      }
+    struct Sample {
+      TimeStamp time;
+      UniverseStats stats;
     };
 
-    typedef std::map<unsigned int, UniverseStats> UniverseStatsMap;
-    UniverseStatsMap m_stats;
-    ola::TimeStamp m_start_time;
-    OlaCallbackClientWrapper *m_wrapper;
+    typedef std::map<unsigned int, Sample> SampleMap;
+
+    const vector<unsigned int> m_universes;
+    const TimeInterval m_interval;
+    // The stats from the last poll, used to work out the rates.
+    SampleMap m_last;
+    // The stats when the counters were last reset.
+    SampleMap m_start;
+    vector<UniverseStats> m_current;
+    TimeStamp m_current_time;
+    bool m_reset_pending;
+    bool m_request_pending;
+    OlaClientWrapper *m_wrapper;
     ola::io::StdinHandler m_stdin_handler;
     ola::Clock m_clock;
 
-    void UniverseData(unsigned int universe, const DmxBuffer &dmx,
-                      const string &error);
-    void RegisterComplete(const string &error);
+    bool Poll();
+    void StatsReceived(const Result &result,
+                       const vector<UniverseStats> &stats);
+    void PrintRates();
+    static float Rate(uint64_t current, uint64_t last,
+                      const TimeInterval &interval);
 };
 
 
-UniverseTracker::UniverseTracker(OlaCallbackClientWrapper *wrapper,
-                                 const vector<unsigned int> &universes)
-    : m_wrapper(wrapper),
+UniverseTracker::UniverseTracker(OlaClientWrapper *wrapper,
+                                 const vector<unsigned int> &universes,
+                                 const TimeInterval &interval)
+    : m_universes(universes),
+      m_interval(interval),
+      m_reset_pending(true),
+      m_request_pending(false),
+      m_wrapper(wrapper),
       m_stdin_handler(wrapper->GetSelectServer(),
                       ola::NewCallback(this, &UniverseTracker::Input)) {
-  // set callback
-  m_wrapper->GetClient()->SetDmxCallback(
-      ola::NewCallback(this, &UniverseTracker::UniverseData));
-
-  vector<unsigned int>::const_iterator iter = universes.begin();
-  for (; iter != universes.end(); ++iter) {
-    struct UniverseStats stats;
-    m_stats[*iter] = stats;
-
-    // register here
-    m_wrapper->GetClient()->RegisterUniverse(
-      *iter,
-      ola::REGISTER,
-      ola::NewSingleCallback(this, &UniverseTracker::RegisterComplete));
-  }
 }
 
 
 bool UniverseTracker::Run() {
-  m_clock.CurrentTime(&m_start_time);
+  Poll();
+  m_wrapper->GetSelectServer()->RegisterRepeatingTimeout(
+      m_interval,
+      ola::NewCallback(this, &UniverseTracker::Poll));
   m_wrapper->GetSelectServer()->Run();
   return true;
 }
 
 
+/*
+ * Print the totals since the counters were reset.
+ */
 void UniverseTracker::PrintStats() {
-  UniverseStatsMap::iterator iter = m_stats.begin();
-  TimeStamp now;
-  m_clock.CurrentTime(&now);
-
-  TimeInterval interval = now - m_start_time;
-  OLA_INFO << "Time delta was " << interval;
-
-  for (; iter != m_stats.end(); ++iter) {
-    const UniverseStats stats = iter->second;
-
-    float fps = 0.0;
-    if (interval.Seconds() > 0)
-      fps = static_cast<float>(stats.frame_count) / interval.Seconds();
-
-    cout << "Universe " << iter->first << endl;
-    cout << "  Frames Received: " << stats.frame_count <<
-      ", Frames/sec: " << fps << endl;
-    cout << "  Frame changes: " << stats.frame_changes << endl;
-    cout << "  Smallest Frame: ";
-    if (stats.shortest_frame == ola::DMX_UNIVERSE_SIZE + 1)
-      cout << "N/A";
-    else
-      cout << stats.shortest_frame;
-    cout << ", Largest Frame: ";
-    if (stats.longest_frame == 0)
-      cout << "N/A";
-    else
-      cout << stats.longest_frame;
-    cout << endl;
+  vector<UniverseStats>::const_iterator iter = m_current.begin();
+  for (; iter != m_current.end(); ++iter) {
+    SampleMap::const_iterator start = m_start.find(iter->universe);
+    if (start == m_start.end()) {
+      continue;
+    }
+    TimeInterval interval = m_current_time - start->second.time;
+    const UniverseStats &stats = start->second.stats;
+    cout << "Universe " << iter->universe << endl;
+    cout << "  Frames Sent: " << iter->frames - stats.frames
+         << ", Frames/sec: "
+         << Rate(iter->frames, stats.frames, interval) << endl;
+    cout << "  Merges: " << iter->merges - stats.merges << endl;
+    cout << "  Input Ports: " << iter->input_ports << ", Source Clients: "
+         << iter->source_clients << ", Active Sources: "
+         << iter->active_sources << endl;
+    cout << "  Latency (us) p50: " << iter->latency_p50 << ", p99: "
+         << iter->latency_p99 << ", p99.9: " << iter->latency_p999
+         << endl;
     cout << "------------------------------" << endl;
   }
 }
 
 
 void UniverseTracker::ResetStats() {
-  m_clock.CurrentTime(&m_start_time);
-
-  UniverseStatsMap::iterator iter = m_stats.begin();
-  for (; iter != m_stats.end(); ++iter) {
-    iter->second.Reset();
-  }
+  m_reset_pending = true;
+  Poll();
   cout << "Reset counters" << endl;
 }
 
+
 void UniverseTracker::Input(int c) {
   switch (c) {
     case 'q':
@@ -192,43 +184,82 @@ void UniverseTracker::Input(int c) {
 }
 
 
-void UniverseTracker::UniverseData(unsigned int universe, const DmxBuffer &dmx,
-                                   const string &error) {
-  if (!error.empty()) {
-    OLA_WARN << error;
-    return;
+bool UniverseTracker::Poll() {
+  // Don't queue up requests if olad is slow to reply.
+  if (!m_request_pending) {
+    m_request_pending = true;
+    m_wrapper->GetClient()->FetchUniverseStats(
+        m_universes,
+        ola::NewSingleCallback(this, &UniverseTracker::StatsReceived));
   }
+  return true;
+}
 
-  UniverseStatsMap::iterator iter = m_stats.find(universe);
-  if (iter == m_stats.end()) {
-    OLA_WARN << "Received data for unknown universe " << universe;
+
+void UniverseTracker::StatsReceived(const Result &result,
+                                    const vector<UniverseStats> &stats) {
+  m_request_pending = false;
+  if (!result.Success()) {
+    OLA_WARN << result.Error();
     return;
   }
 
-  if (dmx.Size() < iter->second.shortest_frame)
-    iter->second.shortest_frame = dmx.Size();
+  m_clock.CurrentTime(&m_current_time);
+  m_current = stats;
+  PrintRates();
+
+  vector<UniverseStats>::const_iterator iter = m_current.begin();
+  for (; iter != m_current.end(); ++iter) {
+    Sample &last = m_last[iter->universe];
+    last.time = m_current_time;
+    last.stats = *iter;
+    if (m_reset_pending || m_start.find(iter->universe) == m_start.end()) {
+      m_start[iter->universe] = last;
+    }
+  }
+  m_reset_pending = false;
+}
 
-  if (dmx.Size() > iter->second.longest_frame)
-    iter->second.longest_frame = dmx.Size();
 
-  iter->second.frame_count++;
+/*
+ * Print a line for each universe, with the rates since the last poll.
+ */
+void UniverseTracker::PrintRates() {
+  cout << setw(8) << "Universe" << setw(10) << "Frames/s" << setw(10)
+       << "Merges/s" << setw(9) << "Sources" << setw(10) << "p50 (us)"
+       << setw(10) << "p99 (us)" << setw(12) << "p99.9 (us)" << endl;
 
-  DmxBuffer &last_dmx = iter->second.frame_data;
-  if (last_dmx.Size() == 0) {
-    // this is the first frame
-    last_dmx.Set(dmx);
-  } else {
-    if (last_dmx.Size() != dmx.Size() || last_dmx != dmx) {
-      // the frame changed
-      iter->second.frame_changes++;
-      last_dmx.Set(dmx);
+  vector<UniverseStats>::const_iterator iter = m_current.begin();
+  for (; iter != m_current.end(); ++iter) {
+    float fps = 0.0;
+    float merges = 0.0;
+    SampleMap::const_iterator last = m_last.find(iter->universe);
+    if (last != m_last.end()) {
+      TimeInterval interval = m_current_time - last->second.time;
+      fps = Rate(iter->frames, last->second.stats.frames, interval);
+      merges = Rate(iter->merges, last->second.stats.merges, interval);
     }
+
+    std::ostringstream sources;
+    sources << iter->active_sources << "/"
+            << iter->input_ports + iter->source_clients;
+
+    cout << setw(8) << iter->universe << setw(10) << std::fixed
+         << std::setprecision(1) << fps << setw(10) << merges << setw(9)
+         << sources.str() << setw(10) << iter->latency_p50 << setw(10)
+         << iter->latency_p99 << setw(12) << iter->latency_p999 << endl;
   }
 }
 
-void UniverseTracker::RegisterComplete(const string &error) {
-  if (!error.empty())
-    OLA_WARN << "Register command failed with " << errno;
+
+float UniverseTracker::Rate(uint64_t current, uint64_t last,
+                            const TimeInterval &interval) {
+  int64_t useconds = interval.AsInt();
+  // The counters restart if olad does.
+  if (useconds <= 0 || current < last) {
+    return 0.0;
+  }
+  return static_cast<float>(current - last) * ola::USEC_IN_SECONDS / useconds;
 }
 
 
@@ -250,8 +281,9 @@ int main(int argc, char *argv[]) {
   ola::AppInit(
       &argc,
       argv,
-      "[options] <universe1> <universe2> ...",
-      "Watch one or more universes and produce stats on DMX frame rates.");
+      "[options] [<universe1> <universe2> ...]",
+      "Display the frame rate, merges, sources and latency of one or more "
+      "universes. If no universes are given, all universes are shown.");
 
   vector<unsigned int> universes;
   for (int i = 1; i < argc; i++) {
@@ -263,23 +295,25 @@ int main(int argc, char *argv[]) {
     universes.push_back(universe);
   }
 
-  if (universes.size() <= 0) {
-    ola::DisplayUsageAndExit();
+  if (FLAGS_interval == 0) {
+    cerr << "The interval must be greater than 0" << endl;
+    exit(ola::EXIT_USAGE);
   }
 
-  ola::OlaCallbackClientWrapper ola_client;
+  OlaClientWrapper ola_client;
   if (!ola_client.Setup()) {
     OLA_FATAL << "Setup failed";
     exit(ola::EXIT_UNAVAILABLE);
   }
   ss = ola_client.GetSelectServer();
 
-  UniverseTracker tracker(&ola_client, universes);
+  TimeInterval interval(static_cast<int64_t>(FLAGS_interval) * 1000);
+  UniverseTracker tracker(&ola_client, universes, interval);
   ola::InstallSignal(SIGINT, InteruptSignal);
   cout << "Actions:" << endl;
-  cout << "  p - Print stats" << endl;
+  cout << "  p - Print totals" << endl;
   cout << "  q - Quit" << endl;
-  cout << "  r - Reset stats" << endl;
+  cout << "  r - Reset totals" << endl;
   bool r = tracker.Run();
   if (r)
     tracker.PrintStats();
@@ -105,6 +105,9 @@
 #ifndef INCLUDE_OLA_CALLBACK_H_
 #define INCLUDE_OLA_CALLBACK_H_
 
+#include <ola/CallbackPool.h>
+#include <stddef.h>
+
 namespace ola {
 
 /**
@@ -120,6 +123,12 @@ class BaseCallback0 {
  public:
   virtual ~BaseCallback0() {}
   virtual ReturnType Run() = 0;
+
+  // The memory comes from the CallbackPool, see CallbackPool.h
+  void *operator new(size_t size) { return AllocateCallback(size); }
+  void operator delete(void *ptr, size_t size) {
+    FreeCallback(ptr, size);
+  }
 };
 
 /**
@@ -983,6 +992,12 @@ class BaseCallback1 {
  public:
   virtual ~BaseCallback1() {}
   virtual ReturnType Run(Arg0 arg0) = 0;
+
+  // The memory comes from the CallbackPool, see CallbackPool.h
+  void *operator new(size_t size) { return AllocateCallback(size); }
+  void operator delete(void *ptr, size_t size) {
+    FreeCallback(ptr, size);
+  }
 };
 
 /**
@@ -1886,6 +1901,12 @@ class BaseCallback2 {
  public:
   virtual ~BaseCallback2() {}
   virtual ReturnType Run(Arg0 arg0, Arg1 arg1) = 0;
+
+  // The memory comes from the CallbackPool, see CallbackPool.h
+  void *operator new(size_t size) { return AllocateCallback(size); }
+  void operator delete(void *ptr, size_t size) {
+    FreeCallback(ptr, size);
+  }
 };
 
 /**
@@ -2829,6 +2850,12 @@ class BaseCallback3 {
  public:
   virtual ~BaseCallback3() {}
   virtual ReturnType Run(Arg0 arg0, Arg1 arg1, Arg2 arg2) = 0;
+
+  // The memory comes from the CallbackPool, see CallbackPool.h
+  void *operator new(size_t size) { return AllocateCallback(size); }
+  void operator delete(void *ptr, size_t size) {
+    FreeCallback(ptr, size);
+  }
 };
 
 /**
@@ -3812,6 +3839,12 @@ class BaseCallback4 {
  public:
   virtual ~BaseCallback4() {}
   virtual ReturnType Run(Arg0 arg0, Arg1 arg1, Arg2 arg2, Arg3 arg3) = 0;
+
+  // The memory comes from the CallbackPool, see CallbackPool.h
+  void *operator new(size_t size) { return AllocateCallback(size); }
+  void operator delete(void *ptr, size_t size) {
+    FreeCallback(ptr, size);
+  }
 };
 
 /**
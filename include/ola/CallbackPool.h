@@ -0,0 +1,73 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * CallbackPool.h
+ * Per-thread memory pools for Callback objects.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup callbacks
+ * @{
+ * @file CallbackPool.h
+ * @brief Per-thread memory pools for Callback objects.
+ *
+ * Callbacks are allocated & freed on almost every asynchronous path. When the
+ * pool is enabled, the memory for a deleted callback is kept on a free list
+ * for the current thread, and reused by the next callback of the same size
+ * class. This removes the calls to malloc() from the steady state.
+ *
+ * The pool can be enabled or disabled at any time; memory from the pool and
+ * the heap is interchangeable.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_CALLBACKPOOL_H_
+#define INCLUDE_OLA_CALLBACKPOOL_H_
+
+#include <stddef.h>
+
+namespace ola {
+
+/**
+ * @addtogroup callbacks
+ * @{
+ */
+
+/**
+ * @brief Enable or disable the callback pool.
+ * @param enabled true to reuse the memory of deleted callbacks.
+ *
+ * The pool is disabled by default.
+ */
+void SetCallbackPoolEnabled(bool enabled);
+
+/**
+ * @brief Check if the callback pool is enabled.
+ */
+bool CallbackPoolEnabled();
+
+/**
+ * @cond HIDDEN_SYMBOLS
+ * These are used by operator new & delete of the callback classes.
+ */
+void *AllocateCallback(size_t size);
+void FreeCallback(void *ptr, size_t size);
+/**
+ * @endcond
+ * @}
+ */
+}  // namespace ola
+#endif  // INCLUDE_OLA_CALLBACKPOOL_H_
@@ -241,6 +241,53 @@ class Clock {
 };
 
 
+/**
+ * @brief A Clock that returns a time kept up to date by someone else.
+ *
+ * This is usually given the SelectServer's WakeUpTime(), which is updated
+ * once each time round the event loop. Reading it is much cheaper than
+ * reading the system clock, but the time may be stale by however long the
+ * current iteration of the loop has been running. Only use it where that
+ * doesn't matter.
+ */
+class CachedClock: public Clock {
+ public:
+  /**
+   * @brief Create a new CachedClock.
+   * @param now the time to return, this must outlive the CachedClock.
+   */
+  explicit CachedClock(const TimeStamp *now) : Clock(), m_now(now) {}
+
+  void CurrentTime(TimeStamp *timestamp) const { *timestamp = *m_now; }
+
+ private:
+  const TimeStamp *m_now;
+};
+
+
+/**
+ * @brief A Clock that reads the monotonic clock.
+ *
+ * The times returned aren't related to the wall clock, and so can't be
+ * compared with times from other Clocks, but they never jump when the system
+ * time is changed. Use this for measuring intervals.
+ */
+class MonotonicClock: public Clock {
+ public:
+  /**
+   * @brief Create a new MonotonicClock.
+   * @param coarse use the coarse monotonic clock if the platform has one.
+   *   This is cheaper to read but only updated every few milliseconds.
+   */
+  explicit MonotonicClock(bool coarse = false);
+
+  void CurrentTime(TimeStamp *timestamp) const;
+
+ private:
+  int m_clock_id;
+};
+
+
 /**
  * A Mock Clock used for testing.
  */
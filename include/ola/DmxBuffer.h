@@ -29,7 +29,7 @@
 #include <stdint.h>
 #include <iostream>
 #include <string>
-
+#include <ola/DmxView.h>
 
 namespace ola {
 
@@ -78,6 +78,31 @@ class DmxBuffer {
      */
     explicit DmxBuffer(const std::string &data);
 
+    /**
+     * @brief Create a new buffer from a view.
+     * @param view the data to copy into the new buffer.
+     */
+    explicit DmxBuffer(const DmxView &view);
+
+#if __cplusplus >= 201103L
+    /**
+     * @brief Move constructor.
+     * This takes the data from the other buffer without touching the
+     * reference count, the other buffer is left empty.
+     * @param other The other DmxBuffer to move from
+     */
+    DmxBuffer(DmxBuffer &&other) noexcept
+        : m_ref_count(other.m_ref_count),
+          m_copy_on_write(other.m_copy_on_write),
+          m_data(other.m_data),
+          m_length(other.m_length) {
+      other.m_ref_count = NULL;
+      other.m_copy_on_write = false;
+      other.m_data = NULL;
+      other.m_length = 0;
+    }
+#endif  // __cplusplus >= 201103L
+
     /**
      * @brief Destructor
      */
@@ -90,6 +115,30 @@ class DmxBuffer {
      */
     DmxBuffer& operator=(const DmxBuffer &other);
 
+#if __cplusplus >= 201103L
+    /**
+     * @brief Move assignment operator.
+     * @param other the other DmxBuffer to move from, this is left empty.
+     */
+    DmxBuffer& operator=(DmxBuffer &&other) noexcept {
+      if (this != &other) {
+        DmxBuffer empty;
+        Swap(empty);
+        Swap(other);
+      }
+      return *this;
+    }
+#endif  // __cplusplus >= 201103L
+
+    /**
+     * @brief Exchange the contents of this buffer with another one.
+     *
+     * This only swaps the underlying pointers, so it's a cheap way to hand
+     * data from one buffer to another.
+     * @param other the DmxBuffer to swap with.
+     */
+    void Swap(DmxBuffer &other);
+
     /**
      * @brief Equality operator used to check if two DmxBuffers are equal.
      * @param other is the other DmxBuffer to check against
@@ -117,6 +166,17 @@ class DmxBuffer {
      */
     bool HTPMerge(const DmxBuffer &other);
 
+    /**
+     * @brief HTP Merge from a number of other DmxBuffers in a single pass.
+     *
+     * This produces the same result as calling HTPMerge() once per buffer,
+     * but avoids writing out the whole universe after each buffer.
+     * @param buffers an array of pointers to the DmxBuffers to merge
+     * @param count the number of buffers in the array
+     * @return false if the merge failed, and true if merge was successful
+     */
+    bool HTPMerge(const DmxBuffer *const *buffers, unsigned int count);
+
     /**
      * @brief Set the contents of this DmxBuffer
      * @param data is a pointer to an array of uint8_t values
@@ -143,6 +203,14 @@ class DmxBuffer {
      */
     bool Set(const DmxBuffer &other);
 
+    /**
+     * @brief Set the contents of this DmxBuffer from a view.
+     * @param view the data to copy
+     * @return true if the set was successful and false if it failed
+     * @post Size() == view.Size()
+     */
+    bool Set(const DmxView &view);
+
     /**
      * @brief Set values from a string.
      * Convert a comma separated list of values into for the DmxBuffer. Invalid
@@ -234,6 +302,15 @@ class DmxBuffer {
      */
     const uint8_t *GetRaw() const { return m_data; }
 
+    /**
+     * @brief Get a read-only view of the data.
+     *
+     * This doesn't copy the data or change the reference count. The view is
+     * invalidated by any change to this buffer.
+     * @return a DmxView of the data in this buffer
+     */
+    DmxView View() const { return DmxView(m_data, m_length); }
+
     /**
      * @brief Get the raw contents of the DmxBuffer as a string.
      * @return a string of raw channel values
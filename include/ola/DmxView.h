@@ -0,0 +1,86 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxView.h
+ * A read-only view of DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file DmxView.h
+ * @brief A read-only view of a universe of DMX data.
+ */
+
+#ifndef INCLUDE_OLA_DMXVIEW_H_
+#define INCLUDE_OLA_DMXVIEW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ola {
+
+/**
+ * @class DmxView ola/DmxView.h
+ * @brief A read-only view of DMX data owned by something else.
+ *
+ * A DmxView is just a pointer and a length, so it can be passed by value and
+ * creating one never copies the data or touches the reference count of a
+ * DmxBuffer. The view is only valid while the underlying data is unchanged.
+ */
+class DmxView {
+ public:
+    /**
+     * @brief Create an empty view, Size() == 0.
+     */
+    DmxView()
+        : m_data(NULL),
+          m_length(0) {
+    }
+
+    /**
+     * @brief Create a view of raw data.
+     * @param data a pointer to the data.
+     * @param length the number of slots in data.
+     */
+    DmxView(const uint8_t *data, unsigned int length)
+        : m_data(length ? data : NULL),
+          m_length(data ? length : 0) {
+    }
+
+    /**
+     * @brief The number of slots in the view.
+     */
+    unsigned int Size() const { return m_length; }
+
+    /**
+     * @brief Get a raw pointer to the data, this may be NULL if Size() == 0.
+     */
+    const uint8_t *GetRaw() const { return m_data; }
+
+    /**
+     * @brief Get the value of a slot.
+     * @param slot the slot to return, starting from 0.
+     * @returns the value of the slot, or 0 if the slot isn't in the view.
+     */
+    uint8_t Get(unsigned int slot) const {
+      return slot < m_length ? m_data[slot] : 0;
+    }
+
+ private:
+    const uint8_t *m_data;
+    unsigned int m_length;
+};
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMXVIEW_H_
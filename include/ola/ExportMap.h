@@ -42,6 +42,8 @@
 
 namespace ola {
 
+class Histogram;
+
 /**
  * @class BaseVariable <ola/ExportMap.h>
  * @brief The base variable class.
@@ -209,9 +211,26 @@ class MapVariable: public BaseVariable {
   void Remove(const std::string &key);
   void Set(const std::string &key, Type value);
   Type &operator[](const std::string &key);
+
+  /**
+   * @brief Return a pointer to the value for a key, creating it if it doesn't
+   * exist.
+   * @param key the key to return the value for.
+   * @returns a pointer which remains valid until the key is removed.
+   *
+   * Code that updates a value frequently should fetch the pointer once,
+   * rather than looking up the key on every update.
+   */
+  Type *Handle(const std::string &key) { return &m_variables[key]; }
+
   const std::string Value() const;
   const std::string Label() const { return m_label; }
 
+  /**
+   * @brief Return the values, keyed by name.
+   */
+  const std::map<std::string, Type> &Values() const { return m_variables; }
+
  protected:
   std::map<std::string, Type> m_variables;
 
@@ -315,6 +334,49 @@ inline const std::string MapVariable<std::string>::Value() const {
 }
 
 
+/**
+ * @brief A map of Histograms, which are owned by the caller.
+ *
+ * On the /debug page this shows the number of values recorded in each
+ * histogram. The buckets are exported by ExportMap::RenderOpenMetrics().
+ */
+class HistogramMap: public BaseVariable {
+ public:
+  HistogramMap(const std::string &name, const std::string &label)
+      : BaseVariable(name),
+        m_label(label) {}
+  ~HistogramMap() {}
+
+  /**
+   * @brief Add a histogram to the map.
+   * @param key the key for the histogram.
+   * @param histogram the histogram, which must remain valid until it's
+   *   removed from the map.
+   */
+  void Set(const std::string &key, const Histogram *histogram) {
+    m_histograms[key] = histogram;
+  }
+
+  /**
+   * @brief Remove a histogram from the map.
+   * @param key the key to remove.
+   */
+  void Remove(const std::string &key) { m_histograms.erase(key); }
+
+  const std::string Value() const;
+  const std::string Label() const { return m_label; }
+
+  /**
+   * @brief Return the histograms, keyed by name.
+   */
+  const std::map<std::string, const Histogram*> &Histograms() const {
+    return m_histograms;
+  }
+
+ private:
+  std::map<std::string, const Histogram*> m_histograms;
+  std::string m_label;
+};
 
 
 /**
@@ -371,6 +433,8 @@ class ExportMap {
   IntMap *GetIntMapVar(const std::string &name, const std::string &label = "");
   UIntMap *GetUIntMapVar(const std::string &name,
                          const std::string &label = "");
+  HistogramMap *GetHistogramMapVar(const std::string &name,
+                                   const std::string &label = "");
 
   /**
    * @brief Fetch a list of all known variables.
@@ -378,6 +442,19 @@ class ExportMap {
    */
   std::vector<BaseVariable*> AllVariables() const;
 
+  /**
+   * @brief Render all variables in the OpenMetrics text format.
+   * @param[out] output the string to append the metrics to.
+   *
+   * Each variable becomes a metric family named ola_ followed by the variable
+   * name, with any characters that aren't allowed replaced by underscores.
+   * Counters are exported as counters, integers and IntMaps as gauges,
+   * UIntMaps as unknown, since some of them are counters and some gauges,
+   * and strings as info metrics. Map keys become a label named after the
+   * map's label.
+   */
+  void RenderOpenMetrics(std::string *output) const;
+
  private :
   template<typename Type>
   Type *GetVar(std::map<std::string, Type*> *var_map,
@@ -396,6 +473,7 @@ class ExportMap {
   std::map<std::string, StringMap*> m_str_map_variables;
   std::map<std::string, IntMap*> m_int_map_variables;
   std::map<std::string, UIntMap*> m_uint_map_variables;
+  std::map<std::string, HistogramMap*> m_histogram_map_variables;
 
   DISALLOW_COPY_AND_ASSIGN(ExportMap);
 };
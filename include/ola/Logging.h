@@ -44,6 +44,8 @@
 #ifndef INCLUDE_OLA_LOGGING_H_
 #define INCLUDE_OLA_LOGGING_H_
 
+#include <stdint.h>
+#include <stdlib.h>
 #include <ostream>
 #include <string>
 #include <sstream>
@@ -90,8 +92,34 @@
  */
 #define OLA_DEBUG OLA_LOG(ola::OLA_LOG_DEBUG)
 
+/**
+ * @brief Log at most one message every interval seconds from this call site.
+ *
+ * Use this for messages that can be triggered by every packet received, so a
+ * misbehaving device can't flood the log. The next message that is logged
+ * includes the number that were suppressed.
+ * @code
+ *     OLA_LOG_RATE_LIMITED(ola::OLA_LOG_WARN, 10) << "Max sources reached";
+ * @endcode
+ * This declares a static variable, so it must be used as a statement.
+ * @param level the log_level to log at.
+ * @param interval the minimum number of seconds between messages.
+ */
+#define OLA_LOG_RATE_LIMITED(level, interval) \
+    static ola::LogRateLimiter OLA_LOG_LIMITER(__LINE__)(interval); \
+    (level <= ola::LogLevel()) && OLA_LOG_LIMITER(__LINE__).Allow() && \
+        ola::LogLine(__FILE__, __LINE__, level, \
+                     OLA_LOG_LIMITER(__LINE__).Suppressed()).stream()
+
+/**@cond HIDDEN_SYMBOLS*/
+#define OLA_LOG_LIMITER(line) OLA_LOG_LIMITER_NAME(line)
+#define OLA_LOG_LIMITER_NAME(line) ola_log_limiter_ ## line
+/**@endcond*/
+
 namespace ola {
 
+class Clock;
+
 /**
  * @brief The OLA log levels.
  * This controls the verbosity of logging. Each level also includes those below
@@ -219,7 +247,8 @@ class UnixSyslogDestination : public SyslogDestination {
  */
 class LogLine {
  public:
-  LogLine(const char *file, int line, log_level level);
+  LogLine(const char *file, int line, log_level level,
+          unsigned int suppressed = 0);
   ~LogLine();
   void Write();
 
@@ -228,9 +257,44 @@ class LogLine {
   log_level m_level;
   std::ostringstream m_stream;
   unsigned int m_prefix_length;
+  unsigned int m_suppressed;
 };
 /**@endcond*/
 
+/**
+ * @brief Limits how often a call site logs, see OLA_LOG_RATE_LIMITED.
+ */
+class LogRateLimiter {
+ public:
+  /**
+   * @brief Create a new LogRateLimiter.
+   * @param interval the minimum number of seconds between messages.
+   * @param clock the clock to use, or NULL to use the system clock. Ownership
+   *   is not transferred.
+   */
+  explicit LogRateLimiter(unsigned int interval, Clock *clock = NULL);
+
+  /**
+   * @brief Check if a message can be logged now.
+   * @returns true if the message should be logged, false if it should be
+   *   suppressed.
+   */
+  bool Allow();
+
+  /**
+   * @brief The number of messages suppressed before the last one that was
+   * allowed.
+   */
+  unsigned int Suppressed() const { return m_last_suppressed; }
+
+ private:
+  const unsigned int m_interval;
+  Clock *m_clock;
+  int64_t m_next_allowed;
+  unsigned int m_suppressed;
+  unsigned int m_last_suppressed;
+};
+
 /**
  * @addtogroup logging
  * @{
@@ -29,10 +29,12 @@ pkginclude_HEADERS += \
     include/ola/ActionQueue.h \
     include/ola/BaseTypes.h \
     include/ola/Callback.h \
+    include/ola/CallbackPool.h \
     include/ola/CallbackRunner.h \
     include/ola/Clock.h \
     include/ola/Constants.h \
     include/ola/DmxBuffer.h \
+    include/ola/DmxView.h \
     include/ola/ExportMap.h \
     include/ola/Logging.h \
     include/ola/MultiCallback.h \
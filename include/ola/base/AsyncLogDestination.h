@@ -0,0 +1,115 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * AsyncLogDestination.h
+ * A LogDestination that writes from a background thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup logging
+ * @{
+ * @file AsyncLogDestination.h
+ * @brief A LogDestination that writes from a background thread.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_BASE_ASYNCLOGDESTINATION_H_
+#define INCLUDE_OLA_BASE_ASYNCLOGDESTINATION_H_
+
+#include <ola/Logging.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/MPSCQueue.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+
+/**
+ * @addtogroup logging
+ * @{
+ */
+
+/**
+ * @brief Queues log lines and writes them to another LogDestination from a
+ * background thread.
+ *
+ * Write() only copies the line onto a lock-free queue, so a burst of messages
+ * doesn't block the caller on stderr or syslog. If more than max_queued_lines
+ * are waiting, new lines are dropped and the number dropped is logged once
+ * the queue drains. Fatal messages are written straight away, since the
+ * process is likely to exit before the thread runs.
+ */
+class AsyncLogDestination: public LogDestination,
+                           private ola::thread::Thread {
+ public:
+  /**
+   * @brief Create a new AsyncLogDestination.
+   * @param destination the LogDestination to write to, ownership is
+   *   transferred.
+   * @param max_queued_lines the maximum number of lines to queue.
+   */
+  explicit AsyncLogDestination(
+      LogDestination *destination,
+      unsigned int max_queued_lines = DEFAULT_MAX_QUEUED_LINES);
+
+  /**
+   * @brief Destructor, this writes any queued lines.
+   */
+  ~AsyncLogDestination();
+
+  /**
+   * @brief Start the background thread.
+   * @returns true if the thread started. Until then, lines are written on
+   *   the calling thread.
+   */
+  bool Init();
+
+  void Write(log_level level, const std::string &log_line);
+
+  static const unsigned int DEFAULT_MAX_QUEUED_LINES = 1000;
+
+ protected:
+  void *Run();
+
+ private:
+  struct QueuedLine {
+    QueuedLine(log_level level, const std::string &line)
+        : level(level), line(line) {}
+
+    log_level level;
+    std::string line;
+  };
+
+  LogDestination *m_destination;
+  const unsigned int m_max_queued_lines;
+  bool m_running;
+  ola::thread::MPSCQueue<QueuedLine*> m_queue;
+  unsigned int m_queued;
+  unsigned int m_dropped;
+  // Protects m_stop, and is held to signal the thread.
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_condition;
+  bool m_stop;
+
+  void WriteQueuedLines(std::vector<QueuedLine*> *lines);
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncLogDestination);
+};
+/**@}*/
+}  // namespace ola
+#endif  // INCLUDE_OLA_BASE_ASYNCLOGDESTINATION_H_
@@ -32,6 +32,7 @@
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/UIDSet.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -133,6 +134,26 @@ typedef SingleUseCallback2<void, const Result&, const ola::rdm::UIDSet&>
 typedef SingleUseCallback3<void, const Result&, const DMXMetadata&,
                            const DmxBuffer&> DMXCallback;
 
+/**
+ * @brief Called once when OlaClient::FetchDMXMulti() completes.
+ * @param result the Result of the API call.
+ * @param data a map of universe id to the DmxBuffer for that universe.
+ * Universes which don't exist are not included.
+ */
+typedef SingleUseCallback2<void, const Result&,
+                           const std::map<unsigned int, DmxBuffer>&>
+    MultiDMXCallback;
+
+/**
+ * @brief Called once when OlaClient::FetchUniverseStats() completes.
+ * @param result the Result of the API call.
+ * @param stats the UniverseStats for each universe. Universes which don't
+ * exist are not included.
+ */
+typedef SingleUseCallback2<void, const Result&,
+                           const std::vector<UniverseStats>&>
+    UniverseStatsCallback;
+
 /**
  * @brief Called when new DMX data arrives.
  * @param metadata the DMXMetadata associated with the frame.
@@ -153,6 +174,33 @@ typedef SingleUseCallback3<void, const Result&,
                            const RDMMetadata&,
                            const ola::rdm::RDMResponse*> RDMCallback;
 
+/**
+ * @brief Called as each command in a batch completes.
+ * Used with OlaClient::RDMBatch().
+ * @param index the index of the command in the batch.
+ * @param metadata the metadata for the response, including the
+ * rdm_response_code.
+ * @param response the RDM Response, or NULL if no response was received.
+ */
+typedef Callback3<void, unsigned int, const RDMMetadata&,
+                  const ola::rdm::RDMResponse*> RDMBatchResultCallback;
+
+/**
+ * @brief Called when subscribed slots change.
+ * Used with OlaClient::SetSlotChangeCallback().
+ * @param universe the universe the slots belong to.
+ * @param changes the changed slots, in the order of the subscribed ranges.
+ */
+typedef Callback2<void, unsigned int, const std::vector<SlotChange>&>
+    RepeatableSlotChangeCallback;
+
+/**
+ * @brief Called when the response to a polled GET changes.
+ * Used with OlaClient::SetRDMPollCallback().
+ * @param result the new response.
+ */
+typedef Callback1<void, const RDMPollResult&> RepeatableRDMPollCallback;
+
 
 }  // namespace client
 }  // namespace ola
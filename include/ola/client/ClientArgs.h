@@ -21,6 +21,7 @@
 #ifndef INCLUDE_OLA_CLIENT_CLIENTARGS_H_
 #define INCLUDE_OLA_CLIENT_CLIENTARGS_H_
 
+#include <ola/DmxBuffer.h>
 #include <ola/client/CallbackTypes.h>
 #include <ola/dmx/SourcePriorities.h>
 
@@ -65,6 +66,29 @@ enum DiscoveryType {
   DISCOVERY_FULL,  /**< Trigger full discovery */
 };
 
+/**
+ * @brief The desired patching of a port, used with OlaClient::PatchPorts().
+ */
+struct PortPatch {
+  unsigned int device_alias;  /**< The device containing the port */
+  unsigned int port;  /**< The port id */
+  PortDirection port_direction;  /**< The direction of the port */
+  PatchAction action;  /**< Patch or unpatch the port */
+  unsigned int universe;  /**< The universe to patch to, if action is PATCH */
+
+  PortPatch(unsigned int _device_alias,
+            unsigned int _port,
+            PortDirection _port_direction,
+            PatchAction _action,
+            unsigned int _universe)
+      : device_alias(_device_alias),
+        port(_port),
+        port_direction(_port_direction),
+        action(_action),
+        universe(_universe) {
+  }
+};
+
 /**
  * @brief Arguments passed to the SendDMX() method.
  */
@@ -78,13 +102,28 @@ struct SendDMXArgs {
    * @brief the Callback to run upon completion. Defaults to NULL.
    */
   GeneralSetCallback *callback;
+  /**
+   * @brief The per-slot priorities of the data, as used by the E1.31 0xDD
+   * start code. A slot priority of 0 means the slot isn't sourced. Defaults to
+   * NULL, which uses priority for all slots. The buffer must remain valid
+   * until SendDMX() returns.
+   */
+  const DmxBuffer *slot_priorities;
+  /**
+   * @brief If non-0, olad fades from the current data to the new data over
+   * this many milliseconds. Defaults to 0, which applies the data straight
+   * away.
+   */
+  unsigned int fade_time;
 
   /**
    * @brief Create a new SendDMXArgs object
    */
   SendDMXArgs()
       : priority(ola::dmx::SOURCE_PRIORITY_DEFAULT),
-        callback(NULL) {
+        callback(NULL),
+        slot_priorities(NULL),
+        fade_time(0) {
   }
 
   /**
@@ -92,7 +131,9 @@ struct SendDMXArgs {
    */
   explicit SendDMXArgs(GeneralSetCallback *_callback)
       : priority(ola::dmx::SOURCE_PRIORITY_DEFAULT),
-        callback(_callback) {
+        callback(_callback),
+        slot_priorities(NULL),
+        fade_time(0) {
   }
 };
 
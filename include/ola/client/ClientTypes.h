@@ -21,9 +21,11 @@
 #ifndef INCLUDE_OLA_CLIENT_CLIENTTYPES_H_
 #define INCLUDE_OLA_CLIENT_CLIENTTYPES_H_
 
+#include <ola/DmxBuffer.h>
 #include <ola/dmx/SourcePriorities.h>
 #include <ola/rdm/RDMFrame.h>
 #include <ola/rdm/RDMResponseCodes.h>
+#include <ola/rdm/UID.h>
 
 #include <olad/PortConstants.h>
 
@@ -305,6 +307,101 @@ class OlaUniverse {
   unsigned int m_rdm_device_count;
 };
 
+/**
+ * @brief A layer of a virtual universe.
+ *
+ * The data from the layer's universe is blended onto the virtual universe
+ * with a weight of mask * opacity / 255 for each slot.
+ */
+struct UniverseLayer {
+  /**
+   * @brief The universe to take the data from.
+   */
+  unsigned int universe;
+  /**
+   * @brief The opacity of the layer.
+   */
+  uint8_t opacity;
+  /**
+   * @brief The per-slot mask. If this is empty all slots are used.
+   */
+  DmxBuffer mask;
+
+  explicit UniverseLayer(unsigned int _universe, uint8_t _opacity = 255)
+      : universe(_universe),
+        opacity(_opacity) {
+  }
+};
+
+/**
+ * @brief A range of slots to watch with OlaClient::SubscribeSlots().
+ */
+struct SlotRange {
+  /**
+   * @brief The 0-based first slot.
+   */
+  uint16_t start;
+  /**
+   * @brief The number of slots.
+   */
+  uint16_t count;
+  /**
+   * @brief A slot is only sent once it differs from the last value sent by
+   * at least this much.
+   */
+  uint8_t threshold;
+
+  SlotRange(uint16_t _start, uint16_t _count, uint8_t _threshold = 1)
+      : start(_start),
+        count(_count),
+        threshold(_threshold) {
+  }
+};
+
+/**
+ * @brief The new value of a slot.
+ */
+struct SlotChange {
+  uint16_t slot;
+  uint8_t value;
+};
+
+/**
+ * @brief A changed response to a GET polled by olad.
+ * @sa OlaClient::SubscribeRDMPoll()
+ */
+struct RDMPollResult {
+  unsigned int universe;
+  ola::rdm::UID uid;
+  uint16_t sub_device;
+  uint16_t pid;
+  /**
+   * @brief The param data of the GET.
+   */
+  std::string request_data;
+  /**
+   * @brief The result of the GET.
+   */
+  ola::rdm::RDMStatusCode response_code;
+  /**
+   * @brief The RDM response type, if response_code is RDM_COMPLETED_OK.
+   */
+  uint8_t response_type;
+  /**
+   * @brief The param data of the response.
+   */
+  std::string data;
+
+  RDMPollResult()
+      : universe(0),
+        uid(0, 0),
+        sub_device(0),
+        pid(0),
+        response_code(ola::rdm::RDM_COMPLETED_OK),
+        response_type(0) {
+  }
+};
+
 /**
  * @brief Metadata that accompanies DMX packets
  */
@@ -326,6 +423,52 @@ struct DMXMetadata {
 };
 
 
+/**
+ * @brief The counters for a universe.
+ * @sa OlaClient::FetchUniverseStats()
+ */
+struct UniverseStats {
+  unsigned int universe;
+  /**
+   * @brief The number of frames olad has sent for the universe.
+   */
+  uint64_t frames;
+  /**
+   * @brief The number of times the sources have been merged.
+   */
+  uint64_t merges;
+  unsigned int input_ports;
+  unsigned int source_clients;
+  /**
+   * @brief The number of sources at the active priority in the last merge.
+   */
+  unsigned int active_sources;
+  /**
+   * @brief The number of source to output latencies recorded.
+   */
+  uint64_t latency_samples;
+  /**
+   * @brief The source to output latency percentiles, in microseconds.
+   */
+  uint32_t latency_p50;
+  uint32_t latency_p99;
+  uint32_t latency_p999;
+
+  UniverseStats()
+      : universe(0),
+        frames(0),
+        merges(0),
+        input_ports(0),
+        source_clients(0),
+        active_sources(0),
+        latency_samples(0),
+        latency_p50(0),
+        latency_p99(0),
+        latency_p999(0) {
+  }
+};
+
+
 /**
  * @brief Metadata that accompanies RDM Responses.
  */
@@ -350,6 +493,51 @@ struct RDMMetadata {
       : response_code(_response_code) {
   }
 };
+
+/**
+ * @brief A single RDM command in a batch.
+ * Used with OlaClient::RDMBatch().
+ */
+struct RDMBatchCommand {
+  /**
+   * @brief The universe to send the command on.
+   */
+  unsigned int universe;
+  /**
+   * @brief The UID to send the command to.
+   */
+  ola::rdm::UID uid;
+  /**
+   * @brief The sub device index.
+   */
+  uint16_t sub_device;
+  /**
+   * @brief The PID to address.
+   */
+  uint16_t pid;
+  /**
+   * @brief True for a SET, false for a GET.
+   */
+  bool is_set;
+  /**
+   * @brief The parameter data to send.
+   */
+  std::string data;
+
+  RDMBatchCommand(unsigned int _universe,
+                  const ola::rdm::UID &_uid,
+                  uint16_t _sub_device,
+                  uint16_t _pid,
+                  bool _is_set = false,
+                  const std::string &_data = "")
+      : universe(_universe),
+        uid(_uid),
+        sub_device(_sub_device),
+        pid(_pid),
+        is_set(_is_set),
+        data(_data) {
+  }
+};
 }  // namespace client
 }  // namespace ola
 #endif  // INCLUDE_OLA_CLIENT_CLIENTTYPES_H_
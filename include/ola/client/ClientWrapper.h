@@ -36,8 +36,10 @@
 #include <ola/io/SelectServer.h>
 #include <ola/network/SocketAddress.h>
 #include <ola/network/TCPSocket.h>
+#include <ola/network/UnixDomainSocket.h>
 
 #include <memory>
+#include <string>
 
 namespace ola {
 namespace client {
@@ -64,6 +66,13 @@ class BaseClientWrapper {
    */
   void SetCloseCallback(CloseCallback *callback);
 
+  /**
+   * @brief Connect to olad through a unix domain socket rather than TCP.
+   * @param path the path olad's --rpc-socket is listening on. This must be
+   *   called before Setup().
+   */
+  void SetSocketPath(const std::string &path) { m_socket_path = path; }
+
   /**
    * @brief Get the SelectServer used by this client.
    * @returns A pointer to a SelectServer, ownership isn't transferred.
@@ -89,7 +98,8 @@ class BaseClientWrapper {
   void SocketClosed();
 
  protected:
-  std::auto_ptr<ola::network::TCPSocket> m_socket;
+  std::auto_ptr<ola::io::ConnectedDescriptor> m_socket;
+  std::string m_socket_path;
 
  private:
   ola::io::SelectServer m_ss;
@@ -129,6 +139,7 @@ class GenericClientWrapper: public BaseClientWrapper {
   }
 
   bool StartupClient() {
+    m_client->SetPipelining(GetSelectServer());
     bool ok = m_client->Setup();
     m_client->SetCloseHandler(
       ola::NewSingleCallback(static_cast<BaseClientWrapper*>(this),
@@ -137,17 +148,24 @@ class GenericClientWrapper: public BaseClientWrapper {
   }
 
   void InitSocket() {
+    if (!m_socket_path.empty()) {
+      m_socket.reset(ola::network::UnixDomainSocket::Connect(m_socket_path));
+      return;
+    }
+
+    ola::network::TCPSocket *socket;
     if (m_auto_start) {
-      m_socket.reset(ola::client::ConnectToServer(OLA_DEFAULT_PORT));
+      socket = ola::client::ConnectToServer(OLA_DEFAULT_PORT);
     } else {
-      m_socket.reset(ola::network::TCPSocket::Connect(
+      socket = ola::network::TCPSocket::Connect(
           ola::network::IPV4SocketAddress(
             ola::network::IPV4Address::Loopback(),
-           OLA_DEFAULT_PORT)));
+           OLA_DEFAULT_PORT));
     }
-    if (m_socket.get()) {
-      m_socket->SetNoDelay();
+    if (socket) {
+      socket->SetNoDelay();
     }
+    m_socket.reset(socket);
   }
 };
 
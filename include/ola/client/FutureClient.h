@@ -0,0 +1,277 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FutureClient.h
+ * A client API which returns Futures.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file FutureClient.h
+ * @brief A client API which returns Futures.
+ */
+
+#ifndef INCLUDE_OLA_CLIENT_FUTURECLIENT_H_
+#define INCLUDE_OLA_CLIENT_FUTURECLIENT_H_
+
+#include <ola/Constants.h>
+#include <ola/base/Macro.h>
+#include <ola/client/ClientArgs.h>
+#include <ola/client/ClientTypes.h>
+#include <ola/rdm/UID.h>
+#include <ola/rdm/UIDSet.h>
+#include <ola/thread/Future.h>
+#include <stdint.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ola {
+
+namespace io {
+class ConnectedDescriptor;
+class SelectServer;
+}
+namespace rdm { class RDMResponse; }
+
+namespace client {
+
+class OlaClient;
+class Result;
+
+/**
+ * @brief The outcome of a FutureClient call.
+ */
+template <typename T>
+struct FutureResult {
+  /**
+   * @brief The error, empty if the call succeeded.
+   */
+  std::string error;
+
+  /**
+   * @brief The value, only valid if the call succeeded.
+   */
+  T value;
+
+  bool Success() const { return error.empty(); }
+};
+
+/**
+ * @brief The outcome of a FutureClient call which doesn't return a value.
+ */
+template <>
+struct FutureResult<void> {
+  std::string error;
+
+  bool Success() const { return error.empty(); }
+};
+
+/**
+ * @brief The reply to a RDM GET or SET.
+ */
+struct RDMReplyData {
+  /**
+   * @brief The metadata for the response, including the response code.
+   */
+  RDMMetadata metadata;
+
+  /**
+   * @brief True if a RDM response was received.
+   */
+  bool has_response;
+
+  /**
+   * @brief The response type, e.g. ola::rdm::RDM_ACK.
+   */
+  uint8_t response_type;
+
+  /**
+   * @brief The parameter data from the response.
+   */
+  std::string param_data;
+
+  RDMReplyData() : has_response(false), response_type(0) {}
+};
+
+typedef ola::thread::Future<FutureResult<void> > SetFuture;
+typedef ola::thread::Future<FutureResult<RDMReplyData> > RDMFuture;
+typedef ola::thread::Future<FutureResult<std::vector<OlaUniverse> > >
+    UniverseListFuture;
+typedef ola::thread::Future<FutureResult<ola::rdm::UIDSet> > UIDListFuture;
+
+/**
+ * @brief A client which returns a Future for each call.
+ *
+ * The FutureClient runs an OlaClient in its own thread. Calls can be made
+ * from any other thread and return straight away, so many RDM and
+ * configuration calls can be in flight at once and then waited on together.
+ *
+ * @code
+ *   FutureClient client;
+ *   if (!client.Start()) { ... }
+ *
+ *   vector<RDMFuture> futures;
+ *   for (...) {
+ *     futures.push_back(client.RDMGet(universe, uid, 0, pid));
+ *   }
+ *   for (...) {
+ *     const FutureResult<RDMReplyData> &result = futures[i].Get();
+ *     ...
+ *   }
+ * @endcode
+ *
+ * If the connection to olad is lost, or the client is stopped, all
+ * outstanding futures complete with an error. Start() and Stop() must not be
+ * called while other threads are making calls.
+ */
+class FutureClient {
+ public:
+  /**
+   * @brief Controls the options for the FutureClient.
+   */
+  struct Options {
+    /**
+     * @brief If true, olad is started if it's not already running.
+     */
+    bool auto_start;
+
+    /**
+     * @brief The RPC port olad is listening on.
+     */
+    uint16_t server_port;
+
+    /**
+     * @brief If set, connect through the unix domain socket at this path
+     * rather than TCP.
+     */
+    std::string socket_path;
+
+    Options()
+        : auto_start(true),
+          server_port(OLA_DEFAULT_PORT) {
+    }
+  };
+
+  explicit FutureClient(const Options &options = Options());
+
+  /**
+   * @brief Stop the client.
+   */
+  ~FutureClient();
+
+  /**
+   * @brief Connect to olad and start the client thread.
+   * @returns true if the client started, false otherwise.
+   */
+  bool Start();
+
+  /**
+   * @brief Stop the client thread and close the connection.
+   */
+  void Stop();
+
+  /**
+   * @brief Fetch the list of universes.
+   */
+  UniverseListFuture FetchUniverseList();
+
+  /**
+   * @brief Set the name of a universe.
+   */
+  SetFuture SetUniverseName(unsigned int universe, const std::string &name);
+
+  /**
+   * @brief Fetch the UIDs on a universe, optionally running discovery.
+   */
+  UIDListFuture RunDiscovery(unsigned int universe,
+                             DiscoveryType discovery_type);
+
+  /**
+   * @brief Send a RDM GET.
+   * @param universe the universe to send the command on.
+   * @param uid the UID to send the command to.
+   * @param sub_device the sub device index.
+   * @param pid the PID to address.
+   * @param data the parameter data to send.
+   */
+  RDMFuture RDMGet(unsigned int universe,
+                   const ola::rdm::UID &uid,
+                   uint16_t sub_device,
+                   uint16_t pid,
+                   const std::string &data = "");
+
+  /**
+   * @brief Send a RDM SET.
+   * @param universe the universe to send the command on.
+   * @param uid the UID to send the command to.
+   * @param sub_device the sub device index.
+   * @param pid the PID to address.
+   * @param data the parameter data to send.
+   */
+  RDMFuture RDMSet(unsigned int universe,
+                   const ola::rdm::UID &uid,
+                   uint16_t sub_device,
+                   uint16_t pid,
+                   const std::string &data = "");
+
+ private:
+  class ClientThread;
+  class PendingCallInterface;
+  template <typename T> class PendingCall;
+  struct RDMRequest;
+
+  const Options m_options;
+  std::auto_ptr<ola::io::SelectServer> m_ss;
+  std::auto_ptr<ola::io::ConnectedDescriptor> m_socket;
+  std::auto_ptr<OlaClient> m_client;
+  std::auto_ptr<ClientThread> m_thread;
+  // Only accessed from the client thread.
+  std::set<PendingCallInterface*> m_pending;
+  bool m_connection_closed;
+
+  template <typename T>
+  PendingCall<T> *NewPendingCall(ola::thread::Future<FutureResult<T> > future);
+  template <typename T>
+  void CompleteCall(PendingCall<T> *call, const FutureResult<T> &result);
+  void FailPendingCalls(const std::string &error);
+  void ConnectionClosed();
+
+  void DoFetchUniverseList(UniverseListFuture future);
+  void DoSetUniverseName(SetFuture future, unsigned int universe,
+                         std::string name);
+  void DoRunDiscovery(UIDListFuture future, unsigned int universe,
+                      DiscoveryType discovery_type);
+  void DoSendRDM(RDMFuture future, RDMRequest *request);
+
+  void HandleSet(PendingCall<void> *call, const Result &result);
+  void HandleUniverseList(PendingCall<std::vector<OlaUniverse> > *call,
+                          const Result &result,
+                          const std::vector<OlaUniverse> &universes);
+  void HandleUIDList(PendingCall<ola::rdm::UIDSet> *call,
+                     const Result &result,
+                     const ola::rdm::UIDSet &uids);
+  void HandleRDM(PendingCall<RDMReplyData> *call,
+                 const Result &result,
+                 const RDMMetadata &metadata,
+                 const ola::rdm::RDMResponse *response);
+
+  DISALLOW_COPY_AND_ASSIGN(FutureClient);
+};
+}  // namespace client
+}  // namespace ola
+#endif  // INCLUDE_OLA_CLIENT_FUTURECLIENT_H_
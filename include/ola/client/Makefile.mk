@@ -5,6 +5,7 @@ olaclientinclude_HEADERS = \
     include/ola/client/ClientRDMAPIShim.h \
     include/ola/client/ClientTypes.h \
     include/ola/client/ClientWrapper.h \
+    include/ola/client/FutureClient.h \
     include/ola/client/Module.h \
     include/ola/client/OlaClient.h \
     include/ola/client/Result.h \
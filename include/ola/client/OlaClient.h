@@ -30,10 +30,12 @@
 #include <ola/plugin_id.h>
 #include <ola/rdm/UID.h>
 #include <ola/rdm/UIDSet.h>
+#include <ola/thread/SchedulerInterface.h>
 #include <ola/timecode/TimeCode.h>
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace client {
@@ -64,6 +66,18 @@ class OlaClient {
    */
   void SetCloseHandler(ola::SingleUseCallback0<void> *callback);
 
+  /**
+   * @brief Coalesce the calls made in the same loop iteration into a single
+   *   write.
+   * @param scheduler the scheduler used to send the calls, usually the
+   *   SelectServer this client is registered with. NULL disables pipelining.
+   *
+   * This is useful for programs which make many calls in a row. The calls
+   * are sent once control returns to the SelectServer, or when Stop() is
+   * called.
+   */
+  void SetPipelining(ola::thread::SchedulerInterface *scheduler);
+
   /**
    * @brief Set the callback to be run when new DMX data arrives.
    *
@@ -73,6 +87,21 @@ class OlaClient {
    */
   void SetDMXCallback(RepeatableDMXCallback *callback);
 
+  /**
+   * @brief Set the callback to be run when subscribed slots change.
+   * @param callback the callback to run, ownership is transferred.
+   * @sa SubscribeSlots()
+   */
+  void SetSlotChangeCallback(RepeatableSlotChangeCallback *callback);
+
+  /**
+   * @brief Set the callback to be run when the response to a polled GET
+   *   changes.
+   * @param callback the callback to run, ownership is transferred.
+   * @sa SubscribeRDMPoll()
+   */
+  void SetRDMPollCallback(RepeatableRDMPollCallback *callback);
+
   /**
    * @brief Trigger a plugin reload.
    * @param callback the SetCallback to invoke upon completion.
@@ -209,6 +238,18 @@ class OlaClient {
                             OlaUniverse::merge_mode mode,
                             SetCallback *callback);
 
+  /**
+   * @brief Set the layers of a virtual universe.
+   * @param universe the id of the virtual universe, this is created if it
+   *   doesn't exist.
+   * @param layers the layers, in the order they are blended. An empty list
+   *   removes the layers.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SetUniverseLayers(unsigned int universe,
+                         const std::vector<UniverseLayer> &layers,
+                         SetCallback *callback);
+
   /**
    * @brief Patch or unpatch a port from a universe.
    * @param device_alias the device containing the port to change
@@ -225,6 +266,40 @@ class OlaClient {
              unsigned int universe,
              SetCallback *callback);
 
+  /**
+   * @brief Patch or unpatch a set of ports in one request.
+   * @param patches the desired patching of each port.
+   * @param callback the SetCallback to invoke upon completion.
+   *
+   * Ports that are already patched as requested are left alone. If any of
+   * the ports can't be found or patched, none of the changes are applied.
+   */
+  void PatchPorts(const std::vector<PortPatch> &patches,
+                  SetCallback *callback);
+
+  /**
+   * @brief Ask for delta encoded DMX updates.
+   * @param enable true to request delta updates.
+   *
+   * This applies to later calls to RegisterUniverse(). olad will then send
+   * only the slots which changed, with a full frame every so often, which
+   * reduces the bandwidth used by clients which monitor many universes. The
+   * callback set by SetDMXCallback() always receives the full frame.
+   */
+  void SetDeltaUpdates(bool enable);
+
+  /**
+   * @brief Ask olad to limit the DMX updates sent to this client.
+   * @param max_rate the maximum number of updates per second for each
+   *   universe, 0 means no limit. Only the latest frame is sent.
+   * @param min_change frames where no slot changed by at least this much are
+   *   skipped, 0 sends every frame.
+   *
+   * This applies to later calls to RegisterUniverse(). It's useful for
+   * clients which display the data, and don't need every frame.
+   */
+  void SetUpdateRateLimit(unsigned int max_rate, unsigned int min_change);
+
   /**
    * @brief Register our interest in a universe.
    *
@@ -238,6 +313,44 @@ class OlaClient {
                         RegisterAction register_action,
                         SetCallback *callback);
 
+  /**
+   * @brief Watch some slots of a universe.
+   *
+   * Rather than sending full frames, olad compares each new frame with the
+   * last and sends just the slots which changed to the callback set by
+   * SetSlotChangeCallback(). The current values are sent first.
+   * @param universe the id of the universe to watch.
+   * @param ranges the slots to watch. This replaces any earlier ranges for
+   *   the universe, an empty list stops watching the universe.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SubscribeSlots(unsigned int universe,
+                      const std::vector<SlotRange> &ranges,
+                      SetCallback *callback);
+
+  /**
+   * @brief Ask olad to poll an RDM GET, e.g. SENSOR_VALUE.
+   *
+   * olad polls each GET once for all the clients that subscribe to it, at
+   * the shortest period any of them asked for. The response is sent to the
+   * callback set by SetRDMPollCallback() when it changes. If olad already
+   * has a response, that's sent first.
+   * @param universe the universe the device is on.
+   * @param uid the UID of the device.
+   * @param sub_device the sub device.
+   * @param pid the PID to GET.
+   * @param data the param data of the GET.
+   * @param period_ms how often to poll, 0 stops polling for this client.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SubscribeRDMPoll(unsigned int universe,
+                        const ola::rdm::UID &uid,
+                        uint16_t sub_device,
+                        uint16_t pid,
+                        const std::string &data,
+                        unsigned int period_ms,
+                        SetCallback *callback);
+
   /**
    * @brief Send DMX data.
    * @param universe the universe to send to.
@@ -248,6 +361,17 @@ class OlaClient {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Send streaming DMX data through shared memory.
+   * @param callback the SetCallback to invoke once olad has accepted, or
+   *   rejected, the shared memory segment.
+   *
+   * Once olad accepts the segment, SendDMX() calls without a callback, fade
+   * time or slot priorities write to shared memory rather than sending an
+   * RPC. olad must be run with --shared-memory-poll-ms.
+   */
+  void UseSharedMemory(SetCallback *callback);
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
@@ -255,6 +379,27 @@ class OlaClient {
    */
   void FetchDMX(unsigned int universe, DMXCallback *callback);
 
+  /**
+   * @brief Fetch the latest DMX data for many universes in a single call.
+   * @param universes the universe ids to get data for. If empty, the data
+   *   for all universes is returned.
+   * @param callback the MultiDMXCallback to invoke upon completion.
+   */
+  void FetchDMXMulti(const std::vector<unsigned int> &universes,
+                     MultiDMXCallback *callback);
+
+  /**
+   * @brief Fetch the counters for many universes in a single call.
+   * @param universes the universe ids to get the stats for. If empty, the
+   *   stats for all universes are returned.
+   * @param callback the UniverseStatsCallback to invoke upon completion.
+   *
+   * Unlike registering for DMX, this doesn't send any DMX data, so it's
+   * cheap enough to poll.
+   */
+  void FetchUniverseStats(const std::vector<unsigned int> &universes,
+                          UniverseStatsCallback *callback);
+
   /**
    * @brief Trigger discovery for a universe.
    * @param universe the universe id to run discovery on.
@@ -308,6 +453,25 @@ class OlaClient {
               unsigned int data_length,
               const SendRDMArgs& args);
 
+  /**
+   * @brief Send a batch of RDM commands.
+   * @param commands the commands to send.
+   * @param max_outstanding the maximum number of commands the server will
+   *   have in flight at once.
+   * @param result_callback run as the result of each command arrives.
+   *   Ownership is transferred and the callback is deleted once the batch
+   *   completes.
+   * @param callback the SetCallback to invoke once all the results have been
+   *   received.
+   *
+   * Results are returned in the order the commands complete, which may not
+   * be the order they were given in.
+   */
+  void RDMBatch(const std::vector<RDMBatchCommand> &commands,
+                unsigned int max_outstanding,
+                RDMBatchResultCallback *result_callback,
+                SetCallback *callback);
+
   /**
    * @brief Send TimeCode data.
    * @param timecode The timecode data.
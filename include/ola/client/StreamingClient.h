@@ -25,18 +25,33 @@
 #ifndef INCLUDE_OLA_CLIENT_STREAMINGCLIENT_H_
 #define INCLUDE_OLA_CLIENT_STREAMINGCLIENT_H_
 
+#include <ola/Clock.h>
 #include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/base/Macro.h>
 #include <ola/dmx/SourcePriorities.h>
 
+#include <map>
+#include <string>
+
 namespace ola {
 
-namespace io { class SelectServer; }
-namespace network { class TCPSocket; }
-namespace proto { class OlaServerService_Stub; }
+namespace dmx {
+class PixelMap;
+class SharedMemoryFrames;
+}
+namespace io {
+class ConnectedDescriptor;
+class SelectServer;
+}
+namespace proto {
+class Ack;
+class DmxDataBatch;
+class OlaServerService_Stub;
+}
 namespace rpc {
 class RpcChannel;
+class RpcController;
 class RpcSession;
 }
 
@@ -97,7 +112,12 @@ class StreamingClient : public StreamingClientInterface {
      * Create a new options structure with the default options. This
      * includes automatically starting olad if it's not already running.
      */
-    Options() : auto_start(true), server_port(OLA_DEFAULT_PORT) {}
+    Options()
+        : auto_start(true),
+          server_port(OLA_DEFAULT_PORT),
+          use_shared_memory(false),
+          non_blocking(false) {
+    }
 
     /**
      * If true, the client will automatically start olad if it's not
@@ -109,6 +129,32 @@ class StreamingClient : public StreamingClientInterface {
      * The RPC port olad is listening on.
      */
     uint16_t server_port;
+
+    /**
+     * If true, send DMX data to olad through shared memory rather than the
+     * RPC connection. This requires olad to be run with
+     * --shared-memory-poll-ms. The RPC connection is used until olad accepts
+     * the shared memory segment, or if it's rejected.
+     */
+    bool use_shared_memory;
+
+    /**
+     * If set, connect to olad through the unix domain socket at this path
+     * rather than TCP. olad must be run with --rpc-socket. auto_start and
+     * server_port are ignored.
+     */
+    std::string socket_path;
+
+    /**
+     * If true, SendDMX() never blocks. If the socket is full, the frame is
+     * held and sent by a later call, and a newer frame for the same universe
+     * replaces it. The connection isn't polled for every frame, so a closed
+     * connection may only be noticed a frame or two later.
+     *
+     * Flush(), SetPixelLayout() and SendPixelFrame() send any held frames
+     * first, blocking if needed.
+     */
+    bool non_blocking;
   };
 
   /**
@@ -164,18 +210,138 @@ class StreamingClient : public StreamingClientInterface {
                const DmxBuffer &data,
                const SendArgs &args);
 
+  /**
+   * @brief Buffer DMX data, to be sent with the next call to Flush().
+   * @param universe the universe to send to.
+   * @param data the DmxBuffer with the data
+   * @param args the SendArgs to use for this call.
+   * @returns true if the data was buffered, false if the connection to the
+   *   server has been closed.
+   *
+   * All the universes buffered between calls to Flush() are sent in a single
+   * message. If the size of a universe hasn't changed since it was last
+   * flushed, only the range of slots which changed is sent.
+   */
+  bool BufferDMX(unsigned int universe,
+                 const DmxBuffer &data,
+                 const SendArgs &args);
+
+  /**
+   * @brief Send all the data buffered by BufferDMX().
+   * @returns true if sent sucessfully, false if the connection to the server
+   *   has been closed.
+   */
+  bool Flush();
+
+  /**
+   * @brief Set a layout used to map the frames from SendPixelFrame() onto
+   *   universes.
+   * @param layout the id of the layout, each client has its own layouts.
+   * @param map the PixelMap which describes the layout. The gamma &
+   *   brightness correction is applied by olad.
+   * @returns true if sent sucessfully, false if the connection to the server
+   *   has been closed.
+   *
+   * If olad rejects the layout a warning is logged, and frames sent for it
+   * are dropped.
+   */
+  bool SetPixelLayout(unsigned int layout, const ola::dmx::PixelMap &map);
+
+  /**
+   * @brief Send a frame of pixels, which olad maps onto universes.
+   * @param layout the id of the layout, from SetPixelLayout().
+   * @param frame the row major RGB pixels, 3 bytes per pixel.
+   * @param length the size of the frame, this must match the layout.
+   * @param args the SendArgs to use for this call.
+   * @returns true if sent sucessfully, false if the connection to the server
+   *   has been closed.
+   *
+   * All the universes in the layout are updated from a single message. The
+   * frame must fit in an RPC, so it can be at most 1MB.
+   */
+  bool SendPixelFrame(unsigned int layout, const uint8_t *frame,
+                      unsigned int length, const SendArgs &args);
+
   void ChannelClosed(ola::rpc::RpcSession *session);
 
+  /**
+   * @brief The number of buffered universes which causes an automatic Flush().
+   */
+  static const unsigned int MAX_BATCH_SIZE = 512;
+
+  /**
+   * @brief In non-blocking mode, how often to poll the connection, in ms.
+   */
+  static const unsigned int CONNECTION_CHECK_INTERVAL_MS = 100;
+
+  /**
+   * @brief How long to wait for olad to accept held frames, in ms.
+   */
+  static const int WRITE_TIMEOUT_MS = 1000;
+
  private:
+  enum SharedMemoryState {
+    SHARED_MEMORY_DISABLED,
+    SHARED_MEMORY_PENDING,
+    SHARED_MEMORY_READY,
+  };
+
+  enum WriteResult {
+    WRITE_OK,
+    WRITE_BLOCKED,
+    WRITE_FAILED,
+  };
+
+  /**
+   * A frame which couldn't be sent because the socket was full.
+   */
+  struct PendingFrame {
+    uint8_t priority;
+    DmxBuffer data;
+  };
+
   bool m_auto_start;
   uint16_t m_server_port;
-  ola::network::TCPSocket *m_socket;
+  bool m_use_shared_memory;
+  std::string m_socket_path;
+  ola::io::ConnectedDescriptor *m_socket;
   ola::io::SelectServer *m_ss;
   class ola::rpc::RpcChannel *m_channel;
   class ola::proto::OlaServerService_Stub *m_stub;
   bool m_socket_closed;
+  ola::dmx::SharedMemoryFrames *m_shared_memory;
+  SharedMemoryState m_shared_memory_state;
+  ola::proto::DmxDataBatch *m_batch;
+  // The last data buffered for each universe, used to find the changed range.
+  std::map<unsigned int, DmxBuffer> m_batch_frames;
+
+  bool m_non_blocking;
+  uint32_t m_sequence;
+  uint8_t *m_frame;
+  // The unsent part of a frame, this has to be sent before anything else.
+  std::string m_partial_frame;
+  std::map<unsigned int, PendingFrame> m_pending_frames;
+  // The replies we're waiting for, which are read by CheckConnection().
+  unsigned int m_outstanding_replies;
+  ola::Clock m_clock;
+  TimeStamp m_last_check;
 
   bool Send(unsigned int universe, uint8_t priority, const DmxBuffer &data);
+  bool SendNonBlocking(unsigned int universe, uint8_t priority,
+                       const DmxBuffer &data);
+  WriteResult SendFrame(unsigned int universe, uint8_t priority,
+                        const DmxBuffer &data, bool block);
+  WriteResult SendPendingFrames(bool block);
+  WriteResult Write(const uint8_t *data, unsigned int size, bool block);
+  bool WaitForWritable(int fd);
+  bool FlushPendingFrames();
+  bool CheckConnection();
+  void RegisterSharedMemory();
+  void SharedMemoryRegistered(ola::rpc::RpcController *controller,
+                              ola::proto::Ack *reply);
+  void PixelLayoutSet(unsigned int layout,
+                      ola::rpc::RpcController *controller,
+                      ola::proto::Ack *reply);
 
   DISALLOW_COPY_AND_ASSIGN(StreamingClient);
 };
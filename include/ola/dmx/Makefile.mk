@@ -1,4 +1,7 @@
 oladmxincludedir = $(pkgincludedir)/dmx/
 oladmxinclude_HEADERS = \
+    include/ola/dmx/PixelMap.h \
     include/ola/dmx/RunLengthEncoder.h \
+    include/ola/dmx/SharedMemoryFrames.h \
+    include/ola/dmx/SlotRemap.h \
     include/ola/dmx/SourcePriorities.h
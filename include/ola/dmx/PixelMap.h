@@ -0,0 +1,262 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PixelMap.h
+ * Map a 2D frame of RGB pixels onto DMX universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file PixelMap.h
+ * @brief Map a 2D frame of RGB pixels onto DMX universes.
+ */
+
+#ifndef INCLUDE_OLA_DMX_PIXELMAP_H_
+#define INCLUDE_OLA_DMX_PIXELMAP_H_
+
+#include <ola/DmxBuffer.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief The order a fixture expects the colors of each pixel in.
+ */
+typedef enum {
+  COLOR_ORDER_RGB,
+  COLOR_ORDER_RBG,
+  COLOR_ORDER_GRB,
+  COLOR_ORDER_GBR,
+  COLOR_ORDER_BRG,
+  COLOR_ORDER_BGR
+} ColorOrder;
+
+/**
+ * @brief The implementations of the pixel gather kernel.
+ */
+typedef enum {
+  PIXEL_GATHER_SCALAR,  /**< Plain C++ */
+  PIXEL_GATHER_SSSE3,  /**< x86 SSSE3, 5 pixels at a time */
+  PIXEL_GATHER_NEON  /**< ARM NEON, 16 pixels at a time */
+} PixelGatherImplementation;
+
+/**
+ * @brief A kernel which copies a run of RGB pixels, reordering the colors.
+ * @param order the color order to write.
+ * @param dest the output, this must have room for 3 * pixels bytes.
+ * @param source the first RGB pixel.
+ * @param stride the distance in bytes between the start of each source pixel.
+ *   This may be negative.
+ * @param pixels the number of pixels to copy.
+ */
+typedef void (*PixelGatherFunction)(ColorOrder order, uint8_t *dest,
+                                    const uint8_t *source, int stride,
+                                    unsigned int pixels);
+
+/**
+ * @brief Copy a run of RGB pixels, using the fastest kernel for this CPU.
+ * @sa PixelGatherFunction
+ */
+void GatherPixels(ColorOrder order, uint8_t *dest, const uint8_t *source,
+                  int stride, unsigned int pixels);
+
+/**
+ * @brief Return the implementation used by GatherPixels().
+ */
+PixelGatherImplementation DefaultPixelGatherImplementation();
+
+/**
+ * @brief Return the kernel for a specific implementation.
+ * @returns the kernel, or NULL if the implementation isn't available on this
+ *   build or CPU.
+ */
+PixelGatherFunction GetPixelGatherFunction(
+    PixelGatherImplementation implementation);
+
+/**
+ * @brief Build a table that applies gamma & brightness correction.
+ * @param gamma the gamma to apply, 1.0 leaves the values unchanged.
+ * @param brightness the brightness scale, from 0 to 255.
+ * @param table the 256 entry table to fill.
+ * @returns false if the table leaves every value unchanged.
+ */
+bool BuildColorTable(double gamma, uint8_t brightness, uint8_t table[256]);
+
+/**
+ * @brief Map each byte through a table built by BuildColorTable().
+ * @param table the table to apply.
+ * @param dest the output, this may be the same as source.
+ * @param source the input.
+ * @param length the number of bytes to map.
+ */
+void ApplyColorTable(const uint8_t table[256], uint8_t *dest,
+                     const uint8_t *source, unsigned int length);
+
+/**
+ * @brief Maps a 2D frame of RGB pixels onto a set of DMX universes.
+ *
+ * The layout is described as a list of runs. Each run is a line of pixels in
+ * the frame, for example a row, a column or one leg of a snake, which is sent
+ * to consecutive slots of a universe. Once the runs are added, Map() takes a
+ * frame and produces the data for every universe in the layout.
+ *
+ * The runs are compiled into a gather table when they're added, so Map() is
+ * a single pass over the table, with one GatherPixels() call per run and one
+ * color correction pass over all the universes. Slots that aren't covered by
+ * a run are 0.
+ *
+ * The frame is row major, 3 bytes per pixel, with no padding between rows.
+ */
+class PixelMap {
+ public:
+  /**
+   * @brief A line of pixels in the frame, sent to consecutive slots.
+   */
+  struct Run {
+   public:
+    Run()
+        : universe(0),
+          start_slot(0),
+          x(0),
+          y(0),
+          x_step(1),
+          y_step(0),
+          count(0),
+          order(COLOR_ORDER_RGB) {
+    }
+
+    // The universe to send the pixels to.
+    unsigned int universe;
+    // The 0-based slot of the first pixel.
+    unsigned int start_slot;
+    // The position of the first pixel in the frame.
+    unsigned int x;
+    unsigned int y;
+    // The change in x & y between each pixel in the run.
+    int x_step;
+    int y_step;
+    // The number of pixels in the run.
+    unsigned int count;
+    ColorOrder order;
+  };
+
+  /**
+   * @brief Create a new PixelMap.
+   * @param width the width of the frame, in pixels.
+   * @param height the height of the frame, in pixels.
+   */
+  PixelMap(unsigned int width, unsigned int height);
+
+  unsigned int Width() const { return m_width; }
+  unsigned int Height() const { return m_height; }
+
+  /**
+   * @brief The size of a frame in bytes.
+   */
+  unsigned int FrameSize() const { return m_width * m_height * RGB_SIZE; }
+
+  /**
+   * @brief Add a run of pixels to the layout.
+   * @returns true if the run was added, false if it has no pixels, any pixel
+   *   is outside the frame, or it extends past the end of the universe.
+   *
+   * Runs are applied in the order they were added, so if two runs write to
+   * the same slots the later one wins.
+   */
+  bool AddRun(const Run &run);
+
+  /**
+   * @brief Return the runs in the layout.
+   */
+  const std::vector<Run> &Runs() const { return m_runs; }
+
+  /**
+   * @brief Apply gamma & brightness correction to the mapped data.
+   * @param gamma the gamma to apply, 1.0 leaves the values unchanged.
+   * @param brightness the brightness scale, from 0 to 255.
+   */
+  void SetColorCorrection(double gamma, uint8_t brightness);
+
+  double Gamma() const { return m_gamma; }
+  uint8_t Brightness() const { return m_brightness; }
+
+  /**
+   * @brief Map a frame onto the universes.
+   * @param frame the frame, which must be FrameSize() bytes.
+   * @param size the size of the frame.
+   * @returns false if the frame is the wrong size.
+   */
+  bool Map(const uint8_t *frame, unsigned int size);
+
+  /**
+   * @brief The number of universes in the layout.
+   */
+  unsigned int UniverseCount() const { return m_universes.size(); }
+
+  /**
+   * @brief The id of a universe in the layout.
+   * @param index the index of the universe, less than UniverseCount().
+   */
+  unsigned int UniverseId(unsigned int index) const {
+    return m_universes[index].id;
+  }
+
+  /**
+   * @brief The data from the last call to Map() for a universe.
+   * @param index the index of the universe, less than UniverseCount().
+   */
+  const DmxBuffer &UniverseData(unsigned int index) const {
+    return m_universes[index].data;
+  }
+
+ private:
+  // A run, compiled down to offsets.
+  struct Gather {
+    unsigned int source;
+    int stride;
+    uint16_t slot;
+    uint16_t pixels;
+    ColorOrder order;
+  };
+
+  struct MappedUniverse {
+    unsigned int id;
+    // The offset of this universe's slots in m_slots.
+    unsigned int offset;
+    unsigned int size;
+    std::vector<Gather> gathers;
+    DmxBuffer data;
+  };
+
+  const unsigned int m_width;
+  const unsigned int m_height;
+  std::vector<Run> m_runs;
+  std::vector<MappedUniverse> m_universes;
+  // The slots for all universes, one after the other.
+  std::vector<uint8_t> m_slots;
+  double m_gamma;
+  uint8_t m_brightness;
+  bool m_color_correction;
+  uint8_t m_color_table[256];
+
+  MappedUniverse *FindOrAddUniverse(unsigned int id);
+
+  static const unsigned int RGB_SIZE = 3;
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_PIXELMAP_H_
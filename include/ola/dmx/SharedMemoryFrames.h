@@ -0,0 +1,201 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedMemoryFrames.h
+ * DMX512 frames passed between processes through shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file SharedMemoryFrames.h
+ * @brief DMX512 frames passed between processes through shared memory.
+ */
+
+#ifndef INCLUDE_OLA_DMX_SHAREDMEMORYFRAMES_H_
+#define INCLUDE_OLA_DMX_SHAREDMEMORYFRAMES_H_
+
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief A shared memory segment holding one DMX512 frame per universe.
+ *
+ * The writer (a client) creates the segment and claims a slot for each
+ * universe it sends. The reader (olad) maps the same segment and polls the
+ * slots, picking up the latest frame for each universe.
+ *
+ * Each slot is protected by a sequence lock, so the writer never blocks. The
+ * sequence is odd while the slot is being written; the reader skips slots
+ * that are being written, or which changed while they were being copied, and
+ * tries again on the next poll. Intermediate frames may be skipped, which is
+ * fine for DMX512 since only the latest frame matters.
+ *
+ * The segment also holds a frame counter, which the writer bumps after each
+ * frame. Readers can check it to see if anything changed without reading the
+ * slots, or block on it with WaitForFrame().
+ *
+ * The writer and reader must each be used from a single thread.
+ */
+class SharedMemoryFrames {
+ public:
+  /**
+   * @brief A frame read from the segment.
+   */
+  struct Frame {
+    unsigned int universe;
+    uint8_t priority;
+    DmxBuffer data;
+  };
+
+  /**
+   * @brief Unmap the segment. If this is the writer, the segment is also
+   *   unlinked.
+   */
+  ~SharedMemoryFrames();
+
+  /**
+   * @brief Create a new segment for writing.
+   * @param name the name of the segment, this must start with
+   *   K_NAME_PREFIX.
+   * @param slot_count the number of universes the segment can hold.
+   * @param replace if true, an existing segment with the same name, say one
+   *   left behind by a process that crashed, is replaced. Otherwise creating
+   *   the segment fails if the name is in use.
+   * @returns a new SharedMemoryFrames, or NULL if the segment couldn't be
+   *   created. Ownership is transferred to the caller.
+   */
+  static SharedMemoryFrames *Create(const std::string &name,
+                                    unsigned int slot_count = DEFAULT_SLOTS,
+                                    bool replace = false);
+
+  /**
+   * @brief Open an existing segment for reading.
+   * @param name the name of the segment, this must start with
+   *   K_NAME_PREFIX.
+   * @returns a new SharedMemoryFrames, or NULL if the segment couldn't be
+   *   opened or isn't valid. Ownership is transferred to the caller.
+   */
+  static SharedMemoryFrames *Open(const std::string &name);
+
+  /**
+   * @brief Generate a segment name that's unique to this process.
+   */
+  static std::string UniqueName();
+
+  /**
+   * @brief The name of the segment.
+   */
+  const std::string &Name() const { return m_name; }
+
+  /**
+   * @brief The number of slots in the segment.
+   */
+  unsigned int SlotCount() const { return m_slot_count; }
+
+  /**
+   * @brief Write a frame for a universe.
+   * @param universe the universe id.
+   * @param priority the priority of the data.
+   * @param data the DMX512 data.
+   * @returns true if the frame was written, false if this isn't the writer
+   *   or all the slots have been claimed by other universes.
+   */
+  bool Write(unsigned int universe, uint8_t priority, const DmxBuffer &data);
+
+  /**
+   * @brief Read the frame in a slot, if it's changed since it was last read.
+   * @param slot the slot to read, must be less than SlotCount().
+   * @param[out] frame the frame, only valid if true is returned.
+   * @returns true if a new frame was read, false if the slot is unused,
+   *   unchanged or in the middle of being written.
+   */
+  bool Read(unsigned int slot, Frame *frame);
+
+  /**
+   * @brief The number of frames written to the segment, this wraps around.
+   */
+  uint32_t FrameCount() const;
+
+  /**
+   * @brief Wake any readers blocked in WaitForFrame().
+   *
+   * Write() doesn't do this itself, since it costs a system call. A writer
+   * with readers that block should call this after each batch of frames.
+   */
+  void WakeReaders();
+
+  /**
+   * @brief Block until a frame is written.
+   * @param frame_count the value of FrameCount() the reader last saw.
+   * @param timeout the longest time to wait.
+   * @returns true if FrameCount() differs from frame_count, false if the
+   *   timeout expired.
+   *
+   * On Linux this sleeps on a futex in the segment, elsewhere it polls
+   * FrameCount() every millisecond.
+   */
+  bool WaitForFrame(uint32_t frame_count, const TimeInterval &timeout);
+
+  /**
+   * @brief The prefix all segment names must have.
+   */
+  static const char K_NAME_PREFIX[];
+
+  /**
+   * @brief The default number of slots in a segment.
+   */
+  static const unsigned int DEFAULT_SLOTS = 32;
+
+  /**
+   * @brief The maximum number of slots in a segment.
+   */
+  static const unsigned int MAX_SLOTS = 1024;
+
+ private:
+  struct SegmentHeader;
+  struct FrameSlot;
+
+  const std::string m_name;
+  const bool m_writer;
+  uint8_t *m_segment;
+  size_t m_segment_size;
+  unsigned int m_slot_count;
+  FrameSlot *m_slots;
+  // The writer's slot for each universe.
+  std::map<unsigned int, unsigned int> m_universe_slots;
+  // The last sequence number the reader saw for each slot.
+  std::vector<uint32_t> m_read_sequences;
+
+  SharedMemoryFrames(const std::string &name, bool writer, uint8_t *segment,
+                     size_t segment_size);
+
+  static bool ValidName(const std::string &name);
+  static size_t SegmentSize(unsigned int slot_count);
+  SegmentHeader *Header() const;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryFrames);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_SHAREDMEMORYFRAMES_H_
@@ -0,0 +1,130 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SlotRemap.h
+ * Move slots around within a universe of DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file SlotRemap.h
+ * @brief Move slots around within a universe of DMX data.
+ */
+
+#ifndef INCLUDE_OLA_DMX_SLOTREMAP_H_
+#define INCLUDE_OLA_DMX_SLOTREMAP_H_
+
+#include <ola/DmxBuffer.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief A table that maps the slots of one DMX frame onto another.
+ *
+ * The table is stored as a list of spans, each of which copies a contiguous
+ * range of source slots to a contiguous range of destination slots, so
+ * applying it is a handful of memcpy() calls. Destination slots that aren't
+ * covered by a span are set to 0. An empty table leaves the data unchanged.
+ *
+ * The string form is a comma separated list of spans, using 1-based slot
+ * numbers:
+ * @code
+ *   1-16=101,17=1
+ * @endcode
+ * Here destination slots 1 to 16 take source slots 101 to 116, and
+ * destination slot 17 takes source slot 1. Offsetting a universe by 10 slots
+ * is then "11-512=1".
+ */
+class SlotRemap {
+ public:
+  SlotRemap() {}
+
+  /**
+   * @brief Check if this remap is empty, and so leaves the data unchanged.
+   */
+  bool Empty() const { return m_spans.empty(); }
+
+  /**
+   * @brief Remove all spans.
+   */
+  void Clear() { m_spans.clear(); }
+
+  /**
+   * @brief Add a span.
+   * @param destination the offset of the first destination slot.
+   * @param source the offset of the first source slot.
+   * @param length the number of slots.
+   * @returns true if the span was added, false if it extends past the end of
+   *   the universe.
+   *
+   * Spans are applied in the order they were added, so if two spans overlap
+   * the later one wins.
+   */
+  bool AddSpan(unsigned int destination, unsigned int source,
+               unsigned int length);
+
+  /**
+   * @brief Replace this remap with one parsed from a string.
+   * @param input the string to parse, an empty string clears the remap.
+   * @returns true if the string was valid. If false is returned the remap
+   *   isn't changed.
+   */
+  bool FromString(const std::string &input);
+
+  /**
+   * @brief Return the string form of this remap.
+   */
+  std::string ToString() const;
+
+  /**
+   * @brief Apply the remap to a frame.
+   * @param input the data to remap.
+   * @param[out] output the remapped data. This can't be the same buffer as
+   *   input.
+   *
+   * The output is as long as the highest destination slot that has data in
+   * the input.
+   */
+  void Apply(const DmxBuffer &input, DmxBuffer *output) const;
+
+  bool operator==(const SlotRemap &other) const {
+    return m_spans == other.m_spans;
+  }
+
+  bool operator!=(const SlotRemap &other) const {
+    return !(*this == other);
+  }
+
+ private:
+  struct Span {
+    uint16_t destination;
+    uint16_t source;
+    uint16_t length;
+
+    bool operator==(const Span &other) const {
+      return (destination == other.destination && source == other.source &&
+              length == other.length);
+    }
+  };
+
+  std::vector<Span> m_spans;
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_SLOTREMAP_H_
@@ -45,6 +45,14 @@ static const uint8_t SOURCE_PRIORITY_DEFAULT = 100;
  */
 static const uint8_t SOURCE_PRIORITY_MAX = 200;
 
+/**
+ * @brief The alternate start code used by E1.31 to carry per-slot priorities.
+ *
+ * In these frames each slot holds the priority of the matching DMX512 slot. A
+ * slot priority of 0 means the slot isn't sourced.
+ */
+static const uint8_t SLOT_PRIORITY_START_CODE = 0xdd;
+
 }  // namespace dmx
 }  // namespace ola
 #endif  // INCLUDE_OLA_DMX_SOURCEPRIORITIES_H_
@@ -57,6 +57,8 @@ class MessageBuilder {
                                ola::e133::E133StatusCode status_code,
                                const string &description);
 
+    void BuildRootE133(IOStack *packet, uint32_t vector,
+                       uint32_t sequence_number, uint16_t endpoint_id);
     void BuildTCPRootE133(IOStack *packet, uint32_t vector,
                           uint32_t sequence_number, uint16_t endpoint_id);
     void BuildUDPRootE133(IOStack *packet, uint32_t vector,
@@ -137,6 +137,9 @@ USA
   #ifndef INCLUDE_OLA_CALLBACK_H_
   #define INCLUDE_OLA_CALLBACK_H_
 
+  #include <ola/CallbackPool.h>
+  #include <stddef.h>
+
   namespace ola {
 
   /**
@@ -179,6 +182,12 @@ def GenerateBase(number_of_args):
   print ' public:'
   print '  virtual ~BaseCallback%d() {}' % number_of_args
   PrintLongLine('  virtual ReturnType Run(%s) = 0;' % arg_list)
+  print ''
+  print '  // The memory comes from the CallbackPool, see CallbackPool.h'
+  print '  void *operator new(size_t size) { return AllocateCallback(size); }'
+  print '  void operator delete(void *ptr, size_t size) {'
+  print '    FreeCallback(ptr, size);'
+  print '  }'
   print '};'
   print ''
 
@@ -28,6 +28,7 @@
 #include <ola/io/SelectServer.h>
 #include <ola/thread/Thread.h>
 #include <ola/web/Json.h>
+#include <ola/web/JsonStreamWriter.h>
 // 0.4.6 of microhttp doesn't include stdarg so we do it here.
 #include <stdarg.h>
 #include <stdint.h>
@@ -92,6 +93,60 @@ class HTTPRequest {
 };
 
 
+/**
+ * @brief A Server-Sent Events (text/event-stream) response.
+ *
+ * Events are buffered until MHD writes them to the connection. The stream is
+ * owned by MHD once it's passed to HTTPResponse::SendEventStream(), and is
+ * deleted when the connection closes, at which point the on-close callback
+ * is run. All methods must be called on the HTTP server thread.
+ */
+class HTTPEventStream {
+ public:
+  HTTPEventStream();
+  ~HTTPEventStream();
+
+  /**
+   * @brief Queue an event.
+   * @param event the type of event, may be empty.
+   * @param data the data for the event, this must not contain newlines.
+   * @returns false if the client isn't keeping up, in which case the event is
+   *   dropped.
+   */
+  bool SendEvent(const std::string &event, const std::string &data);
+
+  /**
+   * @brief End the response once the queued events have been written.
+   */
+  void Close() { m_closed = true; }
+
+  /**
+   * @brief Set the callback to run when the connection closes.
+   * @param callback the callback to run, ownership is transferred. May be
+   *   NULL to clear the callback.
+   */
+  void SetOnClose(ola::SingleUseCallback0<void> *callback);
+
+  /**
+   * @brief Copy queued data into MHD's buffer.
+   * @returns the number of bytes copied, 0 if there isn't any data yet, or
+   *   MHD_CONTENT_READER_END_OF_STREAM once the stream is closed & empty.
+   */
+  ssize_t Read(char *buffer, size_t size);
+
+  // The maximum amount of data to queue for a client.
+  static const unsigned int K_MAX_QUEUED_BYTES = 64 * 1024;
+
+ private:
+  std::string m_queued;
+  size_t m_offset;
+  bool m_closed;
+  ola::SingleUseCallback0<void> *m_on_close;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPEventStream);
+};
+
+
 /*
  * Represents the HTTP Response
  */
@@ -107,7 +162,9 @@ class HTTPResponse {
   void SetStatus(unsigned int status) { m_status_code = status; }
   void SetNoCache();
   int SendJson(const ola::web::JsonValue &json);
+  int SendJson(const ola::web::JsonStreamWriter &json);
   int Send();
+  int SendEventStream(HTTPEventStream *stream);
   struct MHD_Connection *Connection() const { return m_connection; }
  private:
   std::string m_data;
@@ -116,6 +173,10 @@ class HTTPResponse {
   HeadersMultiMap m_headers;
   unsigned int m_status_code;
 
+  int SendData(const std::string &data);
+
+  static const size_t K_EVENT_STREAM_BLOCK_SIZE = 1024;
+
   DISALLOW_COPY_AND_ASSIGN(HTTPResponse);
 };
 
@@ -152,10 +213,18 @@ class HTTPServer: public ola::thread::Thread {
     uint16_t port;
     // The root for content served with ServeStaticContent();
     std::string data_dir;
+    // Use MHD's epoll mode, which removes the FD_SETSIZE limit on the number
+    // of connections. This is ignored if MHD doesn't support epoll.
+    bool use_epoll;
+    // Close idle (keep-alive) connections after this many seconds, 0 means
+    // connections are never timed out.
+    unsigned int connection_timeout;
 
     HTTPServerOptions()
       : port(0),
-        data_dir("") {
+        data_dir(""),
+        use_epoll(false),
+        connection_timeout(0) {
     }
   };
 
@@ -209,6 +278,8 @@ class HTTPServer: public ola::thread::Thread {
   static const char CONTENT_TYPE_OCT[];
   static const char CONTENT_TYPE_XML[];
   static const char CONTENT_TYPE_JSON[];
+  static const char CONTENT_TYPE_EVENT_STREAM[];
+  static const char CONTENT_TYPE_OPENMETRICS[];
 
   // Expose the SelectServer
   ola::io::SelectServer *SelectServer() { return m_select_server.get(); }
@@ -219,6 +290,14 @@ class HTTPServer: public ola::thread::Thread {
   typedef struct {
     std::string file_path;
     std::string content_type;
+    // The file is read on the first request and then served from memory.
+    // The .gz and .br variants are optional, if present they're sent to
+    // clients that accept them.
+    bool loaded;
+    std::string etag;
+    std::string data;
+    std::string gzip_data;
+    std::string brotli_data;
   } static_file_info;
 
   struct DescriptorState {
@@ -251,10 +330,19 @@ class HTTPServer: public ola::thread::Thread {
   BaseHTTPCallback *m_default_handler;
   unsigned int m_port;
   std::string m_data_dir;
-
-  int ServeStaticContent(static_file_info *file_info,
+  bool m_use_epoll;
+  unsigned int m_connection_timeout;
+  // In epoll mode, MHD's epoll descriptor is the only one we watch.
+  std::auto_ptr<ola::io::UnmanagedFileDescriptor> m_epoll_descriptor;
+
+  bool LoadStaticContent(static_file_info *file_info);
+  int ServeStaticContent(const HTTPRequest *request,
+                         static_file_info *file_info,
                          HTTPResponse *response);
 
+  static struct MHD_Response *BuildPersistentResponse(const std::string &data);
+
+  bool SetupEpollDescriptor();
   void InsertSocket(bool is_readable, bool is_writeable, int fd);
   void FreeSocket(DescriptorState *state);
 
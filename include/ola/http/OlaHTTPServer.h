@@ -50,6 +50,8 @@ class OlaHTTPServer {
     ola::ExportMap *m_export_map;
     HTTPServer m_server;
     TimeStamp m_start_time;
+    // Reused between scrapes of /metrics, to avoid growing a new string.
+    std::string m_metrics;
 
     /**
      * Register a static file to serve
@@ -62,6 +64,7 @@ class OlaHTTPServer {
  private:
     static const char K_DATA_DIR_VAR[];
     static const char K_UPTIME_VAR[];
+    static const char K_SELECT_SERVER_VAR_PREFIX[];
 
     inline void RegisterHandler(
         const std::string &path,
@@ -77,8 +80,13 @@ class OlaHTTPServer {
     }
 
     int DisplayDebug(const HTTPRequest *request, HTTPResponse *response);
+    int DisplayLoopDebug(const HTTPRequest *request, HTTPResponse *response);
+    int DisplayTrace(const HTTPRequest *request, HTTPResponse *response);
+    int DisplayMetrics(const HTTPRequest *request, HTTPResponse *response);
     int DisplayHandlers(const HTTPRequest *request, HTTPResponse *response);
 
+    void UpdateUptime();
+
     DISALLOW_COPY_AND_ASSIGN(OlaHTTPServer);
 };
 }  // namespace http
@@ -199,6 +199,113 @@ class BigEndianOutputStream: public BigEndianOutputStreamInterface {
     BigEndianOutputStream(const BigEndianOutputStream&);
     BigEndianOutputStream& operator=(const BigEndianOutputStream&);
 };
+
+/**
+ * A Big Endian output stream that writes to a concrete buffer type.
+ *
+ * BigEndianOutputStream makes two virtual calls for each field it writes.
+ * This calls Buffer::Write() directly, so a buffer with an inline Write(),
+ * like MemoryOutputBuffer, packs each field with a store. Buffer must be a
+ * concrete class with a Write(const uint8_t*, unsigned int) method, e.g.
+ * IOQueue, IOStack or MemoryOutputBuffer.
+ */
+template <typename Buffer>
+class BigEndianBufferOutputStream {
+ public:
+    // Ownership of the buffer is not transferred.
+    explicit BigEndianBufferOutputStream(Buffer *buffer)
+        : m_buffer(buffer) {
+    }
+    ~BigEndianBufferOutputStream() {}
+
+    void Write(const uint8_t *data, unsigned int length) {
+      m_buffer->Buffer::Write(data, length);
+    }
+
+    BigEndianBufferOutputStream& operator<<(int8_t val) {
+      return Output(val);
+    }
+
+    BigEndianBufferOutputStream& operator<<(uint8_t val) {
+      return Output(val);
+    }
+
+    BigEndianBufferOutputStream& operator<<(int16_t val) {
+      return Output(val);
+    }
+
+    BigEndianBufferOutputStream& operator<<(uint16_t val) {
+      return Output(val);
+    }
+
+    BigEndianBufferOutputStream& operator<<(int32_t val) {
+      return Output(val);
+    }
+
+    BigEndianBufferOutputStream& operator<<(uint32_t val) {
+      return Output(val);
+    }
+
+ private:
+    Buffer *m_buffer;
+
+    template <typename T>
+    BigEndianBufferOutputStream& Output(T val) {
+      val = ola::network::HostToNetwork(val);
+      m_buffer->Buffer::Write(reinterpret_cast<const uint8_t*>(&val),
+                              static_cast<unsigned int>(sizeof(val)));
+      return *this;
+    }
+
+    BigEndianBufferOutputStream(const BigEndianBufferOutputStream&);
+    BigEndianBufferOutputStream& operator=(
+        const BigEndianBufferOutputStream&);
+};
+
+
+/**
+ * A Big Endian input stream that reads from a concrete buffer type.
+ *
+ * The counterpart of BigEndianBufferOutputStream, Buffer::Read() is called
+ * directly rather than through InputBufferInterface. Buffer must be a
+ * concrete class with the Read() methods of InputBufferInterface, e.g.
+ * MemoryBuffer or IOQueue.
+ */
+template <typename Buffer>
+class BigEndianBufferInputStream {
+ public:
+    // Ownership of the buffer is not transferred.
+    explicit BigEndianBufferInputStream(Buffer *buffer)
+        : m_buffer(buffer) {
+    }
+    ~BigEndianBufferInputStream() {}
+
+    bool operator>>(int8_t &val) { return ReadAndConvert(&val); }
+    bool operator>>(uint8_t &val) { return ReadAndConvert(&val); }
+    bool operator>>(int16_t &val) { return ReadAndConvert(&val); }
+    bool operator>>(uint16_t &val) { return ReadAndConvert(&val); }
+    bool operator>>(int32_t &val) { return ReadAndConvert(&val); }
+    bool operator>>(uint32_t &val) { return ReadAndConvert(&val); }
+
+    unsigned int ReadString(std::string *output, unsigned int size) {
+      return m_buffer->Buffer::Read(output, size);
+    }
+
+ private:
+    Buffer *m_buffer;
+
+    template <typename T>
+    bool ReadAndConvert(T *val) {
+      const unsigned int size = static_cast<unsigned int>(sizeof(*val));
+      bool ok = m_buffer->Buffer::Read(reinterpret_cast<uint8_t*>(val),
+                                       size) == size;
+      *val = ola::network::NetworkToHost(*val);
+      return ok;
+    }
+
+    BigEndianBufferInputStream(const BigEndianBufferInputStream&);
+    BigEndianBufferInputStream& operator=(const BigEndianBufferInputStream&);
+};
 }  // namespace io
 }  // namespace ola
 #endif  // INCLUDE_OLA_IO_BIGENDIANSTREAM_H_
@@ -134,6 +134,19 @@ int ToFD(const DescriptorHandle& handle);
  * A FileDescriptor which can be read from.
  */
 
+/**
+ * @brief The order in which ready descriptors are serviced.
+ *
+ * In each pass of the event loop, the high priority descriptors that are
+ * ready are serviced before the normal priority ones. This is used for the
+ * descriptors that receive DMX data.
+ */
+enum DescriptorPriority {
+  DESCRIPTOR_PRIORITY_HIGH,
+  DESCRIPTOR_PRIORITY_NORMAL,
+};
+
+
 /**
  * @brief Represents a file descriptor that supports reading data.
  */
@@ -161,6 +174,35 @@ class ReadFileDescriptor {
    * This is usually called by the SelectServer.
    */
   virtual void PerformRead() = 0;
+
+  /**
+   * @brief Check if this descriptor should be registered edge-triggered.
+   *
+   * Edge-triggered descriptors are only reported when new data arrives, so
+   * the poller calls DrainRead() until it returns false. Pollers that don't
+   * support edge-triggered descriptors call PerformRead() as usual.
+   */
+  virtual bool EdgeTriggered() const { return false; }
+
+  /**
+   * @brief Called when an edge-triggered descriptor is readable.
+   * @returns true if there may be more data to read, false once a read would
+   * block or nothing was read.
+   */
+  virtual bool DrainRead() {
+    PerformRead();
+    return false;
+  }
+
+  /**
+   * @brief The priority of this descriptor.
+   *
+   * Pollers that don't support priorities service the descriptors in their
+   * usual order.
+   */
+  virtual DescriptorPriority Priority() const {
+    return DESCRIPTOR_PRIORITY_NORMAL;
+  }
 };
 
 
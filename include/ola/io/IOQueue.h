@@ -29,6 +29,7 @@
 #include <iostream>
 #include <queue>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace io {
@@ -64,6 +65,24 @@ class IOQueue: public InputBufferInterface,
     const struct IOVec *AsIOVec(int *io_count) const;
     void Pop(unsigned int n);
 
+    /**
+     * @brief Remove the first n bytes, without releasing the emptied blocks.
+     * @param n the number of bytes to remove.
+     * @param blocks the blocks that were emptied are appended to this vector.
+     *   Ownership of the blocks is transferred, use Release() to return them
+     *   to the pool.
+     *
+     * This is used when the memory must remain valid after the data has been
+     * removed, e.g. while the kernel is still sending it.
+     */
+    void Pop(unsigned int n, std::vector<class MemoryBlock*> *blocks);
+
+    /**
+     * @brief Release MemoryBlocks back to the pool used by this queue.
+     * @param blocks the blocks to release.
+     */
+    void Release(const std::vector<class MemoryBlock*> &blocks);
+
     // Append a MemoryBlock to this IOQueue. Ownership of the block is taken.
     void AppendBlock(class MemoryBlock *block);
 
@@ -16,7 +16,9 @@ olaioinclude_HEADERS = \
     include/ola/io/NonBlockingSender.h \
     include/ola/io/OutputBuffer.h \
     include/ola/io/OutputStream.h \
+    include/ola/io/RingBuffer.h \
     include/ola/io/SelectServer.h \
     include/ola/io/SelectServerInterface.h \
+    include/ola/io/SelectServerPool.h \
     include/ola/io/Serial.h \
     include/ola/io/StdinHandler.h
@@ -70,6 +70,15 @@ class MemoryBlock {
       m_last = m_first;
     }
 
+    /**
+     * @brief Discard any data and move the insertation point to the start of
+     * the block.
+     */
+    void Reset() {
+      m_first = m_data;
+      m_last = m_first;
+    }
+
     /**
      * @brief The size of the memory region for this block.
      * @returns the size of the memory region for this block.
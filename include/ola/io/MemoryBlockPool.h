@@ -21,80 +21,183 @@
 #ifndef INCLUDE_OLA_IO_MEMORYBLOCKPOOL_H_
 #define INCLUDE_OLA_IO_MEMORYBLOCKPOOL_H_
 
-#include <ola/Logging.h>
+#include <ola/base/Macro.h>
 #include <ola/io/MemoryBlock.h>
-#include <queue>
+#include <string>
+#include <vector>
 
 namespace ola {
+
+class ExportMap;
+class UIntMap;
+
 namespace io {
 
 /**
- * @brief MemoryBlockPool. This class is not thread safe.
- * @param block_size the size of blocks to use.
+ * @brief MemoryBlockPool.
+ *
+ * The pool has one or more size classes, each twice the size of the previous
+ * one. Released blocks are kept on a free list for their size class.
+ *
+ * By default the pool is not thread safe. If Options::thread_safe is set,
+ * each thread keeps a small cache of free blocks, backed by a shared depot.
+ * This allows the blocks in an IOQueue or IOStack to be handed to another
+ * thread without copying. A thread safe pool must outlive the threads that
+ * use it.
  */
 class MemoryBlockPool {
  public:
-    explicit MemoryBlockPool(unsigned int block_size = DEFAULT_BLOCK_SIZE)
-        : m_block_size(block_size),
-          m_blocks_allocated(0) {
-    }
-    ~MemoryBlockPool() {
-      Purge();
-    }
-
-    // Allocate a new MemoryBlock from the pool. May return NULL if allocation
-    // fails.
-    MemoryBlock *Allocate() {
-      if (m_free_blocks.empty()) {
-        uint8_t* data = new uint8_t[m_block_size];
-        OLA_DEBUG << "new block allocated at @" << reinterpret_cast<int*>(data);
-        if (data) {
-          m_blocks_allocated++;
-          return new MemoryBlock(data, m_block_size);
-        } else {
-          return NULL;
-        }
-      } else {
-        MemoryBlock *block = m_free_blocks.front();
-        m_free_blocks.pop();
-        return block;
+    struct Options {
+     public:
+      Options()
+          : block_size(DEFAULT_BLOCK_SIZE),
+            size_classes(1),
+            thread_safe(false),
+            thread_cache_size(DEFAULT_THREAD_CACHE_SIZE),
+            export_map(NULL),
+            name("default") {
       }
-    }
 
-    // Release a MemoryBlock back to the pool.
-    void Release(MemoryBlock *block) {
-      m_free_blocks.push(block);
-    }
+      /**
+       * @brief The size of blocks in the smallest size class.
+       */
+      unsigned int block_size;
 
-    // Returns the number of free blocks in the pool.
-    unsigned int FreeBlocks() const {
-      return static_cast<unsigned int>(m_free_blocks.size());
-    }
+      /**
+       * @brief The number of size classes.
+       */
+      unsigned int size_classes;
+
+      /**
+       * @brief Allow the pool to be used from more than one thread.
+       */
+      bool thread_safe;
+
+      /**
+       * @brief The number of free blocks each thread can hold, per size
+       * class, before they're returned to the depot.
+       */
+      unsigned int thread_cache_size;
+
+      /**
+       * @brief The ExportMap to record the hit & miss counts in.
+       */
+      ola::ExportMap *export_map;
+
+      /**
+       * @brief The name of the pool, used for the ExportMap keys.
+       */
+      std::string name;
+    };
+
+    /**
+     * @brief Create a new single threaded pool.
+     * @param block_size the size of blocks to use.
+     */
+    explicit MemoryBlockPool(unsigned int block_size = DEFAULT_BLOCK_SIZE);
 
-    // Deletes all free blocks.
+    /**
+     * @brief Create a new pool.
+     * @param options the options for the pool.
+     */
+    explicit MemoryBlockPool(const Options &options);
+
+    ~MemoryBlockPool();
+
+    /**
+     * @brief Allocate a new MemoryBlock from the smallest size class.
+     * @returns a new MemoryBlock, or NULL if allocation fails.
+     */
+    MemoryBlock *Allocate();
+
+    /**
+     * @brief Allocate a MemoryBlock with a capacity of at least size bytes.
+     * @param size the minimum size of the block.
+     * @returns a new MemoryBlock, or NULL if size is larger than
+     *   MaxBlockSize() or allocation fails.
+     */
+    MemoryBlock *Allocate(unsigned int size);
+
+    /**
+     * @brief Release a MemoryBlock back to the pool.
+     * @param block the block to release. Any data in the block is discarded.
+     */
+    void Release(MemoryBlock *block);
+
+    /**
+     * @brief Returns the number of free blocks in the pool.
+     *
+     * For a thread safe pool, this is the blocks in the depot and the
+     * calling thread's cache.
+     */
+    unsigned int FreeBlocks() const;
+
+    /**
+     * @brief Deletes all free blocks.
+     */
     void Purge() {
       Purge(0);
     }
 
-    // Delete all but remaining free blocks.
-    void Purge(unsigned int remaining) {
-      while (m_free_blocks.size() != remaining) {
-        MemoryBlock *block = m_free_blocks.front();
-        m_blocks_allocated--;
-        delete block;
-        m_free_blocks.pop();
-      }
-    }
+    /**
+     * @brief Delete all but remaining free blocks.
+     */
+    void Purge(unsigned int remaining);
 
-    unsigned int BlocksAllocated() const { return m_blocks_allocated; }
+    /**
+     * @brief The number of blocks allocated, and not yet purged.
+     */
+    unsigned int BlocksAllocated() const;
+
+    /**
+     * @brief The size of blocks in the smallest size class.
+     */
+    unsigned int BlockSize() const { return m_block_sizes.front(); }
+
+    /**
+     * @brief The size of blocks in the largest size class.
+     */
+    unsigned int MaxBlockSize() const { return m_block_sizes.back(); }
 
     // default to 1k blocks
     static const unsigned int DEFAULT_BLOCK_SIZE = 1024;
+    static const unsigned int DEFAULT_THREAD_CACHE_SIZE = 32;
+
+    static const char K_POOL_HITS_VAR[];
+    static const char K_POOL_MISSES_VAR[];
 
  private:
-    std::queue<MemoryBlock*> m_free_blocks;
-    const unsigned int m_block_size;
+    typedef std::vector<MemoryBlock*> BlockVector;
+    struct ThreadCache;
+    struct ThreadState;
+
+    std::vector<unsigned int> m_block_sizes;
+    // The free blocks for each size class. For a thread safe pool, this is
+    // the depot and is protected by the mutex in m_thread_state.
+    std::vector<BlockVector> m_free_blocks;
     unsigned int m_blocks_allocated;
+    const unsigned int m_thread_cache_size;
+    ThreadState *m_thread_state;
+    UIntMap *m_hits_var;
+    UIntMap *m_misses_var;
+    std::vector<std::string> m_stat_keys;
+
+    void Init(const Options &options);
+    int SizeClass(unsigned int capacity) const;
+    MemoryBlock *AllocateFromClass(unsigned int size_class);
+    MemoryBlock *AllocateFromDepot(unsigned int size_class,
+                                   ThreadCache *cache);
+    MemoryBlock *NewBlock(unsigned int size_class);
+    void ReturnToDepot(ThreadCache *cache, unsigned int size_class,
+                       unsigned int remaining);
+    void FlushHits(ThreadCache *cache);
+    ThreadCache *GetThreadCache() const;
+    void DeleteThreadCache(ThreadCache *cache);
+    unsigned int DepotBlocks() const;
+
+    static void ThreadExit(void *data);
+
+    DISALLOW_COPY_AND_ASSIGN(MemoryBlockPool);
 };
 }  // namespace io
 }  // namespace ola
@@ -14,7 +14,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  *
  * MemoryBuffer.h
- * An derrived class of InputBuffer that wraps a memory buffer.
+ * Input and output buffers that wrap a block of memory.
  * Copyright (C) 2012 Simon Newton
  */
 
@@ -66,6 +66,56 @@ class MemoryBuffer: public InputBufferInterface {
     MemoryBuffer(const MemoryBuffer&);
     MemoryBuffer& operator=(const MemoryBuffer&);
 };
+
+
+/**
+ * Wraps a block of memory so it can be written to by
+ * BigEndianBufferOutputStream. Unlike an OutputBufferInterface, the size is
+ * fixed: data written past the end is dropped and Overflowed() returns true.
+ *
+ * Write() is inline and non-virtual so that a stream over this buffer packs
+ * each field with a couple of stores.
+ */
+class MemoryOutputBuffer {
+ public:
+    MemoryOutputBuffer(uint8_t *data, unsigned int size)
+        : m_data(data),
+          m_size(size),
+          m_cursor(0),
+          m_overflowed(false) {
+    }
+    ~MemoryOutputBuffer() {}
+
+    bool Empty() const { return m_cursor == 0; }
+    unsigned int Size() const { return m_cursor; }
+
+    // True if a write didn't fit in the memory.
+    bool Overflowed() const { return m_overflowed; }
+
+    void Write(const uint8_t *data, unsigned int length) {
+      if (length > m_size - m_cursor) {
+        length = m_size - m_cursor;
+        m_overflowed = true;
+      }
+      memcpy(m_data + m_cursor, data, length);
+      m_cursor += length;
+    }
+
+    // Start writing from the beginning of the memory again.
+    void Reset() {
+      m_cursor = 0;
+      m_overflowed = false;
+    }
+
+ private:
+    uint8_t *m_data;
+    const unsigned int m_size;
+    unsigned int m_cursor;
+    bool m_overflowed;
+
+    MemoryOutputBuffer(const MemoryOutputBuffer&);
+    MemoryOutputBuffer& operator=(const MemoryOutputBuffer&);
+};
 }  // namespace io
 }  // namespace ola
 #endif  // INCLUDE_OLA_IO_MEMORYBUFFER_H_
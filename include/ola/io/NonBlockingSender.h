@@ -30,11 +30,16 @@
 #ifndef INCLUDE_OLA_IO_NONBLOCKINGSENDER_H_
 #define INCLUDE_OLA_IO_NONBLOCKINGSENDER_H_
 
+#include <ola/Callback.h>
 #include <ola/io/Descriptor.h>
 #include <ola/io/IOQueue.h>
 #include <ola/io/MemoryBlockPool.h>
 #include <ola/io/OutputBuffer.h>
 #include <ola/io/SelectServerInterface.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <stdint.h>
+#include <deque>
+#include <memory>
 
 namespace ola {
 namespace io {
@@ -83,6 +88,22 @@ class NonBlockingSender {
    */
   bool LimitReached() const;
 
+  /**
+   * @brief Check if all the buffered data has been written.
+   * @return true if there is no data waiting to be written, false otherwise.
+   */
+  bool Empty() const;
+
+  /**
+   * @brief Set a callback to run each time the buffered data has all been
+   *   written.
+   * @param callback the callback to run, ownership is transferred.
+   *
+   * This allows a sender to hold data back until the descriptor has caught
+   * up, and then send only the latest data.
+   */
+  void SetOnDrain(ola::Callback0<void> *callback);
+
   /**
    * @brief Send the contents of an IOStack on the ConnectedDescriptor.
    * @param stack the IOStack to send. All data in this stack will be sent and
@@ -101,6 +122,37 @@ class NonBlockingSender {
    */
   bool SendMessage(IOQueue *queue);
 
+  /**
+   * @brief Use MSG_ZEROCOPY for large writes.
+   * @param threshold the minimum amount of buffered data before MSG_ZEROCOPY
+   *   is used. Below this the cost of tracking the completions outweighs the
+   *   cost of the copy.
+   * @returns true if zero copy sends are supported by the descriptor, false
+   *   otherwise.
+   *
+   * With MSG_ZEROCOPY, the kernel sends directly from the MemoryBlocks, so
+   * they are held until the kernel reports the send has completed. This is
+   * only available for TCP sockets on Linux 4.14 or later.
+   */
+  bool EnableZeroCopy(unsigned int threshold = DEFAULT_ZEROCOPY_THRESHOLD);
+
+  /**
+   * @brief Check if MSG_ZEROCOPY is in use.
+   * @returns true if zero copy sends are enabled.
+   *
+   * This is disabled automatically if the kernel reports it had to copy the
+   * data anyway, as happens on the loopback interface.
+   */
+  bool ZeroCopyEnabled() const { return m_zerocopy; }
+
+  /**
+   * @brief The number of MemoryBlocks waiting for the kernel to complete a
+   *   zero copy send.
+   */
+  unsigned int ZeroCopyPendingBlocks() const {
+    return static_cast<unsigned int>(m_zerocopy_pending.size());
+  }
+
   /**
    * @brief The default max internal buffer size.
    *
@@ -112,15 +164,45 @@ class NonBlockingSender {
    */
   static const unsigned int DEFAULT_MAX_BUFFER_SIZE;
 
+  /**
+   * @brief The default minimum size of a zero copy send.
+   */
+  static const unsigned int DEFAULT_ZEROCOPY_THRESHOLD;
+
  private:
+  struct PendingBlock {
+    PendingBlock(uint32_t sequence, class MemoryBlock *block)
+        : sequence(sequence),
+          block(block) {
+    }
+
+    // The last zero copy send that used this block.
+    uint32_t sequence;
+    class MemoryBlock *block;
+  };
+
   ola::io::ConnectedDescriptor *m_descriptor;
   ola::io::SelectServerInterface *m_ss;
   ola::io::IOQueue m_output_buffer;
   bool m_associated;
   unsigned int m_max_buffer_size;
+  bool m_zerocopy;
+  unsigned int m_zerocopy_threshold;
+  // The sequence number the kernel will assign to the next zero copy send.
+  uint32_t m_zerocopy_next;
+  // All sends before this sequence number have completed.
+  uint32_t m_zerocopy_completed;
+  std::deque<PendingBlock> m_zerocopy_pending;
+  ola::thread::timeout_id m_zerocopy_timeout;
+  std::auto_ptr<ola::Callback0<void> > m_on_drain;
 
   void PerformWrite();
   void AssociateIfRequired();
+  void ZeroCopyWrite();
+  void ReapZeroCopyCompletions();
+  bool ZeroCopyTimeout();
+
+  static const unsigned int ZEROCOPY_POLL_INTERVAL_MS;
 
   DISALLOW_COPY_AND_ASSIGN(NonBlockingSender);
 };
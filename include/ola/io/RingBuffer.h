@@ -0,0 +1,160 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RingBuffer.h
+ * A contiguous byte queue.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file RingBuffer.h
+ * @brief A contiguous byte queue.
+ */
+
+#ifndef INCLUDE_OLA_IO_RINGBUFFER_H_
+#define INCLUDE_OLA_IO_RINGBUFFER_H_
+
+#include <ola/base/Macro.h>
+#include <ola/io/IOVecInterface.h>
+#include <ola/io/InputBuffer.h>
+#include <ola/io/OutputBuffer.h>
+#include <stdint.h>
+#include <string>
+
+namespace ola {
+namespace io {
+
+/**
+ * @brief A byte queue that keeps its data in a single contiguous region.
+ *
+ * IOQueue stores data in a list of MemoryBlocks, so a message that straddles
+ * two blocks needs two IOVecs to send and a copy to parse. A RingBuffer's
+ * data is always contiguous: Data() points to every byte in the buffer, and
+ * Reserve() returns a single region to receive into.
+ *
+ * Where the platform supports it (Linux, with memfd_create), the buffer is a
+ * ring mapped twice into adjacent virtual memory, so data that wraps past
+ * the end of the ring carries on into the second mapping. Neither reads nor
+ * writes ever need to wrap or move data. Elsewhere, the data is moved to the
+ * front of the buffer when the space at the end runs out, which is what the
+ * RPC layer used to do by hand.
+ *
+ * The buffer grows as needed, it never shrinks.
+ */
+class RingBuffer: public InputBufferInterface,
+                  public OutputBufferInterface,
+                  public IOVecInterface {
+ public:
+  /**
+   * @brief Create a new RingBuffer.
+   * @param capacity the initial capacity. This is rounded up to a multiple
+   *   of the page size if the buffer is double mapped.
+   */
+  explicit RingBuffer(unsigned int capacity = DEFAULT_CAPACITY);
+  ~RingBuffer();
+
+  unsigned int Size() const { return m_size; }
+  bool Empty() const { return m_size == 0; }
+
+  /**
+   * @brief The number of bytes the buffer can hold before it has to grow.
+   */
+  unsigned int Capacity() const { return m_capacity; }
+
+  /**
+   * @brief Check if the buffer is double mapped.
+   */
+  bool DoubleMapped() const { return m_mapped; }
+
+  /**
+   * @brief A pointer to the data in the buffer.
+   * @returns a pointer to Size() contiguous bytes. This is valid until the
+   *   next call to Write() or Reserve().
+   */
+  const uint8_t *Data() const { return m_base + m_read; }
+
+  // From OutputBufferInterface
+  void Write(const uint8_t *data, unsigned int length);
+
+  // From InputBufferInterface, these consume data from the buffer.
+  unsigned int Read(uint8_t *data, unsigned int length);
+  unsigned int Read(std::string *output, unsigned int length);
+
+  /**
+   * @brief Copy data from the buffer without removing it.
+   * @param data the location to copy to.
+   * @param length the maximum number of bytes to copy.
+   * @returns the number of bytes copied.
+   */
+  unsigned int Peek(uint8_t *data, unsigned int length) const;
+
+  /**
+   * @brief Get space to write data into directly, e.g. with recv().
+   * @param length the number of bytes required.
+   * @returns a pointer to at least length bytes of contiguous space, or
+   *   NULL if the buffer couldn't grow. Call Commit() with the number of
+   *   bytes written.
+   *
+   * WritableSize() returns the actual amount of space, which may be more
+   * than length.
+   */
+  uint8_t *Reserve(unsigned int length);
+
+  /**
+   * @brief The number of bytes that can be written at the pointer returned
+   *   by Reserve() without the buffer growing.
+   */
+  unsigned int WritableSize() const;
+
+  /**
+   * @brief Add bytes written to the space returned by Reserve().
+   * @param length the number of bytes written, at most WritableSize().
+   */
+  void Commit(unsigned int length);
+
+  // From IOVecInterface, AsIOVec() always returns a single IOVec.
+  const struct IOVec *AsIOVec(int *io_count) const;
+  void Pop(unsigned int n);
+
+  /**
+   * @brief Remove all the data from the buffer.
+   */
+  void Clear();
+
+  /**
+   * @brief The default initial capacity.
+   */
+  static const unsigned int DEFAULT_CAPACITY = 4096;
+
+ private:
+  uint8_t *m_base;
+  unsigned int m_capacity;
+  // The offset of the first byte of data, always less than m_capacity.
+  unsigned int m_read;
+  unsigned int m_size;
+  bool m_mapped;
+
+  unsigned int WriteOffset() const;
+  bool Grow(unsigned int required);
+  void Free();
+
+  static uint8_t *MapRing(unsigned int capacity);
+  static void UnmapRing(uint8_t *base, unsigned int capacity);
+
+  DISALLOW_COPY_AND_ASSIGN(RingBuffer);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // INCLUDE_OLA_IO_RINGBUFFER_H_
@@ -27,8 +27,10 @@
 #include <ola/io/Descriptor.h>
 #include <ola/io/SelectServerInterface.h>
 #include <ola/network/Socket.h>
+#include <ola/thread/MPSCQueue.h>
 #include <ola/thread/Thread.h>
 
+#include <deque>
 #include <memory>
 #include <set>
 #include <vector>
@@ -53,7 +55,8 @@ namespace io {
  *
  * The SelectServer has a number of different implementations depending on the
  * platform. On systems with epoll, the flag --no-use-epoll will disable the
- * use of epoll(), reverting to select(). The PollerInterface defines the
+ * use of epoll(), reverting to select(). On Linux 5.11 or later, the flag
+ * --use-io-uring will use io_uring instead. The PollerInterface defines the
  * contract between the SelectServer and the lower level, platform dependant
  * Poller classes.
  *
@@ -66,6 +69,13 @@ class SelectServer: public SelectServerInterface {
    public:
     Options()
         : force_select(false),
+          timer_wheel(false),
+          busy_poll_usec(0),
+          high_resolution_timers(false),
+          cpu_affinity(-1),
+          profile_loop(false),
+          slow_callback_usec(10000),
+          bulk_budget_usec(2000),
           export_map(NULL),
           clock(NULL) {
     }
@@ -76,6 +86,54 @@ class SelectServer: public SelectServerInterface {
      */
     bool force_select;
 
+    /**
+     * @brief Use a timer wheel for the timeouts, rather than a priority
+     * queue. This is also enabled by the --use-timer-wheel flag.
+     */
+    bool timer_wheel;
+
+    /**
+     * @brief Spin for up to this many microseconds checking for events before
+     * blocking, and set SO_BUSY_POLL on sockets.
+     *
+     * This reduces the latency from packet arrival to the callback running,
+     * at the cost of CPU time. Only supported with epoll.
+     */
+    unsigned int busy_poll_usec;
+
+    /**
+     * @brief Use a timerfd for timeouts, rather than the millisecond
+     * resolution of the poll timeout. Only supported with epoll.
+     */
+    bool high_resolution_timers;
+
+    /**
+     * @brief The CPU to pin the thread that calls Run() to, or -1 to leave it
+     *   unpinned.
+     */
+    int cpu_affinity;
+
+    /**
+     * @brief Record the execution time of each descriptor and timeout
+     * callback. This is also enabled by the --profile-loop flag.
+     *
+     * The results are exported as ss-loop-* variables, so this requires an
+     * export map. Descriptor callbacks are only profiled with epoll.
+     */
+    bool profile_loop;
+
+    /**
+     * @brief When profiling, callbacks that run for at least this many
+     * microseconds are counted as slow.
+     */
+    unsigned int slow_callback_usec;
+
+    /**
+     * @brief The time to spend running callbacks added with ExecuteBulk(), in
+     * each pass of the event loop.
+     */
+    unsigned int bulk_budget_usec;
+
     /**
      * @brief The export map to use.
      */
@@ -189,6 +247,20 @@ class SelectServer: public SelectServerInterface {
 
   void Execute(ola::BaseCallback0<void> *callback);
 
+  /**
+   * @brief Run a callback once the I/O and timeouts have been handled.
+   * @param callback the callback to run. Ownership is transferred to the
+   *   SelectServer.
+   *
+   * This is for work that can be deferred, such as saving preferences or
+   * handling configuration changes. The bulk callbacks run in the order they
+   * were added, for up to the bulk budget in each pass of the event loop, so
+   * a burst of them doesn't delay DMX. Unlike Execute(), this must be called
+   * from the thread running the SelectServer, and any bulk callbacks that
+   * haven't run when the SelectServer is deleted are discarded.
+   */
+  void ExecuteBulk(ola::BaseCallback0<void> *callback);
+
   void DrainCallbacks();
 
  private:
@@ -198,21 +270,32 @@ class SelectServer: public SelectServerInterface {
   ExportMap *m_export_map;
   bool m_terminate, m_is_running;
   TimeInterval m_poll_interval;
+  int m_cpu_affinity;
+  std::auto_ptr<class LoopProfiler> m_profiler;
   std::auto_ptr<class TimeoutManager> m_timeout_manager;
   std::auto_ptr<class PollerInterface> m_poller;
 
   Clock *m_clock;
   bool m_free_clock;
   LoopClosureSet m_loop_callbacks;
-  Callbacks m_incoming_callbacks;
-  ola::thread::Mutex m_incoming_mutex;
+  // Callbacks from Execute(), the first callback in each batch writes to
+  // m_incoming_descriptor to wake up the loop.
+  ola::thread::MPSCQueue<ola::BaseCallback0<void>*> m_incoming_callbacks;
   LoopbackDescriptor m_incoming_descriptor;
+  CounterVariable *m_execute_callbacks;
+  CounterVariable *m_execute_wakeups;
+  IntegerVariable *m_execute_queue_depth;
+  std::deque<ola::BaseCallback0<void>*> m_bulk_callbacks;
+  TimeInterval m_bulk_budget;
+  IntegerVariable *m_bulk_queue_depth;
 
   void Init(const Options &options);
   bool CheckForEvents(const TimeInterval &poll_interval);
   void DrainAndExecute();
   void RunCallbacks(Callbacks *callbacks);
+  void RunBulkCallbacks();
   void SetTerminate() { m_terminate = true; }
+  void SetAffinity();
 
   // the maximum time we'll wait in the select call
   static const unsigned int POLL_INTERVAL_SECOND = 10;
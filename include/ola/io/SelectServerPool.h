@@ -0,0 +1,90 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SelectServerPool.h
+ * A number of SelectServers, each running in its own thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_IO_SELECTSERVERPOOL_H_
+#define INCLUDE_OLA_IO_SELECTSERVERPOOL_H_
+
+#include <ola/base/Macro.h>
+#include <ola/io/SelectServer.h>
+#include <ola/thread/CallbackThread.h>
+
+#include <vector>
+
+namespace ola {
+namespace io {
+
+/**
+ * @brief A pool of SelectServers, each running in its own thread.
+ *
+ * Each loop is independent, so descriptors should be added to a loop before
+ * Start() is called, or with SelectServer::Execute() once it's running.
+ * ola::network::ReusePortGroup can be used to give each loop its own socket
+ * for the same port.
+ */
+class SelectServerPool {
+ public:
+  /**
+   * @brief Create a new SelectServerPool.
+   * @param size the number of SelectServers.
+   * @param options the options for each SelectServer.
+   *
+   * The ExportMap isn't thread safe, so options.export_map is ignored. If
+   * options.cpu_affinity is set, loop N is pinned to CPU cpu_affinity + N.
+   */
+  explicit SelectServerPool(
+      unsigned int size,
+      const SelectServer::Options &options = SelectServer::Options());
+
+  /**
+   * @brief Stop the threads and delete the SelectServers.
+   */
+  ~SelectServerPool();
+
+  /**
+   * @brief The number of SelectServers in the pool.
+   */
+  unsigned int Size() const { return m_servers.size(); }
+
+  /**
+   * @brief Return a SelectServer from the pool.
+   * @param index the index of the SelectServer, must be less than Size().
+   */
+  SelectServer *Get(unsigned int index) { return m_servers[index]; }
+
+  /**
+   * @brief Start a thread for each SelectServer.
+   * @returns true if all the threads started, false otherwise.
+   */
+  bool Start();
+
+  /**
+   * @brief Terminate the SelectServers and join the threads.
+   */
+  void Stop();
+
+ private:
+  std::vector<SelectServer*> m_servers;
+  std::vector<ola::thread::CallbackThread*> m_threads;
+
+  DISALLOW_COPY_AND_ASSIGN(SelectServerPool);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // INCLUDE_OLA_IO_SELECTSERVERPOOL_H_
@@ -26,6 +26,7 @@
 #include <ola/network/MACAddress.h>
 #include <ola/rdm/UID.h>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <utility>
@@ -33,6 +34,7 @@
 namespace ola {
 namespace messaging {
 
+class DescriptorLayout;
 class FieldDescriptorVisitor;
 
 /**
@@ -401,8 +403,15 @@ class Descriptor: public FieldDescriptorGroup {
     Descriptor(const std::string &name,
                const std::vector<const FieldDescriptor*> &fields)
         : FieldDescriptorGroup(name, fields, 1, 1) {}
+    ~Descriptor();
 
     void Accept(FieldDescriptorVisitor *visitor) const;
+
+    // The compiled layout of the fields, this is built on first use.
+    const DescriptorLayout &Layout() const;
+
+ private:
+    mutable std::auto_ptr<const DescriptorLayout> m_layout;
 };
 }  // namespace messaging
 }  // namespace ola
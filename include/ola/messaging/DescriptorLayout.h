@@ -0,0 +1,132 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DescriptorLayout.h
+ * A flattened form of a Descriptor, used to unpack messages.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_MESSAGING_DESCRIPTORLAYOUT_H_
+#define INCLUDE_OLA_MESSAGING_DESCRIPTORLAYOUT_H_
+
+#include <ola/base/Macro.h>
+#include <vector>
+
+namespace ola {
+namespace messaging {
+
+class Descriptor;
+class FieldDescriptor;
+class FieldDescriptorGroup;
+class StringFieldDescriptor;
+
+/**
+ * @brief The fields of a Descriptor, compiled into a flat list of operations.
+ *
+ * Building the layout walks the descriptor once. Afterwards the size of the
+ * fixed fields and the single variable field (if any) are known, so the
+ * layout of a message can be determined from its length without visiting the
+ * descriptor again.
+ *
+ * Groups are stored as a GROUP op, followed by the ops for the fields within
+ * the group. The group op records the index of the op after the group's
+ * fields.
+ */
+class DescriptorLayout {
+ public:
+    enum OpCode {
+      BOOL,
+      UINT8,
+      UINT16,
+      UINT32,
+      INT8,
+      INT16,
+      INT32,
+      IPV4,
+      MAC,
+      UID,
+      STRING,
+      GROUP,
+    };
+
+    struct Op {
+      OpCode code;
+      // The descriptor for this field.
+      const FieldDescriptor *descriptor;
+      // The size in bytes, or 0 for a variable sized field.
+      unsigned int size;
+      bool little_endian;
+      // True if this is the top level variable sized field.
+      bool variable;
+      // For groups, the number of blocks if the group isn't variable, and the
+      // index of the op after the group's fields.
+      unsigned int blocks;
+      unsigned int end;
+    };
+
+    typedef std::vector<Op> OpList;
+
+    enum VariableFieldType {
+      NO_VARIABLE_FIELD,
+      VARIABLE_STRING,
+      VARIABLE_GROUP,
+      MULTIPLE_VARIABLE_FIELDS,
+      // The variable group contains variable sized fields.
+      NESTED_VARIABLE_GROUP,
+    };
+
+    explicit DescriptorLayout(const Descriptor *descriptor);
+
+    /**
+     * @brief The ops for the descriptor.
+     */
+    const OpList &Ops() const { return m_ops; }
+
+    /**
+     * @brief The total size of the fixed sized top level fields.
+     */
+    unsigned int FixedSize() const { return m_fixed_size; }
+
+    /**
+     * @brief The type of variable sized field in the descriptor.
+     */
+    VariableFieldType VariableType() const { return m_variable_type; }
+
+    /**
+     * @brief The variable sized string, if the type is VARIABLE_STRING.
+     */
+    const StringFieldDescriptor *VariableString() const {
+      return m_variable_string;
+    }
+
+    /**
+     * @brief The variable sized group, if the type is VARIABLE_GROUP.
+     */
+    const FieldDescriptorGroup *VariableGroup() const {
+      return m_variable_group;
+    }
+
+ private:
+    OpList m_ops;
+    unsigned int m_fixed_size;
+    VariableFieldType m_variable_type;
+    const StringFieldDescriptor *m_variable_string;
+    const FieldDescriptorGroup *m_variable_group;
+
+    DISALLOW_COPY_AND_ASSIGN(DescriptorLayout);
+};
+}  // namespace messaging
+}  // namespace ola
+#endif  // INCLUDE_OLA_MESSAGING_DESCRIPTORLAYOUT_H_
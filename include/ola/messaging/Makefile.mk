@@ -1,6 +1,7 @@
 olamessagingincludedir = $(pkgincludedir)/messaging/
 olamessaginginclude_HEADERS = \
     include/ola/messaging/Descriptor.h \
+    include/ola/messaging/DescriptorLayout.h \
     include/ola/messaging/DescriptorVisitor.h \
     include/ola/messaging/Message.h \
     include/ola/messaging/MessagePrinter.h \
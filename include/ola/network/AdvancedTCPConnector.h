@@ -28,8 +28,10 @@
 #include <ola/network/TCPConnector.h>
 #include <ola/network/TCPSocketFactory.h>
 #include <ola/util/Backoff.h>
-#include <map>
+#include <deque>
+#include <set>
 #include <utility>
+#include <vector>
 
 namespace ola {
 namespace network {
@@ -40,10 +42,14 @@ namespace network {
  * The AdvancedTCPConnector attempts to open connections to a endpoint. If
  * the connection fails it will retry according to a given BackOffPolicy.
  *
+ * The endpoints are held in a table sorted by IP:Port. Retries for all
+ * endpoints share a single timeout, which fires when the earliest retry is
+ * due. At most max_concurrent_connects connects run at once, the rest wait
+ * in a FIFO queue. This means that when many endpoints fail at the same time,
+ * for example after a network outage, they don't all reconnect at once.
+ *
  * Limitations:
  *  - This class only supports a single connection per IP:Port.
- *  - This class should work fine for a small number of TCP connections (100 or
- *    so). It'll need to be re-written if we want to support 1000s.
  */
 class AdvancedTCPConnector {
  public:
@@ -52,10 +58,14 @@ class AdvancedTCPConnector {
    * @param ss the SelectServerInterface to use for scheduling
    * @param socket_factory the factory to use for creating new sockets
    * @param connection_timeout the timeout for TCP connects.
+   * @param max_concurrent_connects the maximum number of connects to run at
+   *   once, 0 means no limit.
    */
-  AdvancedTCPConnector(ola::io::SelectServerInterface *ss,
-                       TCPSocketFactoryInterface *socket_factory,
-                       const ola::TimeInterval &connection_timeout);
+  AdvancedTCPConnector(
+      ola::io::SelectServerInterface *ss,
+      TCPSocketFactoryInterface *socket_factory,
+      const ola::TimeInterval &connection_timeout,
+      unsigned int max_concurrent_connects = DEFAULT_MAX_CONCURRENT_CONNECTS);
 
   ~AdvancedTCPConnector();
 
@@ -120,30 +130,68 @@ class AdvancedTCPConnector {
    */
   void Resume(const IPV4SocketAddress &endpoint);
 
+  /**
+   * @brief Return the number of connects in progress.
+   */
+  unsigned int ConnectsInProgress() const { return m_connects_in_progress; }
+
+  /**
+   * @brief Return the number of connects waiting for a free slot.
+   */
+  unsigned int QueuedConnects() const { return m_connect_queue.size(); }
+
+  /**
+   * @brief The default limit on the number of concurrent connects.
+   */
+  static const unsigned int DEFAULT_MAX_CONCURRENT_CONNECTS = 32;
+
  private:
+  typedef std::pair<IPV4Address, uint16_t> IPPortPair;
+
   typedef struct {
+    IPPortPair key;
     ConnectionState state;
     unsigned int failed_attempts;
-    ola::thread::timeout_id retry_timeout;
     TCPConnector::TCPConnectionID connection_id;
     BackOffPolicy *policy;
+    // The time of the next retry, if retry_scheduled is true.
+    TimeStamp retry_time;
+    bool retry_scheduled;
+    bool connecting;
+    bool queued;
     bool reconnect;
   } ConnectionInfo;
 
-  typedef std::pair<IPV4Address, uint16_t> IPPortPair;
-  typedef std::map<IPPortPair, ConnectionInfo*> ConnectionMap;
+  // Sorted by key.
+  typedef std::vector<ConnectionInfo> ConnectionTable;
+  typedef std::pair<TimeStamp, IPPortPair> Retry;
+  typedef std::set<Retry> RetrySchedule;
 
   TCPSocketFactoryInterface *m_socket_factory;
   ola::io::SelectServerInterface *m_ss;
+
   TCPConnector m_connector;
   const ola::TimeInterval m_connection_timeout;
-  ConnectionMap m_connections;
-
-  void ScheduleRetry(const IPPortPair &key, ConnectionInfo *info);
-  void RetryTimeout(IPPortPair key);
+  const unsigned int m_max_concurrent_connects;
+  ConnectionTable m_connections;
+  RetrySchedule m_retries;
+  ola::thread::timeout_id m_retry_timeout;
+  TimeStamp m_retry_timeout_time;
+  std::deque<IPPortPair> m_connect_queue;
+  unsigned int m_connects_in_progress;
+
+  ConnectionTable::iterator Find(const IPPortPair &key);
+  ConnectionTable::const_iterator Find(const IPPortPair &key) const;
+  ConnectionInfo *Lookup(const IPPortPair &key);
+  void ScheduleRetry(ConnectionInfo *info, const TimeInterval &delay);
+  void CancelRetry(ConnectionInfo *info);
+  void UpdateRetryTimeout();
+  void RetryTimeout();
   void ConnectionResult(IPPortPair key, int fd, int error);
-  void AttemptConnection(const IPPortPair &key, ConnectionInfo *state);
-  void AbortConnection(ConnectionInfo *state);
+  void AttemptConnection(ConnectionInfo *info);
+  void StartConnection(ConnectionInfo *info);
+  void StartQueuedConnects();
+  void AbortConnection(ConnectionInfo *info);
 
   DISALLOW_COPY_AND_ASSIGN(AdvancedTCPConnector);
 };
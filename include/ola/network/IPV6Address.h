@@ -0,0 +1,197 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IPV6Address.h
+ * Represents a IPv6 Address
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup network
+ * @{
+ * @file IPV6Address.h
+ * @brief Represents an IPv6 Address.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_IPV6ADDRESS_H_
+#define INCLUDE_OLA_NETWORK_IPV6ADDRESS_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <sstream>
+#include <string>
+
+namespace ola {
+namespace network {
+
+/**
+ * @addtogroup network
+ * @{
+ */
+
+/**
+ * @brief Represents a IPv6 Address.
+ *
+ * The address is stored as 16 bytes in network byte order.
+ */
+class IPV6Address {
+ public:
+    /**
+     * @brief The length in bytes of an IPv6 address.
+     */
+    enum { LENGTH = 16 };
+
+    /**
+     * @brief Create a new IPv6 Address set to the unspecified address (::).
+     */
+    IPV6Address() {
+      memset(m_address, 0, LENGTH);
+    }
+
+    /**
+     * @brief Create a new IPv6 Address from 16 bytes.
+     * @param address the ip address, in network byte order.
+     */
+    explicit IPV6Address(const uint8_t address[LENGTH]) {
+      memcpy(m_address, address, LENGTH);
+    }
+
+    /**
+     * @brief Copy constructor.
+     * @param other the IPV6Address to copy.
+     */
+    IPV6Address(const IPV6Address &other) {
+      memcpy(m_address, other.m_address, LENGTH);
+    }
+
+    /**
+     * @brief Assignment operator.
+     * @param other the IPV6Address to assign to this object.
+     */
+    IPV6Address& operator=(const IPV6Address &other) {
+      if (this != &other) {
+        memcpy(m_address, other.m_address, LENGTH);
+      }
+      return *this;
+    }
+
+    /**
+     * @brief Equals operator.
+     * @param other the IPV6Address to compare.
+     * @returns true if both IPV6Addresses are equal.
+     */
+    bool operator==(const IPV6Address &other) const {
+      return memcmp(m_address, other.m_address, LENGTH) == 0;
+    }
+
+    /**
+     * @brief Not equals operator.
+     * @param other the IPV6Address to compare.
+     * @returns false if both IPV6Addresses are equal.
+     */
+    bool operator!=(const IPV6Address &other) const {
+      return !(*this == other);
+    }
+
+    /**
+     * @brief Less than operator for partial ordering.
+     */
+    bool operator<(const IPV6Address &other) const {
+      return memcmp(m_address, other.m_address, LENGTH) < 0;
+    }
+
+    /**
+     * @brief Greater than operator.
+     */
+    bool operator>(const IPV6Address &other) const {
+      return memcmp(m_address, other.m_address, LENGTH) > 0;
+    }
+
+    /**
+     * @brief Checks if this address is the unspecified address (::).
+     * @returns true if this address is the wildcard address.
+     */
+    bool IsWildcard() const;
+
+    /**
+     * @brief Checks if this is a multicast address (ff00::/8).
+     */
+    bool IsMulticast() const { return m_address[0] == 0xff; }
+
+    /**
+     * @brief Copy the IPV6Address to a memory location.
+     * @param ptr the memory location to copy the address to. The location
+     * should be at least LENGTH bytes.
+     * @note The address is copied in network byte order.
+     */
+    void Get(uint8_t ptr[LENGTH]) const {
+      memcpy(ptr, m_address, LENGTH);
+    }
+
+    /**
+     * @brief Convert the IPV6Address to a string.
+     * @returns the string representation of this IPV6Address.
+     */
+    std::string ToString() const;
+
+    /**
+     * @brief Write the string representation of this IPV6Address to an
+     * ostream.
+     * @param out the ostream to write to.
+     * @param address to address to write.
+     */
+    friend std::ostream& operator<<(std::ostream &out,
+                                    const IPV6Address &address) {
+      return out << address.ToString();
+    }
+
+    /**
+     * @brief Convert a string to an IPV6Address.
+     * @param address the IP address string to convert.
+     * @param[out] target the converted IPV6Address.
+     * @returns true if the string was a valid IPv6 address, false otherwise.
+     */
+    static bool FromString(const std::string &address, IPV6Address *target);
+
+    /**
+     * @brief Convert a string to an IPV6Address or abort.
+     * @note This should only be used within tests.
+     * @param address the IP address to convert.
+     * @return an IPV6Address matching the string.
+     */
+    static IPV6Address FromStringOrDie(const std::string &address);
+
+    /**
+     * @brief Returns the unspecified address (::).
+     * @return an IPV6Address representing the wildcard address.
+     */
+    static IPV6Address WildCard();
+
+    /**
+     * @brief Returns the loopback address (::1).
+     * @return an IPV6Address representing the loopback address.
+     */
+    static IPV6Address Loopback();
+
+ private:
+    uint8_t m_address[LENGTH];
+};
+/**
+ * @}
+ */
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_IPV6ADDRESS_H_
@@ -0,0 +1,129 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InterfaceCache.h
+ * A process wide cache of the network interfaces.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_INTERFACECACHE_H_
+#define INCLUDE_OLA_NETWORK_INTERFACECACHE_H_
+
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+#include <ola/io/SelectServerInterface.h>
+#include <ola/network/Interface.h>
+#include <ola/network/InterfacePicker.h>
+#include <ola/thread/Mutex.h>
+#include <memory>
+#include <vector>
+
+namespace ola {
+namespace network {
+
+/**
+ * @addtogroup network
+ * @{
+ */
+
+/**
+ * @brief Caches the list of network interfaces, so they're only enumerated
+ * once rather than by every caller of InterfacePicker::NewPicker().
+ *
+ * Once a cache is installed with Install(), the pickers returned by
+ * InterfacePicker::NewPicker() read from it. The cache is invalidated by
+ * Invalidate(), or on Linux by the link and address change notifications
+ * from the kernel once Watch() is called. The interfaces are enumerated
+ * again the next time they're needed, so a burst of notifications only
+ * costs one enumeration.
+ *
+ * GetInterfaces() may be called from any thread.
+ */
+class InterfaceCache {
+ public:
+  /**
+   * @brief Create a new InterfaceCache.
+   * @param picker the InterfacePicker to enumerate the interfaces with,
+   *   ownership is transferred. If NULL the system picker is used.
+   */
+  explicit InterfaceCache(InterfacePicker *picker = NULL);
+  ~InterfaceCache();
+
+  /**
+   * @brief Get the interfaces, enumerating them if the cache is empty.
+   * @param include_loopback true to include the loopback interfaces.
+   */
+  std::vector<Interface> GetInterfaces(bool include_loopback);
+
+  /**
+   * @brief Discard the cached interfaces.
+   */
+  void Invalidate();
+
+  /**
+   * @brief Invalidate the cache when the interfaces or their addresses
+   * change.
+   * @param ss the SelectServer to register the notification socket with.
+   * @returns false if change notifications aren't available on this
+   *   platform, in which case the cache must be invalidated manually.
+   */
+  bool Watch(ola::io::SelectServerInterface *ss);
+
+  /**
+   * @brief The number of times the interfaces have been enumerated.
+   */
+  unsigned int EnumerationCount() const;
+
+  /**
+   * @brief Create a new InterfacePicker which reads from this cache.
+   * @returns a new InterfacePicker, ownership is transferred to the caller.
+   */
+  InterfacePicker *NewPicker();
+
+  /**
+   * @brief Install the cache used by InterfacePicker::NewPicker().
+   * @param cache the cache to install, or NULL to remove the installed
+   *   cache. Ownership is not transferred.
+   *
+   * This should be called before any other threads are started.
+   */
+  static void Install(InterfaceCache *cache);
+
+  /**
+   * @brief Return the installed cache, or NULL if there isn't one.
+   */
+  static InterfaceCache *Installed();
+
+ private:
+  std::auto_ptr<InterfacePicker> m_picker;
+  ola::io::SelectServerInterface *m_ss;
+  std::auto_ptr<ola::io::UnmanagedFileDescriptor> m_netlink_descriptor;
+  mutable ola::thread::Mutex m_mutex;
+  std::vector<Interface> m_interfaces;  // includes the loopback interfaces
+  bool m_valid;
+  unsigned int m_enumeration_count;
+
+  void ReceiveNotifications();
+
+  static InterfaceCache *s_installed;
+
+  DISALLOW_COPY_AND_ASSIGN(InterfaceCache);
+};
+/**
+ * @}
+ */
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_INTERFACECACHE_H_
@@ -88,7 +88,19 @@ class InterfacePicker {
 
   virtual std::vector<Interface> GetInterfaces(bool include_loopback) const = 0;
 
+  /**
+   * @brief Create a new InterfacePicker.
+   *
+   * If an InterfaceCache has been installed, the picker reads from the
+   * cache, otherwise it enumerates the interfaces each time it's used.
+   */
   static InterfacePicker *NewPicker();
+
+  /**
+   * @brief Create a new InterfacePicker which always enumerates the
+   * interfaces, bypassing any installed InterfaceCache.
+   */
+  static InterfacePicker *NewSystemPicker();
 };
 /**
  * @}
@@ -3,13 +3,19 @@ olanetworkinclude_HEADERS = \
     include/ola/network/AdvancedTCPConnector.h\
     include/ola/network/HealthCheckedConnection.h \
     include/ola/network/IPV4Address.h \
+    include/ola/network/IPV6Address.h \
     include/ola/network/Interface.h \
+    include/ola/network/InterfaceCache.h \
     include/ola/network/InterfacePicker.h \
     include/ola/network/MACAddress.h \
     include/ola/network/NetworkUtils.h \
+    include/ola/network/ReusePortGroup.h \
     include/ola/network/Socket.h \
     include/ola/network/SocketAddress.h \
     include/ola/network/SocketCloser.h \
     include/ola/network/TCPConnector.h \
     include/ola/network/TCPSocket.h \
-    include/ola/network/TCPSocketFactory.h
+    include/ola/network/TCPSocketFactory.h \
+    include/ola/network/UDPReceiveStats.h \
+    include/ola/network/UnixDomainSocket.h \
+    include/ola/network/XDPReceiver.h
@@ -0,0 +1,160 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ReusePortGroup.h
+ * A group of UDP sockets sharing a port with SO_REUSEPORT.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_REUSEPORTGROUP_H_
+#define INCLUDE_OLA_NETWORK_REUSEPORTGROUP_H_
+
+#include <ola/base/Macro.h>
+#include <ola/network/Socket.h>
+#include <ola/network/SocketAddress.h>
+
+#include <vector>
+
+namespace ola {
+namespace network {
+
+/**
+ * @brief A group of UDP sockets bound to the same port with SO_REUSEPORT.
+ *
+ * The kernel delivers each datagram to one socket in the group. By default
+ * it picks the socket from a hash of the source and destination addresses.
+ * On Linux 4.5 or later a steering program can be attached instead, so that
+ * all datagrams for a universe, or from a source, go to the same socket.
+ *
+ * Combined with a ola::io::SelectServerPool, this spreads the receive load
+ * over several event loops, each handling a disjoint subset of the traffic.
+ *
+ * @examplepara
+ * ~~~~~~~~~~~~~~~~~~~~~
+   SelectServerPool pool(4);
+   ReusePortGroup group(pool.Size());
+   ReusePortGroup::Options options;
+   options.steering = ReusePortGroup::STEER_BY_PAYLOAD;
+   options.payload_offset = ReusePortGroup::E131_UNIVERSE_OFFSET;
+   options.payload_width = 2;
+   group.Bind(IPV4SocketAddress(IPV4Address::WildCard(), 5568), options);
+   for (unsigned int i = 0; i < group.Size(); i++) {
+     group.Socket(i)->SetOnData(...);
+     pool.Get(i)->AddReadDescriptor(group.Socket(i));
+   }
+   pool.Start();
+ * ~~~~~~~~~~~~~~~~~~~~~
+ */
+class ReusePortGroup {
+ public:
+  /**
+   * @brief How datagrams are steered to sockets in the group.
+   */
+  enum Steering {
+    /** Let the kernel hash the addresses & ports */
+    STEER_BY_KERNEL_HASH,
+    /** Use the IPv4 source address modulo the group size */
+    STEER_BY_SOURCE_ADDRESS,
+    /** Use a big endian field in the UDP payload modulo the group size */
+    STEER_BY_PAYLOAD,
+  };
+
+  struct Options {
+   public:
+    Options()
+        : steering(STEER_BY_KERNEL_HASH),
+          payload_offset(0),
+          payload_width(1) {
+    }
+
+    /**
+     * @brief How to steer datagrams.
+     */
+    Steering steering;
+
+    /**
+     * @brief The offset of the field in the UDP payload, for
+     *   STEER_BY_PAYLOAD.
+     *
+     * Datagrams too short to contain the field all go to the first socket.
+     */
+    unsigned int payload_offset;
+
+    /**
+     * @brief The width of the payload field in bytes, either 1, 2 or 4.
+     */
+    unsigned int payload_width;
+  };
+
+  /**
+   * @brief Create a new ReusePortGroup.
+   * @param size the number of sockets in the group.
+   */
+  explicit ReusePortGroup(unsigned int size);
+
+  /**
+   * @brief Close and delete the sockets.
+   */
+  ~ReusePortGroup();
+
+  /**
+   * @brief The number of sockets in the group.
+   */
+  unsigned int Size() const { return m_sockets.size(); }
+
+  /**
+   * @brief Return a socket from the group.
+   * @param index the index of the socket, must be less than Size().
+   *
+   * With steering, socket N receives the datagrams where the key modulo
+   * Size() is N. Ownership is not transferred.
+   */
+  UDPSocket *Socket(unsigned int index) { return m_sockets[index]; }
+
+  /**
+   * @brief Create the sockets and bind them to an endpoint.
+   * @param endpoint the local address to bind to. If the port is 0, the
+   *   first socket picks the port and the rest of the group use it.
+   * @param options the steering options.
+   * @returns true if all the sockets were bound, false otherwise. Failing to
+   *   attach a steering program isn't fatal, the kernel hash is used instead.
+   */
+  bool Bind(const IPV4SocketAddress &endpoint,
+            const Options &options = Options());
+
+  /**
+   * @brief The offset of the universe in an E1.31 data packet. This is two
+   *   bytes wide.
+   */
+  static const unsigned int E131_UNIVERSE_OFFSET = 113;
+
+  /**
+   * @brief The offset of the SubUni field in an ArtDmx packet. Use a width of
+   *   1, the next byte is the Net which is usually the same for every
+   *   universe.
+   */
+  static const unsigned int ARTNET_UNIVERSE_OFFSET = 14;
+
+ private:
+  std::vector<UDPSocket*> m_sockets;
+
+  void CloseSockets();
+  bool AttachSteeringProgram(const Options &options);
+
+  DISALLOW_COPY_AND_ASSIGN(ReusePortGroup);
+};
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_REUSEPORTGROUP_H_
@@ -30,12 +30,100 @@
 #include <ola/io/Descriptor.h>
 #include <ola/io/IOQueue.h>
 #include <ola/network/IPV4Address.h>
+#include <ola/network/IPV6Address.h>
 #include <ola/network/SocketAddress.h>
+#include <ola/network/UDPReceiveStats.h>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace network {
 
+/**
+ * @brief A set of pre-allocated buffers used to receive a batch of datagrams.
+ *
+ * The buffers are allocated once, so a batch can be re-used for each
+ * call to UDPSocketInterface::RecvBatch().
+ */
+class DatagramBatch {
+ public:
+  /**
+   * @brief Create a new DatagramBatch.
+   * @param capacity the maximum number of datagrams in the batch.
+   * @param datagram_size the size of the buffer for each datagram.
+   */
+  DatagramBatch(unsigned int capacity, unsigned int datagram_size);
+
+  /**
+   * @brief The maximum number of datagrams in the batch.
+   */
+  unsigned int Capacity() const { return m_capacity; }
+
+  /**
+   * @brief The size of the buffer for each datagram.
+   */
+  unsigned int DatagramSize() const { return m_datagram_size; }
+
+  /**
+   * @brief The number of datagrams received.
+   */
+  unsigned int Size() const { return m_size; }
+
+  /**
+   * @brief Returns the buffer for a datagram.
+   * @param i the index of the datagram, must be less than Capacity().
+   */
+  uint8_t *Data(unsigned int i) { return &m_buffer[i * m_datagram_size]; }
+
+  /**
+   * @brief Returns the length of a received datagram.
+   * @param i the index of the datagram, must be less than Size().
+   */
+  unsigned int Length(unsigned int i) const { return m_lengths[i]; }
+
+  /**
+   * @brief Returns the source of a received datagram.
+   * @param i the index of the datagram, must be less than Size().
+   *
+   * This is empty for datagrams received on an IPv6 socket.
+   */
+  const IPV4SocketAddress &Source(unsigned int i) const {
+    return m_sources[i];
+  }
+
+  /**
+   * @brief Empty the batch.
+   */
+  void Clear() { m_size = 0; }
+
+  /**
+   * @brief Record the datagram that was written to Data(Size()).
+   * @param length the length of the datagram.
+   * @param source the source of the datagram.
+   * @returns false if the batch is full.
+   *
+   * This is used by the UDPSocketInterface implementations.
+   */
+  bool Append(unsigned int length, const IPV4SocketAddress &source);
+
+  /**
+   * @brief The ExportMap variable used to report the batch size, keyed by
+   * protocol.
+   */
+  static const char K_RECV_BATCH_SIZE_VAR[];
+
+ private:
+  const unsigned int m_capacity;
+  const unsigned int m_datagram_size;
+  unsigned int m_size;
+  std::vector<uint8_t> m_buffer;
+  std::vector<unsigned int> m_lengths;
+  std::vector<IPV4SocketAddress> m_sources;
+
+  DISALLOW_COPY_AND_ASSIGN(DatagramBatch);
+};
+
+
 /**
  * @brief The interface for UDPSockets.
  *
@@ -185,6 +273,33 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
                         ssize_t *data_read,
                         IPV4SocketAddress *source) = 0;
 
+  /**
+   * @brief Receive as many datagrams as are waiting, up to the capacity of
+   * the batch.
+   * @param batch the DatagramBatch to fill. Any existing datagrams are
+   * cleared.
+   * @return true if at least one datagram was received, false otherwise.
+   *
+   * This should be called when the socket is ready for reading; it doesn't
+   * block once the first datagram has been read.
+   */
+  virtual bool RecvBatch(DatagramBatch *batch) = 0;
+
+  /**
+   * @brief Start queuing outgoing datagrams.
+   *
+   * Until the matching EndSendBatch() call, SendTo() copies each datagram to
+   * a queue and returns the number of bytes queued. Calls can be nested; the
+   * queue is sent when the outermost EndSendBatch() is called.
+   */
+  virtual void BeginSendBatch() = 0;
+
+  /**
+   * @brief End a batch started with BeginSendBatch().
+   * @return false if any of the queued datagrams couldn't be sent.
+   */
+  virtual bool EndSendBatch() = 0;
+
   /**
    * @brief Enable broadcasting for this socket.
    * @return true if it worked, false otherwise
@@ -224,6 +339,46 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
    */
   virtual bool SetTos(uint8_t tos) = 0;
 
+  /**
+   * @brief Limit the rate the kernel sends datagrams from this socket at.
+   * @param bytes_per_second the maximum rate, or 0 for no limit.
+   * @return true if it worked, false otherwise
+   *
+   * Rather than sending a burst of datagrams back to back, the datagrams are
+   * spaced out. This is only supported on Linux, and requires the fq queuing
+   * discipline on the outgoing interface.
+   */
+  virtual bool SetMaxPacingRate(uint32_t bytes_per_second) = 0;
+
+  /**
+   * @brief Count the datagrams the kernel drops from the receive queue.
+   * @param options the UDPReceiveOptions.
+   * @return true if drops can be counted on this platform.
+   *
+   * This must be called after Init(). See UDPReceiveStats.
+   */
+  virtual bool EnableReceiveStats(const UDPReceiveOptions &options) = 0;
+
+  /**
+   * @brief Register the socket edge-triggered with the SelectServer.
+   * @param enable true to use edge-triggered reads.
+   *
+   * The SelectServer then runs the on data callback repeatedly, up to a
+   * budget, until the receive queue is empty. The callback must read at least
+   * one datagram each time it's run. Reads no longer block once this is
+   * enabled. This must be called before the socket is added to the
+   * SelectServer.
+   */
+  virtual void SetEdgeTriggered(bool enable) = 0;
+
+  /**
+   * @brief Set the priority of the socket in the SelectServer.
+   * @param priority the DescriptorPriority for the socket.
+   *
+   * Sockets that carry DMX data should use DESCRIPTOR_PRIORITY_HIGH.
+   */
+  virtual void SetPriority(ola::io::DescriptorPriority priority) = 0;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(UDPSocketInterface);
 };
@@ -231,16 +386,29 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
 
 /*
  * A UDPSocket (non connected)
+ *
+ * Sockets created with InitV6() use the IPv6 overloads of Bind(), SendTo(),
+ * JoinMulticast() & LeaveMulticast().
  */
 class UDPSocket: public UDPSocketInterface {
  public:
   UDPSocket()
       : UDPSocketInterface(),
         m_handle(ola::io::INVALID_DESCRIPTOR),
-        m_bound_to_port(false) {}
-  ~UDPSocket() { Close(); }
+        m_bound_to_port(false),
+        m_ipv6(false),
+        m_batch_state(NULL),
+        m_receive_stats(NULL),
+        m_edge_triggered(false),
+        m_priority(ola::io::DESCRIPTOR_PRIORITY_NORMAL),
+        m_read_progress(false),
+        m_would_block(false) {}
+  ~UDPSocket();
   bool Init();
+  // Create an IPv6 only socket.
+  bool InitV6();
   bool Bind(const IPV4SocketAddress &endpoint);
+  bool Bind(const IPV6SocketAddress &endpoint);
 
   bool GetSocketAddress(IPV4SocketAddress *address) const;
 
@@ -259,6 +427,11 @@ class UDPSocket: public UDPSocketInterface {
                  unsigned short port) const;
   ssize_t SendTo(ola::io::IOVecInterface *data,
                  const IPV4SocketAddress &dest) const;
+  ssize_t SendTo(const uint8_t *buffer,
+                 unsigned int size,
+                 const IPV6SocketAddress &dest) const;
+  ssize_t SendTo(ola::io::IOVecInterface *data,
+                 const IPV6SocketAddress &dest) const;
 
   bool RecvFrom(uint8_t *buffer, ssize_t *data_read) const;
   bool RecvFrom(uint8_t *buffer,
@@ -273,6 +446,11 @@ class UDPSocket: public UDPSocketInterface {
                 ssize_t *data_read,
                 IPV4SocketAddress *source);
 
+  bool RecvBatch(DatagramBatch *batch);
+
+  void BeginSendBatch();
+  bool EndSendBatch();
+
   bool EnableBroadcast();
   bool SetMulticastInterface(const IPV4Address &iface);
   bool JoinMulticast(const IPV4Address &iface,
@@ -281,11 +459,62 @@ class UDPSocket: public UDPSocketInterface {
   bool LeaveMulticast(const IPV4Address &iface,
                       const IPV4Address &group);
 
+  // IPv6 interfaces are identified by their index, 0 is the default.
+  bool SetMulticastInterfaceIndex(unsigned int if_index);
+  bool JoinMulticast(unsigned int if_index,
+                     const IPV6Address &group,
+                     bool multicast_loop = false);
+  bool LeaveMulticast(unsigned int if_index,
+                      const IPV6Address &group);
+
   bool SetTos(uint8_t tos);
+  bool SetMaxPacingRate(uint32_t bytes_per_second);
+  bool EnableReceiveStats(const UDPReceiveOptions &options);
+  void SetEdgeTriggered(bool enable) { m_edge_triggered = enable; }
+
+  bool EdgeTriggered() const { return m_edge_triggered; }
+  bool DrainRead();
+
+  void SetPriority(ola::io::DescriptorPriority priority) {
+    m_priority = priority;
+  }
+
+  ola::io::DescriptorPriority Priority() const { return m_priority; }
+
+  /**
+   * @brief The receive stats, or NULL if EnableReceiveStats() hasn't been
+   * called.
+   */
+  const UDPReceiveStats *ReceiveStats() const { return m_receive_stats; }
 
  private:
   ola::io::DescriptorHandle m_handle;
   bool m_bound_to_port;
+  bool m_ipv6;
+  // The message headers for recvmmsg & the queue of outgoing datagrams,
+  // allocated on the first RecvBatch() or BeginSendBatch().
+  struct BatchState;
+  BatchState *m_batch_state;
+  UDPReceiveStats *m_receive_stats;
+  bool m_edge_triggered;
+  ola::io::DescriptorPriority m_priority;
+  // Updated by the reads during DrainRead().
+  mutable bool m_read_progress;
+  mutable bool m_would_block;
+
+  bool CreateSocket(int domain);
+  bool Receive(uint8_t *buffer, ssize_t *data_read,
+               struct sockaddr *source, unsigned int source_size) const;
+  bool BindTo(const SocketAddress &endpoint);
+  ssize_t SendBuffer(const uint8_t *buffer,
+                     unsigned int size,
+                     const SocketAddress &dest) const;
+  ssize_t SendIOVec(ola::io::IOVecInterface *data,
+                    const SocketAddress &dest) const;
+  bool InSendBatch() const;
+  ssize_t QueueDatagram(const struct ola::io::IOVec *iov, int io_len,
+                        const SocketAddress &dest) const;
+  bool SendQueue();
 
   DISALLOW_COPY_AND_ASSIGN(UDPSocket);
 };
@@ -30,6 +30,7 @@
 #define INCLUDE_OLA_NETWORK_SOCKETADDRESS_H_
 
 #include <ola/network/IPV4Address.h>
+#include <ola/network/IPV6Address.h>
 #include <ola/base/Macro.h>
 #include <stdint.h>
 #ifdef _WIN32
@@ -52,7 +53,7 @@ namespace network {
 /**
  * @brief The base SocketAddress.
  *
- * One day if we support V6 there will be another derived class.
+ * Derived classes exist for IPv4 and IPv6 addresses.
  **/
 class SocketAddress {
  public:
@@ -157,6 +158,79 @@ class IPV4SocketAddress: public SocketAddress {
 };
 
 
+/**
+ * @brief An IPv6 SocketAddress.
+ *
+ * Wraps a sockaddr_in6.
+ */
+class IPV6SocketAddress: public SocketAddress {
+ public:
+    IPV6SocketAddress()
+        : SocketAddress(),
+          m_host(),
+          m_port(0) {
+    }
+
+    IPV6SocketAddress(const IPV6Address &host, uint16_t port)
+        : SocketAddress(),
+          m_host(host),
+          m_port(port) {
+    }
+    IPV6SocketAddress(const IPV6SocketAddress &other)
+        : SocketAddress(),
+          m_host(other.m_host),
+          m_port(other.m_port) {
+    }
+
+    ~IPV6SocketAddress() {}
+
+    IPV6SocketAddress& operator=(const IPV6SocketAddress &other) {
+      if (this != &other) {
+        m_host = other.m_host;
+        m_port = other.m_port;
+      }
+      return *this;
+    }
+
+    bool operator==(const IPV6SocketAddress &other) const {
+      return m_host == other.m_host && m_port == other.m_port;
+    }
+
+    bool operator!=(const IPV6SocketAddress &other) const {
+      return !(*this == other);
+    }
+
+    /**
+     * @brief Less than operator for partial ordering.
+     *
+     * Sorts by host, then port.
+     */
+    bool operator<(const IPV6SocketAddress &other) const {
+      if (m_host == other.m_host)
+        return m_port < other.m_port;
+      else
+        return m_host < other.m_host;
+    }
+
+    uint16_t Family() const { return AF_INET6; }
+    const IPV6Address& Host() const { return m_host; }
+    void Host(const IPV6Address &host) { m_host = host; }
+    uint16_t Port() const { return m_port; }
+    void Port(uint16_t port) { m_port = port; }
+
+    /**
+     * @brief The string form of the address, e.g. [ff18::8300:1]:5568
+     */
+    std::string ToString() const;
+
+    bool ToSockAddr(struct sockaddr *addr, unsigned int size) const;
+
+ private:
+    IPV6Address m_host;
+    uint16_t m_port;
+};
+
+
 /**
  * @brief a Generic Socket Address
  *
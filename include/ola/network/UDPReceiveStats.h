@@ -0,0 +1,159 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPReceiveStats.h
+ * Kernel drop counts & receive queue latency for UDP sockets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_UDPRECEIVESTATS_H_
+#define INCLUDE_OLA_NETWORK_UDPRECEIVESTATS_H_
+
+#include <ola/base/Macro.h>
+#include <ola/util/Histogram.h>
+#include <stdint.h>
+#include <string>
+
+struct msghdr;
+
+namespace ola {
+
+class ExportMap;
+
+namespace network {
+
+/**
+ * @brief Options for UDPReceiveStats.
+ */
+struct UDPReceiveOptions {
+ public:
+  UDPReceiveOptions()
+      : timestamps(false),
+        min_recv_buffer(0),
+        max_recv_buffer(0),
+        export_map(NULL) {
+  }
+
+  /**
+   * @brief Record how long datagrams wait in the receive queue, using
+   * SO_TIMESTAMPING.
+   */
+  bool timestamps;
+
+  /**
+   * @brief The smallest receive buffer (SO_RCVBUF) in bytes, or 0 to use the
+   * system default.
+   */
+  unsigned int min_recv_buffer;
+
+  /**
+   * @brief Grow the receive buffer, up to this many bytes, when the kernel
+   * drops datagrams. 0 disables this.
+   */
+  unsigned int max_recv_buffer;
+
+  /**
+   * @brief If not NULL, the ExportMap to export the stats to. This must
+   * outlive the socket.
+   */
+  ExportMap *export_map;
+
+  /**
+   * @brief The key for this socket in the exported variables, e.g. the
+   * protocol name.
+   */
+  std::string export_key;
+};
+
+
+/**
+ * @brief Tracks the datagrams the kernel drops from a UDP socket's receive
+ * queue, and how long datagrams wait in the queue.
+ *
+ * Once Enable() has turned on SO_RXQ_OVFL, and optionally SO_TIMESTAMPING,
+ * datagrams must be read with recvmsg() or recvmmsg() and a control buffer of
+ * CONTROL_SIZE bytes. The control messages for each datagram are then passed
+ * to Update().
+ *
+ * When drops are seen and max_recv_buffer is set, the receive buffer is
+ * doubled until it reaches max_recv_buffer, or the limit set by the system
+ * (net.core.rmem_max on Linux).
+ *
+ * This is only supported on Linux.
+ */
+class UDPReceiveStats {
+ public:
+  UDPReceiveStats();
+  ~UDPReceiveStats();
+
+  /**
+   * @brief Enable the stats for a socket.
+   * @param fd the socket's file descriptor.
+   * @param options the UDPReceiveOptions.
+   * @returns true if drops can be counted on this socket.
+   */
+  bool Enable(int fd, const UDPReceiveOptions &options);
+
+  /**
+   * @brief Update the stats from the control messages for a datagram.
+   * @param header the header passed to recvmsg() or recvmmsg().
+   */
+  void Update(const struct msghdr *header);
+
+  /**
+   * @brief The number of datagrams dropped since Enable() was called.
+   */
+  uint64_t Drops() const { return m_drops; }
+
+  /**
+   * @brief The receive buffer size reported by the kernel.
+   */
+  unsigned int RecvBufferSize() const { return m_recv_buffer_size; }
+
+  /**
+   * @brief The time datagrams spent in the receive queue in microseconds.
+   */
+  const Histogram &Latency() const { return m_latency; }
+
+  /**
+   * @brief The size of the control buffer needed for each datagram.
+   */
+  static const unsigned int CONTROL_SIZE = 128;
+
+  static const char K_KERNEL_DROPS_VAR[];
+  static const char K_RECV_BUFFER_SIZE_VAR[];
+  static const char K_RECV_LATENCY_VAR[];
+
+ private:
+  int m_fd;
+  UDPReceiveOptions m_options;
+  uint32_t m_last_drop_count;
+  uint64_t m_drops;
+  unsigned int m_recv_buffer_size;
+  bool m_can_grow;
+  Histogram m_latency;
+  unsigned int *m_drops_var;
+  unsigned int *m_recv_buffer_size_var;
+
+  void Drop(uint32_t drop_count);
+  void GrowRecvBuffer();
+  bool SetRecvBufferSize(unsigned int size);
+  void UpdateRecvBufferSize();
+
+  DISALLOW_COPY_AND_ASSIGN(UDPReceiveStats);
+};
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_UDPRECEIVESTATS_H_
@@ -0,0 +1,135 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UnixDomainSocket.h
+ * Stream sockets bound to a path in the filesystem.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file UnixDomainSocket.h
+ * @brief Stream sockets bound to a path in the filesystem.
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_UNIXDOMAINSOCKET_H_
+#define INCLUDE_OLA_NETWORK_UNIXDOMAINSOCKET_H_
+
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+
+namespace ola {
+namespace network {
+
+/**
+ * @brief A connected AF_UNIX stream socket.
+ */
+class UnixDomainSocket: public ola::io::ConnectedDescriptor {
+ public:
+  /**
+   * @brief Wrap an existing socket.
+   * @param sd the socket descriptor, ownership is transferred.
+   */
+  explicit UnixDomainSocket(int sd);
+
+  ~UnixDomainSocket() { Close(); }
+
+  ola::io::DescriptorHandle ReadDescriptor() const { return m_handle; }
+  ola::io::DescriptorHandle WriteDescriptor() const { return m_handle; }
+  bool Close();
+
+  /**
+   * @brief Get the credentials of the process at the other end.
+   * @param[out] uid the user id of the peer.
+   * @param[out] gid the group id of the peer.
+   * @returns true if the credentials were available, false otherwise.
+   */
+  bool GetPeerCredentials(uid_t *uid, gid_t *gid) const;
+
+  /**
+   * @brief Connect to a listening socket.
+   * @param path the path of the socket.
+   * @returns a new UnixDomainSocket or NULL if the connection failed.
+   *   Ownership is transferred to the caller.
+   */
+  static UnixDomainSocket* Connect(const std::string &path);
+
+ protected:
+  bool IsSocket() const { return true; }
+
+ private:
+  ola::io::DescriptorHandle m_handle;
+
+  DISALLOW_COPY_AND_ASSIGN(UnixDomainSocket);
+};
+
+
+/**
+ * @brief An AF_UNIX stream socket which accepts new connections.
+ */
+class UnixDomainAcceptingSocket: public ola::io::ReadFileDescriptor {
+ public:
+  typedef ola::Callback1<void, UnixDomainSocket*> NewSocketCallback;
+
+  /**
+   * @brief Create a new UnixDomainAcceptingSocket.
+   * @param on_accept the callback run with each new connection, ownership of
+   *   the callback and the socket passed to it are transferred.
+   */
+  explicit UnixDomainAcceptingSocket(NewSocketCallback *on_accept);
+
+  /**
+   * @brief Close the socket and remove the path.
+   */
+  ~UnixDomainAcceptingSocket();
+
+  /**
+   * @brief Start listening.
+   * @param path the path to bind to. A stale socket at this path is removed.
+   * @param mode the permissions for the socket, this controls which users
+   *   can connect.
+   * @param backlog the listen backlog.
+   * @returns true if the socket is listening, false otherwise.
+   */
+  bool Listen(const std::string &path, mode_t mode = 0660, int backlog = 10);
+
+  ola::io::DescriptorHandle ReadDescriptor() const { return m_handle; }
+
+  /**
+   * @brief Stop listening and remove the path.
+   */
+  bool Close();
+
+  void PerformRead();
+
+  /**
+   * @brief The path the socket is bound to.
+   */
+  const std::string &Path() const { return m_path; }
+
+ private:
+  ola::io::DescriptorHandle m_handle;
+  std::string m_path;
+  std::auto_ptr<NewSocketCallback> m_on_accept;
+
+  DISALLOW_COPY_AND_ASSIGN(UnixDomainAcceptingSocket);
+};
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_UNIXDOMAINSOCKET_H_
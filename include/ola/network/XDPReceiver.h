@@ -0,0 +1,184 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * XDPReceiver.h
+ * Receive UDP datagrams with an AF_XDP socket.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_XDPRECEIVER_H_
+#define INCLUDE_OLA_NETWORK_XDPRECEIVER_H_
+
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+#include <ola/network/Interface.h>
+#include <ola/network/SocketAddress.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+
+namespace ola {
+namespace network {
+
+/**
+ * @brief Options for the XDPReceiver.
+ */
+struct XDPReceiverOptions {
+ public:
+  XDPReceiverOptions()
+      : queue_id(0),
+        frame_count(4096) {
+  }
+
+  /**
+   * @brief The NIC receive queue to attach to.
+   */
+  unsigned int queue_id;
+
+  /**
+   * @brief The number of frames in the shared memory area, this must be a
+   * power of two.
+   */
+  unsigned int frame_count;
+};
+
+
+/**
+ * @brief Receives the UDP datagrams for a set of ports with an AF_XDP socket,
+ * bypassing the kernel network stack.
+ *
+ * An XDP program on the interface redirects the unfragmented IPv4 datagrams
+ * for the registered ports that arrive on the queue to the AF_XDP socket.
+ * Everything else is passed to the kernel as usual, including datagrams for
+ * the ports that arrive on other queues, so the normal sockets for the ports
+ * must still be open. Use ethtool to steer the ports to the queue, e.g.
+ *   ethtool -N eth0 flow-type udp4 dst-port 5568 action 0
+ *
+ * The handlers are passed a pointer into the shared memory area, which is
+ * only valid for the duration of the call.
+ *
+ * This needs Linux 5.9 or later, and CAP_NET_ADMIN and CAP_BPF.
+ */
+class XDPReceiver: public ola::io::ReadFileDescriptor {
+ public:
+  /**
+   * @brief Called with the payload, payload length and source of each
+   * datagram.
+   */
+  typedef ola::Callback3<void, const uint8_t*, unsigned int,
+                         const IPV4SocketAddress&> DatagramHandler;
+
+  /**
+   * @brief Create a new XDPReceiver.
+   * @param iface the interface to attach to.
+   * @param options the XDPReceiverOptions.
+   */
+  XDPReceiver(const Interface &iface, const XDPReceiverOptions &options);
+  ~XDPReceiver();
+
+  /**
+   * @brief Create the socket and attach the XDP program to the interface.
+   * @returns false if AF_XDP isn't available, in which case the normal
+   * sockets should be used.
+   */
+  bool Init();
+
+  /**
+   * @brief Start receiving datagrams for a port.
+   * @param port the destination port in host byte order.
+   * @param handler the DatagramHandler to run, ownership is transferred.
+   * @returns false if the port is already registered.
+   */
+  bool AddPort(uint16_t port, DatagramHandler *handler);
+
+  /**
+   * @brief Stop receiving datagrams for a port.
+   * @param port the destination port in host byte order.
+   * @returns false if the port wasn't registered.
+   */
+  bool RemovePort(uint16_t port);
+
+  /**
+   * @brief The queue this receiver is attached to.
+   */
+  unsigned int QueueId() const { return m_options.queue_id; }
+
+  ola::io::DescriptorHandle ReadDescriptor() const { return m_handle; }
+
+  /**
+   * @brief Run the handlers for the datagrams waiting in the receive ring.
+   */
+  void PerformRead();
+
+  /**
+   * @brief Find the UDP payload in an Ethernet frame.
+   * @param frame the Ethernet frame.
+   * @param length the length of the frame.
+   * @param[out] port the destination port in host byte order.
+   * @param[out] source the source of the datagram.
+   * @param[out] payload set to the start of the payload.
+   * @param[out] payload_length the length of the payload.
+   * @returns false if the frame isn't an unfragmented IPv4 UDP datagram,
+   * without IP options.
+   */
+  static bool ParseFrame(const uint8_t *frame,
+                         unsigned int length,
+                         uint16_t *port,
+                         IPV4SocketAddress *source,
+                         const uint8_t **payload,
+                         unsigned int *payload_length);
+
+  /**
+   * @brief The size of each frame in the shared memory area.
+   */
+  static const unsigned int FRAME_SIZE = 2048;
+
+ private:
+  struct Ring {
+    uint32_t *producer;
+    uint32_t *consumer;
+    void *descriptors;
+    uint32_t mask;
+    void *map;
+    size_t map_size;
+  };
+
+  typedef std::map<uint16_t, DatagramHandler*> HandlerMap;
+
+  const int32_t m_if_index;
+  const std::string m_if_name;
+  const XDPReceiverOptions m_options;
+  ola::io::DescriptorHandle m_handle;
+  uint8_t *m_umem;
+  Ring m_rx;
+  Ring m_fill;
+  int m_ports_map_fd;
+  int m_xsks_map_fd;
+  int m_program_fd;
+  int m_link_fd;
+  HandlerMap m_handlers;
+
+  bool SetupSocket();
+  bool SetupProgram();
+  bool LoadProgram();
+  bool SetPortEnabled(uint16_t port, bool enabled);
+  void Close();
+
+  DISALLOW_COPY_AND_ASSIGN(XDPReceiver);
+};
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_XDPRECEIVER_H_
@@ -131,6 +131,13 @@ class DiscoveryTargetInterface {
  * MAX_MUTE_ATTEMPTS times) and branches that contain responders which continue
  * to respond once muted. The latter causes a branch to be marked as corrupt,
  * which prevents us from looping forver.
+ *
+ * UIDs from a previous run, say from a cache, can be passed to
+ * SetCachedUIDs(). These are muted before the branch stage of the next
+ * discovery, so only new responders need to be found by branching. If early
+ * termination is enabled, once the number of UIDs found reaches the count
+ * from the previous run, a single DUB over the whole UID range is sent. If
+ * nothing responds, the remaining branches are skipped.
  */
 class DiscoveryAgent {
  public:
@@ -167,6 +174,22 @@ class DiscoveryAgent {
    */
   void StartIncrementalDiscovery(DiscoveryCompleteCallback *on_complete);
 
+  /**
+   * @brief Seed the next discovery operation with previously known UIDs.
+   * @param uids the UIDs from a previous run.
+   *
+   * The UIDs are muted before the branch stage of the next discovery, full
+   * or incremental. Those that ack the mute are kept, the rest are dropped.
+   */
+  void SetCachedUIDs(const UIDSet &uids) { m_cached_uids = uids; }
+
+  /**
+   * @brief Stop branching once the responders from the previous run have
+   *   been found.
+   * @param enable true to enable early termination, the default is false.
+   */
+  void SetEarlyTermination(bool enable) { m_early_termination = enable; }
+
  private:
   /**
    * @brief Represents a range of UIDs (a branch of the UID tree)
@@ -197,6 +220,8 @@ class DiscoveryAgent {
   // uids that are misbehaved in some way
   UIDSet m_bad_uids;
   DiscoveryCompleteCallback *m_on_complete;
+  // uids to seed the next discovery with
+  UIDSet m_cached_uids;
   // uids to mute during incremental discovery
   std::queue<UID> m_uids_to_mute;
   // Callbacks used by the DiscoveryTarget
@@ -207,6 +232,8 @@ class DiscoveryAgent {
   std::auto_ptr<DiscoveryTargetInterface::MuteDeviceCallback>
       m_branch_mute_callback;
   std::auto_ptr<DiscoveryTargetInterface::BranchCallback> m_branch_callback;
+  std::auto_ptr<DiscoveryTargetInterface::BranchCallback>
+      m_termination_callback;
 
   // The stack of UIDRanges
   UIDRanges m_uid_ranges;
@@ -214,6 +241,11 @@ class DiscoveryAgent {
   unsigned int m_unmute_count;
   unsigned int m_mute_attempts;
   bool m_tree_corrupt;  // true if there was a problem with discovery
+  bool m_early_termination;
+  // the number of responders found by the previous run
+  unsigned int m_expected_count;
+  // true if a responder was found since the last termination check
+  bool m_check_termination;
 
   void InitDiscovery(DiscoveryCompleteCallback *on_complete,
                      bool incremental);
@@ -223,6 +255,8 @@ class DiscoveryAgent {
   void IncrementalMuteComplete(bool status);
   void SendDiscovery();
 
+  bool MaybeTerminateEarly();
+  void TerminationBranchComplete(const uint8_t *data, unsigned int length);
   void BranchComplete(const uint8_t *data, unsigned int length);
   void BranchMuteComplete(bool status);
   void HandleCollision();
@@ -24,6 +24,7 @@ olardminclude_HEADERS = \
     include/ola/rdm/RDMAPIImplInterface.h \
     include/ola/rdm/RDMCommand.h \
     include/ola/rdm/RDMCommandSerializer.h \
+    include/ola/rdm/RDMCommandView.h \
     include/ola/rdm/RDMControllerAdaptor.h \
     include/ola/rdm/RDMControllerInterface.h \
     include/ola/rdm/RDMEnums.h \
@@ -30,9 +30,8 @@
 #ifndef INCLUDE_OLA_RDM_MESSAGEDESERIALIZER_H_
 #define INCLUDE_OLA_RDM_MESSAGEDESERIALIZER_H_
 
-#include <ola/messaging/DescriptorVisitor.h>
+#include <ola/messaging/DescriptorLayout.h>
 #include <ola/messaging/Message.h>
-#include <stack>
 #include <vector>
 
 namespace ola {
@@ -40,9 +39,9 @@ namespace rdm {
 
 
 /**
- * This visitor inflates the message from raw data.
+ * Inflates a message from raw data, using the layout of the descriptor.
  */
-class MessageDeserializer: public ola::messaging::FieldDescriptorVisitor {
+class MessageDeserializer {
  public:
     MessageDeserializer();
     ~MessageDeserializer();
@@ -52,39 +51,20 @@ class MessageDeserializer: public ola::messaging::FieldDescriptorVisitor {
         const uint8_t *data,
         unsigned int length);
 
-    // we handle decending into groups ourself
-    bool Descend() const { return false; }
-
-    void Visit(const ola::messaging::BoolFieldDescriptor*);
-    void Visit(const ola::messaging::IPV4FieldDescriptor*);
-    void Visit(const ola::messaging::MACFieldDescriptor*);
-    void Visit(const ola::messaging::UIDFieldDescriptor*);
-    void Visit(const ola::messaging::StringFieldDescriptor*);
-    void Visit(const ola::messaging::IntegerFieldDescriptor<uint8_t>*);
-    void Visit(const ola::messaging::IntegerFieldDescriptor<uint16_t>*);
-    void Visit(const ola::messaging::IntegerFieldDescriptor<uint32_t>*);
-    void Visit(const ola::messaging::IntegerFieldDescriptor<int8_t>*);
-    void Visit(const ola::messaging::IntegerFieldDescriptor<int16_t>*);
-    void Visit(const ola::messaging::IntegerFieldDescriptor<int32_t>*);
-    void Visit(const ola::messaging::FieldDescriptorGroup*);
-    void PostVisit(const ola::messaging::FieldDescriptorGroup*) {}
-
  private:
+    typedef std::vector<const ola::messaging::MessageFieldInterface*>
+        message_vector;
+
     const uint8_t *m_data;
     unsigned int m_length;
     unsigned int m_offset;
     unsigned int m_variable_field_size;
     bool m_insufficient_data;
 
-    typedef std::vector<const ola::messaging::MessageFieldInterface*>
-        message_vector;
-    std::stack<message_vector> m_message_stack;
-
-    bool CheckForData(unsigned int required_size);
-    void CleanUpVector();
-
-    template <typename int_type>
-    void IntVisit(const ola::messaging::IntegerFieldDescriptor<int_type> *);
+    void InflateFields(const ola::messaging::DescriptorLayout::OpList &ops,
+                       unsigned int begin,
+                       unsigned int end,
+                       message_vector *fields);
 };
 }  // namespace rdm
 }  // namespace ola
@@ -43,6 +43,8 @@ namespace rdm {
 
 class PidStore;
 class PidDescriptor;
+class PidNameIndex;
+class PidValueIndex;
 
 // The following % before Device is to stop Doxygen interpretting it as a class
 /**
@@ -77,11 +79,7 @@ class RootPidStore {
    */
   RootPidStore(const PidStore *esta_store,
                const ManufacturerMap &manufacturer_stores,
-               uint64_t version = 0)
-      : m_esta_store(esta_store),
-        m_manufacturer_store(manufacturer_stores),
-        m_version(version) {
-  }
+               uint64_t version = 0);
 
   ~RootPidStore();
 
@@ -171,6 +169,8 @@ class RootPidStore {
  private:
   std::auto_ptr<const PidStore> m_esta_store;
   ManufacturerMap m_manufacturer_store;
+  // Indexed by (manufacturer id << 16) | PID
+  std::auto_ptr<const PidValueIndex> m_manufacturer_index;
   uint64_t m_version;
 
   const PidDescriptor *InternalESTANameLookup(
@@ -204,7 +204,7 @@ class PidStore {
    * @brief The number of PidDescriptors in this store.
    * @returns the number of PidDescriptors in this store.
    */
-  unsigned int PidCount() const { return m_pid_by_value.size(); }
+  unsigned int PidCount() const { return m_pids.size(); }
 
   /**
    * @brief Return a list of all PidDescriptors.
@@ -230,10 +230,10 @@ class PidStore {
   const PidDescriptor *LookupPID(const std::string &pid_name) const;
 
  private:
-  typedef std::map<uint16_t, const PidDescriptor*> PidMap;
-  typedef std::map<std::string, const PidDescriptor*> PidNameMap;
-  PidMap m_pid_by_value;
-  PidNameMap m_pid_by_name;
+  // Sorted by PID
+  std::vector<const PidDescriptor*> m_pids;
+  std::auto_ptr<const PidValueIndex> m_value_index;
+  std::auto_ptr<const PidNameIndex> m_name_index;
 
   DISALLOW_COPY_AND_ASSIGN(PidStore);
 };
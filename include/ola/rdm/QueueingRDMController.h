@@ -22,14 +22,15 @@
  * @addtogroup rdm_controller
  * @{
  * @file QueueingRDMController.h
- * @brief An RDM Controller that queues messages and only sends a single message
- * at a time.
+ * @brief An RDM Controller that queues messages and limits how many are sent
+ * at once.
  * @}
  */
 #ifndef INCLUDE_OLA_RDM_QUEUEINGRDMCONTROLLER_H_
 #define INCLUDE_OLA_RDM_QUEUEINGRDMCONTROLLER_H_
 
 #include <ola/rdm/RDMControllerInterface.h>
+#include <memory>
 #include <queue>
 #include <string>
 #include <utility>
@@ -39,13 +40,27 @@ namespace ola {
 namespace rdm {
 
 /*
- * A RDM controller that only sends a single request at a time. This also
- * handles timing out messages that we don't get a response for.
+ * A RDM controller that queues requests and limits how many are sent to the
+ * underlying controller at once.
+ *
+ * By default only a single request is in flight, which is what a half-duplex
+ * DMX line needs. Controllers that can handle concurrent requests can be
+ * given a larger window. Each request in flight tracks its own ACK_OVERFLOW
+ * sequence. ACK_TIMER responses are returned to the caller straight away, so
+ * they free up their slot in the window.
  */
 class QueueingRDMController: public RDMControllerInterface {
  public:
+    /**
+     * @param controller the controller to send requests to.
+     * @param max_queue_size the maximum number of requests, including those
+     *   in flight.
+     * @param max_in_flight the maximum number of requests that are sent to
+     *   the controller at once.
+     */
     QueueingRDMController(RDMControllerInterface *controller,
-                          unsigned int max_queue_size);
+                          unsigned int max_queue_size,
+                          unsigned int max_in_flight = 1);
     ~QueueingRDMController();
 
     void Pause();
@@ -60,22 +75,28 @@ class QueueingRDMController: public RDMControllerInterface {
       RDMCallback *on_complete;
     } outstanding_rdm_request;
 
+    // A request that has been sent, along with any ACK_OVERFLOW data.
+    struct InFlightRequest {
+      const RDMRequest *request;
+      RDMCallback *on_complete;
+      std::auto_ptr<ola::rdm::RDMResponse> response;
+      std::vector<RDMFrame> frames;
+    };
+
     RDMControllerInterface *m_controller;
     unsigned int m_max_queue_size;
+    unsigned int m_max_in_flight;
     std::queue<outstanding_rdm_request> m_pending_requests;
-    bool m_rdm_request_pending;  // true if a request is in progress
+    unsigned int m_in_flight;  // the number of requests in progress
     bool m_active;  // true if the controller is active
-    std::auto_ptr<RDMCallback> m_callback;
-    std::auto_ptr<ola::rdm::RDMResponse> m_response;
-    std::vector<RDMFrame> m_frames;
 
     virtual void TakeNextAction();
     virtual bool CheckForBlockingCondition();
-    void MaybeSendRDMRequest();
-    void DispatchNextRequest();
+    bool MaybeSendRDMRequest();
+    void DispatchRequest(InFlightRequest *in_flight);
 
-    void HandleRDMResponse(RDMReply *reply);
-    void RunCallback(RDMReply *reply);
+    void HandleRDMResponse(InFlightRequest *in_flight, RDMReply *reply);
+    void RunCallback(InFlightRequest *in_flight, RDMReply *reply);
 };
 
 
@@ -89,7 +110,8 @@ class DiscoverableQueueingRDMController: public QueueingRDMController {
  public:
     DiscoverableQueueingRDMController(
         DiscoverableRDMControllerInterface *controller,
-        unsigned int max_queue_size);
+        unsigned int max_queue_size,
+        unsigned int max_in_flight = 1);
 
     ~DiscoverableQueueingRDMController() {}
 
@@ -172,6 +172,16 @@ struct clock_value_s {
 
 typedef struct clock_value_s ClockValue;
 
+/*
+ * The result for one UID in a batch request. The value is only valid if the
+ * status was acked.
+ */
+template <typename value_type>
+struct BatchResult {
+  ResponseStatus status;
+  value_type value;
+};
+
 /*
  * The interface for objects which deal with queued messages
  */
@@ -982,6 +992,28 @@ class RDMAPI {
         ola::SingleUseCallback1<void, const ResponseStatus&> *callback,
         std::string *error);
 
+    // Batch methods. These send the request to each UID in turn and write
+    // each response into the matching entry of results, which must have one
+    // entry per UID and remain valid until the callback runs. The callback is
+    // run once all the responses have arrived.
+    class BatchRequest;
+
+    bool GetDeviceInfoBatch(
+        unsigned int universe,
+        const std::vector<UID> &uids,
+        uint16_t sub_device,
+        BatchResult<DeviceDescriptor> *results,
+        ola::SingleUseCallback0<void> *callback,
+        std::string *error);
+
+    bool GetDMXAddressBatch(
+        unsigned int universe,
+        const std::vector<UID> &uids,
+        uint16_t sub_device,
+        BatchResult<uint16_t> *results,
+        ola::SingleUseCallback0<void> *callback,
+        std::string *error);
+
     // Handlers, these are called by the RDMAPIImpl.
 
     // Generic handlers
@@ -1092,6 +1124,12 @@ class RDMAPI {
         const ResponseStatus &status,
         const std::string &data);
 
+    void _HandleBatchDeviceDescriptor(
+        BatchRequest *batch,
+        BatchResult<DeviceDescriptor> *result,
+        const ResponseStatus &status,
+        const std::string &data);
+
     void _HandleGetProductDetailIdList(
         ola::SingleUseCallback2<void,
                                 const ResponseStatus&,
@@ -1144,6 +1182,12 @@ class RDMAPI {
         const ResponseStatus &status,
         const std::string &data);
 
+    void _HandleBatchDMXAddress(
+        BatchRequest *batch,
+        BatchResult<uint16_t> *result,
+        const ResponseStatus &status,
+        const std::string &data);
+
     void _HandleGetSlotInfo(
         ola::SingleUseCallback2<void,
                                 const ResponseStatus&,
@@ -1288,6 +1332,27 @@ class RDMAPI {
       return true;
     }
 
+    template <typename value_type>
+    bool SendBatch(
+        unsigned int universe,
+        const std::vector<UID> &uids,
+        uint16_t sub_device,
+        uint16_t pid,
+        BatchResult<value_type> *results,
+        void (RDMAPI::*handler)(BatchRequest*,
+                                BatchResult<value_type>*,
+                                const ResponseStatus&,
+                                const std::string&),
+        ola::SingleUseCallback0<void> *callback,
+        std::string *error);
+
+    void UnpackDeviceDescriptor(const std::string &data,
+                                ResponseStatus *status,
+                                DeviceDescriptor *device_info);
+    void UnpackDMXAddress(const std::string &data,
+                          ResponseStatus *status,
+                          uint16_t *start_address);
+
     bool CheckReturnStatus(bool status, std::string *error);
     void SetIncorrectPDL(ResponseStatus *status,
                          unsigned int actual,
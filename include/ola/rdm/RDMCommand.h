@@ -223,6 +223,8 @@ class RDMCommand {
   static uint16_t CalculateChecksum(const uint8_t *data,
                                     unsigned int packet_length);
 
+  friend class RDMCommandView;
+
   DISALLOW_COPY_AND_ASSIGN(RDMCommand);
 };
 
@@ -33,6 +33,7 @@
 #include <ola/io/ByteString.h>
 #include <ola/io/IOStack.h>
 #include <ola/rdm/RDMCommand.h>
+#include <ola/rdm/RDMCommandView.h>
 #include <ola/rdm/UID.h>
 
 namespace ola {
@@ -100,6 +101,31 @@ class RDMCommandSerializer {
    */
   static bool Write(const RDMCommand &command, ola::io::IOStack *stack);
 
+  /**
+   * @brief Serialize a RDMCommandView to an array of bytes.
+   * @param command the RDMCommandView to serialize.
+   * @param buffer The memory location to serailize to.
+   * @param[in,out] size The size of the memory location.
+   * @returns True if the command was serialized correctly, false otherwise.
+   *
+   * The checksum is recalculated, since the header may have been modified.
+   */
+  static bool Pack(const RDMCommandView &command,
+                   uint8_t *buffer,
+                   unsigned int *size);
+
+  /**
+   * @brief Write the binary representation of an RDMCommandView to an
+   *   IOStack.
+   * @param command the RDMCommandView
+   * @param stack the IOStack to write to.
+   * @returns true if the write was successful, false otherwise.
+   *
+   * The parameter data is written directly from the buffer the view refers
+   * to.
+   */
+  static bool Write(const RDMCommandView &command, ola::io::IOStack *stack);
+
   /**
    * @brief The maximum parameter data a single command can contain.
    */
@@ -110,6 +136,9 @@ class RDMCommandSerializer {
 
   static void PopulateHeader(RDMCommandHeader *header,
                              const RDMCommand &command);
+  static uint16_t HeaderChecksum(const RDMCommandHeader &header,
+                                 const uint8_t *param_data,
+                                 unsigned int param_data_length);
 };
 }  // namespace rdm
 }  // namespace ola
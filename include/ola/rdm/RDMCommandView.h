@@ -0,0 +1,135 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMCommandView.h
+ * A read only view of an RDM message in a receive buffer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup rdm_command
+ * @{
+ * @file RDMCommandView.h
+ * @brief A view of an RDM message that doesn't copy the parameter data.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_RDM_RDMCOMMANDVIEW_H_
+#define INCLUDE_OLA_RDM_RDMCOMMANDVIEW_H_
+
+#include <stdint.h>
+#include <ola/rdm/RDMCommand.h>
+#include <ola/rdm/RDMPacket.h>
+#include <ola/rdm/RDMResponseCodes.h>
+#include <ola/rdm/UID.h>
+
+namespace ola {
+namespace rdm {
+
+/**
+ * @brief A view of a serialized RDM message.
+ *
+ * Parsing a message into a RDMCommandView doesn't allocate any memory. The
+ * header is copied into the view, and the parameter data refers to the buffer
+ * that was parsed, so the buffer must outlive the view.
+ *
+ * The source & destination UIDs, transaction number and port id can be
+ * changed, which allows proxies to rewrite a message and then pass it to
+ * RDMCommandSerializer without creating a new RDMCommand.
+ *
+ * @code
+ *   RDMCommandView command;
+ *   if (command.Parse(data, length) == RDM_COMPLETED_OK &&
+ *       command.IsRequest()) {
+ *     command.SetTransactionNumber(transaction_number);
+ *     RDMCommandSerializer::Write(command, &stack);
+ *   }
+ * @endcode
+ */
+class RDMCommandView {
+ public:
+  /**
+   * @brief Create an empty view, Parse() must be called before the view is
+   *   used.
+   */
+  RDMCommandView();
+
+  /**
+   * @brief Parse an RDM message.
+   * @param data the message, excluding the start code.
+   * @param length the length of the data.
+   * @returns RDM_COMPLETED_OK if the message was valid, otherwise the reason
+   *   it was rejected.
+   */
+  RDMStatusCode Parse(const uint8_t *data, unsigned int length);
+
+  uint8_t SubStartCode() const { return m_header.sub_start_code; }
+  uint8_t MessageLength() const { return m_header.message_length; }
+
+  UID SourceUID() const;
+  void SetSourceUID(const UID &uid);
+
+  UID DestinationUID() const;
+  void SetDestinationUID(const UID &uid);
+
+  uint8_t TransactionNumber() const { return m_header.transaction_number; }
+  void SetTransactionNumber(uint8_t transaction_number) {
+    m_header.transaction_number = transaction_number;
+  }
+
+  /**
+   * @brief The port id for requests or the response type for responses.
+   */
+  uint8_t PortIdResponseType() const { return m_header.port_id; }
+  void SetPortIdResponseType(uint8_t port_id) { m_header.port_id = port_id; }
+
+  uint8_t MessageCount() const { return m_header.message_count; }
+  uint16_t SubDevice() const;
+
+  /**
+   * @brief The command class, INVALID_COMMAND if it isn't one we know of.
+   */
+  RDMCommand::RDMCommandClass CommandClass() const { return m_command_class; }
+  uint16_t ParamId() const;
+
+  /**
+   * @brief The parameter data, this points into the buffer passed to Parse().
+   */
+  const uint8_t *ParamData() const { return m_param_data; }
+  unsigned int ParamDataSize() const { return m_header.param_data_length; }
+
+  /**
+   * @brief Check if this is a GET, SET or DISCOVERY request.
+   */
+  bool IsRequest() const;
+
+  /**
+   * @brief Check if this is a GET, SET or DISCOVERY response.
+   */
+  bool IsResponse() const;
+
+  /**
+   * @brief The header, which may have been modified since it was parsed.
+   */
+  const RDMCommandHeader &Header() const { return m_header; }
+
+ private:
+  RDMCommandHeader m_header;
+  RDMCommand::RDMCommandClass m_command_class;
+  const uint8_t *m_param_data;
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // INCLUDE_OLA_RDM_RDMCOMMANDVIEW_H_
@@ -33,7 +33,7 @@
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/RDMResponseCodes.h>
 
-#include <map>
+#include <vector>
 
 namespace ola {
 namespace rdm {
@@ -49,7 +49,8 @@ namespace rdm {
  *
  * The stateless nature of ResponderOps means a single ResponderOps
  * object can handle requests for all responders of the same type. This
- * conserves memory when large numbers of responders are active.
+ * conserves memory when large numbers of responders are active. The handlers
+ * are held in an array sorted by PID, so dispatch is a binary search.
  *
  * ResponderOps handles SUPPORTED_PARAMETERS internally, however this can be
  * overridden by registering a handler for SUPPORTED_PARAMETERS.
@@ -106,15 +107,23 @@ class ResponderOps {
 
  private:
     struct InternalParamHandler {
+      uint16_t pid;
       RDMHandler get_handler;
       RDMHandler set_handler;
     };
-    typedef std::map<uint16_t, InternalParamHandler> RDMHandlers;
+    // Sorted by PID.
+    typedef std::vector<InternalParamHandler> RDMHandlers;
 
     bool m_include_required_pids;
     RDMHandlers m_handlers;
 
+    const InternalParamHandler *FindHandler(uint16_t pid) const;
     RDMResponse *HandleSupportedParams(const RDMRequest *request);
+
+    static bool PIDLessThan(const InternalParamHandler &handler,
+                            uint16_t pid) {
+      return handler.pid < pid;
+    }
 };
 
 }  // namespace rdm
@@ -49,19 +49,33 @@ template <class Target>
 ResponderOps<Target>::ResponderOps(const ParamHandler param_handlers[],
                                    bool include_required_pids)
     : m_include_required_pids(include_required_pids) {
+  // Later handlers for a PID replace earlier ones, so build a map first and
+  // then copy it to the sorted array.
+  std::map<uint16_t, InternalParamHandler> handlers;
+
   // We install placeholders for any pids which are handled internally.
-  struct InternalParamHandler placeholder = {NULL, NULL};
-  STLReplace(&m_handlers, PID_SUPPORTED_PARAMETERS, placeholder);
+  struct InternalParamHandler placeholder = {
+    PID_SUPPORTED_PARAMETERS, NULL, NULL
+  };
+  STLReplace(&handlers, placeholder.pid, placeholder);
 
   const ParamHandler *handler = param_handlers;
   while (handler->pid && (handler->get_handler || handler->set_handler)) {
     struct InternalParamHandler pid_handler = {
+      handler->pid,
       handler->get_handler,
       handler->set_handler
     };
-    STLReplace(&m_handlers, handler->pid, pid_handler);
+    STLReplace(&handlers, handler->pid, pid_handler);
     handler++;
   }
+
+  m_handlers.reserve(handlers.size());
+  typename std::map<uint16_t, InternalParamHandler>::const_iterator iter =
+      handlers.begin();
+  for (; iter != handlers.end(); ++iter) {
+    m_handlers.push_back(iter->second);
+  }
 }
 
 template <class Target>
@@ -136,7 +150,7 @@ void ResponderOps<Target>::HandleRDMRequest(Target *target,
     return;
   }
 
-  InternalParamHandler *handler = STLFind(&m_handlers, request->ParamId());
+  const InternalParamHandler *handler = FindHandler(request->ParamId());
   if (!handler) {
     if (request->DestinationUID().IsBroadcast()) {
       RunRDMCallback(on_complete, RDM_WAS_BROADCAST);
@@ -185,6 +199,17 @@ void ResponderOps<Target>::HandleRDMRequest(Target *target,
   }
 }
 
+template <class Target>
+const typename ResponderOps<Target>::InternalParamHandler*
+    ResponderOps<Target>::FindHandler(uint16_t pid) const {
+  typename RDMHandlers::const_iterator iter = std::lower_bound(
+      m_handlers.begin(), m_handlers.end(), pid, PIDLessThan);
+  if (iter == m_handlers.end() || iter->pid != pid) {
+    return NULL;
+  }
+  return &(*iter);
+}
+
 template <class Target>
 RDMResponse *ResponderOps<Target>::HandleSupportedParams(
     const RDMRequest *request) {
@@ -195,7 +220,7 @@ RDMResponse *ResponderOps<Target>::HandleSupportedParams(
   params.reserve(m_handlers.size());
   typename RDMHandlers::const_iterator iter = m_handlers.begin();
   for (; iter != m_handlers.end(); ++iter) {
-    uint16_t pid = iter->first;
+    uint16_t pid = iter->pid;
     // some pids never appear in supported_parameters.
     if (m_include_required_pids || (
         pid != PID_SUPPORTED_PARAMETERS &&
@@ -204,11 +229,9 @@ RDMResponse *ResponderOps<Target>::HandleSupportedParams(
         pid != PID_SOFTWARE_VERSION_LABEL &&
         pid != PID_DMX_START_ADDRESS &&
         pid != PID_IDENTIFY_DEVICE)) {
-      params.push_back(iter->first);
+      params.push_back(pid);
     }
   }
-  sort(params.begin(), params.end());
-
   std::vector<uint16_t>::iterator param_iter = params.begin();
   for (; param_iter != params.end(); ++param_iter) {
     *param_iter = ola::network::HostToNetwork(*param_iter);
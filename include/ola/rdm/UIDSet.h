@@ -32,8 +32,9 @@
 #include <ola/rdm/UID.h>
 #include <algorithm>
 #include <iomanip>
-#include <set>
+#include <iterator>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace rdm {
@@ -43,6 +44,12 @@ namespace rdm {
  * @{
  * @class UIDSet
  * @brief Represents a set of RDM UIDs.
+ *
+ * The UIDs are stored in a sorted vector, which is much more compact than a
+ * node based set for the thousands of UIDs a universe can have. Lookups are a
+ * binary search, and Union() & SetDifference() are a single linear merge.
+ * Adding UIDs in ascending order is cheap, adding them in random order costs
+ * a move of the larger UIDs each time.
  * @}
  */
 class UIDSet {
@@ -50,7 +57,7 @@ class UIDSet {
     /**
      * @brief the Iterator for a UIDSets
      */
-    typedef std::set<UID>::const_iterator Iterator;
+    typedef std::vector<UID>::const_iterator Iterator;
 
     /**
      * @brief Construct an empty set
@@ -103,7 +110,16 @@ class UIDSet {
      * @param uid the UID to add.
      */
     void AddUID(const UID &uid) {
-      m_uids.insert(uid);
+      // Discovery & the port maps usually produce UIDs in order.
+      if (m_uids.empty() || m_uids.back() < uid) {
+        m_uids.push_back(uid);
+        return;
+      }
+      std::vector<UID>::iterator iter = std::lower_bound(
+          m_uids.begin(), m_uids.end(), uid);
+      if (*iter != uid) {
+        m_uids.insert(iter, uid);
+      }
     }
 
     /**
@@ -111,7 +127,11 @@ class UIDSet {
      * @param uid the UID to remove.
      */
     void RemoveUID(const UID &uid) {
-      m_uids.erase(uid);
+      std::vector<UID>::iterator iter = std::lower_bound(
+          m_uids.begin(), m_uids.end(), uid);
+      if (iter != m_uids.end() && *iter == uid) {
+        m_uids.erase(iter);
+      }
     }
 
     /**
@@ -120,7 +140,7 @@ class UIDSet {
      * @return true if the set contains this UID.
      */
     bool Contains(const UID &uid) const {
-      return m_uids.find(uid) != m_uids.end();
+      return std::binary_search(m_uids.begin(), m_uids.end(), uid);
     }
 
     /**
@@ -129,13 +149,14 @@ class UIDSet {
      * @return the union of the two UIDSets.
      */
     UIDSet Union(const UIDSet &other) {
-      std::set<UID> result;
-      set_union(m_uids.begin(),
-                m_uids.end(),
-                other.Begin(),
-                other.End(),
-                inserter(result, result.begin()));
-      return UIDSet(result);
+      UIDSet result;
+      result.m_uids.reserve(m_uids.size() + other.m_uids.size());
+      std::set_union(m_uids.begin(),
+                     m_uids.end(),
+                     other.m_uids.begin(),
+                     other.m_uids.end(),
+                     std::back_inserter(result.m_uids));
+      return result;
     }
 
     /**
@@ -158,13 +179,14 @@ class UIDSet {
      * @return the difference between this UIDSet and other.
      */
     UIDSet SetDifference(const UIDSet &other) {
-      std::set<UID> difference;
+      UIDSet difference;
+      difference.m_uids.reserve(m_uids.size());
       std::set_difference(m_uids.begin(),
                           m_uids.end(),
                           other.m_uids.begin(),
                           other.m_uids.end(),
-                          std::inserter(difference, difference.begin()));
-      return UIDSet(difference);
+                          std::back_inserter(difference.m_uids));
+      return difference;
     }
 
     /**
@@ -189,7 +211,7 @@ class UIDSet {
      */
     std::string ToString() const {
       std::ostringstream str;
-      std::set<UID>::const_iterator iter;
+      std::vector<UID>::const_iterator iter;
       for (iter = m_uids.begin(); iter != m_uids.end(); ++iter) {
         if (iter != m_uids.begin())
           str << ",";
@@ -208,11 +230,8 @@ class UIDSet {
     }
 
  private:
-    std::set<UID> m_uids;
-
-    explicit UIDSet(const std::set<UID> uids) {
-      m_uids = uids;
-    }
+    // sorted, without duplicates
+    std::vector<UID> m_uids;
 };
 }  // namespace rdm
 }  // namespace ola
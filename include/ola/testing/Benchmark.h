@@ -0,0 +1,97 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Benchmark.h
+ * A minimal harness for the microbenchmarks run by `make bench`.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_TESTING_BENCHMARK_H_
+#define INCLUDE_OLA_TESTING_BENCHMARK_H_
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace testing {
+
+/**
+ * @brief Times a set of operations and writes the results as JSON.
+ *
+ * Each call to Run() writes a single line, e.g.
+ * @code
+ * {"suite": "DmxBuffer", "benchmark": "HTPMerge", "param": 0,
+ *  "iterations": 4194304, "ns_per_op": 21.410, "ops_per_sec": 46707146,
+ *  "allocs_per_op": 0.000}
+ * @endcode
+ * so the output of several benchmark programs can be concatenated and
+ * compared between builds.
+ *
+ * Allocations are counted by replacing the global operator new, so linking
+ * the benchmark library changes the allocator for the whole program. The
+ * counter isn't thread safe, operations which allocate from other threads
+ * will be under-counted.
+ */
+class Benchmark {
+ public:
+  /**
+   * @brief The function that runs the operation under test.
+   *
+   * It's called with the number of times to run the operation.
+   */
+  typedef Callback1<void, unsigned int> BenchmarkFunction;
+
+  /**
+   * @brief Create a new Benchmark.
+   * @param suite the name of this set of benchmarks.
+   * @param output where to write the results.
+   */
+  Benchmark(const std::string &suite, std::ostream *output);
+
+  /**
+   * @brief Time an operation.
+   * @param name the name of the benchmark.
+   * @param param the parameter of this run, e.g. the number of sources.
+   * @param function the function to run, ownership is transferred.
+   *
+   * The number of iterations is doubled until a run takes at least
+   * MIN_DURATION_MS, and the time per operation of that run is written.
+   */
+  void Run(const std::string &name, unsigned int param,
+           BenchmarkFunction *function);
+
+  /**
+   * @brief The number of calls to operator new since the program started.
+   */
+  static uint64_t AllocationCount();
+
+ private:
+  const std::string m_suite;
+  std::ostream *m_output;
+  Clock m_clock;
+
+  static const unsigned int MIN_DURATION_MS = 200;
+  static const unsigned int MAX_ITERATIONS = 1 << 30;
+
+  DISALLOW_COPY_AND_ASSIGN(Benchmark);
+};
+}  // namespace testing
+}  // namespace ola
+#endif  // INCLUDE_OLA_TESTING_BENCHMARK_H_
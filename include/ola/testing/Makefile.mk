@@ -1,4 +1,6 @@
 # These aren't installed
 noinst_HEADERS += \
+    include/ola/testing/Benchmark.h \
     include/ola/testing/MockUDPSocket.h \
-    include/ola/testing/TestUtils.h
+    include/ola/testing/TestUtils.h \
+    include/ola/testing/UDPCapture.h
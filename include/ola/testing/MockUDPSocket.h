@@ -93,6 +93,11 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
   bool RecvFrom(uint8_t *buffer,
                 ssize_t *data_read,
                 ola::network::IPV4SocketAddress *source);
+  bool RecvBatch(ola::network::DatagramBatch *batch);
+  // Data is always sent straight away, so the expected data can be checked
+  // as usual.
+  void BeginSendBatch() { m_send_batch_depth++; }
+  bool EndSendBatch();
   bool EnableBroadcast();
   bool SetMulticastInterface(const ola::network::IPV4Address &iface);
   bool JoinMulticast(const ola::network::IPV4Address &iface,
@@ -102,6 +107,10 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
                       const ola::network::IPV4Address &group);
 
   bool SetTos(uint8_t tos);
+  bool SetMaxPacingRate(uint32_t bytes_per_second);
+  bool EnableReceiveStats(const ola::network::UDPReceiveOptions &options);
+  void SetEdgeTriggered(bool) {}
+  void SetPriority(ola::io::DescriptorPriority) {}
 
   void SetDiscardMode(bool discard_mode) { m_discard_mode = discard_mode; }
 
@@ -152,10 +161,12 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
   bool m_broadcast_set;
   uint16_t m_port;
   uint8_t m_tos;
+  uint32_t m_max_pacing_rate;
   mutable std::queue<expected_call> m_expected_calls;
   mutable std::queue<received_data> m_received_data;
   ola::network::IPV4Address m_interface;
   bool m_discard_mode;
+  unsigned int m_send_batch_depth;
 
   uint8_t* IOQueueToBuffer(ola::io::IOQueue *ioqueue,
                            unsigned int *size) const;
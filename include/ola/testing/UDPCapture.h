@@ -0,0 +1,45 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPCapture.h
+ * Reads UDP datagrams from a pcap file so they can be replayed.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_TESTING_UDPCAPTURE_H_
+#define INCLUDE_OLA_TESTING_UDPCAPTURE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace testing {
+
+/**
+ * @brief Load the payloads of the UDP datagrams sent to a port.
+ * @param filename the pcap file to read.
+ * @param port the destination UDP port to match.
+ * @param[out] payloads the matching payloads, in capture order.
+ * @returns false if the file couldn't be read or isn't a supported capture.
+ *
+ * Only the classic pcap format is supported, with Ethernet, Linux cooked or
+ * raw IP link layers. IPv6 and fragmented IPv4 datagrams are skipped.
+ */
+bool LoadUDPCapture(const std::string &filename, uint16_t port,
+                    std::vector<std::string> *payloads);
+}  // namespace testing
+}  // namespace ola
+#endif  // INCLUDE_OLA_TESTING_UDPCAPTURE_H_
@@ -0,0 +1,113 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MPSCQueue.h
+ * A lock-free multi-producer, single-consumer queue.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_THREAD_MPSCQUEUE_H_
+#define INCLUDE_OLA_THREAD_MPSCQUEUE_H_
+
+#include <ola/base/Macro.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief A lock-free multi-producer, single-consumer queue.
+ *
+ * Any thread can call Push(). The consumer removes all the queued items at
+ * once with PopAll(), which returns them in the order they were pushed. Only
+ * one thread may call PopAll() at a time.
+ *
+ * Push() returns true if the queue was empty, so producers can wake the
+ * consumer once per batch of items rather than once per item.
+ */
+template <typename T>
+class MPSCQueue {
+ public:
+  MPSCQueue() : m_head(NULL) {}
+
+  ~MPSCQueue() {
+    Node *node = m_head;
+    while (node) {
+      Node *next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  /**
+   * @brief Add an item to the queue.
+   * @param value the item to add.
+   * @returns true if the queue was empty before this item was added.
+   */
+  bool Push(const T &value) {
+    Node *node = new Node(value);
+    Node *head = __atomic_load_n(&m_head, __ATOMIC_RELAXED);
+    do {
+      node->next = head;
+    } while (!__atomic_compare_exchange_n(&m_head, &head, node, true,
+                                          __ATOMIC_RELEASE,
+                                          __ATOMIC_RELAXED));
+    return head == NULL;
+  }
+
+  /**
+   * @brief Remove all the items from the queue.
+   * @param output the vector to append the items to, oldest first.
+   * @returns the number of items removed.
+   */
+  unsigned int PopAll(std::vector<T> *output) {
+    Node *node = __atomic_exchange_n(&m_head, static_cast<Node*>(NULL),
+                                     __ATOMIC_ACQUIRE);
+    // The list is newest first.
+    const size_t start = output->size();
+    while (node) {
+      output->push_back(node->value);
+      Node *next = node->next;
+      delete node;
+      node = next;
+    }
+    std::reverse(output->begin() + start, output->end());
+    return output->size() - start;
+  }
+
+  /**
+   * @brief Check if the queue is empty.
+   */
+  bool Empty() const {
+    return __atomic_load_n(&m_head, __ATOMIC_ACQUIRE) == NULL;
+  }
+
+ private:
+  struct Node {
+    explicit Node(const T &v) : value(v), next(NULL) {}
+
+    T value;
+    Node *next;
+  };
+
+  Node *m_head;
+
+  DISALLOW_COPY_AND_ASSIGN(MPSCQueue);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // INCLUDE_OLA_THREAD_MPSCQUEUE_H_
@@ -32,6 +32,7 @@
 #include <ola/thread/Mutex.h>
 
 #include <string>
+#include <vector>
 
 #if defined(_WIN32) && defined(__GNUC__)
 inline std::ostream& operator<<(std::ostream &stream,
@@ -87,11 +88,31 @@ class Thread {
      */
     int inheritsched;
 
+    /**
+     * @brief The class of the thread, e.g. THREAD_CLASS_OUTPUT.
+     *
+     * If settings have been registered for the class with
+     * SetThreadClassSettings(), the thread applies them when it starts. This
+     * allows the CPU affinity & priority of threads to be configured without
+     * changing the code that creates them.
+     */
+    std::string thread_class;
+
+    /**
+     * @brief The CPUs the thread may run on.
+     *
+     * If empty, the CPUs for the thread class are used, or if there are none
+     *   the thread may run on any CPU.
+     */
+    std::vector<unsigned int> cpu_affinity;
+
     /**
      * @brief Create new thread Options.
      * @param name the name of the thread.
+     * @param thread_class the class of the thread.
      */
-    explicit Options(const std::string &name = "");
+    explicit Options(const std::string &name = "",
+                     const std::string &thread_class = "");
   };
 
   /**
@@ -182,6 +203,8 @@ class Thread {
   Mutex m_mutex;  // protects m_running
   ConditionVariable m_condition;  // use to wait for the thread to start
 
+  void ApplyThreadSettings();
+
   DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 }  // namespace thread
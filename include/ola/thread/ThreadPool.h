@@ -31,6 +31,12 @@
 namespace ola {
 namespace thread {
 
+/**
+ * @brief A fixed set of threads sharing a single queue of actions.
+ *
+ * New code should use WorkStealingPool, which supports priorities and
+ * futures.
+ */
 class ThreadPool {
  public :
   typedef ola::BaseCallback0<void>* Action;
@@ -0,0 +1,131 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ThreadSettings.h
+ * CPU affinity & scheduling settings for classes of threads.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_THREAD_THREADSETTINGS_H_
+#define INCLUDE_OLA_THREAD_THREADSETTINGS_H_
+
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief The CPU affinity & scheduling for a class of threads.
+ *
+ * Threads are placed in a class with Thread::Options::thread_class. When a
+ * thread in the class starts, it pins itself to the CPUs and sets its
+ * scheduling policy & priority. Failures are logged but don't stop the
+ * thread, since real-time scheduling usually requires extra privileges.
+ */
+struct ThreadSettings {
+ public:
+  ThreadSettings()
+      : set_scheduling(false),
+        policy(0),
+        priority(0) {
+  }
+
+  /**
+   * @brief The CPUs the threads may run on. If empty, the threads may run on
+   *   any CPU.
+   */
+  std::vector<unsigned int> cpus;
+
+  /**
+   * @brief True if the policy & priority should be set.
+   */
+  bool set_scheduling;
+
+  /**
+   * @brief The scheduling policy, one of SCHED_OTHER, SCHED_FIFO or SCHED_RR.
+   */
+  int policy;
+
+  /**
+   * @brief The priority of the threads.
+   */
+  int priority;
+};
+
+/**
+ * @brief Parse ThreadSettings from strings.
+ * @param cpus a comma separated list of CPUs, e.g. "2,3", or empty to allow
+ *   any CPU.
+ * @param policy one of other, fifo or rr, or empty to leave the scheduling
+ *   unchanged.
+ * @param priority the thread priority. This requires a policy, if it's empty
+ *   the priority is 0.
+ * @param[out] settings the parsed settings.
+ * @returns true if the input was valid, false otherwise.
+ */
+bool ParseThreadSettings(const std::string &cpus,
+                         const std::string &policy,
+                         const std::string &priority,
+                         ThreadSettings *settings);
+
+/**
+ * @brief Set the settings for a class of threads.
+ * @param thread_class the class of threads.
+ * @param settings the settings to use.
+ *
+ * This only affects threads that are started afterwards.
+ */
+void SetThreadClassSettings(const std::string &thread_class,
+                            const ThreadSettings &settings);
+
+/**
+ * @brief Get the settings for a class of threads.
+ * @param thread_class the class of threads.
+ * @param[out] settings the settings for the class.
+ * @returns true if the class has settings, false otherwise.
+ */
+bool GetThreadClassSettings(const std::string &thread_class,
+                            ThreadSettings *settings);
+
+/**
+ * @brief Remove the settings for all classes of threads.
+ */
+void ClearThreadClassSettings();
+
+/**
+ * @brief Pin the calling thread to a set of CPUs.
+ * @param cpus the CPUs the thread may run on.
+ * @returns true if the affinity was set, false otherwise.
+ */
+bool SetCurrentThreadAffinity(const std::vector<unsigned int> &cpus);
+
+/**
+ * @name Thread classes
+ * @brief The classes of threads used by olad.
+ * @{
+ */
+/** @brief Threads that send DMX to the hardware. */
+extern const char THREAD_CLASS_OUTPUT[];
+/** @brief Threads that run the libusb event loop. */
+extern const char THREAD_CLASS_USB[];
+/** @brief The HTTP server thread. */
+extern const char THREAD_CLASS_HTTP[];
+/** @brief The thread that saves the preference files. */
+extern const char THREAD_CLASS_PREFERENCES[];
+/** @} */
+}  // namespace thread
+}  // namespace ola
+#endif  // INCLUDE_OLA_THREAD_THREADSETTINGS_H_
@@ -0,0 +1,199 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WorkStealingPool.h
+ * A pool of worker threads, each with its own queue of actions.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_THREAD_WORKSTEALINGPOOL_H_
+#define INCLUDE_OLA_THREAD_WORKSTEALINGPOOL_H_
+
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/CallbackThread.h>
+#include <ola/thread/ExecutorInterface.h>
+#include <ola/thread/Future.h>
+#include <ola/thread/Mutex.h>
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief Runs actions on a pool of worker threads.
+ *
+ * Each worker has its own queue of actions for each priority. Actions added
+ * from a worker go on that worker's queue; actions added from other threads
+ * are spread across the workers. An idle worker takes from its own queue
+ * first, then steals from the other workers. Higher priority actions are
+ * always run before lower priority ones.
+ *
+ * Unlike ThreadPool, actions added from the same thread may run in any order.
+ *
+ * @examplepara
+ * @code
+ *   WorkStealingPool pool(4);
+ *   pool.Init();
+ *   Future<bool> result = pool.Submit(NewSingleCallback(&Discover));
+ *   // Or run the reply on the SelectServer once the work is done.
+ *   pool.ExecuteAndReply(NewSingleCallback(&Load),
+ *                        &select_server,
+ *                        NewSingleCallback(&Loaded));
+ * @endcode
+ */
+class WorkStealingPool {
+ public :
+  typedef ola::BaseCallback0<void>* Action;
+
+  /**
+   * @brief The priority of an action.
+   */
+  enum Priority {
+    PRIORITY_HIGH,
+    PRIORITY_NORMAL,
+    PRIORITY_LOW,
+  };
+
+  /**
+   * @brief Create a new WorkStealingPool.
+   * @param thread_count the number of worker threads.
+   */
+  explicit WorkStealingPool(unsigned int thread_count);
+
+  /**
+   * @brief Destructor, this runs any outstanding actions.
+   */
+  ~WorkStealingPool();
+
+  /**
+   * @brief Start the worker threads.
+   * @returns true if the threads were started.
+   */
+  bool Init();
+
+  /**
+   * @brief Run any outstanding actions, then stop the worker threads.
+   *
+   * Workers may add more actions while this runs, but other threads must not
+   * call Execute() until it returns.
+   */
+  void JoinAll();
+
+  /**
+   * @brief Queue an action.
+   * @param action the action to run.
+   * @param priority the priority of the action.
+   *
+   * If the pool isn't running, the action is run immediately.
+   */
+  void Execute(Action action, Priority priority = PRIORITY_NORMAL);
+
+  /**
+   * @brief Queue a callback and return a Future for the result.
+   * @param callback the callback to run, ownership is transferred.
+   * @param priority the priority of the callback.
+   */
+  template <typename T>
+  Future<T> Submit(BaseCallback0<T> *callback,
+                   Priority priority = PRIORITY_NORMAL) {
+    Future<T> future;
+    Execute(NewSingleCallback(&RunAndSet<T>, callback, future), priority);
+    return future;
+  }
+
+  /**
+   * @brief Queue a callback and return a Future that completes when it has
+   *   run.
+   * @param callback the callback to run, ownership is transferred.
+   * @param priority the priority of the callback.
+   */
+  Future<void> Submit(BaseCallback0<void> *callback,
+                      Priority priority = PRIORITY_NORMAL);
+
+  /**
+   * @brief Run an action on a worker, then queue a reply on another executor.
+   * @param action the action to run on a worker.
+   * @param executor the executor to run the reply on, usually the
+   *   SelectServer.
+   * @param reply the callback to run on the executor once the action is
+   *   complete.
+   * @param priority the priority of the action.
+   *
+   * This is used to move blocking work off the main loop, while keeping the
+   * handling of the result on the main loop.
+   */
+  void ExecuteAndReply(Action action,
+                       ExecutorInterface *executor,
+                       Action reply,
+                       Priority priority = PRIORITY_NORMAL);
+
+  /**
+   * @brief Return the number of actions waiting to be run.
+   */
+  unsigned int QueueDepth() const;
+
+  /**
+   * @brief Return the number of actions a worker has taken from another
+   *   worker's queue.
+   */
+  uint64_t StealCount() const;
+
+ private:
+  static const unsigned int PRIORITY_COUNT = PRIORITY_LOW + 1;
+
+  struct Worker {
+    Worker() : thread(NULL), steals(0) {}
+
+    CallbackThread *thread;
+    Mutex mutex;
+    std::deque<Action> queues[PRIORITY_COUNT];
+    uint64_t steals;
+  };
+
+  const unsigned int m_thread_count;
+  std::vector<Worker*> m_workers;
+  // Protects the fields below. Workers wait on m_condition when there is
+  // nothing to do.
+  mutable Mutex m_mutex;
+  ConditionVariable m_condition;
+  unsigned int m_pending;
+  unsigned int m_next_worker;
+  bool m_running;
+  bool m_shutdown;
+
+  void RunWorker(unsigned int index);
+  Action TakeAction(unsigned int index);
+  int CurrentWorker() const;
+  void JoinAllThreads();
+
+  static void RunAndReply(Action action,
+                          ExecutorInterface *executor,
+                          Action reply);
+  static void RunAndSetVoid(BaseCallback0<void> *callback,
+                            Future<void> future);
+
+  template <typename T>
+  static void RunAndSet(BaseCallback0<T> *callback, Future<T> future) {
+    future.Set(callback->Run());
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingPool);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // INCLUDE_OLA_THREAD_WORKSTEALINGPOOL_H_
@@ -52,6 +52,14 @@ class TimeCode {
     uint8_t Seconds() const { return m_seconds; }
     uint8_t Frames() const { return m_frames; }
 
+    /**
+     * @brief Advance to the next frame, wrapping at 24 hours.
+     *
+     * Drop frame timecode skips frames 0 & 1 at the start of each minute,
+     * except for every tenth minute.
+     */
+    TimeCode& operator++();
+
     bool operator==(const TimeCode &other) const;
     bool operator!=(const TimeCode &other) const;
 
@@ -68,6 +76,8 @@ class TimeCode {
     static const uint8_t MAX_HOURS = 23;
     static const uint8_t MAX_MINUTES = 59;
     static const uint8_t MAX_SECONDS = 59;
+
+    uint8_t FramesPerSecond() const;
 };
 }  // namespace timecode
 }  // namespace ola
@@ -0,0 +1,97 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Histogram.h
+ * A fixed size, log-linear histogram.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_UTIL_HISTOGRAM_H_
+#define INCLUDE_OLA_UTIL_HISTOGRAM_H_
+
+#include <stdint.h>
+
+namespace ola {
+
+/**
+ * @brief A log-linear histogram, in the style of HdrHistogram.
+ *
+ * Values below 32 are recorded exactly. Larger values are recorded in one of
+ * 16 buckets per power of two, so a percentile is within 1/16th (6.25%) of
+ * the recorded value. Adding a value never allocates memory, which makes this
+ * suitable for recording timings on every frame.
+ */
+class Histogram {
+ public:
+  Histogram() { Reset(); }
+
+  /**
+   * @brief Record a value.
+   */
+  void Add(uint32_t value);
+
+  /**
+   * @brief Remove all recorded values.
+   */
+  void Reset();
+
+  /**
+   * @brief Return the number of values recorded.
+   */
+  uint64_t Count() const { return m_count; }
+
+  /**
+   * @brief Return the sum of the values recorded.
+   */
+  uint64_t Sum() const { return m_sum; }
+
+  /**
+   * @brief Return the largest value recorded.
+   */
+  uint32_t Max() const { return m_max; }
+
+  /**
+   * @brief Return the value at a percentile.
+   * @param percentile the percentile, from 0 to 100, e.g. 99.9.
+   * @returns the highest value in the bucket containing the percentile, or 0
+   *   if no values have been recorded.
+   */
+  uint32_t Percentile(double percentile) const;
+
+  /**
+   * @brief Count the values at or below each of a set of bounds.
+   * @param bounds the bounds, in ascending order. The counts are exact if
+   *   each bound is the top of a bucket, e.g. 2^n - 1.
+   * @param size the number of bounds.
+   * @param[out] counts the cumulative count for each bound.
+   */
+  void CumulativeCounts(const uint32_t *bounds, unsigned int size,
+                        uint64_t *counts) const;
+
+ private:
+  static const unsigned int SUB_BUCKET_BITS = 4;
+  static const unsigned int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static const unsigned int BUCKET_COUNT = (33 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+  uint32_t m_buckets[BUCKET_COUNT];
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint32_t m_max;
+
+  static unsigned int BucketIndex(uint32_t value);
+  static uint32_t BucketUpperBound(unsigned int index);
+};
+}  // namespace ola
+#endif  // INCLUDE_OLA_UTIL_HISTOGRAM_H_
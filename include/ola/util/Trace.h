@@ -0,0 +1,129 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Trace.h
+ * Records spans of time in per-thread ring buffers.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file Trace.h
+ * @brief Records spans of time in per-thread ring buffers.
+ *
+ * Tracing is enabled by building with \--enable-tracing, which defines
+ * OLA_TRACING. Otherwise the OLA_TRACE_* macros expand to nothing.
+ *
+ * @examplepara
+ * @code
+ * void Universe::MergeAll() {
+ *   OLA_TRACE_SCOPE("olad", "Universe::MergeAll");
+ *   ...
+ * }
+ * @endcode
+ *
+ * The recorded spans are written in the Chrome trace event format by
+ * WriteChromeTrace(), this can be loaded into chrome://tracing or Perfetto.
+ */
+
+#ifndef INCLUDE_OLA_UTIL_TRACE_H_
+#define INCLUDE_OLA_UTIL_TRACE_H_
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+namespace ola {
+namespace trace {
+
+/**
+ * @brief Records a span from construction until destruction.
+ *
+ * Use the OLA_TRACE_SCOPE macro rather than creating these directly.
+ */
+class ScopedTrace {
+ public:
+  /**
+   * @brief Start a span.
+   * @param category the category of the span, this must be a string literal.
+   * @param name the name of the span, this must be a string literal.
+   */
+  ScopedTrace(const char *category, const char *name);
+  ~ScopedTrace();
+
+ private:
+  const char *m_category;
+  const char *m_name;
+  int64_t m_start;
+};
+
+/**
+ * @brief The current time in microseconds, from the monotonic clock.
+ */
+int64_t Now();
+
+/**
+ * @brief Record a span on the current thread's buffer.
+ * @param category the category of the span, this must be a string literal.
+ * @param name the name of the span, this must be a string literal.
+ * @param start the start time, from Now().
+ * @param duration the duration in microseconds.
+ */
+void RecordSpan(const char *category, const char *name, int64_t start,
+                int64_t duration);
+
+/**
+ * @brief Set the name of the current thread in the trace.
+ */
+void SetThreadName(const std::string &name);
+
+/**
+ * @brief Write the buffered spans from all threads as a Chrome trace.
+ * @param output the stream to write the JSON to.
+ *
+ * The buffers aren't cleared, so spans may appear in more than one trace.
+ */
+void WriteChromeTrace(std::ostream *output);
+
+/**
+ * @brief The number of spans kept for each thread.
+ */
+static const unsigned int SPANS_PER_THREAD = 16384;
+}  // namespace trace
+}  // namespace ola
+
+#ifdef OLA_TRACING
+
+#define OLA_TRACE_CONCAT_INTERNAL(a, b) a ## b
+#define OLA_TRACE_CONCAT(a, b) OLA_TRACE_CONCAT_INTERNAL(a, b)
+
+/**
+ * @brief Record a span until the end of the enclosing scope.
+ */
+#define OLA_TRACE_SCOPE(category, name) \
+  ola::trace::ScopedTrace OLA_TRACE_CONCAT(ola_trace_, __LINE__)( \
+      category, name)
+
+/**
+ * @brief Set the name of the current thread in the trace.
+ */
+#define OLA_TRACE_THREAD_NAME(name) ola::trace::SetThreadName(name)
+
+#else
+
+#define OLA_TRACE_SCOPE(category, name)
+#define OLA_TRACE_THREAD_NAME(name)
+
+#endif  // OLA_TRACING
+#endif  // INCLUDE_OLA_UTIL_TRACE_H_
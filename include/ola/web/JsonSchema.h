@@ -33,7 +33,6 @@
 #include <ola/stl/STLUtils.h>
 #include <ola/web/Json.h>
 #include <ola/web/JsonTypes.h>
-#include <deque>
 #include <map>
 #include <memory>
 #include <set>
@@ -223,8 +222,11 @@ class BaseValidator : public ValidatorInterface {
   std::string m_description;
   std::auto_ptr<const JsonValue> m_default_value;
   std::vector<const JsonValue*> m_enums;
+  // The values of the string enums, so strings can be checked with a lookup.
+  std::set<std::string> m_string_enums;
 
   bool CheckEnums(const JsonValue &value);
+  bool CheckEnums(const JsonString &value);
 
   // Child classes can hook in here to extend the schema.
   virtual void ExtendSchema(JsonObject *schema) const {
@@ -703,8 +705,6 @@ class ArrayValidator : public BaseValidator {
   void Visit(const JsonArray &array);
 
  private:
-  typedef std::deque<ValidatorInterface*> ValidatorQueue;
-
   const std::auto_ptr<Items> m_items;
   const std::auto_ptr<AdditionalItems> m_additional_items;
   const Options m_options;
@@ -712,35 +712,14 @@ class ArrayValidator : public BaseValidator {
   // This is used if items is missing, or if additionalItems is true.
   std::auto_ptr<WildcardValidator> m_wildcard_validator;
 
-  class ArrayElementValidator : public BaseValidator {
-   public:
-    ArrayElementValidator(const ValidatorList &validators,
-                          ValidatorInterface *default_validator);
-
-    void Visit(const JsonString&);
-    void Visit(const JsonBool&);
-    void Visit(const JsonNull&);
-    void Visit(const JsonRawValue&);
-    void Visit(const JsonObject&);
-    void Visit(const JsonArray &array);
-    void Visit(const JsonUInt&);
-    void Visit(const JsonUInt64&);
-    void Visit(const JsonInt&);
-    void Visit(const JsonInt64&);
-    void Visit(const JsonDouble&);
-
-   private:
-    ValidatorQueue m_item_validators;
-    ValidatorInterface *m_default_validator;
-
-    template <typename T>
-    void ValidateItem(const T &item);
-
-    DISALLOW_COPY_AND_ASSIGN(ArrayElementValidator);
-  };
+  // The validators for the leading elements, if items is an array, and the
+  // validator for the rest, which is NULL if additional items aren't allowed.
+  // These are worked out once, rather than on each Visit().
+  ValidatorList m_item_validators;
+  ValidatorInterface *m_default_item_validator;
 
   void ExtendSchema(JsonObject *schema) const;
-  ArrayElementValidator* ConstructElementValidator() const;
+  void SetupItemValidators();
 
   DISALLOW_COPY_AND_ASSIGN(ArrayValidator);
 };
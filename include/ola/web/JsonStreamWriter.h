@@ -0,0 +1,168 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonStreamWriter.h
+ * Write JSON text without building a tree of JsonValues.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup json
+ * @{
+ * @file JsonStreamWriter.h
+ * @brief Write JSON text without building a tree of JsonValues.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_WEB_JSONSTREAMWRITER_H_
+#define INCLUDE_OLA_WEB_JSONSTREAMWRITER_H_
+
+#include <ola/base/Macro.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace web {
+
+/**
+ * @addtogroup json
+ * @{
+ */
+
+/**
+ * @brief Write JSON text as the values are added.
+ *
+ * JsonWriter needs the whole document as a tree of JsonValues, which is slow
+ * for large responses. JsonStreamWriter appends each value to a string as
+ * it's added, without any whitespace.
+ *
+ * @examplepara
+ * @code
+ *   JsonStreamWriter writer;
+ *   writer.StartObject();
+ *   writer.Add("universe", 1);
+ *   writer.StartArray("uids");
+ *   writer.Value("7a70:00000001");
+ *   writer.EndArray();
+ *   writer.EndObject();
+ *   // writer.AsString() is {"universe":1,"uids":["7a70:00000001"]}
+ * @endcode
+ *
+ * Strings are escaped in the same way as JsonWriter. The caller is
+ * responsible for calling the methods in an order that produces valid JSON,
+ * i.e. each value in an object must be preceded by a Key().
+ */
+class JsonStreamWriter {
+ public:
+  JsonStreamWriter();
+
+  /**
+   * @brief Start a new object.
+   */
+  void StartObject();
+
+  /**
+   * @brief Start a new object as a member of the current object.
+   * @param key the name of the member.
+   */
+  void StartObject(const std::string &key);
+
+  /**
+   * @brief End the current object.
+   */
+  void EndObject();
+
+  /**
+   * @brief Start a new array.
+   */
+  void StartArray();
+
+  /**
+   * @brief Start a new array as a member of the current object.
+   * @param key the name of the member.
+   */
+  void StartArray(const std::string &key);
+
+  /**
+   * @brief End the current array.
+   */
+  void EndArray();
+
+  /**
+   * @brief Write the name of the next member of the current object.
+   * @param key the name of the member.
+   */
+  void Key(const std::string &key);
+
+  /**
+   * @name Values
+   * @{
+   */
+  void Value(const std::string &value);
+  void Value(const char *value);
+  void Value(bool value);
+  void Value(int value);
+  void Value(unsigned int value);
+  void Value(int64_t value);
+  void Value(uint64_t value);
+  void Null();
+
+  /**
+   * @brief Write a value that is already JSON text.
+   */
+  void Raw(const std::string &value);
+  /**
+   * @}
+   */
+
+  /**
+   * @brief Add a member to the current object.
+   * @param key the name of the member.
+   * @param value the value of the member.
+   */
+  template <typename T>
+  void Add(const std::string &key, const T &value) {
+    Key(key);
+    Value(value);
+  }
+
+  /**
+   * @brief Return the JSON text written so far.
+   */
+  const std::string &AsString() const { return m_output; }
+
+  /**
+   * @brief Remove everything that has been written.
+   */
+  void Reset();
+
+ private:
+  std::string m_output;
+  // One entry for each open object or array, true if a value has been
+  // written at that level.
+  std::vector<bool> m_has_values;
+  bool m_after_key;
+
+  void StartValue();
+  void WriteString(const std::string &value);
+  void WriteUnsigned(uint64_t value, bool negative);
+
+  DISALLOW_COPY_AND_ASSIGN(JsonStreamWriter);
+};
+/**@}*/
+}  // namespace web
+}  // namespace ola
+#endif  // INCLUDE_OLA_WEB_JSONSTREAMWRITER_H_
@@ -9,6 +9,7 @@ olawebinclude_HEADERS = \
     include/ola/web/JsonPointer.h \
     include/ola/web/JsonSchema.h \
     include/ola/web/JsonSections.h \
+    include/ola/web/JsonStreamWriter.h \
     include/ola/web/JsonTypes.h \
     include/ola/web/JsonWriter.h \
     include/ola/web/OptionalItem.h
@@ -38,7 +38,10 @@ class DmxSource {
     DmxSource():
         m_buffer(),
         m_timestamp(),
-        m_priority(ola::dmx::SOURCE_PRIORITY_MIN) {
+        m_priority(ola::dmx::SOURCE_PRIORITY_MIN),
+        m_changed_start(0),
+        m_changed_end(0),
+        m_size_changed(true) {
     }
 
     DmxSource(const DmxBuffer &buffer,
@@ -46,13 +49,33 @@ class DmxSource {
               uint8_t priority):
         m_buffer(buffer),
         m_timestamp(timestamp),
-        m_priority(priority) {
+        m_priority(priority),
+        m_changed_start(0),
+        m_changed_end(buffer.Size()),
+        m_size_changed(true) {
+    }
+
+    DmxSource(const DmxBuffer &buffer,
+              const TimeStamp &timestamp,
+              uint8_t priority,
+              const DmxBuffer &slot_priorities):
+        m_buffer(buffer),
+        m_slot_priorities(slot_priorities),
+        m_timestamp(timestamp),
+        m_priority(priority),
+        m_changed_start(0),
+        m_changed_end(buffer.Size()),
+        m_size_changed(true) {
     }
 
     DmxSource(const DmxSource &other) {
       m_buffer = other.m_buffer;
+      m_slot_priorities = other.m_slot_priorities;
       m_timestamp = other.m_timestamp;
       m_priority = other.m_priority;
+      m_changed_start = other.m_changed_start;
+      m_changed_end = other.m_changed_end;
+      m_size_changed = other.m_size_changed;
     }
 
 
@@ -62,8 +85,12 @@ class DmxSource {
     DmxSource& operator=(const DmxSource& other) {
       if (this != &other) {
         m_buffer = other.m_buffer;
+        m_slot_priorities = other.m_slot_priorities;
         m_timestamp = other.m_timestamp;
         m_priority = other.m_priority;
+        m_changed_start = other.m_changed_start;
+        m_changed_end = other.m_changed_end;
+        m_size_changed = other.m_size_changed;
       }
       return *this;
     }
@@ -73,20 +100,21 @@ class DmxSource {
      */
     bool operator==(const DmxSource &other) const {
       return (m_buffer == other.m_buffer &&
+              m_slot_priorities == other.m_slot_priorities &&
               m_timestamp == other.m_timestamp &&
               m_priority == other.m_priority);
     }
 
 
     /*
-     * Update the DmxSource with new data
+     * Update the DmxSource with new data. This also records the range of slots
+     * that differ from the previous data, see ChangedStart() & ChangedEnd().
+     * An empty slot_priorities buffer means the source priority applies to all
+     * slots.
      */
     void UpdateData(const DmxBuffer &buffer, const TimeStamp &timestamp,
-                    uint8_t priority) {
-      m_buffer = buffer;
-      m_timestamp = timestamp;
-      m_priority = priority;
-    }
+                    uint8_t priority,
+                    const DmxBuffer &slot_priorities = DmxBuffer());
 
 
     /*
@@ -123,10 +151,48 @@ class DmxSource {
      */
     uint8_t Priority() const { return m_priority; }
 
+
+    /*
+     * Check if this source has per-slot priorities.
+     */
+    bool HasSlotPriorities() const { return m_slot_priorities.Size() > 0; }
+
+
+    /*
+     * Get the per-slot priorities, as sent with the E1.31 0xDD start code. A
+     * slot priority of 0 means the slot isn't sourced, any slots past the end
+     * of the priorities also aren't sourced.
+     */
+    const DmxBuffer &SlotPriorities() const { return m_slot_priorities; }
+
+
+    /*
+     * The first slot that changed in the last update.
+     */
+    unsigned int ChangedStart() const { return m_changed_start; }
+
+
+    /*
+     * One past the last slot that changed in the last update. If this is equal
+     * to ChangedStart() the last update didn't change any slot values.
+     */
+    unsigned int ChangedEnd() const { return m_changed_end; }
+
+
+    /*
+     * Check if the last update changed the number of slots. In this case the
+     * changed range covers all slots of both the old & new data.
+     */
+    bool SizeChanged() const { return m_size_changed; }
+
  private:
     DmxBuffer m_buffer;
+    DmxBuffer m_slot_priorities;
     TimeStamp m_timestamp;
     uint8_t m_priority;
+    unsigned int m_changed_start;
+    unsigned int m_changed_end;
+    bool m_size_changed;
 
     static const TimeInterval TIMEOUT_INTERVAL;
 };
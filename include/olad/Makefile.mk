@@ -8,4 +8,5 @@ oladinclude_HEADERS = \
     include/olad/PortConstants.h \
     include/olad/Preferences.h \
     include/olad/TokenBucket.h \
+    include/olad/UDPReceivePreferences.h \
     include/olad/Universe.h
@@ -149,6 +149,9 @@ class Plugin: public AbstractPlugin {
     return Id() < other.Id();
   }
 
+  // The preference key for the enabled state.
+  static const char ENABLED_KEY[];
+
  protected:
   virtual bool StartHook() { return 0; }
   virtual bool StopHook() { return 0; }
@@ -160,7 +163,6 @@ class Plugin: public AbstractPlugin {
 
   PluginAdaptor *m_plugin_adaptor;
   class Preferences *m_preferences;  // preferences container
-  static const char ENABLED_KEY[];
 
  private:
   bool m_enabled;  // are we running
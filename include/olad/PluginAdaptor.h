@@ -32,8 +32,11 @@
 #include <ola/ExportMap.h>
 #include <ola/base/Macro.h>
 #include <ola/io/SelectServerInterface.h>
+#include <ola/network/Interface.h>
+#include <ola/network/XDPReceiver.h>
 #include <olad/OlaServer.h>
 
+#include <map>
 #include <string>
 
 namespace ola {
@@ -55,6 +58,7 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
                 class PreferencesFactory *preferences_factory,
                 class PortBrokerInterface *port_broker,
                 const std::string *instance_name);
+  ~PluginAdaptor();
 
   // The following methods are part of the SelectServerInterface
   bool AddReadDescriptor(ola::io::ReadFileDescriptor *descriptor);
@@ -125,6 +129,20 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
     return m_port_broker;
   }
 
+  /**
+   * @brief Get the AF_XDP receiver for an interface, creating it if needed.
+   * @param iface the interface to receive on.
+   * @param queue_id the NIC queue to attach to.
+   * @return the XDPReceiver, or NULL if AF_XDP isn't available, in which case
+   *   the plugin should carry on with its sockets.
+   *
+   * The receiver is shared by the plugins using the interface, and lasts until
+   * the PluginAdaptor is destroyed.
+   */
+  ola::network::XDPReceiver *GetXDPReceiver(
+      const ola::network::Interface &iface,
+      unsigned int queue_id);
+
   void DrainCallbacks();
 
  private:
@@ -134,6 +152,7 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
   class PreferencesFactory *m_preferences_factory;
   class PortBrokerInterface *m_port_broker;
   const std::string *m_instance_name;
+  std::map<int32_t, ola::network::XDPReceiver*> m_xdp_receivers;
 
   DISALLOW_COPY_AND_ASSIGN(PluginAdaptor);
 };
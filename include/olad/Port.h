@@ -23,6 +23,7 @@
 
 #include <ola/DmxBuffer.h>
 #include <ola/base/Macro.h>
+#include <ola/dmx/SlotRemap.h>
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/timecode/TimeCode.h>
@@ -93,6 +94,14 @@ class Port {
    */
   virtual std::string UniqueId() const = 0;
 
+  /**
+   * @brief Get the universe to patch this Port to if there isn't a saved
+   *   patching.
+   * @param[out] universe the universe to patch to.
+   * @returns true if there is a default universe, false otherwise.
+   */
+  virtual bool DefaultUniverse(unsigned int *universe) const = 0;
+
   /**
    * @brief Get the priority capabilities for this port.
    * @returns a port_priority_capability.
@@ -128,6 +137,18 @@ class Port {
    * @returns true if RDM is supported for this Port, false otherwise.
    */
   virtual bool SupportsRDM() const = 0;
+
+  /**
+   * @brief Set the slot remap for this Port.
+   * @param remap the remap to apply to the data passing through this Port. An
+   *   empty remap passes the data through unchanged.
+   */
+  virtual void SetSlotRemap(const ola::dmx::SlotRemap &remap) = 0;
+
+  /**
+   * @brief Get the slot remap for this Port.
+   */
+  virtual const ola::dmx::SlotRemap &GetSlotRemap() const = 0;
 };
 
 
@@ -169,14 +190,58 @@ class OutputPort: public Port, ola::rdm::DiscoverableRDMControllerInterface {
    * @param buffer the DmxBuffer to write
    * @param priority the priority of the DMX data
    * @return true on success, false on failure
+   *
+   * The same buffer is passed to every output port in the universe. Ports
+   * that only need the data until this returns should read it in place, for
+   * example with DmxBuffer::View(), rather than taking a copy.
    */
   virtual bool WriteDMX(const DmxBuffer &buffer, uint8_t priority) = 0;
 
+  /**
+   * @brief Called before a batch of writes.
+   *
+   * When olad runs a frame clock, all universes that changed since the last
+   * tick are written together. BeginBatch() is called on every output port in
+   * those universes before any of the WriteDMX() calls, and EndBatch() is
+   * called once they have all been made. Ports can use this to send sync
+   * packets or to combine the writes.
+   */
+  virtual void BeginBatch() = 0;
+
+  /**
+   * @brief Called after a batch of writes.
+   * @sa BeginBatch()
+   */
+  virtual void EndBatch() = 0;
+
   /**
    * @brief Called if the universe name changes
    */
   virtual void UniverseNameChanged(const std::string &new_name) = 0;
 
+  /**
+   * @brief Limit the rate that DMX data is written to this port.
+   * @param max_rate the maximum number of frames per second, 0 means there is
+   *   no limit.
+   * @param max_burst the number of frames that may be sent back to back
+   *   before the rate applies, 0 is treated as 1.
+   *
+   * This is for receivers that drop frames above a certain rate. Frames above
+   * the rate are held back and the latest one is sent once the rate allows,
+   * so the final frame is never lost.
+   */
+  virtual void SetRateLimit(unsigned int max_rate, unsigned int max_burst) = 0;
+
+  /**
+   * @brief Return the maximum frames per second, or 0 if there is no limit.
+   */
+  virtual unsigned int MaxRate() const = 0;
+
+  /**
+   * @brief Return the number of frames that can be sent back to back.
+   */
+  virtual unsigned int MaxBurst() const = 0;
+
   // Methods from DiscoverableRDMControllerInterface
   // Ownership of the request object is transferred
   virtual void SendRDMRequest(ola::rdm::RDMRequest *request,
@@ -215,6 +280,8 @@ class BasicInputPort: public InputPort {
   uint8_t GetPriority() const { return m_priority; }
   void SetPriorityMode(port_priority_mode mode) { m_priority_mode = mode; }
   port_priority_mode GetPriorityMode() const { return m_priority_mode; }
+  void SetSlotRemap(const ola::dmx::SlotRemap &remap) { m_slot_remap = remap; }
+  const ola::dmx::SlotRemap &GetSlotRemap() const { return m_slot_remap; }
 
   /**
    * @brief Called when there is new data for this port
@@ -250,11 +317,18 @@ class BasicInputPort: public InputPort {
     return ola::dmx::SOURCE_PRIORITY_MIN;
   }
 
+  // Get the inherited per-slot priorities, or NULL if there aren't any. Like
+  // InheritedPriority() these are only used in PRIORITY_MODE_INHERIT.
+  virtual const DmxBuffer *InheritedSlotPriorities() const { return NULL; }
+
   // override this to cancel the SetUniverse operation.
   virtual bool PreSetUniverse(Universe *, Universe *) { return true; }
 
   virtual void PostSetUniverse(Universe *, Universe *) {}
 
+  // Ports aren't patched unless there is a saved patching.
+  virtual bool DefaultUniverse(unsigned int *) const { return false; }
+
   virtual bool SupportsRDM() const { return m_supports_rdm; }
 
  protected:
@@ -271,6 +345,9 @@ class BasicInputPort: public InputPort {
   DmxSource m_dmx_source;
   const PluginAdaptor *m_plugin_adaptor;
   bool m_supports_rdm;
+  ola::dmx::SlotRemap m_slot_remap;
+  DmxBuffer m_remapped_data;
+  DmxBuffer m_remapped_priorities;
 
   DISALLOW_COPY_AND_ASSIGN(BasicInputPort);
 };
@@ -298,6 +375,15 @@ class BasicOutputPort: public OutputPort {
   uint8_t GetPriority() const { return m_priority; }
   void SetPriorityMode(port_priority_mode mode) { m_priority_mode = mode; }
   port_priority_mode GetPriorityMode() const { return m_priority_mode; }
+  void SetSlotRemap(const ola::dmx::SlotRemap &remap) { m_slot_remap = remap; }
+  const ola::dmx::SlotRemap &GetSlotRemap() const { return m_slot_remap; }
+
+  void SetRateLimit(unsigned int max_rate, unsigned int max_burst) {
+    m_max_rate = max_rate;
+    m_max_burst = max_burst;
+  }
+  unsigned int MaxRate() const { return m_max_rate; }
+  unsigned int MaxBurst() const { return m_max_burst; }
 
   virtual void UniverseNameChanged(const std::string &new_name) {
     (void) new_name;
@@ -324,6 +410,10 @@ class BasicOutputPort: public OutputPort {
   virtual void RunIncrementalDiscovery(
       ola::rdm::RDMDiscoveryCallback *on_complete);
 
+  // Batching, most ports don't need to do anything
+  virtual void BeginBatch() {}
+  virtual void EndBatch() {}
+
   // TimeCode
   virtual bool SupportsTimeCode() const { return false; }
 
@@ -338,6 +428,9 @@ class BasicOutputPort: public OutputPort {
   virtual bool PreSetUniverse(Universe *, Universe *) { return true; }
   virtual void PostSetUniverse(Universe *, Universe *) { }
 
+  // Ports aren't patched unless there is a saved patching.
+  virtual bool DefaultUniverse(unsigned int *) const { return false; }
+
   virtual bool SupportsRDM() const { return m_supports_rdm; }
 
  protected:
@@ -358,6 +451,9 @@ class BasicOutputPort: public OutputPort {
   Universe *m_universe;  // the universe this port belongs to
   AbstractDevice *m_device;
   bool m_supports_rdm;
+  ola::dmx::SlotRemap m_slot_remap;
+  unsigned int m_max_rate;
+  unsigned int m_max_burst;
 
   DISALLOW_COPY_AND_ASSIGN(BasicOutputPort);
 };
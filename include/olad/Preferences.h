@@ -23,7 +23,9 @@
 #define INCLUDE_OLAD_PREFERENCES_H_
 
 #include <ola/base/Macro.h>
+#include <ola/Clock.h>
 #include <ola/Logging.h>
+#include <ola/thread/Mutex.h>
 #include <ola/thread/Thread.h>
 #include <ola/io/SelectServer.h>
 
@@ -435,12 +437,24 @@ class MemoryPreferencesFactory: public PreferencesFactory {
 
 
 /**
- * The thread that saves preferences
+ * The thread that saves preferences.
+ *
+ * Saves are delayed by save_delay, and multiple saves of the same file within
+ * that time result in a single write of the latest preferences. Each file is
+ * written to a temporary file which is then renamed, so a crash never leaves
+ * a partially written file.
  */
 class FilePreferenceSaverThread: public ola::thread::Thread {
  public:
   typedef std::multimap<std::string, std::string> PreferencesMap;
-  FilePreferenceSaverThread();
+
+  /**
+   * @brief Create a new FilePreferenceSaverThread.
+   * @param save_delay how long to wait after a save is requested before
+   *   writing the file.
+   */
+  explicit FilePreferenceSaverThread(
+      const TimeInterval &save_delay = TimeInterval(1, 0));
 
   void SavePreferences(const std::string &filename,
                        const PreferencesMap &preferences);
@@ -463,7 +477,16 @@ class FilePreferenceSaverThread: public ola::thread::Thread {
   void Syncronize();
 
  private:
+  typedef std::map<std::string, PreferencesMap> PendingSaves;
+
   ola::io::SelectServer m_ss;
+  const TimeInterval m_save_delay;
+  // Protects m_pending_saves, which is keyed by filename.
+  ola::thread::Mutex m_pending_mutex;
+  PendingSaves m_pending_saves;
+
+  void ScheduleSave();
+  void WritePendingSaves();
 
   /**
    * Notify the blocked thread we're done
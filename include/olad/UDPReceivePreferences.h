@@ -0,0 +1,68 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UDPReceivePreferences.h
+ * Preferences shared by the plugins that receive UDP.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLAD_UDPRECEIVEPREFERENCES_H_
+#define INCLUDE_OLAD_UDPRECEIVEPREFERENCES_H_
+
+#include <ola/network/UDPReceiveStats.h>
+#include <string>
+
+namespace ola {
+
+class ExportMap;
+class Preferences;
+
+/**
+ * @brief Set the defaults for the udp_timestamps, udp_min_recv_buffer and
+ * udp_max_recv_buffer preferences.
+ * @param preferences the plugin's preferences.
+ * @returns true if any of the preferences were changed.
+ */
+bool SetDefaultUDPReceivePreferences(Preferences *preferences);
+
+/**
+ * @brief Build the UDPReceiveOptions from a plugin's preferences.
+ * @param preferences the plugin's preferences.
+ * @param export_map the ExportMap to export the stats to, may be NULL.
+ * @param export_key the key to export the stats under, e.g. the protocol name.
+ * @param[out] options the UDPReceiveOptions to populate.
+ */
+void ReadUDPReceivePreferences(const Preferences &preferences,
+                               ExportMap *export_map,
+                               const std::string &export_key,
+                               ola::network::UDPReceiveOptions *options);
+
+/**
+ * @brief Set the defaults for the network_engine and xdp_queue preferences.
+ * @param preferences the plugin's preferences.
+ * @returns true if any of the preferences were changed.
+ */
+bool SetDefaultNetworkEnginePreferences(Preferences *preferences);
+
+/**
+ * @brief Check if a plugin should receive with AF_XDP.
+ * @param preferences the plugin's preferences.
+ * @param[out] queue_id the NIC queue to attach to.
+ * @returns true if network_engine is set to xdp.
+ */
+bool ReadNetworkEnginePreferences(const Preferences &preferences,
+                                  unsigned int *queue_id);
+}  // namespace ola
+#endif  // INCLUDE_OLAD_UDPRECEIVEPREFERENCES_H_
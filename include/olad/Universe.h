@@ -29,8 +29,10 @@
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/UID.h>
 #include <ola/rdm/UIDSet.h>
+#include <ola/util/Histogram.h>
 #include <olad/DmxSource.h>
 
+#include <memory>
 #include <set>
 #include <map>
 #include <vector>
@@ -39,8 +41,14 @@
 namespace ola {
 
 class Client;
+class DiscoveryScheduler;
 class InputPort;
 class OutputPort;
+class OutputScheduler;
+class OutputRateLimiter;
+class RDMResponseCache;
+class SlotSubscriptions;
+class UniversePublisher;
 
 class Universe: public ola::rdm::RDMControllerInterface {
  public:
@@ -49,6 +57,74 @@ class Universe: public ola::rdm::RDMControllerInterface {
       MERGE_LTP
     };
 
+    /**
+     * @brief A layer of a virtual universe.
+     *
+     * The data from the layer's universe is blended onto the universe, with
+     * a weight of mask * opacity / 255 for each slot.
+     */
+    struct Layer {
+     public:
+      Layer() : universe(0), opacity(255) {}
+
+      // The universe to take the data from.
+      unsigned int universe;
+      uint8_t opacity;
+      // The per-slot mask. If this is empty, all slots of the source are
+      // blended, otherwise only the slots covered by the mask are.
+      DmxBuffer mask;
+    };
+
+    /**
+     * @brief A range of slots a client is watching.
+     * @sa AddSlotSubscription()
+     */
+    struct SlotRange {
+     public:
+      SlotRange() : start(0), count(0), threshold(1) {}
+
+      // The 0-based first slot.
+      uint16_t start;
+      uint16_t count;
+      // The change from the last value sent needed to send the slot again.
+      uint8_t threshold;
+    };
+
+    /**
+     * @brief Counters for monitoring a universe.
+     *
+     * These are kept whether or not there is an ExportMap, so monitoring
+     * tools can poll them without receiving the DMX data.
+     */
+    struct Stats {
+     public:
+      Stats()
+          : frames(0),
+            merges(0),
+            input_ports(0),
+            source_clients(0),
+            active_sources(0),
+            latency_samples(0),
+            latency_p50(0),
+            latency_p99(0),
+            latency_p999(0) {
+      }
+
+      // The number of frames written to the outputs & sink clients.
+      uint64_t frames;
+      // The number of times the sources were merged.
+      uint64_t merges;
+      unsigned int input_ports;
+      unsigned int source_clients;
+      // The sources at the active priority in the last merge.
+      unsigned int active_sources;
+      // The source to output latency, in microseconds.
+      uint64_t latency_samples;
+      uint32_t latency_p50;
+      uint32_t latency_p99;
+      uint32_t latency_p999;
+    };
+
     Universe(unsigned int uid, class UniverseStore *store,
              ExportMap *export_map,
              Clock *clock);
@@ -88,9 +164,154 @@ class Universe: public ola::rdm::RDMControllerInterface {
       m_rdm_discovery_interval = discovery_interval;
     }
 
+    /**
+     * @brief Return the minimum time between writes to the outputs.
+     */
+    const TimeInterval& OutputInterval() const { return m_output_interval; }
+
+    /**
+     * @brief Set the minimum time between writes to the output ports & sink
+     * clients.
+     * @param interval the minimum interval, zero means every change is
+     *   written. This only takes effect if there is an OutputScheduler.
+     */
+    void SetOutputInterval(const TimeInterval &interval) {
+      m_output_interval = interval;
+    }
+
+    /**
+     * @brief Return the keepalive interval for unchanged data.
+     */
+    const TimeInterval& OutputKeepalive() const { return m_output_keepalive; }
+
+    /**
+     * @brief Suppress writes of unchanged data.
+     * @param interval if non-zero, data that is identical to the last write
+     *   is only written again once this much time has passed since that
+     *   write. Zero writes every update, which is the default.
+     */
+    void SetOutputKeepalive(const TimeInterval &interval);
+
+    /**
+     * @brief Check if writes to the output ports are held.
+     */
+    bool OutputHeld() const { return m_output_held; }
+
+    /**
+     * @brief Hold the writes to the output ports.
+     * @param hold if true, the universe keeps merging its sources and writing
+     *   to the sink clients, but the output ports aren't written. Releasing
+     *   the hold writes the current data to the output ports.
+     */
+    void SetOutputHold(bool hold);
+
+    /**
+     * @brief Set the OutputScheduler used to coalesce writes.
+     * @param scheduler the scheduler to use, or NULL to write every change.
+     */
+    void SetOutputScheduler(OutputScheduler *scheduler);
+
+    /**
+     * @brief Set the DiscoveryScheduler used to run RDM discovery.
+     * @param scheduler the scheduler to use, or NULL to run discovery on the
+     *   ports directly.
+     */
+    void SetDiscoveryScheduler(DiscoveryScheduler *scheduler);
+
+    /**
+     * @brief Set the RDMResponseCache used to answer RDM GETs.
+     * @param cache the cache to use, or NULL to send every request to the
+     *   devices.
+     */
+    void SetRDMResponseCache(RDMResponseCache *cache);
+
+    /**
+     * @brief Set the Clock used for the checks made on every update, i.e.
+     *   which sources are active and whether unchanged data is due to be
+     *   written again.
+     * @param clock a Clock that may return a slightly stale time, such as a
+     *   CachedClock, or NULL to use the universe's own Clock.
+     */
+    void SetLoopClock(Clock *clock);
+
+    /**
+     * @brief Set the OutputRateLimiter used for ports with a rate limit.
+     * @param limiter the limiter to use, or NULL to ignore the port rate
+     *   limits.
+     */
+    void SetOutputRateLimiter(OutputRateLimiter *limiter);
+
+    /**
+     * @brief Set the UniversePublisher the output is published to.
+     * @param publisher the publisher to use, or NULL to stop publishing.
+     */
+    void SetUniversePublisher(UniversePublisher *publisher) {
+      m_publisher = publisher;
+    }
+
+    /**
+     * @brief Write the current data to the output ports & sink clients.
+     *
+     * This is called by the OutputScheduler when a deferred write is due.
+     */
+    void FlushOutput();
+
+    /**
+     * @brief Run the merge that was deferred until the next frame.
+     * @returns true if the data changed and should be written.
+     *
+     * If the OutputScheduler defers merging, this is called before
+     * FlushOutput(), possibly on one of the scheduler's merge threads.
+     */
+    bool RunPendingMerge();
+
+    /**
+     * @brief Free the scratch buffers if the universe is idle.
+     * @returns true if no data was written since the last call, in which case
+     *   the buffers were freed.
+     *
+     * This should be called periodically. The buffers are allocated again
+     * the next time they're needed.
+     */
+    bool ReleaseIdleBuffers();
+
     // Each universe has a DMXBuffer
     bool SetDMX(const DmxBuffer &buffer);
-    const DmxBuffer &GetDMX() const { return m_buffer; }
+    /**
+     * @brief The current data, including any layers.
+     */
+    const DmxBuffer &GetDMX() const {
+      return m_layers.empty() ? m_buffer : m_composite;
+    }
+
+    /**
+     * @brief Set the layers that are blended onto the merged data.
+     * @param layers the layers, in the order they are applied. An empty list
+     *   makes this a plain universe again.
+     *
+     * A universe with layers is a virtual universe. Its data is the merge of
+     * its own sources, which may be nothing, with each layer blended on top.
+     * The layers are only composited again when the merged data or one of the
+     * layer universes changes.
+     *
+     * This should be called via UniverseStore::SetLayers(), which keeps track
+     * of the universes each layer depends on and rejects cycles.
+     */
+    void SetLayers(const std::vector<Layer> &layers);
+
+    const std::vector<Layer> &Layers() const { return m_layers; }
+
+    /**
+     * @brief Called when the data in one of the layer universes changes.
+     */
+    void LayerInputChanged();
+
+    /**
+     * The per-slot priorities of the merged data. This is empty unless one of
+     * the sources provided per-slot priorities. A slot priority of 0 means no
+     * source provided that slot.
+     */
+    const DmxBuffer &GetSlotPriorities() const { return m_slot_priorities; }
 
     // These are the ports we need to nofity when data changes
     bool AddPort(InputPort *port);
@@ -116,28 +337,106 @@ class Universe: public ola::rdm::RDMControllerInterface {
     bool ContainsSinkClient(Client *client) const;
     unsigned int SinkClientCount() const { return m_sink_clients.size(); }
 
+    /**
+     * @brief Send a client the changes to some slots of this universe.
+     * @param client the client to send the changes to.
+     * @param ranges the slots to watch, each range must be within the
+     *   universe. This replaces any existing ranges for the client.
+     *
+     * The new data is compared with the previous data once per update, and
+     * each subscribed client is sent just the (slot, value) pairs in its
+     * ranges which have changed by at least the threshold. The current values
+     * are sent straight away.
+     */
+    void AddSlotSubscription(Client *client,
+                             const std::vector<SlotRange> &ranges);
+    bool RemoveSlotSubscription(Client *client);
+
     // These are called when new data arrives on a port/client
     bool PortDataChanged(InputPort *port);
     bool SourceClientDataChanged(Client *client);
 
-    // This is can be called periodically to clean stale clients
-    //    stale == client that has not sent data
-    void CleanStaleSourceClients();
+    /**
+     * @brief Fade the data from a source client to new values.
+     * @param client the client providing the data.
+     * @param target the data to fade to.
+     * @param duration how long the fade should take.
+     * @returns true if the fade was started.
+     *
+     * The client's data moves from its current values to the target on each
+     * tick of the OutputScheduler. If there is no OutputScheduler, or the
+     * duration is zero, the target is used straight away. New data from the
+     * client, with SourceClientDataChanged(), cancels the fade.
+     */
+    bool FadeSourceClient(Client *client, const DmxSource &target,
+                          const TimeInterval &duration);
+
+    /**
+     * @brief Run one step of the fades in progress.
+     * @param now the time of this step.
+     * @returns true if there are still fades in progress.
+     *
+     * This is called by the OutputScheduler.
+     */
+    bool RunFades(const TimeStamp &now);
+
+    /**
+     * @brief Check if a source client has gone stale.
+     * @param client the client to check.
+     * @param serial the serial number the UniverseStore gave the client when
+     *   it was added.
+     * @param generation the current generation of stale client checks.
+     * @returns the generation at which the client should be checked again,
+     *   or 0 if the client was removed or is no longer part of this universe.
+     *
+     * A client is stale if it hasn't sent data since the previous check. This
+     * is called by UniverseStore::CleanStaleSourceClients().
+     */
+    unsigned int CheckSourceClient(Client *client, unsigned int serial,
+                                   unsigned int generation);
 
     // RDM methods
     void SendRDMRequest(ola::rdm::RDMRequest *request,
                         ola::rdm::RDMCallback *callback);
     void RunRDMDiscovery(ola::rdm::RDMDiscoveryCallback *on_complete,
                          bool full = true);
+
+    /**
+     * @brief Run RDM discovery on a single output port.
+     * @param port the port to run discovery on.
+     * @param full true for full discovery, false for incremental.
+     * @param on_complete run with the UIDs found on the port.
+     *
+     * This goes through the DiscoveryScheduler, if there is one. The UID map
+     * isn't updated, that's left to the callback.
+     */
+    void RunPortDiscovery(OutputPort *port, bool full,
+                          ola::rdm::RDMDiscoveryCallback *on_complete);
     void NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids);
     void GetUIDs(ola::rdm::UIDSet *uids) const;
     unsigned int UIDCount() const;
 
+    /**
+     * @brief Get the counters for this universe.
+     * @param stats the Stats to fill in.
+     *
+     * The latency percentiles are worked out on each call, so this shouldn't
+     * be called for every frame.
+     */
+    void GetStats(Stats *stats) const;
+
     bool operator==(const Universe &other) {
       return m_universe_id == other.UniverseId();
     }
 
     static const char K_FPS_VAR[];
+    static const char K_LATENCY_VAR[];
+    static const char K_LATENCY_P50_VAR[];
+    static const char K_LATENCY_P99_VAR[];
+    static const char K_LATENCY_P999_VAR[];
+    static const char K_OUTPUT_COALESCED_VAR[];
+    static const char K_OUTPUT_DEFERRED_VAR[];
+    static const char K_OUTPUT_SUPPRESSED_VAR[];
     static const char K_MERGE_HTP_STR[];
     static const char K_MERGE_LTP_STR[];
     static const char K_UNIVERSE_INPUT_PORT_VAR[];
@@ -158,7 +457,49 @@ class Universe: public ola::rdm::RDMControllerInterface {
       std::vector<rdm::RDMFrame> frames;
     } broadcast_request_tracker;
 
-    typedef std::map<Client*, bool> SourceClientMap;
+    typedef struct {
+      unsigned int last_seen;
+      unsigned int serial;
+    } SourceClientState;
+
+    // An entry in the RDM routing table.
+    struct UIDRoute {
+      UIDRoute(const ola::rdm::UID &_uid, OutputPort *_port)
+          : uid(_uid),
+            port(_port) {
+      }
+      ola::rdm::UID uid;
+      OutputPort *port;
+    };
+
+    // Sorted by UID.
+    typedef std::vector<UIDRoute> UIDRoutes;
+
+    static bool RouteBefore(const UIDRoute &route, const ola::rdm::UID &uid) {
+      return route.uid < uid;
+    }
+
+    typedef std::map<Client*, SourceClientState> SourceClientMap;
+
+    // An entry in the fan-out list, exactly one of port & client is set.
+    typedef struct {
+      OutputPort *port;
+      Client *client;
+    } Destination;
+
+    typedef struct {
+      DmxBuffer start;
+      DmxBuffer target;
+      DmxBuffer slot_priorities;
+      uint8_t priority;
+      TimeStamp start_time;
+      TimeInterval duration;
+    } Fade;
+
+    typedef std::map<Client*, Fade> FadeMap;
+
+    // How often the latency percentiles are updated in the export map.
+    static const unsigned int LATENCY_EXPORT_SAMPLES = 64;
 
     std::string m_universe_name;
     unsigned int m_universe_id;
@@ -168,33 +509,141 @@ class Universe: public ola::rdm::RDMControllerInterface {
     std::vector<InputPort*> m_input_ports;
     std::vector<OutputPort*> m_output_ports;
     std::set<Client*> m_sink_clients;  // clients that require updates
+    // The output ports, grouped by plugin, followed by the sink clients.
+    // This is rebuilt whenever the patching changes.
+    std::vector<Destination> m_fanout;
+    DmxBuffer m_remapped_buffer;  // used for ports with a slot remap
     /**
-     * Tracks current source clients and whether or not they are stale.
-     * true == stale and can be removed, false == active is to be kept
+     * Tracks current source clients, and the generation of stale client
+     * checks in which they last sent data.
      */
     SourceClientMap m_source_clients;
     class UniverseStore *m_universe_store;
     DmxBuffer m_buffer;
+    DmxBuffer m_slot_priorities;
     ExportMap *m_export_map;
-    std::map<ola::rdm::UID, OutputPort*> m_output_uids;
+    UIDRoutes m_output_uids;
+    // Reused by NewUIDList() to build the new routing table.
+    UIDRoutes m_new_output_uids;
+    // Trackers from completed broadcast requests, ready for reuse.
+    std::vector<broadcast_request_tracker*> m_free_trackers;
     Clock *m_clock;
+    Clock *m_loop_clock;
     TimeInterval m_rdm_discovery_interval;
     TimeStamp m_last_discovery_time;
+    /**
+     * The sources that contributed to the last HTP merge. If the same set of
+     * sources is active when the next update arrives, only the slots that
+     * changed are re-merged.
+     */
+    std::vector<const InputPort*> m_merged_ports;
+    std::vector<const Client*> m_merged_clients;
+    bool m_htp_merge_valid;
+    /**
+     * Scratch space for MergeAll(). These keep their capacity between frames
+     * so that merging doesn't allocate memory.
+     */
+    std::vector<const DmxSource*> m_active_sources;
+    std::vector<const InputPort*> m_active_ports;
+    std::vector<const Client*> m_active_clients;
+    std::vector<const DmxBuffer*> m_merge_buffers;
+    unsigned int *m_frames_var;
+    unsigned int *m_output_deferred_var;
+    unsigned int *m_output_coalesced_var;
+    OutputScheduler *m_output_scheduler;
+    DiscoveryScheduler *m_discovery_scheduler;
+    RDMResponseCache *m_rdm_response_cache;
+    OutputRateLimiter *m_rate_limiter;
+    UniversePublisher *m_publisher;
+    TimeInterval m_output_interval;
+    /**
+     * The last data written, used to suppress unchanged writes if
+     * m_output_keepalive is set.
+     */
+    TimeInterval m_output_keepalive;
+    DmxBuffer m_last_output;
+    uint8_t m_last_output_priority;
+    TimeStamp m_last_output_time;
+    unsigned int *m_output_suppressed_var;
+    bool m_output_held;
+    FadeMap m_fades;
+    DmxBuffer m_fade_frame;
+    /**
+     * The layers of a virtual universe, and the result of blending them onto
+     * m_buffer. m_composite is only rebuilt when m_layers_dirty is set.
+     */
+    std::vector<Layer> m_layers;
+    DmxBuffer m_composite;
+    bool m_layers_dirty;
+    // NULL unless a client is watching slots of this universe.
+    SlotSubscriptions *m_slot_subscriptions;
+    /**
+     * The source changes waiting for RunPendingMerge(). If there is only one
+     * change the merge can use the changed source, otherwise all sources are
+     * merged again.
+     */
+    const InputPort *m_pending_port;
+    const Client *m_pending_client;
+    unsigned int m_pending_merges;
+    bool m_pending_write;
+    uint64_t m_frame_count;
+    uint64_t m_merge_count;
+    unsigned int m_active_source_count;
+    /**
+     * The time the source data for the current merge was received. The
+     * latency from then until the data is written is recorded in m_latency.
+     */
+    TimeStamp m_ingress_time;
+    // Allocated when the first latency is recorded.
+    std::auto_ptr<Histogram> m_latency;
+    unsigned int m_latency_samples;
+    unsigned int *m_latency_p50_var;
+    unsigned int *m_latency_p99_var;
+    unsigned int *m_latency_p999_var;
+    /**
+     * The per-frame export map entries are only added once the universe
+     * first sends data, so idle universes don't pay for them.
+     */
+    bool m_output_stats;
+    bool m_written_since_release;
 
+    UIDRoutes::const_iterator FindRoute(const ola::rdm::UID &uid) const;
+    void RemoveRoutes(const OutputPort *port);
+    broadcast_request_tracker *NewBroadcastTracker();
+    void ReleaseBroadcastTracker(broadcast_request_tracker *tracker);
     void HandleBroadcastAck(broadcast_request_tracker *tracker,
                             ola::rdm::RDMReply *reply);
     void HandleBroadcastDiscovery(broadcast_request_tracker *tracker,
                                   ola::rdm::RDMReply *reply);
     bool UpdateDependants();
+    void WriteDependants();
+    void CompositeLayers();
+    void RebuildFanout();
+    void RecordLatency();
+    void InitOutputStats();
+    bool SuppressOutput();
     void UpdateName();
     void UpdateMode();
-    void HTPMergeSources(const std::vector<DmxSource> &sources);
-    bool MergeAll(const InputPort *port, const Client *client);
+    void HTPMergeSources(const std::vector<const DmxSource*> &sources);
+    void HTPMergeSlots(const std::vector<const DmxSource*> &sources,
+                       unsigned int start,
+                       unsigned int end);
+    void SlotPriorityMergeSources(const TimeStamp &now);
+    void SlotPriorityMergeSource(const DmxSource &source,
+                                 const TimeStamp &now,
+                                 uint8_t *data,
+                                 uint8_t *priorities,
+                                 unsigned int *length);
+    bool MergeAll(const InputPort *port, const Client *client,
+                  bool force = false);
+    bool DeferMerge(const InputPort *port, const Client *client);
+    void MergeSourceClient(Client *client);
     void PortDiscoveryComplete(BaseCallback0<void> *on_complete,
                                OutputPort *output_port,
                                const ola::rdm::UIDSet &uids);
     void DiscoveryComplete(ola::rdm::RDMDiscoveryCallback *on_complete);
 
+    unsigned int *UniverseHandle(const char *name);
     void SafeIncrement(const std::string &name);
     void SafeDecrement(const std::string &name);
 
@@ -204,8 +653,7 @@ class Universe: public ola::rdm::RDMControllerInterface {
 
     template<class PortClass>
     bool GenericRemovePort(PortClass *port,
-                          std::vector<PortClass*> *ports,
-                          std::map<ola::rdm::UID, PortClass*> *uid_map = NULL);
+                          std::vector<PortClass*> *ports);
 
     template<class PortClass>
     bool GenericContainsPort(PortClass *port,
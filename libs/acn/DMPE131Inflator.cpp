@@ -18,15 +18,22 @@
  * Copyright (C) 2007 Simon Newton
  */
 
-#include <sys/time.h>
+#include <string.h>
 #include <algorithm>
 #include <map>
 #include <memory>
 #include <vector>
+#include "common/dmx/HTPMerge.h"
+#include "ola/Constants.h"
 #include "ola/Logging.h"
+#include "ola/dmx/SourcePriorities.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/util/Utils.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/DMPHeader.h"
 #include "libs/acn/DMPPDU.h"
+#include "libs/acn/RootHeader.h"
 
 namespace ola {
 namespace acn {
@@ -34,17 +41,60 @@ namespace acn {
 using ola::Callback0;
 using ola::acn::CID;
 using ola::io::OutputStream;
+using ola::network::NetworkToHost;
+using ola::utils::JoinUInt8;
 using std::map;
 using std::pair;
 using std::vector;
 
-const TimeInterval DMPE131Inflator::EXPIRY_INTERVAL(2500000);
+namespace {
+/*
+ * Check a PDU uses the 12 bit length form, with all the flags set, and is
+ * exactly length bytes long.
+ */
+bool CheckFlagsAndLength(const uint8_t *data, unsigned int length) {
+  const uint8_t flags = static_cast<uint8_t>(
+      PDU::VFLAG_MASK | PDU::HFLAG_MASK | PDU::DFLAG_MASK);
+  return (data[0] & ~BaseInflator::LENGTH_MASK) == flags &&
+      JoinUInt8(static_cast<uint8_t>(data[0] & BaseInflator::LENGTH_MASK),
+                data[1]) == length;
+}
+
+uint32_t ReadVector(const uint8_t *data) {
+  return JoinUInt8(data[0], data[1], data[2], data[3]);
+}
+}  // namespace
+
+
+/*
+ * CIDs are random so any of the bytes will do, fold them together.
+ */
+size_t DMPE131Inflator::CIDHash::operator()(const CID &cid) const {
+  uint8_t data[CID::CID_LENGTH];
+  cid.Pack(data);
+  size_t hash = 0;
+  for (unsigned int i = 0; i < CID::CID_LENGTH; i++) {
+    hash = hash * 31 + data[i];
+  }
+  return hash;
+}
+
+
+DMPE131Inflator::DMPE131Inflator(bool ignore_preview, const Clock *clock)
+    : DMPInflator(),
+      m_ignore_preview(ignore_preview),
+      m_clock(clock ? clock : &m_monotonic_clock),
+      m_expiry_scan_interval(EXPIRY_SCAN_INTERVAL_MS) {
+}
 
 
 DMPE131Inflator::~DMPE131Inflator() {
   UniverseHandlers::iterator iter;
   for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
-    delete iter->second.closure;
+    if (*iter) {
+      delete (*iter)->closure;
+      delete *iter;
+    }
   }
   m_handlers.clear();
 }
@@ -62,16 +112,9 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
     return true;
   }
 
-  E131Header e131_header = headers.GetE131Header();
-  UniverseHandlers::iterator universe_iter =
-      m_handlers.find(e131_header.Universe());
-
-  if (e131_header.PreviewData() && m_ignore_preview) {
-    OLA_DEBUG << "Ignoring preview data";
-    return true;
-  }
-
-  if (universe_iter == m_handlers.end())
+  const E131Header &e131_header = headers.GetE131Header();
+  universe_handler *handler = HandlerForHeader(e131_header);
+  if (!handler)
     return true;
 
   DMPHeader dmp_header = headers.GetDMPHeader();
@@ -83,13 +126,6 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
     return true;
   }
 
-  if (e131_header.Priority() > MAX_E131_PRIORITY) {
-    OLA_INFO << "Priority " << static_cast<int>(e131_header.Priority())
-             << " is greater than the max priority ("
-             << static_cast<int>(MAX_E131_PRIORITY) << "), ignoring data";
-    return true;
-  }
-
   unsigned int available_length = pdu_len;
   std::auto_ptr<const BaseDMPAddress> address(
       DecodeAddress(dmp_header.Size(),
@@ -109,58 +145,255 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
   }
 
   unsigned int length_remaining = pdu_len - available_length;
+  unsigned int channels = std::min(length_remaining, address->Number());
+  const uint8_t *slots = data + available_length;
   int start_code = -1;
-  if (e131_header.UsingRev2())
+  if (e131_header.UsingRev2()) {
     start_code = static_cast<int>(address->Start());
-  else if (length_remaining && address->Number())
-    start_code = *(data + available_length);
+  } else if (channels) {
+    // the first slot is the start code
+    start_code = *slots++;
+    channels--;
+  }
+
+  HandleSlots(handler, headers, start_code, slots, channels);
+  return true;
+}
+
+
+/*
+ * Handle a standard E1.31 data packet without going through the inflators.
+ * Data packets make up almost all of the E1.31 traffic and the fields are at
+ * fixed offsets, so we can check them in place and copy the slot data
+ * straight into the source's merge buffer.
+ * @param data the packet, starting from the root layer (after the preamble).
+ * @param length the length of the packet.
+ * @returns true if the packet was handled, false if it should be passed to
+ *   the full inflator.
+ */
+bool DMPE131Inflator::HandleDataPacket(const uint8_t *data,
+                                       unsigned int length) {
+  if (length <= DMP_SLOTS_OFFSET)
+    return false;
+
+  // Each layer must use the short length form and run to the end of the
+  // packet.
+  if (!CheckFlagsAndLength(data, length) ||
+      !CheckFlagsAndLength(data + FRAMING_OFFSET, length - FRAMING_OFFSET) ||
+      !CheckFlagsAndLength(data + DMP_OFFSET, length - DMP_OFFSET))
+    return false;
+
+  if (ReadVector(data + ROOT_VECTOR_OFFSET) != VECTOR_ROOT_E131 ||
+      ReadVector(data + FRAMING_VECTOR_OFFSET) != VECTOR_E131_DATA ||
+      data[DMP_VECTOR_OFFSET] != DMP_SET_PROPERTY_VECTOR)
+    return false;
+
+  const DMPHeader dmp_header(true, false, RANGE_EQUAL, TWO_BYTES);
+  if (data[DMP_HEADER_OFFSET] != dmp_header.Header() ||
+      JoinUInt8(data[DMP_FIRST_ADDRESS_OFFSET],
+                data[DMP_FIRST_ADDRESS_OFFSET + 1]) != 0 ||
+      JoinUInt8(data[DMP_INCREMENT_OFFSET],
+                data[DMP_INCREMENT_OFFSET + 1]) != 1 ||
+      JoinUInt8(data[DMP_COUNT_OFFSET],
+                data[DMP_COUNT_OFFSET + 1]) != length - DMP_SLOTS_OFFSET)
+    return false;
+
+  E131Header::e131_pdu_header raw_header;
+  memcpy(reinterpret_cast<uint8_t*>(&raw_header),
+         data + FRAMING_HEADER_OFFSET,
+         sizeof(raw_header));
+
+  // Termination is rare, leave it to the inflators.
+  const uint8_t start_code = data[DMP_SLOTS_OFFSET];
+  if (raw_header.options & E131Header::STREAM_TERMINATED_MASK ||
+      (start_code != DMX512_START_CODE &&
+       start_code != ola::dmx::SLOT_PRIORITY_START_CODE))
+    return false;
+
+  E131Header e131_header(
+      "",
+      raw_header.priority,
+      raw_header.sequence,
+      NetworkToHost(raw_header.universe),
+      raw_header.options & E131Header::PREVIEW_DATA_MASK);
+  e131_header.SetSyncAddress(
+      NetworkToHost(raw_header.sync_address));
+
+  universe_handler *handler = HandlerForHeader(e131_header);
+  if (!handler)
+    return true;
+
+  RootHeader root_header;
+  root_header.SetCid(CID::FromData(data + CID_OFFSET));
+
+  HeaderSet headers;
+  headers.SetRootHeader(root_header);
+  headers.SetE131Header(e131_header);
+
+  HandleSlots(handler, headers, start_code, data + DMP_SLOTS_OFFSET + 1,
+              length - DMP_SLOTS_OFFSET - 1);
+  return true;
+}
+
+
+/*
+ * Return the handler for the universe in an E131Header, or NULL if the data
+ * should be ignored.
+ */
+DMPE131Inflator::universe_handler *DMPE131Inflator::HandlerForHeader(
+    const E131Header &e131_header) const {
+  if (e131_header.PreviewData() && m_ignore_preview) {
+    OLA_DEBUG << "Ignoring preview data";
+    return NULL;
+  }
+
+  universe_handler *handler = GetHandler(e131_header.Universe());
+  if (!handler)
+    return NULL;
+
+  if (e131_header.Priority() > MAX_E131_PRIORITY) {
+    OLA_INFO << "Priority " << static_cast<int>(e131_header.Priority())
+             << " is greater than the max priority ("
+             << static_cast<int>(MAX_E131_PRIORITY) << "), ignoring data";
+    return NULL;
+  }
+  return handler;
+}
+
+
+/*
+ * Update the source with the slot data and merge.
+ * @param handler the universe_handler struct for this universe.
+ * @param headers the headers for the packet.
+ * @param start_code the start code, or -1 if there wasn't one.
+ * @param slots the slot data, following the start code.
+ * @param slot_count the number of slots.
+ */
+void DMPE131Inflator::HandleSlots(universe_handler *handler,
+                                  const HeaderSet &headers,
+                                  int start_code,
+                                  const uint8_t *slots,
+                                  unsigned int slot_count) {
+  const E131Header &e131_header = headers.GetE131Header();
+  UpdateSourceStats(handler, headers);
 
   // The only time we want to continue processing a non-0 start code is if it
-  // contains a Terminate message.
-  if (start_code && !e131_header.StreamTerminated()) {
+  // contains a Terminate message, or if it contains per-slot priorities.
+  const bool slot_priorities = (
+      !e131_header.UsingRev2() &&
+      start_code == ola::dmx::SLOT_PRIORITY_START_CODE);
+  if (start_code && !slot_priorities && !e131_header.StreamTerminated()) {
     OLA_INFO << "Skipping packet with non-0 start code: " << start_code;
-    return true;
+    return;
   }
 
-  DmxBuffer *target_buffer;
-  if (!TrackSourceIfRequired(&universe_iter->second, headers,
-                             &target_buffer)) {
+  dmx_source *target_source;
+  if (!TrackSourceIfRequired(handler, headers, &target_source)) {
     // no need to continue processing
-    return true;
+    return;
   }
 
   // Reaching here means that we actually have new data and we should merge.
-  if (target_buffer && start_code == 0) {
-    unsigned int channels = std::min(length_remaining, address->Number());
-    if (e131_header.UsingRev2())
-      target_buffer->Set(data + available_length, channels);
-    else
-     target_buffer->Set(data + available_length + 1, channels - 1);
+  if (target_source && start_code == DMX512_START_CODE) {
+    target_source->buffer.Set(slots, slot_count);
+  } else if (target_source && slot_priorities) {
+    target_source->slot_priorities.Set(slots, slot_count);
   }
 
-  if (universe_iter->second.priority)
-    *universe_iter->second.priority = universe_iter->second.active_priority;
+  const uint16_t sync_address = e131_header.SyncAddress();
+  if (handler->hold_for_sync && sync_address &&
+      !e131_header.StreamTerminated() && SyncActive(sync_address)) {
+    // Hold the data until the sync packet arrives.
+    handler->pending_sync_address = sync_address;
+    return;
+  }
+
+  handler->pending_sync_address = 0;
+  MergeSources(handler);
+}
+
+
+/*
+ * Merge the sources for a universe and run the handler.
+ * @param handler the universe_handler struct for this universe.
+ */
+void DMPE131Inflator::MergeSources(universe_handler *handler) {
+  if (handler->priority)
+    *handler->priority = handler->active_priority;
+
+  bool have_slot_priorities = false;
+  SourceMap::const_iterator source_iter = handler->sources.begin();
+  for (; source_iter != handler->sources.end(); ++source_iter) {
+    have_slot_priorities |= source_iter->second.slot_priorities.Size() > 0;
+  }
+
+  if (handler->slot_priorities && !have_slot_priorities) {
+    handler->slot_priorities->Reset();
+  }
 
   // merge the sources
-  switch (universe_iter->second.sources.size()) {
+  switch (handler->sources.size()) {
     case 0:
-      universe_iter->second.buffer->Reset();
+      handler->buffer->Reset();
       break;
     case 1:
-      universe_iter->second.buffer->Set(
-          universe_iter->second.sources[0].buffer);
-      universe_iter->second.closure->Run();
+      source_iter = handler->sources.begin();
+      handler->buffer->Set(source_iter->second.buffer);
+      if (handler->slot_priorities) {
+        handler->slot_priorities->Set(source_iter->second.slot_priorities);
+      }
+      handler->closure->Run();
       break;
     default:
-      // HTP Merge
-      universe_iter->second.buffer->Reset();
-      std::vector<dmx_source>::const_iterator source_iter =
-        universe_iter->second.sources.begin();
-      for (; source_iter != universe_iter->second.sources.end(); ++source_iter)
-        universe_iter->second.buffer->HTPMerge(source_iter->buffer);
-      universe_iter->second.closure->Run();
+      if (handler->slot_priorities && have_slot_priorities) {
+        SlotPriorityMergeSources(handler);
+      } else {
+        // HTP Merge
+        handler->buffer->Reset();
+        for (source_iter = handler->sources.begin();
+             source_iter != handler->sources.end(); ++source_iter)
+          handler->buffer->HTPMerge(source_iter->second.buffer);
+      }
+      handler->closure->Run();
   }
-  return true;
+}
+
+
+/*
+ * Merge the sources for a universe using the per-slot priorities. Sources
+ * that haven't sent per-slot priorities use the active priority for every
+ * slot.
+ * @param universe_data the universe_handler struct for this universe.
+ */
+void DMPE131Inflator::SlotPriorityMergeSources(
+    universe_handler *universe_data) {
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  uint8_t priorities[DMX_UNIVERSE_SIZE];
+  uint8_t source_priorities[DMX_UNIVERSE_SIZE];
+  memset(data, DMX_MIN_SLOT_VALUE, sizeof(data));
+  memset(priorities, 0, sizeof(priorities));
+  unsigned int length = 0;
+
+  SourceMap::const_iterator iter = universe_data->sources.begin();
+  for (; iter != universe_data->sources.end(); ++iter) {
+    const dmx_source &source = iter->second;
+    const unsigned int size = source.buffer.Size();
+    if (source.slot_priorities.Size()) {
+      unsigned int priorities_size = size;
+      source.slot_priorities.Get(source_priorities, &priorities_size);
+      memset(source_priorities + priorities_size, 0, size - priorities_size);
+    } else {
+      memset(source_priorities,
+             std::max(universe_data->active_priority,
+                      static_cast<uint8_t>(1)),
+             size);
+    }
+    ola::dmx::SlotPriorityMerge(data, priorities, source.buffer.GetRaw(),
+                                source_priorities, size);
+    length = std::max(length, size);
+  }
+  universe_data->buffer->Set(data, length);
+  universe_data->slot_priorities->Set(priorities, length);
 }
 
 
@@ -170,30 +403,38 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
  * @param buffer the DmxBuffer to update with the data
  * @param handler the Callback0 to call when there is data for this universe.
  * Ownership of the closure is transferred to the node.
+ * @param slot_priorities the DmxBuffer to update with the per-slot priorities,
+ *   may be NULL.
+ * @param hold_for_sync if true, synchronized data isn't passed on until the
+ *   matching sync packet arrives.
  */
 bool DMPE131Inflator::SetHandler(uint16_t universe,
                                  ola::DmxBuffer *buffer,
                                  uint8_t *priority,
-                                 ola::Callback0<void> *closure) {
+                                 ola::Callback0<void> *closure,
+                                 ola::DmxBuffer *slot_priorities,
+                                 bool hold_for_sync) {
   if (!closure || !buffer)
     return false;
 
-  UniverseHandlers::iterator iter = m_handlers.find(universe);
+  if (universe >= m_handlers.size()) {
+    m_handlers.resize(universe + 1, NULL);
+  }
 
-  if (iter == m_handlers.end()) {
-    universe_handler handler;
-    handler.buffer = buffer;
-    handler.closure = closure;
-    handler.active_priority = 0;
-    handler.priority = priority;
+  universe_handler *handler = m_handlers[universe];
+  if (!handler) {
+    handler = new universe_handler();
+    handler->active_priority = 0;
     m_handlers[universe] = handler;
   } else {
-    Callback0<void> *old_closure = iter->second.closure;
-    iter->second.closure = closure;
-    iter->second.buffer = buffer;
-    iter->second.priority = priority;
-    delete old_closure;
+    delete handler->closure;
   }
+  handler->buffer = buffer;
+  handler->closure = closure;
+  handler->priority = priority;
+  handler->slot_priorities = slot_priorities;
+  handler->hold_for_sync = hold_for_sync;
+  handler->pending_sync_address = 0;
   return true;
 }
 
@@ -204,15 +445,15 @@ bool DMPE131Inflator::SetHandler(uint16_t universe,
  * @param true if removed, false if it didn't exist
  */
 bool DMPE131Inflator::RemoveHandler(uint16_t universe) {
-  UniverseHandlers::iterator iter = m_handlers.find(universe);
-
-  if (iter != m_handlers.end()) {
-    Callback0<void> *old_closure = iter->second.closure;
-    m_handlers.erase(iter);
-    delete old_closure;
-    return true;
+  universe_handler *handler = GetHandler(universe);
+  if (!handler) {
+    return false;
   }
-  return false;
+
+  delete handler->closure;
+  delete handler;
+  m_handlers[universe] = NULL;
+  return true;
 }
 
 
@@ -221,12 +462,219 @@ bool DMPE131Inflator::RemoveHandler(uint16_t universe) {
  * @param universes a pointer to a vector which is populated with the list of
  *   universes that have handlers installed.
  */
+bool DMPE131Inflator::HasHandler(uint16_t universe) const {
+  return GetHandler(universe) != NULL;
+}
+
+
 void DMPE131Inflator::RegisteredUniverses(vector<uint16_t> *universes) {
   universes->clear();
+  for (unsigned int i = 0; i < m_handlers.size(); i++) {
+    if (m_handlers[i]) {
+      universes->push_back(static_cast<uint16_t>(i));
+    }
+  }
+}
+
+
+/**
+ * Handle a synchronization packet. This merges the data held for the sync
+ * address.
+ * @param headers the HeaderSet for the sync packet
+ * @param sync_address the sync address from the packet.
+ */
+void DMPE131Inflator::HandleSync(OLA_UNUSED const HeaderSet &headers,
+                                 uint16_t sync_address) {
+  if (!sync_address) {
+    return;
+  }
+
+  m_sync_addresses[sync_address] = 0;
+
+  UniverseHandlers::iterator iter;
+  for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
+    if (*iter && (*iter)->pending_sync_address == sync_address) {
+      (*iter)->pending_sync_address = 0;
+      MergeSources(*iter);
+    }
+  }
+}
+
+
+/*
+ * Remove the sources that haven't sent anything for EXPIRY_SCANS scans and
+ * re-merge the universes they were contributing to.
+ */
+void DMPE131Inflator::ExpireSources() {
   UniverseHandlers::iterator iter;
   for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
-    universes->push_back(iter->first);
+    universe_handler *handler = *iter;
+    if (!handler) {
+      continue;
+    }
+
+    bool expired = false;
+    SourceMap::iterator source_iter = handler->sources.begin();
+    while (source_iter != handler->sources.end()) {
+      if (++source_iter->second.idle_scans > EXPIRY_SCANS) {
+        OLA_INFO << "source " << source_iter->first.ToString()
+                 << " has expired";
+        handler->sources.erase(source_iter++);
+        expired = true;
+      } else {
+        ++source_iter;
+      }
+    }
+
+    if (handler->sources.empty()) {
+      handler->active_priority = 0;
+    }
+
+    SourceStatsMap::iterator stats_iter = handler->stats.begin();
+    while (stats_iter != handler->stats.end()) {
+      if (++stats_iter->second.idle_scans > EXPIRY_SCANS) {
+        handler->stats.erase(stats_iter++);
+      } else {
+        ++stats_iter;
+      }
+    }
+
+    // Held data is merged when the sync packet arrives.
+    if (expired && !handler->pending_sync_address) {
+      MergeSources(handler);
+    }
   }
+
+  SyncAddresses::iterator sync_iter = m_sync_addresses.begin();
+  while (sync_iter != m_sync_addresses.end()) {
+    if (++sync_iter->second > EXPIRY_SCANS) {
+      m_sync_addresses.erase(sync_iter++);
+    } else {
+      ++sync_iter;
+    }
+  }
+}
+
+
+/*
+ * The sources are expired after EXPIRY_SCANS scans, so scan more often for a
+ * shorter timeout.
+ */
+void DMPE131Inflator::SetSourceTimeout(unsigned int timeout_ms) {
+  m_expiry_scan_interval = timeout_ms / EXPIRY_SCANS;
+  if (m_expiry_scan_interval < MIN_EXPIRY_SCAN_INTERVAL_MS) {
+    m_expiry_scan_interval = MIN_EXPIRY_SCAN_INTERVAL_MS;
+  }
+}
+
+
+void DMPE131Inflator::GetSourceStats(vector<SourceStats> *stats) const {
+  stats->clear();
+  for (unsigned int i = 0; i < m_handlers.size(); i++) {
+    const universe_handler *handler = m_handlers[i];
+    if (!handler) {
+      continue;
+    }
+
+    SourceStatsMap::const_iterator iter = handler->stats.begin();
+    for (; iter != handler->stats.end(); ++iter) {
+      SourceStats source;
+      source.cid = iter->first;
+      source.universe = static_cast<uint16_t>(i);
+      source.priority = iter->second.priority;
+      source.merged = STLContains(handler->sources, iter->first);
+      source.packets = iter->second.packets;
+      source.sequence_gaps = iter->second.sequence_gaps;
+      source.out_of_order = iter->second.out_of_order;
+      source.duplicates = iter->second.duplicates;
+      source.mean_interval = TimeInterval(iter->second.mean_interval);
+      source.jitter = TimeInterval(iter->second.jitter);
+      stats->push_back(source);
+    }
+  }
+}
+
+
+/*
+ * Update the receive statistics for the source of a packet. This sees every
+ * packet for the universe, whether or not the source is merged.
+ */
+void DMPE131Inflator::UpdateSourceStats(universe_handler *handler,
+                                        const HeaderSet &headers) {
+  const E131Header &e131_header = headers.GetE131Header();
+  const CID &cid = headers.GetRootHeader().GetCid();
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  SourceStatsMap::iterator iter = handler->stats.find(cid);
+  if (iter == handler->stats.end()) {
+    if (handler->stats.size() >= MAX_STATS_SOURCES) {
+      return;
+    }
+    source_stats &stats = handler->stats[cid];
+    stats.sequence = e131_header.Sequence();
+    stats.priority = e131_header.Priority();
+    stats.idle_scans = 0;
+    stats.packets = 1;
+    stats.sequence_gaps = 0;
+    stats.out_of_order = 0;
+    stats.duplicates = 0;
+    stats.last_arrival = now;
+    stats.mean_interval = 0;
+    stats.jitter = 0;
+    return;
+  }
+
+  source_stats &stats = iter->second;
+  stats.packets++;
+  stats.priority = e131_header.Priority();
+  stats.idle_scans = 0;
+
+  int8_t seq_diff = static_cast<int8_t>(e131_header.Sequence() -
+                                        stats.sequence);
+  if (seq_diff == 0) {
+    stats.duplicates++;
+    return;
+  } else if (seq_diff < 0 && seq_diff > SEQUENCE_DIFF_THRESHOLD) {
+    stats.out_of_order++;
+    return;
+  } else if (seq_diff > 1) {
+    stats.sequence_gaps += seq_diff - 1;
+  }
+  // Anything further back is treated as the source restarting.
+  stats.sequence = e131_header.Sequence();
+
+  const int64_t interval = (now - stats.last_arrival).AsInt();
+  stats.last_arrival = now;
+  if (stats.mean_interval == 0) {
+    stats.mean_interval = interval;
+    return;
+  }
+  int64_t deviation = interval - stats.mean_interval;
+  if (deviation < 0) {
+    deviation = -deviation;
+  }
+  stats.jitter += (deviation - stats.jitter) / JITTER_GAIN;
+  stats.mean_interval += (interval - stats.mean_interval) / MEAN_INTERVAL_GAIN;
+}
+
+
+/*
+ * Check if we've received a sync packet for this address recently. If the
+ * sync packets stop, data is passed on as soon as it arrives.
+ */
+bool DMPE131Inflator::SyncActive(uint16_t sync_address) const {
+  return STLContains(m_sync_addresses, sync_address);
+}
+
+
+/*
+ * Get the handler for a universe.
+ * @returns the universe_handler, or NULL if there isn't one.
+ */
+DMPE131Inflator::universe_handler *DMPE131Inflator::GetHandler(
+    uint16_t universe) const {
+  return universe < m_handlers.size() ? m_handlers[universe] : NULL;
 }
 
 
@@ -236,43 +684,25 @@ void DMPE131Inflator::RegisteredUniverses(vector<uint16_t> *universes) {
  * priority.
  * @param universe_data the universe_handler struct for this universe,
  * @param HeaderSet the set of headers in this packet
- * @param buffer, if set to a non-NULL pointer, the caller should copy the data
- * in the buffer.
+ * @param source, if set to a non-NULL pointer, the caller should copy the data
+ * in to the source.
  * @returns true if we should remerge the data, false otherwise.
  */
 bool DMPE131Inflator::TrackSourceIfRequired(
     universe_handler *universe_data,
     const HeaderSet &headers,
-    DmxBuffer **buffer) {
+    dmx_source **source) {
 
-  *buffer = NULL;  // default the buffer to NULL
-  ola::TimeStamp now;
-  m_clock.CurrentTime(&now);
+  *source = NULL;  // default the source to NULL
   const E131Header &e131_header = headers.GetE131Header();
+  const CID &cid = headers.GetRootHeader().GetCid();
   uint8_t priority = e131_header.Priority();
-  vector<dmx_source> &sources = universe_data->sources;
-  vector<dmx_source>::iterator iter = sources.begin();
-
-  while (iter != sources.end()) {
-    if (iter->cid != headers.GetRootHeader().GetCid()) {
-      TimeStamp expiry_time = iter->last_heard_from + EXPIRY_INTERVAL;
-      if (now > expiry_time) {
-        OLA_INFO << "source " << iter->cid.ToString() << " has expired";
-        iter = sources.erase(iter);
-        continue;
-      }
-    }
-    iter++;
-  }
+  SourceMap &sources = universe_data->sources;
+  SourceMap::iterator iter = sources.find(cid);
 
   if (sources.empty())
     universe_data->active_priority = 0;
 
-  for (iter = sources.begin(); iter != sources.end(); ++iter) {
-    if (iter->cid == headers.GetRootHeader().GetCid())
-      break;
-  }
-
   if (iter == sources.end()) {
     // This is an untracked source
     if (e131_header.StreamTerminated() ||
@@ -290,46 +720,46 @@ bool DMPE131Inflator::TrackSourceIfRequired(
 
     if (sources.size() == MAX_MERGE_SOURCES) {
       // TODO(simon): flag this in the export map
-      OLA_WARN << "Max merge sources reached for universe " <<
-        e131_header.Universe() << ", " <<
-        headers.GetRootHeader().GetCid().ToString() << " won't be tracked";
+      OLA_LOG_RATE_LIMITED(ola::OLA_LOG_WARN, 10) <<
+        "Max merge sources reached for universe " <<
+        e131_header.Universe() << ", " << cid.ToString() <<
+        " won't be tracked";
         return false;
     } else {
-      OLA_INFO << "Added new E1.31 source: " <<
-        headers.GetRootHeader().GetCid().ToString();
-      dmx_source new_source;
-      new_source.cid = headers.GetRootHeader().GetCid();
+      OLA_INFO << "Added new E1.31 source: " << cid.ToString();
+      dmx_source &new_source = sources[cid];
       new_source.sequence = e131_header.Sequence();
-      new_source.last_heard_from = now;
-      iter = sources.insert(sources.end(), new_source);
-      *buffer = &iter->buffer;
+      new_source.idle_scans = 0;
+      *source = &new_source;
       return true;
     }
 
   } else {
     // We already know about this one, check the seq #
+    dmx_source &known_source = iter->second;
     int8_t seq_diff = static_cast<int8_t>(e131_header.Sequence() -
-                                          iter->sequence);
+                                          known_source.sequence);
     if (seq_diff <= 0 && seq_diff > SEQUENCE_DIFF_THRESHOLD) {
-      OLA_INFO << "Old packet received, ignoring, this # " <<
+      OLA_LOG_RATE_LIMITED(ola::OLA_LOG_INFO, 10) <<
+        "Old packet received, ignoring, this # " <<
         static_cast<int>(e131_header.Sequence()) << ", last " <<
-        static_cast<int>(iter->sequence);
+        static_cast<int>(known_source.sequence);
       return false;
     }
-    iter->sequence = e131_header.Sequence();
+    known_source.sequence = e131_header.Sequence();
 
     if (e131_header.StreamTerminated()) {
-      OLA_INFO << "CID " << headers.GetRootHeader().GetCid().ToString() <<
+      OLA_INFO << "CID " << cid.ToString() <<
         " sent a termination for universe " << e131_header.Universe();
       sources.erase(iter);
       if (sources.empty())
         universe_data->active_priority = 0;
       // We need to trigger a merge here else the buffer will be stale, we keep
-      // the buffer as NULL though so we don't use the data.
+      // the source as NULL though so we don't use the data.
       return true;
     }
 
-    iter->last_heard_from = now;
+    known_source.idle_scans = 0;
     if (priority < universe_data->active_priority) {
       if (sources.size() == 1) {
         universe_data->active_priority = priority;
@@ -342,12 +772,13 @@ bool DMPE131Inflator::TrackSourceIfRequired(
       universe_data->active_priority = priority;
       if (sources.size() != 1) {
         // clear all sources other than this one
-        dmx_source this_source = *iter;
+        dmx_source this_source = known_source;
         sources.clear();
-        iter = sources.insert(sources.end(), this_source);
+        *source = &(sources[cid] = this_source);
+        return true;
       }
     }
-    *buffer = &iter->buffer;
+    *source = &known_source;
     return true;
   }
 }
@@ -22,32 +22,110 @@
 #ifndef LIBS_ACN_DMPE131INFLATOR_H_
 #define LIBS_ACN_DMPE131INFLATOR_H_
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <stddef.h>
 #include <map>
 #include <vector>
-#include "ola/Clock.h"
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/acn/CID.h"
 #include "libs/acn/DMPInflator.h"
 
+#include HASH_MAP_H
+
 namespace ola {
 namespace acn {
 
 class DMPE131Inflator: public DMPInflator {
   friend class DMPE131InflatorTest;
+  friend class E131InflatorTest;
 
  public:
-    explicit DMPE131Inflator(bool ignore_preview):
-      DMPInflator(),
-      m_ignore_preview(ignore_preview) {
-    }
+    /*
+     * The receive statistics for a source on a universe. Sources are counted
+     * even if they're not part of the merge, e.g. a backup console at a lower
+     * priority.
+     */
+    struct SourceStats {
+      ola::acn::CID cid;
+      uint16_t universe;
+      // the priority of the last packet
+      uint8_t priority;
+      // true if the source's data is being merged
+      bool merged;
+      uint64_t packets;
+      // the number of packets skipped in the sequence numbers
+      uint64_t sequence_gaps;
+      // packets which arrived after a later packet, these are dropped
+      uint64_t out_of_order;
+      // packets with the same sequence number as the last one
+      uint64_t duplicates;
+      // the smoothed mean time between packets
+      TimeInterval mean_interval;
+      // the smoothed mean deviation from the mean interval, as in RFC 3550
+      TimeInterval jitter;
+    };
+
+    /*
+     * Create a new DMPE131Inflator.
+     * @param ignore_preview true to drop preview data.
+     * @param clock the clock to time the packets with, if NULL the monotonic
+     *   clock is used.
+     */
+    explicit DMPE131Inflator(bool ignore_preview,
+                             const Clock *clock = NULL);
     ~DMPE131Inflator();
 
     bool SetHandler(uint16_t universe, ola::DmxBuffer *buffer,
-                    uint8_t *priority, ola::Callback0<void> *handler);
+                    uint8_t *priority, ola::Callback0<void> *handler,
+                    ola::DmxBuffer *slot_priorities = NULL,
+                    bool hold_for_sync = false);
     bool RemoveHandler(uint16_t universe);
+    bool HasHandler(uint16_t universe) const;
 
     void RegisteredUniverses(std::vector<uint16_t> *universes);
 
+    void HandleSync(const HeaderSet &headers, uint16_t sync_address);
+
+    /*
+     * Handle a standard data packet, starting at the root layer. Returns
+     * false if the packet needs the full inflators.
+     */
+    bool HandleDataPacket(const uint8_t *data, unsigned int length);
+
+    /*
+     * Expire the sources and sync addresses we haven't heard from recently.
+     * This should be called every EXPIRY_SCAN_INTERVAL_MS.
+     */
+    void ExpireSources();
+
+    /*
+     * Set how long a source can go without sending before it's expired. A
+     * shorter timeout lets a backup source take over sooner when the active
+     * one disappears, but sources must send more often than this even when
+     * the data isn't changing, otherwise they'll flap. This changes
+     * ExpiryScanInterval().
+     */
+    void SetSourceTimeout(unsigned int timeout_ms);
+
+    // How often ExpireSources() should be called, in milliseconds.
+    unsigned int ExpiryScanInterval() const {
+      return m_expiry_scan_interval;
+    }
+
+    /*
+     * Get the receive statistics for the sources we've heard from recently.
+     */
+    void GetSourceStats(std::vector<SourceStats> *stats) const;
+
+    // The default expiry scan interval, this gives the 2.5s timeout from
+    // E1.31.
+    static const unsigned int EXPIRY_SCAN_INTERVAL_MS = 500;
+
  protected:
     virtual bool HandlePDUData(uint32_t vector,
                                const HeaderSet &headers,
@@ -56,38 +134,109 @@ class DMPE131Inflator: public DMPInflator {
 
  private:
     typedef struct {
-      ola::acn::CID cid;
       uint8_t sequence;
-      TimeStamp last_heard_from;
+      // the number of expiry scans since we last heard from this source.
+      uint8_t idle_scans;
       DmxBuffer buffer;
+      DmxBuffer slot_priorities;
     } dmx_source;
 
+    struct CIDHash {
+      size_t operator()(const ola::acn::CID &cid) const;
+    };
+
+    typedef HASH_NAMESPACE::HASH_MAP_CLASS<ola::acn::CID, dmx_source,
+                                           CIDHash> SourceMap;
+
+    struct source_stats {
+      uint8_t sequence;
+      uint8_t priority;
+      // the number of expiry scans since we last heard from this source.
+      uint8_t idle_scans;
+      uint64_t packets;
+      uint64_t sequence_gaps;
+      uint64_t out_of_order;
+      uint64_t duplicates;
+      TimeStamp last_arrival;
+      // in microseconds
+      int64_t mean_interval;
+      int64_t jitter;
+    };
+
+    typedef HASH_NAMESPACE::HASH_MAP_CLASS<ola::acn::CID, source_stats,
+                                           CIDHash> SourceStatsMap;
+
     typedef struct {
       DmxBuffer *buffer;
       Callback0<void> *closure;
       uint8_t active_priority;
       uint8_t *priority;
-      std::vector<dmx_source> sources;
+      DmxBuffer *slot_priorities;
+      SourceMap sources;
+      SourceStatsMap stats;
+      bool hold_for_sync;
+      // the sync address of the data waiting to be merged, 0 if none.
+      uint16_t pending_sync_address;
     } universe_handler;
 
-    typedef std::map<uint16_t, universe_handler> UniverseHandlers;
+    // Indexed by universe, NULL if there isn't a handler for the universe.
+    // This only grows as large as the highest universe we listen on.
+    typedef std::vector<universe_handler*> UniverseHandlers;
+    // sync address to the number of expiry scans since we last heard it.
+    typedef std::map<uint16_t, uint8_t> SyncAddresses;
 
     UniverseHandlers m_handlers;
+    SyncAddresses m_sync_addresses;
     bool m_ignore_preview;
-    ola::Clock m_clock;
+    MonotonicClock m_monotonic_clock;
+    const Clock *m_clock;
+    unsigned int m_expiry_scan_interval;
 
+    universe_handler *GetHandler(uint16_t universe) const;
+    universe_handler *HandlerForHeader(const E131Header &e131_header) const;
+    void HandleSlots(universe_handler *handler,
+                     const HeaderSet &headers,
+                     int start_code,
+                     const uint8_t *slots,
+                     unsigned int slot_count);
+    void UpdateSourceStats(universe_handler *handler,
+                           const HeaderSet &headers);
     bool TrackSourceIfRequired(universe_handler *universe_data,
                                const HeaderSet &headers,
-                               DmxBuffer **buffer);
+                               dmx_source **source);
+    void MergeSources(universe_handler *universe_data);
+    void SlotPriorityMergeSources(universe_handler *universe_data);
+    bool SyncActive(uint16_t sync_address) const;
 
     // The max number of sources we'll track per universe.
     static const uint8_t MAX_MERGE_SOURCES = 6;
+    // The max number of sources we'll keep statistics for per universe.
+    static const uint8_t MAX_STATS_SOURCES = 16;
+    // The gains of the smoothed mean interval and jitter.
+    static const int64_t MEAN_INTERVAL_GAIN = 8;
+    static const int64_t JITTER_GAIN = 16;
+    // The shortest expiry scan interval.
+    static const unsigned int MIN_EXPIRY_SCAN_INTERVAL_MS = 10;
     // The max merge priority.
     static const uint8_t MAX_E131_PRIORITY = 200;
     // ignore packets that differ by less than this amount from the last one
     static const int8_t SEQUENCE_DIFF_THRESHOLD = -20;
-    // expire sources after 2.5s
-    static const TimeInterval EXPIRY_INTERVAL;
+    // expire sources, and sync addresses, after 2.5s
+    static const uint8_t EXPIRY_SCANS = 5;
+
+    // Offsets into a standard data packet, from the start of the root layer.
+    static const unsigned int ROOT_VECTOR_OFFSET = 2;
+    static const unsigned int CID_OFFSET = 6;
+    static const unsigned int FRAMING_OFFSET = 22;
+    static const unsigned int FRAMING_VECTOR_OFFSET = 24;
+    static const unsigned int FRAMING_HEADER_OFFSET = 28;
+    static const unsigned int DMP_OFFSET = 99;
+    static const unsigned int DMP_VECTOR_OFFSET = 101;
+    static const unsigned int DMP_HEADER_OFFSET = 102;
+    static const unsigned int DMP_FIRST_ADDRESS_OFFSET = 103;
+    static const unsigned int DMP_INCREMENT_OFFSET = 105;
+    static const unsigned int DMP_COUNT_OFFSET = 107;
+    static const unsigned int DMP_SLOTS_OFFSET = 109;
 };
 }  // namespace acn
 }  // namespace ola
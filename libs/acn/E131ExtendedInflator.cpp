@@ -0,0 +1,90 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131ExtendedInflator.cpp
+ * The Inflator for E1.31 synchronization packets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+#include "libs/acn/E131ExtendedInflator.h"
+#include "libs/acn/E131SyncPDU.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::NetworkToHost;
+
+/*
+ * Decode the header for a synchronization packet. If data is null we're
+ * expected to use the last header we got. The headers of other packets are
+ * left for HandlePDUData.
+ * @param headers the HeaderSet to add to
+ * @param data a pointer to the data
+ * @param length length of the data
+ * @returns true if successful, false otherwise
+ */
+bool E131ExtendedInflator::DecodeHeader(OLA_UNUSED HeaderSet *headers,
+                                        const uint8_t *data,
+                                        unsigned int length,
+                                        unsigned int *bytes_used) {
+  *bytes_used = 0;
+  if (m_last_vector != ola::acn::VECTOR_E131_EXTENDED_SYNCHRONIZATION) {
+    return true;
+  }
+
+  if (data) {
+    // the header bit was set, decode it
+    if (length < sizeof(E131SyncPDU::e131_sync_header)) {
+      return false;
+    }
+    E131SyncPDU::e131_sync_header raw_header;
+    memcpy(&raw_header, data, sizeof(raw_header));
+    m_sync_address = NetworkToHost(raw_header.sync_address);
+    m_last_header_valid = true;
+    *bytes_used = sizeof(raw_header);
+    return true;
+  }
+
+  // use the last header if it exists
+  if (!m_last_header_valid) {
+    OLA_WARN << "Missing E131 sync header data";
+    return false;
+  }
+  return true;
+}
+
+
+/*
+ * Run the sync callback for synchronization packets.
+ */
+bool E131ExtendedInflator::HandlePDUData(uint32_t vector,
+                                         const HeaderSet &headers,
+                                         OLA_UNUSED const uint8_t *data,
+                                         OLA_UNUSED unsigned int pdu_len) {
+  if (vector != ola::acn::VECTOR_E131_EXTENDED_SYNCHRONIZATION) {
+    OLA_DEBUG << "Ignoring extended E1.31 packet with vector " << vector;
+    return true;
+  }
+
+  if (m_sync_callback.get()) {
+    m_sync_callback->Run(headers, m_sync_address);
+  }
+  return true;
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,80 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131ExtendedInflator.h
+ * Interface for the E131ExtendedInflator class.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * This handles the E1.31 packets sent with the extended root vector. Only
+ * synchronization packets are supported at the moment.
+ */
+
+#ifndef LIBS_ACN_E131EXTENDEDINFLATOR_H_
+#define LIBS_ACN_E131EXTENDEDINFLATOR_H_
+
+#include <memory>
+#include "ola/Callback.h"
+#include "ola/acn/ACNVectors.h"
+#include "libs/acn/BaseInflator.h"
+
+namespace ola {
+namespace acn {
+
+class E131ExtendedInflator: public BaseInflator {
+  friend class E131InflatorTest;
+
+ public:
+  /*
+   * Called with the sync address of each synchronization packet.
+   */
+  typedef ola::Callback2<void, const HeaderSet&, uint16_t> SyncCallback;
+
+  /*
+   * Create a new E131ExtendedInflator, ownership of the callback is
+   * transferred.
+   */
+  explicit E131ExtendedInflator(SyncCallback *sync_callback)
+      : BaseInflator(),
+        m_sync_callback(sync_callback),
+        m_sync_address(0),
+        m_last_header_valid(false) {
+  }
+  ~E131ExtendedInflator() {}
+
+  uint32_t Id() const { return ola::acn::VECTOR_ROOT_E131_EXTENDED; }
+
+ protected:
+  bool DecodeHeader(HeaderSet *headers,
+                    const uint8_t *data,
+                    unsigned int len,
+                    unsigned int *bytes_used);
+
+  void ResetHeaderField() {
+    m_last_header_valid = false;
+  }
+
+  bool HandlePDUData(uint32_t vector,
+                     const HeaderSet &headers,
+                     const uint8_t *data,
+                     unsigned int pdu_len);
+
+ private:
+  std::auto_ptr<SyncCallback> m_sync_callback;
+  uint16_t m_sync_address;
+  bool m_last_header_valid;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131EXTENDEDINFLATOR_H_
@@ -40,7 +40,8 @@ class E131Header {
           m_universe(0),
           m_is_preview(false),
           m_has_terminated(false),
-          m_is_rev2(false) {
+          m_is_rev2(false),
+          m_sync_address(0) {
     }
     E131Header(const std::string &source,
                uint8_t priority,
@@ -55,7 +56,8 @@ class E131Header {
           m_universe(universe),
           m_is_preview(is_preview),
           m_has_terminated(has_terminated),
-          m_is_rev2(is_rev2) {
+          m_is_rev2(is_rev2),
+          m_sync_address(0) {
     }
     ~E131Header() {}
 
@@ -68,6 +70,15 @@ class E131Header {
 
     bool UsingRev2() const { return m_is_rev2; }
 
+    /*
+     * The universe that synchronization packets for this data are sent on, or
+     * 0 if the data isn't synchronized. This isn't supported with Rev 0.2.
+     */
+    uint16_t SyncAddress() const { return m_sync_address; }
+    void SetSyncAddress(uint16_t sync_address) {
+      m_sync_address = sync_address;
+    }
+
     bool operator==(const E131Header &other) const {
       return m_source == other.m_source &&
         m_priority == other.m_priority &&
@@ -75,7 +86,8 @@ class E131Header {
         m_universe == other.m_universe &&
         m_is_preview == other.m_is_preview &&
         m_has_terminated == other.m_has_terminated &&
-        m_is_rev2 == other.m_is_rev2;
+        m_is_rev2 == other.m_is_rev2 &&
+        m_sync_address == other.m_sync_address;
     }
 
     enum { SOURCE_NAME_LEN = 64 };
@@ -84,7 +96,7 @@ class E131Header {
     struct e131_pdu_header_s {
       char source[SOURCE_NAME_LEN];
       uint8_t priority;
-      uint16_t reserved;
+      uint16_t sync_address;
       uint8_t sequence;
       uint8_t options;
       uint16_t universe;
@@ -102,6 +114,7 @@ class E131Header {
     bool m_is_preview;
     bool m_has_terminated;
     bool m_is_rev2;
+    uint16_t m_sync_address;
 };
 
 
@@ -20,21 +20,40 @@
 
 #include <string.h>
 #include <cppunit/extensions/HelperMacros.h>
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
+#include "ola/acn/CID.h"
 #include "ola/network/NetworkUtils.h"
+#include "libs/acn/DMPAddress.h"
+#include "libs/acn/DMPE131Inflator.h"
+#include "libs/acn/DMPPDU.h"
 #include "libs/acn/HeaderSet.h"
 #include "libs/acn/PDUTestCommon.h"
+#include "libs/acn/RootHeader.h"
+#include "libs/acn/RootPDU.h"
+#include "libs/acn/E131ExtendedInflator.h"
 #include "libs/acn/E131Inflator.h"
 #include "libs/acn/E131PDU.h"
+#include "libs/acn/E131SyncPDU.h"
 #include "ola/testing/TestUtils.h"
 
 namespace ola {
 namespace acn {
 
+using ola::DmxBuffer;
+using ola::acn::CID;
 using ola::network::HostToNetwork;
+using std::auto_ptr;
 using std::string;
+using std::vector;
 
 class E131InflatorTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(E131InflatorTest);
@@ -42,6 +61,12 @@ class E131InflatorTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testDecodeHeader);
   CPPUNIT_TEST(testInflateRev2PDU);
   CPPUNIT_TEST(testInflatePDU);
+  CPPUNIT_TEST(testInflateSyncPDU);
+  CPPUNIT_TEST(testHoldForSync);
+  CPPUNIT_TEST(testExpireSources);
+  CPPUNIT_TEST(testHandleDataPacket);
+  CPPUNIT_TEST(testSourceStats);
+  CPPUNIT_TEST(testSourceTimeout);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -49,6 +74,27 @@ class E131InflatorTest: public CppUnit::TestFixture {
     void testDecodeHeader();
     void testInflatePDU();
     void testInflateRev2PDU();
+    void testInflateSyncPDU();
+    void testHoldForSync();
+    void testExpireSources();
+    void testHandleDataPacket();
+    void testSourceStats();
+    void testSourceTimeout();
+
+ private:
+    vector<uint16_t> m_sync_addresses;
+    unsigned int m_dmx_count;
+
+    void SyncReceived(const HeaderSet &, uint16_t sync_address) {
+      m_sync_addresses.push_back(sync_address);
+    }
+    void DmxReceived() { m_dmx_count++; }
+    void InflateDMX(E131Inflator *inflator, uint8_t sequence,
+                    uint16_t sync_address, const DmxBuffer &buffer,
+                    const CID &cid = CID(), uint8_t priority = 100);
+    void InflateSync(E131ExtendedInflator *inflator, uint16_t sync_address);
+    void PackDataPacket(const E131Header &header, const DmxBuffer &buffer,
+                        vector<uint8_t> *packet);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(E131InflatorTest);
@@ -114,7 +160,9 @@ void E131InflatorTest::testDecodeHeader() {
 
   strncpy(header.source, source_name.data(), source_name.size() + 1);
   header.priority = 99;
+  header.sync_address = HostToNetwork(static_cast<uint16_t>(7));
   header.sequence = 10;
+  header.options = 0;
   header.universe = HostToNetwork(static_cast<uint16_t>(42));
 
   OLA_ASSERT(inflator.DecodeHeader(&header_set,
@@ -127,6 +175,7 @@ void E131InflatorTest::testDecodeHeader() {
   OLA_ASSERT_EQ((uint8_t) 99, decoded_header.Priority());
   OLA_ASSERT_EQ((uint8_t) 10, decoded_header.Sequence());
   OLA_ASSERT_EQ((uint16_t) 42, decoded_header.Universe());
+  OLA_ASSERT_EQ((uint16_t) 7, decoded_header.SyncAddress());
 
   // try an undersized header
   OLA_ASSERT_FALSE(inflator.DecodeHeader(
@@ -182,6 +231,7 @@ void E131InflatorTest::testInflateRev2PDU() {
 void E131InflatorTest::testInflatePDU() {
   const string source = "foobar source";
   E131Header header(source, 1, 2, 6000);
+  header.SetSyncAddress(6001);
   // TODO(simon): pass a DMP msg here as well
   E131PDU pdu(3, header, NULL);
   OLA_ASSERT_EQ((unsigned int) 77, pdu.Size());
@@ -198,5 +248,377 @@ void E131InflatorTest::testInflatePDU() {
   OLA_ASSERT(header == header_set.GetE131Header());
   delete[] data;
 }
+
+
+/*
+ * Check that we can inflate a synchronization packet.
+ */
+void E131InflatorTest::testInflateSyncPDU() {
+  E131SyncPDU pdu(5, 6000);
+  OLA_ASSERT_EQ((unsigned int) 11, pdu.Size());
+
+  unsigned int size = pdu.Size();
+  uint8_t data[11];
+  unsigned int bytes_used = size;
+  OLA_ASSERT(pdu.Pack(data, &bytes_used));
+  OLA_ASSERT_EQ(size, bytes_used);
+
+  E131ExtendedInflator inflator(
+      NewCallback(this, &E131InflatorTest::SyncReceived));
+  HeaderSet header_set;
+  OLA_ASSERT_EQ(size, inflator.InflatePDUBlock(&header_set, data, size));
+  OLA_ASSERT_EQ((size_t) 1, m_sync_addresses.size());
+  OLA_ASSERT_EQ((uint16_t) 6000, m_sync_addresses[0]);
+
+  // an undersized header is ignored
+  data[1] = static_cast<uint8_t>(size - 1);
+  OLA_ASSERT_EQ(size - 1, inflator.InflatePDUBlock(&header_set, data,
+                                                   size - 1));
+  OLA_ASSERT_EQ((size_t) 1, m_sync_addresses.size());
+}
+
+
+/*
+ * Check that synchronized data is held until the sync packet arrives.
+ */
+void E131InflatorTest::testHoldForSync() {
+  const uint16_t universe = 1;
+  const uint16_t sync_address = 100;
+  m_dmx_count = 0;
+
+  DMPE131Inflator dmp_inflator(true);
+  E131Inflator e131_inflator;
+  e131_inflator.AddInflator(&dmp_inflator);
+  E131ExtendedInflator extended_inflator(
+      NewCallback(&dmp_inflator, &DMPE131Inflator::HandleSync));
+
+  const DmxBuffer frame1(string("\001\002", 2));
+  const DmxBuffer frame2(string("\003\004", 2));
+  const DmxBuffer frame3(string("\005\006", 2));
+  DmxBuffer buffer;
+  uint8_t priority;
+  OLA_ASSERT_TRUE(dmp_inflator.SetHandler(
+        universe, &buffer, &priority,
+        NewCallback(this, &E131InflatorTest::DmxReceived), NULL, true));
+
+  // Until we've seen a sync packet, the data is passed straight through.
+  InflateDMX(&e131_inflator, 0, sync_address, frame1);
+  OLA_ASSERT_EQ(1u, m_dmx_count);
+  OLA_ASSERT_EQ(frame1, buffer);
+
+  InflateSync(&extended_inflator, sync_address);
+  OLA_ASSERT_EQ(1u, m_dmx_count);
+
+  // Now it's held
+  InflateDMX(&e131_inflator, 1, sync_address, frame2);
+  OLA_ASSERT_EQ(1u, m_dmx_count);
+  OLA_ASSERT_EQ(frame1, buffer);
+
+  // A sync packet for a different address doesn't release it.
+  InflateSync(&extended_inflator, sync_address + 1);
+  OLA_ASSERT_EQ(1u, m_dmx_count);
+
+  InflateSync(&extended_inflator, sync_address);
+  OLA_ASSERT_EQ(2u, m_dmx_count);
+  OLA_ASSERT_EQ(frame2, buffer);
+
+  // Unsynchronized data isn't held.
+  InflateDMX(&e131_inflator, 2, 0, frame3);
+  OLA_ASSERT_EQ(3u, m_dmx_count);
+  OLA_ASSERT_EQ(frame3, buffer);
+}
+
+
+/*
+ * Check that sources are expired by the periodic scan, and that the remaining
+ * sources are re-merged.
+ */
+void E131InflatorTest::testExpireSources() {
+  const uint16_t universe = 1;
+  m_dmx_count = 0;
+
+  DMPE131Inflator dmp_inflator(true);
+  E131Inflator e131_inflator;
+  e131_inflator.AddInflator(&dmp_inflator);
+
+  DmxBuffer buffer;
+  uint8_t priority;
+  OLA_ASSERT_TRUE(dmp_inflator.SetHandler(
+        universe, &buffer, &priority,
+        NewCallback(this, &E131InflatorTest::DmxReceived)));
+  vector<uint16_t> universes;
+  dmp_inflator.RegisteredUniverses(&universes);
+  OLA_ASSERT_EQ((size_t) 1, universes.size());
+  OLA_ASSERT_EQ(universe, universes[0]);
+
+  const CID cid1 = CID::Generate();
+  const CID cid2 = CID::Generate();
+  InflateDMX(&e131_inflator, 0, 0, DmxBuffer(string("\010\000", 2)), cid1);
+  InflateDMX(&e131_inflator, 0, 0, DmxBuffer(string("\000\020", 2)), cid2);
+  OLA_ASSERT_EQ(2u, m_dmx_count);
+  OLA_ASSERT_EQ(DmxBuffer(string("\010\020", 2)), buffer);
+
+  // cid1 keeps sending, cid2 goes quiet.
+  for (unsigned int i = 0; i < DMPE131Inflator::EXPIRY_SCANS; i++) {
+    dmp_inflator.ExpireSources();
+    InflateDMX(&e131_inflator, static_cast<uint8_t>(i + 1), 0,
+               DmxBuffer(string("\010\000", 2)), cid1);
+  }
+  OLA_ASSERT_EQ(2u + DMPE131Inflator::EXPIRY_SCANS, m_dmx_count);
+  OLA_ASSERT_EQ(DmxBuffer(string("\010\020", 2)), buffer);
+
+  dmp_inflator.ExpireSources();
+  OLA_ASSERT_EQ(3u + DMPE131Inflator::EXPIRY_SCANS, m_dmx_count);
+  OLA_ASSERT_EQ(DmxBuffer(string("\010\000", 2)), buffer);
+
+  OLA_ASSERT_TRUE(dmp_inflator.RemoveHandler(universe));
+  OLA_ASSERT_FALSE(dmp_inflator.RemoveHandler(universe));
+  dmp_inflator.RegisteredUniverses(&universes);
+  OLA_ASSERT_TRUE(universes.empty());
+}
+
+
+/*
+ * Check that standard data packets are handled without the inflators, and
+ * that anything else is left for them.
+ */
+void E131InflatorTest::testHandleDataPacket() {
+  const uint16_t universe = 1;
+  m_dmx_count = 0;
+
+  DMPE131Inflator dmp_inflator(true);
+  DmxBuffer buffer;
+  uint8_t priority = 0;
+  OLA_ASSERT_TRUE(dmp_inflator.SetHandler(
+        universe, &buffer, &priority,
+        NewCallback(this, &E131InflatorTest::DmxReceived)));
+
+  const DmxBuffer frame(string("\001\002\003", 3));
+  vector<uint8_t> packet;
+  PackDataPacket(E131Header("foo", 150, 0, universe), frame, &packet);
+  OLA_ASSERT_TRUE(dmp_inflator.HandleDataPacket(&packet[0], packet.size()));
+  OLA_ASSERT_EQ(1u, m_dmx_count);
+  OLA_ASSERT_EQ(frame, buffer);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), priority);
+
+  // The same sequence number is dropped.
+  OLA_ASSERT_TRUE(dmp_inflator.HandleDataPacket(&packet[0], packet.size()));
+  OLA_ASSERT_EQ(1u, m_dmx_count);
+
+  // Universes we're not listening to are consumed.
+  PackDataPacket(E131Header("foo", 150, 1, universe + 1), frame, &packet);
+  OLA_ASSERT_TRUE(dmp_inflator.HandleDataPacket(&packet[0], packet.size()));
+  OLA_ASSERT_EQ(1u, m_dmx_count);
+
+  // Truncated packets, terminated streams and Rev 0.2 are left for the
+  // inflators.
+  PackDataPacket(E131Header("foo", 150, 1, universe), frame, &packet);
+  OLA_ASSERT_FALSE(dmp_inflator.HandleDataPacket(&packet[0],
+                                                 packet.size() - 1));
+  PackDataPacket(E131Header("foo", 150, 1, universe, false, true), frame,
+                 &packet);
+  OLA_ASSERT_FALSE(dmp_inflator.HandleDataPacket(&packet[0], packet.size()));
+  PackDataPacket(E131Header("foo", 150, 1, universe, false, false, true),
+                 frame, &packet);
+  OLA_ASSERT_FALSE(dmp_inflator.HandleDataPacket(&packet[0], packet.size()));
+  OLA_ASSERT_EQ(1u, m_dmx_count);
+}
+
+
+/*
+ * Check the receive statistics are kept for every source, merged or not.
+ */
+void E131InflatorTest::testSourceStats() {
+  const uint16_t universe = 1;
+  TimeStamp now;
+  ola::CachedClock clock(&now);
+  DMPE131Inflator dmp_inflator(true, &clock);
+  E131Inflator e131_inflator;
+  e131_inflator.AddInflator(&dmp_inflator);
+
+  DmxBuffer buffer;
+  uint8_t priority;
+  OLA_ASSERT_TRUE(dmp_inflator.SetHandler(
+        universe, &buffer, &priority,
+        NewCallback(this, &E131InflatorTest::DmxReceived)));
+
+  const CID cid1 = CID::Generate();
+  const CID cid2 = CID::Generate();
+  const DmxBuffer data(string("\010\000", 2));
+  InflateDMX(&e131_inflator, 0, 0, data, cid1);
+  // A backup at a lower priority.
+  InflateDMX(&e131_inflator, 7, 0, data, cid2, 50);
+
+  now += TimeInterval(0, 20000);
+  InflateDMX(&e131_inflator, 1, 0, data, cid1);
+  InflateDMX(&e131_inflator, 1, 0, data, cid1);
+  now += TimeInterval(0, 20000);
+  InflateDMX(&e131_inflator, 4, 0, data, cid1);
+  InflateDMX(&e131_inflator, 3, 0, data, cid1);
+  now += TimeInterval(0, 30000);
+  InflateDMX(&e131_inflator, 5, 0, data, cid1);
+
+  vector<DMPE131Inflator::SourceStats> stats;
+  dmp_inflator.GetSourceStats(&stats);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), stats.size());
+  if (stats[0].cid != cid1) {
+    std::swap(stats[0], stats[1]);
+  }
+
+  OLA_ASSERT_TRUE(cid1 == stats[0].cid);
+  OLA_ASSERT_EQ(universe, stats[0].universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), stats[0].priority);
+  OLA_ASSERT_TRUE(stats[0].merged);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(6), stats[0].packets);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(2), stats[0].sequence_gaps);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), stats[0].out_of_order);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), stats[0].duplicates);
+  // The intervals were 20ms, 20ms and 30ms.
+  OLA_ASSERT_EQ(TimeInterval(0, 21250), stats[0].mean_interval);
+  OLA_ASSERT_EQ(TimeInterval(0, 625), stats[0].jitter);
+
+  OLA_ASSERT_TRUE(cid2 == stats[1].cid);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(50), stats[1].priority);
+  OLA_ASSERT_FALSE(stats[1].merged);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), stats[1].packets);
+
+  // The statistics expire with the sources.
+  for (unsigned int i = 0; i <= DMPE131Inflator::EXPIRY_SCANS; i++) {
+    dmp_inflator.ExpireSources();
+  }
+  dmp_inflator.GetSourceStats(&stats);
+  OLA_ASSERT_TRUE(stats.empty());
+}
+
+
+/*
+ * Check a shorter source timeout scans more often, so a backup source takes
+ * over sooner.
+ */
+void E131InflatorTest::testSourceTimeout() {
+  const uint16_t universe = 1;
+  m_dmx_count = 0;
+
+  DMPE131Inflator dmp_inflator(true);
+  OLA_ASSERT_EQ(500u, dmp_inflator.ExpiryScanInterval());
+  dmp_inflator.SetSourceTimeout(10);
+  OLA_ASSERT_EQ(10u, dmp_inflator.ExpiryScanInterval());
+  dmp_inflator.SetSourceTimeout(200);
+  OLA_ASSERT_EQ(40u, dmp_inflator.ExpiryScanInterval());
+
+  E131Inflator e131_inflator;
+  e131_inflator.AddInflator(&dmp_inflator);
+  DmxBuffer buffer;
+  uint8_t priority;
+  OLA_ASSERT_TRUE(dmp_inflator.SetHandler(
+        universe, &buffer, &priority,
+        NewCallback(this, &E131InflatorTest::DmxReceived)));
+
+  const CID main_cid = CID::Generate();
+  const CID backup_cid = CID::Generate();
+  const DmxBuffer main_data(string("\010\000", 2));
+  const DmxBuffer backup_data(string("\000\020", 2));
+  InflateDMX(&e131_inflator, 0, 0, main_data, main_cid, 150);
+  InflateDMX(&e131_inflator, 0, 0, backup_data, backup_cid);
+  OLA_ASSERT_EQ(1u, m_dmx_count);
+  OLA_ASSERT_EQ(main_data, buffer);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), priority);
+
+  // The main source goes quiet.
+  for (unsigned int i = 0; i <= DMPE131Inflator::EXPIRY_SCANS; i++) {
+    dmp_inflator.ExpireSources();
+    InflateDMX(&e131_inflator, static_cast<uint8_t>(i + 1), 0, backup_data,
+               backup_cid);
+  }
+  InflateDMX(&e131_inflator, DMPE131Inflator::EXPIRY_SCANS + 2, 0,
+             backup_data, backup_cid);
+  OLA_ASSERT_EQ(backup_data, buffer);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), priority);
+}
+
+
+/*
+ * Inflate an E1.31 DMX packet for universe 1.
+ */
+void E131InflatorTest::InflateDMX(E131Inflator *inflator, uint8_t sequence,
+                                  uint16_t sync_address,
+                                  const DmxBuffer &buffer,
+                                  const CID &cid,
+                                  uint8_t priority) {
+  uint8_t dmx_data[DMX_UNIVERSE_SIZE + 1];
+  unsigned int length = DMX_UNIVERSE_SIZE;
+  dmx_data[0] = DMX512_START_CODE;
+  buffer.Get(dmx_data + 1, &length);
+  length++;
+
+  TwoByteRangeDMPAddress range_addr(0, 1, static_cast<uint16_t>(length));
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr, dmx_data,
+                                                     length);
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  auto_ptr<const DMPPDU> dmp_pdu(
+      NewRangeDMPSetProperty<uint16_t>(true, false, ranged_chunks));
+
+  E131Header header("foo", priority, sequence, 1);
+  header.SetSyncAddress(sync_address);
+  E131PDU pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu.get());
+
+  unsigned int size = pdu.Size();
+  vector<uint8_t> data(size);
+  OLA_ASSERT(pdu.Pack(&data[0], &size));
+  RootHeader root_header;
+  root_header.SetCid(cid);
+  HeaderSet header_set;
+  header_set.SetRootHeader(root_header);
+  OLA_ASSERT_EQ(size, inflator->InflatePDUBlock(&header_set, &data[0], size));
+}
+
+
+/*
+ * Pack an E1.31 DMX packet, starting from the root layer.
+ */
+void E131InflatorTest::PackDataPacket(const E131Header &header,
+                                      const DmxBuffer &buffer,
+                                      vector<uint8_t> *packet) {
+  uint8_t dmx_data[DMX_UNIVERSE_SIZE + 1];
+  unsigned int length = DMX_UNIVERSE_SIZE;
+  dmx_data[0] = DMX512_START_CODE;
+  buffer.Get(dmx_data + 1, &length);
+  length++;
+
+  TwoByteRangeDMPAddress range_addr(0, 1, static_cast<uint16_t>(length));
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr, dmx_data,
+                                                     length);
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  auto_ptr<const DMPPDU> dmp_pdu(
+      NewRangeDMPSetProperty<uint16_t>(true, false, ranged_chunks));
+
+  E131PDU pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu.get());
+  PDUBlock<PDU> block;
+  block.AddPDU(&pdu);
+  RootPDU root_pdu(header.UsingRev2() ? ola::acn::VECTOR_ROOT_E131_REV2 :
+                   ola::acn::VECTOR_ROOT_E131,
+                   CID::Generate(), &block);
+
+  unsigned int size = root_pdu.Size();
+  packet->resize(size);
+  OLA_ASSERT(root_pdu.Pack(&(*packet)[0], &size));
+  OLA_ASSERT_EQ(packet->size(), static_cast<size_t>(size));
+}
+
+
+/*
+ * Inflate a synchronization packet.
+ */
+void E131InflatorTest::InflateSync(E131ExtendedInflator *inflator,
+                                   uint16_t sync_address) {
+  E131SyncPDU pdu(0, sync_address);
+  uint8_t data[11];
+  unsigned int size = sizeof(data);
+  OLA_ASSERT(pdu.Pack(data, &size));
+  HeaderSet header_set;
+  OLA_ASSERT_EQ(size, inflator->InflatePDUBlock(&header_set, data, size));
+}
 }  // namespace acn
 }  // namespace ola
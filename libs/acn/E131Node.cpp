@@ -27,8 +27,11 @@
 #include <vector>
 #include "ola/Constants.h"
 #include "ola/Logging.h"
+#include "ola/dmx/SourcePriorities.h"
 #include "ola/network/InterfacePicker.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/util/Trace.h"
+#include "ola/util/Utils.h"
 #include "libs/acn/E131Node.h"
 
 namespace ola {
@@ -38,6 +41,8 @@ using ola::Callback0;
 using ola::DmxBuffer;
 using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
+using ola::network::IPV6Address;
+using ola::network::IPV6SocketAddress;
 using ola::network::HostToNetwork;
 using std::auto_ptr;
 using std::map;
@@ -45,21 +50,30 @@ using std::string;
 using std::set;
 using std::vector;
 
+namespace {
+/*
+ * The interface index to use for IPv6 multicast, 0 lets the kernel choose.
+ */
+unsigned int MulticastIndex(const ola::network::Interface &iface) {
+  return iface.index > 0 ? static_cast<unsigned int>(iface.index) : 0;
+}
+}  // namespace
+
 class TrackedSource {
  public:
-  TrackedSource()
+  explicit TrackedSource(const ola::acn::CID &cid)
       : clean_counter(0),
         current_sequence_number(0),
         total_pages(0) {
+    controller.cid = cid;
   }
 
-  IPV4Address ip_address;
-  string source_name;
-  set<uint16_t> universes;
+  E131Node::KnownController controller;
 
   uint8_t clean_counter;
 
-  void NewPage(uint8_t page_number, uint8_t last_page,
+  // Returns true if this completed a set of pages with different universes.
+  bool NewPage(uint8_t page_number, uint8_t last_page,
                uint32_t sequence_number,
                const vector<uint16_t> &universes);
 
@@ -70,7 +84,7 @@ class TrackedSource {
   set<uint16_t> new_universes;
 };
 
-void TrackedSource::NewPage(uint8_t page_number, uint8_t last_page,
+bool TrackedSource::NewPage(uint8_t page_number, uint8_t last_page,
                             uint32_t sequence_number,
                             const vector<uint16_t> &rx_universes) {
   clean_counter = 0;
@@ -94,17 +108,23 @@ void TrackedSource::NewPage(uint8_t page_number, uint8_t last_page,
   set<uint8_t>::const_iterator iter = received_pages.begin();
   for (; iter != received_pages.end(); ++iter) {
     if (*iter != expected_page)
-      return;
+      return false;
 
     expected_page++;
   }
 
-  if (expected_page == total_pages + 1) {
-    universes = new_universes;
-    received_pages.clear();
-    new_universes.clear();
-    total_pages = 0;
+  if (expected_page != total_pages + 1) {
+    return false;
+  }
+
+  bool changed = new_universes != controller.universes;
+  if (changed) {
+    controller.universes.swap(new_universes);
   }
+  received_pages.clear();
+  new_universes.clear();
+  total_pages = 0;
+  return changed;
 }
 
 E131Node::E131Node(ola::thread::SchedulerInterface *ss,
@@ -115,13 +135,21 @@ E131Node::E131Node(ola::thread::SchedulerInterface *ss,
       m_options(options),
       m_preferred_ip(ip_address),
       m_cid(cid),
+      m_memberships(&m_socket),
       m_root_sender(m_cid),
-      m_e131_sender(&m_socket, &m_root_sender),
+      m_e131_sender(&m_socket, &m_root_sender, options.use_ipv6),
       m_dmp_inflator(options.ignore_preview),
       m_discovery_inflator(NewCallback(this, &E131Node::NewDiscoveryPage)),
-      m_incoming_udp_transport(&m_socket, &m_root_inflator),
+      m_extended_inflator(NewCallback(&m_dmp_inflator,
+                                      &DMPE131Inflator::HandleSync)),
+      m_incoming_udp_transport(&m_socket, &m_root_inflator,
+                               options.recv_batch_size),
+      m_xdp_receiver(NULL),
       m_send_buffer(NULL),
-      m_discovery_timeout(ola::thread::INVALID_TIMEOUT) {
+      m_batch_depth(0),
+      m_source_expiry_timeout(ola::thread::INVALID_TIMEOUT),
+      m_discovery_timeout(ola::thread::INVALID_TIMEOUT),
+      m_discovery_pages_stale(true) {
 
 
   if (!m_options.use_rev2) {
@@ -133,9 +161,15 @@ E131Node::E131Node(ola::thread::SchedulerInterface *ss,
   // setup all the inflators
   m_root_inflator.AddInflator(&m_e131_inflator);
   m_root_inflator.AddInflator(&m_e131_rev2_inflator);
+  m_root_inflator.AddInflator(&m_extended_inflator);
   m_e131_inflator.AddInflator(&m_dmp_inflator);
   m_e131_inflator.AddInflator(&m_discovery_inflator);
   m_e131_rev2_inflator.AddInflator(&m_dmp_inflator);
+  m_dmp_inflator.SetSourceTimeout(m_options.source_timeout_ms);
+
+  // standard data packets skip the inflators
+  m_incoming_udp_transport.SetFastPath(
+      NewCallback(&m_dmp_inflator, &DMPE131Inflator::HandleDataPacket));
 }
 
 
@@ -167,30 +201,48 @@ bool E131Node::Start() {
     return false;
   }
 
-  if (!m_socket.Init()) {
-    return false;
-  }
+  if (m_options.use_ipv6) {
+    if (!m_socket.InitV6()) {
+      return false;
+    }
 
-  if (!m_socket.Bind(
-        IPV4SocketAddress(IPV4Address::WildCard(), m_options.port)))
-    return false;
+    if (!m_socket.Bind(
+          IPV6SocketAddress(IPV6Address::WildCard(), m_options.port)))
+      return false;
 
-  if (!m_socket.EnableBroadcast())
-    return false;
+    m_socket.SetMulticastInterfaceIndex(MulticastIndex(m_interface));
+  } else {
+    if (!m_socket.Init()) {
+      return false;
+    }
+
+    if (!m_socket.Bind(
+          IPV4SocketAddress(IPV4Address::WildCard(), m_options.port)))
+      return false;
+
+    if (!m_socket.EnableBroadcast())
+      return false;
+
+    m_socket.SetMulticastInterface(m_interface.ip_address);
+  }
 
   m_socket.SetTos(m_options.dscp);
-  m_socket.SetMulticastInterface(m_interface.ip_address);
+  if (m_options.max_pacing_rate) {
+    m_socket.SetMaxPacingRate(m_options.max_pacing_rate);
+  }
+  m_socket.EnableReceiveStats(m_options.receive_options);
+  m_socket.SetEdgeTriggered(true);
+  m_socket.SetPriority(ola::io::DESCRIPTOR_PRIORITY_HIGH);
 
   m_socket.SetOnData(NewCallback(&m_incoming_udp_transport,
                                  &IncomingUDPTransport::Receive));
 
-  if (m_options.enable_draft_discovery) {
-    IPV4Address addr;
-    m_e131_sender.UniverseIP(DISCOVERY_UNIVERSE_ID, &addr);
+  m_source_expiry_timeout = m_ss->RegisterRepeatingTimeout(
+      m_dmp_inflator.ExpiryScanInterval(),
+      ola::NewCallback(this, &E131Node::ExpireSources));
 
-    if (!m_socket.JoinMulticast(m_interface.ip_address, addr)) {
-      OLA_WARN << "Failed to join multicast group " << addr;
-    }
+  if (m_options.enable_draft_discovery) {
+    JoinUniverse(DISCOVERY_UNIVERSE_ID);
 
     m_discovery_timeout = m_ss->RegisterRepeatingTimeout(
         UNIVERSE_DISCOVERY_INTERVAL,
@@ -200,11 +252,33 @@ bool E131Node::Start() {
 }
 
 bool E131Node::Stop() {
+  m_ss->RemoveTimeout(m_source_expiry_timeout);
+  m_source_expiry_timeout = ola::thread::INVALID_TIMEOUT;
   m_ss->RemoveTimeout(m_discovery_timeout);
   m_discovery_timeout = ola::thread::INVALID_TIMEOUT;
+  if (m_xdp_receiver) {
+    m_xdp_receiver->RemovePort(m_options.port);
+    m_xdp_receiver = NULL;
+  }
   return true;
 }
 
+void E131Node::SetXDPReceiver(ola::network::XDPReceiver *receiver) {
+  if (m_xdp_receiver || !receiver) {
+    return;
+  }
+  if (m_options.use_ipv6) {
+    OLA_WARN << "AF_XDP isn't supported with IPv6, using the socket";
+    return;
+  }
+  if (receiver->AddPort(
+        m_options.port,
+        NewCallback(&m_incoming_udp_transport,
+                    &IncomingUDPTransport::HandleDatagram))) {
+    m_xdp_receiver = receiver;
+  }
+}
+
 bool E131Node::SetSourceName(uint16_t universe, const string &source) {
   ActiveTxUniverses::iterator iter = m_tx_universes.find(universe);
 
@@ -213,6 +287,30 @@ bool E131Node::SetSourceName(uint16_t universe, const string &source) {
     settings->source = source;
   } else {
     iter->second.source = source;
+    iter->second.dmx_packet.data.clear();
+    iter->second.slot_priority_packet.data.clear();
+  }
+  return true;
+}
+
+bool E131Node::SetSyncUniverse(uint16_t universe, uint16_t sync_universe) {
+  if (m_options.use_rev2 && sync_universe) {
+    OLA_WARN << "Synchronization isn't supported by E1.31 Rev 0.2";
+    return false;
+  }
+
+  ActiveTxUniverses::iterator iter = m_tx_universes.find(universe);
+  tx_universe *settings;
+  if (iter == m_tx_universes.end()) {
+    settings = SetupOutgoingSettings(universe);
+  } else {
+    settings = &iter->second;
+  }
+
+  if (settings->sync_universe != sync_universe) {
+    settings->sync_universe = sync_universe;
+    settings->dmx_packet.data.clear();
+    settings->slot_priority_packet.data.clear();
   }
   return true;
 }
@@ -235,7 +333,9 @@ bool E131Node::TerminateStream(uint16_t universe, uint8_t priority) {
   for (unsigned int i = 0; i < 3; i++) {
     SendStreamTerminated(universe, DmxBuffer(), priority);
   }
-  STLRemove(&m_tx_universes, universe);
+  if (STLRemove(&m_tx_universes, universe)) {
+    m_discovery_pages_stale = true;
+  }
   return true;
 }
 
@@ -252,6 +352,29 @@ bool E131Node::SendDMXWithSequenceOffset(uint16_t universe,
                                          int8_t sequence_offset,
                                          uint8_t priority,
                                          bool preview) {
+  return SendDMPData(universe, DMX512_START_CODE, buffer, sequence_offset,
+                     priority, preview);
+}
+
+bool E131Node::SendSlotPriorities(uint16_t universe,
+                                  const ola::DmxBuffer &slot_priorities,
+                                  uint8_t priority,
+                                  bool preview) {
+  if (m_options.use_rev2) {
+    OLA_DEBUG << "Per-slot priorities aren't supported by E1.31 Rev 0.2";
+    return false;
+  }
+  return SendDMPData(universe, ola::dmx::SLOT_PRIORITY_START_CODE,
+                     slot_priorities, 0, priority, preview);
+}
+
+bool E131Node::SendDMPData(uint16_t universe,
+                           uint8_t start_code,
+                           const ola::DmxBuffer &buffer,
+                           int8_t sequence_offset,
+                           uint8_t priority,
+                           bool preview) {
+  OLA_TRACE_SCOPE("e131", "E131Node::SendDMPData");
   ActiveTxUniverses::iterator iter = m_tx_universes.find(universe);
   tx_universe *settings;
 
@@ -261,41 +384,84 @@ bool E131Node::SendDMXWithSequenceOffset(uint16_t universe,
     settings = &iter->second;
   }
 
-  const uint8_t *dmp_data;
-  unsigned int dmp_data_length;
+  packet_template *packet = (start_code == DMX512_START_CODE) ?
+      &settings->dmx_packet : &settings->slot_priority_packet;
 
-  if (m_options.use_rev2) {
-    dmp_data = buffer.GetRaw();
-    dmp_data_length = buffer.Size();
-  } else {
-    unsigned int data_size = DMX_UNIVERSE_SIZE;
-    buffer.Get(m_send_buffer + 1, &data_size);
-    dmp_data = m_send_buffer;
-    dmp_data_length = data_size + 1;
+  unsigned int dmp_data_length = std::min(
+      buffer.Size(), static_cast<unsigned int>(DMX_UNIVERSE_SIZE));
+  if (!m_options.use_rev2) {
+    dmp_data_length++;  // the start code
   }
 
-  TwoByteRangeDMPAddress range_addr(0, 1, (uint16_t) dmp_data_length);
-  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr,
-                                                     dmp_data,
-                                                     dmp_data_length);
-  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
-  ranged_chunks.push_back(range_chunk);
-  const DMPPDU *pdu = NewRangeDMPSetProperty<uint16_t>(true,
-                                                       false,
-                                                       ranged_chunks);
-
-  E131Header header(settings->source,
-                    priority,
-                    static_cast<uint8_t>(settings->sequence + sequence_offset),
-                    universe,
-                    preview,  // preview
-                    false,  // terminated
-                    m_options.use_rev2);
+  if (packet->data.empty() || packet->dmp_data_length != dmp_data_length ||
+      packet->preview != preview) {
+    const uint8_t *dmp_data;
+    if (m_options.use_rev2) {
+      dmp_data = buffer.GetRaw();
+    } else {
+      unsigned int data_size = DMX_UNIVERSE_SIZE;
+      m_send_buffer[0] = start_code;
+      buffer.Get(m_send_buffer + 1, &data_size);
+      dmp_data = m_send_buffer;
+    }
+    if (!BuildPacketTemplate(universe, *settings, dmp_data, dmp_data_length,
+                             preview, packet)) {
+      return false;
+    }
+  }
 
-  bool result = m_e131_sender.SendDMP(header, pdu);
+  packet->data[E131Sender::PriorityOffset(m_options.use_rev2)] = priority;
+  packet->data[E131Sender::SequenceOffset(m_options.use_rev2)] =
+      static_cast<uint8_t>(settings->sequence + sequence_offset);
+
+  // The template stops before the slot data, which is sent straight from the
+  // DmxBuffer.
+  const unsigned int slot_count = m_options.use_rev2 ?
+      dmp_data_length : dmp_data_length - 1;
+  bool result = m_e131_sender.SendPacked(
+      universe, &packet->data[0],
+      static_cast<unsigned int>(packet->data.size()),
+      buffer.GetRaw(), slot_count);
   if (result && !sequence_offset)
     settings->sequence++;
-  delete pdu;
+
+  if (result && settings->sync_universe) {
+    if (m_batch_depth) {
+      m_pending_syncs.insert(settings->sync_universe);
+    } else {
+      result = SendSync(settings->sync_universe);
+    }
+  }
+  return result;
+}
+
+bool E131Node::SendSync(uint16_t sync_universe) {
+  uint8_t &sequence = m_sync_sequences[sync_universe];
+  bool result = m_e131_sender.SendSync(sync_universe, sequence);
+  if (result)
+    sequence++;
+  return result;
+}
+
+void E131Node::BeginBatch() {
+  m_batch_depth++;
+  m_socket.BeginSendBatch();
+}
+
+bool E131Node::EndBatch() {
+  bool result = true;
+  if (m_batch_depth == 1) {
+    // The sync packets go at the end of the batch, after all the data.
+    set<uint16_t>::const_iterator iter = m_pending_syncs.begin();
+    for (; iter != m_pending_syncs.end(); ++iter) {
+      result &= SendSync(*iter);
+    }
+    m_pending_syncs.clear();
+  }
+  if (m_batch_depth) {
+    m_batch_depth--;
+  }
+  result &= m_socket.EndSendBatch();
   return result;
 }
 
@@ -316,6 +482,7 @@ bool E131Node::SendStreamTerminated(uint16_t universe,
   }
 
   unsigned int data_size = DMX_UNIVERSE_SIZE;
+  m_send_buffer[0] = DMX512_START_CODE;
   buffer.Get(m_send_buffer + 1, &data_size);
   data_size++;
 
@@ -346,52 +513,142 @@ bool E131Node::SendStreamTerminated(uint16_t universe,
 bool E131Node::SetHandler(uint16_t universe,
                           DmxBuffer *buffer,
                           uint8_t *priority,
-                          Callback0<void> *closure) {
+                          Callback0<void> *closure,
+                          DmxBuffer *slot_priorities,
+                          uint16_t sync_universe) {
+  // Replacing a handler doesn't join the group again.
+  if (!m_dmp_inflator.HasHandler(universe) && !JoinUniverse(universe)) {
+    return false;
+  }
+
+  uint16_t old_sync_universe = 0;
+  if (STLLookupAndRemove(&m_rx_sync_universes, universe,
+                         &old_sync_universe)) {
+    LeaveSyncUniverse(old_sync_universe);
+  }
+  if (sync_universe) {
+    JoinSyncUniverse(sync_universe);
+    m_rx_sync_universes[universe] = sync_universe;
+  }
+
+  return m_dmp_inflator.SetHandler(universe, buffer, priority, closure,
+                                   slot_priorities, sync_universe != 0);
+}
+
+bool E131Node::RemoveHandler(uint16_t universe) {
+  if (!LeaveUniverse(universe)) {
+    return false;
+  }
+
+  uint16_t sync_universe = 0;
+  if (STLLookupAndRemove(&m_rx_sync_universes, universe, &sync_universe)) {
+    LeaveSyncUniverse(sync_universe);
+  }
+  return m_dmp_inflator.RemoveHandler(universe);
+}
+
+
+void E131Node::GetKnownControllers(std::vector<KnownController> *controllers) {
+  controllers->reserve(controllers->size() + m_discovered_sources.size());
+  TrackedSources::const_iterator iter = m_discovered_sources.begin();
+  for (; iter != m_discovered_sources.end(); ++iter) {
+    controllers->push_back(iter->second->controller);
+  }
+}
+
+
+void E131Node::GetSourceStats(vector<SourceStats> *stats) const {
+  m_dmp_inflator.GetSourceStats(stats);
+}
+
+
+void E131Node::SetControllerChangeCallback(
+    ControllerChangeCallback *callback) {
+  m_controller_callback.reset(callback);
+}
+
+/*
+ * Join the IPv4 or IPv6 multicast group for a universe.
+ */
+bool E131Node::JoinUniverse(uint16_t universe) {
+  if (m_options.use_ipv6) {
+    IPV6Address addr;
+    if (!m_e131_sender.UniverseIPV6(universe, &addr)) {
+      OLA_WARN << "Unable to determine multicast group for universe " <<
+        universe;
+      return false;
+    }
+    if (!m_memberships.Join(MulticastIndex(m_interface), addr)) {
+      OLA_WARN << "Failed to join multicast group " << addr;
+      return false;
+    }
+    return true;
+  }
+
   IPV4Address addr;
   if (!m_e131_sender.UniverseIP(universe, &addr)) {
     OLA_WARN << "Unable to determine multicast group for universe " <<
       universe;
     return false;
   }
-
-  if (!m_socket.JoinMulticast(m_interface.ip_address, addr)) {
+  if (!m_memberships.Join(m_interface.ip_address, addr)) {
     OLA_WARN << "Failed to join multicast group " << addr;
     return false;
   }
-
-  return m_dmp_inflator.SetHandler(universe, buffer, priority, closure);
+  return true;
 }
 
-bool E131Node::RemoveHandler(uint16_t universe) {
+
+/*
+ * Leave the IPv4 or IPv6 multicast group for a universe.
+ */
+bool E131Node::LeaveUniverse(uint16_t universe) {
+  if (m_options.use_ipv6) {
+    IPV6Address addr;
+    if (!m_e131_sender.UniverseIPV6(universe, &addr)) {
+      OLA_WARN << "Unable to determine multicast group for universe " <<
+        universe;
+      return false;
+    }
+    if (!m_memberships.Leave(MulticastIndex(m_interface), addr)) {
+      OLA_WARN << "Failed to leave multicast group " << addr;
+      return false;
+    }
+    return true;
+  }
+
   IPV4Address addr;
   if (!m_e131_sender.UniverseIP(universe, &addr)) {
     OLA_WARN << "Unable to determine multicast group for universe " <<
       universe;
     return false;
   }
-
-  if (!m_socket.LeaveMulticast(m_interface.ip_address, addr)) {
+  if (!m_memberships.Leave(m_interface.ip_address, addr)) {
     OLA_WARN << "Failed to leave multicast group " << addr;
     return false;
   }
-
-  return m_dmp_inflator.RemoveHandler(universe);
+  return true;
 }
 
 
-void E131Node::GetKnownControllers(std::vector<KnownController> *controllers) {
-  TrackedSources::const_iterator iter = m_discovered_sources.begin();
-  for (; iter != m_discovered_sources.end(); ++iter) {
-    controllers->push_back(KnownController());
-    KnownController &controller = controllers->back();
+/*
+ * Join the multicast group for a sync universe. The memberships are reference
+ * counted, so many universes can share the sync universe.
+ */
+void E131Node::JoinSyncUniverse(uint16_t sync_universe) {
+  JoinUniverse(sync_universe);
+}
 
-    controller.cid = iter->first;
-    controller.ip_address = iter->second->ip_address;
-    controller.source_name = iter->second->source_name;
-    controller.universes = iter->second->universes;
-  }
+
+/*
+ * Leave the multicast group for a sync universe, once no other universe is
+ * using it.
+ */
+void E131Node::LeaveSyncUniverse(uint16_t sync_universe) {
+  LeaveUniverse(sync_universe);
 }
 
+
 /*
  * Create a settings entry for an outgoing universe
  */
@@ -399,22 +656,77 @@ E131Node::tx_universe *E131Node::SetupOutgoingSettings(uint16_t universe) {
   tx_universe settings;
   settings.source = m_options.source_name;
   settings.sequence = 0;
+  settings.sync_universe = 0;
   ActiveTxUniverses::iterator iter =
       m_tx_universes.insert(std::make_pair(universe, settings)).first;
+  m_discovery_pages_stale = true;
   return &iter->second;
 }
 
 
+/*
+ * Pack a DMP packet for a universe so it can be reused for later frames. Only
+ * the headers, and the start code, are kept; the slot data is sent from the
+ * DmxBuffer for each frame.
+ */
+bool E131Node::BuildPacketTemplate(uint16_t universe,
+                                   const tx_universe &settings,
+                                   const uint8_t *dmp_data,
+                                   unsigned int dmp_data_length,
+                                   bool preview,
+                                   packet_template *packet) {
+  TwoByteRangeDMPAddress range_addr(0, 1, (uint16_t) dmp_data_length);
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr,
+                                                     dmp_data,
+                                                     dmp_data_length);
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  auto_ptr<const DMPPDU> pdu(
+      NewRangeDMPSetProperty<uint16_t>(true, false, ranged_chunks));
+
+  // The priority and sequence number are filled in by the caller.
+  E131Header header(settings.source,
+                    0,  // priority
+                    0,  // sequence
+                    universe,
+                    preview,
+                    false,  // terminated
+                    m_options.use_rev2);
+  header.SetSyncAddress(settings.sync_universe);
+
+  packet->data.resize(PreamblePacker::MAX_DATAGRAM_SIZE);
+  unsigned int length = static_cast<unsigned int>(packet->data.size());
+  if (!m_e131_sender.PackDMP(header, pdu.get(), &packet->data[0], &length)) {
+    OLA_WARN << "Failed to pack E1.31 packet for universe " << universe;
+    packet->data.clear();
+    return false;
+  }
+  const unsigned int slot_count = m_options.use_rev2 ?
+      dmp_data_length : dmp_data_length - 1;
+  packet->data.resize(length - slot_count);
+  packet->dmp_data_length = dmp_data_length;
+  packet->preview = preview;
+  return true;
+}
+
+
+bool E131Node::ExpireSources() {
+  m_dmp_inflator.ExpireSources();
+  return true;
+}
+
+
 bool E131Node::PerformDiscoveryHousekeeping() {
   // Send the Universe Discovery packets.
-  vector<uint16_t> universes;
-  STLKeys(m_tx_universes, &universes);
+  if (m_discovery_pages_stale) {
+    BuildDiscoveryPages();
+  }
 
-  uint8_t last_page = static_cast<uint8_t>(
-    universes.size() / DISCOVERY_PAGE_SIZE);
-  uint32_t sequence_number = 0;
-  for (uint8_t i = 0; i <= last_page; i++) {
-    SendDiscoveryPage(universes, i, last_page, sequence_number);
+  E131Header header(m_options.source_name, 0, 0, DISCOVERY_UNIVERSE_ID);
+  vector<vector<uint8_t> >::const_iterator page = m_discovery_pages.begin();
+  for (; page != m_discovery_pages.end(); ++page) {
+    m_e131_sender.SendDiscoveryData(
+        header, &(*page)[0], static_cast<unsigned int>(page->size()));
   }
 
   // Delete any sources that we haven't heard from in 2 x
@@ -422,6 +734,9 @@ bool E131Node::PerformDiscoveryHousekeeping() {
   TrackedSources::iterator iter = m_discovered_sources.begin();
   while (iter != m_discovered_sources.end()) {
     if (iter->second->clean_counter >= 2) {
+      if (m_controller_callback.get()) {
+        m_controller_callback->Run(iter->second->controller, false);
+      }
       delete iter->second;
       OLA_INFO << "Removing " << iter->first.ToString() << " due to inactivity";
       m_discovered_sources.erase(iter++);
@@ -441,47 +756,68 @@ void E131Node::NewDiscoveryPage(
     return;
   }
 
+  const ola::acn::CID &cid = headers.GetRootHeader().GetCid();
+  const IPV4Address &ip_address = headers.GetTransportHeader().Source().Host();
+  const string &source_name = headers.GetE131Header().Source();
+
   TrackedSources::iterator iter = STLLookupOrInsertNull(
-      &m_discovered_sources,
-      headers.GetRootHeader().GetCid());
+      &m_discovered_sources, cid);
+  bool changed = false;
   if (!iter->second) {
-    iter->second = new TrackedSource();
-    iter->second->ip_address = headers.GetTransportHeader().Source().Host();
-    iter->second->source_name = headers.GetE131Header().Source();
+    iter->second = new TrackedSource(cid);
+    iter->second->controller.ip_address = ip_address;
+    iter->second->controller.source_name = source_name;
+    changed = true;
   }
 
-  TrackedSource *source = iter->second;
-  if (source->ip_address != headers.GetTransportHeader().Source().Host()) {
-    OLA_INFO << "CID " << headers.GetRootHeader().GetCid().ToString()
-             << " changed from " << source->ip_address << " to "
-             << headers.GetTransportHeader().Source().Host();
-    source->ip_address = headers.GetTransportHeader().Source().Host();
+  KnownController &controller = iter->second->controller;
+  if (controller.ip_address != ip_address) {
+    OLA_INFO << "CID " << cid.ToString() << " changed from "
+             << controller.ip_address << " to " << ip_address;
+    controller.ip_address = ip_address;
+    changed = true;
   }
-  source->source_name = headers.GetE131Header().Source();
-  source->NewPage(page.page_number, page.last_page, page.page_sequence,
-                  page.universes);
-}
-
-void E131Node::SendDiscoveryPage(const std::vector<uint16_t> &universes,
-                                 uint8_t this_page,
-                                 uint8_t last_page,
-                                 OLA_UNUSED uint32_t sequence_number) {
-  uint16_t in_this_page = static_cast<uint16_t>(this_page == last_page ?
-      universes.size() % DISCOVERY_PAGE_SIZE : DISCOVERY_PAGE_SIZE);
-
-  uint16_t *page_data = new uint16_t[in_this_page + 1];
-  page_data[0] = HostToNetwork(
-      static_cast<uint16_t>(this_page << 8 | last_page));
+  if (controller.source_name != source_name) {
+    controller.source_name = source_name;
+    changed = true;
+  }
+  changed |= iter->second->NewPage(page.page_number, page.last_page,
+                                   page.page_sequence, page.universes);
 
-  for (unsigned int i = 0; i < in_this_page; i++) {
-    page_data[i + 1] = HostToNetwork(
-        universes[this_page * DISCOVERY_PAGE_SIZE + i]);
+  if (changed && m_controller_callback.get()) {
+    m_controller_callback->Run(controller, true);
   }
+}
 
-  E131Header header(m_options.source_name, 0, 0, DISCOVERY_UNIVERSE_ID);
-  m_e131_sender.SendDiscoveryData(
-      header, reinterpret_cast<uint8_t*>(page_data), (in_this_page + 1) * 2);
-  delete[] page_data;
+/*
+ * Pack the discovery pages for the universes we're sending.
+ */
+void E131Node::BuildDiscoveryPages() {
+  const unsigned int universe_count =
+      static_cast<unsigned int>(m_tx_universes.size());
+  const uint8_t last_page = static_cast<uint8_t>(
+    universe_count / DISCOVERY_PAGE_SIZE);
+
+  m_discovery_pages.resize(last_page + 1);
+  ActiveTxUniverses::const_iterator universe = m_tx_universes.begin();
+  for (uint8_t i = 0; i <= last_page; i++) {
+    const unsigned int in_this_page = i == last_page ?
+        universe_count % DISCOVERY_PAGE_SIZE : DISCOVERY_PAGE_SIZE;
+
+    vector<uint8_t> &page = m_discovery_pages[i];
+    page.clear();
+    page.reserve((in_this_page + 1) * 2);
+    page.push_back(i);
+    page.push_back(last_page);
+    for (unsigned int j = 0; j < in_this_page; j++, ++universe) {
+      uint8_t universe_high;
+      uint8_t universe_low;
+      ola::utils::SplitUInt16(universe->first, &universe_high, &universe_low);
+      page.push_back(universe_high);
+      page.push_back(universe_low);
+    }
+  }
+  m_discovery_pages_stale = false;
 }
 }  // namespace acn
 }  // namespace ola
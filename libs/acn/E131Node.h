@@ -23,6 +23,7 @@
 #define LIBS_ACN_E131NODE_H_
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -36,10 +37,13 @@
 #include "ola/thread/SchedulerInterface.h"
 #include "ola/network/Interface.h"
 #include "ola/network/Socket.h"
+#include "ola/network/XDPReceiver.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/E131DiscoveryInflator.h"
+#include "libs/acn/E131ExtendedInflator.h"
 #include "libs/acn/E131Inflator.h"
 #include "libs/acn/E131Sender.h"
+#include "libs/acn/MembershipManager.h"
 #include "libs/acn/RootInflator.h"
 #include "libs/acn/RootSender.h"
 #include "libs/acn/UDPTransport.h"
@@ -56,19 +60,42 @@ class E131Node {
    public:
     Options()
        : use_rev2(false),
+         use_ipv6(false),
          ignore_preview(true),
          enable_draft_discovery(false),
          dscp(0),
+         max_pacing_rate(0),
          port(ola::acn::ACN_PORT),
+         recv_batch_size(16),
+         source_timeout_ms(DEFAULT_SOURCE_TIMEOUT_MS),
          source_name(ola::OLA_DEFAULT_INSTANCE_NAME) {
     }
 
     bool use_rev2;  /**< Use Revision 0.2 of the 2009 draft */
+    /**
+     * Send & receive on the IPv6 multicast groups, rather than the IPv4 ones.
+     */
+    bool use_ipv6;
     bool ignore_preview;  /**< Ignore preview data */
     bool enable_draft_discovery;  /**< Enable 2014 draft discovery */
     uint8_t dscp;  /**< The DSCP value to tag packets with */
+    /**
+     * The maximum rate to send at, in bytes per second, or 0 for no limit.
+     * The kernel spaces the packets out, so this works with batched sends.
+     */
+    uint32_t max_pacing_rate;
     uint16_t port; /**< The UDP port to use, defaults to ACN_PORT */
+    /** The maximum number of datagrams to read each time the socket is ready */
+    unsigned int recv_batch_size;
+    /**
+     * How long a source can go without sending before it's dropped from the
+     * merge, in milliseconds. A shorter timeout fails over to a backup source
+     * sooner, but the sources must keep sending faster than this.
+     */
+    unsigned int source_timeout_ms;
     std::string source_name; /**< The source name to use */
+    /** Kernel drop counting & receive buffer tuning for the socket */
+    ola::network::UDPReceiveOptions receive_options;
   };
 
   struct KnownController {
@@ -78,6 +105,17 @@ class E131Node {
     std::set<uint16_t> universes;
   };
 
+  /**
+   * @brief Called when a controller is discovered, changes, or expires.
+   *
+   * The bool is false if the controller has expired. The KnownController is
+   * only valid for the duration of the call.
+   */
+  typedef ola::Callback2<void, const KnownController&, bool>
+      ControllerChangeCallback;
+
+  typedef DMPE131Inflator::SourceStats SourceStats;
+
   /**
    * @brief Create a new E1.31 node.
    * @param ss the SchedulerInterface to use.
@@ -101,6 +139,16 @@ class E131Node {
    */
   bool Stop();
 
+  /**
+   * @brief Also receive E1.31 packets with an AF_XDP receiver.
+   * @param receiver the XDPReceiver to use, may be NULL. This must outlive the
+   *   node.
+   *
+   * This must be called after Start(), and only IPv4 is supported. The socket
+   * is still used for sending, and for packets the receiver doesn't see.
+   */
+  void SetXDPReceiver(ola::network::XDPReceiver *receiver);
+
   /**
    * @brief Set the name for a universe.
    * @param universe the id of the universe to send
@@ -108,6 +156,18 @@ class E131Node {
    */
   bool SetSourceName(uint16_t universe, const std::string &source);
 
+  /**
+   * @brief Set the synchronization universe for a universe we send on.
+   * @param universe the id of the universe to send
+   * @param sync_universe the universe to send sync packets on, 0 disables
+   *   synchronization.
+   *
+   * The sync packet is sent by the outermost EndBatch(), so all the universes
+   * sent in a batch are latched together. Outside of a batch it's sent after
+   * each packet. This isn't supported with Revision 0.2.
+   */
+  bool SetSyncUniverse(uint16_t universe, uint16_t sync_universe);
+
   /**
    * @brief Signal that we will start sending on this particular universe.
    *   Without sending any DMX data.
@@ -136,6 +196,43 @@ class E131Node {
                uint8_t priority = DEFAULT_PRIORITY,
                bool preview = false);
 
+  /**
+   * @brief Send per-slot priorities, using the 0xDD start code.
+   * @param universe the id of the universe to send
+   * @param slot_priorities the priority of each slot. 0 means the slot isn't
+   *   sourced.
+   * @param priority the priority to use
+   * @param preview set to true to turn on the preview bit
+   * @return true if it was sent successfully, false otherwise
+   *
+   * This isn't supported with Revision 0.2.
+   */
+  bool SendSlotPriorities(uint16_t universe,
+                          const ola::DmxBuffer &slot_priorities,
+                          uint8_t priority = DEFAULT_PRIORITY,
+                          bool preview = false);
+
+  /**
+   * @brief Send a synchronization packet.
+   * @param sync_universe the universe to send the sync packet on.
+   * @return true if it was sent successfully, false otherwise
+   */
+  bool SendSync(uint16_t sync_universe);
+
+  /**
+   * @brief Queue the packets sent until EndBatch() and send them together.
+   *
+   * Calls can be nested, the packets are sent by the outermost EndBatch().
+   */
+  void BeginBatch();
+
+  /**
+   * @brief Send the packets queued since BeginBatch(), followed by the sync
+   *   packets for the synchronized universes.
+   * @return false if any of the packets couldn't be sent.
+   */
+  bool EndBatch();
+
   /**
    * @brief Send some DMX data, allowing finer grained control of parameters.
    *
@@ -178,9 +275,15 @@ class E131Node {
    * @param priority the priority to set.
    * @param handler the Callback to call when there is data for this universe.
    *   Ownership is transferred.
+   * @param slot_priorities the DmxBuffer to copy the per-slot priorities to,
+   *   may be NULL. This is left empty if no source sent per-slot priorities.
+   * @param sync_universe if non-0, listen for sync packets on this universe
+   *   and hold synchronized data until the sync packet arrives.
    */
   bool SetHandler(uint16_t universe, ola::DmxBuffer *buffer,
-                  uint8_t *priority, ola::Callback0<void> *handler);
+                  uint8_t *priority, ola::Callback0<void> *handler,
+                  ola::DmxBuffer *slot_priorities = NULL,
+                  uint16_t sync_universe = 0);
 
   /**
    * @brief Remove the handler for a particular universe.
@@ -207,13 +310,49 @@ class E131Node {
    */
   void GetKnownControllers(std::vector<KnownController> *controllers);
 
+  /**
+   * @brief Set the callback to run when the known controllers change.
+   * @param callback the callback to run, ownership is transferred. Pass NULL
+   * to remove the callback.
+   *
+   * This avoids polling GetKnownControllers(), which copies every controller.
+   */
+  void SetControllerChangeCallback(ControllerChangeCallback *callback);
+
+  /**
+   * @brief Get the receive statistics for the sources sending to the
+   *   universes we're listening on.
+   * @param stats the vector to populate, one entry per source & universe.
+   */
+  void GetSourceStats(std::vector<SourceStats> *stats) const;
+
+  /**
+   * @brief The source timeout from E1.31, in milliseconds.
+   */
+  static const unsigned int DEFAULT_SOURCE_TIMEOUT_MS = 2500;
+
  private:
+  // A fully packed packet. Only the priority, sequence number and data are
+  // updated between frames, it's rebuilt if anything else changes.
+  struct packet_template {
+    std::vector<uint8_t> data;
+    unsigned int dmp_data_length;
+    bool preview;
+
+    packet_template() : dmp_data_length(0), preview(false) {}
+  };
+
   struct tx_universe {
     std::string source;
     uint8_t sequence;
+    uint16_t sync_universe;
+    packet_template dmx_packet;
+    packet_template slot_priority_packet;
   };
 
   typedef std::map<uint16_t, tx_universe> ActiveTxUniverses;
+  // sync universe to sequence number
+  typedef std::map<uint16_t, uint8_t> SyncSequences;
   typedef std::map<acn::CID, class TrackedSource*> TrackedSources;
 
   ola::thread::SchedulerInterface *m_ss;
@@ -223,6 +362,7 @@ class E131Node {
 
   ola::network::Interface m_interface;
   ola::network::UDPSocket m_socket;
+  MembershipManager m_memberships;
   // senders
   RootSender m_root_sender;
   E131Sender m_e131_sender;
@@ -232,22 +372,56 @@ class E131Node {
   E131InflatorRev2 m_e131_rev2_inflator;
   DMPE131Inflator m_dmp_inflator;
   E131DiscoveryInflator m_discovery_inflator;
+  E131ExtendedInflator m_extended_inflator;
 
   IncomingUDPTransport m_incoming_udp_transport;
+  ola::network::XDPReceiver *m_xdp_receiver;
   ActiveTxUniverses m_tx_universes;
   uint8_t *m_send_buffer;
 
+  // Synchronization members
+  unsigned int m_batch_depth;
+  SyncSequences m_sync_sequences;
+  // the sync universes to send once the current batch ends
+  std::set<uint16_t> m_pending_syncs;
+  // universe to the sync universe we listen on for it
+  std::map<uint16_t, uint16_t> m_rx_sync_universes;
+
+  ola::thread::timeout_id m_source_expiry_timeout;
+
   // Discovery members
   ola::thread::timeout_id m_discovery_timeout;
   TrackedSources m_discovered_sources;
+  std::auto_ptr<ControllerChangeCallback> m_controller_callback;
+  // The packed discovery pages for m_tx_universes, rebuilt when the set of
+  // universes changes.
+  std::vector<std::vector<uint8_t> > m_discovery_pages;
+  bool m_discovery_pages_stale;
 
   tx_universe *SetupOutgoingSettings(uint16_t universe);
+  bool BuildPacketTemplate(uint16_t universe,
+                           const tx_universe &settings,
+                           const uint8_t *dmp_data,
+                           unsigned int dmp_data_length,
+                           bool preview,
+                           packet_template *packet);
+  bool SendDMPData(uint16_t universe,
+                   uint8_t start_code,
+                   const ola::DmxBuffer &buffer,
+                   int8_t sequence_offset,
+                   uint8_t priority,
+                   bool preview);
+
+  bool JoinUniverse(uint16_t universe);
+  bool LeaveUniverse(uint16_t universe);
+  void JoinSyncUniverse(uint16_t sync_universe);
+  void LeaveSyncUniverse(uint16_t sync_universe);
 
+  bool ExpireSources();
   bool PerformDiscoveryHousekeeping();
   void NewDiscoveryPage(const HeaderSet &headers,
                         const E131DiscoveryInflator::DiscoveryPage &page);
-  void SendDiscoveryPage(const std::vector<uint16_t> &universes, uint8_t page,
-                         uint8_t last_page, uint32_t sequence_number);
+  void BuildDiscoveryPages();
 
   static const uint16_t DEFAULT_PRIORITY = 100;
   static const uint16_t UNIVERSE_DISCOVERY_INTERVAL = 10000;  // milliseconds
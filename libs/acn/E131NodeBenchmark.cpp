@@ -0,0 +1,255 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131NodeBenchmark.cpp
+ * Measures the receive path of the E131Node.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/acn/ACNPort.h"
+#include "ola/base/Array.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/testing/Benchmark.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "ola/testing/UDPCapture.h"
+#include "libs/acn/DMPE131Inflator.h"
+#include "libs/acn/E131Inflator.h"
+#include "libs/acn/E131Node.h"
+#include "libs/acn/RootInflator.h"
+#include "libs/acn/UDPTransport.h"
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::acn::DMPE131Inflator;
+using ola::acn::E131Inflator;
+using ola::acn::E131Node;
+using ola::acn::IncomingUDPTransport;
+using ola::acn::RootInflator;
+using ola::network::IPV4Address;
+using ola::testing::Benchmark;
+using ola::testing::MockUDPSocket;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Offsets into an E1.31 data packet.
+enum {
+  ROOT_VECTOR_OFFSET = 18,
+  FRAMING_VECTOR_OFFSET = 40,
+  SEQUENCE_OFFSET = 111,
+  UNIVERSE_OFFSET = 113,
+  DMP_SLOTS_OFFSET = 125,
+};
+
+/*
+ * Build an E1.31 data packet for a universe.
+ */
+string BuildDataPacket(uint16_t universe) {
+  const unsigned int size = DMP_SLOTS_OFFSET + 1 + ola::DMX_UNIVERSE_SIZE;
+  uint8_t packet[size];
+  memset(packet, 0, size);
+  const uint8_t preamble[] = {
+    0x00, 0x10, 0x00, 0x00,
+    'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0x00, 0x00, 0x00,
+  };
+  memcpy(packet, preamble, sizeof(preamble));
+
+  // root layer
+  packet[16] = 0x70 | ((size - 16) >> 8);
+  packet[17] = (size - 16) & 0xff;
+  packet[ROOT_VECTOR_OFFSET + 3] = 0x04;
+  for (unsigned int i = 0; i < 16; i++) {
+    packet[22 + i] = static_cast<uint8_t>(i + 1);  // CID
+  }
+
+  // framing layer
+  packet[38] = 0x70 | ((size - 38) >> 8);
+  packet[39] = (size - 38) & 0xff;
+  packet[FRAMING_VECTOR_OFFSET + 3] = 0x02;
+  memcpy(packet + 44, "Benchmark", 9);
+  packet[108] = 100;  // priority
+  packet[UNIVERSE_OFFSET] = universe >> 8;
+  packet[UNIVERSE_OFFSET + 1] = universe & 0xff;
+
+  // DMP layer
+  packet[115] = 0x70 | ((size - 115) >> 8);
+  packet[116] = (size - 115) & 0xff;
+  packet[117] = 0x02;  // set property
+  packet[118] = 0xa1;  // address & data type
+  packet[122] = 0x01;  // address increment
+  packet[123] = (ola::DMX_UNIVERSE_SIZE + 1) >> 8;
+  packet[124] = (ola::DMX_UNIVERSE_SIZE + 1) & 0xff;
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    packet[DMP_SLOTS_OFFSET + 1 + i] = static_cast<uint8_t>(i * 7 + universe);
+  }
+  return string(reinterpret_cast<char*>(packet), size);
+}
+
+
+bool IsDataPacket(const string &packet) {
+  return packet.size() > DMP_SLOTS_OFFSET &&
+      packet[ROOT_VECTOR_OFFSET + 3] == 0x04 &&
+      packet[FRAMING_VECTOR_OFFSET + 3] == 0x02;
+}
+
+
+/*
+ * The E131Node owns a UDPSocket, so this builds the same receive chain as the
+ * node, around a MockUDPSocket.
+ */
+class E131NodeBenchmark {
+ public:
+  E131NodeBenchmark()
+      : m_dmp_inflator(E131Node::Options().ignore_preview),
+        m_frames(0) {
+    ola::network::IPV4Address::FromString("10.0.0.10", &m_peer);
+    m_root_inflator.AddInflator(&m_e131_inflator);
+    m_e131_inflator.AddInflator(&m_dmp_inflator);
+  }
+
+  ~E131NodeBenchmark() { Reset(); }
+
+  /*
+   * Register handlers for the universes and replay the packets to them.
+   */
+  bool Setup(const vector<string> &packets,
+             const std::set<uint16_t> &universes) {
+    Reset();
+    m_packets = packets;
+    if (m_packets.empty()) {
+      return false;
+    }
+
+    m_socket.reset(new MockUDPSocket());
+    m_transport.reset(new IncomingUDPTransport(
+        m_socket.get(), &m_root_inflator,
+        E131Node::Options().recv_batch_size));
+    m_transport->SetFastPath(
+        NewCallback(&m_dmp_inflator, &DMPE131Inflator::HandleDataPacket));
+    m_socket->SetOnData(
+        NewCallback(m_transport.get(), &IncomingUDPTransport::Receive));
+
+    std::set<uint16_t>::const_iterator iter = universes.begin();
+    for (; iter != universes.end(); ++iter) {
+      m_dmp_inflator.SetHandler(
+          *iter, &m_buffers[*iter], &m_priorities[*iter],
+          NewCallback(this, &E131NodeBenchmark::NewFrame));
+      m_universes.push_back(*iter);
+    }
+    return true;
+  }
+
+  void Receive(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      string &packet = m_packets[i % m_packets.size()];
+      // Stale sequence numbers are dropped, so make each packet the newest.
+      if (IsDataPacket(packet)) {
+        packet[SEQUENCE_OFFSET]++;
+      }
+      m_socket->InjectData(reinterpret_cast<const uint8_t*>(packet.data()),
+                           packet.size(), m_peer, ola::acn::ACN_PORT);
+    }
+  }
+
+ private:
+  RootInflator m_root_inflator;
+  E131Inflator m_e131_inflator;
+  DMPE131Inflator m_dmp_inflator;
+  std::auto_ptr<MockUDPSocket> m_socket;
+  std::auto_ptr<IncomingUDPTransport> m_transport;
+  std::map<uint16_t, DmxBuffer> m_buffers;
+  std::map<uint16_t, uint8_t> m_priorities;
+  vector<uint16_t> m_universes;
+  vector<string> m_packets;
+  IPV4Address m_peer;
+  unsigned int m_frames;
+
+  void NewFrame() { m_frames++; }
+
+  void Reset() {
+    vector<uint16_t>::const_iterator iter = m_universes.begin();
+    for (; iter != m_universes.end(); ++iter) {
+      m_dmp_inflator.RemoveHandler(*iter);
+    }
+    m_universes.clear();
+    m_transport.reset();
+    m_socket.reset();
+  }
+};
+}  // namespace
+
+
+/*
+ * With no arguments the benchmark uses generated data packets, otherwise the
+ * E1.31 datagrams in the pcap file are replayed.
+ */
+int main(int argc, char *argv[]) {
+  ola::InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_STDERR);
+
+  E131NodeBenchmark fixture;
+  Benchmark benchmark("E131Node", &std::cout);
+
+  if (argc > 1) {
+    vector<string> packets;
+    if (!ola::testing::LoadUDPCapture(argv[1], ola::acn::ACN_PORT,
+                                      &packets)) {
+      return 1;
+    }
+    std::set<uint16_t> universes;
+    vector<string>::const_iterator iter = packets.begin();
+    for (; iter != packets.end(); ++iter) {
+      if (IsDataPacket(*iter)) {
+        universes.insert(
+            static_cast<uint8_t>((*iter)[UNIVERSE_OFFSET]) << 8 |
+            static_cast<uint8_t>((*iter)[UNIVERSE_OFFSET + 1]));
+      }
+    }
+    if (!fixture.Setup(packets, universes)) {
+      OLA_WARN << "No E1.31 packets in " << argv[1];
+      return 1;
+    }
+    benchmark.Run("Replay", packets.size(),
+                  NewCallback(&fixture, &E131NodeBenchmark::Receive));
+    return 0;
+  }
+
+  const unsigned int universe_counts[] = {1, 4, 16};
+  for (unsigned int i = 0; i < arraysize(universe_counts); i++) {
+    vector<string> packets;
+    std::set<uint16_t> universes;
+    for (uint16_t universe = 1; universe <= universe_counts[i]; universe++) {
+      packets.push_back(BuildDataPacket(universe));
+      universes.insert(universe);
+    }
+    fixture.Setup(packets, universes);
+    benchmark.Run("Data", universe_counts[i],
+                  NewCallback(&fixture, &E131NodeBenchmark::Receive));
+  }
+  return 0;
+}
@@ -25,6 +25,7 @@
 #include "ola/network/NetworkUtils.h"
 #include "libs/acn/PDUTestCommon.h"
 #include "libs/acn/E131PDU.h"
+#include "libs/acn/E131SyncPDU.h"
 #include "ola/testing/TestUtils.h"
 
 namespace ola {
@@ -38,12 +39,14 @@ class E131PDUTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testSimpleRev2E131PDU);
   CPPUNIT_TEST(testSimpleE131PDU);
   CPPUNIT_TEST(testNestedE131PDU);
+  CPPUNIT_TEST(testSyncPDU);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testSimpleRev2E131PDU();
     void testSimpleE131PDU();
     void testNestedE131PDU();
+    void testSyncPDU();
  private:
     static const unsigned int TEST_VECTOR;
 };
@@ -110,6 +113,7 @@ void E131PDUTest::testSimpleRev2E131PDU() {
 void E131PDUTest::testSimpleE131PDU() {
   const string source = "foo source";
   E131Header header(source, 1, 2, 6000, true, true);
+  header.SetSyncAddress(6001);
   E131PDU pdu(TEST_VECTOR, header, NULL);
 
   OLA_ASSERT_EQ((unsigned int) 71, pdu.HeaderSize());
@@ -132,6 +136,10 @@ void E131PDUTest::testSimpleE131PDU() {
 
   OLA_ASSERT_FALSE(memcmp(&data[6], source.data(), source.length()));
   OLA_ASSERT_EQ((uint8_t) 1, data[6 + E131Header::SOURCE_NAME_LEN]);
+  uint16_t actual_sync_address;
+  memcpy(&actual_sync_address, data + 7 + E131Header::SOURCE_NAME_LEN,
+         sizeof(actual_sync_address));
+  OLA_ASSERT_EQ(HostToNetwork((uint16_t) 6001), actual_sync_address);
   OLA_ASSERT_EQ((uint8_t) 2, data[9 + E131Header::SOURCE_NAME_LEN]);
   uint16_t actual_universe;
   memcpy(&actual_universe, data + 11 + E131Header::SOURCE_NAME_LEN,
@@ -157,5 +165,38 @@ void E131PDUTest::testSimpleE131PDU() {
 void E131PDUTest::testNestedE131PDU() {
   // TODO(simon): add this test
 }
+
+
+/*
+ * Test that packing a synchronization PDU works.
+ */
+void E131PDUTest::testSyncPDU() {
+  E131SyncPDU pdu(42, 6000);
+
+  OLA_ASSERT_EQ((unsigned int) 5, pdu.HeaderSize());
+  OLA_ASSERT_EQ((unsigned int) 0, pdu.DataSize());
+  OLA_ASSERT_EQ((unsigned int) 11, pdu.Size());
+
+  unsigned int size = pdu.Size();
+  uint8_t *data = new uint8_t[size];
+  unsigned int bytes_used = size;
+  OLA_ASSERT(pdu.Pack(data, &bytes_used));
+  OLA_ASSERT_EQ((unsigned int) size, bytes_used);
+
+  const uint8_t expected[] = {
+    0x70, 11,
+    0, 0, 0, 1,  // VECTOR_E131_EXTENDED_SYNCHRONIZATION
+    42,  // sequence
+    0x17, 0x70,  // sync address
+    0, 0  // reserved
+  };
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), data, bytes_used);
+
+  // test undersized buffer
+  bytes_used = size - 1;
+  OLA_ASSERT_FALSE(pdu.Pack(data, &bytes_used));
+  OLA_ASSERT_EQ((unsigned int) 0, bytes_used);
+  delete[] data;
+}
 }  // namespace acn
 }  // namespace ola
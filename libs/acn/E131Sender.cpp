@@ -18,15 +18,25 @@
  * Copyright (C) 2007 Simon Newton
  */
 
+#include <stddef.h>
+#include <string.h>
+
 #include "ola/Logging.h"
+#include "ola/acn/ACNPort.h"
 #include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
+#include "ola/base/Macro.h"
+#include "ola/io/IOVecInterface.h"
 #include "ola/network/IPV4Address.h"
+#include "ola/network/IPV6Address.h"
 #include "ola/network/NetworkUtils.h"
+#include "ola/network/SocketAddress.h"
 #include "ola/util/Utils.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/E131Inflator.h"
 #include "libs/acn/E131Sender.h"
 #include "libs/acn/E131PDU.h"
+#include "libs/acn/E131SyncPDU.h"
 #include "libs/acn/RootSender.h"
 #include "libs/acn/UDPTransport.h"
 
@@ -34,15 +44,65 @@ namespace ola {
 namespace acn {
 
 using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::IPV6Address;
+using ola::network::IPV6SocketAddress;
 using ola::network::HostToNetwork;
 
+namespace {
+// After the preamble, the E1.31 framing layer header follows the root layer's
+// flags, length, vector and CID, and then the E1.31 flags, length & vector.
+// DMX packets are always smaller than 4k so the short length form is used.
+const unsigned int E131_HEADER_OFFSET =
+    2 + PDU::FOUR_BYTES + ola::acn::CID::CID_LENGTH + 2 + PDU::FOUR_BYTES;
+
+/*
+ * A datagram made up of the packed headers and the slot data, so the slots
+ * can be sent from the caller's memory without copying them into the packet.
+ */
+class HeaderAndSlots: public ola::io::IOVecInterface {
+ public:
+  HeaderAndSlots(const uint8_t *header, unsigned int header_length,
+                 const uint8_t *slots, unsigned int slot_count)
+      : m_header(header),
+        m_header_length(header_length),
+        m_slots(slots),
+        m_slot_count(slot_count) {
+  }
+
+  const struct ola::io::IOVec *AsIOVec(int *io_count) const {
+    struct ola::io::IOVec *iov = new struct ola::io::IOVec[2];
+    iov[0].iov_base = const_cast<uint8_t*>(m_header);
+    iov[0].iov_len = m_header_length;
+    iov[1].iov_base = const_cast<uint8_t*>(m_slots);
+    iov[1].iov_len = m_slot_count;
+    *io_count = m_slot_count ? 2 : 1;
+    return iov;
+  }
+
+  // The memory belongs to the caller, there's nothing to consume.
+  void Pop(unsigned int) {}
+
+ private:
+  const uint8_t *m_header;
+  const unsigned int m_header_length;
+  const uint8_t *m_slots;
+  const unsigned int m_slot_count;
+
+  DISALLOW_COPY_AND_ASSIGN(HeaderAndSlots);
+};
+}  // namespace
+
 /*
  * Create a new E131Sender
  * @param root_sender the root layer to use
+ * @param use_ipv6 send to the IPv6 multicast groups
  */
 E131Sender::E131Sender(ola::network::UDPSocket *socket,
-                       RootSender *root_sender)
+                       RootSender *root_sender,
+                       bool use_ipv6)
     : m_socket(socket),
+      m_use_ipv6(use_ipv6),
       m_transport_impl(socket, &m_packer),
       m_root_sender(root_sender) {
   if (!m_root_sender) {
@@ -61,23 +121,105 @@ bool E131Sender::SendDMP(const E131Header &header, const DMPPDU *dmp_pdu) {
     return false;
   }
 
-  IPV4Address addr;
-  if (!UniverseIP(header.Universe(), &addr)) {
-    OLA_INFO << "Could not convert universe " << header.Universe()
-             << " to IP.";
-    return false;
+  E131PDU pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu);
+  unsigned int vector = ola::acn::VECTOR_ROOT_E131;
+  if (header.UsingRev2()) {
+    vector = ola::acn::VECTOR_ROOT_E131_REV2;
   }
+  return SendToUniverse(header.Universe(), vector, pdu);
+}
 
-  OutgoingUDPTransport transport(&m_transport_impl, addr);
+/*
+ * Pack a DMPPDU, along with the E1.31 & root layers and the ACN preamble.
+ * @param header the E131Header
+ * @param dmp_pdu the DMPPDU to pack
+ * @param data the buffer to pack into
+ * @param length the size of the buffer, updated with the packed size.
+ */
+bool E131Sender::PackDMP(const E131Header &header, const DMPPDU *dmp_pdu,
+                         uint8_t *data, unsigned int *length) {
+  if (!m_root_sender || *length < PreamblePacker::ACN_HEADER_SIZE) {
+    return false;
+  }
 
   E131PDU pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu);
   unsigned int vector = ola::acn::VECTOR_ROOT_E131;
   if (header.UsingRev2()) {
     vector = ola::acn::VECTOR_ROOT_E131_REV2;
   }
-  return m_root_sender->SendPDU(vector, pdu, &transport);
+
+  memcpy(data, PreamblePacker::ACN_HEADER, PreamblePacker::ACN_HEADER_SIZE);
+  unsigned int size = *length - PreamblePacker::ACN_HEADER_SIZE;
+  if (!m_root_sender->PackPDU(vector, pdu,
+                              data + PreamblePacker::ACN_HEADER_SIZE,
+                              &size)) {
+    return false;
+  }
+  *length = PreamblePacker::ACN_HEADER_SIZE + size;
+  return true;
+}
+
+
+/*
+ * Send a packet built with PackDMP(). The slot data is sent from the caller's
+ * buffer, using scatter / gather IO, rather than being copied into the packet
+ * first.
+ * @param universe the universe the packet is for
+ * @param header the packet up to the slot data
+ * @param header_length the size of the header
+ * @param slots the slot data, which follows the header
+ * @param slot_count the number of slots
+ */
+bool E131Sender::SendPacked(uint16_t universe, const uint8_t *header,
+                            unsigned int header_length, const uint8_t *slots,
+                            unsigned int slot_count) {
+  HeaderAndSlots packet(header, header_length, slots, slot_count);
+  if (m_use_ipv6) {
+    IPV6Address addr;
+    if (!UniverseIPV6(universe, &addr)) {
+      OLA_INFO << "Could not convert universe " << universe << " to IP.";
+      return false;
+    }
+    return m_socket->SendTo(&packet,
+                            IPV6SocketAddress(addr, ola::acn::ACN_PORT));
+  }
+
+  IPV4Address addr;
+  if (!UniverseIP(universe, &addr)) {
+    OLA_INFO << "Could not convert universe " << universe << " to IP.";
+    return false;
+  }
+  return m_socket->SendTo(&packet,
+                          IPV4SocketAddress(addr, ola::acn::ACN_PORT));
+}
+
+
+/*
+ * The offset of the priority field in a packet from PackDMP().
+ */
+unsigned int E131Sender::PriorityOffset(bool rev2) {
+  if (rev2) {
+    return PreamblePacker::ACN_HEADER_SIZE + E131_HEADER_OFFSET +
+        offsetof(E131Rev2Header::e131_rev2_pdu_header, priority);
+  }
+  return PreamblePacker::ACN_HEADER_SIZE + E131_HEADER_OFFSET +
+      offsetof(E131Header::e131_pdu_header, priority);
+}
+
+
+/*
+ * The offset of the sequence number in a packet from PackDMP().
+ */
+unsigned int E131Sender::SequenceOffset(bool rev2) {
+  if (rev2) {
+    return PreamblePacker::ACN_HEADER_SIZE + E131_HEADER_OFFSET +
+        offsetof(E131Rev2Header::e131_rev2_pdu_header, sequence);
+  }
+  return PreamblePacker::ACN_HEADER_SIZE + E131_HEADER_OFFSET +
+      offsetof(E131Header::e131_pdu_header, sequence);
 }
 
+
 bool E131Sender::SendDiscoveryData(const E131Header &header,
                                    const uint8_t *data,
                                    unsigned int data_size) {
@@ -85,18 +227,24 @@ bool E131Sender::SendDiscoveryData(const E131Header &header,
     return false;
   }
 
-  IPV4Address addr;
-  if (!UniverseIP(header.Universe(), &addr)) {
-    OLA_INFO << "Could not convert universe " << header.Universe()
-             << " to IP.";
+  E131PDU pdu(ola::acn::VECTOR_E131_DISCOVERY, header, data, data_size);
+  return SendToUniverse(header.Universe(), ola::acn::VECTOR_ROOT_E131, pdu);
+}
+
+
+/*
+ * Send a synchronization packet.
+ * @param sync_universe the universe to send the sync packet on
+ * @param sequence the sequence number for the sync universe
+ */
+bool E131Sender::SendSync(uint16_t sync_universe, uint8_t sequence) {
+  if (!m_root_sender) {
     return false;
   }
 
-  OutgoingUDPTransport transport(&m_transport_impl, addr);
-
-  E131PDU pdu(ola::acn::VECTOR_E131_DISCOVERY, header, data, data_size);
-  unsigned int vector = ola::acn::VECTOR_ROOT_E131;
-  return m_root_sender->SendPDU(vector, pdu, &transport);
+  E131SyncPDU pdu(sequence, sync_universe);
+  return SendToUniverse(sync_universe, ola::acn::VECTOR_ROOT_E131_EXTENDED,
+                        pdu);
 }
 
 
@@ -122,5 +270,57 @@ bool E131Sender::UniverseIP(uint16_t universe, IPV4Address *addr) {
   OLA_WARN << "Universe " << universe << " isn't a valid E1.31 universe";
   return false;
 }
+
+
+/*
+ * Calculate the IPv6 multicast group that corresponds to a universe, this is
+ * ff18::83:00:<universe high>:<universe low>.
+ * @param universe the universe id
+ * @param addr where to store the address
+ * @return true if this is a valid E1.31 universe, false otherwise
+ */
+bool E131Sender::UniverseIPV6(uint16_t universe, IPV6Address *addr) {
+  uint8_t group[IPV6Address::LENGTH];
+  memset(group, 0, sizeof(group));
+  group[0] = 0xff;
+  group[1] = 0x18;
+  group[12] = 0x83;
+  ola::utils::SplitUInt16(universe, &group[14], &group[15]);
+  *addr = IPV6Address(group);
+  if (universe && (universe != 0xFFFF)) {
+    return true;
+  }
+
+  OLA_WARN << "Universe " << universe << " isn't a valid E1.31 universe";
+  return false;
+}
+
+
+/*
+ * Send a root layer PDU to the multicast group for a universe.
+ * @param universe the universe to send to
+ * @param vector the root layer vector
+ * @param pdu the PDU to send
+ */
+bool E131Sender::SendToUniverse(uint16_t universe, unsigned int vector,
+                                const PDU &pdu) {
+  if (m_use_ipv6) {
+    IPV6Address addr;
+    if (!UniverseIPV6(universe, &addr)) {
+      OLA_INFO << "Could not convert universe " << universe << " to IP.";
+      return false;
+    }
+    OutgoingUDPTransport transport(&m_transport_impl, addr);
+    return m_root_sender->SendPDU(vector, pdu, &transport);
+  }
+
+  IPV4Address addr;
+  if (!UniverseIP(universe, &addr)) {
+    OLA_INFO << "Could not convert universe " << universe << " to IP.";
+    return false;
+  }
+  OutgoingUDPTransport transport(&m_transport_impl, addr);
+  return m_root_sender->SendPDU(vector, pdu, &transport);
+}
 }  // namespace acn
 }  // namespace ola
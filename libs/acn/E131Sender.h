@@ -36,23 +36,46 @@ class DMPInflator;
 
 class E131Sender {
  public:
+  // If use_ipv6 is true, packets are sent to the IPv6 multicast groups and
+  // the socket must have been created with InitV6().
   E131Sender(ola::network::UDPSocket *socket,
-            class RootSender *root_sender);
+            class RootSender *root_sender,
+            bool use_ipv6 = false);
   ~E131Sender() {}
 
   bool SendDMP(const E131Header &header, const DMPPDU *pdu);
   bool SendDiscoveryData(const E131Header &header, const uint8_t *data,
                          unsigned int data_size);
+  bool SendSync(uint16_t sync_universe, uint8_t sequence);
+
+  // Pack a DMP PDU, including the ACN preamble, into a buffer. The packet,
+  // up to the slot data, can then be sent with new slot data, possibly many
+  // times, with SendPacked().
+  bool PackDMP(const E131Header &header, const DMPPDU *pdu, uint8_t *data,
+               unsigned int *length);
+  bool SendPacked(uint16_t universe, const uint8_t *header,
+                  unsigned int header_length, const uint8_t *slots,
+                  unsigned int slot_count);
+
+  // The offsets of the fields in a packet from PackDMP().
+  static unsigned int PriorityOffset(bool rev2);
+  static unsigned int SequenceOffset(bool rev2);
 
   static bool UniverseIP(uint16_t universe,
                          class ola::network::IPV4Address *addr);
+  static bool UniverseIPV6(uint16_t universe,
+                           class ola::network::IPV6Address *addr);
 
  private:
   ola::network::UDPSocket *m_socket;
+  const bool m_use_ipv6;
   PreamblePacker m_packer;
   OutgoingUDPTransportImpl m_transport_impl;
   class RootSender *m_root_sender;
 
+  bool SendToUniverse(uint16_t universe, unsigned int vector,
+                      const PDU &pdu);
+
   DISALLOW_COPY_AND_ASSIGN(E131Sender);
 };
 }  // namespace acn
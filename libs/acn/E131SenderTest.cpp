@@ -0,0 +1,155 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SenderTest.cpp
+ * Test fixture for the E131Sender class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/acn/CID.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/IPV6Address.h"
+#include "ola/network/Socket.h"
+#include "libs/acn/DMPAddress.h"
+#include "libs/acn/DMPPDU.h"
+#include "libs/acn/E131Header.h"
+#include "libs/acn/E131Sender.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RootSender.h"
+#include "ola/testing/TestUtils.h"
+
+
+namespace ola {
+namespace acn {
+
+using ola::acn::CID;
+using ola::network::IPV4Address;
+using ola::network::IPV6Address;
+using std::auto_ptr;
+using std::vector;
+
+class E131SenderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131SenderTest);
+  CPPUNIT_TEST(testPackDMP);
+  CPPUNIT_TEST(testPackDMPRev2);
+  CPPUNIT_TEST(testUniverseIP);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testPackDMP() { CheckPackDMP(false); }
+    void testPackDMPRev2() { CheckPackDMP(true); }
+    void testUniverseIP();
+
+ private:
+    void CheckPackDMP(bool rev2);
+    unsigned int Pack(E131Sender *sender, const E131Header &header,
+                      uint8_t *data);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131SenderTest);
+
+static const uint8_t DMP_DATA[] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+
+/*
+ * Pack a DMP PDU containing DMP_DATA.
+ */
+unsigned int E131SenderTest::Pack(E131Sender *sender,
+                                  const E131Header &header,
+                                  uint8_t *data) {
+  TwoByteRangeDMPAddress range_addr(0, 1, sizeof(DMP_DATA));
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr, DMP_DATA,
+                                                     sizeof(DMP_DATA));
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  auto_ptr<const DMPPDU> pdu(
+      NewRangeDMPSetProperty<uint16_t>(true, false, ranged_chunks));
+
+  unsigned int length = PreamblePacker::MAX_DATAGRAM_SIZE;
+  OLA_ASSERT_TRUE(sender->PackDMP(header, pdu.get(), data, &length));
+  return length;
+}
+
+
+/*
+ * Check that a packed packet has the priority, sequence number and data
+ * where the E131Node expects them to be.
+ */
+void E131SenderTest::CheckPackDMP(bool rev2) {
+  CID cid = CID::Generate();
+  RootSender root_sender(cid);
+  ola::network::UDPSocket socket;
+  E131Sender sender(&socket, &root_sender);
+
+  uint8_t packet1[PreamblePacker::MAX_DATAGRAM_SIZE];
+  uint8_t packet2[PreamblePacker::MAX_DATAGRAM_SIZE];
+  E131Header header1("foo", 100, 42, 1, false, false, rev2);
+  E131Header header2("foo", 200, 43, 1, false, false, rev2);
+  unsigned int length1 = Pack(&sender, header1, packet1);
+  unsigned int length2 = Pack(&sender, header2, packet2);
+  OLA_ASSERT_EQ(length1, length2);
+
+  OLA_ASSERT_DATA_EQUALS(PreamblePacker::ACN_HEADER,
+                         PreamblePacker::ACN_HEADER_SIZE,
+                         packet1, PreamblePacker::ACN_HEADER_SIZE);
+
+  const unsigned int priority_offset = E131Sender::PriorityOffset(rev2);
+  const unsigned int sequence_offset = E131Sender::SequenceOffset(rev2);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), packet1[priority_offset]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(200), packet2[priority_offset]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(42), packet1[sequence_offset]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(43), packet2[sequence_offset]);
+
+  // Nothing else changes
+  for (unsigned int i = 0; i < length1; i++) {
+    if (i != priority_offset && i != sequence_offset) {
+      OLA_ASSERT_EQ(packet1[i], packet2[i]);
+    }
+  }
+
+  // The data is at the end
+  OLA_ASSERT_DATA_EQUALS(DMP_DATA, sizeof(DMP_DATA),
+                         packet1 + length1 - sizeof(DMP_DATA),
+                         sizeof(DMP_DATA));
+}
+
+
+/*
+ * Check the IPv4 & IPv6 multicast groups for a universe.
+ */
+void E131SenderTest::testUniverseIP() {
+  IPV4Address v4_group;
+  OLA_ASSERT_TRUE(E131Sender::UniverseIP(1, &v4_group));
+  OLA_ASSERT_EQ(IPV4Address::FromStringOrDie("239.255.0.1"), v4_group);
+  OLA_ASSERT_TRUE(E131Sender::UniverseIP(0x1234, &v4_group));
+  OLA_ASSERT_EQ(IPV4Address::FromStringOrDie("239.255.18.52"), v4_group);
+  OLA_ASSERT_FALSE(E131Sender::UniverseIP(0, &v4_group));
+  OLA_ASSERT_FALSE(E131Sender::UniverseIP(0xffff, &v4_group));
+
+  IPV6Address v6_group;
+  OLA_ASSERT_TRUE(E131Sender::UniverseIPV6(1, &v6_group));
+  OLA_ASSERT_EQ(IPV6Address::FromStringOrDie("ff18::8300:1"), v6_group);
+  OLA_ASSERT_TRUE(E131Sender::UniverseIPV6(0x1234, &v6_group));
+  OLA_ASSERT_EQ(IPV6Address::FromStringOrDie("ff18::8300:1234"), v6_group);
+  OLA_ASSERT_FALSE(E131Sender::UniverseIPV6(0, &v6_group));
+  OLA_ASSERT_FALSE(E131Sender::UniverseIPV6(0xffff, &v6_group));
+}
+}  // namespace acn
+}  // namespace ola
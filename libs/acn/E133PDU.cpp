@@ -23,6 +23,7 @@
 #include <string>
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
+#include "ola/io/BigEndianStream.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/strings/Utils.h"
 #include "libs/acn/E133PDU.h"
@@ -122,8 +123,8 @@ void E133PDU::PrependPDU(ola::io::IOStack *stack, uint32_t vector,
   stack->Write(reinterpret_cast<uint8_t*>(&header),
                sizeof(E133Header::e133_pdu_header));
 
-  vector = HostToNetwork(vector);
-  stack->Write(reinterpret_cast<uint8_t*>(&vector), sizeof(vector));
+  ola::io::BigEndianBufferOutputStream<ola::io::IOStack> output(stack);
+  output << vector;
   PrependFlagsAndLength(stack);
 }
 }  // namespace acn
@@ -42,6 +42,8 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/DMPPDU.h \
     libs/acn/E131DiscoveryInflator.cpp \
     libs/acn/E131DiscoveryInflator.h \
+    libs/acn/E131ExtendedInflator.cpp \
+    libs/acn/E131ExtendedInflator.h \
     libs/acn/E131Header.h \
     libs/acn/E131Inflator.cpp \
     libs/acn/E131Inflator.h \
@@ -51,6 +53,8 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/E131PDU.h \
     libs/acn/E131Sender.cpp \
     libs/acn/E131Sender.h \
+    libs/acn/E131SyncPDU.cpp \
+    libs/acn/E131SyncPDU.h \
     libs/acn/E133Header.h \
     libs/acn/E133Inflator.cpp \
     libs/acn/E133Inflator.h \
@@ -61,6 +65,8 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/E133StatusPDU.cpp \
     libs/acn/E133StatusPDU.h \
     libs/acn/HeaderSet.h \
+    libs/acn/MembershipManager.cpp \
+    libs/acn/MembershipManager.h \
     libs/acn/PDU.cpp \
     libs/acn/PDU.h \
     libs/acn/PDUTestCommon.h \
@@ -118,6 +124,7 @@ libs_acn_E131Tester_SOURCES = \
     libs/acn/DMPPDUTest.cpp \
     libs/acn/E131InflatorTest.cpp \
     libs/acn/E131PDUTest.cpp \
+    libs/acn/E131SenderTest.cpp \
     libs/acn/HeaderSetTest.cpp \
     libs/acn/PDUTest.cpp \
     libs/acn/RootInflatorTest.cpp \
@@ -141,8 +148,24 @@ libs_acn_E133Tester_LDADD = \
     $(COMMON_TESTING_LIBS)
 
 libs_acn_TransportTester_SOURCES = \
+    libs/acn/MembershipManagerTest.cpp \
     libs/acn/TCPTransportTest.cpp \
     libs/acn/UDPTransportTest.cpp
 libs_acn_TransportTester_CPPFLAGS = $(COMMON_TESTING_FLAGS)
 libs_acn_TransportTester_LDADD = libs/acn/libolae131core.la \
                                  $(COMMON_TESTING_LIBS)
+
+# BENCHMARKS
+##################################################
+if BUILD_TESTS
+bench_programs += libs/acn/E131NodeBenchmark \
+                  libs/acn/PDUPackBenchmark
+
+libs_acn_E131NodeBenchmark_SOURCES = libs/acn/E131NodeBenchmark.cpp
+libs_acn_E131NodeBenchmark_CPPFLAGS = $(COMMON_TESTING_FLAGS)
+libs_acn_E131NodeBenchmark_LDADD = libs/acn/libolae131core.la \
+                                   $(COMMON_SOCKET_BENCHMARK_LIBS)
+
+libs_acn_PDUPackBenchmark_SOURCES = libs/acn/PDUPackBenchmark.cpp
+libs_acn_PDUPackBenchmark_LDADD = $(COMMON_BENCHMARK_LIBS)
+endif
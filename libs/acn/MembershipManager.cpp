@@ -0,0 +1,222 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MembershipManager.cpp
+ * Spreads multicast group memberships across sockets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif  // HAVE_NETINET_IN_H
+
+#include <map>
+#include <vector>
+#include "ola/Logging.h"
+#include "libs/acn/MembershipManager.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::IPV4Address;
+using ola::network::IPV6Address;
+using ola::network::UDPSocket;
+
+namespace {
+#ifdef IP_MULTICAST_ALL
+// Sockets bound to the wildcard address receive the datagrams for all groups
+// joined on the host, so the memberships can be held by other sockets.
+const bool CAN_SPREAD_MEMBERSHIPS = true;
+#else
+const bool CAN_SPREAD_MEMBERSHIPS = false;
+#endif  // IP_MULTICAST_ALL
+}  // namespace
+
+
+MembershipManager::MembershipManager(UDPSocket *socket) {
+  membership_socket receiving_socket = {socket, 0};
+  m_sockets.push_back(receiving_socket);
+}
+
+
+MembershipManager::~MembershipManager() {
+  // Closing the extra sockets leaves their groups.
+  for (unsigned int i = 1; i < m_sockets.size(); i++) {
+    delete m_sockets[i].socket;
+  }
+}
+
+
+/*
+ * Join a multicast group, or add a reference if we've already joined it.
+ * @param iface the address of the interface to join on.
+ * @param group the multicast group to join.
+ */
+bool MembershipManager::Join(const IPV4Address &iface,
+                             const IPV4Address &group) {
+  Groups::iterator iter = m_groups.find(group);
+  if (iter != m_groups.end()) {
+    iter->second.references++;
+    return true;
+  }
+
+  unsigned int socket_index;
+  if (!FindSocket(&socket_index)) {
+    return false;
+  }
+
+  membership_socket &entry = m_sockets[socket_index];
+  if (!entry.socket->JoinMulticast(iface, group)) {
+    return false;
+  }
+  entry.group_count++;
+
+  group_membership membership = {socket_index, 1};
+  m_groups[group] = membership;
+  return true;
+}
+
+
+/*
+ * Remove a reference to a multicast group, leaving it once there are no
+ * references left.
+ * @param iface the address of the interface the group was joined on.
+ * @param group the multicast group to leave.
+ */
+bool MembershipManager::Leave(const IPV4Address &iface,
+                              const IPV4Address &group) {
+  Groups::iterator iter = m_groups.find(group);
+  if (iter == m_groups.end()) {
+    return false;
+  }
+
+  if (--iter->second.references) {
+    return true;
+  }
+
+  const unsigned int socket_index = iter->second.socket_index;
+  m_groups.erase(iter);
+  membership_socket &entry = m_sockets[socket_index];
+  entry.group_count--;
+
+  if (socket_index && !entry.group_count) {
+    // closing the socket leaves the group
+    delete entry.socket;
+    entry.socket = NULL;
+    return true;
+  }
+  return entry.socket->LeaveMulticast(iface, group);
+}
+
+
+/*
+ * Join an IPv6 multicast group, or add a reference if we've already joined it.
+ * @param if_index the index of the interface to join on.
+ * @param group the multicast group to join.
+ */
+bool MembershipManager::Join(unsigned int if_index, const IPV6Address &group) {
+  V6Groups::iterator iter = m_v6_groups.find(group);
+  if (iter != m_v6_groups.end()) {
+    iter->second++;
+    return true;
+  }
+
+  if (!m_sockets[0].socket->JoinMulticast(if_index, group)) {
+    return false;
+  }
+  m_v6_groups[group] = 1;
+  return true;
+}
+
+
+/*
+ * Remove a reference to an IPv6 multicast group, leaving it once there are
+ * no references left.
+ * @param if_index the index of the interface the group was joined on.
+ * @param group the multicast group to leave.
+ */
+bool MembershipManager::Leave(unsigned int if_index,
+                              const IPV6Address &group) {
+  V6Groups::iterator iter = m_v6_groups.find(group);
+  if (iter == m_v6_groups.end()) {
+    return false;
+  }
+
+  if (--iter->second) {
+    return true;
+  }
+  m_v6_groups.erase(iter);
+  return m_sockets[0].socket->LeaveMulticast(if_index, group);
+}
+
+
+unsigned int MembershipManager::SocketCount() const {
+  unsigned int count = 0;
+  std::vector<membership_socket>::const_iterator iter = m_sockets.begin();
+  for (; iter != m_sockets.end(); ++iter) {
+    if (iter->socket) {
+      count++;
+    }
+  }
+  return count;
+}
+
+
+/*
+ * Find a socket that can join another group, opening one if required.
+ * @param socket_index set to the index of the socket in m_sockets.
+ */
+bool MembershipManager::FindSocket(unsigned int *socket_index) {
+  if (!CAN_SPREAD_MEMBERSHIPS) {
+    *socket_index = 0;
+    return true;
+  }
+
+  int free_slot = -1;
+  for (unsigned int i = 0; i < m_sockets.size(); i++) {
+    if (!m_sockets[i].socket) {
+      if (free_slot < 0) {
+        free_slot = static_cast<int>(i);
+      }
+    } else if (m_sockets[i].group_count < MAX_GROUPS_PER_SOCKET) {
+      *socket_index = i;
+      return true;
+    }
+  }
+
+  UDPSocket *socket = new UDPSocket();
+  if (!socket->Init()) {
+    OLA_WARN << "Failed to open a socket for multicast memberships";
+    delete socket;
+    return false;
+  }
+  OLA_DEBUG << "Opened multicast membership socket " << m_sockets.size();
+
+  membership_socket entry = {socket, 0};
+  if (free_slot < 0) {
+    *socket_index = static_cast<unsigned int>(m_sockets.size());
+    m_sockets.push_back(entry);
+  } else {
+    *socket_index = static_cast<unsigned int>(free_slot);
+    m_sockets[*socket_index] = entry;
+  }
+  return true;
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,99 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MembershipManager.h
+ * Spreads multicast group memberships across sockets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_MEMBERSHIPMANAGER_H_
+#define LIBS_ACN_MEMBERSHIPMANAGER_H_
+
+#include <map>
+#include <vector>
+#include "ola/base/Macro.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/IPV6Address.h"
+#include "ola/network/Socket.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * Manages the multicast groups joined for a receiving socket.
+ *
+ * Most kernels limit the number of groups a single socket can join (20 by
+ * default on Linux), which is far fewer than the number of universes an E1.31
+ * node may listen on. Linux delivers multicast datagrams to every socket
+ * bound to the wildcard address & port, no matter which socket joined the
+ * group, so once the receiving socket is full the extra memberships are held
+ * by sockets that are never read from. On other platforms all groups are
+ * joined on the receiving socket.
+ *
+ * Groups are reference counted, so the same group can be joined more than
+ * once, e.g. for a data universe that's also used as a sync universe.
+ *
+ * IPv6 groups are always joined on the receiving socket, since there isn't a
+ * per-socket limit for them.
+ */
+class MembershipManager {
+ public:
+    // Ownership of the socket is not transferred.
+    explicit MembershipManager(ola::network::UDPSocket *socket);
+    ~MembershipManager();
+
+    bool Join(const ola::network::IPV4Address &iface,
+              const ola::network::IPV4Address &group);
+    bool Leave(const ola::network::IPV4Address &iface,
+               const ola::network::IPV4Address &group);
+
+    bool Join(unsigned int if_index, const ola::network::IPV6Address &group);
+    bool Leave(unsigned int if_index, const ola::network::IPV6Address &group);
+
+    // The number of sockets holding memberships, including the receiving one.
+    unsigned int SocketCount() const;
+
+    // The number of groups we'll join on each socket.
+    static const unsigned int MAX_GROUPS_PER_SOCKET = 20;
+
+ private:
+    typedef struct {
+      ola::network::UDPSocket *socket;
+      unsigned int group_count;
+    } membership_socket;
+
+    typedef struct {
+      unsigned int socket_index;
+      unsigned int references;
+    } group_membership;
+
+    typedef std::map<ola::network::IPV4Address, group_membership> Groups;
+    // IPv6 group to the number of references.
+    typedef std::map<ola::network::IPV6Address, unsigned int> V6Groups;
+
+    // The first socket is the receiving socket, which we don't own. Extra
+    // sockets are closed once they have no groups, leaving a NULL entry so
+    // the indices don't change.
+    std::vector<membership_socket> m_sockets;
+    Groups m_groups;
+    V6Groups m_v6_groups;
+
+    bool FindSocket(unsigned int *socket_index);
+
+    DISALLOW_COPY_AND_ASSIGN(MembershipManager);
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_MEMBERSHIPMANAGER_H_
@@ -0,0 +1,105 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MembershipManagerTest.cpp
+ * Test fixture for the MembershipManager class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif  // HAVE_NETINET_IN_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ola/Logging.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/network/Socket.h"
+#include "ola/testing/TestUtils.h"
+#include "libs/acn/MembershipManager.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::UDPSocket;
+
+class MembershipManagerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(MembershipManagerTest);
+  CPPUNIT_TEST(testJoinAndLeave);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testJoinAndLeave();
+
+ private:
+    static IPV4Address Group(unsigned int i) {
+      return IPV4Address(ola::network::HostToNetwork(0xefff0000 + i));
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MembershipManagerTest);
+
+
+/*
+ * Check that groups are spread across sockets and reference counted.
+ */
+void MembershipManagerTest::testJoinAndLeave() {
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(IPV4SocketAddress(IPV4Address::WildCard(), 0)));
+
+  const IPV4Address iface = IPV4Address::Loopback();
+  MembershipManager manager(&socket);
+  OLA_ASSERT_EQ(1u, manager.SocketCount());
+  if (!manager.Join(iface, Group(1))) {
+    OLA_INFO << "Skipping testJoinAndLeave since multicast isn't available";
+    return;
+  }
+  OLA_ASSERT_FALSE(manager.Leave(iface, Group(2)));
+
+  // A second reference doesn't use another membership.
+  OLA_ASSERT_TRUE(manager.Join(iface, Group(1)));
+  const unsigned int group_count = 2 * MembershipManager::MAX_GROUPS_PER_SOCKET;
+  for (unsigned int i = 2; i <= group_count; i++) {
+    OLA_ASSERT_TRUE(manager.Join(iface, Group(i)));
+  }
+
+#ifdef IP_MULTICAST_ALL
+  const unsigned int full_sockets = 2;
+#else
+  const unsigned int full_sockets = 1;
+#endif  // IP_MULTICAST_ALL
+  OLA_ASSERT_EQ(full_sockets, manager.SocketCount());
+
+  // Once the second socket has no groups, it's closed.
+  for (unsigned int i = MembershipManager::MAX_GROUPS_PER_SOCKET + 1;
+       i <= group_count; i++) {
+    OLA_ASSERT_TRUE(manager.Leave(iface, Group(i)));
+  }
+  OLA_ASSERT_EQ(1u, manager.SocketCount());
+
+  OLA_ASSERT_TRUE(manager.Leave(iface, Group(1)));
+  OLA_ASSERT_TRUE(manager.Leave(iface, Group(1)));
+  OLA_ASSERT_FALSE(manager.Leave(iface, Group(1)));
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,147 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PDUPackBenchmark.cpp
+ * Compares packing PDU fields through the virtual and templated streams.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/io/BigEndianStream.h"
+#include "ola/io/IOQueue.h"
+#include "ola/io/MemoryBuffer.h"
+#include "ola/testing/Benchmark.h"
+
+using ola::NewCallback;
+using ola::io::BigEndianBufferOutputStream;
+using ola::io::BigEndianOutputStream;
+using ola::io::IOQueue;
+using ola::io::MemoryOutputBuffer;
+using ola::testing::Benchmark;
+
+namespace {
+
+/*
+ * The streams used by the benchmarks, the param of each result is the
+ * stream.
+ */
+enum StreamType {
+  STREAM_VIRTUAL = 0,  // BigEndianOutputStream over an IOQueue
+  STREAM_IOQUEUE = 1,  // BigEndianBufferOutputStream<IOQueue>
+  STREAM_MEMORY = 2,  // BigEndianBufferOutputStream<MemoryOutputBuffer>
+};
+
+// Large enough for an E1.31 data packet.
+const unsigned int PACKET_SIZE = 638;
+
+/*
+ * Pack the root, framing and DMP layers of an E1.31 data packet, a field at
+ * a time, the way the PDU classes do.
+ */
+template <typename Stream>
+void PackDataPacket(Stream *stream, const uint8_t *cid, const uint8_t *source,
+                    uint8_t sequence, const uint8_t *slots) {
+  // Root layer
+  *stream << static_cast<uint16_t>(0x7000 | 622);
+  *stream << static_cast<uint32_t>(4);
+  stream->Write(cid, 16);
+
+  // Framing layer
+  *stream << static_cast<uint16_t>(0x7000 | 600);
+  *stream << static_cast<uint32_t>(2);
+  stream->Write(source, 64);
+  *stream << static_cast<uint8_t>(100);
+  *stream << static_cast<uint16_t>(0);
+  *stream << sequence;
+  *stream << static_cast<uint8_t>(0);
+  *stream << static_cast<uint16_t>(1);
+
+  // DMP layer
+  *stream << static_cast<uint16_t>(0x7000 | 523);
+  *stream << static_cast<uint8_t>(2);
+  *stream << static_cast<uint8_t>(0xa1);
+  *stream << static_cast<uint16_t>(0);
+  *stream << static_cast<uint16_t>(1);
+  *stream << static_cast<uint16_t>(ola::DMX_UNIVERSE_SIZE + 1);
+  *stream << static_cast<uint8_t>(0);
+  stream->Write(slots, ola::DMX_UNIVERSE_SIZE);
+}
+
+class PDUPackBenchmark {
+ public:
+  PDUPackBenchmark()
+      : m_memory_buffer(m_memory, sizeof(m_memory)),
+        m_sequence(0) {
+    memset(m_cid, 0x5a, sizeof(m_cid));
+    memset(m_source, 0, sizeof(m_source));
+    memcpy(m_source, "benchmark", 9);
+    for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+      m_slots[i] = static_cast<uint8_t>(i);
+    }
+  }
+
+  void PackVirtual(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      BigEndianOutputStream stream(&m_queue);
+      PackDataPacket(&stream, m_cid, m_source, m_sequence++, m_slots);
+      m_queue.Clear();
+    }
+  }
+
+  void PackIOQueue(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      BigEndianBufferOutputStream<IOQueue> stream(&m_queue);
+      PackDataPacket(&stream, m_cid, m_source, m_sequence++, m_slots);
+      m_queue.Clear();
+    }
+  }
+
+  void PackMemory(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      BigEndianBufferOutputStream<MemoryOutputBuffer> stream(
+          &m_memory_buffer);
+      PackDataPacket(&stream, m_cid, m_source, m_sequence++, m_slots);
+      m_memory_buffer.Reset();
+    }
+  }
+
+ private:
+  IOQueue m_queue;
+  uint8_t m_memory[PACKET_SIZE];
+  MemoryOutputBuffer m_memory_buffer;
+  uint8_t m_cid[16];
+  uint8_t m_source[64];
+  uint8_t m_slots[ola::DMX_UNIVERSE_SIZE];
+  uint8_t m_sequence;
+};
+}  // namespace
+
+
+int main() {
+  Benchmark benchmark("PDUPack", &std::cout);
+  PDUPackBenchmark fixture;
+  benchmark.Run("DataPacket", STREAM_VIRTUAL,
+                NewCallback(&fixture, &PDUPackBenchmark::PackVirtual));
+  benchmark.Run("DataPacket", STREAM_IOQUEUE,
+                NewCallback(&fixture, &PDUPackBenchmark::PackIOQueue));
+  benchmark.Run("DataPacket", STREAM_MEMORY,
+                NewCallback(&fixture, &PDUPackBenchmark::PackMemory));
+  return 0;
+}
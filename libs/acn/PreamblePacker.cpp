@@ -91,7 +91,6 @@ const uint8_t *PreamblePacker::Pack(const PDUBlock<PDU> &pdu_block,
  * Add the UDP Preamble to an IOStack
  */
 void PreamblePacker::AddUDPPreamble(IOStack *stack) {
-  ola::io::BigEndianOutputStream output(stack);
   stack->Write(ACN_HEADER, ACN_HEADER_SIZE);
 }
 
@@ -100,7 +99,7 @@ void PreamblePacker::AddUDPPreamble(IOStack *stack) {
  * Add the TCP Preamble to an IOStack
  */
 void PreamblePacker::AddTCPPreamble(IOStack *stack) {
-  ola::io::BigEndianOutputStream output(stack);
+  ola::io::BigEndianBufferOutputStream<IOStack> output(stack);
   output << stack->Size();
   stack->Write(TCP_ACN_HEADER, TCP_ACN_HEADER_SIZE);
 }
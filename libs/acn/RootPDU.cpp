@@ -19,6 +19,7 @@
  */
 
 #include "ola/Logging.h"
+#include "ola/io/BigEndianStream.h"
 #include "ola/io/IOStack.h"
 #include "libs/acn/BaseInflator.h"
 #include "libs/acn/RootPDU.h"
@@ -29,7 +30,6 @@ namespace acn {
 using ola::acn::CID;
 using ola::io::IOStack;
 using ola::io::OutputStream;
-using ola::network::HostToNetwork;
 
 /*
  * Pack the header into a buffer.
@@ -89,8 +89,8 @@ void RootPDU::SetBlock(const PDUBlock<PDU> *block) {
 void RootPDU::PrependPDU(IOStack *stack, uint32_t vector, const CID &cid) {
   cid.Write(stack);
 
-  vector = HostToNetwork(vector);
-  stack->Write(reinterpret_cast<uint8_t*>(&vector), sizeof(vector));
+  ola::io::BigEndianBufferOutputStream<IOStack> output(stack);
+  output << vector;
   PrependFlagsAndLength(stack);
 }
 }  // namespace acn
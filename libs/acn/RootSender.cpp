@@ -106,5 +106,26 @@ bool RootSender::SendPDUBlock(unsigned int vector,
   m_root_block.AddPDU(&m_root_pdu);
   return transport->Send(m_root_block);
 }
+
+
+/*
+ * Encapsulate this PDU in a RootPDU and pack it into a buffer.
+ * @param vector the vector to use at the root level
+ * @param pdu the pdu to pack.
+ * @param data the buffer to pack into.
+ * @param length the size of the buffer, updated with the packed size.
+ */
+bool RootSender::PackPDU(unsigned int vector,
+                         const PDU &pdu,
+                         uint8_t *data,
+                         unsigned int *length) {
+  m_working_block.Clear();
+  m_working_block.AddPDU(&pdu);
+  m_root_pdu.SetVector(vector);
+  m_root_pdu.SetBlock(&m_working_block);
+  m_root_block.Clear();
+  m_root_block.AddPDU(&m_root_pdu);
+  return m_root_block.Pack(data, length);
+}
 }  // namespace acn
 }  // namespace ola
@@ -50,6 +50,11 @@ class RootSender {
     bool SendPDUBlock(unsigned int vector,
                       const PDUBlock<PDU> &block,
                       OutgoingTransport *transport);
+    // Encapsulate a single PDU and pack it into a buffer rather than sending
+    bool PackPDU(unsigned int vector,
+                 const PDU &pdu,
+                 uint8_t *data,
+                 unsigned int *length);
 
     // TODO(simon): add methods to queue and send PDUs/blocks with different
     // vectors
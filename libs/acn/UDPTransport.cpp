@@ -24,6 +24,7 @@
 #include "ola/Logging.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/network/SocketAddress.h"
+#include "ola/util/Trace.h"
 #include "libs/acn/BaseInflator.h"
 #include "libs/acn/HeaderSet.h"
 #include "libs/acn/UDPTransport.h"
@@ -33,12 +34,16 @@ namespace acn {
 
 using ola::network::HostToNetwork;
 using ola::network::IPV4SocketAddress;
+using ola::network::IPV6SocketAddress;
 
 /*
  * Send a block of PDU messages.
  * @param pdu_block the block of pdus to send
  */
 bool OutgoingUDPTransport::Send(const PDUBlock<PDU> &pdu_block) {
+  if (m_ipv6) {
+    return m_impl->Send(pdu_block, m_v6_destination);
+  }
   return m_impl->Send(pdu_block, m_destination);
 }
 
@@ -61,12 +66,40 @@ bool OutgoingUDPTransportImpl::Send(const PDUBlock<PDU> &pdu_block,
 }
 
 
+/*
+ * Send a block of PDU messages using UDP over IPv6.
+ * @param pdu_block the block of pdus to send
+ * @param destination the ipv6 address & port to send to
+ */
+bool OutgoingUDPTransportImpl::Send(const PDUBlock<PDU> &pdu_block,
+                                    const IPV6SocketAddress &destination) {
+  unsigned int data_size;
+  const uint8_t *data = m_packer->Pack(pdu_block, &data_size);
+
+  if (!data)
+    return false;
+
+  return m_socket->SendTo(data, data_size, destination);
+}
+
+
 
-IncomingUDPTransport::IncomingUDPTransport(ola::network::UDPSocket *socket,
-                                           BaseInflator *inflator)
+IncomingUDPTransport::IncomingUDPTransport(
+    ola::network::UDPSocketInterface *socket,
+    BaseInflator *inflator,
+    unsigned int batch_size)
     : m_socket(socket),
       m_inflator(inflator),
-      m_recv_buffer(NULL) {
+      m_fast_path(NULL),
+      m_batch_size(batch_size),
+      m_recv_batch(NULL) {
+}
+
+
+void IncomingUDPTransport::SetFastPath(FastPathCallback *callback) {
+  if (m_fast_path)
+    delete m_fast_path;
+  m_fast_path = callback;
 }
 
 
@@ -74,35 +107,48 @@ IncomingUDPTransport::IncomingUDPTransport(ola::network::UDPSocket *socket,
  * Called when new data arrives.
  */
 void IncomingUDPTransport::Receive() {
-  if (!m_recv_buffer)
-    m_recv_buffer = new uint8_t[PreamblePacker::MAX_DATAGRAM_SIZE];
-
-  ssize_t size = PreamblePacker::MAX_DATAGRAM_SIZE;
-  ola::network::IPV4SocketAddress source;
+  OLA_TRACE_SCOPE("e131", "IncomingUDPTransport::Receive");
+  if (!m_recv_batch) {
+    m_recv_batch = new ola::network::DatagramBatch(
+        m_batch_size, PreamblePacker::MAX_DATAGRAM_SIZE);
+  }
 
-  if (!m_socket->RecvFrom(m_recv_buffer, &size, &source))
+  if (!m_socket->RecvBatch(m_recv_batch))
     return;
 
+  for (unsigned int i = 0; i < m_recv_batch->Size(); i++) {
+    HandleDatagram(m_recv_batch->Data(i), m_recv_batch->Length(i),
+                   m_recv_batch->Source(i));
+  }
+}
+
+
+/*
+ * Check the ACN header and inflate a single datagram.
+ */
+void IncomingUDPTransport::HandleDatagram(const uint8_t *data,
+                                          unsigned int size,
+                                          const IPV4SocketAddress &source) {
   unsigned int header_size = PreamblePacker::ACN_HEADER_SIZE;
-  if (size < static_cast<ssize_t>(header_size)) {
+  if (size < header_size) {
     OLA_WARN << "short ACN frame, discarding";
     return;
   }
 
-  if (memcmp(m_recv_buffer, PreamblePacker::ACN_HEADER, header_size)) {
+  if (memcmp(data, PreamblePacker::ACN_HEADER, header_size)) {
     OLA_WARN << "ACN header is bad, discarding";
     return;
   }
 
+  if (m_fast_path && m_fast_path->Run(data + header_size, size - header_size))
+    return;
+
   HeaderSet header_set;
   TransportHeader transport_header(source, TransportHeader::UDP);
   header_set.SetTransportHeader(transport_header);
 
-  m_inflator->InflatePDUBlock(
-      &header_set,
-      m_recv_buffer + header_size,
-      static_cast<unsigned int>(size) - header_size);
-  return;
+  m_inflator->InflatePDUBlock(&header_set, data + header_size,
+                              size - header_size);
 }
 }  // namespace acn
 }  // namespace ola
@@ -21,8 +21,10 @@
 #ifndef LIBS_ACN_UDPTRANSPORT_H_
 #define LIBS_ACN_UDPTRANSPORT_H_
 
+#include "ola/Callback.h"
 #include "ola/acn/ACNPort.h"
 #include "ola/network/IPV4Address.h"
+#include "ola/network/IPV6Address.h"
 #include "ola/network/Socket.h"
 #include "libs/acn/PDU.h"
 #include "libs/acn/PreamblePacker.h"
@@ -41,15 +43,26 @@ class OutgoingUDPTransport: public OutgoingTransport {
                          const ola::network::IPV4Address &destination,
                          uint16_t port = ola::acn::ACN_PORT)
         : m_impl(impl),
+          m_ipv6(false),
           m_destination(destination, port) {
     }
+    OutgoingUDPTransport(class OutgoingUDPTransportImpl *impl,
+                         const ola::network::IPV6Address &destination,
+                         uint16_t port = ola::acn::ACN_PORT)
+        : m_impl(impl),
+          m_ipv6(true),
+          m_v6_destination(destination, port) {
+    }
     ~OutgoingUDPTransport() {}
 
     bool Send(const PDUBlock<PDU> &pdu_block);
 
  private:
     class OutgoingUDPTransportImpl *m_impl;
+    // m_v6_destination is used if m_ipv6 is true, otherwise m_destination.
+    const bool m_ipv6;
     ola::network::IPV4SocketAddress m_destination;
+    ola::network::IPV6SocketAddress m_v6_destination;
 
     OutgoingUDPTransport(const OutgoingUDPTransport&);
     OutgoingUDPTransport& operator=(const OutgoingUDPTransport&);
@@ -58,6 +71,8 @@ class OutgoingUDPTransport: public OutgoingTransport {
 
 /**
  * OutgoingUDPTransportImpl is the class that actually does the sending.
+ * Between UDPSocket::BeginSendBatch() and EndSendBatch() the packets are
+ * queued and sent together.
  */
 class OutgoingUDPTransportImpl {
  public:
@@ -78,6 +93,8 @@ class OutgoingUDPTransportImpl {
 
     bool Send(const PDUBlock<PDU> &pdu_block,
               const ola::network::IPV4SocketAddress &destination);
+    bool Send(const PDUBlock<PDU> &pdu_block,
+              const ola::network::IPV6SocketAddress &destination);
 
  private:
     ola::network::UDPSocket *m_socket;
@@ -88,24 +105,45 @@ class OutgoingUDPTransportImpl {
 
 /**
  * IncomingUDPTransport is responsible for receiving over UDP
+ * Each call to Receive() reads up to batch_size datagrams from the socket.
  * TODO(simon): pass the socket as an argument to receive so we can reuse the
  * transport for multiple sockets.
  */
 class IncomingUDPTransport {
  public:
-    IncomingUDPTransport(ola::network::UDPSocket *socket,
-                         class BaseInflator *inflator);
+    /*
+     * Called with each datagram, after the preamble, before it's inflated.
+     * Returns true if the datagram was handled and shouldn't be inflated.
+     */
+    typedef ola::Callback2<bool, const uint8_t*, unsigned int>
+        FastPathCallback;
+
+    IncomingUDPTransport(ola::network::UDPSocketInterface *socket,
+                         class BaseInflator *inflator,
+                         unsigned int batch_size = 1);
     ~IncomingUDPTransport() {
-      if (m_recv_buffer)
-        delete[] m_recv_buffer;
+      if (m_recv_batch)
+        delete m_recv_batch;
+      if (m_fast_path)
+        delete m_fast_path;
     }
 
+    // Ownership of the callback is transferred.
+    void SetFastPath(FastPathCallback *callback);
+
     void Receive();
 
+    // Handle a datagram that was received some other way, e.g. with an
+    // XDPReceiver.
+    void HandleDatagram(const uint8_t *data, unsigned int size,
+                        const ola::network::IPV4SocketAddress &source);
+
  private:
-    ola::network::UDPSocket *m_socket;
+    ola::network::UDPSocketInterface *m_socket;
     class BaseInflator *m_inflator;
-    uint8_t *m_recv_buffer;
+    FastPathCallback *m_fast_path;
+    const unsigned int m_batch_size;
+    ola::network::DatagramBatch *m_recv_batch;
 };
 }  // namespace acn
 }  // namespace ola
@@ -14,62 +14,521 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  *
  * e131_loadtest.cpp
- * A simple E1.31 load tester
+ * An E1.31 load tester & benchmark.
+ *
+ * In send mode, the universes are sent at a fixed frame rate, either all at
+ * once or in bursts spread across each frame. In receive mode, the
+ * packets are checked for loss & reordering using the sequence numbers, and
+ * the inter-arrival jitter is measured.
  * Copyright (C) 2013 Simon Newton
  */
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
 #include <algorithm>
+#include <memory>
 #include <string>
+#include <vector>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
+#include "ola/acn/ACNPort.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
 #include "ola/base/Flags.h"
 #include "ola/base/Init.h"
+#include "ola/base/SysExits.h"
 #include "ola/io/SelectServer.h"
+#include "ola/network/Interface.h"
+#include "ola/network/InterfacePicker.h"
+#include "ola/network/Socket.h"
+#include "ola/util/Histogram.h"
+#include "ola/util/Utils.h"
+#include "libs/acn/DMPAddress.h"
+#include "libs/acn/DMPPDU.h"
+#include "libs/acn/E131Header.h"
 #include "libs/acn/E131Node.h"
+#include "libs/acn/E131Sender.h"
+#include "libs/acn/MembershipManager.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RootSender.h"
 
+using ola::Clock;
 using ola::DmxBuffer;
-using ola::io::SelectServer;
-using ola::acn::E131Node;
+using ola::Histogram;
 using ola::NewCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::acn::E131Node;
+using ola::io::SelectServer;
+using ola::network::DatagramBatch;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::UDPSocket;
+using std::auto_ptr;
+using std::max;
 using std::min;
+using std::string;
+using std::vector;
+
+DEFINE_s_string(mode, m, "send", "send or receive");
+DEFINE_s_string(ip, i, "", "The IP address or interface to use");
+DEFINE_s_uint32(fps, s, 10, "Frames per second per universe [1 - 1000]");
+DEFINE_s_uint16(universes, u, 1, "Number of universes to send or receive");
+DEFINE_uint16(burst, 0, "The number of universes in each burst, the bursts "
+              "are spread evenly across the frame. 0 sends the whole frame "
+              "at once.");
+DEFINE_uint32(pacing_rate, 0, "Limit the send rate to this many kbit/s, "
+              "using kernel pacing. 0 for no limit.");
+DEFINE_default_bool(batch, false, "Queue each burst and send it with as few "
+                    "system calls as possible.");
+DEFINE_string(send_path, "template", "template, to send from the packed "
+              "packet templates, or pdu to build the full PDU for each "
+              "packet.");
+DEFINE_uint32(report_interval, 1, "Seconds between reports");
+
+namespace {
+
+const unsigned int MAX_FPS = 1000;
+const unsigned int RECV_BATCH_SIZE = 64;
+
+// Offsets into a data packet, from the start of the preamble.
+const unsigned int ROOT_VECTOR_OFFSET =
+    ola::acn::PreamblePacker::ACN_HEADER_SIZE + 2;
+const unsigned int CID_OFFSET = ola::acn::PreamblePacker::ACN_HEADER_SIZE + 6;
+const unsigned int FRAMING_VECTOR_OFFSET =
+    ola::acn::PreamblePacker::ACN_HEADER_SIZE + 24;
+
+struct CpuUsage {
+  uint64_t user;
+  uint64_t system;
+
+  CpuUsage() : user(0), system(0) {}
+
+  uint64_t Total() const { return user + system; }
+};
+
+CpuUsage OurCpuUsage() {
+  CpuUsage usage;
+  struct rusage rusage;
+  if (getrusage(RUSAGE_SELF, &rusage) == 0) {
+    usage.user = rusage.ru_utime.tv_sec * 1000000ull + rusage.ru_utime.tv_usec;
+    usage.system = (rusage.ru_stime.tv_sec * 1000000ull +
+                    rusage.ru_stime.tv_usec);
+  }
+  return usage;
+}
+
+uint32_t ReadUInt32(const uint8_t *data) {
+  return ola::utils::JoinUInt8(data[0], data[1], data[2], data[3]);
+}
+
+/**
+ * Tracks the packet count & CPU time between reports.
+ */
+class ReportPeriod {
+ public:
+  ReportPeriod()
+      : m_packets(0),
+        m_last_packets(0) {
+    m_clock.CurrentTime(&m_last_time);
+    m_last_cpu = OurCpuUsage();
+  }
+
+  void AddPackets(unsigned int count) { m_packets += count; }
+  uint64_t Packets() const { return m_packets; }
+
+  /**
+   * Log the rate & CPU usage since the last call, and start a new period.
+   */
+  void Report(const string &prefix) {
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    const CpuUsage cpu = OurCpuUsage();
+    const int64_t elapsed_us = max((now - m_last_time).AsInt(),
+                                   static_cast<int64_t>(1));
+    const uint64_t packets = m_packets - m_last_packets;
+    const uint64_t cpu_us = cpu.Total() - m_last_cpu.Total();
+
+    OLA_INFO << prefix << packets * 1000000 / elapsed_us << " pkts/s, "
+             << (packets ? static_cast<double>(cpu_us) / packets : 0.0)
+             << " us CPU/pkt, "
+             << cpu_us * 100 / elapsed_us << "% CPU";
+
+    m_last_time = now;
+    m_last_cpu = cpu;
+    m_last_packets = m_packets;
+  }
+
+ private:
+  Clock m_clock;
+  uint64_t m_packets;
+  uint64_t m_last_packets;
+  TimeStamp m_last_time;
+  CpuUsage m_last_cpu;
+};
 
-DEFINE_s_uint32(fps, s, 10, "Frames per second per universe [1 - 40]");
-DEFINE_s_uint16(universes, u, 1, "Number of universes to send");
 
 /**
- * Send N DMX frames using E1.31, where N is given by number_of_universes.
+ * Sends the universes, a burst at a time.
  */
-bool SendFrames(E131Node *node, DmxBuffer *buffer,
-                uint16_t number_of_universes) {
-  for (uint16_t i = 1; i < number_of_universes + 1; i++) {
-    node->SendDMX(i, *buffer);
+class Transmitter {
+ public:
+  Transmitter(E131Node *node, const ola::acn::CID &cid, uint16_t universes,
+              uint16_t burst, bool batch, bool pdu_path)
+      : m_node(node),
+        m_universes(universes),
+        m_burst(burst ? min(burst, universes) : universes),
+        m_batch(batch),
+        m_pdu_path(pdu_path),
+        m_root_sender(cid),
+        m_sender(node->GetSocket(), &m_root_sender),
+        m_sequences(pdu_path ? universes + 1 : 0, 0),
+        m_next_universe(1),
+        m_frame(0) {
+    m_buffer.Blackout();
   }
+
+  // The number of bursts in each frame.
+  unsigned int BurstsPerFrame() const {
+    return (m_universes + m_burst - 1) / m_burst;
+  }
+
+  bool SendBurst();
+  bool Report() {
+    m_period.Report("Sent ");
+    return true;
+  }
+
+ private:
+  E131Node *m_node;
+  const uint16_t m_universes;
+  const uint16_t m_burst;
+  const bool m_batch;
+  const bool m_pdu_path;
+  ola::acn::RootSender m_root_sender;
+  ola::acn::E131Sender m_sender;
+  vector<uint8_t> m_sequences;
+  uint16_t m_next_universe;
+  uint8_t m_frame;
+  DmxBuffer m_buffer;
+  ReportPeriod m_period;
+
+  bool SendPDU(uint16_t universe);
+};
+
+
+bool Transmitter::SendBurst() {
+  if (m_next_universe == 1) {
+    // Change the data each frame, like a real controller would.
+    m_buffer.SetChannel(0, m_frame++);
+  }
+
+  if (m_batch) {
+    if (m_pdu_path) {
+      m_node->GetSocket()->BeginSendBatch();
+    } else {
+      m_node->BeginBatch();
+    }
+  }
+
+  unsigned int sent = 0;
+  for (; sent < m_burst && m_next_universe <= m_universes; sent++) {
+    if (m_pdu_path) {
+      SendPDU(m_next_universe);
+    } else {
+      m_node->SendDMX(m_next_universe, m_buffer);
+    }
+    m_next_universe++;
+  }
+  if (m_next_universe > m_universes) {
+    m_next_universe = 1;
+  }
+
+  if (m_batch) {
+    if (m_pdu_path) {
+      m_node->GetSocket()->EndSendBatch();
+    } else {
+      m_node->EndBatch();
+    }
+  }
+  m_period.AddPackets(sent);
   return true;
 }
 
-int main(int argc, char* argv[]) {
-  ola::AppInit(&argc, argv, "", "Run the E1.31 load test.");
 
-  if (FLAGS_universes == 0 || FLAGS_fps == 0)
-    return -1;
+/**
+ * Build & send the full PDU for a universe, without the packet templates.
+ */
+bool Transmitter::SendPDU(uint16_t universe) {
+  uint8_t data[ola::DMX_UNIVERSE_SIZE + 1];
+  unsigned int data_size = ola::DMX_UNIVERSE_SIZE;
+  data[0] = ola::DMX512_START_CODE;
+  m_buffer.Get(data + 1, &data_size);
+  data_size++;
 
-  unsigned int fps = min(40u, static_cast<unsigned int>(FLAGS_fps));
-  uint16_t universes = FLAGS_universes;
+  ola::acn::TwoByteRangeDMPAddress range_addr(
+      0, 1, static_cast<uint16_t>(data_size));
+  ola::acn::DMPAddressData<ola::acn::TwoByteRangeDMPAddress> range_chunk(
+      &range_addr, data, data_size);
+  vector<ola::acn::DMPAddressData<ola::acn::TwoByteRangeDMPAddress> >
+      ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  auto_ptr<const ola::acn::DMPPDU> pdu(
+      ola::acn::NewRangeDMPSetProperty<uint16_t>(true, false, ranged_chunks));
 
-  DmxBuffer output;
-  output.Blackout();
-  SelectServer ss;
+  ola::acn::E131Header header("e131_loadtest", 100,
+                              m_sequences[universe]++, universe);
+  return m_sender.SendDMP(header, pdu.get());
+}
+
+
+/**
+ * Receives data packets and checks the sequence numbers & arrival times.
+ */
+class Receiver {
+ public:
+  Receiver(UDPSocket *socket, uint16_t universes)
+      : m_socket(socket),
+        m_universes(universes + 1),
+        m_lost(0),
+        m_reordered(0),
+        m_ignored(0),
+        m_batch(RECV_BATCH_SIZE, ola::acn::PreamblePacker::MAX_DATAGRAM_SIZE) {
+  }
 
-  E131Node node(&ss, "", E131Node::Options());
-  if (!node.Start())
-    return -1;
+  void Receive();
+  bool Report();
 
-  ss.AddReadDescriptor(node.GetSocket());
-  ss.RegisterRepeatingTimeout(
-      1000 / fps,
-      NewCallback(&SendFrames, &node, &output, universes));
-  OLA_INFO << "Starting loadtester...";
-  ss.Run();
+ private:
+  struct UniverseState {
+    bool seen;
+    // The CID of the source, a new source restarts the sequence.
+    uint8_t cid[ola::acn::CID::CID_LENGTH];
+    uint8_t sequence;
+    TimeStamp last_arrival;
+    // The previous inter-arrival time in us, -1 if unknown.
+    int64_t last_interval;
+    // The smoothed jitter in us, as in RFC 3550.
+    double jitter;
+
+    UniverseState()
+        : seen(false),
+          sequence(0),
+          last_interval(-1),
+          jitter(0) {
+      memset(cid, 0, sizeof(cid));
+    }
+  };
+
+  UDPSocket *m_socket;
+  vector<UniverseState> m_universes;
+  uint64_t m_lost;
+  uint64_t m_reordered;
+  uint64_t m_ignored;
+  // The difference between consecutive inter-arrival times, in us.
+  Histogram m_interval_changes;
+  Clock m_clock;
+  DatagramBatch m_batch;
+  ReportPeriod m_period;
+
+  void HandlePacket(const uint8_t *data, unsigned int length,
+                    const TimeStamp &arrival);
+};
+
+
+void Receiver::Receive() {
+  if (!m_socket->RecvBatch(&m_batch)) {
+    return;
+  }
+
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  for (unsigned int i = 0; i < m_batch.Size(); i++) {
+    HandlePacket(m_batch.Data(i), m_batch.Length(i), now);
+  }
+  m_period.AddPackets(m_batch.Size());
+}
+
+
+void Receiver::HandlePacket(const uint8_t *data, unsigned int length,
+                            const TimeStamp &arrival) {
+  const unsigned int sequence_offset =
+      ola::acn::E131Sender::SequenceOffset(false);
+  const unsigned int universe_offset = sequence_offset + 2;
+  if (length < universe_offset + 2 ||
+      ReadUInt32(data + ROOT_VECTOR_OFFSET) != ola::acn::VECTOR_ROOT_E131 ||
+      ReadUInt32(data + FRAMING_VECTOR_OFFSET) !=
+          ola::acn::VECTOR_E131_DATA) {
+    m_ignored++;
+    return;
+  }
+
+  const uint16_t universe = ola::utils::JoinUInt8(data[universe_offset],
+                                                  data[universe_offset + 1]);
+  if (universe >= m_universes.size()) {
+    m_ignored++;
+    return;
+  }
+
+  UniverseState &state = m_universes[universe];
+  const uint8_t sequence = data[sequence_offset];
+  if (state.seen && memcmp(state.cid, data + CID_OFFSET, sizeof(state.cid))) {
+    state.last_interval = -1;
+    state.seen = false;
+  }
+
+  if (state.seen) {
+    const int8_t diff = static_cast<int8_t>(sequence - state.sequence);
+    if (diff <= 0) {
+      // A late or duplicate packet.
+      m_reordered++;
+      return;
+    }
+    m_lost += diff - 1;
+
+    const int64_t interval = (arrival - state.last_arrival).AsInt();
+    if (state.last_interval >= 0) {
+      const int64_t change = interval > state.last_interval ?
+          interval - state.last_interval : state.last_interval - interval;
+      state.jitter += (static_cast<double>(change) - state.jitter) / 16;
+      m_interval_changes.Add(static_cast<uint32_t>(
+          min(change, static_cast<int64_t>(UINT32_MAX))));
+    }
+    state.last_interval = interval;
+  }
+  if (!state.seen) {
+    memcpy(state.cid, data + CID_OFFSET, sizeof(state.cid));
+    state.seen = true;
+  }
+  state.sequence = sequence;
+  state.last_arrival = arrival;
+}
+
+
+bool Receiver::Report() {
+  double jitter = 0;
+  unsigned int active = 0;
+  vector<UniverseState>::const_iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    if (iter->seen) {
+      jitter += iter->jitter;
+      active++;
+    }
+  }
+
+  m_period.Report("Received ");
+  OLA_INFO << "  " << active << " universes, " << m_lost << " lost, "
+           << m_reordered << " reordered, " << m_ignored << " ignored";
+  OLA_INFO << "  jitter " << (active ? jitter / active : 0.0)
+           << " us, inter-arrival change p50 "
+           << m_interval_changes.Percentile(50) << " us, p99 "
+           << m_interval_changes.Percentile(99) << " us, max "
+           << m_interval_changes.Max() << " us";
+  m_interval_changes.Reset();
+  return true;
+}
+
+
+int RunSender(SelectServer *ss, uint16_t universes) {
+  const string send_path = FLAGS_send_path.str();
+  if (send_path != "template" && send_path != "pdu") {
+    OLA_FATAL << "Unknown send path " << send_path;
+    return ola::EXIT_USAGE;
+  }
+
+  const unsigned int fps = min(MAX_FPS, static_cast<unsigned int>(FLAGS_fps));
+  E131Node::Options options;
+  options.max_pacing_rate = FLAGS_pacing_rate * 125;
+  const ola::acn::CID cid = ola::acn::CID::Generate();
+  E131Node node(ss, FLAGS_ip.str(), options, cid);
+  if (!node.Start()) {
+    return ola::EXIT_UNAVAILABLE;
+  }
+  ss->AddReadDescriptor(node.GetSocket());
+
+  Transmitter transmitter(&node, cid, universes, FLAGS_burst, FLAGS_batch,
+                          send_path == "pdu");
+  const unsigned int frame_ms = 1000 / fps;
+  const unsigned int bursts = transmitter.BurstsPerFrame();
+  const unsigned int burst_ms = max(1u, frame_ms / bursts);
+  if (burst_ms * bursts > frame_ms) {
+    OLA_WARN << bursts << " bursts don't fit in a " << frame_ms
+             << "ms frame, the frame rate will be lower";
+  }
+
+  ss->RegisterRepeatingTimeout(
+      burst_ms, NewCallback(&transmitter, &Transmitter::SendBurst));
+  ss->RegisterRepeatingTimeout(
+      FLAGS_report_interval * 1000,
+      NewCallback(&transmitter, &Transmitter::Report));
+  OLA_INFO << "Sending " << universes << " universes at " << fps << " fps, "
+           << bursts << " bursts every " << burst_ms << "ms";
+  ss->Run();
+  ss->RemoveReadDescriptor(node.GetSocket());
+  return ola::EXIT_OK;
+}
+
+
+int RunReceiver(SelectServer *ss, uint16_t universes) {
+  auto_ptr<ola::network::InterfacePicker> picker(
+    ola::network::InterfacePicker::NewPicker());
+  ola::network::Interface iface;
+  if (!picker->ChooseInterface(&iface, FLAGS_ip.str())) {
+    OLA_FATAL << "Failed to find an interface";
+    return ola::EXIT_UNAVAILABLE;
+  }
+
+  UDPSocket socket;
+  if (!socket.Init() ||
+      !socket.Bind(IPV4SocketAddress(IPV4Address::WildCard(),
+                                     ola::acn::ACN_PORT))) {
+    return ola::EXIT_UNAVAILABLE;
+  }
+
+  ola::acn::MembershipManager memberships(&socket);
+  for (uint16_t universe = 1; universe <= universes; universe++) {
+    IPV4Address group;
+    if (!ola::acn::E131Sender::UniverseIP(universe, &group) ||
+        !memberships.Join(iface.ip_address, group)) {
+      OLA_FATAL << "Failed to join the group for universe " << universe;
+      return ola::EXIT_UNAVAILABLE;
+    }
+  }
+
+  Receiver receiver(&socket, universes);
+  socket.SetOnData(NewCallback(&receiver, &Receiver::Receive));
+  ss->AddReadDescriptor(&socket);
+  ss->RegisterRepeatingTimeout(
+      FLAGS_report_interval * 1000,
+      NewCallback(&receiver, &Receiver::Report));
+  OLA_INFO << "Receiving " << universes << " universes on "
+           << iface.ip_address;
+  ss->Run();
+  ss->RemoveReadDescriptor(&socket);
+  return ola::EXIT_OK;
+}
+}  // namespace
+
+
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "[options]", "Run the E1.31 load test.");
+
+  if (FLAGS_universes == 0 || FLAGS_fps == 0 || FLAGS_report_interval == 0) {
+    ola::DisplayUsageAndExit();
+  }
+
+  SelectServer ss;
+  const string mode = FLAGS_mode.str();
+  if (mode == "send") {
+    return RunSender(&ss, FLAGS_universes);
+  } else if (mode == "receive") {
+    return RunReceiver(&ss, FLAGS_universes);
+  }
+  OLA_FATAL << "Unknown mode " << mode;
+  return ola::EXIT_USAGE;
 }
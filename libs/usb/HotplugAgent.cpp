@@ -24,7 +24,9 @@
 
 #include <ola/Callback.h>
 #include <ola/Logging.h>
+#include <ola/io/SelectServer.h>
 #include <ola/stl/STLUtils.h>
+#include <ola/thread/CallbackThread.h>
 #include <ola/thread/PeriodicThread.h>
 #include <ola/thread/Mutex.h>
 #include <ola/thread/Thread.h>
@@ -109,10 +111,10 @@ bool HotplugAgent::Start() {
     return false;
   }
 
-  if (!m_use_hotplug) {
-    // Either we don't support hotplug or the setup failed.
-    // As poor man's hotplug, we call libusb_get_device_list periodically to
-    // check for new devices.
+  if (!m_use_hotplug && !StartMonitor()) {
+    // Either we don't support hotplug or the setup failed, and there aren't
+    // any uevents. As poor man's hotplug, we call libusb_get_device_list
+    // periodically to check for new devices.
     m_scanner_thread.reset(new ola::thread::PeriodicThread(
           TimeInterval(5, 0),
           NewCallback(this, &HotplugAgent::ScanUSBDevices)));
@@ -128,6 +130,7 @@ void HotplugAgent::HaltNotifications() {
   if (m_scanner_thread.get()) {
     m_scanner_thread->Stop();
   }
+  StopMonitor();
 
   {
     ola::thread::MutexLocker locker(&m_mutex);
@@ -212,8 +215,8 @@ bool HotplugAgent::HotplugSupported() {
 }
 
 /*
- * If hotplug isn't supported, this is called periodically to check for
- * USB devices that have been added or removed.
+ * If hotplug isn't supported, this is called on each uevent, or
+ * periodically, to check for USB devices that have been added or removed.
  */
 bool HotplugAgent::ScanUSBDevices() {
   std::set<USBDeviceID> current_device_ids;
@@ -247,5 +250,61 @@ bool HotplugAgent::ScanUSBDevices() {
   }
   return true;
 }
+
+/*
+ * Start a thread which scans for USB devices each time the kernel or udev
+ * reports a device being added or removed.
+ */
+bool HotplugAgent::StartMonitor() {
+  m_monitor.reset(new UsbDeviceMonitor(
+      NewCallback(this, &HotplugAgent::MonitorEvent)));
+  if (!m_monitor->Init()) {
+    m_monitor.reset();
+    return false;
+  }
+
+  m_monitor_ss.reset(new ola::io::SelectServer());
+  m_monitor_ss->AddReadDescriptor(m_monitor->GetDescriptor());
+  m_monitor_ss->RegisterRepeatingTimeout(
+      MONITOR_RESCAN_INTERVAL_MS,
+      NewCallback(this, &HotplugAgent::ScanUSBDevices));
+
+  m_monitor_thread.reset(new ola::thread::CallbackThread(
+      NewSingleCallback(this, &HotplugAgent::RunMonitor)));
+  if (!m_monitor_thread->Start()) {
+    m_monitor_thread.reset();
+    m_monitor_ss.reset();
+    m_monitor.reset();
+    return false;
+  }
+  OLA_INFO << "Using uevents to detect USB devices";
+  return true;
+}
+
+void HotplugAgent::RunMonitor() {
+  ScanUSBDevices();
+  m_monitor_ss->Run();
+}
+
+void HotplugAgent::MonitorEvent(OLA_UNUSED UsbDeviceMonitor::EventType event,
+                                OLA_UNUSED uint8_t bus_number,
+                                OLA_UNUSED uint8_t device_address) {
+  // A single scan picks up all the changes, and only notifies for those.
+  ScanUSBDevices();
+}
+
+void HotplugAgent::StopMonitor() {
+  if (!m_monitor_thread.get()) {
+    return;
+  }
+  // Terminate() is a no-op if the SelectServer isn't running yet, so queue
+  // it instead.
+  m_monitor_ss->Execute(NewSingleCallback(
+      m_monitor_ss.get(), &ola::io::SelectServer::Terminate));
+  m_monitor_thread->Join();
+  m_monitor_thread.reset();
+  m_monitor_ss.reset();
+  m_monitor.reset();
+}
 }  // namespace usb
 }  // namespace ola
@@ -23,7 +23,9 @@
 
 #include <libusb.h>
 #include <ola/Callback.h>
+#include <ola/io/SelectServer.h>
 #include <ola/thread/PeriodicThread.h>
+#include <ola/thread/Thread.h>
 
 #include <map>
 #include <memory>
@@ -31,6 +33,7 @@
 #include "libs/usb/LibUsbAdaptor.h"
 #include "libs/usb/LibUsbThread.h"
 #include "libs/usb/Types.h"
+#include "libs/usb/UsbDeviceMonitor.h"
 
 namespace ola {
 namespace usb {
@@ -40,7 +43,8 @@ namespace usb {
  *
  * The HotplugAgent will run a callback when a USB device is added or removed.
  * On systems with libusb >= 1.0.16 which also support hotplug we'll use the
- * Hotplug API, otherwise we'll periodically check for devices.
+ * Hotplug API. Otherwise, if the platform has uevents we'll check for devices
+ * when one is added or removed, and failing that we'll periodically check.
  */
 class HotplugAgent {
  public:
@@ -139,19 +143,31 @@ class HotplugAgent {
   std::auto_ptr<ola::usb::LibUsbThread> m_usb_thread;
   std::auto_ptr<ola::usb::AsyncronousLibUsbAdaptor> m_usb_adaptor;
   std::auto_ptr<ola::thread::PeriodicThread> m_scanner_thread;
+  std::auto_ptr<UsbDeviceMonitor> m_monitor;
+  std::auto_ptr<ola::io::SelectServer> m_monitor_ss;
+  std::auto_ptr<ola::thread::Thread> m_monitor_thread;
 
   ola::thread::Mutex m_mutex;
   bool m_suppress_hotplug_events;  // GUARDED_BY(m_mutex);
 
   // In hotplug mode, this is guarded by m_mutex while
   // m_suppress_hotplug_events is false.
-  // In non-hotplug mode, this is only accessed from the scanner thread, unless
-  // the thread is no longer running in which case it's accessed from the main
-  // thread during cleanup
+  // In non-hotplug mode, this is only accessed from the scanner or monitor
+  // thread, unless the thread is no longer running in which case it's
+  // accessed from the main thread during cleanup
   DeviceMap m_devices;
 
   bool HotplugSupported();
   bool ScanUSBDevices();
+  bool StartMonitor();
+  void RunMonitor();
+  void MonitorEvent(UsbDeviceMonitor::EventType event, uint8_t bus_number,
+                    uint8_t device_address);
+  void StopMonitor();
+
+  // Uevents can be lost if the socket buffer overflows, so we still scan
+  // every so often.
+  static const unsigned int MONITOR_RESCAN_INTERVAL_MS = 60000;
 
   DISALLOW_COPY_AND_ASSIGN(HotplugAgent);
 };
@@ -74,6 +74,9 @@ class JaRulePortHandle : public ola::rdm::DiscoverableRDMControllerInterface {
   ola::rdm::DiscoverableQueueingRDMController m_queueing_controller;
 
   static const unsigned int RDM_QUEUE_SIZE = 50;
+  // Each request carries its own callback, so the widget can pipeline them
+  // over USB.
+  static const unsigned int RDM_MAX_IN_FLIGHT = 2;
 
   DISALLOW_COPY_AND_ASSIGN(JaRulePortHandle);
 };
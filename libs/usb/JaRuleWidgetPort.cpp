@@ -28,6 +28,8 @@
 #include <ola/thread/Mutex.h>
 #include <ola/util/Utils.h>
 
+#include <string.h>
+
 #include <memory>
 #include <string>
 #include <utility>
@@ -60,7 +62,7 @@ __attribute__((__stdcall__))
 #endif  // _WIN32
 void OutTransferCompleteHandler(struct libusb_transfer *transfer) {
   JaRuleWidgetPort *port = static_cast<JaRuleWidgetPort*>(transfer->user_data);
-  return port->_OutTransferComplete();
+  return port->_OutTransferComplete(transfer);
 }
 
 }  // namespace
@@ -78,10 +80,15 @@ JaRuleWidgetPort::JaRuleWidgetPort(ola::thread::ExecutorInterface *executor,
       m_uid(uid),
       m_physical_port(physical_port),
       m_handle(NULL),
-      m_out_transfer(adaptor->AllocTransfer(0)),
-      m_out_in_progress(false),
+      m_rdm_in_flight(0),
       m_in_transfer(adaptor->AllocTransfer(0)),
       m_in_in_progress(false) {
+  for (unsigned int i = 0; i < MAX_IN_FLIGHT; i++) {
+    OutTransfer *out = new OutTransfer();
+    out->transfer = adaptor->AllocTransfer(0);
+    out->in_progress = false;
+    m_out_transfers.push_back(out);
+  }
 }
 
 JaRuleWidgetPort::~JaRuleWidgetPort() {
@@ -92,7 +99,7 @@ JaRuleWidgetPort::~JaRuleWidgetPort() {
 
   {
     MutexLocker locker(&m_mutex);
-    if (!m_queued_commands.empty()) {
+    if (!(m_dmx_commands.empty() && m_rdm_commands.empty())) {
       OLA_WARN << "Queued commands remain, did we forget to call "
                   "CancelTransfer()?";
     }
@@ -104,8 +111,11 @@ JaRuleWidgetPort::~JaRuleWidgetPort() {
 
     // Cancelling may take up to a second if the endpoint has stalled. I can't
     // really see a way to speed this up.
-    if (m_out_in_progress) {
-      m_adaptor->CancelTransfer(m_out_transfer);
+    OutTransfers::iterator iter = m_out_transfers.begin();
+    for (; iter != m_out_transfers.end(); ++iter) {
+      if ((*iter)->in_progress) {
+        m_adaptor->CancelTransfer((*iter)->transfer);
+      }
     }
 
     if (m_in_in_progress) {
@@ -118,11 +128,15 @@ JaRuleWidgetPort::~JaRuleWidgetPort() {
   while (transfers_pending) {
     // Spin waiting for the transfers to complete.
     MutexLocker locker(&m_mutex);
-    transfers_pending = m_out_in_progress || m_in_in_progress;
+    transfers_pending = OutTransfersPending() || m_in_in_progress;
   }
 
-  if (m_out_transfer) {
-    m_adaptor->FreeTransfer(m_out_transfer);
+  OutTransfers::iterator iter = m_out_transfers.begin();
+  for (; iter != m_out_transfers.end(); ++iter) {
+    if ((*iter)->transfer) {
+      m_adaptor->FreeTransfer((*iter)->transfer);
+    }
+    delete *iter;
   }
 
   if (m_in_transfer) {
@@ -152,11 +166,17 @@ void JaRuleWidgetPort::CancelAll() {
 
   {
     MutexLocker locker(&m_mutex);
-    queued_commands = m_queued_commands;
-    while (!m_queued_commands.empty()) {
-      m_queued_commands.pop();
+    // DMX first, to preserve the order the commands would have been sent in.
+    while (!m_dmx_commands.empty()) {
+      queued_commands.push(m_dmx_commands.front());
+      m_dmx_commands.pop();
+    }
+    while (!m_rdm_commands.empty()) {
+      queued_commands.push(m_rdm_commands.front());
+      m_rdm_commands.pop();
     }
     pending_commands.swap(m_pending_commands);
+    m_rdm_in_flight = 0;
   }
 
   while (!queued_commands.empty()) {
@@ -173,13 +193,14 @@ void JaRuleWidgetPort::CancelAll() {
     if (iter->second->callback) {
       iter->second->callback->Run(COMMAND_RESULT_CANCELLED, RC_UNKNOWN, 0,
                                   ByteString());
-      delete iter->second;
     }
+    delete iter->second;
   }
 
   {
     MutexLocker locker(&m_mutex);
-    if (!(m_queued_commands.empty() && m_pending_commands.empty())) {
+    if (!(m_dmx_commands.empty() && m_rdm_commands.empty() &&
+          m_pending_commands.empty())) {
       OLA_WARN << "Some commands have not been cancelled";
     }
   }
@@ -231,7 +252,9 @@ void JaRuleWidgetPort::SendCommand(
 
   MutexLocker locker(&m_mutex);
 
-  if (m_queued_commands.size() > MAX_QUEUED_MESSAGES) {
+  CommandQueue *queue = command_class == JARULE_CMD_TX_DMX ?
+      &m_dmx_commands : &m_rdm_commands;
+  if (queue->size() > MAX_QUEUED_MESSAGES) {
     locker.Release();
     OLA_WARN << "JaRule outbound queue is full";
     if (callback) {
@@ -240,24 +263,29 @@ void JaRuleWidgetPort::SendCommand(
     return;
   }
 
-  m_queued_commands.push(command.release());
-  MaybeSendCommand();
+  queue->push(command.release());
+  MaybeSendCommands();
 }
 
-void JaRuleWidgetPort::_OutTransferComplete() {
+void JaRuleWidgetPort::_OutTransferComplete(libusb_transfer *transfer) {
   OLA_DEBUG << "Out Command status is "
-            << LibUsbAdaptor::ErrorCodeToString(m_in_transfer->status);
-  if (m_out_transfer->status == LIBUSB_TRANSFER_COMPLETED) {
-    if (m_out_transfer->actual_length != m_out_transfer->length) {
+            << LibUsbAdaptor::ErrorCodeToString(transfer->status);
+  if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+    if (transfer->actual_length != transfer->length) {
       // TODO(simon): Decide what to do here
-      OLA_WARN << "Only sent " << m_out_transfer->actual_length << " / "
-               << m_out_transfer->length << " bytes";
+      OLA_WARN << "Only sent " << transfer->actual_length << " / "
+               << transfer->length << " bytes";
     }
   }
 
   MutexLocker locker(&m_mutex);
-  m_out_in_progress = false;
-  MaybeSendCommand();
+  OutTransfers::iterator iter = m_out_transfers.begin();
+  for (; iter != m_out_transfers.end(); ++iter) {
+    if ((*iter)->transfer == transfer) {
+      (*iter)->in_progress = false;
+    }
+  }
+  MaybeSendCommands();
 }
 
 void JaRuleWidgetPort::_InTransferComplete() {
@@ -278,6 +306,9 @@ void JaRuleWidgetPort::_InTransferComplete() {
   while (iter != m_pending_commands.end()) {
     PendingCommand *command = iter->second;
     if (command->out_time < time_limit) {
+      if (command->command != JARULE_CMD_TX_DMX) {
+        m_rdm_in_flight--;
+      }
       ScheduleCallback(command->callback, COMMAND_RESULT_TIMEOUT, RC_UNKNOWN, 0,
                        ByteString());
       delete command;
@@ -290,52 +321,111 @@ void JaRuleWidgetPort::_InTransferComplete() {
   if (!m_pending_commands.empty()) {
     SubmitInTransfer();
   }
+  MaybeSendCommands();
 }
 
-void JaRuleWidgetPort::MaybeSendCommand() {
-  if (m_out_in_progress ||
-      m_pending_commands.size() > MAX_IN_FLIGHT ||
-      m_queued_commands.empty()) {
-    return;
-  }
+/*
+ * @brief Send queued commands until we run out of commands or in-flight slots.
+ *
+ * DMX is always sent first. RDM may use all but one of the in-flight slots,
+ * which leaves room for a DMX frame while a slow RDM transaction is pending.
+ */
+void JaRuleWidgetPort::MaybeSendCommands() {
+  while (m_pending_commands.size() < MAX_IN_FLIGHT) {
+    CommandQueue *queue = NULL;
+    if (!m_dmx_commands.empty()) {
+      queue = &m_dmx_commands;
+    } else if (!m_rdm_commands.empty() &&
+               m_rdm_in_flight < MAX_IN_FLIGHT - 1) {
+      queue = &m_rdm_commands;
+    } else {
+      return;
+    }
 
-  PendingCommand *command = m_queued_commands.front();
-  m_queued_commands.pop();
+    // The transfer for a command may still be in progress after the response
+    // arrives, in which case we'll try again once it completes.
+    OutTransfer *out = FreeOutTransfer();
+    if (!out) {
+      return;
+    }
 
-  uint8_t token = m_token.Next();
+    PendingCommand *command = queue->front();
+    queue->pop();
+    if (!SubmitCommand(out, command)) {
+      return;
+    }
+  }
+}
+
+/*
+ * @brief Send a single command, this takes ownership of the command.
+ * @returns false if the transfer couldn't be submitted.
+ */
+bool JaRuleWidgetPort::SubmitCommand(OutTransfer *out,
+                                     PendingCommand *command) {
+  uint8_t token = NextToken();
   command->payload[1] = token;
+  memcpy(out->buffer, command->payload.data(), command->payload.size());
   m_adaptor->FillBulkTransfer(
-      m_out_transfer, m_usb_handle, m_endpoint_number | LIBUSB_ENDPOINT_OUT,
-      const_cast<uint8_t*>(command->payload.data()),
-      command->payload.size(), OutTransferCompleteHandler,
+      out->transfer, m_usb_handle, m_endpoint_number | LIBUSB_ENDPOINT_OUT,
+      out->buffer, command->payload.size(), OutTransferCompleteHandler,
       static_cast<void*>(this), ENDPOINT_TIMEOUT_MS);
 
-  int r = m_adaptor->SubmitTransfer(m_out_transfer);
+  int r = m_adaptor->SubmitTransfer(out->transfer);
   if (r) {
     OLA_WARN << "Failed to submit outbound transfer: "
              << LibUsbAdaptor::ErrorCodeToString(r);
     ScheduleCallback(command->callback, COMMAND_RESULT_SEND_ERROR, RC_UNKNOWN,
                      0, ByteString());
     delete command;
-    return;
+    return false;
   }
 
+  out->in_progress = true;
   m_clock.CurrentTime(&command->out_time);
-  std::pair<PendingCommandMap::iterator, bool> p = m_pending_commands.insert(
-      PendingCommandMap::value_type(token, command));
-  if (!p.second) {
-    // We had an old entry, cancel it.
-    ScheduleCallback(p.first->second->callback,
-                     COMMAND_RESULT_CANCELLED, RC_UNKNOWN, 0, ByteString());
-    delete p.first->second;
-    p.first->second = command;
+  m_pending_commands[token] = command;
+  if (command->command != JARULE_CMD_TX_DMX) {
+    m_rdm_in_flight++;
   }
 
-  m_out_in_progress = true;
   if (!m_in_in_progress) {
     SubmitInTransfer();
   }
-  return;
+  return true;
+}
+
+/*
+ * @brief Return an OUT transfer that isn't in use, or NULL.
+ */
+JaRuleWidgetPort::OutTransfer *JaRuleWidgetPort::FreeOutTransfer() {
+  OutTransfers::iterator iter = m_out_transfers.begin();
+  for (; iter != m_out_transfers.end(); ++iter) {
+    if (!(*iter)->in_progress && (*iter)->transfer) {
+      return *iter;
+    }
+  }
+  return NULL;
+}
+
+bool JaRuleWidgetPort::OutTransfersPending() {
+  OutTransfers::iterator iter = m_out_transfers.begin();
+  for (; iter != m_out_transfers.end(); ++iter) {
+    if ((*iter)->in_progress) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * @brief Return the next token that isn't used by an in-flight command.
+ */
+uint8_t JaRuleWidgetPort::NextToken() {
+  uint8_t token = m_token.Next();
+  while (STLContains(m_pending_commands, token)) {
+    token = m_token.Next();
+  }
+  return token;
 }
 
 bool JaRuleWidgetPort::SubmitInTransfer() {
@@ -406,9 +496,14 @@ void JaRuleWidgetPort::HandleResponse(const uint8_t *data, unsigned int size) {
 
   PendingCommand *command;
   if (!STLLookupAndRemove(&m_pending_commands, token, &command)) {
+    OLA_INFO << "No pending command for token " << ToHex(token);
     return;
   }
 
+  if (command->command != JARULE_CMD_TX_DMX) {
+    m_rdm_in_flight--;
+  }
+
   USBCommandResult status = COMMAND_RESULT_OK;
   if (command->command != command_class) {
     status = COMMAND_RESULT_CLASS_MISMATCH;
@@ -30,6 +30,7 @@
 
 #include <map>
 #include <queue>
+#include <vector>
 
 #include "libs/usb/JaRulePortHandle.h"
 #include "libs/usb/LibUsbAdaptor.h"
@@ -43,6 +44,14 @@ namespace usb {
  *
  * Each port has its own libusb transfers as well as a command queue. This
  * avoids slow commands on one port blocking another.
+ *
+ * Commands are pipelined, up to MAX_IN_FLIGHT commands may be outstanding at
+ * once and responses are matched to commands using the token. Each in-flight
+ * command has its own preallocated OUT transfer & buffer.
+ *
+ * DMX and RDM commands are queued separately. Queued DMX commands are always
+ * sent first, and one in-flight slot is reserved for DMX so that DMX frames
+ * don't wait behind slow RDM transactions.
  */
 class JaRuleWidgetPort {
  public:
@@ -102,10 +111,11 @@ class JaRuleWidgetPort {
                    CommandCompleteCallback *callback);
 
   /**
-   * @brief Called by the libusb callback when the transfer completes or is
+   * @brief Called by the libusb callback when an OUT transfer completes or is
    * cancelled.
+   * @param transfer the transfer that completed.
    */
-  void _OutTransferComplete();
+  void _OutTransferComplete(libusb_transfer *transfer);
 
   /**
    * @brief Called by the libusb callback when the transfer completes or is
@@ -144,8 +154,16 @@ class JaRuleWidgetPort {
     TimeStamp out_time;  // When this cmd was sent
   };
 
+  // A preallocated OUT transfer and its buffer.
+  struct OutTransfer {
+    libusb_transfer *transfer;
+    bool in_progress;
+    uint8_t buffer[OUT_BUFFER_SIZE];
+  };
+
   typedef std::map<uint8_t, PendingCommand*> PendingCommandMap;
   typedef std::queue<PendingCommand*> CommandQueue;
+  typedef std::vector<OutTransfer*> OutTransfers;
 
   ola::Clock m_clock;
   ola::thread::ExecutorInterface* const m_executor;
@@ -159,17 +177,23 @@ class JaRuleWidgetPort {
   ola::SequenceNumber<uint8_t> m_token;
 
   ola::thread::Mutex m_mutex;
-  CommandQueue m_queued_commands;  // GUARDED_BY(m_mutex);
+  CommandQueue m_dmx_commands;  // GUARDED_BY(m_mutex);
+  CommandQueue m_rdm_commands;  // GUARDED_BY(m_mutex);
   PendingCommandMap m_pending_commands;  // GUARDED_BY(m_mutex);
+  unsigned int m_rdm_in_flight;  // GUARDED_BY(m_mutex);
 
-  libusb_transfer *m_out_transfer;  // GUARDED_BY(m_mutex);
-  bool m_out_in_progress;  // GUARDED_BY(m_mutex);
+  OutTransfers m_out_transfers;  // GUARDED_BY(m_mutex);
 
   uint8_t m_in_buffer[IN_BUFFER_SIZE];  // GUARDED_BY(m_mutex);
   libusb_transfer *m_in_transfer;  // GUARDED_BY(m_mutex);
   bool m_in_in_progress;  // GUARDED_BY(m_mutex);
 
-  void MaybeSendCommand();  // LOCK_REQUIRED(m_mutex);
+  void MaybeSendCommands();  // LOCK_REQUIRED(m_mutex);
+  bool SubmitCommand(OutTransfer *out,
+                     PendingCommand *command);  // LOCK_REQUIRED(m_mutex);
+  OutTransfer *FreeOutTransfer();  // LOCK_REQUIRED(m_mutex);
+  bool OutTransfersPending();  // LOCK_REQUIRED(m_mutex);
+  uint8_t NextToken();  // LOCK_REQUIRED(m_mutex);
   bool SubmitInTransfer();  // LOCK_REQUIRED(m_mutex);
   void HandleResponse(const uint8_t *data,
                       unsigned int size);  // LOCK_REQUIRED(m_mutex);
@@ -187,7 +211,9 @@ class JaRuleWidgetPort {
   static const unsigned int MAX_PAYLOAD_SIZE = 513;
   static const unsigned int MIN_RESPONSE_SIZE = 9;
   static const unsigned int USB_PACKET_SIZE = 64;
-  static const unsigned int MAX_IN_FLIGHT = 2;
+  // The maximum number of commands awaiting a response. One of these is
+  // reserved for DMX.
+  static const unsigned int MAX_IN_FLIGHT = 4;
   static const unsigned int MAX_QUEUED_MESSAGES = 10;
 
   static const unsigned int ENDPOINT_TIMEOUT_MS = 1000;
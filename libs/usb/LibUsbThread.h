@@ -29,6 +29,7 @@
 
 #include "ola/base/Macro.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/ThreadSettings.h"
 
 namespace ola {
 namespace usb {
@@ -59,7 +60,9 @@ class LibUsbThread : private ola::thread::Thread {
    * @param context the libusb context to use.
    */
   explicit LibUsbThread(libusb_context *context)
-    : m_context(context),
+    : ola::thread::Thread(ola::thread::Thread::Options(
+          "libusb", ola::thread::THREAD_CLASS_USB)),
+      m_context(context),
       m_term(false) {
   }
 
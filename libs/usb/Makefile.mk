@@ -21,7 +21,9 @@ libs_usb_libolausb_la_SOURCES = \
     libs/usb/LibUsbThread.cpp \
     libs/usb/LibUsbThread.h \
     libs/usb/Types.cpp \
-    libs/usb/Types.h
+    libs/usb/Types.h \
+    libs/usb/UsbDeviceMonitor.cpp \
+    libs/usb/UsbDeviceMonitor.h
 libs_usb_libolausb_la_CXXFLAGS = $(COMMON_CXXFLAGS) \
                                  $(libusb_CFLAGS)
 libs_usb_libolausb_la_LIBADD = $(libusb_LIBS) \
@@ -29,7 +31,8 @@ libs_usb_libolausb_la_LIBADD = $(libusb_LIBS) \
 
 # TESTS
 ##################################################
-test_programs += libs/usb/LibUsbThreadTester
+test_programs += libs/usb/LibUsbThreadTester \
+                 libs/usb/UsbDeviceMonitorTester
 
 LIBS_USB_TEST_LDADD = $(COMMON_TESTING_LIBS) \
                       $(libusb_LIBS) \
@@ -40,4 +43,10 @@ libs_usb_LibUsbThreadTester_SOURCES = \
 libs_usb_LibUsbThreadTester_CXXFLAGS = $(COMMON_TESTING_FLAGS) \
                                        $(libusb_CFLAGS)
 libs_usb_LibUsbThreadTester_LDADD = $(LIBS_USB_TEST_LDADD)
+
+libs_usb_UsbDeviceMonitorTester_SOURCES = \
+    libs/usb/UsbDeviceMonitorTest.cpp
+libs_usb_UsbDeviceMonitorTester_CXXFLAGS = $(COMMON_TESTING_FLAGS) \
+                                           $(libusb_CFLAGS)
+libs_usb_UsbDeviceMonitorTester_LDADD = $(LIBS_USB_TEST_LDADD)
 endif
@@ -0,0 +1,220 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UsbDeviceMonitor.cpp
+ * Listens for USB device uevents from the kernel & udev.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * We read the netlink socket directly rather than using libudev, which saves
+ * a dependency. Kernel messages are "ACTION@DEVPATH" followed by NUL
+ * terminated KEY=VALUE pairs. udev messages start with a header, which gives
+ * the offset & length of the KEY=VALUE pairs.
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include "libs/usb/UsbDeviceMonitor.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_LINUX_NETLINK_H
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#endif  // HAVE_LINUX_NETLINK_H
+
+#include <ola/Logging.h>
+#include <ola/StringUtils.h>
+#include <ola/network/NetworkUtils.h>
+#include <string>
+
+namespace ola {
+namespace usb {
+
+using std::string;
+
+namespace {
+
+const char UDEV_PREFIX[] = "libudev";
+const uint32_t UDEV_MAGIC = 0xfeedcafe;
+// The prefix, magic, header size, properties offset & properties length.
+const unsigned int UDEV_HEADER_SIZE = 24;
+const unsigned int UDEV_MAGIC_OFFSET = 8;
+const unsigned int UDEV_PROPERTIES_OFFSET = 16;
+
+uint32_t ReadUInt32(const uint8_t *data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+}  // namespace
+
+UsbDeviceMonitor::UsbDeviceMonitor(EventCallback *callback)
+    : m_callback(callback) {
+}
+
+UsbDeviceMonitor::~UsbDeviceMonitor() {
+  if (m_descriptor.get()) {
+    close(m_descriptor->ReadDescriptor());
+  }
+}
+
+bool UsbDeviceMonitor::Init() {
+  if (m_descriptor.get()) {
+    return true;
+  }
+
+#ifdef HAVE_LINUX_NETLINK_H
+  int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                  NETLINK_KOBJECT_UEVENT);
+  if (fd < 0) {
+    OLA_WARN << "Failed to open uevent socket: " << strerror(errno);
+    return false;
+  }
+
+  struct sockaddr_nl address;
+  memset(&address, 0, sizeof(address));
+  address.nl_family = AF_NETLINK;
+  // Group 1 is the kernel, group 2 is udev.
+  address.nl_groups = 1 | 2;
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address))) {
+    OLA_WARN << "Failed to bind uevent socket: " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  m_descriptor.reset(new ola::io::UnmanagedFileDescriptor(fd));
+  m_descriptor->SetOnData(
+      NewCallback(this, &UsbDeviceMonitor::ReceiveEvents));
+  return true;
+#else
+  OLA_INFO << "USB uevents aren't available on this platform";
+  return false;
+#endif  // HAVE_LINUX_NETLINK_H
+}
+
+bool UsbDeviceMonitor::ParseEvent(const uint8_t *data, unsigned int length,
+                                  EventType *type, uint8_t *bus_number,
+                                  uint8_t *device_address) {
+  const uint8_t *properties;
+  unsigned int properties_length;
+
+  if (length >= sizeof(UDEV_PREFIX) &&
+      memcmp(data, UDEV_PREFIX, sizeof(UDEV_PREFIX)) == 0) {
+    if (length < UDEV_HEADER_SIZE ||
+        ola::network::NetworkToHost(ReadUInt32(data + UDEV_MAGIC_OFFSET)) !=
+        UDEV_MAGIC) {
+      return false;
+    }
+    uint32_t offset = ReadUInt32(data + UDEV_PROPERTIES_OFFSET);
+    uint32_t size = ReadUInt32(data + UDEV_PROPERTIES_OFFSET + 4);
+    if (offset > length || size > length - offset) {
+      return false;
+    }
+    properties = data + offset;
+    properties_length = size;
+  } else {
+    // Skip over ACTION@DEVPATH
+    const uint8_t *end = reinterpret_cast<const uint8_t*>(
+        memchr(data, 0, length));
+    if (!end || !memchr(data, '@', end - data)) {
+      return false;
+    }
+    properties = end + 1;
+    properties_length = length - (properties - data);
+  }
+
+  string action, subsystem, devtype, bus, device;
+  unsigned int offset = 0;
+  while (offset < properties_length) {
+    const char *pair = reinterpret_cast<const char*>(properties + offset);
+    size_t pair_length = strnlen(pair, properties_length - offset);
+    const string property(pair, pair_length);
+    offset += pair_length + 1;
+
+    string::size_type equals = property.find('=');
+    if (equals == string::npos) {
+      continue;
+    }
+    const string key = property.substr(0, equals);
+    const string value = property.substr(equals + 1);
+    if (key == "ACTION") {
+      action = value;
+    } else if (key == "SUBSYSTEM") {
+      subsystem = value;
+    } else if (key == "DEVTYPE") {
+      devtype = value;
+    } else if (key == "BUSNUM") {
+      bus = value;
+    } else if (key == "DEVNUM") {
+      device = value;
+    }
+  }
+
+  if (subsystem != "usb" || devtype != "usb_device") {
+    return false;
+  }
+
+  if (action == "add") {
+    *type = DEVICE_ADDED;
+  } else if (action == "remove") {
+    *type = DEVICE_REMOVED;
+  } else {
+    return false;
+  }
+  return StringToInt(bus, bus_number) && StringToInt(device, device_address);
+}
+
+void UsbDeviceMonitor::ReceiveEvents() {
+#ifdef HAVE_LINUX_NETLINK_H
+  uint8_t buffer[8192];
+  while (true) {
+    struct sockaddr_nl sender;
+    socklen_t sender_length = sizeof(sender);
+    ssize_t length = recvfrom(m_descriptor->ReadDescriptor(), buffer,
+                              sizeof(buffer), 0,
+                              reinterpret_cast<struct sockaddr*>(&sender),
+                              &sender_length);
+    if (length < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        OLA_WARN << "Failed to read uevent: " << strerror(errno);
+      }
+      return;
+    }
+
+    // Kernel events come from port 0, udev events have a header.
+    if (sender.nl_pid != 0 &&
+        (static_cast<size_t>(length) < sizeof(UDEV_PREFIX) ||
+         memcmp(buffer, UDEV_PREFIX, sizeof(UDEV_PREFIX)) != 0)) {
+      continue;
+    }
+
+    EventType type;
+    uint8_t bus_number, device_address;
+    if (ParseEvent(buffer, length, &type, &bus_number, &device_address)) {
+      OLA_DEBUG << "USB uevent for " << static_cast<int>(bus_number) << ":"
+                << static_cast<int>(device_address) << " ["
+                << (type == DEVICE_ADDED ? "add" : "del") << "]";
+      m_callback->Run(type, bus_number, device_address);
+    }
+  }
+#endif  // HAVE_LINUX_NETLINK_H
+}
+}  // namespace usb
+}  // namespace ola
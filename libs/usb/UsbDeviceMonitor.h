@@ -0,0 +1,105 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UsbDeviceMonitor.h
+ * Listens for USB device uevents from the kernel & udev.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_USB_USBDEVICEMONITOR_H_
+#define LIBS_USB_USBDEVICEMONITOR_H_
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+
+#include <memory>
+
+namespace ola {
+namespace usb {
+
+/**
+ * @brief Reports USB devices being added or removed, without polling.
+ *
+ * On Linux this listens on a NETLINK_KOBJECT_UEVENT socket, which carries the
+ * uevents from both the kernel and udev. The udev events arrive once the
+ * rules have run, so the device node has the right permissions by then. The
+ * same device is usually reported by both, so the callback needs to cope with
+ * duplicate events.
+ *
+ * The descriptor should be added to a SelectServer; the callback is run from
+ * that SelectServer's thread. On other platforms Init() fails and the caller
+ * should fall back to scanning.
+ */
+class UsbDeviceMonitor {
+ public:
+  enum EventType {
+    DEVICE_ADDED,  //!< The device was added.
+    DEVICE_REMOVED  //!< The device was removed.
+  };
+
+  /**
+   * @brief Called with the event type, the bus number & the device address.
+   */
+  typedef ola::Callback3<void, EventType, uint8_t, uint8_t> EventCallback;
+
+  /**
+   * @brief Create a new UsbDeviceMonitor.
+   * @param callback the callback to run for each event, ownership is
+   *   transferred.
+   */
+  explicit UsbDeviceMonitor(EventCallback *callback);
+  ~UsbDeviceMonitor();
+
+  /**
+   * @brief Open the uevent socket.
+   * @returns false if uevents aren't available on this platform.
+   */
+  bool Init();
+
+  /**
+   * @brief The descriptor to add to a SelectServer.
+   * @returns the descriptor, or NULL if Init() hasn't succeeded.
+   */
+  ola::io::ReadFileDescriptor *GetDescriptor() const {
+    return m_descriptor.get();
+  }
+
+  /**
+   * @brief Parse a uevent message.
+   * @param data the message, either in the kernel or the udev format.
+   * @param length the length of the message.
+   * @param[out] type the type of the event.
+   * @param[out] bus_number the bus the device is on.
+   * @param[out] device_address the address of the device on the bus.
+   * @returns true if this was a USB device being added or removed, false for
+   *   any other event, e.g. one for a USB interface.
+   */
+  static bool ParseEvent(const uint8_t *data, unsigned int length,
+                         EventType *type, uint8_t *bus_number,
+                         uint8_t *device_address);
+
+ private:
+  std::auto_ptr<EventCallback> m_callback;
+  std::auto_ptr<ola::io::UnmanagedFileDescriptor> m_descriptor;
+
+  void ReceiveEvents();
+
+  DISALLOW_COPY_AND_ASSIGN(UsbDeviceMonitor);
+};
+}  // namespace usb
+}  // namespace ola
+#endif  // LIBS_USB_USBDEVICEMONITOR_H_
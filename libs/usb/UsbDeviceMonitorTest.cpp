@@ -0,0 +1,171 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UsbDeviceMonitorTest.cpp
+ * Test fixture for the UsbDeviceMonitor class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+#include "libs/usb/UsbDeviceMonitor.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::usb::UsbDeviceMonitor;
+using std::string;
+
+class UsbDeviceMonitorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(UsbDeviceMonitorTest);
+  CPPUNIT_TEST(testKernelEvents);
+  CPPUNIT_TEST(testUdevEvents);
+  CPPUNIT_TEST(testIgnoredEvents);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testKernelEvents();
+  void testUdevEvents();
+  void testIgnoredEvents();
+
+ private:
+  UsbDeviceMonitor::EventType m_type;
+  uint8_t m_bus_number;
+  uint8_t m_device_address;
+
+  bool Parse(const string &message);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UsbDeviceMonitorTest);
+
+namespace {
+
+const char ADD_EVENT[] =
+    "add@/devices/pci0000:00/0000:00:14.0/usb1/1-2\0"
+    "ACTION=add\0"
+    "DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-2\0"
+    "SUBSYSTEM=usb\0"
+    "DEVNAME=bus/usb/001/007\0"
+    "DEVTYPE=usb_device\0"
+    "PRODUCT=16c0/5dc/100\0"
+    "BUSNUM=001\0"
+    "DEVNUM=007\0";
+
+const char REMOVE_EVENT[] =
+    "remove@/devices/pci0000:00/0000:00:14.0/usb3/3-1\0"
+    "ACTION=remove\0"
+    "SUBSYSTEM=usb\0"
+    "DEVTYPE=usb_device\0"
+    "BUSNUM=003\0"
+    "DEVNUM=012\0";
+
+const char INTERFACE_EVENT[] =
+    "add@/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0\0"
+    "ACTION=add\0"
+    "SUBSYSTEM=usb\0"
+    "DEVTYPE=usb_interface\0";
+
+const char BIND_EVENT[] =
+    "bind@/devices/pci0000:00/0000:00:14.0/usb1/1-2\0"
+    "ACTION=bind\0"
+    "SUBSYSTEM=usb\0"
+    "DEVTYPE=usb_device\0"
+    "BUSNUM=001\0"
+    "DEVNUM=007\0";
+
+/*
+ * Wrap the properties from a kernel event in a udev header.
+ */
+string UdevMessage(const string &kernel_message) {
+  const string properties = kernel_message.substr(
+      kernel_message.find('\0') + 1);
+  uint8_t header[40];
+  memset(header, 0, sizeof(header));
+  memcpy(header, "libudev", 8);
+  uint32_t value = ola::network::HostToNetwork(0xfeedcafe);
+  memcpy(header + 8, &value, sizeof(value));
+  value = sizeof(header);
+  memcpy(header + 12, &value, sizeof(value));
+  memcpy(header + 16, &value, sizeof(value));
+  value = properties.size();
+  memcpy(header + 20, &value, sizeof(value));
+  return string(reinterpret_cast<char*>(header), sizeof(header)) +
+      properties;
+}
+}  // namespace
+
+
+bool UsbDeviceMonitorTest::Parse(const string &message) {
+  return UsbDeviceMonitor::ParseEvent(
+      reinterpret_cast<const uint8_t*>(message.data()), message.size(),
+      &m_type, &m_bus_number, &m_device_address);
+}
+
+
+/*
+ * Check we parse the events sent by the kernel.
+ */
+void UsbDeviceMonitorTest::testKernelEvents() {
+  OLA_ASSERT_TRUE(Parse(string(ADD_EVENT, sizeof(ADD_EVENT) - 1)));
+  OLA_ASSERT_EQ(UsbDeviceMonitor::DEVICE_ADDED, m_type);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), m_bus_number);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(7), m_device_address);
+
+  OLA_ASSERT_TRUE(Parse(string(REMOVE_EVENT, sizeof(REMOVE_EVENT) - 1)));
+  OLA_ASSERT_EQ(UsbDeviceMonitor::DEVICE_REMOVED, m_type);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(3), m_bus_number);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(12), m_device_address);
+}
+
+
+/*
+ * Check we parse the events sent by udev.
+ */
+void UsbDeviceMonitorTest::testUdevEvents() {
+  OLA_ASSERT_TRUE(Parse(UdevMessage(string(ADD_EVENT,
+                                           sizeof(ADD_EVENT) - 1))));
+  OLA_ASSERT_EQ(UsbDeviceMonitor::DEVICE_ADDED, m_type);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), m_bus_number);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(7), m_device_address);
+
+  // A bad magic number
+  string message = UdevMessage(string(ADD_EVENT, sizeof(ADD_EVENT) - 1));
+  message[8] = 0;
+  OLA_ASSERT_FALSE(Parse(message));
+
+  // The properties run past the end of the message
+  message = UdevMessage(string(ADD_EVENT, sizeof(ADD_EVENT) - 1));
+  OLA_ASSERT_FALSE(Parse(message.substr(0, message.size() - 1)));
+}
+
+
+/*
+ * Check that other events are ignored.
+ */
+void UsbDeviceMonitorTest::testIgnoredEvents() {
+  OLA_ASSERT_FALSE(Parse(string(INTERFACE_EVENT,
+                                sizeof(INTERFACE_EVENT) - 1)));
+  OLA_ASSERT_FALSE(Parse(string(BIND_EVENT, sizeof(BIND_EVENT) - 1)));
+  OLA_ASSERT_FALSE(Parse(""));
+  OLA_ASSERT_FALSE(Parse("ACTION=add"));
+
+  // Missing the device number
+  const char event[] =
+      "add@/devices/usb1/1-2\0ACTION=add\0SUBSYSTEM=usb\0"
+      "DEVTYPE=usb_device\0BUSNUM=001\0";
+  OLA_ASSERT_FALSE(Parse(string(event, sizeof(event) - 1)));
+}
@@ -0,0 +1,123 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxDataEncoder.cpp
+ * Encode StreamDmxData RPCs without building protobuf messages.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <algorithm>
+
+#include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcHeader.h"
+#include "ola/DmxDataEncoder.h"
+
+namespace ola {
+namespace client {
+
+using ola::rpc::RpcChannel;
+using ola::rpc::RpcHeader;
+
+namespace {
+
+enum WireType {
+  VARINT = 0,
+  LENGTH_DELIMITED = 2,
+};
+
+uint8_t Tag(unsigned int field, WireType wire_type) {
+  return static_cast<uint8_t>((field << 3) | wire_type);
+}
+
+// See Rpc.proto & Ola.proto.
+const unsigned int RPC_TYPE_FIELD = 1;
+const unsigned int RPC_ID_FIELD = 2;
+const unsigned int RPC_NAME_FIELD = 3;
+const unsigned int RPC_BUFFER_FIELD = 4;
+const unsigned int RPC_STREAM_REQUEST = 10;
+const char METHOD_NAME[] = "StreamDmxData";
+
+const unsigned int DMX_UNIVERSE_FIELD = 1;
+const unsigned int DMX_DATA_FIELD = 2;
+const unsigned int DMX_PRIORITY_FIELD = 3;
+}  // namespace
+
+
+unsigned int DmxDataEncoder::Encode(uint32_t id, unsigned int universe,
+                                    uint8_t priority, const DmxBuffer &data,
+                                    uint8_t *output) {
+  // The universe is an int32, which protobuf sign extends to 64 bits.
+  const uint64_t universe_value = static_cast<uint64_t>(
+      static_cast<int64_t>(static_cast<int32_t>(universe)));
+  const unsigned int length = std::min(
+      data.Size(), static_cast<unsigned int>(DMX_UNIVERSE_SIZE));
+  const unsigned int dmx_data_size =
+      1 + VarintSize(universe_value) + 1 + VarintSize(length) + length +
+      1 + VarintSize(priority);
+  const unsigned int name_size = sizeof(METHOD_NAME) - 1;
+
+  uint8_t *ptr = output + sizeof(uint32_t);
+  *ptr++ = Tag(RPC_TYPE_FIELD, VARINT);
+  ptr = EncodeVarint(RPC_STREAM_REQUEST, ptr);
+  *ptr++ = Tag(RPC_ID_FIELD, VARINT);
+  ptr = EncodeVarint(id, ptr);
+  *ptr++ = Tag(RPC_NAME_FIELD, LENGTH_DELIMITED);
+  ptr = EncodeVarint(name_size, ptr);
+  memcpy(ptr, METHOD_NAME, name_size);
+  ptr += name_size;
+  *ptr++ = Tag(RPC_BUFFER_FIELD, LENGTH_DELIMITED);
+  ptr = EncodeVarint(dmx_data_size, ptr);
+
+  *ptr++ = Tag(DMX_UNIVERSE_FIELD, VARINT);
+  ptr = EncodeVarint(universe_value, ptr);
+  *ptr++ = Tag(DMX_DATA_FIELD, LENGTH_DELIMITED);
+  ptr = EncodeVarint(length, ptr);
+  if (length) {
+    memcpy(ptr, data.GetRaw(), length);
+    ptr += length;
+  }
+  *ptr++ = Tag(DMX_PRIORITY_FIELD, VARINT);
+  ptr = EncodeVarint(priority, ptr);
+
+  const unsigned int size = ptr - output;
+  uint32_t header;
+  RpcHeader::EncodeHeader(&header, RpcChannel::PROTOCOL_VERSION,
+                          size - sizeof(header));
+  memcpy(output, &header, sizeof(header));
+  return size;
+}
+
+
+unsigned int DmxDataEncoder::VarintSize(uint64_t value) {
+  unsigned int size = 1;
+  while (value > 0x7f) {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+
+uint8_t *DmxDataEncoder::EncodeVarint(uint64_t value, uint8_t *output) {
+  while (value > 0x7f) {
+    *output++ = static_cast<uint8_t>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  *output++ = static_cast<uint8_t>(value);
+  return output;
+}
+}  // namespace client
+}  // namespace ola
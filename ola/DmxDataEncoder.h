@@ -0,0 +1,66 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxDataEncoder.h
+ * Encode StreamDmxData RPCs without building protobuf messages.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLA_DMXDATAENCODER_H_
+#define OLA_DMXDATAENCODER_H_
+
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <stdint.h>
+
+namespace ola {
+namespace client {
+
+/**
+ * @brief Writes a framed StreamDmxData RPC straight into a buffer.
+ *
+ * The output is identical to what the RpcChannel sends for the same
+ * ola::proto::DmxData, but the DMX data is copied once, from the DmxBuffer to
+ * the output, rather than through the intermediate strings of the request
+ * and the RpcMessage.
+ */
+class DmxDataEncoder {
+ public:
+  /**
+   * @brief Encode a StreamDmxData RPC, including the RPC header.
+   * @param id the RPC message id.
+   * @param universe the universe id.
+   * @param priority the priority of the data.
+   * @param data the DMX data, at most DMX_UNIVERSE_SIZE slots are sent.
+   * @param output the buffer to write to, this must be at least MAX_SIZE
+   *   bytes.
+   * @returns the number of bytes written.
+   */
+  static unsigned int Encode(uint32_t id, unsigned int universe,
+                             uint8_t priority, const DmxBuffer &data,
+                             uint8_t *output);
+
+  /**
+   * @brief The largest message Encode() writes.
+   */
+  static const unsigned int MAX_SIZE = 576;
+
+ private:
+  static unsigned int VarintSize(uint64_t value);
+  static uint8_t *EncodeVarint(uint64_t value, uint8_t *output);
+};
+}  // namespace client
+}  // namespace ola
+#endif  // OLA_DMXDATAENCODER_H_
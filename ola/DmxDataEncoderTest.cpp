@@ -0,0 +1,111 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxDataEncoderTest.cpp
+ * Test fixture for the DmxDataEncoder class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+
+#include "common/protocol/Ola.pb.h"
+#include "common/rpc/Rpc.pb.h"
+#include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcHeader.h"
+#include "ola/DmxBuffer.h"
+#include "ola/DmxDataEncoder.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::client::DmxDataEncoder;
+using ola::rpc::RpcChannel;
+using ola::rpc::RpcHeader;
+using std::string;
+
+class DmxDataEncoderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxDataEncoderTest);
+  CPPUNIT_TEST(testEncode);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEncode();
+
+ private:
+    string Expected(uint32_t id, int32_t universe, uint8_t priority,
+                    const DmxBuffer &data);
+    string Encode(uint32_t id, unsigned int universe, uint8_t priority,
+                  const DmxBuffer &data);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxDataEncoderTest);
+
+
+/*
+ * Check the output matches what the RpcChannel sends.
+ */
+void DmxDataEncoderTest::testEncode() {
+  DmxBuffer buffer;
+  OLA_ASSERT_EQ(Expected(0, 1, 100, buffer), Encode(0, 1, 100, buffer));
+
+  buffer.SetFromString("0,128,255");
+  OLA_ASSERT_EQ(Expected(1, 1, 100, buffer), Encode(1, 1, 100, buffer));
+  OLA_ASSERT_EQ(Expected(300, 70000, 200, buffer),
+                Encode(300, 70000, 200, buffer));
+
+  // Universes past 2^31 are negative int32s.
+  OLA_ASSERT_EQ(Expected(0xffffffff, -1, 0, buffer),
+                Encode(0xffffffff, 0xffffffff, 0, buffer));
+
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    buffer.SetChannel(i, i);
+  }
+  string encoded = Encode(0xffffffff, 0xffffffff, 255, buffer);
+  OLA_ASSERT_EQ(Expected(0xffffffff, -1, 255, buffer), encoded);
+  OLA_ASSERT_TRUE(encoded.size() <= DmxDataEncoder::MAX_SIZE);
+}
+
+
+string DmxDataEncoderTest::Expected(uint32_t id, int32_t universe,
+                                    uint8_t priority, const DmxBuffer &data) {
+  ola::proto::DmxData request;
+  request.set_universe(universe);
+  request.set_data(data.Get());
+  request.set_priority(priority);
+
+  ola::rpc::RpcMessage message;
+  message.set_type(ola::rpc::STREAM_REQUEST);
+  message.set_id(id);
+  message.set_name("StreamDmxData");
+  message.set_buffer(request.SerializeAsString());
+  string output = message.SerializeAsString();
+
+  uint32_t header;
+  RpcHeader::EncodeHeader(&header, RpcChannel::PROTOCOL_VERSION,
+                          output.size());
+  return string(reinterpret_cast<const char*>(&header), sizeof(header)) +
+         output;
+}
+
+
+string DmxDataEncoderTest::Encode(uint32_t id, unsigned int universe,
+                                  uint8_t priority, const DmxBuffer &data) {
+  uint8_t output[DmxDataEncoder::MAX_SIZE];
+  unsigned int size = DmxDataEncoder::Encode(id, universe, priority, data,
+                                             output);
+  return string(reinterpret_cast<const char*>(output), size);
+}
@@ -0,0 +1,400 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FutureClient.cpp
+ * A client API which returns Futures.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/AutoStart.h>  // NOLINT(build/include)
+#include <ola/Callback.h>
+#include <ola/Logging.h>
+#include <ola/client/FutureClient.h>
+#include <ola/client/OlaClient.h>
+#include <ola/client/Result.h>
+#include <ola/io/SelectServer.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/SocketAddress.h>
+#include <ola/network/TCPSocket.h>
+#include <ola/network/UnixDomainSocket.h>
+#include <ola/rdm/RDMCommand.h>
+#include <ola/stl/STLUtils.h>
+#include <ola/thread/Thread.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace client {
+
+using ola::io::SelectServer;
+using ola::network::TCPSocket;
+using ola::network::UnixDomainSocket;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using ola::thread::Future;
+using std::string;
+using std::vector;
+
+namespace {
+const char NOT_RUNNING_ERROR[] = "The client isn't running";
+const char CONNECTION_CLOSED_ERROR[] = "The connection to olad was closed";
+
+template <typename T>
+void FailFuture(Future<FutureResult<T> > future, const string &error) {
+  FutureResult<T> result;
+  result.error = error;
+  future.Set(result);
+}
+}  // namespace
+
+/*
+ * The thread that runs the SelectServer.
+ */
+class FutureClient::ClientThread : public ola::thread::Thread {
+ public:
+  explicit ClientThread(SelectServer *ss)
+      : Thread(Thread::Options("ola-future-client")),
+        m_ss(ss) {
+  }
+
+  void *Run() {
+    m_ss->Run();
+    return NULL;
+  }
+
+ private:
+  SelectServer *m_ss;
+};
+
+/*
+ * A call that has been sent to olad and hasn't completed yet.
+ */
+class FutureClient::PendingCallInterface {
+ public:
+  virtual ~PendingCallInterface() {}
+
+  virtual void Fail(const string &error) = 0;
+};
+
+template <typename T>
+class FutureClient::PendingCall : public FutureClient::PendingCallInterface {
+ public:
+  explicit PendingCall(Future<FutureResult<T> > future)
+      : m_future(future) {
+  }
+
+  void Complete(const FutureResult<T> &result) { m_future.Set(result); }
+
+  void Fail(const string &error) { FailFuture(m_future, error); }
+
+ private:
+  Future<FutureResult<T> > m_future;
+};
+
+struct FutureClient::RDMRequest {
+  bool is_set;
+  unsigned int universe;
+  UID uid;
+  uint16_t sub_device;
+  uint16_t pid;
+  string data;
+
+  RDMRequest(bool is_set, unsigned int universe, const UID &uid,
+             uint16_t sub_device, uint16_t pid, const string &data)
+      : is_set(is_set),
+        universe(universe),
+        uid(uid),
+        sub_device(sub_device),
+        pid(pid),
+        data(data) {
+  }
+};
+
+FutureClient::FutureClient(const Options &options)
+    : m_options(options),
+      m_connection_closed(false) {
+}
+
+FutureClient::~FutureClient() {
+  Stop();
+}
+
+bool FutureClient::Start() {
+  if (m_thread.get()) {
+    return false;
+  }
+
+  ola::io::ConnectedDescriptor *socket = NULL;
+  if (!m_options.socket_path.empty()) {
+    socket = UnixDomainSocket::Connect(m_options.socket_path);
+  } else if (m_options.auto_start) {
+    socket = ola::client::ConnectToServer(m_options.server_port);
+  } else {
+    socket = TCPSocket::Connect(
+        ola::network::IPV4SocketAddress(
+            ola::network::IPV4Address::Loopback(), m_options.server_port));
+  }
+
+  if (!socket) {
+    return false;
+  }
+  m_socket.reset(socket);
+  m_connection_closed = false;
+
+  m_ss.reset(new SelectServer());
+  m_client.reset(new OlaClient(m_socket.get()));
+  m_client->SetPipelining(m_ss.get());
+  if (!m_client->Setup()) {
+    m_client.reset();
+    m_ss.reset();
+    m_socket.reset();
+    return false;
+  }
+  m_client->SetCloseHandler(
+      NewSingleCallback(this, &FutureClient::ConnectionClosed));
+  m_ss->AddReadDescriptor(m_socket.get());
+
+  m_thread.reset(new ClientThread(m_ss.get()));
+  if (!m_thread->Start()) {
+    OLA_WARN << "Failed to start the client thread";
+    m_thread.reset();
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+void FutureClient::Stop() {
+  if (m_thread.get()) {
+    m_ss->Terminate();
+    m_thread->Join();
+    m_thread.reset();
+  }
+
+  // The client thread has exited, so it's now safe to touch the client from
+  // this thread.
+  FailPendingCalls(NOT_RUNNING_ERROR);
+  if (m_client.get()) {
+    m_ss->RemoveReadDescriptor(m_socket.get());
+    m_client->Stop();
+  }
+  // This runs any calls which were queued but not yet sent, they fail since
+  // the client has stopped.
+  m_ss.reset();
+  FailPendingCalls(NOT_RUNNING_ERROR);
+  m_client.reset();
+  m_socket.reset();
+}
+
+UniverseListFuture FutureClient::FetchUniverseList() {
+  UniverseListFuture future;
+  if (m_ss.get()) {
+    m_ss->Execute(
+        NewSingleCallback(this, &FutureClient::DoFetchUniverseList, future));
+  } else {
+    FailFuture(future, NOT_RUNNING_ERROR);
+  }
+  return future;
+}
+
+SetFuture FutureClient::SetUniverseName(unsigned int universe,
+                                        const string &name) {
+  SetFuture future;
+  if (m_ss.get()) {
+    m_ss->Execute(NewSingleCallback(this, &FutureClient::DoSetUniverseName,
+                                    future, universe, name));
+  } else {
+    FailFuture(future, NOT_RUNNING_ERROR);
+  }
+  return future;
+}
+
+UIDListFuture FutureClient::RunDiscovery(unsigned int universe,
+                                         DiscoveryType discovery_type) {
+  UIDListFuture future;
+  if (m_ss.get()) {
+    m_ss->Execute(NewSingleCallback(this, &FutureClient::DoRunDiscovery,
+                                    future, universe, discovery_type));
+  } else {
+    FailFuture(future, NOT_RUNNING_ERROR);
+  }
+  return future;
+}
+
+RDMFuture FutureClient::RDMGet(unsigned int universe,
+                               const UID &uid,
+                               uint16_t sub_device,
+                               uint16_t pid,
+                               const string &data) {
+  RDMFuture future;
+  if (m_ss.get()) {
+    m_ss->Execute(NewSingleCallback(
+        this, &FutureClient::DoSendRDM, future,
+        new RDMRequest(false, universe, uid, sub_device, pid, data)));
+  } else {
+    FailFuture(future, NOT_RUNNING_ERROR);
+  }
+  return future;
+}
+
+RDMFuture FutureClient::RDMSet(unsigned int universe,
+                               const UID &uid,
+                               uint16_t sub_device,
+                               uint16_t pid,
+                               const string &data) {
+  RDMFuture future;
+  if (m_ss.get()) {
+    m_ss->Execute(NewSingleCallback(
+        this, &FutureClient::DoSendRDM, future,
+        new RDMRequest(true, universe, uid, sub_device, pid, data)));
+  } else {
+    FailFuture(future, NOT_RUNNING_ERROR);
+  }
+  return future;
+}
+
+template <typename T>
+FutureClient::PendingCall<T> *FutureClient::NewPendingCall(
+    Future<FutureResult<T> > future) {
+  PendingCall<T> *call = new PendingCall<T>(future);
+  m_pending.insert(call);
+  return call;
+}
+
+template <typename T>
+void FutureClient::CompleteCall(PendingCall<T> *call,
+                                const FutureResult<T> &result) {
+  // Calls which were failed by FailPendingCalls() are no longer tracked.
+  if (!STLRemove(&m_pending, call)) {
+    return;
+  }
+  call->Complete(result);
+  delete call;
+}
+
+void FutureClient::FailPendingCalls(const string &error) {
+  // Take a copy, since failing a call may queue more.
+  std::set<PendingCallInterface*> pending;
+  pending.swap(m_pending);
+  std::set<PendingCallInterface*>::iterator iter = pending.begin();
+  for (; iter != pending.end(); ++iter) {
+    (*iter)->Fail(error);
+    delete *iter;
+  }
+}
+
+void FutureClient::ConnectionClosed() {
+  OLA_INFO << "Server closed the connection";
+  m_connection_closed = true;
+  // olad will never reply to these.
+  FailPendingCalls(CONNECTION_CLOSED_ERROR);
+}
+
+void FutureClient::DoFetchUniverseList(UniverseListFuture future) {
+  if (m_connection_closed) {
+    return FailFuture(future, CONNECTION_CLOSED_ERROR);
+  }
+  m_client->FetchUniverseList(
+      NewSingleCallback(this, &FutureClient::HandleUniverseList,
+                        NewPendingCall(future)));
+}
+
+void FutureClient::DoSetUniverseName(SetFuture future,
+                                     unsigned int universe,
+                                     string name) {
+  if (m_connection_closed) {
+    return FailFuture(future, CONNECTION_CLOSED_ERROR);
+  }
+  m_client->SetUniverseName(
+      universe, name,
+      NewSingleCallback(this, &FutureClient::HandleSet,
+                        NewPendingCall(future)));
+}
+
+void FutureClient::DoRunDiscovery(UIDListFuture future,
+                                  unsigned int universe,
+                                  DiscoveryType discovery_type) {
+  if (m_connection_closed) {
+    return FailFuture(future, CONNECTION_CLOSED_ERROR);
+  }
+  m_client->RunDiscovery(
+      universe, discovery_type,
+      NewSingleCallback(this, &FutureClient::HandleUIDList,
+                        NewPendingCall(future)));
+}
+
+void FutureClient::DoSendRDM(RDMFuture future, RDMRequest *request) {
+  if (m_connection_closed) {
+    delete request;
+    return FailFuture(future, CONNECTION_CLOSED_ERROR);
+  }
+  SendRDMArgs args(NewSingleCallback(this, &FutureClient::HandleRDM,
+                                     NewPendingCall(future)));
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(
+      request->data.data());
+  if (request->is_set) {
+    m_client->RDMSet(request->universe, request->uid, request->sub_device,
+                     request->pid, data, request->data.size(), args);
+  } else {
+    m_client->RDMGet(request->universe, request->uid, request->sub_device,
+                     request->pid, data, request->data.size(), args);
+  }
+  delete request;
+}
+
+void FutureClient::HandleSet(PendingCall<void> *call, const Result &result) {
+  FutureResult<void> future_result;
+  future_result.error = result.Error();
+  CompleteCall(call, future_result);
+}
+
+void FutureClient::HandleUniverseList(PendingCall<vector<OlaUniverse> > *call,
+                                      const Result &result,
+                                      const vector<OlaUniverse> &universes) {
+  FutureResult<vector<OlaUniverse> > future_result;
+  future_result.error = result.Error();
+  future_result.value = universes;
+  CompleteCall(call, future_result);
+}
+
+void FutureClient::HandleUIDList(PendingCall<UIDSet> *call,
+                                 const Result &result,
+                                 const UIDSet &uids) {
+  FutureResult<UIDSet> future_result;
+  future_result.error = result.Error();
+  future_result.value = uids;
+  CompleteCall(call, future_result);
+}
+
+void FutureClient::HandleRDM(PendingCall<RDMReplyData> *call,
+                             const Result &result,
+                             const RDMMetadata &metadata,
+                             const ola::rdm::RDMResponse *response) {
+  FutureResult<RDMReplyData> future_result;
+  future_result.error = result.Error();
+  future_result.value.metadata = metadata;
+  if (response) {
+    future_result.value.has_response = true;
+    future_result.value.response_type = response->ResponseType();
+    future_result.value.param_data.assign(
+        reinterpret_cast<const char*>(response->ParamData()),
+        response->ParamDataSize());
+  }
+  CompleteCall(call, future_result);
+}
+}  // namespace client
+}  // namespace ola
@@ -0,0 +1,194 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FutureClientTest.cpp
+ * Test fixture for the FutureClient class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Flags.h"
+#include "ola/client/FutureClient.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/OlaDaemon.h"
+
+DECLARE_uint16(rpc_port);
+
+using ola::OlaDaemon;
+using ola::TimeInterval;
+using ola::client::DISCOVERY_CACHED;
+using ola::client::FutureClient;
+using ola::client::RDMFuture;
+using ola::client::SetFuture;
+using ola::client::UIDListFuture;
+using ola::client::UniverseListFuture;
+using ola::network::GenericSocketAddress;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::vector;
+
+class FutureClientTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FutureClientTest);
+  CPPUNIT_TEST(testNotRunning);
+  CPPUNIT_TEST(testConcurrentCalls);
+  CPPUNIT_TEST(testServerClosed);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void tearDown();
+    void testNotRunning();
+    void testConcurrentCalls();
+    void testServerClosed();
+
+ private:
+    auto_ptr<OlaDaemon> m_olad;
+
+    FutureClient::Options ClientOptions();
+
+    /*
+     * Run olad until the future completes. olad runs in this thread, so we
+     * can't block in Get().
+     */
+    template <typename T>
+    void WaitFor(T *future) {
+      while (!future->IsComplete()) {
+        m_olad->GetSelectServer()->RunOnce(TimeInterval(0, 10000));
+      }
+    }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FutureClientTest);
+
+
+void FutureClientTest::setUp() {
+  ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  FLAGS_rpc_port = 0;  // pick an unused port
+  ola::OlaServer::Options ola_options;
+  ola_options.http_enable = false;
+  ola_options.http_localhost_only = false;
+  ola_options.http_enable_quit = false;
+  ola_options.http_port = 0;
+  ola_options.http_data_dir = "";
+
+  m_olad.reset(new OlaDaemon(ola_options, NULL));
+  OLA_ASSERT_TRUE(m_olad->Init());
+}
+
+
+void FutureClientTest::tearDown() {
+  if (m_olad.get()) {
+    m_olad->Shutdown();
+    m_olad.reset();
+  }
+}
+
+
+FutureClient::Options FutureClientTest::ClientOptions() {
+  GenericSocketAddress server_address = m_olad->RPCAddress();
+  OLA_ASSERT_EQ(static_cast<uint16_t>(AF_INET), server_address.Family());
+  FutureClient::Options options;
+  options.auto_start = false;
+  options.server_port = server_address.V4Addr().Port();
+  return options;
+}
+
+
+/*
+ * Check that calls fail straight away if the client isn't running.
+ */
+void FutureClientTest::testNotRunning() {
+  FutureClient client(ClientOptions());
+
+  UniverseListFuture universes = client.FetchUniverseList();
+  OLA_ASSERT_TRUE(universes.IsComplete());
+  OLA_ASSERT_FALSE(universes.Get().Success());
+
+  OLA_ASSERT_TRUE(client.Start());
+  OLA_ASSERT_FALSE(client.Start());
+  client.Stop();
+
+  SetFuture set = client.SetUniverseName(1, "foo");
+  OLA_ASSERT_TRUE(set.IsComplete());
+  OLA_ASSERT_FALSE(set.Get().Success());
+}
+
+
+/*
+ * Check that many calls can be in flight at once.
+ */
+void FutureClientTest::testConcurrentCalls() {
+  FutureClient client(ClientOptions());
+  OLA_ASSERT_TRUE(client.Start());
+
+  const UID uid(0x7a70, 1);
+  UniverseListFuture universes = client.FetchUniverseList();
+  SetFuture set = client.SetUniverseName(1, "foo");
+  UIDListFuture uids = client.RunDiscovery(1, DISCOVERY_CACHED);
+  vector<RDMFuture> rdm_futures;
+  for (unsigned int i = 0; i < 10; i++) {
+    rdm_futures.push_back(client.RDMGet(1, uid, 0, 0x0060));
+  }
+  rdm_futures.push_back(client.RDMSet(1, uid, 0, 0x1000, "\x01"));
+
+  WaitFor(&universes);
+  OLA_ASSERT_TRUE(universes.Get().Success());
+  OLA_ASSERT_TRUE(universes.Get().value.empty());
+
+  // Universe 1 doesn't exist, so the rest of the calls fail.
+  WaitFor(&set);
+  OLA_ASSERT_FALSE(set.Get().Success());
+  WaitFor(&uids);
+  OLA_ASSERT_FALSE(uids.Get().Success());
+
+  vector<RDMFuture>::iterator iter = rdm_futures.begin();
+  for (; iter != rdm_futures.end(); ++iter) {
+    WaitFor(&(*iter));
+    OLA_ASSERT_FALSE(iter->Get().Success());
+    OLA_ASSERT_FALSE(iter->Get().value.has_response);
+  }
+  client.Stop();
+}
+
+
+/*
+ * Check that calls complete once the server goes away.
+ */
+void FutureClientTest::testServerClosed() {
+  FutureClient client(ClientOptions());
+  OLA_ASSERT_TRUE(client.Start());
+
+  UniverseListFuture universes = client.FetchUniverseList();
+  WaitFor(&universes);
+  OLA_ASSERT_TRUE(universes.Get().Success());
+
+  m_olad->Shutdown();
+  m_olad.reset();
+
+  // Nothing is running olad now, so this would hang if the call was never
+  // completed.
+  universes = client.FetchUniverseList();
+  OLA_ASSERT_FALSE(universes.Get().Success());
+  client.Stop();
+}
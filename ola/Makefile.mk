@@ -20,6 +20,9 @@ ola_libola_la_SOURCES = \
     ola/ClientRDMAPIShim.cpp \
     ola/ClientTypesFactory.h \
     ola/ClientTypesFactory.cpp \
+    ola/DmxDataEncoder.h \
+    ola/DmxDataEncoder.cpp \
+    ola/FutureClient.cpp \
     ola/Module.cpp \
     ola/OlaCallbackClient.cpp \
     ola/OlaClient.cpp \
@@ -35,7 +38,9 @@ ola_libola_la_LIBADD = common/libolacommon.la
 ##################################################
 test_programs += ola/OlaClientTester
 
-ola_OlaClientTester_SOURCES = ola/OlaClientWrapperTest.cpp \
+ola_OlaClientTester_SOURCES = ola/DmxDataEncoderTest.cpp \
+                              ola/FutureClientTest.cpp \
+                              ola/OlaClientWrapperTest.cpp \
                               ola/StreamingClientTest.cpp
 ola_OlaClientTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 ola_OlaClientTester_LDADD = $(COMMON_TESTING_LIBS) \
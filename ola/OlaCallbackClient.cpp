@@ -63,6 +63,11 @@ void OlaCallbackClient::SetCloseHandler(
   m_core->SetCloseHandler(callback);
 }
 
+void OlaCallbackClient::SetPipelining(
+    ola::thread::SchedulerInterface *scheduler) {
+  m_core->SetPipelining(scheduler);
+}
+
 bool OlaCallbackClient::FetchPluginList(
     SingleUseCallback2<void, const vector<OlaPlugin>&,
                        const string&> *callback) {
@@ -32,6 +32,7 @@
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/UID.h>
 #include <ola/rdm/UIDSet.h>
+#include <ola/thread/SchedulerInterface.h>
 #include <ola/timecode/TimeCode.h>
 
 #include <memory>
@@ -84,6 +85,7 @@ class OlaCallbackClient: public ola::rdm::RDMAPIImplInterface {
     bool Stop();
 
     void SetCloseHandler(ola::SingleUseCallback0<void> *callback);
+    void SetPipelining(ola::thread::SchedulerInterface *scheduler);
 
     // plugin methods
     bool FetchPluginList(
@@ -58,10 +58,22 @@ void OlaClient::SetCloseHandler(ola::SingleUseCallback0<void> *callback) {
   m_core->SetCloseHandler(callback);
 }
 
+void OlaClient::SetPipelining(ola::thread::SchedulerInterface *scheduler) {
+  m_core->SetPipelining(scheduler);
+}
+
 void OlaClient::SetDMXCallback(RepeatableDMXCallback *callback) {
   m_core->SetDMXCallback(callback);
 }
 
+void OlaClient::SetSlotChangeCallback(RepeatableSlotChangeCallback *callback) {
+  m_core->SetSlotChangeCallback(callback);
+}
+
+void OlaClient::SetRDMPollCallback(RepeatableRDMPollCallback *callback) {
+  m_core->SetRDMPollCallback(callback);
+}
+
 void OlaClient::ReloadPlugins(SetCallback *callback) {
   m_core->ReloadPlugins(callback);
 }
@@ -143,6 +155,12 @@ void OlaClient::SetUniverseMergeMode(unsigned int universe,
   m_core->SetUniverseMergeMode(universe, mode, callback);
 }
 
+void OlaClient::SetUniverseLayers(unsigned int universe,
+                                  const vector<UniverseLayer> &layers,
+                                  SetCallback *callback) {
+  m_core->SetUniverseLayers(universe, layers, callback);
+}
+
 void OlaClient::Patch(unsigned int device_alias,
                       unsigned int port,
                       PortDirection port_direction,
@@ -152,12 +170,43 @@ void OlaClient::Patch(unsigned int device_alias,
   m_core->Patch(device_alias, port, port_direction, action, universe, callback);
 }
 
+void OlaClient::PatchPorts(const vector<PortPatch> &patches,
+                           SetCallback *callback) {
+  m_core->PatchPorts(patches, callback);
+}
+
+void OlaClient::SetDeltaUpdates(bool enable) {
+  m_core->SetDeltaUpdates(enable);
+}
+
+void OlaClient::SetUpdateRateLimit(unsigned int max_rate,
+                                   unsigned int min_change) {
+  m_core->SetUpdateRateLimit(max_rate, min_change);
+}
+
 void OlaClient::RegisterUniverse(unsigned int universe,
                                  RegisterAction register_action,
                                  SetCallback *callback) {
   m_core->RegisterUniverse(universe, register_action, callback);
 }
 
+void OlaClient::SubscribeSlots(unsigned int universe,
+                               const vector<SlotRange> &ranges,
+                               SetCallback *callback) {
+  m_core->SubscribeSlots(universe, ranges, callback);
+}
+
+void OlaClient::SubscribeRDMPoll(unsigned int universe,
+                                 const ola::rdm::UID &uid,
+                                 uint16_t sub_device,
+                                 uint16_t pid,
+                                 const string &data,
+                                 unsigned int period_ms,
+                                 SetCallback *callback) {
+  m_core->SubscribeRDMPoll(universe, uid, sub_device, pid, data, period_ms,
+                           callback);
+}
+
 void OlaClient::SendDMX(unsigned int universe,
                         const DmxBuffer &data,
                         const SendDMXArgs &args) {
@@ -168,6 +217,16 @@ void OlaClient::FetchDMX(unsigned int universe, DMXCallback *callback) {
   m_core->FetchDMX(universe, callback);
 }
 
+void OlaClient::FetchDMXMulti(const std::vector<unsigned int> &universes,
+                              MultiDMXCallback *callback) {
+  m_core->FetchDMXMulti(universes, callback);
+}
+
+void OlaClient::FetchUniverseStats(const std::vector<unsigned int> &universes,
+                                   UniverseStatsCallback *callback) {
+  m_core->FetchUniverseStats(universes, callback);
+}
+
 void OlaClient::RunDiscovery(unsigned int universe,
                              DiscoveryType discovery_type,
                              DiscoveryCallback *callback) {
@@ -179,6 +238,17 @@ void OlaClient::SetSourceUID(const ola::rdm::UID &uid,
   m_core->SetSourceUID(uid, callback);
 }
 
+void OlaClient::UseSharedMemory(SetCallback *callback) {
+  m_core->UseSharedMemory(callback);
+}
+
+void OlaClient::RDMBatch(const vector<RDMBatchCommand> &commands,
+                         unsigned int max_outstanding,
+                         RDMBatchResultCallback *result_callback,
+                         SetCallback *callback) {
+  m_core->RDMBatch(commands, max_outstanding, result_callback, callback);
+}
+
 void OlaClient::SendTimeCode(const ola::timecode::TimeCode &timecode,
                              SetCallback *callback) {
   m_core->SendTimeCode(timecode, callback);
@@ -24,6 +24,7 @@
 #include <sys/types.h>
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -39,6 +40,7 @@
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/rdm/RDMFrame.h"
+#include "ola/stl/STLUtils.h"
 
 namespace ola {
 namespace client {
@@ -50,6 +52,7 @@ using ola::rdm::UIDSet;
 using ola::rpc::RpcChannel;
 using ola::rpc::RpcController;
 using std::auto_ptr;
+using std::map;
 using std::string;
 using std::vector;
 
@@ -57,6 +60,12 @@ const char OlaClientCore::NOT_CONNECTED_ERROR[] = "Not connected";
 
 OlaClientCore::OlaClientCore(ConnectedDescriptor *descriptor)
     : m_descriptor(descriptor),
+      m_shared_memory_ready(false),
+      m_delta_updates(false),
+      m_max_update_rate(0),
+      m_min_update_change(0),
+      m_scheduler(NULL),
+      m_next_batch_id(0),
       m_connected(false) {
 }
 
@@ -65,6 +74,7 @@ OlaClientCore::~OlaClientCore() {
   if (m_connected) {
     Stop();
   }
+  STLDeleteValues(&m_rdm_batches);
 }
 
 
@@ -82,6 +92,7 @@ bool OlaClientCore::Setup() {
   if (!m_channel.get()) {
     return false;
   }
+  m_channel->SetWriteCoalescing(m_scheduler);
   m_stub.reset(new OlaServerService_Stub(m_channel.get()));
 
   if (!m_stub.get()) {
@@ -99,10 +110,14 @@ bool OlaClientCore::Setup() {
  */
 bool OlaClientCore::Stop() {
   if (m_connected) {
+    m_channel->Flush();
     m_descriptor->Close();
     m_channel.reset();
     m_stub.reset();
   }
+  m_shared_memory.reset();
+  m_shared_memory_ready = false;
+  m_received_frames.clear();
   m_connected = false;
   return 0;
 }
@@ -119,10 +134,27 @@ void OlaClientCore::SetCloseHandler(ClosedCallback *callback) {
   }
 }
 
+void OlaClientCore::SetPipelining(
+    ola::thread::SchedulerInterface *scheduler) {
+  m_scheduler = scheduler;
+  if (m_channel.get()) {
+    m_channel->SetWriteCoalescing(scheduler);
+  }
+}
+
 void OlaClientCore::SetDMXCallback(RepeatableDMXCallback *callback) {
   m_dmx_callback.reset(callback);
 }
 
+void OlaClientCore::SetSlotChangeCallback(
+    RepeatableSlotChangeCallback *callback) {
+  m_slot_change_callback.reset(callback);
+}
+
+void OlaClientCore::SetRDMPollCallback(RepeatableRDMPollCallback *callback) {
+  m_rdm_poll_callback.reset(callback);
+}
+
 void OlaClientCore::ReloadPlugins(SetCallback *callback) {
   ola::proto::PluginReloadRequest request;
   RpcController *controller = new RpcController();
@@ -411,6 +443,36 @@ void OlaClientCore::SetUniverseMergeMode(unsigned int universe,
   }
 }
 
+void OlaClientCore::SetUniverseLayers(unsigned int universe,
+                                      const vector<UniverseLayer> &layers,
+                                      SetCallback *callback) {
+  ola::proto::UniverseLayersRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  request.set_universe(universe);
+  vector<UniverseLayer>::const_iterator iter = layers.begin();
+  for (; iter != layers.end(); ++iter) {
+    ola::proto::UniverseLayer *layer = request.add_layer();
+    layer->set_universe(iter->universe);
+    layer->set_opacity(iter->opacity);
+    if (iter->mask.Size()) {
+      layer->set_mask(iter->mask.Get());
+    }
+  }
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleAck,
+        controller, reply, callback);
+    m_stub->SetUniverseLayers(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+  }
+}
+
 void OlaClientCore::Patch(unsigned int device_alias,
                           unsigned int port_id,
                           PortDirection port_direction,
@@ -441,6 +503,35 @@ void OlaClientCore::Patch(unsigned int device_alias,
   }
 }
 
+void OlaClientCore::PatchPorts(const vector<PortPatch> &patches,
+                               SetCallback *callback) {
+  ola::proto::PatchPortsRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  vector<PortPatch>::const_iterator iter = patches.begin();
+  for (; iter != patches.end(); ++iter) {
+    ola::proto::PatchPortRequest *port = request.add_port();
+    port->set_universe(iter->universe);
+    port->set_device_alias(iter->device_alias);
+    port->set_port_id(iter->port);
+    port->set_is_output(iter->port_direction == OUTPUT_PORT);
+    port->set_action(
+        iter->action == PATCH ? ola::proto::PATCH : ola::proto::UNPATCH);
+  }
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleAck,
+        controller, reply, callback);
+    m_stub->PatchPorts(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+  }
+}
+
 void OlaClientCore::RegisterUniverse(unsigned int universe,
                                      RegisterAction register_action,
                                      SetCallback *callback) {
@@ -453,6 +544,17 @@ void OlaClientCore::RegisterUniverse(unsigned int universe,
         ola::proto::UNREGISTER);
   request.set_universe(universe);
   request.set_action(action);
+  if (register_action == REGISTER) {
+    if (m_delta_updates) {
+      request.set_delta(true);
+    }
+    if (m_max_update_rate) {
+      request.set_max_rate(m_max_update_rate);
+    }
+    if (m_min_update_change) {
+      request.set_min_change(m_min_update_change);
+    }
+  }
 
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
@@ -466,6 +568,69 @@ void OlaClientCore::RegisterUniverse(unsigned int universe,
   }
 }
 
+void OlaClientCore::SubscribeSlots(unsigned int universe,
+                                   const vector<SlotRange> &ranges,
+                                   SetCallback *callback) {
+  ola::proto::SlotSubscriptionRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  request.set_universe(universe);
+  request.set_action(ranges.empty() ? ola::proto::UNREGISTER :
+                     ola::proto::REGISTER);
+  vector<SlotRange>::const_iterator iter = ranges.begin();
+  for (; iter != ranges.end(); ++iter) {
+    ola::proto::SlotRange *range = request.add_range();
+    range->set_start(iter->start);
+    range->set_count(iter->count);
+    range->set_threshold(iter->threshold);
+  }
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleAck,
+        controller, reply, callback);
+    m_stub->SubscribeSlots(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+  }
+}
+
+void OlaClientCore::SubscribeRDMPoll(unsigned int universe,
+                                     const UID &uid,
+                                     uint16_t sub_device,
+                                     uint16_t pid,
+                                     const string &data,
+                                     unsigned int period_ms,
+                                     SetCallback *callback) {
+  ola::proto::RDMPollRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  request.set_universe(universe);
+  request.mutable_uid()->set_esta_id(uid.ManufacturerId());
+  request.mutable_uid()->set_device_id(uid.DeviceId());
+  request.set_sub_device(sub_device);
+  request.set_param_id(pid);
+  request.set_data(data);
+  request.set_action(period_ms ? ola::proto::REGISTER :
+                     ola::proto::UNREGISTER);
+  request.set_period_ms(period_ms);
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleAck,
+        controller, reply, callback);
+    m_stub->SubscribeRDMPoll(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+  }
+}
+
 void OlaClientCore::SendDMX(unsigned int universe,
                             const DmxBuffer &data,
                             const SendDMXArgs &args) {
@@ -473,6 +638,12 @@ void OlaClientCore::SendDMX(unsigned int universe,
   request.set_universe(universe);
   request.set_data(data.Get());
   request.set_priority(args.priority);
+  if (args.slot_priorities && args.slot_priorities->Size()) {
+    request.set_slot_priorities(args.slot_priorities->Get());
+  }
+  if (args.fade_time) {
+    request.set_fade_time(args.fade_time);
+  }
 
   if (args.callback) {
     // Full request
@@ -490,11 +661,51 @@ void OlaClientCore::SendDMX(unsigned int universe,
       HandleGeneralAck(controller, reply, args.callback);
      }
   } else if (m_connected) {
-    // stream data
+    // stream data, through shared memory if we can.
+    if (m_shared_memory_ready && !args.fade_time &&
+        !request.has_slot_priorities() &&
+        m_shared_memory->Write(universe, args.priority, data)) {
+      return;
+    }
     m_stub->StreamDmxData(NULL, &request, NULL, NULL);
   }
 }
 
+void OlaClientCore::UseSharedMemory(SetCallback *callback) {
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  if (!m_connected) {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+    return;
+  }
+
+  if (m_shared_memory.get()) {
+    controller->SetFailed("Shared memory is already in use");
+    HandleAck(controller, reply, callback);
+    return;
+  }
+
+  m_shared_memory.reset(ola::dmx::SharedMemoryFrames::Create(
+      ola::dmx::SharedMemoryFrames::UniqueName()));
+  if (!m_shared_memory.get()) {
+    controller->SetFailed("Failed to create shared memory");
+    HandleAck(controller, reply, callback);
+    return;
+  }
+
+  ola::proto::SharedMemoryRequest request;
+  request.set_name(m_shared_memory->Name());
+  request.set_action(ola::proto::REGISTER);
+
+  CompletionCallback *cb = ola::NewSingleCallback(
+      this,
+      &OlaClientCore::HandleSharedMemoryAck,
+      controller, reply, callback);
+  m_stub->RegisterSharedMemory(controller, &request, reply, cb);
+}
+
 void OlaClientCore::FetchDMX(unsigned int universe,
                              DMXCallback *callback) {
   ola::proto::UniverseRequest request;
@@ -515,6 +726,53 @@ void OlaClientCore::FetchDMX(unsigned int universe,
   }
 }
 
+void OlaClientCore::FetchDMXMulti(const vector<unsigned int> &universes,
+                                  MultiDMXCallback *callback) {
+  ola::proto::MultiUniverseRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::DmxSnapshot *reply = new ola::proto::DmxSnapshot();
+
+  vector<unsigned int>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    request.add_universe(*iter);
+  }
+  request.set_packed(true);
+
+  if (m_connected) {
+    CompletionCallback *cb = NewSingleCallback(
+        this,
+        &OlaClientCore::HandleGetDmxMulti,
+        controller, reply, callback);
+    m_stub->GetDmxMulti(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleGetDmxMulti(controller, reply, callback);
+  }
+}
+
+void OlaClientCore::FetchUniverseStats(const vector<unsigned int> &universes,
+                                       UniverseStatsCallback *callback) {
+  ola::proto::MultiUniverseRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::UniverseStatsReply *reply = new ola::proto::UniverseStatsReply();
+
+  vector<unsigned int>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    request.add_universe(*iter);
+  }
+
+  if (m_connected) {
+    CompletionCallback *cb = NewSingleCallback(
+        this,
+        &OlaClientCore::HandleGetUniverseStats,
+        controller, reply, callback);
+    m_stub->GetUniverseStats(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleGetUniverseStats(controller, reply, callback);
+  }
+}
+
 void OlaClientCore::RunDiscovery(unsigned int universe,
                                  DiscoveryType discovery_type,
                                  DiscoveryCallback *callback) {
@@ -588,6 +846,44 @@ void OlaClientCore::RDMSet(unsigned int universe,
                  args);
 }
 
+void OlaClientCore::RDMBatch(const vector<RDMBatchCommand> &commands,
+                             unsigned int max_outstanding,
+                             RDMBatchResultCallback *result_callback,
+                             SetCallback *callback) {
+  RpcController *controller = new RpcController();
+  ola::proto::RDMBatchReply *reply = new ola::proto::RDMBatchReply();
+  const unsigned int batch_id = m_next_batch_id++;
+  STLReplaceAndDelete(&m_rdm_batches, batch_id, result_callback);
+
+  if (!m_connected) {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleRDMBatch(controller, reply, batch_id, callback);
+    return;
+  }
+
+  ola::proto::RDMBatchRequest request;
+  request.set_batch_id(batch_id);
+  request.set_max_outstanding(max_outstanding);
+  vector<RDMBatchCommand>::const_iterator iter = commands.begin();
+  for (; iter != commands.end(); ++iter) {
+    ola::proto::RDMRequest *rdm_request = request.add_request();
+    rdm_request->set_universe(iter->universe);
+    ola::proto::UID *pb_uid = rdm_request->mutable_uid();
+    pb_uid->set_esta_id(iter->uid.ManufacturerId());
+    pb_uid->set_device_id(iter->uid.DeviceId());
+    rdm_request->set_sub_device(iter->sub_device);
+    rdm_request->set_param_id(iter->pid);
+    rdm_request->set_is_set(iter->is_set);
+    rdm_request->set_data(iter->data);
+  }
+
+  CompletionCallback *cb = NewSingleCallback(
+      this,
+      &OlaClientCore::HandleRDMBatch,
+      controller, reply, batch_id, callback);
+  m_stub->RDMBatchCommand(controller, &request, reply, cb);
+}
+
 void OlaClientCore::SendTimeCode(const ola::timecode::TimeCode &timecode,
                                  SetCallback *callback) {
   if (!timecode.IsValid()) {
@@ -625,10 +921,32 @@ void OlaClientCore::UpdateDmxData(ola::rpc::RpcController*,
                                   const ola::proto::DmxData *request,
                                   ola::proto::Ack*,
                                   CompletionCallback *done) {
-  if (m_dmx_callback.get()) {
-    DmxBuffer buffer;
+  DmxBuffer buffer;
+  if (request->has_offset()) {
+    // A delta update, apply it to the last frame we received.
+    std::map<unsigned int, DmxBuffer>::iterator iter =
+        m_received_frames.find(request->universe());
+    if (iter == m_received_frames.end()) {
+      OLA_WARN << "Delta update for universe " << request->universe()
+               << " without a full frame";
+      done->Run();
+      return;
+    }
+    if (!request->data().empty()) {
+      iter->second.SetRange(
+          request->offset(),
+          reinterpret_cast<const uint8_t*>(request->data().data()),
+          request->data().size());
+    }
+    buffer = iter->second;
+  } else {
     buffer.Set(request->data());
+    if (m_delta_updates) {
+      m_received_frames[request->universe()] = buffer;
+    }
+  }
 
+  if (m_dmx_callback.get()) {
     uint8_t priority = 0;
     if (request->has_priority()) {
       priority = request->priority();
@@ -639,6 +957,74 @@ void OlaClientCore::UpdateDmxData(ola::rpc::RpcController*,
   done->Run();
 }
 
+void OlaClientCore::StreamRDMBatchResult(
+    ola::rpc::RpcController*,
+    const ola::proto::RDMBatchResult *request,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    CompletionCallback *done) {
+  RDMBatchResultCallback *callback = STLFindOrNull(m_rdm_batches,
+                                                   request->batch_id());
+  if (!callback) {
+    OLA_WARN << "Result for unknown RDM batch " << request->batch_id();
+  } else {
+    // BuildRDMResponse doesn't modify the response.
+    ola::proto::RDMResponse *proto_response =
+        const_cast<ola::proto::RDMResponse*>(&request->response());
+    RDMMetadata metadata;
+    auto_ptr<ola::rdm::RDMResponse> response(
+        BuildRDMResponse(proto_response, &metadata.response_code));
+    callback->Run(request->index(), metadata, response.get());
+  }
+  if (done) {
+    done->Run();
+  }
+}
+
+void OlaClientCore::UpdateSlots(
+    ola::rpc::RpcController*,
+    const ola::proto::SlotChanges *request,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    CompletionCallback *done) {
+  if (m_slot_change_callback.get()) {
+    const string &values = request->value();
+    const unsigned int count = std::min(
+        static_cast<unsigned int>(request->slot_size()),
+        static_cast<unsigned int>(values.size()));
+    vector<SlotChange> changes(count);
+    for (unsigned int i = 0; i < count; i++) {
+      changes[i].slot = request->slot(i);
+      changes[i].value = values[i];
+    }
+    m_slot_change_callback->Run(request->universe(), changes);
+  }
+  if (done) {
+    done->Run();
+  }
+}
+
+void OlaClientCore::UpdateRDMPoll(
+    ola::rpc::RpcController*,
+    const ola::proto::RDMPollUpdate *request,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    CompletionCallback *done) {
+  if (m_rdm_poll_callback.get()) {
+    RDMPollResult result;
+    result.universe = request->universe();
+    result.uid = UID(request->uid().esta_id(), request->uid().device_id());
+    result.sub_device = request->sub_device();
+    result.pid = request->param_id();
+    result.request_data = request->request_data();
+    result.response_code = static_cast<ola::rdm::RDMStatusCode>(
+        request->response_code());
+    result.response_type = request->response_type();
+    result.data = request->data();
+    m_rdm_poll_callback->Run(result);
+  }
+  if (done) {
+    done->Run();
+  }
+}
+
 void OlaClientCore::ChannelClosed(ClosedCallback *callback,
                                   OLA_UNUSED ola::rpc::RpcSession *session) {
   callback->Run();
@@ -792,6 +1178,17 @@ void OlaClientCore::HandleAck(RpcController *controller_ptr,
   callback->Run(result);
 }
 
+void OlaClientCore::HandleSharedMemoryAck(RpcController *controller,
+                                          ola::proto::Ack *reply,
+                                          SetCallback *callback) {
+  if (controller->Failed()) {
+    m_shared_memory.reset();
+  } else if (m_shared_memory.get()) {
+    m_shared_memory_ready = true;
+  }
+  HandleAck(controller, reply, callback);
+}
+
 void OlaClientCore::HandleGeneralAck(RpcController *controller_ptr,
                                      ola::proto::Ack *reply_ptr,
                                      GeneralSetCallback *callback) {
@@ -886,6 +1283,79 @@ void OlaClientCore::HandleGetDmx(RpcController *controller_ptr,
   callback->Run(result, metadata, buffer);
 }
 
+void OlaClientCore::HandleGetDmxMulti(RpcController *controller_ptr,
+                                      ola::proto::DmxSnapshot *reply_ptr,
+                                      MultiDMXCallback *callback) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::DmxSnapshot> reply(reply_ptr);
+
+  if (!callback) {
+    return;
+  }
+
+  Result result(controller->Failed() ? controller->ErrorText() : "");
+  map<unsigned int, DmxBuffer> data;
+
+  if (!controller->Failed()) {
+    // Older servers may ignore the packed flag, so handle both forms.
+    for (int i = 0; i < reply->universe_data_size(); i++) {
+      const ola::proto::DmxData &dmx = reply->universe_data(i);
+      data[dmx.universe()].Set(dmx.data());
+    }
+
+    const string &packed_data = reply->packed_data();
+    const uint8_t *ptr = reinterpret_cast<const uint8_t*>(packed_data.data());
+    unsigned int offset = 0;
+    for (int i = 0; i < reply->universe_size() && i < reply->size_size();
+         i++) {
+      unsigned int size = reply->size(i);
+      if (offset + size > packed_data.size()) {
+        OLA_WARN << "Truncated packed DMX data, universe "
+                 << reply->universe(i);
+        break;
+      }
+      data[reply->universe(i)].Set(ptr + offset, size);
+      offset += size;
+    }
+  }
+  callback->Run(result, data);
+}
+
+void OlaClientCore::HandleGetUniverseStats(
+    RpcController *controller_ptr,
+    ola::proto::UniverseStatsReply *reply_ptr,
+    UniverseStatsCallback *callback) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::UniverseStatsReply> reply(reply_ptr);
+
+  if (!callback) {
+    return;
+  }
+
+  Result result(controller->Failed() ? controller->ErrorText() : "");
+  vector<UniverseStats> stats;
+
+  if (!controller->Failed()) {
+    stats.reserve(reply->universe_size());
+    for (int i = 0; i < reply->universe_size(); i++) {
+      const ola::proto::UniverseStats &universe_stats = reply->universe(i);
+      UniverseStats entry;
+      entry.universe = universe_stats.universe();
+      entry.frames = universe_stats.frames();
+      entry.merges = universe_stats.merges();
+      entry.input_ports = universe_stats.input_ports();
+      entry.source_clients = universe_stats.source_clients();
+      entry.active_sources = universe_stats.active_sources();
+      entry.latency_samples = universe_stats.latency_samples();
+      entry.latency_p50 = universe_stats.latency_p50();
+      entry.latency_p99 = universe_stats.latency_p99();
+      entry.latency_p999 = universe_stats.latency_p999();
+      stats.push_back(entry);
+    }
+  }
+  callback->Run(result, stats);
+}
+
 void OlaClientCore::HandleUIDList(RpcController *controller_ptr,
                                   ola::proto::UIDListReply *reply_ptr,
                                   DiscoveryCallback *callback) {
@@ -942,6 +1412,20 @@ void OlaClientCore::HandleRDM(RpcController *controller_ptr,
   callback->Run(result, metadata, response);
 }
 
+void OlaClientCore::HandleRDMBatch(RpcController *controller_ptr,
+                                   ola::proto::RDMBatchReply *reply_ptr,
+                                   unsigned int batch_id,
+                                   SetCallback *callback) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::RDMBatchReply> reply(reply_ptr);
+  STLRemoveAndDelete(&m_rdm_batches, batch_id);
+
+  if (callback) {
+    Result result(controller->Failed() ? controller->ErrorText() : "");
+    callback->Run(result);
+  }
+}
+
 void OlaClientCore::GenericFetchCandidatePorts(
     unsigned int universe_id,
     bool include_universe,
@@ -21,8 +21,10 @@
 #ifndef OLA_OLACLIENTCORE_H_
 #define OLA_OLACLIENTCORE_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
@@ -34,11 +36,13 @@
 #include "ola/client/ClientArgs.h"
 #include "ola/client/ClientTypes.h"
 #include "ola/base/Macro.h"
+#include "ola/dmx/SharedMemoryFrames.h"
 #include "ola/dmx/SourcePriorities.h"
 #include "ola/io/Descriptor.h"
 #include "ola/plugin_id.h"
 #include "ola/rdm/UID.h"
 #include "ola/rdm/UIDSet.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "ola/timecode/TimeCode.h"
 
 namespace ola {
@@ -65,6 +69,14 @@ class OlaClientCore: public ola::proto::OlaClientService {
 
   void SetCloseHandler(ClosedCallback *callback);
 
+  /**
+   * @brief Coalesce the RPCs sent in the same loop iteration into a single
+   *   write.
+   * @param scheduler the scheduler used to send the RPCs, usually the
+   *   SelectServer the client is registered with. NULL disables pipelining.
+   */
+  void SetPipelining(ola::thread::SchedulerInterface *scheduler);
+
   /**
    * @brief Set the callback to be run when new DMX data arrives.
    * The DMX callback will be run when new data arrives for universes that
@@ -74,6 +86,21 @@ class OlaClientCore: public ola::proto::OlaClientService {
    */
   void SetDMXCallback(RepeatableDMXCallback *callback);
 
+  /**
+   * @brief Set the callback to be run when subscribed slots change.
+   * @param callback the callback to run, ownership is transferred.
+   * @sa SubscribeSlots()
+   */
+  void SetSlotChangeCallback(RepeatableSlotChangeCallback *callback);
+
+  /**
+   * @brief Set the callback to be run when the response to a polled GET
+   *   changes.
+   * @param callback the callback to run, ownership is transferred.
+   * @sa SubscribeRDMPoll()
+   */
+  void SetRDMPollCallback(RepeatableRDMPollCallback *callback);
+
   /**
    * @brief Trigger a plugin reload.
    * @param callback the SetCallback to invoke upon completion.
@@ -209,6 +236,18 @@ class OlaClientCore: public ola::proto::OlaClientService {
                             OlaUniverse::merge_mode mode,
                             SetCallback *callback);
 
+  /**
+   * @brief Set the layers of a virtual universe.
+   * @param universe the id of the virtual universe, this is created if it
+   *   doesn't exist.
+   * @param layers the layers, in the order they are blended. An empty list
+   *   removes the layers.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SetUniverseLayers(unsigned int universe,
+                         const std::vector<UniverseLayer> &layers,
+                         SetCallback *callback);
+
   /**
    * @brief Patch or unpatch a port from a universe.
    * @param device_alias the device containing the port to change
@@ -225,6 +264,36 @@ class OlaClientCore: public ola::proto::OlaClientService {
              unsigned int universe,
              SetCallback *callback);
 
+  /**
+   * @brief Patch or unpatch a set of ports in one request.
+   * @param patches the desired patching of each port.
+   * @param callback the SetCallback to invoke upon completion.
+   *
+   * Ports that are already patched as requested are left alone. If any of
+   * the ports can't be found or patched, none of the changes are applied.
+   */
+  void PatchPorts(const std::vector<PortPatch> &patches,
+                  SetCallback *callback);
+
+  /**
+   * @brief Ask for delta encoded updates for universes registered with
+   *   RegisterUniverse().
+   * @param enable true to request delta updates.
+   */
+  void SetDeltaUpdates(bool enable) { m_delta_updates = enable; }
+
+  /**
+   * @brief Ask olad to limit the updates for universes registered with
+   *   RegisterUniverse().
+   * @param max_rate the maximum updates per second, 0 means no limit.
+   * @param min_change the smallest change in a slot value worth sending, 0
+   *   sends every frame.
+   */
+  void SetUpdateRateLimit(unsigned int max_rate, unsigned int min_change) {
+    m_max_update_rate = max_rate;
+    m_min_update_change = min_change;
+  }
+
   /**
    * @brief Register our interest in a universe. The callback set by
    * SetDMXCallback() will be called when new DMX data arrives.
@@ -236,6 +305,44 @@ class OlaClientCore: public ola::proto::OlaClientService {
                         RegisterAction register_action,
                         SetCallback *callback);
 
+  /**
+   * @brief Watch some slots of a universe.
+   *
+   * Rather than sending full frames, olad compares each new frame with the
+   * last and sends just the slots which changed to the callback set by
+   * SetSlotChangeCallback(). The current values are sent first.
+   * @param universe the id of the universe to watch.
+   * @param ranges the slots to watch. This replaces any earlier ranges for
+   *   the universe, an empty list stops watching the universe.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SubscribeSlots(unsigned int universe,
+                      const std::vector<SlotRange> &ranges,
+                      SetCallback *callback);
+
+  /**
+   * @brief Ask olad to poll an RDM GET, e.g. SENSOR_VALUE.
+   *
+   * olad polls each GET once for all the clients that subscribe to it, at
+   * the shortest period any of them asked for. The response is sent to the
+   * callback set by SetRDMPollCallback() when it changes. If olad already
+   * has a response, that's sent first.
+   * @param universe the universe the device is on.
+   * @param uid the UID of the device.
+   * @param sub_device the sub device.
+   * @param pid the PID to GET.
+   * @param data the param data of the GET.
+   * @param period_ms how often to poll, 0 stops polling for this client.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SubscribeRDMPoll(unsigned int universe,
+                        const ola::rdm::UID &uid,
+                        uint16_t sub_device,
+                        uint16_t pid,
+                        const std::string &data,
+                        unsigned int period_ms,
+                        SetCallback *callback);
+
   /**
    * @brief Send DMX data.
    * @param universe the universe to send to.
@@ -246,6 +353,17 @@ class OlaClientCore: public ola::proto::OlaClientService {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Send streaming DMX data through shared memory.
+   * @param callback the SetCallback to invoke once olad has accepted, or
+   *   rejected, the shared memory segment.
+   *
+   * Once olad accepts the segment, SendDMX() calls without a callback, fade
+   * time or slot priorities write to shared memory rather than sending an
+   * RPC. olad must be run with --shared-memory-poll-ms.
+   */
+  void UseSharedMemory(SetCallback *callback);
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
@@ -253,6 +371,27 @@ class OlaClientCore: public ola::proto::OlaClientService {
    */
   void FetchDMX(unsigned int universe, DMXCallback *callback);
 
+  /**
+   * @brief Fetch the latest DMX data for many universes in a single call.
+   * @param universes the universe ids to get data for. If empty, the data
+   *   for all universes is returned.
+   * @param callback the MultiDMXCallback to invoke upon completion.
+   */
+  void FetchDMXMulti(const std::vector<unsigned int> &universes,
+                     MultiDMXCallback *callback);
+
+  /**
+   * @brief Fetch the counters for many universes in a single call.
+   * @param universes the universe ids to get the stats for. If empty, the
+   *   stats for all universes are returned.
+   * @param callback the UniverseStatsCallback to invoke upon completion.
+   *
+   * Unlike registering for DMX, this doesn't send any DMX data, so it's
+   * cheap enough to poll.
+   */
+  void FetchUniverseStats(const std::vector<unsigned int> &universes,
+                          UniverseStatsCallback *callback);
+
   /**
    * @brief Trigger discovery for a universe.
    * @param universe the universe id to run discovery on.
@@ -306,6 +445,25 @@ class OlaClientCore: public ola::proto::OlaClientService {
               unsigned int data_length,
               const SendRDMArgs& args);
 
+  /**
+   * @brief Send a batch of RDM commands.
+   * @param commands the commands to send.
+   * @param max_outstanding the maximum number of commands the server will
+   *   have in flight at once.
+   * @param result_callback run as the result of each command arrives.
+   *   Ownership is transferred and the callback is deleted once the batch
+   *   completes.
+   * @param callback the SetCallback to invoke once all the results have been
+   *   received.
+   *
+   * Results are returned in the order the commands complete, which may not
+   * be the order they were given in.
+   */
+  void RDMBatch(const std::vector<RDMBatchCommand> &commands,
+                unsigned int max_outstanding,
+                RDMBatchResultCallback *result_callback,
+                SetCallback *callback);
+
   /**
    * @brief Send TimeCode data.
    * @param timecode The timecode data.
@@ -322,15 +480,64 @@ class OlaClientCore: public ola::proto::OlaClientService {
                      ola::proto::Ack* response,
                      CompletionCallback* done);
 
+  /**
+   * @brief This is called by the channel when the result of a batched RDM
+   * command arrives.
+   */
+  void StreamRDMBatchResult(ola::rpc::RpcController* controller,
+                            const ola::proto::RDMBatchResult* request,
+                            ola::proto::STREAMING_NO_RESPONSE* response,
+                            CompletionCallback* done);
+
+  /**
+   * @brief This is called by the channel when subscribed slots change.
+   */
+  void UpdateSlots(ola::rpc::RpcController* controller,
+                   const ola::proto::SlotChanges* request,
+                   ola::proto::STREAMING_NO_RESPONSE* response,
+                   CompletionCallback* done);
+
+  /**
+   * @brief This is called by the channel when the response to a polled GET
+   * changes.
+   */
+  void UpdateRDMPoll(ola::rpc::RpcController* controller,
+                     const ola::proto::RDMPollUpdate* request,
+                     ola::proto::STREAMING_NO_RESPONSE* response,
+                     CompletionCallback* done);
+
  private:
+  typedef std::map<unsigned int, RDMBatchResultCallback*> RDMBatchMap;
+
   ola::io::ConnectedDescriptor *m_descriptor;
   std::auto_ptr<RepeatableDMXCallback> m_dmx_callback;
+  std::auto_ptr<RepeatableSlotChangeCallback> m_slot_change_callback;
+  std::auto_ptr<RepeatableRDMPollCallback> m_rdm_poll_callback;
   std::auto_ptr<ola::rpc::RpcChannel> m_channel;
   std::auto_ptr<ola::proto::OlaServerService_Stub> m_stub;
+  std::auto_ptr<ola::dmx::SharedMemoryFrames> m_shared_memory;
+  bool m_shared_memory_ready;
+  bool m_delta_updates;
+  unsigned int m_max_update_rate;
+  unsigned int m_min_update_change;
+  ola::thread::SchedulerInterface *m_scheduler;
+  // The last frame received for each universe, delta updates are applied to
+  // these.
+  std::map<unsigned int, DmxBuffer> m_received_frames;
+  // The result callbacks for the RDM batches in progress, by batch id.
+  RDMBatchMap m_rdm_batches;
+  unsigned int m_next_batch_id;
   int m_connected;
 
   void ChannelClosed(ClosedCallback *callback, ola::rpc::RpcSession *session);
 
+  /**
+   * @brief Called when UseSharedMemory() completes.
+   */
+  void HandleSharedMemoryAck(ola::rpc::RpcController *controller,
+                             ola::proto::Ack *reply,
+                             SetCallback *callback);
+
   /**
    * @brief Called when GetPlugins() completes.
    */
@@ -401,6 +608,20 @@ class OlaClientCore: public ola::proto::OlaClientService {
                     ola::proto::DmxData *reply,
                     DMXCallback *callback);
 
+  /**
+   * @brief Called when a GetDmxMulti() request completes.
+   */
+  void HandleGetDmxMulti(ola::rpc::RpcController *controller,
+                         ola::proto::DmxSnapshot *reply,
+                         MultiDMXCallback *callback);
+
+  /**
+   * @brief Called when a GetUniverseStats() request completes.
+   */
+  void HandleGetUniverseStats(ola::rpc::RpcController *controller,
+                              ola::proto::UniverseStatsReply *reply,
+                              UniverseStatsCallback *callback);
+
   /**
    * @brief Called when a RunDiscovery() request completes.
    */
@@ -415,6 +636,14 @@ class OlaClientCore: public ola::proto::OlaClientService {
                  ola::proto::RDMResponse *reply,
                  RDMCallback *callback);
 
+  /**
+   * @brief Called when a RDMBatch() request completes.
+   */
+  void HandleRDMBatch(ola::rpc::RpcController *controller,
+                      ola::proto::RDMBatchReply *reply,
+                      unsigned int batch_id,
+                      SetCallback *callback);
+
   /**
    * @brief Fetch a list of candidate ports, with or without a universe
    */
@@ -18,6 +18,17 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <string.h>
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#endif  // _WIN32
+
 #include <ola/AutoStart.h>  // NOLINT(build/include)
 // ola/StreamingClient.h deprecated
 #include <ola/Callback.h>
@@ -25,42 +36,75 @@
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/client/StreamingClient.h>
+#include <ola/dmx/PixelMap.h>
+#include <ola/dmx/SharedMemoryFrames.h>
 #include <ola/io/SelectServer.h>
 #include <ola/network/IPV4Address.h>
 #include <ola/network/SocketAddress.h>
 #include <ola/network/TCPSocket.h>
+#include <ola/network/UnixDomainSocket.h>
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
 #include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcController.h"
 #include "common/rpc/RpcSession.h"
+#include "ola/DmxDataEncoder.h"
 
 namespace ola {
 namespace client {
 
+using ola::dmx::PixelMap;
+using ola::dmx::SharedMemoryFrames;
 using ola::io::SelectServer;
 using ola::network::TCPSocket;
+using ola::network::UnixDomainSocket;
 using ola::proto::OlaServerService_Stub;
 using ola::rpc::RpcChannel;
+using ola::rpc::RpcController;
+using std::map;
 
 StreamingClient::StreamingClient(bool auto_start)
     : m_auto_start(auto_start),
       m_server_port(OLA_DEFAULT_PORT),
+      m_use_shared_memory(false),
       m_socket(NULL),
       m_ss(NULL),
       m_channel(NULL),
       m_stub(NULL),
-      m_socket_closed(false) {
+      m_socket_closed(false),
+      m_shared_memory(NULL),
+      m_shared_memory_state(SHARED_MEMORY_DISABLED),
+      m_batch(NULL),
+      m_non_blocking(false),
+      m_sequence(0),
+      m_frame(NULL),
+      m_outstanding_replies(0) {
 }
 
 StreamingClient::StreamingClient(const Options &options)
     : m_auto_start(options.auto_start),
       m_server_port(options.server_port),
+      m_use_shared_memory(options.use_shared_memory),
+      m_socket_path(options.socket_path),
       m_socket(NULL),
       m_ss(NULL),
       m_channel(NULL),
       m_stub(NULL),
-      m_socket_closed(false) {
+      m_socket_closed(false),
+      m_shared_memory(NULL),
+      m_shared_memory_state(SHARED_MEMORY_DISABLED),
+      m_batch(NULL),
+      m_non_blocking(options.non_blocking),
+      m_sequence(0),
+      m_frame(NULL),
+      m_outstanding_replies(0) {
+#ifndef MSG_DONTWAIT
+  if (m_non_blocking) {
+    OLA_WARN << "Non-blocking sends aren't supported on this platform";
+    m_non_blocking = false;
+  }
+#endif  // MSG_DONTWAIT
 }
 
 StreamingClient::~StreamingClient() {
@@ -71,7 +115,9 @@ bool StreamingClient::Setup() {
   if (m_socket || m_channel || m_stub)
     return false;
 
-  if (m_auto_start)
+  if (!m_socket_path.empty())
+    m_socket = UnixDomainSocket::Connect(m_socket_path);
+  else if (m_auto_start)
     m_socket = ola::client::ConnectToServer(m_server_port);
   else
     m_socket = TCPSocket::Connect(
@@ -93,6 +139,7 @@ bool StreamingClient::Setup() {
   }
 
   m_stub = new OlaServerService_Stub(m_channel);
+  m_batch = new ola::proto::DmxDataBatch();
 
   if (!m_stub) {
     delete m_channel;
@@ -105,6 +152,14 @@ bool StreamingClient::Setup() {
   m_channel->SetChannelCloseHandler(
       NewSingleCallback(this, &StreamingClient::ChannelClosed));
 
+  if (m_non_blocking) {
+    m_frame = new uint8_t[DmxDataEncoder::MAX_SIZE];
+    m_clock.CurrentTime(&m_last_check);
+  }
+
+  if (m_use_shared_memory) {
+    RegisterSharedMemory();
+  }
   return true;
 }
 
@@ -121,10 +176,26 @@ void StreamingClient::Stop() {
   if (m_socket)
     delete m_socket;
 
+  if (m_shared_memory)
+    delete m_shared_memory;
+
+  if (m_batch)
+    delete m_batch;
+
+  delete[] m_frame;
+
   m_channel = NULL;
   m_socket = NULL;
   m_ss = NULL;
   m_stub = NULL;
+  m_shared_memory = NULL;
+  m_shared_memory_state = SHARED_MEMORY_DISABLED;
+  m_batch = NULL;
+  m_batch_frames.clear();
+  m_frame = NULL;
+  m_partial_frame.clear();
+  m_pending_frames.clear();
+  m_outstanding_replies = 0;
 }
 
 bool StreamingClient::SendDmx(unsigned int universe,
@@ -138,21 +209,92 @@ bool StreamingClient::SendDMX(unsigned int universe,
   return Send(universe, args.priority, data);
 }
 
-bool StreamingClient::Send(unsigned int universe, uint8_t priority,
-                           const DmxBuffer &data) {
+bool StreamingClient::BufferDMX(unsigned int universe,
+                                const DmxBuffer &data,
+                                const SendArgs &args) {
   if (!m_stub || !m_socket->ValidReadDescriptor())
     return false;
 
-  // We select() on the fd here to see if the remove end has closed the
-  // connection. We could skip this and rely on the EPIPE delivered by the
-  // write() below, but that introduces a race condition in the unittests.
-  m_socket_closed = false;
-  m_ss->RunOnce();
+  if (m_shared_memory_state == SHARED_MEMORY_READY &&
+      m_shared_memory->Write(universe, args.priority, data)) {
+    // The next update sent over RPC must be the full frame.
+    m_batch_frames.erase(universe);
+    m_pending_frames.erase(universe);
+    return true;
+  }
+
+  ola::proto::DmxUpdate *update = m_batch->add_update();
+  update->set_universe(universe);
+  update->set_priority(args.priority);
+
+  std::map<unsigned int, DmxBuffer>::iterator iter =
+      m_batch_frames.find(universe);
+  if (iter != m_batch_frames.end() && iter->second.Size() == data.Size()) {
+    const uint8_t *last = iter->second.GetRaw();
+    const uint8_t *current = data.GetRaw();
+    unsigned int start = 0;
+    unsigned int end = data.Size();
+    while (start < end && last[start] == current[start]) {
+      start++;
+    }
+    while (end > start && last[end - 1] == current[end - 1]) {
+      end--;
+    }
+    // An empty range still refreshes the source in olad.
+    update->set_offset(start);
+    update->set_data(current + start, end - start);
+    iter->second.SetRange(start, current + start, end - start);
+  } else {
+    update->set_data(data.Get());
+    m_batch_frames[universe] = data;
+  }
+
+  if (static_cast<unsigned int>(m_batch->update_size()) >= MAX_BATCH_SIZE) {
+    return Flush();
+  }
+  return true;
+}
+
+bool StreamingClient::Flush() {
+  if (!m_stub || !m_socket->ValidReadDescriptor())
+    return false;
+
+  if (!CheckConnection() || !FlushPendingFrames()) {
+    return false;
+  }
+
+  if (m_batch->update_size() == 0) {
+    return true;
+  }
+
+  m_stub->StreamDmxDataBatch(NULL, m_batch, NULL, NULL);
+  m_batch->Clear();
 
   if (m_socket_closed) {
     Stop();
     return false;
   }
+  return true;
+}
+
+bool StreamingClient::Send(unsigned int universe, uint8_t priority,
+                           const DmxBuffer &data) {
+  if (!m_stub || !m_socket->ValidReadDescriptor())
+    return false;
+
+  if (!CheckConnection()) {
+    return false;
+  }
+
+  if (m_shared_memory_state == SHARED_MEMORY_READY &&
+      m_shared_memory->Write(universe, priority, data)) {
+    m_pending_frames.erase(universe);
+    return true;
+  }
+
+  if (m_non_blocking) {
+    return SendNonBlocking(universe, priority, data);
+  }
 
   ola::proto::DmxData request;
   request.set_universe(universe);
@@ -167,6 +309,306 @@ bool StreamingClient::Send(unsigned int universe, uint8_t priority,
   return true;
 }
 
+bool StreamingClient::SetPixelLayout(unsigned int layout,
+                                     const PixelMap &map) {
+  if (!m_stub || !m_socket->ValidReadDescriptor())
+    return false;
+
+  if (!CheckConnection() || !FlushPendingFrames()) {
+    return false;
+  }
+
+  ola::proto::PixelLayout request;
+  request.set_layout(layout);
+  request.set_width(map.Width());
+  request.set_height(map.Height());
+  request.set_gamma(map.Gamma());
+  request.set_brightness(map.Brightness());
+  std::vector<PixelMap::Run>::const_iterator iter = map.Runs().begin();
+  for (; iter != map.Runs().end(); ++iter) {
+    ola::proto::PixelRun *run = request.add_run();
+    run->set_universe(iter->universe);
+    run->set_start_slot(iter->start_slot);
+    run->set_x(iter->x);
+    run->set_y(iter->y);
+    run->set_x_step(iter->x_step);
+    run->set_y_step(iter->y_step);
+    run->set_count(iter->count);
+    run->set_color_order(iter->order);
+  }
+
+  // The reply is picked up by the RunOnce() call in the next send.
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+  m_outstanding_replies++;
+  m_stub->SetPixelLayout(
+      controller, &request, reply,
+      NewSingleCallback(this, &StreamingClient::PixelLayoutSet, layout,
+                        controller, reply));
+
+  if (m_socket_closed) {
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+bool StreamingClient::SendPixelFrame(unsigned int layout,
+                                     const uint8_t *frame,
+                                     unsigned int length,
+                                     const SendArgs &args) {
+  if (!m_stub || !m_socket->ValidReadDescriptor())
+    return false;
+
+  if (!CheckConnection() || !FlushPendingFrames()) {
+    return false;
+  }
+
+  ola::proto::PixelFrame request;
+  request.set_layout(layout);
+  request.set_data(frame, length);
+  request.set_priority(args.priority);
+  m_stub->StreamPixelFrame(NULL, &request, NULL, NULL);
+
+  if (m_socket_closed) {
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * We select() on the fd here to see if the remove end has closed the
+ * connection. We could skip this and rely on the EPIPE delivered by the
+ * write(), but that introduces a race condition in the unittests.
+ *
+ * In non-blocking mode we do rely on the write errors, and only select() if
+ * we're waiting for a reply, or every CONNECTION_CHECK_INTERVAL_MS.
+ */
+bool StreamingClient::CheckConnection() {
+  if (m_non_blocking && !m_outstanding_replies) {
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    if (now - m_last_check <
+        TimeInterval(0, CONNECTION_CHECK_INTERVAL_MS * 1000)) {
+      return true;
+    }
+    m_last_check = now;
+  }
+
+  m_socket_closed = false;
+  m_ss->RunOnce();
+
+  if (m_socket_closed) {
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Send a frame without blocking. Frames which don't fit in the socket are
+ * held, and only the latest frame for each universe is kept.
+ */
+bool StreamingClient::SendNonBlocking(unsigned int universe, uint8_t priority,
+                                      const DmxBuffer &data) {
+  WriteResult result = SendPendingFrames(false);
+  if (result == WRITE_OK) {
+    result = SendFrame(universe, priority, data, false);
+  }
+
+  if (result == WRITE_FAILED) {
+    Stop();
+    return false;
+  }
+  if (result == WRITE_BLOCKED) {
+    PendingFrame &frame = m_pending_frames[universe];
+    frame.priority = priority;
+    frame.data = data;
+  }
+  return true;
+}
+
+StreamingClient::WriteResult StreamingClient::SendFrame(
+    unsigned int universe, uint8_t priority, const DmxBuffer &data,
+    bool block) {
+  unsigned int size = DmxDataEncoder::Encode(m_sequence++, universe, priority,
+                                             data, m_frame);
+  return Write(m_frame, size, block);
+}
+
+/*
+ * Send the rest of a partly sent frame, and then the held frames.
+ */
+StreamingClient::WriteResult StreamingClient::SendPendingFrames(bool block) {
+  if (!m_partial_frame.empty()) {
+    // Write() puts anything it can't send back into m_partial_frame.
+    std::string partial_frame;
+    partial_frame.swap(m_partial_frame);
+    WriteResult result = Write(
+        reinterpret_cast<const uint8_t*>(partial_frame.data()),
+        partial_frame.size(), block);
+    if (result == WRITE_BLOCKED) {
+      m_partial_frame.swap(partial_frame);
+    }
+    if (result != WRITE_OK) {
+      return result;
+    }
+    if (!m_partial_frame.empty()) {
+      return WRITE_BLOCKED;
+    }
+  }
+
+  while (!m_pending_frames.empty()) {
+    map<unsigned int, PendingFrame>::iterator iter = m_pending_frames.begin();
+    WriteResult result = SendFrame(iter->first, iter->second.priority,
+                                   iter->second.data, block);
+    if (result != WRITE_OK) {
+      return result;
+    }
+    m_pending_frames.erase(iter);
+    if (!m_partial_frame.empty()) {
+      return WRITE_BLOCKED;
+    }
+  }
+  return WRITE_OK;
+}
+
+/*
+ * Write data to the socket. If not blocking and only part of the data is
+ * sent, the rest is saved in m_partial_frame and WRITE_OK is returned, since
+ * the frame can't be replaced by a newer one once it's been started.
+ */
+StreamingClient::WriteResult StreamingClient::Write(const uint8_t *data,
+                                                    unsigned int size,
+                                                    bool block) {
+  int flags = 0;
+#if HAVE_DECL_MSG_NOSIGNAL
+  flags |= MSG_NOSIGNAL;
+#endif  // HAVE_DECL_MSG_NOSIGNAL
+#ifdef MSG_DONTWAIT
+  flags |= MSG_DONTWAIT;
+#endif  // MSG_DONTWAIT
+
+  const int fd = ola::io::ToFD(m_socket->WriteDescriptor());
+  const uint8_t *ptr = data;
+  unsigned int remaining = size;
+  while (remaining) {
+    ssize_t sent = send(fd, reinterpret_cast<const char*>(ptr), remaining,
+                        flags);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        OLA_WARN << "Failed to send DMX data: " << strerror(errno);
+        return WRITE_FAILED;
+      } else if (!block) {
+        break;
+      } else if (!WaitForWritable(fd)) {
+        return WRITE_FAILED;
+      }
+      continue;
+    }
+    ptr += sent;
+    remaining -= sent;
+    if (!block) {
+      break;
+    }
+  }
+
+  if (remaining == size) {
+    return WRITE_BLOCKED;
+  } else if (remaining) {
+    m_partial_frame.assign(reinterpret_cast<const char*>(ptr), remaining);
+  }
+  return WRITE_OK;
+}
+
+bool StreamingClient::WaitForWritable(int fd) {
+  struct pollfd poll_fd;
+  poll_fd.fd = fd;
+  poll_fd.events = POLLOUT;
+  poll_fd.revents = 0;
+  int ready = poll(&poll_fd, 1, WRITE_TIMEOUT_MS);
+  if (ready < 0 && errno == EINTR) {
+    return true;
+  } else if (ready <= 0) {
+    OLA_WARN << "Timed out waiting to send DMX data";
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Send the held frames, blocking if required. This is called before
+ * anything is sent on the RPC channel, so the messages don't get mixed up.
+ */
+bool StreamingClient::FlushPendingFrames() {
+  if (!m_non_blocking) {
+    return true;
+  }
+  if (SendPendingFrames(true) != WRITE_OK) {
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Create a shared memory segment and ask olad to read from it. Until olad
+ * replies, data is sent over the RPC connection. The reply is picked up by
+ * the RunOnce() call in Send().
+ */
+void StreamingClient::RegisterSharedMemory() {
+  m_shared_memory = SharedMemoryFrames::Create(
+      SharedMemoryFrames::UniqueName());
+  if (!m_shared_memory) {
+    OLA_WARN << "Failed to create shared memory, falling back to RPCs";
+    return;
+  }
+
+  ola::proto::SharedMemoryRequest request;
+  request.set_name(m_shared_memory->Name());
+  request.set_action(ola::proto::REGISTER);
+
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+  m_shared_memory_state = SHARED_MEMORY_PENDING;
+  m_outstanding_replies++;
+  m_stub->RegisterSharedMemory(
+      controller, &request, reply,
+      NewSingleCallback(this, &StreamingClient::SharedMemoryRegistered,
+                        controller, reply));
+}
+
+void StreamingClient::SharedMemoryRegistered(RpcController *controller,
+                                             ola::proto::Ack *reply) {
+  m_outstanding_replies--;
+  if (controller->Failed()) {
+    OLA_WARN << "olad rejected the shared memory segment: "
+             << controller->ErrorText() << ", falling back to RPCs";
+    delete m_shared_memory;
+    m_shared_memory = NULL;
+    m_shared_memory_state = SHARED_MEMORY_DISABLED;
+  } else if (m_shared_memory_state == SHARED_MEMORY_PENDING) {
+    m_shared_memory_state = SHARED_MEMORY_READY;
+  }
+  delete controller;
+  delete reply;
+}
+
+void StreamingClient::PixelLayoutSet(unsigned int layout,
+                                     RpcController *controller,
+                                     ola::proto::Ack *reply) {
+  m_outstanding_replies--;
+  if (controller->Failed()) {
+    OLA_WARN << "olad rejected pixel layout " << layout << ": "
+             << controller->ErrorText();
+  }
+  delete controller;
+  delete reply;
+}
+
 void StreamingClient::ChannelClosed(OLA_UNUSED ola::rpc::RpcSession *session) {
   m_socket_closed = true;
   OLA_WARN << "The RPC socket has been closed, this is more than likely due"
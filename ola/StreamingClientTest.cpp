@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
 #include <string>
 #include <memory>
 
@@ -45,12 +46,16 @@ using std::auto_ptr;
 class StreamingClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(StreamingClientTest);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testBufferDMX);
+  CPPUNIT_TEST(testNonBlocking);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void setUp();
     void tearDown();
     void testSendDMX();
+    void testBufferDMX();
+    void testNonBlocking();
 
  private:
     class OlaServerThread *m_server_thread;
@@ -221,3 +226,88 @@ void StreamingClientTest::testSendDMX() {
 
   OLA_ASSERT_FALSE(ola_client.Setup());
 }
+
+
+/*
+ * Check that buffered DMX data is flushed correctly.
+ */
+void StreamingClientTest::testBufferDMX() {
+  m_server_thread->WaitForStart();
+  GenericSocketAddress server_address = m_server_thread->RPCAddress();
+  StreamingClient::Options options;
+  options.auto_start = false;
+  options.server_port = server_address.V4Addr().Port();
+  StreamingClient ola_client(options);
+
+  ola::DmxBuffer buffer;
+  buffer.Blackout();
+  StreamingClient::SendArgs args;
+
+  // Nothing can be buffered until we're connected.
+  OLA_ASSERT_FALSE(ola_client.BufferDMX(TEST_UNIVERSE, buffer, args));
+  OLA_ASSERT_FALSE(ola_client.Flush());
+
+  OLA_ASSERT_TRUE(ola_client.Setup());
+  // An empty flush is fine.
+  OLA_ASSERT_TRUE(ola_client.Flush());
+
+  OLA_ASSERT_TRUE(ola_client.BufferDMX(TEST_UNIVERSE, buffer, args));
+  OLA_ASSERT_TRUE(ola_client.BufferDMX(TEST_UNIVERSE + 1, buffer, args));
+  OLA_ASSERT_TRUE(ola_client.Flush());
+
+  // Now only the changed ranges are sent.
+  buffer.SetChannel(10, 255);
+  OLA_ASSERT_TRUE(ola_client.BufferDMX(TEST_UNIVERSE, buffer, args));
+  OLA_ASSERT_TRUE(ola_client.BufferDMX(TEST_UNIVERSE + 1, buffer, args));
+  OLA_ASSERT_TRUE(ola_client.Flush());
+
+  // Terminate the server mid flight
+  OLA_ASSERT_TRUE(ola_client.BufferDMX(TEST_UNIVERSE, buffer, args));
+  m_server_thread->Terminate();
+  m_server_thread->Join();
+
+  OLA_ASSERT_FALSE(ola_client.Flush());
+  ola_client.Stop();
+}
+
+
+/*
+ * Check that the non-blocking mode works.
+ */
+void StreamingClientTest::testNonBlocking() {
+  m_server_thread->WaitForStart();
+  GenericSocketAddress server_address = m_server_thread->RPCAddress();
+  StreamingClient::Options options;
+  options.auto_start = false;
+  options.server_port = server_address.V4Addr().Port();
+  options.non_blocking = true;
+  StreamingClient ola_client(options);
+
+  ola::DmxBuffer buffer;
+  buffer.Blackout();
+  StreamingClient::SendArgs args;
+
+  OLA_ASSERT_TRUE(ola_client.Setup());
+  for (unsigned int i = 0; i < 100; i++) {
+    buffer.SetChannel(0, i);
+    OLA_ASSERT_TRUE(ola_client.SendDMX(TEST_UNIVERSE, buffer, args));
+    OLA_ASSERT_TRUE(ola_client.SendDMX(TEST_UNIVERSE + 1, buffer, args));
+  }
+  // Batches still work, and send any frames that were held back first.
+  OLA_ASSERT_TRUE(ola_client.BufferDMX(TEST_UNIVERSE, buffer, args));
+  OLA_ASSERT_TRUE(ola_client.Flush());
+
+  // Terminate the server mid flight. The close is found from the write
+  // errors, so it may take a couple of frames.
+  m_server_thread->Terminate();
+  m_server_thread->Join();
+
+  unsigned int sent = 0;
+  while (sent < 10 && ola_client.SendDMX(TEST_UNIVERSE, buffer, args)) {
+    sent++;
+    usleep(10000);
+  }
+  OLA_ASSERT_LT(sent, 10u);
+  OLA_ASSERT_FALSE(ola_client.SendDMX(TEST_UNIVERSE, buffer, args));
+  ola_client.Stop();
+}
@@ -18,7 +18,6 @@
  * Copyright (C) 2010 Simon Newton
  */
 
-#include <set>
 #include <string>
 #include <vector>
 #include "ola/Logging.h"
@@ -27,59 +26,87 @@
 
 namespace ola {
 
-using std::set;
 using std::string;
 using std::vector;
 
 void ClientBroker::AddClient(const Client *client) {
-  m_clients.insert(client);
+  if (STLContains(m_client_slots, client)) {
+    return;
+  }
+
+  unsigned int slot;
+  if (m_free_slots.empty()) {
+    slot = m_epochs.size();
+    m_epochs.push_back(0);
+  } else {
+    slot = m_free_slots.back();
+    m_free_slots.pop_back();
+  }
+  m_client_slots[client] = slot;
 }
 
 void ClientBroker::RemoveClient(const Client *client) {
-  m_clients.erase(client);
+  ClientSlotMap::iterator iter = m_client_slots.find(client);
+  if (iter == m_client_slots.end()) {
+    return;
+  }
+
+  // This invalidates any outstanding handles for the client.
+  m_epochs[iter->second]++;
+  m_free_slots.push_back(iter->second);
+  m_client_slots.erase(iter);
 }
 
 void ClientBroker::SendRDMRequest(const Client *client,
                                   Universe *universe,
                                   ola::rdm::RDMRequest *request,
                                   ola::rdm::RDMCallback *callback) {
-  if (!STLContains(m_clients, client)) {
-    OLA_WARN << "Making an RDM call but the client doesn't exist in the "
-             << "broker!";
-  }
-
   universe->SendRDMRequest(
       request,
-      NewSingleCallback(this, &ClientBroker::RequestComplete, client,
-                        callback));
+      NewSingleCallback(this, &ClientBroker::RequestComplete,
+                        GetHandle(client, "Making an RDM call"), callback));
 }
 
 void ClientBroker::RunRDMDiscovery(const Client *client,
                                    Universe *universe,
                                    bool full_discovery,
                                    ola::rdm::RDMDiscoveryCallback *callback) {
-  if (!STLContains(m_clients, client)) {
-    OLA_WARN << "Running RDM discovery but the client doesn't exist in the "
-             << "broker!";
-  }
-
   universe->RunRDMDiscovery(
-      NewSingleCallback(this, &ClientBroker::DiscoveryComplete, client,
-                        callback),
+      NewSingleCallback(this, &ClientBroker::DiscoveryComplete,
+                        GetHandle(client, "Running RDM discovery"), callback),
       full_discovery);
 }
 
+/*
+ * Return the handle for a client. If the client doesn't exist, the handle
+ * will never be live, so the callback is dropped.
+ */
+ClientBroker::ClientHandle ClientBroker::GetHandle(
+    const Client *client,
+    const char *operation) const {
+  ClientHandle handle;
+  ClientSlotMap::const_iterator iter = m_client_slots.find(client);
+  if (iter == m_client_slots.end()) {
+    OLA_WARN << operation << " but the client doesn't exist in the broker!";
+    handle.slot = UNKNOWN_CLIENT_SLOT;
+    handle.epoch = m_epochs[UNKNOWN_CLIENT_SLOT] + 1;
+    return handle;
+  }
+  handle.slot = iter->second;
+  handle.epoch = m_epochs[handle.slot];
+  return handle;
+}
+
 /*
  * Return from an RDM call.
- * @param key the client associated with this request
- * @param callback the callback to run if the key still exists
- * @param code the code of the RDM request
- * @param response the RDM response
+ * @param handle the client associated with this request
+ * @param callback the callback to run if the client still exists
+ * @param reply the RDM reply
  */
-void ClientBroker::RequestComplete(const Client *client,
+void ClientBroker::RequestComplete(ClientHandle handle,
                                    ola::rdm::RDMCallback *callback,
                                    ola::rdm::RDMReply *reply) {
-  if (!STLContains(m_clients, client)) {
+  if (!IsLive(handle)) {
     OLA_DEBUG << "Client no longer exists, cleaning up from RDM response";
     delete callback;
   } else {
@@ -88,10 +115,10 @@ void ClientBroker::RequestComplete(const Client *client,
 }
 
 void ClientBroker::DiscoveryComplete(
-    const Client *client,
+    ClientHandle handle,
     ola::rdm::RDMDiscoveryCallback *callback,
     const ola::rdm::UIDSet &uids) {
-  if (!STLContains(m_clients, client)) {
+  if (!IsLive(handle)) {
     OLA_DEBUG << "Client no longer exists, cleaning up from RDM discovery";
     delete callback;
   } else {
@@ -24,9 +24,14 @@
 #ifndef OLAD_CLIENTBROKER_H_
 #define OLAD_CLIENTBROKER_H_
 
-#include <set>
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <stdint.h>
 #include <string>
 #include <vector>
+#include HASH_MAP_H
 #include "ola/base/Macro.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMControllerInterface.h"
@@ -48,10 +53,15 @@ namespace ola {
  * and proxying RDM calls. When the RDM call returns, if the client responsible
  * for the call has been deleted, we delete the callback rather then executing
  * it.
+ *
+ * Each client is given a slot, and each slot has an epoch that is incremented
+ * when the client is removed. The RDM callbacks hold the slot & epoch, so
+ * checking if the client still exists is a comparison, and removing a client
+ * doesn't need to touch the outstanding callbacks.
  */
 class ClientBroker {
  public:
-  ClientBroker() {}
+  ClientBroker() : m_epochs(1, 0) {}
   ~ClientBroker() {}
 
   /**
@@ -93,18 +103,36 @@ class ClientBroker {
                        ola::rdm::RDMDiscoveryCallback *callback);
 
  private:
-  typedef std::set<const Client*> client_set;
+  // Identifies a client, this is invalidated when the client is removed.
+  struct ClientHandle {
+    unsigned int slot;
+    uint32_t epoch;
+  };
+
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<const Client*, unsigned int>
+      ClientSlotMap;
 
-  client_set m_clients;
+  ClientSlotMap m_client_slots;
+  // The UNKNOWN_CLIENT_SLOT is never allocated.
+  std::vector<uint32_t> m_epochs;
+  std::vector<unsigned int> m_free_slots;
 
-  void RequestComplete(const Client *key,
+  ClientHandle GetHandle(const Client *client, const char *operation) const;
+
+  bool IsLive(const ClientHandle &handle) const {
+    return m_epochs[handle.slot] == handle.epoch;
+  }
+
+  void RequestComplete(ClientHandle handle,
                        ola::rdm::RDMCallback *callback,
                        ola::rdm::RDMReply *reply);
 
-  void DiscoveryComplete(const Client *key,
+  void DiscoveryComplete(ClientHandle handle,
                          ola::rdm::RDMDiscoveryCallback *on_complete,
                          const ola::rdm::UIDSet &uids);
 
+  static const unsigned int UNKNOWN_CLIENT_SLOT = 0;
+
   DISALLOW_COPY_AND_ASSIGN(ClientBroker);
 };
 }  // namespace ola
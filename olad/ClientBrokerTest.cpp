@@ -0,0 +1,190 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClientBrokerTest.cpp
+ * Test fixture for the ClientBroker class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <utility>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/ClientBroker.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+using ola::Client;
+using ola::ClientBroker;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::Universe;
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::vector;
+
+class ClientBrokerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ClientBrokerTest);
+  CPPUNIT_TEST(testRequests);
+  CPPUNIT_TEST(testSlotReuse);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  ClientBrokerTest()
+      : m_uid(0x7a70, 1),
+        m_store(NULL, NULL),
+        m_port(NULL, 1, &m_uids, true) {
+  }
+
+  void setUp();
+  void tearDown();
+  void testRequests();
+  void testSlotReuse();
+
+ private:
+  typedef std::pair<const RDMRequest*, RDMCallback*> PendingRDMRequest;
+
+  UID m_uid;
+  UIDSet m_uids;
+  ola::UniverseStore m_store;
+  TestMockRDMOutputPort m_port;
+  Universe *m_universe;
+  vector<PendingRDMRequest> m_pending_rdm;
+  vector<unsigned int> m_completed;
+
+  void QueueRDMRequest(const RDMRequest *request, RDMCallback *callback) {
+    m_pending_rdm.push_back(PendingRDMRequest(request, callback));
+  }
+
+  void RequestComplete(unsigned int id, RDMReply*) {
+    m_completed.push_back(id);
+  }
+
+  void SendRequest(ClientBroker *broker, const Client *client,
+                   unsigned int id);
+  void AckRDMRequest(unsigned int index);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ClientBrokerTest);
+
+
+void ClientBrokerTest::setUp() {
+  m_uids.AddUID(m_uid);
+  m_port.SetRDMHandler(
+      NewCallback(this, &ClientBrokerTest::QueueRDMRequest));
+  m_universe = m_store.GetUniverseOrCreate(1);
+  m_universe->AddPort(&m_port);
+  m_port.SetUniverse(m_universe);
+  m_pending_rdm.clear();
+  m_completed.clear();
+}
+
+
+void ClientBrokerTest::tearDown() {
+  m_port.SetUniverse(NULL);
+}
+
+
+void ClientBrokerTest::SendRequest(ClientBroker *broker,
+                                   const Client *client,
+                                   unsigned int id) {
+  RDMRequest *request = new ola::rdm::RDMGetRequest(
+      UID(0x7a70, 100), m_uid, 0, 1, 0, 296, NULL, 0);
+  broker->SendRDMRequest(
+      client, m_universe, request,
+      NewSingleCallback(this, &ClientBrokerTest::RequestComplete, id));
+}
+
+
+void ClientBrokerTest::AckRDMRequest(unsigned int index) {
+  OLA_ASSERT_LT(index, static_cast<unsigned int>(m_pending_rdm.size()));
+  const RDMRequest *request = m_pending_rdm[index].first;
+  RDMReply reply(ola::rdm::RDM_COMPLETED_OK,
+                 ola::rdm::GetResponseFromData(request, NULL, 0));
+  delete request;
+  m_pending_rdm[index].second->Run(&reply);
+}
+
+
+/*
+ * Check requests only complete if the client still exists.
+ */
+void ClientBrokerTest::testRequests() {
+  ClientBroker broker;
+  Client client1(NULL, m_uid);
+  Client client2(NULL, m_uid);
+  Client unknown_client(NULL, m_uid);
+  broker.AddClient(&client1);
+  broker.AddClient(&client2);
+
+  SendRequest(&broker, &client1, 1);
+  SendRequest(&broker, &client2, 2);
+  SendRequest(&broker, &unknown_client, 3);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_pending_rdm.size());
+
+  broker.RemoveClient(&client1);
+  AckRDMRequest(0);
+  AckRDMRequest(1);
+  AckRDMRequest(2);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_completed.size());
+  OLA_ASSERT_EQ(2u, m_completed[0]);
+
+  // Removing a client twice is a no-op.
+  broker.RemoveClient(&client1);
+  broker.RemoveClient(&client2);
+}
+
+
+/*
+ * Check that a new client in a reused slot doesn't get the responses for the
+ * old client.
+ */
+void ClientBrokerTest::testSlotReuse() {
+  ClientBroker broker;
+  Client client1(NULL, m_uid);
+  Client client2(NULL, m_uid);
+
+  broker.AddClient(&client1);
+  SendRequest(&broker, &client1, 1);
+  broker.RemoveClient(&client1);
+
+  broker.AddClient(&client2);
+  SendRequest(&broker, &client2, 2);
+
+  // client1 is added back, this is a new handle.
+  broker.AddClient(&client1);
+  SendRequest(&broker, &client1, 3);
+
+  AckRDMRequest(0);
+  AckRDMRequest(1);
+  AckRDMRequest(2);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_completed.size());
+  OLA_ASSERT_EQ(2u, m_completed[0]);
+  OLA_ASSERT_EQ(3u, m_completed[1]);
+
+  broker.RemoveClient(&client1);
+  broker.RemoveClient(&client2);
+}
@@ -25,6 +25,7 @@
 #include <vector>
 #include "ola/stl/STLUtils.h"
 #include "olad/DynamicPluginLoader.h"
+#include "olad/LazyPlugin.h"
 #include "olad/Plugin.h"
 
 #ifdef USE_ARTNET
@@ -79,6 +80,10 @@
 #include "plugins/renard/RenardPlugin.h"
 #endif  // USE_RENARD
 
+#ifdef USE_REPLICATION
+#include "plugins/replication/ReplicationPlugin.h"
+#endif  // USE_REPLICATION
+
 #ifdef USE_SANDNET
 #include "plugins/sandnet/SandNetPlugin.h"
 #endif  // USE_SANDNET
@@ -119,6 +124,13 @@ namespace ola {
 
 using std::vector;
 
+namespace {
+template <typename PluginClass>
+AbstractPlugin *NewPlugin(PluginAdaptor *plugin_adaptor) {
+  return new PluginClass(plugin_adaptor);
+}
+}  // namespace
+
 DynamicPluginLoader::~DynamicPluginLoader() {
   UnloadPlugins();
 }
@@ -131,110 +143,112 @@ vector<AbstractPlugin*> DynamicPluginLoader::LoadPlugins() {
 }
 
 /*
- * Setup the plugin list
+ * Add a LazyPlugin which creates a PluginClass when it's needed.
+ */
+template <typename PluginClass>
+void DynamicPluginLoader::AddPlugin(ola_plugin_id id, bool default_mode) {
+  m_plugins.push_back(new LazyPlugin(
+      m_plugin_adaptor, id, PluginClass::PLUGIN_NAME,
+      PluginClass::PLUGIN_PREFIX, default_mode, &NewPlugin<PluginClass>));
+}
+
+/*
+ * Setup the plugin list. The plugins themselves aren't created until
+ * they're enabled or started, see LazyPlugin.
  */
 void DynamicPluginLoader::PopulatePlugins() {
 #ifdef USE_DMX4LINUX
-  m_plugins.push_back(
-      new ola::plugin::dmx4linux::Dmx4LinuxPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::dmx4linux::Dmx4LinuxPlugin>(OLA_PLUGIN_DMX4LINUX);
 #endif  // USE_DMX4LINUX
 
 #ifdef USE_ARTNET
-  m_plugins.push_back(new ola::plugin::artnet::ArtNetPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::artnet::ArtNetPlugin>(OLA_PLUGIN_ARTNET);
 #endif  // USE_ARTNET
 
 #ifdef USE_DUMMY
-  m_plugins.push_back(new ola::plugin::dummy::DummyPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::dummy::DummyPlugin>(OLA_PLUGIN_DUMMY);
 #endif  // USE_DUMMY
 
 #ifdef USE_E131
-  m_plugins.push_back(new ola::plugin::e131::E131Plugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::e131::E131Plugin>(OLA_PLUGIN_E131);
 #endif  // USE_E131
 
 #ifdef USE_ESPNET
-  m_plugins.push_back(new ola::plugin::espnet::EspNetPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::espnet::EspNetPlugin>(OLA_PLUGIN_ESPNET);
 #endif  // USE_ESPNET
 
 #ifdef USE_GPIO
-  m_plugins.push_back(new ola::plugin::gpio::GPIOPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::gpio::GPIOPlugin>(OLA_PLUGIN_GPIO);
 #endif  // USE_GPIO
 
 #ifdef USE_KARATE
-  m_plugins.push_back(
-      new ola::plugin::karate::KaratePlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::karate::KaratePlugin>(OLA_PLUGIN_KARATE);
 #endif  // USE_KARATE
 
 #ifdef USE_KINET
-  m_plugins.push_back(new ola::plugin::kinet::KiNetPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::kinet::KiNetPlugin>(OLA_PLUGIN_KINET);
 #endif  // USE_KINET
 
 #ifdef USE_MILINST
-  m_plugins.push_back(
-      new ola::plugin::milinst::MilInstPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::milinst::MilInstPlugin>(OLA_PLUGIN_MILINST);
 #endif  // USE_MILINST
 
 #ifdef USE_OPENDMX
-  m_plugins.push_back(
-      new ola::plugin::opendmx::OpenDmxPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::opendmx::OpenDmxPlugin>(OLA_PLUGIN_OPENDMX);
 #endif  // USE_OPENDMX
 
 #ifdef USE_OPENPIXELCONTROL
-  m_plugins.push_back(
-      new ola::plugin::openpixelcontrol::OPCPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::openpixelcontrol::OPCPlugin>(
+      OLA_PLUGIN_OPENPIXELCONTROL);
 #endif  // USE_OPENPIXELCONTROL
 
 #ifdef USE_OSC
-  m_plugins.push_back(
-      new ola::plugin::osc::OSCPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::osc::OSCPlugin>(OLA_PLUGIN_OSC);
 #endif  // USE_OSC
 
 #ifdef USE_RENARD
-  m_plugins.push_back(
-      new ola::plugin::renard::RenardPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::renard::RenardPlugin>(OLA_PLUGIN_RENARD);
 #endif  // USE_RENARD
 
+#ifdef USE_REPLICATION
+  AddPlugin<ola::plugin::replication::ReplicationPlugin>(
+      OLA_PLUGIN_REPLICATION);
+#endif  // USE_REPLICATION
+
 #ifdef USE_SANDNET
-  m_plugins.push_back(
-      new ola::plugin::sandnet::SandNetPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::sandnet::SandNetPlugin>(OLA_PLUGIN_SANDNET);
 #endif  // USE_SANDNET
 
 #ifdef USE_SHOWNET
-  m_plugins.push_back(
-      new ola::plugin::shownet::ShowNetPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::shownet::ShowNetPlugin>(OLA_PLUGIN_SHOWNET);
 #endif  // USE_SHOWNET
 
 #ifdef USE_SPI
-  m_plugins.push_back(
-      new ola::plugin::spi::SPIPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::spi::SPIPlugin>(OLA_PLUGIN_SPI);
 #endif  // USE_SPI
 
 #ifdef USE_STAGEPROFI
-  m_plugins.push_back(
-      new ola::plugin::stageprofi::StageProfiPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::stageprofi::StageProfiPlugin>(OLA_PLUGIN_STAGEPROFI);
 #endif  // USE_STAGEPROFI
 
 #ifdef USE_USBPRO
-  m_plugins.push_back(
-      new ola::plugin::usbpro::UsbSerialPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::usbpro::UsbSerialPlugin>(OLA_PLUGIN_USBPRO);
 #endif  // USE_USBPRO
 
 #ifdef USE_LIBUSB
-  m_plugins.push_back(new ola::plugin::usbdmx::UsbDmxPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::usbdmx::UsbDmxPlugin>(OLA_PLUGIN_USBDMX);
 #endif  // USE_LIBUSB
 
 #ifdef USE_PATHPORT
-  m_plugins.push_back(
-      new ola::plugin::pathport::PathportPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::pathport::PathportPlugin>(OLA_PLUGIN_PATHPORT);
 #endif  // USE_PATHPORT
 
 #ifdef USE_FTDI
-  m_plugins.push_back(
-      new ola::plugin::ftdidmx::FtdiDmxPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::ftdidmx::FtdiDmxPlugin>(OLA_PLUGIN_FTDIDMX, false);
 #endif  // USE_FTDI
 
 #ifdef USE_UART
-  m_plugins.push_back(
-      new ola::plugin::uartdmx::UartDmxPlugin(m_plugin_adaptor));
+  AddPlugin<ola::plugin::uartdmx::UartDmxPlugin>(OLA_PLUGIN_UARTDMX, false);
 #endif  // USE_UART
 }
 
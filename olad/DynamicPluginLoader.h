@@ -23,6 +23,7 @@
 
 #include <vector>
 #include "ola/base/Macro.h"
+#include "ola/plugin_id.h"
 #include "olad/PluginLoader.h"
 
 namespace ola {
@@ -42,6 +43,9 @@ class DynamicPluginLoader: public PluginLoader {
  private:
   void PopulatePlugins();
 
+  template <typename PluginClass>
+  void AddPlugin(ola_plugin_id id, bool default_mode = true);
+
   std::vector<class AbstractPlugin*> m_plugins;
 
   DISALLOW_COPY_AND_ASSIGN(DynamicPluginLoader);
@@ -0,0 +1,354 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * HotStandby.cpp
+ * Mirrors the state of a primary olad, and takes over if it fails.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/network/HealthCheckedConnection.h"
+#include "ola/rdm/UID.h"
+#include "olad/DmxSource.h"
+#include "olad/HotStandby.h"
+#include "olad/Port.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+namespace ola {
+
+using ola::client::DMXMetadata;
+using ola::client::OlaUniverse;
+using ola::client::Result;
+using ola::network::TCPSocket;
+using std::map;
+using std::set;
+using std::vector;
+
+const char HotStandby::K_STANDBY_STATE_VAR[] = "standby-state";
+
+/**
+ * @brief Polls the primary every heartbeat interval.
+ *
+ * The primary doesn't send heartbeats of its own, so each reply to a poll
+ * counts as one.
+ */
+class HotStandby::HealthCheck : public ola::network::HealthCheckedConnection {
+ public:
+  HealthCheck(HotStandby *standby, ola::thread::SchedulerInterface *scheduler,
+              const TimeInterval &interval)
+      : HealthCheckedConnection(scheduler, interval),
+        m_standby(standby) {
+  }
+
+  void SendHeartbeat() { m_standby->SendHeartbeat(); }
+
+ protected:
+  void HeartbeatTimeout() { m_standby->HeartbeatTimeout(); }
+
+ private:
+  HotStandby *m_standby;
+};
+
+
+HotStandby::HotStandby(ola::io::SelectServerInterface *ss,
+                       UniverseStore *universe_store,
+                       ExportMap *export_map,
+                       const Options &options)
+    : m_ss(ss),
+      m_universe_store(universe_store),
+      m_export_map(export_map),
+      m_options(options),
+      m_active(false),
+      m_heartbeat_pending(false),
+      m_uid_fetches_pending(0),
+      m_socket_factory(NewCallback(this, &HotStandby::OnConnect)),
+      m_connector(ss, &m_socket_factory,
+                  TimeInterval(0, CONNECT_TIMEOUT_MS * 1000)),
+      m_backoff_policy(TimeInterval(RETRY_INTERVAL_MS / 1000, 0)),
+      m_client(new Client(NULL, ola::rdm::UID(0, 0))) {
+}
+
+
+HotStandby::~HotStandby() {
+  CloseConnection();
+  m_connector.RemoveEndpoint(m_options.primary);
+
+  vector<Universe*> universes;
+  m_universe_store->GetList(&universes);
+  vector<Universe*>::iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    (*iter)->RemoveSourceClient(m_client.get());
+  }
+}
+
+
+void HotStandby::Start() {
+  OLA_INFO << "Running as a hot standby for " << m_options.primary;
+  m_universe_store->SetOutputHold(true);
+  UpdateState("connecting");
+  m_connector.AddEndpoint(m_options.primary, &m_backoff_policy);
+}
+
+
+void HotStandby::TakeOver() {
+  if (m_active) {
+    return;
+  }
+  m_active = true;
+  CloseConnection();
+  m_connector.RemoveEndpoint(m_options.primary);
+
+  TimeStamp now;
+  Clock clock;
+  clock.CurrentTime(&now);
+
+  unsigned int universe_count = 0;
+  DmxMap::const_iterator dmx_iter = m_dmx.begin();
+  for (; dmx_iter != m_dmx.end(); ++dmx_iter) {
+    Universe *universe = m_universe_store->GetUniverse(dmx_iter->first);
+    if (!universe) {
+      continue;
+    }
+    DmxSource source(dmx_iter->second, now, m_priorities[dmx_iter->first]);
+    m_client->DMXReceived(dmx_iter->first, source);
+    universe->SourceClientDataChanged(m_client.get());
+    universe_count++;
+  }
+
+  UIDMap::const_iterator uid_iter = m_uids.begin();
+  for (; uid_iter != m_uids.end(); ++uid_iter) {
+    Universe *universe = m_universe_store->GetUniverse(uid_iter->first);
+    if (universe) {
+      RestoreUIDs(universe, uid_iter->second);
+    }
+  }
+
+  // Releasing the hold writes the data for each universe.
+  m_universe_store->SetOutputHold(false);
+  UpdateState("active");
+  OLA_WARN << "Primary " << m_options.primary << " failed, took over "
+           << universe_count << " universes";
+}
+
+
+void HotStandby::OnConnect(TCPSocket *socket) {
+  OLA_INFO << "Connected to primary " << m_options.primary;
+  m_socket.reset(socket);
+  m_ola_client.reset(new ola::client::OlaClient(socket));
+  if (!m_ola_client->Setup()) {
+    OLA_WARN << "Failed to setup the client for " << m_options.primary;
+    m_ola_client.reset();
+    m_socket.reset();
+    m_connector.Disconnect(m_options.primary);
+    return;
+  }
+  m_ola_client->SetCloseHandler(
+      NewSingleCallback(this, &HotStandby::ConnectionClosed));
+  m_ola_client->SetDMXCallback(NewCallback(this, &HotStandby::NewDMX));
+  m_ss->AddReadDescriptor(socket);
+
+  m_heartbeat_pending = false;
+  m_uid_fetches_pending = 0;
+  m_last_uid_refresh = TimeStamp();
+  m_registered.clear();
+  UpdateState("standby");
+
+  m_health_check.reset(new HealthCheck(this, m_ss,
+                                       m_options.heartbeat_interval));
+  m_health_check->Setup();
+}
+
+
+/*
+ * Called when the primary closes the connection, which is what happens when
+ * it crashes.
+ */
+void HotStandby::ConnectionClosed() {
+  OLA_WARN << "Connection to primary " << m_options.primary << " closed";
+  // We're inside the RpcChannel, so tear it down on the next loop.
+  m_ss->Execute(NewSingleCallback(this, &HotStandby::TakeOver));
+}
+
+
+void HotStandby::CloseConnection() {
+  m_health_check.reset();
+  if (m_ola_client.get()) {
+    m_ss->RemoveReadDescriptor(m_socket.get());
+    m_ola_client->Stop();
+    m_ola_client.reset();
+  }
+  m_socket.reset();
+}
+
+
+void HotStandby::SendHeartbeat() {
+  if (!m_ola_client.get() || m_heartbeat_pending) {
+    return;
+  }
+  m_heartbeat_pending = true;
+  m_ola_client->FetchUniverseList(
+      NewSingleCallback(this, &HotStandby::UniverseList));
+
+  const TimeStamp *now = m_ss->WakeUpTime();
+  if (m_uid_fetches_pending ||
+      *now - m_last_uid_refresh < m_options.uid_refresh_interval) {
+    return;
+  }
+  m_last_uid_refresh = *now;
+  set<unsigned int>::const_iterator iter = m_registered.begin();
+  for (; iter != m_registered.end(); ++iter) {
+    m_uid_fetches_pending++;
+    m_ola_client->RunDiscovery(
+        *iter, ola::client::DISCOVERY_CACHED,
+        NewSingleCallback(this, &HotStandby::UIDList, *iter));
+  }
+}
+
+
+void HotStandby::HeartbeatTimeout() {
+  OLA_WARN << "Primary " << m_options.primary << " stopped responding";
+  m_ss->Execute(NewSingleCallback(this, &HotStandby::TakeOver));
+}
+
+
+void HotStandby::UniverseList(const Result &result,
+                              const vector<OlaUniverse> &universes) {
+  m_heartbeat_pending = false;
+  if (!result.Success()) {
+    OLA_WARN << "Failed to fetch universes from the primary: "
+             << result.Error();
+    return;
+  }
+  if (!m_health_check.get()) {
+    return;
+  }
+  m_health_check->HeartbeatReceived();
+
+  set<unsigned int> current;
+  vector<OlaUniverse>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    current.insert(iter->Id());
+    ApplyUniverseSettings(*iter);
+    if (m_registered.insert(iter->Id()).second) {
+      m_ola_client->RegisterUniverse(
+          iter->Id(), ola::client::REGISTER,
+          NewSingleCallback(this, &HotStandby::RegistrationComplete,
+                            iter->Id()));
+    }
+  }
+
+  // Forget the universes the primary no longer has.
+  set<unsigned int>::iterator reg_iter = m_registered.begin();
+  while (reg_iter != m_registered.end()) {
+    if (current.find(*reg_iter) == current.end()) {
+      m_dmx.erase(*reg_iter);
+      m_priorities.erase(*reg_iter);
+      m_uids.erase(*reg_iter);
+      m_registered.erase(reg_iter++);
+    } else {
+      ++reg_iter;
+    }
+  }
+}
+
+
+void HotStandby::RegistrationComplete(unsigned int universe,
+                                      const Result &result) {
+  if (!result.Success()) {
+    OLA_WARN << "Failed to mirror universe " << universe << ": "
+             << result.Error();
+    m_registered.erase(universe);
+  }
+}
+
+
+void HotStandby::NewDMX(const DMXMetadata &metadata, const DmxBuffer &data) {
+  if (m_registered.find(metadata.universe) == m_registered.end()) {
+    return;
+  }
+  m_dmx[metadata.universe].Set(data);
+  m_priorities[metadata.universe] = metadata.priority;
+}
+
+
+void HotStandby::UIDList(unsigned int universe,
+                         const Result &result,
+                         const ola::rdm::UIDSet &uids) {
+  if (m_uid_fetches_pending) {
+    m_uid_fetches_pending--;
+  }
+  if (result.Success() &&
+      m_registered.find(universe) != m_registered.end()) {
+    m_uids[universe] = uids;
+  }
+}
+
+
+void HotStandby::ApplyUniverseSettings(const OlaUniverse &primary) {
+  Universe *universe = m_universe_store->GetUniverse(primary.Id());
+  if (!universe) {
+    return;
+  }
+  if (universe->Name() != primary.Name()) {
+    universe->SetName(primary.Name());
+  }
+  Universe::merge_mode mode = primary.MergeMode() == OlaUniverse::MERGE_HTP ?
+      Universe::MERGE_HTP : Universe::MERGE_LTP;
+  if (universe->MergeMode() != mode) {
+    universe->SetMergeMode(mode);
+  }
+}
+
+
+/*
+ * The UIDs can only be restored if there is a single port they could be on,
+ * otherwise they're found by the next discovery.
+ */
+void HotStandby::RestoreUIDs(Universe *universe,
+                             const ola::rdm::UIDSet &uids) {
+  vector<OutputPort*> ports;
+  universe->OutputPorts(&ports);
+  OutputPort *rdm_port = NULL;
+  vector<OutputPort*>::const_iterator iter = ports.begin();
+  for (; iter != ports.end(); ++iter) {
+    if (!(*iter)->SupportsRDM()) {
+      continue;
+    }
+    if (rdm_port) {
+      OLA_INFO << "Universe " << universe->UniverseId()
+               << " has more than one RDM port, not restoring UIDs";
+      return;
+    }
+    rdm_port = *iter;
+  }
+  if (rdm_port) {
+    universe->NewUIDList(rdm_port, uids);
+  }
+}
+
+
+void HotStandby::UpdateState(const char *state) {
+  if (m_export_map) {
+    m_export_map->GetStringVar(K_STANDBY_STATE_VAR)->Set(state);
+  }
+}
+}  // namespace ola
@@ -0,0 +1,178 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * HotStandby.h
+ * Mirrors the state of a primary olad, and takes over if it fails.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_HOTSTANDBY_H_
+#define OLAD_HOTSTANDBY_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/client/ClientTypes.h"
+#include "ola/client/OlaClient.h"
+#include "ola/client/Result.h"
+#include "ola/io/SelectServerInterface.h"
+#include "ola/network/AdvancedTCPConnector.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/network/TCPSocket.h"
+#include "ola/network/TCPSocketFactory.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/util/Backoff.h"
+
+namespace ola {
+
+class Client;
+class UniverseStore;
+
+/**
+ * @brief Runs olad as a hot standby for another olad.
+ *
+ * The standby connects to the RPC port of the primary, and mirrors:
+ *  - the name & merge mode of each universe.
+ *  - the merged DMX data of each universe, which the primary streams to us.
+ *  - the UIDs discovered on each universe.
+ *
+ * While the primary is healthy, the writes to our output ports are held, so
+ * that both instances don't drive the same outputs, and periodic RDM
+ * discovery isn't run.
+ *
+ * The primary is polled every heartbeat interval. If the connection closes,
+ * or the primary doesn't answer within 2.5 heartbeat intervals, we take over:
+ * the mirrored data is added to each universe as a source, the mirrored UIDs
+ * are used for universes with a single RDM output port, so discovery doesn't
+ * need to run first, and the output ports are released. If the output is
+ * aligned to a frame clock, the data is written on the next tick.
+ *
+ * Until the first connection to the primary succeeds we keep retrying, so a
+ * standby that starts before the primary doesn't take over. Once active, the
+ * standby stays active; fail-back is left to the operator.
+ */
+class HotStandby {
+ public:
+  struct Options {
+    Options()
+        : heartbeat_interval(0, DEFAULT_HEARTBEAT_INTERVAL_MS * 1000),
+          uid_refresh_interval(DEFAULT_UID_REFRESH_INTERVAL_S, 0) {
+    }
+
+    /** @brief The RPC address of the primary olad. */
+    ola::network::IPV4SocketAddress primary;
+    /** @brief How often to poll the primary. */
+    TimeInterval heartbeat_interval;
+    /** @brief How often to fetch the UID lists from the primary. */
+    TimeInterval uid_refresh_interval;
+  };
+
+  /**
+   * @brief Create a new HotStandby.
+   * @param ss the SelectServer to use.
+   * @param universe_store the UniverseStore to mirror the universes into.
+   * @param export_map the ExportMap to use, may be NULL.
+   * @param options the Options to use.
+   */
+  HotStandby(ola::io::SelectServerInterface *ss,
+             UniverseStore *universe_store,
+             ExportMap *export_map,
+             const Options &options);
+  ~HotStandby();
+
+  /**
+   * @brief Hold the outputs and start connecting to the primary.
+   */
+  void Start();
+
+  /**
+   * @brief Check if we've taken over from the primary.
+   */
+  bool IsActive() const { return m_active; }
+
+  /**
+   * @brief Take over from the primary.
+   *
+   * This is called when the primary fails. It does nothing if we're already
+   * active.
+   */
+  void TakeOver();
+
+  static const char K_STANDBY_STATE_VAR[];
+  static const unsigned int DEFAULT_HEARTBEAT_INTERVAL_MS = 10;
+  static const unsigned int DEFAULT_UID_REFRESH_INTERVAL_S = 5;
+
+ private:
+  class HealthCheck;
+
+  typedef std::map<unsigned int, DmxBuffer> DmxMap;
+  typedef std::map<unsigned int, uint8_t> PriorityMap;
+  typedef std::map<unsigned int, ola::rdm::UIDSet> UIDMap;
+
+  ola::io::SelectServerInterface *m_ss;
+  UniverseStore *m_universe_store;
+  ExportMap *m_export_map;
+  const Options m_options;
+  bool m_active;
+  bool m_heartbeat_pending;
+  unsigned int m_uid_fetches_pending;
+  TimeStamp m_last_uid_refresh;
+
+  ola::network::TCPSocketFactory m_socket_factory;
+  ola::network::AdvancedTCPConnector m_connector;
+  ola::ConstantBackoffPolicy m_backoff_policy;
+  std::auto_ptr<ola::network::TCPSocket> m_socket;
+  std::auto_ptr<ola::client::OlaClient> m_ola_client;
+  std::auto_ptr<HealthCheck> m_health_check;
+
+  // The universes on the primary, and the ones we've registered for.
+  std::set<unsigned int> m_registered;
+  DmxMap m_dmx;
+  PriorityMap m_priorities;
+  UIDMap m_uids;
+  // The mirrored DMX data is added to the universes from this client.
+  std::auto_ptr<Client> m_client;
+
+  void OnConnect(ola::network::TCPSocket *socket);
+  void ConnectionClosed();
+  void CloseConnection();
+  void SendHeartbeat();
+  void HeartbeatTimeout();
+  void UniverseList(const ola::client::Result &result,
+                    const std::vector<ola::client::OlaUniverse> &universes);
+  void RegistrationComplete(unsigned int universe,
+                            const ola::client::Result &result);
+  void NewDMX(const ola::client::DMXMetadata &metadata,
+              const DmxBuffer &data);
+  void UIDList(unsigned int universe,
+               const ola::client::Result &result,
+               const ola::rdm::UIDSet &uids);
+  void ApplyUniverseSettings(const ola::client::OlaUniverse &universe);
+  void RestoreUIDs(class Universe *universe, const ola::rdm::UIDSet &uids);
+  void UpdateState(const char *state);
+
+  static const unsigned int CONNECT_TIMEOUT_MS = 500;
+  static const unsigned int RETRY_INTERVAL_MS = 1000;
+
+  DISALLOW_COPY_AND_ASSIGN(HotStandby);
+};
+}  // namespace ola
+#endif  // OLAD_HOTSTANDBY_H_
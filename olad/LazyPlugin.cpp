@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * LazyPlugin.cpp
+ * A plugin which is only created when it's needed.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/LazyPlugin.h"
+
+#include <set>
+#include <string>
+
+#include "ola/Logging.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/Preferences.h"
+
+namespace ola {
+
+using std::set;
+using std::string;
+
+LazyPlugin::LazyPlugin(PluginAdaptor *plugin_adaptor,
+                       ola_plugin_id id,
+                       const string &name,
+                       const string &prefix,
+                       bool default_mode,
+                       create_t *factory)
+    : m_plugin_adaptor(plugin_adaptor),
+      m_id(id),
+      m_name(name),
+      m_prefix(prefix),
+      m_default_mode(default_mode),
+      m_factory(factory),
+      m_preferences(NULL) {
+}
+
+LazyPlugin::~LazyPlugin() {}
+
+/*
+ * Only the enabled flag is loaded here, the plugin loads the rest of its
+ * preferences when it's created.
+ */
+bool LazyPlugin::LoadPreferences() {
+  if (!m_preferences) {
+    m_preferences = m_plugin_adaptor->NewPreference(m_prefix);
+    if (!m_preferences) {
+      return false;
+    }
+
+    m_preferences->Load();
+    if (m_preferences->SetDefaultValue(Plugin::ENABLED_KEY, BoolValidator(),
+                                       m_default_mode)) {
+      m_preferences->Save();
+    }
+  }
+
+  if (!IsEnabled()) {
+    return true;
+  }
+  return GetPlugin()->LoadPreferences();
+}
+
+string LazyPlugin::PreferenceConfigLocation() const {
+  return m_preferences ? m_preferences->ConfigLocation() : "";
+}
+
+bool LazyPlugin::IsEnabled() const {
+  return m_preferences && m_preferences->GetValueAsBool(Plugin::ENABLED_KEY);
+}
+
+void LazyPlugin::SetEnabledState(bool enable) {
+  if (!m_preferences) {
+    return;
+  }
+  m_preferences->SetValueAsBool(Plugin::ENABLED_KEY, enable);
+  m_preferences->Save();
+}
+
+bool LazyPlugin::Start() {
+  return GetPlugin()->Start();
+}
+
+bool LazyPlugin::Stop() {
+  return m_plugin.get() ? m_plugin->Stop() : false;
+}
+
+string LazyPlugin::Description() const {
+  return GetPlugin()->Description();
+}
+
+void LazyPlugin::ConflictsWith(set<ola_plugin_id> *conflict_set) const {
+  GetPlugin()->ConflictsWith(conflict_set);
+}
+
+/*
+ * Create the plugin if it doesn't already exist.
+ */
+AbstractPlugin *LazyPlugin::GetPlugin() const {
+  if (!m_plugin.get()) {
+    OLA_DEBUG << "Creating plugin " << m_name;
+    m_plugin.reset(m_factory(m_plugin_adaptor));
+    if (m_plugin->Id() != m_id) {
+      OLA_WARN << "Plugin " << m_name << " has id " << m_plugin->Id()
+               << ", expected " << m_id;
+    }
+  }
+  return m_plugin.get();
+}
+}  // namespace ola
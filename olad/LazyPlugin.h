@@ -0,0 +1,100 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * LazyPlugin.h
+ * A plugin which is only created when it's needed.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_LAZYPLUGIN_H_
+#define OLAD_LAZYPLUGIN_H_
+
+#include <memory>
+#include <set>
+#include <string>
+
+#include "ola/base/Macro.h"
+#include "ola/plugin_id.h"
+#include "olad/Plugin.h"
+
+namespace ola {
+
+/**
+ * @brief Stands in for a plugin until the plugin is needed.
+ *
+ * The LazyPlugin reads the plugin's enabled flag from the preferences itself,
+ * so disabled plugins are never created, and don't load the rest of their
+ * preferences. The plugin is created when it's enabled, when it's started,
+ * or when something asks for its description or conflicts, e.g. an RPC
+ * client listing the plugins.
+ *
+ * The plugin shares the Preferences object with the LazyPlugin, since
+ * PreferencesFactory returns the same object for each prefix.
+ */
+class LazyPlugin: public AbstractPlugin {
+ public:
+  /**
+   * @brief Create a new LazyPlugin.
+   * @param plugin_adaptor the PluginAdaptor to pass to the plugin.
+   * @param id the id of the plugin.
+   * @param name the name of the plugin.
+   * @param prefix the preferences prefix of the plugin.
+   * @param default_mode true if the plugin is enabled by default.
+   * @param factory the function which creates the plugin.
+   */
+  LazyPlugin(PluginAdaptor *plugin_adaptor,
+             ola_plugin_id id,
+             const std::string &name,
+             const std::string &prefix,
+             bool default_mode,
+             create_t *factory);
+  ~LazyPlugin();
+
+  bool LoadPreferences();
+  std::string PreferenceConfigLocation() const;
+  bool IsEnabled() const;
+  void SetEnabledState(bool enable);
+  bool Start();
+  bool Stop();
+  ola_plugin_id Id() const { return m_id; }
+  std::string Name() const { return m_name; }
+  std::string Description() const;
+  void ConflictsWith(std::set<ola_plugin_id> *conflict_set) const;
+
+  bool operator<(const AbstractPlugin &other) const {
+    return Id() < other.Id();
+  }
+
+  /**
+   * @brief Check if the plugin has been created.
+   */
+  bool IsCreated() const { return m_plugin.get() != NULL; }
+
+ private:
+  PluginAdaptor *m_plugin_adaptor;
+  const ola_plugin_id m_id;
+  const std::string m_name;
+  const std::string m_prefix;
+  const bool m_default_mode;
+  create_t *m_factory;
+  class Preferences *m_preferences;
+  mutable std::auto_ptr<AbstractPlugin> m_plugin;
+
+  AbstractPlugin *GetPlugin() const;
+
+  DISALLOW_COPY_AND_ASSIGN(LazyPlugin);
+};
+}  // namespace ola
+#endif  // OLAD_LAZYPLUGIN_H_
@@ -0,0 +1,175 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * LazyPluginTest.cpp
+ * Test fixture for the LazyPlugin class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "olad/LazyPlugin.h"
+#include "olad/Plugin.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/PluginLoader.h"
+#include "olad/PluginManager.h"
+#include "olad/Preferences.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::AbstractPlugin;
+using ola::LazyPlugin;
+using ola::PluginAdaptor;
+using ola::PluginLoader;
+using ola::PluginManager;
+using std::set;
+using std::string;
+using std::vector;
+
+
+class LazyPluginTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(LazyPluginTest);
+  CPPUNIT_TEST(testDisabledPlugin);
+  CPPUNIT_TEST(testPluginManager);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testDisabledPlugin();
+    void testPluginManager();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LazyPluginTest);
+
+namespace {
+
+AbstractPlugin *NewArtNetPlugin(PluginAdaptor *adaptor) {
+  set<ola::ola_plugin_id> conflicts;
+  conflicts.insert(ola::OLA_PLUGIN_ESPNET);
+  return new TestMockPlugin(adaptor, ola::OLA_PLUGIN_ARTNET, conflicts);
+}
+
+AbstractPlugin *NewEspNetPlugin(PluginAdaptor *adaptor) {
+  return new TestMockPlugin(adaptor, ola::OLA_PLUGIN_ESPNET);
+}
+
+class LazyLoader: public PluginLoader {
+ public:
+    LazyLoader() : PluginLoader() {}
+    ~LazyLoader() { UnloadPlugins(); }
+
+    vector<AbstractPlugin*> LoadPlugins() {
+      m_plugins.push_back(new LazyPlugin(
+          m_plugin_adaptor, ola::OLA_PLUGIN_ARTNET, "ArtNet", "artnet", true,
+          &NewArtNetPlugin));
+      m_plugins.push_back(new LazyPlugin(
+          m_plugin_adaptor, ola::OLA_PLUGIN_ESPNET, "EspNet", "espnet", false,
+          &NewEspNetPlugin));
+      return m_plugins;
+    }
+
+    void UnloadPlugins() {
+      ola::STLDeleteElements(&m_plugins);
+    }
+
+    LazyPlugin *Plugin(unsigned int i) {
+      return static_cast<LazyPlugin*>(m_plugins[i]);
+    }
+
+ private:
+    vector<AbstractPlugin*> m_plugins;
+};
+}  // namespace
+
+
+/*
+ * Check a disabled plugin isn't created.
+ */
+void LazyPluginTest::testDisabledPlugin() {
+  ola::MemoryPreferencesFactory factory;
+  PluginAdaptor adaptor(NULL, NULL, NULL, &factory, NULL, NULL);
+
+  LazyPlugin plugin(&adaptor, ola::OLA_PLUGIN_ESPNET, "EspNet", "espnet",
+                    false, &NewEspNetPlugin);
+  OLA_ASSERT_EQ(ola::OLA_PLUGIN_ESPNET, plugin.Id());
+  OLA_ASSERT_EQ(string("EspNet"), plugin.Name());
+  OLA_ASSERT_FALSE(plugin.IsEnabled());
+
+  OLA_ASSERT_TRUE(plugin.LoadPreferences());
+  OLA_ASSERT_FALSE(plugin.IsEnabled());
+  OLA_ASSERT_FALSE(plugin.IsCreated());
+  OLA_ASSERT_EQ(string("false"),
+                factory.NewPreference("espnet")->GetValue(
+                    ola::Plugin::ENABLED_KEY));
+  OLA_ASSERT_FALSE(plugin.Stop());
+  OLA_ASSERT_FALSE(plugin.IsCreated());
+
+  // Enabling the plugin updates the preferences, it's created when it's
+  // started.
+  plugin.SetEnabledState(true);
+  OLA_ASSERT_TRUE(plugin.IsEnabled());
+  OLA_ASSERT_FALSE(plugin.IsCreated());
+  OLA_ASSERT_TRUE(plugin.Start());
+  OLA_ASSERT_TRUE(plugin.IsCreated());
+  OLA_ASSERT_TRUE(plugin.Stop());
+
+  // The description comes from the plugin.
+  LazyPlugin plugin2(&adaptor, ola::OLA_PLUGIN_ESPNET, "EspNet", "espnet",
+                     false, &NewEspNetPlugin);
+  OLA_ASSERT_EQ(string("bar"), plugin2.Description());
+  OLA_ASSERT_TRUE(plugin2.IsCreated());
+}
+
+
+/*
+ * Check the PluginManager only creates the enabled plugins.
+ */
+void LazyPluginTest::testPluginManager() {
+  ola::MemoryPreferencesFactory factory;
+  PluginAdaptor adaptor(NULL, NULL, NULL, &factory, NULL, NULL);
+
+  LazyLoader loader;
+  vector<PluginLoader*> loaders;
+  loaders.push_back(&loader);
+
+  PluginManager manager(loaders, &adaptor);
+  manager.LoadAll();
+
+  vector<AbstractPlugin*> plugins;
+  manager.Plugins(&plugins);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), plugins.size());
+  OLA_ASSERT_TRUE(manager.IsActive(ola::OLA_PLUGIN_ARTNET));
+  OLA_ASSERT_FALSE(manager.IsEnabled(ola::OLA_PLUGIN_ESPNET));
+  OLA_ASSERT_TRUE(loader.Plugin(0)->IsCreated());
+  OLA_ASSERT_FALSE(loader.Plugin(1)->IsCreated());
+
+  // The running ArtNet plugin conflicts with EspNet.
+  OLA_ASSERT_FALSE(manager.EnableAndStartPlugin(ola::OLA_PLUGIN_ESPNET));
+  OLA_ASSERT_TRUE(manager.IsEnabled(ola::OLA_PLUGIN_ESPNET));
+  OLA_ASSERT_FALSE(loader.Plugin(1)->IsCreated());
+
+  manager.DisableAndStopPlugin(ola::OLA_PLUGIN_ARTNET);
+  OLA_ASSERT_FALSE(manager.IsActive(ola::OLA_PLUGIN_ARTNET));
+  OLA_ASSERT_TRUE(manager.EnableAndStartPlugin(ola::OLA_PLUGIN_ESPNET));
+  OLA_ASSERT_TRUE(manager.IsActive(ola::OLA_PLUGIN_ESPNET));
+  OLA_ASSERT_TRUE(loader.Plugin(1)->IsCreated());
+
+  manager.UnloadAll();
+}
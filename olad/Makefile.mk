@@ -15,14 +15,20 @@ ola_server_sources = \
     olad/DiscoveryAgent.h \
     olad/DynamicPluginLoader.cpp \
     olad/DynamicPluginLoader.h \
+    olad/HotStandby.cpp \
+    olad/HotStandby.h \
     olad/HttpServerActions.h \
+    olad/LazyPlugin.cpp \
+    olad/LazyPlugin.h \
     olad/OlaServerServiceImpl.cpp \
     olad/OlaServerServiceImpl.h \
     olad/OladHTTPServer.h \
     olad/PluginLoader.h \
     olad/PluginManager.cpp \
     olad/PluginManager.h \
-    olad/RDMHTTPModule.h
+    olad/RDMHTTPModule.h \
+    olad/RDMPoller.cpp \
+    olad/RDMPoller.h
 ola_server_additional_libs =
 
 if HAVE_DNSSD
@@ -87,8 +93,11 @@ COMMON_OLAD_TEST_LDADD = $(COMMON_TESTING_LIBS) $(libprotobuf_LIBS) \
                          common/libolacommon.la
 
 olad_OlaTester_SOURCES = \
+    olad/ClientBrokerTest.cpp \
+    olad/LazyPluginTest.cpp \
     olad/PluginManagerTest.cpp \
-    olad/OlaServerServiceImplTest.cpp
+    olad/OlaServerServiceImplTest.cpp \
+    olad/RDMPollerTest.cpp
 olad_OlaTester_CXXFLAGS = $(COMMON_TESTING_PROTOBUF_FLAGS)
 olad_OlaTester_LDADD = $(COMMON_OLAD_TEST_LDADD)
 
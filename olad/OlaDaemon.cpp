@@ -32,14 +32,17 @@
 #include <Shlobj.h>
 #endif  // _WIN32
 #include <string>
+#include <vector>
 
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
+#include "ola/base/Array.h"
 #include "ola/base/Credentials.h"
 #include "ola/base/Flags.h"
 #include "ola/file/Util.h"
 #include "ola/network/SocketAddress.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/thread/ThreadSettings.h"
 
 #include "olad/DynamicPluginLoader.h"
 #include "olad/OlaDaemon.h"
@@ -63,6 +66,7 @@ using std::string;
 
 const char OlaDaemon::OLA_CONFIG_DIR[] = ".ola";
 const char OlaDaemon::CONFIG_DIR_KEY[] = "config-dir";
+const char OlaDaemon::THREADS_PREFERENCES[] = "threads";
 const char OlaDaemon::UID_KEY[] = "uid";
 const char OlaDaemon::GID_KEY[] = "gid";
 const char OlaDaemon::USER_NAME_KEY[] = "user";
@@ -122,6 +126,10 @@ bool OlaDaemon::Init() {
   if (m_export_map) {
     m_export_map->GetStringVar(CONFIG_DIR_KEY)->Set(config_dir);
   }
+
+  // This must happen before any threads are started, including the
+  // preference saver thread.
+  LoadThreadSettings(config_dir);
   auto_ptr<PreferencesFactory> preferences_factory(
       new FileBackedPreferencesFactory(config_dir));
 
@@ -189,6 +197,45 @@ string OlaDaemon::DefaultConfigDir() {
   }
 }
 
+/*
+ * Load the CPU affinity & scheduling settings for each class of thread from
+ * ola-threads.conf, e.g.
+ *   output_cpus = 2,3
+ *   output_policy = fifo
+ *   output_priority = 50
+ */
+void OlaDaemon::LoadThreadSettings(const string &config_dir) {
+  FileBackedPreferences preferences(config_dir, THREADS_PREFERENCES, NULL);
+  if (!preferences.Load()) {
+    return;
+  }
+
+  const char *thread_classes[] = {
+    ola::thread::THREAD_CLASS_OUTPUT,
+    ola::thread::THREAD_CLASS_USB,
+    ola::thread::THREAD_CLASS_HTTP,
+    ola::thread::THREAD_CLASS_PREFERENCES,
+  };
+
+  for (unsigned int i = 0; i < arraysize(thread_classes); i++) {
+    const string thread_class = thread_classes[i];
+    const string cpus = preferences.GetValue(thread_class + "_cpus");
+    const string policy = preferences.GetValue(thread_class + "_policy");
+    const string priority = preferences.GetValue(thread_class + "_priority");
+    if (cpus.empty() && policy.empty() && priority.empty()) {
+      continue;
+    }
+
+    ola::thread::ThreadSettings settings;
+    if (ola::thread::ParseThreadSettings(cpus, policy, priority, &settings)) {
+      ola::thread::SetThreadClassSettings(thread_class, settings);
+    } else {
+      OLA_WARN << "Ignoring invalid settings for " << thread_class
+               << " threads";
+    }
+  }
+}
+
 /*
  * Create the config dir if it doesn't exist. This doesn't create parent
  * directories.
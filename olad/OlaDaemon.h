@@ -98,9 +98,11 @@ class OlaDaemon {
 
   std::string DefaultConfigDir();
   bool InitConfigDir(const std::string &path);
+  void LoadThreadSettings(const std::string &config_dir);
 
   static const char OLA_CONFIG_DIR[];
   static const char CONFIG_DIR_KEY[];
+  static const char THREADS_PREFERENCES[];
   static const char UID_KEY[];
   static const char USER_NAME_KEY[];
   static const char GID_KEY[];
@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -38,13 +39,19 @@
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
+#include "ola/dmx/SharedMemoryFrames.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/InterfaceCache.h"
 #include "ola/network/InterfacePicker.h"
 #include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
 #include "ola/rdm/PidStore.h"
 #include "ola/rdm/UID.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
 #include "olad/ClientBroker.h"
 #include "olad/DiscoveryAgent.h"
+#include "olad/HotStandby.h"
 #include "olad/OlaServer.h"
 #include "olad/OlaServerServiceImpl.h"
 #include "olad/Plugin.h"
@@ -53,10 +60,17 @@
 #include "olad/Port.h"
 #include "olad/PortBroker.h"
 #include "olad/Preferences.h"
+#include "olad/RDMPoller.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/DiscoveryScheduler.h"
 #include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/OutputRateLimiter.h"
+#include "olad/plugin_api/OutputScheduler.h"
+#include "olad/plugin_api/RDMResponseCache.h"
+#include "olad/plugin_api/TimeCodeScheduler.h"
+#include "olad/plugin_api/UniversePublisher.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 #ifdef HAVE_LIBMICROHTTPD
@@ -67,9 +81,67 @@ DEFINE_s_uint16(rpc_port, r, ola::OlaServer::DEFAULT_RPC_PORT,
                 "The port to listen for RPCs on. Defaults to 9010.");
 DEFINE_default_bool(register_with_dns_sd, true,
                     "Don't register the web service using DNS-SD (Bonjour).");
+DEFINE_uint16(output_frame_rate, 0,
+              "If non-0, align the output of all universes to a frame clock "
+              "running at this many frames per second.");
+DEFINE_uint16(output_keepalive, 0,
+              "If non-0, don't send unchanged DMX data to the outputs until "
+              "this many ms have passed since it was last sent.");
+DEFINE_uint8(universe_merge_threads, 0,
+             "If non-0, and --output-frame-rate is set, merge the sources of "
+             "universes using this many threads.");
+DEFINE_uint16(rdm_discovery_concurrency, 0,
+              "If non-0, limit the number of ports running RDM discovery at "
+              "once.");
+DEFINE_uint16(rdm_discovery_jitter_ms, 0,
+              "If non-0, delay the start of RDM discovery on each port by a "
+              "random amount up to this many ms.");
+DEFINE_bool(rdm_response_cache, false,
+            "Answer RDM GETs for PIDs that rarely change, like "
+            "DEVICE_MODEL_DESCRIPTION, from a cache.");
+DEFINE_bool(http_epoll, false,
+            "Use epoll for the HTTP server connections, this removes the "
+            "limit of 1024 open connections.");
+DEFINE_uint16(http_connection_timeout, 0,
+              "Close idle HTTP connections after this many seconds, 0 keeps "
+              "them open.");
+DEFINE_uint16(shared_memory_poll_ms, 0,
+              "If non-0, allow local clients to send DMX data through shared "
+              "memory, which is read every this many ms.");
+DEFINE_string(publish_universes, "",
+              "If set, publish the output of every universe to the shared "
+              "memory segment with this name, which must start with "
+              "/ola-dmx-. Local readers can map it rather than registering "
+              "for DMX.");
+DEFINE_string(rpc_socket, "",
+              "If set, also accept RPC clients on a unix domain socket at this "
+              "path. The socket can be used by the user and group olad runs "
+              "as.");
+DEFINE_uint16(client_high_watermark, 128,
+              "Once a client has this many DMX updates outstanding, only the "
+              "latest frame for each universe is kept. 0 disables this.");
+DEFINE_uint16(client_low_watermark, 32,
+              "Resume sending DMX updates to a slow client once it has this "
+              "many updates outstanding.");
+DEFINE_uint16(timecode_freewheel_ms, 0,
+              "If non-0, generate timecode locally between the updates from "
+              "clients, for up to this many ms after the last update.");
+DEFINE_uint16(rdm_poll_interval_ms, ola::RDMPoller::DEFAULT_MIN_INTERVAL_MS,
+              "The minimum time between the RDM GETs olad polls for clients "
+              "on each universe.");
+DEFINE_string(standby_of, "",
+              "Run as a hot standby for the olad with this ip[:port]. The "
+              "outputs are held until the primary fails.");
+DEFINE_uint16(standby_heartbeat_ms,
+              ola::HotStandby::DEFAULT_HEARTBEAT_INTERVAL_MS,
+              "How often the standby polls the primary, it takes over if "
+              "there's no reply within 2.5 times this.");
 
 namespace ola {
 
+using ola::dmx::SharedMemoryFrames;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
 using ola::proto::OlaClientService_Stub;
 using ola::rdm::RootPidStore;
 using ola::rpc::RpcChannel;
@@ -77,6 +149,7 @@ using ola::rpc::RpcSession;
 using ola::rpc::RpcServer;
 using std::auto_ptr;
 using std::pair;
+using std::string;
 using std::vector;
 
 const char OlaServer::INSTANCE_NAME_KEY[] = "instance-name";
@@ -101,9 +174,11 @@ OlaServer::OlaServer(const vector<PluginLoader*> &plugin_loaders,
       m_accepting_socket(socket),
       m_export_map(export_map),
       m_default_uid(OPEN_LIGHTING_ESTA_CODE, 0),
+      m_loop_clock(select_server->WakeUpTime()),
       m_server_preferences(NULL),
       m_universe_preferences(NULL),
-      m_housekeeping_timeout(ola::thread::INVALID_TIMEOUT) {
+      m_housekeeping_timeout(ola::thread::INVALID_TIMEOUT),
+      m_shared_memory_timeout(ola::thread::INVALID_TIMEOUT) {
   if (!m_export_map) {
     m_our_export_map.reset(new ExportMap());
     m_export_map = m_our_export_map.get();
@@ -123,11 +198,17 @@ OlaServer::~OlaServer() {
   // Order is important during shutdown.
   // Shutdown the RPC server first since it depends on almost everything else.
   m_rpc_server.reset();
+  m_hot_standby.reset();
+  m_timecode_scheduler.reset();
 
   if (m_housekeeping_timeout != ola::thread::INVALID_TIMEOUT) {
     m_ss->RemoveTimeout(m_housekeeping_timeout);
   }
 
+  if (m_shared_memory_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_shared_memory_timeout);
+  }
+
   StopPlugins();
 
   m_broker.reset();
@@ -137,6 +218,13 @@ OlaServer::~OlaServer() {
     m_universe_store->DeleteAll();
     m_universe_store.reset();
   }
+  // This must outlive the RDM requests sent to the universes.
+  m_rdm_poller.reset();
+  m_output_scheduler.reset();
+  m_discovery_scheduler.reset();
+  m_rdm_response_cache.reset();
+  m_rate_limiter.reset();
+  m_universe_publisher.reset();
 
   if (m_server_preferences) {
     m_server_preferences->Save();
@@ -151,6 +239,7 @@ OlaServer::~OlaServer() {
   m_device_manager.reset();
   m_plugin_manager.reset();
   m_service_impl.reset();
+  m_interface_cache.reset();
 }
 
 bool OlaServer::Init() {
@@ -177,6 +266,11 @@ bool OlaServer::Init() {
   signal(SIGPIPE, SIG_IGN);
 #endif  // _WIN32
 
+  // Share one list of interfaces between the server and the plugins.
+  m_interface_cache.reset(new ola::network::InterfaceCache());
+  m_interface_cache->Watch(m_ss);
+  ola::network::InterfaceCache::Install(m_interface_cache.get());
+
   // fetch the interface info
   ola::network::Interface iface;
   {
@@ -209,8 +303,65 @@ bool OlaServer::Init() {
       UNIVERSE_PREFERENCES);
   universe_preferences->Load();
 
+  auto_ptr<OutputScheduler> output_scheduler(new OutputScheduler(m_ss));
+  if (FLAGS_output_frame_rate) {
+    output_scheduler->SetFrameInterval(
+        TimeInterval(static_cast<int64_t>(USEC_IN_SECONDS /
+                                          FLAGS_output_frame_rate)));
+    OLA_INFO << "Universe output is aligned to a " << FLAGS_output_frame_rate
+             << " fps frame clock";
+  }
+
+  if (FLAGS_universe_merge_threads) {
+    if (!FLAGS_output_frame_rate) {
+      OLA_WARN << "--universe-merge-threads requires --output-frame-rate";
+    } else if (output_scheduler->StartMergeThreads(
+                   FLAGS_universe_merge_threads)) {
+      OLA_INFO << "Merging universes using "
+               << static_cast<int>(FLAGS_universe_merge_threads)
+               << " threads";
+    }
+  }
+
   auto_ptr<UniverseStore> universe_store(
       new UniverseStore(universe_preferences, m_export_map));
+  universe_store->SetOutputScheduler(output_scheduler.get());
+  universe_store->SetLoopClock(&m_loop_clock);
+
+  auto_ptr<DiscoveryScheduler> discovery_scheduler(
+      new DiscoveryScheduler(m_ss, m_export_map));
+  discovery_scheduler->SetMaxConcurrent(FLAGS_rdm_discovery_concurrency);
+  discovery_scheduler->SetJitter(FLAGS_rdm_discovery_jitter_ms);
+  universe_store->SetDiscoveryScheduler(discovery_scheduler.get());
+
+  auto_ptr<RDMResponseCache> rdm_response_cache;
+  if (FLAGS_rdm_response_cache) {
+    rdm_response_cache.reset(new RDMResponseCache(m_export_map,
+                                                  &m_loop_clock));
+    universe_store->SetRDMResponseCache(rdm_response_cache.get());
+  }
+  auto_ptr<OutputRateLimiter> rate_limiter(
+      new OutputRateLimiter(m_ss, m_export_map, &m_loop_clock));
+  universe_store->SetOutputRateLimiter(rate_limiter.get());
+
+  auto_ptr<UniversePublisher> universe_publisher;
+  if (!FLAGS_publish_universes.str().empty()) {
+    // Replace any segment left behind by a previous olad.
+    SharedMemoryFrames *frames = SharedMemoryFrames::Create(
+        FLAGS_publish_universes.str(), SharedMemoryFrames::MAX_SLOTS, true);
+    if (!frames) {
+      return false;
+    }
+    universe_publisher.reset(
+        new UniversePublisher(m_ss, frames, m_export_map));
+    universe_store->SetUniversePublisher(universe_publisher.get());
+    OLA_INFO << "Publishing universes to " << universe_publisher->Name();
+  }
+
+  if (FLAGS_output_keepalive) {
+    universe_store->SetOutputKeepalive(TimeInterval(
+        static_cast<int64_t>(FLAGS_output_keepalive) * ONE_THOUSAND));
+  }
 
   auto_ptr<PortBroker> port_broker(new PortBroker());
 
@@ -222,6 +373,16 @@ bool OlaServer::Init() {
   auto_ptr<DeviceManager> device_manager(
       new DeviceManager(m_preferences_factory, port_manager.get()));
 
+  auto_ptr<TimeCodeScheduler> timecode_scheduler;
+  if (FLAGS_timecode_freewheel_ms) {
+    timecode_scheduler.reset(new TimeCodeScheduler(
+        m_ss,
+        NewCallback(device_manager.get(), &DeviceManager::SendTimeCode),
+        m_export_map));
+    timecode_scheduler->SetFreewheelTime(TimeInterval(
+        static_cast<int64_t>(FLAGS_timecode_freewheel_ms) * ONE_THOUSAND));
+  }
+
   auto_ptr<PluginAdaptor> plugin_adaptor(
       new PluginAdaptor(device_manager.get(), m_ss, m_export_map,
                         m_preferences_factory, port_broker.get(),
@@ -238,12 +399,22 @@ bool OlaServer::Init() {
       broker.get(),
       m_ss->WakeUpTime(),
       NewCallback(this, &OlaServer::ReloadPluginsInternal)));
+  service_impl->SetTimeCodeScheduler(timecode_scheduler.get());
+
+  auto_ptr<RDMPoller> rdm_poller(new RDMPoller(
+      m_ss, NewCallback(this, &OlaServer::SendRDMPollRequest),
+      m_default_uid, m_export_map));
+  rdm_poller->SetMinimumInterval(TimeInterval(
+      static_cast<int64_t>(FLAGS_rdm_poll_interval_ms) * ONE_THOUSAND));
+  service_impl->SetRDMPoller(rdm_poller.get());
 
   // Initialize the RPC server.
   RpcServer::Options rpc_options;
   rpc_options.listen_socket = m_accepting_socket;
   rpc_options.listen_port = FLAGS_rpc_port;
   rpc_options.export_map = m_export_map;
+  rpc_options.coalesce_writes = true;
+  rpc_options.unix_socket_path = FLAGS_rpc_socket.str();
 
   auto_ptr<ola::rpc::RpcServer> rpc_server(
       new RpcServer(m_ss, service_impl.get(), this, rpc_options));
@@ -304,10 +475,33 @@ bool OlaServer::Init() {
   m_port_manager.reset(port_manager.release());
   m_rpc_server.reset(rpc_server.release());
   m_service_impl.reset(service_impl.release());
+  m_output_scheduler.reset(output_scheduler.release());
+  m_discovery_scheduler.reset(discovery_scheduler.release());
+  m_timecode_scheduler.reset(timecode_scheduler.release());
+  m_rdm_poller.reset(rdm_poller.release());
+  m_rdm_response_cache.reset(rdm_response_cache.release());
+  m_rate_limiter.reset(rate_limiter.release());
+  m_universe_publisher.reset(universe_publisher.release());
   m_universe_store.reset(universe_store.release());
 
   UpdatePidStore(pid_store.release());
 
+  if (!FLAGS_standby_of.str().empty() && !m_hot_standby.get()) {
+    HotStandby::Options standby_options;
+    if (!ParsePrimaryAddress(FLAGS_standby_of.str(),
+                             &standby_options.primary)) {
+      OLA_WARN << "Invalid --standby-of address " << FLAGS_standby_of.str();
+      return false;
+    }
+    if (FLAGS_standby_heartbeat_ms) {
+      standby_options.heartbeat_interval = TimeInterval(
+          static_cast<int64_t>(FLAGS_standby_heartbeat_ms) * ONE_THOUSAND);
+    }
+    m_hot_standby.reset(new HotStandby(m_ss, m_universe_store.get(),
+                                       m_export_map, standby_options));
+    m_hot_standby->Start();
+  }
+
   if (m_housekeeping_timeout != ola::thread::INVALID_TIMEOUT) {
     m_ss->RemoveTimeout(m_housekeeping_timeout);
   }
@@ -316,9 +510,23 @@ bool OlaServer::Init() {
       K_HOUSEKEEPING_TIMEOUT_MS,
       ola::NewCallback(this, &OlaServer::RunHousekeeping));
 
-  // The plugin load procedure can take a while so we run it in the main loop.
+  if (FLAGS_shared_memory_poll_ms) {
+    if (m_shared_memory_timeout != ola::thread::INVALID_TIMEOUT) {
+      m_ss->RemoveTimeout(m_shared_memory_timeout);
+    }
+    m_service_impl->EnableSharedMemory();
+    m_shared_memory_timeout = m_ss->RegisterRepeatingTimeout(
+        FLAGS_shared_memory_poll_ms,
+        ola::NewCallback(this, &OlaServer::PollSharedMemory));
+    OLA_INFO << "Reading shared memory DMX data every "
+             << FLAGS_shared_memory_poll_ms << "ms";
+  }
+
+  // Starting the plugins can take a while, so they're started one at a time
+  // from the main loop. This lets clients connect while slow plugins start.
   m_ss->Execute(
-      ola::NewSingleCallback(m_plugin_manager.get(), &PluginManager::LoadAll));
+      ola::NewSingleCallback(m_plugin_manager.get(),
+                             &PluginManager::LoadAllIncrementally));
 
   return true;
 }
@@ -357,6 +565,11 @@ ola::network::GenericSocketAddress OlaServer::LocalRPCAddress() const {
 void OlaServer::NewClient(RpcSession *session) {
   OlaClientService_Stub *stub = new OlaClientService_Stub(session->Channel());
   Client *client = new Client(stub, m_default_uid);
+  client->SetWatermarks(FLAGS_client_high_watermark,
+                        FLAGS_client_low_watermark);
+  client->ExportStats(m_export_map,
+                      ola::strings::IntToString(m_client_ids.Next()));
+  client->SetScheduler(m_ss, m_ss->WakeUpTime());
   session->SetData(static_cast<void*>(client));
   m_broker->AddClient(client);
 }
@@ -366,6 +579,7 @@ void OlaServer::ClientRemoved(RpcSession *session) {
   session->SetData(NULL);
 
   m_broker->RemoveClient(client.get());
+  m_service_impl->ClientRemoved(client.get());
 
   vector<Universe*> universe_list;
   m_universe_store->GetList(&universe_list);
@@ -375,15 +589,31 @@ void OlaServer::ClientRemoved(RpcSession *session) {
        uni_iter != universe_list.end(); ++uni_iter) {
     (*uni_iter)->RemoveSourceClient(client.get());
     (*uni_iter)->RemoveSinkClient(client.get());
+    (*uni_iter)->RemoveSlotSubscription(client.get());
   }
 }
 
+/*
+ * Pick up new DMX data from the clients using shared memory.
+ */
+bool OlaServer::PollSharedMemory() {
+  m_service_impl->PollSharedMemory();
+  return true;
+}
+
 /*
  * Run the garbage collector
  */
 bool OlaServer::RunHousekeeping() {
   OLA_DEBUG << "Garbage collecting";
   m_universe_store->GarbageCollectUniverses();
+  m_universe_store->CleanStaleSourceClients();
+  m_universe_store->ReleaseIdleBuffers();
+
+  // A standby doesn't run discovery, the UIDs are mirrored from the primary.
+  if (m_hot_standby.get() && !m_hot_standby->IsActive()) {
+    return true;
+  }
 
   // Give the universes an opportunity to run discovery
   vector<Universe*> universes;
@@ -392,17 +622,28 @@ bool OlaServer::RunHousekeeping() {
   vector<Universe*>::iterator iter = universes.begin();
   const TimeStamp *now = m_ss->WakeUpTime();
   for (; iter != universes.end(); ++iter) {
-    (*iter)->CleanStaleSourceClients();
     if ((*iter)->IsActive() &&
         (*iter)->RDMDiscoveryInterval().Seconds() &&
         *now - (*iter)->LastRDMDiscovery() > (*iter)->RDMDiscoveryInterval()) {
-      // run incremental discovery
-      (*iter)->RunRDMDiscovery(NULL, false);
+      // Discovery can generate a burst of RDM traffic, so it's run as bulk
+      // work.
+      m_ss->ExecuteBulk(NewSingleCallback(
+          this, &OlaServer::RunIncrementalDiscovery, (*iter)->UniverseId()));
     }
   }
   return true;
 }
 
+/*
+ * Run incremental discovery on a universe, if it still exists.
+ */
+void OlaServer::RunIncrementalDiscovery(unsigned int universe_id) {
+  Universe *universe = m_universe_store->GetUniverse(universe_id);
+  if (universe && universe->IsActive()) {
+    universe->RunRDMDiscovery(NULL, false);
+  }
+}
+
 #ifdef HAVE_LIBMICROHTTPD
 bool OlaServer::StartHttpServer(ola::rpc::RpcServer *server,
                                 const ola::network::Interface &iface) {
@@ -424,6 +665,8 @@ bool OlaServer::StartHttpServer(ola::rpc::RpcServer *server,
   options.data_dir = (m_options.http_data_dir.empty() ? HTTP_DATA_DIR :
                       m_options.http_data_dir);
   options.enable_quit = m_options.http_enable_quit;
+  options.use_epoll = FLAGS_http_epoll;
+  options.connection_timeout = FLAGS_http_connection_timeout;
 
   auto_ptr<OladHTTPServer> httpd(
       new OladHTTPServer(m_export_map, options,
@@ -471,10 +714,43 @@ bool OlaServer::InternalNewConnection(
   }
 }
 
+/*
+ * Send a request from the RDMPoller.
+ */
+void OlaServer::SendRDMPollRequest(unsigned int universe_id,
+                                   ola::rdm::RDMRequest *request,
+                                   ola::rdm::RDMCallback *callback) {
+  Universe *universe = m_universe_store->GetUniverse(universe_id);
+  if (!universe) {
+    delete request;
+    ola::rdm::RunRDMCallback(callback, ola::rdm::RDM_FAILED_TO_SEND);
+    return;
+  }
+  universe->SendRDMRequest(request, callback);
+}
+
 void OlaServer::ReloadPluginsInternal() {
   OLA_INFO << "Reloading plugins";
   StopPlugins();
-  m_plugin_manager->LoadAll();
+  // In case we're not notified of interface changes on this platform.
+  m_interface_cache->Invalidate();
+  m_plugin_manager->LoadAllIncrementally();
+}
+
+/*
+ * Parse the ip[:port] of the primary olad, the port defaults to the RPC port.
+ */
+bool OlaServer::ParsePrimaryAddress(const string &address,
+                                    IPV4SocketAddress *primary) {
+  if (IPV4SocketAddress::FromString(address, primary)) {
+    return true;
+  }
+  IPV4Address ip;
+  if (!IPV4Address::FromString(address, &ip)) {
+    return false;
+  }
+  *primary = IPV4SocketAddress(ip, DEFAULT_RPC_PORT);
+  return true;
 }
 
 void OlaServer::UpdatePidStore(const RootPidStore *pid_store) {
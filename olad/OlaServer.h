@@ -25,17 +25,21 @@
 #include <config.h>
 #endif  // HAVE_CONFIG_H
 
+#include <ola/Clock.h>
 #include <ola/Constants.h>
 #include <ola/ExportMap.h>
 #include <ola/base/Macro.h>
 #include <ola/io/SelectServer.h>
+#include <ola/network/InterfaceCache.h>
 #include <ola/network/InterfacePicker.h>
 #include <ola/network/Socket.h>
 #include <ola/network/TCPSocketFactory.h>
 #include <ola/plugin_id.h>
 #include <ola/rdm/PidStore.h>
+#include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/UID.h>
 #include <ola/rpc/RpcSessionHandler.h>
+#include <ola/util/SequenceNumber.h>
 
 #include <map>
 #include <memory>
@@ -180,11 +184,22 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
 
   std::auto_ptr<class ExportMap> m_our_export_map;
   ola::rdm::UID m_default_uid;
+  // The time the SelectServer last woke up, for the hot paths which can
+  // tolerate a slightly stale time.
+  CachedClock m_loop_clock;
 
   // These are all populated in Init.
+  std::auto_ptr<ola::network::InterfaceCache> m_interface_cache;
   std::auto_ptr<class DeviceManager> m_device_manager;
   std::auto_ptr<class PluginManager> m_plugin_manager;
   std::auto_ptr<class PluginAdaptor> m_plugin_adaptor;
+  std::auto_ptr<class OutputScheduler> m_output_scheduler;
+  std::auto_ptr<class DiscoveryScheduler> m_discovery_scheduler;
+  std::auto_ptr<class TimeCodeScheduler> m_timecode_scheduler;
+  std::auto_ptr<class RDMPoller> m_rdm_poller;
+  std::auto_ptr<class RDMResponseCache> m_rdm_response_cache;
+  std::auto_ptr<class OutputRateLimiter> m_rate_limiter;
+  std::auto_ptr<class UniversePublisher> m_universe_publisher;
   std::auto_ptr<class UniverseStore> m_universe_store;
   std::auto_ptr<class PortManager> m_port_manager;
   std::auto_ptr<class OlaServerServiceImpl> m_service_impl;
@@ -193,14 +208,20 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   std::auto_ptr<const ola::rdm::RootPidStore> m_pid_store;
   std::auto_ptr<class DiscoveryAgentInterface> m_discovery_agent;
   std::auto_ptr<ola::rpc::RpcServer> m_rpc_server;
+  std::auto_ptr<class HotStandby> m_hot_standby;
   class Preferences *m_server_preferences;
   class Preferences *m_universe_preferences;
   std::string m_instance_name;
+  // Used to identify clients in the ExportMap.
+  SequenceNumber<unsigned int> m_client_ids;
 
   ola::thread::timeout_id m_housekeeping_timeout;
+  ola::thread::timeout_id m_shared_memory_timeout;
   std::auto_ptr<OladHTTPServer_t> m_httpd;
 
   bool RunHousekeeping();
+  void RunIncrementalDiscovery(unsigned int universe_id);
+  bool PollSharedMemory();
 
 #ifdef HAVE_LIBMICROHTTPD
   bool StartHttpServer(ola::rpc::RpcServer *server,
@@ -213,10 +234,15 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   bool InternalNewConnection(ola::rpc::RpcServer *server,
                              ola::io::ConnectedDescriptor *descriptor);
   void ReloadPluginsInternal();
+  void SendRDMPollRequest(unsigned int universe_id,
+                          ola::rdm::RDMRequest *request,
+                          ola::rdm::RDMCallback *callback);
   /**
    * @brief Update the Pid store with the new values.
    */
   void UpdatePidStore(const ola::rdm::RootPidStore *pid_store);
+  static bool ParsePrimaryAddress(const std::string &address,
+                                  ola::network::IPV4SocketAddress *primary);
 
   static const char INSTANCE_NAME_KEY[];
   static const char K_INSTANCE_NAME_VAR[];
@@ -20,15 +20,22 @@
  */
 
 #include <algorithm>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include "common/protocol/Ola.pb.h"
 #include "common/rpc/RpcSession.h"
+#include "common/rpc/WireReader.h"
 #include "ola/Callback.h"
 #include "ola/CallbackRunner.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/dmx/PixelMap.h"
+#include "ola/dmx/SharedMemoryFrames.h"
 #include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMCommandSerializer.h"
 #include "ola/rdm/UIDSet.h"
 #include "ola/strings/Format.h"
 #include "ola/timecode/TimeCode.h"
@@ -40,15 +47,19 @@
 #include "olad/Plugin.h"
 #include "olad/PluginManager.h"
 #include "olad/Port.h"
+#include "olad/RDMPoller.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
 #include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/TimeCodeScheduler.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 namespace ola {
 
 using ola::CallbackRunner;
+using ola::dmx::PixelMap;
+using ola::dmx::SharedMemoryFrames;
 using ola::proto::Ack;
 using ola::proto::DeviceConfigReply;
 using ola::proto::DeviceConfigRequest;
@@ -56,9 +67,17 @@ using ola::proto::DeviceInfo;
 using ola::proto::DeviceInfoReply;
 using ola::proto::DeviceInfoRequest;
 using ola::proto::DmxData;
+using ola::proto::DmxDataBatch;
+using ola::proto::DmxSnapshot;
+using ola::proto::DmxUpdate;
 using ola::proto::MergeModeRequest;
+using ola::proto::MultiUniverseRequest;
 using ola::proto::OptionalUniverseRequest;
 using ola::proto::PatchPortRequest;
+using ola::proto::PatchPortsRequest;
+using ola::proto::PixelFrame;
+using ola::proto::PixelLayout;
+using ola::proto::PixelRun;
 using ola::proto::PluginDescriptionReply;
 using ola::proto::PluginDescriptionRequest;
 using ola::proto::PluginInfo;
@@ -66,15 +85,20 @@ using ola::proto::PluginListReply;
 using ola::proto::PluginListRequest;
 using ola::proto::PortInfo;
 using ola::proto::RegisterDmxRequest;
+using ola::proto::SharedMemoryRequest;
+using ola::proto::SlotSubscriptionRequest;
 using ola::proto::UniverseInfo;
 using ola::proto::UniverseInfoReply;
+using ola::proto::UniverseLayersRequest;
 using ola::proto::UniverseNameRequest;
 using ola::proto::UniverseRequest;
+using ola::proto::UniverseStatsReply;
 using ola::rdm::RDMRequest;
 using ola::rdm::RDMResponse;
 using ola::rdm::UID;
 using ola::rdm::UIDSet;
 using ola::rpc::RpcController;
+using std::set;
 using std::string;
 using std::vector;
 
@@ -106,6 +130,47 @@ RDMRequest::OverrideOptions RDMRequestOptionsFromProto(
   }
   return options;
 }
+
+/*
+ * Build a GET or SET RDMRequest from a proto::RDMRequest.
+ */
+RDMRequest *RDMRequestFromProto(const UID &source_uid,
+                                const ola::proto::RDMRequest &request) {
+  UID destination(request.uid().esta_id(), request.uid().device_id());
+  RDMRequest::OverrideOptions options = RDMRequestOptionsFromProto(request);
+
+  if (request.is_set()) {
+    return new ola::rdm::RDMSetRequest(
+        source_uid,
+        destination,
+        0,  // transaction #
+        1,  // port id
+        request.sub_device(),
+        request.param_id(),
+        reinterpret_cast<const uint8_t*>(request.data().data()),
+        request.data().size(),
+        options);
+  } else {
+    return new ola::rdm::RDMGetRequest(
+        source_uid,
+        destination,
+        0,  // transaction #
+        1,  // port id
+        request.sub_device(),
+        request.param_id(),
+        reinterpret_cast<const uint8_t*>(request.data().data()),
+        request.data().size(),
+        options);
+  }
+}
+
+uint8_t ClampPriority(int priority) {
+  priority = std::max(static_cast<int>(ola::dmx::SOURCE_PRIORITY_MIN),
+                      priority);
+  priority = std::min(static_cast<int>(ola::dmx::SOURCE_PRIORITY_MAX),
+                      priority);
+  return static_cast<uint8_t>(priority);
+}
 }  // namespace
 
 typedef CallbackRunner<ola::rpc::RpcService::CompletionCallback> ClosureRunner;
@@ -124,7 +189,64 @@ OlaServerServiceImpl::OlaServerServiceImpl(
       m_port_manager(port_manager),
       m_broker(broker),
       m_wake_up_time(wake_up_time),
-      m_reload_plugins_callback(reload_plugins_callback) {
+      m_timecode_scheduler(NULL),
+      m_rdm_poller(NULL),
+      m_reload_plugins_callback(reload_plugins_callback),
+      m_shared_memory_enabled(false),
+      m_stream_dmx_method(descriptor()->FindMethodByName("StreamDmxData")) {
+}
+
+void OlaServerServiceImpl::PollSharedMemory() {
+  SharedMemoryFrames::Frame frame;
+  set<Client*>::iterator iter = m_shared_memory_clients.begin();
+  for (; iter != m_shared_memory_clients.end(); ++iter) {
+    Client *client = *iter;
+    SharedMemoryFrames *frames = client->SharedMemory();
+    for (unsigned int slot = 0; slot < frames->SlotCount(); slot++) {
+      if (!frames->Read(slot, &frame)) {
+        continue;
+      }
+
+      Universe *universe = m_universe_store->GetUniverse(frame.universe);
+      if (!universe) {
+        continue;
+      }
+
+      DmxSource source(frame.data, *m_wake_up_time,
+                       ClampPriority(frame.priority));
+      client->DMXReceived(frame.universe, source);
+      universe->SourceClientDataChanged(client);
+    }
+  }
+}
+
+OlaServerServiceImpl::~OlaServerServiceImpl() {
+  RDMBatchSet::iterator iter = m_rdm_batches.begin();
+  for (; iter != m_rdm_batches.end(); ++iter) {
+    delete (*iter)->done;
+    delete *iter;
+  }
+}
+
+void OlaServerServiceImpl::ClientRemoved(Client *client) {
+  m_shared_memory_clients.erase(client);
+  if (m_rdm_poller) {
+    m_rdm_poller->RemoveClient(client);
+  }
+
+  // The ClientBroker drops the outstanding RDM callbacks for the client, so
+  // the batches will never complete.
+  RDMBatchSet::iterator iter = m_rdm_batches.begin();
+  while (iter != m_rdm_batches.end()) {
+    RDMBatch *batch = *iter;
+    if (batch->client == client) {
+      delete batch->done;
+      delete batch;
+      m_rdm_batches.erase(iter++);
+    } else {
+      ++iter;
+    }
+  }
 }
 
 void OlaServerServiceImpl::GetDmx(
@@ -141,6 +263,69 @@ void OlaServerServiceImpl::GetDmx(
   const DmxBuffer buffer = universe->GetDMX();
   response->set_data(buffer.Get());
   response->set_universe(request->universe());
+  if (universe->GetSlotPriorities().Size()) {
+    response->set_slot_priorities(universe->GetSlotPriorities().Get());
+  }
+}
+
+void OlaServerServiceImpl::GetDmxMulti(
+    RpcController*,
+    const MultiUniverseRequest* request,
+    DmxSnapshot* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  vector<Universe*> universes;
+  RequestedUniverses(*request, &universes);
+
+  if (request->packed()) {
+    string *packed_data = response->mutable_packed_data();
+    vector<Universe*>::const_iterator iter = universes.begin();
+    for (; iter != universes.end(); ++iter) {
+      const DmxBuffer &buffer = (*iter)->GetDMX();
+      response->add_universe((*iter)->UniverseId());
+      response->add_size(buffer.Size());
+      packed_data->append(reinterpret_cast<const char*>(buffer.GetRaw()),
+                          buffer.Size());
+    }
+    return;
+  }
+
+  vector<Universe*>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    DmxData *data = response->add_universe_data();
+    data->set_universe((*iter)->UniverseId());
+    data->set_data((*iter)->GetDMX().Get());
+    if ((*iter)->GetSlotPriorities().Size()) {
+      data->set_slot_priorities((*iter)->GetSlotPriorities().Get());
+    }
+  }
+}
+
+void OlaServerServiceImpl::GetUniverseStats(
+    RpcController*,
+    const MultiUniverseRequest* request,
+    UniverseStatsReply* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  vector<Universe*> universes;
+  RequestedUniverses(*request, &universes);
+
+  vector<Universe*>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    Universe::Stats stats;
+    (*iter)->GetStats(&stats);
+    ola::proto::UniverseStats *universe_stats = response->add_universe();
+    universe_stats->set_universe((*iter)->UniverseId());
+    universe_stats->set_frames(stats.frames);
+    universe_stats->set_merges(stats.merges);
+    universe_stats->set_input_ports(stats.input_ports);
+    universe_stats->set_source_clients(stats.source_clients);
+    universe_stats->set_active_sources(stats.active_sources);
+    universe_stats->set_latency_samples(stats.latency_samples);
+    universe_stats->set_latency_p50(stats.latency_p50);
+    universe_stats->set_latency_p99(stats.latency_p99);
+    universe_stats->set_latency_p999(stats.latency_p999);
+  }
 }
 
 void OlaServerServiceImpl::RegisterForDmx(
@@ -157,10 +342,64 @@ void OlaServerServiceImpl::RegisterForDmx(
 
   Client *client = GetClient(controller);
   if (request->action() == ola::proto::REGISTER) {
+    if (client) {
+      client->SetDeltaUpdates(request->universe(),
+                              request->has_delta() && request->delta());
+      client->SetRateLimit(request->universe(), request->max_rate(),
+                           request->min_change());
+    }
     universe->AddSinkClient(client);
   } else {
     universe->RemoveSinkClient(client);
+    if (client) {
+      client->SetDeltaUpdates(request->universe(), false);
+      client->SetRateLimit(request->universe(), 0, 0);
+    }
+  }
+}
+
+void OlaServerServiceImpl::SubscribeSlots(
+    RpcController* controller,
+    const SlotSubscriptionRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  Client *client = GetClient(controller);
+  if (request->action() == ola::proto::UNREGISTER) {
+    Universe *universe = m_universe_store->GetUniverse(request->universe());
+    if (universe) {
+      universe->RemoveSlotSubscription(client);
+    }
+    return;
+  }
+
+  if (!client || request->range_size() == 0) {
+    controller->SetFailed("No slots to watch");
+    return;
+  }
+
+  vector<Universe::SlotRange> ranges(request->range_size());
+  for (int i = 0; i < request->range_size(); i++) {
+    const ola::proto::SlotRange &proto_range = request->range(i);
+    if (proto_range.count() == 0 ||
+        proto_range.start() >= ola::DMX_UNIVERSE_SIZE ||
+        proto_range.count() > ola::DMX_UNIVERSE_SIZE - proto_range.start() ||
+        proto_range.threshold() == 0 ||
+        proto_range.threshold() > ola::DMX_MAX_SLOT_VALUE) {
+      controller->SetFailed("Invalid slot range " + IntToString(i));
+      return;
+    }
+    ranges[i].start = proto_range.start();
+    ranges[i].count = proto_range.count();
+    ranges[i].threshold = proto_range.threshold();
   }
+
+  Universe *universe = m_universe_store->GetUniverseOrCreate(
+      request->universe());
+  if (!universe) {
+    return MissingUniverseError(controller);
+  }
+  universe->AddSlotSubscription(client, ranges);
 }
 
 void OlaServerServiceImpl::UpdateDmxData(
@@ -180,15 +419,14 @@ void OlaServerServiceImpl::UpdateDmxData(
 
   uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
   if (request->has_priority()) {
-    priority = request->priority();
-    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
-                        priority);
-    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
-                        priority);
-  }
-  DmxSource source(buffer, *m_wake_up_time, priority);
-  client->DMXReceived(request->universe(), source);
-  universe->SourceClientDataChanged(client);
+    priority = ClampPriority(request->priority());
+  }
+  DmxBuffer slot_priorities;
+  if (request->has_slot_priorities()) {
+    SetSlotPriorities(request->slot_priorities(), &slot_priorities);
+  }
+  DmxSource source(buffer, *m_wake_up_time, priority, slot_priorities);
+  UpdateSourceClient(universe, client, request, source);
 }
 
 void OlaServerServiceImpl::StreamDmxData(
@@ -208,15 +446,247 @@ void OlaServerServiceImpl::StreamDmxData(
 
   uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
   if (request->has_priority()) {
-    priority = request->priority();
-    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
-                        priority);
-    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
-                        priority);
-  }
-  DmxSource source(buffer, *m_wake_up_time, priority);
-  client->DMXReceived(request->universe(), source);
+    priority = ClampPriority(request->priority());
+  }
+  DmxBuffer slot_priorities;
+  if (request->has_slot_priorities()) {
+    SetSlotPriorities(request->slot_priorities(), &slot_priorities);
+  }
+  DmxSource source(buffer, *m_wake_up_time, priority, slot_priorities);
+  UpdateSourceClient(universe, client, request, source);
+}
+
+bool OlaServerServiceImpl::CallStreamingMethod(
+    const google::protobuf::MethodDescriptor *method,
+    RpcController *controller,
+    const uint8_t *data,
+    unsigned int size) {
+  if (method != m_stream_dmx_method) {
+    return false;
+  }
+
+  // See DmxData in Ola.proto.
+  ola::rpc::WireReader reader(data, size);
+  ola::rpc::WireField field;
+  int32_t universe_id = 0;
+  bool has_universe = false;
+  const uint8_t *dmx = NULL;
+  unsigned int dmx_size = 0;
+  int32_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
+  while (reader.Next(&field)) {
+    if (field.number == 1 && field.type == ola::rpc::WireField::VARINT) {
+      universe_id = static_cast<int32_t>(field.value);
+      has_universe = true;
+    } else if (field.number == 2 &&
+               field.type == ola::rpc::WireField::LENGTH_DELIMITED) {
+      dmx = field.data;
+      dmx_size = field.size;
+    } else if (field.number == 3 &&
+               field.type == ola::rpc::WireField::VARINT) {
+      priority = static_cast<int32_t>(field.value);
+    } else {
+      return false;
+    }
+  }
+  if (reader.Failed() || !has_universe || !dmx) {
+    return false;
+  }
+
+  Universe *universe = m_universe_store->GetUniverse(universe_id);
+  if (!universe) {
+    return true;
+  }
+
+  Client *client = GetClient(controller);
+  DmxBuffer buffer(dmx, dmx_size);
+  DmxSource source(buffer, *m_wake_up_time, ClampPriority(priority));
+  client->DMXReceived(universe_id, source);
   universe->SourceClientDataChanged(client);
+  return true;
+}
+
+void OlaServerServiceImpl::StreamDmxDataBatch(
+    RpcController *controller,
+    const DmxDataBatch* request,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    ola::rpc::RpcService::CompletionCallback*) {
+  Client *client = GetClient(controller);
+  for (int i = 0; i < request->update_size(); i++) {
+    const DmxUpdate &update = request->update(i);
+    uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
+    if (update.has_priority()) {
+      priority = ClampPriority(update.priority());
+    }
+
+    DmxBuffer buffer;
+    if (update.has_offset()) {
+      // Apply the changed range to the last frame from this client.
+      buffer = client->SourceData(update.universe()).Data();
+      if (!update.data().empty() &&
+          !buffer.SetRange(
+              update.offset(),
+              reinterpret_cast<const uint8_t*>(update.data().data()),
+              update.data().size())) {
+        OLA_INFO << "Invalid range at offset " << update.offset()
+                 << " for universe " << update.universe();
+        continue;
+      }
+    } else {
+      buffer.Set(update.data());
+    }
+
+    // Record the data even if the universe doesn't exist, since later
+    // ranges are applied on top of it.
+    DmxSource source(buffer, *m_wake_up_time, priority);
+    client->DMXReceived(update.universe(), source);
+    Universe *universe = m_universe_store->GetUniverse(update.universe());
+    if (universe) {
+      universe->SourceClientDataChanged(client);
+    }
+  }
+}
+
+void OlaServerServiceImpl::RegisterSharedMemory(
+    RpcController* controller,
+    const SharedMemoryRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  Client *client = GetClient(controller);
+
+  if (request->action() == ola::proto::UNREGISTER) {
+    if (client->SharedMemory() &&
+        client->SharedMemory()->Name() == request->name()) {
+      m_shared_memory_clients.erase(client);
+      client->SetSharedMemory(NULL);
+    }
+    return;
+  }
+
+  if (!m_shared_memory_enabled) {
+    controller->SetFailed("Shared memory is disabled");
+    return;
+  }
+
+  SharedMemoryFrames *frames = SharedMemoryFrames::Open(request->name());
+  if (!frames) {
+    controller->SetFailed("Failed to open " + request->name());
+    return;
+  }
+
+  OLA_INFO << "Reading DMX data from " << request->name();
+  client->SetSharedMemory(frames);
+  m_shared_memory_clients.insert(client);
+}
+
+void OlaServerServiceImpl::SetPixelLayout(
+    RpcController* controller,
+    const PixelLayout* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  Client *client = GetClient(controller);
+
+  if (request->run_size() == 0) {
+    client->SetPixelMap(request->layout(), NULL);
+    return;
+  }
+
+  const uint64_t frame_size = static_cast<uint64_t>(request->width()) *
+                              request->height() * 3;
+  if (!frame_size || frame_size > MAX_PIXEL_FRAME_SIZE) {
+    controller->SetFailed("Invalid frame size");
+    return;
+  }
+
+  std::auto_ptr<PixelMap> map(
+      new PixelMap(request->width(), request->height()));
+  for (int i = 0; i < request->run_size(); i++) {
+    const PixelRun &proto_run = request->run(i);
+    if (proto_run.color_order() > ola::dmx::COLOR_ORDER_BGR) {
+      controller->SetFailed("Invalid color order");
+      return;
+    }
+
+    PixelMap::Run run;
+    run.universe = proto_run.universe();
+    run.start_slot = proto_run.start_slot();
+    run.x = proto_run.x();
+    run.y = proto_run.y();
+    run.x_step = proto_run.x_step();
+    run.y_step = proto_run.y_step();
+    run.count = proto_run.count();
+    run.order = static_cast<ola::dmx::ColorOrder>(proto_run.color_order());
+    if (!map->AddRun(run)) {
+      controller->SetFailed(
+          "Invalid pixel run " + IntToString(i));
+      return;
+    }
+  }
+
+  if (request->brightness() > 255) {
+    controller->SetFailed("Invalid brightness");
+    return;
+  }
+  map->SetColorCorrection(request->gamma(), request->brightness());
+
+  OLA_INFO << "Client set pixel layout " << request->layout() << ", "
+           << map->Width() << "x" << map->Height() << " to "
+           << map->UniverseCount() << " universes";
+  client->SetPixelMap(request->layout(), map.release());
+}
+
+void OlaServerServiceImpl::StreamPixelFrame(
+    RpcController *controller,
+    const PixelFrame* request,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    ola::rpc::RpcService::CompletionCallback*) {
+  Client *client = GetClient(controller);
+  PixelMap *map = client->GetPixelMap(request->layout());
+  if (!map) {
+    OLA_INFO << "Unknown pixel layout " << request->layout();
+    return;
+  }
+
+  if (!map->Map(reinterpret_cast<const uint8_t*>(request->data().data()),
+                request->data().size())) {
+    OLA_INFO << "Pixel frame of " << request->data().size()
+             << " bytes doesn't match layout " << request->layout()
+             << ", expected " << map->FrameSize();
+    return;
+  }
+
+  uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
+  if (request->has_priority()) {
+    priority = ClampPriority(request->priority());
+  }
+
+  for (unsigned int i = 0; i < map->UniverseCount(); i++) {
+    DmxSource source(map->UniverseData(i), *m_wake_up_time, priority);
+    client->DMXReceived(map->UniverseId(i), source);
+    Universe *universe = m_universe_store->GetUniverse(map->UniverseId(i));
+    if (universe) {
+      universe->SourceClientDataChanged(client);
+    }
+  }
+}
+
+/*
+ * Apply new data from a client, fading to it if the request has a fade time.
+ */
+void OlaServerServiceImpl::UpdateSourceClient(Universe *universe,
+                                              Client *client,
+                                              const DmxData *request,
+                                              const DmxSource &source) {
+  if (request->has_fade_time() && request->fade_time()) {
+    universe->FadeSourceClient(
+        client, source,
+        TimeInterval(static_cast<int64_t>(request->fade_time()) *
+                     ONE_THOUSAND));
+  } else {
+    client->DMXReceived(request->universe(), source);
+    universe->SourceClientDataChanged(client);
+  }
 }
 
 void OlaServerServiceImpl::SetUniverseName(
@@ -249,6 +719,37 @@ void OlaServerServiceImpl::SetMergeMode(
   universe->SetMergeMode(mode);
 }
 
+void OlaServerServiceImpl::SetUniverseLayers(
+    RpcController* controller,
+    const UniverseLayersRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  vector<Universe::Layer> layers(request->layer_size());
+  for (int i = 0; i < request->layer_size(); i++) {
+    const ola::proto::UniverseLayer &proto_layer = request->layer(i);
+    if (proto_layer.opacity() > ola::DMX_MAX_SLOT_VALUE ||
+        proto_layer.mask().size() > ola::DMX_UNIVERSE_SIZE) {
+      controller->SetFailed("Invalid layer " + IntToString(i));
+      return;
+    }
+    layers[i].universe = proto_layer.universe();
+    layers[i].opacity = proto_layer.opacity();
+    layers[i].mask.Set(proto_layer.mask());
+  }
+
+  Universe *universe = layers.empty() ?
+      m_universe_store->GetUniverse(request->universe()) :
+      m_universe_store->GetUniverseOrCreate(request->universe());
+  if (!universe) {
+    return MissingUniverseError(controller);
+  }
+
+  if (!m_universe_store->SetLayers(universe, layers)) {
+    controller->SetFailed("Layers would create a cycle");
+  }
+}
+
 void OlaServerServiceImpl::PatchPort(
     RpcController* controller,
     const PatchPortRequest* request,
@@ -292,6 +793,47 @@ void OlaServerServiceImpl::PatchPort(
   }
 }
 
+void OlaServerServiceImpl::PatchPorts(
+    RpcController* controller,
+    const PatchPortsRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  vector<PortManager::PortPatch> patches;
+  patches.reserve(request->port_size());
+
+  // Resolve all the ports first, so nothing is changed if one is missing.
+  for (int i = 0; i < request->port_size(); i++) {
+    const PatchPortRequest &port_request = request->port(i);
+    AbstractDevice *device =
+      m_device_manager->GetDevice(port_request.device_alias());
+    if (!device) {
+      return MissingDeviceError(controller);
+    }
+
+    bool patch = port_request.action() == ola::proto::PATCH;
+    if (port_request.is_output()) {
+      OutputPort *port = device->GetOutputPort(port_request.port_id());
+      if (!port) {
+        return MissingPortError(controller);
+      }
+      patches.push_back(
+          PortManager::PortPatch(port, patch, port_request.universe()));
+    } else {
+      InputPort *port = device->GetInputPort(port_request.port_id());
+      if (!port) {
+        return MissingPortError(controller);
+      }
+      patches.push_back(
+          PortManager::PortPatch(port, patch, port_request.universe()));
+    }
+  }
+
+  if (!m_port_manager->ApplyPatches(patches)) {
+    controller->SetFailed("Patch ports request failed");
+  }
+}
+
 void OlaServerServiceImpl::SetPortPriority(
     RpcController* controller,
     const ola::proto::PortPriorityRequest* request,
@@ -721,37 +1263,8 @@ void OlaServerServiceImpl::RDMCommand(
   }
 
   Client *client = GetClient(controller);
-  UID source_uid = client->GetUID();
-
-  UID destination(request->uid().esta_id(),
-                  request->uid().device_id());
-
-  RDMRequest::OverrideOptions options = RDMRequestOptionsFromProto(*request);
-
-  ola::rdm::RDMRequest *rdm_request = NULL;
-  if (request->is_set()) {
-    rdm_request = new ola::rdm::RDMSetRequest(
-        source_uid,
-        destination,
-        0,  // transaction #
-        1,  // port id
-        request->sub_device(),
-        request->param_id(),
-        reinterpret_cast<const uint8_t*>(request->data().data()),
-        request->data().size(),
-        options);
-  } else {
-    rdm_request = new ola::rdm::RDMGetRequest(
-        source_uid,
-        destination,
-        0,  // transaction #
-        1,  // port id
-        request->sub_device(),
-        request->param_id(),
-        reinterpret_cast<const uint8_t*>(request->data().data()),
-        request->data().size(),
-        options);
-  }
+  ola::rdm::RDMRequest *rdm_request = RDMRequestFromProto(client->GetUID(),
+                                                          *request);
 
   ola::rdm::RDMCallback *callback =
     NewSingleCallback(
@@ -764,6 +1277,70 @@ void OlaServerServiceImpl::RDMCommand(
   m_broker->SendRDMRequest(client, universe, rdm_request, callback);
 }
 
+void OlaServerServiceImpl::RDMBatchCommand(
+    RpcController* controller,
+    const ola::proto::RDMBatchRequest* request,
+    ola::proto::RDMBatchReply* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  response->set_batch_id(request->batch_id());
+  response->set_result_count(0);
+  if (request->request_size() == 0) {
+    done->Run();
+    return;
+  }
+
+  RDMBatch *batch = new RDMBatch(GetClient(controller), *request, response,
+                                 done);
+  m_rdm_batches.insert(batch);
+  SendRDMBatchRequests(batch);
+}
+
+void OlaServerServiceImpl::SubscribeRDMPoll(
+    RpcController* controller,
+    const ola::proto::RDMPollRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  Client *client = GetClient(controller);
+  if (!m_rdm_poller || !client) {
+    controller->SetFailed("RDM polling isn't available");
+    return;
+  }
+
+  if (request->sub_device() < 0 ||
+      request->sub_device() > ola::rdm::ALL_RDM_SUBDEVICES ||
+      request->param_id() < 0 || request->param_id() > 0xffff ||
+      request->data().size() >
+          ola::rdm::RDMCommandSerializer::MAX_PARAM_DATA_LENGTH) {
+    controller->SetFailed("Invalid request");
+    return;
+  }
+
+  RDMPoller::PollRequest poll_request(
+      request->universe(),
+      UID(request->uid().esta_id(), request->uid().device_id()),
+      request->sub_device(),
+      request->param_id(),
+      request->data());
+
+  if (request->action() == ola::proto::UNREGISTER) {
+    m_rdm_poller->Unsubscribe(client, poll_request);
+    return;
+  }
+
+  if (request->period_ms() == 0) {
+    controller->SetFailed("Invalid period");
+    return;
+  }
+
+  if (!m_universe_store->GetUniverse(request->universe())) {
+    return MissingUniverseError(controller);
+  }
+  m_rdm_poller->Subscribe(
+      client, poll_request,
+      TimeInterval(static_cast<int64_t>(request->period_ms()) * ONE_THOUSAND));
+}
+
 void OlaServerServiceImpl::RDMDiscoveryCommand(
     RpcController* controller,
     const ola::proto::RDMDiscoveryRequest* request,
@@ -830,10 +1407,12 @@ void OlaServerServiceImpl::SendTimeCode(
       request->seconds(),
       request->frames());
 
-  if (time_code.IsValid()) {
-    m_device_manager->SendTimeCode(time_code);
-  } else {
+  if (!time_code.IsValid()) {
     controller->SetFailed("Invalid TimeCode");
+  } else if (m_timecode_scheduler) {
+    m_timecode_scheduler->SetReference(time_code);
+  } else {
+    m_device_manager->SendTimeCode(time_code);
   }
 }
 
@@ -850,6 +1429,16 @@ void OlaServerServiceImpl::HandleRDMResponse(
     bool include_raw_packets,
     ola::rdm::RDMReply *reply) {
   ClosureRunner runner(done);
+  PopulateRDMResponse(reply, include_raw_packets, response);
+}
+
+/*
+ * Copy an RDMReply into a proto::RDMResponse.
+ */
+void OlaServerServiceImpl::PopulateRDMResponse(
+    ola::rdm::RDMReply *reply,
+    bool include_raw_packets,
+    ola::proto::RDMResponse* response) {
   response->set_response_code(
       static_cast<ola::proto::RDMResponseCode>(reply->StatusCode()));
 
@@ -917,6 +1506,67 @@ void OlaServerServiceImpl::HandleRDMResponse(
   }
 }
 
+/*
+ * Send requests from the batch until max_outstanding are in flight. Requests
+ * for universes that don't exist fail straight away.
+ */
+void OlaServerServiceImpl::SendRDMBatchRequests(RDMBatch *batch) {
+  if (batch->sending) {
+    // A request completed synchronously, the loop below will pick it up.
+    return;
+  }
+
+  batch->sending = true;
+  const int request_count = batch->request.request_size();
+  while (batch->outstanding < batch->max_outstanding &&
+         batch->next < request_count) {
+    const unsigned int index = batch->next++;
+    const ola::proto::RDMRequest &request = batch->request.request(index);
+    batch->outstanding++;
+
+    ola::rdm::RDMCallback *callback = NewSingleCallback(
+        this, &OlaServerServiceImpl::HandleRDMBatchResponse, batch, index);
+
+    Universe *universe = m_universe_store->GetUniverse(request.universe());
+    if (!universe) {
+      ola::rdm::RunRDMCallback(callback, ola::rdm::RDM_FAILED_TO_SEND);
+      continue;
+    }
+    m_broker->SendRDMRequest(
+        batch->client, universe,
+        RDMRequestFromProto(batch->client->GetUID(), request),
+        callback);
+  }
+  batch->sending = false;
+
+  if (batch->completed == static_cast<unsigned int>(request_count)) {
+    batch->reply->set_result_count(batch->completed);
+    m_rdm_batches.erase(batch);
+    ola::rpc::RpcService::CompletionCallback *done = batch->done;
+    delete batch;
+    done->Run();
+  }
+}
+
+/*
+ * Stream the result of a batched request back to the client, then send the
+ * next request.
+ */
+void OlaServerServiceImpl::HandleRDMBatchResponse(RDMBatch *batch,
+                                                  unsigned int index,
+                                                  ola::rdm::RDMReply *reply) {
+  ola::proto::RDMBatchResult result;
+  result.set_batch_id(batch->request.batch_id());
+  result.set_index(index);
+  PopulateRDMResponse(reply,
+                      batch->request.request(index).include_raw_response(),
+                      result.mutable_response());
+  batch->client->SendRDMBatchResult(result);
+
+  batch->outstanding--;
+  batch->completed++;
+  SendRDMBatchRequests(batch);
+}
 
 /**
  * Called when RDM discovery completes
@@ -1035,6 +1685,39 @@ void OlaServerServiceImpl::SetProtoUID(const ola::rdm::UID &uid,
   pb_uid->set_device_id(uid.DeviceId());
 }
 
+/*
+ * Find the universes listed in a MultiUniverseRequest, or all universes if
+ * none are listed. Universes which don't exist are skipped.
+ */
+void OlaServerServiceImpl::RequestedUniverses(
+    const MultiUniverseRequest &request,
+    vector<Universe*> *universes) const {
+  if (!request.universe_size()) {
+    m_universe_store->GetList(universes);
+    return;
+  }
+  for (int i = 0; i < request.universe_size(); i++) {
+    Universe *universe = m_universe_store->GetUniverse(request.universe(i));
+    if (universe) {
+      universes->push_back(universe);
+    }
+  }
+}
+
+/*
+ * Convert the slot priorities from a DmxData message, clamping each one to
+ * the max source priority.
+ */
+void OlaServerServiceImpl::SetSlotPriorities(const string &data,
+                                             DmxBuffer *slot_priorities) const {
+  slot_priorities->Set(data);
+  for (unsigned int i = 0; i < slot_priorities->Size(); i++) {
+    if (slot_priorities->Get(i) > ola::dmx::SOURCE_PRIORITY_MAX) {
+      slot_priorities->SetChannel(i, ola::dmx::SOURCE_PRIORITY_MAX);
+    }
+  }
+}
+
 Client* OlaServerServiceImpl::GetClient(ola::rpc::RpcController *controller) {
   return reinterpret_cast<Client*>(controller->Session()->GetData());
 }
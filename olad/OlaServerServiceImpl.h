@@ -18,12 +18,15 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
 #include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMControllerInterface.h"
 #include "ola/rdm/UID.h"
@@ -34,6 +37,7 @@
 
 namespace ola {
 
+class DmxSource;
 class Universe;
 
 /**
@@ -65,7 +69,42 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                        const class TimeStamp *wake_up_time,
                        ReloadPluginsCallback *reload_plugins_callback);
 
-  ~OlaServerServiceImpl() {}
+  ~OlaServerServiceImpl();
+
+  /**
+   * @brief Allow clients to register shared memory segments.
+   *
+   * This is off by default. Once enabled, PollSharedMemory() should be called
+   * periodically to pick up new frames.
+   */
+  void EnableSharedMemory() { m_shared_memory_enabled = true; }
+
+  /**
+   * @brief Send timecode from clients through a TimeCodeScheduler.
+   * @param scheduler the TimeCodeScheduler to use, ownership is not
+   *   transferred. If NULL, timecode is sent straight to the ports.
+   */
+  void SetTimeCodeScheduler(class TimeCodeScheduler *scheduler) {
+    m_timecode_scheduler = scheduler;
+  }
+
+  /**
+   * @brief Set the RDMPoller used for SubscribeRDMPoll.
+   * @param poller the RDMPoller to use, ownership is not transferred. If
+   *   NULL, SubscribeRDMPoll fails.
+   */
+  void SetRDMPoller(class RDMPoller *poller) { m_rdm_poller = poller; }
+
+  /**
+   * @brief Read new frames from the shared memory segments of all clients.
+   */
+  void PollSharedMemory();
+
+  /**
+   * @brief Called when a client disconnects.
+   * @param client the Client that is about to be deleted.
+   */
+  void ClientRemoved(class Client *client);
 
   /**
    * @brief Returns the current DMX values for a particular universe.
@@ -75,6 +114,22 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
               ola::proto::DmxData* response,
               ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Returns the current DMX values for many universes, or all of them.
+   */
+  void GetDmxMulti(ola::rpc::RpcController* controller,
+                   const ola::proto::MultiUniverseRequest* request,
+                   ola::proto::DmxSnapshot* response,
+                   ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Returns the counters for many universes, or all of them.
+   */
+  void GetUniverseStats(ola::rpc::RpcController* controller,
+                        const ola::proto::MultiUniverseRequest* request,
+                        ola::proto::UniverseStatsReply* response,
+                        ola::rpc::RpcService::CompletionCallback* done);
+
 
   /**
    * @brief Register a client to receive DMX data.
@@ -99,6 +154,49 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                      ::ola::proto::STREAMING_NO_RESPONSE* response,
                      ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Handle StreamDmxData requests without parsing them.
+   *
+   * The DMX data is copied once, straight from the receive buffer into the
+   * client's DmxSource. Requests with fields other than the universe, data &
+   * priority are left for StreamDmxData().
+   */
+  bool CallStreamingMethod(const google::protobuf::MethodDescriptor *method,
+                           ola::rpc::RpcController *controller,
+                           const uint8_t *data,
+                           unsigned int size);
+
+  /**
+   * @brief Handle a batch of streaming DMX updates, no response is sent.
+   */
+  void StreamDmxDataBatch(ola::rpc::RpcController* controller,
+                          const ::ola::proto::DmxDataBatch* request,
+                          ::ola::proto::STREAMING_NO_RESPONSE* response,
+                          ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Register or unregister a shared memory segment for a client.
+   */
+  void RegisterSharedMemory(ola::rpc::RpcController* controller,
+                            const ola::proto::SharedMemoryRequest* request,
+                            ola::proto::Ack* response,
+                            ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Set or remove a pixel layout for a client.
+   */
+  void SetPixelLayout(ola::rpc::RpcController* controller,
+                      const ola::proto::PixelLayout* request,
+                      ola::proto::Ack* response,
+                      ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Map a frame of pixels onto universes, no response is sent.
+   */
+  void StreamPixelFrame(ola::rpc::RpcController* controller,
+                        const ::ola::proto::PixelFrame* request,
+                        ::ola::proto::STREAMING_NO_RESPONSE* response,
+                        ola::rpc::RpcService::CompletionCallback* done);
 
   /**
    * @brief Sets the name of a universe.
@@ -108,6 +206,14 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                        ola::proto::Ack* response,
                        ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Subscribe to, or unsubscribe from, changes to slots in a universe.
+   */
+  void SubscribeSlots(ola::rpc::RpcController* controller,
+                      const ola::proto::SlotSubscriptionRequest* request,
+                      ola::proto::Ack* response,
+                      ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Set the merge mode for a universe.
    */
@@ -116,6 +222,14 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                     ola::proto::Ack* response,
                     ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Set the layers of a virtual universe.
+   */
+  void SetUniverseLayers(ola::rpc::RpcController* controller,
+                         const ola::proto::UniverseLayersRequest* request,
+                         ola::proto::Ack* response,
+                         ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Patch a port to a universe.
    */
@@ -124,6 +238,17 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                  ola::proto::Ack* response,
                  ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Patch or unpatch a set of ports.
+   *
+   * Only the ports whose patching differs from the request are changed. If
+   * any port is missing or can't be patched, no changes are made.
+   */
+  void PatchPorts(ola::rpc::RpcController* controller,
+                  const ola::proto::PatchPortsRequest* request,
+                  ola::proto::Ack* response,
+                  ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Set the priority of one or more ports.
    */
@@ -232,6 +357,29 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                   ola::rpc::RpcService::CompletionCallback* done);
 
 
+  /**
+   * @brief Handle a batch of RDM Commands.
+   *
+   * At most max_outstanding requests from the batch are in flight at once.
+   * The result of each request is streamed back to the client as it
+   * completes, and the reply is sent once all the results have been streamed.
+   */
+  void RDMBatchCommand(ola::rpc::RpcController* controller,
+                       const ::ola::proto::RDMBatchRequest* request,
+                       ola::proto::RDMBatchReply* response,
+                       ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Subscribe to, or unsubscribe from, a GET polled by olad.
+   *
+   * The responses are sent to the client with UpdateRDMPoll when they
+   * change.
+   */
+  void SubscribeRDMPoll(ola::rpc::RpcController* controller,
+                        const ::ola::proto::RDMPollRequest* request,
+                        ola::proto::Ack* response,
+                        ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Handle an RDM Discovery Command.
    *
@@ -260,10 +408,52 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                     ola::rpc::RpcService::CompletionCallback* done);
 
  private:
+  /**
+   * @brief The state of a batch of RDM requests from a client.
+   */
+  struct RDMBatch {
+    class Client *client;
+    // A copy, since the RPC layer reuses the request message.
+    ola::proto::RDMBatchRequest request;
+    ola::proto::RDMBatchReply *reply;
+    ola::rpc::RpcService::CompletionCallback *done;
+    unsigned int max_outstanding;
+    int next;
+    unsigned int outstanding;
+    unsigned int completed;
+    // True while requests are being sent, to avoid recursion if a request
+    // completes synchronously.
+    bool sending;
+
+    RDMBatch(class Client *client,
+             const ola::proto::RDMBatchRequest &request,
+             ola::proto::RDMBatchReply *reply,
+             ola::rpc::RpcService::CompletionCallback *done)
+        : client(client),
+          request(request),
+          reply(reply),
+          done(done),
+          max_outstanding(std::max(1u, request.max_outstanding())),
+          next(0),
+          outstanding(0),
+          completed(0),
+          sending(false) {
+    }
+  };
+
+  typedef std::set<RDMBatch*> RDMBatchSet;
+
   void HandleRDMResponse(ola::proto::RDMResponse* response,
                          ola::rpc::RpcService::CompletionCallback* done,
                          bool include_raw_packets,
                          ola::rdm::RDMReply *reply);
+  void PopulateRDMResponse(ola::rdm::RDMReply *reply,
+                           bool include_raw_packets,
+                           ola::proto::RDMResponse* response);
+  void SendRDMBatchRequests(RDMBatch *batch);
+  void HandleRDMBatchResponse(RDMBatch *batch,
+                              unsigned int index,
+                              ola::rdm::RDMReply *reply);
   void RDMDiscoveryComplete(unsigned int universe,
                             ola::rpc::RpcService::CompletionCallback* done,
                             ola::proto::UIDListReply *response,
@@ -287,6 +477,14 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                     ola::proto::PortInfo *port_info) const;
 
   void SetProtoUID(const ola::rdm::UID &uid, ola::proto::UID *pb_uid);
+  void RequestedUniverses(const ola::proto::MultiUniverseRequest &request,
+                          std::vector<Universe*> *universes) const;
+  void SetSlotPriorities(const std::string &data,
+                         DmxBuffer *slot_priorities) const;
+  void UpdateSourceClient(Universe *universe,
+                          class Client *client,
+                          const ola::proto::DmxData *request,
+                          const DmxSource &source);
 
   class Client* GetClient(ola::rpc::RpcController *controller);
 
@@ -296,7 +494,16 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
   class PortManager *m_port_manager;
   class ClientBroker *m_broker;
   const class TimeStamp *m_wake_up_time;
+  class TimeCodeScheduler *m_timecode_scheduler;
+  class RDMPoller *m_rdm_poller;
   std::auto_ptr<ReloadPluginsCallback> m_reload_plugins_callback;
+  bool m_shared_memory_enabled;
+  std::set<class Client*> m_shared_memory_clients;
+  RDMBatchSet m_rdm_batches;
+  const google::protobuf::MethodDescriptor *m_stream_dmx_method;
+
+  // Larger frames wouldn't fit in an RPC.
+  static const unsigned int MAX_PIXEL_FRAME_SIZE = 1 << 20;
 };
 }  // namespace ola
 #endif  // OLAD_OLASERVERSERVICEIMPL_H_
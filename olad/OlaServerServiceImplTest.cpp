@@ -24,6 +24,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <string>
+#include <vector>
 
 #include "common/rpc/RpcController.h"
 #include "common/rpc/RpcSession.h"
@@ -33,33 +34,54 @@
 #include "ola/DmxBuffer.h"
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMReply.h"
 #include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
 #include "ola/testing/TestUtils.h"
+#include "olad/ClientBroker.h"
 #include "olad/OlaServerServiceImpl.h"
 #include "olad/PluginLoader.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/TestCommon.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 using ola::Client;
+using ola::ClientBroker;
+using ola::NewCallback;
 using ola::NewSingleCallback;
 using ola::SingleUseCallback0;
 using ola::DmxBuffer;
 using ola::OlaServerServiceImpl;
 using ola::Universe;
 using ola::UniverseStore;
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
 using ola::rpc::RpcController;
 using ola::rpc::RpcSession;
 using std::string;
+using std::vector;
 
 class OlaServerServiceImplTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OlaServerServiceImplTest);
   CPPUNIT_TEST(testGetDmx);
+  CPPUNIT_TEST(testGetDmxMulti);
+  CPPUNIT_TEST(testGetUniverseStats);
   CPPUNIT_TEST(testRegisterForDmx);
   CPPUNIT_TEST(testUpdateDmxData);
+  CPPUNIT_TEST(testStreamDmxData);
   CPPUNIT_TEST(testSetUniverseName);
   CPPUNIT_TEST(testSetMergeMode);
+  CPPUNIT_TEST(testPixelFrame);
+  CPPUNIT_TEST(testSetUniverseLayers);
+  CPPUNIT_TEST(testSubscribeSlots);
+  CPPUNIT_TEST(testRDMBatchCommand);
+  CPPUNIT_TEST(testRDMBatchClientRemoved);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -72,14 +94,31 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
     }
 
     void testGetDmx();
+    void testGetDmxMulti();
+    void testGetUniverseStats();
     void testRegisterForDmx();
     void testUpdateDmxData();
+    void testStreamDmxData();
     void testSetUniverseName();
     void testSetMergeMode();
+    void testPixelFrame();
+    void testSetUniverseLayers();
+    void testSubscribeSlots();
+    void testRDMBatchCommand();
+    void testRDMBatchClientRemoved();
 
  private:
+    typedef std::pair<const RDMRequest*, RDMCallback*> PendingRDMRequest;
+
     ola::rdm::UID m_uid;
     ola::Clock m_clock;
+    vector<PendingRDMRequest> m_pending_rdm;
+
+    void QueueRDMRequest(const RDMRequest *request, RDMCallback *callback) {
+      m_pending_rdm.push_back(PendingRDMRequest(request, callback));
+    }
+
+    void AckRDMRequest(unsigned int index);
 
     void CallGetDmx(OlaServerServiceImpl *service,
                     int universe_id,
@@ -93,6 +132,9 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
                            int universe_id,
                            const DmxBuffer &data,
                            class UpdateDmxDataCheck *check);
+    bool CallStreamingDmxData(OlaServerServiceImpl *service,
+                              Client *client,
+                              const ola::proto::DmxData &request);
     void CallSetUniverseName(OlaServerServiceImpl *service,
                              int universe_id,
                              const string &name,
@@ -107,6 +149,54 @@ CPPUNIT_TEST_SUITE_REGISTRATION(OlaServerServiceImplTest);
 
 static const uint8_t SAMPLE_DMX_DATA[] = {1, 2, 3, 4, 5};
 
+static void Noop() {}
+
+static void MarkDone(bool *done) {
+  *done = true;
+}
+
+/*
+ * A Client which records the streamed RDM batch results.
+ */
+class MockBatchClient: public Client {
+ public:
+  explicit MockBatchClient(const UID &uid) : Client(NULL, uid) {}
+
+  void SendRDMBatchResult(const ola::proto::RDMBatchResult &result) {
+    results.push_back(result);
+  }
+
+  vector<ola::proto::RDMBatchResult> results;
+};
+
+/*
+ * A Client which records the slot changes it's sent.
+ */
+class MockSlotClient: public Client {
+ public:
+  explicit MockSlotClient(const UID &uid) : Client(NULL, uid) {}
+
+  void SendSlotChanges(const ola::proto::SlotChanges &changes) {
+    results.push_back(changes);
+  }
+
+  vector<ola::proto::SlotChanges> results;
+};
+
+static void AddBatchRequest(ola::proto::RDMBatchRequest *batch,
+                            unsigned int universe_id,
+                            const UID &uid,
+                            uint16_t pid) {
+  ola::proto::RDMRequest *request = batch->add_request();
+  request->set_universe(universe_id);
+  request->mutable_uid()->set_esta_id(uid.ManufacturerId());
+  request->mutable_uid()->set_device_id(uid.DeviceId());
+  request->set_sub_device(0);
+  request->set_param_id(pid);
+  request->set_is_set(false);
+  request->set_data("");
+}
+
 /*
  * The GetDmx Checks
  */
@@ -244,6 +334,113 @@ void OlaServerServiceImplTest::testGetDmx() {
   CallGetDmx(&service, universe_id, &missing_universe_check);
 }
 
+/*
+ * Check that the GetDmxMulti method works
+ */
+void OlaServerServiceImplTest::testGetDmxMulti() {
+  UniverseStore store(NULL, NULL);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL, NULL, NULL);
+  RpcSession session(NULL);
+
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+  OLA_ASSERT_NOT_NULL(universe1);
+  OLA_ASSERT_NOT_NULL(universe2);
+  DmxBuffer buffer(SAMPLE_DMX_DATA, sizeof(SAMPLE_DMX_DATA));
+  universe1->SetDMX(buffer);
+  DmxBuffer buffer2;
+  buffer2.SetFromString("10,20");
+  universe2->SetDMX(buffer2);
+
+  // request two universes, one of which doesn't exist
+  {
+    RpcController controller(&session);
+    ola::proto::MultiUniverseRequest request;
+    ola::proto::DmxSnapshot response;
+    request.add_universe(1);
+    request.add_universe(3);
+    service.GetDmxMulti(&controller, &request, &response,
+                        NewSingleCallback(&Noop));
+    OLA_ASSERT_FALSE(controller.Failed());
+    OLA_ASSERT_EQ(1, response.universe_data_size());
+    OLA_ASSERT_EQ(1, response.universe_data(0).universe());
+    OLA_ASSERT_EQ(string(reinterpret_cast<const char*>(SAMPLE_DMX_DATA),
+                         sizeof(SAMPLE_DMX_DATA)),
+                  response.universe_data(0).data());
+    OLA_ASSERT_EQ(0, response.universe_size());
+  }
+
+  // request all universes, packed
+  {
+    RpcController controller(&session);
+    ola::proto::MultiUniverseRequest request;
+    ola::proto::DmxSnapshot response;
+    request.set_packed(true);
+    service.GetDmxMulti(&controller, &request, &response,
+                        NewSingleCallback(&Noop));
+    OLA_ASSERT_FALSE(controller.Failed());
+    OLA_ASSERT_EQ(0, response.universe_data_size());
+    OLA_ASSERT_EQ(2, response.universe_size());
+    OLA_ASSERT_EQ(2, response.size_size());
+    OLA_ASSERT_EQ(1, response.universe(0));
+    OLA_ASSERT_EQ(2, response.universe(1));
+    OLA_ASSERT_EQ(static_cast<uint32_t>(sizeof(SAMPLE_DMX_DATA)),
+                  response.size(0));
+    OLA_ASSERT_EQ(2u, response.size(1));
+    OLA_ASSERT_EQ(buffer.Get() + buffer2.Get(), response.packed_data());
+  }
+}
+
+/*
+ * Check that the GetUniverseStats method works
+ */
+void OlaServerServiceImplTest::testGetUniverseStats() {
+  UniverseStore store(NULL, NULL);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL, NULL, NULL);
+  RpcSession session(NULL);
+
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+  OLA_ASSERT_NOT_NULL(universe1);
+  OLA_ASSERT_NOT_NULL(universe2);
+  DmxBuffer buffer(SAMPLE_DMX_DATA, sizeof(SAMPLE_DMX_DATA));
+  universe1->SetDMX(buffer);
+  universe1->SetDMX(buffer);
+
+  // request two universes, one of which doesn't exist
+  {
+    RpcController controller(&session);
+    ola::proto::MultiUniverseRequest request;
+    ola::proto::UniverseStatsReply response;
+    request.add_universe(1);
+    request.add_universe(3);
+    service.GetUniverseStats(&controller, &request, &response,
+                             NewSingleCallback(&Noop));
+    OLA_ASSERT_FALSE(controller.Failed());
+    OLA_ASSERT_EQ(1, response.universe_size());
+    const ola::proto::UniverseStats &stats = response.universe(0);
+    OLA_ASSERT_EQ(1, stats.universe());
+    OLA_ASSERT_EQ(static_cast<uint64_t>(2), stats.frames());
+    OLA_ASSERT_EQ(0u, stats.input_ports());
+    OLA_ASSERT_EQ(0u, stats.source_clients());
+    OLA_ASSERT_EQ(static_cast<uint64_t>(0), stats.latency_samples());
+  }
+
+  // request all universes
+  {
+    RpcController controller(&session);
+    ola::proto::MultiUniverseRequest request;
+    ola::proto::UniverseStatsReply response;
+    service.GetUniverseStats(&controller, &request, &response,
+                             NewSingleCallback(&Noop));
+    OLA_ASSERT_FALSE(controller.Failed());
+    OLA_ASSERT_EQ(2, response.universe_size());
+    OLA_ASSERT_EQ(1, response.universe(0).universe());
+    OLA_ASSERT_EQ(2, response.universe(1).universe());
+    OLA_ASSERT_EQ(static_cast<uint64_t>(0), response.universe(1).frames());
+  }
+}
+
 /*
  * Call the GetDmx method
  * @param impl the OlaServerServiceImpl to use
@@ -422,6 +619,83 @@ void OlaServerServiceImplTest::CallUpdateDmxData(
   service->UpdateDmxData(&controller, &request, &response, closure);
 }
 
+/*
+ * Check StreamDmxData requests are handled without parsing them.
+ */
+void OlaServerServiceImplTest::testStreamDmxData() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  ola::Client client1(NULL, m_uid);
+  ola::Client client2(NULL, m_uid);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &time1, NULL);
+  unsigned int universe_id = 1;
+  DmxBuffer dmx_data("this is a test");
+  DmxBuffer dmx_data2("different data hmm");
+
+  ola::proto::DmxData request;
+  request.set_universe(universe_id);
+  request.set_data(dmx_data.Get());
+
+  // Other methods aren't handled.
+  RpcSession session(NULL);
+  session.SetData(&client1);
+  RpcController controller(&session);
+  const string serialized = request.SerializeAsString();
+  OLA_ASSERT_FALSE(service.CallStreamingMethod(
+      service.descriptor()->FindMethodByName("UpdateDmxData"), &controller,
+      reinterpret_cast<const uint8_t*>(serialized.data()),
+      serialized.size()));
+
+  // A universe that doesn't exist is ignored.
+  m_clock.CurrentTime(&time1);
+  OLA_ASSERT_TRUE(CallStreamingDmxData(&service, &client1, request));
+  OLA_ASSERT_FALSE(store.GetUniverse(universe_id));
+
+  Universe *universe = store.GetUniverseOrCreate(universe_id);
+  OLA_ASSERT_TRUE(CallStreamingDmxData(&service, &client1, request));
+  OLA_ASSERT_EQ(dmx_data, universe->GetDMX());
+  OLA_ASSERT_EQ(dmx_data, client1.SourceData(universe_id).Data());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_DEFAULT),
+                client1.SourceData(universe_id).Priority());
+
+  // The priority is clamped.
+  m_clock.CurrentTime(&time1);
+  request.set_data(dmx_data2.Get());
+  request.set_priority(250);
+  OLA_ASSERT_TRUE(CallStreamingDmxData(&service, &client2, request));
+  OLA_ASSERT_EQ(dmx_data2, universe->GetDMX());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
+                client2.SourceData(universe_id).Priority());
+
+  // Requests with slot priorities are left for StreamDmxData().
+  request.set_slot_priorities(string(dmx_data.Size(), 100));
+  OLA_ASSERT_FALSE(CallStreamingDmxData(&service, &client1, request));
+
+  // As is invalid data.
+  const uint8_t truncated[] = {0x08, 0x01, 0x12, 0x05, 'a'};
+  OLA_ASSERT_FALSE(service.CallStreamingMethod(
+      service.descriptor()->FindMethodByName("StreamDmxData"), &controller,
+      truncated, sizeof(truncated)));
+}
+
+/*
+ * Serialize a DmxData request and pass it to CallStreamingMethod.
+ */
+bool OlaServerServiceImplTest::CallStreamingDmxData(
+    OlaServerServiceImpl *service,
+    Client *client,
+    const ola::proto::DmxData &request) {
+  RpcSession session(NULL);
+  session.SetData(client);
+  RpcController controller(&session);
+  const string serialized = request.SerializeAsString();
+  return service->CallStreamingMethod(
+      service->descriptor()->FindMethodByName("StreamDmxData"), &controller,
+      reinterpret_cast<const uint8_t*>(serialized.data()),
+      serialized.size());
+}
+
 /*
  * Check the SetUniverseName method works
  */
@@ -535,3 +809,387 @@ void OlaServerServiceImplTest::CallSetMergeMode(
   request.set_merge_mode(merge_mode);
   service->SetMergeMode(&controller, &request, &response, closure);
 }
+
+
+/*
+ * Reply to one of the queued RDM requests.
+ */
+void OlaServerServiceImplTest::AckRDMRequest(unsigned int index) {
+  OLA_ASSERT_LT(index, static_cast<unsigned int>(m_pending_rdm.size()));
+  const RDMRequest *request = m_pending_rdm[index].first;
+  RDMReply reply(ola::rdm::RDM_COMPLETED_OK,
+                 ola::rdm::GetResponseFromData(request, NULL, 0));
+  delete request;
+  m_pending_rdm[index].second->Run(&reply);
+}
+
+
+/*
+ * Check the SetUniverseLayers method works.
+ */
+void OlaServerServiceImplTest::testSetUniverseLayers() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  m_clock.CurrentTime(&time1);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &time1, NULL);
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  DmxBuffer data;
+  data.SetFromString("100,200");
+  universe1->SetDMX(data);
+
+  // The virtual universe is created.
+  ola::proto::UniverseLayersRequest request;
+  request.set_universe(2);
+  ola::proto::UniverseLayer *layer = request.add_layer();
+  layer->set_universe(1);
+  const uint8_t mask[] = {255};
+  layer->set_mask(mask, sizeof(mask));
+
+  ola::proto::Ack ack;
+  bool done = false;
+  {
+    RpcController controller;
+    service.SetUniverseLayers(&controller, &request, &ack,
+                              NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_FALSE(controller.Failed());
+  }
+  Universe *universe2 = store.GetUniverse(2);
+  OLA_ASSERT_NOT_NULL(universe2);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), universe2->Layers().size());
+  DmxBuffer expected;
+  expected.SetFromString("100");
+  OLA_ASSERT_EQ(expected, universe2->GetDMX());
+
+  // Cycles & invalid opacities are rejected.
+  request.set_universe(1);
+  layer->set_universe(2);
+  done = false;
+  {
+    RpcController controller;
+    service.SetUniverseLayers(&controller, &request, &ack,
+                              NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_TRUE(controller.Failed());
+  }
+  layer->set_universe(3);
+  layer->set_opacity(256);
+  done = false;
+  {
+    RpcController controller;
+    service.SetUniverseLayers(&controller, &request, &ack,
+                              NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_TRUE(controller.Failed());
+  }
+  OLA_ASSERT_TRUE(universe1->Layers().empty());
+
+  // An empty list removes the layers.
+  request.set_universe(2);
+  request.clear_layer();
+  done = false;
+  {
+    RpcController controller;
+    service.SetUniverseLayers(&controller, &request, &ack,
+                              NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_FALSE(controller.Failed());
+  }
+  OLA_ASSERT_TRUE(universe2->Layers().empty());
+}
+
+
+/*
+ * Check the SubscribeSlots method works.
+ */
+void OlaServerServiceImplTest::testSubscribeSlots() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  m_clock.CurrentTime(&time1);
+  MockSlotClient client(m_uid);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &time1, NULL);
+  RpcSession session(NULL);
+  session.SetData(&client);
+
+  ola::proto::SlotSubscriptionRequest request;
+  request.set_universe(1);
+  request.set_action(ola::proto::REGISTER);
+  ola::proto::SlotRange *range = request.add_range();
+  range->set_start(510);
+  range->set_count(3);
+
+  ola::proto::Ack ack;
+  bool done = false;
+  {
+    RpcController controller(&session);
+    service.SubscribeSlots(&controller, &request, &ack,
+                           NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_TRUE(controller.Failed());
+  }
+  OLA_ASSERT_NULL(store.GetUniverse(1));
+
+  range->set_start(1);
+  range->set_count(2);
+  done = false;
+  {
+    RpcController controller(&session);
+    service.SubscribeSlots(&controller, &request, &ack,
+                           NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_FALSE(controller.Failed());
+  }
+  Universe *universe = store.GetUniverse(1);
+  OLA_ASSERT_NOT_NULL(universe);
+  OLA_ASSERT_TRUE(universe->IsActive());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client.results.size());
+
+  DmxBuffer data;
+  data.SetFromString("1,2,0,4");
+  universe->SetDMX(data);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), client.results.size());
+  const ola::proto::SlotChanges &changes = client.results.back();
+  OLA_ASSERT_EQ(1, changes.universe());
+  OLA_ASSERT_EQ(1, changes.slot_size());
+  OLA_ASSERT_EQ(1u, changes.slot(0));
+  OLA_ASSERT_EQ(string(1, 2), changes.value());
+
+  request.set_action(ola::proto::UNREGISTER);
+  done = false;
+  {
+    RpcController controller(&session);
+    service.SubscribeSlots(&controller, &request, &ack,
+                           NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_FALSE(controller.Failed());
+  }
+  OLA_ASSERT_FALSE(universe->IsActive());
+}
+
+
+/*
+ * Check that pixel frames are mapped onto universes by the client's layout.
+ */
+void OlaServerServiceImplTest::testPixelFrame() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  m_clock.CurrentTime(&time1);
+  ola::Client client(NULL, m_uid);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &time1, NULL);
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+
+  RpcSession session(NULL);
+  session.SetData(&client);
+
+  // A 2x2 frame, row 0 to universe 1 and row 1 to universe 2 in BGR.
+  ola::proto::PixelLayout layout;
+  layout.set_layout(3);
+  layout.set_width(2);
+  layout.set_height(2);
+  ola::proto::PixelRun *run = layout.add_run();
+  run->set_universe(1);
+  run->set_start_slot(0);
+  run->set_x(0);
+  run->set_y(0);
+  run->set_count(2);
+  run = layout.add_run();
+  run->set_universe(2);
+  run->set_start_slot(0);
+  run->set_x(0);
+  run->set_y(1);
+  run->set_count(2);
+  run->set_color_order(ola::dmx::COLOR_ORDER_BGR);
+
+  ola::proto::Ack ack;
+  bool done = false;
+  {
+    RpcController controller(&session);
+    service.SetPixelLayout(&controller, &layout, &ack,
+                           NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_FALSE(controller.Failed());
+  }
+
+  const uint8_t pixels[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  ola::proto::PixelFrame frame;
+  frame.set_layout(3);
+  frame.set_data(pixels, sizeof(pixels));
+  {
+    RpcController controller(&session);
+    service.StreamPixelFrame(&controller, &frame, NULL, NULL);
+  }
+  DmxBuffer expected;
+  expected.SetFromString("1,2,3,4,5,6");
+  OLA_ASSERT_EQ(expected, universe1->GetDMX());
+  expected.SetFromString("9,8,7,12,11,10");
+  OLA_ASSERT_EQ(expected, universe2->GetDMX());
+
+  // Frames of the wrong size, or for other layouts, are dropped.
+  const uint8_t zeros[sizeof(pixels)] = {0};
+  frame.set_data(zeros, sizeof(zeros) - 1);
+  {
+    RpcController controller(&session);
+    service.StreamPixelFrame(&controller, &frame, NULL, NULL);
+  }
+  frame.set_layout(4);
+  frame.set_data(zeros, sizeof(zeros));
+  {
+    RpcController controller(&session);
+    service.StreamPixelFrame(&controller, &frame, NULL, NULL);
+  }
+  expected.SetFromString("1,2,3,4,5,6");
+  OLA_ASSERT_EQ(expected, universe1->GetDMX());
+
+  // A run outside the frame is rejected.
+  run->set_y(2);
+  done = false;
+  {
+    RpcController controller(&session);
+    service.SetPixelLayout(&controller, &layout, &ack,
+                           NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_TRUE(controller.Failed());
+  }
+
+  // A layout without runs removes it.
+  layout.clear_run();
+  done = false;
+  {
+    RpcController controller(&session);
+    service.SetPixelLayout(&controller, &layout, &ack,
+                           NewSingleCallback(&MarkDone, &done));
+    OLA_ASSERT_TRUE(done);
+    OLA_ASSERT_FALSE(controller.Failed());
+  }
+  OLA_ASSERT_NULL(client.GetPixelMap(3));
+  universe1->RemoveSourceClient(&client);
+  universe2->RemoveSourceClient(&client);
+}
+
+
+/*
+ * Check the RDMBatchCommand method streams results and limits the number of
+ * requests in flight.
+ */
+void OlaServerServiceImplTest::testRDMBatchCommand() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  ClientBroker broker;
+  MockBatchClient client(m_uid);
+  broker.AddClient(&client);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, &broker,
+                               &time1, NULL);
+
+  UID uid(0x7a70, 1);
+  UIDSet uids;
+  uids.AddUID(uid);
+  TestMockRDMOutputPort port(NULL, 1, &uids, true);
+  port.SetRDMHandler(
+      NewCallback(this, &OlaServerServiceImplTest::QueueRDMRequest));
+  Universe *universe = store.GetUniverseOrCreate(1);
+  universe->AddPort(&port);
+  port.SetUniverse(universe);
+  m_pending_rdm.clear();
+
+  ola::proto::RDMBatchRequest request;
+  request.set_batch_id(7);
+  request.set_max_outstanding(2);
+  AddBatchRequest(&request, 1, uid, ola::rdm::PID_DEVICE_INFO);
+  AddBatchRequest(&request, 2, uid, ola::rdm::PID_DEVICE_INFO);
+  AddBatchRequest(&request, 1, uid, ola::rdm::PID_DEVICE_LABEL);
+  AddBatchRequest(&request, 1, uid, ola::rdm::PID_SOFTWARE_VERSION_LABEL);
+
+  RpcSession session(NULL);
+  session.SetData(&client);
+  RpcController controller(&session);
+  ola::proto::RDMBatchReply reply;
+  bool done = false;
+  service.RDMBatchCommand(&controller, &request, &reply,
+                          NewSingleCallback(&MarkDone, &done));
+
+  // Universe 2 doesn't exist, so that request fails straight away. Only two
+  // requests are sent.
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_pending_rdm.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client.results.size());
+  OLA_ASSERT_EQ(1u, client.results[0].index());
+  OLA_ASSERT_EQ(7u, client.results[0].batch_id());
+  OLA_ASSERT_EQ(ola::proto::RDM_FAILED_TO_SEND,
+                client.results[0].response().response_code());
+
+  AckRDMRequest(0);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), client.results.size());
+  OLA_ASSERT_EQ(0u, client.results[1].index());
+  OLA_ASSERT_EQ(ola::proto::RDM_COMPLETED_OK,
+                client.results[1].response().response_code());
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ola::rdm::PID_DEVICE_INFO),
+                client.results[1].response().param_id());
+
+  // The last request is sent once there is space
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_pending_rdm.size());
+  OLA_ASSERT_FALSE(done);
+
+  AckRDMRequest(2);
+  AckRDMRequest(1);
+  OLA_ASSERT_EQ(static_cast<size_t>(4), client.results.size());
+  OLA_ASSERT_EQ(3u, client.results[2].index());
+  OLA_ASSERT_EQ(2u, client.results[3].index());
+  OLA_ASSERT_TRUE(done);
+  OLA_ASSERT_EQ(7u, reply.batch_id());
+  OLA_ASSERT_EQ(4u, reply.result_count());
+
+  port.SetUniverse(NULL);
+  broker.RemoveClient(&client);
+}
+
+
+/*
+ * Check a batch is abandoned if the client disconnects.
+ */
+void OlaServerServiceImplTest::testRDMBatchClientRemoved() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  ClientBroker broker;
+  MockBatchClient client(m_uid);
+  broker.AddClient(&client);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, &broker,
+                               &time1, NULL);
+
+  UID uid(0x7a70, 1);
+  UIDSet uids;
+  uids.AddUID(uid);
+  TestMockRDMOutputPort port(NULL, 1, &uids, true);
+  port.SetRDMHandler(
+      NewCallback(this, &OlaServerServiceImplTest::QueueRDMRequest));
+  Universe *universe = store.GetUniverseOrCreate(1);
+  universe->AddPort(&port);
+  port.SetUniverse(universe);
+  m_pending_rdm.clear();
+
+  ola::proto::RDMBatchRequest request;
+  request.set_batch_id(1);
+  AddBatchRequest(&request, 1, uid, ola::rdm::PID_DEVICE_INFO);
+  AddBatchRequest(&request, 1, uid, ola::rdm::PID_DEVICE_LABEL);
+
+  RpcSession session(NULL);
+  session.SetData(&client);
+  RpcController controller(&session);
+  ola::proto::RDMBatchReply reply;
+  bool done = false;
+  service.RDMBatchCommand(&controller, &request, &reply,
+                          NewSingleCallback(&MarkDone, &done));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_pending_rdm.size());
+
+  broker.RemoveClient(&client);
+  service.ClientRemoved(&client);
+
+  AckRDMRequest(0);
+  AckRDMRequest(1);
+  OLA_ASSERT_TRUE(client.results.empty());
+  OLA_ASSERT_FALSE(done);
+
+  port.SetUniverse(NULL);
+}
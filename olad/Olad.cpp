@@ -32,6 +32,7 @@
 #include <iostream>
 #include <memory>
 
+#include "ola/CallbackPool.h"
 #include "ola/Logging.h"
 #include "ola/base/Credentials.h"
 #include "ola/base/Flags.h"
@@ -48,6 +49,8 @@ using std::endl;
 
 DEFINE_default_bool(http, true, "Disable the HTTP server.");
 DEFINE_default_bool(http_quit, true, "Disable the HTTP /quit handler.");
+DEFINE_default_bool(callback_pool, true,
+                    "Don't reuse the memory of deleted callbacks.");
 #ifndef _WIN32
 DEFINE_s_default_bool(daemon, f, false, "Fork and run in the background.");
 #endif  // _WIN32
@@ -91,6 +94,7 @@ int main(int argc, char *argv[]) {
   ola::ParseFlags(&argc, argv);
 
   ola::InitLoggingFromFlags();
+  ola::SetCallbackPoolEnabled(FLAGS_callback_pool);
   OLA_INFO << "OLA Daemon version " << ola::base::Version::GetVersion();
 
   #ifndef OLAD_SKIP_ROOT_CHECK
@@ -32,6 +32,7 @@
 #include "ola/dmx/SourcePriorities.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/web/Json.h"
+#include "ola/web/JsonStreamWriter.h"
 #include "olad/DmxSource.h"
 #include "olad/HttpServerActions.h"
 #include "olad/OladHTTPServer.h"
@@ -46,18 +47,49 @@ using ola::client::OlaOutputPort;
 using ola::client::OlaPlugin;
 using ola::client::OlaPort;
 using ola::client::OlaUniverse;
+using ola::http::HTTPEventStream;
 using ola::http::HTTPRequest;
 using ola::http::HTTPResponse;
 using ola::http::HTTPServer;
 using ola::io::ConnectedDescriptor;
 using ola::web::JsonArray;
 using ola::web::JsonObject;
+using ola::web::JsonStreamWriter;
 using std::cout;
 using std::endl;
 using std::ostringstream;
 using std::string;
 using std::vector;
 
+namespace {
+
+/*
+ * Base64 encode some data, this is more compact than the JSON array used by
+ * /get_dmx.
+ */
+string Base64Encode(const uint8_t *data, unsigned int length) {
+  static const char ALPHABET[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  string output;
+  output.reserve((length + 2) / 3 * 4);
+  for (unsigned int i = 0; i < length; i += 3) {
+    unsigned int remaining = length - i;
+    uint32_t chunk = data[i] << 16;
+    if (remaining > 1) {
+      chunk |= data[i + 1] << 8;
+    }
+    if (remaining > 2) {
+      chunk |= data[i + 2];
+    }
+    output.push_back(ALPHABET[(chunk >> 18) & 0x3f]);
+    output.push_back(ALPHABET[(chunk >> 12) & 0x3f]);
+    output.push_back(remaining > 1 ? ALPHABET[(chunk >> 6) & 0x3f] : '=');
+    output.push_back(remaining > 2 ? ALPHABET[chunk & 0x3f] : '=');
+  }
+  return output;
+}
+}  // namespace
+
 const char OladHTTPServer::HELP_PARAMETER[] = "help";
 const char OladHTTPServer::HELP_REDIRECTION[] = "?help=1";
 const char OladHTTPServer::K_BACKEND_DISCONNECTED_ERROR[] =
@@ -95,6 +127,7 @@ OladHTTPServer::OladHTTPServer(ExportMap *export_map,
   RegisterHandler("/set_plugin_state", &OladHTTPServer::SetPluginState);
   RegisterHandler("/set_dmx", &OladHTTPServer::HandleSetDmx);
   RegisterHandler("/get_dmx", &OladHTTPServer::GetDmx);
+  RegisterHandler("/stream_dmx", &OladHTTPServer::StreamDmx);
 
   // json endpoints for the new UI
   RegisterHandler("/json/server_stats", &OladHTTPServer::JsonServerStats);
@@ -383,6 +416,17 @@ OladHTTPServer::OladHTTPServer(ExportMap *export_map,
  * @brief Teardown
  */
 OladHTTPServer::~OladHTTPServer() {
+  // MHD deletes the streams when it's stopped, which is after we're gone.
+  DMXStreamMap::iterator iter = m_dmx_streams.begin();
+  for (; iter != m_dmx_streams.end(); ++iter) {
+    EventStreamSet::iterator stream_iter = iter->second.begin();
+    for (; stream_iter != iter->second.end(); ++stream_iter) {
+      (*stream_iter)->SetOnClose(NULL);
+      (*stream_iter)->Close();
+    }
+  }
+  m_dmx_streams.clear();
+
   if (m_client_socket) {
     m_server.SelectServer()->RemoveReadDescriptor(m_client_socket);
   }
@@ -405,6 +449,10 @@ bool OladHTTPServer::Init() {
   if (!m_client.Setup()) {
     return false;
   }
+  // DMX streams only need the latest frame, so let olad drop the rest.
+  m_client.SetUpdateRateLimit(K_DMX_STREAM_MAX_RATE, 0);
+  m_client.SetDMXCallback(
+      NewCallback(this, &OladHTTPServer::HandleStreamDmx));
   /*
   Setup disconnect notifications.
   m_socket->SetOnClose(
@@ -441,7 +489,8 @@ int OladHTTPServer::JsonServerStats(const HTTPRequest*,
   strftime(start_time_str, sizeof(start_time_str), "%c", &start_time);
 #endif  // _WIN32
 
-  JsonObject json;
+  JsonStreamWriter json;
+  json.StartObject();
   json.Add("hostname", ola::network::FQDN());
   json.Add("instance_name", m_ola_server->InstanceName());
   json.Add("config_dir",
@@ -453,6 +502,7 @@ int OladHTTPServer::JsonServerStats(const HTTPRequest*,
   json.Add("version", ola::base::Version::GetVersion());
   json.Add("up_since", start_time_str);
   json.Add("quit_enabled", m_enable_quit);
+  json.EndObject();
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
@@ -733,6 +783,65 @@ int OladHTTPServer::GetDmx(const HTTPRequest *request,
 }
 
 
+/**
+ * @brief Stream the DMX data for one or more universes as Server-Sent Events.
+ *
+ * Each frame is sent as a dmx event, with data of the form
+ * {"universe": 1, "dmx": "[base64 encoded slots]"}. Frames are limited to
+ * K_DMX_STREAM_MAX_RATE per second for each universe.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int OladHTTPServer::StreamDmx(const HTTPRequest *request,
+                              HTTPResponse *response) {
+  if (request->CheckParameterExists(HELP_PARAMETER)) {
+    return ServeUsage(response, "?u=[universe],[universe],...");
+  }
+
+  vector<string> universe_ids;
+  StringSplit(request->GetParameter("u"), &universe_ids, ",");
+  if (universe_ids.empty() ||
+      universe_ids.size() > K_DMX_STREAM_UNIVERSE_LIMIT) {
+    return ServeHelpRedirect(response);
+  }
+
+  vector<unsigned int> universes;
+  vector<string>::const_iterator iter = universe_ids.begin();
+  for (; iter != universe_ids.end(); ++iter) {
+    unsigned int universe_id;
+    if (!StringToInt(*iter, &universe_id)) {
+      return ServeHelpRedirect(response);
+    }
+    universes.push_back(universe_id);
+  }
+
+  HTTPEventStream *stream = new HTTPEventStream();
+  stream->SetOnClose(NewSingleCallback(
+      this, &OladHTTPServer::DmxStreamClosed, stream, universes));
+
+  vector<unsigned int>::const_iterator universe_iter = universes.begin();
+  for (; universe_iter != universes.end(); ++universe_iter) {
+    EventStreamSet &streams = m_dmx_streams[*universe_iter];
+    if (streams.empty()) {
+      m_client.RegisterUniverse(
+          *universe_iter, ola::client::REGISTER,
+          NewSingleCallback(this, &OladHTTPServer::HandleStreamRegistration,
+                            *universe_iter));
+    }
+    streams.insert(stream);
+    // Start with the current frame, rather than waiting for the next one.
+    m_client.FetchDMX(
+        *universe_iter,
+        NewSingleCallback(this, &OladHTTPServer::HandleStreamFetch));
+  }
+
+  int r = response->SendEventStream(stream);
+  delete response;
+  return r;
+}
+
+
 /**
  * @brief Handle the set DMX command
  * @param request the HTTPRequest
@@ -835,7 +944,7 @@ void OladHTTPServer::HandlePluginList(HTTPResponse *response,
     return;
   }
 
-  JsonObject *json = new JsonObject();
+  JsonStreamWriter *json = new JsonStreamWriter();
 
   // fire off the universe request now. the main server is running in a
   // separate thread.
@@ -845,42 +954,48 @@ void OladHTTPServer::HandlePluginList(HTTPResponse *response,
                         response,
                         json));
 
-  JsonArray *plugins_json = json->AddArray("plugins");
+  json->StartObject();
+  json->StartArray("plugins");
   vector<OlaPlugin>::const_iterator iter;
   for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
-    JsonObject *plugin = plugins_json->AppendObject();
-    plugin->Add("name", iter->Name());
-    plugin->Add("id", iter->Id());
-    plugin->Add("active", iter->IsActive());
-    plugin->Add("enabled", iter->IsEnabled());
+    json->StartObject();
+    json->Add("name", iter->Name());
+    json->Add("id", iter->Id());
+    json->Add("active", iter->IsActive());
+    json->Add("enabled", iter->IsEnabled());
+    json->EndObject();
   }
+  json->EndArray();
 }
 
 
 /**
  * @brief Handle the universe list callback
  * @param response the HTTPResponse that is associated with the request.
- * @param json the JsonObject to add the data to
+ * @param json the JsonStreamWriter to add the data to, the top level object
+ *   is still open.
  * @param result the result of the API call
  * @param universes the vector of OlaUniverse
  */
 void OladHTTPServer::HandleUniverseList(HTTPResponse *response,
-                                        JsonObject *json,
+                                        JsonStreamWriter *json,
                                         const client::Result &result,
                                         const vector<OlaUniverse> &universes) {
   if (result.Success()) {
-    JsonArray *universe_json = json->AddArray("universes");
-
+    json->StartArray("universes");
     vector<OlaUniverse>::const_iterator iter;
     for (iter = universes.begin(); iter != universes.end(); ++iter) {
-      JsonObject *universe = universe_json->AppendObject();
-      universe->Add("id", iter->Id());
-      universe->Add("input_ports", iter->InputPortCount());
-      universe->Add("name", iter->Name());
-      universe->Add("output_ports", iter->OutputPortCount());
-      universe->Add("rdm_devices", iter->RDMDeviceCount());
+      json->StartObject();
+      json->Add("id", iter->Id());
+      json->Add("input_ports", iter->InputPortCount());
+      json->Add("name", iter->Name());
+      json->Add("output_ports", iter->OutputPortCount());
+      json->Add("rdm_devices", iter->RDMDeviceCount());
+      json->EndObject();
     }
+    json->EndArray();
   }
+  json->EndObject();
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
@@ -1182,11 +1297,12 @@ void OladHTTPServer::HandleGetDmx(HTTPResponse *response,
                                   const client::DMXMetadata &,
                                   const DmxBuffer &buffer) {
   // rather than adding 512 JsonValue we cheat and use raw here
-  ostringstream str;
-  str << "[" << buffer.ToString() << "]";
-  JsonObject json;
-  json.AddRaw("dmx", str.str());
+  JsonStreamWriter json;
+  json.StartObject();
+  json.Key("dmx");
+  json.Raw("[" + buffer.ToString() + "]");
   json.Add("error", result.Error());
+  json.EndObject();
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
@@ -1213,6 +1329,73 @@ void OladHTTPServer::HandleBoolResponse(HTTPResponse *response,
 }
 
 
+/**
+ * @brief Called when new DMX data arrives for a universe with streams.
+ */
+void OladHTTPServer::HandleStreamDmx(const client::DMXMetadata &metadata,
+                                     const DmxBuffer &buffer) {
+  DMXStreamMap::iterator iter = m_dmx_streams.find(metadata.universe);
+  if (iter == m_dmx_streams.end()) {
+    return;
+  }
+
+  ostringstream str;
+  str << "{\"universe\": " << metadata.universe << ", \"dmx\": \""
+      << Base64Encode(buffer.GetRaw(), buffer.Size()) << "\"}";
+  const string data = str.str();
+
+  EventStreamSet::iterator stream_iter = iter->second.begin();
+  for (; stream_iter != iter->second.end(); ++stream_iter) {
+    // A slow client misses frames, it doesn't queue them.
+    (*stream_iter)->SendEvent("dmx", data);
+  }
+}
+
+
+/**
+ * @brief Send the current frame to the streams for a universe.
+ */
+void OladHTTPServer::HandleStreamFetch(const client::Result &result,
+                                       const client::DMXMetadata &metadata,
+                                       const DmxBuffer &buffer) {
+  if (result.Success()) {
+    HandleStreamDmx(metadata, buffer);
+  }
+}
+
+
+void OladHTTPServer::HandleStreamRegistration(unsigned int universe,
+                                              const client::Result &result) {
+  if (!result.Success()) {
+    OLA_WARN << "Failed to register for universe " << universe << ": "
+             << result.Error();
+  }
+}
+
+
+/**
+ * @brief Called when the connection for a DMX stream closes.
+ */
+void OladHTTPServer::DmxStreamClosed(HTTPEventStream *stream,
+                                     vector<unsigned int> universes) {
+  vector<unsigned int>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    DMXStreamMap::iterator streams = m_dmx_streams.find(*iter);
+    if (streams == m_dmx_streams.end()) {
+      continue;
+    }
+    streams->second.erase(stream);
+    if (streams->second.empty()) {
+      m_dmx_streams.erase(streams);
+      m_client.RegisterUniverse(
+          *iter, ola::client::UNREGISTER,
+          NewSingleCallback(this, &OladHTTPServer::HandleStreamRegistration,
+                            *iter));
+    }
+  }
+}
+
+
 /**
  * @brief Add the json representation of this port to the ostringstream
  */
@@ -22,6 +22,8 @@
 #define OLAD_OLADHTTPSERVER_H_
 
 #include <time.h>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include "ola/ExportMap.h"
@@ -83,6 +85,8 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
              ola::http::HTTPResponse *response);
   int HandleSetDmx(const ola::http::HTTPRequest *request,
                    ola::http::HTTPResponse *response);
+  int StreamDmx(const ola::http::HTTPRequest *request,
+                ola::http::HTTPResponse *response);
   int DisplayQuit(const ola::http::HTTPRequest *request,
                   ola::http::HTTPResponse *response);
   int ReloadPlugins(const ola::http::HTTPRequest *request,
@@ -95,7 +99,7 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
                         const std::vector<client::OlaPlugin> &plugins);
 
   void HandleUniverseList(ola::http::HTTPResponse *response,
-                          ola::web::JsonObject *json,
+                          ola::web::JsonStreamWriter *json,
                           const client::Result &result,
                           const std::vector<client::OlaUniverse> &universes);
 
@@ -159,6 +163,11 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
   RDMHTTPModule m_rdm_module;
   time_t m_start_time_t;
 
+  typedef std::set<ola::http::HTTPEventStream*> EventStreamSet;
+  typedef std::map<unsigned int, EventStreamSet> DMXStreamMap;
+  // The event streams for each universe, see StreamDmx().
+  DMXStreamMap m_dmx_streams;
+
   void HandleGetDmx(ola::http::HTTPResponse *response,
                     const client::Result &result,
                     const client::DMXMetadata &metadata,
@@ -167,6 +176,16 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
   void HandleBoolResponse(ola::http::HTTPResponse *response,
                           const client::Result &result);
 
+  void HandleStreamDmx(const client::DMXMetadata &metadata,
+                       const DmxBuffer &buffer);
+  void HandleStreamFetch(const client::Result &result,
+                         const client::DMXMetadata &metadata,
+                         const DmxBuffer &buffer);
+  void HandleStreamRegistration(unsigned int universe,
+                                const client::Result &result);
+  void DmxStreamClosed(ola::http::HTTPEventStream *stream,
+                       std::vector<unsigned int> universes);
+
   void PortToJson(ola::web::JsonObject *object,
                   const client::OlaDevice &device,
                   const client::OlaPort &port,
@@ -200,6 +219,9 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
   static const unsigned int K_UNIVERSE_NAME_LIMIT = 100;
   static const char K_PRIORITY_VALUE_SUFFIX[];
   static const char K_PRIORITY_MODE_SUFFIX[];
+  // The maximum frame rate of each universe in a DMX stream.
+  static const unsigned int K_DMX_STREAM_MAX_RATE = 25;
+  static const unsigned int K_DMX_STREAM_UNIVERSE_LIMIT = 64;
 
   DISALLOW_COPY_AND_ASSIGN(OladHTTPServer);
 };
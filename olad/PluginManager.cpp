@@ -22,6 +22,7 @@
 
 #include <set>
 #include <vector>
+#include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/stl/STLUtils.h"
 #include "olad/Plugin.h"
@@ -36,7 +37,8 @@ using std::set;
 PluginManager::PluginManager(const vector<PluginLoader*> &plugin_loaders,
                              class PluginAdaptor *plugin_adaptor)
     : m_plugin_loaders(plugin_loaders),
-      m_plugin_adaptor(plugin_adaptor) {
+      m_plugin_adaptor(plugin_adaptor),
+      m_start_scheduled(false) {
 }
 
 PluginManager::~PluginManager() {
@@ -44,6 +46,26 @@ PluginManager::~PluginManager() {
 }
 
 void PluginManager::LoadAll() {
+  LoadPlugins();
+
+  // The second pass checks for conflicts and starts each plugin
+  PluginMap::iterator plugin_iter = m_enabled_plugins.begin();
+  for (; plugin_iter != m_enabled_plugins.end(); ++plugin_iter) {
+    StartIfSafe(plugin_iter->second);
+  }
+}
+
+void PluginManager::LoadAllIncrementally() {
+  LoadPlugins();
+
+  PluginMap::iterator plugin_iter = m_enabled_plugins.begin();
+  for (; plugin_iter != m_enabled_plugins.end(); ++plugin_iter) {
+    m_pending_starts.push_back(plugin_iter->first);
+  }
+  ScheduleNextStart();
+}
+
+void PluginManager::LoadPlugins() {
   m_enabled_plugins.clear();
 
   // The first pass populates the m_plugin map, and builds a list of enabled
@@ -76,15 +98,10 @@ void PluginManager::LoadAll() {
       STLInsertIfNotPresent(&m_enabled_plugins, plugin->Id(), plugin);
     }
   }
-
-  // The second pass checks for conflicts and starts each plugin
-  PluginMap::iterator plugin_iter = m_enabled_plugins.begin();
-  for (; plugin_iter != m_enabled_plugins.end(); ++plugin_iter) {
-    StartIfSafe(plugin_iter->second);
-  }
 }
 
 void PluginManager::UnloadAll() {
+  m_pending_starts.clear();
   PluginMap::iterator plugin_iter = m_loaded_plugins.begin();
   for (; plugin_iter != m_loaded_plugins.end(); ++plugin_iter) {
     plugin_iter->second->Stop();
@@ -182,6 +199,35 @@ void PluginManager::GetConflictList(ola_plugin_id plugin_id,
   }
 }
 
+void PluginManager::ScheduleNextStart() {
+  // A reload may queue more plugins while a start is already scheduled.
+  if (m_pending_starts.empty() || m_start_scheduled) {
+    return;
+  }
+  m_start_scheduled = true;
+  m_plugin_adaptor->Execute(
+      NewSingleCallback(this, &PluginManager::StartNextPlugin));
+}
+
+/*
+ * Start the next pending plugin, unless it's been started or disabled over
+ * RPC since it was queued.
+ */
+void PluginManager::StartNextPlugin() {
+  m_start_scheduled = false;
+  if (m_pending_starts.empty()) {
+    return;
+  }
+  ola_plugin_id plugin_id = m_pending_starts.front();
+  m_pending_starts.pop_front();
+
+  AbstractPlugin *plugin = STLFindOrNull(m_enabled_plugins, plugin_id);
+  if (plugin && !STLContains(m_active_plugins, plugin_id)) {
+    StartIfSafe(plugin);
+  }
+  ScheduleNextStart();
+}
+
 bool PluginManager::StartIfSafe(AbstractPlugin *plugin) {
   AbstractPlugin *conflicting_plugin = CheckForRunningConflicts(plugin);
   if (conflicting_plugin) {
@@ -21,6 +21,7 @@
 #ifndef OLAD_PLUGINMANAGER_H_
 #define OLAD_PLUGINMANAGER_H_
 
+#include <deque>
 #include <map>
 #include <vector>
 
@@ -71,6 +72,17 @@ class PluginManager {
    */
   void LoadAll();
 
+  /**
+   * @brief Load all the plugins, and start them one at a time from the
+   * PluginAdaptor's Execute() queue.
+   *
+   * This returns once the plugins are loaded. The SelectServer handles I/O
+   * between each plugin start, so RPC and HTTP clients are served while
+   * slow plugins probe for hardware. Conflicts are checked as each plugin is
+   * started, in the same order as LoadAll().
+   */
+  void LoadAllIncrementally();
+
   /**
    * Unload all the plugins.
    */
@@ -150,7 +162,13 @@ class PluginManager {
   PluginMap m_active_plugins;  // active plugins
   PluginMap m_enabled_plugins;  // enabled plugins
   PluginAdaptor *m_plugin_adaptor;
+  // Plugins waiting to be started by LoadAllIncrementally().
+  std::deque<ola_plugin_id> m_pending_starts;
+  bool m_start_scheduled;
 
+  void LoadPlugins();
+  void ScheduleNextStart();
+  void StartNextPlugin();
   bool StartIfSafe(AbstractPlugin *plugin);
   AbstractPlugin* CheckForRunningConflicts(const AbstractPlugin *plugin) const;
 
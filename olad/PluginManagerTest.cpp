@@ -29,6 +29,7 @@
 #include "olad/PluginManager.h"
 #include "olad/Preferences.h"
 #include "olad/plugin_api/TestCommon.h"
+#include "ola/io/SelectServer.h"
 #include "ola/testing/TestUtils.h"
 
 
@@ -44,11 +45,13 @@ class PluginManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PluginManagerTest);
   CPPUNIT_TEST(testPluginManager);
   CPPUNIT_TEST(testConflictingPlugins);
+  CPPUNIT_TEST(testIncrementalStart);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testPluginManager();
     void testConflictingPlugins();
+    void testIncrementalStart();
 
     void setUp() {
       ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
@@ -181,3 +184,56 @@ void PluginManagerTest::testConflictingPlugins() {
   manager.UnloadAll();
   VerifyPluginCounts(&manager, 0, 0, OLA_SOURCELINE());
 }
+
+
+/*
+ * Check that LoadAllIncrementally starts one plugin per loop iteration.
+ */
+void PluginManagerTest::testIncrementalStart() {
+  ola::MemoryPreferencesFactory factory;
+  ola::io::SelectServer ss;
+  ola::PluginAdaptor adaptor(NULL, &ss, NULL, &factory, NULL, NULL);
+
+  set<ola::ola_plugin_id> conflict_set;
+  conflict_set.insert(ola::OLA_PLUGIN_ARTNET);
+  TestMockPlugin plugin1(&adaptor, ola::OLA_PLUGIN_DUMMY, conflict_set);
+  TestMockPlugin plugin2(&adaptor, ola::OLA_PLUGIN_ARTNET);
+  TestMockPlugin plugin3(&adaptor, ola::OLA_PLUGIN_SHOWNET);
+  TestMockPlugin plugin4(&adaptor, ola::OLA_PLUGIN_SANDNET);
+
+  vector<AbstractPlugin*> our_plugins;
+  our_plugins.push_back(&plugin1);
+  our_plugins.push_back(&plugin2);
+  our_plugins.push_back(&plugin3);
+  our_plugins.push_back(&plugin4);
+
+  MockLoader loader(our_plugins);
+  vector<PluginLoader*> loaders;
+  loaders.push_back(&loader);
+
+  PluginManager manager(loaders, &adaptor);
+  manager.LoadAllIncrementally();
+  VerifyPluginCounts(&manager, 4, 0, OLA_SOURCELINE());
+
+  // The plugins are started in ID order, so the dummy plugin is first.
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  VerifyPluginCounts(&manager, 4, 1, OLA_SOURCELINE());
+  OLA_ASSERT_TRUE(plugin1.IsRunning());
+
+  // Start sandnet out of turn, and disable shownet before it's started.
+  OLA_ASSERT_TRUE(manager.EnableAndStartPlugin(ola::OLA_PLUGIN_SANDNET));
+  manager.DisableAndStopPlugin(ola::OLA_PLUGIN_SHOWNET);
+  VerifyPluginCounts(&manager, 4, 2, OLA_SOURCELINE());
+
+  // Art-Net conflicts with the dummy plugin, so it's skipped.
+  for (unsigned int i = 0; i < 3; i++) {
+    ss.RunOnce(ola::TimeInterval(0, 0));
+  }
+  VerifyPluginCounts(&manager, 4, 2, OLA_SOURCELINE());
+  OLA_ASSERT_FALSE(plugin2.IsRunning());
+  OLA_ASSERT_FALSE(plugin3.IsRunning());
+  OLA_ASSERT_TRUE(plugin4.IsRunning());
+
+  manager.UnloadAll();
+  VerifyPluginCounts(&manager, 0, 0, OLA_SOURCELINE());
+}
@@ -42,6 +42,7 @@
 #include "ola/thread/Mutex.h"
 #include "ola/web/Json.h"
 #include "ola/web/JsonSections.h"
+#include "ola/web/JsonStreamWriter.h"
 #include "olad/OlaServer.h"
 #include "olad/OladHTTPServer.h"
 #include "olad/RDMHTTPModule.h"
@@ -62,6 +63,7 @@ using ola::web::HiddenItem;
 using ola::web::JsonArray;
 using ola::web::JsonObject;
 using ola::web::JsonSection;
+using ola::web::JsonStreamWriter;
 using ola::web::SelectItem;
 using ola::web::StringItem;
 using ola::web::UIntItem;
@@ -73,6 +75,23 @@ using std::set;
 using std::string;
 using std::vector;
 
+namespace {
+/*
+ * The status to pass to a response handler if the request couldn't be sent.
+ */
+ola::rdm::ResponseStatus SendFailedStatus(const string &error) {
+  ola::rdm::ResponseStatus status;
+  status.error = error.empty() ? "Unable to send RDM command" : error;
+  status.response_code = ola::rdm::RDM_FAILED_TO_SEND;
+  status.response_type = 0;
+  status.message_count = 0;
+  status.m_param = 0;
+  status.set_command = false;
+  status.pid_value = 0;
+  return status;
+}
+}  // namespace
+
 
 const char RDMHTTPModule::BACKEND_DISCONNECTED_ERROR[] =
     "Failed to send request, client isn't connected";
@@ -434,7 +453,7 @@ int RDMHTTPModule::JsonSupportedPIDs(const HTTPRequest *request,
  * @brief Return a list of sections to display in the RDM control panel.
  *
  * We use the response from SUPPORTED_PARAMS and DEVICE_INFO to decide which
- * PIDs exist.
+ * PIDs exist. The two GETs are independent so they're sent together.
  * @param request the HTTPRequest
  * @param response the HTTPResponse
  * @returns MHD_NO or MHD_YES
@@ -455,22 +474,37 @@ int RDMHTTPModule::JsonSupportedSections(const HTTPRequest *request,
     return OladHTTPServer::ServeHelpRedirect(response);
   }
 
+  sections_info *info = new sections_info();
+  info->response = response;
+  info->outstanding = 2;
+
+  // info may be deleted once the last request has been sent.
   string error;
-  bool ok = m_rdm_api.GetSupportedParameters(
-      universe_id,
-      *uid,
-      ola::rdm::ROOT_RDM_DEVICE,
-      NewSingleCallback(this,
-                        &RDMHTTPModule::SupportedSectionsHandler,
-                        response,
-                        universe_id,
-                        *uid),
-      &error);
-  delete uid;
+  if (!m_rdm_api.GetSupportedParameters(
+          universe_id,
+          *uid,
+          ola::rdm::ROOT_RDM_DEVICE,
+          NewSingleCallback(this,
+                            &RDMHTTPModule::SupportedSectionsHandler,
+                            info),
+          &error)) {
+    SupportedSectionsHandler(info, SendFailedStatus(error),
+                             vector<uint16_t>());
+  }
 
-  if (!ok) {
-    return m_server->ServeError(response, BACKEND_DISCONNECTED_ERROR);
+  error.clear();
+  if (!m_rdm_api.GetDeviceInfo(
+          universe_id,
+          *uid,
+          ola::rdm::ROOT_RDM_DEVICE,
+          NewSingleCallback(this,
+                            &RDMHTTPModule::SupportedSectionsDeviceInfoHandler,
+                            info),
+          &error)) {
+    SupportedSectionsDeviceInfoHandler(info, SendFailedStatus(error),
+                                       ola::rdm::DeviceDescriptor());
   }
+  delete uid;
   return MHD_YES;
 }
 
@@ -713,9 +747,10 @@ void RDMHTTPModule::HandleUIDList(HTTPResponse *response,
        uid_iter != uid_state->resolved_uids.end(); ++uid_iter)
     uid_iter->second.active = false;
 
-  JsonObject json;
+  JsonStreamWriter json;
+  json.StartObject();
   json.Add("universe", universe_id);
-  JsonArray *json_uids = json.AddArray("uids");
+  json.StartArray("uids");
 
   for (; iter != uids.End(); ++iter) {
     uid_iter = uid_state->resolved_uids.find(*iter);
@@ -736,13 +771,16 @@ void RDMHTTPModule::HandleUIDList(HTTPResponse *response,
       uid_iter->second.active = true;
     }
 
-    JsonObject *json_uid = json_uids->AppendObject();
-    json_uid->Add("manufacturer_id", iter->ManufacturerId());
-    json_uid->Add("device_id", iter->DeviceId());
-    json_uid->Add("device", device);
-    json_uid->Add("manufacturer", manufacturer);
-    json_uid->Add("uid", iter->ToString());
+    json.StartObject();
+    json.Add("manufacturer_id", iter->ManufacturerId());
+    json.Add("device_id", iter->DeviceId());
+    json.Add("device", device);
+    json.Add("manufacturer", manufacturer);
+    json.Add("uid", iter->ToString());
+    json.EndObject();
   }
+  json.EndArray();
+  json.EndObject();
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
@@ -1001,48 +1039,55 @@ void RDMHTTPModule::SupportedParamsHandler(
 
 
 /**
- * @brief Takes the supported PIDs for a device and come up with the list of
- * sections to display in the RDM panel
+ * @brief Handle the supported PIDs part of the supported sections request.
  */
 void RDMHTTPModule::SupportedSectionsHandler(
-    HTTPResponse *response,
-    unsigned int universe_id,
-    UID uid,
+    sections_info *info,
     const ola::rdm::ResponseStatus &status,
-    const vector<uint16_t> &pid_list) {
-  string error;
-
-  // nacks here are ok if the device doesn't support SUPPORTED_PARAMS
-  if (!CheckForRDMSuccess(status) && !status.WasNacked()) {
-    m_server->ServeError(response, BACKEND_DISCONNECTED_ERROR + error);
-    return;
+    const vector<uint16_t> &pids) {
+  info->pid_status = status;
+  info->pids = pids;
+  if (--info->outstanding == 0) {
+    SendSupportedSections(info);
   }
-
-  m_rdm_api.GetDeviceInfo(
-      universe_id,
-      uid,
-      ola::rdm::ROOT_RDM_DEVICE,
-      NewSingleCallback(this,
-                        &RDMHTTPModule::SupportedSectionsDeviceInfoHandler,
-                        response,
-                        pid_list),
-      &error);
-  if (!error.empty())
-    m_server->ServeError(response, BACKEND_DISCONNECTED_ERROR + error);
 }
 
 
 /**
- * @brief Handle the second part of the supported sections request.
+ * @brief Handle the device info part of the supported sections request.
  */
 void RDMHTTPModule::SupportedSectionsDeviceInfoHandler(
-    HTTPResponse *response,
-    const vector<uint16_t> pid_list,
+    sections_info *info,
     const ola::rdm::ResponseStatus &status,
     const ola::rdm::DeviceDescriptor &device) {
+  info->device_status = status;
+  info->device = device;
+  if (--info->outstanding == 0) {
+    SendSupportedSections(info);
+  }
+}
+
+
+/**
+ * @brief Takes the supported PIDs for a device and come up with the list of
+ * sections to display in the RDM panel
+ */
+void RDMHTTPModule::SendSupportedSections(sections_info *info) {
+  HTTPResponse *response = info->response;
+  const ola::rdm::ResponseStatus &status = info->device_status;
+  const ola::rdm::DeviceDescriptor &device = info->device;
+
+  // nacks here are ok if the device doesn't support SUPPORTED_PARAMS
+  if (!CheckForRDMSuccess(info->pid_status) &&
+      !info->pid_status.WasNacked()) {
+    m_server->ServeError(response, BACKEND_DISCONNECTED_ERROR);
+    delete info;
+    return;
+  }
+
   vector<section_info> sections;
   std::set<uint16_t> pids;
-  copy(pid_list.begin(), pid_list.end(), inserter(pids, pids.end()));
+  copy(info->pids.begin(), info->pids.end(), inserter(pids, pids.end()));
 
   // PID_DEVICE_INFO is required so we always add it
   string hint;
@@ -1193,6 +1238,7 @@ void RDMHTTPModule::SupportedSectionsDeviceInfoHandler(
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
   response->SendJson(json);
   delete response;
+  delete info;
 }
 
 
@@ -1323,25 +1369,59 @@ void RDMHTTPModule::ProxiedDevicesHandler(
 
 /*
  * @brief Handle the request for the device info section.
+ *
+ * The software version, device model and device info GETs are all sent at
+ * once.
  */
 string RDMHTTPModule::GetDeviceInfo(const HTTPRequest *request,
                                     HTTPResponse *response,
                                     unsigned int universe_id,
                                     const UID &uid) {
-  string hint = request->GetParameter(HINT_KEY);
+  const bool include_model =
+      request->GetParameter(HINT_KEY).find('m') != string::npos;
+  device_info *dev_info = new device_info(response, uid);
+  dev_info->outstanding = include_model ? 3 : 2;
+
+  // dev_info may be deleted once the last request has been sent.
   string error;
-  device_info dev_info = {universe_id, uid, hint, "", ""};
+  if (!m_rdm_api.GetSoftwareVersionLabel(
+          universe_id,
+          uid,
+          ola::rdm::ROOT_RDM_DEVICE,
+          NewSingleCallback(this,
+                            &RDMHTTPModule::GetSoftwareVersionHandler,
+                            dev_info),
+          &error)) {
+    GetSoftwareVersionHandler(dev_info, SendFailedStatus(error), "");
+  }
+
+  if (include_model) {
+    error.clear();
+    if (!m_rdm_api.GetDeviceModelDescription(
+            universe_id,
+            uid,
+            ola::rdm::ROOT_RDM_DEVICE,
+            NewSingleCallback(this,
+                              &RDMHTTPModule::GetDeviceModelHandler,
+                              dev_info),
+            &error)) {
+      GetDeviceModelHandler(dev_info, SendFailedStatus(error), "");
+    }
+  }
 
-  m_rdm_api.GetSoftwareVersionLabel(
-    universe_id,
-    uid,
-    ola::rdm::ROOT_RDM_DEVICE,
-    NewSingleCallback(this,
-                      &RDMHTTPModule::GetSoftwareVersionHandler,
-                      response,
-                      dev_info),
-    &error);
-  return error;
+  error.clear();
+  if (!m_rdm_api.GetDeviceInfo(
+          universe_id,
+          uid,
+          ola::rdm::ROOT_RDM_DEVICE,
+          NewSingleCallback(this,
+                            &RDMHTTPModule::GetDeviceInfoHandler,
+                            dev_info),
+          &error)) {
+    GetDeviceInfoHandler(dev_info, SendFailedStatus(error),
+                         ola::rdm::DeviceDescriptor());
+  }
+  return "";
 }
 
 
@@ -1349,40 +1429,14 @@ string RDMHTTPModule::GetDeviceInfo(const HTTPRequest *request,
  * @brief Handle the response to a software version call.
  */
 void RDMHTTPModule::GetSoftwareVersionHandler(
-    HTTPResponse *response,
-    device_info dev_info,
+    device_info *dev_info,
     const ola::rdm::ResponseStatus &status,
     const string &software_version) {
-  string error;
-
   if (CheckForRDMSuccess(status)) {
-    dev_info.software_version = software_version;
-  }
-
-  if (dev_info.hint.find('m') != string::npos) {
-    m_rdm_api.GetDeviceModelDescription(
-        dev_info.universe_id,
-        dev_info.uid,
-        ola::rdm::ROOT_RDM_DEVICE,
-        NewSingleCallback(this,
-                          &RDMHTTPModule::GetDeviceModelHandler,
-                          response,
-                          dev_info),
-        &error);
-  } else {
-    m_rdm_api.GetDeviceInfo(
-        dev_info.universe_id,
-        dev_info.uid,
-        ola::rdm::ROOT_RDM_DEVICE,
-        NewSingleCallback(this,
-                          &RDMHTTPModule::GetDeviceInfoHandler,
-                          response,
-                          dev_info),
-        &error);
+    dev_info->software_version = software_version;
   }
-
-  if (!error.empty()) {
-    m_server->ServeError(response, BACKEND_DISCONNECTED_ERROR + error);
+  if (--dev_info->outstanding == 0) {
+    SendDeviceInfoSection(dev_info);
   }
 }
 
@@ -1391,43 +1445,43 @@ void RDMHTTPModule::GetSoftwareVersionHandler(
  * @brief Handle the response to a device model call.
  */
 void RDMHTTPModule::GetDeviceModelHandler(
-    HTTPResponse *response,
-    device_info dev_info,
+    device_info *dev_info,
     const ola::rdm::ResponseStatus &status,
     const string &device_model) {
-  string error;
-
   if (CheckForRDMSuccess(status)) {
-    dev_info.device_model = device_model;
+    dev_info->device_model = device_model;
   }
-
-  m_rdm_api.GetDeviceInfo(
-      dev_info.universe_id,
-      dev_info.uid,
-      ola::rdm::ROOT_RDM_DEVICE,
-      NewSingleCallback(this,
-                        &RDMHTTPModule::GetDeviceInfoHandler,
-                        response,
-                        dev_info),
-      &error);
-
-  if (!error.empty()) {
-    m_server->ServeError(response, BACKEND_DISCONNECTED_ERROR + error);
+  if (--dev_info->outstanding == 0) {
+    SendDeviceInfoSection(dev_info);
   }
 }
 
 
 /**
- * @brief Handle the response to a device info call and build the response
+ * @brief Handle the response to a device info call.
  */
 void RDMHTTPModule::GetDeviceInfoHandler(
-    HTTPResponse *response,
-    device_info dev_info,
+    device_info *dev_info,
     const ola::rdm::ResponseStatus &status,
     const ola::rdm::DeviceDescriptor &device) {
+  dev_info->device_status = status;
+  dev_info->device = device;
+  if (--dev_info->outstanding == 0) {
+    SendDeviceInfoSection(dev_info);
+  }
+}
+
+
+/**
+ * @brief Build the device info section once all the responses have arrived.
+ */
+void RDMHTTPModule::SendDeviceInfoSection(device_info *dev_info) {
+  HTTPResponse *response = dev_info->response;
+  const ola::rdm::DeviceDescriptor &device = dev_info->device;
   JsonSection section;
 
-  if (CheckForRDMError(response, status)) {
+  if (CheckForRDMError(response, dev_info->device_status)) {
+    delete dev_info;
     return;
   }
 
@@ -1437,10 +1491,10 @@ void RDMHTTPModule::GetDeviceInfoHandler(
   section.AddItem(new StringItem("Protocol Version", stream.str()));
 
   stream.str("");
-  if (dev_info.device_model.empty()) {
+  if (dev_info->device_model.empty()) {
     stream << device.device_model;
   } else {
-    stream << dev_info.device_model << " (" << device.device_model << ")";
+    stream << dev_info->device_model << " (" << device.device_model << ")";
   }
   section.AddItem(new StringItem("Device Model", stream.str()));
 
@@ -1448,10 +1502,10 @@ void RDMHTTPModule::GetDeviceInfoHandler(
       "Product Category",
       ola::rdm::ProductCategoryToString(device.product_category)));
   stream.str("");
-  if (dev_info.software_version.empty()) {
+  if (dev_info->software_version.empty()) {
     stream << device.software_version;
   } else {
-    stream << dev_info.software_version << " (" << device.software_version
+    stream << dev_info->software_version << " (" << device.software_version
            << ")";
   }
   section.AddItem(new StringItem("Software Version", stream.str()));
@@ -1471,8 +1525,9 @@ void RDMHTTPModule::GetDeviceInfoHandler(
 
   section.AddItem(new UIntItem("Sub Devices", device.sub_device_count));
   section.AddItem(new UIntItem("Sensors", device.sensor_count));
-  section.AddItem(new StringItem("UID", dev_info.uid.ToString()));
+  section.AddItem(new StringItem("UID", dev_info->uid.ToString()));
   RespondWithSection(response, section);
+  delete dev_info;
 }
 
 
@@ -1898,7 +1953,7 @@ string RDMHTTPModule::GetPersonalities(OLA_UNUSED const HTTPRequest *request,
   info->include_descriptions = include_descriptions || (hint == "l");
   info->return_as_section = return_as_section;
   info->active = 0;
-  info->next = 1;
+  info->outstanding = 0;
   info->total = 0;
 
   m_rdm_api.GetDMXPersonality(
@@ -1933,7 +1988,7 @@ void RDMHTTPModule::GetPersonalityHandler(
   info->total = total;
 
   if (info->include_descriptions) {
-    GetNextPersonalityDescription(response, info);
+    GetPersonalityDescriptions(response, info);
   } else {
     SendPersonalityResponse(response, info);
   }
@@ -1941,32 +1996,47 @@ void RDMHTTPModule::GetPersonalityHandler(
 
 
 /**
- * @brief Get the description of the next dmx personality
+ * @brief Get the descriptions of all the dmx personalities.
+ *
+ * The requests are sent together, the response is sent once the last one
+ * completes.
  */
-void RDMHTTPModule::GetNextPersonalityDescription(HTTPResponse *response,
-                                                  personality_info *info) {
-  string error;
-  while (info->next <= info->total) {
-    bool r = m_rdm_api.GetDMXPersonalityDescription(
-        info->universe_id,
-        *(info->uid),
-        ola::rdm::ROOT_RDM_DEVICE,
-        info->next,
-        NewSingleCallback(this,
-                          &RDMHTTPModule::GetPersonalityLabelHandler,
-                          response,
-                          info),
-        &error);
-    if (r) {
-      return;
-    }
+void RDMHTTPModule::GetPersonalityDescriptions(HTTPResponse *response,
+                                               personality_info *info) {
+  // info may be deleted once the last request has been sent.
+  const unsigned int universe_id = info->universe_id;
+  const UID uid = *info->uid;
+  const unsigned int total = info->total;
+
+  info->personalities.assign(
+      total, pair<uint32_t, string>(INVALID_PERSONALITY, ""));
+  info->outstanding = total;
 
-    info->next++;
+  if (!total) {
+    if (info->return_as_section) {
+      SendSectionPersonalityResponse(response, info);
+    } else {
+      SendPersonalityResponse(response, info);
+    }
+    return;
   }
-  if (info->return_as_section) {
-    SendSectionPersonalityResponse(response, info);
-  } else {
-    SendPersonalityResponse(response, info);
+
+  for (unsigned int i = 1; i <= total; i++) {
+    string error;
+    if (!m_rdm_api.GetDMXPersonalityDescription(
+            universe_id,
+            uid,
+            ola::rdm::ROOT_RDM_DEVICE,
+            i,
+            NewSingleCallback(this,
+                              &RDMHTTPModule::GetPersonalityLabelHandler,
+                              response,
+                              info,
+                              i),
+            &error)) {
+      GetPersonalityLabelHandler(response, info, i, SendFailedStatus(error),
+                                 i, 0, "");
+    }
   }
 }
 
@@ -1974,35 +2044,27 @@ void RDMHTTPModule::GetNextPersonalityDescription(HTTPResponse *response,
 /**
  * @brief Handle the response to a Personality label call.
  *
- * This fetches the next personality in the sequence, or sends the response if
- * we have all the info.
+ * This sends the response once all the descriptions have arrived.
  */
 void RDMHTTPModule::GetPersonalityLabelHandler(
     HTTPResponse *response,
     personality_info *info,
+    unsigned int index,
     const ola::rdm::ResponseStatus &status,
     OLA_UNUSED uint8_t personality,
     uint16_t slot_count,
     const string &label) {
-  string description = "";
-  uint32_t slots = INVALID_PERSONALITY;
-
   if (CheckForRDMSuccess(status)) {
-    slots = slot_count;
-    description = label;
+    info->personalities[index - 1] = pair<uint32_t, string>(slot_count,
+                                                            label);
   }
 
-  info->personalities.push_back(pair<uint32_t, string>(slots, description));
-
-  if (info->next == info->total) {
+  if (--info->outstanding == 0) {
     if (info->return_as_section) {
       SendSectionPersonalityResponse(response, info);
     } else {
       SendPersonalityResponse(response, info);
     }
-  } else {
-    info->next++;
-    GetNextPersonalityDescription(response, info);
   }
 }
 
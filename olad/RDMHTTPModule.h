@@ -116,13 +116,33 @@ class RDMHTTPModule {
       }
     };
 
+    // The GETs for the supported sections are sent together, this collects
+    // the responses.
     typedef struct {
-      unsigned int universe_id;
+      ola::http::HTTPResponse *response;
+      unsigned int outstanding;
+      ola::rdm::ResponseStatus pid_status;
+      std::vector<uint16_t> pids;
+      ola::rdm::ResponseStatus device_status;
+      ola::rdm::DeviceDescriptor device;
+    } sections_info;
+
+    // Likewise for the device info section.
+    struct device_info {
+      device_info(ola::http::HTTPResponse *response, const ola::rdm::UID &uid)
+          : response(response),
+            uid(uid),
+            outstanding(0) {
+      }
+
+      ola::http::HTTPResponse *response;
       const ola::rdm::UID uid;
-      std::string hint;
+      unsigned int outstanding;
       std::string device_model;
       std::string software_version;
-    } device_info;
+      ola::rdm::ResponseStatus device_status;
+      ola::rdm::DeviceDescriptor device;
+    };
 
     typedef struct {
       unsigned int universe_id;
@@ -130,7 +150,7 @@ class RDMHTTPModule {
       bool include_descriptions;
       bool return_as_section;
       unsigned int active;
-      unsigned int next;
+      unsigned int outstanding;
       unsigned int total;
       std::vector<std::pair<uint32_t, std::string> > personalities;
     } personality_info;
@@ -175,16 +195,14 @@ class RDMHTTPModule {
     void SupportedParamsHandler(ola::http::HTTPResponse *response,
                                 const ola::rdm::ResponseStatus &status,
                                 const std::vector<uint16_t> &pids);
-    void SupportedSectionsHandler(ola::http::HTTPResponse *response,
-                                  unsigned int universe,
-                                  ola::rdm::UID uid,
+    void SupportedSectionsHandler(sections_info *info,
                                   const ola::rdm::ResponseStatus &status,
                                   const std::vector<uint16_t> &pids);
     void SupportedSectionsDeviceInfoHandler(
-        ola::http::HTTPResponse *response,
-        const std::vector<uint16_t> pids,
+        sections_info *info,
         const ola::rdm::ResponseStatus &status,
         const ola::rdm::DeviceDescriptor &device);
+    void SendSupportedSections(sections_info *info);
 
     // section methods
     std::string GetCommStatus(ola::http::HTTPResponse *response,
@@ -216,21 +234,20 @@ class RDMHTTPModule {
                               unsigned int universe_id,
                               const ola::rdm::UID &uid);
 
-    void GetSoftwareVersionHandler(ola::http::HTTPResponse *response,
-                                   device_info dev_info,
+    void GetSoftwareVersionHandler(device_info *dev_info,
                                    const ola::rdm::ResponseStatus &status,
                                    const std::string &software_version);
 
-    void GetDeviceModelHandler(ola::http::HTTPResponse *response,
-                               device_info dev_info,
+    void GetDeviceModelHandler(device_info *dev_info,
                                const ola::rdm::ResponseStatus &status,
                                const std::string &device_model);
 
-    void GetDeviceInfoHandler(ola::http::HTTPResponse *response,
-                              device_info dev_info,
+    void GetDeviceInfoHandler(device_info *dev_info,
                               const ola::rdm::ResponseStatus &status,
                               const ola::rdm::DeviceDescriptor &device);
 
+    void SendDeviceInfoSection(device_info *dev_info);
+
     std::string GetProductIds(const ola::http::HTTPRequest *request,
                               ola::http::HTTPResponse *response,
                               unsigned int universe_id,
@@ -330,12 +347,13 @@ class RDMHTTPModule {
         uint8_t current,
         uint8_t total);
 
-    void GetNextPersonalityDescription(ola::http::HTTPResponse *response,
-                                       personality_info *info);
+    void GetPersonalityDescriptions(ola::http::HTTPResponse *response,
+                                    personality_info *info);
 
     void GetPersonalityLabelHandler(
         ola::http::HTTPResponse *response,
         personality_info *info,
+        unsigned int index,
         const ola::rdm::ResponseStatus &status,
         uint8_t personality,
         uint16_t slot_count,
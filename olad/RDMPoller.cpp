@@ -0,0 +1,352 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMPoller.cpp
+ * Polls RDM GETs on behalf of the clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/RDMPoller.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/protocol/Ola.pb.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+
+using ola::rdm::RDMReply;
+using ola::rdm::RDMResponse;
+using ola::rdm::UID;
+using ola::thread::INVALID_TIMEOUT;
+using std::string;
+using std::vector;
+
+namespace {
+const int64_t USECS_PER_SECOND = ONE_THOUSAND * ONE_THOUSAND;
+}  // namespace
+
+const char RDMPoller::K_RDM_POLLS_VAR[] = "rdm-polls";
+const char RDMPoller::K_RDM_POLL_REQUESTS_VAR[] = "rdm-poll-requests";
+const char RDMPoller::K_RDM_POLL_UPDATES_VAR[] = "rdm-poll-updates";
+
+bool RDMPoller::PollRequest::operator<(const PollRequest &other) const {
+  if (universe != other.universe) {
+    return universe < other.universe;
+  }
+  if (uid != other.uid) {
+    return uid < other.uid;
+  }
+  if (sub_device != other.sub_device) {
+    return sub_device < other.sub_device;
+  }
+  if (pid != other.pid) {
+    return pid < other.pid;
+  }
+  return data < other.data;
+}
+
+RDMPoller::UniverseState::UniverseState()
+    : busy(false),
+      in_flight(NULL),
+      timeout(INVALID_TIMEOUT) {
+}
+
+RDMPoller::RDMPoller(ola::thread::SchedulerInterface *scheduler,
+                     SendRequestCallback *send_request,
+                     const UID &source_uid,
+                     ExportMap *export_map,
+                     Clock *clock)
+    : m_scheduler(scheduler),
+      m_send_request(send_request),
+      m_source_uid(source_uid),
+      m_export_map(export_map),
+      m_clock(clock),
+      m_free_clock(false),
+      m_min_interval(DEFAULT_MIN_INTERVAL_MS * ONE_THOUSAND),
+      m_transaction_number(0),
+      m_requests_sent(0) {
+  if (!m_clock) {
+    m_clock = new Clock();
+    m_free_clock = true;
+  }
+  if (m_export_map) {
+    m_export_map->GetIntegerVar(K_RDM_POLLS_VAR);
+    m_export_map->GetCounterVar(K_RDM_POLL_REQUESTS_VAR);
+    m_export_map->GetCounterVar(K_RDM_POLL_UPDATES_VAR);
+  }
+}
+
+RDMPoller::~RDMPoller() {
+  UniverseMap::iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    if (iter->second.timeout != INVALID_TIMEOUT) {
+      m_scheduler->RemoveTimeout(iter->second.timeout);
+    }
+  }
+  STLDeleteValues(&m_polls);
+  if (m_free_clock) {
+    delete m_clock;
+  }
+}
+
+void RDMPoller::Subscribe(Client *client, const PollRequest &request,
+                          const TimeInterval &period) {
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  Poll *&poll = m_polls[request];
+  if (!poll) {
+    poll = new Poll();
+    poll->due = now;
+    UpdatePollCount();
+  }
+
+  poll->subscribers[client] = period;
+  poll->period = period;
+  SubscriberMap::const_iterator iter = poll->subscribers.begin();
+  for (; iter != poll->subscribers.end(); ++iter) {
+    if (iter->second < poll->period) {
+      poll->period = iter->second;
+    }
+  }
+  if (now + poll->period < poll->due) {
+    poll->due = now + poll->period;
+  }
+
+  if (poll->has_response) {
+    SendUpdate(client, request, *poll);
+  }
+  Schedule(request.universe, false);
+}
+
+bool RDMPoller::Unsubscribe(Client *client, const PollRequest &request) {
+  PollMap::iterator iter = m_polls.find(request);
+  if (iter == m_polls.end() || !iter->second->subscribers.erase(client)) {
+    return false;
+  }
+
+  Poll *poll = iter->second;
+  if (poll->subscribers.empty()) {
+    RemovePoll(iter);
+    Schedule(request.universe, false);
+    return true;
+  }
+
+  poll->period = poll->subscribers.begin()->second;
+  SubscriberMap::const_iterator sub_iter = poll->subscribers.begin();
+  for (; sub_iter != poll->subscribers.end(); ++sub_iter) {
+    if (sub_iter->second < poll->period) {
+      poll->period = sub_iter->second;
+    }
+  }
+  return true;
+}
+
+void RDMPoller::RemoveClient(Client *client) {
+  vector<PollRequest> requests;
+  PollMap::const_iterator iter = m_polls.begin();
+  for (; iter != m_polls.end(); ++iter) {
+    if (STLContains(iter->second->subscribers, client)) {
+      requests.push_back(iter->first);
+    }
+  }
+
+  vector<PollRequest>::const_iterator request_iter = requests.begin();
+  for (; request_iter != requests.end(); ++request_iter) {
+    Unsubscribe(client, *request_iter);
+  }
+}
+
+void RDMPoller::RemovePoll(PollMap::iterator iter) {
+  UniverseMap::iterator universe_iter = m_universes.find(
+      iter->first.universe);
+  if (universe_iter != m_universes.end() &&
+      universe_iter->second.in_flight == &iter->first) {
+    universe_iter->second.in_flight = NULL;
+  }
+  delete iter->second;
+  m_polls.erase(iter);
+  UpdatePollCount();
+}
+
+/*
+ * Work out when to send the next poll for a universe.
+ */
+void RDMPoller::Schedule(unsigned int universe, bool timed_out) {
+  UniverseState &state = m_universes[universe];
+  if (timed_out) {
+    state.timeout = INVALID_TIMEOUT;
+  }
+  if (state.busy) {
+    return;
+  }
+
+  if (state.timeout != INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(state.timeout);
+    state.timeout = INVALID_TIMEOUT;
+  }
+
+  // Find the poll that's due first, and the total rate of the polls, in
+  // polls per second.
+  PollMap::iterator next = m_polls.end();
+  double rate = 0;
+  PollMap::iterator iter = m_polls.lower_bound(
+      PollRequest(universe, UID(0, 0), 0, 0));
+  for (; iter != m_polls.end() && iter->first.universe == universe; ++iter) {
+    if (next == m_polls.end() || iter->second->due < next->second->due) {
+      next = iter;
+    }
+    rate += static_cast<double>(USECS_PER_SECOND) /
+            std::max(iter->second->period.AsInt(),
+                     static_cast<int64_t>(1));
+  }
+
+  if (next == m_polls.end()) {
+    m_universes.erase(universe);
+    return;
+  }
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  if (timed_out) {
+    SendPoll(universe, next, now);
+    return;
+  }
+
+  TimeInterval gap(static_cast<int64_t>(USECS_PER_SECOND / rate));
+  if (gap < m_min_interval) {
+    gap = m_min_interval;
+  }
+
+  TimeStamp send_time = next->second->due;
+  if (send_time < state.last_sent + gap) {
+    send_time = state.last_sent + gap;
+  }
+
+  if (send_time <= now) {
+    SendPoll(universe, next, now);
+  } else {
+    state.timeout = m_scheduler->RegisterSingleTimeout(
+        send_time - now,
+        NewSingleCallback(this, &RDMPoller::Schedule, universe, true));
+  }
+}
+
+void RDMPoller::SendPoll(unsigned int universe, PollMap::iterator iter,
+                         const TimeStamp &now) {
+  UniverseState &state = m_universes[universe];
+  state.busy = true;
+  state.in_flight = &iter->first;
+  state.last_sent = now;
+  iter->second->due = now + iter->second->period;
+
+  m_requests_sent++;
+  if (m_export_map) {
+    (*m_export_map->GetCounterVar(K_RDM_POLL_REQUESTS_VAR))++;
+  }
+
+  const PollRequest &request = iter->first;
+  ola::rdm::RDMRequest *rdm_request = new ola::rdm::RDMGetRequest(
+      m_source_uid,
+      request.uid,
+      m_transaction_number++,
+      1,  // port id
+      request.sub_device,
+      request.pid,
+      reinterpret_cast<const uint8_t*>(request.data.data()),
+      request.data.size());
+
+  // This may run the callback straight away, so don't touch the state after
+  // this.
+  m_send_request->Run(
+      universe, rdm_request,
+      NewSingleCallback(this, &RDMPoller::HandleResponse, universe));
+}
+
+void RDMPoller::HandleResponse(unsigned int universe, RDMReply *reply) {
+  UniverseState &state = m_universes[universe];
+  const PollRequest *request = state.in_flight;
+  state.busy = false;
+  state.in_flight = NULL;
+
+  Poll *poll = request ? STLFindOrNull(m_polls, *request) : NULL;
+  if (poll) {
+    ola::rdm::RDMStatusCode status_code = reply->StatusCode();
+    uint8_t response_type = 0;
+    string data;
+    const RDMResponse *response = reply->Response();
+    if (status_code == ola::rdm::RDM_COMPLETED_OK) {
+      if (response) {
+        response_type = response->ResponseType();
+        if (response->ParamData()) {
+          data.assign(reinterpret_cast<const char*>(response->ParamData()),
+                      response->ParamDataSize());
+        }
+      } else {
+        status_code = ola::rdm::RDM_INVALID_RESPONSE;
+      }
+    }
+
+    if (!poll->has_response || status_code != poll->status_code ||
+        response_type != poll->response_type || data != poll->data) {
+      poll->has_response = true;
+      poll->status_code = status_code;
+      poll->response_type = response_type;
+      poll->data = data;
+
+      SubscriberMap::const_iterator iter = poll->subscribers.begin();
+      for (; iter != poll->subscribers.end(); ++iter) {
+        SendUpdate(iter->first, *request, *poll);
+      }
+    }
+  }
+  Schedule(universe, false);
+}
+
+void RDMPoller::SendUpdate(Client *client, const PollRequest &request,
+                           const Poll &poll) {
+  ola::proto::RDMPollUpdate update;
+  update.set_universe(request.universe);
+  update.mutable_uid()->set_esta_id(request.uid.ManufacturerId());
+  update.mutable_uid()->set_device_id(request.uid.DeviceId());
+  update.set_sub_device(request.sub_device);
+  update.set_param_id(request.pid);
+  update.set_request_data(request.data);
+  update.set_response_code(
+      static_cast<ola::proto::RDMResponseCode>(poll.status_code));
+  if (poll.status_code == ola::rdm::RDM_COMPLETED_OK) {
+    update.set_response_type(
+        static_cast<ola::proto::RDMResponseType>(poll.response_type));
+    update.set_data(poll.data);
+  }
+  client->SendRDMPollUpdate(update);
+
+  if (m_export_map) {
+    (*m_export_map->GetCounterVar(K_RDM_POLL_UPDATES_VAR))++;
+  }
+}
+
+void RDMPoller::UpdatePollCount() {
+  if (m_export_map) {
+    m_export_map->GetIntegerVar(K_RDM_POLLS_VAR)->Set(m_polls.size());
+  }
+}
+}  // namespace ola
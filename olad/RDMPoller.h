@@ -0,0 +1,206 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMPoller.h
+ * Polls RDM GETs on behalf of the clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_RDMPOLLER_H_
+#define OLAD_RDMPOLLER_H_
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMControllerInterface.h"
+#include "ola/rdm/RDMResponseCodes.h"
+#include "ola/rdm/UID.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "olad/plugin_api/Client.h"
+
+namespace ola {
+
+/**
+ * @brief Polls RDM GETs, like SENSOR_VALUE or LAMP_HOURS, for the clients.
+ *
+ * Clients subscribe to a GET with the period they need. Each distinct GET is
+ * only polled once, at the shortest period any subscriber asked for, and the
+ * response is pushed to the subscribers when it changes. New subscribers are
+ * sent the last response straight away.
+ *
+ * Each universe has at most one poll in flight. The polls are spaced evenly
+ * so the total rate matches the sum of the rates of the polls on the
+ * universe, with at least the minimum interval between them, rather than
+ * being sent in bursts. If the minimum interval is too long to meet all the
+ * periods, the polls are sent in the order they're due, and the periods
+ * stretch.
+ *
+ * The RDMPoller must outlive any requests in flight, so it should be
+ * deleted after the universes.
+ */
+class RDMPoller {
+ public:
+  /**
+   * @brief Sends a request to a universe, the callback must always be run.
+   */
+  typedef ola::Callback3<void, unsigned int, ola::rdm::RDMRequest*,
+                         ola::rdm::RDMCallback*> SendRequestCallback;
+
+  /**
+   * @brief A GET to poll.
+   */
+  struct PollRequest {
+    unsigned int universe;
+    ola::rdm::UID uid;
+    uint16_t sub_device;
+    uint16_t pid;
+    std::string data;
+
+    PollRequest(unsigned int universe, const ola::rdm::UID &uid,
+                uint16_t sub_device, uint16_t pid,
+                const std::string &data = "")
+        : universe(universe), uid(uid), sub_device(sub_device), pid(pid),
+          data(data) {
+    }
+
+    bool operator<(const PollRequest &other) const;
+  };
+
+  /**
+   * @brief Create a new RDMPoller.
+   * @param scheduler the SchedulerInterface used to time the polls.
+   * @param send_request the callback used to send the requests, ownership is
+   *   transferred.
+   * @param source_uid the UID to send the requests from.
+   * @param export_map the ExportMap to use for the statistics, may be NULL.
+   * @param clock the Clock to use, if NULL a Clock is created.
+   */
+  RDMPoller(ola::thread::SchedulerInterface *scheduler,
+            SendRequestCallback *send_request,
+            const ola::rdm::UID &source_uid,
+            ExportMap *export_map,
+            Clock *clock = NULL);
+  ~RDMPoller();
+
+  /**
+   * @brief Set the minimum time between polls on a universe.
+   */
+  void SetMinimumInterval(const TimeInterval &interval) {
+    m_min_interval = interval;
+  }
+
+  /**
+   * @brief Set the UID the requests are sent from.
+   */
+  void SetSourceUID(const ola::rdm::UID &uid) { m_source_uid = uid; }
+
+  /**
+   * @brief Subscribe a client to a GET.
+   * @param client the client to send the responses to.
+   * @param request the GET to poll.
+   * @param period how often the client wants the GET polled. Subscribing
+   *   again changes the period.
+   */
+  void Subscribe(Client *client, const PollRequest &request,
+                 const TimeInterval &period);
+
+  /**
+   * @brief Unsubscribe a client from a GET.
+   * @returns false if the client wasn't subscribed to the GET.
+   */
+  bool Unsubscribe(Client *client, const PollRequest &request);
+
+  /**
+   * @brief Remove all the subscriptions for a client.
+   */
+  void RemoveClient(Client *client);
+
+  /**
+   * @brief The number of distinct GETs being polled.
+   */
+  unsigned int PollCount() const { return m_polls.size(); }
+
+  /**
+   * @brief The number of requests sent.
+   */
+  unsigned int RequestsSent() const { return m_requests_sent; }
+
+  static const char K_RDM_POLLS_VAR[];
+  static const char K_RDM_POLL_REQUESTS_VAR[];
+  static const char K_RDM_POLL_UPDATES_VAR[];
+
+  static const unsigned int DEFAULT_MIN_INTERVAL_MS = 20;
+
+ private:
+  typedef std::map<Client*, TimeInterval> SubscriberMap;
+
+  struct Poll {
+    SubscriberMap subscribers;
+    TimeInterval period;
+    TimeStamp due;
+    bool has_response;
+    ola::rdm::RDMStatusCode status_code;
+    uint8_t response_type;
+    std::string data;
+
+    Poll() : has_response(false), status_code(ola::rdm::RDM_TIMEOUT),
+             response_type(0) {}
+  };
+
+  struct UniverseState {
+    bool busy;
+    // The poll in flight, this is NULL if it's been removed.
+    const PollRequest *in_flight;
+    TimeStamp last_sent;
+    ola::thread::timeout_id timeout;
+
+    UniverseState();
+  };
+
+  typedef std::map<PollRequest, Poll*> PollMap;
+  typedef std::map<unsigned int, UniverseState> UniverseMap;
+
+  ola::thread::SchedulerInterface *m_scheduler;
+  std::auto_ptr<SendRequestCallback> m_send_request;
+  ola::rdm::UID m_source_uid;
+  ExportMap *m_export_map;
+  Clock *m_clock;
+  bool m_free_clock;
+  TimeInterval m_min_interval;
+  uint8_t m_transaction_number;
+  unsigned int m_requests_sent;
+  PollMap m_polls;
+  UniverseMap m_universes;
+
+  void RemovePoll(PollMap::iterator iter);
+  void Schedule(unsigned int universe, bool timed_out);
+  void SendPoll(unsigned int universe, PollMap::iterator iter,
+                const TimeStamp &now);
+  void HandleResponse(unsigned int universe, ola::rdm::RDMReply *reply);
+  void SendUpdate(Client *client, const PollRequest &request,
+                  const Poll &poll);
+  void UpdatePollCount();
+
+  DISALLOW_COPY_AND_ASSIGN(RDMPoller);
+};
+}  // namespace ola
+#endif  // OLAD_RDMPOLLER_H_
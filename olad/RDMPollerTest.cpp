@@ -0,0 +1,329 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMPollerTest.cpp
+ * Test fixture for the RDMPoller class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/protocol/Ola.pb.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/RDMPoller.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/TestCommon.h"
+
+using ola::Client;
+using ola::NewCallback;
+using ola::RDMPoller;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * A Client which records the poll updates it's sent.
+ */
+class MockPollClient: public Client {
+ public:
+  explicit MockPollClient(const UID &uid) : Client(NULL, uid) {}
+
+  void SendRDMPollUpdate(const ola::proto::RDMPollUpdate &update) {
+    updates.push_back(update);
+  }
+
+  vector<ola::proto::RDMPollUpdate> updates;
+};
+}  // namespace
+
+class RDMPollerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMPollerTest);
+  CPPUNIT_TEST(testDeduplication);
+  CPPUNIT_TEST(testSpacing);
+  CPPUNIT_TEST(testUnsubscribe);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  RDMPollerTest()
+      : m_uid(0x7a70, 1),
+        m_clock(&m_now) {
+  }
+
+  void setUp();
+  void tearDown();
+  void testDeduplication();
+  void testSpacing();
+  void testUnsubscribe();
+
+ private:
+  struct PendingRequest {
+    unsigned int universe;
+    RDMRequest *request;
+    RDMCallback *callback;
+  };
+
+  UID m_uid;
+  TimeStamp m_now;
+  ola::CachedClock m_clock;
+  MockScheduler m_scheduler;
+  ola::ExportMap m_export_map;
+  auto_ptr<RDMPoller> m_poller;
+  vector<PendingRequest> m_pending;
+
+  void QueueRequest(unsigned int universe, RDMRequest *request,
+                    RDMCallback *callback) {
+    PendingRequest pending = {universe, request, callback};
+    m_pending.push_back(pending);
+  }
+
+  void Reply(const string &data);
+  void Advance(unsigned int ms);
+  unsigned int PollVar() {
+    return m_export_map.GetIntegerVar(RDMPoller::K_RDM_POLLS_VAR)->Get();
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMPollerTest);
+
+
+void RDMPollerTest::setUp() {
+  m_now = TimeStamp();
+  m_now += TimeInterval(100, 0);
+  m_poller.reset(new RDMPoller(
+      &m_scheduler, NewCallback(this, &RDMPollerTest::QueueRequest),
+      UID(0x7a70, 100), &m_export_map, &m_clock));
+}
+
+
+void RDMPollerTest::tearDown() {
+  m_poller.reset();
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  vector<PendingRequest>::iterator iter = m_pending.begin();
+  for (; iter != m_pending.end(); ++iter) {
+    delete iter->request;
+    delete iter->callback;
+  }
+  m_pending.clear();
+}
+
+
+/*
+ * Ack the oldest request in flight, with an empty data string meaning a
+ * timeout.
+ */
+void RDMPollerTest::Reply(const string &data) {
+  OLA_ASSERT_FALSE(m_pending.empty());
+  PendingRequest pending = m_pending.front();
+  m_pending.erase(m_pending.begin());
+
+  if (data.empty()) {
+    RDMReply reply(ola::rdm::RDM_TIMEOUT);
+    pending.callback->Run(&reply);
+  } else {
+    RDMReply reply(ola::rdm::RDM_COMPLETED_OK,
+                   ola::rdm::GetResponseFromData(
+                       pending.request,
+                       reinterpret_cast<const uint8_t*>(data.data()),
+                       data.size()));
+    pending.callback->Run(&reply);
+  }
+  delete pending.request;
+}
+
+
+void RDMPollerTest::Advance(unsigned int ms) {
+  m_now += TimeInterval(ms * ola::ONE_THOUSAND);
+  m_scheduler.RunTimeouts();
+}
+
+
+/*
+ * Check a GET subscribed to by several clients is only polled once, at the
+ * shortest period, and changes are pushed to all of them.
+ */
+void RDMPollerTest::testDeduplication() {
+  MockPollClient client1(m_uid), client2(m_uid), client3(m_uid);
+  const RDMPoller::PollRequest request(1, UID(0x7a70, 2), 0, 0x0201, "\001");
+
+  m_poller->Subscribe(&client1, request, TimeInterval(1, 0));
+  m_poller->Subscribe(&client2, request, TimeInterval(0, 500000));
+  OLA_ASSERT_EQ(1u, m_poller->PollCount());
+  OLA_ASSERT_EQ(1u, PollVar());
+
+  // The first poll is sent straight away.
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_pending.size());
+  OLA_ASSERT_EQ(1u, m_pending[0].universe);
+  OLA_ASSERT_EQ(UID(0x7a70, 2), m_pending[0].request->DestinationUID());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0x0201),
+                m_pending[0].request->ParamId());
+  OLA_ASSERT_EQ(1u, m_pending[0].request->ParamDataSize());
+
+  Reply("abc");
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client1.updates.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client2.updates.size());
+  const ola::proto::RDMPollUpdate &update = client1.updates[0];
+  OLA_ASSERT_EQ(1, update.universe());
+  OLA_ASSERT_EQ(0x7a70, update.uid().esta_id());
+  OLA_ASSERT_EQ(2u, update.uid().device_id());
+  OLA_ASSERT_EQ(0x0201, update.param_id());
+  OLA_ASSERT_EQ(string("\001"), update.request_data());
+  OLA_ASSERT_EQ(ola::proto::RDM_COMPLETED_OK, update.response_code());
+  OLA_ASSERT_EQ(ola::proto::RDM_ACK, update.response_type());
+  OLA_ASSERT_EQ(string("abc"), update.data());
+
+  // The next poll is at the shortest period.
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(TimeInterval(0, 500000), m_scheduler.Delay());
+  Advance(500);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_pending.size());
+
+  // An unchanged response isn't pushed.
+  Reply("abc");
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client1.updates.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client2.updates.size());
+
+  // A late subscriber is sent the last response straight away.
+  m_poller->Subscribe(&client3, request, TimeInterval(2, 0));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client3.updates.size());
+  OLA_ASSERT_EQ(string("abc"), client3.updates[0].data());
+  OLA_ASSERT_EQ(1u, m_poller->PollCount());
+
+  Advance(500);
+  Reply("");
+  OLA_ASSERT_EQ(static_cast<size_t>(2), client1.updates.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), client2.updates.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), client3.updates.size());
+  OLA_ASSERT_EQ(ola::proto::RDM_TIMEOUT, client3.updates[1].response_code());
+  OLA_ASSERT_FALSE(client3.updates[1].has_data());
+
+  Advance(500);
+  Reply("def");
+  OLA_ASSERT_EQ(static_cast<size_t>(3), client1.updates.size());
+  OLA_ASSERT_EQ(string("def"), client1.updates[2].data());
+  OLA_ASSERT_EQ(4u, m_poller->RequestsSent());
+  OLA_ASSERT_EQ(4u, m_export_map.GetCounterVar(
+      RDMPoller::K_RDM_POLL_REQUESTS_VAR)->Get());
+  OLA_ASSERT_EQ(9u, m_export_map.GetCounterVar(
+      RDMPoller::K_RDM_POLL_UPDATES_VAR)->Get());
+}
+
+
+/*
+ * Check only one poll is in flight per universe, and the polls are spread
+ * out rather than sent in bursts.
+ */
+void RDMPollerTest::testSpacing() {
+  MockPollClient client(m_uid);
+  const RDMPoller::PollRequest request1(1, UID(0x7a70, 2), 0, 0x0201);
+  const RDMPoller::PollRequest request2(1, UID(0x7a70, 3), 0, 0x0201);
+  const RDMPoller::PollRequest request3(2, UID(0x7a70, 4), 0, 0x0201);
+
+  m_poller->Subscribe(&client, request1, TimeInterval(1, 0));
+  m_poller->Subscribe(&client, request2, TimeInterval(1, 0));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_pending.size());
+  Reply("a");
+
+  // Two polls a second means one every 500ms, even though the second one is
+  // already due.
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(TimeInterval(0, 500000), m_scheduler.Delay());
+  Advance(500);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_pending.size());
+  OLA_ASSERT_EQ(UID(0x7a70, 3), m_pending[0].request->DestinationUID());
+  Reply("b");
+
+  OLA_ASSERT_EQ(TimeInterval(0, 500000), m_scheduler.Delay());
+  Advance(500);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_pending.size());
+  OLA_ASSERT_EQ(UID(0x7a70, 2), m_pending[0].request->DestinationUID());
+
+  // Universes are independent.
+  m_poller->Subscribe(&client, request3, TimeInterval(1, 0));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_pending.size());
+  OLA_ASSERT_EQ(2u, m_pending[1].universe);
+  Reply("a");
+  Reply("c");
+  OLA_ASSERT_EQ(2u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_TRUE(m_poller->Unsubscribe(&client, request3));
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+
+  // The minimum interval stretches the periods.
+  m_poller->SetMinimumInterval(TimeInterval(0, 800000));
+  m_poller->Subscribe(&client, request1, TimeInterval(1, 0));
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(TimeInterval(0, 800000), m_scheduler.Delay());
+  Advance(800);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_pending.size());
+  OLA_ASSERT_EQ(UID(0x7a70, 3), m_pending[0].request->DestinationUID());
+  Reply("b");
+  OLA_ASSERT_EQ(5u, m_poller->RequestsSent());
+}
+
+
+/*
+ * Check unsubscribing, and removing clients.
+ */
+void RDMPollerTest::testUnsubscribe() {
+  MockPollClient client1(m_uid), client2(m_uid);
+  const RDMPoller::PollRequest request1(1, UID(0x7a70, 2), 0, 0x0201);
+  const RDMPoller::PollRequest request2(1, UID(0x7a70, 3), 0, 0x0201);
+
+  OLA_ASSERT_FALSE(m_poller->Unsubscribe(&client1, request1));
+
+  m_poller->Subscribe(&client1, request1, TimeInterval(0, 200000));
+  m_poller->Subscribe(&client2, request1, TimeInterval(1, 0));
+  m_poller->Subscribe(&client2, request2, TimeInterval(1, 0));
+  OLA_ASSERT_EQ(2u, m_poller->PollCount());
+  Reply("a");
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client1.updates.size());
+
+  // Removing the subscriber with the shortest period lengthens the period.
+  OLA_ASSERT_TRUE(m_poller->Unsubscribe(&client1, request1));
+  OLA_ASSERT_FALSE(m_poller->Unsubscribe(&client1, request1));
+  OLA_ASSERT_EQ(2u, m_poller->PollCount());
+
+  Advance(500);
+  OLA_ASSERT_EQ(UID(0x7a70, 3), m_pending[0].request->DestinationUID());
+  Reply("b");
+  Advance(500);
+  OLA_ASSERT_EQ(UID(0x7a70, 2), m_pending[0].request->DestinationUID());
+
+  // A response for a poll that's gone is dropped.
+  m_poller->RemoveClient(&client2);
+  OLA_ASSERT_EQ(0u, m_poller->PollCount());
+  OLA_ASSERT_EQ(0u, PollVar());
+  Reply("c");
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client1.updates.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), client2.updates.size());
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(3u, m_poller->RequestsSent());
+}
@@ -18,10 +18,14 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <google/protobuf/descriptor.h>
+#include <algorithm>
 #include <map>
+#include <string>
 #include <utility>
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
+#include "common/rpc/RpcChannel.h"
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/rdm/UID.h"
@@ -33,31 +37,273 @@ namespace ola {
 using ola::rdm::UID;
 using ola::rpc::RpcController;
 using std::map;
+using std::string;
+
+const char Client::K_OUTSTANDING_UPDATES_VAR[] = "client-dmx-outstanding";
+const char Client::K_DROPPED_UPDATES_VAR[] = "client-dmx-dropped";
 
 Client::Client(ola::proto::OlaClientService_Stub *client_stub,
                const ola::rdm::UID &uid)
     : m_client_stub(client_stub),
-      m_uid(uid) {
+      m_uid(uid),
+      m_high_watermark(0),
+      m_low_watermark(0),
+      m_outstanding_updates(0),
+      m_dropped_updates(0),
+      m_throttled(false),
+      m_outstanding_var(NULL),
+      m_dropped_var(NULL),
+      m_scheduler(NULL),
+      m_wake_up_time(NULL) {
 }
 
 Client::~Client() {
+  while (!m_rate_limits.empty()) {
+    RemoveRateLimit(m_rate_limits.begin()->first);
+  }
   m_data_map.clear();
+  STLDeleteValues(&m_pixel_maps);
+  if (m_outstanding_var) {
+    m_outstanding_var->Remove(m_stats_id);
+    m_dropped_var->Remove(m_stats_id);
+  }
 }
 
 bool Client::SendDMX(unsigned int universe, uint8_t priority,
-                     const DmxBuffer &buffer) {
+                     const DmxBuffer &buffer, string *serialized) {
   if (!m_client_stub.get()) {
     OLA_FATAL << "client_stub is null";
     return false;
   }
 
+  RateLimit *limit = STLFindOrNull(m_rate_limits, universe);
+  if (limit && !CheckRateLimit(universe, limit, priority, buffer)) {
+    return true;
+  }
+  return SendFlowControlled(universe, priority, buffer, serialized);
+}
+
+void Client::SendRDMBatchResult(const ola::proto::RDMBatchResult &result) {
+  if (!m_client_stub.get()) {
+    OLA_FATAL << "client_stub is null";
+    return;
+  }
+  m_client_stub->StreamRDMBatchResult(NULL, &result, NULL, NULL);
+}
+
+void Client::SendSlotChanges(const ola::proto::SlotChanges &changes) {
+  if (!m_client_stub.get()) {
+    OLA_FATAL << "client_stub is null";
+    return;
+  }
+  m_client_stub->UpdateSlots(NULL, &changes, NULL, NULL);
+}
+
+void Client::SendRDMPollUpdate(const ola::proto::RDMPollUpdate &update) {
+  if (!m_client_stub.get()) {
+    OLA_FATAL << "client_stub is null";
+    return;
+  }
+  m_client_stub->UpdateRDMPoll(NULL, &update, NULL, NULL);
+}
+
+void Client::SetWatermarks(unsigned int high_watermark,
+                           unsigned int low_watermark) {
+  m_high_watermark = high_watermark;
+  m_low_watermark = std::min(low_watermark, high_watermark);
+}
+
+void Client::ExportStats(ExportMap *export_map, const string &id) {
+  m_stats_id = id;
+  m_outstanding_var = export_map->GetUIntMapVar(K_OUTSTANDING_UPDATES_VAR);
+  m_dropped_var = export_map->GetUIntMapVar(K_DROPPED_UPDATES_VAR);
+  UpdateStats();
+}
+
+void Client::SetScheduler(ola::thread::SchedulerInterface *scheduler,
+                          const TimeStamp *wake_up_time) {
+  m_scheduler = scheduler;
+  m_wake_up_time = wake_up_time;
+}
+
+void Client::SetRateLimit(unsigned int universe, unsigned int max_rate,
+                          unsigned int min_change) {
+  RemoveRateLimit(universe);
+
+  if (max_rate && !m_scheduler) {
+    OLA_WARN << "No scheduler set, ignoring the rate limit for universe "
+             << universe;
+    max_rate = 0;
+  }
+
+  if (!max_rate && !min_change) {
+    return;
+  }
+
+  RateLimit *limit = new RateLimit();
+  limit->min_change = min_change;
+  if (max_rate) {
+    // Allow one frame straight away, with no bursts after that.
+    limit->bucket.reset(new TokenBucket(1, max_rate, 1, *m_wake_up_time));
+    limit->interval = std::max(1u, (1000 + max_rate - 1) / max_rate);
+  }
+  m_rate_limits[universe] = limit;
+}
+
+bool Client::SendFlowControlled(unsigned int universe, uint8_t priority,
+                                const DmxBuffer &buffer, string *serialized) {
+  if (m_high_watermark && m_outstanding_updates >= m_high_watermark) {
+    m_throttled = true;
+  }
+
+  if (m_throttled) {
+    // Latest value wins, any frame that's already held is dropped.
+    HeldFrames::iterator iter = m_held_frames.find(universe);
+    if (iter == m_held_frames.end()) {
+      iter = m_held_frames.insert(
+          std::make_pair(universe, HeldFrame())).first;
+    } else {
+      m_dropped_updates++;
+      UpdateStats();
+    }
+    iter->second.priority = priority;
+    iter->second.buffer = buffer;
+    return true;
+  }
+  return SendUpdate(universe, priority, buffer, serialized);
+}
+
+/*
+ * Returns true if the frame should be sent now.
+ */
+bool Client::CheckRateLimit(unsigned int universe, RateLimit *limit,
+                            uint8_t priority, const DmxBuffer &buffer) {
+  if (limit->min_change && limit->last_sent.Size() == buffer.Size()) {
+    const uint8_t *old_data = limit->last_sent.GetRaw();
+    const uint8_t *new_data = buffer.GetRaw();
+    bool changed = false;
+    for (unsigned int i = 0; i < buffer.Size() && !changed; i++) {
+      unsigned int difference = old_data[i] > new_data[i] ?
+          old_data[i] - new_data[i] : new_data[i] - old_data[i];
+      changed = difference >= limit->min_change;
+    }
+    if (!changed) {
+      // The client already has close enough data, so anything held is stale.
+      limit->held = false;
+      return false;
+    }
+  }
+
+  if (!limit->bucket.get() ||
+      (!limit->held && limit->bucket->GetToken(*m_wake_up_time))) {
+    limit->last_sent = buffer;
+    return true;
+  }
+
+  // Latest value wins.
+  limit->held = true;
+  limit->held_frame.priority = priority;
+  limit->held_frame.buffer = buffer;
+  if (limit->timeout == ola::thread::INVALID_TIMEOUT) {
+    limit->timeout = m_scheduler->RegisterSingleTimeout(
+        limit->interval,
+        NewSingleCallback(this, &Client::SendHeldFrame, universe));
+  }
+  return false;
+}
+
+void Client::SendHeldFrame(unsigned int universe) {
+  RateLimit *limit = STLFindOrNull(m_rate_limits, universe);
+  if (!limit) {
+    return;
+  }
+  limit->timeout = ola::thread::INVALID_TIMEOUT;
+  if (!limit->held) {
+    return;
+  }
+
+  if (!limit->bucket->GetToken(*m_wake_up_time)) {
+    limit->timeout = m_scheduler->RegisterSingleTimeout(
+        limit->interval,
+        NewSingleCallback(this, &Client::SendHeldFrame, universe));
+    return;
+  }
+
+  limit->held = false;
+  limit->last_sent = limit->held_frame.buffer;
+  SendFlowControlled(universe, limit->held_frame.priority,
+                     limit->held_frame.buffer, NULL);
+}
+
+void Client::RemoveRateLimit(unsigned int universe) {
+  RateLimit *limit = STLLookupAndRemovePtr(&m_rate_limits, universe);
+  if (!limit) {
+    return;
+  }
+  if (limit->timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(limit->timeout);
+  }
+  delete limit;
+}
+
+bool Client::SendUpdate(unsigned int universe, uint8_t priority,
+                        const DmxBuffer &buffer, string *serialized) {
   RpcController *controller = new RpcController();
   ola::proto::DmxData dmx_data;
   ola::proto::Ack *ack = new ola::proto::Ack();
+  m_outstanding_updates++;
+  UpdateStats();
+
+  ola::rpc::RpcChannel *channel = m_client_stub->channel();
+  if (serialized && channel && !STLContains(m_delta_state, universe)) {
+    if (serialized->empty()) {
+      dmx_data.set_priority(priority);
+      dmx_data.set_universe(universe);
+      dmx_data.set_data(buffer.Get());
+      dmx_data.SerializeToString(serialized);
+    }
+    channel->CallMethod(
+        ola::proto::OlaClientService::descriptor()->FindMethodByName(
+            "UpdateDmxData"),
+        controller,
+        *serialized,
+        ack,
+        ola::NewSingleCallback(this, &ola::Client::SendDMXCallback,
+                               controller, ack));
+    return true;
+  }
 
   dmx_data.set_priority(priority);
   dmx_data.set_universe(universe);
-  dmx_data.set_data(buffer.Get());
+
+  map<unsigned int, DeltaState>::iterator iter =
+      m_delta_state.find(universe);
+  if (iter == m_delta_state.end()) {
+    dmx_data.set_data(buffer.Get());
+  } else if (iter->second.updates_since_keyframe >=
+                 K_DELTA_KEYFRAME_INTERVAL ||
+             iter->second.last_sent.Size() != buffer.Size()) {
+    dmx_data.set_data(buffer.Get());
+    iter->second.last_sent = buffer;
+    iter->second.updates_since_keyframe = 0;
+  } else {
+    // Send the range which changed since the last update.
+    DmxBuffer *last_sent = &iter->second.last_sent;
+    const uint8_t *old_data = last_sent->GetRaw();
+    const uint8_t *new_data = buffer.GetRaw();
+    unsigned int start = 0;
+    unsigned int end = buffer.Size();
+    while (start < end && old_data[start] == new_data[start]) {
+      start++;
+    }
+    while (end > start && old_data[end - 1] == new_data[end - 1]) {
+      end--;
+    }
+    dmx_data.set_offset(start);
+    dmx_data.set_data(new_data + start, end - start);
+    last_sent->SetRange(start, new_data + start, end - start);
+    iter->second.updates_since_keyframe++;
+  }
 
   m_client_stub->UpdateDmxData(
       controller,
@@ -69,18 +315,34 @@ bool Client::SendDMX(unsigned int universe, uint8_t priority,
 }
 
 void Client::DMXReceived(unsigned int universe, const DmxSource &source) {
-  STLReplace(&m_data_map, universe, source);
+  map<unsigned int, DmxSource>::iterator iter = m_data_map.find(universe);
+  if (iter == m_data_map.end()) {
+    m_data_map.insert(std::make_pair(universe, source));
+  } else {
+    // Update in place so the source can track which slots changed.
+    iter->second.UpdateData(source.Data(), source.Timestamp(),
+                            source.Priority(), source.SlotPriorities());
+  }
 }
 
-const DmxSource Client::SourceData(unsigned int universe) const {
+void Client::SetDeltaUpdates(unsigned int universe, bool enable) {
+  if (enable) {
+    // Start with a full frame.
+    m_delta_state[universe].updates_since_keyframe =
+        K_DELTA_KEYFRAME_INTERVAL;
+  } else {
+    m_delta_state.erase(universe);
+  }
+}
+
+const DmxSource &Client::SourceData(unsigned int universe) const {
   map<unsigned int, DmxSource>::const_iterator iter =
     m_data_map.find(universe);
 
   if (iter != m_data_map.end()) {
     return iter->second;
   } else {
-    DmxSource source;
-    return source;
+    return m_empty_source;
   }
 }
 
@@ -92,6 +354,18 @@ void Client::SetUID(const ola::rdm::UID &uid) {
   m_uid = uid;
 }
 
+void Client::SetPixelMap(unsigned int layout, ola::dmx::PixelMap *map) {
+  if (map) {
+    STLReplaceAndDelete(&m_pixel_maps, layout, map);
+  } else {
+    STLRemoveAndDelete(&m_pixel_maps, layout);
+  }
+}
+
+ola::dmx::PixelMap *Client::GetPixelMap(unsigned int layout) const {
+  return STLFindOrNull(m_pixel_maps, layout);
+}
+
 /*
  * Called when UpdateDmxData completes.
  */
@@ -99,6 +373,28 @@ void Client::SendDMXCallback(RpcController *controller,
                              ola::proto::Ack *reply) {
   delete controller;
   delete reply;
+  m_outstanding_updates--;
+  UpdateStats();
+
+  if (m_throttled && m_outstanding_updates <= m_low_watermark) {
+    m_throttled = false;
+    // If the send fails this may be called again, so take a copy of the held
+    // frames first.
+    HeldFrames held_frames;
+    held_frames.swap(m_held_frames);
+    HeldFrames::const_iterator iter = held_frames.begin();
+    for (; iter != held_frames.end(); ++iter) {
+      SendUpdate(iter->first, iter->second.priority, iter->second.buffer,
+                 NULL);
+    }
+  }
+}
+
+void Client::UpdateStats() {
+  if (m_outstanding_var) {
+    (*m_outstanding_var)[m_stats_id] = m_outstanding_updates;
+    (*m_dropped_var)[m_stats_id] = m_dropped_updates;
+  }
 }
 
 
@@ -23,15 +23,25 @@
 
 #include <map>
 #include <memory>
+#include <string>
 #include "common/rpc/RpcController.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
 #include "ola/base/Macro.h"
+#include "ola/dmx/PixelMap.h"
+#include "ola/dmx/SharedMemoryFrames.h"
 #include "ola/rdm/UID.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "olad/DmxSource.h"
+#include "olad/TokenBucket.h"
 
 namespace ola {
 namespace proto {
 class OlaClientService_Stub;
 class Ack;
+class RDMBatchResult;
+class RDMPollUpdate;
+class SlotChanges;
 }
 }
 
@@ -64,8 +74,75 @@ class Client {
    * @param buffer the DMX data.
    * @return true if the update was sent, false otherwise
    */
+  bool SendDMX(unsigned int universe_id, uint8_t priority,
+               const DmxBuffer &buffer) {
+    return SendDMX(universe_id, priority, buffer, NULL);
+  }
+
+  /**
+   * @brief Push a DMX update to this client, sharing the serialized update
+   *   with other clients.
+   * @param universe_id the universe the DMX data belongs to
+   * @param priority the priority of the DMX data
+   * @param buffer the DMX data.
+   * @param serialized the serialized update, shared between all the clients
+   *   sent the same frame. If empty, it's filled in by the first client
+   *   which uses it. May be NULL.
+   * @return true if the update was sent, false otherwise
+   *
+   * Clients with delta updates enabled don't use the serialized update.
+   */
   virtual bool SendDMX(unsigned int universe_id, uint8_t priority,
-                       const DmxBuffer &buffer);
+                       const DmxBuffer &buffer, std::string *serialized);
+
+  /**
+   * @brief Push the result of a batched RDM request to the client.
+   * @param result the result to send.
+   */
+  virtual void SendRDMBatchResult(const ola::proto::RDMBatchResult &result);
+
+  /**
+   * @brief Push the changes to the slots the client has subscribed to.
+   * @param changes the changed slots.
+   * @sa Universe::AddSlotSubscription()
+   */
+  virtual void SendSlotChanges(const ola::proto::SlotChanges &changes);
+
+  /**
+   * @brief Push a changed response to an RDM GET polled for the client.
+   * @param update the update to send.
+   * @sa RDMPoller
+   */
+  virtual void SendRDMPollUpdate(const ola::proto::RDMPollUpdate &update);
+
+  /**
+   * @brief Control if updates for a universe are delta encoded.
+   * @param universe_id the universe id.
+   * @param enable if true, SendDMX() sends only the range of slots which
+   *   changed since the last update, with a full frame every
+   *   K_DELTA_KEYFRAME_INTERVAL updates.
+   */
+  void SetDeltaUpdates(unsigned int universe_id, bool enable);
+
+  /**
+   * @brief Set the scheduler used to send frames held back by SetRateLimit().
+   * @param scheduler the scheduler to use, ownership is not transferred.
+   * @param wake_up_time the time of the current event loop iteration.
+   */
+  void SetScheduler(ola::thread::SchedulerInterface *scheduler,
+                    const TimeStamp *wake_up_time);
+
+  /**
+   * @brief Limit the DMX updates sent for a universe.
+   * @param universe_id the universe id.
+   * @param max_rate the maximum number of updates per second, 0 means no
+   *   limit. Frames which arrive faster than this are held back and only the
+   *   latest one is sent. This requires SetScheduler() to have been called.
+   * @param min_change frames where no slot has changed by at least this much
+   *   since the last update sent are dropped. 0 sends every frame.
+   */
+  void SetRateLimit(unsigned int universe_id, unsigned int max_rate,
+                    unsigned int min_change);
 
   /**
    * @brief Called when this client sends us new data
@@ -77,8 +154,11 @@ class Client {
   /**
    * @brief Get the most recent DMX data received from this client.
    * @param universe the id of the universe we're interested in
+   * @returns the DmxSource for the universe, or an unset DmxSource if this
+   *   client hasn't sent data for the universe. The reference is valid until
+   *   the client is destroyed.
    */
-  const DmxSource SourceData(unsigned int universe) const;
+  const DmxSource &SourceData(unsigned int universe) const;
 
   /**
    * @brief Return the UID associated with this client.
@@ -95,13 +175,146 @@ class Client {
    */
   void SetUID(const ola::rdm::UID &uid);
 
+  /**
+   * @brief Set the shared memory segment this client writes DMX data to.
+   * @param frames the segment, or NULL to remove the existing one. Ownership
+   *   is transferred.
+   */
+  void SetSharedMemory(ola::dmx::SharedMemoryFrames *frames) {
+    m_shared_memory.reset(frames);
+  }
+
+  /**
+   * @brief Return the shared memory segment for this client.
+   * @returns the segment, or NULL if the client hasn't registered one.
+   */
+  ola::dmx::SharedMemoryFrames *SharedMemory() const {
+    return m_shared_memory.get();
+  }
+
+  /**
+   * @brief Set a pixel layout for this client.
+   * @param layout the id of the layout, chosen by the client.
+   * @param map the PixelMap for the layout, or NULL to remove the layout.
+   *   Ownership is transferred.
+   */
+  void SetPixelMap(unsigned int layout, ola::dmx::PixelMap *map);
+
+  /**
+   * @brief Return one of this client's pixel layouts.
+   * @returns the PixelMap, or NULL if the client hasn't set the layout.
+   */
+  ola::dmx::PixelMap *GetPixelMap(unsigned int layout) const;
+
+  /**
+   * @brief Limit the number of DMX updates awaiting acknowledgement.
+   * @param high_watermark once this many updates are outstanding, further
+   *   updates are held back and only the latest frame for each universe is
+   *   kept. 0 disables flow control.
+   * @param low_watermark the held frames are sent once the number of
+   *   outstanding updates drops to this.
+   */
+  void SetWatermarks(unsigned int high_watermark, unsigned int low_watermark);
+
+  /**
+   * @brief Export the flow control counters for this client.
+   * @param export_map the ExportMap to use, ownership is not transferred.
+   * @param id the key to use for this client in the ExportMap variables.
+   */
+  void ExportStats(ExportMap *export_map, const std::string &id);
+
+  /**
+   * @brief The number of DMX updates which haven't been acknowledged yet.
+   */
+  unsigned int OutstandingUpdates() const { return m_outstanding_updates; }
+
+  /**
+   * @brief The number of DMX frames dropped because the client wasn't keeping
+   *   up.
+   */
+  unsigned int DroppedUpdates() const { return m_dropped_updates; }
+
+  /**
+   * @brief The number of delta updates between full frames.
+   */
+  static const unsigned int K_DELTA_KEYFRAME_INTERVAL = 50;
+
+  static const char K_OUTSTANDING_UPDATES_VAR[];
+  static const char K_DROPPED_UPDATES_VAR[];
+
  private:
+  struct DeltaState {
+    DeltaState() : updates_since_keyframe(0) {}
+
+    DmxBuffer last_sent;
+    unsigned int updates_since_keyframe;
+  };
+
+  struct HeldFrame {
+    uint8_t priority;
+    DmxBuffer buffer;
+  };
+
+  typedef std::map<unsigned int, HeldFrame> HeldFrames;
+
+  struct RateLimit {
+    RateLimit()
+        : min_change(0),
+          interval(0),
+          held(false),
+          timeout(ola::thread::INVALID_TIMEOUT) {
+    }
+
+    // NULL if there is no maximum rate.
+    std::auto_ptr<TokenBucket> bucket;
+    unsigned int min_change;
+    // The time between updates, in ms.
+    unsigned int interval;
+    DmxBuffer last_sent;
+    bool held;
+    HeldFrame held_frame;
+    ola::thread::timeout_id timeout;
+  };
+
+  typedef std::map<unsigned int, RateLimit*> RateLimits;
+
+  bool SendFlowControlled(unsigned int universe_id, uint8_t priority,
+                          const DmxBuffer &buffer, std::string *serialized);
+  bool CheckRateLimit(unsigned int universe_id, RateLimit *limit,
+                      uint8_t priority, const DmxBuffer &buffer);
+  void SendHeldFrame(unsigned int universe_id);
+  void RemoveRateLimit(unsigned int universe_id);
+  bool SendUpdate(unsigned int universe_id, uint8_t priority,
+                  const DmxBuffer &buffer, std::string *serialized);
   void SendDMXCallback(ola::rpc::RpcController *controller,
                        ola::proto::Ack *ack);
+  void UpdateStats();
 
   std::auto_ptr<class ola::proto::OlaClientService_Stub> m_client_stub;
   std::map<unsigned int, DmxSource> m_data_map;
+  // The universes which have delta updates enabled.
+  std::map<unsigned int, DeltaState> m_delta_state;
+  const DmxSource m_empty_source;
   ola::rdm::UID m_uid;
+  std::auto_ptr<ola::dmx::SharedMemoryFrames> m_shared_memory;
+  std::map<unsigned int, ola::dmx::PixelMap*> m_pixel_maps;
+
+  // Flow control
+  unsigned int m_high_watermark;
+  unsigned int m_low_watermark;
+  unsigned int m_outstanding_updates;
+  unsigned int m_dropped_updates;
+  bool m_throttled;
+  // The latest frame for each universe, while throttled.
+  HeldFrames m_held_frames;
+  std::string m_stats_id;
+  UIntMap *m_outstanding_var;
+  UIntMap *m_dropped_var;
+
+  // Rate limiting
+  ola::thread::SchedulerInterface *m_scheduler;
+  const TimeStamp *m_wake_up_time;
+  RateLimits m_rate_limits;
 
   DISALLOW_COPY_AND_ASSIGN(Client);
 };
@@ -19,6 +19,8 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <deque>
+#include <map>
 #include <string>
 
 #include "common/protocol/Ola.pb.h"
@@ -30,6 +32,7 @@
 #include "ola/DmxBuffer.h"
 #include "ola/rdm/UID.h"
 #include "ola/testing/TestUtils.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "olad/DmxSource.h"
 #include "olad/plugin_api/Client.h"
 
@@ -41,18 +44,26 @@ static const char TEST_DATA2[] = "another set of test data";
 
 using ola::Client;
 using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::thread::timeout_id;
 using std::string;
 
 class ClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ClientTest);
   CPPUNIT_TEST(testSendDMX);
   CPPUNIT_TEST(testGetSetDMX);
+  CPPUNIT_TEST(testDeltaUpdates);
+  CPPUNIT_TEST(testWatermarks);
+  CPPUNIT_TEST(testRateLimit);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   ClientTest() : m_test_uid(ola::OPEN_LIGHTING_ESTA_CODE, 0) {}
   void testSendDMX();
   void testGetSetDMX();
+  void testDeltaUpdates();
+  void testWatermarks();
+  void testRateLimit();
 
  private:
   ola::Clock m_clock;
@@ -87,6 +98,116 @@ void MockClientStub::UpdateDmxData(
   done->Run();
 }
 
+/*
+ * A ClientStub which records the last DmxData sent.
+ */
+class RecordingClientStub: public ola::proto::OlaClientService_Stub {
+ public:
+  RecordingClientStub(): ola::proto::OlaClientService_Stub(NULL) {}
+
+  void UpdateDmxData(OLA_UNUSED ola::rpc::RpcController *controller,
+                     const ola::proto::DmxData *request,
+                     OLA_UNUSED ola::proto::Ack *response,
+                     ola::rpc::RpcService::CompletionCallback *done) {
+    m_last.CopyFrom(*request);
+    done->Run();
+  }
+
+  const ola::proto::DmxData &Last() const { return m_last; }
+
+ private:
+  ola::proto::DmxData m_last;
+};
+
+/*
+ * A ClientStub which holds on to the updates until Ack() is called.
+ */
+class DeferredClientStub: public ola::proto::OlaClientService_Stub {
+ public:
+  DeferredClientStub(): ola::proto::OlaClientService_Stub(NULL) {}
+
+  void UpdateDmxData(OLA_UNUSED ola::rpc::RpcController *controller,
+                     const ola::proto::DmxData *request,
+                     OLA_UNUSED ola::proto::Ack *response,
+                     ola::rpc::RpcService::CompletionCallback *done) {
+    m_sent.push_back(request->data());
+    m_callbacks.push_back(done);
+  }
+
+  // Acknowledge the oldest update.
+  void Ack() {
+    ola::rpc::RpcService::CompletionCallback *done = m_callbacks.front();
+    m_callbacks.pop_front();
+    done->Run();
+  }
+
+  const std::deque<string> &Sent() const { return m_sent; }
+
+ private:
+  std::deque<string> m_sent;
+  std::deque<ola::rpc::RpcService::CompletionCallback*> m_callbacks;
+};
+
+/*
+ * A SchedulerInterface that lets the test run the single timeouts.
+ */
+class MockScheduler: public ola::thread::SchedulerInterface {
+ public:
+  MockScheduler() : m_next_id(1) {}
+  ~MockScheduler() {
+    TimeoutMap::iterator iter = m_timeouts.begin();
+    for (; iter != m_timeouts.end(); ++iter) {
+      delete iter->second;
+    }
+  }
+
+  timeout_id RegisterRepeatingTimeout(unsigned int, ola::Callback0<bool>*) {
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  timeout_id RegisterRepeatingTimeout(const TimeInterval&,
+                                      ola::Callback0<bool>*) {
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  timeout_id RegisterSingleTimeout(unsigned int,
+                                   ola::SingleUseCallback0<void> *callback) {
+    timeout_id id = reinterpret_cast<timeout_id>(m_next_id++);
+    m_timeouts[id] = callback;
+    return id;
+  }
+
+  timeout_id RegisterSingleTimeout(const TimeInterval &delay,
+                                   ola::SingleUseCallback0<void> *callback) {
+    return RegisterSingleTimeout(delay.InMilliSeconds(), callback);
+  }
+
+  void RemoveTimeout(timeout_id id) {
+    TimeoutMap::iterator iter = m_timeouts.find(id);
+    if (iter != m_timeouts.end()) {
+      delete iter->second;
+      m_timeouts.erase(iter);
+    }
+  }
+
+  unsigned int TimeoutCount() const { return m_timeouts.size(); }
+
+  void RunTimeouts() {
+    TimeoutMap timeouts;
+    timeouts.swap(m_timeouts);
+    TimeoutMap::iterator iter = timeouts.begin();
+    for (; iter != timeouts.end(); ++iter) {
+      iter->second->Run();
+    }
+  }
+
+ private:
+  typedef std::map<timeout_id, ola::SingleUseCallback0<void>*> TimeoutMap;
+
+  uintptr_t m_next_id;
+  TimeoutMap m_timeouts;
+};
+
 /*
  * Check that the SendDMX method works correctly.
  */
@@ -142,3 +263,167 @@ void ClientTest::testGetSetDMX() {
   OLA_ASSERT_FALSE(source4.IsSet());
   OLA_ASSERT(empty == source4.Data());
 }
+
+/*
+ * Check that delta updates only contain the changed slots.
+ */
+void ClientTest::testDeltaUpdates() {
+  RecordingClientStub *stub = new RecordingClientStub();
+  Client client(stub, m_test_uid);
+  uint8_t priority = 100;
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4,5");
+
+  // Without delta updates, the full frame is sent.
+  client.SendDMX(TEST_UNIVERSE, priority, buffer);
+  OLA_ASSERT_FALSE(stub->Last().has_offset());
+  OLA_ASSERT_EQ(buffer.Get(), stub->Last().data());
+
+  // The first update after enabling deltas is a full frame.
+  client.SetDeltaUpdates(TEST_UNIVERSE, true);
+  client.SendDMX(TEST_UNIVERSE, priority, buffer);
+  OLA_ASSERT_FALSE(stub->Last().has_offset());
+  OLA_ASSERT_EQ(buffer.Get(), stub->Last().data());
+
+  buffer.SetChannel(1, 20);
+  buffer.SetChannel(2, 30);
+  client.SendDMX(TEST_UNIVERSE, priority, buffer);
+  OLA_ASSERT_TRUE(stub->Last().has_offset());
+  OLA_ASSERT_EQ(1u, stub->Last().offset());
+  OLA_ASSERT_EQ(string("\x14\x1e"), stub->Last().data());
+
+  // Nothing changed.
+  client.SendDMX(TEST_UNIVERSE, priority, buffer);
+  OLA_ASSERT_TRUE(stub->Last().has_offset());
+  OLA_ASSERT_TRUE(stub->Last().data().empty());
+
+  // A change in size results in a full frame.
+  buffer.SetFromString("1,2,3");
+  client.SendDMX(TEST_UNIVERSE, priority, buffer);
+  OLA_ASSERT_FALSE(stub->Last().has_offset());
+  OLA_ASSERT_EQ(buffer.Get(), stub->Last().data());
+
+  // A full frame is sent every K_DELTA_KEYFRAME_INTERVAL updates.
+  for (unsigned int i = 0; i < Client::K_DELTA_KEYFRAME_INTERVAL; i++) {
+    client.SendDMX(TEST_UNIVERSE, priority, buffer);
+    OLA_ASSERT_TRUE(stub->Last().has_offset());
+  }
+  client.SendDMX(TEST_UNIVERSE, priority, buffer);
+  OLA_ASSERT_FALSE(stub->Last().has_offset());
+
+  // Other universes aren't affected.
+  client.SendDMX(TEST_UNIVERSE2, priority, buffer);
+  OLA_ASSERT_FALSE(stub->Last().has_offset());
+
+  client.SetDeltaUpdates(TEST_UNIVERSE, false);
+  client.SendDMX(TEST_UNIVERSE, priority, buffer);
+  OLA_ASSERT_FALSE(stub->Last().has_offset());
+}
+
+/*
+ * Check that updates to a slow client are dropped past the high watermark.
+ */
+void ClientTest::testWatermarks() {
+  DeferredClientStub *stub = new DeferredClientStub();
+  Client client(stub, m_test_uid);
+  client.SetWatermarks(3, 1);
+  uint8_t priority = 100;
+  const DmxBuffer first("1"), second("2"), third("3");
+
+  client.SendDMX(TEST_UNIVERSE, priority, first);
+  client.SendDMX(TEST_UNIVERSE2, priority, first);
+  client.SendDMX(TEST_UNIVERSE, priority, first);
+  OLA_ASSERT_EQ(3u, client.OutstandingUpdates());
+  OLA_ASSERT_EQ(static_cast<size_t>(3), stub->Sent().size());
+
+  // Past the high watermark, only the latest frame is kept.
+  client.SendDMX(TEST_UNIVERSE, priority, first);
+  client.SendDMX(TEST_UNIVERSE, priority, second);
+  client.SendDMX(TEST_UNIVERSE, priority, third);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), stub->Sent().size());
+  OLA_ASSERT_EQ(2u, client.DroppedUpdates());
+
+  // Still above the low watermark.
+  stub->Ack();
+  client.SendDMX(TEST_UNIVERSE2, priority, second);
+  OLA_ASSERT_EQ(2u, client.OutstandingUpdates());
+  OLA_ASSERT_EQ(static_cast<size_t>(3), stub->Sent().size());
+
+  // The held frames are sent once the low watermark is reached.
+  stub->Ack();
+  OLA_ASSERT_EQ(3u, client.OutstandingUpdates());
+  OLA_ASSERT_EQ(static_cast<size_t>(5), stub->Sent().size());
+  OLA_ASSERT_EQ(third.Get(), stub->Sent()[3]);
+  OLA_ASSERT_EQ(second.Get(), stub->Sent()[4]);
+  OLA_ASSERT_EQ(2u, client.DroppedUpdates());
+
+  while (client.OutstandingUpdates()) {
+    stub->Ack();
+  }
+}
+
+
+/*
+ * Check that updates are limited by rate and by the size of the change.
+ */
+void ClientTest::testRateLimit() {
+  DeferredClientStub *stub = new DeferredClientStub();
+  MockScheduler scheduler;
+  ola::TimeStamp now;
+  Client client(stub, m_test_uid);
+  client.SetScheduler(&scheduler, &now);
+  uint8_t priority = 100;
+  const DmxBuffer first("1"), second("2"), third("3");
+
+  client.SetRateLimit(TEST_UNIVERSE, 10, 0);
+  client.SendDMX(TEST_UNIVERSE, priority, first);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), stub->Sent().size());
+
+  // Too soon, so only the latest frame is held.
+  client.SendDMX(TEST_UNIVERSE, priority, second);
+  client.SendDMX(TEST_UNIVERSE, priority, third);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), stub->Sent().size());
+  OLA_ASSERT_EQ(1u, scheduler.TimeoutCount());
+
+  // Other universes aren't limited.
+  client.SendDMX(TEST_UNIVERSE2, priority, second);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), stub->Sent().size());
+
+  now += TimeInterval(0, 100000);
+  scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), stub->Sent().size());
+  OLA_ASSERT_EQ(third.Get(), stub->Sent()[2]);
+  OLA_ASSERT_EQ(0u, scheduler.TimeoutCount());
+
+  // Removing the limit cancels the pending timeout.
+  client.SendDMX(TEST_UNIVERSE, priority, first);
+  OLA_ASSERT_EQ(1u, scheduler.TimeoutCount());
+  client.SetRateLimit(TEST_UNIVERSE, 0, 0);
+  OLA_ASSERT_EQ(0u, scheduler.TimeoutCount());
+  client.SendDMX(TEST_UNIVERSE, priority, first);
+  OLA_ASSERT_EQ(static_cast<size_t>(4), stub->Sent().size());
+
+  // Now check the minimum change.
+  client.SetRateLimit(TEST_UNIVERSE2, 0, 5);
+  DmxBuffer buffer;
+  buffer.SetFromString("10,20");
+  client.SendDMX(TEST_UNIVERSE2, priority, buffer);
+  OLA_ASSERT_EQ(static_cast<size_t>(5), stub->Sent().size());
+
+  buffer.SetFromString("14,16");
+  client.SendDMX(TEST_UNIVERSE2, priority, buffer);
+  OLA_ASSERT_EQ(static_cast<size_t>(5), stub->Sent().size());
+
+  buffer.SetFromString("10,25");
+  client.SendDMX(TEST_UNIVERSE2, priority, buffer);
+  OLA_ASSERT_EQ(static_cast<size_t>(6), stub->Sent().size());
+
+  // A change in size is always sent.
+  buffer.SetFromString("10");
+  client.SendDMX(TEST_UNIVERSE2, priority, buffer);
+  OLA_ASSERT_EQ(static_cast<size_t>(7), stub->Sent().size());
+
+  while (client.OutstandingUpdates()) {
+    stub->Ack();
+  }
+}
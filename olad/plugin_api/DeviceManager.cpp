@@ -23,20 +23,20 @@
 
 #include <stdio.h>
 #include <errno.h>
-#include <map>
+#include <algorithm>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/dmx/SlotRemap.h"
 #include "ola/stl/STLUtils.h"
 #include "olad/Port.h"
 #include "olad/plugin_api/PortManager.h"
 
 namespace ola {
 
-using std::map;
 using std::set;
 using std::string;
 using std::vector;
@@ -45,6 +45,9 @@ const unsigned int DeviceManager::MISSING_DEVICE_ALIAS = 0;
 const char DeviceManager::PORT_PREFERENCES[] = "port";
 const char DeviceManager::PRIORITY_VALUE_SUFFIX[] = "_priority_value";
 const char DeviceManager::PRIORITY_MODE_SUFFIX[] = "_priority_mode";
+const char DeviceManager::SLOT_REMAP_SUFFIX[] = "_slot_remap";
+const char DeviceManager::MAX_RATE_SUFFIX[] = "_max_rate";
+const char DeviceManager::MAX_BURST_SUFFIX[] = "_max_burst";
 
 bool operator <(const device_alias_pair& left,
                 const device_alias_pair &right) {
@@ -105,17 +108,22 @@ bool DeviceManager::RegisterDevice(AbstractDevice *device) {
   OLA_INFO << "Installed device: " << device->Name() << ":"
            << device->UniqueId();
 
+  // Collect the saved patchings for all ports, so the device's universes are
+  // only checked once.
+  vector<PortManager::PortPatch> patches;
   vector<InputPort*> input_ports;
   device->InputPorts(&input_ports);
-  RestorePortSettings(input_ports);
+  RestorePortSettings(input_ports, &patches);
 
   vector<OutputPort*> output_ports;
   device->OutputPorts(&output_ports);
-  RestorePortSettings(output_ports);
+  RestorePortSettings(output_ports, &patches);
+  m_port_manager->PatchPorts(patches);
 
   // look for timecode ports and add them to the set
   vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
   for (; output_iter != output_ports.end(); ++output_iter) {
+    RestorePortRateLimit(*output_iter);
     if ((*output_iter)->SupportsTimeCode()) {
       m_timecode_ports.insert(*output_iter);
     }
@@ -157,12 +165,13 @@ unsigned int DeviceManager::DeviceCount() const {
 
 vector<device_alias_pair> DeviceManager::Devices() const {
   vector<device_alias_pair> result;
-  map<string, device_alias_pair>::const_iterator iter;
+  DeviceIdMap::const_iterator iter;
   for (iter = m_devices.begin(); iter != m_devices.end(); ++iter) {
     if (iter->second.device) {
       result.push_back(iter->second);
     }
   }
+  std::sort(result.begin(), result.end());
   return result;
 }
 
@@ -214,11 +223,14 @@ void DeviceManager::ReleaseDevice(const AbstractDevice *device) {
   vector<InputPort*>::const_iterator input_iter = input_ports.begin();
   for (; input_iter != input_ports.end(); ++input_iter) {
     SavePortPriority(**input_iter);
+    SavePortSlotRemap(**input_iter);
   }
 
   vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
   for (; output_iter != output_ports.end(); ++output_iter) {
     SavePortPriority(**output_iter);
+    SavePortSlotRemap(**output_iter);
+    SavePortRateLimit(**output_iter);
 
     // remove from the timecode port set
     STLRemove(&m_timecode_ports, *output_iter);
@@ -311,10 +323,96 @@ void DeviceManager::RestorePortPriority(Port *port) const {
 
 
 /*
- * Restore the patching information for a port.
+ * Save the slot remap for a port
+ */
+void DeviceManager::SavePortSlotRemap(const Port &port) const {
+  string port_id = port.UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  if (port.GetSlotRemap().Empty()) {
+    m_port_preferences->RemoveValue(port_id + SLOT_REMAP_SUFFIX);
+  } else {
+    m_port_preferences->SetValue(port_id + SLOT_REMAP_SUFFIX,
+                                 port.GetSlotRemap().ToString());
+  }
+}
+
+
+/*
+ * Restore the slot remap for a port
+ */
+void DeviceManager::RestorePortSlotRemap(Port *port) const {
+  string port_id = port->UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  string remap_str = m_port_preferences->GetValue(port_id + SLOT_REMAP_SUFFIX);
+  if (remap_str.empty()) {
+    return;
+  }
+
+  ola::dmx::SlotRemap remap;
+  if (remap.FromString(remap_str)) {
+    port->SetSlotRemap(remap);
+  } else {
+    OLA_WARN << "Invalid slot remap for " << port_id << ": " << remap_str;
+  }
+}
+
+
+/*
+ * Save the output rate limit for a port
+ */
+void DeviceManager::SavePortRateLimit(const OutputPort &port) const {
+  string port_id = port.UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  if (port.MaxRate()) {
+    m_port_preferences->SetValue(port_id + MAX_RATE_SUFFIX,
+                                 IntToString(port.MaxRate()));
+    m_port_preferences->SetValue(port_id + MAX_BURST_SUFFIX,
+                                 IntToString(port.MaxBurst()));
+  } else {
+    m_port_preferences->RemoveValue(port_id + MAX_RATE_SUFFIX);
+    m_port_preferences->RemoveValue(port_id + MAX_BURST_SUFFIX);
+  }
+}
+
+
+/*
+ * Restore the output rate limit for a port
+ */
+void DeviceManager::RestorePortRateLimit(OutputPort *port) const {
+  string port_id = port->UniqueId();
+  if (!m_port_preferences || port_id.empty()) {
+    return;
+  }
+
+  unsigned int max_rate, max_burst = 1;
+  if (!StringToInt(m_port_preferences->GetValue(port_id + MAX_RATE_SUFFIX),
+                   &max_rate)) {
+    return;
+  }
+  StringToInt(m_port_preferences->GetValue(port_id + MAX_BURST_SUFFIX),
+              &max_burst);
+  port->SetRateLimit(max_rate, max_burst);
+}
+
+
+/*
+ * Restore the settings for a set of ports. The saved patchings are appended
+ * to patches. Ports without a saved patching are patched to their default
+ * universe, if they have one.
  */
 template <class PortClass>
-void DeviceManager::RestorePortSettings(const vector<PortClass*> &ports) const {
+void DeviceManager::RestorePortSettings(
+    const vector<PortClass*> &ports,
+    vector<PortManager::PortPatch> *patches) const {
   if (!m_port_preferences) {
     return;
   }
@@ -322,6 +420,7 @@ void DeviceManager::RestorePortSettings(const vector<PortClass*> &ports) const {
   typename vector<PortClass*>::const_iterator iter = ports.begin();
   while (iter != ports.end()) {
     RestorePortPriority(*iter);
+    RestorePortSlotRemap(*iter);
     PortClass *port = *iter;
     iter++;
 
@@ -330,15 +429,20 @@ void DeviceManager::RestorePortSettings(const vector<PortClass*> &ports) const {
       continue;
 
     string uni_id = m_port_preferences->GetValue(port_id);
-    if (uni_id.empty())
+    if (uni_id.empty()) {
+      unsigned int universe;
+      if (port->DefaultUniverse(&universe)) {
+        patches->push_back(PortManager::PortPatch(port, true, universe));
+      }
       continue;
+    }
 
     errno = 0;
     int id = static_cast<int>(strtol(uni_id.c_str(), NULL, 10));
     if ((id == 0 && errno) || id < 0)
       continue;
 
-    m_port_manager->PatchPort(port, id);
+    patches->push_back(PortManager::PortPatch(port, true, id));
   }
 }
 }  // namespace ola
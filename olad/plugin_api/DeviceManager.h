@@ -21,14 +21,19 @@
 #ifndef OLAD_PLUGIN_API_DEVICEMANAGER_H_
 #define OLAD_PLUGIN_API_DEVICEMANAGER_H_
 
-#include <map>
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <set>
 #include <string>
 #include <vector>
+#include HASH_MAP_H
 #include "ola/base/Macro.h"
 #include "ola/timecode/TimeCode.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PortManager.h"
 
 namespace ola {
 
@@ -67,7 +72,7 @@ class DeviceManager {
    * @param port_manager the PortManager to use, ownership is not transferred.
    */
   DeviceManager(PreferencesFactory *prefs_factory,
-                class PortManager *port_manager);
+                PortManager *port_manager);
 
   /**
    * @brief Destructor.
@@ -138,11 +143,13 @@ class DeviceManager {
   static const unsigned int MISSING_DEVICE_ALIAS;
 
  private:
-  typedef std::map<std::string, device_alias_pair> DeviceIdMap;
-  typedef std::map<unsigned int, AbstractDevice*> DeviceAliasMap;
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<std::string, device_alias_pair>
+      DeviceIdMap;
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<unsigned int, AbstractDevice*>
+      DeviceAliasMap;
 
   Preferences *m_port_preferences;
-  class PortManager *m_port_manager;
+  PortManager *m_port_manager;
 
   DeviceIdMap m_devices;
   DeviceAliasMap m_alias_map;
@@ -158,14 +165,23 @@ class DeviceManager {
 
   void SavePortPriority(const Port &port) const;
   void RestorePortPriority(Port *port) const;
+  void SavePortSlotRemap(const Port &port) const;
+  void RestorePortSlotRemap(Port *port) const;
+  void SavePortRateLimit(const OutputPort &port) const;
+  void RestorePortRateLimit(OutputPort *port) const;
 
   template <class PortClass>
-  void RestorePortSettings(const std::vector<PortClass*> &ports) const;
+  void RestorePortSettings(
+      const std::vector<PortClass*> &ports,
+      std::vector<PortManager::PortPatch> *patches) const;
 
   static const char PORT_PREFERENCES[];
   static const unsigned int FIRST_DEVICE_ALIAS = 1;
   static const char PRIORITY_VALUE_SUFFIX[];
   static const char PRIORITY_MODE_SUFFIX[];
+  static const char SLOT_REMAP_SUFFIX[];
+  static const char MAX_RATE_SUFFIX[];
+  static const char MAX_BURST_SUFFIX[];
 
   DISALLOW_COPY_AND_ASSIGN(DeviceManager);
 };
@@ -47,17 +47,42 @@ using std::string;
 using std::vector;
 
 
+/**
+ * An output port with a default universe.
+ */
+class DefaultUniverseOutputPort: public TestMockOutputPort {
+ public:
+  DefaultUniverseOutputPort(AbstractDevice *parent, unsigned int port_id,
+                            unsigned int universe)
+      : TestMockOutputPort(parent, port_id),
+        m_universe(universe) {
+  }
+
+  bool DefaultUniverse(unsigned int *universe) const {
+    *universe = m_universe;
+    return true;
+  }
+
+ private:
+  const unsigned int m_universe;
+};
+
+
 class DeviceManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DeviceManagerTest);
   CPPUNIT_TEST(testDeviceManager);
   CPPUNIT_TEST(testRestorePatchings);
+  CPPUNIT_TEST(testDefaultPatchings);
   CPPUNIT_TEST(testRestorePriorities);
+  CPPUNIT_TEST(testRestoreSlotRemaps);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testDeviceManager();
     void testRestorePatchings();
+    void testDefaultPatchings();
     void testRestorePriorities();
+    void testRestoreSlotRemaps();
 };
 
 
@@ -195,6 +220,41 @@ void DeviceManagerTest::testRestorePatchings() {
 }
 
 
+/*
+ * Check that ports without a saved patching use their default universe.
+ */
+void DeviceManagerTest::testDefaultPatchings() {
+  ola::MemoryPreferencesFactory prefs_factory;
+  UniverseStore uni_store(NULL, NULL);
+  ola::PortBroker broker;
+  PortManager port_manager(&uni_store, &broker);
+  DeviceManager manager(&prefs_factory, &port_manager);
+
+  ola::Preferences *prefs = prefs_factory.NewPreference("port");
+  OLA_ASSERT(prefs);
+  prefs->SetValue("2-test-device-1-O-1", "3");
+
+  TestMockPlugin plugin(NULL, ola::OLA_PLUGIN_ARTNET);
+  MockDevice device1(&plugin, "test-device-1");
+  DefaultUniverseOutputPort saved_port(&device1, 1, 5);
+  DefaultUniverseOutputPort default_port(&device1, 2, 6);
+  TestMockOutputPort unpatched_port(&device1, 3);
+  device1.AddPort(&saved_port);
+  device1.AddPort(&default_port);
+  device1.AddPort(&unpatched_port);
+
+  OLA_ASSERT(manager.RegisterDevice(&device1));
+  OLA_ASSERT(saved_port.GetUniverse());
+  OLA_ASSERT_EQ(3u, saved_port.GetUniverse()->UniverseId());
+  OLA_ASSERT(default_port.GetUniverse());
+  OLA_ASSERT_EQ(6u, default_port.GetUniverse()->UniverseId());
+  OLA_ASSERT_NULL(unpatched_port.GetUniverse());
+
+  manager.UnregisterAllDevices();
+  OLA_ASSERT_EQ(string("6"), prefs->GetValue("2-test-device-1-O-2"));
+}
+
+
 /*
  * Test that port priorities are restored correctly.
  */
@@ -291,3 +351,48 @@ void DeviceManagerTest::testRestorePriorities() {
   OLA_ASSERT_EQ(string("60"),
                 prefs->GetValue("2-test_device_1-O-3_priority_value"));
 }
+
+
+/*
+ * Test that port slot remaps are restored correctly.
+ */
+void DeviceManagerTest::testRestoreSlotRemaps() {
+  ola::MemoryPreferencesFactory prefs_factory;
+  UniverseStore uni_store(NULL, NULL);
+  ola::PortBroker broker;
+  PortManager port_manager(&uni_store, &broker);
+  DeviceManager manager(&prefs_factory, &port_manager);
+
+  ola::Preferences *prefs = prefs_factory.NewPreference("port");
+  OLA_ASSERT(prefs);
+  prefs->SetValue("2-test_device_1-I-1_slot_remap", "1-10=11");
+  prefs->SetValue("2-test_device_1-O-1_slot_remap", "11-512=1");
+  prefs->SetValue("2-test_device_1-O-2_slot_remap", "foo");  // invalid
+
+  TestMockPlugin plugin(NULL, ola::OLA_PLUGIN_ARTNET);
+  MockDevice device1(&plugin, "test_device_1");
+  TestMockInputPort input_port(&device1, 1, NULL);
+  TestMockOutputPort output_port(&device1, 1);
+  TestMockOutputPort output_port2(&device1, 2);
+  device1.AddPort(&input_port);
+  device1.AddPort(&output_port);
+  device1.AddPort(&output_port2);
+
+  OLA_ASSERT(manager.RegisterDevice(&device1));
+  OLA_ASSERT_EQ(string("1-10=11"), input_port.GetSlotRemap().ToString());
+  OLA_ASSERT_EQ(string("11-512=1"), output_port.GetSlotRemap().ToString());
+  OLA_ASSERT(output_port2.GetSlotRemap().Empty());
+
+  // Now make some changes
+  input_port.SetSlotRemap(ola::dmx::SlotRemap());
+  ola::dmx::SlotRemap remap;
+  OLA_ASSERT(remap.FromString("1=2,2=1"));
+  output_port2.SetSlotRemap(remap);
+
+  manager.UnregisterAllDevices();
+  OLA_ASSERT_EQ(string(""), prefs->GetValue("2-test_device_1-I-1_slot_remap"));
+  OLA_ASSERT_EQ(string("11-512=1"),
+                prefs->GetValue("2-test_device_1-O-1_slot_remap"));
+  OLA_ASSERT_EQ(string("1=2,2=1"),
+                prefs->GetValue("2-test_device_1-O-2_slot_remap"));
+}
@@ -0,0 +1,279 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DiscoveryScheduler.cpp
+ * Limits the number of output ports running RDM discovery at once.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/DiscoveryScheduler.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/math/Random.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/Port.h"
+
+namespace ola {
+
+using ola::rdm::RDMDiscoveryCallback;
+using ola::rdm::UIDSet;
+using ola::thread::INVALID_TIMEOUT;
+using std::vector;
+
+const char DiscoveryScheduler::K_DISCOVERY_FULL_VAR[] =
+    "rdm-discovery-full-runs";
+const char DiscoveryScheduler::K_DISCOVERY_INCREMENTAL_VAR[] =
+    "rdm-discovery-incremental-runs";
+const char DiscoveryScheduler::K_DISCOVERY_QUEUE_TIME_VAR[] =
+    "rdm-discovery-queue-time-ms";
+const char DiscoveryScheduler::K_DISCOVERY_TIME_VAR[] =
+    "rdm-discovery-time-ms";
+const char DiscoveryScheduler::K_DISCOVERY_UIDS_VAR[] = "rdm-discovery-uids";
+
+DiscoveryScheduler::DiscoveryScheduler(
+    ola::thread::SchedulerInterface *scheduler,
+    ExportMap *export_map,
+    Clock *clock)
+    : m_scheduler(scheduler),
+      m_export_map(export_map),
+      m_clock(clock),
+      m_free_clock(false),
+      m_max_concurrent(0),
+      m_max_jitter(0),
+      m_starting(false) {
+  if (!m_clock) {
+    m_clock = new MonotonicClock();
+    m_free_clock = true;
+  }
+}
+
+
+DiscoveryScheduler::~DiscoveryScheduler() {
+  RequestMap::iterator iter = m_queued.begin();
+  for (; iter != m_queued.end(); ++iter) {
+    STLDeleteElements(&iter->second->callbacks);
+    delete iter->second;
+  }
+
+  // Requests waiting for their start time haven't been passed to the port.
+  for (iter = m_running.begin(); iter != m_running.end(); ++iter) {
+    if (iter->second->timeout != INVALID_TIMEOUT) {
+      m_scheduler->RemoveTimeout(iter->second->timeout);
+      STLDeleteElements(&iter->second->callbacks);
+      delete iter->second;
+    }
+  }
+
+  if (m_free_clock) {
+    delete m_clock;
+  }
+}
+
+
+void DiscoveryScheduler::RunDiscovery(OutputPort *port, bool full,
+                                      RDMDiscoveryCallback *on_complete) {
+  DiscoveryRequest *request = STLFindOrNull(m_queued, port);
+  if (request) {
+    if (full && !request->full) {
+      RemoveFromQueue(&m_incremental_queue, request);
+      request->full = true;
+      m_full_queue.push_back(request);
+    }
+    if (on_complete) {
+      request->callbacks.push_back(on_complete);
+    }
+    return;
+  }
+
+  request = new DiscoveryRequest();
+  request->port = port;
+  request->port_id = port->UniqueId();
+  request->full = full;
+  request->timeout = INVALID_TIMEOUT;
+  if (on_complete) {
+    request->callbacks.push_back(on_complete);
+  }
+  m_clock->CurrentTime(&request->queued);
+
+  m_queued[port] = request;
+  if (full) {
+    m_full_queue.push_back(request);
+  } else {
+    m_incremental_queue.push_back(request);
+  }
+  StartQueuedDiscovery();
+}
+
+
+void DiscoveryScheduler::RemovePort(OutputPort *port) {
+  const UIDSet uids;
+
+  RequestMap::iterator iter = m_running.find(port);
+  if (iter != m_running.end()) {
+    DiscoveryRequest *request = iter->second;
+    m_running.erase(iter);
+    if (request->timeout != INVALID_TIMEOUT) {
+      m_scheduler->RemoveTimeout(request->timeout);
+      RunCallbacks(request, uids);
+      delete request;
+    } else {
+      // The port still owns the completion callback, so leave the request for
+      // DiscoveryComplete() to clean up.
+      request->port = NULL;
+    }
+  }
+
+  iter = m_queued.find(port);
+  if (iter != m_queued.end()) {
+    DiscoveryRequest *request = iter->second;
+    m_queued.erase(iter);
+    RemoveFromQueue(
+        request->full ? &m_full_queue : &m_incremental_queue, request);
+    RunCallbacks(request, uids);
+    delete request;
+  }
+  StartQueuedDiscovery();
+}
+
+
+/*
+ * Start discovery on as many ports as the limit allows. Ports may complete
+ * discovery straight away, so this loops rather than recursing.
+ */
+void DiscoveryScheduler::StartQueuedDiscovery() {
+  if (m_starting) {
+    return;
+  }
+
+  m_starting = true;
+  while (!m_max_concurrent || m_running.size() < m_max_concurrent) {
+    DiscoveryRequest *request = TakeNextRequest(&m_incremental_queue);
+    if (!request) {
+      request = TakeNextRequest(&m_full_queue);
+    }
+    if (!request) {
+      break;
+    }
+
+    m_queued.erase(request->port);
+    m_running[request->port] = request;
+
+    unsigned int delay = m_max_jitter ?
+        ola::math::Random(0, m_max_jitter) : 0;
+    if (delay) {
+      request->timeout = m_scheduler->RegisterSingleTimeout(
+          delay,
+          NewSingleCallback(this, &DiscoveryScheduler::StartDiscovery,
+                            request));
+    } else {
+      StartDiscovery(request);
+    }
+  }
+  m_starting = false;
+}
+
+
+/*
+ * Remove the first request from the queue for a port that isn't already
+ * running discovery.
+ */
+DiscoveryScheduler::DiscoveryRequest *DiscoveryScheduler::TakeNextRequest(
+    RequestQueue *queue) {
+  RequestQueue::iterator iter = queue->begin();
+  for (; iter != queue->end(); ++iter) {
+    if (!STLContains(m_running, (*iter)->port)) {
+      DiscoveryRequest *request = *iter;
+      queue->erase(iter);
+      return request;
+    }
+  }
+  return NULL;
+}
+
+
+void DiscoveryScheduler::StartDiscovery(DiscoveryRequest *request) {
+  request->timeout = INVALID_TIMEOUT;
+  m_clock->CurrentTime(&request->started);
+
+  OLA_DEBUG << "Starting " << (request->full ? "full" : "incremental")
+            << " RDM discovery on " << request->port_id;
+
+  RDMDiscoveryCallback *callback = NewSingleCallback(
+      this, &DiscoveryScheduler::DiscoveryComplete, request);
+  if (request->full) {
+    request->port->RunFullDiscovery(callback);
+  } else {
+    request->port->RunIncrementalDiscovery(callback);
+  }
+}
+
+
+void DiscoveryScheduler::DiscoveryComplete(DiscoveryRequest *request,
+                                           const UIDSet &uids) {
+  if (request->port) {
+    m_running.erase(request->port);
+    UpdateStats(*request, uids);
+  }
+  RunCallbacks(request, uids);
+  delete request;
+  StartQueuedDiscovery();
+}
+
+
+void DiscoveryScheduler::UpdateStats(const DiscoveryRequest &request,
+                                     const UIDSet &uids) {
+  if (!m_export_map) {
+    return;
+  }
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  (*m_export_map->GetUIntMapVar(K_DISCOVERY_TIME_VAR))[request.port_id] =
+      (now - request.started).InMilliSeconds();
+  (*m_export_map->GetUIntMapVar(K_DISCOVERY_QUEUE_TIME_VAR))[request.port_id] =
+      (request.started - request.queued).InMilliSeconds();
+  (*m_export_map->GetUIntMapVar(K_DISCOVERY_UIDS_VAR))[request.port_id] =
+      uids.Size();
+  m_export_map->GetUIntMapVar(
+      request.full ? K_DISCOVERY_FULL_VAR : K_DISCOVERY_INCREMENTAL_VAR)->
+      Increment(request.port_id);
+}
+
+
+void DiscoveryScheduler::RunCallbacks(DiscoveryRequest *request,
+                                      const UIDSet &uids) {
+  vector<RDMDiscoveryCallback*> callbacks;
+  callbacks.swap(request->callbacks);
+  vector<RDMDiscoveryCallback*>::iterator iter = callbacks.begin();
+  for (; iter != callbacks.end(); ++iter) {
+    (*iter)->Run(uids);
+  }
+}
+
+
+void DiscoveryScheduler::RemoveFromQueue(RequestQueue *queue,
+                                         DiscoveryRequest *request) {
+  RequestQueue::iterator iter = std::find(queue->begin(), queue->end(),
+                                          request);
+  if (iter != queue->end()) {
+    queue->erase(iter);
+  }
+}
+}  // namespace ola
@@ -0,0 +1,168 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DiscoveryScheduler.h
+ * Limits the number of output ports running RDM discovery at once.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_DISCOVERYSCHEDULER_H_
+#define OLAD_PLUGIN_API_DISCOVERYSCHEDULER_H_
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/rdm/RDMControllerInterface.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+
+class OutputPort;
+
+/**
+ * @brief Runs RDM discovery on the output ports of all universes.
+ *
+ * Each port runs discovery independently of the others, so the ports from
+ * different universes are discovered at the same time. The number of ports
+ * running discovery at once can be limited, and each start can be delayed by
+ * a random amount so that ports on the same network don't all start together.
+ *
+ * Incremental discovery is run before full discovery, since it's quicker and
+ * is what keeps the UID lists current. Only one discovery is queued for each
+ * port; later requests for the same port share the result, and a request for
+ * full discovery upgrades a queued incremental one.
+ *
+ * The time taken by the last discovery on each port, the time it spent
+ * queued, the number of UIDs found and the number of runs are exported to the
+ * ExportMap, keyed by the port's unique id.
+ */
+class DiscoveryScheduler {
+ public:
+  /**
+   * @brief Create a new DiscoveryScheduler.
+   * @param scheduler the SchedulerInterface used to delay the start of
+   *   discovery.
+   * @param export_map the ExportMap to update, may be NULL.
+   * @param clock the Clock to use, if NULL a MonotonicClock is created.
+   */
+  DiscoveryScheduler(ola::thread::SchedulerInterface *scheduler,
+                     ExportMap *export_map,
+                     Clock *clock = NULL);
+
+  /**
+   * @brief Destructor.
+   *
+   * The callbacks for any queued discovery are deleted without being run.
+   */
+  ~DiscoveryScheduler();
+
+  /**
+   * @brief Limit the number of ports running discovery at once.
+   * @param limit the maximum number of ports, 0 means no limit, which is the
+   *   default.
+   */
+  void SetMaxConcurrent(unsigned int limit) { m_max_concurrent = limit; }
+
+  /**
+   * @brief Delay the start of each discovery by a random amount.
+   * @param max_jitter_ms the maximum delay in ms, 0 disables the delay, which
+   *   is the default.
+   */
+  void SetJitter(unsigned int max_jitter_ms) { m_max_jitter = max_jitter_ms; }
+
+  /**
+   * @brief Run discovery on a port.
+   * @param port the port to run discovery on.
+   * @param full true for full discovery, false for incremental.
+   * @param on_complete run with the UIDs found, may be NULL.
+   *
+   * on_complete may be run before this returns.
+   */
+  void RunDiscovery(OutputPort *port, bool full,
+                    ola::rdm::RDMDiscoveryCallback *on_complete);
+
+  /**
+   * @brief Remove a port from the scheduler.
+   * @param port the port to remove.
+   *
+   * Any queued discovery is cancelled, and the callbacks are run with an
+   * empty UIDSet. If discovery is running on the port, the port no longer
+   * counts towards the limit.
+   */
+  void RemovePort(OutputPort *port);
+
+  /**
+   * @brief Return the number of ports waiting to run discovery.
+   */
+  unsigned int QueuedCount() const { return m_queued.size(); }
+
+  /**
+   * @brief Return the number of ports running discovery.
+   */
+  unsigned int RunningCount() const { return m_running.size(); }
+
+  static const char K_DISCOVERY_FULL_VAR[];
+  static const char K_DISCOVERY_INCREMENTAL_VAR[];
+  static const char K_DISCOVERY_QUEUE_TIME_VAR[];
+  static const char K_DISCOVERY_TIME_VAR[];
+  static const char K_DISCOVERY_UIDS_VAR[];
+
+ private:
+  struct DiscoveryRequest {
+    OutputPort *port;
+    std::string port_id;
+    bool full;
+    std::vector<ola::rdm::RDMDiscoveryCallback*> callbacks;
+    TimeStamp queued;
+    TimeStamp started;
+    ola::thread::timeout_id timeout;
+  };
+
+  typedef std::deque<DiscoveryRequest*> RequestQueue;
+  typedef std::map<OutputPort*, DiscoveryRequest*> RequestMap;
+
+  ola::thread::SchedulerInterface *m_scheduler;
+  ExportMap *m_export_map;
+  Clock *m_clock;
+  bool m_free_clock;
+  unsigned int m_max_concurrent;
+  unsigned int m_max_jitter;
+  bool m_starting;
+  RequestQueue m_incremental_queue;
+  RequestQueue m_full_queue;
+  RequestMap m_queued;
+  RequestMap m_running;
+
+  void StartQueuedDiscovery();
+  DiscoveryRequest *TakeNextRequest(RequestQueue *queue);
+  void StartDiscovery(DiscoveryRequest *request);
+  void DiscoveryComplete(DiscoveryRequest *request,
+                         const ola::rdm::UIDSet &uids);
+  void UpdateStats(const DiscoveryRequest &request,
+                   const ola::rdm::UIDSet &uids);
+  void RunCallbacks(DiscoveryRequest *request,
+                    const ola::rdm::UIDSet &uids);
+  void RemoveFromQueue(RequestQueue *queue, DiscoveryRequest *request);
+
+  DISALLOW_COPY_AND_ASSIGN(DiscoveryScheduler);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_DISCOVERYSCHEDULER_H_
@@ -0,0 +1,409 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DiscoverySchedulerTest.cpp
+ * Test fixture for the DiscoveryScheduler class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/DiscoveryScheduler.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniverseStore.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DiscoveryScheduler;
+using ola::ExportMap;
+using ola::MockClock;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::Universe;
+using ola::UniverseStore;
+using ola::rdm::RDMDiscoveryCallback;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::string;
+using std::vector;
+
+/**
+ * An output port that holds on to the discovery callbacks until the test
+ * completes them.
+ */
+class DeferredDiscoveryPort: public TestMockOutputPort {
+ public:
+  DeferredDiscoveryPort(ola::AbstractDevice *parent, unsigned int port_id)
+      : TestMockOutputPort(parent, port_id, false, true),
+        full_runs(0),
+        incremental_runs(0) {
+  }
+
+  ~DeferredDiscoveryPort() {
+    while (!m_callbacks.empty()) {
+      delete m_callbacks.front();
+      m_callbacks.pop_front();
+    }
+  }
+
+  void RunFullDiscovery(RDMDiscoveryCallback *on_complete) {
+    full_runs++;
+    m_callbacks.push_back(on_complete);
+  }
+
+  void RunIncrementalDiscovery(RDMDiscoveryCallback *on_complete) {
+    incremental_runs++;
+    m_callbacks.push_back(on_complete);
+  }
+
+  bool Running() const { return !m_callbacks.empty(); }
+
+  void Complete(const UIDSet &uids) {
+    RDMDiscoveryCallback *callback = m_callbacks.front();
+    m_callbacks.pop_front();
+    callback->Run(uids);
+  }
+
+  unsigned int full_runs;
+  unsigned int incremental_runs;
+
+ private:
+  std::deque<RDMDiscoveryCallback*> m_callbacks;
+};
+
+
+class DiscoverySchedulerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DiscoverySchedulerTest);
+  CPPUNIT_TEST(testConcurrencyLimit);
+  CPPUNIT_TEST(testIncrementalFirst);
+  CPPUNIT_TEST(testCoalescing);
+  CPPUNIT_TEST(testRemovePort);
+  CPPUNIT_TEST(testJitter);
+  CPPUNIT_TEST(testStats);
+  CPPUNIT_TEST(testUniverseDiscovery);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  DiscoverySchedulerTest()
+      : m_plugin(NULL, ola::OLA_PLUGIN_ARTNET),
+        m_device(&m_plugin, "test device"),
+        m_port1(&m_device, 1),
+        m_port2(&m_device, 2),
+        m_port3(&m_device, 3) {
+  }
+
+  void setUp();
+  void tearDown();
+
+  void testConcurrencyLimit();
+  void testIncrementalFirst();
+  void testCoalescing();
+  void testRemovePort();
+  void testJitter();
+  void testStats();
+  void testUniverseDiscovery();
+
+ private:
+  MockScheduler m_scheduler;
+  MockClock m_clock;
+  ExportMap m_export_map;
+  TestMockPlugin m_plugin;
+  MockDevice m_device;
+  DeferredDiscoveryPort m_port1, m_port2, m_port3;
+  ola::DiscoveryScheduler *m_discovery;
+  vector<UIDSet> m_results;
+
+  void DiscoveryDone(const UIDSet &uids) {
+    m_results.push_back(uids);
+  }
+
+  RDMDiscoveryCallback *NewDiscoveryCallback() {
+    return NewSingleCallback(this, &DiscoverySchedulerTest::DiscoveryDone);
+  }
+
+  unsigned int PortVar(const char *var, const DeferredDiscoveryPort &port) {
+    return (*m_export_map.GetUIntMapVar(var))[port.UniqueId()];
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DiscoverySchedulerTest);
+
+
+void DiscoverySchedulerTest::setUp() {
+  m_discovery = new DiscoveryScheduler(&m_scheduler, &m_export_map,
+                                       &m_clock);
+}
+
+
+void DiscoverySchedulerTest::tearDown() {
+  delete m_discovery;
+}
+
+
+/*
+ * Check that no more than the limit of ports run discovery at once.
+ */
+void DiscoverySchedulerTest::testConcurrencyLimit() {
+  m_discovery->SetMaxConcurrent(2);
+  m_discovery->RunDiscovery(&m_port1, true, NewDiscoveryCallback());
+  m_discovery->RunDiscovery(&m_port2, true, NewDiscoveryCallback());
+  m_discovery->RunDiscovery(&m_port3, true, NewDiscoveryCallback());
+
+  OLA_ASSERT_TRUE(m_port1.Running());
+  OLA_ASSERT_TRUE(m_port2.Running());
+  OLA_ASSERT_FALSE(m_port3.Running());
+  OLA_ASSERT_EQ(2u, m_discovery->RunningCount());
+  OLA_ASSERT_EQ(1u, m_discovery->QueuedCount());
+
+  UIDSet uids;
+  uids.AddUID(UID(0x7a70, 1));
+  m_port2.Complete(uids);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_results.size());
+  OLA_ASSERT_EQ(uids, m_results[0]);
+  OLA_ASSERT_TRUE(m_port3.Running());
+  OLA_ASSERT_EQ(2u, m_discovery->RunningCount());
+  OLA_ASSERT_EQ(0u, m_discovery->QueuedCount());
+
+  m_port1.Complete(UIDSet());
+  m_port3.Complete(UIDSet());
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_results.size());
+  OLA_ASSERT_EQ(0u, m_discovery->RunningCount());
+
+  // With no limit, all ports start together
+  m_discovery->SetMaxConcurrent(0);
+  m_discovery->RunDiscovery(&m_port1, false, NULL);
+  m_discovery->RunDiscovery(&m_port2, false, NULL);
+  m_discovery->RunDiscovery(&m_port3, false, NULL);
+  OLA_ASSERT_EQ(3u, m_discovery->RunningCount());
+  m_port1.Complete(UIDSet());
+  m_port2.Complete(UIDSet());
+  m_port3.Complete(UIDSet());
+}
+
+
+/*
+ * Check that incremental discovery is run before full discovery.
+ */
+void DiscoverySchedulerTest::testIncrementalFirst() {
+  m_discovery->SetMaxConcurrent(1);
+  m_discovery->RunDiscovery(&m_port1, true, NULL);
+  m_discovery->RunDiscovery(&m_port2, true, NULL);
+  m_discovery->RunDiscovery(&m_port3, false, NULL);
+  OLA_ASSERT_TRUE(m_port1.Running());
+
+  m_port1.Complete(UIDSet());
+  OLA_ASSERT_FALSE(m_port2.Running());
+  OLA_ASSERT_TRUE(m_port3.Running());
+  OLA_ASSERT_EQ(1u, m_port3.incremental_runs);
+
+  m_port3.Complete(UIDSet());
+  OLA_ASSERT_TRUE(m_port2.Running());
+  OLA_ASSERT_EQ(1u, m_port2.full_runs);
+  m_port2.Complete(UIDSet());
+}
+
+
+/*
+ * Check that requests for the same port share a single discovery.
+ */
+void DiscoverySchedulerTest::testCoalescing() {
+  m_discovery->SetMaxConcurrent(1);
+  m_discovery->RunDiscovery(&m_port1, false, NewDiscoveryCallback());
+
+  // A port doesn't run discovery twice at once
+  m_discovery->RunDiscovery(&m_port1, false, NewDiscoveryCallback());
+  OLA_ASSERT_EQ(1u, m_port1.incremental_runs);
+  OLA_ASSERT_EQ(1u, m_discovery->QueuedCount());
+
+  // These share the queued discovery, which is upgraded to full
+  m_discovery->RunDiscovery(&m_port1, true, NewDiscoveryCallback());
+  m_discovery->RunDiscovery(&m_port1, false, NewDiscoveryCallback());
+  OLA_ASSERT_EQ(1u, m_discovery->QueuedCount());
+
+  m_port1.Complete(UIDSet());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_results.size());
+  OLA_ASSERT_EQ(1u, m_port1.full_runs);
+  OLA_ASSERT_EQ(0u, m_discovery->QueuedCount());
+
+  UIDSet uids;
+  uids.AddUID(UID(0x7a70, 1));
+  m_port1.Complete(uids);
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_results.size());
+  OLA_ASSERT_EQ(uids, m_results[1]);
+  OLA_ASSERT_EQ(uids, m_results[3]);
+  OLA_ASSERT_EQ(1u, m_port1.incremental_runs);
+  OLA_ASSERT_EQ(1u, m_port1.full_runs);
+}
+
+
+/*
+ * Check that removing a port cancels the queued discovery.
+ */
+void DiscoverySchedulerTest::testRemovePort() {
+  m_discovery->SetMaxConcurrent(1);
+  m_discovery->RunDiscovery(&m_port1, true, NewDiscoveryCallback());
+  m_discovery->RunDiscovery(&m_port2, true, NewDiscoveryCallback());
+  m_discovery->RunDiscovery(&m_port3, true, NewDiscoveryCallback());
+
+  m_discovery->RemovePort(&m_port2);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_results.size());
+  OLA_ASSERT_EQ(0u, m_results[0].Size());
+  OLA_ASSERT_EQ(0u, m_port2.full_runs);
+
+  // Removing a running port frees up its slot
+  m_discovery->RemovePort(&m_port1);
+  OLA_ASSERT_TRUE(m_port3.Running());
+
+  // The callback still runs when the port completes
+  UIDSet uids;
+  uids.AddUID(UID(0x7a70, 1));
+  m_port1.Complete(uids);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_results.size());
+  OLA_ASSERT_EQ(uids, m_results[1]);
+  OLA_ASSERT_EQ(0u, PortVar(DiscoveryScheduler::K_DISCOVERY_FULL_VAR,
+                            m_port1));
+  OLA_ASSERT_EQ(1u, m_discovery->RunningCount());
+
+  m_port3.Complete(UIDSet());
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_results.size());
+}
+
+
+/*
+ * Check that the start of discovery is delayed by the jitter.
+ */
+void DiscoverySchedulerTest::testJitter() {
+  m_discovery->SetJitter(100);
+  // The random delay may be 0, so try until we get a timeout.
+  unsigned int attempts = 0;
+  while (!m_scheduler.TimeoutCount() && attempts++ < 100) {
+    m_discovery->RunDiscovery(&m_port1, false, NewDiscoveryCallback());
+    if (m_port1.Running()) {
+      m_port1.Complete(UIDSet());
+    }
+  }
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_TRUE(m_scheduler.Delay() <= TimeInterval(0, 100000));
+  OLA_ASSERT_FALSE(m_port1.Running());
+  OLA_ASSERT_EQ(1u, m_discovery->RunningCount());
+
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_TRUE(m_port1.Running());
+  m_port1.Complete(UIDSet());
+  OLA_ASSERT_EQ(0u, m_discovery->RunningCount());
+
+  // Removing the port while it's waiting runs the callback
+  m_results.clear();
+  while (!m_scheduler.TimeoutCount()) {
+    m_discovery->RunDiscovery(&m_port2, false, NewDiscoveryCallback());
+    if (m_port2.Running()) {
+      m_port2.Complete(UIDSet());
+      m_results.clear();
+    }
+  }
+  m_discovery->RemovePort(&m_port2);
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_results.size());
+  OLA_ASSERT_EQ(0u, m_discovery->RunningCount());
+}
+
+
+/*
+ * Check the per-port stats.
+ */
+void DiscoverySchedulerTest::testStats() {
+  m_discovery->SetMaxConcurrent(1);
+  m_discovery->RunDiscovery(&m_port1, true, NULL);
+  m_discovery->RunDiscovery(&m_port2, false, NULL);
+
+  m_clock.AdvanceTime(0, 250000);
+  UIDSet uids;
+  uids.AddUID(UID(0x7a70, 1));
+  uids.AddUID(UID(0x7a70, 2));
+  m_port1.Complete(uids);
+
+  OLA_ASSERT_EQ(250u, PortVar(DiscoveryScheduler::K_DISCOVERY_TIME_VAR,
+                              m_port1));
+  OLA_ASSERT_EQ(0u, PortVar(DiscoveryScheduler::K_DISCOVERY_QUEUE_TIME_VAR,
+                            m_port1));
+  OLA_ASSERT_EQ(2u, PortVar(DiscoveryScheduler::K_DISCOVERY_UIDS_VAR,
+                            m_port1));
+  OLA_ASSERT_EQ(1u, PortVar(DiscoveryScheduler::K_DISCOVERY_FULL_VAR,
+                            m_port1));
+
+  m_clock.AdvanceTime(0, 50000);
+  m_port2.Complete(UIDSet());
+  OLA_ASSERT_EQ(50u, PortVar(DiscoveryScheduler::K_DISCOVERY_TIME_VAR,
+                             m_port2));
+  OLA_ASSERT_EQ(250u, PortVar(DiscoveryScheduler::K_DISCOVERY_QUEUE_TIME_VAR,
+                              m_port2));
+  OLA_ASSERT_EQ(1u, PortVar(DiscoveryScheduler::K_DISCOVERY_INCREMENTAL_VAR,
+                            m_port2));
+  OLA_ASSERT_EQ(0u, PortVar(DiscoveryScheduler::K_DISCOVERY_FULL_VAR,
+                            m_port2));
+}
+
+
+/*
+ * Check that universes run discovery through the scheduler.
+ */
+void DiscoverySchedulerTest::testUniverseDiscovery() {
+  UniverseStore store(NULL, NULL);
+  store.SetDiscoveryScheduler(m_discovery);
+  m_discovery->SetMaxConcurrent(1);
+
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+  universe1->AddPort(&m_port1);
+  m_port1.SetUniverse(universe1);
+  universe2->AddPort(&m_port2);
+  m_port2.SetUniverse(universe2);
+
+  universe1->RunRDMDiscovery(NewDiscoveryCallback(), true);
+  universe2->RunRDMDiscovery(NewDiscoveryCallback(), true);
+  OLA_ASSERT_TRUE(m_port1.Running());
+  OLA_ASSERT_FALSE(m_port2.Running());
+
+  UIDSet uids;
+  uids.AddUID(UID(0x7a70, 1));
+  m_port1.Complete(uids);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_results.size());
+  OLA_ASSERT_EQ(uids, m_results[0]);
+  OLA_ASSERT_EQ(1u, universe1->UIDCount());
+  OLA_ASSERT_TRUE(m_port2.Running());
+
+  // Unpatching the port completes the universe's discovery
+  universe2->RunRDMDiscovery(NewDiscoveryCallback(), true);
+  universe1->RunRDMDiscovery(NewDiscoveryCallback(), true);
+  universe1->RemovePort(&m_port1);
+  m_port1.SetUniverse(NULL);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_results.size());
+  OLA_ASSERT_EQ(0u, m_results[1].Size());
+
+  m_port2.Complete(UIDSet());
+  m_port2.Complete(UIDSet());
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_results.size());
+  universe2->RemovePort(&m_port2);
+  m_port2.SetUniverse(NULL);
+  store.DeleteAll();
+}
@@ -18,9 +18,53 @@
  * Copyright (C) 2005 Simon Newton
  */
 
-#include <olad/DmxSource.h>
+#include <algorithm>
+#include "olad/DmxSource.h"
 
 namespace ola {
 
 const TimeInterval DmxSource::TIMEOUT_INTERVAL(2500000);  // 2.5s
+
+void DmxSource::UpdateData(const DmxBuffer &buffer,
+                           const TimeStamp &timestamp,
+                           uint8_t priority,
+                           const DmxBuffer &slot_priorities) {
+  const unsigned int old_size = m_buffer.Size();
+  const unsigned int new_size = buffer.Size();
+
+  m_size_changed = old_size != new_size;
+  if (m_size_changed) {
+    m_changed_start = 0;
+    m_changed_end = std::max(old_size, new_size);
+  } else if (m_buffer.GetRaw() == buffer.GetRaw()) {
+    // Same underlying data, nothing changed.
+    m_changed_start = 0;
+    m_changed_end = 0;
+  } else {
+    const uint8_t *old_data = m_buffer.GetRaw();
+    const uint8_t *new_data = buffer.GetRaw();
+    unsigned int start = 0;
+    while (start < new_size && old_data[start] == new_data[start]) {
+      start++;
+    }
+    unsigned int end = new_size;
+    while (end > start && old_data[end - 1] == new_data[end - 1]) {
+      end--;
+    }
+    m_changed_start = start;
+    m_changed_end = end;
+  }
+
+  // A change in the slot priorities can change how every slot is merged.
+  if ((m_slot_priorities.Size() || slot_priorities.Size()) &&
+      m_slot_priorities != slot_priorities) {
+    m_changed_start = 0;
+    m_changed_end = std::max(old_size, new_size);
+  }
+
+  m_buffer = buffer;
+  m_slot_priorities = slot_priorities;
+  m_timestamp = timestamp;
+  m_priority = priority;
+}
 }  // namespace ola
@@ -33,11 +33,13 @@ class DmxSourceTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DmxSourceTest);
   CPPUNIT_TEST(testDmxSource);
   CPPUNIT_TEST(testIsActive);
+  CPPUNIT_TEST(testChangedRange);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testDmxSource();
     void testIsActive();
+    void testChangedRange();
 
  private:
     ola::Clock m_clock;
@@ -101,3 +103,35 @@ void DmxSourceTest::testIsActive() {
   later = timestamp + TimeInterval(2500000);
   OLA_ASSERT_FALSE(source.IsActive(later));
 }
+
+
+/*
+ * Test that we track which slots changed
+ */
+void DmxSourceTest::testChangedRange() {
+  DmxBuffer buffer("123456789");
+  TimeStamp timestamp;
+  m_clock.CurrentTime(&timestamp);
+
+  DmxSource source(buffer, timestamp, 100);
+  OLA_ASSERT_TRUE(source.SizeChanged());
+  OLA_ASSERT_EQ(0u, source.ChangedStart());
+  OLA_ASSERT_EQ(9u, source.ChangedEnd());
+
+  DmxBuffer buffer2("123xy6789");
+  source.UpdateData(buffer2, timestamp, 100);
+  OLA_ASSERT_FALSE(source.SizeChanged());
+  OLA_ASSERT_EQ(3u, source.ChangedStart());
+  OLA_ASSERT_EQ(5u, source.ChangedEnd());
+
+  // no change
+  source.UpdateData(buffer2, timestamp, 100);
+  OLA_ASSERT_FALSE(source.SizeChanged());
+  OLA_ASSERT_EQ(source.ChangedStart(), source.ChangedEnd());
+
+  DmxBuffer buffer3("123xy6789ab");
+  source.UpdateData(buffer3, timestamp, 100);
+  OLA_ASSERT_TRUE(source.SizeChanged());
+  OLA_ASSERT_EQ(0u, source.ChangedStart());
+  OLA_ASSERT_EQ(11u, source.ChangedEnd());
+}
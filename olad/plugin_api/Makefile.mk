@@ -17,7 +17,13 @@ olad_plugin_api_libolaserverplugininterface_la_SOURCES = \
     olad/plugin_api/Device.cpp \
     olad/plugin_api/DeviceManager.cpp \
     olad/plugin_api/DeviceManager.h \
+    olad/plugin_api/DiscoveryScheduler.cpp \
+    olad/plugin_api/DiscoveryScheduler.h \
     olad/plugin_api/DmxSource.cpp \
+    olad/plugin_api/OutputRateLimiter.cpp \
+    olad/plugin_api/OutputRateLimiter.h \
+    olad/plugin_api/OutputScheduler.cpp \
+    olad/plugin_api/OutputScheduler.h \
     olad/plugin_api/Plugin.cpp \
     olad/plugin_api/PluginAdaptor.cpp \
     olad/plugin_api/Port.cpp \
@@ -25,7 +31,16 @@ olad_plugin_api_libolaserverplugininterface_la_SOURCES = \
     olad/plugin_api/PortManager.cpp \
     olad/plugin_api/PortManager.h \
     olad/plugin_api/Preferences.cpp \
+    olad/plugin_api/RDMResponseCache.cpp \
+    olad/plugin_api/RDMResponseCache.h \
+    olad/plugin_api/SlotSubscriptions.cpp \
+    olad/plugin_api/SlotSubscriptions.h \
+    olad/plugin_api/TimeCodeScheduler.cpp \
+    olad/plugin_api/TimeCodeScheduler.h \
+    olad/plugin_api/UDPReceivePreferences.cpp \
     olad/plugin_api/Universe.cpp \
+    olad/plugin_api/UniversePublisher.cpp \
+    olad/plugin_api/UniversePublisher.h \
     olad/plugin_api/UniverseStore.cpp \
     olad/plugin_api/UniverseStore.h
 olad_plugin_api_libolaserverplugininterface_la_CXXFLAGS = \
@@ -73,6 +88,26 @@ olad_plugin_api_PreferencesTester_SOURCES = olad/plugin_api/PreferencesTest.cpp
 olad_plugin_api_PreferencesTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_PreferencesTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
 
-olad_plugin_api_UniverseTester_SOURCES = olad/plugin_api/UniverseTest.cpp
+olad_plugin_api_UniverseTester_SOURCES = \
+    olad/plugin_api/DiscoverySchedulerTest.cpp \
+    olad/plugin_api/OutputRateLimiterTest.cpp \
+    olad/plugin_api/OutputSchedulerTest.cpp \
+    olad/plugin_api/RDMResponseCacheTest.cpp \
+    olad/plugin_api/SlotSubscriptionsTest.cpp \
+    olad/plugin_api/TimeCodeSchedulerTest.cpp \
+    olad/plugin_api/UniversePublisherTest.cpp \
+    olad/plugin_api/UniverseTest.cpp
 olad_plugin_api_UniverseTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_UniverseTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
+
+# BENCHMARKS
+##################################################
+bench_programs += olad/plugin_api/UniverseBenchmark
+
+olad_plugin_api_UniverseBenchmark_SOURCES = \
+    olad/plugin_api/UniverseBenchmark.cpp
+olad_plugin_api_UniverseBenchmark_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
+olad_plugin_api_UniverseBenchmark_LDADD = \
+    $(COMMON_BENCHMARK_LIBS) \
+    $(libprotobuf_LIBS) \
+    olad/plugin_api/libolaserverplugininterface.la
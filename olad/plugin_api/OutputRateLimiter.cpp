@@ -0,0 +1,195 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputRateLimiter.cpp
+ * Limits the rate DMX data is written to output ports.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/OutputRateLimiter.h"
+
+#include <algorithm>
+
+#include "ola/Callback.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+
+using ola::thread::INVALID_TIMEOUT;
+
+const char OutputRateLimiter::K_RATE_DEFERRED_VAR[] = "output-rate-deferred";
+const char OutputRateLimiter::K_RATE_DROPPED_VAR[] = "output-rate-dropped";
+
+
+OutputRateLimiter::OutputRateLimiter(
+    ola::thread::SchedulerInterface *scheduler,
+    ExportMap *export_map,
+    Clock *clock)
+    : m_scheduler(scheduler),
+      m_export_map(export_map),
+      m_clock(clock),
+      m_free_clock(false) {
+  if (!m_clock) {
+    m_clock = new Clock();
+    m_free_clock = true;
+  }
+
+  if (m_export_map) {
+    m_export_map->GetUIntMapVar(K_RATE_DEFERRED_VAR, "port");
+    m_export_map->GetUIntMapVar(K_RATE_DROPPED_VAR, "port");
+  }
+}
+
+
+OutputRateLimiter::~OutputRateLimiter() {
+  PortStateMap::iterator iter = m_ports.begin();
+  for (; iter != m_ports.end(); ++iter) {
+    DeleteState(iter->second);
+  }
+  m_ports.clear();
+
+  if (m_free_clock) {
+    delete m_clock;
+  }
+}
+
+
+bool OutputRateLimiter::WriteDMX(OutputPort *port,
+                                 const DmxBuffer &buffer,
+                                 uint8_t priority) {
+  const unsigned int max_rate = port->MaxRate();
+  if (!max_rate) {
+    RemovePort(port);
+    port->WriteDMX(buffer, priority);
+    return true;
+  }
+  const unsigned int max_burst = std::max(1u, port->MaxBurst());
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  PortStateMap::iterator iter = STLLookupOrInsertNull(&m_ports, port);
+  PortState *state = iter->second;
+  if (state &&
+      (state->max_rate != max_rate || state->max_burst != max_burst)) {
+    // The limit changed, start again with a full bucket.
+    DeleteState(state);
+    state = NULL;
+  }
+  if (!state) {
+    state = new PortState(max_rate, max_burst, now);
+    iter->second = state;
+  }
+
+  if (state->pending) {
+    // The held frame hasn't been sent, the latest data wins.
+    state->buffer.Set(buffer);
+    state->priority = priority;
+    IncrementVar(K_RATE_DROPPED_VAR, port);
+    return false;
+  }
+
+  if (state->bucket.GetToken(now)) {
+    port->WriteDMX(buffer, priority);
+    return true;
+  }
+
+  state->buffer.Set(buffer);
+  state->priority = priority;
+  state->pending = true;
+  IncrementVar(K_RATE_DEFERRED_VAR, port);
+  ArmTimeout(port, state);
+  return false;
+}
+
+
+void OutputRateLimiter::RemovePort(OutputPort *port) {
+  PortStateMap::iterator iter = m_ports.find(port);
+  if (iter != m_ports.end()) {
+    DeleteState(iter->second);
+    m_ports.erase(iter);
+  }
+}
+
+
+unsigned int OutputRateLimiter::PendingCount() const {
+  unsigned int count = 0;
+  PortStateMap::const_iterator iter = m_ports.begin();
+  for (; iter != m_ports.end(); ++iter) {
+    if (iter->second && iter->second->pending) {
+      count++;
+    }
+  }
+  return count;
+}
+
+
+/*
+ * Called when the timeout fires, write the held frame if there's a token,
+ * otherwise wait a bit longer.
+ */
+void OutputRateLimiter::WritePending(OutputPort *port) {
+  PortState *state = STLFindOrNull(m_ports, port);
+  if (!state) {
+    return;
+  }
+  state->timeout = INVALID_TIMEOUT;
+
+  if (!port->MaxRate()) {
+    // The limit was removed, so newer data has already been written.
+    RemovePort(port);
+    return;
+  }
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  if (state->bucket.GetToken(now)) {
+    state->pending = false;
+    port->WriteDMX(state->buffer, state->priority);
+  } else {
+    ArmTimeout(port, state);
+  }
+}
+
+
+/*
+ * A new token is added every 1 / max_rate seconds, round up so the bucket is
+ * sure to have one when the timeout fires.
+ */
+void OutputRateLimiter::ArmTimeout(OutputPort *port, PortState *state) {
+  const TimeInterval delay(static_cast<int64_t>(
+      (USEC_IN_SECONDS + state->max_rate - 1) / state->max_rate));
+  state->timeout = m_scheduler->RegisterSingleTimeout(
+      delay,
+      NewSingleCallback(this, &OutputRateLimiter::WritePending, port));
+}
+
+
+void OutputRateLimiter::DeleteState(PortState *state) {
+  if (state && state->timeout != INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(state->timeout);
+  }
+  delete state;
+}
+
+
+void OutputRateLimiter::IncrementVar(const char *var_name,
+                                     const OutputPort *port) {
+  if (m_export_map) {
+    UIntMap *var = m_export_map->GetUIntMapVar(var_name);
+    (*var)[port->UniqueId()]++;
+  }
+}
+}  // namespace ola
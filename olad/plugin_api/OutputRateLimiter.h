@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputRateLimiter.h
+ * Limits the rate DMX data is written to output ports.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_OUTPUTRATELIMITER_H_
+#define OLAD_PLUGIN_API_OUTPUTRATELIMITER_H_
+
+#include <stdint.h>
+#include <map>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "olad/Port.h"
+#include "olad/TokenBucket.h"
+
+namespace ola {
+
+/**
+ * @brief Applies the rate limits set with OutputPort::SetRateLimit().
+ *
+ * Each limited port has a TokenBucket that fills at the port's maximum rate
+ * and holds up to the burst size. A frame is written straight away if there
+ * is a token. Otherwise the frame is held, and written by a timeout once
+ * the next token is due. If more frames arrive while one is held, the
+ * latest replaces it, so the receiver always ends up with the final frame.
+ *
+ * The number of deferred frames, and the number of held frames that were
+ * replaced before they were sent, are exported to the ExportMap keyed by
+ * port.
+ */
+class OutputRateLimiter {
+ public:
+  /**
+   * @brief Create a new OutputRateLimiter.
+   * @param scheduler the SchedulerInterface used to write deferred frames.
+   * @param export_map the ExportMap to update, may be NULL.
+   * @param clock the Clock to use, if NULL a Clock is created.
+   */
+  OutputRateLimiter(ola::thread::SchedulerInterface *scheduler,
+                    ExportMap *export_map,
+                    Clock *clock = NULL);
+  ~OutputRateLimiter();
+
+  /**
+   * @brief Write data to a port, subject to the port's rate limit.
+   * @param port the port to write to.
+   * @param buffer the data to write.
+   * @param priority the priority of the data.
+   * @returns true if the data was written now, false if it was held.
+   */
+  bool WriteDMX(OutputPort *port, const DmxBuffer &buffer, uint8_t priority);
+
+  /**
+   * @brief Forget about a port, any held frame is discarded.
+   */
+  void RemovePort(OutputPort *port);
+
+  /**
+   * @brief Return the number of ports with a held frame.
+   */
+  unsigned int PendingCount() const;
+
+  static const char K_RATE_DEFERRED_VAR[];
+  static const char K_RATE_DROPPED_VAR[];
+
+ private:
+  struct PortState {
+    PortState(unsigned int max_rate, unsigned int max_burst,
+              const TimeStamp &now)
+        : bucket(max_burst, max_rate, max_burst, now),
+          max_rate(max_rate),
+          max_burst(max_burst),
+          priority(0),
+          pending(false),
+          timeout(ola::thread::INVALID_TIMEOUT) {
+    }
+
+    TokenBucket bucket;
+    const unsigned int max_rate;
+    const unsigned int max_burst;
+    DmxBuffer buffer;
+    uint8_t priority;
+    bool pending;
+    ola::thread::timeout_id timeout;
+  };
+
+  typedef std::map<OutputPort*, PortState*> PortStateMap;
+
+  ola::thread::SchedulerInterface *m_scheduler;
+  ExportMap *m_export_map;
+  Clock *m_clock;
+  bool m_free_clock;
+  PortStateMap m_ports;
+
+  void WritePending(OutputPort *port);
+  void ArmTimeout(OutputPort *port, PortState *state);
+  void DeleteState(PortState *state);
+  void IncrementVar(const char *var_name, const OutputPort *port);
+
+  DISALLOW_COPY_AND_ASSIGN(OutputRateLimiter);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_OUTPUTRATELIMITER_H_
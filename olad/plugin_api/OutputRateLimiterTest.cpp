@@ -0,0 +1,220 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputRateLimiterTest.cpp
+ * Test fixture for the OutputRateLimiter class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "olad/plugin_api/OutputRateLimiter.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::MockClock;
+using ola::OutputRateLimiter;
+using ola::TimeInterval;
+using std::string;
+
+/**
+ * An output port that counts the writes.
+ */
+class CountingOutputPort: public TestMockOutputPort {
+ public:
+  CountingOutputPort(ola::AbstractDevice *parent, unsigned int port_id)
+      : TestMockOutputPort(parent, port_id),
+        writes(0) {
+  }
+
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
+    writes++;
+    return TestMockOutputPort::WriteDMX(buffer, priority);
+  }
+
+  unsigned int writes;
+};
+
+
+class OutputRateLimiterTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(OutputRateLimiterTest);
+  CPPUNIT_TEST(testUnlimited);
+  CPPUNIT_TEST(testBurst);
+  CPPUNIT_TEST(testLatestWins);
+  CPPUNIT_TEST(testLimitRemoved);
+  CPPUNIT_TEST(testRemovePort);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  OutputRateLimiterTest()
+      : m_plugin(NULL, ola::OLA_PLUGIN_ARTNET),
+        m_device(&m_plugin, "test device"),
+        m_port(&m_device, 1) {
+  }
+
+  void setUp();
+  void tearDown();
+
+  void testUnlimited();
+  void testBurst();
+  void testLatestWins();
+  void testLimitRemoved();
+  void testRemovePort();
+
+ private:
+  MockScheduler m_scheduler;
+  MockClock m_clock;
+  ExportMap m_export_map;
+  TestMockPlugin m_plugin;
+  MockDevice m_device;
+  CountingOutputPort m_port;
+  OutputRateLimiter *m_limiter;
+
+  unsigned int PortVar(const char *var) {
+    return (*m_export_map.GetUIntMapVar(var))[m_port.UniqueId()];
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OutputRateLimiterTest);
+
+
+void OutputRateLimiterTest::setUp() {
+  m_port.SetRateLimit(0, 0);
+  m_port.writes = 0;
+  m_limiter = new OutputRateLimiter(&m_scheduler, &m_export_map, &m_clock);
+}
+
+
+void OutputRateLimiterTest::tearDown() {
+  delete m_limiter;
+}
+
+
+/*
+ * Ports without a limit are always written to.
+ */
+void OutputRateLimiterTest::testUnlimited() {
+  DmxBuffer buffer("abc");
+  for (unsigned int i = 0; i < 100; i++) {
+    OLA_ASSERT_TRUE(m_limiter->WriteDMX(&m_port, buffer, 100));
+  }
+  OLA_ASSERT_EQ(100u, m_port.writes);
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(0u, PortVar(OutputRateLimiter::K_RATE_DEFERRED_VAR));
+}
+
+
+/*
+ * Check a burst is allowed, and the next frame is held until a token is
+ * available.
+ */
+void OutputRateLimiterTest::testBurst() {
+  m_port.SetRateLimit(10, 3);
+  DmxBuffer buffer("abc");
+
+  OLA_ASSERT_TRUE(m_limiter->WriteDMX(&m_port, buffer, 100));
+  OLA_ASSERT_TRUE(m_limiter->WriteDMX(&m_port, buffer, 100));
+  OLA_ASSERT_TRUE(m_limiter->WriteDMX(&m_port, buffer, 100));
+  OLA_ASSERT_EQ(3u, m_port.writes);
+
+  DmxBuffer held("def");
+  OLA_ASSERT_FALSE(m_limiter->WriteDMX(&m_port, held, 100));
+  OLA_ASSERT_EQ(3u, m_port.writes);
+  OLA_ASSERT_EQ(1u, m_limiter->PendingCount());
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(TimeInterval(0, 100000), m_scheduler.Delay());
+  OLA_ASSERT_EQ(1u, PortVar(OutputRateLimiter::K_RATE_DEFERRED_VAR));
+
+  // Firing early re-arms the timeout
+  m_clock.AdvanceTime(0, 50000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(3u, m_port.writes);
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+
+  m_clock.AdvanceTime(0, 50000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(4u, m_port.writes);
+  OLA_ASSERT_EQ(held, m_port.ReadDMX());
+  OLA_ASSERT_EQ(0u, m_limiter->PendingCount());
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+}
+
+
+/*
+ * Frames that arrive while one is held replace it.
+ */
+void OutputRateLimiterTest::testLatestWins() {
+  m_port.SetRateLimit(10, 1);
+  OLA_ASSERT_TRUE(m_limiter->WriteDMX(&m_port, DmxBuffer("a"), 100));
+  OLA_ASSERT_FALSE(m_limiter->WriteDMX(&m_port, DmxBuffer("b"), 100));
+  OLA_ASSERT_FALSE(m_limiter->WriteDMX(&m_port, DmxBuffer("c"), 100));
+  OLA_ASSERT_FALSE(m_limiter->WriteDMX(&m_port, DmxBuffer("d"), 100));
+  OLA_ASSERT_EQ(1u, m_port.writes);
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(1u, PortVar(OutputRateLimiter::K_RATE_DEFERRED_VAR));
+  OLA_ASSERT_EQ(2u, PortVar(OutputRateLimiter::K_RATE_DROPPED_VAR));
+
+  m_clock.AdvanceTime(0, 100000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(2u, m_port.writes);
+  OLA_ASSERT_EQ(DmxBuffer("d"), m_port.ReadDMX());
+}
+
+
+/*
+ * A held frame isn't written once the limit is removed.
+ */
+void OutputRateLimiterTest::testLimitRemoved() {
+  m_port.SetRateLimit(10, 1);
+  OLA_ASSERT_TRUE(m_limiter->WriteDMX(&m_port, DmxBuffer("a"), 100));
+  OLA_ASSERT_FALSE(m_limiter->WriteDMX(&m_port, DmxBuffer("b"), 100));
+
+  m_port.SetRateLimit(0, 0);
+  m_clock.AdvanceTime(0, 100000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(1u, m_port.writes);
+  OLA_ASSERT_EQ(0u, m_limiter->PendingCount());
+
+  // Changing the limit starts with a full bucket.
+  m_port.SetRateLimit(10, 1);
+  OLA_ASSERT_TRUE(m_limiter->WriteDMX(&m_port, DmxBuffer("c"), 100));
+  OLA_ASSERT_FALSE(m_limiter->WriteDMX(&m_port, DmxBuffer("d"), 100));
+  m_port.SetRateLimit(20, 1);
+  OLA_ASSERT_TRUE(m_limiter->WriteDMX(&m_port, DmxBuffer("e"), 100));
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(DmxBuffer("e"), m_port.ReadDMX());
+}
+
+
+/*
+ * Removing a port discards the held frame and the timeout.
+ */
+void OutputRateLimiterTest::testRemovePort() {
+  m_port.SetRateLimit(10, 1);
+  OLA_ASSERT_TRUE(m_limiter->WriteDMX(&m_port, DmxBuffer("a"), 100));
+  OLA_ASSERT_FALSE(m_limiter->WriteDMX(&m_port, DmxBuffer("b"), 100));
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+
+  m_limiter->RemovePort(&m_port);
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(0u, m_limiter->PendingCount());
+  OLA_ASSERT_EQ(1u, m_port.writes);
+}
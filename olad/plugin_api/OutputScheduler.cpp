@@ -0,0 +1,396 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputScheduler.cpp
+ * Coalesces the output of universes so each one is sent at most once per
+ * interval.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/OutputScheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/dmx/HTPMerge.h"
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/Port.h"
+#include "olad/Universe.h"
+
+namespace ola {
+
+using ola::thread::INVALID_TIMEOUT;
+using ola::thread::MutexLocker;
+using ola::thread::WorkStealingPool;
+using std::vector;
+
+const TimeInterval OutputScheduler::DEFAULT_FADE_INTERVAL(0, 25000);
+
+OutputScheduler::OutputScheduler(ola::thread::SchedulerInterface *scheduler,
+                                 Clock *clock)
+    : m_scheduler(scheduler),
+      m_clock(clock),
+      m_free_clock(false),
+      m_timeout(INVALID_TIMEOUT),
+      m_running_fades(false),
+      m_merges_outstanding(0) {
+  if (!m_clock) {
+    m_clock = new Clock();
+    m_free_clock = true;
+  }
+  m_clock->CurrentTime(&m_epoch);
+}
+
+
+OutputScheduler::~OutputScheduler() {
+  if (m_timeout != INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_timeout);
+  }
+  if (m_merge_pool.get()) {
+    m_merge_pool->JoinAll();
+  }
+  STLDeleteElements(&m_merge_tasks);
+  if (m_free_clock) {
+    delete m_clock;
+  }
+}
+
+
+void OutputScheduler::SetFrameInterval(const TimeInterval &interval) {
+  m_frame_interval = interval;
+  m_clock->CurrentTime(&m_epoch);
+}
+
+
+bool OutputScheduler::StartMergeThreads(unsigned int thread_count) {
+  if (m_merge_pool.get() || !thread_count) {
+    return false;
+  }
+
+  // The merge kernel is picked the first time it's used, do that now so the
+  // merge threads don't race to do it.
+  ola::dmx::DefaultHTPMergeImplementation();
+
+  std::auto_ptr<WorkStealingPool> pool(new WorkStealingPool(thread_count));
+  if (!pool->Init()) {
+    OLA_WARN << "Failed to start " << thread_count << " merge threads";
+    return false;
+  }
+  m_merge_pool.reset(pool.release());
+
+  // The calling thread runs the last shard.
+  for (unsigned int i = 0; i < thread_count; i++) {
+    m_merge_tasks.push_back(
+        NewCallback(this, &OutputScheduler::MergeShard, i));
+  }
+  return true;
+}
+
+
+OutputScheduler::OutputAction OutputScheduler::ScheduleOutput(
+    Universe *universe,
+    const TimeInterval &min_interval) {
+  UniverseState &state = m_universes[universe];
+  if (state.pending) {
+    return OUTPUT_COALESCED;
+  }
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  TimeStamp due = now;
+  if (state.last_output.IsSet() && !min_interval.IsZero()) {
+    due = std::max(due, state.last_output + min_interval);
+  }
+
+  if (FrameAligned()) {
+    // Changes made by a fade step are sent on the tick the step ran on.
+    due = (m_running_fades && due <= now) ? m_fade_step_time : NextTick(due);
+  } else if (due <= now) {
+    state.last_output = now;
+    return OUTPUT_NOW;
+  }
+
+  state.pending = true;
+  state.due = due;
+  if (!m_running_fades) {
+    // Otherwise FlushDueUniverses() will arm the timeout.
+    ArmTimeout(due, now);
+  }
+  return OUTPUT_DEFERRED;
+}
+
+
+void OutputScheduler::ScheduleFade(Universe *universe) {
+  if (!m_fading.insert(universe).second) {
+    return;
+  }
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  if (m_fading.size() == 1) {
+    m_next_fade = NextFade(now);
+  }
+  if (!m_running_fades) {
+    ArmTimeout(m_next_fade, now);
+  }
+}
+
+
+void OutputScheduler::RemoveUniverse(Universe *universe) {
+  m_universes.erase(universe);
+  m_fading.erase(universe);
+  // This may be called while we're flushing or running the fades.
+  std::replace(m_flush_list.begin(), m_flush_list.end(), universe,
+               static_cast<Universe*>(NULL));
+  std::replace(m_fade_list.begin(), m_fade_list.end(), universe,
+               static_cast<Universe*>(NULL));
+}
+
+
+unsigned int OutputScheduler::PendingCount() const {
+  unsigned int count = 0;
+  UniverseStateMap::const_iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    if (iter->second.pending) {
+      count++;
+    }
+  }
+  return count;
+}
+
+
+/*
+ * Make sure the timeout runs no later than due.
+ */
+void OutputScheduler::ArmTimeout(const TimeStamp &due, const TimeStamp &now) {
+  if (m_timeout != INVALID_TIMEOUT) {
+    if (m_timeout_due <= due) {
+      return;
+    }
+    m_scheduler->RemoveTimeout(m_timeout);
+  }
+
+  TimeInterval delay;
+  if (due > now) {
+    delay = due - now;
+  }
+  m_timeout_due = due;
+  m_timeout = m_scheduler->RegisterSingleTimeout(
+      delay,
+      NewSingleCallback(this, &OutputScheduler::FlushDueUniverses));
+}
+
+
+/*
+ * Called when the timeout fires, this writes the output for all universes
+ * which are due.
+ */
+void OutputScheduler::FlushDueUniverses() {
+  m_timeout = INVALID_TIMEOUT;
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  if (!m_fading.empty() && m_next_fade <= now) {
+    RunFades(now);
+  }
+
+  m_flush_list.clear();
+  TimeStamp next_due;
+  if (!m_fading.empty()) {
+    next_due = m_next_fade;
+  }
+
+  UniverseStateMap::iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    UniverseState &state = iter->second;
+    if (!state.pending) {
+      continue;
+    }
+    if (state.due <= now) {
+      state.pending = false;
+      state.last_output = now;
+      m_flush_list.push_back(iter->first);
+    } else if (!next_due.IsSet() || state.due < next_due) {
+      next_due = state.due;
+    }
+  }
+
+  RunMerges();
+
+  // With the frame clock, everything due on this tick is sent as one batch.
+  const bool batch = FrameAligned() && !m_flush_list.empty();
+  if (batch) {
+    BeginBatch();
+  }
+
+  // Writing the output can cause other universes to change, so we don't
+  // touch the map while we do this.
+  vector<Universe*>::iterator flush_iter = m_flush_list.begin();
+  for (; flush_iter != m_flush_list.end(); ++flush_iter) {
+    if (*flush_iter) {
+      (*flush_iter)->FlushOutput();
+    }
+  }
+  m_flush_list.clear();
+
+  if (batch) {
+    EndBatch();
+  }
+
+  if (next_due.IsSet()) {
+    ArmTimeout(next_due, now);
+  }
+}
+
+
+/*
+ * Run one step of each fade in progress.
+ */
+void OutputScheduler::RunFades(const TimeStamp &now) {
+  m_running_fades = true;
+  m_fade_step_time = now;
+  m_fade_list.assign(m_fading.begin(), m_fading.end());
+  vector<Universe*>::iterator iter = m_fade_list.begin();
+  for (; iter != m_fade_list.end(); ++iter) {
+    if (*iter && !(*iter)->RunFades(now)) {
+      m_fading.erase(*iter);
+    }
+  }
+  m_fade_list.clear();
+  m_running_fades = false;
+  m_next_fade = NextFade(now);
+}
+
+
+/*
+ * Return the time of the next fade step.
+ */
+TimeStamp OutputScheduler::NextFade(const TimeStamp &now) const {
+  if (FrameAligned()) {
+    return NextTick(now + TimeInterval(0, 1));
+  }
+  return now + DEFAULT_FADE_INTERVAL;
+}
+
+
+/*
+ * Run the pending merges for the universes in the flush list. Universes that
+ * didn't change are removed from the list.
+ */
+void OutputScheduler::RunMerges() {
+  m_merge_results.assign(m_flush_list.size(), 0);
+
+  const unsigned int shards = m_merge_tasks.size();
+  if (m_flush_list.size() > 1 && shards) {
+    {
+      MutexLocker locker(&m_merge_mutex);
+      m_merges_outstanding = shards;
+    }
+    vector<BaseCallback0<void>*>::iterator iter = m_merge_tasks.begin();
+    for (; iter != m_merge_tasks.end(); ++iter) {
+      m_merge_pool->Execute(*iter, WorkStealingPool::PRIORITY_HIGH);
+    }
+    MergeShard(shards);
+
+    MutexLocker locker(&m_merge_mutex);
+    while (m_merges_outstanding) {
+      m_merge_done.Wait(&m_merge_mutex);
+    }
+  } else {
+    for (unsigned int i = 0; i < m_flush_list.size(); i++) {
+      if (m_flush_list[i]) {
+        m_merge_results[i] = m_flush_list[i]->RunPendingMerge();
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < m_flush_list.size(); i++) {
+    if (!m_merge_results[i]) {
+      m_flush_list[i] = NULL;
+    }
+  }
+}
+
+
+/*
+ * Merge every n-th universe in the flush list, starting at shard, where n is
+ * the number of threads plus one.
+ */
+void OutputScheduler::MergeShard(unsigned int shard) {
+  const unsigned int stride = m_merge_tasks.size() + 1;
+  for (unsigned int i = shard; i < m_flush_list.size(); i += stride) {
+    if (m_flush_list[i]) {
+      m_merge_results[i] = m_flush_list[i]->RunPendingMerge();
+    }
+  }
+
+  if (shard < m_merge_tasks.size()) {
+    MutexLocker locker(&m_merge_mutex);
+    if (--m_merges_outstanding == 0) {
+      m_merge_done.Signal();
+    }
+  }
+}
+
+
+/*
+ * Tell the output ports of all the universes in the flush list that a batch
+ * is starting. A port is only told once, even if it's in more than one
+ * universe.
+ */
+void OutputScheduler::BeginBatch() {
+  m_batch_ports.clear();
+  vector<Universe*>::iterator iter = m_flush_list.begin();
+  for (; iter != m_flush_list.end(); ++iter) {
+    (*iter)->OutputPorts(&m_universe_ports);
+    m_batch_ports.insert(m_batch_ports.end(), m_universe_ports.begin(),
+                         m_universe_ports.end());
+  }
+  std::sort(m_batch_ports.begin(), m_batch_ports.end());
+  m_batch_ports.erase(std::unique(m_batch_ports.begin(), m_batch_ports.end()),
+                      m_batch_ports.end());
+
+  vector<OutputPort*>::iterator port_iter = m_batch_ports.begin();
+  for (; port_iter != m_batch_ports.end(); ++port_iter) {
+    (*port_iter)->BeginBatch();
+  }
+}
+
+
+void OutputScheduler::EndBatch() {
+  vector<OutputPort*>::iterator port_iter = m_batch_ports.begin();
+  for (; port_iter != m_batch_ports.end(); ++port_iter) {
+    (*port_iter)->EndBatch();
+  }
+  m_batch_ports.clear();
+}
+
+
+/*
+ * Return the first tick of the frame clock at or after time.
+ */
+TimeStamp OutputScheduler::NextTick(const TimeStamp &time) const {
+  if (time <= m_epoch) {
+    return m_epoch;
+  }
+  int64_t period = m_frame_interval.AsInt();
+  int64_t elapsed = (time - m_epoch).AsInt();
+  int64_t ticks = (elapsed + period - 1) / period;
+  return m_epoch + TimeInterval(ticks * period);
+}
+}  // namespace ola
@@ -0,0 +1,214 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputScheduler.h
+ * Coalesces the output of universes so each one is sent at most once per
+ * interval.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_OUTPUTSCHEDULER_H_
+#define OLAD_PLUGIN_API_OUTPUTSCHEDULER_H_
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "ola/thread/WorkStealingPool.h"
+
+namespace ola {
+
+class OutputPort;
+class Universe;
+
+/**
+ * @brief Limits how often universes write to their output ports & clients.
+ *
+ * When the data in a universe changes, the universe asks the scheduler if it
+ * can write the new data straight away. If the universe has written within its
+ * minimum output interval, or the scheduler is aligned to a frame clock, the
+ * write is deferred and Universe::FlushOutput() is called once the universe is
+ * due. Further changes before then are coalesced into that single write.
+ *
+ * With the frame clock, all universes that are due on a tick are written in a
+ * single batch, which is wrapped in OutputPort::BeginBatch() and
+ * OutputPort::EndBatch() calls. The merges for these universes can also be
+ * spread across a pool of threads, see StartMergeThreads().
+ *
+ * The scheduler also drives the fades started with
+ * Universe::FadeSourceClient(). With the frame clock, each fade step is run
+ * at the start of a tick, so the new data is sent on the same tick. Otherwise
+ * the fades are stepped every DEFAULT_FADE_INTERVAL.
+ */
+class OutputScheduler {
+ public:
+  /**
+   * @brief The result of a call to ScheduleOutput().
+   */
+  enum OutputAction {
+    OUTPUT_NOW,  /**< Write the data now */
+    OUTPUT_DEFERRED,  /**< A write has been scheduled */
+    OUTPUT_COALESCED  /**< A write was already scheduled */
+  };
+
+  /**
+   * @brief Create a new OutputScheduler.
+   * @param scheduler the SchedulerInterface used to run the deferred writes.
+   * @param clock the Clock to use, if NULL a Clock is created.
+   */
+  explicit OutputScheduler(ola::thread::SchedulerInterface *scheduler,
+                           Clock *clock = NULL);
+
+  /**
+   * @brief Destructor.
+   */
+  ~OutputScheduler();
+
+  /**
+   * @brief Align all universe output to a frame clock.
+   * @param interval the period of the frame clock. A zero interval disables
+   *   the frame clock, which is the default.
+   *
+   * While the frame clock is running, every write is deferred to the next
+   * tick, so all universes are sent together.
+   */
+  void SetFrameInterval(const TimeInterval &interval);
+
+  /**
+   * @brief Return the period of the frame clock, zero if it isn't running.
+   */
+  const TimeInterval &FrameInterval() const { return m_frame_interval; }
+
+  /**
+   * @brief Check if universe output is aligned to the frame clock.
+   */
+  bool FrameAligned() const { return !m_frame_interval.IsZero(); }
+
+  /**
+   * @brief Merge universes on a pool of threads.
+   * @param thread_count the number of threads to start.
+   * @returns true if the threads were started.
+   *
+   * This only has an effect while the frame clock is running. Universes then
+   * defer merging their sources until the next tick, and the merges for all
+   * universes due on that tick are shared between the pool and the calling
+   * thread. Writing to the output ports & sink clients always happens on the
+   * calling thread.
+   */
+  bool StartMergeThreads(unsigned int thread_count);
+
+  /**
+   * @brief Check if universes should defer merging to the next tick.
+   */
+  bool DeferredMerging() const {
+    return FrameAligned() && !m_merge_tasks.empty();
+  }
+
+  /**
+   * @brief Called when the data in a universe has changed.
+   * @param universe the universe with new data.
+   * @param min_interval the minimum time between writes for this universe.
+   * @returns the action the universe should take.
+   */
+  OutputAction ScheduleOutput(Universe *universe,
+                              const TimeInterval &min_interval);
+
+  /**
+   * @brief Called when a universe has a fade in progress.
+   * @param universe the universe, Universe::RunFades() will be called until
+   *   it returns false.
+   */
+  void ScheduleFade(Universe *universe);
+
+  /**
+   * @brief Remove a universe from the scheduler.
+   * @param universe the universe to remove. Any pending write is dropped.
+   */
+  void RemoveUniverse(Universe *universe);
+
+  /**
+   * @brief Return the number of universes with a pending write.
+   */
+  unsigned int PendingCount() const;
+
+  /**
+   * @brief Return the number of universes with a fade in progress.
+   */
+  unsigned int FadeCount() const { return m_fading.size(); }
+
+  /**
+   * @brief The time between fade steps if the frame clock isn't running.
+   */
+  static const TimeInterval DEFAULT_FADE_INTERVAL;
+
+ private:
+  struct UniverseState {
+    UniverseState() : pending(false) {}
+
+    TimeStamp last_output;
+    TimeStamp due;
+    bool pending;
+  };
+
+  typedef std::map<Universe*, UniverseState> UniverseStateMap;
+
+  ola::thread::SchedulerInterface *m_scheduler;
+  Clock *m_clock;
+  bool m_free_clock;
+  TimeInterval m_frame_interval;
+  TimeStamp m_epoch;
+  UniverseStateMap m_universes;
+  std::vector<Universe*> m_flush_list;
+  std::vector<OutputPort*> m_batch_ports;
+  std::vector<OutputPort*> m_universe_ports;
+  ola::thread::timeout_id m_timeout;
+  TimeStamp m_timeout_due;
+
+  std::set<Universe*> m_fading;
+  std::vector<Universe*> m_fade_list;
+  TimeStamp m_next_fade;
+  TimeStamp m_fade_step_time;
+  bool m_running_fades;
+
+  std::auto_ptr<ola::thread::WorkStealingPool> m_merge_pool;
+  std::vector<BaseCallback0<void>*> m_merge_tasks;
+  // One entry per universe in m_flush_list. This isn't a vector<bool> since
+  // the entries are written from different threads.
+  std::vector<uint8_t> m_merge_results;
+  ola::thread::Mutex m_merge_mutex;
+  ola::thread::ConditionVariable m_merge_done;
+  unsigned int m_merges_outstanding;
+
+  void ArmTimeout(const TimeStamp &due, const TimeStamp &now);
+  void FlushDueUniverses();
+  void RunFades(const TimeStamp &now);
+  TimeStamp NextFade(const TimeStamp &now) const;
+  void RunMerges();
+  void MergeShard(unsigned int shard);
+  void BeginBatch();
+  void EndBatch();
+  TimeStamp NextTick(const TimeStamp &time) const;
+
+  DISALLOW_COPY_AND_ASSIGN(OutputScheduler);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_OUTPUTSCHEDULER_H_
@@ -0,0 +1,463 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputSchedulerTest.cpp
+ * Test fixture for the OutputScheduler class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/rdm/UID.h"
+#include "olad/DmxSource.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/PortBroker.h"
+#include "olad/Preferences.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/OutputScheduler.h"
+#include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniverseStore.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::DmxSource;
+using ola::ExportMap;
+using ola::MockClock;
+using ola::OutputScheduler;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::Universe;
+using ola::UniverseStore;
+using std::string;
+using std::vector;
+
+/**
+ * An output port that records the batch calls & writes.
+ */
+class BatchRecordingPort: public TestMockOutputPort {
+ public:
+  BatchRecordingPort(unsigned int port_id, vector<string> *log)
+      : TestMockOutputPort(NULL, port_id),
+        m_name(1, static_cast<char>('0' + port_id)),
+        m_log(log) {
+  }
+
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
+    m_log->push_back("write " + m_name);
+    return TestMockOutputPort::WriteDMX(buffer, priority);
+  }
+
+  void BeginBatch() { m_log->push_back("begin " + m_name); }
+  void EndBatch() { m_log->push_back("end " + m_name); }
+
+ private:
+  const string m_name;
+  vector<string> *m_log;
+};
+
+
+class OutputSchedulerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(OutputSchedulerTest);
+  CPPUNIT_TEST(testNoScheduling);
+  CPPUNIT_TEST(testOutputInterval);
+  CPPUNIT_TEST(testFrameClock);
+  CPPUNIT_TEST(testBatches);
+  CPPUNIT_TEST(testRemoveUniverse);
+  CPPUNIT_TEST(testMergeThreads);
+  CPPUNIT_TEST(testFades);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+  void testNoScheduling();
+  void testOutputInterval();
+  void testFrameClock();
+  void testBatches();
+  void testRemoveUniverse();
+  void testMergeThreads();
+  void testFades();
+
+ private:
+  ExportMap m_export_map;
+  MockClock m_clock;
+  MockScheduler m_scheduler;
+  ola::MemoryPreferences *m_preferences;
+  UniverseStore *m_store;
+  OutputScheduler *m_output_scheduler;
+
+  unsigned int Counter(const char *var) {
+    return (*m_export_map.GetUIntMapVar(var))["1"];
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OutputSchedulerTest);
+
+void OutputSchedulerTest::setUp() {
+  m_preferences = new ola::MemoryPreferences("foo");
+  m_output_scheduler = new OutputScheduler(&m_scheduler, &m_clock);
+  m_store = new UniverseStore(m_preferences, &m_export_map);
+  m_store->SetOutputScheduler(m_output_scheduler);
+}
+
+void OutputSchedulerTest::tearDown() {
+  delete m_store;
+  delete m_output_scheduler;
+  delete m_preferences;
+}
+
+
+/*
+ * Check that universes without an output interval write every change.
+ */
+void OutputSchedulerTest::testNoScheduling() {
+  Universe *universe = m_store->GetUniverseOrCreate(1);
+  OLA_ASSERT(universe);
+  TestMockOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(buffer, port.ReadDMX());
+  buffer.SetFromString("4,5,6");
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(buffer, port.ReadDMX());
+
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(2u, Counter(Universe::K_FPS_VAR));
+  OLA_ASSERT_EQ(0u, Counter(Universe::K_OUTPUT_DEFERRED_VAR));
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check that the output interval limits the rate of writes.
+ */
+void OutputSchedulerTest::testOutputInterval() {
+  Universe *universe = m_store->GetUniverseOrCreate(1);
+  OLA_ASSERT(universe);
+  universe->SetOutputInterval(TimeInterval(0, 100000));
+  TestMockOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  // The first change is written right away.
+  DmxBuffer buffer1, buffer2, buffer3;
+  buffer1.SetFromString("1,2,3");
+  buffer2.SetFromString("4,5,6");
+  buffer3.SetFromString("7,8,9");
+  OLA_ASSERT(universe->SetDMX(buffer1));
+  OLA_ASSERT_EQ(buffer1, port.ReadDMX());
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+
+  // The next two are coalesced into a single write.
+  m_clock.AdvanceTime(0, 40000);
+  OLA_ASSERT(universe->SetDMX(buffer2));
+  OLA_ASSERT(universe->SetDMX(buffer3));
+  OLA_ASSERT_EQ(buffer1, port.ReadDMX());
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  // The clock keeps running, so this may be slightly less than 60ms.
+  OLA_ASSERT_TRUE(m_scheduler.Delay() <= TimeInterval(0, 60000));
+  OLA_ASSERT_TRUE(m_scheduler.Delay() > TimeInterval(0, 50000));
+  OLA_ASSERT_EQ(1u, m_output_scheduler->PendingCount());
+  OLA_ASSERT_EQ(1u, Counter(Universe::K_OUTPUT_DEFERRED_VAR));
+  OLA_ASSERT_EQ(1u, Counter(Universe::K_OUTPUT_COALESCED_VAR));
+
+  m_clock.AdvanceTime(0, 60000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(buffer3, port.ReadDMX());
+  OLA_ASSERT_EQ(0u, m_output_scheduler->PendingCount());
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(2u, Counter(Universe::K_FPS_VAR));
+
+  // Once the interval has passed, changes are written right away again.
+  m_clock.AdvanceTime(0, 100000);
+  OLA_ASSERT(universe->SetDMX(buffer1));
+  OLA_ASSERT_EQ(buffer1, port.ReadDMX());
+  OLA_ASSERT_EQ(3u, Counter(Universe::K_FPS_VAR));
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check that the frame clock aligns the output of all universes.
+ */
+void OutputSchedulerTest::testFrameClock() {
+  m_output_scheduler->SetFrameInterval(TimeInterval(0, 25000));
+  Universe *universe1 = m_store->GetUniverseOrCreate(1);
+  Universe *universe2 = m_store->GetUniverseOrCreate(2);
+  TestMockOutputPort port1(NULL, 1);
+  TestMockOutputPort port2(NULL, 2);
+  universe1->AddPort(&port1);
+  universe2->AddPort(&port2);
+
+  DmxBuffer buffer1, buffer2;
+  buffer1.SetFromString("1,2,3");
+  buffer2.SetFromString("4,5,6");
+
+  m_clock.AdvanceTime(0, 10000);
+  OLA_ASSERT(universe1->SetDMX(buffer1));
+  m_clock.AdvanceTime(0, 5000);
+  OLA_ASSERT(universe2->SetDMX(buffer2));
+  OLA_ASSERT(universe1->SetDMX(buffer2));
+  OLA_ASSERT_EQ(0u, port1.ReadDMX().Size());
+  OLA_ASSERT_EQ(0u, port2.ReadDMX().Size());
+
+  // Both universes are sent on the next tick of the frame clock.
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_TRUE(m_scheduler.Delay() <= TimeInterval(0, 15000));
+  OLA_ASSERT_TRUE(m_scheduler.Delay() > TimeInterval(0, 5000));
+  m_clock.AdvanceTime(0, 10000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(buffer2, port1.ReadDMX());
+  OLA_ASSERT_EQ(buffer2, port2.ReadDMX());
+  OLA_ASSERT_EQ(1u, Counter(Universe::K_FPS_VAR));
+  OLA_ASSERT_EQ(1u, Counter(Universe::K_OUTPUT_COALESCED_VAR));
+
+  universe1->RemovePort(&port1);
+  universe2->RemovePort(&port2);
+}
+
+
+/*
+ * Check that the writes on each tick are wrapped in BeginBatch() / EndBatch().
+ */
+void OutputSchedulerTest::testBatches() {
+  vector<string> log;
+  BatchRecordingPort port1(1, &log);
+  BatchRecordingPort port2(2, &log);
+
+  // Without the frame clock there aren't any batches.
+  Universe *universe1 = m_store->GetUniverseOrCreate(1);
+  Universe *universe2 = m_store->GetUniverseOrCreate(2);
+  universe1->AddPort(&port1);
+  universe2->AddPort(&port2);
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT(universe1->SetDMX(buffer));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), log.size());
+  OLA_ASSERT_EQ(string("write 1"), log[0]);
+  log.clear();
+
+  m_output_scheduler->SetFrameInterval(TimeInterval(0, 25000));
+  OLA_ASSERT(universe1->SetDMX(buffer));
+  OLA_ASSERT(universe2->SetDMX(buffer));
+  OLA_ASSERT(log.empty());
+
+  m_clock.AdvanceTime(0, 25000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(static_cast<size_t>(6), log.size());
+  OLA_ASSERT_EQ(string("begin"), log[0].substr(0, 5));
+  OLA_ASSERT_EQ(string("begin"), log[1].substr(0, 5));
+  OLA_ASSERT_EQ(string("write"), log[2].substr(0, 5));
+  OLA_ASSERT_EQ(string("write"), log[3].substr(0, 5));
+  OLA_ASSERT_EQ(string("end"), log[4].substr(0, 3));
+  OLA_ASSERT_EQ(string("end"), log[5].substr(0, 3));
+  log.clear();
+
+  // Only the ports in universes that changed are part of the batch.
+  OLA_ASSERT(universe2->SetDMX(buffer));
+  m_clock.AdvanceTime(0, 25000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), log.size());
+  OLA_ASSERT_EQ(string("begin 2"), log[0]);
+  OLA_ASSERT_EQ(string("write 2"), log[1]);
+  OLA_ASSERT_EQ(string("end 2"), log[2]);
+
+  universe1->RemovePort(&port1);
+  universe2->RemovePort(&port2);
+}
+
+
+/*
+ * Check that deleting a universe cancels any pending write.
+ */
+void OutputSchedulerTest::testRemoveUniverse() {
+  m_output_scheduler->SetFrameInterval(TimeInterval(0, 25000));
+  Universe *universe = m_store->GetUniverseOrCreate(1);
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(1u, m_output_scheduler->PendingCount());
+
+  m_store->DeleteAll();
+  OLA_ASSERT_EQ(0u, m_output_scheduler->PendingCount());
+
+  // The timeout may still run, but there is nothing to do.
+  m_clock.AdvanceTime(0, 25000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(0u, m_output_scheduler->PendingCount());
+}
+
+
+/*
+ * Check that merging on the merge threads produces the same data.
+ */
+void OutputSchedulerTest::testMergeThreads() {
+  const unsigned int UNIVERSE_COUNT = 5;
+  ola::PortBroker broker;
+  ola::PortManager port_manager(m_store, &broker);
+  TimeStamp time_stamp;
+  MockSelectServer ss(&time_stamp);
+  ola::PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  MockDevice device(NULL, "foo");
+
+  OLA_ASSERT_FALSE(m_output_scheduler->StartMergeThreads(0));
+  OLA_ASSERT_TRUE(m_output_scheduler->StartMergeThreads(2));
+  OLA_ASSERT_FALSE(m_output_scheduler->StartMergeThreads(2));
+  // Merges are only deferred while the frame clock is running.
+  OLA_ASSERT_FALSE(m_output_scheduler->DeferredMerging());
+  m_output_scheduler->SetFrameInterval(TimeInterval(0, 25000));
+  OLA_ASSERT_TRUE(m_output_scheduler->DeferredMerging());
+
+  vector<TestMockInputPort*> input_ports;
+  vector<TestMockOutputPort*> output_ports;
+  vector<DmxBuffer> expected;
+  for (unsigned int i = 0; i < UNIVERSE_COUNT; i++) {
+    input_ports.push_back(new TestMockInputPort(&device, i, &plugin_adaptor));
+    output_ports.push_back(new TestMockOutputPort(NULL, i));
+    OLA_ASSERT(port_manager.PatchPort(input_ports[i], i + 1));
+    m_store->GetUniverseOrCreate(i + 1)->AddPort(output_ports[i]);
+  }
+
+  // The first universe has a second HTP source.
+  Universe *universe = m_store->GetUniverse(1);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+  TestMockInputPort htp_port(&device, UNIVERSE_COUNT, &plugin_adaptor);
+  OLA_ASSERT(port_manager.PatchPort(&htp_port, 1));
+
+  m_clock.CurrentTime(&time_stamp);
+  for (unsigned int i = 0; i < UNIVERSE_COUNT; i++) {
+    const uint8_t data[] = {static_cast<uint8_t>(i), 10,
+                            static_cast<uint8_t>(200 + i)};
+    DmxBuffer buffer(data, sizeof(data));
+    input_ports[i]->WriteDMX(buffer);
+    input_ports[i]->DmxChanged();
+    expected.push_back(buffer);
+  }
+  DmxBuffer htp_buffer;
+  htp_buffer.SetFromString("100,1,1");
+  htp_port.WriteDMX(htp_buffer);
+  htp_port.DmxChanged();
+  expected[0].SetFromString("100,10,200");
+
+  // Nothing is merged until the next tick.
+  OLA_ASSERT_EQ(0u, universe->GetDMX().Size());
+  OLA_ASSERT_EQ(UNIVERSE_COUNT, m_output_scheduler->PendingCount());
+
+  m_clock.AdvanceTime(0, 25000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(0u, m_output_scheduler->PendingCount());
+  for (unsigned int i = 0; i < UNIVERSE_COUNT; i++) {
+    OLA_ASSERT_DATA_EQUALS(expected[i].GetRaw(), expected[i].Size(),
+                           m_store->GetUniverse(i + 1)->GetDMX().GetRaw(),
+                           m_store->GetUniverse(i + 1)->GetDMX().Size());
+    OLA_ASSERT_DATA_EQUALS(expected[i].GetRaw(), expected[i].Size(),
+                           output_ports[i]->ReadDMX().GetRaw(),
+                           output_ports[i]->ReadDMX().Size());
+  }
+
+  // A lower HTP value in one source doesn't change the output.
+  htp_buffer.SetFromString("0,1,1");
+  htp_port.WriteDMX(htp_buffer);
+  htp_port.DmxChanged();
+  m_clock.AdvanceTime(0, 25000);
+  m_scheduler.RunTimeouts();
+  expected[0].SetFromString("0,10,200");
+  OLA_ASSERT_DATA_EQUALS(expected[0].GetRaw(), expected[0].Size(),
+                         output_ports[0]->ReadDMX().GetRaw(),
+                         output_ports[0]->ReadDMX().Size());
+
+  port_manager.UnPatchPort(&htp_port);
+  for (unsigned int i = 0; i < UNIVERSE_COUNT; i++) {
+    port_manager.UnPatchPort(input_ports[i]);
+    m_store->GetUniverse(i + 1)->RemovePort(output_ports[i]);
+    delete input_ports[i];
+    delete output_ports[i];
+  }
+}
+
+
+/*
+ * Check that fades are stepped on the frame clock.
+ */
+void OutputSchedulerTest::testFades() {
+  ola::Client client(NULL, ola::rdm::UID(0x7a70, 1));
+  TestMockOutputPort port(NULL, 1);
+  Universe *universe = m_store->GetUniverseOrCreate(1);
+  universe->AddPort(&port);
+  m_output_scheduler->SetFrameInterval(TimeInterval(0, 25000));
+
+  DmxBuffer target;
+  target.SetFromString("200,100,0");
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  OLA_ASSERT_TRUE(universe->FadeSourceClient(
+      &client, DmxSource(target, now, 100), TimeInterval(0, 100000)));
+  OLA_ASSERT_EQ(1u, m_output_scheduler->FadeCount());
+  OLA_ASSERT_EQ(0u, port.ReadDMX().Size());
+
+  // The first step is a quarter of the way there, and is sent on the same
+  // tick.
+  m_clock.AdvanceTime(0, 25000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(3u, port.ReadDMX().Size());
+  OLA_ASSERT_TRUE(port.ReadDMX().Get(0) >= 50 && port.ReadDMX().Get(0) < 60);
+  OLA_ASSERT_TRUE(port.ReadDMX().Get(1) >= 25 && port.ReadDMX().Get(1) < 30);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), port.ReadDMX().Get(2));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), universe->ActivePriority());
+
+  for (unsigned int i = 0; i < 3; i++) {
+    m_clock.AdvanceTime(0, 25000);
+    m_scheduler.RunTimeouts();
+  }
+  OLA_ASSERT_EQ(target, port.ReadDMX());
+  OLA_ASSERT_EQ(0u, m_output_scheduler->FadeCount());
+
+  // New data from the client cancels a fade.
+  DmxBuffer black;
+  black.SetFromString("0,0,0");
+  m_clock.CurrentTime(&now);
+  OLA_ASSERT_TRUE(universe->FadeSourceClient(
+      &client, DmxSource(black, now, 100), TimeInterval(1, 0)));
+  DmxBuffer snap;
+  snap.SetFromString("10,20,30");
+  client.DMXReceived(1, DmxSource(snap, now, 100));
+  OLA_ASSERT_TRUE(universe->SourceClientDataChanged(&client));
+  m_clock.AdvanceTime(0, 25000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(snap, port.ReadDMX());
+  OLA_ASSERT_EQ(0u, m_output_scheduler->FadeCount());
+
+  // A zero duration applies the data straight away.
+  OLA_ASSERT_TRUE(universe->FadeSourceClient(
+      &client, DmxSource(target, now, 100), TimeInterval()));
+  OLA_ASSERT_EQ(0u, m_output_scheduler->FadeCount());
+  m_clock.AdvanceTime(0, 25000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(target, port.ReadDMX());
+
+  universe->RemoveSourceClient(&client);
+  universe->RemovePort(&port);
+}
@@ -19,8 +19,11 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <map>
 #include <string>
 #include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/network/XDPReceiver.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/PortBroker.h"
 #include "olad/Preferences.h"
@@ -46,6 +49,17 @@ PluginAdaptor::PluginAdaptor(DeviceManager *device_manager,
   m_instance_name(instance_name) {
 }
 
+PluginAdaptor::~PluginAdaptor() {
+  std::map<int32_t, ola::network::XDPReceiver*>::iterator iter =
+      m_xdp_receivers.begin();
+  for (; iter != m_xdp_receivers.end(); ++iter) {
+    if (iter->second) {
+      m_ss->RemoveReadDescriptor(iter->second);
+      delete iter->second;
+    }
+  }
+}
+
 bool PluginAdaptor::AddReadDescriptor(
     ola::io::ReadFileDescriptor *descriptor) {
   return m_ss->AddReadDescriptor(descriptor);
@@ -125,6 +139,35 @@ Preferences *PluginAdaptor::NewPreference(const string &name) const {
   return m_preferences_factory->NewPreference(name);
 }
 
+/*
+ * A failed receiver is remembered as NULL so each plugin doesn't try again.
+ */
+ola::network::XDPReceiver *PluginAdaptor::GetXDPReceiver(
+    const ola::network::Interface &iface,
+    unsigned int queue_id) {
+  std::map<int32_t, ola::network::XDPReceiver*>::iterator iter =
+      m_xdp_receivers.find(iface.index);
+  if (iter != m_xdp_receivers.end()) {
+    if (iter->second && iter->second->QueueId() != queue_id) {
+      OLA_WARN << "AF_XDP is already using queue "
+               << iter->second->QueueId() << " on " << iface.name;
+    }
+    return iter->second;
+  }
+
+  ola::network::XDPReceiverOptions options;
+  options.queue_id = queue_id;
+  ola::network::XDPReceiver *receiver = new ola::network::XDPReceiver(
+      iface, options);
+  if (!receiver->Init() || !m_ss->AddReadDescriptor(receiver)) {
+    OLA_WARN << "Falling back to sockets on " << iface.name;
+    delete receiver;
+    receiver = NULL;
+  }
+  m_xdp_receivers[iface.index] = receiver;
+  return receiver;
+}
+
 const TimeStamp *PluginAdaptor::WakeUpTime() const {
   return m_ss->WakeUpTime();
 }
@@ -82,12 +82,28 @@ bool BasicInputPort::SetPriority(uint8_t priority) {
 
 void BasicInputPort::DmxChanged() {
   if (GetUniverse()) {
-    const DmxBuffer &buffer = ReadDMX();
-    uint8_t priority = (PriorityCapability() == CAPABILITY_FULL &&
-                        GetPriorityMode() == PRIORITY_MODE_INHERIT ?
-                        InheritedPriority() :
-                        GetPriority());
-    m_dmx_source.UpdateData(buffer, *m_plugin_adaptor->WakeUpTime(), priority);
+    const DmxBuffer *buffer = &ReadDMX();
+    const bool inherit = (PriorityCapability() == CAPABILITY_FULL &&
+                          GetPriorityMode() == PRIORITY_MODE_INHERIT);
+    uint8_t priority = inherit ? InheritedPriority() : GetPriority();
+    const DmxBuffer *slot_priorities = inherit ? InheritedSlotPriorities() :
+                                                 NULL;
+    if (!m_slot_remap.Empty()) {
+      // Slots that aren't mapped get a priority of 0, so they aren't sourced.
+      m_slot_remap.Apply(*buffer, &m_remapped_data);
+      buffer = &m_remapped_data;
+      if (slot_priorities) {
+        m_slot_remap.Apply(*slot_priorities, &m_remapped_priorities);
+        slot_priorities = &m_remapped_priorities;
+      }
+    }
+    if (slot_priorities) {
+      m_dmx_source.UpdateData(*buffer, *m_plugin_adaptor->WakeUpTime(),
+                              priority, *slot_priorities);
+    } else {
+      m_dmx_source.UpdateData(*buffer, *m_plugin_adaptor->WakeUpTime(),
+                              priority);
+    }
     GetUniverse()->PortDataChanged(this);
   }
 }
@@ -128,7 +144,9 @@ BasicOutputPort::BasicOutputPort(AbstractDevice *parent,
     m_port_string(""),
     m_universe(NULL),
     m_device(parent),
-    m_supports_rdm(supports_rdm) {
+    m_supports_rdm(supports_rdm),
+    m_max_rate(0),
+    m_max_burst(0) {
 }
 
 bool BasicOutputPort::SetUniverse(Universe *new_universe) {
@@ -139,9 +157,9 @@ bool BasicOutputPort::SetUniverse(Universe *new_universe) {
   if (PreSetUniverse(old_universe, new_universe)) {
     m_universe = new_universe;
     PostSetUniverse(old_universe, new_universe);
-    if (m_discover_on_patch)
-      RunIncrementalDiscovery(
-          NewSingleCallback(this, &BasicOutputPort::UpdateUIDs));
+    if (m_discover_on_patch && new_universe)
+      new_universe->RunPortDiscovery(
+          this, false, NewSingleCallback(this, &BasicOutputPort::UpdateUIDs));
     return true;
   }
   return false;
@@ -20,15 +20,123 @@
 
 #include "olad/plugin_api/PortManager.h"
 
+#include <map>
+#include <utility>
 #include <vector>
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/stl/STLUtils.h"
 #include "olad/Port.h"
 
 namespace ola {
 
+using std::map;
 using std::vector;
 
+namespace {
+
+bool IsInputPort(const InputPort*) { return true; }
+bool IsInputPort(const OutputPort*) { return false; }
+}  // namespace
+
+
+/*
+ * The universes that each device's ports are patched to. A device's entry is
+ * built the first time it's needed, after that it's kept up to date as ports
+ * are patched & unpatched.
+ */
+class PortManager::PatchIndex {
+ public:
+  PatchIndex() {}
+
+  /*
+   * Check if a port of the device can be patched to the universe.
+   */
+  bool CanPatch(const AbstractDevice *device, bool input,
+                unsigned int universe_id) {
+    DeviceUniverses *universes = Lookup(device);
+    if (!device->AllowLooping()) {
+      const UniverseCounts &opposite = input ? universes->output_universes :
+          universes->input_universes;
+      if (STLContains(opposite, universe_id)) {
+        OLA_INFO << "Device " << device->UniqueId()
+                 << " would loop on universe " << universe_id;
+        return false;
+      }
+    }
+
+    if (!device->AllowMultiPortPatching()) {
+      const UniverseCounts &same = input ? universes->input_universes :
+          universes->output_universes;
+      if (STLContains(same, universe_id)) {
+        OLA_INFO << "Device " << device->UniqueId()
+                 << " already has a port patched to " << universe_id;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Add(const AbstractDevice *device, bool input,
+           unsigned int universe_id) {
+    DeviceUniverses *universes = Lookup(device);
+    (input ? universes->input_universes :
+             universes->output_universes)[universe_id]++;
+  }
+
+  void Remove(const AbstractDevice *device, bool input,
+              unsigned int universe_id) {
+    DeviceUniverses *universes = Lookup(device);
+    UniverseCounts &counts = input ? universes->input_universes :
+        universes->output_universes;
+    UniverseCounts::iterator iter = counts.find(universe_id);
+    if (iter != counts.end() && --iter->second == 0) {
+      counts.erase(iter);
+    }
+  }
+
+ private:
+  // universe id to the number of ports patched to it
+  typedef map<unsigned int, unsigned int> UniverseCounts;
+
+  struct DeviceUniverses {
+    UniverseCounts input_universes;
+    UniverseCounts output_universes;
+  };
+
+  map<const AbstractDevice*, DeviceUniverses> m_devices;
+
+  DeviceUniverses *Lookup(const AbstractDevice *device) {
+    map<const AbstractDevice*, DeviceUniverses>::iterator iter =
+        m_devices.find(device);
+    if (iter != m_devices.end()) {
+      return &iter->second;
+    }
+
+    DeviceUniverses *universes = &m_devices[device];
+    vector<InputPort*> input_ports;
+    device->InputPorts(&input_ports);
+    AddPorts(input_ports, &universes->input_universes);
+    vector<OutputPort*> output_ports;
+    device->OutputPorts(&output_ports);
+    AddPorts(output_ports, &universes->output_universes);
+    return universes;
+  }
+
+  template<class PortClass>
+  void AddPorts(const vector<PortClass*> &ports, UniverseCounts *counts) {
+    typename vector<PortClass*>::const_iterator iter = ports.begin();
+    for (; iter != ports.end(); ++iter) {
+      if ((*iter)->GetUniverse()) {
+        (*counts)[(*iter)->GetUniverse()->UniverseId()]++;
+      }
+    }
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(PatchIndex);
+};
+
+
 bool PortManager::PatchPort(InputPort *port,
                             unsigned int universe) {
   return GenericPatchPort(port, universe);
@@ -47,6 +155,74 @@ bool PortManager::UnPatchPort(OutputPort *port) {
   return GenericUnPatchPort(port);
 }
 
+bool PortManager::ApplyPatches(const vector<PortPatch> &patches) {
+  // The ports that need to change, and the universe each was bound to.
+  vector<std::pair<PortPatch, Universe*> > changes;
+  vector<PortPatch>::const_iterator iter = patches.begin();
+  for (; iter != patches.end(); ++iter) {
+    if (!iter->input_port && !iter->output_port) {
+      return false;
+    }
+    Universe *current = CurrentUniverse(*iter);
+    bool unchanged = iter->patch ?
+        current && current->UniverseId() == iter->universe : !current;
+    if (!unchanged) {
+      changes.push_back(std::make_pair(*iter, current));
+    }
+  }
+
+  PatchIndex index;
+  vector<std::pair<PortPatch, Universe*> >::const_iterator change;
+  vector<unsigned int> old_universes;
+  for (change = changes.begin(); change != changes.end(); ++change) {
+    // The universe may be removed once it has no ports, so save the id now.
+    old_universes.push_back(change->second ? change->second->UniverseId() : 0);
+    if (change->second) {
+      UnPatchPort(change->first, &index);
+    }
+  }
+
+  bool ok = true;
+  for (change = changes.begin(); ok && change != changes.end(); ++change) {
+    if (change->first.patch) {
+      ok = PatchPort(change->first, change->first.universe, &index);
+    }
+  }
+  if (ok) {
+    return true;
+  }
+
+  OLA_WARN << "Failed to apply " << changes.size()
+           << " port changes, rolling back";
+  for (change = changes.begin(); change != changes.end(); ++change) {
+    UnPatchPort(change->first, &index);
+  }
+  for (unsigned int i = 0; i < changes.size(); i++) {
+    if (changes[i].second) {
+      PatchPort(changes[i].first, old_universes[i], &index);
+    }
+  }
+  return false;
+}
+
+unsigned int PortManager::PatchPorts(const vector<PortPatch> &patches) {
+  PatchIndex index;
+  unsigned int applied = 0;
+  vector<PortPatch>::const_iterator iter = patches.begin();
+  for (; iter != patches.end(); ++iter) {
+    if (!iter->input_port && !iter->output_port) {
+      continue;
+    }
+    if (iter->patch) {
+      applied += PatchPort(*iter, iter->universe, &index);
+    } else {
+      UnPatchPort(*iter, &index);
+      applied++;
+    }
+  }
+  return applied;
+}
+
 bool PortManager::SetPriorityInherit(Port *port) {
   if (port->PriorityCapability() != CAPABILITY_FULL)
     return true;
@@ -79,9 +255,36 @@ bool PortManager::SetPriorityStatic(Port *port, uint8_t value) {
 }
 
 
+bool PortManager::PatchPort(const PortPatch &patch, unsigned int universe,
+                            PatchIndex *index) {
+  if (patch.input_port) {
+    return GenericPatchPort(patch.input_port, universe, index);
+  }
+  return GenericPatchPort(patch.output_port, universe, index);
+}
+
+
+void PortManager::UnPatchPort(const PortPatch &patch, PatchIndex *index) {
+  if (patch.input_port) {
+    GenericUnPatchPort(patch.input_port, index);
+  } else {
+    GenericUnPatchPort(patch.output_port, index);
+  }
+}
+
+
+Universe *PortManager::CurrentUniverse(const PortPatch &patch) const {
+  if (patch.input_port) {
+    return patch.input_port->GetUniverse();
+  }
+  return patch.output_port->GetUniverse();
+}
+
+
 template<class PortClass>
 bool PortManager::GenericPatchPort(PortClass *port,
-                                   unsigned int new_universe_id) {
+                                   unsigned int new_universe_id,
+                                   PatchIndex *index) {
   if (!port)
     return false;
 
@@ -90,7 +293,10 @@ bool PortManager::GenericPatchPort(PortClass *port,
     return true;
 
   AbstractDevice *device = port->GetDevice();
-  if (device) {
+  if (device && index) {
+    if (!index->CanPatch(device, IsInputPort(port), new_universe_id))
+      return false;
+  } else if (device) {
     if (!device->AllowLooping()) {
       // check ports of the opposite type
       if (CheckLooping<PortClass>(device, new_universe_id))
@@ -109,6 +315,8 @@ bool PortManager::GenericPatchPort(PortClass *port,
       universe->UniverseId();
     m_broker->RemovePort(port);
     universe->RemovePort(port);
+    if (device && index)
+      index->Remove(device, IsInputPort(port), universe->UniverseId());
   }
 
   universe = m_universe_store->GetUniverseOrCreate(new_universe_id);
@@ -120,6 +328,8 @@ bool PortManager::GenericPatchPort(PortClass *port,
       universe->UniverseId();
     m_broker->AddPort(port);
     universe->AddPort(port);
+    if (device && index)
+      index->Add(device, IsInputPort(port), new_universe_id);
   } else {
     if (!universe->IsActive())
       m_universe_store->AddUniverseGarbageCollection(universe);
@@ -129,13 +339,16 @@ bool PortManager::GenericPatchPort(PortClass *port,
 
 
 template<class PortClass>
-bool PortManager::GenericUnPatchPort(PortClass *port) {
+bool PortManager::GenericUnPatchPort(PortClass *port, PatchIndex *index) {
   if (!port)
     return false;
 
   Universe *universe = port->GetUniverse();
   m_broker->RemovePort(port);
   if (universe) {
+    if (index && port->GetDevice())
+      index->Remove(port->GetDevice(), IsInputPort(port),
+                    universe->UniverseId());
     universe->RemovePort(port);
     port->SetUniverse(NULL);
     OLA_INFO << "Unpatched " << port->UniqueId() << " from uni "
@@ -24,7 +24,6 @@
 #include <vector>
 #include "olad/Device.h"
 #include "olad/PortBroker.h"
-#include "olad/plugin_api/DeviceManager.h"
 #include "olad/plugin_api/UniverseStore.h"
 #include "ola/base/Macro.h"
 
@@ -36,6 +35,32 @@ namespace ola {
  */
 class PortManager {
  public:
+  /**
+   * @brief The desired state of a single port, used with ApplyPatches().
+   *
+   * Exactly one of input_port and output_port is set.
+   */
+  struct PortPatch {
+    PortPatch(InputPort *port, bool patch, unsigned int universe)
+        : input_port(port),
+          output_port(NULL),
+          patch(patch),
+          universe(universe) {
+    }
+
+    PortPatch(OutputPort *port, bool patch, unsigned int universe)
+        : input_port(NULL),
+          output_port(port),
+          patch(patch),
+          universe(universe) {
+    }
+
+    InputPort *input_port;
+    OutputPort *output_port;
+    bool patch;  /**< false to unpatch the port */
+    unsigned int universe;  /**< ignored when unpatching */
+  };
+
   /**
    * @brief Create a new PortManager.
    * @param universe_store the UniverseStore used to lookup / create Universes.
@@ -82,6 +107,32 @@ class PortManager {
    */
   bool UnPatchPort(OutputPort *port);
 
+  /**
+   * @brief Bring a set of ports to the desired patching.
+   * @param patches the desired state of each port.
+   * @returns true if all changes were applied. On failure the ports are
+   *   returned to their previous universes and false is returned.
+   *
+   * Ports that are already in the desired state are left alone, so the
+   * universes they're bound to aren't disturbed. The changed ports are all
+   * unpatched before any are patched, which allows two ports to swap
+   * universes without failing the looping or multi-port checks.
+   */
+  bool ApplyPatches(const std::vector<PortPatch> &patches);
+
+  /**
+   * @brief Apply a set of patches, skipping any that fail.
+   * @param patches the desired state of each port.
+   * @returns the number of patches that were applied.
+   *
+   * Unlike ApplyPatches(), each patch is applied in order and a failure
+   * doesn't affect the others. The universes used by each device's ports are
+   * collected once, so checking for loops & multi-port patching doesn't walk
+   * every port of the device for each patch. This is used to restore the
+   * patchings when a device is registered.
+   */
+  unsigned int PatchPorts(const std::vector<PortPatch> &patches);
+
   /**
    * @brief Set a port to 'inherit' priority mode.
    * @param port the port to configure
@@ -96,12 +147,20 @@ class PortManager {
   bool SetPriorityStatic(Port *port, uint8_t value);
 
  private:
+  class PatchIndex;
+
+  bool PatchPort(const PortPatch &patch, unsigned int universe,
+                 PatchIndex *index);
+  void UnPatchPort(const PortPatch &patch, PatchIndex *index);
+  Universe *CurrentUniverse(const PortPatch &patch) const;
+
   template<class PortClass>
   bool GenericPatchPort(PortClass *port,
-                        unsigned int new_universe_id);
+                        unsigned int new_universe_id,
+                        PatchIndex *index = NULL);
 
   template<class PortClass>
-  bool GenericUnPatchPort(PortClass *port);
+  bool GenericUnPatchPort(PortClass *port, PatchIndex *index = NULL);
 
   template<class PortClass>
   bool CheckLooping(const AbstractDevice *device,
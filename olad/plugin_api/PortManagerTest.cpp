@@ -20,6 +20,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <string>
+#include <vector>
 
 #include "olad/DmxSource.h"
 #include "olad/PortBroker.h"
@@ -34,12 +35,15 @@ using ola::PortManager;
 using ola::Port;
 using ola::Universe;
 using std::string;
+using std::vector;
 
 
 class PortManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PortManagerTest);
   CPPUNIT_TEST(testPortPatching);
   CPPUNIT_TEST(testPortPatchingLoopMulti);
+  CPPUNIT_TEST(testApplyPatches);
+  CPPUNIT_TEST(testPatchPorts);
   CPPUNIT_TEST(testInputPortSetPriority);
   CPPUNIT_TEST(testOutputPortSetPriority);
   CPPUNIT_TEST_SUITE_END();
@@ -47,6 +51,8 @@ class PortManagerTest: public CppUnit::TestFixture {
  public:
     void testPortPatching();
     void testPortPatchingLoopMulti();
+    void testApplyPatches();
+    void testPatchPorts();
     void testInputPortSetPriority();
     void testOutputPortSetPriority();
 };
@@ -175,6 +181,107 @@ void PortManagerTest::testPortPatchingLoopMulti() {
 }
 
 
+/*
+ * Check that ApplyPatches only changes what it needs to, and rolls back on
+ * failure.
+ */
+void PortManagerTest::testApplyPatches() {
+  ola::UniverseStore uni_store(NULL, NULL);
+  ola::PortBroker broker;
+  ola::PortManager port_manager(&uni_store, &broker);
+
+  // mock device, this doesn't allow looping or multiport patching
+  MockDevice device1(NULL, "test_device_1");
+  TestMockInputPort input_port(&device1, 1, NULL);
+  TestMockInputPort input_port2(&device1, 2, NULL);
+  TestMockOutputPort output_port(&device1, 1);
+  TestMockOutputPort output_port2(&device1, 2);
+  device1.AddPort(&input_port);
+  device1.AddPort(&input_port2);
+  device1.AddPort(&output_port);
+  device1.AddPort(&output_port2);
+
+  OLA_ASSERT(port_manager.PatchPort(&input_port, 1));
+  OLA_ASSERT(port_manager.PatchPort(&output_port, 2));
+
+  // Swapping universes would fail the looping check if done one at a time.
+  vector<PortManager::PortPatch> patches;
+  patches.push_back(PortManager::PortPatch(&input_port, true, 2));
+  patches.push_back(PortManager::PortPatch(&output_port, true, 1));
+  OLA_ASSERT(port_manager.ApplyPatches(patches));
+  OLA_ASSERT_EQ((unsigned int) 2, input_port.GetUniverse()->UniverseId());
+  OLA_ASSERT_EQ((unsigned int) 1, output_port.GetUniverse()->UniverseId());
+
+  // Unchanged ports are left alone.
+  Universe *universe = input_port.GetUniverse();
+  patches.clear();
+  patches.push_back(PortManager::PortPatch(&input_port, true, 2));
+  patches.push_back(PortManager::PortPatch(&input_port2, false, 0));
+  patches.push_back(PortManager::PortPatch(&output_port2, true, 3));
+  OLA_ASSERT(port_manager.ApplyPatches(patches));
+  OLA_ASSERT_EQ(universe, input_port.GetUniverse());
+  OLA_ASSERT_EQ(static_cast<Universe*>(NULL), input_port2.GetUniverse());
+  OLA_ASSERT_EQ((unsigned int) 3, output_port2.GetUniverse()->UniverseId());
+
+  // A multiport failure rolls back all the changes.
+  patches.clear();
+  patches.push_back(PortManager::PortPatch(&output_port2, false, 0));
+  patches.push_back(PortManager::PortPatch(&output_port, true, 5));
+  patches.push_back(PortManager::PortPatch(&input_port2, true, 2));
+  OLA_ASSERT_FALSE(port_manager.ApplyPatches(patches));
+  OLA_ASSERT_EQ((unsigned int) 2, input_port.GetUniverse()->UniverseId());
+  OLA_ASSERT_EQ(static_cast<Universe*>(NULL), input_port2.GetUniverse());
+  OLA_ASSERT_EQ((unsigned int) 1, output_port.GetUniverse()->UniverseId());
+  OLA_ASSERT_EQ((unsigned int) 3, output_port2.GetUniverse()->UniverseId());
+}
+
+
+/*
+ * Check that PatchPorts applies what it can, in order.
+ */
+void PortManagerTest::testPatchPorts() {
+  ola::UniverseStore uni_store(NULL, NULL);
+  ola::PortBroker broker;
+  ola::PortManager port_manager(&uni_store, &broker);
+
+  // mock device, this doesn't allow looping or multiport patching
+  MockDevice device1(NULL, "test_device_1");
+  TestMockInputPort input_port(&device1, 1, NULL);
+  TestMockInputPort input_port2(&device1, 2, NULL);
+  TestMockOutputPort output_port(&device1, 1);
+  TestMockOutputPort output_port2(&device1, 2);
+  device1.AddPort(&input_port);
+  device1.AddPort(&input_port2);
+  device1.AddPort(&output_port);
+  device1.AddPort(&output_port2);
+
+  OLA_ASSERT(port_manager.PatchPort(&output_port2, 4));
+
+  // The second input port fails the multiport check, the second output port
+  // fails the looping check, since it's applied after the first input port.
+  vector<PortManager::PortPatch> patches;
+  patches.push_back(PortManager::PortPatch(&input_port, true, 1));
+  patches.push_back(PortManager::PortPatch(&input_port2, true, 1));
+  patches.push_back(PortManager::PortPatch(&output_port, true, 2));
+  patches.push_back(PortManager::PortPatch(&output_port2, true, 1));
+  OLA_ASSERT_EQ(2u, port_manager.PatchPorts(patches));
+  OLA_ASSERT_EQ((unsigned int) 1, input_port.GetUniverse()->UniverseId());
+  OLA_ASSERT_EQ(static_cast<Universe*>(NULL), input_port2.GetUniverse());
+  OLA_ASSERT_EQ((unsigned int) 2, output_port.GetUniverse()->UniverseId());
+  OLA_ASSERT_EQ((unsigned int) 4, output_port2.GetUniverse()->UniverseId());
+
+  // Unpatching a port frees up its universe for later patches.
+  patches.clear();
+  patches.push_back(PortManager::PortPatch(&input_port, false, 0));
+  patches.push_back(PortManager::PortPatch(&output_port2, true, 1));
+  patches.push_back(PortManager::PortPatch(&input_port2, true, 2));
+  OLA_ASSERT_EQ(2u, port_manager.PatchPorts(patches));
+  OLA_ASSERT_EQ(static_cast<Universe*>(NULL), input_port.GetUniverse());
+  OLA_ASSERT_EQ((unsigned int) 1, output_port2.GetUniverse()->UniverseId());
+  OLA_ASSERT_EQ(static_cast<Universe*>(NULL), input_port2.GetUniverse());
+}
+
+
 /*
  * Check that we can set priorities on an input port
  */
@@ -31,7 +31,6 @@
 #include <fstream>
 #include <list>
 #include <map>
-#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -42,40 +41,79 @@
 #include "ola/network/IPV4Address.h"
 #include "ola/stl/STLUtils.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/ThreadSettings.h"
 #include "olad/Preferences.h"
 
 namespace ola {
 
 using ola::thread::Mutex;
 using ola::thread::ConditionVariable;
+using ola::thread::MutexLocker;
 using std::ifstream;
-using std::ofstream;
 using std::map;
 using std::pair;
 using std::string;
 using std::vector;
 
 namespace {
+/*
+ * Write to a temporary file and then rename it, so the file is either the old
+ * or the new version, never partially written.
+ */
 void SavePreferencesToFile(
-    const string *filename_ptr,
-    const FilePreferenceSaverThread::PreferencesMap *pref_map_ptr) {
-  std::auto_ptr<const string> filename(filename_ptr);
-  std::auto_ptr<const FilePreferenceSaverThread::PreferencesMap> pref_map(
-      pref_map_ptr);
-
+    const string &filename,
+    const FilePreferenceSaverThread::PreferencesMap &pref_map) {
+  string contents;
   FilePreferenceSaverThread::PreferencesMap::const_iterator iter;
-  ofstream pref_file(filename->data());
+  for (iter = pref_map.begin(); iter != pref_map.end(); ++iter) {
+    contents.append(iter->first);
+    contents.append(" = ");
+    contents.append(iter->second);
+    contents.push_back('\n');
+  }
 
-  if (!pref_file.is_open()) {
-    OLA_WARN << "Could not open " << *filename_ptr << ": " << strerror(errno);
+  const string temp_filename = filename + ".new";
+  FILE *pref_file = fopen(temp_filename.c_str(), "w");
+  if (!pref_file) {
+    OLA_WARN << "Could not open " << temp_filename << ": " << strerror(errno);
     return;
   }
 
-  for (iter = pref_map->begin(); iter != pref_map->end(); ++iter) {
-    pref_file << iter->first << " = " << iter->second << std::endl;
+  bool ok = fwrite(contents.data(), 1, contents.size(), pref_file) ==
+            contents.size();
+  ok &= fflush(pref_file) == 0;
+#ifndef _WIN32
+  ok &= fsync(fileno(pref_file)) == 0;
+#endif  // _WIN32
+  ok &= fclose(pref_file) == 0;
+  if (!ok) {
+    OLA_WARN << "Failed to write " << temp_filename << ": " << strerror(errno);
+    unlink(temp_filename.c_str());
+    return;
+  }
+
+#ifdef _WIN32
+  // rename() doesn't replace an existing file on Windows.
+  unlink(filename.c_str());
+#endif  // _WIN32
+  if (rename(temp_filename.c_str(), filename.c_str())) {
+    OLA_WARN << "Failed to rename " << temp_filename << " to " << filename
+             << ": " << strerror(errno);
+    unlink(temp_filename.c_str());
+  }
+}
+
+/*
+ * Remove the characters StringTrim() removes from both ends of a range.
+ */
+void TrimRange(const char **start, const char **end) {
+  static const char TRIM_CHARS[] = " \n\r\t";
+  while (*start < *end && strchr(TRIM_CHARS, **start)) {
+    (*start)++;
+  }
+  while (*end > *start && strchr(TRIM_CHARS, *(*end - 1))) {
+    (*end)--;
   }
-  pref_file.flush();
-  pref_file.close();
 }
 }  // namespace
 
@@ -344,8 +382,11 @@ void MemoryPreferences::SetValueAsBool(const string &key, bool value) {
 // FilePreferenceSaverThread
 //-----------------------------------------------------------------------------
 
-FilePreferenceSaverThread::FilePreferenceSaverThread()
-    : Thread(Thread::Options("pref-saver")) {
+FilePreferenceSaverThread::FilePreferenceSaverThread(
+    const TimeInterval &save_delay)
+    : Thread(Thread::Options("pref-saver",
+                             ola::thread::THREAD_CLASS_PREFERENCES)),
+      m_save_delay(save_delay) {
   // set a long poll interval so we don't spin
   m_ss.SetDefaultInterval(TimeInterval(60, 0));
 }
@@ -353,16 +394,25 @@ FilePreferenceSaverThread::FilePreferenceSaverThread()
 void FilePreferenceSaverThread::SavePreferences(
     const string &file_name,
     const PreferencesMap &preferences) {
-  const string *file_name_ptr = new string(file_name);
-  const PreferencesMap *save_map = new PreferencesMap(preferences);
-  SingleUseCallback0<void> *cb =
-      NewSingleCallback(SavePreferencesToFile, file_name_ptr, save_map);
-  m_ss.Execute(cb);
+  bool schedule;
+  {
+    MutexLocker lock(&m_pending_mutex);
+    schedule = m_pending_saves.empty();
+    // This replaces any earlier save of the same file that hasn't been
+    // written yet.
+    m_pending_saves[file_name] = preferences;
+  }
+  if (schedule) {
+    m_ss.Execute(
+        NewSingleCallback(this, &FilePreferenceSaverThread::ScheduleSave));
+  }
 }
 
 
 void *FilePreferenceSaverThread::Run() {
   m_ss.Run();
+  // Write anything that was saved just before we were stopped.
+  WritePendingSaves();
   return NULL;
 }
 
@@ -389,6 +439,7 @@ void FilePreferenceSaverThread::Syncronize() {
 void FilePreferenceSaverThread::CompleteSyncronization(
     ConditionVariable *condition,
     Mutex *mutex) {
+  WritePendingSaves();
   // calling lock here forces us to block until Wait() is called on the
   // condition_var.
   mutex->Lock();
@@ -397,6 +448,31 @@ void FilePreferenceSaverThread::CompleteSyncronization(
 }
 
 
+/*
+ * Called in the saver thread, since the SelectServer timeouts aren't thread
+ * safe.
+ */
+void FilePreferenceSaverThread::ScheduleSave() {
+  m_ss.RegisterSingleTimeout(
+      m_save_delay,
+      NewSingleCallback(this, &FilePreferenceSaverThread::WritePendingSaves));
+}
+
+
+void FilePreferenceSaverThread::WritePendingSaves() {
+  PendingSaves saves;
+  {
+    MutexLocker lock(&m_pending_mutex);
+    saves.swap(m_pending_saves);
+  }
+
+  PendingSaves::const_iterator iter = saves.begin();
+  for (; iter != saves.end(); ++iter) {
+    SavePreferencesToFile(iter->first, iter->second);
+  }
+}
+
+
 // FileBackedPreferences
 //-----------------------------------------------------------------------------
 
@@ -417,8 +493,11 @@ const string FileBackedPreferences::FileName() const {
 }
 
 
+/*
+ * The file is read in one go, and each line is parsed in place.
+ */
 bool FileBackedPreferences::LoadFromFile(const string &filename) {
-  ifstream pref_file(filename.data());
+  ifstream pref_file(filename.data(), std::ios::binary);
 
   if (!pref_file.is_open()) {
     OLA_INFO << "Missing " << filename << ": " << strerror(errno) <<
@@ -426,30 +505,52 @@ bool FileBackedPreferences::LoadFromFile(const string &filename) {
     return false;
   }
 
+  string contents;
+  pref_file.seekg(0, std::ios::end);
+  std::streamoff size = pref_file.tellg();
+  if (size > 0) {
+    contents.resize(static_cast<size_t>(size));
+    pref_file.seekg(0, std::ios::beg);
+    pref_file.read(&contents[0], size);
+    contents.resize(static_cast<size_t>(pref_file.gcount()));
+  }
+  pref_file.close();
+
   m_pref_map.clear();
-  string line;
-  while (getline(pref_file, line)) {
-    StringTrim(&line);
+  const char *ptr = contents.data();
+  const char *const contents_end = ptr + contents.size();
+  while (ptr < contents_end) {
+    const char *line_end = static_cast<const char*>(
+        memchr(ptr, '\n', contents_end - ptr));
+    if (!line_end) {
+      line_end = contents_end;
+    }
+    const char *line_start = ptr;
+    ptr = line_end + 1;
 
-    if (line.empty() || line.at(0) == '#') {
+    TrimRange(&line_start, &line_end);
+    if (line_start == line_end || *line_start == '#') {
       continue;
     }
 
-    vector<string> tokens;
-    StringSplit(line, &tokens, "=");
-
-    if (tokens.size() != 2) {
-      OLA_INFO << "Skipping line: " << line;
+    // There must be exactly one =
+    const char *equals = static_cast<const char*>(
+        memchr(line_start, '=', line_end - line_start));
+    if (!equals || memchr(equals + 1, '=', line_end - equals - 1)) {
+      OLA_INFO << "Skipping line: " << string(line_start, line_end);
       continue;
     }
 
-    string key = tokens[0];
-    string value = tokens[1];
-    StringTrim(&key);
-    StringTrim(&value);
-    m_pref_map.insert(make_pair(key, value));
+    const char *key_end = equals;
+    const char *value_start = equals + 1;
+    TrimRange(&line_start, &key_end);
+    TrimRange(&value_start, &line_end);
+    // The saved files are sorted, so hinting the end makes this constant
+    // time. The hint also keeps multiple values in the order they're listed.
+    m_pref_map.insert(m_pref_map.end(),
+                      make_pair(string(line_start, key_end),
+                                string(value_start, line_end)));
   }
-  pref_file.close();
   return true;
 }
 }  // namespace ola
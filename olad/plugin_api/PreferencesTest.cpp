@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
 #include <set>
 #include <string>
 #include <vector>
@@ -337,6 +338,10 @@ void PreferencesTest::testLoad() {
   OLA_ASSERT_EQ(string("1"), values.at(0));
   OLA_ASSERT_EQ(string("2"), values.at(1));
   OLA_ASSERT_EQ(string("3"), values.at(2));
+
+  OLA_ASSERT_EQ(string("a value"), preferences->GetValue("spaces"));
+  OLA_ASSERT_FALSE(preferences->HasKey("bad"));
+  OLA_ASSERT_FALSE(preferences->HasKey("not a setting"));
   delete preferences;
 }
 
@@ -366,12 +371,20 @@ void PreferencesTest::testSave() {
   preferences->SetMultipleValue(multi_key, "3");
   preferences->Save();
 
+  // Saves within the delay are merged, so only the last one is written.
+  preferences->SetValue(key1, "new value");
+  preferences->Save();
+
   saver_thread.Syncronize();
 
+  // The temporary file has been renamed.
+  OLA_ASSERT_EQ(-1, access((data_path + ".new").c_str(), F_OK));
+
   FileBackedPreferences *input_preferences = new
     FileBackedPreferences("", "input", NULL);
   input_preferences->LoadFromFile(data_path);
   OLA_ASSERT(*preferences == *input_preferences);
+  OLA_ASSERT_EQ(string("new value"), input_preferences->GetValue(key1));
   delete preferences;
   delete input_preferences;
 
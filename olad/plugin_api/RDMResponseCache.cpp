@@ -0,0 +1,230 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMResponseCache.cpp
+ * Caches the responses to GETs for PIDs that rarely change.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/RDMResponseCache.h"
+
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+
+namespace ola {
+
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMCommand;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::UID;
+using std::string;
+
+const char RDMResponseCache::K_CACHE_HITS_VAR[] = "rdm-cache-hits";
+const char RDMResponseCache::K_CACHE_MISSES_VAR[] = "rdm-cache-misses";
+
+RDMResponseCache::CacheKey::CacheKey(unsigned int universe,
+                                     const RDMRequest &request)
+    : universe(universe),
+      uid(request.DestinationUID()),
+      sub_device(request.SubDevice()),
+      pid(request.ParamId()),
+      param_data(reinterpret_cast<const char*>(request.ParamData()),
+                 request.ParamDataSize()) {
+}
+
+
+RDMResponseCache::CacheKey::CacheKey(unsigned int universe, const UID &uid)
+    : universe(universe),
+      uid(uid),
+      sub_device(0),
+      pid(0) {
+}
+
+
+bool RDMResponseCache::CacheKey::operator<(const CacheKey &other) const {
+  if (universe != other.universe) {
+    return universe < other.universe;
+  }
+  if (uid != other.uid) {
+    return uid < other.uid;
+  }
+  if (sub_device != other.sub_device) {
+    return sub_device < other.sub_device;
+  }
+  if (pid != other.pid) {
+    return pid < other.pid;
+  }
+  return param_data < other.param_data;
+}
+
+
+RDMResponseCache::RDMResponseCache(ExportMap *export_map, Clock *clock)
+    : m_export_map(export_map),
+      m_clock(clock),
+      m_free_clock(false),
+      m_generation(0) {
+  if (!m_clock) {
+    m_clock = new Clock();
+    m_free_clock = true;
+  }
+
+  const TimeInterval static_ttl(300, 0);
+  m_ttls[ola::rdm::PID_DEVICE_INFO] = TimeInterval(5, 0);
+  m_ttls[ola::rdm::PID_SUPPORTED_PARAMETERS] = static_ttl;
+  m_ttls[ola::rdm::PID_DEVICE_MODEL_DESCRIPTION] = static_ttl;
+  m_ttls[ola::rdm::PID_MANUFACTURER_LABEL] = static_ttl;
+  m_ttls[ola::rdm::PID_SOFTWARE_VERSION_LABEL] = static_ttl;
+
+  if (m_export_map) {
+    m_export_map->GetUIntMapVar(K_CACHE_HITS_VAR, "universe");
+    m_export_map->GetUIntMapVar(K_CACHE_MISSES_VAR, "universe");
+  }
+}
+
+
+RDMResponseCache::~RDMResponseCache() {
+  if (m_free_clock) {
+    delete m_clock;
+  }
+}
+
+
+void RDMResponseCache::SetTTL(uint16_t pid, const TimeInterval &ttl) {
+  if (ttl == TimeInterval()) {
+    m_ttls.erase(pid);
+  } else {
+    m_ttls[pid] = ttl;
+  }
+}
+
+
+bool RDMResponseCache::ServeRequest(unsigned int universe,
+                                    const RDMRequest *request,
+                                    RDMCallback **callback) {
+  const UID &destination = request->DestinationUID();
+  if (request->CommandClass() == RDMCommand::SET_COMMAND) {
+    if (destination.IsBroadcast()) {
+      InvalidateUniverse(universe);
+    } else {
+      InvalidateUID(universe, destination);
+    }
+    return false;
+  }
+
+  if (request->CommandClass() != RDMCommand::GET_COMMAND ||
+      destination.IsBroadcast()) {
+    return false;
+  }
+
+  const TimeInterval *ttl = STLFind(&m_ttls, request->ParamId());
+  if (!ttl) {
+    return false;
+  }
+
+  CacheKey key(universe, *request);
+  EntryMap::iterator iter = m_entries.find(key);
+  if (iter != m_entries.end()) {
+    TimeStamp now;
+    m_clock->CurrentTime(&now);
+    if (now < iter->second.expiry) {
+      IncrementVar(K_CACHE_HITS_VAR, universe);
+      const string &data = iter->second.param_data;
+      RDMResponse *response = ola::rdm::GetResponseFromData(
+          request,
+          reinterpret_cast<const uint8_t*>(data.data()),
+          data.size());
+      RDMReply reply(ola::rdm::RDM_COMPLETED_OK, response);
+      (*callback)->Run(&reply);
+      return true;
+    }
+    m_entries.erase(iter);
+  }
+
+  IncrementVar(K_CACHE_MISSES_VAR, universe);
+  PendingRequest *pending = new PendingRequest(key, *ttl, m_generation,
+                                               *callback);
+  *callback = NewSingleCallback(this, &RDMResponseCache::HandleReply,
+                                pending);
+  return false;
+}
+
+
+void RDMResponseCache::InvalidateUID(unsigned int universe, const UID &uid) {
+  Invalidate(universe, &uid);
+}
+
+
+void RDMResponseCache::InvalidateUniverse(unsigned int universe) {
+  Invalidate(universe, NULL);
+}
+
+
+/*
+ * Store an ACK, then pass the reply on to the original callback.
+ */
+void RDMResponseCache::HandleReply(PendingRequest *pending, RDMReply *reply) {
+  const RDMResponse *response = reply->Response();
+  if (pending->generation == m_generation &&
+      reply->StatusCode() == ola::rdm::RDM_COMPLETED_OK &&
+      response &&
+      response->ResponseType() == ola::rdm::RDM_ACK &&
+      response->CommandClass() == RDMCommand::GET_COMMAND_RESPONSE) {
+    CacheEntry &entry = m_entries[pending->key];
+    entry.param_data.assign(
+        reinterpret_cast<const char*>(response->ParamData()),
+        response->ParamDataSize());
+    m_clock->CurrentTime(&entry.expiry);
+    entry.expiry += pending->ttl;
+  }
+
+  RDMCallback *callback = pending->callback;
+  delete pending;
+  callback->Run(reply);
+}
+
+
+/*
+ * Remove the entries for a UID, or for the whole universe if uid is NULL. The
+ * entries are sorted by universe then UID, so they're a single range.
+ */
+void RDMResponseCache::Invalidate(unsigned int universe, const UID *uid) {
+  m_generation++;
+
+  EntryMap::iterator iter = m_entries.lower_bound(
+      CacheKey(universe, uid ? *uid : UID(0, 0)));
+  EntryMap::iterator end = iter;
+  while (end != m_entries.end() && end->first.universe == universe &&
+         (!uid || end->first.uid == *uid)) {
+    ++end;
+  }
+  m_entries.erase(iter, end);
+}
+
+
+void RDMResponseCache::IncrementVar(const char *var_name,
+                                    unsigned int universe) {
+  if (m_export_map) {
+    UIntMap *var = m_export_map->GetUIntMapVar(var_name);
+    (*var)[ola::strings::IntToString(universe)]++;
+  }
+}
+}  // namespace ola
@@ -0,0 +1,159 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMResponseCache.h
+ * Caches the responses to GETs for PIDs that rarely change.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_RDMRESPONSECACHE_H_
+#define OLAD_PLUGIN_API_RDMRESPONSECACHE_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMControllerInterface.h"
+#include "ola/rdm/UID.h"
+
+namespace ola {
+
+/**
+ * @brief Caches the responses to RDM GET requests.
+ *
+ * Only the PIDs which have a TTL are cached. By default these are the PIDs
+ * that describe the device, like DEVICE_MODEL_DESCRIPTION and
+ * SOFTWARE_VERSION_LABEL, which don't change unless the device is replaced.
+ * DEVICE_INFO is cached for a short time, since it includes the DMX start
+ * address & personality.
+ *
+ * Responses are keyed by the universe, UID, sub device, PID and the parameter
+ * data of the request. Only ACKs to GETs are stored. A SET to a UID removes
+ * all the cached responses from that UID, and a broadcast SET removes all the
+ * cached responses for the universe. Universe removes the responses for UIDs
+ * that are no longer present after discovery.
+ *
+ * The hits & misses are exported to the ExportMap, keyed by universe.
+ */
+class RDMResponseCache {
+ public:
+  /**
+   * @brief Create a new RDMResponseCache.
+   * @param export_map the ExportMap to update, may be NULL.
+   * @param clock the Clock to use, if NULL a Clock is created.
+   */
+  explicit RDMResponseCache(ExportMap *export_map, Clock *clock = NULL);
+  ~RDMResponseCache();
+
+  /**
+   * @brief Set how long responses for a PID are cached for.
+   * @param pid the PID.
+   * @param ttl the time to cache responses for, a zero interval stops the
+   *   PID from being cached.
+   */
+  void SetTTL(uint16_t pid, const TimeInterval &ttl);
+
+  /**
+   * @brief Try to answer a request from the cache.
+   * @param universe the id of the universe the request was sent to.
+   * @param request the request.
+   * @param callback the callback for the request. On a miss this may be
+   *   replaced with a callback that stores the response.
+   * @returns true if the request was answered, in which case the callback has
+   *   been run, false if the request should be sent to the devices.
+   *
+   * Requests that change the state of the device invalidate the responses
+   * from that device.
+   */
+  bool ServeRequest(unsigned int universe,
+                    const ola::rdm::RDMRequest *request,
+                    ola::rdm::RDMCallback **callback);
+
+  /**
+   * @brief Remove the cached responses from a UID.
+   */
+  void InvalidateUID(unsigned int universe, const ola::rdm::UID &uid);
+
+  /**
+   * @brief Remove all cached responses for a universe.
+   */
+  void InvalidateUniverse(unsigned int universe);
+
+  /**
+   * @brief Return the number of cached responses.
+   */
+  unsigned int Size() const { return m_entries.size(); }
+
+  static const char K_CACHE_HITS_VAR[];
+  static const char K_CACHE_MISSES_VAR[];
+
+ private:
+  struct CacheKey {
+    unsigned int universe;
+    ola::rdm::UID uid;
+    uint16_t sub_device;
+    uint16_t pid;
+    std::string param_data;
+
+    CacheKey(unsigned int universe, const ola::rdm::RDMRequest &request);
+    // The first key for a UID.
+    CacheKey(unsigned int universe, const ola::rdm::UID &uid);
+
+    bool operator<(const CacheKey &other) const;
+  };
+
+  struct CacheEntry {
+    std::string param_data;
+    TimeStamp expiry;
+  };
+
+  struct PendingRequest {
+    CacheKey key;
+    TimeInterval ttl;
+    unsigned int generation;
+    ola::rdm::RDMCallback *callback;
+
+    PendingRequest(const CacheKey &key, const TimeInterval &ttl,
+                   unsigned int generation,
+                   ola::rdm::RDMCallback *callback)
+        : key(key), ttl(ttl), generation(generation), callback(callback) {}
+  };
+
+  typedef std::map<CacheKey, CacheEntry> EntryMap;
+  typedef std::map<uint16_t, TimeInterval> TTLMap;
+
+  ExportMap *m_export_map;
+  Clock *m_clock;
+  bool m_free_clock;
+  TTLMap m_ttls;
+  EntryMap m_entries;
+  /**
+   * Incremented each time responses are invalidated, so that a response to
+   * a request sent before the invalidation isn't stored.
+   */
+  unsigned int m_generation;
+
+  void HandleReply(PendingRequest *pending, ola::rdm::RDMReply *reply);
+  void Invalidate(unsigned int universe, const ola::rdm::UID *uid);
+  void IncrementVar(const char *var_name, unsigned int universe);
+
+  DISALLOW_COPY_AND_ASSIGN(RDMResponseCache);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_RDMRESPONSECACHE_H_
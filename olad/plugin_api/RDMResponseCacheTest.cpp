@@ -0,0 +1,299 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMResponseCacheTest.cpp
+ * Test fixture for the RDMResponseCache class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/RDMResponseCache.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniverseStore.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::ExportMap;
+using ola::MockClock;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::RDMResponseCache;
+using ola::TimeInterval;
+using ola::Universe;
+using ola::UniverseStore;
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::string;
+
+class RDMResponseCacheTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMResponseCacheTest);
+  CPPUNIT_TEST(testCacheHit);
+  CPPUNIT_TEST(testExpiry);
+  CPPUNIT_TEST(testNotCached);
+  CPPUNIT_TEST(testSetInvalidates);
+  CPPUNIT_TEST(testDiscoveryInvalidates);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  RDMResponseCacheTest()
+      : m_uid(0x7a70, 1),
+        m_source(0x7a70, 100),
+        m_port(NULL, 1, &m_uids, true),
+        m_nack(false),
+        m_requests(0),
+        m_replies(0),
+        m_transaction_number(0) {
+  }
+
+  void setUp();
+  void tearDown();
+
+  void testCacheHit();
+  void testExpiry();
+  void testNotCached();
+  void testSetInvalidates();
+  void testDiscoveryInvalidates();
+
+ private:
+  UID m_uid;
+  UID m_source;
+  UIDSet m_uids;
+  MockClock m_clock;
+  ExportMap m_export_map;
+  TestMockRDMOutputPort m_port;
+  UniverseStore *m_store;
+  RDMResponseCache *m_cache;
+  Universe *m_universe;
+  bool m_nack;
+  unsigned int m_requests;
+  unsigned int m_replies;
+  uint8_t m_transaction_number;
+
+  void HandleRequest(const RDMRequest *request, RDMCallback *callback) {
+    m_requests++;
+    RDMResponse *response;
+    if (m_nack) {
+      response = ola::rdm::NackWithReason(request, ola::rdm::NR_UNKNOWN_PID);
+    } else {
+      response = ola::rdm::GetResponseFromData(
+          request, reinterpret_cast<const uint8_t*>(LABEL), strlen(LABEL));
+    }
+    delete request;
+    RDMReply reply(ola::rdm::RDM_COMPLETED_OK, response);
+    callback->Run(&reply);
+  }
+
+  void CheckReply(uint8_t transaction_number, RDMReply *reply) {
+    m_replies++;
+    OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, reply->StatusCode());
+    const RDMResponse *response = reply->Response();
+    OLA_ASSERT_NOT_NULL(response);
+    OLA_ASSERT_EQ(m_uid, response->SourceUID());
+    OLA_ASSERT_EQ(m_source, response->DestinationUID());
+    OLA_ASSERT_EQ(transaction_number, response->TransactionNumber());
+    if (!m_nack) {
+      OLA_ASSERT_DATA_EQUALS(reinterpret_cast<const uint8_t*>(LABEL),
+                             strlen(LABEL),
+                             response->ParamData(),
+                             response->ParamDataSize());
+    }
+  }
+
+  void SendGet(uint16_t pid) {
+    uint8_t transaction_number = m_transaction_number++;
+    m_universe->SendRDMRequest(
+        new RDMGetRequest(m_source, m_uid, transaction_number, 1, 0, pid,
+                          NULL, 0),
+        NewSingleCallback(this, &RDMResponseCacheTest::CheckReply,
+                          transaction_number));
+  }
+
+  void SendSet(const UID &destination) {
+    m_universe->SendRDMRequest(
+        new RDMSetRequest(m_source, destination, m_transaction_number++, 1, 0,
+                          ola::rdm::PID_DEVICE_LABEL,
+                          reinterpret_cast<const uint8_t*>(LABEL),
+                          strlen(LABEL)),
+        NewSingleCallback(this, &RDMResponseCacheTest::CountReply));
+  }
+
+  void CountReply(RDMReply*) {
+    m_replies++;
+  }
+
+  unsigned int CacheStat(const char *var_name) {
+    return (*m_export_map.GetUIntMapVar(var_name))["1"];
+  }
+
+  static const char LABEL[];
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMResponseCacheTest);
+
+const char RDMResponseCacheTest::LABEL[] = "Open Lighting";
+
+void RDMResponseCacheTest::setUp() {
+  m_uids.AddUID(m_uid);
+  m_port.SetRDMHandler(
+      NewCallback(this, &RDMResponseCacheTest::HandleRequest));
+
+  m_cache = new RDMResponseCache(&m_export_map, &m_clock);
+  m_store = new UniverseStore(NULL, NULL);
+  m_store->SetRDMResponseCache(m_cache);
+  m_universe = m_store->GetUniverseOrCreate(1);
+  OLA_ASSERT(m_universe);
+  m_universe->AddPort(&m_port);
+  m_port.SetUniverse(m_universe);
+  OLA_ASSERT_EQ(1u, m_universe->UIDCount());
+}
+
+
+void RDMResponseCacheTest::tearDown() {
+  m_port.SetUniverse(NULL);
+  delete m_store;
+  delete m_cache;
+}
+
+
+/*
+ * Check a second GET is answered from the cache.
+ */
+void RDMResponseCacheTest::testCacheHit() {
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(1u, m_requests);
+  OLA_ASSERT_EQ(1u, m_replies);
+  OLA_ASSERT_EQ(1u, m_cache->Size());
+
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(1u, m_requests);
+  OLA_ASSERT_EQ(3u, m_replies);
+  OLA_ASSERT_EQ(2u, CacheStat(RDMResponseCache::K_CACHE_HITS_VAR));
+  OLA_ASSERT_EQ(1u, CacheStat(RDMResponseCache::K_CACHE_MISSES_VAR));
+
+  // A different PID is a different entry
+  SendGet(ola::rdm::PID_SOFTWARE_VERSION_LABEL);
+  OLA_ASSERT_EQ(2u, m_requests);
+  OLA_ASSERT_EQ(2u, m_cache->Size());
+}
+
+
+/*
+ * Check entries expire.
+ */
+void RDMResponseCacheTest::testExpiry() {
+  SendGet(ola::rdm::PID_DEVICE_INFO);
+  SendGet(ola::rdm::PID_DEVICE_INFO);
+  OLA_ASSERT_EQ(1u, m_requests);
+
+  m_clock.AdvanceTime(6, 0);
+  SendGet(ola::rdm::PID_DEVICE_INFO);
+  OLA_ASSERT_EQ(2u, m_requests);
+
+  // Removing the TTL stops the PID from being cached
+  m_cache->SetTTL(ola::rdm::PID_MANUFACTURER_LABEL, TimeInterval());
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(4u, m_requests);
+  OLA_ASSERT_EQ(5u, m_replies);
+}
+
+
+/*
+ * Check PIDs without a TTL and NACKs aren't cached.
+ */
+void RDMResponseCacheTest::testNotCached() {
+  SendGet(ola::rdm::PID_DMX_START_ADDRESS);
+  SendGet(ola::rdm::PID_DMX_START_ADDRESS);
+  OLA_ASSERT_EQ(2u, m_requests);
+  OLA_ASSERT_EQ(0u, m_cache->Size());
+
+  m_nack = true;
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(4u, m_requests);
+  OLA_ASSERT_EQ(4u, m_replies);
+  OLA_ASSERT_EQ(0u, m_cache->Size());
+}
+
+
+/*
+ * Check a SET removes the cached responses.
+ */
+void RDMResponseCacheTest::testSetInvalidates() {
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  SendGet(ola::rdm::PID_DEVICE_INFO);
+  OLA_ASSERT_EQ(2u, m_cache->Size());
+
+  // A SET to another UID doesn't change anything
+  m_cache->InvalidateUID(1, UID(0x7a70, 2));
+  OLA_ASSERT_EQ(2u, m_cache->Size());
+
+  SendSet(m_uid);
+  OLA_ASSERT_EQ(0u, m_cache->Size());
+  OLA_ASSERT_EQ(3u, m_requests);
+
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(4u, m_requests);
+  OLA_ASSERT_EQ(1u, m_cache->Size());
+
+  // A broadcast SET clears the universe
+  SendSet(UID::AllDevices());
+  OLA_ASSERT_EQ(0u, m_cache->Size());
+}
+
+
+/*
+ * Check responses are removed when a UID is no longer present.
+ */
+void RDMResponseCacheTest::testDiscoveryInvalidates() {
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(1u, m_cache->Size());
+
+  // Another UID appearing doesn't change anything
+  UIDSet uids(m_uids);
+  uids.AddUID(UID(0x7a70, 2));
+  m_universe->NewUIDList(&m_port, uids);
+  OLA_ASSERT_EQ(1u, m_cache->Size());
+
+  m_universe->NewUIDList(&m_port, UIDSet());
+  OLA_ASSERT_EQ(0u, m_cache->Size());
+
+  m_universe->NewUIDList(&m_port, m_uids);
+  SendGet(ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(1u, m_cache->Size());
+
+  // Removing the port removes the routes
+  m_universe->RemovePort(&m_port);
+  OLA_ASSERT_EQ(0u, m_cache->Size());
+  OLA_ASSERT_EQ(2u, m_requests);
+}
@@ -0,0 +1,134 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SlotSubscriptions.cpp
+ * Sends the changes to individual slots of a universe to clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/SlotSubscriptions.h"
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "common/protocol/Ola.pb.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/plugin_api/Client.h"
+
+namespace ola {
+
+using std::string;
+using std::vector;
+
+SlotSubscriptions::SlotSubscriptions(unsigned int universe_id,
+                                     const DmxBuffer &current)
+    : m_universe_id(universe_id),
+      m_last_size(0) {
+  SetFrame(current);
+}
+
+SlotSubscriptions::~SlotSubscriptions() {
+  STLDeleteValues(&m_subscribers);
+}
+
+void SlotSubscriptions::Subscribe(Client *client,
+                                  const vector<Universe::SlotRange> &ranges,
+                                  const DmxBuffer &current) {
+  Subscriber *subscriber = STLFindOrNull(m_subscribers, client);
+  if (!subscriber) {
+    subscriber = new Subscriber();
+    m_subscribers[client] = subscriber;
+  }
+  subscriber->ranges = ranges;
+
+  // Send the current values, so the client has a starting point.
+  ola::proto::SlotChanges message;
+  message.set_universe(m_universe_id);
+  string *values = message.mutable_value();
+  vector<Universe::SlotRange>::const_iterator iter = ranges.begin();
+  for (; iter != ranges.end(); ++iter) {
+    for (unsigned int slot = iter->start;
+         slot < iter->start + iter->count; slot++) {
+      const uint8_t value = slot < current.Size() ? current.Get(slot) : 0;
+      subscriber->last_sent[slot] = value;
+      message.add_slot(slot);
+      values->push_back(value);
+    }
+  }
+  client->SendSlotChanges(message);
+}
+
+bool SlotSubscriptions::Unsubscribe(Client *client) {
+  return STLRemoveAndDelete(&m_subscribers, client);
+}
+
+void SlotSubscriptions::Update(const DmxBuffer &buffer) {
+  const unsigned int size = buffer.Size();
+  if (size == m_last_size && !memcmp(buffer.GetRaw(), m_last_frame, size)) {
+    return;
+  }
+
+  // Diff the frame once, for all subscribers.
+  m_changed.clear();
+  const uint8_t *data = buffer.GetRaw();
+  const unsigned int length = std::max(size, m_last_size);
+  for (unsigned int slot = 0; slot < length; slot++) {
+    const uint8_t value = slot < size ? data[slot] : 0;
+    if (value != m_last_frame[slot]) {
+      m_changed.push_back(slot);
+      m_last_frame[slot] = value;
+    }
+  }
+  m_last_size = size;
+
+  ola::proto::SlotChanges message;
+  SubscriberMap::iterator iter = m_subscribers.begin();
+  for (; iter != m_subscribers.end(); ++iter) {
+    Subscriber *subscriber = iter->second;
+    message.Clear();
+    string *values = message.mutable_value();
+
+    vector<Universe::SlotRange>::const_iterator range =
+        subscriber->ranges.begin();
+    for (; range != subscriber->ranges.end(); ++range) {
+      const unsigned int end = range->start + range->count;
+      vector<uint16_t>::const_iterator changed = std::lower_bound(
+          m_changed.begin(), m_changed.end(), range->start);
+      for (; changed != m_changed.end() && *changed < end; ++changed) {
+        const uint8_t value = m_last_frame[*changed];
+        const uint8_t last = subscriber->last_sent[*changed];
+        const unsigned int delta = value > last ? value - last : last - value;
+        if (delta >= range->threshold) {
+          subscriber->last_sent[*changed] = value;
+          message.add_slot(*changed);
+          values->push_back(value);
+        }
+      }
+    }
+
+    if (message.slot_size()) {
+      message.set_universe(m_universe_id);
+      iter->first->SendSlotChanges(message);
+    }
+  }
+}
+
+void SlotSubscriptions::SetFrame(const DmxBuffer &buffer) {
+  memset(m_last_frame, 0, sizeof(m_last_frame));
+  m_last_size = buffer.Size();
+  buffer.GetRange(0, m_last_frame, &m_last_size);
+}
+}  // namespace ola
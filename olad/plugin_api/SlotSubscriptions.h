@@ -0,0 +1,104 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SlotSubscriptions.h
+ * Sends the changes to individual slots of a universe to clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_SLOTSUBSCRIPTIONS_H_
+#define OLAD_PLUGIN_API_SLOTSUBSCRIPTIONS_H_
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "olad/Universe.h"
+
+namespace ola {
+
+class Client;
+
+/**
+ * @brief Tracks the clients watching slots of a universe.
+ *
+ * Each client subscribes to a set of slot ranges, each with a threshold. On
+ * every update the new frame is compared with the previous one once, and the
+ * changed slots are then matched against each client's ranges. A change is
+ * sent once a slot differs from the last value sent to that client by at
+ * least the range's threshold, so small changes aren't lost, they're sent
+ * once they add up.
+ */
+class SlotSubscriptions {
+ public:
+  /**
+   * @brief Create a new SlotSubscriptions.
+   * @param universe_id the universe, used in the messages sent to clients.
+   * @param current the current data for the universe.
+   */
+  SlotSubscriptions(unsigned int universe_id, const DmxBuffer &current);
+  ~SlotSubscriptions();
+
+  /**
+   * @brief Add a client, or replace the ranges of an existing one.
+   * @param client the client to send changes to.
+   * @param ranges the slots to watch.
+   * @param current the current data for the universe.
+   *
+   * The current values of the slots are sent to the client straight away.
+   */
+  void Subscribe(Client *client,
+                 const std::vector<Universe::SlotRange> &ranges,
+                 const DmxBuffer &current);
+
+  /**
+   * @brief Remove a client.
+   * @returns true if the client was subscribed.
+   */
+  bool Unsubscribe(Client *client);
+
+  bool Empty() const { return m_subscribers.empty(); }
+  unsigned int SubscriberCount() const { return m_subscribers.size(); }
+
+  /**
+   * @brief Called when the universe's data changes.
+   * @param buffer the new data.
+   */
+  void Update(const DmxBuffer &buffer);
+
+ private:
+  struct Subscriber {
+    std::vector<Universe::SlotRange> ranges;
+    uint8_t last_sent[DMX_UNIVERSE_SIZE];
+  };
+
+  typedef std::map<Client*, Subscriber*> SubscriberMap;
+
+  const unsigned int m_universe_id;
+  SubscriberMap m_subscribers;
+  uint8_t m_last_frame[DMX_UNIVERSE_SIZE];
+  unsigned int m_last_size;
+  // The slots which changed in the current update, in order.
+  std::vector<uint16_t> m_changed;
+
+  void SetFrame(const DmxBuffer &buffer);
+
+  DISALLOW_COPY_AND_ASSIGN(SlotSubscriptions);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_SLOTSUBSCRIPTIONS_H_
@@ -0,0 +1,200 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SlotSubscriptionsTest.cpp
+ * Test fixture for the SlotSubscriptions class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+#include "common/protocol/Ola.pb.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/StringUtils.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/SlotSubscriptions.h"
+
+using ola::DmxBuffer;
+using ola::SlotSubscriptions;
+using ola::Universe;
+using ola::rdm::UID;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * A client which records the changes it's sent.
+ */
+class SlotClient: public ola::Client {
+ public:
+  SlotClient() : ola::Client(NULL, UID(ola::OPEN_LIGHTING_ESTA_CODE, 0)) {}
+
+  void SendSlotChanges(const ola::proto::SlotChanges &changes) {
+    messages.push_back(changes);
+  }
+
+  // Return the last message as slot:value pairs.
+  string LastChanges() const {
+    if (messages.empty()) {
+      return "";
+    }
+    const ola::proto::SlotChanges &changes = messages.back();
+    string output;
+    for (int i = 0; i < changes.slot_size(); i++) {
+      if (i) {
+        output.append(",");
+      }
+      output.append(ola::IntToString(changes.slot(i)) + ":" +
+                    ola::IntToString(
+                        static_cast<uint8_t>(changes.value()[i])));
+    }
+    return output;
+  }
+
+  vector<ola::proto::SlotChanges> messages;
+};
+
+Universe::SlotRange Range(uint16_t start, uint16_t count,
+                          uint8_t threshold = 1) {
+  Universe::SlotRange range;
+  range.start = start;
+  range.count = count;
+  range.threshold = threshold;
+  return range;
+}
+}  // namespace
+
+
+class SlotSubscriptionsTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SlotSubscriptionsTest);
+  CPPUNIT_TEST(testSubscribe);
+  CPPUNIT_TEST(testUpdate);
+  CPPUNIT_TEST(testThreshold);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testSubscribe();
+    void testUpdate();
+    void testThreshold();
+
+ private:
+    static const unsigned int UNIVERSE_ID = 3;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SlotSubscriptionsTest);
+
+
+/*
+ * Check the current values are sent when a client subscribes.
+ */
+void SlotSubscriptionsTest::testSubscribe() {
+  DmxBuffer data;
+  data.SetFromString("1,2,3,4");
+  SlotSubscriptions subscriptions(UNIVERSE_ID, data);
+  OLA_ASSERT_TRUE(subscriptions.Empty());
+
+  SlotClient client;
+  vector<Universe::SlotRange> ranges;
+  ranges.push_back(Range(1, 2));
+  ranges.push_back(Range(3, 3));
+  subscriptions.Subscribe(&client, ranges, data);
+  OLA_ASSERT_EQ(1u, subscriptions.SubscriberCount());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client.messages.size());
+  OLA_ASSERT_EQ(static_cast<int>(UNIVERSE_ID),
+                client.messages[0].universe());
+  OLA_ASSERT_EQ(string("1:2,2:3,3:4,4:0,5:0"), client.LastChanges());
+
+  // Nothing is sent if the data doesn't change.
+  subscriptions.Update(data);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client.messages.size());
+
+  OLA_ASSERT_TRUE(subscriptions.Unsubscribe(&client));
+  OLA_ASSERT_FALSE(subscriptions.Unsubscribe(&client));
+  OLA_ASSERT_TRUE(subscriptions.Empty());
+}
+
+
+/*
+ * Check each client is only sent the changes in its ranges.
+ */
+void SlotSubscriptionsTest::testUpdate() {
+  DmxBuffer data;
+  data.SetFromString("0,0,0,0,0,0");
+  SlotSubscriptions subscriptions(UNIVERSE_ID, data);
+
+  SlotClient client1, client2;
+  subscriptions.Subscribe(&client1, vector<Universe::SlotRange>(
+      1, Range(0, 2)), data);
+  subscriptions.Subscribe(&client2, vector<Universe::SlotRange>(
+      1, Range(4, 100)), data);
+
+  data.SetFromString("10,0,20,0,30,40");
+  subscriptions.Update(data);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), client1.messages.size());
+  OLA_ASSERT_EQ(string("0:10"), client1.LastChanges());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), client2.messages.size());
+  OLA_ASSERT_EQ(string("4:30,5:40"), client2.LastChanges());
+
+  // Only client2 is watching slot 6, and a shorter frame sets the missing
+  // slots to 0.
+  data.SetFromString("10,0,20,0,30,40,50");
+  subscriptions.Update(data);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), client1.messages.size());
+  OLA_ASSERT_EQ(string("6:50"), client2.LastChanges());
+
+  data.SetFromString("10,0,20,0,30");
+  subscriptions.Update(data);
+  OLA_ASSERT_EQ(string("5:0,6:0"), client2.LastChanges());
+
+  // Subscribing again replaces the ranges.
+  subscriptions.Subscribe(&client1, vector<Universe::SlotRange>(
+      1, Range(2, 1)), data);
+  OLA_ASSERT_EQ(string("2:20"), client1.LastChanges());
+  data.SetFromString("11,0,21");
+  subscriptions.Update(data);
+  OLA_ASSERT_EQ(string("2:21"), client1.LastChanges());
+}
+
+
+/*
+ * Check small changes are held back until they reach the threshold.
+ */
+void SlotSubscriptionsTest::testThreshold() {
+  DmxBuffer data;
+  data.SetFromString("100");
+  SlotSubscriptions subscriptions(UNIVERSE_ID, data);
+
+  SlotClient client;
+  subscriptions.Subscribe(&client, vector<Universe::SlotRange>(
+      1, Range(0, 1, 5)), data);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), client.messages.size());
+
+  const char *steps[] = {"102", "104", "105", "101", "100"};
+  const size_t expected_messages[] = {1, 1, 2, 2, 3};
+  for (unsigned int i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+    data.SetFromString(steps[i]);
+    subscriptions.Update(data);
+    OLA_ASSERT_EQ(expected_messages[i], client.messages.size());
+  }
+  OLA_ASSERT_EQ(string("0:100"), client.LastChanges());
+}
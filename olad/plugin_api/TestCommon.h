@@ -21,15 +21,20 @@
 #ifndef OLAD_PLUGIN_API_TESTCOMMON_H_
 #define OLAD_PLUGIN_API_TESTCOMMON_H_
 #include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/UIDSet.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "olad/Device.h"
 #include "olad/Plugin.h"
 #include "olad/Port.h"
@@ -78,11 +83,20 @@ class TestMockPriorityInputPort: public TestMockInputPort {
     m_inherited_priority = priority;
   }
 
+  const ola::DmxBuffer *InheritedSlotPriorities() const {
+    return m_slot_priorities.Size() ? &m_slot_priorities : NULL;
+  }
+
+  void SetInheritedSlotPriorities(const ola::DmxBuffer &slot_priorities) {
+    m_slot_priorities = slot_priorities;
+  }
+
  protected:
   bool SupportsPriorities() const { return true; }
 
  private:
   uint8_t m_inherited_priority;
+  ola::DmxBuffer m_slot_priorities;
 };
 
 
@@ -340,4 +354,81 @@ class MockSelectServer: public ola::io::SelectServerInterface {
  private:
   const ola::TimeStamp *m_wake_up;
 };
+
+/**
+ * A SchedulerInterface that lets the test run the timeouts.
+ */
+class MockScheduler: public ola::thread::SchedulerInterface {
+ public:
+  MockScheduler() : m_next_id(1) {}
+  ~MockScheduler() {
+    TimeoutMap::iterator iter = m_timeouts.begin();
+    for (; iter != m_timeouts.end(); ++iter) {
+      delete iter->second.second;
+    }
+  }
+
+  ola::thread::timeout_id RegisterRepeatingTimeout(unsigned int,
+                                                   ola::Callback0<bool>*) {
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  ola::thread::timeout_id RegisterRepeatingTimeout(const ola::TimeInterval&,
+                                                   ola::Callback0<bool>*) {
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  ola::thread::timeout_id RegisterSingleTimeout(
+      unsigned int delay,
+      ola::SingleUseCallback0<void> *callback) {
+    return RegisterSingleTimeout(ola::TimeInterval(delay * 1000), callback);
+  }
+
+  ola::thread::timeout_id RegisterSingleTimeout(
+      const ola::TimeInterval &delay,
+      ola::SingleUseCallback0<void> *callback) {
+    ola::thread::timeout_id id =
+        reinterpret_cast<ola::thread::timeout_id>(m_next_id++);
+    m_timeouts[id] = std::make_pair(delay, callback);
+    return id;
+  }
+
+  void RemoveTimeout(ola::thread::timeout_id id) {
+    TimeoutMap::iterator iter = m_timeouts.find(id);
+    if (iter != m_timeouts.end()) {
+      delete iter->second.second;
+      m_timeouts.erase(iter);
+    }
+  }
+
+  unsigned int TimeoutCount() const { return m_timeouts.size(); }
+
+  /**
+   * Return the delay of the only pending timeout.
+   */
+  ola::TimeInterval Delay() const {
+    return m_timeouts.empty() ? ola::TimeInterval() :
+                                m_timeouts.begin()->second.first;
+  }
+
+  /**
+   * Run all the pending timeouts.
+   */
+  void RunTimeouts() {
+    TimeoutMap timeouts;
+    timeouts.swap(m_timeouts);
+    TimeoutMap::iterator iter = timeouts.begin();
+    for (; iter != timeouts.end(); ++iter) {
+      iter->second.second->Run();
+    }
+  }
+
+ private:
+  typedef std::map<ola::thread::timeout_id,
+                   std::pair<ola::TimeInterval,
+                             ola::SingleUseCallback0<void>*> > TimeoutMap;
+
+  uintptr_t m_next_id;
+  TimeoutMap m_timeouts;
+};
 #endif  // OLAD_PLUGIN_API_TESTCOMMON_H_
@@ -0,0 +1,232 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimeCodeScheduler.cpp
+ * Generates timecode locally, between the updates from clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/TimeCodeScheduler.h"
+
+#include <algorithm>
+
+#include "ola/Callback.h"
+#include "ola/timecode/TimeCodeEnums.h"
+
+namespace ola {
+
+using ola::thread::INVALID_TIMEOUT;
+using ola::timecode::TimeCode;
+using ola::timecode::TimeCodeType;
+
+const char TimeCodeScheduler::K_TIMECODE_FRAMES_VAR[] = "timecode-frames";
+const char TimeCodeScheduler::K_TIMECODE_GENERATED_VAR[] =
+    "timecode-frames-generated";
+const char TimeCodeScheduler::K_TIMECODE_MAX_JITTER_VAR[] =
+    "timecode-jitter-max-us";
+const char TimeCodeScheduler::K_TIMECODE_MEAN_JITTER_VAR[] =
+    "timecode-jitter-mean-us";
+
+TimeCodeScheduler::TimeCodeScheduler(
+    ola::thread::SchedulerInterface *scheduler,
+    OutputCallback *output,
+    ExportMap *export_map,
+    Clock *clock)
+    : m_scheduler(scheduler),
+      m_output(output),
+      m_export_map(export_map),
+      m_clock(clock),
+      m_free_clock(false),
+      m_freewheel(DEFAULT_FREEWHEEL_MS * ONE_THOUSAND),
+      m_last_frame(ola::timecode::TIMECODE_SMPTE, 0, 0, 0, 0),
+      m_frames_generated(0),
+      m_timeout(INVALID_TIMEOUT),
+      m_frames_sent(0),
+      m_jitter_samples(0),
+      m_total_jitter(0),
+      m_max_jitter(0) {
+  if (!m_clock) {
+    m_clock = new Clock();
+    m_free_clock = true;
+  }
+  if (m_export_map) {
+    m_export_map->GetCounterVar(K_TIMECODE_FRAMES_VAR);
+    m_export_map->GetCounterVar(K_TIMECODE_GENERATED_VAR);
+    m_export_map->GetIntegerVar(K_TIMECODE_MAX_JITTER_VAR);
+    m_export_map->GetIntegerVar(K_TIMECODE_MEAN_JITTER_VAR);
+  }
+}
+
+
+TimeCodeScheduler::~TimeCodeScheduler() {
+  CancelTimeout();
+  if (m_free_clock) {
+    delete m_clock;
+  }
+}
+
+
+void TimeCodeScheduler::SetReference(const TimeCode &timecode) {
+  bool resend = true;
+  if (Running()) {
+    TimeCode next(timecode);
+    if (++next == m_last_frame) {
+      // The client is slightly behind us, don't step backwards.
+      return;
+    }
+    // If the client sent the frame we just generated, only realign the clock.
+    resend = timecode != m_last_frame;
+  }
+  CancelTimeout();
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  m_reference_time = now;
+  m_frames_generated = 0;
+  m_last_frame = timecode;
+  if (resend) {
+    SendFrame();
+  }
+  ArmTimeout(now);
+}
+
+
+void TimeCodeScheduler::Stop() {
+  CancelTimeout();
+}
+
+
+bool TimeCodeScheduler::Running() const {
+  return m_timeout != INVALID_TIMEOUT;
+}
+
+
+TimeInterval TimeCodeScheduler::MeanJitter() const {
+  if (!m_jitter_samples) {
+    return TimeInterval();
+  }
+  return TimeInterval(m_total_jitter / m_jitter_samples);
+}
+
+
+TimeInterval TimeCodeScheduler::FrameInterval(TimeCodeType type) {
+  return TimeInterval(FrameOffset(type, 1));
+}
+
+
+/*
+ * Schedule the next frame, unless we've reached the end of the freewheel
+ * time.
+ */
+void TimeCodeScheduler::ArmTimeout(const TimeStamp &now) {
+  const TimeStamp due = FrameTime(m_frames_generated + 1);
+  if (due - m_reference_time > m_freewheel) {
+    return;
+  }
+
+  TimeInterval delay;
+  if (due > now) {
+    delay = due - now;
+  }
+  m_timeout = m_scheduler->RegisterSingleTimeout(
+      delay,
+      NewSingleCallback(this, &TimeCodeScheduler::SendNextFrame));
+}
+
+
+/*
+ * Return the time a frame is due, counting from the reference.
+ */
+TimeStamp TimeCodeScheduler::FrameTime(uint64_t frame) const {
+  return m_reference_time +
+         TimeInterval(FrameOffset(m_last_frame.Type(), frame));
+}
+
+
+/*
+ * Called when the timeout fires, this sends the frame that's now due.
+ */
+void TimeCodeScheduler::SendNextFrame() {
+  m_timeout = INVALID_TIMEOUT;
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  m_frames_generated++;
+  ++m_last_frame;
+  while (FrameTime(m_frames_generated + 1) <= now) {
+    m_frames_generated++;
+    ++m_last_frame;
+  }
+
+  const TimeStamp due = FrameTime(m_frames_generated);
+  RecordJitter(now > due ? now - due : TimeInterval());
+  if (m_export_map) {
+    (*m_export_map->GetCounterVar(K_TIMECODE_GENERATED_VAR))++;
+  }
+  SendFrame();
+  ArmTimeout(now);
+}
+
+
+void TimeCodeScheduler::SendFrame() {
+  m_frames_sent++;
+  if (m_export_map) {
+    (*m_export_map->GetCounterVar(K_TIMECODE_FRAMES_VAR))++;
+  }
+  m_output->Run(m_last_frame);
+}
+
+
+void TimeCodeScheduler::RecordJitter(const TimeInterval &jitter) {
+  const int64_t usecs = jitter.AsInt();
+  m_jitter_samples++;
+  m_total_jitter += usecs;
+  m_max_jitter = std::max(m_max_jitter, usecs);
+  if (m_export_map) {
+    m_export_map->GetIntegerVar(K_TIMECODE_MAX_JITTER_VAR)->Set(m_max_jitter);
+    m_export_map->GetIntegerVar(K_TIMECODE_MEAN_JITTER_VAR)->Set(
+        MeanJitter().AsInt());
+  }
+}
+
+
+void TimeCodeScheduler::CancelTimeout() {
+  if (m_timeout != INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_timeout);
+    m_timeout = INVALID_TIMEOUT;
+  }
+}
+
+
+/*
+ * Return the time from the start of the first frame to the start of the n-th
+ * frame, in microseconds. Drop frame timecode runs at 30000 / 1001 fps.
+ */
+int64_t TimeCodeScheduler::FrameOffset(TimeCodeType type, uint64_t frame) {
+  const int64_t usecs = frame * USEC_IN_SECONDS;
+  switch (type) {
+    case ola::timecode::TIMECODE_FILM:
+      return usecs / 24;
+    case ola::timecode::TIMECODE_EBU:
+      return usecs / 25;
+    case ola::timecode::TIMECODE_DF:
+      return usecs * 1001 / 30000;
+    case ola::timecode::TIMECODE_SMPTE:
+      return usecs / 30;
+  }
+  return usecs / 30;
+}
+}  // namespace ola
@@ -0,0 +1,168 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimeCodeScheduler.h
+ * Generates timecode locally, between the updates from clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_TIMECODESCHEDULER_H_
+#define OLAD_PLUGIN_API_TIMECODESCHEDULER_H_
+
+#include <stdint.h>
+#include <memory>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "ola/timecode/TimeCode.h"
+
+namespace ola {
+
+/**
+ * @brief Sends timecode to the output ports on a local frame clock.
+ *
+ * Without the scheduler, each timecode message from a client is sent to the
+ * ports as it arrives, so any delay in the client, the RPC layer or the main
+ * loop shows up as jitter on the wire.
+ *
+ * Instead, each message from a client sets the reference timecode. The
+ * scheduler sends the reference, then generates the following frames itself
+ * at the rate for the timecode type. Each frame is due at a fixed offset from
+ * the time the reference arrived, so timer latency doesn't accumulate. If
+ * the client sends the frame that was just generated, the frame clock is
+ * realigned to the client but the frame isn't sent again. If it sends the
+ * frame before that, it's ignored. If the main loop falls more than a frame
+ * behind, the missed frames are skipped.
+ *
+ * Once the client has been quiet for the freewheel time, the scheduler stops
+ * generating frames.
+ *
+ * The difference between when each generated frame was due and when it was
+ * sent is recorded in the ExportMap.
+ */
+class TimeCodeScheduler {
+ public:
+  typedef ola::Callback1<void, const ola::timecode::TimeCode&> OutputCallback;
+
+  /**
+   * @brief Create a new TimeCodeScheduler.
+   * @param scheduler the SchedulerInterface used to run the frame clock.
+   * @param output the callback that sends a frame to the ports, ownership is
+   *   transferred.
+   * @param export_map the ExportMap to use for the statistics, may be NULL.
+   * @param clock the Clock to use, if NULL a Clock is created.
+   */
+  TimeCodeScheduler(ola::thread::SchedulerInterface *scheduler,
+                    OutputCallback *output,
+                    ExportMap *export_map,
+                    Clock *clock = NULL);
+
+  /**
+   * @brief Destructor.
+   */
+  ~TimeCodeScheduler();
+
+  /**
+   * @brief Set how long to keep generating frames after the last reference.
+   * @param freewheel the freewheel time.
+   */
+  void SetFreewheelTime(const TimeInterval &freewheel) {
+    m_freewheel = freewheel;
+  }
+
+  /**
+   * @brief Called when a client sends timecode.
+   * @param timecode the new reference, this must be valid.
+   */
+  void SetReference(const ola::timecode::TimeCode &timecode);
+
+  /**
+   * @brief Stop generating frames.
+   */
+  void Stop();
+
+  /**
+   * @brief Check if frames are being generated.
+   */
+  bool Running() const;
+
+  /**
+   * @brief The last frame that was sent.
+   */
+  const ola::timecode::TimeCode &LastFrame() const { return m_last_frame; }
+
+  /**
+   * @brief The number of frames sent, including the references.
+   */
+  unsigned int FramesSent() const { return m_frames_sent; }
+
+  /**
+   * @brief The largest delay sending a generated frame.
+   */
+  TimeInterval MaxJitter() const { return TimeInterval(m_max_jitter); }
+
+  /**
+   * @brief The mean delay sending a generated frame.
+   */
+  TimeInterval MeanJitter() const;
+
+  /**
+   * @brief Return the time between two frames of a timecode type.
+   */
+  static TimeInterval FrameInterval(ola::timecode::TimeCodeType type);
+
+  static const char K_TIMECODE_FRAMES_VAR[];
+  static const char K_TIMECODE_GENERATED_VAR[];
+  static const char K_TIMECODE_MAX_JITTER_VAR[];
+  static const char K_TIMECODE_MEAN_JITTER_VAR[];
+
+  static const unsigned int DEFAULT_FREEWHEEL_MS = 500;
+
+ private:
+  ola::thread::SchedulerInterface *m_scheduler;
+  std::auto_ptr<OutputCallback> m_output;
+  ExportMap *m_export_map;
+  Clock *m_clock;
+  bool m_free_clock;
+  TimeInterval m_freewheel;
+
+  ola::timecode::TimeCode m_last_frame;
+  // The time the reference arrived, and the frames generated since then.
+  TimeStamp m_reference_time;
+  uint64_t m_frames_generated;
+  ola::thread::timeout_id m_timeout;
+
+  unsigned int m_frames_sent;
+  unsigned int m_jitter_samples;
+  int64_t m_total_jitter;
+  int64_t m_max_jitter;
+
+  void ArmTimeout(const TimeStamp &now);
+  TimeStamp FrameTime(uint64_t frame) const;
+  void SendNextFrame();
+  void SendFrame();
+  void RecordJitter(const TimeInterval &jitter);
+  void CancelTimeout();
+
+  static int64_t FrameOffset(ola::timecode::TimeCodeType type,
+                             uint64_t frame);
+
+  DISALLOW_COPY_AND_ASSIGN(TimeCodeScheduler);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_TIMECODESCHEDULER_H_
@@ -0,0 +1,217 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimeCodeSchedulerTest.cpp
+ * Test fixture for the TimeCodeScheduler class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/timecode/TimeCode.h"
+#include "ola/timecode/TimeCodeEnums.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/TimeCodeScheduler.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::ExportMap;
+using ola::MockClock;
+using ola::TimeCodeScheduler;
+using ola::TimeInterval;
+using ola::timecode::TimeCode;
+using std::vector;
+
+class TimeCodeSchedulerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TimeCodeSchedulerTest);
+  CPPUNIT_TEST(testFrameInterval);
+  CPPUNIT_TEST(testExtrapolation);
+  CPPUNIT_TEST(testClientUpdates);
+  CPPUNIT_TEST(testJitter);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+  void testFrameInterval();
+  void testExtrapolation();
+  void testClientUpdates();
+  void testJitter();
+
+ private:
+  ExportMap m_export_map;
+  MockClock m_clock;
+  MockScheduler m_scheduler;
+  TimeCodeScheduler *m_timecode_scheduler;
+  vector<TimeCode> m_frames;
+
+  void RecordFrame(const TimeCode &timecode) {
+    m_frames.push_back(timecode);
+  }
+
+  /*
+   * The MockClock keeps running, so allow a little slack.
+   */
+  void CheckNear(int64_t expected, int64_t actual) {
+    OLA_ASSERT_TRUE(actual > expected - SLACK);
+    OLA_ASSERT_TRUE(actual < expected + SLACK);
+  }
+
+  static const int64_t SLACK = 500;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimeCodeSchedulerTest);
+
+void TimeCodeSchedulerTest::setUp() {
+  m_frames.clear();
+  m_timecode_scheduler = new TimeCodeScheduler(
+      &m_scheduler,
+      ola::NewCallback(this, &TimeCodeSchedulerTest::RecordFrame),
+      &m_export_map,
+      &m_clock);
+}
+
+void TimeCodeSchedulerTest::tearDown() {
+  delete m_timecode_scheduler;
+}
+
+
+/*
+ * Check the frame intervals for each type.
+ */
+void TimeCodeSchedulerTest::testFrameInterval() {
+  OLA_ASSERT_EQ(TimeInterval(0, 41666),
+                TimeCodeScheduler::FrameInterval(ola::timecode::TIMECODE_FILM));
+  OLA_ASSERT_EQ(TimeInterval(0, 40000),
+                TimeCodeScheduler::FrameInterval(ola::timecode::TIMECODE_EBU));
+  OLA_ASSERT_EQ(TimeInterval(0, 33366),
+                TimeCodeScheduler::FrameInterval(ola::timecode::TIMECODE_DF));
+  OLA_ASSERT_EQ(
+      TimeInterval(0, 33333),
+      TimeCodeScheduler::FrameInterval(ola::timecode::TIMECODE_SMPTE));
+}
+
+
+/*
+ * Check frames are generated after a reference, until the freewheel time.
+ */
+void TimeCodeSchedulerTest::testExtrapolation() {
+  m_timecode_scheduler->SetFreewheelTime(TimeInterval(0, 100000));
+
+  TimeCode reference(ola::timecode::TIMECODE_EBU, 1, 2, 3, 23);
+  m_timecode_scheduler->SetReference(reference);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_EQ(reference, m_frames[0]);
+  OLA_ASSERT_TRUE(m_timecode_scheduler->Running());
+  CheckNear(40000, m_scheduler.Delay().AsInt());
+
+  m_clock.AdvanceTime(0, 40000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_EBU, 1, 2, 3, 24),
+                m_frames[1]);
+  CheckNear(40000, m_scheduler.Delay().AsInt());
+
+  m_clock.AdvanceTime(0, 40000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_frames.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_EBU, 1, 2, 4, 0),
+                m_frames[2]);
+
+  // The next frame would be past the freewheel time.
+  OLA_ASSERT_FALSE(m_timecode_scheduler->Running());
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(3u, m_timecode_scheduler->FramesSent());
+  OLA_ASSERT_EQ(
+      3u,
+      m_export_map.GetCounterVar(TimeCodeScheduler::K_TIMECODE_FRAMES_VAR)->
+      Get());
+  OLA_ASSERT_EQ(
+      2u,
+      m_export_map.GetCounterVar(TimeCodeScheduler::K_TIMECODE_GENERATED_VAR)->
+      Get());
+}
+
+
+/*
+ * Check that client updates realign the clock without duplicate frames.
+ */
+void TimeCodeSchedulerTest::testClientUpdates() {
+  TimeCode reference(ola::timecode::TIMECODE_SMPTE, 0, 0, 0, 0);
+  m_timecode_scheduler->SetReference(reference);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+
+  m_clock.AdvanceTime(0, 33333);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+
+  // The client sends the frame we just generated, a little late.
+  TimeCode next(ola::timecode::TIMECODE_SMPTE, 0, 0, 0, 1);
+  m_clock.AdvanceTime(0, 2000);
+  m_timecode_scheduler->SetReference(next);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  CheckNear(33333, m_scheduler.Delay().AsInt());
+
+  // The client is behind us, this is ignored.
+  m_timecode_scheduler->SetReference(reference);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  OLA_ASSERT_EQ(next, m_timecode_scheduler->LastFrame());
+
+  // A jump is sent right away.
+  TimeCode jump(ola::timecode::TIMECODE_SMPTE, 0, 10, 0, 0);
+  m_timecode_scheduler->SetReference(jump);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_frames.size());
+  OLA_ASSERT_EQ(jump, m_frames[2]);
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+
+  m_timecode_scheduler->Stop();
+  OLA_ASSERT_FALSE(m_timecode_scheduler->Running());
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+}
+
+
+/*
+ * Check late timeouts are recorded, and missed frames are skipped.
+ */
+void TimeCodeSchedulerTest::testJitter() {
+  TimeCode reference(ola::timecode::TIMECODE_EBU, 0, 0, 0, 0);
+  m_timecode_scheduler->SetReference(reference);
+
+  m_clock.AdvanceTime(0, 41000);
+  m_scheduler.RunTimeouts();
+  CheckNear(1000, m_timecode_scheduler->MaxJitter().AsInt());
+  // The next frame is still due 80ms after the reference.
+  CheckNear(39000, m_scheduler.Delay().AsInt());
+
+  m_clock.AdvanceTime(0, 42000);
+  m_scheduler.RunTimeouts();
+  CheckNear(3000, m_timecode_scheduler->MaxJitter().AsInt());
+  CheckNear(2000, m_timecode_scheduler->MeanJitter().AsInt());
+  CheckNear(3000, m_export_map.GetIntegerVar(
+      TimeCodeScheduler::K_TIMECODE_MAX_JITTER_VAR)->Get());
+
+  // Stall for more than two frames, frame 3 is skipped.
+  m_clock.AdvanceTime(0, 80000);
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_frames.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_EBU, 0, 0, 0, 4),
+                m_frames[3]);
+  CheckNear(3000, m_timecode_scheduler->MaxJitter().AsInt());
+}
@@ -0,0 +1,103 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UDPReceivePreferences.cpp
+ * Preferences shared by the plugins that receive UDP.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <set>
+#include <string>
+
+#include "ola/StringUtils.h"
+#include "ola/network/UDPReceiveStats.h"
+#include "olad/Preferences.h"
+#include "olad/UDPReceivePreferences.h"
+
+namespace ola {
+
+namespace {
+
+const char UDP_TIMESTAMPS_KEY[] = "udp_timestamps";
+const char UDP_MIN_RECV_BUFFER_KEY[] = "udp_min_recv_buffer";
+const char UDP_MAX_RECV_BUFFER_KEY[] = "udp_max_recv_buffer";
+const char NETWORK_ENGINE_KEY[] = "network_engine";
+const char XDP_QUEUE_KEY[] = "xdp_queue";
+const char SOCKET_ENGINE[] = "socket";
+const char XDP_ENGINE[] = "xdp";
+// 64MB, well above the default net.core.rmem_max.
+const unsigned int MAX_RECV_BUFFER = 1 << 26;
+
+unsigned int ReadBufferSize(const Preferences &preferences,
+                            const std::string &key) {
+  unsigned int size;
+  if (!StringToInt(preferences.GetValue(key), &size)) {
+    return 0;
+  }
+  return size;
+}
+}  // namespace
+
+bool SetDefaultUDPReceivePreferences(Preferences *preferences) {
+  bool save = false;
+  save |= preferences->SetDefaultValue(UDP_TIMESTAMPS_KEY, BoolValidator(),
+                                       false);
+  save |= preferences->SetDefaultValue(UDP_MIN_RECV_BUFFER_KEY,
+                                       UIntValidator(0, MAX_RECV_BUFFER), 0);
+  save |= preferences->SetDefaultValue(UDP_MAX_RECV_BUFFER_KEY,
+                                       UIntValidator(0, MAX_RECV_BUFFER), 0);
+  return save;
+}
+
+
+void ReadUDPReceivePreferences(const Preferences &preferences,
+                               ExportMap *export_map,
+                               const std::string &export_key,
+                               ola::network::UDPReceiveOptions *options) {
+  options->timestamps = preferences.GetValueAsBool(UDP_TIMESTAMPS_KEY);
+  options->min_recv_buffer = ReadBufferSize(preferences,
+                                            UDP_MIN_RECV_BUFFER_KEY);
+  options->max_recv_buffer = ReadBufferSize(preferences,
+                                            UDP_MAX_RECV_BUFFER_KEY);
+  options->export_map = export_map;
+  options->export_key = export_key;
+}
+
+
+bool SetDefaultNetworkEnginePreferences(Preferences *preferences) {
+  std::set<std::string> engines;
+  engines.insert(SOCKET_ENGINE);
+  engines.insert(XDP_ENGINE);
+
+  bool save = false;
+  save |= preferences->SetDefaultValue(
+      NETWORK_ENGINE_KEY, SetValidator<std::string>(engines), SOCKET_ENGINE);
+  save |= preferences->SetDefaultValue(XDP_QUEUE_KEY, UIntValidator(0, 1023),
+                                       0);
+  return save;
+}
+
+
+bool ReadNetworkEnginePreferences(const Preferences &preferences,
+                                  unsigned int *queue_id) {
+  if (preferences.GetValue(NETWORK_ENGINE_KEY) != XDP_ENGINE) {
+    return false;
+  }
+  if (!StringToInt(preferences.GetValue(XDP_QUEUE_KEY), queue_id)) {
+    *queue_id = 0;
+  }
+  return true;
+}
+}  // namespace ola
@@ -30,6 +30,7 @@
  *   A list of sink clients, which we update whenever the DmxBuffer changes.
  */
 
+#include <string.h>
 #include <algorithm>
 #include <iterator>
 #include <map>
@@ -39,16 +40,29 @@
 #include <utility>
 #include <vector>
 
+#include "common/dmx/HTPMerge.h"
+#include "common/dmx/Interpolate.h"
+#include "common/dmx/LayerBlend.h"
 #include "ola/base/Array.h"
+#include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/MultiCallback.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/stl/STLUtils.h"
 #include "ola/strings/Format.h"
+#include "ola/util/Trace.h"
+#include "olad/Device.h"
+#include "olad/Plugin.h"
 #include "olad/Port.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/DiscoveryScheduler.h"
+#include "olad/plugin_api/OutputRateLimiter.h"
+#include "olad/plugin_api/OutputScheduler.h"
+#include "olad/plugin_api/RDMResponseCache.h"
+#include "olad/plugin_api/SlotSubscriptions.h"
+#include "olad/plugin_api/UniversePublisher.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 namespace ola {
@@ -68,6 +82,13 @@ using std::vector;
 
 const char Universe::K_UNIVERSE_UID_COUNT_VAR[] = "universe-uids";
 const char Universe::K_FPS_VAR[] = "universe-dmx-frames";
+const char Universe::K_LATENCY_VAR[] = "universe-latency-us";
+const char Universe::K_LATENCY_P50_VAR[] = "universe-latency-p50-us";
+const char Universe::K_LATENCY_P99_VAR[] = "universe-latency-p99-us";
+const char Universe::K_LATENCY_P999_VAR[] = "universe-latency-p999-us";
+const char Universe::K_OUTPUT_COALESCED_VAR[] = "universe-output-coalesced";
+const char Universe::K_OUTPUT_DEFERRED_VAR[] = "universe-output-deferred";
+const char Universe::K_OUTPUT_SUPPRESSED_VAR[] = "universe-output-suppressed";
 const char Universe::K_MERGE_HTP_STR[] = "htp";
 const char Universe::K_MERGE_LTP_STR[] = "ltp";
 const char Universe::K_UNIVERSE_INPUT_PORT_VAR[] = "universe-input-ports";
@@ -95,8 +116,36 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
       m_universe_store(store),
       m_export_map(export_map),
       m_clock(clock),
+      m_loop_clock(clock),
       m_rdm_discovery_interval(),
-      m_last_discovery_time() {
+      m_last_discovery_time(),
+      m_htp_merge_valid(false),
+      m_frames_var(NULL),
+      m_output_deferred_var(NULL),
+      m_output_coalesced_var(NULL),
+      m_output_scheduler(NULL),
+      m_discovery_scheduler(NULL),
+      m_rdm_response_cache(NULL),
+      m_rate_limiter(NULL),
+      m_publisher(NULL),
+      m_last_output_priority(0),
+      m_output_suppressed_var(NULL),
+      m_output_held(false),
+      m_layers_dirty(false),
+      m_slot_subscriptions(NULL),
+      m_pending_port(NULL),
+      m_pending_client(NULL),
+      m_pending_merges(0),
+      m_pending_write(false),
+      m_frame_count(0),
+      m_merge_count(0),
+      m_active_source_count(0),
+      m_latency_samples(0),
+      m_latency_p50_var(NULL),
+      m_latency_p99_var(NULL),
+      m_latency_p999_var(NULL),
+      m_output_stats(false),
+      m_written_since_release(false) {
   ostringstream universe_id_str, universe_name_str;
   universe_id_str << universe_id;
   m_universe_id_str = universe_id_str.str();
@@ -107,7 +156,6 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
   UpdateMode();
 
   const char *vars[] = {
-    K_FPS_VAR,
     K_UNIVERSE_INPUT_PORT_VAR,
     K_UNIVERSE_OUTPUT_PORT_VAR,
     K_UNIVERSE_RDM_REQUESTS,
@@ -132,6 +180,14 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
  * Delete this universe
  */
 Universe::~Universe() {
+  delete m_slot_subscriptions;
+  if (m_output_scheduler) {
+    m_output_scheduler->RemoveUniverse(this);
+  }
+  if (m_rdm_response_cache) {
+    m_rdm_response_cache->InvalidateUniverse(m_universe_id);
+  }
+
   const char *string_vars[] = {
     K_UNIVERSE_NAME_VAR,
     K_UNIVERSE_MODE_VAR,
@@ -139,6 +195,12 @@ Universe::~Universe() {
 
   const char *uint_vars[] = {
     K_FPS_VAR,
+    K_LATENCY_P50_VAR,
+    K_LATENCY_P99_VAR,
+    K_LATENCY_P999_VAR,
+    K_OUTPUT_COALESCED_VAR,
+    K_OUTPUT_DEFERRED_VAR,
+    K_OUTPUT_SUPPRESSED_VAR,
     K_UNIVERSE_INPUT_PORT_VAR,
     K_UNIVERSE_OUTPUT_PORT_VAR,
     K_UNIVERSE_RDM_REQUESTS,
@@ -154,7 +216,9 @@ Universe::~Universe() {
     for (unsigned int i = 0; i < arraysize(uint_vars); ++i) {
       m_export_map->GetUIntMapVar(uint_vars[i])->Remove(m_universe_id_str);
     }
+    m_export_map->GetHistogramMapVar(K_LATENCY_VAR)->Remove(m_universe_id_str);
   }
+  STLDeleteElements(&m_free_trackers);
 }
 
 
@@ -180,10 +244,113 @@ void Universe::SetName(const string &name) {
  */
 void Universe::SetMergeMode(enum merge_mode merge_mode) {
   m_merge_mode = merge_mode;
+  m_htp_merge_valid = false;
   UpdateMode();
 }
 
 
+void Universe::SetOutputKeepalive(const TimeInterval &interval) {
+  m_output_keepalive = interval;
+  // Make sure the next update is written.
+  m_last_output.Reset();
+}
+
+
+void Universe::SetOutputHold(bool hold) {
+  if (hold == m_output_held) {
+    return;
+  }
+  m_output_held = hold;
+  if (!hold && GetDMX().Size()) {
+    // The held data was never written, so it can't be suppressed.
+    m_last_output.Reset();
+    UpdateDependants();
+  }
+}
+
+void Universe::SetOutputScheduler(OutputScheduler *scheduler) {
+  if (m_output_scheduler && m_output_scheduler != scheduler) {
+    m_output_scheduler->RemoveUniverse(this);
+  }
+  m_output_scheduler = scheduler;
+}
+
+
+void Universe::SetDiscoveryScheduler(DiscoveryScheduler *scheduler) {
+  m_discovery_scheduler = scheduler;
+}
+
+
+void Universe::SetLoopClock(Clock *clock) {
+  m_loop_clock = clock ? clock : m_clock;
+}
+
+
+void Universe::SetOutputRateLimiter(OutputRateLimiter *limiter) {
+  if (m_rate_limiter && m_rate_limiter != limiter) {
+    vector<OutputPort*>::iterator iter = m_output_ports.begin();
+    for (; iter != m_output_ports.end(); ++iter) {
+      m_rate_limiter->RemovePort(*iter);
+    }
+  }
+  m_rate_limiter = limiter;
+}
+
+
+void Universe::SetRDMResponseCache(RDMResponseCache *cache) {
+  if (m_rdm_response_cache && m_rdm_response_cache != cache) {
+    m_rdm_response_cache->InvalidateUniverse(m_universe_id);
+  }
+  m_rdm_response_cache = cache;
+}
+
+
+void Universe::FlushOutput() {
+  WriteDependants();
+}
+
+
+bool Universe::ReleaseIdleBuffers() {
+  if (m_written_since_release) {
+    m_written_since_release = false;
+    return false;
+  }
+
+  // Assigning an empty buffer frees the memory, Reset() doesn't.
+  m_remapped_buffer = DmxBuffer();
+  m_fade_frame = DmxBuffer();
+  if (m_layers.empty()) {
+    m_composite = DmxBuffer();
+  }
+  UIDRoutes().swap(m_new_output_uids);
+  vector<const DmxSource*>().swap(m_active_sources);
+  vector<const InputPort*>().swap(m_active_ports);
+  vector<const Client*>().swap(m_active_clients);
+  vector<const DmxBuffer*>().swap(m_merge_buffers);
+  return true;
+}
+
+
+bool Universe::RunPendingMerge() {
+  bool changed = m_pending_write;
+  if (m_pending_merges == 1) {
+    changed |= MergeAll(m_pending_port, m_pending_client);
+  } else if (m_pending_merges) {
+    // More than one source changed, or the same source changed more than
+    // once, so the changed slots of a single source aren't enough.
+    m_htp_merge_valid = false;
+    changed |= MergeAll(NULL, NULL, true);
+  } else {
+    changed = true;
+  }
+  m_pending_port = NULL;
+  m_pending_client = NULL;
+  m_pending_merges = 0;
+  m_pending_write = false;
+  return changed;
+}
+
+
 /*
  * Add an InputPort to this universe.
  * @param port the port to add
@@ -198,7 +365,9 @@ bool Universe::AddPort(InputPort *port) {
  * @param port the port to add
  */
 bool Universe::AddPort(OutputPort *port) {
-  return GenericAddPort(port, &m_output_ports);
+  bool ret = GenericAddPort(port, &m_output_ports);
+  RebuildFanout();
+  return ret;
 }
 
 
@@ -208,6 +377,10 @@ bool Universe::AddPort(OutputPort *port) {
  * @return true if the port was removed, false if it didn't exist
  */
 bool Universe::RemovePort(InputPort *port) {
+  if (m_pending_merges && m_pending_port == port) {
+    m_pending_port = NULL;
+    m_pending_merges++;
+  }
   return GenericRemovePort(port, &m_input_ports);
 }
 
@@ -218,7 +391,17 @@ bool Universe::RemovePort(InputPort *port) {
  * @return true if the port was removed, false if it didn't exist
  */
 bool Universe::RemovePort(OutputPort *port) {
-  bool ret = GenericRemovePort(port, &m_output_ports, &m_output_uids);
+  bool ret = GenericRemovePort(port, &m_output_ports);
+  RemoveRoutes(port);
+  RebuildFanout();
+
+  if (m_discovery_scheduler) {
+    m_discovery_scheduler->RemovePort(port);
+  }
+
+  if (m_rate_limiter) {
+    m_rate_limiter->RemovePort(port);
+  }
 
   if (m_export_map) {
     (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_COUNT_VAR))[m_universe_id_str]
@@ -276,12 +459,22 @@ void Universe::OutputPorts(vector<OutputPort*> *ports) const {
  * @return true
  */
 bool Universe::AddSourceClient(Client *client) {
+  const unsigned int generation = m_universe_store ?
+      m_universe_store->SourceClientGeneration() : 0;
+
   // Check to see if it exists already. It doesn't make sense to have multiple
   //  clients
-  if (STLReplace(&m_source_clients, client, false)) {
+  SourceClientMap::iterator iter = m_source_clients.find(client);
+  if (iter != m_source_clients.end()) {
+    iter->second.last_seen = generation;
     return true;
   }
 
+  SourceClientState &state = m_source_clients[client];
+  state.last_seen = generation;
+  state.serial = m_universe_store ?
+      m_universe_store->WatchSourceClient(this, client) : 0;
+
   OLA_INFO << "Added source client, " << client << " to universe "
            << m_universe_id;
 
@@ -302,6 +495,12 @@ bool Universe::RemoveSourceClient(Client *client) {
     return false;
   }
 
+  if (m_pending_merges && m_pending_client == client) {
+    m_pending_client = NULL;
+    m_pending_merges++;
+  }
+  m_fades.erase(client);
+
   SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
 
   OLA_INFO << "Source client " << client << " has been removed from uni "
@@ -333,6 +532,7 @@ bool Universe::AddSinkClient(Client *client) {
   if (!STLInsertIfNotPresent(&m_sink_clients, client)) {
     return false;
   }
+  RebuildFanout();
 
   OLA_INFO << "Added sink client, " << client << " to universe "
            << m_universe_id;
@@ -353,6 +553,7 @@ bool Universe::RemoveSinkClient(Client *client) {
   if (!STLRemove(&m_sink_clients, client)) {
     return false;
   }
+  RebuildFanout();
 
   SafeDecrement(K_UNIVERSE_SINK_CLIENTS_VAR);
 
@@ -365,6 +566,30 @@ bool Universe::RemoveSinkClient(Client *client) {
   return true;
 }
 
+void Universe::AddSlotSubscription(Client *client,
+                                   const vector<SlotRange> &ranges) {
+  if (!m_slot_subscriptions) {
+    m_slot_subscriptions = new SlotSubscriptions(m_universe_id, GetDMX());
+  }
+  m_slot_subscriptions->Subscribe(client, ranges, GetDMX());
+}
+
+
+bool Universe::RemoveSlotSubscription(Client *client) {
+  if (!m_slot_subscriptions || !m_slot_subscriptions->Unsubscribe(client)) {
+    return false;
+  }
+  if (m_slot_subscriptions->Empty()) {
+    delete m_slot_subscriptions;
+    m_slot_subscriptions = NULL;
+    if (!IsActive()) {
+      m_universe_store->AddUniverseGarbageCollection(this);
+    }
+  }
+  return true;
+}
+
+
 /*
  * Check if this universe contains a client as a sink
  * @param client the client to check for
@@ -388,6 +613,13 @@ bool Universe::SetDMX(const DmxBuffer &buffer) {
     return true;
   }
   m_buffer.Set(buffer);
+  m_slot_priorities.Reset();
+  m_htp_merge_valid = false;
+  m_ingress_time = TimeStamp();
+  if (m_output_scheduler && m_output_scheduler->DeferredMerging()) {
+    // Make sure this is written even if a pending merge has no effect.
+    m_pending_write = true;
+  }
   return UpdateDependants();
 }
 
@@ -397,12 +629,13 @@ bool Universe::SetDMX(const DmxBuffer &buffer) {
  * @param port the port that has changed
  */
 bool Universe::PortDataChanged(InputPort *port) {
+  OLA_TRACE_SCOPE("olad", "Universe::PortDataChanged");
   if (!ContainsPort(port)) {
     OLA_INFO << "Trying to update a port which isn't bound to universe: "
              << UniverseId();
     return false;
   }
-  if (MergeAll(port, NULL)) {
+  if (!DeferMerge(port, NULL) && MergeAll(port, NULL)) {
     UpdateDependants();
   }
   return true;
@@ -417,34 +650,92 @@ bool Universe::SourceClientDataChanged(Client *client) {
     return false;
   }
 
-  AddSourceClient(client);   // always add since this may be the first call
-  if (MergeAll(NULL, client)) {
-    UpdateDependants();
+  if (!m_fades.empty()) {
+    m_fades.erase(client);
   }
+  MergeSourceClient(client);
   return true;
 }
 
 
-/**
- * @brief Clean old source clients
- */
-void Universe::CleanStaleSourceClients() {
-  SourceClientMap::iterator iter = m_source_clients.begin();
-  while (iter != m_source_clients.end()) {
-    if (iter->second) {
-      // if stale remove it
-      m_source_clients.erase(iter++);
-      SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
-      OLA_INFO << "Removed Stale Client";
-      if (!IsActive()) {
-        m_universe_store->AddUniverseGarbageCollection(this);
-      }
+bool Universe::FadeSourceClient(Client *client, const DmxSource &target,
+                                const TimeInterval &duration) {
+  if (!client) {
+    return false;
+  }
+
+  if (duration.IsZero() || !m_output_scheduler || !target.Data().Size()) {
+    client->DMXReceived(m_universe_id, target);
+    return SourceClientDataChanged(client);
+  }
+
+  // Start from the client's current data, which may be part way through an
+  // earlier fade. Slots the client didn't have start at 0.
+  const DmxBuffer &current = client->SourceData(m_universe_id).Data();
+  Fade &fade = m_fades[client];
+  fade.start.Blackout();
+  fade.start.SetRange(0, current.GetRaw(), current.Size());
+  fade.target.Set(target.Data());
+  fade.slot_priorities = target.SlotPriorities();
+  fade.priority = target.Priority();
+  fade.start_time = target.Timestamp();
+  fade.duration = duration;
+
+  m_output_scheduler->ScheduleFade(this);
+  return true;
+}
+
+
+bool Universe::RunFades(const TimeStamp &now) {
+  uint8_t frame[ola::DMX_UNIVERSE_SIZE];
+
+  FadeMap::iterator iter = m_fades.begin();
+  while (iter != m_fades.end()) {
+    Client *client = iter->first;
+    const Fade &fade = iter->second;
+
+    const TimeInterval elapsed = now > fade.start_time ?
+        now - fade.start_time : TimeInterval();
+    const bool done = elapsed >= fade.duration;
+    const unsigned int step = done ? ola::dmx::INTERPOLATE_STEPS :
+        static_cast<unsigned int>(elapsed.AsInt() *
+                                  ola::dmx::INTERPOLATE_STEPS /
+                                  fade.duration.AsInt());
+
+    ola::dmx::InterpolateSlots(frame, fade.start.GetRaw(), fade.target.GetRaw(),
+                               fade.target.Size(), step);
+    m_fade_frame.Set(frame, fade.target.Size());
+    client->DMXReceived(
+        m_universe_id,
+        DmxSource(m_fade_frame, now, fade.priority, fade.slot_priorities));
+
+    if (done) {
+      m_fades.erase(iter++);
     } else {
-      // clear the stale flag
-      iter->second = true;
       ++iter;
     }
+    MergeSourceClient(client);
   }
+  return !m_fades.empty();
+}
+
+
+unsigned int Universe::CheckSourceClient(Client *client, unsigned int serial,
+                                         unsigned int generation) {
+  SourceClientMap::iterator iter = m_source_clients.find(client);
+  if (iter == m_source_clients.end() || iter->second.serial != serial) {
+    return 0;
+  }
+
+  // The client must have sent data since the previous check.
+  if (iter->second.last_seen + 1 >= generation) {
+    return iter->second.last_seen + 2;
+  }
+
+  OLA_INFO << "Removing stale source client " << client << " from uni "
+           << m_universe_id;
+  RemoveSourceClient(client);
+  return 0;
 }
 
 
@@ -465,6 +756,12 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
 
   SafeIncrement(K_UNIVERSE_RDM_REQUESTS);
 
+  if (m_rdm_response_cache &&
+      m_rdm_response_cache->ServeRequest(m_universe_id, request.get(),
+                                         &callback)) {
+    return;
+  }
+
   if (request->DestinationUID().IsBroadcast()) {
     if (m_output_ports.empty()) {
       RunRDMCallback(
@@ -475,7 +772,7 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
     }
 
     // send this request to all ports
-    broadcast_request_tracker *tracker = new broadcast_request_tracker;
+    broadcast_request_tracker *tracker = NewBroadcastTracker();
     tracker->expected_count = m_output_ports.size();
     tracker->current_count = 0;
     tracker->status_code = (request->IsDUB() ?
@@ -500,15 +797,14 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
       }
     }
   } else {
-    map<UID, OutputPort*>::iterator iter =
-        m_output_uids.find(request->DestinationUID());
+    UIDRoutes::const_iterator iter = FindRoute(request->DestinationUID());
 
     if (iter == m_output_uids.end()) {
       OLA_WARN << "Can't find UID " << request->DestinationUID()
                << " in the output universe map, dropping request";
       RunRDMCallback(callback, ola::rdm::RDM_UNKNOWN_UID);
     } else {
-      iter->second->SendRDMRequest(request.release(), callback);
+      iter->port->SendRDMRequest(request.release(), callback);
     }
   }
 }
@@ -542,45 +838,62 @@ void Universe::RunRDMDiscovery(RDMDiscoveryCallback *on_complete, bool full) {
   // will trigger, running the DiscoveryCallback.
   vector<OutputPort*>::iterator iter;
   for (iter = output_ports.begin(); iter != output_ports.end(); ++iter) {
-    if (full) {
-      (*iter)->RunFullDiscovery(
-          NewSingleCallback(this,
-                            &Universe::PortDiscoveryComplete,
-                            discovery_complete,
-                            *iter));
-    } else {
-      (*iter)->RunIncrementalDiscovery(
-          NewSingleCallback(this,
-                            &Universe::PortDiscoveryComplete,
-                            discovery_complete,
-                            *iter));
-    }
+    RunPortDiscovery(*iter, full,
+                     NewSingleCallback(this,
+                                       &Universe::PortDiscoveryComplete,
+                                       discovery_complete,
+                                       *iter));
+  }
+}
+
+
+void Universe::RunPortDiscovery(OutputPort *port, bool full,
+                                RDMDiscoveryCallback *on_complete) {
+  if (m_discovery_scheduler) {
+    m_discovery_scheduler->RunDiscovery(port, full, on_complete);
+  } else if (full) {
+    port->RunFullDiscovery(on_complete);
+  } else {
+    port->RunIncrementalDiscovery(on_complete);
   }
 }
 
 
 /*
- * Update the UID : port mapping with this new data
+ * Update the UID : port mapping with this new data.
+ *
+ * Both the routing table and the UIDSet are sorted, so this is a single merge
+ * of the two.
  */
 void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
-  map<UID, OutputPort*>::iterator iter = m_output_uids.begin();
-  while (iter != m_output_uids.end()) {
-    if (iter->second == port && !uids.Contains(iter->first)) {
-      m_output_uids.erase(iter++);
-    } else {
-      ++iter;
-    }
-  }
+  m_new_output_uids.clear();
+  m_new_output_uids.reserve(m_output_uids.size() + uids.Size());
 
+  UIDRoutes::const_iterator iter = m_output_uids.begin();
   ola::rdm::UIDSet::Iterator set_iter = uids.Begin();
-  for (; set_iter != uids.End(); ++set_iter) {
-    iter = m_output_uids.find(*set_iter);
-    if (iter == m_output_uids.end()) {
-      m_output_uids[*set_iter] = port;
-    } else if (iter->second != port) {
-      OLA_WARN << "UID " << *set_iter << " seen on more than one port";
+  while (iter != m_output_uids.end() || set_iter != uids.End()) {
+    if (set_iter == uids.End() ||
+        (iter != m_output_uids.end() && iter->uid < *set_iter)) {
+      // Not in the new list, drop it if it belonged to this port.
+      if (iter->port != port) {
+        m_new_output_uids.push_back(*iter);
+      } else if (m_rdm_response_cache) {
+        m_rdm_response_cache->InvalidateUID(m_universe_id, iter->uid);
+      }
+      ++iter;
+    } else if (iter == m_output_uids.end() || *set_iter < iter->uid) {
+      m_new_output_uids.push_back(UIDRoute(*set_iter, port));
+      ++set_iter;
+    } else {
+      if (iter->port != port) {
+        OLA_WARN << "UID " << *set_iter << " seen on more than one port";
+      }
+      m_new_output_uids.push_back(*iter);
+      ++iter;
+      ++set_iter;
     }
   }
+  m_output_uids.swap(m_new_output_uids);
 
   if (m_export_map) {
     (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_COUNT_VAR))[m_universe_id_str]
@@ -593,9 +906,9 @@ void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
  * Returns the complete UIDSet for this universe
  */
 void Universe::GetUIDs(ola::rdm::UIDSet *uids) const {
-  map<UID, OutputPort*>::const_iterator iter = m_output_uids.begin();
+  UIDRoutes::const_iterator iter = m_output_uids.begin();
   for (; iter != m_output_uids.end(); ++iter) {
-    uids->AddUID(iter->first);
+    uids->AddUID(iter->uid);
   }
 }
 
@@ -608,13 +921,55 @@ unsigned int Universe::UIDCount() const {
 }
 
 
+void Universe::GetStats(Stats *stats) const {
+  stats->frames = m_frame_count;
+  stats->merges = m_merge_count;
+  stats->input_ports = m_input_ports.size();
+  stats->source_clients = m_source_clients.size();
+  stats->active_sources = m_active_source_count;
+  if (m_latency.get()) {
+    stats->latency_samples = m_latency->Count();
+    stats->latency_p50 = m_latency->Percentile(50);
+    stats->latency_p99 = m_latency->Percentile(99);
+    stats->latency_p999 = m_latency->Percentile(99.9);
+  } else {
+    stats->latency_samples = 0;
+    stats->latency_p50 = 0;
+    stats->latency_p99 = 0;
+    stats->latency_p999 = 0;
+  }
+}
+
+
 /*
  * Return true if this universe is in use (has at least one port or client).
  */
 bool Universe::IsActive() const {
   // any of the following means the port is active
   return !(m_output_ports.empty() && m_input_ports.empty() &&
-           m_source_clients.empty() && m_sink_clients.empty());
+           m_source_clients.empty() && m_sink_clients.empty() &&
+           m_layers.empty() && !m_slot_subscriptions);
+}
+
+
+void Universe::SetLayers(const vector<Layer> &layers) {
+  m_layers = layers;
+  if (m_layers.empty()) {
+    m_composite.Reset();
+  }
+  LayerInputChanged();
+  if (!IsActive() && m_universe_store) {
+    m_universe_store->AddUniverseGarbageCollection(this);
+  }
+}
+
+
+void Universe::LayerInputChanged() {
+  if (m_output_scheduler && m_output_scheduler->DeferredMerging()) {
+    // Make sure this is written even if a pending merge has no effect.
+    m_pending_write = true;
+  }
+  UpdateDependants();
 }
 
 
@@ -624,26 +979,297 @@ bool Universe::IsActive() const {
 
 /*
  * Called when the dmx data for this universe changes,
- * updates everyone who needs to know (patched ports and network clients)
+ * updates everyone who needs to know (patched ports and network clients).
+ * If there is an OutputScheduler, the write may be deferred.
  */
 bool Universe::UpdateDependants() {
-  vector<OutputPort*>::const_iterator iter;
-  set<Client*>::const_iterator client_iter;
+  OLA_TRACE_SCOPE("olad", "Universe::UpdateDependants");
+  if (!m_output_stats) {
+    InitOutputStats();
+  }
+  m_layers_dirty = true;
+  m_written_since_release = true;
+  if (m_output_scheduler &&
+      (!m_output_interval.IsZero() || m_output_scheduler->FrameAligned())) {
+    unsigned int *var = NULL;
+    switch (m_output_scheduler->ScheduleOutput(this, m_output_interval)) {
+      case OutputScheduler::OUTPUT_NOW:
+        WriteDependants();
+        return true;
+      case OutputScheduler::OUTPUT_DEFERRED:
+        var = m_output_deferred_var;
+        break;
+      case OutputScheduler::OUTPUT_COALESCED:
+        var = m_output_coalesced_var;
+        break;
+    }
+    if (var) {
+      (*var)++;
+    }
+    return true;
+  }
+  WriteDependants();
+  return true;
+}
 
-  // write to all ports assigned to this universe
-  for (iter = m_output_ports.begin(); iter != m_output_ports.end(); ++iter) {
-    (*iter)->WriteDMX(m_buffer, m_active_priority);
+
+/*
+ * If the OutputScheduler merges universes on the frame clock, record the
+ * change and schedule the output. The merge is done by RunPendingMerge().
+ * @returns true if the merge was deferred.
+ */
+bool Universe::DeferMerge(const InputPort *port, const Client *client) {
+  if (!m_output_scheduler || !m_output_scheduler->DeferredMerging()) {
+    return false;
   }
+  m_pending_port = port;
+  m_pending_client = client;
+  m_pending_merges++;
+  UpdateDependants();
+  return true;
+}
 
-  // write to all clients
-  for (client_iter = m_sink_clients.begin();
-       client_iter != m_sink_clients.end();
-       ++client_iter) {
-    (*client_iter)->SendDMX(m_universe_id, m_active_priority, m_buffer);
+
+/*
+ * Merge the data from a source client.
+ */
+void Universe::MergeSourceClient(Client *client) {
+  AddSourceClient(client);   // always add since this may be the first call
+  if (!DeferMerge(NULL, client) && MergeAll(NULL, client)) {
+    UpdateDependants();
   }
+}
 
-  SafeIncrement(K_FPS_VAR);
-  return true;
+
+/*
+ * Write the dmx data to the patched ports and sink clients.
+ */
+void Universe::WriteDependants() {
+  OLA_TRACE_SCOPE("olad", "Universe::WriteDependants");
+  if (m_layers_dirty && !m_layers.empty()) {
+    CompositeLayers();
+  }
+  m_layers_dirty = false;
+
+  if (!m_output_keepalive.IsZero() && SuppressOutput()) {
+    if (m_output_suppressed_var) {
+      (*m_output_suppressed_var)++;
+    }
+    m_ingress_time = TimeStamp();
+    return;
+  }
+
+  // write to all ports assigned to this universe, then all clients. The
+  // clients share a single serialized copy of the update.
+  const DmxBuffer &buffer = GetDMX();
+  string serialized;
+  vector<Destination>::const_iterator iter = m_fanout.begin();
+  for (; iter != m_fanout.end(); ++iter) {
+    if (iter->port) {
+      if (m_output_held) {
+        continue;
+      }
+      OLA_TRACE_SCOPE("olad", "OutputPort::WriteDMX");
+      const ola::dmx::SlotRemap &remap = iter->port->GetSlotRemap();
+      const DmxBuffer *data = &buffer;
+      if (!remap.Empty()) {
+        remap.Apply(buffer, &m_remapped_buffer);
+        data = &m_remapped_buffer;
+      }
+      if (m_rate_limiter && iter->port->MaxRate()) {
+        m_rate_limiter->WriteDMX(iter->port, *data, m_active_priority);
+      } else {
+        iter->port->WriteDMX(*data, m_active_priority);
+      }
+    } else {
+      OLA_TRACE_SCOPE("olad", "Client::SendDMX");
+      iter->client->SendDMX(m_universe_id, m_active_priority, buffer,
+                            &serialized);
+    }
+  }
+
+  if (m_slot_subscriptions) {
+    OLA_TRACE_SCOPE("olad", "SlotSubscriptions::Update");
+    m_slot_subscriptions->Update(buffer);
+  }
+
+  if (m_publisher) {
+    OLA_TRACE_SCOPE("olad", "UniversePublisher::Publish");
+    m_publisher->Publish(m_universe_id, m_active_priority, buffer);
+  }
+
+  if (m_universe_store) {
+    m_universe_store->LayerSourceChanged(m_universe_id);
+  }
+
+  m_frame_count++;
+  if (m_frames_var) {
+    (*m_frames_var)++;
+  }
+
+  if (m_ingress_time.IsSet()) {
+    RecordLatency();
+  }
+}
+
+
+/*
+ * Blend the layers onto the merged data. Slots past the end of the merged
+ * data start at 0, and layers from universes that don't exist are skipped.
+ */
+void Universe::CompositeLayers() {
+  OLA_TRACE_SCOPE("olad", "Universe::CompositeLayers");
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  unsigned int size = sizeof(data);
+  m_buffer.Get(data, &size);
+  memset(data + size, 0, sizeof(data) - size);
+
+  vector<Layer>::const_iterator iter = m_layers.begin();
+  for (; iter != m_layers.end(); ++iter) {
+    const Universe *source = m_universe_store ?
+        m_universe_store->GetUniverse(iter->universe) : NULL;
+    if (!source || !iter->opacity) {
+      continue;
+    }
+
+    const DmxBuffer &input = source->GetDMX();
+    const bool masked = iter->mask.Size() != 0;
+    unsigned int length = input.Size();
+    if (masked) {
+      length = std::min(length, iter->mask.Size());
+    }
+    if (!length) {
+      continue;
+    }
+    ola::dmx::BlendLayer(data, input.GetRaw(),
+                         masked ? iter->mask.GetRaw() : NULL,
+                         iter->opacity, length);
+    size = std::max(size, length);
+  }
+  m_composite.Set(data, size);
+}
+
+
+/*
+ * Order output ports by the plugin that owns them.
+ */
+static bool PluginOrder(const OutputPort *a, const OutputPort *b) {
+  const AbstractDevice *device_a = a->GetDevice();
+  const AbstractDevice *device_b = b->GetDevice();
+  const AbstractPlugin *plugin_a = device_a ? device_a->Owner() : NULL;
+  const AbstractPlugin *plugin_b = device_b ? device_b->Owner() : NULL;
+  if (!plugin_a || !plugin_b) {
+    return plugin_b != NULL;
+  }
+  return plugin_a->Id() < plugin_b->Id();
+}
+
+
+/*
+ * Rebuild the fan-out list from the output ports & sink clients. The ports are
+ * grouped by plugin, so consecutive writes go to the same plugin, while
+ * keeping the patch order within each plugin.
+ */
+void Universe::RebuildFanout() {
+  vector<OutputPort*> ports(m_output_ports);
+  std::stable_sort(ports.begin(), ports.end(), PluginOrder);
+
+  m_fanout.clear();
+  m_fanout.reserve(ports.size() + m_sink_clients.size());
+  Destination destination;
+  destination.client = NULL;
+  vector<OutputPort*>::const_iterator port_iter = ports.begin();
+  for (; port_iter != ports.end(); ++port_iter) {
+    destination.port = *port_iter;
+    m_fanout.push_back(destination);
+  }
+
+  destination.port = NULL;
+  set<Client*>::const_iterator client_iter = m_sink_clients.begin();
+  for (; client_iter != m_sink_clients.end(); ++client_iter) {
+    destination.client = *client_iter;
+    m_fanout.push_back(destination);
+  }
+}
+
+
+/*
+ * Check if the data is the same as the last write, and the keepalive interval
+ * hasn't passed. If the data is going to be written, remember it.
+ * @returns true if the write should be skipped.
+ */
+bool Universe::SuppressOutput() {
+  TimeStamp now;
+  m_loop_clock->CurrentTime(&now);
+
+  const DmxBuffer &buffer = GetDMX();
+  if (buffer.Size() && m_active_priority == m_last_output_priority &&
+      buffer == m_last_output &&
+      now < m_last_output_time + m_output_keepalive) {
+    return true;
+  }
+
+  // Copy rather than share the data, so that the next merge doesn't have to
+  // allocate a new buffer.
+  m_last_output.Set(buffer);
+  m_last_output_priority = m_active_priority;
+  m_last_output_time = now;
+  return false;
+}
+
+
+/*
+ * Record the time from when the source data was received until now, and
+ * update the percentiles in the export map.
+ */
+void Universe::RecordLatency() {
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  if (!m_latency.get()) {
+    m_latency.reset(new Histogram());
+    if (m_export_map) {
+      m_export_map->GetHistogramMapVar(K_LATENCY_VAR)->Set(m_universe_id_str,
+                                                           m_latency.get());
+    }
+  }
+  if (now >= m_ingress_time) {
+    int64_t latency = (now - m_ingress_time).AsInt();
+    m_latency->Add(static_cast<uint32_t>(
+        std::min(latency, static_cast<int64_t>(0xffffffff))));
+  }
+  // Don't count the same data twice if it's written again.
+  m_ingress_time = TimeStamp();
+
+  // Working out the percentiles means walking the histogram, so only do it
+  // every so often.
+  if (!m_latency_p50_var ||
+      (m_latency->Count() > 1 &&
+       ++m_latency_samples < LATENCY_EXPORT_SAMPLES)) {
+    return;
+  }
+  m_latency_samples = 0;
+  *m_latency_p50_var = m_latency->Percentile(50);
+  *m_latency_p99_var = m_latency->Percentile(99);
+  *m_latency_p999_var = m_latency->Percentile(99.9);
+}
+
+
+/*
+ * Add the per-frame export map entries. These are updated on every frame, so
+ * hold onto this universe's values rather than looking them up by name.
+ */
+void Universe::InitOutputStats() {
+  m_output_stats = true;
+  if (!m_export_map) {
+    return;
+  }
+  m_frames_var = UniverseHandle(K_FPS_VAR);
+  m_output_deferred_var = UniverseHandle(K_OUTPUT_DEFERRED_VAR);
+  m_output_coalesced_var = UniverseHandle(K_OUTPUT_COALESCED_VAR);
+  m_output_suppressed_var = UniverseHandle(K_OUTPUT_SUPPRESSED_VAR);
+  m_latency_p50_var = UniverseHandle(K_LATENCY_P50_VAR);
+  m_latency_p99_var = UniverseHandle(K_LATENCY_P99_VAR);
+  m_latency_p999_var = UniverseHandle(K_LATENCY_P999_VAR);
 }
 
 
@@ -675,15 +1301,123 @@ void Universe::UpdateMode() {
 /*
  * HTP Merge all sources (clients/ports)
  * @pre sources.size >= 2
- * @param sources the list of DmxSources to merge
+ * @param sources the DmxSources to merge
  */
-void Universe::HTPMergeSources(const vector<DmxSource> &sources) {
-  vector<DmxSource>::const_iterator iter;
+void Universe::HTPMergeSources(const vector<const DmxSource*> &sources) {
+  m_merge_buffers.clear();
+  vector<const DmxSource*>::const_iterator iter;
+  for (iter = sources.begin(); iter != sources.end(); ++iter) {
+    m_merge_buffers.push_back(&(*iter)->Data());
+  }
+
   m_buffer.Reset();
+  if (!m_merge_buffers.empty()) {
+    m_buffer.HTPMerge(&m_merge_buffers[0], m_merge_buffers.size());
+  }
+}
 
+
+/*
+ * HTP Merge a range of slots from all sources. This is used when only a single
+ * source has changed, the slots outside of the range are left untouched.
+ * @pre m_buffer holds the HTP merge of sources, with the exception of the slots
+ *   in the range [start, end).
+ * @param sources the list of DmxSources to merge
+ * @param start the first slot to merge
+ * @param end one past the last slot to merge
+ */
+void Universe::HTPMergeSlots(const vector<const DmxSource*> &sources,
+                             unsigned int start,
+                             unsigned int end) {
+  if (start >= end) {
+    return;
+  }
+
+  uint8_t merged[DMX_UNIVERSE_SIZE];
+  memset(merged, DMX_MIN_SLOT_VALUE, end - start);
+
+  vector<const DmxSource*>::const_iterator iter;
   for (iter = sources.begin(); iter != sources.end(); ++iter) {
-    m_buffer.HTPMerge(iter->Data());
+    const uint8_t *data = (*iter)->Data().GetRaw();
+    unsigned int source_end = std::min(end, (*iter)->Data().Size());
+    for (unsigned int i = start; i < source_end; i++) {
+      merged[i - start] = std::max(merged[i - start], data[i]);
+    }
   }
+  m_buffer.SetRange(start, merged, end - start);
+}
+
+
+/*
+ * Merge all active sources using per-slot priorities. This is used when at
+ * least one of the sources has per-slot priorities.
+ *
+ * Unlike the other merges this considers every active source, since a source
+ * below the active priority may still have the highest priority for some
+ * slots. Sources with the same priority for a slot are always HTP merged.
+ * @param now the current time
+ */
+void Universe::SlotPriorityMergeSources(const TimeStamp &now) {
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  uint8_t priorities[DMX_UNIVERSE_SIZE];
+  memset(data, DMX_MIN_SLOT_VALUE, sizeof(data));
+  memset(priorities, 0, sizeof(priorities));
+  unsigned int length = 0;
+
+  vector<InputPort*>::const_iterator iter;
+  for (iter = m_input_ports.begin(); iter != m_input_ports.end(); ++iter) {
+    SlotPriorityMergeSource((*iter)->SourceData(), now, data, priorities,
+                            &length);
+  }
+
+  SourceClientMap::const_iterator client_iter;
+  for (client_iter = m_source_clients.begin();
+       client_iter != m_source_clients.end();
+       ++client_iter) {
+    SlotPriorityMergeSource(client_iter->first->SourceData(UniverseId()), now,
+                            data, priorities, &length);
+  }
+
+  m_buffer.Set(data, length);
+  m_slot_priorities.Set(priorities, length);
+}
+
+
+/*
+ * Merge a single source into the per-slot priority merge.
+ * Sources without per-slot priorities use the source priority for every slot.
+ * Since a slot priority of 0 means the slot isn't sourced, a source priority
+ * of 0 is treated as 1.
+ * @param source the source to merge
+ * @param now the current time
+ * @param data the merged data
+ * @param priorities the priorities of the merged data
+ * @param length the length of the merged data, this is updated if the source
+ *   is longer.
+ */
+void Universe::SlotPriorityMergeSource(const DmxSource &source,
+                                       const TimeStamp &now,
+                                       uint8_t *data,
+                                       uint8_t *priorities,
+                                       unsigned int *length) {
+  if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
+    return;
+  }
+
+  const unsigned int size = source.Data().Size();
+  uint8_t source_priorities[DMX_UNIVERSE_SIZE];
+  if (source.HasSlotPriorities()) {
+    unsigned int priorities_size = size;
+    source.SlotPriorities().Get(source_priorities, &priorities_size);
+    memset(source_priorities + priorities_size, 0, size - priorities_size);
+  } else {
+    memset(source_priorities,
+           std::max(source.Priority(), static_cast<uint8_t>(1)), size);
+  }
+
+  ola::dmx::SlotPriorityMerge(data, priorities, source.Data().GetRaw(),
+                              source_priorities, size);
+  *length = std::max(*length, size);
 }
 
 
@@ -693,36 +1427,48 @@ void Universe::HTPMergeSources(const vector<DmxSource> &sources) {
  * https://wiki.openlighting.org/index.php/OLA_Merging_Algorithms
  * @param port the input port that changed or NULL
  * @param client the client that changed or NULL
+ * @param force merge the sources even if the changed port / client isn't
+ *   active. The newest active source is used as the changed source.
  * @returns true if the data for this universe changed, false otherwise
  */
-bool Universe::MergeAll(const InputPort *port, const Client *client) {
-  vector<DmxSource> active_sources;
+bool Universe::MergeAll(const InputPort *port, const Client *client,
+                        bool force) {
+  OLA_TRACE_SCOPE("olad", "Universe::MergeAll");
+  // The scratch vectors are members so that once they've grown to the number
+  // of sources, a merge doesn't allocate any memory.
+  m_active_sources.clear();
+  m_active_ports.clear();
+  m_active_clients.clear();
 
   vector<InputPort*>::const_iterator iter;
   SourceClientMap::const_iterator client_iter;
 
   m_active_priority = ola::dmx::SOURCE_PRIORITY_MIN;
   TimeStamp now;
-  m_clock->CurrentTime(&now);
-  bool changed_source_is_active = false;
+  m_loop_clock->CurrentTime(&now);
+  const DmxSource *changed_source = NULL;
+  bool slot_priorities = false;
 
   // Find the highest active ports
   for (iter = m_input_ports.begin(); iter != m_input_ports.end(); ++iter) {
-    DmxSource source = (*iter)->SourceData();
+    const DmxSource &source = (*iter)->SourceData();
     if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
       continue;
     }
+    slot_priorities |= source.HasSlotPriorities();
 
     if (source.Priority() > m_active_priority) {
-      changed_source_is_active = false;
-      active_sources.clear();
+      changed_source = NULL;
+      m_active_sources.clear();
+      m_active_ports.clear();
       m_active_priority = source.Priority();
     }
 
     if (source.Priority() == m_active_priority) {
-      active_sources.push_back(source);
+      m_active_sources.push_back(&source);
+      m_active_ports.push_back(*iter);
       if (*iter == port) {
-        changed_source_is_active = true;
+        changed_source = &source;
       }
     }
   }
@@ -736,59 +1482,103 @@ bool Universe::MergeAll(const InputPort *port, const Client *client) {
     if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
       continue;
     }
+    slot_priorities |= source.HasSlotPriorities();
 
     if (source.Priority() > m_active_priority) {
-      changed_source_is_active = false;
-      active_sources.clear();
+      changed_source = NULL;
+      m_active_sources.clear();
+      m_active_ports.clear();
+      m_active_clients.clear();
       m_active_priority = source.Priority();
     }
 
     if (source.Priority() == m_active_priority) {
-      active_sources.push_back(source);
+      m_active_sources.push_back(&source);
+      m_active_clients.push_back(client_iter->first);
       if (client_iter->first == client) {
-        changed_source_is_active = true;
+        changed_source = &source;
       }
     }
   }
 
-  if (active_sources.empty()) {
+  m_merge_count++;
+  m_active_source_count = m_active_sources.size();
+
+  if (m_active_sources.empty()) {
     OLA_WARN << "Something changed but we didn't find any active sources "
              << " for universe " << UniverseId();
+    m_htp_merge_valid = false;
     return false;
   }
 
-  if (!changed_source_is_active) {
-    // this source didn't have any effect, skip
-    return false;
+  if (slot_priorities) {
+    SlotPriorityMergeSources(now);
+    m_htp_merge_valid = false;
+    if (changed_source) {
+      m_ingress_time = changed_source->Timestamp();
+    }
+    return true;
+  }
+
+  const bool had_slot_priorities = m_slot_priorities.Size() > 0;
+  m_slot_priorities.Reset();
+
+  if (!changed_source) {
+    if (!had_slot_priorities && !force) {
+      // this source didn't have any effect, skip
+      return false;
+    }
+    // The last merge used per-slot priorities, or we were asked to, so the
+    // data has to be merged again. Use the newest active source as the
+    // changed one.
+    vector<const DmxSource*>::const_iterator source_iter =
+        m_active_sources.begin();
+    changed_source = *source_iter;
+    for (; source_iter != m_active_sources.end(); source_iter++) {
+      if (changed_source->Timestamp() < (*source_iter)->Timestamp()) {
+        changed_source = *source_iter;
+      }
+    }
   }
 
   // only one source at the active priority
-  if (active_sources.size() == 1) {
-    m_buffer.Set(active_sources[0].Data());
+  if (m_active_sources.size() == 1) {
+    m_buffer.Set(m_active_sources[0]->Data());
+    m_htp_merge_valid = false;
   } else {
     // multi source merge
     if (m_merge_mode == Universe::MERGE_LTP) {
-      vector<DmxSource>::const_iterator source_iter = active_sources.begin();
-      DmxSource changed_source;
-      if (port) {
-        changed_source = port->SourceData();
-      } else {
-        changed_source = client->SourceData(UniverseId());
-      }
+      vector<const DmxSource*>::const_iterator source_iter =
+          m_active_sources.begin();
 
       // check that the current port/client is newer than all other active
       // sources
-      for (; source_iter != active_sources.end(); source_iter++) {
-        if (changed_source.Timestamp() < source_iter->Timestamp()) {
+      for (; source_iter != m_active_sources.end(); source_iter++) {
+        if (changed_source->Timestamp() < (*source_iter)->Timestamp()) {
           return false;
         }
       }
       // if we made it to here this is the newest source
-      m_buffer.Set(changed_source.Data());
+      m_buffer.Set(changed_source->Data());
+      m_htp_merge_valid = false;
     } else {
-      HTPMergeSources(active_sources);
+      // If the same sources are active as last time, only the slots that
+      // changed in this source need to be merged again.
+      if (m_htp_merge_valid && !changed_source->SizeChanged() &&
+          m_active_ports == m_merged_ports &&
+          m_active_clients == m_merged_clients) {
+        HTPMergeSlots(m_active_sources, changed_source->ChangedStart(),
+                      changed_source->ChangedEnd());
+      } else {
+        HTPMergeSources(m_active_sources);
+        // Assign rather than swap, so both vectors keep their capacity.
+        m_merged_ports = m_active_ports;
+        m_merged_clients = m_active_clients;
+        m_htp_merge_valid = true;
+      }
     }
   }
+  m_ingress_time = changed_source->Timestamp();
   return true;
 }
 
@@ -816,6 +1606,59 @@ void Universe::DiscoveryComplete(RDMDiscoveryCallback *on_complete) {
 }
 
 
+/*
+ * Find the route for a UID.
+ * @returns an iterator to the route, or m_output_uids.end() if there isn't one.
+ */
+Universe::UIDRoutes::const_iterator Universe::FindRoute(const UID &uid) const {
+  UIDRoutes::const_iterator iter = std::lower_bound(
+      m_output_uids.begin(), m_output_uids.end(), uid, RouteBefore);
+  if (iter != m_output_uids.end() && iter->uid == uid) {
+    return iter;
+  }
+  return m_output_uids.end();
+}
+
+
+/*
+ * Remove any routes to a port.
+ */
+void Universe::RemoveRoutes(const OutputPort *port) {
+  UIDRoutes::iterator out = m_output_uids.begin();
+  UIDRoutes::const_iterator iter = m_output_uids.begin();
+  for (; iter != m_output_uids.end(); ++iter) {
+    if (iter->port != port) {
+      *out++ = *iter;
+    } else if (m_rdm_response_cache) {
+      m_rdm_response_cache->InvalidateUID(m_universe_id, iter->uid);
+    }
+  }
+  m_output_uids.erase(out, m_output_uids.end());
+}
+
+
+/*
+ * Get a tracker for a broadcast request, reusing a free one if we can.
+ */
+Universe::broadcast_request_tracker *Universe::NewBroadcastTracker() {
+  if (m_free_trackers.empty()) {
+    return new broadcast_request_tracker;
+  }
+  broadcast_request_tracker *tracker = m_free_trackers.back();
+  m_free_trackers.pop_back();
+  return tracker;
+}
+
+
+/*
+ * Return a tracker to the free list. The frames vector keeps its capacity.
+ */
+void Universe::ReleaseBroadcastTracker(broadcast_request_tracker *tracker) {
+  tracker->frames.clear();
+  m_free_trackers.push_back(tracker);
+}
+
+
 /**
  * Track fan-out responses for a broadcast request.
  * This increments the port counter until we reach the expected value, and
@@ -831,8 +1674,10 @@ void Universe::HandleBroadcastAck(broadcast_request_tracker *tracker,
 
   if (tracker->current_count == tracker->expected_count) {
     // all ports have completed
-    RunRDMCallback(tracker->callback, tracker->status_code);
-    delete tracker;
+    ola::rdm::RDMCallback *callback = tracker->callback;
+    ola::rdm::RDMStatusCode status_code = tracker->status_code;
+    ReleaseBroadcastTracker(tracker);
+    RunRDMCallback(callback, status_code);
   }
 }
 
@@ -876,12 +1721,21 @@ void Universe::HandleBroadcastDiscovery(
   if (tracker->current_count == tracker->expected_count) {
     // all ports have completed
     RDMReply reply(tracker->status_code, NULL, tracker->frames);
-    tracker->callback->Run(&reply);
-    delete tracker;
+    ola::rdm::RDMCallback *callback = tracker->callback;
+    ReleaseBroadcastTracker(tracker);
+    callback->Run(&reply);
   }
 }
 
 
+/*
+ * Return a pointer to this universe's value in an Export Map variable.
+ */
+unsigned int *Universe::UniverseHandle(const char *name) {
+  return m_export_map->GetUIntMapVar(name)->Handle(m_universe_id_str);
+}
+
+
 /*
  * Helper function to increment an Export Map variable
  */
@@ -930,8 +1784,7 @@ bool Universe::GenericAddPort(PortClass *port, vector<PortClass*> *ports) {
  */
 template<class PortClass>
 bool Universe::GenericRemovePort(PortClass *port,
-                                 vector<PortClass*> *ports,
-                                 map<UID, PortClass*> *uid_map) {
+                                 vector<PortClass*> *ports) {
   typename vector<PortClass*>::iterator iter =
     find(ports->begin(), ports->end(), port);
 
@@ -952,18 +1805,6 @@ bool Universe::GenericRemovePort(PortClass *port,
   if (!IsActive()) {
     m_universe_store->AddUniverseGarbageCollection(this);
   }
-
-  // Remove any uids that mapped to this port
-  if (uid_map) {
-    typename map<UID, PortClass*>::iterator uid_iter = uid_map->begin();
-    while (uid_iter != uid_map->end()) {
-      if (uid_iter->second == port) {
-        uid_map->erase(uid_iter++);
-      } else {
-        ++uid_iter;
-      }
-    }
-  }
   return true;
 }
 
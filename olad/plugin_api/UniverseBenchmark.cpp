@@ -0,0 +1,205 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UniverseBenchmark.cpp
+ * Microbenchmarks for merging & writing universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/base/Array.h"
+#include "ola/io/SelectServer.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/testing/Benchmark.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/Port.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::Universe;
+using ola::testing::Benchmark;
+using std::string;
+using std::vector;
+
+namespace {
+
+class BenchmarkInputPort: public ola::BasicInputPort {
+ public:
+  BenchmarkInputPort(unsigned int port_id,
+                     const ola::PluginAdaptor *plugin_adaptor)
+      : ola::BasicInputPort(NULL, port_id, plugin_adaptor) {}
+
+  string Description() const { return ""; }
+  void SetData(const DmxBuffer &buffer) { m_buffer = buffer; }
+  const DmxBuffer &ReadDMX() const { return m_buffer; }
+
+ private:
+  DmxBuffer m_buffer;
+};
+
+
+class BenchmarkOutputPort: public ola::BasicOutputPort {
+ public:
+  explicit BenchmarkOutputPort(unsigned int port_id)
+      : ola::BasicOutputPort(NULL, port_id),
+        m_slots(0) {
+  }
+
+  string Description() const { return ""; }
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t) {
+    m_slots += buffer.Size();
+    return true;
+  }
+
+ private:
+  unsigned int m_slots;
+};
+
+
+class UniverseBenchmark {
+ public:
+  UniverseBenchmark()
+      : m_plugin_adaptor(NULL, &m_ss, NULL, NULL, NULL, NULL),
+        m_store(NULL, NULL),
+        m_universe(NULL),
+        m_next_universe(1) {
+    uint8_t data[ola::DMX_UNIVERSE_SIZE];
+    for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+      data[i] = static_cast<uint8_t>(i * 7);
+    }
+    m_buffer.Set(data, sizeof(data));
+  }
+
+  ~UniverseBenchmark() { Reset(); }
+
+  /*
+   * Create a new HTP universe with source_count input ports.
+   */
+  void SetupInputs(unsigned int source_count) {
+    Reset();
+    RefreshWakeUpTime();
+    m_universe = m_store.GetUniverseOrCreate(m_next_universe++);
+    m_universe->SetMergeMode(Universe::MERGE_HTP);
+    for (unsigned int i = 0; i < source_count; i++) {
+      BenchmarkInputPort *port = new BenchmarkInputPort(i, &m_plugin_adaptor);
+      DmxBuffer data(m_buffer);
+      data.SetChannel(i, 255);
+      port->SetData(data);
+      port->SetUniverse(m_universe);
+      m_universe->AddPort(port);
+      port->DmxChanged();
+      m_input_ports.push_back(port);
+    }
+  }
+
+  /*
+   * Create a new universe with port_count output ports.
+   */
+  void SetupOutputs(unsigned int port_count) {
+    Reset();
+    m_universe = m_store.GetUniverseOrCreate(m_next_universe++);
+    for (unsigned int i = 0; i < port_count; i++) {
+      BenchmarkOutputPort *port = new BenchmarkOutputPort(i);
+      port->SetUniverse(m_universe);
+      m_universe->AddPort(port);
+      m_output_ports.push_back(port);
+    }
+  }
+
+  /*
+   * Signal new data on one input, which merges all of them.
+   */
+  void MergeAll(unsigned int iterations) {
+    // Sources time out if the wake up time isn't updated.
+    RefreshWakeUpTime();
+    for (unsigned int i = 0; i < iterations; i++) {
+      m_input_ports[i % m_input_ports.size()]->DmxChanged();
+    }
+  }
+
+  /*
+   * Write new data to all the output ports.
+   */
+  void FanOut(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      m_universe->SetDMX(m_buffer);
+    }
+  }
+
+ private:
+  ola::io::SelectServer m_ss;
+  ola::PluginAdaptor m_plugin_adaptor;
+  ola::UniverseStore m_store;
+  Universe *m_universe;
+  unsigned int m_next_universe;
+  DmxBuffer m_buffer;
+  vector<BenchmarkInputPort*> m_input_ports;
+  vector<BenchmarkOutputPort*> m_output_ports;
+
+  void RefreshWakeUpTime() {
+    m_ss.RunOnce(ola::TimeInterval(0, 0));
+  }
+
+  void Reset() {
+    vector<BenchmarkInputPort*>::iterator input_iter = m_input_ports.begin();
+    for (; input_iter != m_input_ports.end(); ++input_iter) {
+      m_universe->RemovePort(*input_iter);
+    }
+    vector<BenchmarkOutputPort*>::iterator output_iter =
+        m_output_ports.begin();
+    for (; output_iter != m_output_ports.end(); ++output_iter) {
+      m_universe->RemovePort(*output_iter);
+    }
+    ola::STLDeleteElements(&m_input_ports);
+    ola::STLDeleteElements(&m_output_ports);
+    m_store.GarbageCollectUniverses();
+    m_universe = NULL;
+  }
+};
+}  // namespace
+
+
+int main() {
+  ola::InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_STDERR);
+
+  UniverseBenchmark fixture;
+  Benchmark benchmark("Universe", &std::cout);
+
+  const unsigned int source_counts[] = {1, 2, 8, 32};
+  for (unsigned int i = 0; i < arraysize(source_counts); i++) {
+    fixture.SetupInputs(source_counts[i]);
+    benchmark.Run("MergeAll", source_counts[i],
+                  NewCallback(&fixture, &UniverseBenchmark::MergeAll));
+  }
+
+  const unsigned int port_counts[] = {1, 8, 32, 128};
+  for (unsigned int i = 0; i < arraysize(port_counts); i++) {
+    fixture.SetupOutputs(port_counts[i]);
+    benchmark.Run("UpdateDependants", port_counts[i],
+                  NewCallback(&fixture, &UniverseBenchmark::FanOut));
+  }
+  return 0;
+}
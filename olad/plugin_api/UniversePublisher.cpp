@@ -0,0 +1,87 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UniversePublisher.cpp
+ * Publishes the merged data of each universe to shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/UniversePublisher.h"
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+
+namespace ola {
+
+using ola::dmx::SharedMemoryFrames;
+using ola::thread::INVALID_TIMEOUT;
+
+const char UniversePublisher::K_PUBLISHED_FRAMES_VAR[] =
+    "universe-publish-frames";
+const char UniversePublisher::K_PUBLISH_DROPPED_VAR[] =
+    "universe-publish-dropped";
+
+
+UniversePublisher::UniversePublisher(
+    ola::thread::SchedulerInterface *scheduler,
+    SharedMemoryFrames *frames,
+    ExportMap *export_map)
+    : m_scheduler(scheduler),
+      m_frames(frames),
+      m_wake_timeout(INVALID_TIMEOUT),
+      m_published_var(NULL),
+      m_dropped_var(NULL) {
+  if (export_map) {
+    m_published_var = export_map->GetCounterVar(K_PUBLISHED_FRAMES_VAR);
+    m_dropped_var = export_map->GetCounterVar(K_PUBLISH_DROPPED_VAR);
+  }
+}
+
+
+UniversePublisher::~UniversePublisher() {
+  if (m_wake_timeout != INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_wake_timeout);
+  }
+}
+
+
+void UniversePublisher::Publish(unsigned int universe, uint8_t priority,
+                                const DmxBuffer &buffer) {
+  if (!m_frames->Write(universe, priority, buffer)) {
+    if (m_dropped_var) {
+      (*m_dropped_var)++;
+    }
+    OLA_DEBUG << "No shared memory slot to publish universe " << universe;
+    return;
+  }
+
+  if (m_published_var) {
+    (*m_published_var)++;
+  }
+
+  // A 0ms timeout runs on the next pass through the event loop, by which
+  // time any other universes updated by the same event have been written.
+  if (m_wake_timeout == INVALID_TIMEOUT) {
+    m_wake_timeout = m_scheduler->RegisterSingleTimeout(
+        0, NewSingleCallback(this, &UniversePublisher::WakeReaders));
+  }
+}
+
+
+void UniversePublisher::WakeReaders() {
+  m_wake_timeout = INVALID_TIMEOUT;
+  m_frames->WakeReaders();
+}
+}  // namespace ola
@@ -0,0 +1,89 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UniversePublisher.h
+ * Publishes the merged data of each universe to shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_UNIVERSEPUBLISHER_H_
+#define OLAD_PLUGIN_API_UNIVERSEPUBLISHER_H_
+
+#include <stdint.h>
+#include <memory>
+
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/dmx/SharedMemoryFrames.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+
+/**
+ * @brief Writes each universe's output to a shared memory segment.
+ *
+ * Local processes that only read the output, like visualizers and loggers,
+ * can map the segment with ola::dmx::SharedMemoryFrames::Open() rather than
+ * registering for DMX over RPC. Publishing a frame costs the same however
+ * many readers there are.
+ *
+ * Readers that block in SharedMemoryFrames::WaitForFrame() are woken once
+ * per pass through the event loop, rather than once per frame, so a burst
+ * of universe updates costs a single system call.
+ */
+class UniversePublisher {
+ public:
+  /**
+   * @brief Create a new UniversePublisher.
+   * @param scheduler the SchedulerInterface used to wake readers.
+   * @param frames the segment to write to, ownership is transferred.
+   * @param export_map the ExportMap to update, may be NULL.
+   */
+  UniversePublisher(ola::thread::SchedulerInterface *scheduler,
+                    ola::dmx::SharedMemoryFrames *frames,
+                    ExportMap *export_map = NULL);
+  ~UniversePublisher();
+
+  /**
+   * @brief Publish the latest data for a universe.
+   * @param universe the universe id.
+   * @param priority the priority of the data.
+   * @param buffer the merged data.
+   */
+  void Publish(unsigned int universe, uint8_t priority,
+               const DmxBuffer &buffer);
+
+  /**
+   * @brief The name of the shared memory segment.
+   */
+  const std::string &Name() const { return m_frames->Name(); }
+
+  static const char K_PUBLISHED_FRAMES_VAR[];
+  static const char K_PUBLISH_DROPPED_VAR[];
+
+ private:
+  ola::thread::SchedulerInterface *m_scheduler;
+  std::auto_ptr<ola::dmx::SharedMemoryFrames> m_frames;
+  ola::thread::timeout_id m_wake_timeout;
+  CounterVariable *m_published_var;
+  CounterVariable *m_dropped_var;
+
+  void WakeReaders();
+
+  DISALLOW_COPY_AND_ASSIGN(UniversePublisher);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_UNIVERSEPUBLISHER_H_
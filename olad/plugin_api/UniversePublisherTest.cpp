@@ -0,0 +1,168 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UniversePublisherTest.cpp
+ * Test fixture for the UniversePublisher class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/SharedMemoryFrames.h"
+#include "ola/rdm/UID.h"
+#include "olad/DmxSource.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniversePublisher.h"
+#include "olad/plugin_api/UniverseStore.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::Universe;
+using ola::UniversePublisher;
+using ola::UniverseStore;
+using ola::dmx::SharedMemoryFrames;
+using std::auto_ptr;
+using std::string;
+
+
+class UniversePublisherTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(UniversePublisherTest);
+  CPPUNIT_TEST(testPublish);
+  CPPUNIT_TEST(testUniverseOutput);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testPublish();
+  void testUniverseOutput();
+
+ private:
+  MockScheduler m_scheduler;
+  ExportMap m_export_map;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UniversePublisherTest);
+
+
+/*
+ * Check frames are published and readers are woken once per batch.
+ */
+void UniversePublisherTest::testPublish() {
+#ifdef HAVE_SYS_MMAN_H
+  SharedMemoryFrames *frames = SharedMemoryFrames::Create(
+      SharedMemoryFrames::UniqueName(), 2);
+  OLA_ASSERT_NOT_NULL(frames);
+  UniversePublisher publisher(&m_scheduler, frames, &m_export_map);
+
+  auto_ptr<SharedMemoryFrames> reader(
+      SharedMemoryFrames::Open(publisher.Name()));
+  OLA_ASSERT_NOT_NULL(reader.get());
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  publisher.Publish(1, 100, buffer);
+  publisher.Publish(2, 50, buffer);
+  OLA_ASSERT_EQ(2u, reader->FrameCount());
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(ola::TimeInterval(), m_scheduler.Delay());
+
+  SharedMemoryFrames::Frame frame;
+  OLA_ASSERT_TRUE(reader->Read(0, &frame));
+  OLA_ASSERT_EQ(1u, frame.universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), frame.priority);
+  OLA_ASSERT_EQ(buffer, frame.data);
+  OLA_ASSERT_TRUE(reader->Read(1, &frame));
+  OLA_ASSERT_EQ(2u, frame.universe);
+
+  m_scheduler.RunTimeouts();
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+
+  // There are only two slots.
+  publisher.Publish(3, 100, buffer);
+  OLA_ASSERT_EQ(2u, reader->FrameCount());
+  OLA_ASSERT_EQ(0u, m_scheduler.TimeoutCount());
+  OLA_ASSERT_EQ(
+      1u,
+      m_export_map.GetCounterVar(UniversePublisher::K_PUBLISH_DROPPED_VAR)
+          ->Get());
+  OLA_ASSERT_EQ(
+      2u,
+      m_export_map.GetCounterVar(UniversePublisher::K_PUBLISHED_FRAMES_VAR)
+          ->Get());
+
+  // A pending wake up is cancelled when the publisher is deleted.
+  publisher.Publish(1, 100, buffer);
+  OLA_ASSERT_EQ(1u, m_scheduler.TimeoutCount());
+#endif  // HAVE_SYS_MMAN_H
+}
+
+
+/*
+ * Check the universes in a store publish their output.
+ */
+void UniversePublisherTest::testUniverseOutput() {
+#ifdef HAVE_SYS_MMAN_H
+  UniversePublisher publisher(
+      &m_scheduler,
+      SharedMemoryFrames::Create(SharedMemoryFrames::UniqueName(), 4));
+  auto_ptr<SharedMemoryFrames> reader(
+      SharedMemoryFrames::Open(publisher.Name()));
+  OLA_ASSERT_NOT_NULL(reader.get());
+
+  UniverseStore store(NULL, NULL);
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  store.SetUniversePublisher(&publisher);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+
+  ola::Clock clock;
+  ola::TimeStamp now;
+  clock.CurrentTime(&now);
+  DmxBuffer buffer;
+  buffer.SetFromString("10,20,30");
+  ola::DmxSource source(buffer, now, 120);
+  ola::Client client(NULL, ola::rdm::UID(ola::OPEN_LIGHTING_ESTA_CODE, 0));
+  client.DMXReceived(2, source);
+  universe2->SourceClientDataChanged(&client);
+  client.DMXReceived(1, source);
+  universe1->SourceClientDataChanged(&client);
+  OLA_ASSERT_EQ(2u, reader->FrameCount());
+
+  SharedMemoryFrames::Frame frame;
+  OLA_ASSERT_TRUE(reader->Read(0, &frame));
+  OLA_ASSERT_EQ(2u, frame.universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(120), frame.priority);
+  OLA_ASSERT_EQ(buffer, frame.data);
+  OLA_ASSERT_TRUE(reader->Read(1, &frame));
+  OLA_ASSERT_EQ(1u, frame.universe);
+
+  store.SetUniversePublisher(NULL);
+  universe1->SourceClientDataChanged(&client);
+  OLA_ASSERT_EQ(2u, reader->FrameCount());
+  universe1->RemoveSourceClient(&client);
+  universe2->RemoveSourceClient(&client);
+#endif  // HAVE_SYS_MMAN_H
+}
@@ -22,6 +22,7 @@
 #include "olad/plugin_api/UniverseStore.h"
 
 #include <iostream>
+#include <queue>
 #include <set>
 #include <sstream>
 #include <string>
@@ -43,17 +44,35 @@ using std::string;
 using std::vector;
 
 const unsigned int UniverseStore::MINIMUM_RDM_DISCOVERY_INTERVAL = 30;
+// This covers the universe ranges of Art-Net (15 bit) & E1.31 (1 - 63999).
+const unsigned int UniverseStore::MAX_INDEXED_UNIVERSE = 65536;
 
 UniverseStore::UniverseStore(Preferences *preferences,
                              ExportMap *export_map)
     : m_preferences(preferences),
-      m_export_map(export_map) {
+      m_export_map(export_map),
+      m_output_scheduler(NULL),
+      m_discovery_scheduler(NULL),
+      m_rdm_response_cache(NULL),
+      m_rate_limiter(NULL),
+      m_publisher(NULL),
+      m_output_held(false),
+      m_loop_clock(NULL),
+      m_client_generation(0),
+      m_client_serial(0) {
   if (export_map) {
     export_map->GetStringMapVar(Universe::K_UNIVERSE_NAME_VAR, "universe");
     export_map->GetStringMapVar(Universe::K_UNIVERSE_MODE_VAR, "universe");
+    export_map->GetHistogramMapVar(Universe::K_LATENCY_VAR, "universe");
 
     const char *vars[] = {
       Universe::K_FPS_VAR,
+      Universe::K_LATENCY_P50_VAR,
+      Universe::K_LATENCY_P99_VAR,
+      Universe::K_LATENCY_P999_VAR,
+      Universe::K_OUTPUT_COALESCED_VAR,
+      Universe::K_OUTPUT_DEFERRED_VAR,
+      Universe::K_OUTPUT_SUPPRESSED_VAR,
       Universe::K_UNIVERSE_INPUT_PORT_VAR,
       Universe::K_UNIVERSE_OUTPUT_PORT_VAR,
       Universe::K_UNIVERSE_SINK_CLIENTS_VAR,
@@ -72,10 +91,20 @@ UniverseStore::~UniverseStore() {
 }
 
 Universe *UniverseStore::GetUniverse(unsigned int universe_id) const {
+  if (universe_id < m_universe_index.size()) {
+    return m_universe_index[universe_id];
+  } else if (universe_id < MAX_INDEXED_UNIVERSE) {
+    return NULL;
+  }
   return STLFindOrNull(m_universe_map, universe_id);
 }
 
 Universe *UniverseStore::GetUniverseOrCreate(unsigned int universe_id) {
+  Universe *universe = GetUniverse(universe_id);
+  if (universe) {
+    return universe;
+  }
+
   UniverseMap::iterator iter = STLLookupOrInsertNull(
       &m_universe_map, universe_id);
 
@@ -83,6 +112,15 @@ Universe *UniverseStore::GetUniverseOrCreate(unsigned int universe_id) {
     iter->second = new Universe(universe_id, this, m_export_map, &m_clock);
 
     if (iter->second) {
+      AddToIndex(iter->second);
+      iter->second->SetOutputScheduler(m_output_scheduler);
+      iter->second->SetDiscoveryScheduler(m_discovery_scheduler);
+      iter->second->SetRDMResponseCache(m_rdm_response_cache);
+      iter->second->SetOutputKeepalive(m_output_keepalive);
+      iter->second->SetLoopClock(m_loop_clock);
+      iter->second->SetOutputRateLimiter(m_rate_limiter);
+      iter->second->SetUniversePublisher(m_publisher);
+      iter->second->SetOutputHold(m_output_held);
       if (m_preferences) {
         RestoreUniverseSettings(iter->second);
       }
@@ -97,6 +135,70 @@ void UniverseStore::GetList(vector<Universe*> *universes) const {
   STLValues(m_universe_map, universes);
 }
 
+void UniverseStore::SetOutputScheduler(OutputScheduler *scheduler) {
+  m_output_scheduler = scheduler;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetOutputScheduler(scheduler);
+  }
+}
+
+void UniverseStore::SetDiscoveryScheduler(DiscoveryScheduler *scheduler) {
+  m_discovery_scheduler = scheduler;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetDiscoveryScheduler(scheduler);
+  }
+}
+
+void UniverseStore::SetRDMResponseCache(RDMResponseCache *cache) {
+  m_rdm_response_cache = cache;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetRDMResponseCache(cache);
+  }
+}
+
+void UniverseStore::SetOutputKeepalive(const TimeInterval &interval) {
+  m_output_keepalive = interval;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetOutputKeepalive(interval);
+  }
+}
+
+void UniverseStore::SetOutputRateLimiter(OutputRateLimiter *limiter) {
+  m_rate_limiter = limiter;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetOutputRateLimiter(limiter);
+  }
+}
+
+void UniverseStore::SetUniversePublisher(UniversePublisher *publisher) {
+  m_publisher = publisher;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetUniversePublisher(publisher);
+  }
+}
+
+void UniverseStore::SetOutputHold(bool hold) {
+  m_output_held = hold;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetOutputHold(hold);
+  }
+}
+
+void UniverseStore::SetLoopClock(Clock *clock) {
+  m_loop_clock = clock;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetLoopClock(clock);
+  }
+}
+
 void UniverseStore::DeleteAll() {
   UniverseMap::iterator iter;
 
@@ -106,6 +208,9 @@ void UniverseStore::DeleteAll() {
   }
   m_deletion_candiates.clear();
   m_universe_map.clear();
+  m_universe_index.clear();
+  m_client_checks = std::priority_queue<SourceClientCheck>();
+  m_layer_dependants.clear();
 }
 
 void UniverseStore::AddUniverseGarbageCollection(Universe *universe) {
@@ -121,12 +226,159 @@ void UniverseStore::GarbageCollectUniverses() {
     if (!(*iter)->IsActive()) {
       SaveUniverseSettings(*iter);
       m_universe_map.erase((*iter)->UniverseId());
+      RemoveFromIndex((*iter)->UniverseId());
       delete *iter;
     }
   }
   m_deletion_candiates.clear();
 }
 
+unsigned int UniverseStore::ReleaseIdleBuffers() {
+  unsigned int idle = 0;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    if (iter->second->ReleaseIdleBuffers()) {
+      idle++;
+    }
+  }
+  return idle;
+}
+
+void UniverseStore::CleanStaleSourceClients() {
+  m_client_generation++;
+
+  // Entries are re-queued once they have been checked, so collect them first.
+  vector<SourceClientCheck> due;
+  while (!m_client_checks.empty() &&
+         m_client_checks.top().generation <= m_client_generation) {
+    due.push_back(m_client_checks.top());
+    m_client_checks.pop();
+  }
+
+  vector<SourceClientCheck>::iterator iter = due.begin();
+  for (; iter != due.end(); ++iter) {
+    Universe *universe = GetUniverse(iter->universe_id);
+    if (!universe) {
+      continue;
+    }
+
+    unsigned int next_check = universe->CheckSourceClient(
+        iter->client, iter->serial, m_client_generation);
+    if (next_check) {
+      iter->generation = next_check;
+      m_client_checks.push(*iter);
+    }
+  }
+}
+
+unsigned int UniverseStore::WatchSourceClient(const Universe *universe,
+                                              Client *client) {
+  SourceClientCheck check;
+  check.generation = m_client_generation + 2;
+  check.universe_id = universe->UniverseId();
+  check.client = client;
+  check.serial = ++m_client_serial;
+  m_client_checks.push(check);
+  return check.serial;
+}
+
+bool UniverseStore::SetLayers(Universe *universe,
+                              const vector<Universe::Layer> &layers) {
+  const unsigned int universe_id = universe->UniverseId();
+  vector<Universe::Layer>::const_iterator iter = layers.begin();
+  for (; iter != layers.end(); ++iter) {
+    if (LayerReaches(iter->universe, universe_id)) {
+      OLA_WARN << "Layer " << iter->universe << " of universe "
+               << universe_id << " would create a cycle";
+      return false;
+    }
+  }
+
+  for (iter = universe->Layers().begin(); iter != universe->Layers().end();
+       ++iter) {
+    LayerDependantMap::iterator dependants = m_layer_dependants.find(
+        iter->universe);
+    if (dependants != m_layer_dependants.end()) {
+      dependants->second.erase(universe_id);
+      if (dependants->second.empty()) {
+        m_layer_dependants.erase(dependants);
+      }
+    }
+  }
+
+  for (iter = layers.begin(); iter != layers.end(); ++iter) {
+    m_layer_dependants[iter->universe].insert(universe_id);
+  }
+  universe->SetLayers(layers);
+  return true;
+}
+
+
+void UniverseStore::LayerSourceChanged(unsigned int universe_id) {
+  if (m_layer_dependants.empty()) {
+    return;
+  }
+  LayerDependantMap::const_iterator dependants = m_layer_dependants.find(
+      universe_id);
+  if (dependants == m_layer_dependants.end()) {
+    return;
+  }
+
+  // The graph is acyclic, so this always terminates.
+  set<unsigned int>::const_iterator iter = dependants->second.begin();
+  for (; iter != dependants->second.end(); ++iter) {
+    Universe *universe = GetUniverse(*iter);
+    if (universe) {
+      universe->LayerInputChanged();
+    }
+  }
+}
+
+
+/*
+ * Check if a universe is, or depends on, the target universe via its layers.
+ */
+bool UniverseStore::LayerReaches(unsigned int universe_id,
+                                 unsigned int target) const {
+  if (universe_id == target) {
+    return true;
+  }
+  const Universe *universe = GetUniverse(universe_id);
+  if (!universe) {
+    return false;
+  }
+  vector<Universe::Layer>::const_iterator iter = universe->Layers().begin();
+  for (; iter != universe->Layers().end(); ++iter) {
+    if (LayerReaches(iter->universe, target)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+void UniverseStore::AddToIndex(Universe *universe) {
+  unsigned int universe_id = universe->UniverseId();
+  if (universe_id >= MAX_INDEXED_UNIVERSE) {
+    return;
+  }
+  if (universe_id >= m_universe_index.size()) {
+    m_universe_index.resize(universe_id + 1, NULL);
+  }
+  m_universe_index[universe_id] = universe;
+}
+
+void UniverseStore::RemoveFromIndex(unsigned int universe_id) {
+  if (universe_id >= m_universe_index.size()) {
+    return;
+  }
+  m_universe_index[universe_id] = NULL;
+  // Shrink the index if this was the highest universe.
+  while (!m_universe_index.empty() && !m_universe_index.back()) {
+    m_universe_index.pop_back();
+  }
+}
+
 
 /*
  * Restore a universe's settings
@@ -181,6 +433,40 @@ bool UniverseStore::RestoreUniverseSettings(Universe *universe) const {
         universe->UniverseId() << ", value was " << value;
     }
   }
+
+  // load the maximum output rate
+  key = "uni_" + oss.str() + "_max_output_rate";
+  value = m_preferences->GetValue(key);
+
+  if (!value.empty()) {
+    unsigned int rate;
+    if (StringToInt(value, &rate, true)) {
+      OLA_DEBUG << "Max output rate for " << oss.str() << " is " << rate;
+      universe->SetOutputInterval(
+          rate ? TimeInterval(static_cast<int64_t>(USEC_IN_SECONDS / rate)) :
+                 TimeInterval());
+    } else {
+      OLA_WARN << "Invalid max output rate for universe " <<
+        universe->UniverseId() << ", value was " << value;
+    }
+  }
+
+  // load the keepalive interval for unchanged data, in ms
+  key = "uni_" + oss.str() + "_output_keepalive";
+  value = m_preferences->GetValue(key);
+
+  if (!value.empty()) {
+    unsigned int keepalive;
+    if (StringToInt(value, &keepalive, true)) {
+      OLA_DEBUG << "Output keepalive for " << oss.str() << " is " << keepalive
+                << "ms";
+      universe->SetOutputKeepalive(
+          TimeInterval(static_cast<int64_t>(keepalive) * ONE_THOUSAND));
+    } else {
+      OLA_WARN << "Invalid output keepalive for universe " <<
+        universe->UniverseId() << ", value was " << value;
+    }
+  }
   return 0;
 }
 
@@ -207,8 +493,8 @@ bool UniverseStore::SaveUniverseSettings(Universe *universe) const {
   mode = (universe->MergeMode() == Universe::MERGE_HTP ? "HTP" : "LTP");
   m_preferences->SetValue(key, mode);
 
-  // We don't save the RDM Discovery interval since it can only be set in the
-  // config files for now.
+  // We don't save the RDM Discovery interval or the max output rate since
+  // they can only be set in the config files for now.
 
   m_preferences->Save();
 
@@ -22,16 +22,23 @@
 #define OLAD_PLUGIN_API_UNIVERSESTORE_H_
 
 #include <map>
+#include <queue>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "ola/Clock.h"
 #include "ola/base/Macro.h"
+#include "olad/Universe.h"
 
 namespace ola {
 
-class Universe;
+class Client;
+class DiscoveryScheduler;
+class OutputRateLimiter;
+class UniversePublisher;
+class RDMResponseCache;
+class OutputScheduler;
 
 /**
  * @brief Maintains a collection of Universe objects.
@@ -76,6 +83,71 @@ class UniverseStore {
    */
   void GetList(std::vector<Universe*> *universes) const;
 
+  /**
+   * @brief Set the OutputScheduler used by all universes.
+   * @param scheduler the OutputScheduler, or NULL to write every change
+   *   immediately. Ownership is not transferred.
+   */
+  void SetOutputScheduler(OutputScheduler *scheduler);
+
+  /**
+   * @brief Set the DiscoveryScheduler used by all universes.
+   * @param scheduler the DiscoveryScheduler, or NULL to run discovery on the
+   *   ports directly. Ownership is not transferred.
+   */
+  void SetDiscoveryScheduler(DiscoveryScheduler *scheduler);
+
+  /**
+   * @brief Set the RDMResponseCache used by all universes.
+   * @param cache the RDMResponseCache, or NULL to send every RDM request to
+   *   the devices. Ownership is not transferred.
+   */
+  void SetRDMResponseCache(RDMResponseCache *cache);
+
+  /**
+   * @brief Set the default keepalive interval for unchanged data.
+   * @param interval the interval, zero means every update is written.
+   *
+   * This applies to all universes, unless the universe has its own setting
+   * in the preferences.
+   * @sa Universe::SetOutputKeepalive()
+   */
+  void SetOutputKeepalive(const TimeInterval &interval);
+
+  /**
+   * @brief Set the Clock used by all universes for the per-update checks.
+   * @param clock the Clock, or NULL to read the system clock. Ownership is
+   *   not transferred.
+   * @sa Universe::SetLoopClock()
+   */
+  void SetLoopClock(Clock *clock);
+
+  /**
+   * @brief Set the OutputRateLimiter used by all universes.
+   * @param limiter the OutputRateLimiter, or NULL to ignore the port rate
+   *   limits. Ownership is not transferred.
+   */
+  void SetOutputRateLimiter(OutputRateLimiter *limiter);
+
+  /**
+   * @brief Set the UniversePublisher used by all universes.
+   * @param publisher the UniversePublisher, or NULL to stop publishing.
+   *   Ownership is not transferred.
+   */
+  void SetUniversePublisher(UniversePublisher *publisher);
+
+  /**
+   * @brief Hold the writes to the output ports of all universes.
+   * @param hold true to hold the writes, false to release them.
+   * @sa Universe::SetOutputHold()
+   */
+  void SetOutputHold(bool hold);
+
+  /**
+   * @brief Check if the writes to the output ports are held.
+   */
+  bool OutputHeld() const { return m_output_held; }
+
   /**
    * @brief Delete all universes.
    */
@@ -92,20 +164,107 @@ class UniverseStore {
    */
   void GarbageCollectUniverses();
 
+  /**
+   * @brief Free the scratch buffers of universes that are idle.
+   * @returns the number of idle universes.
+   *
+   * This should be called periodically. A universe is idle if it hasn't sent
+   * data since the previous call, see Universe::ReleaseIdleBuffers().
+   */
+  unsigned int ReleaseIdleBuffers();
+
+  /**
+   * @brief Remove any source clients that haven't sent data recently.
+   *
+   * This should be called periodically. A source client is removed if it
+   * hasn't sent data to a universe since the previous call. Only the clients
+   * that are due to be checked are visited, so universes without source
+   * clients cost nothing.
+   */
+  void CleanStaleSourceClients();
+
+  /**
+   * @brief Start tracking a source client of a universe.
+   * @param universe the universe the client was added to.
+   * @param client the new source client.
+   * @returns the serial number of the entry, which is passed back to
+   *   Universe::CheckSourceClient().
+   */
+  unsigned int WatchSourceClient(const Universe *universe, Client *client);
+
+  /**
+   * @brief Return the current generation of stale client checks.
+   *
+   * This is incremented each time CleanStaleSourceClients() is called.
+   */
+  unsigned int SourceClientGeneration() const { return m_client_generation; }
+
+  /**
+   * @brief Set the layers of a virtual universe.
+   * @param universe the universe to set the layers of.
+   * @param layers the layers, see Universe::SetLayers().
+   * @returns false if the layers would create a cycle, in which case the
+   *   universe isn't changed.
+   *
+   * The layer universes don't have to exist yet.
+   */
+  bool SetLayers(Universe *universe,
+                 const std::vector<Universe::Layer> &layers);
+
+  /**
+   * @brief Called when the data in a universe changes, this updates the
+   * virtual universes with a layer from that universe.
+   * @param universe_id the universe that changed.
+   */
+  void LayerSourceChanged(unsigned int universe_id);
+
  private:
+  struct SourceClientCheck {
+    unsigned int generation;
+    unsigned int universe_id;
+    Client *client;
+    unsigned int serial;
+
+    // Reversed, so the priority_queue returns the earliest check first.
+    bool operator<(const SourceClientCheck &other) const {
+      return generation > other.generation;
+    }
+  };
+
   typedef std::map<unsigned int, Universe*> UniverseMap;
+  typedef std::map<unsigned int, std::set<unsigned int> > LayerDependantMap;
 
   Preferences *m_preferences;
   ExportMap *m_export_map;
+  OutputScheduler *m_output_scheduler;
+  DiscoveryScheduler *m_discovery_scheduler;
+  RDMResponseCache *m_rdm_response_cache;
+  OutputRateLimiter *m_rate_limiter;
+  UniversePublisher *m_publisher;
+  TimeInterval m_output_keepalive;
+  bool m_output_held;
+  Clock *m_loop_clock;
   UniverseMap m_universe_map;
+  // Universes with an id below MAX_INDEXED_UNIVERSE are also stored here, so
+  // they can be found without walking the map.
+  std::vector<Universe*> m_universe_index;
   std::set<Universe*> m_deletion_candiates;  // list of universes we may be
                                              // able to delete
   Clock m_clock;
+  std::priority_queue<SourceClientCheck> m_client_checks;
+  unsigned int m_client_generation;
+  unsigned int m_client_serial;
+  // Maps each universe to the virtual universes that have it as a layer.
+  LayerDependantMap m_layer_dependants;
 
+  void AddToIndex(Universe *universe);
+  void RemoveFromIndex(unsigned int universe_id);
+  bool LayerReaches(unsigned int universe_id, unsigned int target) const;
   bool RestoreUniverseSettings(Universe *universe) const;
   bool SaveUniverseSettings(Universe *universe) const;
 
   static const unsigned int MINIMUM_RDM_DISCOVERY_INTERVAL;
+  static const unsigned int MAX_INDEXED_UNIVERSE;
 
   DISALLOW_COPY_AND_ASSIGN(UniverseStore);
 };
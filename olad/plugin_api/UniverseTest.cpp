@@ -19,14 +19,19 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <stdlib.h>
+#include <unistd.h>
 #include <iostream>
+#include <new>
 #include <string>
 #include <vector>
 
+#include "ola/base/Array.h"
 #include "ola/Callback.h"
 #include "ola/Constants.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMReply.h"
 #include "ola/rdm/RDMResponseCodes.h"
@@ -49,6 +54,7 @@ using ola::Clock;
 using ola::DmxBuffer;
 using ola::NewCallback;
 using ola::NewSingleCallback;
+using ola::TimeInterval;
 using ola::TimeStamp;
 using ola::Universe;
 using ola::rdm::NewDiscoveryUniqueBranchRequest;
@@ -65,17 +71,51 @@ using std::vector;
 static unsigned int TEST_UNIVERSE = 1;
 static const char TEST_DATA[] = "this is some test data";
 
+// Used by testMergeAllocations to count heap allocations.
+static bool count_allocations = false;
+static unsigned int allocation_count = 0;
+
+#if __cplusplus >= 201103L
+void *operator new(size_t size) {
+#else
+void *operator new(size_t size) throw(std::bad_alloc) {
+#endif  // __cplusplus >= 201103L
+  if (count_allocations) {
+    allocation_count++;
+  }
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) throw() {
+  free(ptr);
+}
+
 
 class UniverseTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(UniverseTest);
   CPPUNIT_TEST(testLifecycle);
+  CPPUNIT_TEST(testLookup);
   CPPUNIT_TEST(testSetGetDmx);
   CPPUNIT_TEST(testSendDmx);
+  CPPUNIT_TEST(testFanoutOrder);
   CPPUNIT_TEST(testReceiveDmx);
   CPPUNIT_TEST(testSourceClients);
+  CPPUNIT_TEST(testStaleSourceClients);
   CPPUNIT_TEST(testSinkClients);
   CPPUNIT_TEST(testLtpMerging);
   CPPUNIT_TEST(testHtpMerging);
+  CPPUNIT_TEST(testIncrementalHtpMerging);
+  CPPUNIT_TEST(testSlotPriorityMerging);
+  CPPUNIT_TEST(testMergeAllocations);
+  CPPUNIT_TEST(testLatency);
+  CPPUNIT_TEST(testOutputKeepalive);
+  CPPUNIT_TEST(testOutputHold);
+  CPPUNIT_TEST(testIdleUniverse);
+  CPPUNIT_TEST(testLayers);
   CPPUNIT_TEST(testRDMDiscovery);
   CPPUNIT_TEST(testRDMSend);
   CPPUNIT_TEST_SUITE_END();
@@ -84,13 +124,24 @@ class UniverseTest: public CppUnit::TestFixture {
   void setUp();
   void tearDown();
   void testLifecycle();
+  void testLookup();
   void testSetGetDmx();
   void testSendDmx();
+  void testFanoutOrder();
   void testReceiveDmx();
   void testSourceClients();
+  void testStaleSourceClients();
   void testSinkClients();
   void testLtpMerging();
   void testHtpMerging();
+  void testIncrementalHtpMerging();
+  void testSlotPriorityMerging();
+  void testMergeAllocations();
+  void testLatency();
+  void testOutputKeepalive();
+  void testOutputHold();
+  void testIdleUniverse();
+  void testLayers();
   void testRDMDiscovery();
   void testRDMSend();
 
@@ -124,7 +175,7 @@ class MockClient: public ola::Client {
   }
 
   bool SendDMX(unsigned int universe_id, uint8_t priority,
-               const DmxBuffer &buffer) {
+               const DmxBuffer &buffer, OLA_UNUSED string *serialized) {
     OLA_ASSERT_EQ(TEST_UNIVERSE, universe_id);
     OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_MIN, priority);
     OLA_ASSERT_EQ(string(TEST_DATA), buffer.Get());
@@ -135,6 +186,28 @@ class MockClient: public ola::Client {
 };
 
 
+/*
+ * An output port that records the order of writes.
+ */
+class OrderedOutputPort: public TestMockOutputPort {
+ public:
+  OrderedOutputPort(ola::AbstractDevice *parent,
+                    unsigned int port_id,
+                    vector<unsigned int> *writes)
+      : TestMockOutputPort(parent, port_id),
+        m_writes(writes) {
+  }
+
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
+    m_writes->push_back(PortId());
+    return TestMockOutputPort::WriteDMX(buffer, priority);
+  }
+
+ private:
+  vector<unsigned int> *m_writes;
+};
+
+
 CPPUNIT_TEST_SUITE_REGISTRATION(UniverseTest);
 
 
@@ -191,6 +264,51 @@ void UniverseTest::testLifecycle() {
 }
 
 
+/*
+ * Check universe lookups, both in and outside of the directly indexed range.
+ */
+void UniverseTest::testLookup() {
+  const unsigned int universe_ids[] = {0, 1, 63999, 65535, 65536, 0xffffffff};
+  for (unsigned int i = 0; i < arraysize(universe_ids); i++) {
+    OLA_ASSERT_NULL(m_store->GetUniverse(universe_ids[i]));
+  }
+
+  for (unsigned int i = 0; i < arraysize(universe_ids); i++) {
+    Universe *universe = m_store->GetUniverseOrCreate(universe_ids[i]);
+    OLA_ASSERT_NOT_NULL(universe);
+    OLA_ASSERT_EQ(universe_ids[i], universe->UniverseId());
+    OLA_ASSERT_EQ(universe, m_store->GetUniverse(universe_ids[i]));
+    OLA_ASSERT_EQ(universe, m_store->GetUniverseOrCreate(universe_ids[i]));
+  }
+  OLA_ASSERT_EQ((unsigned int) arraysize(universe_ids),
+                m_store->UniverseCount());
+  OLA_ASSERT_NULL(m_store->GetUniverse(2));
+  OLA_ASSERT_NULL(m_store->GetUniverse(65537));
+
+  vector<Universe*> universes;
+  m_store->GetList(&universes);
+  OLA_ASSERT_EQ((size_t) arraysize(universe_ids), universes.size());
+  for (unsigned int i = 0; i < arraysize(universe_ids); i++) {
+    OLA_ASSERT_EQ(universe_ids[i], universes[i]->UniverseId());
+  }
+
+  // Unused universes are garbage collected
+  m_store->AddUniverseGarbageCollection(m_store->GetUniverse(65535));
+  m_store->AddUniverseGarbageCollection(m_store->GetUniverse(0xffffffff));
+  m_store->GarbageCollectUniverses();
+  OLA_ASSERT_NULL(m_store->GetUniverse(65535));
+  OLA_ASSERT_NULL(m_store->GetUniverse(0xffffffff));
+  OLA_ASSERT_NOT_NULL(m_store->GetUniverse(63999));
+  OLA_ASSERT_NOT_NULL(m_store->GetUniverse(65536));
+  OLA_ASSERT_EQ((unsigned int) 4, m_store->UniverseCount());
+
+  m_store->DeleteAll();
+  for (unsigned int i = 0; i < arraysize(universe_ids); i++) {
+    OLA_ASSERT_NULL(m_store->GetUniverse(universe_ids[i]));
+  }
+}
+
+
 /*
  * Check that SetDMX/GetDMX works
  */
@@ -225,6 +343,14 @@ void UniverseTest::testSendDmx() {
   OLA_ASSERT(universe->SetDMX(m_buffer));
   OLA_ASSERT(m_buffer == port.ReadDMX());
 
+  // with a remap, the port gets the remapped data
+  ola::dmx::SlotRemap remap;
+  OLA_ASSERT(remap.FromString("1-4=6,5=1"));
+  port.SetSlotRemap(remap);
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(string("is st"), port.ReadDMX().Get());
+  port.SetSlotRemap(ola::dmx::SlotRemap());
+
   // remove the port from the universe
   universe->RemovePort(&port);
   OLA_ASSERT_EQ((unsigned int) 0, universe->InputPortCount());
@@ -233,6 +359,55 @@ void UniverseTest::testSendDmx() {
 }
 
 
+/*
+ * Check that the writes to output ports are grouped by plugin.
+ */
+void UniverseTest::testFanoutOrder() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  TestMockPlugin artnet_plugin(NULL, ola::OLA_PLUGIN_ARTNET);
+  TestMockPlugin e131_plugin(NULL, ola::OLA_PLUGIN_E131);
+  MockDevice artnet_device(&artnet_plugin, "artnet");
+  MockDevice e131_device(&e131_plugin, "e131");
+
+  vector<unsigned int> writes;
+  OrderedOutputPort port1(&e131_device, 1, &writes);
+  OrderedOutputPort port2(&artnet_device, 2, &writes);
+  OrderedOutputPort port3(&e131_device, 3, &writes);
+  OrderedOutputPort port4(NULL, 4, &writes);
+  universe->AddPort(&port1);
+  universe->AddPort(&port2);
+  universe->AddPort(&port3);
+  universe->AddPort(&port4);
+
+  MockClient client;
+  universe->AddSinkClient(&client);
+
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT(client.m_dmx_set);
+  OLA_ASSERT_EQ((size_t) 4, writes.size());
+  OLA_ASSERT_EQ(4u, writes[0]);
+  OLA_ASSERT_EQ(2u, writes[1]);
+  OLA_ASSERT_EQ(1u, writes[2]);
+  OLA_ASSERT_EQ(3u, writes[3]);
+
+  // Once a port is removed, it's no longer written to
+  universe->RemovePort(&port1);
+  writes.clear();
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ((size_t) 3, writes.size());
+  OLA_ASSERT_EQ(4u, writes[0]);
+  OLA_ASSERT_EQ(2u, writes[1]);
+  OLA_ASSERT_EQ(3u, writes[2]);
+
+  universe->RemovePort(&port2);
+  universe->RemovePort(&port3);
+  universe->RemovePort(&port4);
+  universe->RemoveSinkClient(&client);
+}
+
+
 /*
  * Check that we update when ports have new data
  */
@@ -263,6 +438,13 @@ void UniverseTest::testReceiveDmx() {
   OLA_ASSERT_EQ(m_buffer.Size(), universe->GetDMX().Size());
   OLA_ASSERT(m_buffer == universe->GetDMX());
 
+  // With a remap, the universe gets the remapped data
+  ola::dmx::SlotRemap remap;
+  OLA_ASSERT(remap.FromString("1-4=6,5=1"));
+  port.SetSlotRemap(remap);
+  port.DmxChanged();
+  OLA_ASSERT_EQ(string("is st"), universe->GetDMX().Get());
+
   // Remove the port from the universe
   universe->RemovePort(&port);
   OLA_ASSERT_FALSE(universe->IsActive());
@@ -312,6 +494,45 @@ void UniverseTest::testSourceClients() {
 }
 
 
+/*
+ * Check that source clients which stop sending data are removed.
+ */
+void UniverseTest::testStaleSourceClients() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  MockClient client1, client2;
+  universe->AddSourceClient(&client1);
+  universe->AddSourceClient(&client2);
+  OLA_ASSERT_EQ((unsigned int) 2, universe->SourceClientCount());
+
+  // Both clients sent data within the first period
+  m_store->CleanStaleSourceClients();
+  OLA_ASSERT_EQ((unsigned int) 2, universe->SourceClientCount());
+
+  // client2 sends again, client1 doesn't
+  universe->AddSourceClient(&client2);
+  m_store->CleanStaleSourceClients();
+  OLA_ASSERT_EQ((unsigned int) 1, universe->SourceClientCount());
+  OLA_ASSERT_FALSE(universe->ContainsSourceClient(&client1));
+  OLA_ASSERT(universe->ContainsSourceClient(&client2));
+
+  // client2 hasn't sent since the last check
+  m_store->CleanStaleSourceClients();
+  OLA_ASSERT_EQ((unsigned int) 0, universe->SourceClientCount());
+
+  // A client that is removed & added again gets a fresh period.
+  universe->AddSourceClient(&client1);
+  m_store->CleanStaleSourceClients();
+  universe->RemoveSourceClient(&client1);
+  universe->AddSourceClient(&client1);
+  m_store->CleanStaleSourceClients();
+  OLA_ASSERT(universe->ContainsSourceClient(&client1));
+  m_store->CleanStaleSourceClients();
+  OLA_ASSERT_FALSE(universe->ContainsSourceClient(&client1));
+}
+
+
 /*
  * Check that we can add/remove sink clients from this universes
  */
@@ -521,6 +742,490 @@ void UniverseTest::testHtpMerging() {
 }
 
 
+/**
+ * Check that updates which only touch a few slots are HTP merged correctly.
+ */
+void UniverseTest::testIncrementalHtpMerging() {
+  DmxBuffer buffer1, buffer2, expected;
+  buffer1.SetFromString("10,20,30,40");
+  buffer2.SetFromString("40,30,20,10,5");
+
+  ola::PortBroker broker;
+  ola::PortManager port_manager(m_store, &broker);
+
+  TimeStamp time_stamp;
+  MockSelectServer ss(&time_stamp);
+  ola::PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  MockDevice device(NULL, "foo");
+  MockDevice device2(NULL, "bar");
+  TestMockInputPort port(&device, 1, &plugin_adaptor);  // input port
+  TestMockInputPort port2(&device2, 1, &plugin_adaptor);  // input port
+  port_manager.PatchPort(&port, TEST_UNIVERSE);
+  port_manager.PatchPort(&port2, TEST_UNIVERSE);
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+
+  m_clock.CurrentTime(&time_stamp);
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  port2.WriteDMX(buffer2);
+  port2.DmxChanged();
+  expected.SetFromString("40,30,30,40,5");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+
+  // raise a single slot above the other source
+  buffer1.SetChannel(1, 200);
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  expected.SetFromString("40,200,30,40,5");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+
+  // drop it again, the other source should now win this slot
+  buffer1.SetChannel(1, 0);
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  expected.SetFromString("40,30,30,40,5");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+
+  // an update that doesn't change anything
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+
+  // change the other source, including the slot past the end of buffer1
+  buffer2.SetChannel(0, 0);
+  buffer2.SetChannel(4, 99);
+  port2.WriteDMX(buffer2);
+  port2.DmxChanged();
+  expected.SetFromString("10,30,30,40,99");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+
+  // grow the first source, this forces a full merge
+  buffer1.SetFromString("10,0,30,40,0,1");
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  expected.SetFromString("10,30,30,40,99,1");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+
+  // SetDMX overrides the merge, the next update must merge everything again
+  DmxBuffer override_buffer;
+  override_buffer.SetFromString("1,1,1,1,1,1");
+  universe->SetDMX(override_buffer);
+  OLA_ASSERT_EQ(override_buffer, universe->GetDMX());
+  buffer1.SetChannel(0, 11);
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  expected.SetFromString("11,30,30,40,99,1");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+
+  // clean up
+  universe->RemovePort(&port);
+  universe->RemovePort(&port2);
+  OLA_ASSERT_FALSE(universe->IsActive());
+}
+
+
+/*
+ * Check that per-slot priorities are merged slot by slot.
+ */
+void UniverseTest::testSlotPriorityMerging() {
+  DmxBuffer buffer1, buffer2, slot_priorities, expected, expected_priorities;
+  buffer1.SetFromString("10,20,30,40");
+  buffer2.SetFromString("40,30,20,10,5");
+
+  ola::PortBroker broker;
+  ola::PortManager port_manager(m_store, &broker);
+
+  TimeStamp time_stamp;
+  MockSelectServer ss(&time_stamp);
+  ola::PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  MockDevice device(NULL, "foo");
+  MockDevice device2(NULL, "bar");
+  TestMockPriorityInputPort port(&device, 1, &plugin_adaptor);
+  TestMockPriorityInputPort port2(&device2, 1, &plugin_adaptor);
+  port.SetPriorityMode(ola::PRIORITY_MODE_INHERIT);
+  port2.SetPriorityMode(ola::PRIORITY_MODE_INHERIT);
+  port_manager.PatchPort(&port, TEST_UNIVERSE);
+  port_manager.PatchPort(&port2, TEST_UNIVERSE);
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetMergeMode(Universe::MERGE_LTP);
+
+  // port has a higher priority than port2 for slots 0 & 1, the same priority
+  // for slot 2 and doesn't source slot 3.
+  m_clock.CurrentTime(&time_stamp);
+  slot_priorities.SetFromString("150,150,100,0");
+  port.SetInheritedSlotPriorities(slot_priorities);
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  port2.WriteDMX(buffer2);
+  port2.DmxChanged();
+
+  expected.SetFromString("10,20,30,10,5");
+  expected_priorities.SetFromString("150,150,100,100,100");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+  OLA_ASSERT_EQ(expected_priorities, universe->GetSlotPriorities());
+
+  // a higher source priority on port2 wins every slot
+  port2.SetInheritedPriority(200);
+  port2.DmxChanged();
+  expected_priorities.SetFromString("200,200,200,200,200");
+  OLA_ASSERT_EQ(buffer2, universe->GetDMX());
+  OLA_ASSERT_EQ(expected_priorities, universe->GetSlotPriorities());
+  OLA_ASSERT_EQ((uint8_t) 200, universe->ActivePriority());
+
+  // dropping the slot priorities returns to a normal merge, port2 has the
+  // higher priority.
+  port.SetInheritedSlotPriorities(DmxBuffer());
+  port.DmxChanged();
+  OLA_ASSERT_EQ(buffer2, universe->GetDMX());
+  OLA_ASSERT_EQ(0u, universe->GetSlotPriorities().Size());
+
+  // clean up
+  universe->RemovePort(&port);
+  universe->RemovePort(&port2);
+  OLA_ASSERT_FALSE(universe->IsActive());
+}
+
+
+/*
+ * Check that once the sources are known, merging doesn't allocate memory.
+ */
+void UniverseTest::testMergeAllocations() {
+  ola::ExportMap export_map;
+  ola::UniverseStore store(m_preferences, &export_map);
+  DmxBuffer buffer1, buffer2, buffer3;
+  buffer1.SetFromString("10,20,30,40");
+  buffer2.SetFromString("40,30,20,10,5");
+  buffer3.SetFromString("1,2,3");
+
+  ola::PortBroker broker;
+  ola::PortManager port_manager(&store, &broker);
+
+  TimeStamp time_stamp;
+  MockSelectServer ss(&time_stamp);
+  ola::PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  MockDevice device(NULL, "foo");
+  MockDevice device2(NULL, "bar");
+  MockDevice device3(NULL, "baz");
+  TestMockInputPort port(&device, 1, &plugin_adaptor);
+  TestMockInputPort port2(&device2, 1, &plugin_adaptor);
+  TestMockInputPort port3(&device3, 1, &plugin_adaptor);
+  port_manager.PatchPort(&port, TEST_UNIVERSE);
+  port_manager.PatchPort(&port2, TEST_UNIVERSE);
+  port_manager.PatchPort(&port3, TEST_UNIVERSE);
+
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+
+  // The first merge sizes the scratch space.
+  m_clock.CurrentTime(&time_stamp);
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  port2.WriteDMX(buffer2);
+  port2.DmxChanged();
+  port3.WriteDMX(buffer3);
+  port3.DmxChanged();
+
+  // A change to a single source, this re-merges the changed slots
+  buffer1.SetChannel(1, 200);
+  port.WriteDMX(buffer1);
+  allocation_count = 0;
+  count_allocations = true;
+  port.DmxChanged();
+  count_allocations = false;
+  OLA_ASSERT_EQ(0u, allocation_count);
+  DmxBuffer expected;
+  expected.SetFromString("40,200,30,40,5");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+
+  // A change in size, this re-merges all the sources
+  buffer3.SetFromString("1,2,3,4,5,6");
+  port3.WriteDMX(buffer3);
+  allocation_count = 0;
+  count_allocations = true;
+  port3.DmxChanged();
+  count_allocations = false;
+  OLA_ASSERT_EQ(0u, allocation_count);
+  expected.SetFromString("40,200,30,40,5,6");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+
+  // LTP
+  universe->SetMergeMode(Universe::MERGE_LTP);
+  buffer2.SetChannel(0, 1);
+  port2.WriteDMX(buffer2);
+  allocation_count = 0;
+  count_allocations = true;
+  port2.DmxChanged();
+  count_allocations = false;
+  OLA_ASSERT_EQ(0u, allocation_count);
+  OLA_ASSERT_EQ(buffer2, universe->GetDMX());
+
+  // 3 warm up frames + 3 merges
+  OLA_ASSERT_EQ(6u, (*export_map.GetUIntMapVar(Universe::K_FPS_VAR))["1"]);
+
+  // clean up
+  universe->RemovePort(&port);
+  universe->RemovePort(&port2);
+  universe->RemovePort(&port3);
+}
+
+
+
+/*
+ * Check that the time from receiving data to writing it is recorded.
+ */
+void UniverseTest::testLatency() {
+  ola::ExportMap export_map;
+  ola::UniverseStore store(m_preferences, &export_map);
+  ola::PortBroker broker;
+  ola::PortManager port_manager(&store, &broker);
+
+  TimeStamp time_stamp;
+  MockSelectServer ss(&time_stamp);
+  ola::PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  MockDevice device(NULL, "foo");
+  TestMockInputPort input_port(&device, 1, &plugin_adaptor);
+  TestMockOutputPort output_port(&device, 1);
+  port_manager.PatchPort(&input_port, TEST_UNIVERSE);
+  port_manager.PatchPort(&output_port, TEST_UNIVERSE);
+
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  ola::UIntMap *p50 = export_map.GetUIntMapVar(Universe::K_LATENCY_P50_VAR);
+  ola::UIntMap *p999 = export_map.GetUIntMapVar(Universe::K_LATENCY_P999_VAR);
+  OLA_ASSERT_EQ(0u, (*p50)["1"]);
+
+  // Data set directly doesn't have a receive time.
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(0u, (*p50)["1"]);
+
+  // Pretend the data arrived 5ms ago.
+  m_clock.CurrentTime(&time_stamp);
+  time_stamp = time_stamp - TimeInterval(0, 5000);
+  input_port.WriteDMX(m_buffer);
+  input_port.DmxChanged();
+  OLA_ASSERT(m_buffer == output_port.ReadDMX());
+  OLA_ASSERT_TRUE((*p50)["1"] >= 5000);
+  OLA_ASSERT_TRUE((*p50)["1"] < 1000000);
+  OLA_ASSERT_EQ((*p50)["1"], (*p999)["1"]);
+
+  // The same values are available without the export map.
+  Universe::Stats stats;
+  universe->GetStats(&stats);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(2), stats.frames);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), stats.merges);
+  OLA_ASSERT_EQ(1u, stats.input_ports);
+  OLA_ASSERT_EQ(0u, stats.source_clients);
+  OLA_ASSERT_EQ(1u, stats.active_sources);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), stats.latency_samples);
+  OLA_ASSERT_EQ((*p50)["1"], stats.latency_p50);
+  OLA_ASSERT_EQ((*p999)["1"], stats.latency_p999);
+
+  port_manager.UnPatchPort(&input_port);
+  port_manager.UnPatchPort(&output_port);
+}
+
+
+/*
+ * Check that unchanged data is only written once the keepalive has passed.
+ */
+void UniverseTest::testOutputKeepalive() {
+  ola::ExportMap export_map;
+  m_preferences->SetValue("uni_2_output_keepalive", "500");
+  ola::UniverseStore store(m_preferences, &export_map);
+  store.SetOutputKeepalive(TimeInterval(0, 10000));
+
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  OLA_ASSERT_EQ(TimeInterval(0, 10000), universe->OutputKeepalive());
+
+  // The preferences override the default.
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+  OLA_ASSERT(universe2);
+  OLA_ASSERT_EQ(TimeInterval(0, 500000), universe2->OutputKeepalive());
+
+  TestMockOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+  ola::UIntMap *frames = export_map.GetUIntMapVar(Universe::K_FPS_VAR);
+  ola::UIntMap *suppressed = export_map.GetUIntMapVar(
+      Universe::K_OUTPUT_SUPPRESSED_VAR);
+
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT(m_buffer == port.ReadDMX());
+  OLA_ASSERT_EQ(1u, (*frames)["1"]);
+
+  // The same data again isn't written.
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(1u, (*frames)["1"]);
+  OLA_ASSERT_EQ(1u, (*suppressed)["1"]);
+
+  // New data is.
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT(buffer == port.ReadDMX());
+  OLA_ASSERT_EQ(2u, (*frames)["1"]);
+
+  // Once the keepalive has passed, the same data is written again.
+  usleep(20000);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(3u, (*frames)["1"]);
+  OLA_ASSERT_EQ(1u, (*suppressed)["1"]);
+
+  // Turning it off writes every update.
+  universe->SetOutputKeepalive(TimeInterval());
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(5u, (*frames)["1"]);
+
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check that held output isn't written until the hold is released.
+ */
+void UniverseTest::testOutputHold() {
+  ola::UniverseStore store(m_preferences, NULL);
+  store.SetOutputKeepalive(TimeInterval(10, 0));
+  store.SetOutputHold(true);
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  OLA_ASSERT_TRUE(universe->OutputHeld());
+
+  TestMockOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(0u, port.ReadDMX().Size());
+  OLA_ASSERT(m_buffer == universe->GetDMX());
+
+  // Releasing the hold writes the data, even though it hasn't changed.
+  store.SetOutputHold(false);
+  OLA_ASSERT_FALSE(universe->OutputHeld());
+  OLA_ASSERT(m_buffer == port.ReadDMX());
+
+  universe->RemovePort(&port);
+}
+
+/**
+ * Check idle universes don't hold per-frame stats or scratch buffers.
+ */
+void UniverseTest::testIdleUniverse() {
+  ola::ExportMap export_map;
+  ola::UniverseStore store(m_preferences, &export_map);
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  const ola::UIntMap *frames = export_map.GetUIntMapVar(Universe::K_FPS_VAR);
+  OLA_ASSERT_EQ(static_cast<size_t>(0), frames->Values().count("1"));
+
+  TestMockOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+  ola::dmx::SlotRemap remap;
+  OLA_ASSERT(remap.FromString("1-4=6,5=1"));
+  port.SetSlotRemap(remap);
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(string("is st"), port.ReadDMX().Get());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), frames->Values().count("1"));
+
+  // The universe sent data, so it isn't idle the first time.
+  OLA_ASSERT_EQ(0u, store.ReleaseIdleBuffers());
+  OLA_ASSERT_EQ(1u, store.ReleaseIdleBuffers());
+  OLA_ASSERT_TRUE(universe->ReleaseIdleBuffers());
+
+  // The data is still there, and the scratch buffers come back when needed.
+  OLA_ASSERT(m_buffer == universe->GetDMX());
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4,5,6");
+  OLA_ASSERT(universe->SetDMX(buffer));
+  DmxBuffer expected;
+  remap.Apply(buffer, &expected);
+  OLA_ASSERT_EQ(expected, port.ReadDMX());
+  OLA_ASSERT_FALSE(universe->ReleaseIdleBuffers());
+  universe->RemovePort(&port);
+}
+
+
+/**
+ * Check virtual universes blend their layers, and are updated when a layer
+ * changes.
+ */
+void UniverseTest::testLayers() {
+  const unsigned int LAYER_UNIVERSE1 = 10;
+  const unsigned int LAYER_UNIVERSE2 = 11;
+  Universe *layer1 = m_store->GetUniverseOrCreate(LAYER_UNIVERSE1);
+  Universe *layer2 = m_store->GetUniverseOrCreate(LAYER_UNIVERSE2);
+  Universe *virtual_universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(layer1);
+  OLA_ASSERT(layer2);
+  OLA_ASSERT(virtual_universe);
+  OLA_ASSERT_FALSE(virtual_universe->IsActive());
+
+  DmxBuffer data;
+  data.SetFromString("100,100,100,100");
+  layer1->SetDMX(data);
+  data.SetFromString("200,0");
+  layer2->SetDMX(data);
+
+  TestMockOutputPort port(NULL, 1);
+  virtual_universe->AddPort(&port);
+
+  vector<Universe::Layer> layers(2);
+  layers[0].universe = LAYER_UNIVERSE1;
+  layers[0].mask.SetFromString("255,255,0");
+  layers[1].universe = LAYER_UNIVERSE2;
+  layers[1].opacity = 128;
+  OLA_ASSERT_TRUE(m_store->SetLayers(virtual_universe, layers));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), virtual_universe->Layers().size());
+
+  DmxBuffer expected;
+  expected.SetFromString("150,50,0");
+  OLA_ASSERT_EQ(expected, virtual_universe->GetDMX());
+  OLA_ASSERT_EQ(expected, port.ReadDMX());
+
+  // A change to a layer is passed on.
+  data.SetFromString("0,0,0");
+  layer1->SetDMX(data);
+  expected.SetFromString("100,0,0");
+  OLA_ASSERT_EQ(expected, port.ReadDMX());
+
+  // The universe's own data is the base.
+  data.SetFromString("10,10,10,10");
+  virtual_universe->SetDMX(data);
+  expected.SetFromString("100,0,10,10");
+  OLA_ASSERT_EQ(expected, port.ReadDMX());
+
+  // Cycles are rejected.
+  vector<Universe::Layer> cycle(1);
+  cycle[0].universe = TEST_UNIVERSE;
+  OLA_ASSERT_FALSE(m_store->SetLayers(layer1, cycle));
+  OLA_ASSERT_FALSE(m_store->SetLayers(virtual_universe, cycle));
+  OLA_ASSERT_TRUE(layer1->Layers().empty());
+
+  // A chain of virtual universes is fine.
+  cycle[0].universe = LAYER_UNIVERSE2;
+  OLA_ASSERT_TRUE(m_store->SetLayers(layer1, cycle));
+  data.SetFromString("50");
+  layer2->SetDMX(data);
+  expected.SetFromString("50,0,0");
+  OLA_ASSERT_EQ(expected, layer1->GetDMX());
+  expected.SetFromString("50,0,10,10");
+  OLA_ASSERT_EQ(expected, port.ReadDMX());
+
+  // Removing the layers reverts to the merged data.
+  virtual_universe->RemovePort(&port);
+  OLA_ASSERT_TRUE(virtual_universe->IsActive());
+  OLA_ASSERT_TRUE(m_store->SetLayers(virtual_universe,
+                                     vector<Universe::Layer>()));
+  OLA_ASSERT_EQ(string("10,10,10,10"), virtual_universe->GetDMX().ToString());
+  OLA_ASSERT_FALSE(virtual_universe->IsActive());
+}
+
 /**
  * Test RDM discovery for a universe/
  */
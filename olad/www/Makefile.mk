@@ -143,3 +143,21 @@ dist_bootfonts_DATA = \
     olad/www/new/libs/bootstrap/fonts/glyphicons-halflings-regular.woff2
 dist_bootcss_DATA = \
     olad/www/new/libs/bootstrap/css/bootstrap.min.css
+
+# The HTTP server sends the .gz variant of a file to clients that accept it.
+install-data-hook-www:
+	find $(DESTDIR)$(www_datadir) -type f \
+	  \( -name '*.css' -o -name '*.html' -o -name '*.js' -o -name '*.svg' \) \
+	  -exec sh -c 'gzip -9 -n -c "$$1" > "$$1.gz"' sh {} \;
+
+INSTALL_DATA_HOOKS += install-data-hook-www
+
+# Remove the .gz variants written by install-data-hook-www.
+uninstall-hook-www:
+	if test -d $(DESTDIR)$(www_datadir); then \
+	  find $(DESTDIR)$(www_datadir) -type f \
+	    \( -name '*.css.gz' -o -name '*.html.gz' -o -name '*.js.gz' \
+	       -o -name '*.svg.gz' \) -exec rm -f {} \; ; \
+	fi
+
+UNINSTALL_HOOKS += uninstall-hook-www
@@ -31,14 +31,17 @@
 #include "common/rpc/RpcController.h"
 #include "ola/Callback.h"
 #include "ola/CallbackRunner.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/InterfacePicker.h"
 #include "ola/network/NetworkUtils.h"
+#include "ola/network/Socket.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
+#include "olad/UDPReceivePreferences.h"
 #include "plugins/artnet/ArtNetDevice.h"
 #include "plugins/artnet/ArtNetPort.h"
 
@@ -63,12 +66,18 @@ const char ArtNetDevice::K_LIMITED_BROADCAST_KEY[] = "use_limited_broadcast";
 const char ArtNetDevice::K_LONG_NAME_KEY[] = "long_name";
 const char ArtNetDevice::K_LOOPBACK_KEY[] = "use_loopback";
 const char ArtNetDevice::K_NET_KEY[] = "net";
+const char ArtNetDevice::K_INPUT_PORT_KEY[] = "input_ports";
 const char ArtNetDevice::K_OUTPUT_PORT_KEY[] = "output_ports";
 const char ArtNetDevice::K_SHORT_NAME_KEY[] = "short_name";
 const char ArtNetDevice::K_SUBNET_KEY[] = "subnet";
+const char ArtNetDevice::K_SYNC_KEY[] = "use_sync";
+const char ArtNetDevice::K_TRIM_DMX_KEY[] = "trim_dmx";
 const unsigned int ArtNetDevice::K_ARTNET_NET = 0;
 const unsigned int ArtNetDevice::K_ARTNET_SUBNET = 0;
+const unsigned int ArtNetDevice::K_DEFAULT_INPUT_PORT_COUNT = 4;
 const unsigned int ArtNetDevice::K_DEFAULT_OUTPUT_PORT_COUNT = 4;
+// 16 pages of four ports, one for each subnet.
+const unsigned int ArtNetDevice::K_MAX_PORT_COUNT = 64;
 
 ArtNetDevice::ArtNetDevice(AbstractPlugin *owner,
                            ola::Preferences *preferences,
@@ -104,10 +113,25 @@ bool ArtNetDevice::StartHook() {
       K_ALWAYS_BROADCAST_KEY);
   node_options.use_limited_broadcast_address = m_preferences->GetValueAsBool(
       K_LIMITED_BROADCAST_KEY);
+  node_options.use_sync = m_preferences->GetValueAsBool(K_SYNC_KEY);
+  node_options.trim_dmx = m_preferences->GetValueAsBool(K_TRIM_DMX_KEY);
   // OLA Output ports are ArtNet input ports
   node_options.input_port_count = StringToIntOrDefault(
       m_preferences->GetValue(K_OUTPUT_PORT_KEY),
       K_DEFAULT_OUTPUT_PORT_COUNT);
+  // and OLA Input ports are ArtNet output ports
+  node_options.output_port_count = StringToIntOrDefault(
+      m_preferences->GetValue(K_INPUT_PORT_KEY),
+      K_DEFAULT_INPUT_PORT_COUNT);
+
+  ola::ExportMap *export_map = m_plugin_adaptor->GetExportMap();
+  ReadUDPReceivePreferences(*m_preferences, export_map, "artnet",
+                            &node_options.receive_options);
+  if (export_map) {
+    (*export_map->GetUIntMapVar(
+        ola::network::DatagramBatch::K_RECV_BATCH_SIZE_VAR,
+        "protocol"))["artnet"] = node_options.recv_batch_size;
+  }
 
   m_node = new ArtNetNode(iface, m_plugin_adaptor, node_options);
   m_node->SetNetAddress(net);
@@ -119,7 +143,7 @@ bool ArtNetDevice::StartHook() {
     AddPort(new ArtNetOutputPort(this, i, m_node));
   }
 
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
+  for (unsigned int i = 0; i < node_options.output_port_count; i++) {
     AddPort(new ArtNetInputPort(this, i, m_plugin_adaptor, m_node));
   }
 
@@ -130,6 +154,11 @@ bool ArtNetDevice::StartHook() {
     return false;
   }
 
+  unsigned int xdp_queue;
+  if (ReadNetworkEnginePreferences(*m_preferences, &xdp_queue)) {
+    m_node->SetXDPReceiver(m_plugin_adaptor->GetXDPReceiver(iface, xdp_queue));
+  }
+
   ostringstream str;
   str << K_DEVICE_NAME << " [" << iface.ip_address << "]";
   SetName(str.str());
@@ -73,6 +73,7 @@ class ArtNetDevice: public Device {
 
   static const char K_ALWAYS_BROADCAST_KEY[];
   static const char K_DEVICE_NAME[];
+  static const char K_INPUT_PORT_KEY[];
   static const char K_IP_KEY[];
   static const char K_LIMITED_BROADCAST_KEY[];
   static const char K_LONG_NAME_KEY[];
@@ -81,9 +82,13 @@ class ArtNetDevice: public Device {
   static const char K_OUTPUT_PORT_KEY[];
   static const char K_SHORT_NAME_KEY[];
   static const char K_SUBNET_KEY[];
+  static const char K_SYNC_KEY[];
+  static const char K_TRIM_DMX_KEY[];
   static const unsigned int K_ARTNET_NET;
   static const unsigned int K_ARTNET_SUBNET;
+  static const unsigned int K_DEFAULT_INPUT_PORT_COUNT;
   static const unsigned int K_DEFAULT_OUTPUT_PORT_COUNT;
+  static const unsigned int K_MAX_PORT_COUNT;
   // 10s between polls when we're sending data, DMX-workshop uses 8s;
   static const unsigned int POLL_INTERVAL = 10000;
 
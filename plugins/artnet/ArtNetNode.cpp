@@ -30,14 +30,17 @@
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
+#include "ola/math/Random.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/network/SocketAddress.h"
 #include "ola/rdm/RDMCommandSerializer.h"
+#include "ola/rdm/RDMCommandView.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/stl/STLUtils.h"
 #include "ola/strings/Format.h"
 #include "ola/strings/Utils.h"
+#include "ola/util/Trace.h"
 #include "plugins/artnet/ArtNetNode.h"
 
 
@@ -57,6 +60,7 @@ using ola::network::UDPSocket;
 using ola::rdm::RDMCallback;
 using ola::rdm::RDMCommand;
 using ola::rdm::RDMCommandSerializer;
+using ola::rdm::RDMCommandView;
 using ola::rdm::RDMDiscoveryCallback;
 using ola::rdm::RDMFrame;
 using ola::rdm::RDMReply;
@@ -73,6 +77,16 @@ using std::set;
 using std::string;
 using std::vector;
 
+namespace {
+/*
+ * Each page of ARTNET_MAX_PORTS ports has its own ArtPollReply, and uses the
+ * subnet after the previous page.
+ */
+uint8_t PageSubnet(uint8_t subnet_address, unsigned int port_id) {
+  return (subnet_address + port_id / ARTNET_MAX_PORTS) & 0x0f;
+}
+}  // namespace
+
 
 const char ArtNetNodeImpl::ARTNET_ID[] = "Art-Net";
 
@@ -84,9 +98,24 @@ typedef map<UID, std::pair<IPV4Address, uint8_t> > uid_map;
 // Input ports are ones that send data using ArtNet
 class ArtNetNodeImpl::InputPort {
  public:
+  // A node which is listening to the universe this port sends.
+  struct SubscribedNode {
+    IPV4Address address;
+    TimeStamp last_heard;
+  };
+  typedef vector<SubscribedNode> SubscribedNodes;
+
+  // The TOD being assembled from the ArtTodData blocks sent by a node.
+  struct PendingTod {
+    UIDSet uids;
+    uint16_t uid_total;
+  };
+  typedef map<IPV4Address, PendingTod> PendingTods;
+
   InputPort()
       : enabled(false),
         sequence_number(0),
+        last_used_size(0),
         discovery_callback(NULL),
         discovery_timeout(ola::thread::INVALID_TIMEOUT),
         rdm_request_callback(NULL),
@@ -106,6 +135,7 @@ class ArtNetNodeImpl::InputPort {
 
     m_port_address = ((m_port_address & 0xf0) | universe_address);
     uids.clear();
+    pending_tods.clear();
     subscribed_nodes.clear();
     return true;
   }
@@ -114,6 +144,32 @@ class ArtNetNodeImpl::InputPort {
     subscribed_nodes.clear();
   }
 
+  // Add a node, or update the time we last heard from it.
+  void UpdateSubscribedNode(const IPV4Address &address,
+                            const TimeStamp &now) {
+    SubscribedNodes::iterator iter = subscribed_nodes.begin();
+    for (; iter != subscribed_nodes.end(); ++iter) {
+      if (iter->address == address) {
+        iter->last_heard = now;
+        return;
+      }
+    }
+    SubscribedNode node = {address, now};
+    subscribed_nodes.push_back(node);
+  }
+
+  // Remove the nodes we haven't heard from since the threshold.
+  void ExpireSubscribedNodes(const TimeStamp &threshold) {
+    SubscribedNodes::iterator output = subscribed_nodes.begin();
+    SubscribedNodes::const_iterator iter = subscribed_nodes.begin();
+    for (; iter != subscribed_nodes.end(); ++iter) {
+      if (iter->last_heard >= threshold) {
+        *output++ = *iter;
+      }
+    }
+    subscribed_nodes.erase(output, subscribed_nodes.end());
+  }
+
   // Returns true if the address changed.
   bool SetSubNetAddress(uint8_t subnet_address) {
     subnet_address = subnet_address << 4;
@@ -123,6 +179,7 @@ class ArtNetNodeImpl::InputPort {
 
     m_port_address = subnet_address | (m_port_address & 0x0f);
     uids.clear();
+    pending_tods.clear();
     subscribed_nodes.clear();
     return true;
   }
@@ -159,8 +216,13 @@ class ArtNetNodeImpl::InputPort {
 
   bool enabled;
   uint8_t sequence_number;
-  map<IPV4Address, TimeStamp> subscribed_nodes;
+  // The slots up to the last non-zero one in the last trimmed ArtDmx.
+  unsigned int last_used_size;
+  SubscribedNodes subscribed_nodes;
+  // The ArtDmx packet for this port, the header is filled in once.
+  artnet_packet dmx_packet;
   uid_map uids;  // used to keep track of the UIDs
+  PendingTods pending_tods;
   // NULL if discovery isn't running, otherwise the callback to run when it
   // finishes
   RDMDiscoveryCallback *discovery_callback;
@@ -199,6 +261,7 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
                                ola::network::UDPSocketInterface *socket)
     : m_running(false),
       m_net_address(0),
+      m_subnet_address(0),
       m_send_reply_on_change(true),
       m_short_name(""),
       m_long_name(""),
@@ -207,29 +270,48 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
       m_ss(ss),
       m_always_broadcast(options.always_broadcast),
       m_use_limited_broadcast_address(options.use_limited_broadcast_address),
+      m_use_sync(options.use_sync),
+      m_trim_dmx(options.trim_dmx),
+      m_receive_options(options.receive_options),
+      m_batch_depth(0),
+      m_sync_required(false),
+      m_expiry_timeout(ola::thread::INVALID_TIMEOUT),
+      m_poll_replies_valid(false),
+      m_poll_reply_timeout(ola::thread::INVALID_TIMEOUT),
       m_in_configuration_mode(false),
       m_artpoll_required(false),
       m_artpollreply_required(false),
+      m_output_ports(options.output_port_count),
       m_interface(iface),
-      m_socket(socket) {
+      m_socket(socket),
+      m_recv_batch(options.recv_batch_size, sizeof(artnet_packet)),
+      m_xdp_receiver(NULL) {
 
   if (!m_socket.get()) {
     m_socket.reset(new UDPSocket());
   }
 
   for (unsigned int i = 0; i < options.input_port_count; i++) {
-    m_input_ports.push_back(new InputPort());
+    InputPort *port = new InputPort();
+    PopulatePacketHeader(&port->dmx_packet, ARTNET_DMX);
+    memset(&port->dmx_packet.data.dmx, 0, sizeof(port->dmx_packet.data.dmx));
+    port->dmx_packet.data.dmx.version = HostToNetwork(ARTNET_VERSION);
+    port->dmx_packet.data.dmx.physical = static_cast<uint8_t>(i);
+    port->SetSubNetAddress(PageSubnet(m_subnet_address, i));
+    m_input_ports.push_back(port);
   }
 
   // reset all the port structures
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    m_output_ports[i].universe_address = 0;
+  for (unsigned int i = 0; i < m_output_ports.size(); i++) {
+    m_output_ports[i].universe_address = PageSubnet(m_subnet_address, i) << 4;
     m_output_ports[i].sequence_number = 0;
     m_output_ports[i].enabled = false;
     m_output_ports[i].is_merging = false;
     m_output_ports[i].merge_mode = ARTNET_MERGE_HTP;
     m_output_ports[i].buffer = NULL;
+    m_output_ports[i].sync_pending = false;
     m_output_ports[i].on_data = NULL;
+    m_output_ports[i].on_nzs = NULL;
     m_output_ports[i].on_discover = NULL;
     m_output_ports[i].on_flush = NULL;
     m_output_ports[i].on_rdm_request = NULL;
@@ -241,10 +323,13 @@ ArtNetNodeImpl::~ArtNetNodeImpl() {
 
   STLDeleteElements(&m_input_ports);
 
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
+  for (unsigned int i = 0; i < m_output_ports.size(); i++) {
     if (m_output_ports[i].on_data) {
       delete m_output_ports[i].on_data;
     }
+    if (m_output_ports[i].on_nzs) {
+      delete m_output_ports[i].on_nzs;
+    }
     if (m_output_ports[i].on_discover) {
       delete m_output_ports[i].on_discover;
     }
@@ -262,6 +347,9 @@ bool ArtNetNodeImpl::Start() {
     return false;
   }
 
+  m_expiry_timeout = m_ss->RegisterRepeatingTimeout(
+      NODE_EXPIRY_INTERVAL_MS,
+      ola::NewCallback(this, &ArtNetNodeImpl::ExpireNodesAndSources));
   m_running = true;
   return true;
 }
@@ -302,12 +390,37 @@ bool ArtNetNodeImpl::Stop() {
     }
   }
 
+  if (m_expiry_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_expiry_timeout);
+    m_expiry_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  if (m_poll_reply_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_poll_reply_timeout);
+    m_poll_reply_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  if (m_xdp_receiver) {
+    m_xdp_receiver->RemovePort(ARTNET_PORT);
+    m_xdp_receiver = NULL;
+  }
   m_ss->RemoveReadDescriptor(m_socket.get());
 
   m_running = false;
   return true;
 }
 
+void ArtNetNodeImpl::SetXDPReceiver(ola::network::XDPReceiver *receiver) {
+  if (!m_running || m_xdp_receiver || !receiver) {
+    return;
+  }
+  if (receiver->AddPort(
+        ARTNET_PORT,
+        NewCallback(this, &ArtNetNodeImpl::XDPPacketReady))) {
+    m_xdp_receiver = receiver;
+  }
+}
+
 bool ArtNetNodeImpl::EnterConfigurationMode() {
   if (m_in_configuration_mode) {
     return false;
@@ -377,13 +490,18 @@ bool ArtNetNodeImpl::SetNetAddress(uint8_t net_address) {
 }
 
 bool ArtNetNodeImpl::SetSubnetAddress(uint8_t subnet_address) {
+  subnet_address &= 0x0f;
+
   // Set for all input ports.
   bool changed = false;
   bool input_ports_enabled = false;
-  vector<InputPort*>::iterator iter = m_input_ports.begin();
-  for (; iter != m_input_ports.end(); ++iter) {
-    input_ports_enabled |= (*iter)->enabled;
-    changed |= (*iter)->SetSubNetAddress(subnet_address);
+  for (unsigned int i = 0; i < m_input_ports.size(); i++) {
+    InputPort *port = m_input_ports[i];
+    input_ports_enabled |= port->enabled;
+    if (port->SetSubNetAddress(PageSubnet(subnet_address, i))) {
+      LoadCachedTod(port);
+      changed = true;
+    }
   }
 
   if (input_ports_enabled && changed) {
@@ -391,16 +509,17 @@ bool ArtNetNodeImpl::SetSubnetAddress(uint8_t subnet_address) {
   }
 
   // set for all output ports.
-  uint8_t old_address = m_output_ports[0].universe_address >> 4;
-  if (old_address == subnet_address && !changed) {
+  if (m_subnet_address == subnet_address && !changed) {
     return true;
   }
 
-  subnet_address = subnet_address << 4;
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    m_output_ports[i].universe_address = subnet_address |
-        (m_output_ports[i].universe_address & 0x0f);
+  m_subnet_address = subnet_address;
+  for (unsigned int i = 0; i < m_output_ports.size(); i++) {
+    m_output_ports[i].universe_address = (
+        (PageSubnet(subnet_address, i) << 4) |
+        (m_output_ports[i].universe_address & 0x0f));
   }
+  UpdateOutputPortIndex();
 
   return SendPollReplyIfRequired();
 }
@@ -416,8 +535,12 @@ bool ArtNetNodeImpl::SetInputPortUniverse(uint8_t port_id,
     return false;
   }
 
+  if (!port->enabled) {
+    m_poll_replies_valid = false;
+  }
   port->enabled = true;
   if (port->SetUniverseAddress(universe_id)) {
+    LoadCachedTod(port);
     SendPollIfAllowed();
     return SendPollReplyIfRequired();
   }
@@ -461,6 +584,7 @@ bool ArtNetNodeImpl::SetOutputPortUniverse(uint8_t port_id,
   port->universe_address = (
       (universe_id & 0x0f) | (port->universe_address & 0xf0));
   port->enabled = true;
+  UpdateOutputPortIndex();
   return SendPollReplyIfRequired();
 }
 
@@ -478,6 +602,7 @@ void ArtNetNodeImpl::DisableOutputPort(uint8_t port_id) {
   bool was_enabled = port->enabled;
   port->enabled = false;
   if (was_enabled) {
+    UpdateOutputPortIndex();
     SendPollReplyIfRequired();
   }
 }
@@ -526,6 +651,7 @@ bool ArtNetNodeImpl::SendPoll() {
 }
 
 bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
+  OLA_TRACE_SCOPE("artnet", "ArtNetNode::SendDMX");
   InputPort *port = GetEnabledInputPort(port_id, "ArtDMX");
   if (!port) {
     return false;
@@ -536,19 +662,28 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
     return true;
   }
 
-  artnet_packet packet;
-  PopulatePacketHeader(&packet, ARTNET_DMX);
-  memset(&packet.data.dmx, 0, sizeof(packet.data.dmx));
-
-  packet.data.poll.version = HostToNetwork(ARTNET_VERSION);
+  artnet_packet &packet = port->dmx_packet;
   packet.data.dmx.sequence = port->sequence_number;
-  packet.data.dmx.physical = port_id;
   packet.data.dmx.universe = port->PortAddress();
   packet.data.dmx.net = m_net_address;
 
-  unsigned int buffer_size = buffer.Size();
+  const unsigned int frame_size = buffer.Size();
+  unsigned int buffer_size = frame_size;
   buffer.Get(packet.data.dmx.data, &buffer_size);
 
+  if (m_trim_dmx) {
+    // Receivers hold the slots we don't send, so we also send the slots which
+    // were non-zero in the last frame.
+    unsigned int used_size = buffer_size;
+    while (used_size && !packet.data.dmx.data[used_size - 1]) {
+      used_size--;
+    }
+    buffer_size = std::max(used_size,
+                           std::min(port->last_used_size, buffer_size));
+    buffer_size = std::max(buffer_size, std::min(2u, frame_size));
+    port->last_used_size = used_size;
+  }
+
   // the dmx frame size needs to be a multiple of two, correct here if needed
   if (buffer_size % 2) {
     packet.data.dmx.data[buffer_size] = 0;
@@ -559,7 +694,71 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
 
   unsigned int size = sizeof(packet.data.dmx) - DMX_UNIVERSE_SIZE + buffer_size;
 
+  bool sent = false;
+  bool sent_ok = SendDataPacket(port, packet, size, &sent);
+  if (!sent_ok) {
+    OLA_WARN << "Failed to send ArtNet DMX packet";
+  }
+
+  m_sync_required |= (sent && m_use_sync);
+  if (m_sync_required && !m_batch_depth) {
+    // Outside of a batch, each packet is synced on its own.
+    sent_ok &= SendSync();
+  }
+  return sent_ok;
+}
+
+bool ArtNetNodeImpl::SendNzs(uint8_t port_id, uint8_t start_code,
+                             const DmxBuffer &buffer) {
+  InputPort *port = GetEnabledInputPort(port_id, "ArtNzs");
+  if (!port) {
+    return false;
+  }
+
+  if (start_code == ola::DMX512_START_CODE ||
+      start_code == ola::rdm::RDMCommand::START_CODE) {
+    OLA_WARN << "Can't send start code " << ToHex(start_code)
+             << " in an ArtNzs";
+    return false;
+  }
+
+  if (!buffer.Size()) {
+    OLA_DEBUG << "Not sending 0 length packet";
+    return true;
+  }
+
+  artnet_packet packet;
+  PopulatePacketHeader(&packet, ARTNET_NZS);
+  packet.data.nzs.version = HostToNetwork(ARTNET_VERSION);
+  packet.data.nzs.sequence = port->sequence_number;
+  packet.data.nzs.start_code = start_code;
+  packet.data.nzs.universe = port->PortAddress();
+  packet.data.nzs.net = m_net_address;
+
+  unsigned int buffer_size = buffer.Size();
+  buffer.Get(packet.data.nzs.data, &buffer_size);
+  if (buffer_size % 2) {
+    packet.data.nzs.data[buffer_size] = 0;
+    buffer_size++;
+  }
+  packet.data.nzs.length[0] = buffer_size >> 8;
+  packet.data.nzs.length[1] = buffer_size & 0xff;
+
+  unsigned int size = sizeof(packet.data.nzs) - DMX_UNIVERSE_SIZE + buffer_size;
+  bool sent = false;
+  if (!SendDataPacket(port, packet, size, &sent)) {
+    OLA_WARN << "Failed to send ArtNet NZS packet";
+    return false;
+  }
+  return true;
+}
+
+bool ArtNetNodeImpl::SendDataPacket(InputPort *port,
+                                    const artnet_packet &packet,
+                                    unsigned int size,
+                                    bool *sent) {
   bool sent_ok = false;
+  *sent = false;
   if (port->subscribed_nodes.size() >= m_broadcast_threshold ||
       m_always_broadcast) {
     sent_ok = SendPacket(
@@ -569,35 +768,45 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
         IPV4Address::Broadcast() :
         m_interface.bcast_address);
     port->sequence_number++;
+    *sent = true;
+  } else if (port->subscribed_nodes.empty()) {
+    OLA_DEBUG << "Suppressing data transmit due to no active nodes for "
+                 "universe "
+              << static_cast<int>(port->PortAddress());
+    sent_ok = true;
   } else {
-    map<IPV4Address, TimeStamp>::iterator iter = port->subscribed_nodes.begin();
-    TimeStamp last_heard_threshold = (
-        *m_ss->WakeUpTime() - TimeInterval(NODE_TIMEOUT, 0));
-    while (iter != port->subscribed_nodes.end()) {
-      // if this node has timed out, remove it from the set
-      if (iter->second < last_heard_threshold) {
-        port->subscribed_nodes.erase(iter++);
-        continue;
-      }
-      sent_ok |= SendPacket(packet, size, iter->first);
-      ++iter;
+    // Queue the copies so they are sent with a single system call.
+    m_socket->BeginSendBatch();
+    InputPort::SubscribedNodes::const_iterator iter =
+        port->subscribed_nodes.begin();
+    for (; iter != port->subscribed_nodes.end(); ++iter) {
+      sent_ok |= SendPacket(packet, size, iter->address);
     }
+    sent_ok &= m_socket->EndSendBatch();
 
-    if (port->subscribed_nodes.empty()) {
-      OLA_DEBUG << "Suppressing data transmit due to no active nodes for "
-                   "universe "
-                << static_cast<int>(port->PortAddress());
-      sent_ok = true;
-    } else {
-      // We sent at least one packet, increment the sequence number
-      port->sequence_number++;
-    }
+    // We sent at least one packet, increment the sequence number
+    port->sequence_number++;
+    *sent = true;
   }
+  return sent_ok;
+}
 
-  if (!sent_ok) {
-    OLA_WARN << "Failed to send ArtNet DMX packet";
+void ArtNetNodeImpl::BeginBatch() {
+  m_batch_depth++;
+  m_socket->BeginSendBatch();
+}
+
+bool ArtNetNodeImpl::EndBatch() {
+  bool result = true;
+  if (m_batch_depth == 1 && m_sync_required) {
+    // The ArtSync goes at the end of the batch, after all the data.
+    result = SendSync();
   }
-  return sent_ok;
+  if (m_batch_depth) {
+    m_batch_depth--;
+  }
+  result &= m_socket->EndSendBatch();
+  return result;
 }
 
 void ArtNetNodeImpl::RunFullDiscovery(uint8_t port_id,
@@ -637,6 +846,15 @@ void ArtNetNodeImpl::RunIncrementalDiscovery(
     return;
   }
 
+  if (!port->discovery_callback && HaveRecentTods(*port)) {
+    // Every node has sent us its TOD recently, so there's no need to ask.
+    OLA_DEBUG << "Using the cached TOD for address "
+              << static_cast<int>(port->PortAddress());
+    port->discovery_callback = callback;
+    port->RunDiscoveryCallback();
+    return;
+  }
+
   if (!StartDiscoveryProcess(port, callback)) {
     return;
   }
@@ -728,13 +946,13 @@ void ArtNetNodeImpl::GetSubscribedNodes(
     return;
   }
 
-  map<IPV4Address, TimeStamp> &subscribed_nodes = port->subscribed_nodes;
-  map<IPV4Address, TimeStamp>::const_iterator iter = subscribed_nodes.begin();
-  for (; iter != subscribed_nodes.end(); ++iter) {
-    TimeStamp last_heard_threshold = (
-        *m_ss->WakeUpTime() - TimeInterval(NODE_TIMEOUT, 0));
-    if (iter->second >= last_heard_threshold) {
-      node_addresses->push_back(iter->first);
+  TimeStamp last_heard_threshold = (
+      *m_ss->WakeUpTime() - TimeInterval(NODE_TIMEOUT, 0));
+  InputPort::SubscribedNodes::const_iterator iter =
+      port->subscribed_nodes.begin();
+  for (; iter != port->subscribed_nodes.end(); ++iter) {
+    if (iter->last_heard >= last_heard_threshold) {
+      node_addresses->push_back(iter->address);
     }
   }
 }
@@ -752,6 +970,20 @@ bool ArtNetNodeImpl::SetDMXHandler(uint8_t port_id,
   }
   port->buffer = buffer;
   port->on_data = on_data;
+  port->sync_pending = false;
+  return true;
+}
+
+bool ArtNetNodeImpl::SetNzsHandler(uint8_t port_id, NzsHandler *on_nzs) {
+  OutputPort *port = GetOutputPort(port_id);
+  if (!port) {
+    return false;
+  }
+
+  if (port->on_nzs) {
+    delete port->on_nzs;
+  }
+  port->on_nzs = on_nzs;
   return true;
 }
 
@@ -851,17 +1083,60 @@ bool ArtNetNodeImpl::SendTimeCode(const ola::timecode::TimeCode &timecode) {
 }
 
 void ArtNetNodeImpl::SocketReady() {
-  artnet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  ola::network::IPV4SocketAddress source;
-
-  if (!m_socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                          &packet_size,
-                          &source)) {
+  OLA_TRACE_SCOPE("artnet", "ArtNetNode::SocketReady");
+  if (!m_socket->RecvBatch(&m_recv_batch)) {
     return;
   }
 
-  HandlePacket(source.Host(), packet, packet_size);
+  for (unsigned int i = 0; i < m_recv_batch.Size(); i++) {
+    // Each buffer is sizeof(artnet_packet), so they are all aligned.
+    const artnet_packet *packet = reinterpret_cast<const artnet_packet*>(
+        m_recv_batch.Data(i));
+    HandlePacket(m_recv_batch.Source(i).Host(), *packet,
+                 m_recv_batch.Length(i));
+  }
+}
+
+void ArtNetNodeImpl::XDPPacketReady(const uint8_t *data,
+                                    unsigned int length,
+                                    const IPV4SocketAddress &source) {
+  OLA_TRACE_SCOPE("artnet", "ArtNetNode::XDPPacketReady");
+  // The packet is read in place, it's truncated to match the socket.
+  HandlePacket(source.Host(), *reinterpret_cast<const artnet_packet*>(data),
+               std::min(length,
+                        static_cast<unsigned int>(sizeof(artnet_packet))));
+}
+
+bool ArtNetNodeImpl::ExpireNodesAndSources() {
+  TimeStamp last_heard_threshold = (
+      *m_ss->WakeUpTime() - TimeInterval(NODE_TIMEOUT, 0));
+  InputPorts::iterator iter = m_input_ports.begin();
+  for (; iter != m_input_ports.end(); ++iter) {
+    (*iter)->ExpireSubscribedNodes(last_heard_threshold);
+  }
+
+  TimeStamp merge_time_threshold = (
+      *m_ss->WakeUpTime() - TimeInterval(MERGE_TIMEOUT, 0));
+  vector<OutputPort>::iterator port_iter = m_output_ports.begin();
+  for (; port_iter != m_output_ports.end(); ++port_iter) {
+    unsigned int active_sources = 0;
+    for (unsigned int i = 0; i < MAX_MERGE_SOURCES; i++) {
+      DMXSource &source = port_iter->sources[i];
+      if (source.address.IsWildcard()) {
+        continue;
+      }
+      if (source.timestamp < merge_time_threshold) {
+        source.address = IPV4Address();
+      } else {
+        active_sources++;
+      }
+    }
+    if (active_sources < 2 && port_iter->is_merging) {
+      port_iter->is_merging = false;
+      m_poll_replies_valid = false;
+    }
+  }
+  return true;
 }
 
 bool ArtNetNodeImpl::SendPollIfAllowed() {
@@ -878,6 +1153,8 @@ bool ArtNetNodeImpl::SendPollIfAllowed() {
 }
 
 bool ArtNetNodeImpl::SendPollReplyIfRequired() {
+  // This is called each time the contents of the reply change.
+  m_poll_replies_valid = false;
   if (m_running && m_send_reply_on_change) {
     if (m_in_configuration_mode) {
       m_artpollreply_required = true;
@@ -890,49 +1167,91 @@ bool ArtNetNodeImpl::SendPollReplyIfRequired() {
 }
 
 bool ArtNetNodeImpl::SendPollReply(const IPV4Address &destination) {
-  artnet_packet packet;
-  PopulatePacketHeader(&packet, ARTNET_REPLY);
-  memset(&packet.data.reply, 0, sizeof(packet.data.reply));
-
-  m_interface.ip_address.Get(packet.data.reply.ip);
-  packet.data.reply.port = HostToLittleEndian(ARTNET_PORT);
-  packet.data.reply.net_address = m_net_address;
-  packet.data.reply.subnet_address = m_output_ports[0].universe_address >> 4;
-  packet.data.reply.oem = HostToNetwork(OEM_CODE);
-  packet.data.reply.status1 = 0xd2;  // normal indicators, rdm enabled
-  packet.data.reply.esta_id = HostToLittleEndian(OPEN_LIGHTING_ESTA_CODE);
-  strings::StrNCopy(packet.data.reply.short_name,
-                    m_short_name.data());
-  strings::StrNCopy(packet.data.reply.long_name,
-                    m_long_name.data());
+  if (!m_poll_replies_valid) {
+    BuildPollReplies();
+  }
 
+  // The node report carries a counter, so it's the only part we update for
+  // each reply.
   std::ostringstream str;
   str << "#0001 [" << m_unsolicited_replies << "] OLA";
-  CopyToFixedLengthBuffer(str.str(), packet.data.reply.node_report,
-                          arraysize(packet.data.reply.node_report));
-  packet.data.reply.number_ports[1] = ARTNET_MAX_PORTS;
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    InputPort *iport = GetInputPort(i, false);
-    packet.data.reply.port_types[i] = iport ? 0xc0 : 0x80;
-    packet.data.reply.good_input[i] = iport && iport->enabled ? 0x0 : 0x8;
-    packet.data.reply.sw_in[i] = iport ? iport->PortAddress() : 0;
-
-    packet.data.reply.good_output[i] = (
-        (m_output_ports[i].enabled ? 0x80 : 0x00) |
-        (m_output_ports[i].merge_mode == ARTNET_MERGE_LTP ? 0x2 : 0x0) |
-        (m_output_ports[i].is_merging ? 0x8 : 0x0));
-    packet.data.reply.sw_out[i] = m_output_ports[i].universe_address;
-  }
-  packet.data.reply.style = NODE_CODE;
-  m_interface.hw_address.Get(packet.data.reply.mac);
-  m_interface.ip_address.Get(packet.data.reply.bind_ip);
-  // maybe set status2 here if the web UI is enabled
-  packet.data.reply.status2 = 0x08;  // node supports 15 bit port addresses
-  if (!SendPacket(packet, sizeof(packet.data.reply), destination)) {
+  const string node_report = str.str();
+
+  bool ok = true;
+  vector<artnet_packet>::iterator iter = m_poll_replies.begin();
+  for (; iter != m_poll_replies.end(); ++iter) {
+    CopyToFixedLengthBuffer(node_report, iter->data.reply.node_report,
+                            arraysize(iter->data.reply.node_report));
+    ok &= SendPacket(*iter, sizeof(iter->data.reply), destination);
+  }
+  if (!ok) {
     OLA_INFO << "Failed to send ArtPollReply";
-    return false;
   }
-  return true;
+  return ok;
+}
+
+void ArtNetNodeImpl::BuildPollReplies() {
+  const unsigned int port_count = std::max(
+      static_cast<unsigned int>(m_input_ports.size()),
+      static_cast<unsigned int>(m_output_ports.size()));
+  const unsigned int page_count = std::max(
+      1u, (port_count + ARTNET_MAX_PORTS - 1) / ARTNET_MAX_PORTS);
+
+  m_poll_replies.resize(page_count);
+  for (unsigned int page = 0; page < page_count; page++) {
+    BuildPollReplyPage(page, page_count, &m_poll_replies[page]);
+  }
+  m_poll_replies_valid = true;
+}
+
+void ArtNetNodeImpl::BuildPollReplyPage(unsigned int page,
+                                        unsigned int page_count,
+                                        artnet_packet *packet) {
+  PopulatePacketHeader(packet, ARTNET_REPLY);
+  artnet_reply_t &reply = packet->data.reply;
+  memset(&reply, 0, sizeof(reply));
+
+  const unsigned int first_port = page * ARTNET_MAX_PORTS;
+  m_interface.ip_address.Get(reply.ip);
+  reply.port = HostToLittleEndian(ARTNET_PORT);
+  reply.net_address = m_net_address;
+  reply.subnet_address = PageSubnet(m_subnet_address, first_port);
+  reply.oem = HostToNetwork(OEM_CODE);
+  reply.status1 = 0xd2;  // normal indicators, rdm enabled
+  reply.esta_id = HostToLittleEndian(OPEN_LIGHTING_ESTA_CODE);
+  strings::StrNCopy(reply.short_name, m_short_name.data());
+  strings::StrNCopy(reply.long_name, m_long_name.data());
+
+  uint8_t ports = 0;
+  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
+    InputPort *iport = GetInputPort(first_port + i, false);
+    const OutputPort *oport = first_port + i < m_output_ports.size() ?
+        &m_output_ports[first_port + i] : NULL;
+    if (!iport && !oport) {
+      continue;
+    }
+    ports++;
+
+    reply.port_types[i] = (iport ? 0x40 : 0) | (oport ? 0x80 : 0);
+    reply.good_input[i] = iport && iport->enabled ? 0x0 : 0x8;
+    reply.sw_in[i] = iport ? iport->PortAddress() : 0;
+
+    if (oport) {
+      reply.good_output[i] = (
+          (oport->enabled ? 0x80 : 0x00) |
+          (oport->merge_mode == ARTNET_MERGE_LTP ? 0x2 : 0x0) |
+          (oport->is_merging ? 0x8 : 0x0));
+      reply.sw_out[i] = oport->universe_address;
+    }
+  }
+  reply.number_ports[1] = ports;
+  reply.style = NODE_CODE;
+  m_interface.hw_address.Get(reply.mac);
+  m_interface.ip_address.Get(reply.bind_ip);
+  // A bind index of 0 is the root device, pages start from 1.
+  reply.bind_index = page_count > 1 ? page + 1 : 0;
+  // maybe set status2 here if the web UI is enabled
+  reply.status2 = 0x08;  // node supports 15 bit port addresses
 }
 
 bool ArtNetNodeImpl::SendIPReply(const IPV4Address &destination) {
@@ -978,6 +1297,16 @@ void ArtNetNodeImpl::HandlePacket(const IPV4Address &source_address,
                        packet.data.dmx,
                        packet_size - header_size);
       break;
+    case ARTNET_NZS:
+      HandleNzsPacket(source_address,
+                      packet.data.nzs,
+                      packet_size - header_size);
+      break;
+    case ARTNET_SYNC:
+      HandleSyncPacket(source_address,
+                       packet.data.sync,
+                       packet_size - header_size);
+      break;
     case ARTNET_TODREQUEST:
       HandleTodRequest(source_address,
                        packet.data.tod_request,
@@ -1030,9 +1359,38 @@ void ArtNetNodeImpl::HandlePollPacket(const IPV4Address &source_address,
   }
 
   m_send_reply_on_change = packet.talk_to_me & 0x02;
-  // It's unclear if this should be broadcast or unicast, stick with broadcast
+  ReplyToPoll();
+}
+
+void ArtNetNodeImpl::ReplyToPoll() {
+  if (m_poll_reply_timeout != ola::thread::INVALID_TIMEOUT) {
+    // a reply is already scheduled
+    return;
+  }
+
+  const TimeStamp &now = *m_ss->WakeUpTime();
+  const TimeInterval min_interval(0, MIN_POLL_REPLY_INTERVAL_MS * 1000);
+  if (!m_last_poll_reply.IsSet() || now - m_last_poll_reply >= min_interval) {
+    m_last_poll_reply = now;
+    // It's unclear if this should be broadcast or unicast, stick with
+    // broadcast
+    SendPollReply(m_interface.bcast_address);
+    return;
+  }
+
+  const int64_t wait = (
+      m_last_poll_reply + min_interval - now).InMilliSeconds();
+  const unsigned int delay = static_cast<unsigned int>(wait) +
+      ola::math::Random(0, POLL_REPLY_JITTER_MS);
+  m_poll_reply_timeout = m_ss->RegisterSingleTimeout(
+      delay,
+      ola::NewSingleCallback(this, &ArtNetNodeImpl::SendScheduledPollReply));
+}
+
+void ArtNetNodeImpl::SendScheduledPollReply() {
+  m_poll_reply_timeout = ola::thread::INVALID_TIMEOUT;
+  m_last_poll_reply = *m_ss->WakeUpTime();
   SendPollReply(m_interface.bcast_address);
-  (void) source_address;
 }
 
 void ArtNetNodeImpl::HandleReplyPacket(const IPV4Address &source_address,
@@ -1063,18 +1421,19 @@ void ArtNetNodeImpl::HandleReplyPacket(const IPV4Address &source_address,
     return;
   }
 
-  // Update the subscribed nodes list
+  // Update the subscribed nodes list. Multi-port nodes send a reply for each
+  // page of ports, with the page's subnet.
   unsigned int port_limit = std::min((uint8_t) ARTNET_MAX_PORTS,
                                      packet.number_ports[1]);
   for (unsigned int i = 0; i < port_limit; i++) {
     if (packet.port_types[i] & 0x80) {
       // port is of type output
-      uint8_t universe_id = packet.sw_out[i];
+      uint8_t universe_id = static_cast<uint8_t>(
+          (packet.subnet_address << 4) | (packet.sw_out[i] & 0x0f));
       InputPorts::iterator iter = m_input_ports.begin();
       for (; iter != m_input_ports.end(); ++iter) {
         if ((*iter)->enabled && (*iter)->PortAddress() == universe_id) {
-          STLReplace(&(*iter)->subscribed_nodes, source_address,
-                     *m_ss->WakeUpTime());
+          (*iter)->UpdateSubscribedNode(source_address, *m_ss->WakeUpTime());
         }
       }
     }
@@ -1104,26 +1463,117 @@ void ArtNetNodeImpl::HandleDataPacket(const IPV4Address &source_address,
     return;
   }
 
-  uint16_t universe_id = LittleEndianToHost(packet.universe);
+  const uint8_t universe_id = packet.universe;
   uint16_t data_size = std::min(
       (unsigned int) ((packet.length[0] << 8) + packet.length[1]),
       packet_size - header_size);
 
-  for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == universe_id &&
-        m_output_ports[port_id].on_data &&
-        m_output_ports[port_id].buffer) {
+  const PortIds &port_ids = m_output_port_index[universe_id];
+  PortIds::const_iterator iter = port_ids.begin();
+  for (; iter != port_ids.end(); ++iter) {
+    OutputPort &port = m_output_ports[*iter];
+    if (port.on_data && port.buffer) {
+      m_last_dmx_source = source_address;
       // update this port, doing a merge if necessary
-      DMXSource source;
-      source.address = source_address;
-      source.timestamp = *m_ss->WakeUpTime();
-      source.buffer.Set(packet.data, data_size);
-      UpdatePortFromSource(&m_output_ports[port_id], source);
+      UpdatePortFromSource(&port, source_address, packet.data, data_size);
+    }
+  }
+}
+
+void ArtNetNodeImpl::HandleNzsPacket(const IPV4Address &source_address,
+                                     const artnet_nzs_t &packet,
+                                     unsigned int packet_size) {
+  unsigned int header_size = sizeof(artnet_nzs_t) - DMX_UNIVERSE_SIZE;
+  if (!CheckPacketSize(source_address,
+                       "ArtNzs",
+                       packet_size,
+                       header_size + 2)) {
+    return;
+  }
+
+  if (!CheckPacketVersion(source_address, "ArtNzs", packet.version)) {
+    return;
+  }
+
+  if (packet.net != m_net_address ||
+      packet.start_code == ola::DMX512_START_CODE ||
+      packet.start_code == ola::rdm::RDMCommand::START_CODE) {
+    return;
+  }
+
+  uint16_t data_size = std::min(
+      (unsigned int) ((packet.length[0] << 8) + packet.length[1]),
+      packet_size - header_size);
+
+  bool data_set = false;
+  const PortIds &port_ids = m_output_port_index[packet.universe];
+  PortIds::const_iterator iter = port_ids.begin();
+  for (; iter != port_ids.end(); ++iter) {
+    OutputPort &port = m_output_ports[*iter];
+    if (port.on_nzs) {
+      if (!data_set) {
+        m_nzs_buffer.Set(packet.data, data_size);
+        data_set = true;
+      }
+      port.on_nzs->Run(packet.start_code, m_nzs_buffer);
+    }
+  }
+}
+
+void ArtNetNodeImpl::HandleSyncPacket(const IPV4Address &source_address,
+                                      const artnet_sync_t &packet,
+                                      unsigned int packet_size) {
+  if (!CheckPacketSize(source_address,
+                       "ArtSync",
+                       packet_size,
+                       sizeof(packet))) {
+    return;
+  }
+
+  if (!CheckPacketVersion(source_address, "ArtSync", packet.version)) {
+    return;
+  }
+
+  // As per the spec, an ArtSync is ignored unless it's from the same source
+  // as the last ArtDmx.
+  if (source_address != m_last_dmx_source) {
+    OLA_DEBUG << "Ignoring ArtSync from " << source_address
+              << ", the last ArtDmx was from " << m_last_dmx_source;
+    return;
+  }
+
+  m_last_sync = *m_ss->WakeUpTime();
+  vector<OutputPort>::iterator iter = m_output_ports.begin();
+  for (; iter != m_output_ports.end(); ++iter) {
+    OutputPort &port = *iter;
+    if (port.sync_pending) {
+      port.sync_pending = false;
+      *port.buffer = port.sync_buffer;
+      port.on_data->Run();
     }
   }
 }
 
+bool ArtNetNodeImpl::SendSync() {
+  m_sync_required = false;
+  artnet_packet packet;
+  PopulatePacketHeader(&packet, ARTNET_SYNC);
+  memset(&packet.data.sync, 0, sizeof(packet.data.sync));
+  packet.data.sync.version = HostToNetwork(ARTNET_VERSION);
+  // The ArtSync is always broadcast, since it applies to all the nodes.
+  return SendPacket(
+      packet,
+      sizeof(packet.data.sync),
+      m_use_limited_broadcast_address ?
+      IPV4Address::Broadcast() :
+      m_interface.bcast_address);
+}
+
+bool ArtNetNodeImpl::InSyncMode() const {
+  return (m_last_sync.IsSet() &&
+          *m_ss->WakeUpTime() - m_last_sync < TimeInterval(SYNC_TIMEOUT, 0));
+}
+
 void ArtNetNodeImpl::HandleTodRequest(const IPV4Address &source_address,
                                       const artnet_todrequest_t &packet,
                                       unsigned int packet_size) {
@@ -1159,17 +1609,15 @@ void ArtNetNodeImpl::HandleTodRequest(const IPV4Address &source_address,
       static_cast<unsigned int>(ARTNET_MAX_RDM_ADDRESS_COUNT),
       addresses);
 
-  bool handler_called[ARTNET_MAX_PORTS];
-  memset(handler_called, 0, sizeof(handler_called));
+  vector<bool> handler_called(m_output_ports.size(), false);
 
   for (unsigned int i = 0; i < addresses; i++) {
-    for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-      if (m_output_ports[port_id].enabled &&
-          m_output_ports[port_id].universe_address == packet.addresses[i] &&
-          m_output_ports[port_id].on_discover &&
-          !handler_called[port_id]) {
-        m_output_ports[port_id].on_discover->Run();
-        handler_called[port_id] = true;
+    const PortIds &port_ids = m_output_port_index[packet.addresses[i]];
+    PortIds::const_iterator iter = port_ids.begin();
+    for (; iter != port_ids.end(); ++iter) {
+      if (m_output_ports[*iter].on_discover && !handler_called[*iter]) {
+        m_output_ports[*iter].on_discover->Run();
+        handler_called[*iter] = true;
       }
     }
   }
@@ -1239,11 +1687,11 @@ void ArtNetNodeImpl::HandleTodControl(const IPV4Address &source_address,
     return;
   }
 
-  for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == packet.address &&
-        m_output_ports[port_id].on_flush) {
-      m_output_ports[port_id].on_flush->Run();
+  const PortIds &port_ids = m_output_port_index[packet.address];
+  PortIds::const_iterator iter = port_ids.begin();
+  for (; iter != port_ids.end(); ++iter) {
+    if (m_output_ports[*iter].on_flush) {
+      m_output_ports[*iter].on_flush->Run();
     }
   }
 }
@@ -1283,34 +1731,48 @@ void ArtNetNodeImpl::HandleRdm(const IPV4Address &source_address,
     return;
   }
 
-  // look for the port that this was sent to, once we know the port we can try
-  // to parse the message
-  for (uint8_t port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == packet.address &&
-        m_output_ports[port_id].on_rdm_request) {
-      RDMRequest *request = RDMRequest::InflateFromData(packet.data,
-                                                        rdm_length);
-
-      if (request) {
-        m_output_ports[port_id].on_rdm_request->Run(
-            request,
-            NewSingleCallback(this,
-                              &ArtNetNodeImpl::RDMRequestCompletion,
-                              source_address,
-                              port_id,
-                              m_output_ports[port_id].universe_address));
-      }
-    }
+  // Check the message in place, so we only copy it if a port wants it.
+  RDMCommandView command;
+  if (command.Parse(packet.data, rdm_length) != ola::rdm::RDM_COMPLETED_OK) {
+    return;
   }
 
-  // The ArtNet packet does not include the RDM start code. Prepend that.
-  RDMFrame rdm_response(packet.data, rdm_length, RDMFrame::Options(true));
-
-  InputPorts::iterator iter = m_input_ports.begin();
-  for (; iter != m_input_ports.end(); ++iter) {
-    if ((*iter)->enabled && (*iter)->PortAddress() == packet.address) {
-      HandleRDMResponse(*iter, rdm_response, source_address);
+  if (command.IsRequest()) {
+    // look for the port that this was sent to
+    const PortIds &port_ids = m_output_port_index[packet.address];
+    PortIds::const_iterator port_iter = port_ids.begin();
+    for (; port_iter != port_ids.end(); ++port_iter) {
+      const uint8_t port_id = *port_iter;
+      if (m_output_ports[port_id].on_rdm_request) {
+        RDMRequest *request = RDMRequest::InflateFromData(packet.data,
+                                                          rdm_length);
+
+        if (request) {
+          m_output_ports[port_id].on_rdm_request->Run(
+              request,
+              NewSingleCallback(this,
+                                &ArtNetNodeImpl::RDMRequestCompletion,
+                                source_address,
+                                port_id,
+                                m_output_ports[port_id].universe_address));
+        }
+      }
+    }
+  } else if (command.IsResponse()) {
+    // The ArtNet packet does not include the RDM start code. This is prepended
+    // when the frame is created.
+    auto_ptr<RDMFrame> rdm_response;
+
+    InputPorts::iterator iter = m_input_ports.begin();
+    for (; iter != m_input_ports.end(); ++iter) {
+      if ((*iter)->enabled && (*iter)->PortAddress() == packet.address &&
+          (*iter)->pending_request) {
+        if (!rdm_response.get()) {
+          rdm_response.reset(
+              new RDMFrame(packet.data, rdm_length, RDMFrame::Options(true)));
+        }
+        HandleRDMResponse(*iter, *rdm_response, source_address);
+      }
     }
   }
 }
@@ -1490,9 +1952,9 @@ bool ArtNetNodeImpl::SendRDMCommand(const RDMCommand &command,
 }
 
 void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
-                                          const DMXSource &source) {
-  TimeStamp merge_time_threshold = (
-      *m_ss->WakeUpTime() - TimeInterval(MERGE_TIMEOUT, 0));
+                                          const IPV4Address &source_address,
+                                          const uint8_t *data,
+                                          unsigned int length) {
   // the index of the first empty slot, of MAX_MERGE_SOURCES if we're already
   // tracking MAX_MERGE_SOURCES sources.
   unsigned int first_empty_slot = MAX_MERGE_SOURCES;
@@ -1501,20 +1963,12 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
   unsigned int active_sources = 0;
 
   // locate the source within the list of tracked sources, also find the first
-  // empty source location in case this source is new, and timeout any sources
-  // we haven't heard from.
+  // empty source location in case this source is new. Sources we haven't heard
+  // from are removed by the expiry timer.
   for (unsigned int i = 0; i < MAX_MERGE_SOURCES; i++) {
-    if (port->sources[i].address == source.address) {
+    if (port->sources[i].address == source_address) {
       source_slot = i;
-      continue;
-    }
-
-    // timeout old sources
-    if (port->sources[i].timestamp < merge_time_threshold) {
-      port->sources[i].address = IPV4Address();
-    }
-
-    if (!port->sources[i].address.IsWildcard()) {
+    } else if (!port->sources[i].address.IsWildcard()) {
       active_sources++;
     } else if (i < first_empty_slot) {
       first_empty_slot = i;
@@ -1525,7 +1979,8 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
     // this is a new source
     if (first_empty_slot == MAX_MERGE_SOURCES) {
       // No room at the inn
-      OLA_WARN << "Max merge sources reached, ignoring";
+      OLA_LOG_RATE_LIMITED(ola::OLA_LOG_WARN, 10)
+          << "Max merge sources reached, ignoring";
       return;
     }
     if (active_sources == 0) {
@@ -1537,31 +1992,41 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
       SendPollReplyIfRequired();
     }
     source_slot = first_empty_slot;
-  } else if (active_sources == 1) {
-    port->is_merging = false;
   }
 
-  port->sources[source_slot] = source;
+  // Copy into the existing buffers, rather than allocating new ones for each
+  // packet.
+  DMXSource &tracked_source = port->sources[source_slot];
+  tracked_source.address = source_address;
+  tracked_source.timestamp = *m_ss->WakeUpTime();
+  tracked_source.buffer.Set(data, length);
+
+  // In synchronous mode the data is held until the ArtSync arrives. The spec
+  // says ArtSync is ignored while merging.
+  const bool hold = !port->is_merging && InSyncMode();
+  DmxBuffer *output = hold ? &port->sync_buffer : port->buffer;
 
   // Now we need to merge
-  if (port->merge_mode == ARTNET_MERGE_LTP) {
-    // the current source is the latest
-    (*port->buffer) = source.buffer;
+  if (port->merge_mode == ARTNET_MERGE_LTP || !active_sources) {
+    // the current source is the latest, or the only one
+    output->Set(data, length);
   } else {
-    // HTP merge
-    bool first = true;
+    // HTP merge, all the sources are merged in a single pass.
+    const DmxBuffer *buffers[MAX_MERGE_SOURCES];
+    unsigned int buffer_count = 0;
     for (unsigned int i = 0; i < MAX_MERGE_SOURCES; i++) {
       if (!port->sources[i].address.IsWildcard()) {
-        if (first) {
-          (*port->buffer) = port->sources[i].buffer;
-          first = false;
-        } else {
-          port->buffer->HTPMerge(port->sources[i].buffer);
-        }
+        buffers[buffer_count++] = &port->sources[i].buffer;
       }
     }
+    output->Reset();
+    output->HTPMerge(buffers, buffer_count);
+  }
+
+  port->sync_pending = hold;
+  if (!hold) {
+    port->on_data->Run();
   }
-  port->on_data->Run();
 }
 
 bool ArtNetNodeImpl::CheckPacketVersion(const IPV4Address &source_address,
@@ -1626,9 +2091,9 @@ ArtNetNodeImpl::InputPort *ArtNetNodeImpl::GetEnabledInputPort(
 }
 
 ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(uint8_t port_id) {
-  if (port_id >= ARTNET_MAX_PORTS) {
+  if (port_id >= m_output_ports.size()) {
     OLA_WARN << "Port index of out bounds: "
-             << static_cast<int>(port_id) << " >= " << ARTNET_MAX_PORTS;
+             << static_cast<int>(port_id) << " >= " << m_output_ports.size();
     return NULL;
   }
   return &m_output_ports[port_id];
@@ -1636,9 +2101,9 @@ ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(uint8_t port_id) {
 
 const ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(
     uint8_t port_id) const {
-  if (port_id >= ARTNET_MAX_PORTS) {
+  if (port_id >= m_output_ports.size()) {
     OLA_WARN << "Port index of out bounds: "
-             << static_cast<int>(port_id) << " >= " << ARTNET_MAX_PORTS;
+             << static_cast<int>(port_id) << " >= " << m_output_ports.size();
     return NULL;
   }
   return &m_output_ports[port_id];
@@ -1659,6 +2124,18 @@ ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetEnabledOutputPort(
   return ok ? port : NULL;
 }
 
+void ArtNetNodeImpl::UpdateOutputPortIndex() {
+  for (unsigned int i = 0; i < arraysize(m_output_port_index); i++) {
+    m_output_port_index[i].clear();
+  }
+  for (unsigned int i = 0; i < m_output_ports.size(); i++) {
+    if (m_output_ports[i].enabled) {
+      m_output_port_index[m_output_ports[i].universe_address].push_back(
+          static_cast<uint8_t>(i));
+    }
+  }
+}
+
 bool ArtNetNodeImpl::InitNetwork() {
   if (!m_socket->Init()) {
     OLA_WARN << "Socket init failed";
@@ -1675,6 +2152,9 @@ bool ArtNetNodeImpl::InitNetwork() {
     return false;
   }
 
+  m_socket->EnableReceiveStats(m_receive_options);
+  m_socket->SetEdgeTriggered(true);
+  m_socket->SetPriority(ola::io::DESCRIPTOR_PRIORITY_HIGH);
   m_socket->SetOnData(NewCallback(this, &ArtNetNodeImpl::SocketReady));
   m_ss->AddReadDescriptor(m_socket.get());
   return true;
@@ -1690,11 +2170,18 @@ void ArtNetNodeImpl::UpdatePortFromTodPacket(InputPort *port,
 
   OLA_DEBUG << "Got TOD data packet with " << uid_count << " UIDs";
   uid_map &port_uids = port->uids;
-  UIDSet uid_set;
+
+  // The blocks from a node are merged as they arrive, the first block starts
+  // a new TOD.
+  InputPort::PendingTod &pending = port->pending_tods[source_address];
+  if (packet.block_count == 0) {
+    pending.uids.Clear();
+  }
+  pending.uid_total = NetworkToHost(packet.uid_total);
 
   for (unsigned int i = 0; i < uid_count; i++) {
     UID uid(packet.tod[i]);
-    uid_set.AddUID(uid);
+    pending.uids.AddUID(uid);
     uid_map::iterator iter = port_uids.find(uid);
     if (iter == port_uids.end()) {
       port_uids[uid] = std::pair<IPV4Address, uint8_t>(source_address, 0);
@@ -1708,20 +2195,26 @@ void ArtNetNodeImpl::UpdatePortFromTodPacket(InputPort *port,
     }
   }
 
-  // If this is the one and only block from this node, we can remove all uids
-  // that don't appear in it.
+  // Once we have all the blocks from this node, we can remove all uids that
+  // don't appear in them. If a block is dropped the TOD stays incomplete
+  // until the node sends it again, and we rely on RDM_MISSED_TODDATA_LIMIT.
   // There is a bug in ArtNet nodes where sometimes UidCount > UidTotal.
-  if (uid_count >= NetworkToHost(packet.uid_total)) {
+  if (pending.uids.Size() >= pending.uid_total) {
     uid_map::iterator iter = port_uids.begin();
     while (iter != port_uids.end()) {
       if (iter->second.first == source_address &&
-          !uid_set.Contains(iter->first)) {
+          !pending.uids.Contains(iter->first)) {
         port_uids.erase(iter++);
       } else {
         ++iter;
       }
     }
 
+    CachedTod &cached_tod = m_tod_cache[MakeTodCacheKey(*port, source_address)];
+    cached_tod.uids = pending.uids;
+    cached_tod.updated = *m_ss->WakeUpTime();
+    port->pending_tods.erase(source_address);
+
     // mark this node as complete
     if (port->discovery_node_set.erase(source_address)) {
       // if the set is now 0, and it was non-0 initally and we have a
@@ -1734,17 +2227,58 @@ void ArtNetNodeImpl::UpdatePortFromTodPacket(InputPort *port,
     }
   }
 
-  // Removing uids from multi-block messages is much harder as you need to
-  // consider dropped packets. For the moment we rely on the
-  // RDM_MISSED_TODDATA_LIMIT to clean these up.
-  // TODO(simon): figure this out sometime
-
   // if we're not in the middle of a discovery process, send an unsolicited
   // update if we have a callback
   if (!port->discovery_callback)
     port->RunTodCallback();
 }
 
+ArtNetNodeImpl::TodCacheKey ArtNetNodeImpl::MakeTodCacheKey(
+    const InputPort &port,
+    const IPV4Address &node_address) const {
+  uint16_t port_address = (m_net_address << 8) | port.PortAddress();
+  return TodCacheKey(port_address, node_address);
+}
+
+void ArtNetNodeImpl::LoadCachedTod(InputPort *port) {
+  const TodCacheKey first_key = MakeTodCacheKey(*port, IPV4Address());
+  const uint16_t port_address = first_key.first;
+  TodCache::const_iterator iter = m_tod_cache.lower_bound(first_key);
+  bool loaded = false;
+  for (; iter != m_tod_cache.end() && iter->first.first == port_address;
+       ++iter) {
+    UIDSet::Iterator uid_iter = iter->second.uids.Begin();
+    for (; uid_iter != iter->second.uids.End(); ++uid_iter) {
+      port->uids[*uid_iter] = std::pair<IPV4Address, uint8_t>(
+          iter->first.second, 0);
+      loaded = true;
+    }
+  }
+  if (loaded) {
+    port->RunTodCallback();
+  }
+}
+
+bool ArtNetNodeImpl::HaveRecentTods(const InputPort &port) const {
+  if (port.subscribed_nodes.empty()) {
+    return false;
+  }
+
+  const TimeStamp threshold = (
+      *m_ss->WakeUpTime() - TimeInterval(TOD_CACHE_TIMEOUT, 0));
+  InputPort::SubscribedNodes::const_iterator iter =
+      port.subscribed_nodes.begin();
+  for (; iter != port.subscribed_nodes.end(); ++iter) {
+    TodCache::const_iterator cache_iter = m_tod_cache.find(
+        MakeTodCacheKey(port, iter->address));
+    if (cache_iter == m_tod_cache.end() ||
+        cache_iter->second.updated < threshold) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool ArtNetNodeImpl::StartDiscoveryProcess(InputPort *port,
                                            RDMDiscoveryCallback *callback) {
   if (port->discovery_callback) {
@@ -1762,10 +2296,10 @@ bool ArtNetNodeImpl::StartDiscoveryProcess(InputPort *port,
   // these nodes. If ArtTod packets arrive after discovery completes, we'll
   // call the unsolicited handler
   port->discovery_node_set.clear();
-  map<IPV4Address, TimeStamp>::const_iterator node_iter =
+  InputPort::SubscribedNodes::const_iterator node_iter =
       port->subscribed_nodes.begin();
   for (; node_iter != port->subscribed_nodes.end(); node_iter++)
-    port->discovery_node_set.insert(node_iter->first);
+    port->discovery_node_set.insert(node_iter->address);
 
   port->discovery_timeout = m_ss->RegisterSingleTimeout(
       RDM_TOD_TIMEOUT_MS,
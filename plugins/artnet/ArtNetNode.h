@@ -34,6 +34,7 @@
 #include "ola/network/Interface.h"
 #include "ola/io/SelectServerInterface.h"
 #include "ola/network/Socket.h"
+#include "ola/network/XDPReceiver.h"
 #include "ola/rdm/QueueingRDMController.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMFrame.h"
@@ -69,7 +70,11 @@ class ArtNetNodeOptions {
         use_limited_broadcast_address(false),
         rdm_queue_size(20),
         broadcast_threshold(30),
-        input_port_count(4) {
+        input_port_count(4),
+        output_port_count(ARTNET_MAX_PORTS),
+        recv_batch_size(16),
+        use_sync(false),
+        trim_dmx(false) {
   }
 
   bool always_broadcast;
@@ -77,9 +82,27 @@ class ArtNetNodeOptions {
   unsigned int rdm_queue_size;
   unsigned int broadcast_threshold;
   uint8_t input_port_count;
+  // Ports beyond the first ARTNET_MAX_PORTS are announced in pages of
+  // ARTNET_MAX_PORTS, each with its own bind index and the next subnet.
+  uint8_t output_port_count;
+  // The maximum number of datagrams to read each time the socket is ready.
+  unsigned int recv_batch_size;
+  // Send an ArtSync after the ArtDmx packets in each batch.
+  bool use_sync;
+  // Only send the slots up to the last non-zero one, plus enough to zero the
+  // slots that were set in the previous frame.
+  bool trim_dmx;
+  // Kernel drop counting & receive buffer tuning for the socket.
+  ola::network::UDPReceiveOptions receive_options;
 };
 
 
+/**
+ * @brief Called with the start code and data of a received ArtNzs packet.
+ */
+typedef ola::Callback2<void, uint8_t, const DmxBuffer&> NzsHandler;
+
+
 class ArtNetNodeImpl {
  public:
   /**
@@ -109,6 +132,16 @@ class ArtNetNodeImpl {
    */
   bool Stop();
 
+  /**
+   * @brief Also receive ArtNet packets with an AF_XDP receiver.
+   * @param receiver the XDPReceiver to use, may be NULL. This must outlive the
+   *   node.
+   *
+   * This must be called after Start(). The socket is still used for sending,
+   * and for packets the receiver doesn't see.
+   */
+  void SetXDPReceiver(ola::network::XDPReceiver *receiver);
+
   /**
    * @brief Start the configuration transaction.
    *
@@ -162,9 +195,7 @@ class ArtNetNodeImpl {
    * @param subnet_address the ArtNet 'subnet' address, 4 bits.
    */
   bool SetSubnetAddress(uint8_t subnet_address);
-  uint8_t SubnetAddress() const {
-    return m_output_ports[0].universe_address >> 4;
-  }
+  uint8_t SubnetAddress() const { return m_subnet_address; }
 
   /**
    * Get the number of input ports
@@ -182,20 +213,20 @@ class ArtNetNodeImpl {
    *
    * Return the 8bit universe address for a port. This does not include the
    * ArtNet III net-address.
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id, less than the number of ports
    * @return The universe address for the port. Invalid port_ids return 0.
    */
   uint8_t GetInputPortUniverse(uint8_t port_id) const;
 
   /**
    * @brief Disable an input port.
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id, less than the number of ports
    */
   void DisableInputPort(uint8_t port_id);
 
   /**
    * @brief Check the state of an input port
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id, less than the number of ports
    * @return the state (enabled or disabled) of an input port. An invalid
    * port_id returns false.
    */
@@ -203,27 +234,27 @@ class ArtNetNodeImpl {
 
   /**
    * @brief Set the universe for an output port.
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id, less than the number of ports
    * @param universe_id the new universe id.
    */
   bool SetOutputPortUniverse(uint8_t port_id, uint8_t universe_id);
 
   /**
    * Return the current universe address for an output port
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id, less than the number of ports
    * @return the universe address for the port
    */
   uint8_t GetOutputPortUniverse(uint8_t port_id);
 
   /**
    * @brief Disable an output port.
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id, less than the number of ports
    */
   void DisableOutputPort(uint8_t port_id);
 
   /**
    * @brief Check the state of an output port
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id, less than the number of ports
    * @return the state (enabled or disabled) of an output port. An invalid
    * port_id returns false.
    */
@@ -235,7 +266,7 @@ class ArtNetNodeImpl {
 
   /**
    * @brief Set the merge mode for an output port
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id, less than the number of ports
    * @param merge_mode the artnet_merge_mode
    */
   bool SetMergeMode(uint8_t port_id, artnet_merge_mode merge_mode);
@@ -256,6 +287,32 @@ class ArtNetNodeImpl {
    */
   bool SendDMX(uint8_t port_id, const ola::DmxBuffer &buffer);
 
+  /**
+   * @brief Send data with a non-zero start code in an ArtNzs packet.
+   * @param port_id port to send on
+   * @param start_code the start code, this can't be 0 or the RDM start code.
+   * @param buffer the data, not including the start code.
+   * @return true if it was send successfully, false otherwise
+   */
+  bool SendNzs(uint8_t port_id, uint8_t start_code,
+               const ola::DmxBuffer &buffer);
+
+  /**
+   * @brief Queue the packets sent until EndBatch() and send them together.
+   *
+   * Calls can be nested, the packets are sent by the outermost EndBatch().
+   */
+  void BeginBatch();
+
+  /**
+   * @brief Send the packets queued since BeginBatch().
+   *
+   * If use_sync is set, an ArtSync follows the ArtDmx packets so the
+   * receiving nodes output all the universes in the batch together.
+   * @return false if any of the packets couldn't be sent.
+   */
+  bool EndBatch();
+
   /**
    * @brief Flush the TOD and force a full discovery.
    *
@@ -329,6 +386,14 @@ class ArtNetNodeImpl {
                      DmxBuffer *buffer,
                      ola::Callback0<void> *handler);
 
+  /**
+   * @brief Set the closure to be called when we receive ArtNzs data for this
+   * universe.
+   * @param port_id the id of the port to register the handler for
+   * @param handler the NzsHandler, ownership is transferred to the node.
+   */
+  bool SetNzsHandler(uint8_t port_id, NzsHandler *handler);
+
   /**
    * @brief Send an set of UIDs in one of more ArtTod packets
    * @param port_id the id of the port to send on
@@ -361,6 +426,16 @@ class ArtNetNodeImpl {
   typedef std::map<ola::rdm::UID,
                    std::pair<ola::network::IPV4Address, uint8_t> > uid_map;
 
+  // The last complete TOD received from a node.
+  struct CachedTod {
+    ola::rdm::UIDSet uids;
+    TimeStamp updated;
+  };
+
+  // The 15-bit port address and the IP address of the node.
+  typedef std::pair<uint16_t, ola::network::IPV4Address> TodCacheKey;
+  typedef std::map<TodCacheKey, CachedTod> TodCache;
+
   enum { MAX_MERGE_SOURCES = 2 };
 
   struct DMXSource {
@@ -378,8 +453,12 @@ class ArtNetNodeImpl {
     bool is_merging;
     DMXSource sources[MAX_MERGE_SOURCES];
     DmxBuffer *buffer;
+    // In synchronous mode the merged data is held here until the ArtSync.
+    DmxBuffer sync_buffer;
+    bool sync_pending;
     std::map<ola::rdm::UID, ola::network::IPV4Address> uid_map;
     Callback0<void> *on_data;
+    NzsHandler *on_nzs;
     Callback0<void> *on_discover;
     Callback0<void> *on_flush;
     ola::Callback2<void,
@@ -389,6 +468,7 @@ class ArtNetNodeImpl {
 
   bool m_running;
   uint8_t m_net_address;  // this is the 'net' portion of the Artnet address
+  uint8_t m_subnet_address;  // the subnet of the first page of ports
   bool m_send_reply_on_change;
   std::string m_short_name;
   std::string m_long_name;
@@ -397,6 +477,31 @@ class ArtNetNodeImpl {
   ola::io::SelectServerInterface *m_ss;
   bool m_always_broadcast;
   bool m_use_limited_broadcast_address;
+  bool m_use_sync;
+  bool m_trim_dmx;
+  const ola::network::UDPReceiveOptions m_receive_options;
+  // holds the data from an ArtNzs while the handlers run
+  DmxBuffer m_nzs_buffer;
+
+  // ArtSync state
+  unsigned int m_batch_depth;
+  // true if ArtDmx packets have been sent since the last ArtSync.
+  bool m_sync_required;
+  // the source of the last ArtDmx we received, only it can sync us.
+  ola::network::IPV4Address m_last_dmx_source;
+  // when we last received an ArtSync, we're in synchronous mode until
+  // SYNC_TIMEOUT has passed.
+  TimeStamp m_last_sync;
+
+  ola::thread::timeout_id m_expiry_timeout;
+
+  // The encoded ArtPollReply for each page of ports, these are rebuilt when
+  // the node's configuration changes.
+  std::vector<artnet_packet> m_poll_replies;
+  bool m_poll_replies_valid;
+  // when we last replied to an ArtPoll, and the scheduled reply if any.
+  TimeStamp m_last_poll_reply;
+  ola::thread::timeout_id m_poll_reply_timeout;
 
   // The following keep track of "Configuration mode"
   bool m_in_configuration_mode;
@@ -404,15 +509,36 @@ class ArtNetNodeImpl {
   bool m_artpollreply_required;
 
   InputPorts m_input_ports;
-  OutputPort m_output_ports[ARTNET_MAX_PORTS];
+  // Outlives changes to the port addresses so a port can be moved back
+  // without waiting for the nodes.
+  TodCache m_tod_cache;
+  std::vector<OutputPort> m_output_ports;
+  // The ids of the enabled output ports, indexed by universe address.
+  typedef std::vector<uint8_t> PortIds;
+  PortIds m_output_port_index[256];
   ola::network::Interface m_interface;
   std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
+  ola::network::DatagramBatch m_recv_batch;
+  ola::network::XDPReceiver *m_xdp_receiver;
 
   /**
    * @brief Called when there is data on this socket
    */
   void SocketReady();
 
+  /**
+   * @brief Called with each packet from the XDPReceiver.
+   */
+  void XDPPacketReady(const uint8_t *data, unsigned int length,
+                      const ola::network::IPV4SocketAddress &source);
+
+  /**
+   * @brief Remove the subscribed nodes we haven't heard from within
+   * NODE_TIMEOUT, and the merge sources we haven't heard from within
+   * MERGE_TIMEOUT.
+   */
+  bool ExpireNodesAndSources();
+
   /**
    * @brief Send an ArtPoll if we're both running and not in configuration mode.
    *
@@ -434,6 +560,31 @@ class ArtNetNodeImpl {
    */
   bool SendPollReply(const ola::network::IPV4Address &destination);
 
+  /**
+   * @brief Encode the ArtPollReply packets into m_poll_replies.
+   */
+  void BuildPollReplies();
+
+  /**
+   * @brief Encode the ArtPollReply for one page of ARTNET_MAX_PORTS ports.
+   */
+  void BuildPollReplyPage(unsigned int page,
+                          unsigned int page_count,
+                          artnet_packet *packet);
+
+  /**
+   * @brief Reply to an ArtPoll, limiting the rate of replies.
+   *
+   * If we replied within MIN_POLL_REPLY_INTERVAL_MS, a single reply is
+   * scheduled instead, and any ArtPolls received until then share it.
+   */
+  void ReplyToPoll();
+
+  /**
+   * @brief Called when a scheduled reply to an ArtPoll is due.
+   */
+  void SendScheduledPollReply();
+
   /**
    * @brief Send an IPProgReply
    */
@@ -467,6 +618,30 @@ class ArtNetNodeImpl {
                         const artnet_dmx_t &packet,
                         unsigned int packet_size);
 
+  /**
+   * @brief Handle an ArtNzs packet, these aren't merged.
+   */
+  void HandleNzsPacket(const ola::network::IPV4Address &source_address,
+                       const artnet_nzs_t &packet,
+                       unsigned int packet_size);
+
+  /**
+   * @brief Handle an ArtSync packet, this outputs the held DMX data.
+   */
+  void HandleSyncPacket(const ola::network::IPV4Address &source_address,
+                        const artnet_sync_t &packet,
+                        unsigned int packet_size);
+
+  /**
+   * @brief Send an ArtSync packet.
+   */
+  bool SendSync();
+
+  /**
+   * @brief Check if we've received an ArtSync within the last SYNC_TIMEOUT.
+   */
+  bool InSyncMode() const;
+
   /**
    * @brief Handle a TOD Request packet
    */
@@ -538,6 +713,19 @@ class ArtNetNodeImpl {
                   unsigned int size,
                   const ola::network::IPV4Address &destination);
 
+  /**
+   * @brief Send an ArtDmx or ArtNzs packet to the nodes subscribed to a port,
+   * broadcasting if there are enough of them.
+   * @param port the InputPort the data is for
+   * @param packet the packet to send
+   * @param size the size of the packet, excluding the header portion
+   * @param[out] sent set to true if any packets were sent
+   */
+  bool SendDataPacket(InputPort *port,
+                      const artnet_packet &packet,
+                      unsigned int size,
+                      bool *sent);
+
   /**
    * @brief Timeout a pending RDM request
    * @param port the id of the port to timeout.
@@ -554,7 +742,10 @@ class ArtNetNodeImpl {
   /**
    * @brief Update a port from a source, merging if necessary
    */
-  void UpdatePortFromSource(OutputPort *port, const DMXSource &source);
+  void UpdatePortFromSource(OutputPort *port,
+                            const ola::network::IPV4Address &source_address,
+                            const uint8_t *data,
+                            unsigned int length);
 
   /**
    * @brief Check the version number of a incoming packet
@@ -615,6 +806,24 @@ class ArtNetNodeImpl {
    */
   void ReleaseDiscoveryLock(InputPort *port);
 
+  /**
+   * @brief Build the TOD cache key for a node on an input port.
+   */
+  TodCacheKey MakeTodCacheKey(const InputPort &port,
+                              const ola::network::IPV4Address &node) const;
+
+  /**
+   * @brief Populate the UIDs of a port from the TOD cache, this is called
+   * when the port address changes.
+   */
+  void LoadCachedTod(InputPort *port);
+
+  /**
+   * @brief Check if all the nodes subscribed to a port have sent us their
+   * TOD within TOD_CACHE_TIMEOUT.
+   */
+  bool HaveRecentTods(const InputPort &port) const;
+
   /**
    * @brief Start the discovery process, this puts the port into discovery mode and
    * sets up the callback.
@@ -624,6 +833,11 @@ class ArtNetNodeImpl {
   bool StartDiscoveryProcess(InputPort *port,
                              ola::rdm::RDMDiscoveryCallback *callback);
 
+  /**
+   * @brief Rebuild m_output_port_index after an output port changes.
+   */
+  void UpdateOutputPortIndex();
+
   /**
    * @brief Setup the networking components.
    */
@@ -642,8 +856,20 @@ class ArtNetNodeImpl {
   static const unsigned int MERGE_TIMEOUT = 10;  // As per the spec
   // seconds after which a node is marked as inactive for the dmx merging
   static const unsigned int NODE_TIMEOUT = 31;
+  // how often we check for subscribed nodes & merge sources which have timed
+  // out
+  static const unsigned int NODE_EXPIRY_INTERVAL_MS = 1000;
+  // the minimum time between replies to ArtPolls
+  static const unsigned int MIN_POLL_REPLY_INTERVAL_MS = 500;
+  // the max random delay added to a scheduled ArtPollReply, so the nodes that
+  // defer their replies don't all send at once.
+  static const unsigned int POLL_REPLY_JITTER_MS = 500;
+  // seconds without an ArtSync before we leave synchronous mode
+  static const unsigned int SYNC_TIMEOUT = 4;
   // mseconds we wait for a TodData packet before declaring a node missing
   static const unsigned int RDM_TOD_TIMEOUT_MS = 4000;
+  // seconds for which a TOD from a node saves us sending an ArtTodRequest
+  static const unsigned int TOD_CACHE_TIMEOUT = 10;
   // Number of missed TODs before we decide a UID has gone
   static const unsigned int RDM_MISSED_TODDATA_LIMIT = 3;
   // The maximum number of requests we'll allow in the queue. This is a per
@@ -704,6 +930,10 @@ class ArtNetNode {
   bool Start() { return m_impl.Start(); }
   bool Stop() { return m_impl.Stop(); }
 
+  void SetXDPReceiver(ola::network::XDPReceiver *receiver) {
+    m_impl.SetXDPReceiver(receiver);
+  }
+
   bool EnterConfigurationMode() {
     return m_impl.EnterConfigurationMode();
   }
@@ -782,6 +1012,14 @@ class ArtNetNode {
     return m_impl.SendDMX(port_id, buffer);
   }
 
+  bool SendNzs(uint8_t port_id, uint8_t start_code,
+               const ola::DmxBuffer &buffer) {
+    return m_impl.SendNzs(port_id, start_code, buffer);
+  }
+
+  void BeginBatch() { m_impl.BeginBatch(); }
+  bool EndBatch() { return m_impl.EndBatch(); }
+
   /**
    * @brief Trigger full discovery for a port
    */
@@ -822,6 +1060,9 @@ class ArtNetNode {
                      ola::Callback0<void> *handler) {
     return m_impl.SetDMXHandler(port_id, buffer, handler);
   }
+  bool SetNzsHandler(uint8_t port_id, NzsHandler *handler) {
+    return m_impl.SetNzsHandler(port_id, handler);
+  }
   bool SendTod(uint8_t port_id, const ola::rdm::UIDSet &uid_set) {
     return m_impl.SendTod(port_id, uid_set);
   }
@@ -0,0 +1,199 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ArtNetNodeBenchmark.cpp
+ * Measures the receive path of the ArtNetNode.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/base/Array.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/Interface.h"
+#include "ola/testing/Benchmark.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "ola/testing/UDPCapture.h"
+#include "plugins/artnet/ArtNetNode.h"
+#include "plugins/artnet/ArtNetPackets.h"
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::network::IPV4Address;
+using ola::plugin::artnet::ARTNET_MAX_PORTS;
+using ola::plugin::artnet::ArtNetNode;
+using ola::plugin::artnet::ArtNetNodeOptions;
+using ola::testing::Benchmark;
+using ola::testing::MockUDPSocket;
+using std::string;
+using std::vector;
+
+namespace {
+
+const uint16_t ARTNET_PORT = 6454;
+
+/*
+ * Build an ArtDmx packet for a universe.
+ */
+string BuildArtDmx(uint16_t port_address) {
+  const uint8_t header[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,  // OpDmx
+    0x0, 14,  // protocol version
+    0,  // sequence
+    0,  // physical port
+    static_cast<uint8_t>(port_address & 0xff),
+    static_cast<uint8_t>(port_address >> 8),
+    ola::DMX_UNIVERSE_SIZE >> 8, ola::DMX_UNIVERSE_SIZE & 0xff,
+  };
+  string packet(reinterpret_cast<const char*>(header), sizeof(header));
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    packet.push_back(static_cast<char>(i * 7 + port_address));
+  }
+  return packet;
+}
+
+
+class ArtNetNodeBenchmark {
+ public:
+  ArtNetNodeBenchmark()
+      : m_socket(NULL),
+        m_frames(0) {
+    ola::network::IPV4Address::FromString("10.0.0.10", &m_peer);
+  }
+
+  /*
+   * Create a node which listens for the port addresses, and replays the
+   * packets to it.
+   */
+  bool Setup(const vector<string> &packets,
+             const std::set<uint16_t> &port_addresses) {
+    m_node.reset();
+    m_packets = packets;
+    if (m_packets.empty()) {
+      return false;
+    }
+
+    ola::network::InterfaceBuilder builder;
+    builder.SetAddress("10.0.0.1");
+    builder.SetSubnetMask("255.0.0.0");
+    builder.SetBroadcast("10.255.255.255");
+
+    // Replies to ArtPolls are dropped.
+    m_socket = new MockUDPSocket();
+    m_socket->SetDiscardMode(true);
+    ArtNetNodeOptions options;
+    m_node.reset(new ArtNetNode(builder.Construct(), &m_ss, options,
+                                m_socket));
+
+    // All ports share the net & subnet.
+    uint16_t first = port_addresses.empty() ? 0 : *port_addresses.begin();
+    m_node->SetNetAddress(first >> 8);
+    m_node->SetSubnetAddress((first >> 4) & 0x0f);
+    uint8_t port = 0;
+    std::set<uint16_t>::const_iterator iter = port_addresses.begin();
+    for (; iter != port_addresses.end() && port < ARTNET_MAX_PORTS; ++iter) {
+      if ((*iter & 0xfff0) != (first & 0xfff0)) {
+        continue;
+      }
+      m_node->SetOutputPortUniverse(port, *iter & 0x0f);
+      m_node->SetDMXHandler(
+          port, &m_buffers[port],
+          NewCallback(this, &ArtNetNodeBenchmark::NewFrame));
+      port++;
+    }
+    return m_node->Start();
+  }
+
+  void Receive(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      const string &packet = m_packets[i % m_packets.size()];
+      m_socket->InjectData(reinterpret_cast<const uint8_t*>(packet.data()),
+                           packet.size(), m_peer, ARTNET_PORT);
+    }
+  }
+
+ private:
+  ola::io::SelectServer m_ss;
+  MockUDPSocket *m_socket;
+  std::auto_ptr<ArtNetNode> m_node;
+  DmxBuffer m_buffers[ARTNET_MAX_PORTS];
+  vector<string> m_packets;
+  IPV4Address m_peer;
+  unsigned int m_frames;
+
+  void NewFrame() { m_frames++; }
+};
+}  // namespace
+
+
+/*
+ * With no arguments the benchmark uses generated ArtDmx packets, otherwise
+ * the Art-Net datagrams in the pcap file are replayed.
+ */
+int main(int argc, char *argv[]) {
+  ola::InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_STDERR);
+
+  ArtNetNodeBenchmark fixture;
+  Benchmark benchmark("ArtNetNode", &std::cout);
+
+  if (argc > 1) {
+    vector<string> packets;
+    if (!ola::testing::LoadUDPCapture(argv[1], ARTNET_PORT, &packets)) {
+      return 1;
+    }
+    std::set<uint16_t> port_addresses;
+    vector<string>::const_iterator iter = packets.begin();
+    for (; iter != packets.end(); ++iter) {
+      if (iter->size() > 16 && (*iter)[8] == 0x00 && (*iter)[9] == 0x50) {
+        port_addresses.insert(static_cast<uint8_t>((*iter)[14]) |
+                              static_cast<uint8_t>((*iter)[15]) << 8);
+      }
+    }
+    if (!fixture.Setup(packets, port_addresses)) {
+      OLA_WARN << "No Art-Net packets in " << argv[1];
+      return 1;
+    }
+    benchmark.Run("Replay", packets.size(),
+                  NewCallback(&fixture, &ArtNetNodeBenchmark::Receive));
+    return 0;
+  }
+
+  const unsigned int universe_counts[] = {1, 4};
+  for (unsigned int i = 0; i < arraysize(universe_counts); i++) {
+    vector<string> packets;
+    std::set<uint16_t> port_addresses;
+    for (uint16_t universe = 0; universe < universe_counts[i]; universe++) {
+      packets.push_back(BuildArtDmx(universe));
+      port_addresses.insert(universe);
+    }
+    if (!fixture.Setup(packets, port_addresses)) {
+      return 1;
+    }
+    benchmark.Run("ArtDmx", universe_counts[i],
+                  NewCallback(&fixture, &ArtNetNodeBenchmark::Receive));
+  }
+  return 0;
+}
@@ -73,17 +73,24 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testBasicBehaviour);
   CPPUNIT_TEST(testConfigurationMode);
   CPPUNIT_TEST(testExtendedInputPorts);
+  CPPUNIT_TEST(testPortPages);
+  CPPUNIT_TEST(testPollReplyRateLimit);
   CPPUNIT_TEST(testBroadcastSendDMX);
   CPPUNIT_TEST(testBroadcastSendDMXZeroUniverse);
   CPPUNIT_TEST(testLimitedBroadcastDMX);
+  CPPUNIT_TEST(testTrimmedSendDMX);
+  CPPUNIT_TEST(testNzs);
   CPPUNIT_TEST(testNonBroadcastSendDMX);
+  CPPUNIT_TEST(testSendDMXWithSync);
   CPPUNIT_TEST(testReceiveDMX);
   CPPUNIT_TEST(testReceiveDMXZeroUniverse);
+  CPPUNIT_TEST(testReceiveDMXWithSync);
   CPPUNIT_TEST(testHTPMerge);
   CPPUNIT_TEST(testLTPMerge);
   CPPUNIT_TEST(testControllerDiscovery);
   CPPUNIT_TEST(testControllerIncrementalDiscovery);
   CPPUNIT_TEST(testUnsolicitedTod);
+  CPPUNIT_TEST(testTodBlocksAndCache);
   CPPUNIT_TEST(testResponderDiscovery);
   CPPUNIT_TEST(testRDMResponder);
   CPPUNIT_TEST(testRDMRequest);
@@ -98,6 +105,7 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
       : CppUnit::TestFixture(),
         ss(NULL, &m_clock),
         m_got_dmx(false),
+        m_nzs_start_code(0),
         m_got_rdm_timeout(false),
         m_discovery_done(false),
         m_tod_flush(false),
@@ -114,17 +122,24 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   void testBasicBehaviour();
   void testConfigurationMode();
   void testExtendedInputPorts();
+  void testPortPages();
+  void testPollReplyRateLimit();
   void testBroadcastSendDMX();
   void testBroadcastSendDMXZeroUniverse();
   void testLimitedBroadcastDMX();
+  void testTrimmedSendDMX();
+  void testNzs();
   void testNonBroadcastSendDMX();
+  void testSendDMXWithSync();
   void testReceiveDMX();
   void testReceiveDMXZeroUniverse();
+  void testReceiveDMXWithSync();
   void testHTPMerge();
   void testLTPMerge();
   void testControllerDiscovery();
   void testControllerIncrementalDiscovery();
   void testUnsolicitedTod();
+  void testTodBlocksAndCache();
   void testResponderDiscovery();
   void testRDMResponder();
   void testRDMRequest();
@@ -137,6 +152,8 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   ola::MockClock m_clock;
   ola::io::SelectServer ss;
   bool m_got_dmx;
+  uint8_t m_nzs_start_code;
+  string m_nzs_data;
   bool m_got_rdm_timeout;
   bool m_discovery_done;
   bool m_tod_flush;
@@ -156,6 +173,11 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
    */
   void NewDmx() { m_got_dmx = true; }
 
+  void NewNzs(uint8_t start_code, const DmxBuffer &buffer) {
+    m_nzs_start_code = start_code;
+    m_nzs_data = buffer.ToString();
+  }
+
   void DiscoveryComplete(const UIDSet &uids) {
     m_uids = uids;
     m_discovery_done = true;
@@ -270,6 +292,7 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
 
   static const uint8_t POLL_MESSAGE[];
   static const uint8_t POLL_REPLY_MESSAGE[];
+  static const uint8_t SYNC_MESSAGE[];
   static const uint8_t TOD_CONTROL[];
   static const uint16_t ARTNET_PORT = 6454;
 };
@@ -324,6 +347,14 @@ const uint8_t ArtNetNodeTest::POLL_REPLY_MESSAGE[] = {
 };
 
 
+const uint8_t ArtNetNodeTest::SYNC_MESSAGE[] = {
+  'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+  0x00, 0x52,
+  0x0, 14,
+  0, 0
+};
+
+
 const uint8_t ArtNetNodeTest::TOD_CONTROL[] = {
   'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
   0x00, 0x82,
@@ -629,6 +660,157 @@ void ArtNetNodeTest::testExtendedInputPorts() {
 }
 
 
+/**
+ * Check a node with more than one page of ports.
+ */
+void ArtNetNodeTest::testPortPages() {
+  ArtNetNodeOptions node_options;
+  node_options.always_broadcast = true;
+  node_options.input_port_count = 8;
+  node_options.output_port_count = 8;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+
+  node.SetShortName("Short Name");
+  node.SetLongName("This is the very long name");
+  node.SetNetAddress(4);
+  node.SetSubnetAddress(2);
+  node.SetOutputPortUniverse(0, 3);
+  node.SetOutputPortUniverse(5, 3);
+  node.SetInputPortUniverse(6, 1);
+  DmxBuffer input_buffer;
+  node.SetDMXHandler(5,
+                     &input_buffer,
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+
+  // the second page of ports uses the next subnet
+  OLA_ASSERT_EQ((uint8_t) 2, node.SubnetAddress());
+  OLA_ASSERT_EQ((uint8_t) 0x23, node.GetOutputPortUniverse(0));
+  OLA_ASSERT_EQ((uint8_t) 0x33, node.GetOutputPortUniverse(5));
+  OLA_ASSERT_EQ((uint8_t) 0x31, node.GetInputPortUniverse(6));
+  OLA_ASSERT(node.OutputPortState(5));
+  OLA_ASSERT(node.InputPortState(6));
+  OLA_ASSERT_FALSE(node.OutputPortState(8));
+
+  // an ArtPoll gets a reply for each page
+  {
+    SocketVerifier verifer(m_socket);
+    uint8_t first_page[sizeof(POLL_REPLY_MESSAGE)];
+    memcpy(first_page, POLL_REPLY_MESSAGE, sizeof(POLL_REPLY_MESSAGE));
+    first_page[211] = 1;  // bind index
+    ExpectedBroadcast(first_page, sizeof(first_page));
+
+    uint8_t second_page[sizeof(POLL_REPLY_MESSAGE)];
+    memcpy(second_page, POLL_REPLY_MESSAGE, sizeof(POLL_REPLY_MESSAGE));
+    second_page[19] = 3;  // subnet address
+    second_page[180] = 0;  // good input
+    second_page[182] = 0;  // good output
+    second_page[183] = 0x80;
+    const uint8_t sw_in_out[] = {0x30, 0x30, 0x31, 0x30,
+                                 0x30, 0x33, 0x30, 0x30};
+    memcpy(second_page + 186, sw_in_out, sizeof(sw_in_out));
+    second_page[211] = 2;  // bind index
+    ExpectedBroadcast(second_page, sizeof(second_page));
+
+    ReceiveFromPeer(POLL_MESSAGE, sizeof(POLL_MESSAGE), peer_ip);
+  }
+
+  // DMX for the second page is delivered to port 5
+  {
+    SocketVerifier verifer(m_socket);
+    const uint8_t DMX_MESSAGE[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x50,
+      0x0, 14,
+      0,  // seq #
+      1,  // physical port
+      0x33, 4,  // subnet & net address
+      0, 6,  // dmx length
+      0, 1, 2, 3, 4, 5
+    };
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+  }
+
+  // and input port 6 sends with the second page's subnet
+  {
+    SocketVerifier verifer(m_socket);
+    const uint8_t DMX_MESSAGE[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x50,
+      0x0, 14,
+      0,  // seq #
+      6,  // physical port
+      0x31, 4,  // subnet & net address
+      0, 6,  // dmx length
+      0, 1, 2, 3, 4, 5
+    };
+    ExpectedBroadcast(DMX_MESSAGE, sizeof(DMX_MESSAGE));
+
+    DmxBuffer dmx;
+    dmx.SetFromString("0,1,2,3,4,5");
+    OLA_ASSERT(node.SendDMX(6, dmx));
+  }
+}
+
+
+/**
+ * Check that replies to ArtPolls are rate limited, and the cached reply is
+ * updated when the configuration changes.
+ */
+void ArtNetNodeTest::testPollReplyRateLimit() {
+  ArtNetNodeOptions node_options;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  node.SetShortName("Short Name");
+  node.SetLongName("This is the very long name");
+  node.SetNetAddress(4);
+  node.SetSubnetAddress(2);
+  node.SetOutputPortUniverse(0, 3);
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+
+  {
+    SocketVerifier verifer(m_socket);
+    ExpectedBroadcast(POLL_REPLY_MESSAGE, sizeof(POLL_REPLY_MESSAGE));
+    ReceiveFromPeer(POLL_MESSAGE, sizeof(POLL_MESSAGE), peer_ip);
+  }
+
+  // further ArtPolls share a single, deferred, reply
+  {
+    SocketVerifier verifer(m_socket);
+    ReceiveFromPeer(POLL_MESSAGE, sizeof(POLL_MESSAGE), peer_ip);
+    ReceiveFromPeer(POLL_MESSAGE, sizeof(POLL_MESSAGE), peer_ip2);
+  }
+
+  {
+    SocketVerifier verifer(m_socket);
+    ExpectedBroadcast(POLL_REPLY_MESSAGE, sizeof(POLL_REPLY_MESSAGE));
+    m_clock.AdvanceTime(1, 0);
+    ss.RunOnce();
+  }
+
+  // a change to the configuration updates the reply
+  {
+    SocketVerifier verifer(m_socket);
+    uint8_t expected_poll_reply_packet[sizeof(POLL_REPLY_MESSAGE)];
+    memcpy(expected_poll_reply_packet, POLL_REPLY_MESSAGE,
+           sizeof(POLL_REPLY_MESSAGE));
+    expected_poll_reply_packet[32] = 'G';  // short name
+    expected_poll_reply_packet[115] = '1';  // node report
+    ExpectedBroadcast(expected_poll_reply_packet,
+                      sizeof(expected_poll_reply_packet));
+    node.SetShortName("Short Game");
+  }
+  OLA_ASSERT(node.Stop());
+}
+
+
 /**
  * Check sending DMX using broadcast works.
  */
@@ -838,6 +1020,202 @@ void ArtNetNodeTest::testLimitedBroadcastDMX() {
 }
 
 
+/**
+ * Check that trim_dmx only sends the slots in use.
+ */
+void ArtNetNodeTest::testTrimmedSendDMX() {
+  m_socket->SetDiscardMode(true);
+
+  ArtNetNodeOptions node_options;
+  node_options.always_broadcast = true;
+  node_options.trim_dmx = true;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupInputPort(&node);
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  {
+    SocketVerifier verifer(m_socket);
+    const uint8_t DMX_MESSAGE[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x50,
+      0x0, 14,
+      0,  // seq #
+      1,  // physical port
+      0x23, 4,  // subnet & net address
+      0, 4,  // dmx length
+      1, 2, 3, 0
+    };
+    ExpectedBroadcast(DMX_MESSAGE, sizeof(DMX_MESSAGE));
+
+    DmxBuffer dmx;
+    dmx.Blackout();
+    dmx.SetFromString("1,2,3");
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+  }
+
+  // the slots which were set in the last frame are sent as zeros
+  {
+    SocketVerifier verifer(m_socket);
+    const uint8_t DMX_MESSAGE2[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x50,
+      0x0, 14,
+      1,  // seq #
+      1,  // physical port
+      0x23, 4,  // subnet & net address
+      0, 4,  // dmx length
+      1, 0, 0, 0
+    };
+    ExpectedBroadcast(DMX_MESSAGE2, sizeof(DMX_MESSAGE2));
+
+    DmxBuffer dmx;
+    dmx.Blackout();
+    dmx.SetChannel(0, 1);
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+  }
+
+  // a blackout sends the minimum of two slots
+  {
+    SocketVerifier verifer(m_socket);
+    const uint8_t DMX_MESSAGE3[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x50,
+      0x0, 14,
+      2,  // seq #
+      1,  // physical port
+      0x23, 4,  // subnet & net address
+      0, 2,  // dmx length
+      0, 0
+    };
+    ExpectedBroadcast(DMX_MESSAGE3, sizeof(DMX_MESSAGE3));
+
+    DmxBuffer dmx;
+    dmx.Blackout();
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+  }
+}
+
+
+/**
+ * Check that we can send and receive ArtNzs packets.
+ */
+void ArtNetNodeTest::testNzs() {
+  m_socket->SetDiscardMode(true);
+
+  ArtNetNodeOptions node_options;
+  node_options.always_broadcast = true;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupInputPort(&node);
+  node.SetOutputPortUniverse(m_port_id, 3);
+  OLA_ASSERT(node.SetNzsHandler(
+      m_port_id, ola::NewCallback(this, &ArtNetNodeTest::NewNzs)));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  const uint8_t NZS_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x51,
+    0x0, 14,
+    0,  // seq #
+    0x91,  // start code
+    0x23, 4,  // subnet & net address
+    0, 4,  // length
+    1, 2, 3, 0
+  };
+
+  {
+    SocketVerifier verifer(m_socket);
+    ExpectedBroadcast(NZS_MESSAGE, sizeof(NZS_MESSAGE));
+
+    DmxBuffer data;
+    data.SetFromString("1,2,3");
+    OLA_ASSERT(node.SendNzs(m_port_id, 0x91, data));
+
+    // the null and RDM start codes aren't allowed
+    OLA_ASSERT_FALSE(node.SendNzs(m_port_id, 0, data));
+    OLA_ASSERT_FALSE(node.SendNzs(m_port_id, 0xcc, data));
+  }
+
+  {
+    SocketVerifier verifer(m_socket);
+    ReceiveFromPeer(NZS_MESSAGE, sizeof(NZS_MESSAGE), peer_ip);
+    OLA_ASSERT_EQ(static_cast<uint8_t>(0x91), m_nzs_start_code);
+    OLA_ASSERT_EQ(string("1,2,3,0"), m_nzs_data);
+  }
+}
+
+
+/**
+ * Check that an ArtSync follows the DMX data when use_sync is set.
+ */
+void ArtNetNodeTest::testSendDMXWithSync() {
+  m_socket->SetDiscardMode(true);
+
+  ArtNetNodeOptions node_options;
+  node_options.always_broadcast = true;
+  node_options.use_sync = true;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupInputPort(&node);
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+  DmxBuffer dmx;
+  dmx.SetFromString("0,1,2,3,4,5");
+
+  // outside of a batch, each packet is followed by an ArtSync
+  {
+    SocketVerifier verifer(m_socket);
+    ExpectedBroadcast(DMX_MESSAGE, sizeof(DMX_MESSAGE));
+    ExpectedBroadcast(SYNC_MESSAGE, sizeof(SYNC_MESSAGE));
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+  }
+
+  // within a batch, the ArtSync is sent once, by the outermost EndBatch()
+  {
+    SocketVerifier verifer(m_socket);
+    node.BeginBatch();
+    node.BeginBatch();
+    DMX_MESSAGE[12] = 1;
+    ExpectedBroadcast(DMX_MESSAGE, sizeof(DMX_MESSAGE));
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+    DMX_MESSAGE[12] = 2;
+    ExpectedBroadcast(DMX_MESSAGE, sizeof(DMX_MESSAGE));
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+    OLA_ASSERT(node.EndBatch());
+
+    ExpectedBroadcast(SYNC_MESSAGE, sizeof(SYNC_MESSAGE));
+    OLA_ASSERT(node.EndBatch());
+  }
+
+  // a batch without any data doesn't send an ArtSync
+  {
+    SocketVerifier verifer(m_socket);
+    node.BeginBatch();
+    OLA_ASSERT(node.EndBatch());
+  }
+}
+
+
 /**
  * Check sending DMX using unicast works.
  */
@@ -1017,6 +1395,20 @@ void ArtNetNodeTest::testNonBroadcastSendDMX() {
     ExpectedBroadcast(DMX_MESSAGE3, sizeof(DMX_MESSAGE3));
     OLA_ASSERT(node.SendDMX(m_port_id, dmx));
   }
+
+  // once the nodes time out they are removed, and nothing is sent
+  {
+    SocketVerifier verifer(m_socket);
+    // The expiry timer sees the wake up time from the previous loop.
+    m_clock.AdvanceTime(32, 0);
+    ss.RunOnce();
+    m_clock.AdvanceTime(1, 0);
+    ss.RunOnce();
+    node_addresses.clear();
+    node.GetSubscribedNodes(m_port_id, &node_addresses);
+    OLA_ASSERT_TRUE(node_addresses.empty());
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+  }
 }
 
 /**
@@ -1166,6 +1558,77 @@ void ArtNetNodeTest::testReceiveDMXZeroUniverse() {
   }
 }
 
+/**
+ * Check that the DMX data is held until the ArtSync in synchronous mode.
+ */
+void ArtNetNodeTest::testReceiveDMXWithSync() {
+  m_socket->SetDiscardMode(true);
+  ArtNetNodeOptions node_options;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupOutputPort(&node);
+  DmxBuffer input_buffer;
+  node.SetDMXHandler(m_port_id,
+                     &input_buffer,
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+
+  // until we see an ArtSync, the data is used straight away
+  {
+    SocketVerifier verifer(m_socket);
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+    ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+  }
+
+  // now the data is held
+  {
+    SocketVerifier verifer(m_socket);
+    DMX_MESSAGE[12] = 1;
+    DMX_MESSAGE[18] = 10;
+    m_got_dmx = false;
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+
+    // an ArtSync from a different source is ignored
+    ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip2);
+    OLA_ASSERT_FALSE(m_got_dmx);
+
+    ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("10,1,2,3,4,5"), input_buffer.ToString());
+  }
+
+  // without an ArtSync for 4s, we go back to using the data straight away
+  {
+    SocketVerifier verifer(m_socket);
+    m_clock.AdvanceTime(5, 0);
+    DMX_MESSAGE[12] = 2;
+    DMX_MESSAGE[18] = 20;
+    m_got_dmx = false;
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("20,1,2,3,4,5"), input_buffer.ToString());
+  }
+}
+
+
 /**
  * Check that merging works
  */
@@ -1332,8 +1795,12 @@ void ArtNetNodeTest::testHTPMerge() {
                   input_buffer.ToString());
   }
 
-  // advance the clock so the second source times out
+  // advance the clock so the second source times out. The expiry timer sees
+  // the wake up time from the previous loop.
   m_clock.AdvanceTime(6, 0);
+  ss.RunOnce();
+  m_clock.AdvanceTime(1, 0);
+  ss.RunOnce();
 
   // send another packet from the first source
   {
@@ -1827,6 +2294,90 @@ void ArtNetNodeTest::testUnsolicitedTod() {
 }
 
 
+/**
+ * Check that TODs split across blocks are merged, and that the TOD is
+ * restored from the cache when a port returns to a universe.
+ */
+void ArtNetNodeTest::testTodBlocksAndCache() {
+  m_socket->SetDiscardMode(true);
+  ArtNetNodeOptions node_options;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupInputPort(&node);
+  OLA_ASSERT(node.SetUnsolicitedUIDSetHandler(
+      m_port_id,
+      ola::NewCallback(this, &ArtNetNodeTest::DiscoveryComplete)));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  UID uid1(0x7a70, 0);
+  UID uid2(0x7a70, 1);
+  uint8_t art_tod[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x81,
+    0x0, 14,
+    1,  // rdm standard
+    1,  // first port
+    0, 0, 0, 0, 0, 0, 0,
+    4,  // net
+    0,  // full tod
+    0x23,  // universe address
+    0, 2,  // uid total
+    0,  // block count
+    1,  // uid count
+    0x7a, 0x70, 0, 0, 0, 0,
+  };
+
+  // the first of two blocks
+  {
+    SocketVerifier verifer(m_socket);
+    ReceiveFromPeer(art_tod, sizeof(art_tod), peer_ip);
+    OLA_ASSERT(m_discovery_done);
+    UIDSet uids;
+    uids.AddUID(uid1);
+    OLA_ASSERT_EQ(uids, m_uids);
+  }
+
+  // the second block is merged with the first
+  {
+    SocketVerifier verifer(m_socket);
+    art_tod[26] = 1;  // block count
+    art_tod[33] = 1;  // uid
+    ReceiveFromPeer(art_tod, sizeof(art_tod), peer_ip);
+    UIDSet uids;
+    uids.AddUID(uid1);
+    uids.AddUID(uid2);
+    OLA_ASSERT_EQ(uids, m_uids);
+  }
+
+  // a complete TOD in one block removes the missing UID
+  {
+    SocketVerifier verifer(m_socket);
+    art_tod[25] = 1;  // uid total
+    art_tod[26] = 0;  // block count
+    ReceiveFromPeer(art_tod, sizeof(art_tod), peer_ip);
+    UIDSet uids;
+    uids.AddUID(uid2);
+    OLA_ASSERT_EQ(uids, m_uids);
+  }
+
+  // moving the port to another universe clears the TOD, moving it back
+  // restores it from the cache.
+  m_socket->SetDiscardMode(true);
+  m_discovery_done = false;
+  m_uids.Clear();
+  OLA_ASSERT(node.SetInputPortUniverse(m_port_id, 4));
+  OLA_ASSERT_FALSE(m_discovery_done);
+  OLA_ASSERT(node.SetInputPortUniverse(m_port_id, 3));
+  OLA_ASSERT(m_discovery_done);
+  UIDSet uids;
+  uids.AddUID(uid2);
+  OLA_ASSERT_EQ(uids, m_uids);
+}
+
+
 /**
  * Check that we respond to Tod messages
  */
@@ -55,6 +55,8 @@ typedef enum artnet_packet_type_e {
   ARTNET_POLL = 0x2000,
   ARTNET_REPLY = 0x2100,
   ARTNET_DMX = 0x5000,
+  ARTNET_NZS = 0x5100,
+  ARTNET_SYNC = 0x5200,
   ARTNET_TODREQUEST = 0x8000,
   ARTNET_TODDATA = 0x8100,
   ARTNET_TODCONTROL = 0x8200,
@@ -137,6 +139,29 @@ struct artnet_dmx_s {
 
 typedef struct artnet_dmx_s artnet_dmx_t;
 
+// ArtNzs, this is ArtDmx with the physical field replaced by a start code.
+PACK(
+struct artnet_nzs_s {
+  uint16_t version;
+  uint8_t  sequence;
+  uint8_t  start_code;
+  uint8_t  universe;
+  uint8_t  net;
+  uint8_t  length[2];
+  uint8_t  data[DMX_UNIVERSE_SIZE];
+});
+
+typedef struct artnet_nzs_s artnet_nzs_t;
+
+PACK(
+struct artnet_sync_s {
+  uint16_t version;
+  uint8_t  aux1;
+  uint8_t  aux2;
+});
+
+typedef struct artnet_sync_s artnet_sync_t;
+
 PACK(
 struct artnet_todrequest_s {
   uint16_t version;
@@ -256,6 +281,8 @@ typedef struct {
     artnet_reply_t reply;
     artnet_timecode_t timecode;
     artnet_dmx_t dmx;
+    artnet_nzs_t nzs;
+    artnet_sync_t sync;
     artnet_todrequest_t tod_request;
     artnet_toddata_t tod_data;
     artnet_todcontrol_t tod_control;
@@ -25,6 +25,7 @@
 #include "ola/Logging.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/UDPReceivePreferences.h"
 #include "plugins/artnet/ArtNetPlugin.h"
 #include "plugins/artnet/ArtNetPluginDescription.h"
 #include "plugins/artnet/ArtNetDevice.h"
@@ -97,9 +98,13 @@ bool ArtNetPlugin::SetDefaultPreferences() {
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_SUBNET_KEY,
                                          UIntValidator(0, 15),
                                          ArtNetDevice::K_ARTNET_SUBNET);
+  save |= m_preferences->SetDefaultValue(
+      ArtNetDevice::K_INPUT_PORT_KEY,
+      UIntValidator(0, ArtNetDevice::K_MAX_PORT_COUNT),
+      ArtNetDevice::K_DEFAULT_INPUT_PORT_COUNT);
   save |= m_preferences->SetDefaultValue(
       ArtNetDevice::K_OUTPUT_PORT_KEY,
-      UIntValidator(0, 16),
+      UIntValidator(0, ArtNetDevice::K_MAX_PORT_COUNT),
       ArtNetDevice::K_DEFAULT_OUTPUT_PORT_COUNT);
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_ALWAYS_BROADCAST_KEY,
                                          BoolValidator(),
@@ -110,6 +115,14 @@ bool ArtNetPlugin::SetDefaultPreferences() {
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_LOOPBACK_KEY,
                                          BoolValidator(),
                                          false);
+  save |= m_preferences->SetDefaultValue(ArtNetDevice::K_SYNC_KEY,
+                                         BoolValidator(),
+                                         false);
+  save |= m_preferences->SetDefaultValue(ArtNetDevice::K_TRIM_DMX_KEY,
+                                         BoolValidator(),
+                                         false);
+  save |= SetDefaultUDPReceivePreferences(m_preferences);
+  save |= SetDefaultNetworkEnginePreferences(m_preferences);
 
   if (save) {
     m_preferences->Save();
@@ -120,6 +133,7 @@ bool ArtNetPlugin::SetDefaultPreferences() {
   if (m_preferences->GetValue(ArtNetDevice::K_SHORT_NAME_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_LONG_NAME_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_SUBNET_KEY).empty() ||
+      m_preferences->GetValue(ArtNetDevice::K_INPUT_PORT_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_OUTPUT_PORT_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_NET_KEY).empty()) {
     return false;
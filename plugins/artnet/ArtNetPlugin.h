@@ -44,6 +44,9 @@ class ArtNetPlugin : public Plugin {
   std::string Description() const;
   std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
  private:
   /**
    * Start the plugin, for now we just have one device.
@@ -60,8 +63,6 @@ class ArtNetPlugin : public Plugin {
   static const char ARTNET_SUBNET[];
   static const char ARTNET_LONG_NAME[];
   static const char ARTNET_SHORT_NAME[];
-  static const char PLUGIN_NAME[];
-  static const char PLUGIN_PREFIX[];
 };
 }  // namespace artnet
 }  // namespace plugin
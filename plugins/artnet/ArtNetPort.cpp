@@ -92,10 +92,11 @@ string ArtNetInputPort::Description() const {
   }
 
   std::ostringstream str;
+  const uint8_t address = m_node->GetOutputPortUniverse(PortId());
   str << "ArtNet Universe "
       << static_cast<int>(m_node->NetAddress()) << ":"
-      << static_cast<int>(m_node->SubnetAddress()) << ":"
-      << static_cast<int>(m_node->GetOutputPortUniverse(PortId()));
+      << static_cast<int>(address >> 4) << ":"
+      << static_cast<int>(address & 0x0f);
   return str.str();
 }
 
@@ -110,11 +111,6 @@ void ArtNetInputPort::TriggerDiscovery() {
 
 bool ArtNetOutputPort::WriteDMX(const DmxBuffer &buffer,
                                 OLA_UNUSED uint8_t priority) {
-  if (PortId() >= ARTNET_MAX_PORTS) {
-    OLA_WARN << "Invalid artnet port id " << PortId();
-    return false;
-  }
-
   return m_node->SendDMX(PortId(), buffer);
 }
 
@@ -170,10 +166,11 @@ string ArtNetOutputPort::Description() const {
   }
 
   std::ostringstream str;
+  const uint8_t address = m_node->GetInputPortUniverse(PortId());
   str << "ArtNet Universe "
       << static_cast<int>(m_node->NetAddress()) << ":"
-      << static_cast<int>(m_node->SubnetAddress()) << ":"
-      << static_cast<int>(m_node->GetInputPortUniverse(PortId()));
+      << static_cast<int>(address >> 4) << ":"
+      << static_cast<int>(address & 0x0f);
   return str.str();
 }
 }  // namespace artnet
@@ -79,6 +79,10 @@ class ArtNetOutputPort: public BasicOutputPort {
 
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
 
+  // The ArtDmx packets for a frame are sent together.
+  void BeginBatch() { m_node->BeginBatch(); }
+  void EndBatch() { m_node->EndBatch(); }
+
   /*
    * Handle an RDMRequest
    */
@@ -48,6 +48,19 @@ plugins_artnet_ArtNetTester_SOURCES = plugins/artnet/ArtNetNodeTest.cpp
 plugins_artnet_ArtNetTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 plugins_artnet_ArtNetTester_LDADD = $(COMMON_TESTING_LIBS) \
                                     plugins/artnet/libolaartnetnode.la
+
+# BENCHMARKS
+##################################################
+if BUILD_TESTS
+bench_programs += plugins/artnet/ArtNetNodeBenchmark
+
+plugins_artnet_ArtNetNodeBenchmark_SOURCES = \
+    plugins/artnet/ArtNetNodeBenchmark.cpp
+plugins_artnet_ArtNetNodeBenchmark_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+plugins_artnet_ArtNetNodeBenchmark_LDADD = \
+    $(COMMON_SOCKET_BENCHMARK_LIBS) \
+    plugins/artnet/libolaartnetnode.la
+endif
 endif
 
 EXTRA_DIST += plugins/artnet/README.md
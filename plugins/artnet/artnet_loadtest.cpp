@@ -14,92 +14,801 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  *
  * artnet_loadtest.cpp
- * A simple ArtNet load tester
+ * An ArtNet load tester.
+ *
+ * In send mode, the universes are sent at a fixed frame rate, with the send
+ * time embedded in each frame. In receive mode, we act as a node and measure
+ * the packet rate, sequence gaps, jitter and the latency from the embedded
+ * send times. In nodes mode, we simulate a number of nodes which poll and
+ * subscribe to universes, to load the poll reply & unicast paths of a
+ * controller.
  * Copyright (C) 2013 Simon Newton
  */
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
+#include "ola/base/Array.h"
 #include "ola/base/Flags.h"
 #include "ola/base/Init.h"
+#include "ola/base/SysExits.h"
 #include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
 #include "ola/network/InterfacePicker.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Utils.h"
+#include "ola/util/Histogram.h"
 #include "plugins/artnet/ArtNetNode.h"
+#include "plugins/artnet/ArtNetPackets.h"
 
+using ola::Clock;
 using ola::DmxBuffer;
+using ola::Histogram;
 using ola::NewCallback;
+using ola::TimeStamp;
 using ola::io::SelectServer;
+using ola::network::DatagramBatch;
+using ola::network::HostToLittleEndian;
+using ola::network::HostToNetwork;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
 using ola::network::Interface;
 using ola::network::InterfacePicker;
+using ola::network::LittleEndianToHost;
+using ola::network::UDPSocket;
+using ola::plugin::artnet::ARTNET_DMX;
+using ola::plugin::artnet::ARTNET_MAX_PORTS;
+using ola::plugin::artnet::ARTNET_POLL;
+using ola::plugin::artnet::ARTNET_REPLY;
 using ola::plugin::artnet::ArtNetNode;
 using ola::plugin::artnet::ArtNetNodeOptions;
+using ola::plugin::artnet::artnet_packet;
 using std::auto_ptr;
-using std::cout;
-using std::endl;
+using std::max;
 using std::min;
+using std::string;
+using std::vector;
 
+DEFINE_s_string(mode, m, "send", "send, receive or nodes");
+DEFINE_s_string(ip, i, "", "The IP address or interface to use");
 DEFINE_s_uint32(fps, f, 10, "Frames per second per universe [1 - 1000]");
-DEFINE_s_uint16(universes, u, 1, "Number of universes to send");
-DEFINE_string(iface, "", "The interface to send from");
+DEFINE_s_uint16(universes, u, 1, "Number of universes to send, or to "
+                "subscribe to [1 - 64]");
+DEFINE_default_bool(unicast, false, "In send mode, send to the subscribed "
+                    "nodes rather than broadcasting.");
+DEFINE_uint16(nodes, 10, "The number of nodes to simulate in nodes mode. "
+              "Each node subscribes to a page of four universes.");
+DEFINE_string(node_ip, "127.0.1.1", "The address of the first simulated "
+              "node, the others use the following addresses. These must be "
+              "local addresses, like the 127.0.0.0/8 loopback range.");
+DEFINE_string(controller, "127.0.0.1", "The address of the controller the "
+              "simulated nodes poll & subscribe with.");
+DEFINE_uint32(report_interval, 1, "Seconds between reports");
+
+namespace {
+
+const unsigned int MAX_FPS = 1000;
+const unsigned int MAX_UNIVERSES = 64;
+const unsigned int RECV_BATCH_SIZE = 64;
+const uint16_t ARTNET_PORT = 6454;
+const uint16_t ARTNET_VERSION = 14;
+const char ARTNET_ID[] = "Art-Net";
+// How often the simulated nodes poll & announce themselves.
+const unsigned int POLL_INTERVAL_MS = 2500;
+
+// The test pattern at the start of each frame is a magic number followed by
+// the send time, in microseconds since the epoch.
+const uint8_t PATTERN_MAGIC[] = {'O', 'L', 'A', 'T'};
+const unsigned int PATTERN_SIZE = sizeof(PATTERN_MAGIC) + 8;
+
+// The size of an ArtDmx packet without the slot data.
+const unsigned int DMX_HEADER_SIZE = (
+    offsetof(artnet_packet, data) +
+    offsetof(ola::plugin::artnet::artnet_dmx_t, data));
+
+struct CpuUsage {
+  uint64_t user;
+  uint64_t system;
+
+  CpuUsage() : user(0), system(0) {}
+
+  uint64_t Total() const { return user + system; }
+};
+
+CpuUsage OurCpuUsage() {
+  CpuUsage usage;
+  struct rusage rusage;
+  if (getrusage(RUSAGE_SELF, &rusage) == 0) {
+    usage.user = rusage.ru_utime.tv_sec * 1000000ull + rusage.ru_utime.tv_usec;
+    usage.system = (rusage.ru_stime.tv_sec * 1000000ull +
+                    rusage.ru_stime.tv_usec);
+  }
+  return usage;
+}
+
+int64_t MicroSecondsSinceEpoch(const TimeStamp &timestamp) {
+  return static_cast<int64_t>(timestamp.Seconds()) * 1000000 +
+         timestamp.MicroSeconds();
+}
+
+/*
+ * The 15 bit port address for the n-th universe. Universes are grouped in
+ * pages of four, each page uses the next subnet, which matches how the
+ * ArtNetNode assigns the subnets of its ports.
+ */
+uint16_t PortAddress(unsigned int universe) {
+  return static_cast<uint16_t>(((universe / ARTNET_MAX_PORTS) << 4) |
+                               (universe % ARTNET_MAX_PORTS));
+}
+
+void PopulateHeader(artnet_packet *packet, uint16_t op_code) {
+  ola::strings::CopyToFixedLengthBuffer(
+      ARTNET_ID, reinterpret_cast<char*>(packet->id), arraysize(packet->id));
+  packet->op_code = HostToLittleEndian(op_code);
+}
+
+bool IsArtNetPacket(const uint8_t *data, unsigned int length) {
+  return length >= sizeof(ARTNET_ID) + 2 &&
+      memcmp(data, ARTNET_ID, sizeof(ARTNET_ID)) == 0;
+}
+
+uint16_t OpCode(const uint8_t *data) {
+  const artnet_packet *packet = reinterpret_cast<const artnet_packet*>(data);
+  return LittleEndianToHost(packet->op_code);
+}
+
+/*
+ * Build an ArtPollReply for a node with output ports for a page of
+ * universes.
+ * @param address the node's IP address.
+ * @param page the page of universes.
+ * @param universes the total number of universes.
+ * @param packet the packet to populate.
+ * @returns the size of the packet.
+ */
+unsigned int BuildPollReply(IPV4Address address, unsigned int page,
+                            unsigned int universes, artnet_packet *packet) {
+  PopulateHeader(packet, ARTNET_REPLY);
+  ola::plugin::artnet::artnet_reply_t &reply = packet->data.reply;
+  memset(&reply, 0, sizeof(reply));
+  address.Get(reply.ip);
+  reply.port = HostToLittleEndian(ARTNET_PORT);
+  reply.subnet_address = static_cast<uint8_t>(page & 0x0f);
+  ola::strings::CopyToFixedLengthBuffer("artnet_loadtest", reply.short_name,
+                                        arraysize(reply.short_name));
+  ola::strings::CopyToFixedLengthBuffer("artnet_loadtest", reply.long_name,
+                                        arraysize(reply.long_name));
+
+  const unsigned int first = page * ARTNET_MAX_PORTS;
+  uint8_t ports = 0;
+  for (unsigned int i = first; i < universes && ports < ARTNET_MAX_PORTS;
+       i++, ports++) {
+    reply.port_types[ports] = 0x80;
+    reply.good_output[ports] = 0x80;
+    reply.sw_out[ports] = static_cast<uint8_t>(PortAddress(i) & 0x0f);
+  }
+  reply.number_ports[1] = ports;
+  address.Get(reply.bind_ip);
+  reply.bind_index = static_cast<uint8_t>(page + 1);
+  reply.status2 = 0x08;  // 15 bit port addresses
+  return sizeof(packet->id) + sizeof(packet->op_code) + sizeof(reply);
+}
+
+unsigned int BuildPoll(artnet_packet *packet) {
+  PopulateHeader(packet, ARTNET_POLL);
+  memset(&packet->data.poll, 0, sizeof(packet->data.poll));
+  packet->data.poll.version = HostToNetwork(ARTNET_VERSION);
+  packet->data.poll.talk_to_me = 0x02;  // reply on change
+  return sizeof(packet->id) + sizeof(packet->op_code) +
+      sizeof(packet->data.poll);
+}
+
 
 /**
- * Send N DMX frames using ArtNet, where N is given by number_of_universes.
+ * Tracks the packet count & CPU time between reports.
  */
-bool SendFrames(ArtNetNode *node, DmxBuffer *buffer,
-                uint16_t number_of_universes) {
-  for (uint16_t i = 0; i < number_of_universes; i++) {
-    node->SendDMX(i, *buffer);
+class ReportPeriod {
+ public:
+  ReportPeriod()
+      : m_packets(0),
+        m_last_packets(0) {
+    m_clock.CurrentTime(&m_last_time);
+    m_last_cpu = OurCpuUsage();
   }
+
+  void AddPackets(unsigned int count) { m_packets += count; }
+
+  /**
+   * Log the rate & CPU usage since the last call, and start a new period.
+   */
+  void Report(const string &prefix) {
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    const CpuUsage cpu = OurCpuUsage();
+    const int64_t elapsed_us = max((now - m_last_time).AsInt(),
+                                   static_cast<int64_t>(1));
+    const uint64_t packets = m_packets - m_last_packets;
+    const uint64_t cpu_us = cpu.Total() - m_last_cpu.Total();
+
+    OLA_INFO << prefix << packets * 1000000 / elapsed_us << " pkts/s, "
+             << (packets ? static_cast<double>(cpu_us) / packets : 0.0)
+             << " us CPU/pkt, "
+             << cpu_us * 100 / elapsed_us << "% CPU";
+
+    m_last_time = now;
+    m_last_cpu = cpu;
+    m_last_packets = m_packets;
+  }
+
+ private:
+  Clock m_clock;
+  uint64_t m_packets;
+  uint64_t m_last_packets;
+  TimeStamp m_last_time;
+  CpuUsage m_last_cpu;
+};
+
+
+/**
+ * Sends a frame for each universe, stamped with the send time.
+ */
+class Transmitter {
+ public:
+  Transmitter(ArtNetNode *node, uint16_t universes)
+      : m_node(node),
+        m_universes(universes) {
+    m_buffer.Blackout();
+    m_buffer.SetRange(0, PATTERN_MAGIC, sizeof(PATTERN_MAGIC));
+  }
+
+  bool SendFrame();
+  bool Report() {
+    m_period.Report("Sent ");
+    return true;
+  }
+
+ private:
+  ArtNetNode *m_node;
+  const uint16_t m_universes;
+  DmxBuffer m_buffer;
+  Clock m_clock;
+  ReportPeriod m_period;
+};
+
+
+bool Transmitter::SendFrame() {
+  m_node->BeginBatch();
+  for (uint16_t i = 0; i < m_universes; i++) {
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    const uint64_t send_time = MicroSecondsSinceEpoch(now);
+    uint8_t encoded_time[8];
+    for (unsigned int j = 0; j < sizeof(encoded_time); j++) {
+      encoded_time[j] = static_cast<uint8_t>(send_time >> (56 - 8 * j));
+    }
+    m_buffer.SetRange(sizeof(PATTERN_MAGIC), encoded_time,
+                      sizeof(encoded_time));
+    m_node->SendDMX(static_cast<uint8_t>(i), m_buffer);
+  }
+  m_node->EndBatch();
+  m_period.AddPackets(m_universes);
   return true;
 }
 
-int main(int argc, char* argv[]) {
-  ola::AppInit(&argc, argv, "", "Run the E1.31 load test.");
 
-  if (FLAGS_universes == 0 || FLAGS_fps == 0) {
-    return -1;
+/**
+ * Acts as a node, and measures the ArtDmx packets we receive.
+ */
+class Receiver {
+ public:
+  Receiver(UDPSocket *socket, const Interface &iface, uint16_t universes)
+      : m_socket(socket),
+        m_interface(iface),
+        m_universes(universes),
+        m_port_addresses(1 << 15),
+        m_lost(0),
+        m_reordered(0),
+        m_ignored(0),
+        m_unstamped(0),
+        m_clock_skew(0),
+        m_batch(RECV_BATCH_SIZE, sizeof(artnet_packet)) {
   }
 
-  unsigned int fps = min(1000u, static_cast<unsigned int>(FLAGS_fps));
-  uint16_t universes = FLAGS_universes;
+  void Receive();
+  bool Report();
 
-  DmxBuffer output;
-  output.Blackout();
+  /**
+   * Announce our ports, so controllers send to us.
+   */
+  bool SendPollReplies();
 
-  Interface iface;
-  {
-    auto_ptr<InterfacePicker> picker(InterfacePicker::NewPicker());
+ private:
+  struct PortAddressState {
+    bool seen;
+    uint8_t sequence;
+    TimeStamp last_arrival;
+    // The previous inter-arrival time in us, -1 if unknown.
+    int64_t last_interval;
+    // The smoothed jitter in us, as in RFC 3550.
+    double jitter;
 
-    if (!picker->ChooseInterface(&iface, FLAGS_iface.str())) {
-      return -1;
+    PortAddressState()
+        : seen(false),
+          sequence(0),
+          last_interval(-1),
+          jitter(0) {
     }
+  };
+
+  UDPSocket *m_socket;
+  const Interface m_interface;
+  const uint16_t m_universes;
+  vector<PortAddressState> m_port_addresses;
+  uint64_t m_lost;
+  uint64_t m_reordered;
+  uint64_t m_ignored;
+  uint64_t m_unstamped;
+  uint64_t m_clock_skew;
+  // The difference between consecutive inter-arrival times, in us.
+  Histogram m_interval_changes;
+  // The time from the embedded send time to the arrival, in us.
+  Histogram m_latency;
+  Clock m_clock;
+  DatagramBatch m_batch;
+  ReportPeriod m_period;
+
+  void HandleDMX(const ola::plugin::artnet::artnet_dmx_t &dmx,
+                 unsigned int slots, const TimeStamp &arrival);
+};
+
+
+void Receiver::Receive() {
+  if (!m_socket->RecvBatch(&m_batch)) {
+    return;
   }
 
-  ArtNetNodeOptions options;
-  options.always_broadcast = true;
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  unsigned int dmx_packets = 0;
+  for (unsigned int i = 0; i < m_batch.Size(); i++) {
+    const uint8_t *data = m_batch.Data(i);
+    const unsigned int length = m_batch.Length(i);
+    if (!IsArtNetPacket(data, length)) {
+      m_ignored++;
+      continue;
+    }
 
-  SelectServer ss;
-  ArtNetNode node(iface, &ss, options);
+    const uint16_t op_code = OpCode(data);
+    if (op_code == ARTNET_POLL) {
+      SendPollReplies();
+    } else if (op_code == ARTNET_DMX && length >= DMX_HEADER_SIZE) {
+      const artnet_packet *packet = reinterpret_cast<const artnet_packet*>(
+          data);
+      HandleDMX(packet->data.dmx, length - DMX_HEADER_SIZE, now);
+      dmx_packets++;
+    }
+  }
+  m_period.AddPackets(dmx_packets);
+}
+
+
+void Receiver::HandleDMX(const ola::plugin::artnet::artnet_dmx_t &dmx,
+                         unsigned int slots, const TimeStamp &arrival) {
+  const uint16_t port_address = static_cast<uint16_t>(
+      ((dmx.net & 0x7f) << 8) | dmx.universe);
+  PortAddressState &state = m_port_addresses[port_address];
+
+  // A sequence number of 0 means the sender doesn't use them.
+  if (state.seen && dmx.sequence && state.sequence) {
+    int8_t diff = static_cast<int8_t>(dmx.sequence - state.sequence);
+    if (state.sequence == 0xff && dmx.sequence == 1) {
+      // Some senders skip 0 when they wrap.
+      diff = 1;
+    }
+    if (diff <= 0) {
+      // A late or duplicate packet.
+      m_reordered++;
+      return;
+    }
+    m_lost += diff - 1;
+  }
+
+  if (state.seen) {
+    const int64_t interval = (arrival - state.last_arrival).AsInt();
+    if (state.last_interval >= 0) {
+      const int64_t change = interval > state.last_interval ?
+          interval - state.last_interval : state.last_interval - interval;
+      state.jitter += (static_cast<double>(change) - state.jitter) / 16;
+      m_interval_changes.Add(static_cast<uint32_t>(
+          min(change, static_cast<int64_t>(UINT32_MAX))));
+    }
+    state.last_interval = interval;
+  }
+  state.seen = true;
+  state.sequence = dmx.sequence;
+  state.last_arrival = arrival;
+
+  if (slots < PATTERN_SIZE ||
+      memcmp(dmx.data, PATTERN_MAGIC, sizeof(PATTERN_MAGIC))) {
+    m_unstamped++;
+    return;
+  }
+
+  uint64_t send_time = 0;
+  for (unsigned int i = sizeof(PATTERN_MAGIC); i < PATTERN_SIZE; i++) {
+    send_time = (send_time << 8) | dmx.data[i];
+  }
+  const int64_t latency = MicroSecondsSinceEpoch(arrival) -
+      static_cast<int64_t>(send_time);
+  if (latency < 0) {
+    // The sender's clock is ahead of ours.
+    m_clock_skew++;
+  } else {
+    m_latency.Add(static_cast<uint32_t>(
+        min(latency, static_cast<int64_t>(UINT32_MAX))));
+  }
+}
+
+
+bool Receiver::SendPollReplies() {
+  const IPV4SocketAddress destination(m_interface.bcast_address, ARTNET_PORT);
+  const unsigned int pages = (m_universes + ARTNET_MAX_PORTS - 1) /
+      ARTNET_MAX_PORTS;
+  artnet_packet packet;
+  for (unsigned int page = 0; page < pages; page++) {
+    const unsigned int size = BuildPollReply(m_interface.ip_address, page,
+                                             m_universes, &packet);
+    m_socket->SendTo(reinterpret_cast<const uint8_t*>(&packet), size,
+                     destination);
+  }
+  return true;
+}
+
+
+bool Receiver::Report() {
+  double jitter = 0;
+  unsigned int active = 0;
+  vector<PortAddressState>::const_iterator iter = m_port_addresses.begin();
+  for (; iter != m_port_addresses.end(); ++iter) {
+    if (iter->seen) {
+      jitter += iter->jitter;
+      active++;
+    }
+  }
+
+  m_period.Report("Received ");
+  OLA_INFO << "  " << active << " universes, " << m_lost << " lost, "
+           << m_reordered << " reordered, " << m_ignored << " ignored";
+  OLA_INFO << "  jitter " << (active ? jitter / active : 0.0)
+           << " us, inter-arrival change p50 "
+           << m_interval_changes.Percentile(50) << " us, p99 "
+           << m_interval_changes.Percentile(99) << " us, max "
+           << m_interval_changes.Max() << " us";
+  OLA_INFO << "  latency p50 " << m_latency.Percentile(50) << " us, p99 "
+           << m_latency.Percentile(99) << " us, max " << m_latency.Max()
+           << " us, " << m_unstamped << " without a send time, "
+           << m_clock_skew << " from the future";
+  m_interval_changes.Reset();
+  m_latency.Reset();
+  return true;
+}
+
+
+/**
+ * A simulated node, with its own address. It subscribes to a page of
+ * universes by sending ArtPollReplies to the controller, and counts the
+ * ArtDmx packets it's sent.
+ */
+class SimulatedNode {
+ public:
+  SimulatedNode(const IPV4Address &address, unsigned int page)
+      : m_address(address),
+        m_page(page),
+        m_dmx_packets(0),
+        m_poll_replies(0) {
+  }
+
+  bool Init(ola::Callback0<void> *on_data);
+  UDPSocket *Socket() { return &m_socket; }
+
+  void Announce(const IPV4SocketAddress &controller, unsigned int universes);
+  void Receive(DatagramBatch *batch);
+
+  uint64_t DMXPackets() const { return m_dmx_packets; }
+  uint64_t PollReplies() const { return m_poll_replies; }
+
+ private:
+  const IPV4Address m_address;
+  const unsigned int m_page;
+  UDPSocket m_socket;
+  uint64_t m_dmx_packets;
+  uint64_t m_poll_replies;
+
+  DISALLOW_COPY_AND_ASSIGN(SimulatedNode);
+};
+
+
+bool SimulatedNode::Init(ola::Callback0<void> *on_data) {
+  if (!m_socket.Init() ||
+      !m_socket.Bind(IPV4SocketAddress(m_address, ARTNET_PORT))) {
+    delete on_data;
+    return false;
+  }
+  m_socket.SetOnData(on_data);
+  return true;
+}
+
+
+void SimulatedNode::Announce(const IPV4SocketAddress &controller,
+                             unsigned int universes) {
+  artnet_packet packet;
+  unsigned int size = BuildPoll(&packet);
+  m_socket.SendTo(reinterpret_cast<const uint8_t*>(&packet), size,
+                  controller);
+  size = BuildPollReply(m_address, m_page, universes, &packet);
+  m_socket.SendTo(reinterpret_cast<const uint8_t*>(&packet), size,
+                  controller);
+}
+
+
+void SimulatedNode::Receive(DatagramBatch *batch) {
+  if (!m_socket.RecvBatch(batch)) {
+    return;
+  }
+
+  for (unsigned int i = 0; i < batch->Size(); i++) {
+    if (!IsArtNetPacket(batch->Data(i), batch->Length(i))) {
+      continue;
+    }
+    const uint16_t op_code = OpCode(batch->Data(i));
+    if (op_code == ARTNET_DMX) {
+      m_dmx_packets++;
+    } else if (op_code == ARTNET_REPLY) {
+      m_poll_replies++;
+    }
+  }
+}
+
+
+/**
+ * Runs the simulated nodes.
+ */
+class NodeSimulator {
+ public:
+  NodeSimulator(const IPV4SocketAddress &controller, uint16_t universes)
+      : m_controller(controller),
+        m_universes(universes),
+        m_last_poll_replies(0),
+        m_batch(RECV_BATCH_SIZE, sizeof(artnet_packet)) {
+  }
+
+  ~NodeSimulator() { ola::STLDeleteElements(&m_nodes); }
+
+  bool AddNodes(SelectServer *ss, const IPV4Address &first_address,
+                unsigned int count);
+  void RemoveNodes(SelectServer *ss);
+
+  bool Announce();
+  bool Report();
+
+ private:
+  const IPV4SocketAddress m_controller;
+  const uint16_t m_universes;
+  vector<SimulatedNode*> m_nodes;
+  vector<uint64_t> m_last_node_packets;
+  uint64_t m_last_poll_replies;
+  DatagramBatch m_batch;
+  ReportPeriod m_period;
+
+  void Receive(SimulatedNode *node);
+};
+
+
+bool NodeSimulator::AddNodes(SelectServer *ss,
+                             const IPV4Address &first_address,
+                             unsigned int count) {
+  const unsigned int pages = (m_universes + ARTNET_MAX_PORTS - 1) /
+      ARTNET_MAX_PORTS;
+  const uint32_t first = ola::network::NetworkToHost(
+      first_address.AsInt());
+  for (unsigned int i = 0; i < count; i++) {
+    const IPV4Address address(HostToNetwork(first + i));
+    SimulatedNode *node = new SimulatedNode(address, i % pages);
+    if (!node->Init(NewCallback(this, &NodeSimulator::Receive, node))) {
+      OLA_FATAL << "Failed to bind to " << address;
+      delete node;
+      return false;
+    }
+    ss->AddReadDescriptor(node->Socket());
+    m_nodes.push_back(node);
+  }
+  m_last_node_packets.resize(m_nodes.size(), 0);
+  return true;
+}
+
+
+void NodeSimulator::RemoveNodes(SelectServer *ss) {
+  vector<SimulatedNode*>::iterator iter = m_nodes.begin();
+  for (; iter != m_nodes.end(); ++iter) {
+    ss->RemoveReadDescriptor((*iter)->Socket());
+  }
+}
+
+
+void NodeSimulator::Receive(SimulatedNode *node) {
+  const uint64_t before = node->DMXPackets();
+  node->Receive(&m_batch);
+  m_period.AddPackets(static_cast<unsigned int>(node->DMXPackets() - before));
+}
+
+
+bool NodeSimulator::Announce() {
+  vector<SimulatedNode*>::iterator iter = m_nodes.begin();
+  for (; iter != m_nodes.end(); ++iter) {
+    (*iter)->Announce(m_controller, m_universes);
+  }
+  return true;
+}
+
+
+bool NodeSimulator::Report() {
+  uint64_t poll_replies = 0;
+  uint64_t min_node_packets = UINT64_MAX;
+  uint64_t max_node_packets = 0;
+  for (unsigned int i = 0; i < m_nodes.size(); i++) {
+    const uint64_t packets = m_nodes[i]->DMXPackets();
+    const uint64_t period_packets = packets - m_last_node_packets[i];
+    min_node_packets = min(min_node_packets, period_packets);
+    max_node_packets = max(max_node_packets, period_packets);
+    m_last_node_packets[i] = packets;
+    poll_replies += m_nodes[i]->PollReplies();
+  }
+
+  m_period.Report("Nodes received ");
+  OLA_INFO << "  " << m_nodes.size() << " nodes, "
+           << (m_nodes.empty() ? 0 : min_node_packets) << " - "
+           << max_node_packets << " ArtDmx per node, "
+           << poll_replies - m_last_poll_replies << " ArtPollReplies";
+  m_last_poll_replies = poll_replies;
+  return true;
+}
+
+
+bool ChooseInterface(Interface *iface) {
+  auto_ptr<InterfacePicker> picker(InterfacePicker::NewPicker());
+  if (!picker->ChooseInterface(iface, FLAGS_ip.str())) {
+    OLA_FATAL << "Failed to find an interface";
+    return false;
+  }
+  return true;
+}
+
+
+int RunSender(SelectServer *ss, uint16_t universes) {
+  Interface iface;
+  if (!ChooseInterface(&iface)) {
+    return ola::EXIT_UNAVAILABLE;
+  }
+
+  const unsigned int fps = min(MAX_FPS, static_cast<unsigned int>(FLAGS_fps));
+  ArtNetNodeOptions options;
+  options.always_broadcast = !FLAGS_unicast;
+  options.input_port_count = static_cast<uint8_t>(universes);
+  ArtNetNode node(iface, ss, options);
 
   for (uint16_t i = 0; i < universes; i++) {
-    if (!node.SetInputPortUniverse(i, i)) {
+    if (!node.SetInputPortUniverse(static_cast<uint8_t>(i),
+                                   PortAddress(i) & 0x0f)) {
       OLA_WARN << "Failed to set port";
     }
   }
 
   if (!node.Start()) {
-    return -1;
+    return ola::EXIT_UNAVAILABLE;
   }
 
-  ss.RegisterRepeatingTimeout(
-      1000 / fps,
-      NewCallback(&SendFrames, &node, &output, universes));
-  cout << "Starting loadtester: " << universes << " universe(s), " << fps
-       << " fps" << endl;
-  ss.Run();
+  Transmitter transmitter(&node, universes);
+  ss->RegisterRepeatingTimeout(
+      1000 / fps, NewCallback(&transmitter, &Transmitter::SendFrame));
+  ss->RegisterRepeatingTimeout(
+      FLAGS_report_interval * 1000,
+      NewCallback(&transmitter, &Transmitter::Report));
+  OLA_INFO << "Sending " << universes << " universes at " << fps << " fps"
+           << (FLAGS_unicast ? " to the subscribed nodes" : "");
+  ss->Run();
+  node.Stop();
+  return ola::EXIT_OK;
+}
+
+
+int RunReceiver(SelectServer *ss, uint16_t universes) {
+  Interface iface;
+  if (!ChooseInterface(&iface)) {
+    return ola::EXIT_UNAVAILABLE;
+  }
+
+  UDPSocket socket;
+  if (!socket.Init() ||
+      !socket.Bind(IPV4SocketAddress(IPV4Address::WildCard(), ARTNET_PORT)) ||
+      !socket.EnableBroadcast()) {
+    return ola::EXIT_UNAVAILABLE;
+  }
+
+  Receiver receiver(&socket, iface, universes);
+  socket.SetOnData(NewCallback(&receiver, &Receiver::Receive));
+  ss->AddReadDescriptor(&socket);
+  receiver.SendPollReplies();
+  ss->RegisterRepeatingTimeout(
+      FLAGS_report_interval * 1000,
+      NewCallback(&receiver, &Receiver::Report));
+  OLA_INFO << "Receiving " << universes << " universes on "
+           << iface.ip_address;
+  ss->Run();
+  ss->RemoveReadDescriptor(&socket);
+  return ola::EXIT_OK;
+}
+
+
+int RunNodes(SelectServer *ss, uint16_t universes) {
+  IPV4Address first_address, controller;
+  if (!IPV4Address::FromString(FLAGS_node_ip.str(), &first_address) ||
+      !IPV4Address::FromString(FLAGS_controller.str(), &controller)) {
+    OLA_FATAL << "Invalid node or controller address";
+    return ola::EXIT_USAGE;
+  }
+
+  NodeSimulator simulator(IPV4SocketAddress(controller, ARTNET_PORT),
+                          universes);
+  int status = ola::EXIT_OK;
+  if (simulator.AddNodes(ss, first_address, FLAGS_nodes)) {
+    simulator.Announce();
+    ss->RegisterRepeatingTimeout(
+        POLL_INTERVAL_MS, NewCallback(&simulator, &NodeSimulator::Announce));
+    ss->RegisterRepeatingTimeout(
+        FLAGS_report_interval * 1000,
+        NewCallback(&simulator, &NodeSimulator::Report));
+    OLA_INFO << "Simulating " << FLAGS_nodes << " nodes from "
+             << first_address << ", subscribed to " << controller;
+    ss->Run();
+  } else {
+    status = ola::EXIT_UNAVAILABLE;
+  }
+  simulator.RemoveNodes(ss);
+  return status;
+}
+}  // namespace
+
+
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "[options]", "Run the ArtNet load test.");
+
+  if (FLAGS_universes == 0 || FLAGS_universes > MAX_UNIVERSES ||
+      FLAGS_fps == 0 || FLAGS_report_interval == 0) {
+    ola::DisplayUsageAndExit();
+  }
+
+  SelectServer ss;
+  const string mode = FLAGS_mode.str();
+  if (mode == "send") {
+    return RunSender(&ss, FLAGS_universes);
+  } else if (mode == "receive") {
+    return RunReceiver(&ss, FLAGS_universes);
+  } else if (mode == "nodes") {
+    return RunNodes(&ss, FLAGS_universes);
+  }
+  OLA_FATAL << "Unknown mode " << mode;
+  return ola::EXIT_USAGE;
 }
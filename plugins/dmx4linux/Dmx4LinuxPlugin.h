@@ -29,6 +29,7 @@
 #include "ola/plugin_id.h"
 #include "plugins/dmx4linux/Dmx4LinuxPort.h"
 #include "plugins/dmx4linux/Dmx4LinuxSocket.h"
+#include "plugins/dmx4linux/Dmx4LinuxWriter.h"
 
 namespace ola {
 namespace plugin {
@@ -42,6 +43,7 @@ class Dmx4LinuxPlugin: public ola::Plugin {
       Plugin(plugin_adaptor),
       m_in_descriptor(NULL),
       m_out_descriptor(NULL),
+      m_writer(NULL),
       m_in_devices_count(0),
       m_in_buffer(NULL) {}
     ~Dmx4LinuxPlugin();
@@ -53,6 +55,9 @@ class Dmx4LinuxPlugin: public ola::Plugin {
     int SocketReady();
     string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
@@ -69,6 +74,7 @@ class Dmx4LinuxPlugin: public ola::Plugin {
     string m_in_dev;   // path to the dmx input device
     Dmx4LinuxSocket *m_in_descriptor;
     Dmx4LinuxSocket *m_out_descriptor;
+    Dmx4LinuxWriter *m_writer;
     int m_in_devices_count;  // number of input devices
     uint8_t *m_in_buffer;  // input buffer
 
@@ -76,8 +82,6 @@ class Dmx4LinuxPlugin: public ola::Plugin {
     static const char DMX4LINUX_IN_DEVICE[];
     static const char OUT_DEV_KEY[];
     static const char IN_DEV_KEY[];
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
 };
 }  // namespace dmx4linux
 }  // namespace plugin
@@ -21,15 +21,15 @@
 #ifndef PLUGINS_DMX4LINUX_DMX4LINUXSOCKET_H_
 #define PLUGINS_DMX4LINUX_DMX4LINUXSOCKET_H_
 
-#include "ola/network/Socket.h"
+#include "ola/io/Descriptor.h"
 
 namespace ola {
 namespace plugin {
 namespace dmx4linux {
 
-class Dmx4LinuxSocket: public ola::network::DeviceDescriptor {
+class Dmx4LinuxSocket: public ola::io::DeviceDescriptor {
  public:
-    explicit Dmx4LinuxSocket(int fd): ola::network::DeviceDescriptor(fd) {}
+    explicit Dmx4LinuxSocket(int fd): ola::io::DeviceDescriptor(fd) {}
  protected:
     virtual bool IsClosed() const {return false;}
 };
@@ -0,0 +1,109 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Dmx4LinuxWriter.cpp
+ * Writes to the dmx4linux output device without blocking.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "plugins/dmx4linux/Dmx4LinuxWriter.h"
+
+namespace ola {
+namespace plugin {
+namespace dmx4linux {
+
+Dmx4LinuxWriter::Dmx4LinuxWriter(Dmx4LinuxSocket *descriptor,
+                                 ola::io::SelectServerInterface *ss)
+    : m_descriptor(descriptor),
+      m_ss(ss),
+      m_waiting(false) {
+  m_descriptor->SetOnWritable(
+      NewCallback(this, &Dmx4LinuxWriter::DescriptorWritable));
+}
+
+Dmx4LinuxWriter::~Dmx4LinuxWriter() {
+  if (m_waiting) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+  }
+  m_descriptor->SetOnWritable(NULL);
+}
+
+bool Dmx4LinuxWriter::WriteUniverse(int d4l_universe,
+                                    const DmxBuffer &buffer) {
+  if (m_waiting) {
+    // The device is busy, replace anything already waiting.
+    m_pending[d4l_universe] = buffer;
+    return true;
+  }
+
+  switch (Write(d4l_universe, buffer)) {
+    case WRITE_OK:
+      return true;
+    case WRITE_BLOCKED:
+      m_pending[d4l_universe] = buffer;
+      m_ss->AddWriteDescriptor(m_descriptor);
+      m_waiting = true;
+      return true;
+    case WRITE_FAILED:
+    default:
+      return false;
+  }
+}
+
+/*
+ * Write a universe at its offset in the device. The frame is written in a
+ * single pwrite, so a partial write is retried in full.
+ */
+Dmx4LinuxWriter::WriteResult Dmx4LinuxWriter::Write(int d4l_universe,
+                                                    const DmxBuffer &buffer) {
+  off_t offset = DMX_UNIVERSE_SIZE * d4l_universe;
+  ssize_t r = pwrite(m_descriptor->WriteDescriptor(), buffer.GetRaw(),
+                     buffer.Size(), offset);
+  if (r == static_cast<ssize_t>(buffer.Size())) {
+    return WRITE_OK;
+  }
+  if (r >= 0 || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+    return WRITE_BLOCKED;
+  }
+  OLA_WARN << "Failed to write universe " << d4l_universe << ": "
+           << strerror(errno);
+  return WRITE_FAILED;
+}
+
+/*
+ * Called when the device is writable, this sends the waiting frames.
+ */
+void Dmx4LinuxWriter::DescriptorWritable() {
+  PendingFrames::iterator iter = m_pending.begin();
+  while (iter != m_pending.end()) {
+    if (Write(iter->first, iter->second) == WRITE_BLOCKED) {
+      return;
+    }
+    m_pending.erase(iter++);
+  }
+
+  m_ss->RemoveWriteDescriptor(m_descriptor);
+  m_waiting = false;
+}
+}  // namespace dmx4linux
+}  // namespace plugin
+}  // namespace ola
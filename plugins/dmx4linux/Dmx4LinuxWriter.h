@@ -0,0 +1,84 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Dmx4LinuxWriter.h
+ * Writes to the dmx4linux output device without blocking.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_DMX4LINUX_DMX4LINUXWRITER_H_
+#define PLUGINS_DMX4LINUX_DMX4LINUXWRITER_H_
+
+#include <map>
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/io/SelectServerInterface.h"
+#include "plugins/dmx4linux/Dmx4LinuxSocket.h"
+
+namespace ola {
+namespace plugin {
+namespace dmx4linux {
+
+/**
+ * @brief Writes universes to the shared dmx4linux output device.
+ *
+ * The device is opened non-blocking. If a write can't complete, the frame is
+ * held until the device is writable, and any later frame for the same
+ * universe replaces it. So a slow device only ever has the latest data
+ * waiting, and never stalls the SelectServer.
+ */
+class Dmx4LinuxWriter {
+ public:
+  /**
+   * @brief Create a new Dmx4LinuxWriter.
+   * @param descriptor the output device, ownership is not transferred.
+   * @param ss the SelectServer to use to wait for the device to be writable.
+   */
+  Dmx4LinuxWriter(Dmx4LinuxSocket *descriptor,
+                  ola::io::SelectServerInterface *ss);
+  ~Dmx4LinuxWriter();
+
+  /**
+   * @brief Write a universe to the device.
+   * @param d4l_universe the dmx4linux universe.
+   * @param buffer the data to write.
+   * @returns false if the write failed, true if it was written or is
+   *   waiting for the device.
+   */
+  bool WriteUniverse(int d4l_universe, const DmxBuffer &buffer);
+
+ private:
+  typedef std::map<int, DmxBuffer> PendingFrames;
+
+  enum WriteResult {
+    WRITE_OK,
+    WRITE_BLOCKED,
+    WRITE_FAILED
+  };
+
+  Dmx4LinuxSocket *m_descriptor;
+  ola::io::SelectServerInterface *m_ss;
+  PendingFrames m_pending;
+  bool m_waiting;
+
+  WriteResult Write(int d4l_universe, const DmxBuffer &buffer);
+  void DescriptorWritable();
+
+  DISALLOW_COPY_AND_ASSIGN(Dmx4LinuxWriter);
+};
+}  // namespace dmx4linux
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_DMX4LINUX_DMX4LINUXWRITER_H_
@@ -21,25 +21,66 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <string>
 #include <vector>
 
+#include "ola/StringUtils.h"
 #include "plugins/dummy/DummyDevice.h"
+#include "plugins/dummy/DummyInputPort.h"
 #include "plugins/dummy/DummyPort.h"
 
 namespace ola {
 namespace plugin {
 namespace dummy {
 
+using std::string;
+
+/*
+ * The first device keeps the id of "1", so existing patchings are restored.
+ */
+string DummyDevice::DeviceId() const {
+  return IntToString(m_index + 1);
+}
+
 
 /*
  * Start this device
  */
 bool DummyDevice::StartHook() {
-  DummyPort *port = new DummyPort(this, m_port_options, 0);
+  for (unsigned int i = 0; i < m_options.output_port_count; i++) {
+    // Number the ports across all devices, so each has its own UIDs and the
+    // ports are spread evenly over the universes.
+    unsigned int port_index = m_index * m_options.output_port_count + i;
+    DummyPort::Options port_options = m_port_options;
+    port_options.uid_block = port_index;
+    if (m_options.universe_count) {
+      port_options.has_default_universe = true;
+      port_options.default_universe =
+          1 + port_index % m_options.universe_count;
+    }
+
+    DummyPort *port = new DummyPort(this, port_options, i);
+    if (!AddPort(port)) {
+      delete port;
+      return false;
+    }
+  }
+
+  for (unsigned int i = 0; i < m_options.input_port_count; i++) {
+    unsigned int port_index = m_index * m_options.input_port_count + i;
+    DummyInputPort::Options input_options = m_input_options;
+    if (m_options.universe_count) {
+      input_options.has_default_universe = true;
+      input_options.default_universe =
+          1 + port_index % m_options.universe_count;
+    }
 
-  if (!AddPort(port)) {
-    delete port;
-    return false;
+    DummyInputPort *port = new DummyInputPort(this, m_plugin_adaptor,
+                                              input_options, i);
+    if (!AddPort(port)) {
+      delete port;
+      return false;
+    }
   }
   return true;
 }
@@ -23,29 +23,72 @@
 
 #include <string>
 #include "olad/Device.h"
+#include "plugins/dummy/DummyInputPort.h"
 #include "plugins/dummy/DummyPort.h"
 
 namespace ola {
 
 class AbstractPlugin;
+class PluginAdaptor;
 
 namespace plugin {
 namespace dummy {
 
 class DummyDevice: public Device {
  public:
+  struct Options {
+   public:
+    Options()
+        : output_port_count(1),
+          input_port_count(0),
+          universe_count(0) {
+    }
+
+    unsigned int output_port_count;
+    unsigned int input_port_count;
+    // If non-0, ports are patched to universes 1 to universe_count, unless
+    // there is a saved patching.
+    unsigned int universe_count;
+  };
+
+  /**
+   * Create a new DummyDevice
+   * @param owner the plugin that owns this device
+   * @param plugin_adaptor the PluginAdaptor to use
+   * @param name the name of the device
+   * @param index the index of this device, starting from 0
+   * @param options the number of ports, and universes to patch them to
+   * @param port_options the options for the output ports
+   * @param input_options the options for the input ports
+   */
   DummyDevice(
       AbstractPlugin *owner,
+      PluginAdaptor *plugin_adaptor,
       const std::string &name,
-      const DummyPort::Options &port_options)
+      unsigned int index,
+      const Options &options,
+      const DummyPort::Options &port_options,
+      const DummyInputPort::Options &input_options)
       : Device(owner, name),
-        m_port_options(port_options) {
+        m_plugin_adaptor(plugin_adaptor),
+        m_index(index),
+        m_options(options),
+        m_port_options(port_options),
+        m_input_options(input_options) {
   }
 
-  std::string DeviceId() const { return "1"; }
+  std::string DeviceId() const;
+
+  // The ports don't share any hardware, so any patching is fine.
+  bool AllowLooping() const { return true; }
+  bool AllowMultiPortPatching() const { return true; }
 
  protected:
+  PluginAdaptor *m_plugin_adaptor;
+  const unsigned int m_index;
+  const Options m_options;
   const DummyPort::Options m_port_options;
+  const DummyInputPort::Options m_input_options;
 
   bool StartHook();
 };
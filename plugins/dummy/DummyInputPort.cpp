@@ -0,0 +1,96 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DummyInputPort.cpp
+ * An input port that generates DMX frames.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "olad/PluginAdaptor.h"
+#include "plugins/dummy/DummyDevice.h"
+#include "plugins/dummy/DummyInputPort.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+DummyInputPort::DummyInputPort(DummyDevice *parent,
+                               PluginAdaptor *plugin_adaptor,
+                               const Options &options,
+                               unsigned int id)
+    : BasicInputPort(parent, id, plugin_adaptor),
+      m_plugin_adaptor(plugin_adaptor),
+      m_options(options),
+      m_timeout_id(ola::thread::INVALID_TIMEOUT),
+      m_offset(0),
+      m_value(0) {
+  m_buffer.Blackout();
+}
+
+
+DummyInputPort::~DummyInputPort() {
+  if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
+    m_plugin_adaptor->RemoveTimeout(m_timeout_id);
+  }
+}
+
+
+/*
+ * Start generating frames when the port is patched, and stop when it's
+ * unpatched.
+ */
+void DummyInputPort::PostSetUniverse(Universe*, Universe *new_universe) {
+  if (new_universe && m_timeout_id == ola::thread::INVALID_TIMEOUT &&
+      m_options.frame_rate) {
+    m_timeout_id = m_plugin_adaptor->RegisterRepeatingTimeout(
+        TimeInterval(static_cast<int64_t>(USEC_IN_SECONDS /
+                                          m_options.frame_rate)),
+        NewCallback(this, &DummyInputPort::SendFrame));
+  } else if (!new_universe && m_timeout_id != ola::thread::INVALID_TIMEOUT) {
+    m_plugin_adaptor->RemoveTimeout(m_timeout_id);
+    m_timeout_id = ola::thread::INVALID_TIMEOUT;
+  }
+}
+
+
+bool DummyInputPort::DefaultUniverse(unsigned int *universe) const {
+  if (m_options.has_default_universe) {
+    *universe = m_options.default_universe;
+  }
+  return m_options.has_default_universe;
+}
+
+
+/*
+ * Change the next block of slots and send the frame.
+ */
+bool DummyInputPort::SendFrame() {
+  if (m_options.changed_slots) {
+    m_value++;
+    for (unsigned int i = 0; i < m_options.changed_slots; i++) {
+      m_buffer.SetChannel((m_offset + i) % DMX_UNIVERSE_SIZE,
+                          m_value + i);
+    }
+    m_offset = (m_offset + m_options.changed_slots) % DMX_UNIVERSE_SIZE;
+  }
+  DmxChanged();
+  return true;
+}
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
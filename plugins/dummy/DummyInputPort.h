@@ -0,0 +1,88 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DummyInputPort.h
+ * An input port that generates DMX frames.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_DUMMY_DUMMYINPUTPORT_H_
+#define PLUGINS_DUMMY_DUMMYINPUTPORT_H_
+
+#include <string>
+#include "ola/DmxBuffer.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "olad/Port.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+/**
+ * @brief An input port that generates frames at a fixed rate.
+ *
+ * Frames are only generated while the port is patched.
+ */
+class DummyInputPort: public BasicInputPort {
+ public:
+  struct Options {
+   public:
+    Options()
+        : frame_rate(40),
+          changed_slots(DMX_UNIVERSE_SIZE),
+          has_default_universe(false),
+          default_universe(0) {
+    }
+
+    // Frames per second.
+    unsigned int frame_rate;
+    // The number of slots that change in each frame.
+    unsigned int changed_slots;
+    bool has_default_universe;
+    unsigned int default_universe;
+  };
+
+  /**
+   * @brief Create a new DummyInputPort
+   * @param parent the parent device for this port
+   * @param plugin_adaptor the PluginAdaptor to use for the timer
+   * @param options the frame rate and pattern to generate
+   * @param id the ID of this port
+   */
+  DummyInputPort(class DummyDevice *parent,
+                 PluginAdaptor *plugin_adaptor,
+                 const Options &options,
+                 unsigned int id);
+  ~DummyInputPort();
+
+  std::string Description() const { return "Dummy Input Port"; }
+  const DmxBuffer &ReadDMX() const { return m_buffer; }
+  void PostSetUniverse(Universe *old_universe, Universe *new_universe);
+  bool DefaultUniverse(unsigned int *universe) const;
+
+ private:
+  PluginAdaptor *m_plugin_adaptor;
+  const Options m_options;
+  DmxBuffer m_buffer;
+  ola::thread::timeout_id m_timeout_id;
+  unsigned int m_offset;
+  uint8_t m_value;
+
+  bool SendFrame();
+};
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_DUMMY_DUMMYINPUTPORT_H_
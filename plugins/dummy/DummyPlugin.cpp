@@ -20,12 +20,16 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "ola/Constants.h"
 #include "ola/StringUtils.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
 #include "plugins/dummy/DummyDevice.h"
+#include "plugins/dummy/DummyInputPort.h"
 #include "plugins/dummy/DummyPort.h"
 #include "plugins/dummy/DummyPlugin.h"
 #include "plugins/dummy/DummyPluginDescription.h"
@@ -35,6 +39,7 @@ namespace plugin {
 namespace dummy {
 
 using std::string;
+using std::vector;
 
 const char DummyPlugin::ACK_TIMER_COUNT_KEY[] = "ack_timer_count";
 const char DummyPlugin::ADVANCED_DIMMER_KEY[] = "advanced_dimmer_count";
@@ -42,20 +47,28 @@ const uint8_t DummyPlugin::DEFAULT_DEVICE_COUNT = 1;
 // 0 for now, since the web UI doesn't handle it.
 const uint8_t DummyPlugin::DEFAULT_ACK_TIMER_DEVICE_COUNT = 0;
 const uint16_t DummyPlugin::DEFAULT_SUBDEVICE_COUNT = 4;
+const unsigned int DummyPlugin::DEFAULT_INPUT_FRAME_RATE = 40;
+const char DummyPlugin::DEVICE_COUNT_KEY[] = "device_count";
 const char DummyPlugin::DEVICE_NAME[] = "Dummy Device";
 const char DummyPlugin::DIMMER_COUNT_KEY[] = "dimmer_count";
 const char DummyPlugin::DIMMER_SUBDEVICE_COUNT_KEY[] = "dimmer_subdevice_count";
 const char DummyPlugin::DUMMY_DEVICE_COUNT_KEY[] = "dummy_device_count";
+const char DummyPlugin::INPUT_CHANGED_SLOTS_KEY[] = "input_changed_slots";
+const char DummyPlugin::INPUT_FRAME_RATE_KEY[] = "input_frame_rate";
+const char DummyPlugin::INPUT_PORT_COUNT_KEY[] = "input_port_count";
 const char DummyPlugin::MOVING_LIGHT_COUNT_KEY[] = "moving_light_count";
 const char DummyPlugin::NETWORK_COUNT_KEY[] = "network_device_count";
+const char DummyPlugin::OUTPUT_PORT_COUNT_KEY[] = "output_port_count";
 const char DummyPlugin::PLUGIN_NAME[] = "Dummy";
 const char DummyPlugin::PLUGIN_PREFIX[] = "dummy";
 const char DummyPlugin::SENSOR_COUNT_KEY[] = "sensor_device_count";
+const char DummyPlugin::UNIVERSE_COUNT_KEY[] = "universe_count";
 
 /*
  * Start the plugin
  *
- * Lets keep it simple, one device for this plugin.
+ * By default there is one device with a single output port. More devices,
+ * ports and universes can be configured for load testing.
  */
 bool DummyPlugin::StartHook() {
   DummyPort::Options options;
@@ -100,14 +113,29 @@ bool DummyPlugin::StartHook() {
     options.number_of_network_responders = DEFAULT_DEVICE_COUNT;
   }
 
-  std::auto_ptr<DummyDevice> device(
-      new DummyDevice(this, DEVICE_NAME, options));
-  if (!device->Start()) {
-    return false;
+  DummyDevice::Options device_options;
+  device_options.output_port_count = GetUIntValue(OUTPUT_PORT_COUNT_KEY, 1);
+  device_options.input_port_count = GetUIntValue(INPUT_PORT_COUNT_KEY, 0);
+  device_options.universe_count = GetUIntValue(UNIVERSE_COUNT_KEY, 0);
+
+  DummyInputPort::Options input_options;
+  input_options.frame_rate = GetUIntValue(INPUT_FRAME_RATE_KEY,
+                                          DEFAULT_INPUT_FRAME_RATE);
+  input_options.changed_slots = GetUIntValue(INPUT_CHANGED_SLOTS_KEY,
+                                             DMX_UNIVERSE_SIZE);
+
+  unsigned int device_count = GetUIntValue(DEVICE_COUNT_KEY, 1);
+  for (unsigned int i = 0; i < device_count; i++) {
+    std::auto_ptr<DummyDevice> device(
+        new DummyDevice(this, m_plugin_adaptor, DEVICE_NAME, i,
+                        device_options, options, input_options));
+    if (!device->Start()) {
+      continue;
+    }
+    m_plugin_adaptor->RegisterDevice(device.get());
+    m_devices.push_back(device.release());
   }
-  m_device = device.release();
-  m_plugin_adaptor->RegisterDevice(m_device);
-  return true;
+  return !m_devices.empty();
 }
 
 
@@ -116,13 +144,15 @@ bool DummyPlugin::StartHook() {
  * @return true on success, false on failure
  */
 bool DummyPlugin::StopHook() {
-  if (m_device) {
-    m_plugin_adaptor->UnregisterDevice(m_device);
-    bool ret = m_device->Stop();
-    delete m_device;
-    return ret;
+  bool ret = true;
+  vector<DummyDevice*>::iterator iter = m_devices.begin();
+  for (; iter != m_devices.end(); ++iter) {
+    m_plugin_adaptor->UnregisterDevice(*iter);
+    ret &= (*iter)->Stop();
+    delete *iter;
   }
-  return true;
+  m_devices.clear();
+  return ret;
 }
 
 
@@ -173,12 +203,49 @@ bool DummyPlugin::SetDefaultPreferences() {
                                          IntValidator(0, 254),
                                          DEFAULT_DEVICE_COUNT);
 
+  save |= m_preferences->SetDefaultValue(DEVICE_COUNT_KEY,
+                                         UIntValidator(1, 1024),
+                                         1);
+
+  save |= m_preferences->SetDefaultValue(OUTPUT_PORT_COUNT_KEY,
+                                         UIntValidator(0, 512),
+                                         1);
+
+  save |= m_preferences->SetDefaultValue(INPUT_PORT_COUNT_KEY,
+                                         UIntValidator(0, 512),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(UNIVERSE_COUNT_KEY,
+                                         UIntValidator(0, 65535),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(INPUT_FRAME_RATE_KEY,
+                                         UIntValidator(1, 1000),
+                                         DEFAULT_INPUT_FRAME_RATE);
+
+  save |= m_preferences->SetDefaultValue(INPUT_CHANGED_SLOTS_KEY,
+                                         UIntValidator(0, DMX_UNIVERSE_SIZE),
+                                         DMX_UNIVERSE_SIZE);
+
   if (save) {
     m_preferences->Save();
   }
 
   return true;
 }
+
+
+/**
+ * Get an unsigned int preference, or the default if it isn't valid.
+ */
+unsigned int DummyPlugin::GetUIntValue(const string &key,
+                                       unsigned int default_value) const {
+  unsigned int value;
+  if (!StringToInt(m_preferences->GetValue(key), &value)) {
+    value = default_value;
+  }
+  return value;
+}
 }  // namespace dummy
 }  // namespace plugin
 }  // namespace ola
@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
 
@@ -35,35 +36,46 @@ class DummyDevice;
 class DummyPlugin: public Plugin {
  public:
     explicit DummyPlugin(PluginAdaptor *plugin_adaptor):
-      Plugin(plugin_adaptor),
-      m_device(NULL) {}
+      Plugin(plugin_adaptor) {}
 
     std::string Name() const { return PLUGIN_NAME; }
     std::string Description() const;
     ola_plugin_id Id() const { return OLA_PLUGIN_DUMMY; }
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
     bool SetDefaultPreferences();
 
-    DummyDevice *m_device;  // the dummy device
+    std::vector<DummyDevice*> m_devices;
+
+    unsigned int GetUIntValue(const std::string &key,
+                              unsigned int default_value) const;
+
     static const char ACK_TIMER_COUNT_KEY[];
     static const char ADVANCED_DIMMER_KEY[];
     static const uint8_t DEFAULT_DEVICE_COUNT;
     static const uint8_t DEFAULT_ACK_TIMER_DEVICE_COUNT;
     static const uint16_t DEFAULT_SUBDEVICE_COUNT;
+    static const unsigned int DEFAULT_INPUT_FRAME_RATE;
+    static const char DEVICE_COUNT_KEY[];
     static const char DEVICE_NAME[];
     static const char DIMMER_COUNT_KEY[];
     static const char DIMMER_SUBDEVICE_COUNT_KEY[];
     static const char DUMMY_DEVICE_COUNT_KEY[];
+    static const char INPUT_CHANGED_SLOTS_KEY[];
+    static const char INPUT_FRAME_RATE_KEY[];
+    static const char INPUT_PORT_COUNT_KEY[];
     static const char MOVING_LIGHT_COUNT_KEY[];
     static const char NETWORK_COUNT_KEY[];
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
+    static const char OUTPUT_PORT_COUNT_KEY[];
     static const char SENSOR_COUNT_KEY[];
     static const char SUBDEVICE_COUNT_KEY[];
+    static const char UNIVERSE_COUNT_KEY[];
 };
 }  // namespace dummy
 }  // namespace plugin
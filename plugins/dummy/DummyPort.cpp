@@ -73,9 +73,17 @@ void AddResponders(map<UID, ola::rdm::RDMControllerInterface*> *responders,
 DummyPort::DummyPort(DummyDevice *parent,
                      const Options &options,
                      unsigned int id)
-    : BasicOutputPort(parent, id, true, true) {
-  UID first_uid(OPEN_LIGHTING_ESTA_CODE, DummyPort::kStartAddress);
-  ola::rdm::UIDAllocator allocator(first_uid);
+    : BasicOutputPort(parent, id, true, true),
+      m_has_default_universe(options.has_default_universe),
+      m_default_universe(options.default_universe) {
+  uint32_t first_device_id = kStartAddress;
+  uint32_t last_device_id = UID::ALL_DEVICES;
+  if (options.uid_block) {
+    first_device_id = kStartAddress - options.uid_block * UID_BLOCK_SIZE;
+    last_device_id = first_device_id + UID_BLOCK_SIZE - 1;
+  }
+  UID first_uid(OPEN_LIGHTING_ESTA_CODE, first_device_id);
+  ola::rdm::UIDAllocator allocator(first_uid, last_device_id);
 
   AddResponders<ola::rdm::DummyResponder>(
       &m_responders, &allocator, options.number_of_dummy_responders);
@@ -110,6 +118,12 @@ bool DummyPort::WriteDMX(const DmxBuffer &buffer,
                          uint8_t priority) {
   (void) priority;
   m_buffer = buffer;
+  // Don't format the data unless it'll be logged, since this may be called
+  // thousands of times a second when load testing.
+  if (ola::LogLevel() < ola::OLA_LOG_INFO) {
+    return true;
+  }
+
   ostringstream str;
   string data = buffer.Get();
 
@@ -120,6 +134,13 @@ bool DummyPort::WriteDMX(const DmxBuffer &buffer,
   return true;
 }
 
+bool DummyPort::DefaultUniverse(unsigned int *universe) const {
+  if (m_has_default_universe) {
+    *universe = m_default_universe;
+  }
+  return m_has_default_universe;
+}
+
 void DummyPort::RunFullDiscovery(RDMDiscoveryCallback *callback) {
   RunDiscovery(callback);
 }
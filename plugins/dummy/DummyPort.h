@@ -48,7 +48,10 @@ class DummyPort: public BasicOutputPort {
           number_of_ack_timer_responders(0),
           number_of_advanced_dimmers(1),
           number_of_sensor_responders(1),
-          number_of_network_responders(1) {
+          number_of_network_responders(1),
+          uid_block(0),
+          has_default_universe(false),
+          default_universe(0) {
     }
 
     uint8_t number_of_dimmers;
@@ -59,6 +62,10 @@ class DummyPort: public BasicOutputPort {
     uint8_t number_of_advanced_dimmers;
     uint8_t number_of_sensor_responders;
     uint8_t number_of_network_responders;
+    // Each port needs its own block of UIDs, see UID_BLOCK_SIZE.
+    unsigned int uid_block;
+    bool has_default_universe;
+    unsigned int default_universe;
   };
 
 
@@ -75,6 +82,7 @@ class DummyPort: public BasicOutputPort {
   virtual ~DummyPort();
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
   std::string Description() const { return "Dummy Port"; }
+  bool DefaultUniverse(unsigned int *universe) const;
   void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
   void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
 
@@ -95,6 +103,8 @@ class DummyPort: public BasicOutputPort {
   typedef std::map<ola::rdm::UID,
                    ola::rdm::RDMControllerInterface*> ResponderMap;
 
+  const bool m_has_default_universe;
+  const unsigned int m_default_universe;
   DmxBuffer m_buffer;
   ResponderMap m_responders;
 
@@ -105,6 +115,9 @@ class DummyPort: public BasicOutputPort {
   // See https://wiki.openlighting.org/index.php/Open_Lighting_Allocations
   // Do not change.
   static const unsigned int kStartAddress = 0xffffff00;
+  // Ports after the first allocate UIDs from successive blocks of this size
+  // below kStartAddress.
+  static const unsigned int UID_BLOCK_SIZE = 0x800;
 };
 }  // namespace dummy
 }  // namespace plugin
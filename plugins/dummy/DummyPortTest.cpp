@@ -71,6 +71,7 @@ class MockDummyPort: public DummyPort {
 class DummyPortTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DummyPortTest);
   CPPUNIT_TEST(testRDMDiscovery);
+  CPPUNIT_TEST(testUIDBlock);
   CPPUNIT_TEST(testUnknownPid);
   CPPUNIT_TEST(testSupportedParams);
   CPPUNIT_TEST(testDeviceInfo);
@@ -100,6 +101,7 @@ class DummyPortTest: public CppUnit::TestFixture {
   void Verify() { OLA_ASSERT_FALSE(m_expected_response); }
 
   void testRDMDiscovery();
+  void testUIDBlock();
   void testUnknownPid();
   void testSupportedParams();
   void testDeviceInfo();
@@ -119,6 +121,7 @@ class DummyPortTest: public CppUnit::TestFixture {
   bool m_got_uids;
 
   void VerifyUIDs(const UIDSet &uids);
+  void StoreUIDs(UIDSet *output, const UIDSet &uids) { *output = uids; }
   void checkSubDeviceOutOfRange(uint16_t pid);
   void checkSubDeviceOutOfRange(ola::rdm::rdm_pid pid) {
     checkSubDeviceOutOfRange(static_cast<uint16_t>(pid));
@@ -185,6 +188,32 @@ void DummyPortTest::testRDMDiscovery() {
 }
 
 
+/*
+ * Check that ports use their own block of UIDs, and the default universe.
+ */
+void DummyPortTest::testUIDBlock() {
+  unsigned int universe;
+  OLA_ASSERT_FALSE(m_port.DefaultUniverse(&universe));
+
+  DummyPort::Options options;
+  options.uid_block = 2;
+  options.has_default_universe = true;
+  options.default_universe = 7;
+  DummyPort port(NULL, options, 1);
+  OLA_ASSERT_TRUE(port.DefaultUniverse(&universe));
+  OLA_ASSERT_EQ(7u, universe);
+
+  UIDSet uids;
+  port.RunFullDiscovery(
+      NewSingleCallback(this, &DummyPortTest::StoreUIDs, &uids));
+  UIDSet expected_uids;
+  for (unsigned int i = 0; i < 6; i++) {
+    expected_uids.AddUID(UID(OPEN_LIGHTING_ESTA_CODE, 0xffffef00 + i));
+  }
+  OLA_ASSERT_EQ(expected_uids, uids);
+}
+
+
 /*
  * Check that unknown pids fail
  */
@@ -13,6 +13,8 @@ plugins/dummy/DummyPluginDescription.h: plugins/dummy/README.md plugins/dummy/Ma
 plugins_dummy_liboladummy_la_SOURCES = \
     plugins/dummy/DummyDevice.cpp \
     plugins/dummy/DummyDevice.h \
+    plugins/dummy/DummyInputPort.cpp \
+    plugins/dummy/DummyInputPort.h \
     plugins/dummy/DummyPlugin.cpp \
     plugins/dummy/DummyPlugin.h \
     plugins/dummy/DummyPort.cpp \
@@ -30,8 +30,10 @@
 
 #include "common/rpc/RpcController.h"
 #include "ola/CallbackRunner.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/network/NetworkUtils.h"
+#include "ola/network/Socket.h"
 #include "olad/Plugin.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
@@ -52,6 +54,13 @@ using std::set;
 using std::string;
 using std::vector;
 
+namespace {
+uint16_t SyncUniverse(const vector<uint16_t> &sync_universes,
+                      unsigned int port_id) {
+  return port_id < sync_universes.size() ? sync_universes[port_id] : 0;
+}
+}  // namespace
+
 /*
  * Create a new device
  */
@@ -72,6 +81,13 @@ E131Device::E131Device(Plugin *owner,
  * Start this device
  */
 bool E131Device::StartHook() {
+  ola::ExportMap *export_map = m_plugin_adaptor->GetExportMap();
+  if (export_map) {
+    (*export_map->GetUIntMapVar(
+        ola::network::DatagramBatch::K_RECV_BATCH_SIZE_VAR,
+        "protocol"))["e131"] = m_options.recv_batch_size;
+  }
+
   m_node.reset(new E131Node(m_plugin_adaptor, m_ip_addr, m_options, m_cid));
 
   if (!m_node->Start()) {
@@ -80,20 +96,27 @@ bool E131Device::StartHook() {
     return false;
   }
 
+  if (m_options.use_xdp) {
+    m_node->SetXDPReceiver(m_plugin_adaptor->GetXDPReceiver(
+        m_node->GetInterface(), m_options.xdp_queue));
+  }
+
   ostringstream str;
   str << DEVICE_NAME << " [" << m_node->GetInterface().ip_address << "]";
   SetName(str.str());
 
   for (unsigned int i = 0; i < m_options.input_ports; i++) {
     E131InputPort *input_port = new E131InputPort(
-        this, i, m_node.get(), m_plugin_adaptor);
+        this, i, m_node.get(), m_plugin_adaptor,
+        SyncUniverse(m_options.input_sync_universes, i));
     AddPort(input_port);
     m_input_ports.push_back(input_port);
   }
 
   for (unsigned int i = 0; i < m_options.output_ports; i++) {
     E131OutputPort *output_port = new E131OutputPort(
-        this, i, m_node.get());
+        this, i, m_node.get(),
+        SyncUniverse(m_options.output_sync_universes, i));
     AddPort(output_port);
     m_output_ports.push_back(output_port);
   }
@@ -148,6 +171,9 @@ void E131Device::Configure(RpcController *controller,
     case ola::plugin::e131::Request::E131_SOURCES_LIST:
       HandleSourceListRequest(&request_pb, response);
       break;
+    case ola::plugin::e131::Request::E131_SOURCE_STATS:
+      HandleSourceStatsRequest(response);
+      break;
     default:
       controller->SetFailed("Invalid Request");
   }
@@ -241,6 +267,31 @@ void E131Device::HandleSourceListRequest(const Request *request,
   reply.SerializeToString(response);
 }
 
+void E131Device::HandleSourceStatsRequest(string *response) {
+  ola::plugin::e131::Reply reply;
+  reply.set_type(ola::plugin::e131::Reply::E131_SOURCE_STATS);
+  ola::plugin::e131::SourceStatsReply *stats_reply =
+      reply.mutable_source_stats();
+
+  vector<E131Node::SourceStats> sources;
+  m_node->GetSourceStats(&sources);
+  vector<E131Node::SourceStats>::const_iterator iter = sources.begin();
+  for (; iter != sources.end(); ++iter) {
+    ola::plugin::e131::SourceStats *stats = stats_reply->add_source();
+    stats->set_cid(iter->cid.ToString());
+    stats->set_universe(iter->universe);
+    stats->set_priority(iter->priority);
+    stats->set_merged(iter->merged);
+    stats->set_packets(iter->packets);
+    stats->set_sequence_gaps(iter->sequence_gaps);
+    stats->set_out_of_order(iter->out_of_order);
+    stats->set_duplicates(iter->duplicates);
+    stats->set_mean_interval(iter->mean_interval.AsInt());
+    stats->set_jitter(iter->jitter.AsInt());
+  }
+  reply.SerializeToString(response);
+}
+
 E131InputPort *E131Device::GetE131InputPort(unsigned int port_id) {
   return (port_id < m_input_ports.size()) ? m_input_ports[port_id] : NULL;
 }
@@ -44,10 +44,19 @@ class E131Device: public ola::Device {
     E131DeviceOptions()
       : ola::acn::E131Node::Options(),
         input_ports(0),
-        output_ports(0) {
+        output_ports(0),
+        use_xdp(false),
+        xdp_queue(0) {
     }
     unsigned int input_ports;
     unsigned int output_ports;
+    // Receive with AF_XDP on this NIC queue.
+    bool use_xdp;
+    unsigned int xdp_queue;
+    // The sync universe for each port, indexed by port id. 0, or a missing
+    // entry, means the port isn't synchronized.
+    std::vector<uint16_t> input_sync_universes;
+    std::vector<uint16_t> output_sync_universes;
   };
 
   E131Device(ola::Plugin *owner,
@@ -82,6 +91,7 @@ class E131Device: public ola::Device {
   void HandlePortStatusRequest(std::string *response);
   void HandleSourceListRequest(const ola::plugin::e131::Request *request,
                                std::string *response);
+  void HandleSourceStatsRequest(std::string *response);
 
   E131InputPort *GetE131InputPort(unsigned int port_id);
   E131OutputPort *GetE131OutputPort(unsigned int port_id);
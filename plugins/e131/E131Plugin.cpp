@@ -20,6 +20,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "ola/Logging.h"
 #include "ola/network/NetworkUtils.h"
@@ -27,6 +28,7 @@
 #include "ola/acn/CID.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/UDPReceivePreferences.h"
 #include "plugins/e131/E131Device.h"
 #include "plugins/e131/E131Plugin.h"
 #include "plugins/e131/E131PluginDescription.h"
@@ -45,13 +47,20 @@ const char E131Plugin::DRAFT_DISCOVERY_KEY[] = "draft_discovery";
 const char E131Plugin::IGNORE_PREVIEW_DATA_KEY[] = "ignore_preview";
 const char E131Plugin::INPUT_PORT_COUNT_KEY[] = "input_ports";
 const char E131Plugin::IP_KEY[] = "ip";
+const char E131Plugin::IPV6_KEY[] = "ipv6";
+const unsigned int E131Plugin::MAX_PACING_RATE_KBPS = 10000000;
+const unsigned int E131Plugin::MAX_SOURCE_TIMEOUT_MS = 10000;
+const unsigned int E131Plugin::MIN_SOURCE_TIMEOUT_MS = 100;
 const char E131Plugin::OUTPUT_PORT_COUNT_KEY[] = "output_ports";
+const char E131Plugin::PACING_RATE_KEY[] = "pacing_rate";
 const char E131Plugin::PLUGIN_NAME[] = "E1.31 (sACN)";
 const char E131Plugin::PLUGIN_PREFIX[] = "e131";
 const char E131Plugin::PREPEND_HOSTNAME_KEY[] = "prepend_hostname";
 const char E131Plugin::REVISION_0_2[] = "0.2";
 const char E131Plugin::REVISION_0_46[] = "0.46";
 const char E131Plugin::REVISION_KEY[] = "revision";
+const char E131Plugin::SOURCE_TIMEOUT_KEY[] = "source_timeout";
+const char E131Plugin::SYNC_UNIVERSE_SUFFIX[] = "_sync_universe";
 const unsigned int E131Plugin::DEFAULT_PORT_COUNT = 5;
 
 
@@ -64,6 +73,7 @@ bool E131Plugin::StartHook() {
 
   E131Device::E131DeviceOptions options;
   options.use_rev2 = (m_preferences->GetValue(REVISION_KEY) == REVISION_0_2);
+  options.use_ipv6 = m_preferences->GetValueAsBool(IPV6_KEY);
   options.ignore_preview = m_preferences->GetValueAsBool(
       IGNORE_PREVIEW_DATA_KEY);
   options.enable_draft_discovery = m_preferences->GetValueAsBool(
@@ -86,6 +96,20 @@ bool E131Plugin::StartHook() {
     options.dscp = dscp << 2;
   }
 
+  const string pacing_rate = m_preferences->GetValue(PACING_RATE_KEY);
+  unsigned int pacing_kbps = 0;
+  if (!pacing_rate.empty() && !StringToInt(pacing_rate, &pacing_kbps)) {
+    OLA_WARN << "Invalid value for " << PACING_RATE_KEY;
+  }
+  // kbit/s to bytes/s
+  options.max_pacing_rate = pacing_kbps * 125;
+
+  if (!StringToInt(m_preferences->GetValue(SOURCE_TIMEOUT_KEY),
+                   &options.source_timeout_ms)) {
+    OLA_WARN << "Invalid value for " << SOURCE_TIMEOUT_KEY;
+    options.source_timeout_ms = ola::acn::E131Node::DEFAULT_SOURCE_TIMEOUT_MS;
+  }
+
   if (!StringToInt(m_preferences->GetValue(INPUT_PORT_COUNT_KEY),
                    &options.input_ports)) {
     OLA_WARN << "Invalid value for input_ports";
@@ -96,6 +120,15 @@ bool E131Plugin::StartHook() {
     OLA_WARN << "Invalid value for input_ports";
   }
 
+  ReadSyncUniverses("input_", options.input_ports,
+                    &options.input_sync_universes);
+  ReadSyncUniverses("output_", options.output_ports,
+                    &options.output_sync_universes);
+  ReadUDPReceivePreferences(*m_preferences, m_plugin_adaptor->GetExportMap(),
+                            "e131", &options.receive_options);
+  options.use_xdp = ReadNetworkEnginePreferences(*m_preferences,
+                                                 &options.xdp_queue);
+
   m_device = new E131Device(this, cid, ip_addr, m_plugin_adaptor, options);
 
   if (!m_device->Start()) {
@@ -131,6 +164,28 @@ string E131Plugin::Description() const {
 }
 
 
+/*
+ * Read the optional sync universe for each port, e.g. output_0_sync_universe.
+ * @param prefix the key prefix for the type of port
+ * @param port_count the number of ports
+ * @param sync_universes the sync universe for each port, 0 if the port isn't
+ *   synchronized.
+ */
+void E131Plugin::ReadSyncUniverses(const string &prefix,
+                                   unsigned int port_count,
+                                   std::vector<uint16_t> *sync_universes) {
+  for (unsigned int i = 0; i < port_count; i++) {
+    const string key = prefix + IntToString(i) + SYNC_UNIVERSE_SUFFIX;
+    const string value = m_preferences->GetValue(key);
+    uint16_t sync_universe = 0;
+    if (!value.empty() && !StringToInt(value, &sync_universe)) {
+      OLA_WARN << "Invalid value for " << key;
+    }
+    sync_universes->push_back(sync_universe);
+  }
+}
+
+
 /*
  * Load the plugin prefs and default to sensible values
  *
@@ -153,6 +208,11 @@ bool E131Plugin::SetDefaultPreferences() {
       UIntValidator(0, 63),
       DEFAULT_DSCP_VALUE);
 
+  save |= m_preferences->SetDefaultValue(
+      PACING_RATE_KEY,
+      UIntValidator(0, MAX_PACING_RATE_KBPS),
+      0);
+
   save |= m_preferences->SetDefaultValue(
       DRAFT_DISCOVERY_KEY,
       BoolValidator(),
@@ -175,11 +235,21 @@ bool E131Plugin::SetDefaultPreferences() {
 
   save |= m_preferences->SetDefaultValue(IP_KEY, StringValidator(true), "");
 
+  save |= m_preferences->SetDefaultValue(
+      IPV6_KEY,
+      BoolValidator(),
+      false);
+
   save |= m_preferences->SetDefaultValue(
       PREPEND_HOSTNAME_KEY,
       BoolValidator(),
       true);
 
+  save |= m_preferences->SetDefaultValue(
+      SOURCE_TIMEOUT_KEY,
+      UIntValidator(MIN_SOURCE_TIMEOUT_MS, MAX_SOURCE_TIMEOUT_MS),
+      ola::acn::E131Node::DEFAULT_SOURCE_TIMEOUT_MS);
+
   std::set<string> revision_values;
   revision_values.insert(REVISION_0_2);
   revision_values.insert(REVISION_0_46);
@@ -189,6 +259,9 @@ bool E131Plugin::SetDefaultPreferences() {
       SetValidator<string>(revision_values),
       REVISION_0_46);
 
+  save |= SetDefaultUDPReceivePreferences(m_preferences);
+  save |= SetDefaultNetworkEnginePreferences(m_preferences);
+
   if (save) {
     m_preferences->Save();
   }
@@ -22,6 +22,7 @@
 #define PLUGINS_E131_E131PLUGIN_H_
 
 #include <string>
+#include <vector>
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
 
@@ -43,27 +44,37 @@ class E131Plugin: public ola::Plugin {
     std::string Description() const;
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
     bool SetDefaultPreferences();
+    void ReadSyncUniverses(const std::string &prefix, unsigned int port_count,
+                           std::vector<uint16_t> *sync_universes);
 
     E131Device *m_device;
     static const char CID_KEY[];
     static const unsigned int DEFAULT_DSCP_VALUE;
     static const unsigned int DEFAULT_PORT_COUNT;
+    static const unsigned int MAX_PACING_RATE_KBPS;
+    static const unsigned int MAX_SOURCE_TIMEOUT_MS;
+    static const unsigned int MIN_SOURCE_TIMEOUT_MS;
     static const char DRAFT_DISCOVERY_KEY[];
     static const char DSCP_KEY[];
     static const char IGNORE_PREVIEW_DATA_KEY[];
     static const char INPUT_PORT_COUNT_KEY[];
     static const char IP_KEY[];
+    static const char IPV6_KEY[];
     static const char OUTPUT_PORT_COUNT_KEY[];
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
+    static const char PACING_RATE_KEY[];
     static const char PREPEND_HOSTNAME_KEY[];
     static const char REVISION_0_2[];
     static const char REVISION_0_46[];
     static const char REVISION_KEY[];
+    static const char SOURCE_TIMEOUT_KEY[];
+    static const char SYNC_UNIVERSE_SUFFIX[];
 };
 }  // namespace e131
 }  // namespace plugin
@@ -65,7 +65,9 @@ void E131InputPort::PostSetUniverse(Universe *old_universe,
         new_universe->UniverseId(),
         &m_buffer,
         &m_priority,
-        NewCallback<E131InputPort, void>(this, &E131InputPort::DmxChanged));
+        NewCallback<E131InputPort, void>(this, &E131InputPort::DmxChanged),
+        &m_slot_priorities,
+        m_sync_universe);
 }
 
 E131OutputPort::~E131OutputPort() {
@@ -85,6 +87,9 @@ void E131OutputPort::PostSetUniverse(Universe *old_universe,
   }
   if (new_universe) {
     m_node->StartStream(new_universe->UniverseId());
+    if (m_sync_universe) {
+      m_node->SetSyncUniverse(new_universe->UniverseId(), m_sync_universe);
+    }
   }
 }
 
@@ -99,9 +104,37 @@ bool E131OutputPort::WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
 
   m_last_priority = (GetPriorityMode() == PRIORITY_MODE_STATIC) ?
       GetPriority() : priority;
+  if (GetPriorityMode() == PRIORITY_MODE_INHERIT) {
+    SendSlotPrioritiesIfRequired(universe->UniverseId());
+  }
   return m_node->SendDMX(universe->UniverseId(), buffer, m_last_priority,
                          m_preview_on);
 }
+
+
+/*
+ * Send the universe's per-slot priorities if they changed, or if we haven't
+ * sent them for a while.
+ */
+void E131OutputPort::SendSlotPrioritiesIfRequired(uint16_t universe) {
+  const DmxBuffer &slot_priorities = GetUniverse()->GetSlotPriorities();
+  if (!slot_priorities.Size()) {
+    m_last_slot_priorities.Reset();
+    return;
+  }
+
+  m_frames_since_slot_priorities++;
+  if (m_frames_since_slot_priorities < SLOT_PRIORITY_RESEND_FRAMES &&
+      slot_priorities == m_last_slot_priorities) {
+    return;
+  }
+
+  if (m_node->SendSlotPriorities(universe, slot_priorities, m_last_priority,
+                                 m_preview_on)) {
+    m_last_slot_priorities = slot_priorities;
+    m_frames_since_slot_priorities = 0;
+  }
+}
 }  // namespace e131
 }  // namespace plugin
 }  // namespace ola
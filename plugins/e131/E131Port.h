@@ -42,10 +42,12 @@ class E131PortHelper {
 class E131InputPort: public BasicInputPort {
  public:
   E131InputPort(E131Device *parent, int id, ola::acn::E131Node *node,
-                class PluginAdaptor *plugin_adaptor)
+                class PluginAdaptor *plugin_adaptor,
+                uint16_t sync_universe = 0)
       : BasicInputPort(parent, id, plugin_adaptor),
         m_node(node),
-        m_priority(ola::dmx::SOURCE_PRIORITY_DEFAULT) {
+        m_priority(ola::dmx::SOURCE_PRIORITY_DEFAULT),
+        m_sync_universe(sync_universe) {
     SetPriorityMode(PRIORITY_MODE_INHERIT);
   }
 
@@ -59,21 +61,30 @@ class E131InputPort: public BasicInputPort {
   const ola::DmxBuffer &ReadDMX() const { return m_buffer; }
   bool SupportsPriorities() const { return true; }
   uint8_t InheritedPriority() const { return m_priority; }
+  const ola::DmxBuffer *InheritedSlotPriorities() const {
+    return m_slot_priorities.Size() ? &m_slot_priorities : NULL;
+  }
 
  private:
   ola::DmxBuffer m_buffer;
+  ola::DmxBuffer m_slot_priorities;
   ola::acn::E131Node *m_node;
   E131PortHelper m_helper;
   uint8_t m_priority;
+  // if set, synchronized data is held until the sync packet arrives.
+  const uint16_t m_sync_universe;
 };
 
 
 class E131OutputPort: public BasicOutputPort {
  public:
-  E131OutputPort(E131Device *parent, int id, ola::acn::E131Node *node)
+  E131OutputPort(E131Device *parent, int id, ola::acn::E131Node *node,
+                 uint16_t sync_universe = 0)
       : BasicOutputPort(parent, id),
         m_preview_on(false),
-        m_node(node) {
+        m_frames_since_slot_priorities(0),
+        m_node(node),
+        m_sync_universe(sync_universe) {
     m_last_priority = GetPriority();
   }
 
@@ -89,6 +100,11 @@ class E131OutputPort: public BasicOutputPort {
 
   bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t priority);
 
+  // The E1.31 packets for a frame are sent together, followed by the sync
+  // packet if this port is synchronized.
+  void BeginBatch() { m_node->BeginBatch(); }
+  void EndBatch() { m_node->EndBatch(); }
+
   void SetPreviewMode(bool preview_mode) { m_preview_on = preview_mode; }
   bool PreviewMode() const { return m_preview_on; }
   bool SupportsPriorities() const { return true; }
@@ -96,9 +112,18 @@ class E131OutputPort: public BasicOutputPort {
  private:
   bool m_preview_on;
   uint8_t m_last_priority;
+  unsigned int m_frames_since_slot_priorities;
   ola::DmxBuffer m_buffer;
+  ola::DmxBuffer m_last_slot_priorities;
   ola::acn::E131Node *m_node;
   E131PortHelper m_helper;
+  const uint16_t m_sync_universe;
+
+  void SendSlotPrioritiesIfRequired(uint16_t universe);
+
+  // Resend the per-slot priorities every this many frames, even if they
+  // haven't changed. This is roughly once a second at 44Hz.
+  static const unsigned int SLOT_PRIORITY_RESEND_FRAMES = 44;
 };
 }  // namespace e131
 }  // namespace plugin
@@ -60,7 +60,8 @@ EspNetDevice::EspNetDevice(Plugin *owner,
  * Start this device
  */
 bool EspNetDevice::StartHook() {
-  m_node = new EspNetNode(m_preferences->GetValue(IP_KEY));
+  m_node = new EspNetNode(m_preferences->GetValue(IP_KEY),
+                          m_plugin_adaptor->GetExportMap());
   m_node->SetName(m_preferences->GetValue(NODE_NAME_KEY));
   m_node->SetType(ESPNET_NODE_TYPE_IO);
 
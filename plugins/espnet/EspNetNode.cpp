@@ -20,7 +20,6 @@
 
 #include <string.h>
 #include <algorithm>
-#include <map>
 #include <string>
 #include "ola/Logging.h"
 #include "ola/network/InterfacePicker.h"
@@ -40,7 +39,6 @@ using ola::network::IPV4SocketAddress;
 using ola::network::NetworkToHost;
 using ola::network::UDPSocket;
 using ola::Callback0;
-using std::map;
 using std::string;
 
 const char EspNetNode::NODE_NAME[] = "OLA Node";
@@ -49,9 +47,12 @@ const char EspNetNode::NODE_NAME[] = "OLA Node";
  * Create a new node
  * @param ip_address the IP address to prefer to listen on, if NULL we choose
  * one.
+ * @param export_map the ExportMap to add the receive counters to, may be NULL.
  */
-EspNetNode::EspNetNode(const string &ip_address)
-    : m_running(false),
+EspNetNode::EspNetNode(const string &ip_address,
+                       ola::ExportMap *export_map)
+    : UDPNode("espnet", sizeof(espnet_packet_union_t), export_map),
+      m_running(false),
       m_options(DEFAULT_OPTIONS),
       m_tos(DEFAULT_TOS),
       m_ttl(DEFAULT_TTL),
@@ -67,12 +68,6 @@ EspNetNode::EspNetNode(const string &ip_address)
  */
 EspNetNode::~EspNetNode() {
   Stop();
-
-  std::map<uint8_t, universe_handler>::iterator iter;
-  for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
-    delete iter->second.closure;
-  }
-  m_handlers.clear();
 }
 
 
@@ -117,41 +112,45 @@ bool EspNetNode::Stop() {
  * Called when there is data on this socket
  */
 void EspNetNode::SocketReady() {
-  espnet_packet_union_t packet;
-  memset(&packet, 0, sizeof(packet));
-  ola::network::IPV4SocketAddress source;
+  ReceivePackets(&m_socket);
+}
 
-  ssize_t packet_size = sizeof(packet);
-  if (!m_socket.RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                         &packet_size,
-                         &source))
-    return;
 
-  if (packet_size < (ssize_t) sizeof(packet.poll.head)) {
+/*
+ * Handle a datagram from the receive batch.
+ */
+bool EspNetNode::HandlePacket(const uint8_t *data, unsigned int length,
+                              const IPV4SocketAddress &source) {
+  const espnet_packet_union_t *packet =
+      reinterpret_cast<const espnet_packet_union_t*>(data);
+  const ssize_t packet_size = length;
+
+  if (packet_size < (ssize_t) sizeof(packet->poll.head)) {
     OLA_WARN << "Small espnet packet received, discarding";
-    return;
+    return false;
   }
 
   // skip packets sent by us
   if (source.Host() == m_interface.ip_address) {
-    return;
+    return false;
   }
 
-  switch (NetworkToHost(packet.poll.head)) {
+  switch (NetworkToHost(packet->poll.head)) {
     case ESPNET_POLL:
-      HandlePoll(packet.poll, packet_size, source.Host());
-      break;
+      HandlePoll(packet->poll, packet_size, source.Host());
+      return true;
     case ESPNET_REPLY:
-      HandleReply(packet.reply, packet_size, source.Host());
-      break;
+      HandleReply(packet->reply, packet_size, source.Host());
+      return true;
     case ESPNET_DMX:
-      HandleData(packet.dmx, packet_size, source.Host());
-      break;
+      return HandleData(packet->dmx, packet_size, source.Host());
     case ESPNET_ACK:
-      HandleAck(packet.ack, packet_size, source.Host());
-      break;
+      HandleAck(packet->ack, packet_size, source.Host());
+      return true;
     default:
-      OLA_INFO << "Skipping a packet with invalid header" << packet.poll.head;
+      OLA_INFO << "Skipping a packet with invalid header"
+               << packet->poll.head;
+      return false;
   }
 }
 
@@ -165,23 +164,7 @@ void EspNetNode::SocketReady() {
 bool EspNetNode::SetHandler(uint8_t universe,
                             DmxBuffer *buffer,
                             Callback0<void> *closure) {
-  if (!closure)
-    return false;
-
-  map<uint8_t, universe_handler>::iterator iter =
-    m_handlers.find(universe);
-
-  if (iter == m_handlers.end()) {
-    universe_handler handler;
-    handler.buffer = buffer;
-    handler.closure = closure;
-    m_handlers[universe] = handler;
-  } else {
-    Callback0<void> *old_closure = iter->second.closure;
-    iter->second.closure = closure;
-    delete old_closure;
-  }
-  return true;
+  return SetUniverseHandler(universe, buffer, closure);
 }
 
 
@@ -191,16 +174,7 @@ bool EspNetNode::SetHandler(uint8_t universe,
  * @param true if removed, false if it didn't exist
  */
 bool EspNetNode::RemoveHandler(uint8_t universe) {
-  map<uint8_t, universe_handler>::iterator iter =
-    m_handlers.find(universe);
-
-  if (iter != m_handlers.end()) {
-    Callback0<void> *old_closure = iter->second.closure;
-    m_handlers.erase(iter);
-    delete old_closure;
-    return true;
-  }
-  return false;
+  return RemoveUniverseHandler(universe);
 }
 
 
@@ -308,22 +282,20 @@ void EspNetNode::HandleAck(const espnet_ack_t &ack,
 /*
  * Handle an Esp data packet
  */
-void EspNetNode::HandleData(const espnet_data_t &data,
+bool EspNetNode::HandleData(const espnet_data_t &data,
                             ssize_t length,
                             const IPV4Address &source) {
   static const ssize_t header_size = sizeof(espnet_data_t) - DMX_UNIVERSE_SIZE;
   if (length < header_size) {
     OLA_DEBUG << "Data size too small " << length << " < " << header_size;
-    return;
+    return false;
   }
 
-  map<uint8_t, universe_handler>::iterator iter =
-    m_handlers.find(data.universe);
-
-  if (iter == m_handlers.end()) {
+  UniverseHandler *handler = LookupUniverse(data.universe);
+  if (!handler) {
     OLA_DEBUG << "Not interested in universe " <<
       static_cast<int>(data.universe) << ", skipping ";
-    return;
+    return false;
   }
 
   ssize_t data_size = std::min(length - header_size,
@@ -332,20 +304,21 @@ void EspNetNode::HandleData(const espnet_data_t &data,
   // we ignore the start code
   switch (data.type) {
     case DATA_RAW:
-      iter->second.buffer->Set(data.data, data_size);
+      handler->buffer->Set(data.data, data_size);
       break;
     case DATA_PAIRS:
       OLA_WARN << "espnet data pairs aren't supported";
-      return;
+      return false;
     case DATA_RLE:
-      m_decoder.Decode(iter->second.buffer, data.data, data_size);
+      m_decoder.Decode(handler->buffer, data.data, data_size);
       break;
     default:
       OLA_WARN << "unknown espnet data type " << data.type;
-      return;
+      return false;
   }
-  iter->second.closure->Run();
+  DmxReceived(handler);
   (void) source;
+  return true;
 }
 
 
@@ -22,9 +22,10 @@
 #define PLUGINS_ESPNET_ESPNETNODE_H_
 
 #include <string>
-#include <map>
+#include "common/network/UDPNode.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/Interface.h"
 #include "ola/network/Socket.h"
@@ -46,9 +47,10 @@ typedef enum {
 
 enum { ESPNET_MAX_UNIVERSES = 512 };
 
-class EspNetNode {
+class EspNetNode: public ola::network::UDPNode {
  public:
-    explicit EspNetNode(const std::string &ip_address);
+    explicit EspNetNode(const std::string &ip_address,
+                        ola::ExportMap *export_map = NULL);
     virtual ~EspNetNode();
 
     bool Start();
@@ -75,12 +77,11 @@ class EspNetNode {
     bool SendPoll(bool full_poll = false);
     bool SendDMX(uint8_t universe, const ola::DmxBuffer &buffer);
 
- private:
-    typedef struct {
-      DmxBuffer *buffer;
-      Callback0<void> *closure;
-    } universe_handler;
+ protected:
+    bool HandlePacket(const uint8_t *data, unsigned int length,
+                      const ola::network::IPV4SocketAddress &source);
 
+ private:
     EspNetNode(const EspNetNode&);
     EspNetNode& operator=(const EspNetNode&);
     bool InitNetwork();
@@ -91,7 +92,7 @@ class EspNetNode {
                      const ola::network::IPV4Address &source);
     void HandleAck(const espnet_ack_t &ack, ssize_t length,
                    const ola::network::IPV4Address &source);
-    void HandleData(const espnet_data_t &data, ssize_t length,
+    bool HandleData(const espnet_data_t &data, ssize_t length,
                     const ola::network::IPV4Address &source);
 
     bool SendEspPoll(const ola::network::IPV4Address &dst, bool full);
@@ -114,7 +115,6 @@ class EspNetNode {
     espnet_node_type m_type;
     std::string m_node_name;
     std::string m_preferred_ip;
-    std::map<uint8_t, universe_handler> m_handlers;
     ola::network::Interface m_interface;
     ola::network::UDPSocket m_socket;
     RunLengthDecoder m_decoder;
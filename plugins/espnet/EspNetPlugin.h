@@ -43,6 +43,9 @@ class EspNetPlugin: public ola::Plugin {
     ola_plugin_id Id() const { return OLA_PLUGIN_ESPNET; }
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
@@ -50,8 +53,6 @@ class EspNetPlugin: public ola::Plugin {
 
     EspNetDevice *m_device;
     static const char ESPNET_NODE_NAME[];
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
 };
 }  // namespace espnet
 }  // namespace plugin
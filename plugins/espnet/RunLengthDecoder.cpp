@@ -18,6 +18,7 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <string.h>
 #include <ola/Constants.h>
 #include <ola/base/Macro.h>
 #include "plugins/espnet/RunLengthDecoder.h"
@@ -31,32 +32,46 @@ namespace espnet {
  * @param dst the DmxBuffer to store the result
  * @param src_data the data to decode
  * @param length the length of the data to decode
+ *
+ * The frame is expanded on the stack and then copied into the DmxBuffer in a
+ * single call. A repeat or escape code at the end of the data is ignored.
  */
 void RunLengthDecoder::Decode(DmxBuffer *dst,
                               const uint8_t *src_data,
                               unsigned int length) {
-  dst->Reset();
+  uint8_t frame[DMX_UNIVERSE_SIZE];
   unsigned int i = 0;
   const uint8_t *value = src_data;
-  uint8_t count;
-  while (i < DMX_UNIVERSE_SIZE && value < src_data + length) {
+  const uint8_t *end = src_data + length;
+  while (i < DMX_UNIVERSE_SIZE && value < end) {
     switch (*value) {
       case REPEAT_VALUE:
-        value++;
-        count = *(value++);
-        dst->SetRangeToValue(i, *value, count);
-        i+= count;
-        break;
+        {
+          if (end - value < 3) {
+            value = end;
+            break;
+          }
+          unsigned int count = value[1];
+          if (count > DMX_UNIVERSE_SIZE - i) {
+            count = DMX_UNIVERSE_SIZE - i;
+          }
+          memset(frame + i, value[2], count);
+          i += count;
+          value += 3;
+          break;
+        }
       case ESCAPE_VALUE:
         value++;
+        if (value == end) {
+          break;
+        }
         // fall through
         OLA_FALLTHROUGH
       default:
-        dst->SetChannel(i, *value);
-        i++;
+        frame[i++] = *(value++);
     }
-    value++;
   }
+  dst->Set(frame, i);
 }
 }  // namespace espnet
 }  // namespace plugin
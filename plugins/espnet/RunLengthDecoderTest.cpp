@@ -27,10 +27,12 @@
 class RunLengthDecoderTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(RunLengthDecoderTest);
   CPPUNIT_TEST(testDecode);
+  CPPUNIT_TEST(testTruncated);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testDecode();
+    void testTruncated();
  private:
 };
 
@@ -56,3 +58,31 @@ void RunLengthDecoderTest::testDecode() {
   decoder.Decode(&buffer, data, sizeof(data));
   OLA_ASSERT(buffer == expected);
 }
+
+
+/*
+ * Check that codes at the end of the data, and runs past the end of the
+ * universe, are handled.
+ */
+void RunLengthDecoderTest::testTruncated() {
+  ola::plugin::espnet::RunLengthDecoder decoder;
+  ola::DmxBuffer buffer;
+
+  uint8_t truncated_repeat[] = {0x01, 0xFE, 0x5};
+  decoder.Decode(&buffer, truncated_repeat, sizeof(truncated_repeat));
+  OLA_ASSERT_EQ(ola::DmxBuffer(truncated_repeat, 1), buffer);
+
+  uint8_t truncated_escape[] = {0x01, 0x02, 0xFD};
+  decoder.Decode(&buffer, truncated_escape, sizeof(truncated_escape));
+  OLA_ASSERT_EQ(ola::DmxBuffer(truncated_escape, 2), buffer);
+
+  uint8_t long_frame[] = {0xFE, 0xFF, 0x1, 0xFE, 0xFF, 0x2, 0xFE, 0x10, 0x3};
+  decoder.Decode(&buffer, long_frame, sizeof(long_frame));
+  OLA_ASSERT_EQ(512u, buffer.Size());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), buffer.Get(254));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(2), buffer.Get(509));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(3), buffer.Get(511));
+
+  decoder.Decode(&buffer, long_frame, 0);
+  OLA_ASSERT_EQ(0u, buffer.Size());
+}
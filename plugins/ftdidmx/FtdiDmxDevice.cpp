@@ -25,7 +25,9 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include "ola/Logging.h"
+#include "ola/base/Array.h"
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
 #include "plugins/ftdidmx/FtdiDmxPort.h"
 
@@ -34,13 +36,25 @@ namespace plugin {
 namespace ftdidmx {
 
 using std::string;
+using std::vector;
+
+const char FtdiDmxDevice::K_FRAMES_VAR[] = "ftdidmx-frames";
+const char FtdiDmxDevice::K_LATE_FRAMES_VAR[] = "ftdidmx-late-frames";
+const char FtdiDmxDevice::K_JITTER_VAR[] = "ftdidmx-jitter-us";
+const char FtdiDmxDevice::K_MAX_JITTER_VAR[] = "ftdidmx-max-jitter-us";
+
+namespace {
+const char PORT_KEY[] = "port";
+}  // namespace
 
 FtdiDmxDevice::FtdiDmxDevice(AbstractPlugin *owner,
                              const FtdiWidgetInfo &widget_info,
-                             unsigned int frequency)
+                             unsigned int frequency,
+                             ola::thread::FrameScheduler *scheduler)
     : Device(owner, widget_info.Description()),
       m_widget_info(widget_info),
-      m_frequency(frequency) {
+      m_frequency(frequency),
+      m_scheduler(scheduler) {
   m_widget = new FtdiWidget(widget_info.Serial(),
                             widget_info.Name(),
                             widget_info.Id(),
@@ -64,7 +78,7 @@ bool FtdiDmxDevice::StartHook() {
     FtdiInterface *port = new FtdiInterface(m_widget,
                                             static_cast<ftdi_interface>(i));
     if (port->SetupOutput()) {
-      AddPort(new FtdiDmxOutputPort(this, port, i, m_frequency));
+      AddPort(new FtdiDmxOutputPort(this, port, i, m_frequency, m_scheduler));
       successfully_added += 1;
     } else {
       OLA_WARN << "Failed to add interface: " << i;
@@ -81,6 +95,43 @@ bool FtdiDmxDevice::StartHook() {
 
   return true;
 }
+
+
+void FtdiDmxDevice::ExportTimingStats(ExportMap *export_map) const {
+  UIntMap *frames = export_map->GetUIntMapVar(K_FRAMES_VAR, PORT_KEY);
+  UIntMap *late_frames = export_map->GetUIntMapVar(K_LATE_FRAMES_VAR,
+                                                   PORT_KEY);
+  UIntMap *jitter = export_map->GetUIntMapVar(K_JITTER_VAR, PORT_KEY);
+  UIntMap *max_jitter = export_map->GetUIntMapVar(K_MAX_JITTER_VAR, PORT_KEY);
+
+  vector<OutputPort*> ports;
+  OutputPorts(&ports);
+  vector<OutputPort*>::const_iterator iter = ports.begin();
+  for (; iter != ports.end(); ++iter) {
+    ola::thread::FrameTimerStats stats;
+    static_cast<FtdiDmxOutputPort*>(*iter)->GetTimingStats(&stats);
+    const string key = (*iter)->UniqueId();
+    (*frames)[key] = stats.frames;
+    (*late_frames)[key] = stats.late_frames;
+    (*jitter)[key] = stats.jitter_us;
+    (*max_jitter)[key] = stats.max_jitter_us;
+  }
+}
+
+
+void FtdiDmxDevice::RemoveTimingStats(ExportMap *export_map) const {
+  const char *vars[] = {K_FRAMES_VAR, K_LATE_FRAMES_VAR, K_JITTER_VAR,
+                        K_MAX_JITTER_VAR};
+  vector<OutputPort*> ports;
+  OutputPorts(&ports);
+  for (unsigned int i = 0; i < arraysize(vars); i++) {
+    UIntMap *var = export_map->GetUIntMapVar(vars[i], PORT_KEY);
+    vector<OutputPort*>::const_iterator iter = ports.begin();
+    for (; iter != ports.end(); ++iter) {
+      var->Remove((*iter)->UniqueId());
+    }
+  }
+}
 }  // namespace ftdidmx
 }  // namespace plugin
 }  // namespace ola
@@ -28,7 +28,9 @@
 
 #include <string>
 #include <memory>
+#include "common/thread/FrameScheduler.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiWidget.h"
@@ -41,13 +43,23 @@ class FtdiDmxDevice : public Device {
  public:
   FtdiDmxDevice(AbstractPlugin *owner,
                 const FtdiWidgetInfo &widget_info,
-                unsigned int frequency);
+                unsigned int frequency,
+                ola::thread::FrameScheduler *scheduler);
   ~FtdiDmxDevice();
 
   std::string DeviceId() const { return m_widget->Serial(); }
   std::string Description() const { return m_widget_info.Description(); }
   FtdiWidget* GetDevice() { return m_widget; }
 
+  // Copy the timing statistics of the output threads to the ExportMap.
+  void ExportTimingStats(ExportMap *export_map) const;
+  void RemoveTimingStats(ExportMap *export_map) const;
+
+  static const char K_FRAMES_VAR[];
+  static const char K_LATE_FRAMES_VAR[];
+  static const char K_JITTER_VAR[];
+  static const char K_MAX_JITTER_VAR[];
+
  protected:
   bool StartHook();
 
@@ -55,6 +67,7 @@ class FtdiDmxDevice : public Device {
   FtdiWidget *m_widget;
   const FtdiWidgetInfo m_widget_info;
   unsigned int m_frequency;
+  ola::thread::FrameScheduler *m_scheduler;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
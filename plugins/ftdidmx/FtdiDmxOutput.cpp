@@ -13,7 +13,7 @@
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  *
- * FtdiDmxThread.h
+ * FtdiDmxOutput.cpp
  * The FTDI usb chipset DMX plugin for ola
  * Copyright (C) 2011 Rui Barreiros
  *
@@ -23,43 +23,31 @@
  * by E.S. Rosenberg a.k.a. Keeper of the Keys 5774/2014
  */
 
-#ifndef PLUGINS_FTDIDMX_FTDIDMXTHREAD_H_
-#define PLUGINS_FTDIDMX_FTDIDMXTHREAD_H_
-
-#include "ola/DmxBuffer.h"
-#include "ola/thread/Thread.h"
+#include "plugins/ftdidmx/FtdiDmxOutput.h"
+#include "plugins/ftdidmx/FtdiWidget.h"
 
 namespace ola {
 namespace plugin {
 namespace ftdidmx {
 
-class FtdiDmxThread : public ola::thread::Thread {
- public:
-    FtdiDmxThread(FtdiInterface *interface, unsigned int frequency);
-    ~FtdiDmxThread();
-
-    bool Stop();
-    void *Run();
-    bool WriteDMX(const DmxBuffer &buffer);
+FtdiDmxOutput::FtdiDmxOutput(FtdiInterface *interface, unsigned int frequency)
+  : m_interface(interface),
+    m_period(ONE_MILLION / frequency) {
+  // Setup the interface
+  if (!m_interface->IsOpen()) {
+    m_interface->SetupOutput();
+  }
+}
 
- private:
-    enum TimerGranularity { UNKNOWN, GOOD, BAD };
 
-    TimerGranularity m_granularity;
-    FtdiInterface *m_interface;
-    bool m_term;
-    unsigned int m_frequency;
-    DmxBuffer m_buffer;
-    ola::thread::Mutex m_term_mutex;
-    ola::thread::Mutex m_buffer_mutex;
+bool FtdiDmxOutput::SetBreak(bool on) {
+  return m_interface->SetBreak(on);
+}
 
-    void CheckTimeGranularity();
 
-    static const uint32_t DMX_MAB = 16;
-    static const uint32_t DMX_BREAK = 110;
-    static const uint32_t BAD_GRANULARITY_LIMIT = 3;
-};
+bool FtdiDmxOutput::WriteFrame(const DmxBuffer &frame) {
+  return m_interface->Write(frame);
+}
 }  // namespace ftdidmx
 }  // namespace plugin
 }  // namespace ola
-#endif  // PLUGINS_FTDIDMX_FTDIDMXTHREAD_H_
@@ -0,0 +1,65 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * FtdiDmxOutput.h
+ * The FTDI usb chipset DMX plugin for ola
+ * Copyright (C) 2011 Rui Barreiros
+ *
+ * Additional modifications to enable support for multiple outputs and
+ * additional device ids did change the original structure.
+ *
+ * by E.S. Rosenberg a.k.a. Keeper of the Keys 5774/2014
+ */
+
+#ifndef PLUGINS_FTDIDMX_FTDIDMXOUTPUT_H_
+#define PLUGINS_FTDIDMX_FTDIDMXOUTPUT_H_
+
+#include "common/thread/FrameScheduler.h"
+#include "ola/DmxBuffer.h"
+#include "plugins/ftdidmx/FtdiWidget.h"
+
+namespace ola {
+namespace plugin {
+namespace ftdidmx {
+
+/**
+ * @brief Generates the DMX stream on an FTDI interface.
+ *
+ * The frames are sent by a FrameScheduler, which drives all the interfaces.
+ */
+class FtdiDmxOutput : public ola::thread::FrameOutput {
+ public:
+    FtdiDmxOutput(FtdiInterface *interface, unsigned int frequency);
+
+    unsigned int BreakTime() const { return DMX_BREAK; }
+    unsigned int MarkAfterBreakTime() const { return DMX_MAB; }
+    unsigned int FramePeriod(const DmxBuffer&) const { return m_period; }
+    bool SetBreak(bool on);
+    bool WriteFrame(const DmxBuffer &frame);
+
+ private:
+    FtdiInterface *m_interface;
+    const unsigned int m_period;
+
+    static const unsigned int DMX_MAB = 16;
+    static const unsigned int DMX_BREAK = 110;
+    static const unsigned int ONE_MILLION = 1000000;
+
+    DISALLOW_COPY_AND_ASSIGN(FtdiDmxOutput);
+};
+}  // namespace ftdidmx
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_FTDIDMX_FTDIDMXOUTPUT_H_
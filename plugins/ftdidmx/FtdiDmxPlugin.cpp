@@ -26,6 +26,8 @@
 #include <vector>
 #include <string>
 
+#include "ola/Callback.h"
+#include "ola/ExportMap.h"
 #include "ola/StringUtils.h"
 #include "olad/Preferences.h"
 #include "olad/PluginAdaptor.h"
@@ -73,9 +75,37 @@ bool FtdiDmxPlugin::StartHook() {
       m_preferences->GetValue(K_FREQUENCY),
       DEFAULT_FREQUENCY);
 
+  if (widgets.empty()) {
+    return true;
+  }
+
+  m_scheduler.reset(new ola::thread::FrameScheduler());
+  if (!m_scheduler->Start()) {
+    m_scheduler.reset();
+    return false;
+  }
+
   FtdiWidgetInfoVector::const_iterator iter;
   for (iter = widgets.begin(); iter != widgets.end(); ++iter) {
-    AddDevice(new FtdiDmxDevice(this, *iter, frequency));
+    AddDevice(new FtdiDmxDevice(this, *iter, frequency, m_scheduler.get()));
+  }
+
+  if (m_plugin_adaptor->GetExportMap()) {
+    m_stats_timeout = m_plugin_adaptor->RegisterRepeatingTimeout(
+        STATS_INTERVAL_MS,
+        NewCallback(this, &FtdiDmxPlugin::ExportTimingStats));
+  }
+  return true;
+}
+
+
+/**
+ * @brief Copy the timing statistics from the output threads to the ExportMap.
+ */
+bool FtdiDmxPlugin::ExportTimingStats() {
+  FtdiDeviceVector::iterator iter = m_devices.begin();
+  for (; iter != m_devices.end(); ++iter) {
+    (*iter)->ExportTimingStats(m_plugin_adaptor->GetExportMap());
   }
   return true;
 }
@@ -85,13 +115,27 @@ bool FtdiDmxPlugin::StartHook() {
  * @brief Stop all the devices.
  */
 bool FtdiDmxPlugin::StopHook() {
+  if (m_stats_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_plugin_adaptor->RemoveTimeout(m_stats_timeout);
+    m_stats_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  ExportMap *export_map = m_plugin_adaptor->GetExportMap();
   FtdiDeviceVector::iterator iter;
   for (iter = m_devices.begin(); iter != m_devices.end(); ++iter) {
+    if (export_map) {
+      (*iter)->RemoveTimingStats(export_map);
+    }
     m_plugin_adaptor->UnregisterDevice(*iter);
     (*iter)->Stop();
     delete (*iter);
   }
   m_devices.clear();
+
+  if (m_scheduler.get()) {
+    m_scheduler->Stop();
+    m_scheduler.reset();
+  }
   return true;
 }
 
@@ -22,11 +22,14 @@
 #define PLUGINS_FTDIDMX_FTDIDMXPLUGIN_H_
 
 #include <set>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "common/thread/FrameScheduler.h"
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
+#include "ola/thread/SchedulerInterface.h"
 
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
 
@@ -38,7 +41,8 @@ namespace ftdidmx {
 class FtdiDmxPlugin : public Plugin {
  public:
   explicit FtdiDmxPlugin(ola::PluginAdaptor *plugin_adaptor)
-      : Plugin(plugin_adaptor) {
+      : Plugin(plugin_adaptor),
+        m_stats_timeout(ola::thread::INVALID_TIMEOUT) {
   }
 
   ola_plugin_id Id() const { return OLA_PLUGIN_FTDIDMX; }
@@ -54,20 +58,26 @@ class FtdiDmxPlugin : public Plugin {
 
   std::string Description() const;
 
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
  private:
   typedef std::vector<FtdiDmxDevice*> FtdiDeviceVector;
   FtdiDeviceVector m_devices;
+  // Generates the DMX frames for all the ports.
+  std::auto_ptr<ola::thread::FrameScheduler> m_scheduler;
+  ola::thread::timeout_id m_stats_timeout;
 
   void AddDevice(FtdiDmxDevice *device);
+  bool ExportTimingStats();
   bool StartHook();
   bool StopHook();
   bool SetDefaultPreferences();
 
   static const uint8_t DEFAULT_FREQUENCY = 30;
+  static const unsigned int STATS_INTERVAL_MS = 1000;
 
   static const char K_FREQUENCY[];
-  static const char PLUGIN_NAME[];
-  static const char PLUGIN_PREFIX[];
 };
 }  // namespace ftdidmx
 }  // namespace plugin
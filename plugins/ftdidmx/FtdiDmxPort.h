@@ -28,12 +28,13 @@
 
 #include <string>
 
+#include "common/thread/FrameScheduler.h"
 #include "ola/DmxBuffer.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
 #include "plugins/ftdidmx/FtdiWidget.h"
-#include "plugins/ftdidmx/FtdiDmxThread.h"
+#include "plugins/ftdidmx/FtdiDmxOutput.h"
 
 namespace ola {
 namespace plugin {
@@ -44,26 +45,34 @@ class FtdiDmxOutputPort : public ola::BasicOutputPort {
     FtdiDmxOutputPort(FtdiDmxDevice *parent,
                       FtdiInterface *interface,
                       unsigned int id,
-                      unsigned int freq)
+                      unsigned int freq,
+                      ola::thread::FrameScheduler *scheduler)
         : BasicOutputPort(parent, id),
           m_interface(interface),
-          m_thread(interface, freq) {
-      m_thread.Start();
+          m_output(interface, freq),
+          m_scheduler(scheduler) {
+      m_scheduler->AddOutput(&m_output);
     }
     ~FtdiDmxOutputPort() {
-      m_thread.Stop();
+      m_scheduler->RemoveOutput(&m_output);
       delete m_interface;
     }
 
     bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t) {
-      return m_thread.WriteDMX(buffer);
+      m_output.SetFrame(buffer);
+      return true;
     }
 
     std::string Description() const { return m_interface->Description(); }
 
+    void GetTimingStats(ola::thread::FrameTimerStats *stats) const {
+      m_output.GetStats(stats);
+    }
+
  private:
     FtdiInterface *m_interface;
-    FtdiDmxThread m_thread;
+    FtdiDmxOutput m_output;
+    ola::thread::FrameScheduler *m_scheduler;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
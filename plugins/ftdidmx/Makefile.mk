@@ -13,11 +13,11 @@ plugins/ftdidmx/FtdiDmxPluginDescription.h: plugins/ftdidmx/README.md plugins/ft
 plugins_ftdidmx_libolaftdidmx_la_SOURCES = \
     plugins/ftdidmx/FtdiDmxDevice.cpp \
     plugins/ftdidmx/FtdiDmxDevice.h \
+    plugins/ftdidmx/FtdiDmxOutput.cpp \
+    plugins/ftdidmx/FtdiDmxOutput.h \
     plugins/ftdidmx/FtdiDmxPlugin.cpp \
     plugins/ftdidmx/FtdiDmxPlugin.h \
     plugins/ftdidmx/FtdiDmxPort.h \
-    plugins/ftdidmx/FtdiDmxThread.cpp \
-    plugins/ftdidmx/FtdiDmxThread.h \
     plugins/ftdidmx/FtdiWidget.cpp \
     plugins/ftdidmx/FtdiWidget.h
 plugins_ftdidmx_libolaftdidmx_la_LIBADD = \
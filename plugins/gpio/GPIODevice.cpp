@@ -31,18 +31,34 @@ namespace gpio {
  * Create a new device
  */
 GPIODevice::GPIODevice(GPIOPlugin *owner,
-                       const GPIODriver::Options &options)
+                       PluginAdaptor *plugin_adaptor,
+                       const GPIODriver::Options &options,
+                       const GPIOInput::Options &input_options)
     : Device(owner, "General Purpose I/O Device"),
-      m_options(options) {
+      m_plugin_adaptor(plugin_adaptor),
+      m_options(options),
+      m_input_options(input_options) {
 }
 
 bool GPIODevice::StartHook() {
-  GPIOOutputPort *port = new GPIOOutputPort(this, m_options);
-  if (!port->Init()) {
-    delete port;
-    return false;
+  if (!m_options.gpio_pins.empty()) {
+    GPIOOutputPort *port = new GPIOOutputPort(this, m_options);
+    if (!port->Init()) {
+      delete port;
+      return false;
+    }
+    AddPort(port);
+  }
+
+  if (!m_input_options.gpio_pins.empty()) {
+    GPIOInputPort *port = new GPIOInputPort(this, m_plugin_adaptor,
+                                            m_input_options);
+    if (!port->Init()) {
+      delete port;
+      return false;
+    }
+    AddPort(port);
   }
-  AddPort(port);
   return true;
 }
 }  // namespace gpio
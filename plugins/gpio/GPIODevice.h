@@ -27,6 +27,7 @@
 
 #include "olad/Device.h"
 #include "plugins/gpio/GPIODriver.h"
+#include "plugins/gpio/GPIOInput.h"
 
 namespace ola {
 namespace plugin {
@@ -40,10 +41,14 @@ class GPIODevice: public ola::Device {
   /**
    * @brief Create a new GPIODevice.
    * @param owner The Plugin that owns this device.
-   * @param options the options to use for the new device.
+   * @param plugin_adaptor the PluginAdaptor to use for the input port.
+   * @param options the options to use for the output port.
+   * @param input_options the options to use for the input port.
    */
   GPIODevice(class GPIOPlugin *owner,
-             const GPIODriver::Options &options);
+             class PluginAdaptor *plugin_adaptor,
+             const GPIODriver::Options &options,
+             const GPIOInput::Options &input_options);
 
   std::string DeviceId() const { return "1"; }
 
@@ -51,7 +56,9 @@ class GPIODevice: public ola::Device {
   bool StartHook();
 
  private:
+  class PluginAdaptor *m_plugin_adaptor;
   const GPIODriver::Options m_options;
+  const GPIOInput::Options m_input_options;
 
   DISALLOW_COPY_AND_ASSIGN(GPIODevice);
 };
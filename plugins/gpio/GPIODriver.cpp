@@ -35,6 +35,8 @@
 #include "ola/io/IOUtils.h"
 #include "ola/Logging.h"
 #include "ola/thread/Mutex.h"
+#include "ola/thread/ThreadSettings.h"
+#include "plugins/gpio/GPIOLines.h"
 
 namespace ola {
 namespace plugin {
@@ -47,7 +49,10 @@ using std::string;
 using std::vector;
 
 GPIODriver::GPIODriver(const Options &options)
-    : m_options(options),
+    : ola::thread::Thread(ola::thread::Thread::Options(
+          "gpio", ola::thread::THREAD_CLASS_OUTPUT)),
+      m_options(options),
+      m_line_fd(-1),
       m_term(false),
       m_dmx_changed(false) {
 }
@@ -116,6 +121,10 @@ void *GPIODriver::Run() {
 }
 
 bool GPIODriver::SetupGPIO() {
+  if (!m_options.gpio_chip.empty()) {
+    return SetupGPIOChip();
+  }
+
   /**
    * This relies on the pins being exported:
    *   echo N > /sys/class/gpio/export
@@ -160,6 +169,23 @@ bool GPIODriver::SetupGPIO() {
   return true;
 }
 
+bool GPIODriver::SetupGPIOChip() {
+  if (!RequestGPIOLines(m_options.gpio_chip, m_options.gpio_pins, true,
+                        &m_line_fd)) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < m_options.gpio_pins.size(); i++) {
+    GPIOPin pin = {-1, UNDEFINED, false};
+    m_gpio_pins.push_back(pin);
+  }
+  return true;
+}
+
+/*
+ * Only the pins which change are written. With the GPIO character device
+ * they're all set with a single call.
+ */
 bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
   enum Action {
     TURN_ON,
@@ -167,6 +193,9 @@ bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
     NO_CHANGE,
   };
 
+  uint64_t values = 0;
+  uint64_t mask = 0;
+
   for (uint16_t i = 0;
        i < m_gpio_pins.size() && (i + m_options.start_address < dmx.Size());
        i++) {
@@ -187,8 +216,16 @@ bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
         action = (slot_value >= m_options.turn_on ? TURN_ON : TURN_OFF);
     }
 
-    // Change the pin state if required.
-    if (action != NO_CHANGE) {
+    if (action == NO_CHANGE) {
+      continue;
+    }
+
+    if (m_line_fd >= 0) {
+      mask |= static_cast<uint64_t>(1) << i;
+      if (action == TURN_ON) {
+        values |= static_cast<uint64_t>(1) << i;
+      }
+    } else {
       char data = (action == TURN_ON ? '1' : '0');
       if (write(m_gpio_pins[i].fd, &data, sizeof(data)) < 0) {
         OLA_WARN << "Failed to toggle GPIO pin " << i << ", fd "
@@ -199,15 +236,34 @@ bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
       m_gpio_pins[i].state = (action == TURN_ON ? ON : OFF);
     }
   }
+
+  if (mask) {
+    if (!SetGPIOLines(m_line_fd, values, mask)) {
+      return false;
+    }
+    for (uint16_t i = 0; i < m_gpio_pins.size(); i++) {
+      if (mask & (static_cast<uint64_t>(1) << i)) {
+        m_gpio_pins[i].state = (values & (static_cast<uint64_t>(1) << i)) ?
+            ON : OFF;
+      }
+    }
+  }
   return true;
 }
 
 void GPIODriver::CloseGPIOFDs() {
   GPIOPins::iterator iter = m_gpio_pins.begin();
   for (; iter != m_gpio_pins.end(); ++iter) {
-    close(iter->fd);
+    if (iter->fd >= 0) {
+      close(iter->fd);
+    }
   }
   m_gpio_pins.clear();
+
+  if (m_line_fd >= 0) {
+    close(m_line_fd);
+    m_line_fd = -1;
+  }
 }
 }  // namespace gpio
 }  // namespace plugin
@@ -26,6 +26,7 @@
 #include <ola/base/Macro.h>
 #include <ola/thread/Thread.h>
 
+#include <string>
 #include <vector>
 
 namespace ola {
@@ -63,6 +64,15 @@ class GPIODriver : private ola::thread::Thread {
      * @brief The value below which a pin will be turned off.
      */
     uint8_t turn_off;
+
+    /**
+     * @brief The GPIO character device to use, e.g. /dev/gpiochip0.
+     *
+     * If set, the gpio_pins are line offsets on this chip and all the pins
+     * that change are set with a single call. If empty, the pins are
+     * controlled through sysfs.
+     */
+    std::string gpio_chip;
   };
 
   /**
@@ -114,6 +124,8 @@ class GPIODriver : private ola::thread::Thread {
 
   const Options m_options;
   GPIOPins m_gpio_pins;
+  // The lines from the GPIO character device, if we're using it.
+  int m_line_fd;
 
   DmxBuffer m_buffer;
   bool m_term;  // GUARDED_BY(m_mutex);
@@ -122,6 +134,7 @@ class GPIODriver : private ola::thread::Thread {
   ola::thread::ConditionVariable m_cond;
 
   bool SetupGPIO();
+  bool SetupGPIOChip();
   bool UpdateGPIOPins(const DmxBuffer &dmx);
   void CloseGPIOFDs();
 
@@ -0,0 +1,108 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * GPIOInput.cpp
+ * Converts the state of GPIO input pins to DMX.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "plugins/gpio/GPIOInput.h"
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "plugins/gpio/GPIOLines.h"
+
+namespace ola {
+namespace plugin {
+namespace gpio {
+
+GPIOInput::GPIOInput(ola::io::SelectServerInterface *ss,
+                     const Options &options,
+                     Callback0<void> *on_change)
+    : m_ss(ss),
+      m_options(options),
+      m_on_change(on_change) {
+}
+
+GPIOInput::~GPIOInput() {
+  if (m_descriptor.get()) {
+    m_ss->RemoveReadDescriptor(m_descriptor.get());
+    close(m_descriptor->ReadDescriptor());
+  }
+}
+
+bool GPIOInput::Init() {
+  int fd;
+  if (!RequestGPIOLines(m_options.gpio_chip, m_options.gpio_pins, false,
+                        &fd)) {
+    return false;
+  }
+
+  m_descriptor.reset(new ola::io::UnmanagedFileDescriptor(fd));
+  m_descriptor->SetOnData(NewCallback(this, &GPIOInput::EdgeEvent));
+  m_ss->AddReadDescriptor(m_descriptor.get());
+
+  // Size the buffer so it covers all the pins, then read the initial state.
+  const unsigned int slots = m_options.start_address - 1 +
+                             m_options.gpio_pins.size();
+  m_buffer.SetRangeToValue(
+      0, DMX_MIN_SLOT_VALUE,
+      std::min(slots, static_cast<unsigned int>(DMX_UNIVERSE_SIZE)));
+  UpdateBuffer();
+  return true;
+}
+
+void GPIOInput::EdgeEvent() {
+  // The events only tell us something changed, the values are read in one go.
+  if (DrainGPIOEvents(m_descriptor->ReadDescriptor()) && UpdateBuffer() &&
+      m_on_change.get()) {
+    m_on_change->Run();
+  }
+}
+
+/*
+ * Read all the pins, and return true if the DMX data changed.
+ */
+bool GPIOInput::UpdateBuffer() {
+  uint64_t values;
+  if (!GetGPIOLines(m_descriptor->ReadDescriptor(),
+                    m_options.gpio_pins.size(), &values)) {
+    return false;
+  }
+
+  bool changed = false;
+  for (unsigned int i = 0; i < m_options.gpio_pins.size(); i++) {
+    const unsigned int slot = m_options.start_address - 1 + i;
+    if (slot >= DMX_UNIVERSE_SIZE) {
+      break;
+    }
+    const uint8_t value = (values & (static_cast<uint64_t>(1) << i)) ?
+        DMX_MAX_SLOT_VALUE : DMX_MIN_SLOT_VALUE;
+    if (m_buffer.Get(slot) != value) {
+      m_buffer.SetChannel(slot, value);
+      changed = true;
+    }
+  }
+  return changed;
+}
+}  // namespace gpio
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,118 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * GPIOInput.h
+ * Converts the state of GPIO input pins to DMX.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_GPIO_GPIOINPUT_H_
+#define PLUGINS_GPIO_GPIOINPUT_H_
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+#include <ola/io/SelectServerInterface.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace plugin {
+namespace gpio {
+
+/**
+ * @brief Maps GPIO input pins to DMX slots.
+ *
+ * The pins are requested from the GPIO character device with edge detection,
+ * and the single file descriptor for them is registered with the
+ * SelectServer. Nothing is polled; when an edge occurs all the pins are read
+ * with one call.
+ */
+class GPIOInput {
+ public:
+  /**
+   * @brief The Options.
+   */
+  struct Options {
+   public:
+    Options(): start_address(1) {}
+
+    /**
+     * @brief The GPIO character device, e.g. /dev/gpiochip0.
+     */
+    std::string gpio_chip;
+
+    /**
+     * @brief The line offsets of the input pins.
+     */
+    std::vector<uint16_t> gpio_pins;
+
+    /**
+     * @brief The DMX512 slot of the first pin.
+     */
+    uint16_t start_address;
+  };
+
+  /**
+   * @brief Create a new GPIOInput.
+   * @param ss the SelectServer to register the pins with.
+   * @param options the Options.
+   * @param on_change run when the DMX data changes, ownership is transferred.
+   */
+  GPIOInput(ola::io::SelectServerInterface *ss,
+            const Options &options,
+            Callback0<void> *on_change);
+
+  /**
+   * @brief Destructor.
+   */
+  ~GPIOInput();
+
+  /**
+   * @brief Request the pins and read their initial state.
+   * @returns true is successful, false otherwise.
+   */
+  bool Init();
+
+  /**
+   * @brief Get a list of the GPIO pins used.
+   */
+  std::vector<uint16_t> PinList() const { return m_options.gpio_pins; }
+
+  /**
+   * @brief The DMX data, a high pin is 255 and a low pin is 0.
+   */
+  const DmxBuffer &Data() const { return m_buffer; }
+
+ private:
+  ola::io::SelectServerInterface *m_ss;
+  const Options m_options;
+  std::auto_ptr<Callback0<void> > m_on_change;
+  std::auto_ptr<ola::io::UnmanagedFileDescriptor> m_descriptor;
+  DmxBuffer m_buffer;
+
+  void EdgeEvent();
+  bool UpdateBuffer();
+
+  DISALLOW_COPY_AND_ASSIGN(GPIOInput);
+};
+}  // namespace gpio
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_GPIO_GPIOINPUT_H_
@@ -0,0 +1,146 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * GPIOLines.cpp
+ * Requests and sets lines through the GPIO character device.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * This uses the v2 uAPI (Linux 5.10), which lets a single file descriptor
+ * set, get and report edges for many lines.
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#ifdef HAVE_LINUX_GPIO_H
+#include <linux/gpio.h>
+#endif  // HAVE_LINUX_GPIO_H
+
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/io/IOUtils.h"
+#include "ola/network/SocketCloser.h"
+#include "plugins/gpio/GPIOLines.h"
+
+#if defined(HAVE_LINUX_GPIO_H) && defined(GPIO_V2_GET_LINE_IOCTL)
+#define OLA_GPIO_V2_LINES 1
+#endif  // HAVE_LINUX_GPIO_H && GPIO_V2_GET_LINE_IOCTL
+
+namespace ola {
+namespace plugin {
+namespace gpio {
+
+using std::string;
+using std::vector;
+
+#ifdef OLA_GPIO_V2_LINES
+bool RequestGPIOLines(const string &chip, const vector<uint16_t> &offsets,
+                      bool output, int *fd) {
+  if (offsets.size() > MAX_GPIO_LINES) {
+    OLA_WARN << "At most " << MAX_GPIO_LINES << " lines can be used with "
+             << chip;
+    return false;
+  }
+
+  int chip_fd;
+  if (!ola::io::Open(chip, O_RDWR, &chip_fd)) {
+    return false;
+  }
+  ola::network::SocketCloser closer(chip_fd);
+
+  struct gpio_v2_line_request request;
+  memset(&request, 0, sizeof(request));
+  for (unsigned int i = 0; i < offsets.size(); i++) {
+    request.offsets[i] = offsets[i];
+  }
+  request.num_lines = offsets.size();
+  request.config.flags = output ? GPIO_V2_LINE_FLAG_OUTPUT :
+      (GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING |
+       GPIO_V2_LINE_FLAG_EDGE_FALLING);
+  strncpy(request.consumer, "olad", sizeof(request.consumer) - 1);
+
+  if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &request) < 0) {
+    OLA_WARN << "Failed to request lines from " << chip << ": "
+             << strerror(errno);
+    return false;
+  }
+  *fd = request.fd;
+  return true;
+}
+
+bool SetGPIOLines(int fd, uint64_t values, uint64_t mask) {
+  struct gpio_v2_line_values line_values;
+  line_values.bits = values;
+  line_values.mask = mask;
+  if (ioctl(fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &line_values) < 0) {
+    OLA_WARN << "Failed to set GPIO lines: " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool GetGPIOLines(int fd, unsigned int line_count, uint64_t *values) {
+  struct gpio_v2_line_values line_values;
+  line_values.bits = 0;
+  line_values.mask = line_count >= MAX_GPIO_LINES ?
+      ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << line_count) - 1;
+  if (ioctl(fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &line_values) < 0) {
+    OLA_WARN << "Failed to get GPIO lines: " << strerror(errno);
+    return false;
+  }
+  *values = line_values.bits;
+  return true;
+}
+
+unsigned int DrainGPIOEvents(int fd) {
+  struct gpio_v2_line_event events[16];
+  ssize_t r = read(fd, events, sizeof(events));
+  if (r < 0) {
+    OLA_WARN << "Failed to read GPIO events: " << strerror(errno);
+    return 0;
+  }
+  return r / sizeof(events[0]);
+}
+#else
+bool RequestGPIOLines(const string &chip, const vector<uint16_t>&, bool,
+                      int*) {
+  OLA_WARN << "GPIO character devices aren't supported, can't use " << chip;
+  return false;
+}
+
+bool SetGPIOLines(int, uint64_t, uint64_t) {
+  return false;
+}
+
+bool GetGPIOLines(int, unsigned int, uint64_t*) {
+  return false;
+}
+
+unsigned int DrainGPIOEvents(int) {
+  return 0;
+}
+#endif  // OLA_GPIO_V2_LINES
+}  // namespace gpio
+}  // namespace plugin
+}  // namespace ola
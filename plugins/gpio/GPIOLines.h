@@ -0,0 +1,76 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * GPIOLines.h
+ * Requests and sets lines through the GPIO character device.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_GPIO_GPIOLINES_H_
+#define PLUGINS_GPIO_GPIOLINES_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace plugin {
+namespace gpio {
+
+/**
+ * @brief The maximum number of lines in a single request.
+ */
+const unsigned int MAX_GPIO_LINES = 64;
+
+/**
+ * @brief Request lines from a GPIO character device.
+ * @param chip the path to the chip, e.g. /dev/gpiochip0.
+ * @param offsets the line offsets on the chip, at most MAX_GPIO_LINES.
+ * @param output true to request outputs, false to request inputs which
+ *   generate an event on both edges.
+ * @param[out] fd the file descriptor for the lines.
+ * @returns true if the lines were requested, false otherwise.
+ */
+bool RequestGPIOLines(const std::string &chip,
+                      const std::vector<uint16_t> &offsets,
+                      bool output,
+                      int *fd);
+
+/**
+ * @brief Set the value of some of the lines with a single call.
+ * @param fd the file descriptor from RequestGPIOLines().
+ * @param values a bitmask of the values, bit n is the nth line requested.
+ * @param mask a bitmask of the lines to set.
+ */
+bool SetGPIOLines(int fd, uint64_t values, uint64_t mask);
+
+/**
+ * @brief Get the values of the lines with a single call.
+ * @param fd the file descriptor from RequestGPIOLines().
+ * @param line_count the number of lines requested.
+ * @param[out] values a bitmask of the values, bit n is the nth line requested.
+ */
+bool GetGPIOLines(int fd, unsigned int line_count, uint64_t *values);
+
+/**
+ * @brief Read and discard the pending edge events.
+ * @param fd the file descriptor from RequestGPIOLines().
+ * @returns the number of events read.
+ */
+unsigned int DrainGPIOEvents(int fd);
+}  // namespace gpio
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_GPIO_GPIOLINES_H_
@@ -28,6 +28,7 @@
 #include "ola/StringUtils.h"
 #include "plugins/gpio/GPIODevice.h"
 #include "plugins/gpio/GPIODriver.h"
+#include "plugins/gpio/GPIOInput.h"
 #include "plugins/gpio/GPIOPluginDescription.h"
 
 namespace ola {
@@ -38,6 +39,8 @@ using std::auto_ptr;
 using std::string;
 using std::vector;
 
+const char GPIOPlugin::GPIO_CHIP_KEY[] = "gpio_chip";
+const char GPIOPlugin::GPIO_INPUT_PINS_KEY[] = "gpio_input_pins";
 const char GPIOPlugin::GPIO_PINS_KEY[] = "gpio_pins";
 const char GPIOPlugin::GPIO_SLOT_OFFSET_KEY[] = "gpio_slot_offset";
 const char GPIOPlugin::GPIO_TURN_OFF_KEY[] = "gpio_turn_off";
@@ -71,27 +74,27 @@ bool GPIOPlugin::StartHook() {
     return false;
   }
 
-  vector<string> pin_list;
-  StringSplit(m_preferences->GetValue(GPIO_PINS_KEY), &pin_list, ",");
-  vector<string>::const_iterator iter = pin_list.begin();
-  for (; iter != pin_list.end(); ++iter) {
-    if (iter->empty()) {
-      continue;
-    }
+  GPIOInput::Options input_options;
+  input_options.start_address = options.start_address;
+  options.gpio_chip = m_preferences->GetValue(GPIO_CHIP_KEY);
+  input_options.gpio_chip = options.gpio_chip;
 
-    uint16_t pin;
-    if (!StringToInt(*iter, &pin)) {
-      OLA_WARN << "Invalid value for GPIO pin: " << *iter;
-      return false;
-    }
-    options.gpio_pins.push_back(pin);
+  if (!(ReadPinList(GPIO_PINS_KEY, &options.gpio_pins) &&
+        ReadPinList(GPIO_INPUT_PINS_KEY, &input_options.gpio_pins))) {
+    return false;
   }
 
-  if (options.gpio_pins.empty()) {
+  if (!input_options.gpio_pins.empty() && input_options.gpio_chip.empty()) {
+    OLA_WARN << GPIO_INPUT_PINS_KEY << " requires " << GPIO_CHIP_KEY;
+    input_options.gpio_pins.clear();
+  }
+
+  if (options.gpio_pins.empty() && input_options.gpio_pins.empty()) {
     return true;
   }
 
-  std::auto_ptr<GPIODevice> device(new GPIODevice(this, options));
+  std::auto_ptr<GPIODevice> device(
+      new GPIODevice(this, m_plugin_adaptor, options, input_options));
   if (!device->Start()) {
     return false;
   }
@@ -111,6 +114,25 @@ bool GPIOPlugin::StopHook() {
   return true;
 }
 
+bool GPIOPlugin::ReadPinList(const char *key, vector<uint16_t> *pins) {
+  vector<string> pin_list;
+  StringSplit(m_preferences->GetValue(key), &pin_list, ",");
+  vector<string>::const_iterator iter = pin_list.begin();
+  for (; iter != pin_list.end(); ++iter) {
+    if (iter->empty()) {
+      continue;
+    }
+
+    uint16_t pin;
+    if (!StringToInt(*iter, &pin)) {
+      OLA_WARN << "Invalid value for GPIO pin: " << *iter;
+      return false;
+    }
+    pins->push_back(pin);
+  }
+  return true;
+}
+
 string GPIOPlugin::Description() const {
   return plugin_description;
 }
@@ -124,6 +146,12 @@ bool GPIOPlugin::SetDefaultPreferences() {
   save |= m_preferences->SetDefaultValue(GPIO_PINS_KEY,
                                          StringValidator(),
                                          "");
+  save |= m_preferences->SetDefaultValue(GPIO_INPUT_PINS_KEY,
+                                         StringValidator(true),
+                                         "");
+  save |= m_preferences->SetDefaultValue(GPIO_CHIP_KEY,
+                                         StringValidator(true),
+                                         "");
   save |= m_preferences->SetDefaultValue(GPIO_SLOT_OFFSET_KEY,
                                          UIntValidator(1, DMX_UNIVERSE_SIZE),
                                          "1");
@@ -22,6 +22,7 @@
 #define PLUGINS_GPIO_GPIOPLUGIN_H_
 
 #include <string>
+#include <vector>
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
 
@@ -47,19 +48,23 @@ class GPIOPlugin: public ola::Plugin {
   ola_plugin_id Id() const { return OLA_PLUGIN_GPIO; }
   std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
  private:
   class GPIODevice *m_device;
 
   bool StartHook();
   bool StopHook();
   bool SetDefaultPreferences();
+  bool ReadPinList(const char *key, std::vector<uint16_t> *pins);
 
+  static const char GPIO_CHIP_KEY[];
+  static const char GPIO_INPUT_PINS_KEY[];
   static const char GPIO_PINS_KEY[];
   static const char GPIO_SLOT_OFFSET_KEY[];
   static const char GPIO_TURN_OFF_KEY[];
   static const char GPIO_TURN_ON_KEY[];
-  static const char PLUGIN_NAME[];
-  static const char PLUGIN_PREFIX[];
 
   DISALLOW_COPY_AND_ASSIGN(GPIOPlugin);
 };
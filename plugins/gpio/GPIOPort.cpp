@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "ola/StringUtils.h"
+#include "olad/PluginAdaptor.h"
 #include "plugins/gpio/GPIODriver.h"
 
 namespace ola {
@@ -53,6 +54,24 @@ bool GPIOOutputPort::WriteDMX(const DmxBuffer &buffer,
                               OLA_UNUSED uint8_t priority) {
   return m_driver->SendDmx(buffer);
 }
+
+GPIOInputPort::GPIOInputPort(GPIODevice *parent,
+                             PluginAdaptor *plugin_adaptor,
+                             const GPIOInput::Options &options)
+    : BasicInputPort(parent, 1, plugin_adaptor),
+      m_input(plugin_adaptor, options,
+              NewCallback(static_cast<BasicInputPort*>(this),
+                          &BasicInputPort::DmxChanged)) {
+}
+
+bool GPIOInputPort::Init() {
+  return m_input.Init();
+}
+
+string GPIOInputPort::Description() const {
+  vector<uint16_t> pins = m_input.PinList();
+  return "Pins " + ola::StringJoin(", ", pins);
+}
 }  // namespace gpio
 }  // namespace plugin
 }  // namespace ola
@@ -26,6 +26,7 @@
 #include "olad/Port.h"
 #include "plugins/gpio/GPIODevice.h"
 #include "plugins/gpio/GPIODriver.h"
+#include "plugins/gpio/GPIOInput.h"
 
 namespace ola {
 namespace plugin {
@@ -64,6 +65,43 @@ class GPIOOutputPort: public BasicOutputPort {
 
   DISALLOW_COPY_AND_ASSIGN(GPIOOutputPort);
 };
+
+
+/**
+ * @brief The GPIO Input port.
+ */
+class GPIOInputPort: public BasicInputPort {
+ public:
+  /**
+   * @brief Create a new GPIOInputPort.
+   * @param parent The parent device.
+   * @param plugin_adaptor the PluginAdaptor to register the pins with.
+   * @param options the Options for the GPIOInput.
+   */
+  GPIOInputPort(GPIODevice *parent,
+                class PluginAdaptor *plugin_adaptor,
+                const GPIOInput::Options &options);
+
+  /**
+   * @brief Destructor.
+   */
+  ~GPIOInputPort() {}
+
+  /**
+   * @brief Initialize the port.
+   * @returns true if successful, false otherwise.
+   */
+  bool Init();
+
+  std::string Description() const;
+
+  const DmxBuffer &ReadDMX() const { return m_input.Data(); }
+
+ private:
+  GPIOInput m_input;
+
+  DISALLOW_COPY_AND_ASSIGN(GPIOInputPort);
+};
 }  // namespace gpio
 }  // namespace plugin
 }  // namespace ola
@@ -7,7 +7,11 @@ lib_LTLIBRARIES += plugins/gpio/libolagpiocore.la \
 # This is a library which isn't coupled to olad
 plugins_gpio_libolagpiocore_la_SOURCES = \
     plugins/gpio/GPIODriver.cpp \
-    plugins/gpio/GPIODriver.h
+    plugins/gpio/GPIODriver.h \
+    plugins/gpio/GPIOInput.cpp \
+    plugins/gpio/GPIOInput.h \
+    plugins/gpio/GPIOLines.cpp \
+    plugins/gpio/GPIOLines.h
 plugins_gpio_libolagpiocore_la_LIBADD = common/libolacommon.la
 
 # Plugin description is generated from README.md
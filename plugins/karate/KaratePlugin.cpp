@@ -48,6 +48,7 @@ const char KaratePlugin::KARATE_DEVICE_NAME[] = "KarateLight Device";
 const char KaratePlugin::PLUGIN_NAME[] = "KarateLight";
 const char KaratePlugin::PLUGIN_PREFIX[] = "karate";
 const char KaratePlugin::DEVICE_KEY[] = "device";
+const char KaratePlugin::SEND_ON_CHANGE_KEY[] = "send_on_change";
 
 /**
  * @brief Start the plugin
@@ -55,6 +56,8 @@ const char KaratePlugin::DEVICE_KEY[] = "device";
 bool KaratePlugin::StartHook() {
   vector<string> devices = m_preferences->GetMultipleValue(DEVICE_KEY);
   vector<string>::const_iterator iter = devices.begin();
+  const bool send_on_change = m_preferences->GetValueAsBool(
+      SEND_ON_CHANGE_KEY);
 
   // start counting device ids from 0
   unsigned int device_id = 0;
@@ -68,7 +71,8 @@ bool KaratePlugin::StartHook() {
           this,
           KARATE_DEVICE_NAME,
           *iter,
-          device_id++);
+          device_id++,
+          send_on_change);
       if (device->Start()) {
         m_devices.push_back(device);
         m_plugin_adaptor->RegisterDevice(device);
@@ -117,8 +121,11 @@ bool KaratePlugin::SetDefaultPreferences() {
     return false;
   }
 
-  if (m_preferences->SetDefaultValue(DEVICE_KEY, StringValidator(),
-                                     KARATE_DEVICE_PATH)) {
+  bool save = m_preferences->SetDefaultValue(DEVICE_KEY, StringValidator(),
+                                             KARATE_DEVICE_PATH);
+  save |= m_preferences->SetDefaultValue(SEND_ON_CHANGE_KEY, BoolValidator(),
+                                         false);
+  if (save) {
     m_preferences->Save();
   }
 
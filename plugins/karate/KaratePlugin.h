@@ -43,6 +43,9 @@ class KaratePlugin: public Plugin {
     ola_plugin_id Id() const { return OLA_PLUGIN_KARATE; }
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
@@ -51,11 +54,10 @@ class KaratePlugin: public Plugin {
     typedef std::vector<KarateDevice*> DeviceList;
     DeviceList m_devices;
 
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
     static const char KARATE_DEVICE_PATH[];
     static const char KARATE_DEVICE_NAME[];
     static const char DEVICE_KEY[];
+    static const char SEND_ON_CHANGE_KEY[];
 };
 }  // namespace karate
 }  // namespace plugin
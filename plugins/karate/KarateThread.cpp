@@ -32,9 +32,10 @@
 #include <unistd.h>
 #include <string>
 
-#include "ola/Clock.h"
+#include "common/thread/FrameTimer.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
+#include "ola/thread/ThreadSettings.h"
 #include "plugins/karate/KarateLight.h"
 #include "plugins/karate/KarateThread.h"
 
@@ -42,17 +43,17 @@ namespace ola {
 namespace plugin {
 namespace karate {
 
-using ola::thread::Mutex;
-using ola::thread::MutexLocker;
+using ola::thread::FrameTimer;
 using std::string;
 
 /**
  * @brief Create a new KarateThread object
  */
-KarateThread::KarateThread(const string &path)
-    : ola::thread::Thread(),
+KarateThread::KarateThread(const string &path, bool send_on_change)
+    : ola::thread::Thread(ola::thread::Thread::Options(
+          "karate", ola::thread::THREAD_CLASS_OUTPUT)),
       m_path(path),
-      m_term(false) {
+      m_send_on_change(send_on_change) {
 }
 
 
@@ -60,46 +61,40 @@ KarateThread::KarateThread(const string &path)
  * @brief Run this thread
  */
 void *KarateThread::Run() {
-  bool write_success;
-  Clock clock;
+  FrameTimer timer;
+  // true if the next frame should be written even if it hasn't changed
+  bool resend = true;
 
   KarateLight k(m_path);
   k.Init();
+  timer.StartFrame();
 
   while (true) {
-    {
-      MutexLocker lock(&m_term_mutex);
-      if (m_term)
-        break;
-    }
-
     if (!k.IsActive()) {
       // try to reopen the device...
-      TimeStamp wake_up;
-      clock.CurrentTime(&wake_up);
-      wake_up += TimeInterval(2, 0);
-
-      // wait for either a signal that we should terminate, or ts seconds
-      m_term_mutex.Lock();
-      if (m_term)
+      if (!WaitToReopen()) {
         break;
-      m_term_cond.TimedWait(&m_term_mutex, wake_up);
-      m_term_mutex.Unlock();
-
+      }
       OLA_WARN << "Re-Initialising device " << m_path;
       k.Init();
+      resend = true;
+      continue;
+    }
 
-    } else {
-      {
-        MutexLocker locker(&m_mutex);
-        write_success = k.SetColors(m_buffer);
-      }
-      if (!write_success) {
-        OLA_WARN << "Failed to write color data";
-      }  else {
-        usleep(20000);  // 50Hz
-      }
-    }  // port is okay
+    const DmxBuffer *frame;
+    bool changed;
+    const unsigned int timeout = m_send_on_change && !resend ?
+        KEEPALIVE_US : 0;
+    if (!m_handoff.WaitForFrame(timeout, &frame, &changed)) {
+      break;
+    }
+    resend = false;
+
+    if (!k.SetColors(*frame)) {
+      OLA_WARN << "Failed to write color data";
+      resend = true;
+    }
+    timer.StartNextFrame(FRAME_PERIOD_US);
   }
   return NULL;
 }
@@ -109,11 +104,7 @@ void *KarateThread::Run() {
  * @brief Stop the thread
  */
 bool KarateThread::Stop() {
-  {
-    MutexLocker locker(&m_mutex);
-    m_term = true;
-  }
-  m_term_cond.Signal();
+  m_handoff.Terminate();
   return Join();
 }
 
@@ -122,9 +113,29 @@ bool KarateThread::Stop() {
  * @brief Store the data in the shared buffer.
  */
 bool KarateThread::WriteDmx(const DmxBuffer &buffer) {
-  MutexLocker locker(&m_mutex);
-  // avoid the reference counting
-  m_buffer.Set(buffer);
+  m_handoff.SetFrame(buffer);
+  return true;
+}
+
+
+/**
+ * @brief Wait before trying to open the device again.
+ *
+ * New frames are still taken while we wait, so the latest one is written once
+ * the device is back.
+ * @returns false if the thread is stopping.
+ */
+bool KarateThread::WaitToReopen() {
+  const int64_t retry_at = FrameTimer::CurrentTime() + REOPEN_DELAY_US;
+  int64_t now;
+  while ((now = FrameTimer::CurrentTime()) < retry_at) {
+    const DmxBuffer *frame;
+    bool changed;
+    if (!m_handoff.WaitForFrame(static_cast<unsigned int>(retry_at - now),
+                                &frame, &changed)) {
+      return false;
+    }
+  }
   return true;
 }
 }  // namespace karate
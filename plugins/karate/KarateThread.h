@@ -22,6 +22,7 @@
 #define PLUGINS_KARATE_KARATETHREAD_H_
 
 #include <string>
+#include "common/thread/FrameHandoff.h"
 #include "ola/DmxBuffer.h"
 #include "ola/thread/Thread.h"
 
@@ -31,7 +32,12 @@ namespace karate {
 
 class KarateThread: public ola::thread::Thread {
  public:
-    explicit KarateThread(const std::string &path);
+    /**
+     * @param path the path to the device.
+     * @param send_on_change if true, only write a frame when the data
+     *   changes, and once a second to keep the device alive.
+     */
+    KarateThread(const std::string &path, bool send_on_change);
 
     bool Stop();
     bool WriteDmx(const DmxBuffer &buffer);
@@ -39,11 +45,15 @@ class KarateThread: public ola::thread::Thread {
 
  private:
     std::string m_path;
-    DmxBuffer m_buffer;
-    bool m_term;
-    ola::thread::Mutex m_mutex;
-    ola::thread::Mutex m_term_mutex;
-    ola::thread::ConditionVariable m_term_cond;
+    bool m_send_on_change;
+    ola::thread::FrameHandoff m_handoff;
+
+    bool WaitToReopen();
+
+    // 50 frames per second, sent on absolute deadlines.
+    static const unsigned int FRAME_PERIOD_US = 20000;
+    static const unsigned int KEEPALIVE_US = 1000000;
+    static const unsigned int REOPEN_DELAY_US = 2000000;
 };
 }  // namespace karate
 }  // namespace plugin
@@ -46,10 +46,12 @@ using std::vector;
  */
 KiNetDevice::KiNetDevice(
     AbstractPlugin *owner,
-    const vector<ola::network::IPV4Address> &power_supplies,
-    PluginAdaptor *plugin_adaptor)
+    const vector<PowerSupply> &power_supplies,
+    PluginAdaptor *plugin_adaptor,
+    const ola::network::UDPReceiveOptions &receive_options)
     : Device(owner, "KiNet Device"),
       m_power_supplies(power_supplies),
+      m_receive_options(receive_options),
       m_node(NULL),
       m_plugin_adaptor(plugin_adaptor) {
 }
@@ -61,6 +63,7 @@ KiNetDevice::KiNetDevice(
  */
 bool KiNetDevice::StartHook() {
   m_node = new KiNetNode(m_plugin_adaptor);
+  m_node->SetReceiveOptions(m_receive_options);
 
   if (!m_node->Start()) {
     delete m_node;
@@ -68,10 +71,18 @@ bool KiNetDevice::StartHook() {
     return false;
   }
 
-  vector<IPV4Address>::const_iterator iter = m_power_supplies.begin();
+  vector<PowerSupply>::const_iterator iter = m_power_supplies.begin();
   unsigned int port_id = 0;
   for (; iter != m_power_supplies.end(); ++iter) {
-    AddPort(new KiNetOutputPort(this, *iter, m_node, port_id++));
+    if (!iter->port_count) {
+      AddPort(new KiNetOutputPort(this, iter->address, 0, m_node,
+                                  port_id++));
+      continue;
+    }
+    for (unsigned int i = 1; i <= iter->port_count; i++) {
+      AddPort(new KiNetOutputPort(this, iter->address, i, m_node,
+                                  port_id++));
+    }
   }
   return true;
 }
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "ola/network/IPV4Address.h"
+#include "ola/network/UDPReceiveStats.h"
 #include "olad/Device.h"
 
 namespace ola {
@@ -33,9 +34,16 @@ namespace kinet {
 
 class KiNetDevice: public ola::Device {
  public:
+    struct PowerSupply {
+      ola::network::IPV4Address address;
+      // 0 for a DMXOUT supply, otherwise the number of PORTOUT ports.
+      unsigned int port_count;
+    };
+
     KiNetDevice(AbstractPlugin *owner,
-                const std::vector<ola::network::IPV4Address> &power_supplies,
-                class PluginAdaptor *plugin_adaptor);
+                const std::vector<PowerSupply> &power_supplies,
+                class PluginAdaptor *plugin_adaptor,
+                const ola::network::UDPReceiveOptions &receive_options);
 
     // Only one KiNet device
     std::string DeviceId() const { return "1"; }
@@ -46,7 +54,8 @@ class KiNetDevice: public ola::Device {
     void PostPortStop();
 
  private:
-    const std::vector<ola::network::IPV4Address> m_power_supplies;
+    const std::vector<PowerSupply> m_power_supplies;
+    const ola::network::UDPReceiveOptions m_receive_options;
     class KiNetNode *m_node;
     class PluginAdaptor *m_plugin_adaptor;
 };
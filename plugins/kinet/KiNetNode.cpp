@@ -24,6 +24,8 @@
 #include "ola/Logging.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/SocketAddress.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/util/Trace.h"
 #include "plugins/kinet/KiNetNode.h"
 
 namespace ola {
@@ -54,6 +56,7 @@ KiNetNode::KiNetNode(ola::io::SelectServerInterface *ss,
  */
 KiNetNode::~KiNetNode() {
   Stop();
+  STLDeleteValues(&m_packets);
 }
 
 
@@ -89,32 +92,54 @@ bool KiNetNode::Stop() {
  * Send some DMX data
  */
 bool KiNetNode::SendDMX(const IPV4Address &target_ip, const DmxBuffer &buffer) {
-  static const uint8_t port = 0;
-  static const uint8_t flags = 0;
-  static const uint16_t timer_val = 0;
-  static const uint32_t universe = 0xffffffff;
-
+  OLA_TRACE_SCOPE("kinet", "KiNetNode::SendDMX");
   if (!buffer.Size()) {
     OLA_DEBUG << "Not sending 0 length packet";
     return true;
   }
 
-  m_output_queue.Clear();
-  PopulatePacketHeader(KINET_DMX_MSG);
-  m_output_stream << port << flags << timer_val << universe;
-  m_output_stream << DMX512_START_CODE;
-  m_output_stream.Write(buffer.GetRaw(), buffer.Size());
+  kinet_packet *packet = GetPacket(target_ip, DMX_OUT_PORT);
+  unsigned int data_size = DMX_UNIVERSE_SIZE;
+  buffer.Get(packet->data + packet->header_size, &data_size);
+  return SendPacket(target_ip, *packet, data_size);
+}
 
-  IPV4SocketAddress target(target_ip, KINET_PORT);
-  bool ok = m_socket->SendTo(&m_output_queue, target);
-  if (!ok)
-    OLA_WARN << "Failed to send KiNet DMX packet";
 
-  if (!m_output_queue.Empty()) {
-    OLA_WARN << "Failed to send complete KiNet packet";
-    m_output_queue.Clear();
+/*
+ * Send some DMX data to a port of a multi-port power supply.
+ */
+bool KiNetNode::SendPortOut(const IPV4Address &target_ip,
+                            uint8_t port,
+                            const DmxBuffer &buffer) {
+  if (port == DMX_OUT_PORT) {
+    OLA_WARN << "KiNet PORTOUT ports start from 1";
+    return false;
   }
-  return ok;
+
+  if (!buffer.Size()) {
+    OLA_DEBUG << "Not sending 0 length packet";
+    return true;
+  }
+
+  kinet_packet *packet = GetPacket(target_ip, port);
+  unsigned int data_size = DMX_UNIVERSE_SIZE;
+  buffer.Get(packet->data + packet->header_size, &data_size);
+
+  // The length is little endian, and comes before the 2 byte start code.
+  uint8_t *length = packet->data + packet->header_size - 4;
+  length[0] = data_size & 0xff;
+  length[1] = data_size >> 8;
+  return SendPacket(target_ip, *packet, data_size);
+}
+
+
+void KiNetNode::BeginBatch() {
+  m_socket->BeginSendBatch();
+}
+
+
+bool KiNetNode::EndBatch() {
+  return m_socket->EndSendBatch();
 }
 
 
@@ -135,12 +160,67 @@ void KiNetNode::SocketReady() {
 }
 
 
+/*
+ * Return the packet for a power supply port, building the header if this is
+ * the first time we've sent to it.
+ */
+KiNetNode::kinet_packet *KiNetNode::GetPacket(const IPV4Address &target_ip,
+                                              uint8_t port) {
+  static const uint8_t pad = 0;
+  static const uint8_t flags = 0;
+  static const uint16_t portout_flags = 0;
+  static const uint16_t timer_val = 0;
+  static const uint16_t length = 0;
+  static const uint16_t start_code = 0;
+  static const uint32_t universe = 0xffffffff;
+
+  const PacketKey key(target_ip, port);
+  PacketMap::iterator iter = m_packets.find(key);
+  if (iter != m_packets.end()) {
+    return iter->second;
+  }
+
+  m_output_queue.Clear();
+  if (port == DMX_OUT_PORT) {
+    PopulatePacketHeader(KINET_VERSION_ONE, KINET_DMX_MSG);
+    m_output_stream << port << flags << timer_val << universe;
+    m_output_stream << DMX512_START_CODE;
+  } else {
+    PopulatePacketHeader(KINET_VERSION_TWO, KINET_PORTOUT_MSG);
+    m_output_stream << universe << port << pad << portout_flags;
+    m_output_stream << length << start_code;
+  }
+
+  kinet_packet *packet = new kinet_packet();
+  packet->header_size = m_output_queue.Read(packet->data, MAX_HEADER_SIZE);
+  m_packets[key] = packet;
+  return packet;
+}
+
+
+/*
+ * Send a packet with data_size bytes of data.
+ */
+bool KiNetNode::SendPacket(const IPV4Address &target_ip,
+                           const kinet_packet &packet,
+                           unsigned int data_size) {
+  const unsigned int size = packet.header_size + data_size;
+  IPV4SocketAddress target(target_ip, KINET_PORT);
+  ssize_t bytes_sent = m_socket->SendTo(packet.data, size, target);
+  if (bytes_sent != static_cast<ssize_t>(size)) {
+    OLA_WARN << "Failed to send KiNet packet to " << target_ip;
+    return false;
+  }
+  return true;
+}
+
+
 /*
  * Fill in the header for a packet
  */
-void KiNetNode::PopulatePacketHeader(uint16_t msg_type) {
+void KiNetNode::PopulatePacketHeader(uint16_t version, uint16_t msg_type) {
   uint32_t sequence_number = 0;  // everything seems to set this to 0.
-  m_output_stream << KINET_MAGIC_NUMBER << KINET_VERSION_ONE;
+  m_output_stream << KINET_MAGIC_NUMBER << version;
   m_output_stream << msg_type << sequence_number;
 }
 
@@ -163,6 +243,7 @@ bool KiNetNode::InitNetwork() {
     return false;
   }
 
+  socket->EnableReceiveStats(m_receive_options);
   socket->SetOnData(NewCallback(this, &KiNetNode::SocketReady));
   m_ss->AddReadDescriptor(socket.get());
   m_socket.reset(socket.release());
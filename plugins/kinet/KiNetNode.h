@@ -21,8 +21,11 @@
 #ifndef PLUGINS_KINET_KINETNODE_H_
 #define PLUGINS_KINET_KINETNODE_H_
 
+#include <map>
 #include <memory>
+#include <utility>
 
+#include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/io/BigEndianStream.h"
 #include "ola/io/IOQueue.h"
@@ -43,29 +46,68 @@ class KiNetNode {
     bool Start();
     bool Stop();
 
+    // This must be called before Start().
+    void SetReceiveOptions(const ola::network::UDPReceiveOptions &options) {
+      m_receive_options = options;
+    }
+
     // The following apply to Input Ports (those which send data)
+    // Send a DMXOUT (v1) packet, for single port power supplies.
     bool SendDMX(const ola::network::IPV4Address &target,
                  const ola::DmxBuffer &buffer);
 
+    // Send a PORTOUT (v2) packet to one port of a multi-port power supply.
+    // Ports are numbered from 1.
+    bool SendPortOut(const ola::network::IPV4Address &target,
+                     uint8_t port,
+                     const ola::DmxBuffer &buffer);
+
+    // The packets sent until the outermost EndBatch() are sent together.
+    void BeginBatch();
+    bool EndBatch();
+
  private:
+    enum { MAX_HEADER_SIZE = 24 };
+
+    // The packet for a power supply port. The header is built the first time
+    // we send to the port, after that only the data changes.
+    struct kinet_packet {
+      unsigned int header_size;
+      uint8_t data[MAX_HEADER_SIZE + DMX_UNIVERSE_SIZE];
+    };
+
+    // The power supply and the PORTOUT port, or DMX_OUT_PORT for DMXOUT.
+    typedef std::pair<ola::network::IPV4Address, uint8_t> PacketKey;
+    typedef std::map<PacketKey, kinet_packet*> PacketMap;
+
     bool m_running;
     ola::io::SelectServerInterface *m_ss;
     ola::io::IOQueue m_output_queue;
     ola::io::BigEndianOutputStream m_output_stream;
     ola::network::Interface m_interface;
+    ola::network::UDPReceiveOptions m_receive_options;
     std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
+    PacketMap m_packets;
 
     KiNetNode(const KiNetNode&);
     KiNetNode& operator=(const KiNetNode&);
 
     void SocketReady();
-    void PopulatePacketHeader(uint16_t msg_type);
+    kinet_packet *GetPacket(const ola::network::IPV4Address &target,
+                            uint8_t port);
+    bool SendPacket(const ola::network::IPV4Address &target,
+                    const kinet_packet &packet,
+                    unsigned int data_size);
+    void PopulatePacketHeader(uint16_t version, uint16_t msg_type);
     bool InitNetwork();
 
+    static const uint8_t DMX_OUT_PORT = 0;
     static const uint16_t KINET_PORT = 6038;
     static const uint32_t KINET_MAGIC_NUMBER = 0x0401dc4a;
     static const uint16_t KINET_VERSION_ONE = 0x0100;
+    static const uint16_t KINET_VERSION_TWO = 0x0200;
     static const uint16_t KINET_DMX_MSG = 0x0101;
+    static const uint16_t KINET_PORTOUT_MSG = 0x0801;
 };
 }  // namespace kinet
 }  // namespace plugin
@@ -0,0 +1,138 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * KiNetNodeBenchmark.cpp
+ * Measures the receive path of the KiNetNode.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/testing/Benchmark.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "ola/testing/UDPCapture.h"
+#include "plugins/kinet/KiNetNode.h"
+
+using ola::NewCallback;
+using ola::network::IPV4Address;
+using ola::plugin::kinet::KiNetNode;
+using ola::testing::Benchmark;
+using ola::testing::MockUDPSocket;
+using std::string;
+using std::vector;
+
+namespace {
+
+const uint16_t KINET_PORT = 6038;
+
+/*
+ * Build a version one DMXOUT packet.
+ */
+string BuildDmxOut() {
+  const uint8_t header[] = {
+    0x04, 0x01, 0xdc, 0x4a,  // magic number
+    0x01, 0x00,  // version
+    0x01, 0x01,  // DMXOUT
+    0, 0, 0, 0,  // sequence
+    0,  // port
+    0,  // flags
+    0, 0,  // timer
+    0xff, 0xff, 0xff, 0xff,  // universe
+    ola::DMX512_START_CODE,
+  };
+  string packet(reinterpret_cast<const char*>(header), sizeof(header));
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    packet.push_back(static_cast<char>(i * 7));
+  }
+  return packet;
+}
+
+
+class KiNetNodeBenchmark {
+ public:
+  KiNetNodeBenchmark()
+      : m_socket(NULL) {
+    ola::network::IPV4Address::FromString("10.0.0.10", &m_peer);
+  }
+
+  bool Setup(const vector<string> &packets) {
+    m_node.reset();
+    m_packets = packets;
+    if (m_packets.empty()) {
+      return false;
+    }
+
+    m_socket = new MockUDPSocket();
+    m_node.reset(new KiNetNode(&m_ss, m_socket));
+    return m_node->Start();
+  }
+
+  void Receive(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      const string &packet = m_packets[i % m_packets.size()];
+      m_socket->InjectData(reinterpret_cast<const uint8_t*>(packet.data()),
+                           packet.size(), m_peer, KINET_PORT);
+    }
+  }
+
+ private:
+  ola::io::SelectServer m_ss;
+  MockUDPSocket *m_socket;
+  std::auto_ptr<KiNetNode> m_node;
+  vector<string> m_packets;
+  IPV4Address m_peer;
+};
+}  // namespace
+
+
+/*
+ * With no arguments the benchmark uses a generated DMXOUT packet, otherwise
+ * the KiNet datagrams in the pcap file are replayed.
+ */
+int main(int argc, char *argv[]) {
+  ola::InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_STDERR);
+
+  KiNetNodeBenchmark fixture;
+  Benchmark benchmark("KiNetNode", &std::cout);
+
+  vector<string> packets;
+  string name;
+  if (argc > 1) {
+    if (!ola::testing::LoadUDPCapture(argv[1], KINET_PORT, &packets)) {
+      return 1;
+    }
+    name = "Replay";
+  } else {
+    packets.push_back(BuildDmxOut());
+    name = "DmxOut";
+  }
+
+  if (!fixture.Setup(packets)) {
+    OLA_WARN << "Failed to setup the KiNetNode";
+    return 1;
+  }
+  benchmark.Run(name, packets.size(),
+                NewCallback(&fixture, &KiNetNodeBenchmark::Receive));
+  return 0;
+}
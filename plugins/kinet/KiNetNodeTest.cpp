@@ -37,6 +37,7 @@ using ola::testing::MockUDPSocket;
 class KiNetNodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(KiNetNodeTest);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testSendPortOut);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -48,6 +49,7 @@ class KiNetNodeTest: public CppUnit::TestFixture {
     void setUp();
 
     void testSendDMX();
+    void testSendPortOut();
 
  private:
     ola::io::SelectServer ss;
@@ -88,3 +90,61 @@ void KiNetNodeTest::testSendDMX() {
   m_socket->Verify();
   OLA_ASSERT(node.Stop());
 }
+
+
+/**
+ * Check sending PORTOUT packets works, including in a batch.
+ */
+void KiNetNodeTest::testSendPortOut() {
+  KiNetNode node(&ss, m_socket);
+  OLA_ASSERT_TRUE(node.Start());
+
+  const uint8_t expected_data[] = {
+    0x04, 0x01, 0xdc, 0x4a, 0x02, 0x00,
+    0x08, 0x01, 0, 0, 0, 0,
+    0xff, 0xff, 0xff, 0xff,
+    2, 0,  // port & pad
+    0, 0,  // flags
+    8, 0,  // length
+    0, 0,  // start code
+    1, 5, 8, 10, 14, 45, 100, 255
+  };
+
+  m_socket->AddExpectedData(expected_data, sizeof(expected_data), target_ip,
+                            KINET_PORT);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,5,8,10,14,45,100,255");
+  OLA_ASSERT_TRUE(node.SendPortOut(target_ip, 2, buffer));
+  m_socket->Verify();
+
+  // ports start from 1
+  OLA_ASSERT_FALSE(node.SendPortOut(target_ip, 0, buffer));
+
+  // the second frame reuses the packet, and is sent in a batch
+  const uint8_t expected_port3[] = {
+    0x04, 0x01, 0xdc, 0x4a, 0x02, 0x00,
+    0x08, 0x01, 0, 0, 0, 0,
+    0xff, 0xff, 0xff, 0xff,
+    3, 0, 0, 0, 2, 0, 0, 0,
+    1, 5
+  };
+  const uint8_t expected_port2[] = {
+    0x04, 0x01, 0xdc, 0x4a, 0x02, 0x00,
+    0x08, 0x01, 0, 0, 0, 0,
+    0xff, 0xff, 0xff, 0xff,
+    2, 0, 0, 0, 2, 0, 0, 0,
+    1, 5
+  };
+  m_socket->AddExpectedData(expected_port3, sizeof(expected_port3),
+                            target_ip, KINET_PORT);
+  m_socket->AddExpectedData(expected_port2, sizeof(expected_port2),
+                            target_ip, KINET_PORT);
+  buffer.SetFromString("1,5");
+  node.BeginBatch();
+  OLA_ASSERT_TRUE(node.SendPortOut(target_ip, 3, buffer));
+  OLA_ASSERT_TRUE(node.SendPortOut(target_ip, 2, buffer));
+  OLA_ASSERT_TRUE(node.EndBatch());
+  m_socket->Verify();
+  OLA_ASSERT(node.Stop());
+}
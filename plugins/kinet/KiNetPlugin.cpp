@@ -22,9 +22,11 @@
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
 #include "ola/network/IPV4Address.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/UDPReceivePreferences.h"
 #include "plugins/kinet/KiNetDevice.h"
 #include "plugins/kinet/KiNetPlugin.h"
 #include "plugins/kinet/KiNetPluginDescription.h"
@@ -39,6 +41,9 @@ using std::string;
 using std::vector;
 
 const char KiNetPlugin::POWER_SUPPLY_KEY[] = "power_supply";
+const char KiNetPlugin::MODE_KEY_SUFFIX[] = "-mode";
+const char KiNetPlugin::PORTS_KEY_SUFFIX[] = "-ports";
+const char KiNetPlugin::PORTOUT_MODE[] = "portout";
 const char KiNetPlugin::PLUGIN_NAME[] = "KiNET";
 const char KiNetPlugin::PLUGIN_PREFIX[] = "kinet";
 
@@ -55,20 +60,37 @@ bool KiNetPlugin::StartHook() {
   vector<string> power_supplies_strings = m_preferences->GetMultipleValue(
       POWER_SUPPLY_KEY);
   vector<string>::const_iterator iter = power_supplies_strings.begin();
-  vector<IPV4Address> power_supplies;
+  vector<KiNetDevice::PowerSupply> power_supplies;
 
   for (; iter != power_supplies_strings.end(); ++iter) {
     if (iter->empty()) {
       continue;
     }
-    IPV4Address target;
-    if (IPV4Address::FromString(*iter, &target)) {
-      power_supplies.push_back(target);
-    } else {
+    KiNetDevice::PowerSupply power_supply;
+    if (!IPV4Address::FromString(*iter, &power_supply.address)) {
       OLA_WARN << "Invalid power supply IP address : " << *iter;
+      continue;
+    }
+
+    power_supply.port_count = 0;
+    if (m_preferences->GetValue(*iter + MODE_KEY_SUFFIX) == PORTOUT_MODE) {
+      const string ports = m_preferences->GetValue(*iter + PORTS_KEY_SUFFIX);
+      if (ports.empty()) {
+        power_supply.port_count = DEFAULT_PORTOUT_PORTS;
+      } else if (!StringToInt(ports, &power_supply.port_count) ||
+                 power_supply.port_count == 0 ||
+                 power_supply.port_count > MAX_PORTOUT_PORTS) {
+        OLA_WARN << "Invalid port count for " << *iter << ": " << ports;
+        continue;
+      }
     }
+    power_supplies.push_back(power_supply);
   }
-  m_device.reset(new KiNetDevice(this, power_supplies, m_plugin_adaptor));
+  ola::network::UDPReceiveOptions receive_options;
+  ReadUDPReceivePreferences(*m_preferences, m_plugin_adaptor->GetExportMap(),
+                            "kinet", &receive_options);
+  m_device.reset(new KiNetDevice(this, power_supplies, m_plugin_adaptor,
+                                 receive_options));
 
   if (!m_device->Start()) {
     m_device.reset();
@@ -116,6 +138,7 @@ bool KiNetPlugin::SetDefaultPreferences() {
 
   save |= m_preferences->SetDefaultValue(POWER_SUPPLY_KEY,
                                          StringValidator(true), "");
+  save |= SetDefaultUDPReceivePreferences(m_preferences);
 
   if (save) {
     m_preferences->Save();
@@ -40,6 +40,9 @@ class KiNetPlugin : public Plugin {
     std::string Description() const;
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     std::auto_ptr<class KiNetDevice> m_device;  // only have one device
 
@@ -47,9 +50,12 @@ class KiNetPlugin : public Plugin {
     bool StopHook();
     bool SetDefaultPreferences();
 
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
     static const char POWER_SUPPLY_KEY[];
+    static const char MODE_KEY_SUFFIX[];
+    static const char PORTS_KEY_SUFFIX[];
+    static const char PORTOUT_MODE[];
+    static const unsigned int DEFAULT_PORTOUT_PORTS = 16;
+    static const unsigned int MAX_PORTOUT_PORTS = 255;
 };
 }  // namespace kinet
 }  // namespace plugin
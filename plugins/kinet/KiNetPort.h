@@ -21,6 +21,7 @@
 #ifndef PLUGINS_KINET_KINETPORT_H_
 #define PLUGINS_KINET_KINETPORT_H_
 
+#include <sstream>
 #include <string>
 #include "ola/network/IPV4Address.h"
 #include "olad/Port.h"
@@ -33,26 +34,42 @@ namespace kinet {
 
 class KiNetOutputPort: public BasicOutputPort {
  public:
+  // kinet_port is the PORTOUT port, or 0 to use DMXOUT.
   KiNetOutputPort(KiNetDevice *device,
                   const ola::network::IPV4Address &target,
+                  uint8_t kinet_port,
                   KiNetNode *node,
                   unsigned int port_id)
       : BasicOutputPort(device, port_id),
         m_node(node),
-        m_target(target) {
+        m_target(target),
+        m_kinet_port(kinet_port) {
   }
 
   bool WriteDMX(const DmxBuffer &buffer, OLA_UNUSED uint8_t priority) {
+    if (m_kinet_port) {
+      return m_node->SendPortOut(m_target, m_kinet_port, buffer);
+    }
     return m_node->SendDMX(m_target, buffer);
   }
 
+  // The packets for all the power supplies are sent together.
+  void BeginBatch() { m_node->BeginBatch(); }
+  void EndBatch() { m_node->EndBatch(); }
+
   std::string Description() const {
-    return "Power Supply: " + m_target.ToString();
+    std::ostringstream str;
+    str << "Power Supply: " << m_target;
+    if (m_kinet_port) {
+      str << ", Port: " << static_cast<int>(m_kinet_port);
+    }
+    return str.str();
   }
 
  private:
   KiNetNode *m_node;
   const ola::network::IPV4Address m_target;
+  const uint8_t m_kinet_port;
 };
 }  // namespace kinet
 }  // namespace plugin
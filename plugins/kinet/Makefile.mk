@@ -34,6 +34,19 @@ plugins_kinet_KiNetTester_SOURCES = plugins/kinet/KiNetNodeTest.cpp
 plugins_kinet_KiNetTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 plugins_kinet_KiNetTester_LDADD = $(COMMON_TESTING_LIBS) \
                                   plugins/kinet/libolakinetnode.la
+
+# BENCHMARKS
+##################################################
+if BUILD_TESTS
+bench_programs += plugins/kinet/KiNetNodeBenchmark
+
+plugins_kinet_KiNetNodeBenchmark_SOURCES = \
+    plugins/kinet/KiNetNodeBenchmark.cpp
+plugins_kinet_KiNetNodeBenchmark_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+plugins_kinet_KiNetNodeBenchmark_LDADD = \
+    $(COMMON_SOCKET_BENCHMARK_LIBS) \
+    plugins/kinet/libolakinetnode.la
+endif
 endif
 
 EXTRA_DIST += plugins/kinet/README.md
@@ -46,6 +46,9 @@ class MilInstPlugin: public Plugin {
   int SocketClosed(ola::io::ConnectedDescriptor *socket);
   std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
  private:
   bool StartHook();
   bool StopHook();
@@ -55,8 +58,6 @@ class MilInstPlugin: public Plugin {
   std::vector<MilInstDevice*> m_devices;  // list of our devices
 
   static const char MILINST_DEVICE_PATH[];
-  static const char PLUGIN_NAME[];
-  static const char PLUGIN_PREFIX[];
   static const char DEVICE_KEY[];
 };
 }  // namespace milinst
@@ -20,7 +20,9 @@
 
 #include <string>
 
+#include "ola/Callback.h"
 #include "ola/Logging.h"
+#include "ola/io/IOQueue.h"
 #include "ola/io/IOUtils.h"
 #include "plugins/milinst/MilInstWidget.h"
 
@@ -34,6 +36,8 @@ using std::string;
  * New widget
  */
 MilInstWidget::~MilInstWidget() {
+  // The sender uses the socket, so it goes first.
+  m_sender.reset();
   if (m_socket) {
     m_socket->Close();
     delete m_socket;
@@ -74,9 +78,51 @@ int MilInstWidget::ConnectToWidget(const string &path, speed_t speed) {
  * Disconnect from the widget
  */
 int MilInstWidget::Disconnect() {
+  m_sender.reset();
+  m_pending_frame.clear();
   m_socket->Close();
   return 0;
 }
+
+
+void MilInstWidget::StartSender() {
+  m_sender.reset(new ola::io::NonBlockingSender(m_socket, m_ss, &m_pool,
+                                                MAX_BUFFER_SIZE));
+  m_sender->SetOnDrain(NewCallback(this, &MilInstWidget::SenderDrained));
+}
+
+
+bool MilInstWidget::SendFrame(const uint8_t *data, unsigned int length) {
+  if (!m_sender.get()) {
+    return false;
+  }
+
+  if (!m_sender->Empty()) {
+    m_pending_frame.assign(data, length);
+    return true;
+  }
+  WriteFrame(data, length);
+  return true;
+}
+
+
+void MilInstWidget::WriteFrame(const uint8_t *data, unsigned int length) {
+  ola::io::IOQueue queue(&m_pool);
+  queue.Write(data, length);
+  m_sender->SendMessage(&queue);
+}
+
+
+/*
+ * Called once the last frame has been written.
+ */
+void MilInstWidget::SenderDrained() {
+  if (m_pending_frame.empty()) {
+    return;
+  }
+  WriteFrame(m_pending_frame.data(), m_pending_frame.size());
+  m_pending_frame.clear();
+}
 }  // namespace milinst
 }  // namespace plugin
 }  // namespace ola
@@ -22,9 +22,14 @@
 #define PLUGINS_MILINST_MILINSTWIDGET_H_
 
 #include <fcntl.h>
+#include <stdint.h>
 #include <termios.h>
+#include <memory>
 #include <string>
 
+#include "ola/io/ByteString.h"
+#include "ola/io/MemoryBlockPool.h"
+#include "ola/io/NonBlockingSender.h"
 #include "ola/io/SelectServer.h"
 #include "ola/DmxBuffer.h"
 
@@ -36,10 +41,11 @@ class MilInstWidget {
  public:
   static int ConnectToWidget(const std::string &path, speed_t speed = B9600);
 
-  explicit MilInstWidget(const std::string &path)
+  MilInstWidget(ola::io::SelectServerInterface *ss, const std::string &path)
       : m_enabled(false),
         m_path(path),
-        m_socket(NULL) {}
+        m_socket(NULL),
+        m_ss(ss) {}
 
   virtual ~MilInstWidget();
 
@@ -56,16 +62,45 @@ class MilInstWidget {
     return str.str();
   }
 
-  virtual bool SendDmx(const DmxBuffer &buffer) const = 0;
+  virtual bool SendDmx(const DmxBuffer &buffer) = 0;
   virtual bool DetectDevice() = 0;
 
  protected:
-  virtual int SetChannel(unsigned int chan, uint8_t val) const = 0;
+  virtual bool SetChannel(unsigned int chan, uint8_t val) = 0;
+
+  /**
+   * @brief Start writing to m_socket, called once the widget is connected.
+   */
+  void StartSender();
+
+  /**
+   * @brief Send a frame without blocking.
+   * @param data the frame to send.
+   * @param length the length of the frame.
+   * @returns false if the widget isn't connected.
+   *
+   * If the previous frame is still being written, this frame is held back
+   * and replaces any frame that's already waiting, so a slow widget gets the
+   * latest data rather than a growing backlog.
+   */
+  bool SendFrame(const uint8_t *data, unsigned int length);
 
   // instance variables
   bool m_enabled;
   const std::string m_path;
   ola::io::ConnectedDescriptor *m_socket;
+
+ private:
+  ola::io::SelectServerInterface *m_ss;
+  ola::io::MemoryBlockPool m_pool;
+  std::auto_ptr<ola::io::NonBlockingSender> m_sender;
+  ola::io::ByteString m_pending_frame;
+
+  void WriteFrame(const uint8_t *data, unsigned int length);
+  void SenderDrained();
+
+  // Enough for a frame of 512 channels.
+  static const unsigned int MAX_BUFFER_SIZE = 1024;
 };
 }  // namespace milinst
 }  // namespace plugin
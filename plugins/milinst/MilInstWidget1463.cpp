@@ -39,6 +39,7 @@ bool MilInstWidget1463::Connect() {
     return false;
 
   m_socket = new ola::io::DeviceDescriptor(fd);
+  StartSender();
 
   OLA_DEBUG << "Connected to " << m_path;
   return true;
@@ -58,13 +59,10 @@ bool MilInstWidget1463::DetectDevice() {
 /*
  * Send a DMX msg.
   */
-bool MilInstWidget1463::SendDmx(const DmxBuffer &buffer) const {
+bool MilInstWidget1463::SendDmx(const DmxBuffer &buffer) {
   // TODO(Peter): Probably add offset in here to send higher channels shifted
   // down
-  int bytes_sent = Send112(buffer);
-  OLA_DEBUG << "Sending DMX, sent " << bytes_sent << " bytes";
-  // Should this confirm we've sent more than 0 bytes and return false if not?
-  return true;
+  return Send112(buffer);
 }
 
 
@@ -73,13 +71,13 @@ bool MilInstWidget1463::SendDmx(const DmxBuffer &buffer) const {
 /*
  * Set a single channel
  */
-int MilInstWidget1463::SetChannel(unsigned int chan, uint8_t val) const {
+bool MilInstWidget1463::SetChannel(unsigned int chan, uint8_t val) {
   uint8_t msg[2];
 
   msg[0] = chan;
   msg[1] = val;
   OLA_DEBUG << "Setting " << chan << " to " << static_cast<int>(val);
-  return m_socket->Send(msg, sizeof(msg));
+  return SendFrame(msg, sizeof(msg));
 }
 
 
@@ -87,18 +85,16 @@ int MilInstWidget1463::SetChannel(unsigned int chan, uint8_t val) const {
  * Send 112 channels worth of data
  * @param buffer a DmxBuffer with the data
  */
-int MilInstWidget1463::Send112(const DmxBuffer &buffer) const {
+bool MilInstWidget1463::Send112(const DmxBuffer &buffer) {
   unsigned int channels = std::min((unsigned int) DMX_MAX_TRANSMIT_CHANNELS,
                                    buffer.Size());
-  uint8_t msg[channels * 2];
+  uint8_t msg[DMX_MAX_TRANSMIT_CHANNELS * 2];
 
-  for (unsigned int i = 0; i <= channels; i++) {
+  for (unsigned int i = 0; i < channels; i++) {
     msg[i * 2] = i + 1;
     msg[(i * 2) + 1] = buffer.Get(i);
-    OLA_DEBUG << "Setting " << (i + 1) << " to " <<
-        static_cast<int>(buffer.Get(i));
   }
-  return m_socket->Send(msg, (channels * 2));
+  return SendFrame(msg, channels * 2);
 }
 }  // namespace milinst
 }  // namespace plugin
@@ -44,9 +44,10 @@ const uint16_t MilInstWidget1553::CHANNELS_512 = 512;
 const uint16_t MilInstWidget1553::DEFAULT_CHANNELS = CHANNELS_128;
 
 
-MilInstWidget1553::MilInstWidget1553(const string &path,
+MilInstWidget1553::MilInstWidget1553(ola::io::SelectServerInterface *ss,
+                                     const string &path,
                                      Preferences *preferences)
-    : MilInstWidget(path),
+    : MilInstWidget(ss, path),
       m_preferences(preferences) {
   SetWidgetDefaults();
 
@@ -80,6 +81,7 @@ bool MilInstWidget1553::Connect() {
   m_socket = new ola::io::DeviceDescriptor(fd);
   m_socket->SetOnData(
       NewCallback<MilInstWidget1553>(this, &MilInstWidget1553::SocketReady));
+  StartSender();
 
   OLA_DEBUG << "Connected to " << m_path;
   return true;
@@ -117,13 +119,10 @@ bool MilInstWidget1553::DetectDevice() {
 /*
  * Send a DMX msg.
   */
-bool MilInstWidget1553::SendDmx(const DmxBuffer &buffer) const {
+bool MilInstWidget1553::SendDmx(const DmxBuffer &buffer) {
   // TODO(Peter): Probably add offset in here to send higher channels shifted
   // down
-  int bytes_sent = Send(buffer);
-  OLA_DEBUG << "Sending DMX, sent " << bytes_sent << " bytes";
-  // Should this confirm we've sent more than 0 bytes and return false if not?
-  return true;
+  return Send(buffer);
 }
 
 
@@ -132,14 +131,14 @@ bool MilInstWidget1553::SendDmx(const DmxBuffer &buffer) const {
 /*
  * Set a single channel
  */
-int MilInstWidget1553::SetChannel(unsigned int chan, uint8_t val) const {
+bool MilInstWidget1553::SetChannel(unsigned int chan, uint8_t val) {
   uint8_t msg[4];
 
   msg[0] = MILINST_1553_LOAD_COMMAND;
   ola::utils::SplitUInt16(chan, &msg[1], &msg[2]);
   msg[3] = val;
   OLA_DEBUG << "Setting " << chan << " to " << static_cast<int>(val);
-  return m_socket->Send(msg, sizeof(msg));
+  return SendFrame(msg, sizeof(msg));
 }
 
 
@@ -147,7 +146,7 @@ int MilInstWidget1553::SetChannel(unsigned int chan, uint8_t val) const {
  * Send data
  * @param buffer a DmxBuffer with the data
  */
-int MilInstWidget1553::Send(const DmxBuffer &buffer) const {
+bool MilInstWidget1553::Send(const DmxBuffer &buffer) {
   unsigned int channels = std::min(static_cast<unsigned int>(m_channels),
                                    buffer.Size());
   uint8_t msg[3 + channels];
@@ -157,7 +156,7 @@ int MilInstWidget1553::Send(const DmxBuffer &buffer) const {
 
   buffer.Get(msg + 3, &channels);
 
-  return m_socket->Send(msg, sizeof(msg));
+  return SendFrame(msg, sizeof(msg));
 }
 
 
@@ -31,19 +31,21 @@ namespace milinst {
 
 class MilInstWidget1553: public MilInstWidget {
  public:
-  explicit MilInstWidget1553(const std::string &path, Preferences *preferences);
+  MilInstWidget1553(ola::io::SelectServerInterface *ss,
+                    const std::string &path,
+                    Preferences *preferences);
   ~MilInstWidget1553() {}
 
   bool Connect();
   bool DetectDevice();
-  bool SendDmx(const DmxBuffer &buffer) const;
+  bool SendDmx(const DmxBuffer &buffer);
   std::string Type() { return "Milford Instruments 1-553 Widget"; }
 
   void SocketReady();
 
  protected:
-  int SetChannel(unsigned int chan, uint8_t val) const;
-  int Send(const DmxBuffer &buffer) const;
+  bool SetChannel(unsigned int chan, uint8_t val);
+  bool Send(const DmxBuffer &buffer);
 
   static const uint8_t MILINST_1553_LOAD_COMMAND = 0x01;
 
@@ -44,9 +44,11 @@ using std::string;
 OpenDmxDevice::OpenDmxDevice(AbstractPlugin *owner,
                              const string &name,
                              const string &path,
-                             unsigned int device_id)
+                             unsigned int device_id,
+                             bool send_on_change)
     : Device(owner, name),
-      m_path(path) {
+      m_path(path),
+      m_send_on_change(send_on_change) {
   std::ostringstream str;
   str << device_id;
   m_device_id = str.str();
@@ -58,7 +60,7 @@ OpenDmxDevice::OpenDmxDevice(AbstractPlugin *owner,
  * Start this device
  */
 bool OpenDmxDevice::StartHook() {
-  AddPort(new OpenDmxOutputPort(this, 0, m_path));
+  AddPort(new OpenDmxOutputPort(this, 0, m_path, m_send_on_change));
   return true;
 }
 }  // namespace opendmx
@@ -33,7 +33,8 @@ class OpenDmxDevice: public ola::Device {
     OpenDmxDevice(ola::AbstractPlugin *owner,
                   const std::string &name,
                   const std::string &path,
-                  unsigned int device_id);
+                  unsigned int device_id,
+                  bool send_on_change);
 
     // we only support one widget for now
     std::string DeviceId() const { return m_device_id; }
@@ -44,6 +45,7 @@ class OpenDmxDevice: public ola::Device {
  private:
     std::string m_path;
     std::string m_device_id;
+    bool m_send_on_change;
 };
 }  // namespace opendmx
 }  // namespace plugin
@@ -47,6 +47,7 @@ const char OpenDmxPlugin::OPENDMX_DEVICE_NAME[] = "OpenDmx USB Device";
 const char OpenDmxPlugin::PLUGIN_NAME[] = "Enttec Open DMX";
 const char OpenDmxPlugin::PLUGIN_PREFIX[] = "opendmx";
 const char OpenDmxPlugin::DEVICE_KEY[] = "device";
+const char OpenDmxPlugin::SEND_ON_CHANGE_KEY[] = "send_on_change";
 
 
 /*
@@ -56,6 +57,8 @@ const char OpenDmxPlugin::DEVICE_KEY[] = "device";
 bool OpenDmxPlugin::StartHook() {
   vector<string> devices = m_preferences->GetMultipleValue(DEVICE_KEY);
   vector<string>::const_iterator iter = devices.begin();
+  const bool send_on_change = m_preferences->GetValueAsBool(
+      SEND_ON_CHANGE_KEY);
 
   // start counting device ids from 0
   unsigned int device_id = 0;
@@ -69,7 +72,8 @@ bool OpenDmxPlugin::StartHook() {
           this,
           OPENDMX_DEVICE_NAME,
           *iter,
-          device_id++);
+          device_id++,
+          send_on_change);
       if (device->Start()) {
         m_devices.push_back(device);
         m_plugin_adaptor->RegisterDevice(device);
@@ -118,8 +122,11 @@ bool OpenDmxPlugin::SetDefaultPreferences() {
     return false;
   }
 
-  if (m_preferences->SetDefaultValue(DEVICE_KEY, StringValidator(),
-                                     OPENDMX_DEVICE_PATH)) {
+  bool save = m_preferences->SetDefaultValue(DEVICE_KEY, StringValidator(),
+                                             OPENDMX_DEVICE_PATH);
+  save |= m_preferences->SetDefaultValue(SEND_ON_CHANGE_KEY, BoolValidator(),
+                                         false);
+  if (save) {
     m_preferences->Save();
   }
 
@@ -43,6 +43,9 @@ class OpenDmxPlugin: public Plugin {
     ola_plugin_id Id() const { return OLA_PLUGIN_OPENDMX; }
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
@@ -50,11 +53,10 @@ class OpenDmxPlugin: public Plugin {
 
     typedef std::vector<OpenDmxDevice*> DeviceList;
     DeviceList m_devices;
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
     static const char OPENDMX_DEVICE_PATH[];
     static const char OPENDMX_DEVICE_NAME[];
     static const char DEVICE_KEY[];
+    static const char SEND_ON_CHANGE_KEY[];
 };
 }  // namespace opendmx
 }  // namespace plugin
@@ -35,9 +35,10 @@ class OpenDmxOutputPort: public BasicOutputPort {
  public:
   OpenDmxOutputPort(OpenDmxDevice *parent,
                     unsigned int id,
-                    const std::string &path)
+                    const std::string &path,
+                    bool send_on_change)
       : BasicOutputPort(parent, id),
-        m_thread(path),
+        m_thread(path, send_on_change),
         m_path(path) {
     m_thread.Start();
   }
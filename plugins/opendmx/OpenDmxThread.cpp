@@ -31,28 +31,29 @@
 #include <unistd.h>
 #include <string>
 
-#include "ola/Clock.h"
+#include "common/thread/FrameTimer.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/io/IOUtils.h"
+#include "ola/thread/ThreadSettings.h"
 #include "plugins/opendmx/OpenDmxThread.h"
 
 namespace ola {
 namespace plugin {
 namespace opendmx {
 
+using ola::thread::FrameTimer;
 using std::string;
-using ola::thread::Mutex;
-using ola::thread::MutexLocker;
 
 /*
  * Create a new OpenDmxThread object
  */
-OpenDmxThread::OpenDmxThread(const string &path)
-    : ola::thread::Thread(),
+OpenDmxThread::OpenDmxThread(const string &path, bool send_on_change)
+    : ola::thread::Thread(ola::thread::Thread::Options(
+          "opendmx", ola::thread::THREAD_CLASS_OUTPUT)),
     m_fd(INVALID_FD),
     m_path(path),
-    m_term(false) {
+    m_send_on_change(send_on_change) {
 }
 
 
@@ -61,52 +62,51 @@ OpenDmxThread::OpenDmxThread(const string &path)
  */
 void *OpenDmxThread::Run() {
   uint8_t buffer[DMX_UNIVERSE_SIZE+1];
-  unsigned int length = DMX_UNIVERSE_SIZE;
-  Clock clock;
-
-  // should close other fd here
+  FrameTimer timer;
+  // true if the next frame should be written even if it hasn't changed
+  bool resend = true;
 
   // start code
   buffer[0] = 0x00;
   ola::io::Open(m_path, O_WRONLY, &m_fd);
+  timer.StartFrame();
 
   while (true) {
-    {
-      MutexLocker lock(&m_term_mutex);
-      if (m_term)
-        break;
-    }
-
     if (m_fd == INVALID_FD) {
-      TimeStamp wake_up;
-      clock.CurrentTime(&wake_up);
-      wake_up += TimeInterval(1, 0);
-
-      // wait for either a signal that we should terminate, or ts seconds
-      m_term_mutex.Lock();
-      if (m_term)
+      if (!WaitToReopen()) {
         break;
-      m_term_cond.TimedWait(&m_term_mutex, wake_up);
-      m_term_mutex.Unlock();
-
-      ola::io::Open(m_path, O_WRONLY, &m_fd);
-
-    } else {
-      length = DMX_UNIVERSE_SIZE;
-      {
-        MutexLocker locker(&m_mutex);
-        m_buffer.Get(buffer + 1, &length);
       }
+      ola::io::Open(m_path, O_WRONLY, &m_fd);
+      resend = true;
+      continue;
+    }
 
-      if (write(m_fd, buffer, length + 1) < 0) {
-        // if you unplug the dongle
-        OLA_WARN << "Error writing to device: " << strerror(errno);
-
-        if (close(m_fd) < 0)
-          OLA_WARN << "Close failed " << strerror(errno);
-        m_fd = INVALID_FD;
-      }
+    const DmxBuffer *frame;
+    bool changed;
+    const unsigned int timeout = m_send_on_change && !resend ?
+        KEEPALIVE_US : 0;
+    if (!m_handoff.WaitForFrame(timeout, &frame, &changed)) {
+      break;
     }
+    resend = false;
+
+    unsigned int length = DMX_UNIVERSE_SIZE;
+    frame->Get(buffer + 1, &length);
+    if (write(m_fd, buffer, length + 1) < 0) {
+      // if you unplug the dongle
+      OLA_WARN << "Error writing to device: " << strerror(errno);
+
+      if (close(m_fd) < 0)
+        OLA_WARN << "Close failed " << strerror(errno);
+      m_fd = INVALID_FD;
+      continue;
+    }
+    timer.StartNextFrame(FRAME_PERIOD_US);
+  }
+
+  if (m_fd != INVALID_FD) {
+    close(m_fd);
+    m_fd = INVALID_FD;
   }
   return NULL;
 }
@@ -116,11 +116,7 @@ void *OpenDmxThread::Run() {
  * Stop the thread
  */
 bool OpenDmxThread::Stop() {
-  {
-    MutexLocker locker(&m_mutex);
-    m_term = true;
-  }
-  m_term_cond.Signal();
+  m_handoff.Terminate();
   return Join();
 }
 
@@ -130,9 +126,27 @@ bool OpenDmxThread::Stop() {
  *
  */
 bool OpenDmxThread::WriteDmx(const DmxBuffer &buffer) {
-  MutexLocker locker(&m_mutex);
-  // avoid the reference counting
-  m_buffer.Set(buffer);
+  m_handoff.SetFrame(buffer);
+  return true;
+}
+
+
+/*
+ * Wait before trying to open the device again. New frames are still taken
+ * while we wait, so the latest one is written once the device is back.
+ * @returns false if the thread is stopping.
+ */
+bool OpenDmxThread::WaitToReopen() {
+  const int64_t retry_at = FrameTimer::CurrentTime() + REOPEN_DELAY_US;
+  int64_t now;
+  while ((now = FrameTimer::CurrentTime()) < retry_at) {
+    const DmxBuffer *frame;
+    bool changed;
+    if (!m_handoff.WaitForFrame(static_cast<unsigned int>(retry_at - now),
+                                &frame, &changed)) {
+      return false;
+    }
+  }
   return true;
 }
 }  // namespace opendmx
@@ -22,6 +22,7 @@
 #define PLUGINS_OPENDMX_OPENDMXTHREAD_H_
 
 #include <string>
+#include "common/thread/FrameHandoff.h"
 #include "ola/DmxBuffer.h"
 #include "ola/thread/Thread.h"
 
@@ -31,7 +32,12 @@ namespace opendmx {
 
 class OpenDmxThread: public ola::thread::Thread {
  public:
-    explicit OpenDmxThread(const std::string &path);
+    /**
+     * @param path the path to the device.
+     * @param send_on_change if true, only write a frame when the data
+     *   changes, and once a second to keep the device alive.
+     */
+    OpenDmxThread(const std::string &path, bool send_on_change);
     ~OpenDmxThread() {}
 
     bool Stop();
@@ -41,13 +47,16 @@ class OpenDmxThread: public ola::thread::Thread {
  private:
     int m_fd;
     std::string m_path;
-    DmxBuffer m_buffer;
-    bool m_term;
-    ola::thread::Mutex m_mutex;
-    ola::thread::Mutex m_term_mutex;
-    ola::thread::ConditionVariable m_term_cond;
+    bool m_send_on_change;
+    ola::thread::FrameHandoff m_handoff;
+
+    bool WaitToReopen();
 
     static const int INVALID_FD = -1;
+    // 40 frames per second, sent on absolute deadlines.
+    static const unsigned int FRAME_PERIOD_US = 25000;
+    static const unsigned int KEEPALIVE_US = 1000000;
+    static const unsigned int REOPEN_DELAY_US = 1000000;
 };
 }  // namespace opendmx
 }  // namespace plugin
@@ -11,7 +11,8 @@ plugins_openpixelcontrol_libolaopc_la_SOURCES = \
     plugins/openpixelcontrol/OPCServer.cpp \
     plugins/openpixelcontrol/OPCServer.h
 plugins_openpixelcontrol_libolaopc_la_LIBADD = \
-    common/libolacommon.la
+    common/libolacommon.la \
+    common/web/libolaweb.la
 
 lib_LTLIBRARIES += plugins/openpixelcontrol/libolaopenpixelcontrol.la
 
@@ -44,7 +44,8 @@ OPCClient::OPCClient(ola::io::SelectServerInterface *ss,
       m_backoff(TimeInterval(1, 0), TimeInterval(300, 0)),
       m_pool(OPC_FRAME_SIZE),
       m_socket_factory(NewCallback(this, &OPCClient::SocketConnected)),
-      m_tcp_connector(ss, &m_socket_factory, TimeInterval(3, 0)) {
+      m_tcp_connector(ss, &m_socket_factory, TimeInterval(3, 0)),
+      m_batch_depth(0) {
   m_tcp_connector.AddEndpoint(target, &m_backoff);
 }
 
@@ -60,13 +61,20 @@ bool OPCClient::SendDmx(uint8_t channel, const DmxBuffer &buffer) {
     return false;  // not connected
   }
 
-  ola::io::IOQueue queue(&m_pool);
-  ola::io::BigEndianOutputStream stream(&queue);
-  stream << channel;
-  stream << SET_PIXEL_COMMAND;
-  stream << static_cast<uint16_t>(buffer.Size());
-  stream.Write(buffer.GetRaw(), buffer.Size());
-  return m_sender->SendMessage(&queue);
+  m_pending_frames[channel] = buffer;
+  MaybeFlush();
+  return true;
+}
+
+void OPCClient::BeginBatch() {
+  m_batch_depth++;
+}
+
+void OPCClient::EndBatch() {
+  if (m_batch_depth) {
+    m_batch_depth--;
+  }
+  MaybeFlush();
 }
 
 void OPCClient::SetSocketCallback(SocketEventCallback *callback) {
@@ -79,9 +87,12 @@ void OPCClient::SocketConnected(TCPSocket *socket) {
   m_client_socket->SetOnClose(
       NewSingleCallback(this, &OPCClient::SocketClosed));
   m_ss->AddReadDescriptor(socket);
+  // We coalesce the frames ourselves, so Nagle only adds latency.
+  socket->SetNoDelay();
 
   m_sender.reset(
       new ola::io::NonBlockingSender(socket, m_ss, &m_pool, OPC_FRAME_SIZE));
+  m_sender->SetOnDrain(NewCallback(this, &OPCClient::MaybeFlush));
   if (m_socket_callback.get()) {
     m_socket_callback->Run(true);
   }
@@ -101,11 +112,35 @@ void OPCClient::NewData() {
 void OPCClient::SocketClosed() {
   m_sender.reset();
   m_client_socket.reset();
+  m_pending_frames.clear();
 
   if (m_socket_callback.get()) {
     m_socket_callback->Run(false);
   }
 }
+
+/*
+ * Write all the pending frames in a single message, unless we're in a batch or
+ * the last write is still in progress.
+ */
+void OPCClient::MaybeFlush() {
+  if (m_batch_depth || m_pending_frames.empty() || !m_sender.get() ||
+      !m_sender->Empty()) {
+    return;
+  }
+
+  ola::io::IOQueue queue(&m_pool);
+  ola::io::BigEndianOutputStream stream(&queue);
+  std::map<uint8_t, DmxBuffer>::const_iterator iter = m_pending_frames.begin();
+  for (; iter != m_pending_frames.end(); ++iter) {
+    stream << iter->first;
+    stream << SET_PIXEL_COMMAND;
+    stream << static_cast<uint16_t>(iter->second.Size());
+    stream.Write(iter->second.GetRaw(), iter->second.Size());
+  }
+  m_pending_frames.clear();
+  m_sender->SendMessage(&queue);
+}
 }  // namespace openpixelcontrol
 }  // namespace plugin
 }  // namespace ola
@@ -21,6 +21,7 @@
 #ifndef PLUGINS_OPENPIXELCONTROL_OPCCLIENT_H_
 #define PLUGINS_OPENPIXELCONTROL_OPCCLIENT_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
@@ -45,6 +46,11 @@ namespace openpixelcontrol {
  * @brief An Open Pixel Control client.
  *
  * The OPC client connects to a remote IP:port and sends OPC messages.
+ *
+ * Frames are held per channel, and only the latest frame for each channel is
+ * kept. The held frames are written together, in a single send, when a batch
+ * ends or once the previous write has drained. This means a slow server only
+ * ever has one set of frames waiting for it, rather than a growing backlog.
  */
 class OPCClient {
  public:
@@ -76,9 +82,20 @@ class OPCClient {
    * @brief Send a DMX frame.
    * @param channel the OPC channel to use.
    * @param buffer the DMX data.
+   * @returns false if the client isn't connected.
+   *
+   * If a batch is open, or the previous write hasn't drained yet, the frame
+   * replaces any unsent frame for the channel.
    */
   bool SendDmx(uint8_t channel, const DmxBuffer &buffer);
 
+  /**
+   * @brief The frames sent until the outermost EndBatch() are written
+   * together.
+   */
+  void BeginBatch();
+  void EndBatch();
+
   /**
    * @brief Set the callback to be run when the socket state changes.
    * @param callback the callback to run when the socket state changes.
@@ -97,10 +114,14 @@ class OPCClient {
   std::auto_ptr<ola::network::TCPSocket> m_client_socket;
   std::auto_ptr<ola::io::NonBlockingSender> m_sender;
   std::auto_ptr<SocketEventCallback> m_socket_callback;
+  // The latest unsent frame for each channel.
+  std::map<uint8_t, DmxBuffer> m_pending_frames;
+  unsigned int m_batch_depth;
 
   void SocketConnected(ola::network::TCPSocket *socket);
   void NewData();
   void SocketClosed();
+  void MaybeFlush();
 
   DISALLOW_COPY_AND_ASSIGN(OPCClient);
 };
@@ -44,6 +44,7 @@ using std::auto_ptr;
 class OPCClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OPCClientTest);
   CPPUNIT_TEST(testTransmit);
+  CPPUNIT_TEST(testBatch);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -54,12 +55,15 @@ class OPCClientTest: public CppUnit::TestFixture {
   void setUp();
 
   void testTransmit();
+  void testBatch();
 
  private:
   ola::io::SelectServer m_ss;
   auto_ptr<OPCServer> m_server;
   DmxBuffer m_received_data;
+  DmxBuffer m_received_data2;
   uint8_t m_command;
+  unsigned int m_frame_count;
 
   void CaptureData(uint8_t command, const uint8_t *data, unsigned int length) {
     m_received_data.Set(data, length);
@@ -67,6 +71,19 @@ class OPCClientTest: public CppUnit::TestFixture {
     m_ss.Terminate();
   }
 
+  void CaptureFrame(DmxBuffer *output, uint8_t, const uint8_t *data,
+                    unsigned int length) {
+    output->Set(data, length);
+    if (++m_frame_count == 2) {
+      m_ss.Terminate();
+    }
+  }
+
+  void Connected(bool connected) {
+    OLA_ASSERT_TRUE(connected);
+    m_ss.Terminate();
+  }
+
   void SendDMX(OPCClient *client, DmxBuffer *buffer, bool connected) {
     if (connected) {
       OLA_ASSERT_TRUE(client->SendDmx(CHANNEL, *buffer));
@@ -76,6 +93,7 @@ class OPCClientTest: public CppUnit::TestFixture {
   }
 
   static const uint8_t CHANNEL = 1;
+  static const uint8_t CHANNEL2 = 2;
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(OPCClientTest);
@@ -111,3 +129,37 @@ void OPCClientTest::testTransmit() {
   // Now sends should fail since there is no connection
   OLA_ASSERT_FALSE(client.SendDmx(CHANNEL, buffer));
 }
+
+/*
+ * Check that only the latest frame for each channel in a batch is sent.
+ */
+void OPCClientTest::testBatch() {
+  m_frame_count = 0;
+  m_server->SetCallback(
+      CHANNEL,
+      ola::NewCallback(this, &OPCClientTest::CaptureFrame, &m_received_data));
+  m_server->SetCallback(
+      CHANNEL2,
+      ola::NewCallback(this, &OPCClientTest::CaptureFrame, &m_received_data2));
+
+  OPCClient client(&m_ss, m_server->ListenAddress());
+  client.SetSocketCallback(
+      ola::NewCallback(this, &OPCClientTest::Connected));
+  m_ss.Run();
+
+  DmxBuffer old_buffer, buffer, buffer2;
+  old_buffer.SetFromString("9,9,9");
+  buffer.SetFromString("1,2,3,4");
+  buffer2.SetFromString("5,6,7");
+
+  client.BeginBatch();
+  OLA_ASSERT_TRUE(client.SendDmx(CHANNEL, old_buffer));
+  OLA_ASSERT_TRUE(client.SendDmx(CHANNEL2, buffer2));
+  OLA_ASSERT_TRUE(client.SendDmx(CHANNEL, buffer));
+  client.EndBatch();
+
+  m_ss.Run();
+  OLA_ASSERT_EQ(2u, m_frame_count);
+  OLA_ASSERT_EQ(buffer, m_received_data);
+  OLA_ASSERT_EQ(buffer2, m_received_data2);
+}
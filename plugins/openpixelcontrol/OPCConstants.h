@@ -46,6 +46,21 @@ enum {
  */
 static const uint8_t SET_PIXEL_COMMAND = 0;
 
+/**
+ * @brief The set-pixel command with 16 bit, big endian, values.
+ */
+static const uint8_t SET_PIXEL_16_COMMAND = 2;
+
+/**
+ * @brief The system exclusive command.
+ */
+static const uint8_t SYSTEM_EXCLUSIVE_COMMAND = 0xff;
+
+/**
+ * @brief The broadcast channel, frames on this channel go to all channels.
+ */
+static const uint8_t BROADCAST_CHANNEL = 0;
+
 }  // namespace openpixelcontrol
 }  // namespace plugin
 }  // namespace ola
@@ -82,11 +82,34 @@ bool OPCServerDevice::StartHook() {
   str << "listen_" << m_listen_addr << "_channel";
   set<uint8_t> channels = DeDupChannels(
       m_preferences->GetMultipleValue(str.str()));
+
+  // Large channels can be split across several universes, in which case each
+  // universe gets a whole number of RGB pixels.
+  ostringstream universes_key;
+  universes_key << "listen_" << m_listen_addr << "_universes_per_channel";
+  unsigned int universes_per_channel = 1;
+  const string universes = m_preferences->GetValue(universes_key.str());
+  if (!universes.empty() &&
+      (!StringToInt(universes, &universes_per_channel) ||
+       universes_per_channel == 0 ||
+       universes_per_channel > MAX_UNIVERSES_PER_CHANNEL)) {
+    OLA_WARN << "Invalid value for " << universes_key.str() << ": "
+             << universes;
+    universes_per_channel = 1;
+  }
+  unsigned int slots = DMX_UNIVERSE_SIZE;
+  if (universes_per_channel > 1) {
+    slots = SLOTS_PER_SPLIT_UNIVERSE;
+  }
+
   set<uint8_t>::const_iterator iter = channels.begin();
   for (; iter != channels.end(); ++iter) {
-    OPCInputPort *port = new OPCInputPort(this, *iter, m_plugin_adaptor,
-                                          m_server.get());
-    AddPort(port);
+    for (unsigned int i = 0; i < universes_per_channel; i++) {
+      OPCInputPort *port = new OPCInputPort(
+          this, *iter * universes_per_channel + i, *iter, i * slots, slots,
+          m_plugin_adaptor, m_server.get());
+      AddPort(port);
+    }
   }
   return true;
 }
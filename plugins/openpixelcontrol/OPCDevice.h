@@ -63,6 +63,11 @@ class OPCServerDevice: public ola::Device {
   const ola::network::IPV4SocketAddress m_listen_addr;
   std::auto_ptr<class OPCServer> m_server;
 
+  // A 16 bit OPC frame holds up to 128 universes.
+  static const unsigned int MAX_UNIVERSES_PER_CHANNEL = 128;
+  // 170 RGB pixels.
+  static const unsigned int SLOTS_PER_SPLIT_UNIVERSE = 510;
+
   DISALLOW_COPY_AND_ASSIGN(OPCServerDevice);
 };
 
@@ -42,6 +42,9 @@ class OPCPlugin: public Plugin {
   std::string Description() const;
   std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
  private:
   typedef std::vector<ola::Device*> OPCDevices;
   OPCDevices m_devices;
@@ -54,8 +57,6 @@ class OPCPlugin: public Plugin {
   void AddDevices(const std::string &key);
 
   static const char LISTEN_KEY[];
-  static const char PLUGIN_NAME[];
-  static const char PLUGIN_PREFIX[];
   static const char TARGET_KEY[];
 };
 }  // namespace openpixelcontrol
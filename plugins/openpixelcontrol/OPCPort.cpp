@@ -20,7 +20,9 @@
 
 #include "plugins/openpixelcontrol/OPCPort.h"
 
+#include <algorithm>
 #include <string>
+#include "ola/Logging.h"
 #include "ola/base/Macro.h"
 #include "plugins/openpixelcontrol/OPCClient.h"
 #include "plugins/openpixelcontrol/OPCConstants.h"
@@ -34,13 +36,18 @@ namespace openpixelcontrol {
 using std::string;
 
 OPCInputPort::OPCInputPort(OPCServerDevice *parent,
+                           unsigned int port_id,
                            uint8_t channel,
+                           unsigned int offset,
+                           unsigned int size,
                            class PluginAdaptor *plugin_adaptor,
                            class OPCServer *server)
-    : BasicInputPort(parent, channel, plugin_adaptor),
+    : BasicInputPort(parent, port_id, plugin_adaptor),
       m_channel(channel),
+      m_offset(offset),
+      m_size(size),
       m_server(server) {
-  m_server->SetCallback(channel, NewCallback(this, &OPCInputPort::NewData));
+  m_server->AddCallback(channel, NewCallback(this, &OPCInputPort::NewData));
 }
 
 void OPCInputPort::NewData(uint8_t command,
@@ -51,7 +58,10 @@ void OPCInputPort::NewData(uint8_t command,
               << static_cast<int>(command);
     return;
   }
-  m_buffer.Set(data, length);
+  if (length <= m_offset) {
+    return;
+  }
+  m_buffer.Set(data + m_offset, std::min(length - m_offset, m_size));
   DmxChanged();
 }
 
@@ -59,6 +69,9 @@ string OPCInputPort::Description() const {
   std::ostringstream str;
   str << m_server->ListenAddress() << ", Channel "
       << static_cast<int>(m_channel);
+  if (m_offset || m_size != DMX_UNIVERSE_SIZE) {
+    str << ", Slots " << m_offset + 1 << "-" << m_offset + m_size;
+  }
   return str.str();
 }
 
@@ -75,6 +88,14 @@ bool OPCOutputPort::WriteDMX(const DmxBuffer &buffer,
   return m_client->SendDmx(m_channel, buffer);
 }
 
+void OPCOutputPort::BeginBatch() {
+  m_client->BeginBatch();
+}
+
+void OPCOutputPort::EndBatch() {
+  m_client->EndBatch();
+}
+
 string OPCOutputPort::Description() const {
   std::ostringstream str;
   str << m_client->GetRemoteAddress() << ", Channel "
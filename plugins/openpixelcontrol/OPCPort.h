@@ -40,12 +40,18 @@ class OPCInputPort: public BasicInputPort {
   /**
    * @brief Create a new OPC Input Port.
    * @param parent the OPCDevice this port belongs to
+   * @param port_id the id of the port.
    * @param channel the OPC channel for the port.
+   * @param offset the offset of the port's slots in the channel data.
+   * @param size the maximum number of slots for the port.
    * @param plugin_adaptor the PluginAdaptor to use
    * @param server the OPCServer to use, ownership is not transferred.
    */
   OPCInputPort(OPCServerDevice *parent,
+               unsigned int port_id,
                uint8_t channel,
+               unsigned int offset,
+               unsigned int size,
                class PluginAdaptor *plugin_adaptor,
                class OPCServer *server);
 
@@ -57,6 +63,8 @@ class OPCInputPort: public BasicInputPort {
 
  private:
   const uint8_t m_channel;
+  const unsigned int m_offset;
+  const unsigned int m_size;
   class OPCServer* const m_server;
   DmxBuffer m_buffer;
 
@@ -82,6 +90,8 @@ class OPCOutputPort: public BasicOutputPort {
                 class OPCClient *client);
 
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
+  void BeginBatch();
+  void EndBatch();
 
   std::string Description() const;
 
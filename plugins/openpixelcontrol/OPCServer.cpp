@@ -20,13 +20,19 @@
 
 #include "plugins/openpixelcontrol/OPCServer.h"
 
+#include <string.h>
+#include <math.h>
+#include <algorithm>
 #include <string>
+#include <utility>
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/network/SocketAddress.h"
 #include "ola/stl/STLUtils.h"
 #include "ola/util/Utils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonLexer.h"
 
 namespace ola {
 namespace plugin {
@@ -36,6 +42,7 @@ using ola::network::GenericSocketAddress;
 using ola::network::IPV4SocketAddress;
 using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
+using ola::web::JsonDouble;
 using std::string;
 
 namespace {
@@ -43,6 +50,70 @@ namespace {
 void CleanupSocket(TCPSocket *socket) {
   delete socket;
 }
+
+/*
+ * Extracts the gamma and whitepoint from the JSON body of a Fadecandy color
+ * correction message. The other keys are ignored.
+ */
+class ColorCorrectionParser : public ola::web::JsonParserInterface {
+ public:
+  ColorCorrectionParser()
+      : gamma(1.0),
+        m_depth(0),
+        m_index(0),
+        m_in_whitepoint(false) {
+    whitepoint[0] = whitepoint[1] = whitepoint[2] = 1.0;
+  }
+
+  void Begin() {}
+  void End() {}
+  void String(const string&) {}
+  void Number(uint32_t value) { SetNumber(value); }
+  void Number(int32_t value) { SetNumber(value); }
+  void Number(uint64_t value) { SetNumber(value); }
+  void Number(int64_t value) { SetNumber(value); }
+  void Number(const JsonDouble::DoubleRepresentation &rep) {
+    double value;
+    if (JsonDouble::AsDouble(rep, &value)) {
+      SetNumber(value);
+    }
+  }
+  void Number(double value) { SetNumber(value); }
+  void Bool(bool) {}
+  void Null() {}
+  void OpenArray() {
+    m_in_whitepoint = m_depth == 1 && m_key == "whitepoint";
+    m_index = 0;
+    m_depth++;
+  }
+  void CloseArray() {
+    m_in_whitepoint = false;
+    m_depth--;
+  }
+  void OpenObject() { m_depth++; }
+  void ObjectKey(const string &key) { m_key = key; }
+  void CloseObject() { m_depth--; }
+  void SetError(const string &) {}
+
+  double gamma;
+  double whitepoint[3];
+
+ private:
+  unsigned int m_depth;
+  unsigned int m_index;
+  bool m_in_whitepoint;
+  string m_key;
+
+  void SetNumber(double value) {
+    if (m_in_whitepoint && m_depth == 2) {
+      if (m_index < arraysize(whitepoint)) {
+        whitepoint[m_index++] = value;
+      }
+    } else if (m_depth == 1 && m_key == "gamma") {
+      gamma = value;
+    }
+  }
+};
 }  // namespace
 
 void OPCServer::RxState::CheckSize() {
@@ -62,7 +133,8 @@ OPCServer::OPCServer(ola::io::SelectServerInterface *ss,
     : m_ss(ss),
       m_listen_addr(listen_addr),
       m_tcp_socket_factory(
-          ola::NewCallback(this, &OPCServer::NewTCPConnection)) {
+          ola::NewCallback(this, &OPCServer::NewTCPConnection)),
+      m_color_correction(false) {
 }
 
 OPCServer::~OPCServer() {
@@ -78,7 +150,10 @@ OPCServer::~OPCServer() {
     delete iter->second;
   }
 
-  STLDeleteValues(&m_callbacks);
+  ChannelCallbacks::iterator cb_iter = m_callbacks.begin();
+  for (; cb_iter != m_callbacks.end(); ++cb_iter) {
+    delete cb_iter->second;
+  }
 }
 
 bool OPCServer::Init() {
@@ -103,7 +178,20 @@ IPV4SocketAddress OPCServer::ListenAddress() const {
 }
 
 void OPCServer::SetCallback(uint8_t channel, ChannelCallback *callback) {
-  STLReplaceAndDelete(&m_callbacks, channel, callback);
+  std::pair<ChannelCallbacks::iterator, ChannelCallbacks::iterator> range =
+      m_callbacks.equal_range(channel);
+  for (ChannelCallbacks::iterator iter = range.first; iter != range.second;
+       ++iter) {
+    delete iter->second;
+  }
+  m_callbacks.erase(range.first, range.second);
+  AddCallback(channel, callback);
+}
+
+void OPCServer::AddCallback(uint8_t channel, ChannelCallback *callback) {
+  if (callback) {
+    m_callbacks.insert(ChannelCallbacks::value_type(channel, callback));
+  }
 }
 
 void OPCServer::NewTCPConnection(TCPSocket *socket) {
@@ -130,28 +218,102 @@ void OPCServer::SocketReady(TCPSocket *socket, RxState *rx_state) {
     SocketClosed(socket);
     return;
   }
-
   rx_state->offset += data_received;
-  if (rx_state->offset < OPC_HEADER_SIZE) {
+
+  // Handle all the complete frames in the buffer, in place.
+  unsigned int frame_start = 0;
+  while (rx_state->offset - frame_start >= OPC_HEADER_SIZE) {
+    uint8_t *frame = rx_state->data + frame_start;
+    const unsigned int length = utils::JoinUInt8(frame[2], frame[3]);
+    if (rx_state->offset - frame_start < length + OPC_HEADER_SIZE) {
+      break;
+    }
+    HandleFrame(frame[0], frame[1], frame + OPC_HEADER_SIZE, length);
+    frame_start += length + OPC_HEADER_SIZE;
+  }
+
+  // Move any partial frame to the start of the buffer.
+  if (frame_start) {
+    rx_state->offset -= frame_start;
+    memmove(rx_state->data, rx_state->data + frame_start, rx_state->offset);
+  }
+  if (rx_state->offset >= OPC_HEADER_SIZE) {
+    rx_state->CheckSize();
+  }
+}
+
+void OPCServer::HandleFrame(uint8_t channel, uint8_t command, uint8_t *data,
+                            unsigned int length) {
+  if (command == SYSTEM_EXCLUSIVE_COMMAND) {
+    HandleSystemExclusive(data, length);
     return;
   }
 
-  rx_state->CheckSize();
-  if (rx_state->offset <
-      static_cast<unsigned int>(rx_state->expected_size) + OPC_HEADER_SIZE) {
+  if (command == SET_PIXEL_16_COMMAND) {
+    // Keep the most significant byte of each value.
+    length /= 2;
+    for (unsigned int i = 0; i < length; i++) {
+      data[i] = data[2 * i];
+    }
+    command = SET_PIXEL_COMMAND;
+  }
+
+  if (command == SET_PIXEL_COMMAND && m_color_correction) {
+    for (unsigned int i = 0; i < length; i++) {
+      data[i] = m_color_table[i % 3][data[i]];
+    }
+  }
+
+  ChannelCallbacks::iterator iter, end;
+  if (channel == BROADCAST_CHANNEL) {
+    iter = m_callbacks.begin();
+    end = m_callbacks.end();
+  } else {
+    std::pair<ChannelCallbacks::iterator, ChannelCallbacks::iterator> range =
+        m_callbacks.equal_range(channel);
+    iter = range.first;
+    end = range.second;
+  }
+  for (; iter != end; ++iter) {
+    iter->second->Run(command, data, length);
+  }
+}
+
+void OPCServer::HandleSystemExclusive(const uint8_t *data,
+                                      unsigned int length) {
+  if (length < 4) {
+    return;
+  }
+
+  const uint16_t system_id = utils::JoinUInt8(data[0], data[1]);
+  const uint16_t command = utils::JoinUInt8(data[2], data[3]);
+  if (system_id != FADECANDY_SYSTEM_ID ||
+      command != SET_COLOR_CORRECTION_COMMAND) {
+    OLA_DEBUG << "Ignoring OPC system exclusive message " << system_id << ":"
+              << command;
     return;
   }
 
-  ChannelCallback *cb = STLFindOrNull(m_callbacks, rx_state->data[0]);
-  if (cb) {
-    DmxBuffer buffer(rx_state->data + OPC_HEADER_SIZE,
-                     rx_state->offset - OPC_HEADER_SIZE);
-    cb->Run(rx_state->data[1],
-            rx_state->data + OPC_HEADER_SIZE,
-            rx_state->expected_size);
+  ColorCorrectionParser parser;
+  const string json(reinterpret_cast<const char*>(data + 4), length - 4);
+  if (!ola::web::JsonLexer::Parse(json, &parser)) {
+    OLA_WARN << "Invalid OPC color correction: " << json;
+    return;
+  }
+  SetColorCorrection(parser.gamma, parser.whitepoint);
+}
+
+void OPCServer::SetColorCorrection(double gamma, const double whitepoint[3]) {
+  m_color_correction = (gamma != 1.0 || whitepoint[0] != 1.0 ||
+                        whitepoint[1] != 1.0 || whitepoint[2] != 1.0);
+  for (unsigned int color = 0; color < 3; color++) {
+    for (unsigned int i = 0; i < arraysize(m_color_table[color]); i++) {
+      double value = (pow(i / 255.0, gamma) * whitepoint[color] * 255.0 +
+                      0.5);
+      m_color_table[color][i] = static_cast<uint8_t>(
+          std::max(0.0, std::min(value, 255.0)));
+    }
   }
-  rx_state->offset = 0;
-  rx_state->expected_size = 0;
 }
 
 void OPCServer::SocketClosed(TCPSocket *socket) {
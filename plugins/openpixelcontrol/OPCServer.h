@@ -45,6 +45,10 @@ class OPCServer {
  public:
   /**
    * @brief The callback executed when new OPC data arrives.
+   *
+   * The data points into the receive buffer, and is only valid until the
+   * callback returns. 16 bit frames are passed as 8 bit SET_PIXEL_COMMAND
+   * frames.
    */
   typedef Callback3<void, uint8_t, const uint8_t*, unsigned int>
       ChannelCallback;
@@ -77,6 +81,14 @@ class OPCServer {
    */
   void SetCallback(uint8_t channel, ChannelCallback *callback);
 
+  /**
+   * @brief Add another callback for a channel, this allows the data for a
+   *   channel to be split across multiple ports.
+   * @param channel the OPC channel this callback is for.
+   * @param callback The callback to run, ownership is transferred.
+   */
+  void AddCallback(uint8_t channel, ChannelCallback *callback);
+
   /**
    * @brief The listen address of this server
    * @returns The listen address of the server. If the server isn't listening
@@ -107,6 +119,7 @@ class OPCServer {
   };
 
   typedef std::map<ola::network::TCPSocket*, RxState*> ClientMap;
+  typedef std::multimap<uint8_t, ChannelCallback*> ChannelCallbacks;
 
   ola::io::SelectServerInterface* const m_ss;
   const ola::network::IPV4SocketAddress m_listen_addr;
@@ -114,11 +127,21 @@ class OPCServer {
 
   std::auto_ptr<ola::network::TCPAcceptingSocket> m_listening_socket;
   ClientMap m_clients;
-  std::map<uint8_t, ChannelCallback*> m_callbacks;
+  ChannelCallbacks m_callbacks;
+  // Set by the global color correction system exclusive message.
+  bool m_color_correction;
+  uint8_t m_color_table[3][256];
 
   void NewTCPConnection(ola::network::TCPSocket *socket);
   void SocketReady(ola::network::TCPSocket *socket, RxState *rx_state);
   void SocketClosed(ola::network::TCPSocket *socket);
+  void HandleFrame(uint8_t channel, uint8_t command, uint8_t *data,
+                   unsigned int length);
+  void HandleSystemExclusive(const uint8_t *data, unsigned int length);
+  void SetColorCorrection(double gamma, const double whitepoint[3]);
+
+  static const uint16_t FADECANDY_SYSTEM_ID = 0x0001;
+  static const uint16_t SET_COLOR_CORRECTION_COMMAND = 0x0001;
 
   DISALLOW_COPY_AND_ASSIGN(OPCServer);
 };
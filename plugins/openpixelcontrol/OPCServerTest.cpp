@@ -20,6 +20,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <string.h>
 #include <memory>
 #include "ola/base/Array.h"
 #include "ola/Callback.h"
@@ -47,12 +48,17 @@ class OPCServerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testUnknownCommand);
   CPPUNIT_TEST(testLargeFrame);
   CPPUNIT_TEST(testHangingFrame);
+  CPPUNIT_TEST(testMultipleFrames);
+  CPPUNIT_TEST(testBroadcast);
+  CPPUNIT_TEST(test16BitFrame);
+  CPPUNIT_TEST(testColorCorrection);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   OPCServerTest()
       : CppUnit::TestFixture(),
-        m_ss(NULL) {
+        m_ss(NULL),
+        m_frame_count(0) {
   }
   void setUp();
 
@@ -60,6 +66,10 @@ class OPCServerTest: public CppUnit::TestFixture {
   void testUnknownCommand();
   void testLargeFrame();
   void testHangingFrame();
+  void testMultipleFrames();
+  void testBroadcast();
+  void test16BitFrame();
+  void testColorCorrection();
 
  private:
   ola::io::SelectServer m_ss;
@@ -67,6 +77,7 @@ class OPCServerTest: public CppUnit::TestFixture {
   auto_ptr<TCPSocket> m_client_socket;
   DmxBuffer m_received_data;
   uint8_t m_command;
+  unsigned int m_frame_count;
 
   void SendDataAndCheck(uint8_t channel,
                         const DmxBuffer &data);
@@ -74,6 +85,7 @@ class OPCServerTest: public CppUnit::TestFixture {
   void CaptureData(uint8_t command, const uint8_t *data, unsigned int length) {
     m_received_data.Set(data, length);
     m_command = command;
+    m_frame_count++;
     m_ss.Terminate();
   }
 
@@ -151,3 +163,59 @@ void OPCServerTest::testHangingFrame() {
   uint8_t data[] = {1, 0};
   m_client_socket->Send(data, arraysize(data));
 }
+
+void OPCServerTest::testMultipleFrames() {
+  // Both frames are handled from a single read.
+  uint8_t data[] = {1, 0, 0, 2, 1, 2, 1, 0, 0, 3, 4, 5, 6};
+  m_client_socket->Send(data, arraysize(data));
+  m_ss.Run();
+
+  DmxBuffer buffer;
+  buffer.SetFromString("4,5,6");
+  OLA_ASSERT_EQ(2u, m_frame_count);
+  OLA_ASSERT_EQ(m_received_data, buffer);
+}
+
+void OPCServerTest::testBroadcast() {
+  DmxBuffer buffer;
+  buffer.SetFromString("7,8,9");
+  SendDataAndCheck(0, buffer);
+}
+
+void OPCServerTest::test16BitFrame() {
+  uint8_t data[] = {1, 2, 0, 6, 0x12, 0x34, 0xff, 0x00, 0x80, 0x01};
+  m_client_socket->Send(data, arraysize(data));
+  m_ss.Run();
+
+  DmxBuffer buffer;
+  buffer.SetFromString("18,255,128");
+  OLA_ASSERT_EQ(static_cast<uint8_t>(SET_PIXELS_COMMAND), m_command);
+  OLA_ASSERT_EQ(m_received_data, buffer);
+}
+
+void OPCServerTest::testColorCorrection() {
+  const char json[] = "{\"gamma\": 1.0, \"whitepoint\": [0.5, 1.0, 0.25]}";
+  const unsigned int json_size = sizeof(json) - 1;
+  const unsigned int sysex_size = json_size + 4;
+  uint8_t data[sysex_size + 4 + 7];
+  data[0] = 0;
+  data[1] = 0xff;
+  ola::utils::SplitUInt16(static_cast<uint16_t>(sysex_size), &data[2],
+                          &data[3]);
+  // The Fadecandy system id and set global color correction command.
+  data[4] = 0;
+  data[5] = 1;
+  data[6] = 0;
+  data[7] = 1;
+  memcpy(data + 8, json, json_size);
+
+  const uint8_t pixels[] = {1, 0, 0, 3, 200, 200, 200};
+  memcpy(data + sysex_size + 4, pixels, sizeof(pixels));
+  m_client_socket->Send(data, arraysize(data));
+  m_ss.Run();
+
+  DmxBuffer buffer;
+  buffer.SetFromString("100,200,50");
+  OLA_ASSERT_EQ(1u, m_frame_count);
+  OLA_ASSERT_EQ(m_received_data, buffer);
+}
@@ -8,6 +8,8 @@ plugins_osc_libolaoscnode_la_SOURCES = \
     plugins/osc/OSCAddressTemplate.h \
     plugins/osc/OSCNode.cpp \
     plugins/osc/OSCNode.h \
+    plugins/osc/OSCParser.cpp \
+    plugins/osc/OSCParser.h \
     plugins/osc/OSCTarget.h
 plugins_osc_libolaoscnode_la_CXXFLAGS = $(COMMON_CXXFLAGS) $(liblo_CFLAGS)
 plugins_osc_libolaoscnode_la_LIBADD = $(liblo_LIBS)
@@ -39,7 +41,8 @@ test_programs += plugins/osc/OSCTester
 
 plugins_osc_OSCTester_SOURCES = \
     plugins/osc/OSCAddressTemplateTest.cpp \
-    plugins/osc/OSCNodeTest.cpp
+    plugins/osc/OSCNodeTest.cpp \
+    plugins/osc/OSCParserTest.cpp
 plugins_osc_OSCTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 plugins_osc_OSCTester_LDADD = $(COMMON_TESTING_LIBS) \
                   plugins/osc/libolaoscnode.la \
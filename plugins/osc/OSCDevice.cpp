@@ -40,6 +40,7 @@ const char OSCDevice::DEVICE_NAME[] = "OSC Device";
  * @param owner the plugin which created this device
  * @param plugin_adaptor a pointer to a PluginAdaptor object
  * @param udp_port the UDP port to listen on
+ * @param receive_options the options for the UDP receive stats
  * @param addresses a list of strings to use as OSC addresses for the input
  *   ports.
  * @param port_configs config to use for the ports
@@ -47,6 +48,7 @@ const char OSCDevice::DEVICE_NAME[] = "OSC Device";
 OSCDevice::OSCDevice(AbstractPlugin *owner,
                      PluginAdaptor *plugin_adaptor,
                      uint16_t udp_port,
+                     const ola::network::UDPReceiveOptions &receive_options,
                      const vector<string> &addresses,
                      const PortConfigs &port_configs)
     : Device(owner, DEVICE_NAME),
@@ -55,6 +57,7 @@ OSCDevice::OSCDevice(AbstractPlugin *owner,
       m_port_configs(port_configs) {
   OSCNode::OSCNodeOptions options;
   options.listen_port = udp_port;
+  options.receive_options = receive_options;
   // allocate a new OSCNode but delay the call to Init() until later
   m_osc_node.reset(new OSCNode(plugin_adaptor, plugin_adaptor->GetExportMap(),
                                options));
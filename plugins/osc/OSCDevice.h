@@ -51,6 +51,7 @@ class OSCDevice: public Device {
     OSCDevice(AbstractPlugin *owner,
               PluginAdaptor *plugin_adaptor,
               uint16_t udp_port,
+              const ola::network::UDPReceiveOptions &receive_options,
               const std::vector<std::string> &addresses,
               const PortConfigs &port_configs);
     std::string DeviceId() const { return "1"; }
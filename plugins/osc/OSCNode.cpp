@@ -18,16 +18,28 @@
  * Copyright (C) 2012 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #ifdef _WIN32
 #include <ola/win/CleanWinSock2.h>
 #endif  // _WIN32
 
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif  // HAVE_SYS_SOCKET_H
+
+#include <errno.h>
+
 #include <ola/Callback.h>
 #include <ola/Constants.h>
 #include <ola/ExportMap.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
+#include <ola/network/NetworkUtils.h>
 #include <ola/stl/STLUtils.h>
+#include <string.h>
 #include <algorithm>
 #include <string>
 #include <utility>
@@ -55,6 +67,7 @@ class UnmanagedSocketDescriptor : public ola::io::UnmanagedFileDescriptor {
 
 using ola::IntToString;
 using ola::io::SelectServerInterface;
+using ola::network::HostToNetwork;
 using std::make_pair;
 using std::max;
 using std::min;
@@ -63,6 +76,22 @@ using std::vector;
 
 const char OSCNode::OSC_PORT_VARIABLE[] = "osc-listen-port";
 
+namespace {
+// "#bundle" followed by the 'immediately' time tag.
+const uint8_t BUNDLE_HEADER[] = {
+  '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+  0, 0, 0, 0, 0, 0, 0, 1
+};
+
+const uint8_t INT_TYPE_TAG[] = {',', 'i', 0, 0};
+const uint8_t FLOAT_TYPE_TAG[] = {',', 'f', 0, 0};
+
+void WriteUInt32(uint32_t value, uint8_t *ptr) {
+  value = HostToNetwork(value);
+  memcpy(ptr, &value, sizeof(value));
+}
+}  // namespace
+
 /*
  * The Error handler for the OSC server.
  */
@@ -80,112 +109,65 @@ void OSCErrorHandler(int error_code, const char *msg, const char *stack) {
 
 
 /**
- * Extract the slot number and group address from an OSC address
+ * Extract the slot number from the last component of an OSC address.
+ * @param osc_address the OSC address
+ * @param group_length set to the length of the group address
+ * @param slot set to the slot offset
  */
-bool ExtractSlotFromPath(const string &osc_address,
-                         string *group_address,
+bool ExtractSlotFromPath(const char *osc_address,
+                         unsigned int *group_length,
                          uint16_t *slot) {
-  size_t pos = osc_address.find_last_of("/");
-  if (pos == string::npos) {
+  const char *slot_str = strrchr(osc_address, '/');
+  if (!slot_str || !slot_str[1]) {
     OLA_WARN << "Got invalid OSC message to " << osc_address;
     return false;
   }
-  if (!StringToInt(osc_address.substr(pos + 1), slot, true)) {
-    OLA_WARN << "Unable to extract slot from " << osc_address.substr(pos + 1);
-    return false;
-  }
 
-  if (*slot == 0 || *slot > DMX_UNIVERSE_SIZE) {
-    OLA_WARN << "Ignoring slot " << *slot;
-    return 0;
+  unsigned int value = 0;
+  for (const char *ptr = slot_str + 1; *ptr; ptr++) {
+    if (*ptr < '0' || *ptr > '9' || value > DMX_UNIVERSE_SIZE) {
+      OLA_WARN << "Unable to extract slot from " << slot_str + 1;
+      return false;
+    }
+    value = value * 10 + (*ptr - '0');
   }
-  (*slot)--;
 
-  *group_address = osc_address.substr(0, pos);
+  if (value == 0 || value > DMX_UNIVERSE_SIZE) {
+    OLA_WARN << "Ignoring slot " << value;
+    return false;
+  }
+  *slot = static_cast<uint16_t>(value - 1);
+  *group_length = static_cast<unsigned int>(slot_str - osc_address);
   return true;
 }
 
 /**
  * Extract the slot and value from a tuple (either ii or if)
  */
-bool ExtractSlotValueFromPair(const string &type, lo_arg **argv,
-                              int argc, uint16_t *slot, uint8_t *value) {
-  if (argc != 2 || !(type == "ii" || type == "if")) {
-    OLA_WARN << "Unknown OSC message type " << type;
+bool ExtractSlotValueFromPair(const OSCMessage &message, uint16_t *slot,
+                              uint8_t *value) {
+  if (strcmp(message.types, "ii") && strcmp(message.types, "if")) {
+    OLA_WARN << "Unknown OSC message type " << message.types;
     return false;
   }
 
-  int raw_slot = argv[0]->i;
+  int raw_slot = message.arguments[0].int_value;
   if (raw_slot <= 0 || raw_slot > DMX_UNIVERSE_SIZE) {
     OLA_WARN << "Invalid slot # " << raw_slot;
     return false;
   }
   *slot = static_cast<uint16_t>(raw_slot - 1);
 
-  if (type == "ii") {
-    *value = min(static_cast<int>(DMX_MAX_SLOT_VALUE), max(0, argv[1]->i));
-  } else if (type == "if") {
-    float val = max(0.0f, min(1.0f, argv[1]->f));
+  const OSCArgument &arg = message.arguments[1];
+  if (arg.type == 'i') {
+    *value = min(static_cast<int>(DMX_MAX_SLOT_VALUE), max(0, arg.int_value));
+  } else {
+    float val = max(0.0f, min(1.0f, arg.float_value));
     *value = val * DMX_MAX_SLOT_VALUE;
   }
-
   return true;
 }
 
-/**
- * Called when liblo receives data.
- * @param osc_address the OSC Address this data was sent to
- * @param types the OSC data type for the data
- * @param argv the data itself
- * @param argc the number of data blocks
- * @param user_data a pointer to the OSCNode object.
- */
-int OSCDataHandler(const char *osc_address, const char *types, lo_arg **argv,
-                   int argc, void *, void *user_data) {
-  OLA_DEBUG << "Got OSC message for " << osc_address << ", types are " << types;
-
-  OSCNode *node = reinterpret_cast<OSCNode*>(user_data);
-  const string type(types);
-  uint16_t slot;
-
-  if (argc == 1) {
-    if (type == "b") {
-      lo_blob blob = argv[0];
-      unsigned int size = min(static_cast<uint32_t>(DMX_UNIVERSE_SIZE),
-                              lo_blob_datasize(blob));
-      node->SetUniverse(
-          osc_address, static_cast<uint8_t*>(lo_blob_dataptr(blob)), size);
-      return 0;
-    } else if (type == "f") {
-      float val = max(0.0f, min(1.0f, argv[0]->f));
-      string group_address;
-      if (!ExtractSlotFromPath(osc_address, &group_address, &slot))
-        return 0;
-
-      node->SetSlot(group_address, slot,  val * DMX_MAX_SLOT_VALUE);
-      return 0;
-    } else if (type == "i") {
-      int val = min(static_cast<int>(DMX_MAX_SLOT_VALUE), max(0, argv[0]->i));
-      string group_address;
-      if (!ExtractSlotFromPath(osc_address, &group_address, &slot))
-        return 0;
-
-      node->SetSlot(group_address, slot,  val);
-      return 0;
-    }
-  } else if (argc == 2) {
-    uint8_t value;
-    if (!ExtractSlotValueFromPair(type, argv, argc, &slot, &value)) {
-      return 0;
-    }
-
-    node->SetSlot(osc_address, slot,  value);
-    return 0;
-  }
-  OLA_WARN << "Unknown OSC message type " << type;
-  return 0;
-}
-
 
 OSCNode::NodeOSCTarget::NodeOSCTarget(const OSCTarget &target)
   : socket_address(target.socket_address),
@@ -211,7 +193,9 @@ OSCNode::OSCNode(SelectServerInterface *ss,
                  const OSCNodeOptions &options)
     : m_ss(ss),
       m_listen_port(options.listen_port),
-      m_osc_server(NULL) {
+      m_receive_options(options.receive_options),
+      m_osc_server(NULL),
+      m_parser(NewCallback(this, &OSCNode::HandleMessage)) {
   if (export_map) {
     // export the OSC listening port if we have an export map
     ola::IntegerVariable *osc_port_var =
@@ -254,16 +238,18 @@ bool OSCNode::Init() {
   m_descriptor.reset(new UnmanagedSocketDescriptor(fd));
 #else
   m_descriptor.reset(new ola::io::UnmanagedFileDescriptor(fd));
+  m_receive_stats.reset(new ola::network::UDPReceiveStats());
+  if (!m_receive_stats->Enable(fd, m_receive_options)) {
+    m_receive_stats.reset();
+  }
 #endif  // _WIN32
   m_descriptor->SetOnData(NewCallback(this, &OSCNode::DescriptorReady));
   m_ss->AddReadDescriptor(m_descriptor.get());
 
-  // liblo doesn't support address pattern matching. So rather than registering
-  // a bunch of handlers, we just register for any address matching the types
-  // we want, and handle the dispatching ourselves. NULL means 'any address'
-  // Similarly liblo tries to coerce types so rather than letting it do
-  // anything we just register for all types and sort it out ourselves.
-  lo_server_add_method(m_osc_server, NULL, NULL, OSCDataHandler, this);
+  // Bundles are encoded by us, so they're sent from a plain UDP socket.
+  if (!m_bundle_socket.Init()) {
+    OLA_WARN << "Failed to create the OSC bundle socket";
+  }
   return true;
 }
 
@@ -272,10 +258,6 @@ bool OSCNode::Init() {
  * Stop this node. This removes all registrations and targets.
  */
 void OSCNode::Stop() {
-  if (m_osc_server) {
-    lo_server_del_method(m_osc_server, NULL, NULL);
-  }
-
   // Clean up the m_output_map map
   OutputGroupMap::iterator group_iter = m_output_map.begin();
   for (; group_iter != m_output_map.end(); ++group_iter) {
@@ -292,12 +274,14 @@ void OSCNode::Stop() {
     // SelectServer and delete it.
     m_ss->RemoveReadDescriptor(m_descriptor.get());
     m_descriptor.reset();
+    m_receive_stats.reset();
   }
   if (m_osc_server) {
     // If there was an lo_server then free it.
     lo_server_free(m_osc_server);
     m_osc_server = NULL;
   }
+  m_bundle_socket.Close();
 }
 
 
@@ -388,6 +372,10 @@ bool OSCNode::SendData(unsigned int group, DataFormat data_format,
       return SendIndividualFloats(dmx_data, output_group);
     case FORMAT_FLOAT_ARRAY:
       return SendFloatArray(dmx_data, output_group->targets);
+    case FORMAT_INT_BUNDLE:
+      return SendBundles(dmx_data, output_group, false);
+    case FORMAT_FLOAT_BUNDLE:
+      return SendBundles(dmx_data, output_group, true);
     default:
       OLA_WARN << "Unimplemented data format";
       return false;
@@ -423,45 +411,121 @@ bool OSCNode::RegisterAddress(const string &osc_address,
     }
   } else {
     // deregister
-    STLRemoveAndDelete(&m_input_map, osc_address);
+    OSCInputGroup *universe_data = STLFindOrNull(m_input_map, osc_address);
+    if (universe_data) {
+      // This may be called from a callback while we're running the changed
+      // groups.
+      std::replace(m_changed_groups.begin(), m_changed_groups.end(),
+                   universe_data, static_cast<OSCInputGroup*>(NULL));
+      STLRemoveAndDelete(&m_input_map, osc_address);
+    }
   }
   return true;
 }
 
 
 /**
- * Called by OSCDataHandler when there is new data.
- * @param osc_address the OSC address this data arrived on
- * @param data the DmxBuffer containing the data.
- * @param size the number of slots.
+ * Handle a message decoded by the OSCParser.
+ * @param message the OSCMessage.
  */
-void OSCNode::SetUniverse(const string &osc_address, const uint8_t *data,
-                          unsigned int size) {
-  OSCInputGroup *universe_data = STLFindOrNull(m_input_map, osc_address);
-  if (!universe_data)
+void OSCNode::HandleMessage(const OSCMessage &message) {
+  OLA_DEBUG << "Got OSC message for " << message.address << ", types are "
+            << message.types;
+
+  uint16_t slot;
+  if (message.argument_count == 1) {
+    const OSCArgument &arg = message.arguments[0];
+    if (arg.type == 'b') {
+      OSCInputGroup *universe_data = LookupInputGroup(
+          message.address, static_cast<unsigned int>(strlen(message.address)));
+      if (universe_data) {
+        SetUniverse(universe_data, arg.data,
+                    min(static_cast<unsigned int>(DMX_UNIVERSE_SIZE),
+                        arg.size));
+      }
+      return;
+    } else if (arg.type == 'f' || arg.type == 'i') {
+      unsigned int group_length;
+      if (!ExtractSlotFromPath(message.address, &group_length, &slot))
+        return;
+
+      OSCInputGroup *universe_data = LookupInputGroup(message.address,
+                                                      group_length);
+      if (!universe_data)
+        return;
+
+      uint8_t value;
+      if (arg.type == 'f') {
+        float val = max(0.0f, min(1.0f, arg.float_value));
+        value = val * DMX_MAX_SLOT_VALUE;
+      } else {
+        value = min(static_cast<int>(DMX_MAX_SLOT_VALUE),
+                    max(0, arg.int_value));
+      }
+      SetSlot(universe_data, slot, value);
+      return;
+    }
+  } else if (message.argument_count == 2) {
+    uint8_t value;
+    if (!ExtractSlotValueFromPair(message, &slot, &value)) {
+      return;
+    }
+
+    OSCInputGroup *universe_data = LookupInputGroup(
+        message.address, static_cast<unsigned int>(strlen(message.address)));
+    if (universe_data) {
+      SetSlot(universe_data, slot, value);
+    }
     return;
+  }
+  OLA_WARN << "Unknown OSC message type " << message.types;
+}
+
+
+/**
+ * Find the input group for an address.
+ * @param osc_address the OSC address.
+ * @param length the number of characters of osc_address to use.
+ */
+OSCNode::OSCInputGroup *OSCNode::LookupInputGroup(const char *osc_address,
+                                                  unsigned int length) {
+  m_lookup_address.assign(osc_address, length);
+  return STLFindOrNull(m_input_map, m_lookup_address);
+}
 
+
+/**
+ * Set the data for an input group. The callback is run once the packet has
+ * been processed.
+ * @param universe_data the OSCInputGroup to update.
+ * @param data the new data.
+ * @param size the number of slots.
+ */
+void OSCNode::SetUniverse(OSCInputGroup *universe_data, const uint8_t *data,
+                          unsigned int size) {
   universe_data->dmx.Set(data, size);
-  if (universe_data->callback.get()) {
-    universe_data->callback->Run(universe_data->dmx);
-  }
+  MarkChanged(universe_data);
 }
 
+
 /**
- * Called by OSCDataHandler when there is new data.
- * @param osc_address the OSC address this data arrived on
+ * Set a single slot for an input group. The callback is run once the packet
+ * has been processed.
+ * @param universe_data the OSCInputGroup to update.
  * @param slot the slot offset to set.
  * @param value the DMX value for the slot
  */
-void OSCNode::SetSlot(const string &osc_address, uint16_t slot, uint8_t value) {
-  OSCInputGroup *universe_data = STLFindOrNull(m_input_map, osc_address);
-  if (!universe_data)
-    return;
-
+void OSCNode::SetSlot(OSCInputGroup *universe_data, uint16_t slot,
+                      uint8_t value) {
   universe_data->dmx.SetChannel(slot, value);
+  MarkChanged(universe_data);
+}
+
 
-  if (universe_data->callback.get()) {
-    universe_data->callback->Run(universe_data->dmx);
+void OSCNode::MarkChanged(OSCInputGroup *universe_data) {
+  if (!universe_data->changed) {
+    universe_data->changed = true;
+    m_changed_groups.push_back(universe_data);
   }
 }
 
@@ -481,8 +545,52 @@ uint16_t OSCNode::ListeningPort() const {
  * Called when the OSC FD is readable.
  */
 void OSCNode::DescriptorReady() {
-  // Call into liblo with a timeout of 0 so we don't block.
-  lo_server_recv_noblock(m_osc_server, 0);
+  // We read the socket ourselves, rather than using liblo's dispatching,
+  // since the OSCParser doesn't allocate memory for each message.
+  const int fd = lo_server_get_socket_fd(m_osc_server);
+  ssize_t size;
+#ifndef _WIN32
+  if (m_receive_stats.get()) {
+    struct iovec iov;
+    iov.iov_base = m_receive_buffer;
+    iov.iov_len = sizeof(m_receive_buffer);
+    uint8_t control[ola::network::UDPReceiveStats::CONTROL_SIZE];
+    struct msghdr header;
+    memset(&header, 0, sizeof(header));
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    header.msg_control = control;
+    header.msg_controllen = sizeof(control);
+    size = recvmsg(fd, &header, 0);
+    if (size >= 0) {
+      m_receive_stats->Update(&header);
+    }
+  } else {
+    size = recv(fd, reinterpret_cast<char*>(m_receive_buffer),
+                sizeof(m_receive_buffer), 0);
+  }
+#else
+  size = recv(fd, reinterpret_cast<char*>(m_receive_buffer),
+              sizeof(m_receive_buffer), 0);
+#endif  // _WIN32
+  if (size < 0) {
+    OLA_WARN << "Failed to receive OSC packet: " << strerror(errno);
+    return;
+  }
+  m_parser.ParsePacket(m_receive_buffer, static_cast<unsigned int>(size));
+
+  // Run the callbacks once for all the slots set by this packet.
+  for (unsigned int i = 0; i < m_changed_groups.size(); i++) {
+    OSCInputGroup *universe_data = m_changed_groups[i];
+    if (!universe_data) {
+      continue;
+    }
+    universe_data->changed = false;
+    if (universe_data->callback.get()) {
+      universe_data->callback->Run(universe_data->dmx);
+    }
+  }
+  m_changed_groups.clear();
 }
 
 
@@ -594,35 +702,37 @@ bool OSCNode::SendIndividualMessages(const DmxBuffer &dmx_data,
   bool ok = true;
   const OSCTargetVector &targets = group->targets;
 
-  vector<SlotMessage> messages;
+  vector<unsigned int> slots;
+  UpdateChangedSlots(dmx_data, group, &slots);
 
-  // We only send the slots that have changed.
-  for (unsigned int i = 0; i < dmx_data.Size(); ++i) {
-    if (i > group->dmx.Size() || dmx_data.Get(i) != group->dmx.Get(i)) {
-      SlotMessage message = {i, lo_message_new()};
-      if (osc_type == "i") {
-        lo_message_add_int32(message.message, dmx_data.Get(i));
-      } else {
-        lo_message_add_float(message.message, dmx_data.Get(i) / 255.0f);
-      }
-      messages.push_back(message);
+  vector<SlotMessage> messages;
+  vector<unsigned int>::const_iterator slot_iter = slots.begin();
+  for (; slot_iter != slots.end(); ++slot_iter) {
+    SlotMessage message = {*slot_iter, lo_message_new()};
+    if (osc_type == "i") {
+      lo_message_add_int32(message.message, dmx_data.Get(*slot_iter));
+    } else {
+      lo_message_add_float(message.message,
+                           dmx_data.Get(*slot_iter) / 255.0f);
     }
+    messages.push_back(message);
   }
-  group->dmx.Set(dmx_data);
 
   // Send all messages to each target.
   OSCTargetVector::const_iterator target_iter = targets.begin();
   for (; target_iter != targets.end(); ++target_iter) {
     OLA_DEBUG << "Sending to " << (*target_iter)->socket_address;
+    if ((*target_iter)->slot_paths.empty()) {
+      EncodeSlotPaths(*target_iter);
+    }
 
     vector<SlotMessage>::const_iterator message_iter = messages.begin();
     for (; message_iter != messages.end(); ++message_iter) {
-      std::ostringstream path;
-      path << (*target_iter)->osc_address << "/" << message_iter->slot + 1;
-
+      // The padding in the encoded path ends the C string.
+      const string &path = (*target_iter)->slot_paths[message_iter->slot];
       int ret = lo_send_message_from((*target_iter)->liblo_address,
                                      m_osc_server,
-                                     path.str().c_str(),
+                                     path.c_str(),
                                      message_iter->message);
       ok &= (ret > 0);
     }
@@ -636,6 +746,124 @@ bool OSCNode::SendIndividualMessages(const DmxBuffer &dmx_data,
 
   return ok;
 }
+
+
+/**
+ * Send the changed slots as individual messages, packed into as few bundles
+ * as possible.
+ * @param dmx_data the DmxBuffer to send
+ * @param group the OSCOutputGroup with the targets.
+ * @param use_floats true to send floats, false to send ints.
+ */
+bool OSCNode::SendBundles(const DmxBuffer &dmx_data,
+                          OSCOutputGroup *group,
+                          bool use_floats) {
+  vector<unsigned int> slots;
+  UpdateChangedSlots(dmx_data, group, &slots);
+  if (slots.empty()) {
+    return true;
+  }
+
+  const uint8_t *type_tag = use_floats ? FLOAT_TYPE_TAG : INT_TYPE_TAG;
+  memcpy(m_bundle, BUNDLE_HEADER, sizeof(BUNDLE_HEADER));
+
+  bool ok = true;
+  m_bundle_socket.BeginSendBatch();
+  OSCTargetVector::const_iterator target_iter = group->targets.begin();
+  for (; target_iter != group->targets.end(); ++target_iter) {
+    NodeOSCTarget *target = *target_iter;
+    if (target->slot_paths.empty()) {
+      EncodeSlotPaths(target);
+    }
+
+    unsigned int offset = sizeof(BUNDLE_HEADER);
+    vector<unsigned int>::const_iterator slot_iter = slots.begin();
+    for (; slot_iter != slots.end(); ++slot_iter) {
+      const string &path = target->slot_paths[*slot_iter];
+      // The path, the type tag and the argument.
+      const unsigned int message_size =
+          static_cast<unsigned int>(path.size() + 2 * sizeof(uint32_t));
+
+      if (offset + sizeof(uint32_t) + message_size > MAX_BUNDLE_SIZE) {
+        if (offset == sizeof(BUNDLE_HEADER)) {
+          OLA_WARN << "OSC address " << target->osc_address
+                   << " is too long to bundle";
+          ok = false;
+          break;
+        }
+        ok &= SendBundle(*target, offset);
+        offset = sizeof(BUNDLE_HEADER);
+      }
+
+      WriteUInt32(message_size, m_bundle + offset);
+      offset += sizeof(uint32_t);
+      memcpy(m_bundle + offset, path.data(), path.size());
+      offset += path.size();
+      memcpy(m_bundle + offset, type_tag, sizeof(uint32_t));
+      offset += sizeof(uint32_t);
+
+      uint32_t value = dmx_data.Get(*slot_iter);
+      if (use_floats) {
+        const float float_value = value / 255.0f;
+        memcpy(&value, &float_value, sizeof(value));
+      }
+      WriteUInt32(value, m_bundle + offset);
+      offset += sizeof(uint32_t);
+    }
+
+    if (offset > sizeof(BUNDLE_HEADER)) {
+      ok &= SendBundle(*target, offset);
+    }
+  }
+  ok &= m_bundle_socket.EndSendBatch();
+  return ok;
+}
+
+
+/**
+ * Send the bundle in m_bundle to a target.
+ * @param target the target to send to.
+ * @param size the size of the bundle.
+ */
+bool OSCNode::SendBundle(const NodeOSCTarget &target, unsigned int size) {
+  OLA_DEBUG << "Sending " << size << " byte bundle to "
+            << target.socket_address;
+  return m_bundle_socket.SendTo(m_bundle, size, target.socket_address) > 0;
+}
+
+
+/**
+ * Find the slots that have changed since the last frame for a group, and
+ * update the group's copy of the data.
+ * @param dmx_data the new DmxBuffer.
+ * @param group the OSCOutputGroup that holds the last values.
+ * @param slots populated with the offsets of the changed slots.
+ */
+void OSCNode::UpdateChangedSlots(const DmxBuffer &dmx_data,
+                                 OSCOutputGroup *group,
+                                 vector<unsigned int> *slots) {
+  for (unsigned int i = 0; i < dmx_data.Size(); ++i) {
+    if (i >= group->dmx.Size() || dmx_data.Get(i) != group->dmx.Get(i)) {
+      slots->push_back(i);
+    }
+  }
+  group->dmx.Set(dmx_data);
+}
+
+
+/**
+ * Build the OSC encoded address, <address>/<slot>, for each slot of a
+ * target. These are null terminated and padded to a multiple of 4 bytes.
+ */
+void OSCNode::EncodeSlotPaths(NodeOSCTarget *target) {
+  target->slot_paths.reserve(DMX_UNIVERSE_SIZE);
+  for (unsigned int i = 1; i <= DMX_UNIVERSE_SIZE; i++) {
+    string path = target->osc_address + "/" + IntToString(i);
+    path.resize((path.size() + sizeof(uint32_t)) & ~(sizeof(uint32_t) - 1),
+                '\0');
+    target->slot_paths.push_back(path);
+  }
+}
 }  // namespace osc
 }  // namespace plugin
 }  // namespace ola
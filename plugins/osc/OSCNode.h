@@ -21,19 +21,28 @@
 #ifndef PLUGINS_OSC_OSCNODE_H_
 #define PLUGINS_OSC_OSCNODE_H_
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <lo/lo.h>
 #include <ola/DmxBuffer.h>
 #include <ola/ExportMap.h>
 #include <ola/io/Descriptor.h>
 #include <ola/io/SelectServerInterface.h>
+#include <ola/network/Socket.h>
 #include <ola/network/SocketAddress.h>
+#include <ola/network/UDPReceiveStats.h>
 #include <stdint.h>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
+#include "plugins/osc/OSCParser.h"
 #include "plugins/osc/OSCTarget.h"
 
+#include HASH_MAP_H
+
 namespace ola {
 namespace plugin {
 namespace osc {
@@ -63,6 +72,10 @@ namespace osc {
  *   node.RegisterAddress("/dmx/1", NewCallback(...));
  *   // run the SelectServer
  *
+ *   Received packets are decoded by the OSCParser rather than liblo. The
+ *   callback for an address runs once per packet, even if a bundle updated
+ *   many slots.
+ *
  *   // once it's time to stop, de-register this address
  *   node.RegisterAddress("/dmx/1", NULL);
  */
@@ -75,11 +88,15 @@ class OSCNode {
     FORMAT_INT_INDIVIDUAL,
     FORMAT_FLOAT_ARRAY,
     FORMAT_FLOAT_INDIVIDUAL,
+    FORMAT_INT_BUNDLE,
+    FORMAT_FLOAT_BUNDLE,
   };
 
   // The options for the OSCNode object.
   struct OSCNodeOptions {
     uint16_t listen_port;  // UDP port to listen on
+    // Kernel drop counting & receive buffer tuning for the socket.
+    ola::network::UDPReceiveOptions receive_options;
 
     OSCNodeOptions() : listen_port(DEFAULT_OSC_PORT) {}
   };
@@ -104,11 +121,6 @@ class OSCNode {
   // Receiving methods
   bool RegisterAddress(const std::string &osc_address, DMXCallback *callback);
 
-  // Called by the liblo handlers.
-  void SetUniverse(const std::string &osc_address, const uint8_t *data,
-                   unsigned int size);
-  void SetSlot(const std::string &osc_address, uint16_t slot, uint8_t value);
-
   // The port OSC is listening on.
   uint16_t ListeningPort() const;
 
@@ -131,6 +143,8 @@ class OSCNode {
     ola::network::IPV4SocketAddress socket_address;
     std::string osc_address;
     lo_address liblo_address;
+    // The OSC encoded address for each slot, including the padding.
+    std::vector<std::string> slot_paths;
 
    private:
     NodeOSCTarget(const NodeOSCTarget&);
@@ -145,14 +159,19 @@ class OSCNode {
   };
 
   struct OSCInputGroup {
-    explicit OSCInputGroup(DMXCallback *callback) : callback(callback) {}
+    explicit OSCInputGroup(DMXCallback *callback)
+        : changed(false),
+          callback(callback) {
+    }
 
     DmxBuffer dmx;
+    bool changed;  // true if the data changed in the current packet.
     std::auto_ptr<DMXCallback> callback;
   };
 
   typedef std::map<unsigned int, OSCOutputGroup*> OutputGroupMap;
-  typedef std::map<std::string, OSCInputGroup*> InputUniverseMap;
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<std::string, OSCInputGroup*>
+      InputUniverseMap;
 
   struct SlotMessage {
     unsigned int slot;
@@ -161,12 +180,25 @@ class OSCNode {
 
   ola::io::SelectServerInterface *m_ss;
   const uint16_t m_listen_port;
+  const ola::network::UDPReceiveOptions m_receive_options;
   std::auto_ptr<ola::io::UnmanagedFileDescriptor> m_descriptor;
   lo_server m_osc_server;
+  ola::network::UDPSocket m_bundle_socket;
   OutputGroupMap m_output_map;
   InputUniverseMap m_input_map;
+  OSCParser m_parser;
+  // Reused to look up addresses without allocating.
+  std::string m_lookup_address;
+  std::vector<OSCInputGroup*> m_changed_groups;
 
   void DescriptorReady();
+  void HandleMessage(const OSCMessage &message);
+  OSCInputGroup *LookupInputGroup(const char *osc_address,
+                                  unsigned int length);
+  void SetUniverse(OSCInputGroup *group, const uint8_t *data,
+                   unsigned int size);
+  void SetSlot(OSCInputGroup *group, uint16_t slot, uint8_t value);
+  void MarkChanged(OSCInputGroup *group);
   bool SendBlob(const DmxBuffer &data, const OSCTargetVector &targets);
   bool SendIndividualFloats(const DmxBuffer &data,
                             OSCOutputGroup *group);
@@ -181,9 +213,27 @@ class OSCNode {
   bool SendIndividualMessages(const DmxBuffer &data,
                               OSCOutputGroup *group,
                               const std::string &osc_type);
+  bool SendBundles(const DmxBuffer &data,
+                   OSCOutputGroup *group,
+                   bool use_floats);
+  bool SendBundle(const NodeOSCTarget &target, unsigned int size);
+  void UpdateChangedSlots(const DmxBuffer &data,
+                          OSCOutputGroup *group,
+                          std::vector<unsigned int> *slots);
+
+  static void EncodeSlotPaths(NodeOSCTarget *target);
 
   static const uint16_t DEFAULT_OSC_PORT = 7770;
+  // The largest bundle that fits in an Ethernet frame.
+  static const unsigned int MAX_BUNDLE_SIZE = 1472;
+  // The largest UDP datagram.
+  static const unsigned int MAX_PACKET_SIZE = 65535;
   static const char OSC_PORT_VARIABLE[];
+
+  uint8_t m_bundle[MAX_BUNDLE_SIZE];
+  uint8_t m_receive_buffer[MAX_PACKET_SIZE];
+  // NULL unless the receive stats are supported.
+  std::auto_ptr<ola::network::UDPReceiveStats> m_receive_stats;
 };
 }  // namespace osc
 }  // namespace plugin
@@ -50,7 +50,9 @@ using std::auto_ptr;
 class OSCNodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OSCNodeTest);
   CPPUNIT_TEST(testSendBlob);
+  CPPUNIT_TEST(testSendBundle);
   CPPUNIT_TEST(testReceive);
+  CPPUNIT_TEST(testReceiveBundle);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -59,7 +61,10 @@ class OSCNodeTest: public CppUnit::TestFixture {
      */
     OSCNodeTest()
         : CppUnit::TestFixture(),
-          m_timeout_id(ola::thread::INVALID_TIMEOUT) {
+          m_timeout_id(ola::thread::INVALID_TIMEOUT),
+          m_expected_data(NULL),
+          m_expected_size(0),
+          m_dmx_callbacks(0) {
       OSCNode::OSCNodeOptions options;
       options.listen_port = 0;
       m_osc_node.reset(new OSCNode(&m_ss, NULL, options));
@@ -70,9 +75,11 @@ class OSCNodeTest: public CppUnit::TestFixture {
     void setUp();
     void tearDown() { m_osc_node->Stop(); }
 
-    // our two tests
+    // our tests
     void testSendBlob();
+    void testSendBundle();
     void testReceive();
+    void testReceiveBundle();
 
     // Called if we don't receive data in ABORT_TIMEOUT_IN_MS
     void Timeout() { OLA_FAIL("timeout"); }
@@ -84,7 +91,11 @@ class OSCNodeTest: public CppUnit::TestFixture {
     ola::thread::timeout_id m_timeout_id;
     DmxBuffer m_dmx_data;
     DmxBuffer m_received_data;
+    const uint8_t *m_expected_data;
+    unsigned int m_expected_size;
+    unsigned int m_dmx_callbacks;
 
+    void SetupReceiveSocket(IPV4SocketAddress *socket_address);
     void UDPSocketReady();
     void DMXHandler(const DmxBuffer &dmx);
 
@@ -92,6 +103,8 @@ class OSCNodeTest: public CppUnit::TestFixture {
     // The number of mseconds to wait before failing the test.
     static const int ABORT_TIMEOUT_IN_MS = 2000;
     static const uint8_t OSC_BLOB_DATA[];
+    static const uint8_t OSC_INT_BUNDLE_DATA[];
+    static const uint8_t OSC_CHANGED_BUNDLE_DATA[];
     static const uint8_t OSC_SINGLE_FLOAT_DATA[];
     static const uint8_t OSC_SINGLE_INT_DATA[];
     static const uint8_t OSC_INT_TUPLE_DATA[];
@@ -116,6 +129,47 @@ const uint8_t OSCNodeTest::OSC_BLOB_DATA[] = {
   8, 9, 0xa, 0
 };
 
+// An OSC bundle with int messages for slots 1 & 2.
+const uint8_t OSCNodeTest::OSC_INT_BUNDLE_DATA[] = {
+  // bundle header and time tag
+  '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+  0, 0, 0, 0, 0, 0, 0, 1,
+  // message size
+  0, 0, 0, 28,
+  // osc address
+  '/', 'd', 'm', 'x', '/', 'u', 'n', 'i',
+  'v', 'e', 'r', 's', 'e', '/', '1', '0',
+  '/', '1', 0, 0,
+  // tag type & data
+  ',', 'i', 0, 0,
+  0, 0, 0, 10,
+  // message size
+  0, 0, 0, 28,
+  // osc address
+  '/', 'd', 'm', 'x', '/', 'u', 'n', 'i',
+  'v', 'e', 'r', 's', 'e', '/', '1', '0',
+  '/', '2', 0, 0,
+  // tag type & data
+  ',', 'i', 0, 0,
+  0, 0, 0, 20
+};
+
+// An OSC bundle with just the changed slot 2.
+const uint8_t OSCNodeTest::OSC_CHANGED_BUNDLE_DATA[] = {
+  // bundle header and time tag
+  '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+  0, 0, 0, 0, 0, 0, 0, 1,
+  // message size
+  0, 0, 0, 28,
+  // osc address
+  '/', 'd', 'm', 'x', '/', 'u', 'n', 'i',
+  'v', 'e', 'r', 's', 'e', '/', '1', '0',
+  '/', '2', 0, 0,
+  // tag type & data
+  ',', 'i', 0, 0,
+  0, 0, 0, 30
+};
+
 // An OSC single float packet for slot 1
 const uint8_t OSCNodeTest::OSC_SINGLE_FLOAT_DATA[] = {
   // osc address
@@ -199,7 +253,7 @@ void OSCNodeTest::UDPSocketReady() {
   // Read the received packet into 'data'.
   OLA_ASSERT_TRUE(m_udp_socket.RecvFrom(data, &data_read));
   // Verify it matches the expected packet
-  OLA_ASSERT_DATA_EQUALS(OSC_BLOB_DATA, sizeof(OSC_BLOB_DATA), data, data_read);
+  OLA_ASSERT_DATA_EQUALS(m_expected_data, m_expected_size, data, data_read);
   // Stop the SelectServer
   m_ss.Terminate();
 }
@@ -210,24 +264,36 @@ void OSCNodeTest::UDPSocketReady() {
  */
 void OSCNodeTest::DMXHandler(const DmxBuffer &dmx) {
   m_received_data = dmx;
+  m_dmx_callbacks++;
   m_ss.Terminate();
 }
 
 
 /**
- * Check that we send OSC messages correctly.
+ * Bind the UDP socket used to receive the messages the node sends.
+ * @param socket_address set to the local address of the socket.
  */
-void OSCNodeTest::testSendBlob() {
-  // First up create a UDP socket to receive the messages on.
+void OSCNodeTest::SetupReceiveSocket(IPV4SocketAddress *socket_address) {
   // Port 0 means 'ANY'
-  IPV4SocketAddress socket_address(IPV4Address::Loopback(), 0);
-  // Bind the socket, set the callback, and register with the select server.
-  OLA_ASSERT_TRUE(m_udp_socket.Bind(socket_address));
+  OLA_ASSERT_TRUE(m_udp_socket.Bind(
+      IPV4SocketAddress(IPV4Address::Loopback(), 0)));
   m_udp_socket.SetOnData(NewCallback(this, &OSCNodeTest::UDPSocketReady));
   OLA_ASSERT_TRUE(m_ss.AddReadDescriptor(&m_udp_socket));
   // Store the local address of the UDP socket so we know where to tell the
   // OSCNode to send to.
-  OLA_ASSERT_TRUE(m_udp_socket.GetSocketAddress(&socket_address));
+  OLA_ASSERT_TRUE(m_udp_socket.GetSocketAddress(socket_address));
+}
+
+
+/**
+ * Check that we send OSC messages correctly.
+ */
+void OSCNodeTest::testSendBlob() {
+  // First up create a UDP socket to receive the messages on.
+  IPV4SocketAddress socket_address;
+  SetupReceiveSocket(&socket_address);
+  m_expected_data = OSC_BLOB_DATA;
+  m_expected_size = sizeof(OSC_BLOB_DATA);
 
   // Setup the OSCTarget pointing to the local socket address
   OSCTarget target(socket_address, TEST_OSC_ADDRESS);
@@ -251,6 +317,33 @@ void OSCNodeTest::testSendBlob() {
 }
 
 
+/**
+ * Check that the changed slots are sent as a bundle.
+ */
+void OSCNodeTest::testSendBundle() {
+  IPV4SocketAddress socket_address;
+  SetupReceiveSocket(&socket_address);
+  m_osc_node->AddTarget(TEST_GROUP, OSCTarget(socket_address,
+                                              TEST_OSC_ADDRESS));
+
+  DmxBuffer dmx;
+  dmx.SetFromString("10,20");
+  m_expected_data = OSC_INT_BUNDLE_DATA;
+  m_expected_size = sizeof(OSC_INT_BUNDLE_DATA);
+  OLA_ASSERT_TRUE(m_osc_node->SendData(TEST_GROUP, OSCNode::FORMAT_INT_BUNDLE,
+                                       dmx));
+  m_ss.Run();
+
+  // Only the second slot has changed.
+  dmx.SetFromString("10,30");
+  m_expected_data = OSC_CHANGED_BUNDLE_DATA;
+  m_expected_size = sizeof(OSC_CHANGED_BUNDLE_DATA);
+  OLA_ASSERT_TRUE(m_osc_node->SendData(TEST_GROUP, OSCNode::FORMAT_INT_BUNDLE,
+                                       dmx));
+  m_ss.Run();
+}
+
+
 /**
  * Check that we receive OSC messages correctly.
  */
@@ -329,3 +422,24 @@ void OSCNodeTest::testReceive() {
   // De-register a second time
   OLA_ASSERT_TRUE(m_osc_node->RegisterAddress(TEST_OSC_ADDRESS, NULL));
 }
+
+
+/**
+ * Check that the slots from a bundle result in a single update.
+ */
+void OSCNodeTest::testReceiveBundle() {
+  OLA_ASSERT_TRUE(m_osc_node->RegisterAddress(
+      TEST_OSC_ADDRESS, NewCallback(this, &OSCNodeTest::DMXHandler)));
+
+  IPV4SocketAddress dest_address(IPV4Address::Loopback(),
+                                 m_osc_node->ListeningPort());
+  m_udp_socket.SendTo(OSC_INT_BUNDLE_DATA, sizeof(OSC_INT_BUNDLE_DATA),
+                      dest_address);
+  m_ss.Run();
+
+  DmxBuffer expected_data;
+  expected_data.SetChannel(0, 10);
+  expected_data.SetChannel(1, 20);
+  OLA_ASSERT_EQ(1u, m_dmx_callbacks);
+  OLA_ASSERT_EQ(expected_data, m_received_data);
+}
@@ -0,0 +1,250 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OSCParser.cpp
+ * Decodes OSC packets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+#include "plugins/osc/OSCParser.h"
+
+namespace ola {
+namespace plugin {
+namespace osc {
+
+using ola::network::NetworkToHost;
+
+namespace {
+const char BUNDLE_TAG[] = "#bundle";
+// The bundle tag and the time tag.
+const unsigned int BUNDLE_HEADER_SIZE = 16;
+
+unsigned int Pad(unsigned int size) {
+  return (size + 3) & ~3u;
+}
+
+uint32_t ReadUInt32(const uint8_t *ptr) {
+  uint32_t value;
+  memcpy(&value, ptr, sizeof(value));
+  return NetworkToHost(value);
+}
+
+/*
+ * Read a null terminated, padded string.
+ * @param data the start of the data.
+ * @param size the size of the data.
+ * @param offset the offset to read from, updated to point after the string.
+ * @param str set to the start of the string.
+ */
+bool ReadString(const uint8_t *data, unsigned int size, unsigned int *offset,
+                const char **str) {
+  if (*offset >= size) {
+    return false;
+  }
+  const uint8_t *start = data + *offset;
+  const uint8_t *end = static_cast<const uint8_t*>(
+      memchr(start, 0, size - *offset));
+  if (!end) {
+    return false;
+  }
+  unsigned int length = Pad(static_cast<unsigned int>(end - start) + 1);
+  if (length > size - *offset) {
+    return false;
+  }
+  *str = reinterpret_cast<const char*>(start);
+  *offset += length;
+  return true;
+}
+}  // namespace
+
+
+bool OSCParser::ParsePacket(const uint8_t *data, unsigned int size) {
+  if (size % 4) {
+    OLA_INFO << "OSC packet size " << size << " isn't a multiple of 4";
+    return false;
+  }
+  return ParseElement(data, size, 0);
+}
+
+
+/*
+ * Parse a bundle or a message.
+ */
+bool OSCParser::ParseElement(const uint8_t *data, unsigned int size,
+                             unsigned int depth) {
+  if (size >= sizeof(BUNDLE_TAG) &&
+      memcmp(data, BUNDLE_TAG, sizeof(BUNDLE_TAG)) == 0) {
+    if (depth >= MAX_BUNDLE_DEPTH) {
+      OLA_INFO << "OSC bundles nested too deeply";
+      return false;
+    }
+    return ParseBundle(data, size, depth);
+  }
+  return ParseMessage(data, size);
+}
+
+
+bool OSCParser::ParseBundle(const uint8_t *data, unsigned int size,
+                            unsigned int depth) {
+  if (size < BUNDLE_HEADER_SIZE) {
+    return false;
+  }
+
+  // The time tag is ignored, everything is processed immediately.
+  unsigned int offset = BUNDLE_HEADER_SIZE;
+  while (offset < size) {
+    if (size - offset < sizeof(uint32_t)) {
+      return false;
+    }
+    const uint32_t element_size = ReadUInt32(data + offset);
+    offset += sizeof(uint32_t);
+    if (element_size > size - offset || element_size % 4) {
+      OLA_INFO << "Invalid OSC bundle element size " << element_size;
+      return false;
+    }
+    if (!ParseElement(data + offset, element_size, depth + 1)) {
+      return false;
+    }
+    offset += element_size;
+  }
+  return true;
+}
+
+
+bool OSCParser::ParseMessage(const uint8_t *data, unsigned int size) {
+  unsigned int offset = 0;
+  if (!ReadString(data, size, &offset, &m_message.address) ||
+      m_message.address[0] != '/') {
+    OLA_INFO << "Invalid OSC address";
+    return false;
+  }
+
+  // Very old senders may omit the type tags, treat this as no arguments.
+  const char *types = ",";
+  if (offset < size && !ReadString(data, size, &offset, &types)) {
+    return false;
+  }
+  if (types[0] != ',') {
+    OLA_INFO << "Invalid OSC type tags for " << m_message.address;
+    return false;
+  }
+  m_message.types = types + 1;
+
+  const unsigned int argument_count = static_cast<unsigned int>(
+      strlen(m_message.types));
+  if (argument_count > OSCMessage::MAX_ARGUMENTS) {
+    OLA_DEBUG << "Skipping OSC message to " << m_message.address << " with "
+              << argument_count << " arguments";
+    return true;
+  }
+
+  for (unsigned int i = 0; i < argument_count; i++) {
+    if (!ParseArgument(m_message.types[i], data, size, &offset,
+                       &m_message.arguments[i])) {
+      OLA_INFO << "Invalid OSC argument " << i << " for "
+               << m_message.address;
+      return false;
+    }
+  }
+  m_message.argument_count = argument_count;
+  m_handler->Run(m_message);
+  return true;
+}
+
+
+/*
+ * Decode a single argument.
+ */
+bool OSCParser::ParseArgument(char type, const uint8_t *data,
+                              unsigned int size, unsigned int *offset,
+                              OSCArgument *argument) {
+  argument->type = type;
+  argument->int_value = 0;
+  argument->float_value = 0.0f;
+  argument->data = NULL;
+  argument->size = 0;
+
+  const unsigned int remaining = size - *offset;
+  switch (type) {
+    case 'i':
+    case 'c':
+    case 'm':
+    case 'r':
+      if (remaining < sizeof(uint32_t)) {
+        return false;
+      }
+      argument->int_value = static_cast<int32_t>(ReadUInt32(data + *offset));
+      *offset += sizeof(uint32_t);
+      return true;
+    case 'f':
+      {
+        if (remaining < sizeof(uint32_t)) {
+          return false;
+        }
+        const uint32_t value = ReadUInt32(data + *offset);
+        memcpy(&argument->float_value, &value, sizeof(value));
+        *offset += sizeof(uint32_t);
+        return true;
+      }
+    case 'b':
+      {
+        if (remaining < sizeof(uint32_t)) {
+          return false;
+        }
+        const uint32_t blob_size = ReadUInt32(data + *offset);
+        if (blob_size > remaining - sizeof(uint32_t) ||
+            Pad(blob_size) > remaining - sizeof(uint32_t)) {
+          return false;
+        }
+        argument->data = data + *offset + sizeof(uint32_t);
+        argument->size = blob_size;
+        *offset += sizeof(uint32_t) + Pad(blob_size);
+        return true;
+      }
+    case 's':
+    case 'S':
+      {
+        const char *str;
+        if (!ReadString(data, size, offset, &str)) {
+          return false;
+        }
+        argument->data = reinterpret_cast<const uint8_t*>(str);
+        argument->size = static_cast<unsigned int>(strlen(str));
+        return true;
+      }
+    case 'h':
+    case 't':
+    case 'd':
+      // 64 bit values aren't used for DMX, so they're skipped.
+      if (remaining < 2 * sizeof(uint32_t)) {
+        return false;
+      }
+      *offset += 2 * sizeof(uint32_t);
+      return true;
+    case 'T':
+    case 'F':
+    case 'N':
+    case 'I':
+      return true;
+    default:
+      return false;
+  }
+}
+}  // namespace osc
+}  // namespace plugin
+}  // namespace ola
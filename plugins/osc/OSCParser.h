@@ -0,0 +1,104 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OSCParser.h
+ * Decodes OSC packets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_OSC_OSCPARSER_H_
+#define PLUGINS_OSC_OSCPARSER_H_
+
+#include <stdint.h>
+#include <memory>
+#include "ola/Callback.h"
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace plugin {
+namespace osc {
+
+/**
+ * An argument from an OSC message. Strings and blobs point into the packet.
+ */
+struct OSCArgument {
+  char type;
+  int32_t int_value;
+  float float_value;
+  const uint8_t *data;
+  unsigned int size;
+};
+
+/**
+ * A decoded OSC message. The address and types point into the packet, so
+ * they are only valid while the message is being handled.
+ */
+struct OSCMessage {
+  enum { MAX_ARGUMENTS = 8 };
+
+  const char *address;
+  const char *types;  // the type tags, without the leading ','
+  unsigned int argument_count;
+  OSCArgument arguments[MAX_ARGUMENTS];
+};
+
+/**
+ * Decodes OSC packets, including nested bundles, and runs a callback for
+ * each message. This doesn't allocate any memory while parsing.
+ *
+ * Messages with more than OSCMessage::MAX_ARGUMENTS arguments are skipped.
+ */
+class OSCParser {
+ public:
+  typedef Callback1<void, const OSCMessage&> MessageHandler;
+
+  /**
+   * Create a new OSCParser.
+   * @param handler the callback to run for each message, ownership is
+   *   transferred.
+   */
+  explicit OSCParser(MessageHandler *handler)
+      : m_handler(handler) {
+  }
+
+  /**
+   * Parse an OSC packet.
+   * @param data the packet data.
+   * @param size the size of the packet.
+   * @returns false if the packet was malformed. Any messages before the
+   *   error have already been handled.
+   */
+  bool ParsePacket(const uint8_t *data, unsigned int size);
+
+ private:
+  std::auto_ptr<MessageHandler> m_handler;
+  OSCMessage m_message;
+
+  bool ParseElement(const uint8_t *data, unsigned int size,
+                    unsigned int depth);
+  bool ParseBundle(const uint8_t *data, unsigned int size,
+                   unsigned int depth);
+  bool ParseMessage(const uint8_t *data, unsigned int size);
+  bool ParseArgument(char type, const uint8_t *data, unsigned int size,
+                     unsigned int *offset, OSCArgument *argument);
+
+  static const unsigned int MAX_BUNDLE_DEPTH = 4;
+
+  DISALLOW_COPY_AND_ASSIGN(OSCParser);
+};
+}  // namespace osc
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_OSC_OSCPARSER_H_
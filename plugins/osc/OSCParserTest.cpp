@@ -0,0 +1,208 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OSCParserTest.cpp
+ * Test fixture for the OSCParser class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/osc/OSCParser.h"
+
+using ola::NewCallback;
+using ola::plugin::osc::OSCMessage;
+using ola::plugin::osc::OSCParser;
+using std::string;
+using std::vector;
+
+class OSCParserTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(OSCParserTest);
+  CPPUNIT_TEST(testMessage);
+  CPPUNIT_TEST(testBundle);
+  CPPUNIT_TEST(testInvalidPackets);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp() {
+      m_messages.clear();
+    }
+
+    void testMessage();
+    void testBundle();
+    void testInvalidPackets();
+
+ private:
+    // A summary of each message that was handled.
+    struct ReceivedMessage {
+      string address;
+      string types;
+      int int_value;
+      float float_value;
+      string data;
+    };
+
+    vector<ReceivedMessage> m_messages;
+
+    void HandleMessage(const OSCMessage &message) {
+      ReceivedMessage received;
+      received.address = message.address;
+      received.types = message.types;
+      received.int_value = 0;
+      received.float_value = 0.0f;
+      if (message.argument_count) {
+        received.int_value = message.arguments[0].int_value;
+        received.float_value = message.arguments[0].float_value;
+        received.data.assign(
+            reinterpret_cast<const char*>(message.arguments[0].data),
+            message.arguments[0].size);
+      }
+      m_messages.push_back(received);
+    }
+
+    bool Parse(const uint8_t *data, unsigned int size) {
+      OSCParser parser(NewCallback(this, &OSCParserTest::HandleMessage));
+      return parser.ParsePacket(data, size);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OSCParserTest);
+
+
+/**
+ * Check that single messages are decoded.
+ */
+void OSCParserTest::testMessage() {
+  const uint8_t int_message[] = {
+    '/', 'd', 'm', 'x', '/', '1', 0, 0,
+    ',', 'i', 0, 0,
+    0, 0, 1, 2
+  };
+  OLA_ASSERT_TRUE(Parse(int_message, sizeof(int_message)));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_messages.size());
+  OLA_ASSERT_EQ(string("/dmx/1"), m_messages[0].address);
+  OLA_ASSERT_EQ(string("i"), m_messages[0].types);
+  OLA_ASSERT_EQ(258, m_messages[0].int_value);
+
+  const uint8_t float_message[] = {
+    '/', 'd', 'm', 'x', 0, 0, 0, 0,
+    ',', 'f', 0, 0,
+    0x3f, 0, 0, 0
+  };
+  OLA_ASSERT_TRUE(Parse(float_message, sizeof(float_message)));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_messages.size());
+  OLA_ASSERT_EQ(string("/dmx"), m_messages[1].address);
+  OLA_ASSERT_EQ(0.5f, m_messages[1].float_value);
+
+  const uint8_t blob_message[] = {
+    '/', 'd', 'm', 'x', 0, 0, 0, 0,
+    ',', 'b', 0, 0,
+    0, 0, 0, 3,
+    'a', 'b', 'c', 0
+  };
+  OLA_ASSERT_TRUE(Parse(blob_message, sizeof(blob_message)));
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_messages.size());
+  OLA_ASSERT_EQ(string("b"), m_messages[2].types);
+  OLA_ASSERT_EQ(string("abc"), m_messages[2].data);
+
+  // Messages with no type tags have no arguments.
+  const uint8_t no_types_message[] = {'/', 'g', 'o', 0};
+  OLA_ASSERT_TRUE(Parse(no_types_message, sizeof(no_types_message)));
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_messages.size());
+  OLA_ASSERT_EQ(string(""), m_messages[3].types);
+}
+
+
+/**
+ * Check that bundles, including nested bundles, are decoded.
+ */
+void OSCParserTest::testBundle() {
+  const uint8_t bundle[] = {
+    '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+    0, 0, 0, 0, 0, 0, 0, 1,
+    // first message
+    0, 0, 0, 12,
+    '/', 'a', 0, 0,
+    ',', 'i', 0, 0,
+    0, 0, 0, 1,
+    // a nested bundle
+    0, 0, 0, 32,
+    '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+    0, 0, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 12,
+    '/', 'b', 0, 0,
+    ',', 'i', 0, 0,
+    0, 0, 0, 2,
+  };
+  OLA_ASSERT_TRUE(Parse(bundle, sizeof(bundle)));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_messages.size());
+  OLA_ASSERT_EQ(string("/a"), m_messages[0].address);
+  OLA_ASSERT_EQ(1, m_messages[0].int_value);
+  OLA_ASSERT_EQ(string("/b"), m_messages[1].address);
+  OLA_ASSERT_EQ(2, m_messages[1].int_value);
+}
+
+
+/**
+ * Check that malformed packets are rejected.
+ */
+void OSCParserTest::testInvalidPackets() {
+  // Not a multiple of 4
+  const uint8_t short_packet[] = {'/', 'a', 0};
+  OLA_ASSERT_FALSE(Parse(short_packet, sizeof(short_packet)));
+
+  // The address isn't terminated
+  const uint8_t unterminated[] = {'/', 'a', 'b', 'c'};
+  OLA_ASSERT_FALSE(Parse(unterminated, sizeof(unterminated)));
+
+  // Missing the int argument
+  const uint8_t missing_argument[] = {
+    '/', 'a', 0, 0,
+    ',', 'i', 0, 0
+  };
+  OLA_ASSERT_FALSE(Parse(missing_argument, sizeof(missing_argument)));
+
+  // The blob size is larger than the packet
+  const uint8_t large_blob[] = {
+    '/', 'a', 0, 0,
+    ',', 'b', 0, 0,
+    0xff, 0xff, 0xff, 0xff,
+    0, 0, 0, 0
+  };
+  OLA_ASSERT_FALSE(Parse(large_blob, sizeof(large_blob)));
+
+  // The element size is larger than the bundle
+  const uint8_t bad_bundle[] = {
+    '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+    0, 0, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 16,
+    '/', 'a', 0, 0,
+    ',', 0, 0, 0,
+  };
+  OLA_ASSERT_FALSE(Parse(bad_bundle, sizeof(bad_bundle)));
+
+  // An unknown type
+  const uint8_t unknown_type[] = {
+    '/', 'a', 0, 0,
+    ',', 'x', 0, 0,
+    0, 0, 0, 0
+  };
+  OLA_ASSERT_FALSE(Parse(unknown_type, sizeof(unknown_type)));
+  OLA_ASSERT_TRUE(m_messages.empty());
+}
@@ -30,6 +30,7 @@
 #include "ola/StringUtils.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/UDPReceivePreferences.h"
 #include "plugins/osc/OSCAddressTemplate.h"
 #include "plugins/osc/OSCDevice.h"
 #include "plugins/osc/OSCPlugin.h"
@@ -57,8 +58,10 @@ const char OSCPlugin::UDP_PORT_KEY[] = "udp_listen_port";
 
 const char OSCPlugin::BLOB_FORMAT[] = "blob";
 const char OSCPlugin::FLOAT_ARRAY_FORMAT[] = "float_array";
+const char OSCPlugin::FLOAT_BUNDLE_FORMAT[] = "float_bundle";
 const char OSCPlugin::FLOAT_INDIVIDUAL_FORMAT[] = "individual_float";
 const char OSCPlugin::INT_ARRAY_FORMAT[] = "int_array";
+const char OSCPlugin::INT_BUNDLE_FORMAT[] = "int_bundle";
 const char OSCPlugin::INT_INDIVIDUAL_FORMAT[] = "individual_int";
 
 /*
@@ -101,10 +104,14 @@ bool OSCPlugin::StartHook() {
     port_configs.push_back(port_config);
   }
 
+  ola::network::UDPReceiveOptions receive_options;
+  ReadUDPReceivePreferences(*m_preferences, m_plugin_adaptor->GetExportMap(),
+                            "osc", &receive_options);
+
   // Finally create the new OSCDevice, start it and register the device.
   std::auto_ptr<OSCDevice> device(
-    new OSCDevice(this, m_plugin_adaptor, udp_port, port_addresses,
-                  port_configs));
+    new OSCDevice(this, m_plugin_adaptor, udp_port, receive_options,
+                  port_addresses, port_configs));
   if (!device->Start()) {
     return false;
   }
@@ -165,8 +172,10 @@ bool OSCPlugin::SetDefaultPreferences() {
   set<string> valid_formats;
   valid_formats.insert(BLOB_FORMAT);
   valid_formats.insert(FLOAT_ARRAY_FORMAT);
+  valid_formats.insert(FLOAT_BUNDLE_FORMAT);
   valid_formats.insert(FLOAT_INDIVIDUAL_FORMAT);
   valid_formats.insert(INT_ARRAY_FORMAT);
+  valid_formats.insert(INT_BUNDLE_FORMAT);
   valid_formats.insert(INT_INDIVIDUAL_FORMAT);
 
   SetValidator<string> format_validator = SetValidator<string>(valid_formats);
@@ -183,6 +192,8 @@ bool OSCPlugin::SetDefaultPreferences() {
         BLOB_FORMAT);
   }
 
+  save |= SetDefaultUDPReceivePreferences(m_preferences);
+
   if (save) {
     m_preferences->Save();
   }
@@ -233,10 +244,14 @@ void OSCPlugin::SetDataFormat(const string &format_option,
     port_config->data_format = OSCNode::FORMAT_BLOB;
   } else if (format_option == FLOAT_ARRAY_FORMAT) {
     port_config->data_format = OSCNode::FORMAT_FLOAT_ARRAY;
+  } else if (format_option == FLOAT_BUNDLE_FORMAT) {
+    port_config->data_format = OSCNode::FORMAT_FLOAT_BUNDLE;
   } else if (format_option == FLOAT_INDIVIDUAL_FORMAT) {
     port_config->data_format = OSCNode::FORMAT_FLOAT_INDIVIDUAL;
   } else if (format_option == INT_ARRAY_FORMAT) {
     port_config->data_format = OSCNode::FORMAT_INT_ARRAY;
+  } else if (format_option == INT_BUNDLE_FORMAT) {
+    port_config->data_format = OSCNode::FORMAT_INT_BUNDLE;
   } else if (format_option == INT_INDIVIDUAL_FORMAT) {
     port_config->data_format = OSCNode::FORMAT_INT_INDIVIDUAL;
   } else {
@@ -44,6 +44,9 @@ class OSCPlugin: public ola::Plugin {
     ola_plugin_id Id() const { return OLA_PLUGIN_OSC; }
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
@@ -62,8 +65,6 @@ class OSCPlugin: public ola::Plugin {
     static const char DEFAULT_TARGETS_TEMPLATE[];
     static const char INPUT_PORT_COUNT_KEY[];
     static const char OUTPUT_PORT_COUNT_KEY[];
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
     static const char PORT_ADDRESS_TEMPLATE[];
     static const char PORT_TARGETS_TEMPLATE[];
     static const char PORT_FORMAT_TEMPLATE[];
@@ -71,8 +72,10 @@ class OSCPlugin: public ola::Plugin {
 
     static const char BLOB_FORMAT[];
     static const char FLOAT_ARRAY_FORMAT[];
+    static const char FLOAT_BUNDLE_FORMAT[];
     static const char FLOAT_INDIVIDUAL_FORMAT[];
     static const char INT_ARRAY_FORMAT[];
+    static const char INT_BUNDLE_FORMAT[];
     static const char INT_INDIVIDUAL_FORMAT[];
 };
 }  // namespace osc
@@ -82,7 +82,8 @@ bool PathportDevice::StartHook() {
   }
 
   m_node = new PathportNode(m_preferences->GetValue(K_NODE_IP_KEY),
-                            product_id, dscp);
+                            product_id, dscp,
+                            m_plugin_adaptor->GetExportMap());
 
   if (!m_node->Start()) {
     delete m_node;
@@ -21,7 +21,6 @@
 #include <string.h>
 #include <algorithm>
 #include <string>
-#include <map>
 #include <vector>
 #include "ola/Logging.h"
 #include "ola/Constants.h"
@@ -35,7 +34,6 @@ namespace plugin {
 namespace pathport {
 
 using std::string;
-using std::map;
 using std::vector;
 using ola::network::HostToNetwork;
 using ola::network::IPV4Address;
@@ -48,11 +46,14 @@ using ola::Callback0;
  * Create a new node
  * @param ip_address the IP address to prefer to listen on, if NULL we choose
  * one.
+ * @param export_map the ExportMap to add the receive counters to, may be NULL.
  */
 PathportNode::PathportNode(const string &ip_address,
                            uint32_t device_id,
-                           uint8_t dscp)
-    : m_running(false),
+                           uint8_t dscp,
+                           ola::ExportMap *export_map)
+    : UDPNode("pathport", sizeof(pathport_packet_s), export_map),
+      m_running(false),
       m_dscp(dscp),
       m_preferred_ip(ip_address),
       m_device_id(device_id),
@@ -65,12 +66,6 @@ PathportNode::PathportNode(const string &ip_address,
  */
 PathportNode::~PathportNode() {
   Stop();
-
-  universe_handlers::iterator iter;
-  for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
-    delete iter->second.closure;
-  }
-  m_handlers.clear();
 }
 
 
@@ -122,31 +117,34 @@ bool PathportNode::Stop() {
  * Called when there is data on this socket
  */
 void PathportNode::SocketReady(UDPSocket *socket) {
-  pathport_packet_s packet;
-  ssize_t packet_size = sizeof(packet);
-  IPV4SocketAddress source;
+  ReceivePackets(socket);
+}
 
-  if (!socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                        &packet_size, &source))
-    return;
 
+/*
+ * Handle a datagram from the receive batch.
+ */
+bool PathportNode::HandlePacket(const uint8_t *data, unsigned int length,
+                                const IPV4SocketAddress &source) {
   // skip packets sent by us
   if (source.Host() == m_interface.ip_address)
-    return;
+    return false;
 
-  if (packet_size < static_cast<ssize_t>(sizeof(packet.header))) {
+  const pathport_packet_s *packet =
+      reinterpret_cast<const pathport_packet_s*>(data);
+  if (length < sizeof(packet->header)) {
     OLA_WARN << "Small pathport packet received, discarding";
-    return;
+    return false;
   }
-  packet_size -= static_cast<ssize_t>(sizeof(packet.header));
+  length -= sizeof(packet->header);
 
   // Validate header
-  if (!ValidateHeader(packet.header)) {
+  if (!ValidateHeader(packet->header)) {
     OLA_WARN << "Invalid pathport packet";
-    return;
+    return false;
   }
 
-  uint32_t destination = NetworkToHost(packet.header.destination);
+  uint32_t destination = NetworkToHost(packet->header.destination);
   if (destination != m_device_id &&
       destination != PATHPORT_ID_BROADCAST &&
       destination != PATHPORT_STATUS_GROUP &&
@@ -154,31 +152,31 @@ void PathportNode::SocketReady(UDPSocket *socket) {
       destination != PATHPORT_DATA_GROUP) {
     ola::network::IPV4Address addr(destination);
     OLA_WARN << "pathport destination not set to us: " << addr;
-    return;
+    return false;
   }
 
   // TODO(simon): Handle multiple pdus here
-  pathport_packet_pdu *pdu = &packet.d.pdu;
+  const pathport_packet_pdu *pdu = &packet->d.pdu;
 
-  if (packet_size < static_cast<ssize_t>(sizeof(pathport_pdu_header))) {
+  if (length < sizeof(pathport_pdu_header)) {
     OLA_WARN << "Pathport packet too small to fit a pdu header";
-    return;
+    return false;
   }
-  packet_size -= sizeof(pathport_pdu_header);
+  length -= sizeof(pathport_pdu_header);
 
   switch (NetworkToHost(pdu->head.type)) {
     case PATHPORT_DATA:
-      HandleDmxData(pdu->d.data, packet_size);
-      break;
+      return HandleDmxData(pdu->d.data, length);
     case PATHPORT_ARP_REQUEST:
       SendArpReply();
-      break;
+      return true;
     case PATHPORT_ARP_REPLY:
       OLA_DEBUG << "Got pathport arp reply";
-      break;
+      return true;
     default:
       OLA_INFO << "Unhandled pathport packet with id: " <<
         NetworkToHost(pdu->head.type);
+      return false;
   }
 }
 
@@ -192,22 +190,7 @@ void PathportNode::SocketReady(UDPSocket *socket) {
 bool PathportNode::SetHandler(uint8_t universe,
                              DmxBuffer *buffer,
                              Callback0<void> *closure) {
-  if (!closure)
-    return false;
-
-  universe_handlers::iterator iter = m_handlers.find(universe);
-
-  if (iter == m_handlers.end()) {
-    universe_handler handler;
-    handler.buffer = buffer;
-    handler.closure = closure;
-    m_handlers[universe] = handler;
-  } else {
-    Callback0<void> *old_closure = iter->second.closure;
-    iter->second.closure = closure;
-    delete old_closure;
-  }
-  return true;
+  return SetUniverseHandler(universe, buffer, closure);
 }
 
 
@@ -217,15 +200,7 @@ bool PathportNode::SetHandler(uint8_t universe,
  * @param true if removed, false if it didn't exist
  */
 bool PathportNode::RemoveHandler(uint8_t universe) {
-  universe_handlers::iterator iter = m_handlers.find(universe);
-
-  if (iter != m_handlers.end()) {
-    Callback0<void> *old_closure = iter->second.closure;
-    m_handlers.erase(iter);
-    delete old_closure;
-    return true;
-  }
-  return false;
+  return RemoveUniverseHandler(universe);
 }
 
 
@@ -375,20 +350,20 @@ bool PathportNode::ValidateHeader(const pathport_packet_header &header) {
 /*
  * Handle new DMX data
  */
-void PathportNode::HandleDmxData(const pathport_pdu_data &packet,
+bool PathportNode::HandleDmxData(const pathport_pdu_data &packet,
                                  unsigned int size) {
   if (size < sizeof(pathport_pdu_data)) {
     OLA_WARN << "Small pathport data packet received, ignoring";
-    return;
+    return false;
   }
 
   // Don't handle release messages yet
   if (NetworkToHost(packet.type) != XDMX_DATA_FLAT)
-    return;
+    return false;
 
   if (packet.start_code) {
     OLA_INFO << "Non-0 start code packet received, ignoring";
-    return;
+    return false;
   }
 
   unsigned int offset = NetworkToHost(packet.offset) % DMX_UNIVERSE_SIZE;
@@ -398,22 +373,23 @@ void PathportNode::HandleDmxData(const pathport_pdu_data &packet,
       NetworkToHost(packet.channel_count),
       (uint16_t) (size - sizeof(pathport_pdu_data)));
 
+  bool handled = false;
   while (data_size > 0 && universe <= MAX_UNIVERSES) {
     unsigned int channels_for_this_universe =
       std::min(data_size, DMX_UNIVERSE_SIZE - offset);
 
-    universe_handlers::iterator iter = m_handlers.find(universe);
-    if (iter != m_handlers.end()) {
-      iter->second.buffer->SetRange(offset,
-                                    dmx_data,
-                                    channels_for_this_universe);
-      iter->second.closure->Run();
+    UniverseHandler *handler = LookupUniverse(universe);
+    if (handler) {
+      handler->buffer->SetRange(offset, dmx_data, channels_for_this_universe);
+      DmxReceived(handler);
+      handled = true;
     }
     data_size -= channels_for_this_universe;
     dmx_data += channels_for_this_universe;
     offset = 0;
     universe++;
   }
+  return handled;
 }
 
 
@@ -21,10 +21,11 @@
 #ifndef PLUGINS_PATHPORT_PATHPORTNODE_H_
 #define PLUGINS_PATHPORT_PATHPORTNODE_H_
 
-#include <map>
 #include <string>
+#include "common/network/UDPNode.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/InterfacePicker.h"
 #include "ola/network/Socket.h"
@@ -34,10 +35,10 @@ namespace ola {
 namespace plugin {
 namespace pathport {
 
-class PathportNode {
+class PathportNode: public ola::network::UDPNode {
  public:
     explicit PathportNode(const std::string &preferred_ip, uint32_t device_id,
-                          uint8_t dscp);
+                          uint8_t dscp, ola::ExportMap *export_map = NULL);
     ~PathportNode();
 
     bool Start();
@@ -59,12 +60,11 @@ class PathportNode {
     // apparently pathport supports up to 128 universes, the spec only says 64
     static const uint8_t MAX_UNIVERSES = 127;
 
- private:
-    typedef struct {
-      DmxBuffer *buffer;
-      Callback0<void> *closure;
-    } universe_handler;
+ protected:
+    bool HandlePacket(const uint8_t *data, unsigned int length,
+                      const ola::network::IPV4SocketAddress &source);
 
+ private:
     enum {
       XDMX_DATA_FLAT = 0x0101,
       XDMX_DATA_RELEASE = 0x0103
@@ -98,12 +98,10 @@ class PathportNode {
       NODE_DEVICE_ONEPORT = 2,
     };
 
-    typedef std::map<uint8_t, universe_handler> universe_handlers;
-
     bool InitNetwork();
     void PopulateHeader(pathport_packet_header *header, uint32_t destination);
     bool ValidateHeader(const pathport_packet_header &header);
-    void HandleDmxData(const pathport_pdu_data &packet,
+    bool HandleDmxData(const pathport_pdu_data &packet,
                        unsigned int size);
     bool SendArpRequest(uint32_t destination = PATHPORT_ID_BROADCAST);
     bool SendPacket(const pathport_packet_s &packet,
@@ -116,7 +114,6 @@ class PathportNode {
     uint32_t m_device_id;  // the pathport device id
     uint16_t m_sequence_number;
 
-    universe_handlers m_handlers;
     ola::network::Interface m_interface;
     ola::network::UDPSocket m_socket;
     ola::network::IPV4Address m_config_addr;
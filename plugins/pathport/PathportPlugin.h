@@ -41,6 +41,9 @@ class PathportPlugin: public ola::Plugin {
     ola_plugin_id Id() const { return OLA_PLUGIN_PATHPORT; }
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
@@ -49,8 +52,6 @@ class PathportPlugin: public ola::Plugin {
     class PathportDevice *m_device;
 
     static const unsigned int DEFAULT_DSCP_VALUE;
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
     // 0x28 is assigned to the OLA project
     static const uint8_t OLA_MANUFACTURER_CODE = 0x28;
 };
@@ -24,6 +24,7 @@
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
 #include "plugins/renard/RenardPort.h"
 #include "plugins/renard/RenardWidget.h"
@@ -56,6 +57,7 @@ const uint32_t RenardDevice::DEFAULT_BAUDRATE = ola::io::BAUD_RATE_57600;
  * @param dev_path path to the pro widget
  */
 RenardDevice::RenardDevice(AbstractPlugin *owner,
+                           PluginAdaptor *plugin_adaptor,
                            class Preferences *preferences,
                            const string &dev_path)
     : Device(owner, RENARD_DEVICE_NAME),
@@ -82,7 +84,9 @@ RenardDevice::RenardDevice(AbstractPlugin *owner,
     baudrate = DEFAULT_BAUDRATE;
   }
 
-  m_widget.reset(new RenardWidget(m_dev_path, dmxOffset, channels, baudrate,
+  m_widget.reset(new RenardWidget(plugin_adaptor,
+                                  plugin_adaptor->GetExportMap(), m_dev_path,
+                                  dmxOffset, channels, baudrate,
                                   RENARD_START_ADDRESS));
 
   OLA_DEBUG << "DMX offset set to " << static_cast<int>(dmxOffset);
@@ -36,6 +36,7 @@ namespace renard {
 class RenardDevice: public ola::Device {
  public:
     RenardDevice(AbstractPlugin *owner,
+                 class PluginAdaptor *plugin_adaptor,
                  class Preferences *preferences,
                  const std::string &dev_path);
     ~RenardDevice();
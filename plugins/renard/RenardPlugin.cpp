@@ -60,7 +60,7 @@ bool RenardPlugin::StartHook() {
       continue;
     }
 
-    device = new RenardDevice(this, m_preferences, *it);
+    device = new RenardDevice(this, m_plugin_adaptor, m_preferences, *it);
     OLA_DEBUG << "Adding device " << *it;
 
     if (!device->Start()) {
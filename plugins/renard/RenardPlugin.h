@@ -45,6 +45,9 @@ class RenardPlugin: public Plugin {
     int SocketClosed(ola::io::ConnectedDescriptor *socket);
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
@@ -56,8 +59,6 @@ class RenardPlugin: public Plugin {
     static const char RENARD_DEVICE_PATH[];
     static const char RENARD_BASE_DEVICE_NAME[];
     static const char RENARD_SS_DEVICE_NAME[];
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
     static const char DEVICE_KEY[];
 };
 }  // namespace renard
@@ -18,9 +18,11 @@
  * Copyright (C) 2013 Hakan Lindestaf
  */
 
+#include <string.h>
 #include <algorithm>
 #include <string>
 
+#include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/io/IOUtils.h"
 #include "ola/io/Serial.h"
@@ -30,6 +32,7 @@ namespace ola {
 namespace plugin {
 namespace renard {
 
+using ola::thread::INVALID_TIMEOUT;
 using std::string;
 
 // Based on standard Renard firmware
@@ -43,11 +46,47 @@ const uint8_t RenardWidget::RENARD_ESCAPE_ESCAPE = 0x31;
 const uint8_t RenardWidget::RENARD_CHANNELS_IN_BANK = 8;
 // Discussions on the Renard firmware recommended a padding each 100 bytes or so
 const uint32_t RenardWidget::RENARD_BYTES_BETWEEN_PADDING = 100;
+const char RenardWidget::RENARD_UPDATE_RATE_VAR[] = "renard-update-rate";
+const char RenardWidget::RENARD_DEVICE_KEY[] = "device";
+
+namespace {
+// Banks that haven't changed are skipped, so every bank is resent this often
+// in case the boards missed an update.
+const int64_t FULL_UPDATE_INTERVAL_US = ola::USEC_IN_SECONDS;
+}  // namespace
 
 /*
  * New widget
  */
+RenardWidget::RenardWidget(ola::io::SelectServerInterface *ss,
+                           ExportMap *export_map,
+                           const string &path,
+                           int dmxOffset,
+                           int channels,
+                           uint32_t baudrate,
+                           uint8_t startAddress)
+    : m_ss(ss),
+      m_path(path),
+      m_socket(NULL),
+      m_byteCounter(0),
+      m_dmxOffset(dmxOffset),
+      m_channels(channels),
+      m_baudrate(baudrate),
+      m_startAddress(startAddress),
+      m_pacer(baudrate),
+      m_send_timeout(INVALID_TIMEOUT),
+      m_rate_var(NULL) {
+  if (export_map) {
+    m_rate_var = export_map->GetUIntMapVar(RENARD_UPDATE_RATE_VAR,
+                                           RENARD_DEVICE_KEY);
+    (*m_rate_var)[m_path] = 0;
+  }
+}
+
 RenardWidget::~RenardWidget() {
+  if (m_send_timeout != INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_send_timeout);
+  }
   if (m_socket) {
     m_socket->Close();
     delete m_socket;
@@ -112,6 +151,10 @@ int RenardWidget::ConnectToWidget(const string &path, speed_t speed) {
  * Disconnect from the widget
  */
 int RenardWidget::Disconnect() {
+  if (m_send_timeout != INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_send_timeout);
+    m_send_timeout = INVALID_TIMEOUT;
+  }
   m_socket->Close();
   return 0;
 }
@@ -128,77 +171,133 @@ bool RenardWidget::DetectDevice() {
 
 
 /*
- * Send a DMX msg.
+ * Send a DMX msg. If the serial link is still busy with the last frame this
+ * is held back until it's idle, and replaced if another frame arrives first.
  */
 bool RenardWidget::SendDmx(const DmxBuffer &buffer) {
+  m_pending = buffer;
+  if (m_send_timeout != INVALID_TIMEOUT) {
+    return true;
+  }
+
+  const TimeInterval wait = m_pacer.TimeUntilIdle(*m_ss->WakeUpTime());
+  if (!wait.IsZero()) {
+    m_send_timeout = m_ss->RegisterSingleTimeout(
+        wait, NewSingleCallback(this, &RenardWidget::SendTimeout));
+    return true;
+  }
+  return SendPending();
+}
+
+
+void RenardWidget::SendTimeout() {
+  m_send_timeout = INVALID_TIMEOUT;
+  SendPending();
+}
+
+
+/*
+ * Send the banks that differ from the last frame sent, or all of them if a
+ * full update is due.
+ */
+bool RenardWidget::SendPending() {
+  if (!m_socket) {
+    return false;
+  }
+
+  const DmxBuffer &buffer = m_pending;
   unsigned int channels = std::max((unsigned int)0,
                                    std::min((unsigned int) m_channels +
                                             m_dmxOffset, buffer.Size()) -
                                    m_dmxOffset);
 
-  OLA_DEBUG << "Sending " << static_cast<int>(channels) << " channels";
-
-  // Max buffer size for worst case scenario (escaping + padding)
-  unsigned int bufferSize = channels * 2 + 10;
-  uint8_t msg[bufferSize];
-
-  int dataToSend = 0;
+  const TimeStamp now = *m_ss->WakeUpTime();
+  const bool full_update = (
+      !m_last_full_update.IsSet() ||
+      (now - m_last_full_update).AsInt() >= FULL_UPDATE_INTERVAL_US);
+  if (full_update) {
+    m_last_full_update = now;
+  }
 
-  for (unsigned int i = 0; i < channels; i++) {
-    if ((i % RENARD_CHANNELS_IN_BANK) == 0) {
-      if (m_byteCounter >= RENARD_BYTES_BETWEEN_PADDING) {
-        // Send PAD every 100 (or so) bytes. Note that the counter is per
-        // device, so the counter should span multiple calls to SendDMX.
-        msg[dataToSend++] = RENARD_COMMAND_PAD;
-        m_byteCounter = 0;
-      }
+  OLA_DEBUG << "Sending " << static_cast<int>(channels) << " channels";
 
-      // Send address
-      msg[dataToSend++] = RENARD_COMMAND_START_PACKET;
-      msg[dataToSend++] = m_startAddress + (i / RENARD_CHANNELS_IN_BANK);
-      m_byteCounter += 2;
+  // Each bank is at most a pad, the 2 byte header & 8 escaped channels.
+  m_msg.clear();
+  m_msg.reserve(channels * 2 + (channels / RENARD_CHANNELS_IN_BANK + 1) * 3);
+
+  for (unsigned int bank_start = 0; bank_start < channels;
+       bank_start += RENARD_CHANNELS_IN_BANK) {
+    const unsigned int bank_size = std::min(
+        static_cast<unsigned int>(RENARD_CHANNELS_IN_BANK),
+        channels - bank_start);
+    const unsigned int offset = m_dmxOffset + bank_start;
+
+    if (!full_update && m_sent.Size() >= offset + bank_size &&
+        memcmp(buffer.GetRaw() + offset, m_sent.GetRaw() + offset,
+               bank_size) == 0) {
+      continue;
     }
 
-    uint8_t b = buffer.Get(m_dmxOffset + i);
-
-    // Escaping magic bytes
-    switch (b) {
-      case RENARD_COMMAND_PAD:
-        msg[dataToSend++] = RENARD_COMMAND_ESCAPE;
-        msg[dataToSend++] = RENARD_ESCAPE_PAD;
-        m_byteCounter += 2;
-        break;
-
-      case RENARD_COMMAND_START_PACKET:
-        msg[dataToSend++] = RENARD_COMMAND_ESCAPE;
-        msg[dataToSend++] = RENARD_ESCAPE_START_PACKET;
-        m_byteCounter += 2;
-        break;
-
-      case RENARD_COMMAND_ESCAPE:
-        msg[dataToSend++] = RENARD_COMMAND_ESCAPE;
-        msg[dataToSend++] = RENARD_ESCAPE_ESCAPE;
-        m_byteCounter += 2;
-        break;
-
-      default:
-        msg[dataToSend++] = b;
-        m_byteCounter++;
-        break;
+    if (m_byteCounter >= RENARD_BYTES_BETWEEN_PADDING) {
+      // Send PAD every 100 (or so) bytes. Note that the counter is per
+      // device, so the counter should span multiple calls to SendDMX.
+      m_msg.push_back(RENARD_COMMAND_PAD);
+      m_byteCounter = 0;
     }
 
-    OLA_DEBUG << "Setting Renard " << m_startAddress +
-      (i / RENARD_CHANNELS_IN_BANK) << "/" <<
-      ((i % RENARD_CHANNELS_IN_BANK) + 1) << " to " <<
-      static_cast<int>(b);
+    // Send address, the boards before this one pass the packet on.
+    m_msg.push_back(RENARD_COMMAND_START_PACKET);
+    m_msg.push_back(m_startAddress + (bank_start / RENARD_CHANNELS_IN_BANK));
+    m_byteCounter += 2;
+
+    for (unsigned int i = 0; i < bank_size; i++) {
+      AppendEscaped(buffer.Get(offset + i));
+    }
   }
 
-  int bytes_sent = m_socket->Send(msg, dataToSend);
+  m_sent = buffer;
+  if (m_msg.empty()) {
+    return true;
+  }
 
+  int bytes_sent = m_socket->Send(&m_msg[0], m_msg.size());
   OLA_DEBUG << "Sending DMX, sent " << bytes_sent << " bytes";
 
+  m_pacer.FrameSent(now, m_msg.size());
+  if (m_rate_var) {
+    (*m_rate_var)[m_path] = m_pacer.FrameRate();
+  }
   return true;
 }
+
+
+void RenardWidget::AppendEscaped(uint8_t value) {
+  // Escaping magic bytes
+  switch (value) {
+    case RENARD_COMMAND_PAD:
+      m_msg.push_back(RENARD_COMMAND_ESCAPE);
+      m_msg.push_back(RENARD_ESCAPE_PAD);
+      m_byteCounter += 2;
+      break;
+
+    case RENARD_COMMAND_START_PACKET:
+      m_msg.push_back(RENARD_COMMAND_ESCAPE);
+      m_msg.push_back(RENARD_ESCAPE_START_PACKET);
+      m_byteCounter += 2;
+      break;
+
+    case RENARD_COMMAND_ESCAPE:
+      m_msg.push_back(RENARD_COMMAND_ESCAPE);
+      m_msg.push_back(RENARD_ESCAPE_ESCAPE);
+      m_byteCounter += 2;
+      break;
+
+    default:
+      m_msg.push_back(value);
+      m_byteCounter++;
+      break;
+  }
+}
 }  // namespace renard
 }  // namespace plugin
 }  // namespace ola
@@ -24,10 +24,13 @@
 #include <fcntl.h>
 #include <termios.h>
 #include <string>
+#include <vector>
 
-#include "ola/io/SelectServer.h"
-#include "ola/io/Serial.h"
+#include "common/io/SerialPacer.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/io/SelectServerInterface.h"
+#include "ola/io/Serial.h"
 
 namespace ola {
 namespace plugin {
@@ -50,18 +53,16 @@ class RenardWidget {
     // default in the standard firmware is 0x80, and it may be a reasonable
     // future feature request to have this configurable for more advanced
     // Renard configurations (using wireless transmitters, etc).
-    explicit RenardWidget(const std::string &path,
-                          int dmxOffset,
-                          int channels,
-                          uint32_t baudrate,
-                          uint8_t startAddress)
-      : m_path(path),
-        m_socket(NULL),
-        m_byteCounter(0),
-        m_dmxOffset(dmxOffset),
-        m_channels(channels),
-        m_baudrate(baudrate),
-        m_startAddress(startAddress) {}
+    // Only the banks which changed are sent, with a full refresh each
+    // second, and frames are held back while the serial link is still busy
+    // with the last one. The update rate achieved is exported to export_map.
+    RenardWidget(ola::io::SelectServerInterface *ss,
+                 ExportMap *export_map,
+                 const std::string &path,
+                 int dmxOffset,
+                 int channels,
+                 uint32_t baudrate,
+                 uint8_t startAddress);
     virtual ~RenardWidget();
 
     // these methods are for communicating with the device
@@ -76,8 +77,12 @@ class RenardWidget {
 
  private:
     int ConnectToWidget(const std::string &path, speed_t speed);
+    bool SendPending();
+    void SendTimeout();
+    void AppendEscaped(uint8_t value);
 
     // instance variables
+    ola::io::SelectServerInterface *m_ss;
     const std::string m_path;
     ola::io::ConnectedDescriptor *m_socket;
     uint32_t m_byteCounter;
@@ -85,6 +90,14 @@ class RenardWidget {
     uint32_t m_channels;
     uint32_t m_baudrate;
     uint8_t m_startAddress;
+    // The latest frame, and the frame the widget last received.
+    DmxBuffer m_pending;
+    DmxBuffer m_sent;
+    TimeStamp m_last_full_update;
+    ola::io::SerialPacer m_pacer;
+    ola::thread::timeout_id m_send_timeout;
+    std::vector<uint8_t> m_msg;
+    UIntMap *m_rate_var;
 
     static const uint8_t RENARD_COMMAND_PAD;
     static const uint8_t RENARD_COMMAND_START_PACKET;
@@ -93,6 +106,8 @@ class RenardWidget {
     static const uint8_t RENARD_ESCAPE_START_PACKET;
     static const uint8_t RENARD_ESCAPE_ESCAPE;
     static const uint32_t RENARD_BYTES_BETWEEN_PADDING;
+    static const char RENARD_UPDATE_RATE_VAR[];
+    static const char RENARD_DEVICE_KEY[];
 };
 }  // namespace renard
 }  // namespace plugin
@@ -0,0 +1,43 @@
+# LIBRARIES
+##################################################
+if USE_REPLICATION
+# This is a library which isn't coupled to olad
+noinst_LTLIBRARIES += plugins/replication/libolareplicationnode.la
+plugins_replication_libolareplicationnode_la_SOURCES = \
+    plugins/replication/ReplicationNode.cpp \
+    plugins/replication/ReplicationNode.h
+plugins_replication_libolareplicationnode_la_LIBADD = common/libolacommon.la
+
+lib_LTLIBRARIES += plugins/replication/libolareplication.la
+
+# Plugin description is generated from README.md
+built_sources += plugins/replication/ReplicationPluginDescription.h
+nodist_plugins_replication_libolareplication_la_SOURCES = \
+    plugins/replication/ReplicationPluginDescription.h
+plugins/replication/ReplicationPluginDescription.h: plugins/replication/README.md plugins/replication/Makefile.mk plugins/convert_README_to_header.sh
+	sh $(top_srcdir)/plugins/convert_README_to_header.sh $(top_srcdir)/plugins/replication $(top_builddir)/plugins/replication/ReplicationPluginDescription.h
+
+plugins_replication_libolareplication_la_SOURCES = \
+    plugins/replication/ReplicationDevice.cpp \
+    plugins/replication/ReplicationDevice.h \
+    plugins/replication/ReplicationPlugin.cpp \
+    plugins/replication/ReplicationPlugin.h \
+    plugins/replication/ReplicationPort.cpp \
+    plugins/replication/ReplicationPort.h
+plugins_replication_libolareplication_la_LIBADD = \
+    olad/plugin_api/libolaserverplugininterface.la \
+    plugins/replication/libolareplicationnode.la
+
+# TESTS
+##################################################
+test_programs += plugins/replication/ReplicationTester
+
+plugins_replication_ReplicationTester_SOURCES = \
+    plugins/replication/ReplicationNodeTest.cpp
+plugins_replication_ReplicationTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+plugins_replication_ReplicationTester_LDADD = \
+    $(COMMON_TESTING_LIBS) \
+    plugins/replication/libolareplicationnode.la
+endif
+
+EXTRA_DIST += plugins/replication/README.md
@@ -0,0 +1,102 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ReplicationDevice.cpp
+ * The device for the replication plugin.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/Port.h"
+#include "plugins/replication/ReplicationDevice.h"
+#include "plugins/replication/ReplicationPort.h"
+
+namespace ola {
+namespace plugin {
+namespace replication {
+
+using ola::network::IPV4SocketAddress;
+using std::vector;
+
+/*
+ * Create a new Replication Device
+ */
+ReplicationDevice::ReplicationDevice(
+    AbstractPlugin *owner,
+    PluginAdaptor *plugin_adaptor,
+    const ReplicationNode::Options &options,
+    const vector<IPV4SocketAddress> &targets,
+    unsigned int input_ports,
+    unsigned int output_ports)
+    : Device(owner, "Replication Device"),
+      m_plugin_adaptor(plugin_adaptor),
+      m_options(options),
+      m_targets(targets),
+      m_input_ports(input_ports),
+      m_output_ports(output_ports),
+      m_node(NULL) {
+}
+
+
+/*
+ * Start this device
+ * @return true on success, false on failure
+ */
+bool ReplicationDevice::StartHook() {
+  m_node = new ReplicationNode(m_plugin_adaptor, m_options);
+  if (!m_node->Start()) {
+    delete m_node;
+    m_node = NULL;
+    return false;
+  }
+
+  vector<IPV4SocketAddress>::const_iterator iter = m_targets.begin();
+  for (; iter != m_targets.end(); ++iter) {
+    OLA_INFO << "Replicating universes to " << *iter;
+    m_node->AddTarget(*iter);
+  }
+
+  for (unsigned int i = 0; i < m_input_ports; i++) {
+    AddPort(new ReplicationInputPort(this, i, m_plugin_adaptor, m_node));
+  }
+  for (unsigned int i = 0; i < m_output_ports; i++) {
+    AddPort(new ReplicationOutputPort(this, i, m_node));
+  }
+  return true;
+}
+
+
+/**
+ * Stop this device. This is called before the ports are deleted
+ */
+void ReplicationDevice::PrePortStop() {
+  m_node->Stop();
+}
+
+
+/*
+ * Stop this device
+ */
+void ReplicationDevice::PostPortStop() {
+  delete m_node;
+  m_node = NULL;
+}
+}  // namespace replication
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,63 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ReplicationDevice.h
+ * The device for the replication plugin.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_REPLICATION_REPLICATIONDEVICE_H_
+#define PLUGINS_REPLICATION_REPLICATIONDEVICE_H_
+
+#include <string>
+#include <vector>
+
+#include "ola/network/SocketAddress.h"
+#include "olad/Device.h"
+#include "plugins/replication/ReplicationNode.h"
+
+namespace ola {
+namespace plugin {
+namespace replication {
+
+class ReplicationDevice: public ola::Device {
+ public:
+  ReplicationDevice(AbstractPlugin *owner,
+                    class PluginAdaptor *plugin_adaptor,
+                    const ReplicationNode::Options &options,
+                    const std::vector<ola::network::IPV4SocketAddress> &targets,
+                    unsigned int input_ports,
+                    unsigned int output_ports);
+
+  // Only one replication device
+  std::string DeviceId() const { return "1"; }
+
+ protected:
+  bool StartHook();
+  void PrePortStop();
+  void PostPortStop();
+
+ private:
+  class PluginAdaptor *m_plugin_adaptor;
+  const ReplicationNode::Options m_options;
+  const std::vector<ola::network::IPV4SocketAddress> m_targets;
+  const unsigned int m_input_ports;
+  const unsigned int m_output_ports;
+  ReplicationNode *m_node;
+};
+}  // namespace replication
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_REPLICATION_REPLICATIONDEVICE_H_
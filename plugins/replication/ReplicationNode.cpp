@@ -0,0 +1,601 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ReplicationNode.cpp
+ * Replicates universes between olad instances.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/util/Trace.h"
+#include "ola/util/Utils.h"
+#include "plugins/replication/ReplicationNode.h"
+
+namespace ola {
+namespace plugin {
+namespace replication {
+
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::UDPSocket;
+using ola::utils::JoinUInt8;
+using ola::utils::SplitUInt16;
+using std::vector;
+
+namespace {
+
+void WriteUInt16(uint8_t *output, uint16_t value) {
+  SplitUInt16(value, &output[0], &output[1]);
+}
+
+void WriteUInt32(uint8_t *output, uint32_t value) {
+  WriteUInt16(output, static_cast<uint16_t>(value >> 16));
+  WriteUInt16(output + 2, static_cast<uint16_t>(value & 0xffff));
+}
+}  // namespace
+
+const uint16_t ReplicationNode::DEFAULT_PORT;
+const unsigned int ReplicationNode::MAX_DATAGRAM_SIZE;
+
+ReplicationNode::ReplicationNode(ola::io::SelectServerInterface *ss,
+                                 const Options &options,
+                                 ola::network::UDPSocketInterface *socket)
+    : m_ss(ss),
+      m_options(options),
+      m_running(false),
+      m_batch_depth(0),
+      m_socket(socket),
+      m_recv_batch(RECV_BATCH_SIZE, MAX_DATAGRAM_SIZE),
+      // There must be room for at least one keyframe.
+      m_datagram(std::min(
+          MAX_DATAGRAM_SIZE,
+          std::max(options.max_datagram_size,
+                   HEADER_SIZE + RECORD_HEADER_SIZE + DMX_UNIVERSE_SIZE))),
+      m_keyframe_timeout(ola::thread::INVALID_TIMEOUT) {
+}
+
+
+ReplicationNode::~ReplicationNode() {
+  Stop();
+  STLDeleteValues(&m_output_universes);
+
+  InputUniverseMap::iterator iter = m_input_universes.begin();
+  for (; iter != m_input_universes.end(); ++iter) {
+    delete iter->second->handler;
+    delete iter->second;
+  }
+}
+
+
+bool ReplicationNode::Start() {
+  if (m_running) {
+    return false;
+  }
+
+  if (!InitNetwork()) {
+    return false;
+  }
+
+  m_keyframe_timeout = m_ss->RegisterRepeatingTimeout(
+      KEYFRAME_TICK_MS,
+      NewCallback(this, &ReplicationNode::RefreshKeyframes));
+  m_running = true;
+  return true;
+}
+
+
+bool ReplicationNode::Stop() {
+  if (!m_running) {
+    return false;
+  }
+
+  if (m_keyframe_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_keyframe_timeout);
+    m_keyframe_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  m_ss->RemoveReadDescriptor(m_socket.get());
+  m_socket.reset();
+  m_running = false;
+  return true;
+}
+
+
+void ReplicationNode::AddTarget(const IPV4SocketAddress &target) {
+  m_targets.push_back(target);
+}
+
+
+bool ReplicationNode::SendDMX(unsigned int universe, const DmxBuffer &buffer) {
+  OutputUniverse *&output = m_output_universes[universe];
+  if (!output) {
+    output = new OutputUniverse();
+  }
+  output->data.Set(buffer);
+  MarkDirty(universe, output);
+  return m_batch_depth ? true : Flush();
+}
+
+
+void ReplicationNode::RemoveUniverse(unsigned int universe) {
+  // Flush() skips universes that are no longer in the map.
+  STLRemoveAndDelete(&m_output_universes, universe);
+}
+
+
+void ReplicationNode::BeginBatch() {
+  m_batch_depth++;
+}
+
+
+bool ReplicationNode::EndBatch() {
+  if (!m_batch_depth) {
+    OLA_WARN << "EndBatch() called without a BeginBatch()";
+    return false;
+  }
+  if (--m_batch_depth) {
+    return true;
+  }
+  return Flush();
+}
+
+
+bool ReplicationNode::SetHandler(unsigned int universe,
+                                 DmxBuffer *buffer,
+                                 ola::Callback0<void> *handler) {
+  if (!handler) {
+    return false;
+  }
+
+  InputUniverse *&input = m_input_universes[universe];
+  if (input) {
+    delete input->handler;
+  } else {
+    input = new InputUniverse();
+  }
+  input->buffer = buffer;
+  input->handler = handler;
+  return true;
+}
+
+
+bool ReplicationNode::RemoveHandler(unsigned int universe) {
+  InputUniverse *input = STLLookupAndRemovePtr(&m_input_universes, universe);
+  if (!input) {
+    return false;
+  }
+  delete input->handler;
+  delete input;
+  return true;
+}
+
+
+bool ReplicationNode::InitNetwork() {
+  std::auto_ptr<ola::network::UDPSocketInterface> socket(m_socket.release());
+
+  if (!socket.get()) {
+    socket.reset(new UDPSocket());
+  }
+
+  if (!socket->Init()) {
+    OLA_WARN << "Socket init failed";
+    return false;
+  }
+
+  if (!socket->Bind(IPV4SocketAddress(IPV4Address::WildCard(),
+                                      m_options.port))) {
+    return false;
+  }
+
+  // Allow the targets to be broadcast addresses.
+  if (!socket->EnableBroadcast()) {
+    OLA_WARN << "Failed to enable broadcasting";
+  }
+
+  socket->EnableReceiveStats(m_options.receive_options);
+  socket->SetEdgeTriggered(true);
+  socket->SetPriority(ola::io::DESCRIPTOR_PRIORITY_HIGH);
+  socket->SetOnData(NewCallback(this, &ReplicationNode::SocketReady));
+  m_ss->AddReadDescriptor(socket.get());
+  m_socket.reset(socket.release());
+  return true;
+}
+
+
+/*
+ * Pack the dirty universes into datagrams and send them to all the targets.
+ */
+bool ReplicationNode::Flush() {
+  OLA_TRACE_SCOPE("replication", "ReplicationNode::Flush");
+  if (m_dirty_universes.empty()) {
+    return true;
+  }
+
+  if (!m_running) {
+    vector<unsigned int>::const_iterator iter = m_dirty_universes.begin();
+    for (; iter != m_dirty_universes.end(); ++iter) {
+      OutputUniverse *output = STLFindOrNull(m_output_universes, *iter);
+      if (output) {
+        output->dirty = false;
+      }
+    }
+    m_dirty_universes.clear();
+    return false;
+  }
+
+  const TimeStamp &now = Now();
+  const unsigned int max_record_size = RECORD_HEADER_SIZE + DMX_UNIVERSE_SIZE;
+  uint8_t *datagram = &m_datagram[0];
+  datagram[0] = MAGIC_HIGH;
+  datagram[1] = MAGIC_LOW;
+  datagram[2] = PROTOCOL_VERSION;
+  datagram[3] = DATA_MESSAGE;
+  unsigned int size = HEADER_SIZE;
+  bool ok = true;
+
+  m_socket->BeginSendBatch();
+  vector<unsigned int>::const_iterator iter = m_dirty_universes.begin();
+  for (; iter != m_dirty_universes.end(); ++iter) {
+    OutputUniverse *output = STLFindOrNull(m_output_universes, *iter);
+    if (!output || !output->dirty) {
+      continue;
+    }
+    output->dirty = false;
+
+    if (size + max_record_size > m_datagram.size()) {
+      ok &= SendDatagram(size);
+      size = HEADER_SIZE;
+    }
+    size += PackUniverse(*iter, output, datagram + size, now);
+  }
+
+  if (size > HEADER_SIZE) {
+    ok &= SendDatagram(size);
+  }
+  m_dirty_universes.clear();
+  ok &= m_socket->EndSendBatch();
+  return ok;
+}
+
+
+void ReplicationNode::MarkDirty(unsigned int universe,
+                                OutputUniverse *output) {
+  if (!output->dirty) {
+    output->dirty = true;
+    m_dirty_universes.push_back(universe);
+  }
+}
+
+
+/*
+ * Write the record for a universe, and return the size of the record.
+ */
+unsigned int ReplicationNode::PackUniverse(unsigned int universe,
+                                           OutputUniverse *output,
+                                           uint8_t *record,
+                                           const TimeStamp &now) {
+  uint8_t *body = record + RECORD_HEADER_SIZE;
+  const unsigned int data_size = output->data.Size();
+  unsigned int body_size = 0;
+  uint8_t type = DELTA_RECORD;
+
+  bool keyframe = (
+      !output->has_keyframe || output->force_keyframe ||
+      now >= output->keyframe_time + TimeInterval(
+          static_cast<int64_t>(m_options.keyframe_interval) * 1000));
+  if (!keyframe) {
+    body_size = EncodeDelta(output->keyframe, output->data, body, data_size);
+    // The delta is larger than the frame.
+    keyframe = body_size == 0;
+  }
+
+  if (keyframe) {
+    type = KEYFRAME_RECORD;
+    output->keyframe.Set(output->data);
+    output->keyframe_id++;
+    output->keyframe_time = now;
+    output->has_keyframe = true;
+    output->force_keyframe = false;
+    body_size = data_size;
+    if (body_size) {
+      memcpy(body, output->data.GetRaw(), body_size);
+    }
+  }
+
+  WriteUInt32(record, universe);
+  record[4] = type;
+  record[5] = output->keyframe_id;
+  WriteUInt16(record + 6, static_cast<uint16_t>(body_size));
+  return RECORD_HEADER_SIZE + body_size;
+}
+
+
+/*
+ * Encode the slots that differ from the keyframe. Runs are merged if the gap
+ * between them is smaller than the run header.
+ * @returns the size of the delta, or 0 if it would be max_size or larger.
+ */
+unsigned int ReplicationNode::EncodeDelta(const DmxBuffer &keyframe,
+                                          const DmxBuffer &data,
+                                          uint8_t *output,
+                                          unsigned int max_size) {
+  const unsigned int size = data.Size();
+  const unsigned int keyframe_size = keyframe.Size();
+  const uint8_t *current = data.GetRaw();
+  const uint8_t *base = keyframe.GetRaw();
+
+  if (max_size <= 2) {
+    return 0;
+  }
+  WriteUInt16(output, static_cast<uint16_t>(size));
+  unsigned int length = 2;
+
+  unsigned int i = 0;
+  while (i < size) {
+    if (i < keyframe_size && current[i] == base[i]) {
+      i++;
+      continue;
+    }
+
+    const unsigned int start = i;
+    unsigned int end = i + 1;
+    for (unsigned int j = end; j < size && j - start < MAX_RUN_LENGTH; j++) {
+      if (j >= keyframe_size || current[j] != base[j]) {
+        end = j + 1;
+      } else if (j + 1 - end >= RUN_HEADER_SIZE) {
+        break;
+      }
+    }
+
+    const unsigned int count = end - start;
+    if (length + RUN_HEADER_SIZE + count >= max_size) {
+      return 0;
+    }
+    WriteUInt16(output + length, static_cast<uint16_t>(start));
+    output[length + 2] = static_cast<uint8_t>(count);
+    memcpy(output + length + RUN_HEADER_SIZE, current + start, count);
+    length += RUN_HEADER_SIZE + count;
+    i = end;
+  }
+  return length;
+}
+
+
+bool ReplicationNode::SendDatagram(unsigned int size) {
+  bool ok = true;
+  vector<IPV4SocketAddress>::const_iterator iter = m_targets.begin();
+  for (; iter != m_targets.end(); ++iter) {
+    ssize_t bytes_sent = m_socket->SendTo(&m_datagram[0], size, *iter);
+    if (bytes_sent != static_cast<ssize_t>(size)) {
+      OLA_WARN << "Failed to send replication datagram to " << *iter;
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+
+/*
+ * Send a keyframe for the universes that haven't had one for the keyframe
+ * interval, so receivers that join late catch up even if nothing changes.
+ */
+bool ReplicationNode::RefreshKeyframes() {
+  const TimeInterval interval(
+      static_cast<int64_t>(m_options.keyframe_interval) * 1000);
+  const TimeStamp &now = Now();
+
+  OutputUniverseMap::iterator iter = m_output_universes.begin();
+  for (; iter != m_output_universes.end(); ++iter) {
+    OutputUniverse *output = iter->second;
+    if (output->has_keyframe && now >= output->keyframe_time + interval) {
+      output->force_keyframe = true;
+      MarkDirty(iter->first, output);
+    }
+  }
+
+  if (!m_batch_depth) {
+    Flush();
+  }
+  return true;
+}
+
+
+void ReplicationNode::SocketReady() {
+  OLA_TRACE_SCOPE("replication", "ReplicationNode::SocketReady");
+  if (!m_socket->RecvBatch(&m_recv_batch)) {
+    return;
+  }
+
+  for (unsigned int i = 0; i < m_recv_batch.Size(); i++) {
+    HandleDatagram(m_recv_batch.Data(i), m_recv_batch.Length(i),
+                   m_recv_batch.Source(i));
+  }
+}
+
+
+void ReplicationNode::HandleDatagram(const uint8_t *data,
+                                     unsigned int length,
+                                     const IPV4SocketAddress &source) {
+  if (length < HEADER_SIZE || data[0] != MAGIC_HIGH ||
+      data[1] != MAGIC_LOW) {
+    OLA_DEBUG << "Ignoring non-replication datagram from " << source;
+    return;
+  }
+
+  if (data[2] != PROTOCOL_VERSION) {
+    OLA_DEBUG << "Unknown replication version " << static_cast<int>(data[2])
+              << " from " << source;
+    return;
+  }
+
+  switch (data[3]) {
+    case DATA_MESSAGE:
+      HandleData(data, length, source);
+      break;
+    case KEYFRAME_REQUEST_MESSAGE:
+      HandleKeyframeRequest(data, length);
+      break;
+    default:
+      OLA_DEBUG << "Unknown replication message " << static_cast<int>(data[3])
+                << " from " << source;
+  }
+}
+
+
+void ReplicationNode::HandleData(const uint8_t *data,
+                                 unsigned int length,
+                                 const IPV4SocketAddress &source) {
+  const TimeStamp &now = Now();
+  const TimeInterval request_interval(
+      static_cast<int64_t>(KEYFRAME_REQUEST_INTERVAL_MS) * 1000);
+  m_keyframe_requests.clear();
+
+  unsigned int offset = HEADER_SIZE;
+  while (offset + RECORD_HEADER_SIZE <= length) {
+    const uint8_t *record = data + offset;
+    const unsigned int universe = JoinUInt8(record[0], record[1], record[2],
+                                            record[3]);
+    const uint8_t type = record[4];
+    const uint8_t keyframe_id = record[5];
+    const unsigned int body_length = JoinUInt8(record[6], record[7]);
+    offset += RECORD_HEADER_SIZE;
+    if (offset + body_length > length) {
+      OLA_DEBUG << "Truncated replication record from " << source;
+      break;
+    }
+    const uint8_t *body = data + offset;
+    offset += body_length;
+
+    InputUniverse *input = STLFindOrNull(m_input_universes, universe);
+    if (!input) {
+      continue;
+    }
+
+    if (type == KEYFRAME_RECORD) {
+      if (body_length > DMX_UNIVERSE_SIZE) {
+        continue;
+      }
+      input->keyframe.Set(body, body_length);
+      input->keyframe_id = keyframe_id;
+      input->has_keyframe = true;
+      input->buffer->Set(input->keyframe);
+      input->handler->Run();
+    } else if (type == DELTA_RECORD) {
+      if (input->has_keyframe && input->keyframe_id == keyframe_id) {
+        if (ApplyDelta(input, body, body_length)) {
+          input->handler->Run();
+        }
+      } else if (!input->last_request.IsSet() ||
+                 now >= input->last_request + request_interval) {
+        input->last_request = now;
+        m_keyframe_requests.push_back(universe);
+      }
+    }
+  }
+
+  if (m_keyframe_requests.empty() || !m_socket.get()) {
+    return;
+  }
+
+  uint8_t *datagram = &m_datagram[0];
+  datagram[0] = MAGIC_HIGH;
+  datagram[1] = MAGIC_LOW;
+  datagram[2] = PROTOCOL_VERSION;
+  datagram[3] = KEYFRAME_REQUEST_MESSAGE;
+  unsigned int size = HEADER_SIZE;
+  vector<unsigned int>::const_iterator iter = m_keyframe_requests.begin();
+  for (; iter != m_keyframe_requests.end() && size + 4 <= m_datagram.size();
+       ++iter) {
+    WriteUInt32(datagram + size, *iter);
+    size += 4;
+  }
+
+  if (m_socket->SendTo(datagram, size, source) !=
+      static_cast<ssize_t>(size)) {
+    OLA_WARN << "Failed to send keyframe request to " << source;
+  }
+}
+
+
+void ReplicationNode::HandleKeyframeRequest(const uint8_t *data,
+                                            unsigned int length) {
+  for (unsigned int offset = HEADER_SIZE; offset + 4 <= length; offset += 4) {
+    const unsigned int universe = JoinUInt8(data[offset], data[offset + 1],
+                                            data[offset + 2], data[offset + 3]);
+    OutputUniverse *output = STLFindOrNull(m_output_universes, universe);
+    if (output && output->has_keyframe) {
+      output->force_keyframe = true;
+      MarkDirty(universe, output);
+    }
+  }
+
+  if (!m_batch_depth) {
+    Flush();
+  }
+}
+
+
+/*
+ * Rebuild the frame from the keyframe and the runs in the delta.
+ */
+bool ReplicationNode::ApplyDelta(InputUniverse *input,
+                                 const uint8_t *body,
+                                 unsigned int length) {
+  if (length < 2) {
+    return false;
+  }
+  const unsigned int frame_size = JoinUInt8(body[0], body[1]);
+  if (frame_size > DMX_UNIVERSE_SIZE) {
+    return false;
+  }
+
+  uint8_t frame[DMX_UNIVERSE_SIZE];
+  const unsigned int keyframe_size = std::min(frame_size,
+                                              input->keyframe.Size());
+  if (keyframe_size) {
+    memcpy(frame, input->keyframe.GetRaw(), keyframe_size);
+  }
+  memset(frame + keyframe_size, 0, frame_size - keyframe_size);
+
+  unsigned int offset = 2;
+  while (offset + RUN_HEADER_SIZE <= length) {
+    const unsigned int start = JoinUInt8(body[offset], body[offset + 1]);
+    const unsigned int count = body[offset + 2];
+    offset += RUN_HEADER_SIZE;
+    if (offset + count > length || start + count > frame_size) {
+      OLA_DEBUG << "Invalid replication delta";
+      return false;
+    }
+    memcpy(frame + start, body + offset, count);
+    offset += count;
+  }
+  input->buffer->Set(frame, frame_size);
+  return true;
+}
+
+
+const TimeStamp &ReplicationNode::Now() const {
+  return *m_ss->WakeUpTime();
+}
+}  // namespace replication
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,229 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ReplicationNode.h
+ * Replicates universes between olad instances.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_REPLICATION_REPLICATIONNODE_H_
+#define PLUGINS_REPLICATION_REPLICATIONNODE_H_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/io/SelectServerInterface.h"
+#include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/network/UDPReceiveStats.h"
+
+namespace ola {
+namespace plugin {
+namespace replication {
+
+/**
+ * @brief Sends and receives universes using the replication protocol.
+ *
+ * Each datagram starts with a 4 byte header: the magic number 'O' 'R', the
+ * version, and the message type. All fields are big endian.
+ *
+ * DATA messages carry a record for each universe, packed until the datagram
+ * is full:
+ *  - universe (4 bytes)
+ *  - record type (1 byte), KEYFRAME or DELTA.
+ *  - keyframe id (1 byte)
+ *  - body length (2 bytes)
+ *  - the body.
+ *
+ * The body of a KEYFRAME is the DMX data. The body of a DELTA is the frame
+ * size (2 bytes), then a list of runs of slots that differ from the keyframe:
+ * offset (2 bytes), count (1 byte) and the slot data. Deltas are always
+ * against the last keyframe, so a lost delta doesn't affect the ones that
+ * follow it.
+ *
+ * A new keyframe is sent when a delta would be larger than the frame, and
+ * every keyframe interval, even if the universe hasn't changed.
+ *
+ * When a receiver gets a delta for a keyframe it doesn't have, it replies with
+ * a KEYFRAME_REQUEST message containing the universes (4 bytes each). The
+ * sender then sends a new keyframe for those universes to all targets.
+ */
+class ReplicationNode {
+ public:
+  struct Options {
+   public:
+    Options()
+        : port(DEFAULT_PORT),
+          keyframe_interval(DEFAULT_KEYFRAME_INTERVAL_MS),
+          max_datagram_size(DEFAULT_MAX_DATAGRAM_SIZE) {
+    }
+
+    // The UDP port to listen & send on.
+    uint16_t port;
+    // How often to send a keyframe for each universe, in ms.
+    unsigned int keyframe_interval;
+    // The largest datagram to send, this should fit in the path MTU.
+    unsigned int max_datagram_size;
+    ola::network::UDPReceiveOptions receive_options;
+  };
+
+  /**
+   * @brief Create a new ReplicationNode.
+   * @param ss the SelectServerInterface to use.
+   * @param options the Options for the node.
+   * @param socket a UDPSocket or NULL. Ownership is transferred.
+   */
+  ReplicationNode(ola::io::SelectServerInterface *ss,
+                  const Options &options,
+                  ola::network::UDPSocketInterface *socket = NULL);
+  ~ReplicationNode();
+
+  bool Start();
+  bool Stop();
+
+  /**
+   * @brief Add a node to send universes to.
+   */
+  void AddTarget(const ola::network::IPV4SocketAddress &target);
+
+  /**
+   * @brief Queue a universe to be sent.
+   *
+   * Outside of a batch the universe is sent immediately.
+   */
+  bool SendDMX(unsigned int universe, const DmxBuffer &buffer);
+
+  /**
+   * @brief Stop sending a universe.
+   */
+  void RemoveUniverse(unsigned int universe);
+
+  /**
+   * @brief The universes queued until the outermost EndBatch() are packed
+   * into as few datagrams as possible.
+   */
+  void BeginBatch();
+  bool EndBatch();
+
+  /**
+   * @brief Set the handler for a universe we receive.
+   * @param universe the universe to receive.
+   * @param buffer the DmxBuffer to update with the data.
+   * @param handler the handler to run when the data changes, ownership is
+   *   transferred.
+   */
+  bool SetHandler(unsigned int universe, DmxBuffer *buffer,
+                  ola::Callback0<void> *handler);
+  bool RemoveHandler(unsigned int universe);
+
+  static const uint16_t DEFAULT_PORT = 5570;
+  static const unsigned int DEFAULT_KEYFRAME_INTERVAL_MS = 1000;
+  static const unsigned int DEFAULT_MAX_DATAGRAM_SIZE = 1400;
+  // The largest datagram we accept.
+  static const unsigned int MAX_DATAGRAM_SIZE = 9000;
+
+ private:
+  struct OutputUniverse {
+    OutputUniverse() : keyframe_id(0), has_keyframe(false), dirty(false),
+                       force_keyframe(false) {}
+
+    DmxBuffer data;
+    DmxBuffer keyframe;
+    uint8_t keyframe_id;
+    bool has_keyframe;
+    // True if the universe is in m_dirty_universes.
+    bool dirty;
+    bool force_keyframe;
+    TimeStamp keyframe_time;
+  };
+
+  struct InputUniverse {
+    InputUniverse() : buffer(NULL), handler(NULL), keyframe_id(0),
+                      has_keyframe(false) {}
+
+    DmxBuffer *buffer;
+    ola::Callback0<void> *handler;
+    DmxBuffer keyframe;
+    uint8_t keyframe_id;
+    bool has_keyframe;
+    TimeStamp last_request;
+  };
+
+  typedef std::map<unsigned int, OutputUniverse*> OutputUniverseMap;
+  typedef std::map<unsigned int, InputUniverse*> InputUniverseMap;
+
+  ola::io::SelectServerInterface *m_ss;
+  const Options m_options;
+  bool m_running;
+  unsigned int m_batch_depth;
+  std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
+  ola::network::DatagramBatch m_recv_batch;
+  std::vector<ola::network::IPV4SocketAddress> m_targets;
+  OutputUniverseMap m_output_universes;
+  InputUniverseMap m_input_universes;
+  std::vector<unsigned int> m_dirty_universes;
+  std::vector<uint8_t> m_datagram;
+  std::vector<unsigned int> m_keyframe_requests;
+  ola::thread::timeout_id m_keyframe_timeout;
+
+  bool InitNetwork();
+  bool Flush();
+  void MarkDirty(unsigned int universe, OutputUniverse *output);
+  unsigned int PackUniverse(unsigned int universe, OutputUniverse *output,
+                            uint8_t *record, const TimeStamp &now);
+  bool SendDatagram(unsigned int size);
+  bool RefreshKeyframes();
+  void SocketReady();
+  void HandleDatagram(const uint8_t *data, unsigned int length,
+                      const ola::network::IPV4SocketAddress &source);
+  void HandleData(const uint8_t *data, unsigned int length,
+                  const ola::network::IPV4SocketAddress &source);
+  void HandleKeyframeRequest(const uint8_t *data, unsigned int length);
+  bool ApplyDelta(InputUniverse *input, const uint8_t *body,
+                  unsigned int length);
+  const TimeStamp &Now() const;
+
+  static unsigned int EncodeDelta(const DmxBuffer &keyframe,
+                                  const DmxBuffer &data,
+                                  uint8_t *output,
+                                  unsigned int max_size);
+
+  static const uint8_t MAGIC_HIGH = 'O';
+  static const uint8_t MAGIC_LOW = 'R';
+  static const uint8_t PROTOCOL_VERSION = 1;
+  static const uint8_t DATA_MESSAGE = 1;
+  static const uint8_t KEYFRAME_REQUEST_MESSAGE = 2;
+  static const uint8_t KEYFRAME_RECORD = 0;
+  static const uint8_t DELTA_RECORD = 1;
+  static const unsigned int HEADER_SIZE = 4;
+  static const unsigned int RECORD_HEADER_SIZE = 8;
+  static const unsigned int RUN_HEADER_SIZE = 3;
+  static const unsigned int MAX_RUN_LENGTH = 255;
+  static const unsigned int KEYFRAME_TICK_MS = 100;
+  static const unsigned int KEYFRAME_REQUEST_INTERVAL_MS = 100;
+  static const unsigned int RECV_BATCH_SIZE = 32;
+
+  DISALLOW_COPY_AND_ASSIGN(ReplicationNode);
+};
+}  // namespace replication
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_REPLICATION_REPLICATIONNODE_H_
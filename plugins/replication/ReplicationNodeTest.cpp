@@ -0,0 +1,278 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ReplicationNodeTest.cpp
+ * Test fixture for the ReplicationNode class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/replication/ReplicationNode.h"
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::plugin::replication::ReplicationNode;
+using ola::testing::MockUDPSocket;
+
+
+class ReplicationNodeTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ReplicationNodeTest);
+  CPPUNIT_TEST(testSendKeyframeAndDelta);
+  CPPUNIT_TEST(testSendBatch);
+  CPPUNIT_TEST(testKeyframeRequest);
+  CPPUNIT_TEST(testReceive);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  ReplicationNodeTest()
+      : CppUnit::TestFixture(),
+        ss(NULL),
+        m_socket(new MockUDPSocket()),
+        m_handler_count(0) {
+  }
+  void setUp();
+
+  void testSendKeyframeAndDelta();
+  void testSendBatch();
+  void testKeyframeRequest();
+  void testReceive();
+
+ private:
+  ola::io::SelectServer ss;
+  IPV4SocketAddress m_target;
+  MockUDPSocket *m_socket;
+  unsigned int m_handler_count;
+  uint8_t m_frame[32];
+
+  void NewData() { m_handler_count++; }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ReplicationNodeTest);
+
+void ReplicationNodeTest::setUp() {
+  ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  IPV4Address target_ip;
+  IPV4Address::FromString("10.0.0.10", &target_ip);
+  m_target = IPV4SocketAddress(target_ip, ReplicationNode::DEFAULT_PORT);
+  for (unsigned int i = 0; i < sizeof(m_frame); i++) {
+    m_frame[i] = i;
+  }
+}
+
+
+/**
+ * Check that the first frame is sent as a keyframe and then as deltas.
+ */
+void ReplicationNodeTest::testSendKeyframeAndDelta() {
+  ReplicationNode node(&ss, ReplicationNode::Options(), m_socket);
+  OLA_ASSERT_TRUE(node.Start());
+  OLA_ASSERT_TRUE(m_socket->CheckNetworkParamsMatch(
+      true, true, ReplicationNode::DEFAULT_PORT, true));
+  node.AddTarget(m_target);
+
+  uint8_t expected_keyframe[4 + 8 + sizeof(m_frame)] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 1, 0, 1, 0, 32,
+  };
+  memcpy(expected_keyframe + 12, m_frame, sizeof(m_frame));
+  m_socket->AddExpectedData(expected_keyframe, sizeof(expected_keyframe),
+                            m_target.Host(), m_target.Port());
+
+  DmxBuffer buffer(m_frame, sizeof(m_frame));
+  OLA_ASSERT_TRUE(node.SendDMX(1, buffer));
+  m_socket->Verify();
+
+  // Slots 1 & 3 are sent as one run, slot 9 as another.
+  const uint8_t expected_delta[] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 1, 1, 1, 0, 12,
+    0, 32,
+    0, 1, 3, 20, 2, 40,
+    0, 9, 1, 90,
+  };
+  m_socket->AddExpectedData(expected_delta, sizeof(expected_delta),
+                            m_target.Host(), m_target.Port());
+  buffer.SetChannel(1, 20);
+  buffer.SetChannel(3, 40);
+  buffer.SetChannel(9, 90);
+  OLA_ASSERT_TRUE(node.SendDMX(1, buffer));
+  m_socket->Verify();
+
+  // If the delta would be larger than the frame, a new keyframe is sent.
+  DmxBuffer new_frame;
+  new_frame.SetFromString("1,2,3,4");
+  const uint8_t expected_new_keyframe[] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 1, 0, 2, 0, 4,
+    1, 2, 3, 4,
+  };
+  m_socket->AddExpectedData(expected_new_keyframe,
+                            sizeof(expected_new_keyframe),
+                            m_target.Host(), m_target.Port());
+  OLA_ASSERT_TRUE(node.SendDMX(1, new_frame));
+  m_socket->Verify();
+  OLA_ASSERT_TRUE(node.Stop());
+}
+
+
+/**
+ * Check the universes in a batch are packed into one datagram.
+ */
+void ReplicationNodeTest::testSendBatch() {
+  ReplicationNode node(&ss, ReplicationNode::Options(), m_socket);
+  OLA_ASSERT_TRUE(node.Start());
+  node.AddTarget(m_target);
+
+  const uint8_t expected_data[] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 5, 0, 1, 0, 2, 1, 2,
+    0, 1, 0, 0, 0, 1, 0, 3, 7, 8, 9,
+  };
+  m_socket->AddExpectedData(expected_data, sizeof(expected_data),
+                            m_target.Host(), m_target.Port());
+
+  DmxBuffer buffer;
+  node.BeginBatch();
+  buffer.SetFromString("1,2");
+  OLA_ASSERT_TRUE(node.SendDMX(5, buffer));
+  buffer.SetFromString("7,8,9");
+  OLA_ASSERT_TRUE(node.SendDMX(65536, buffer));
+  OLA_ASSERT_TRUE(node.EndBatch());
+  m_socket->Verify();
+  OLA_ASSERT_TRUE(node.Stop());
+}
+
+
+/**
+ * Check a keyframe request causes a new keyframe to be sent.
+ */
+void ReplicationNodeTest::testKeyframeRequest() {
+  ReplicationNode node(&ss, ReplicationNode::Options(), m_socket);
+  OLA_ASSERT_TRUE(node.Start());
+  node.AddTarget(m_target);
+
+  const uint8_t expected_keyframe[] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 1, 0, 1, 0, 2, 1, 2,
+  };
+  m_socket->AddExpectedData(expected_keyframe, sizeof(expected_keyframe),
+                            m_target.Host(), m_target.Port());
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2");
+  OLA_ASSERT_TRUE(node.SendDMX(1, buffer));
+  m_socket->Verify();
+
+  // Universe 2 isn't sent, so it's ignored.
+  const uint8_t request[] = {
+    'O', 'R', 1, 2,
+    0, 0, 0, 1,
+    0, 0, 0, 2,
+  };
+  const uint8_t expected_new_keyframe[] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 1, 0, 2, 0, 2, 1, 2,
+  };
+  m_socket->AddExpectedData(expected_new_keyframe,
+                            sizeof(expected_new_keyframe),
+                            m_target.Host(), m_target.Port());
+  m_socket->InjectData(request, sizeof(request), m_target);
+  m_socket->Verify();
+  OLA_ASSERT_TRUE(node.Stop());
+}
+
+
+/**
+ * Check receiving keyframes and deltas.
+ */
+void ReplicationNodeTest::testReceive() {
+  ReplicationNode node(&ss, ReplicationNode::Options(), m_socket);
+  OLA_ASSERT_TRUE(node.Start());
+
+  DmxBuffer buffer;
+  OLA_ASSERT_TRUE(node.SetHandler(
+      1, &buffer, NewCallback(this, &ReplicationNodeTest::NewData)));
+
+  // A delta without a keyframe triggers a keyframe request.
+  const uint8_t delta[] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 1, 1, 7, 0, 6,
+    0, 4, 0, 1, 1, 20,
+  };
+  const uint8_t expected_request[] = {
+    'O', 'R', 1, 2,
+    0, 0, 0, 1,
+  };
+  m_socket->AddExpectedData(expected_request, sizeof(expected_request),
+                            m_target.Host(), m_target.Port());
+  m_socket->InjectData(delta, sizeof(delta), m_target);
+  m_socket->Verify();
+  OLA_ASSERT_EQ(0u, m_handler_count);
+
+  // Universe 2 isn't patched so it's skipped.
+  const uint8_t keyframes[] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 2, 0, 1, 0, 2, 9, 9,
+    0, 0, 0, 1, 0, 7, 0, 4, 1, 2, 3, 4,
+  };
+  m_socket->InjectData(keyframes, sizeof(keyframes), m_target);
+  OLA_ASSERT_EQ(1u, m_handler_count);
+  DmxBuffer expected;
+  expected.SetFromString("1,2,3,4");
+  OLA_ASSERT_EQ(expected, buffer);
+
+  m_socket->InjectData(delta, sizeof(delta), m_target);
+  OLA_ASSERT_EQ(2u, m_handler_count);
+  expected.SetFromString("1,20,3,4");
+  OLA_ASSERT_EQ(expected, buffer);
+
+  // Deltas that are larger than the keyframe are padded with zeros, and
+  // invalid runs are ignored.
+  const uint8_t longer_delta[] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 1, 1, 7, 0, 6,
+    0, 6, 0, 5, 1, 60,
+  };
+  m_socket->InjectData(longer_delta, sizeof(longer_delta), m_target);
+  OLA_ASSERT_EQ(3u, m_handler_count);
+  expected.SetFromString("1,2,3,4,0,60");
+  OLA_ASSERT_EQ(expected, buffer);
+
+  const uint8_t invalid_delta[] = {
+    'O', 'R', 1, 1,
+    0, 0, 0, 1, 1, 7, 0, 6,
+    0, 4, 0, 4, 1, 60,
+  };
+  m_socket->InjectData(invalid_delta, sizeof(invalid_delta), m_target);
+  OLA_ASSERT_EQ(3u, m_handler_count);
+
+  OLA_ASSERT_TRUE(node.RemoveHandler(1));
+  OLA_ASSERT_FALSE(node.RemoveHandler(1));
+  m_socket->InjectData(keyframes, sizeof(keyframes), m_target);
+  OLA_ASSERT_EQ(3u, m_handler_count);
+  OLA_ASSERT_TRUE(node.Stop());
+}
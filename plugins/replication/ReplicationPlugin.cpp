@@ -0,0 +1,182 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ReplicationPlugin.cpp
+ * Replicates universes between olad instances.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/Preferences.h"
+#include "olad/UDPReceivePreferences.h"
+#include "plugins/replication/ReplicationDevice.h"
+#include "plugins/replication/ReplicationNode.h"
+#include "plugins/replication/ReplicationPlugin.h"
+#include "plugins/replication/ReplicationPluginDescription.h"
+
+
+namespace ola {
+namespace plugin {
+namespace replication {
+
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using std::string;
+using std::vector;
+
+const char ReplicationPlugin::PLUGIN_NAME[] = "Replication";
+const char ReplicationPlugin::PLUGIN_PREFIX[] = "replication";
+const char ReplicationPlugin::TARGET_KEY[] = "target";
+const char ReplicationPlugin::PORT_KEY[] = "port";
+const char ReplicationPlugin::INPUT_PORTS_KEY[] = "input_ports";
+const char ReplicationPlugin::OUTPUT_PORTS_KEY[] = "output_ports";
+const char ReplicationPlugin::KEYFRAME_INTERVAL_KEY[] = "keyframe_interval";
+const char ReplicationPlugin::MAX_DATAGRAM_SIZE_KEY[] = "max_datagram_size";
+
+ReplicationPlugin::ReplicationPlugin(PluginAdaptor *plugin_adaptor)
+    : Plugin(plugin_adaptor) {
+}
+
+ReplicationPlugin::~ReplicationPlugin() {}
+
+/*
+ * Start the plugin.
+ */
+bool ReplicationPlugin::StartHook() {
+  ReplicationNode::Options options;
+  options.port = ReadUIntPreference(PORT_KEY, ReplicationNode::DEFAULT_PORT);
+  options.keyframe_interval = ReadUIntPreference(
+      KEYFRAME_INTERVAL_KEY, ReplicationNode::DEFAULT_KEYFRAME_INTERVAL_MS);
+  options.max_datagram_size = ReadUIntPreference(
+      MAX_DATAGRAM_SIZE_KEY, ReplicationNode::DEFAULT_MAX_DATAGRAM_SIZE);
+  ReadUDPReceivePreferences(*m_preferences, m_plugin_adaptor->GetExportMap(),
+                            "replication", &options.receive_options);
+
+  vector<string> target_strings = m_preferences->GetMultipleValue(TARGET_KEY);
+  vector<string>::const_iterator iter = target_strings.begin();
+  vector<IPV4SocketAddress> targets;
+  for (; iter != target_strings.end(); ++iter) {
+    if (iter->empty()) {
+      continue;
+    }
+    IPV4SocketAddress target;
+    IPV4Address address;
+    if (IPV4SocketAddress::FromString(*iter, &target)) {
+      targets.push_back(target);
+    } else if (IPV4Address::FromString(*iter, &address)) {
+      targets.push_back(IPV4SocketAddress(address, options.port));
+    } else {
+      OLA_WARN << "Invalid replication target: " << *iter;
+    }
+  }
+
+  m_device.reset(new ReplicationDevice(
+      this, m_plugin_adaptor, options, targets,
+      ReadUIntPreference(INPUT_PORTS_KEY, DEFAULT_PORT_COUNT),
+      ReadUIntPreference(OUTPUT_PORTS_KEY, DEFAULT_PORT_COUNT)));
+
+  if (!m_device->Start()) {
+    m_device.reset();
+    return false;
+  }
+  m_plugin_adaptor->RegisterDevice(m_device.get());
+  return true;
+}
+
+
+/*
+ * Stop the plugin
+ * @return true on success, false on failure
+ */
+bool ReplicationPlugin::StopHook() {
+  if (m_device.get()) {
+    // stop the device
+    m_plugin_adaptor->UnregisterDevice(m_device.get());
+    bool ret = m_device->Stop();
+    m_device.reset();
+    return ret;
+  }
+  return true;
+}
+
+
+/*
+ * Return the description for this plugin.
+ * @return a string description of the plugin
+ */
+string ReplicationPlugin::Description() const {
+  return plugin_description;
+}
+
+
+/*
+ * Set default preferences.
+ */
+bool ReplicationPlugin::SetDefaultPreferences() {
+  bool save = false;
+
+  if (!m_preferences) {
+    return false;
+  }
+
+  save |= m_preferences->SetDefaultValue(TARGET_KEY, StringValidator(true),
+                                         "");
+  save |= m_preferences->SetDefaultValue(PORT_KEY, UIntValidator(1, 0xffff),
+                                         ReplicationNode::DEFAULT_PORT);
+  save |= m_preferences->SetDefaultValue(INPUT_PORTS_KEY,
+                                         UIntValidator(0, MAX_PORT_COUNT),
+                                         DEFAULT_PORT_COUNT);
+  save |= m_preferences->SetDefaultValue(OUTPUT_PORTS_KEY,
+                                         UIntValidator(0, MAX_PORT_COUNT),
+                                         DEFAULT_PORT_COUNT);
+  save |= m_preferences->SetDefaultValue(
+      KEYFRAME_INTERVAL_KEY,
+      UIntValidator(MIN_KEYFRAME_INTERVAL_MS, MAX_KEYFRAME_INTERVAL_MS),
+      ReplicationNode::DEFAULT_KEYFRAME_INTERVAL_MS);
+  save |= m_preferences->SetDefaultValue(
+      MAX_DATAGRAM_SIZE_KEY,
+      UIntValidator(MIN_DATAGRAM_SIZE, ReplicationNode::MAX_DATAGRAM_SIZE),
+      ReplicationNode::DEFAULT_MAX_DATAGRAM_SIZE);
+  save |= SetDefaultUDPReceivePreferences(m_preferences);
+
+  if (save) {
+    m_preferences->Save();
+  }
+  return true;
+}
+
+
+/*
+ * Read an unsigned int preference, falling back to the default.
+ */
+unsigned int ReplicationPlugin::ReadUIntPreference(
+    const string &key,
+    unsigned int default_value) const {
+  unsigned int value;
+  if (!StringToInt(m_preferences->GetValue(key), &value)) {
+    return default_value;
+  }
+  return value;
+}
+}  // namespace replication
+}  // namespace plugin
+}  // namespace ola
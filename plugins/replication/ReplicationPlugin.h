@@ -0,0 +1,71 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ReplicationPlugin.h
+ * Replicates universes between olad instances.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_REPLICATION_REPLICATIONPLUGIN_H_
+#define PLUGINS_REPLICATION_REPLICATIONPLUGIN_H_
+
+#include <memory>
+#include <string>
+#include "olad/Plugin.h"
+#include "ola/plugin_id.h"
+
+namespace ola {
+namespace plugin {
+namespace replication {
+
+class ReplicationPlugin : public Plugin {
+ public:
+  explicit ReplicationPlugin(PluginAdaptor *plugin_adaptor);
+  ~ReplicationPlugin();
+
+  std::string Name() const { return PLUGIN_NAME; }
+  ola_plugin_id Id() const { return OLA_PLUGIN_REPLICATION; }
+  std::string Description() const;
+  std::string PluginPrefix() const { return PLUGIN_PREFIX; }
+
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
+ private:
+  std::auto_ptr<class ReplicationDevice> m_device;  // only have one device
+
+  bool StartHook();
+  bool StopHook();
+  bool SetDefaultPreferences();
+  unsigned int ReadUIntPreference(const std::string &key,
+                                  unsigned int default_value) const;
+
+  static const char TARGET_KEY[];
+  static const char PORT_KEY[];
+  static const char INPUT_PORTS_KEY[];
+  static const char OUTPUT_PORTS_KEY[];
+  static const char KEYFRAME_INTERVAL_KEY[];
+  static const char MAX_DATAGRAM_SIZE_KEY[];
+  static const unsigned int DEFAULT_PORT_COUNT = 16;
+  static const unsigned int MAX_PORT_COUNT = 4096;
+  static const unsigned int MIN_KEYFRAME_INTERVAL_MS = 100;
+  static const unsigned int MAX_KEYFRAME_INTERVAL_MS = 60000;
+  // Enough for a full universe in one record.
+  static const unsigned int MIN_DATAGRAM_SIZE = 524;
+};
+}  // namespace replication
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_REPLICATION_REPLICATIONPLUGIN_H_
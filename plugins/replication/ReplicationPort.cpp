@@ -0,0 +1,95 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ReplicationPort.cpp
+ * The ports for the replication plugin.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "olad/Universe.h"
+#include "plugins/replication/ReplicationPort.h"
+
+namespace ola {
+namespace plugin {
+namespace replication {
+
+/*
+ * Check for loops.
+ */
+bool ReplicationInputPort::PreSetUniverse(OLA_UNUSED Universe *old_universe,
+                                          OLA_UNUSED Universe *new_universe) {
+  OutputPort *output_port = GetDevice()->GetOutputPort(PortId());
+  if (output_port && output_port->GetUniverse()) {
+    OLA_WARN << "Avoiding possible replication loop on port " << PortId();
+    return false;
+  }
+  return true;
+}
+
+
+/*
+ * We intercept this to setup/remove the dmx handler
+ */
+void ReplicationInputPort::PostSetUniverse(Universe *old_universe,
+                                           Universe *new_universe) {
+  if (old_universe) {
+    m_node->RemoveHandler(old_universe->UniverseId());
+  }
+
+  if (new_universe) {
+    m_node->SetHandler(
+        new_universe->UniverseId(),
+        &m_buffer,
+        NewCallback<ReplicationInputPort, void>(
+            this, &ReplicationInputPort::DmxChanged));
+  }
+}
+
+
+/*
+ * Check for loops.
+ */
+bool ReplicationOutputPort::PreSetUniverse(OLA_UNUSED Universe *old_universe,
+                                           OLA_UNUSED Universe *new_universe) {
+  InputPort *input_port = GetDevice()->GetInputPort(PortId());
+  if (input_port && input_port->GetUniverse()) {
+    OLA_WARN << "Avoiding possible replication loop on port " << PortId();
+    return false;
+  }
+  return true;
+}
+
+
+void ReplicationOutputPort::PostSetUniverse(Universe *old_universe,
+                                            OLA_UNUSED Universe *new_universe) {
+  if (old_universe) {
+    m_node->RemoveUniverse(old_universe->UniverseId());
+  }
+}
+
+
+bool ReplicationOutputPort::WriteDMX(const DmxBuffer &buffer,
+                                     OLA_UNUSED uint8_t priority) {
+  Universe *universe = GetUniverse();
+  if (!universe) {
+    return false;
+  }
+  return m_node->SendDMX(universe->UniverseId(), buffer);
+}
+}  // namespace replication
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ReplicationPort.h
+ * The ports for the replication plugin.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_REPLICATION_REPLICATIONPORT_H_
+#define PLUGINS_REPLICATION_REPLICATIONPORT_H_
+
+#include <string>
+#include "ola/DmxBuffer.h"
+#include "olad/Port.h"
+#include "plugins/replication/ReplicationDevice.h"
+#include "plugins/replication/ReplicationNode.h"
+
+namespace ola {
+namespace plugin {
+namespace replication {
+
+/**
+ * @brief Receives the universe with the same number as the universe the port
+ * is patched to.
+ */
+class ReplicationInputPort: public BasicInputPort {
+ public:
+  ReplicationInputPort(ReplicationDevice *parent,
+                       unsigned int id,
+                       class PluginAdaptor *plugin_adaptor,
+                       ReplicationNode *node)
+      : BasicInputPort(parent, id, plugin_adaptor),
+        m_node(node) {
+  }
+
+  std::string Description() const { return "Receives the patched universe"; }
+  const ola::DmxBuffer &ReadDMX() const { return m_buffer; }
+  bool PreSetUniverse(Universe *old_universe, Universe *new_universe);
+  void PostSetUniverse(Universe *old_universe, Universe *new_universe);
+
+ private:
+  DmxBuffer m_buffer;
+  ReplicationNode *m_node;
+};
+
+
+/**
+ * @brief Sends the universe the port is patched to.
+ */
+class ReplicationOutputPort: public BasicOutputPort {
+ public:
+  ReplicationOutputPort(ReplicationDevice *parent,
+                        unsigned int id,
+                        ReplicationNode *node)
+      : BasicOutputPort(parent, id),
+        m_node(node) {
+  }
+
+  std::string Description() const { return "Sends the patched universe"; }
+  bool PreSetUniverse(Universe *old_universe, Universe *new_universe);
+  void PostSetUniverse(Universe *old_universe, Universe *new_universe);
+  bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t priority);
+
+  // All the universes written in a tick are packed together.
+  void BeginBatch() { m_node->BeginBatch(); }
+  void EndBatch() { m_node->EndBatch(); }
+
+ private:
+  ReplicationNode *m_node;
+};
+}  // namespace replication
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_REPLICATION_REPLICATIONPORT_H_
@@ -64,7 +64,8 @@ bool SandNetDevice::StartHook() {
   vector<ola::network::UDPSocket*> sockets;
   vector<ola::network::UDPSocket*>::iterator iter;
 
-  m_node = new SandNetNode(m_preferences->GetValue(IP_KEY));
+  m_node = new SandNetNode(m_preferences->GetValue(IP_KEY),
+                           m_plugin_adaptor->GetExportMap());
   m_node->SetName(m_preferences->GetValue(NAME_KEY));
 
   // setup the output ports (ie INTO sandnet)
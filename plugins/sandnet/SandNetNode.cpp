@@ -21,7 +21,6 @@
 #include <string.h>
 #include <algorithm>
 #include <string>
-#include <map>
 #include <vector>
 #include "ola/Logging.h"
 #include "ola/network/IPV4Address.h"
@@ -35,7 +34,6 @@ namespace plugin {
 namespace sandnet {
 
 using std::string;
-using std::map;
 using std::vector;
 using ola::network::HostToNetwork;
 using ola::network::IPV4Address;
@@ -55,9 +53,12 @@ const char SandNetNode::DEFAULT_NODE_NAME[] = "ola-SandNet";
  * Create a new node
  * @param ip_address the IP address to prefer to listen on, if NULL we choose
  * one.
+ * @param export_map the ExportMap to add the receive counters to, may be NULL.
  */
-SandNetNode::SandNetNode(const string &ip_address)
-    : m_running(false),
+SandNetNode::SandNetNode(const string &ip_address,
+                         ola::ExportMap *export_map)
+    : UDPNode("sandnet", sizeof(sandnet_packet), export_map),
+      m_running(false),
       m_node_name(DEFAULT_NODE_NAME),
       m_preferred_ip(ip_address) {
   for (unsigned int i = 0; i < SANDNET_MAX_PORTS; i++) {
@@ -72,12 +73,6 @@ SandNetNode::SandNetNode(const string &ip_address)
  */
 SandNetNode::~SandNetNode() {
   Stop();
-
-  universe_handlers::iterator iter;
-  for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
-    delete iter->second.closure;
-  }
-  m_handlers.clear();
 }
 
 
@@ -148,36 +143,37 @@ vector<UDPSocket*> SandNetNode::GetSockets() {
  * Called when there is data on this socket
  */
 void SandNetNode::SocketReady(UDPSocket *socket) {
-  sandnet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  IPV4SocketAddress source;
+  ReceivePackets(socket);
+}
 
-  if (!socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                        &packet_size, &source))
-    return;
 
+/*
+ * Handle a datagram from the receive batch.
+ */
+bool SandNetNode::HandlePacket(const uint8_t *data, unsigned int length,
+                               const IPV4SocketAddress &source) {
   // skip packets sent by us
   if (source.Host() == m_interface.ip_address)
-    return;
+    return false;
 
-  if (packet_size < static_cast<ssize_t>(sizeof(packet.opcode))) {
+  const sandnet_packet *packet = reinterpret_cast<const sandnet_packet*>(data);
+  if (length < sizeof(packet->opcode)) {
     OLA_WARN << "Small sandnet packet received, discarding";
-    return;
+    return false;
   }
 
-  switch (NetworkToHost(packet.opcode)) {
+  switch (NetworkToHost(packet->opcode)) {
     case SANDNET_DMX:
-      HandleDMX(packet.contents.dmx, packet_size - sizeof(packet.opcode));
-      break;
+      return HandleDMX(packet->contents.dmx, length - sizeof(packet->opcode));
     case SANDNET_COMPRESSED_DMX:
-      HandleCompressedDMX(packet.contents.compressed_dmx,
-                          packet_size - sizeof(packet.opcode));
-      break;
+      return HandleCompressedDMX(packet->contents.compressed_dmx,
+                                 length - sizeof(packet->opcode));
     case SANDNET_ADVERTISEMENT:
-      break;
+      return true;
     default:
       OLA_INFO << "Skipping sandnet packet with unknown code: 0x" <<
-        std::hex << NetworkToHost(packet.opcode);
+        std::hex << NetworkToHost(packet->opcode);
+      return false;
   }
 }
 
@@ -191,23 +187,7 @@ void SandNetNode::SocketReady(UDPSocket *socket) {
 bool SandNetNode::SetHandler(uint8_t group, uint8_t universe,
                              DmxBuffer *buffer,
                              Callback0<void> *closure) {
-  if (!closure)
-    return false;
-
-  group_universe_pair key(group, universe);
-  universe_handlers::iterator iter = m_handlers.find(key);
-
-  if (iter == m_handlers.end()) {
-    universe_handler handler;
-    handler.buffer = buffer;
-    handler.closure = closure;
-    m_handlers[key] = handler;
-  } else {
-    Callback0<void> *old_closure = iter->second.closure;
-    iter->second.closure = closure;
-    delete old_closure;
-  }
-  return true;
+  return SetUniverseHandler(UniverseKey(group, universe), buffer, closure);
 }
 
 
@@ -217,16 +197,7 @@ bool SandNetNode::SetHandler(uint8_t group, uint8_t universe,
  * @param true if removed, false if it didn't exist
  */
 bool SandNetNode::RemoveHandler(uint8_t group, uint8_t universe) {
-  group_universe_pair key(group, universe);
-  universe_handlers::iterator iter = m_handlers.find(key);
-
-  if (iter != m_handlers.end()) {
-    Callback0<void> *old_closure = iter->second.closure;
-    m_handlers.erase(iter);
-    delete old_closure;
-    return true;
-  }
-  return false;
+  return RemoveUniverseHandler(UniverseKey(group, universe));
 }
 
 
@@ -380,20 +351,19 @@ bool SandNetNode::HandleCompressedDMX(const sandnet_compressed_dmx &dmx_packet,
     return false;
   }
 
-  group_universe_pair key(dmx_packet.group, dmx_packet.universe);
-  universe_handlers::iterator iter = m_handlers.find(key);
-
-  if (iter == m_handlers.end())
+  UniverseHandler *handler = LookupUniverse(
+      UniverseKey(dmx_packet.group, dmx_packet.universe));
+  if (!handler)
     return false;
 
   unsigned int data_size = size - header_size;
-  bool r = m_encoder.Decode(0, dmx_packet.dmx, data_size, iter->second.buffer);
+  bool r = m_encoder.Decode(0, dmx_packet.dmx, data_size, handler->buffer);
   if (!r) {
     OLA_WARN << "Failed to decode Sandnet Data";
     return false;
   }
 
-  iter->second.closure->Run();
+  DmxReceived(handler);
   return true;
 }
 
@@ -410,15 +380,14 @@ bool SandNetNode::HandleDMX(const sandnet_dmx &dmx_packet,
     return false;
   }
 
-  group_universe_pair key(dmx_packet.group, dmx_packet.universe);
-  universe_handlers::iterator iter = m_handlers.find(key);
-
-  if (iter == m_handlers.end())
+  UniverseHandler *handler = LookupUniverse(
+      UniverseKey(dmx_packet.group, dmx_packet.universe));
+  if (!handler)
     return false;
 
   unsigned int data_size = size - header_size;
-  iter->second.buffer->Set(dmx_packet.dmx, data_size);
-  iter->second.closure->Run();
+  handler->buffer->Set(dmx_packet.dmx, data_size);
+  DmxReceived(handler);
   return true;
 }
 
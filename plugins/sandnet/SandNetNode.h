@@ -21,12 +21,12 @@
 #ifndef PLUGINS_SANDNET_SANDNETNODE_H_
 #define PLUGINS_SANDNET_SANDNETNODE_H_
 
-#include <map>
 #include <string>
 #include <vector>
-#include <utility>
+#include "common/network/UDPNode.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/InterfacePicker.h"
 #include "ola/network/Socket.h"
@@ -38,7 +38,7 @@ namespace plugin {
 namespace sandnet {
 
 
-class SandNetNode {
+class SandNetNode: public ola::network::UDPNode {
  public:
     typedef enum {
       SANDNET_PORT_MODE_DISABLED,
@@ -48,7 +48,8 @@ class SandNetNode {
       SANDNET_PORT_MODE_MIN
     } sandnet_port_type;
 
-    explicit SandNetNode(const std::string &preferred_ip);
+    explicit SandNetNode(const std::string &preferred_ip,
+                         ola::ExportMap *export_map = NULL);
     ~SandNetNode();
 
     const ola::network::Interface &GetInterface() const {
@@ -74,6 +75,10 @@ class SandNetNode {
     bool SendAdvertisement();
     bool SendDMX(uint8_t port_id, const DmxBuffer &buffer);
 
+ protected:
+    bool HandlePacket(const uint8_t *data, unsigned int length,
+                      const ola::network::IPV4SocketAddress &source);
+
  private:
     typedef struct {
       uint8_t group;
@@ -81,14 +86,6 @@ class SandNetNode {
       sandnet_port_type type;
     } sandnet_port;
 
-    typedef struct {
-      DmxBuffer *buffer;
-      Callback0<void> *closure;
-    } universe_handler;
-
-    typedef std::pair<uint8_t, uint8_t> group_universe_pair;
-    typedef std::map<group_universe_pair, universe_handler> universe_handlers;
-
     bool InitNetwork();
 
     bool HandleCompressedDMX(const sandnet_compressed_dmx &dmx_packet,
@@ -106,7 +103,6 @@ class SandNetNode {
     std::string m_preferred_ip;
 
     sandnet_port m_ports[SANDNET_MAX_PORTS];
-    universe_handlers m_handlers;
     ola::network::Interface m_interface;
     ola::network::UDPSocket m_control_socket;
     ola::network::UDPSocket m_data_socket;
@@ -120,6 +116,10 @@ class SandNetNode {
     static const char DATA_ADDRESS[];
     static const char DEFAULT_NODE_NAME[];
     static const uint32_t FIRMWARE_VERSION = 0x00050501;
+
+    static unsigned int UniverseKey(uint8_t group, uint8_t universe) {
+      return (group << 8) + universe;
+    }
 };
 }  // namespace sandnet
 }  // namespace plugin
@@ -41,6 +41,9 @@ class SandNetPlugin: public ola::Plugin {
     ola_plugin_id Id() const { return OLA_PLUGIN_SANDNET; }
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     class SandNetDevice *m_device;  // only have one device
 
@@ -49,8 +52,6 @@ class SandNetPlugin: public ola::Plugin {
     bool SetDefaultPreferences();
 
     static const char SANDNET_NODE_NAME[];
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
 };
 }  // namespace sandnet
 }  // namespace plugin
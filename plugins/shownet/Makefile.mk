@@ -34,6 +34,18 @@ plugins_shownet_ShowNetTester_SOURCES = \
 plugins_shownet_ShowNetTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 plugins_shownet_ShowNetTester_LDADD = $(COMMON_TESTING_LIBS) \
                                       common/libolacommon.la
+
+# BENCHMARKS
+##################################################
+if BUILD_TESTS
+bench_programs += plugins/shownet/ShowNetNodeBenchmark
+
+plugins_shownet_ShowNetNodeBenchmark_SOURCES = \
+    plugins/shownet/ShowNetNode.cpp \
+    plugins/shownet/ShowNetNodeBenchmark.cpp
+plugins_shownet_ShowNetNodeBenchmark_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+plugins_shownet_ShowNetNodeBenchmark_LDADD = $(COMMON_SOCKET_BENCHMARK_LIBS)
+endif
 endif
 
 EXTRA_DIST += plugins/shownet/README.md
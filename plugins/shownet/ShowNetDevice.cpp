@@ -26,6 +26,7 @@
 #include "olad/Plugin.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/UDPReceivePreferences.h"
 #include "plugins/shownet/ShowNetDevice.h"
 #include "plugins/shownet/ShowNetNode.h"
 #include "plugins/shownet/ShowNetPort.h"
@@ -56,8 +57,13 @@ ShowNetDevice::ShowNetDevice(ola::Plugin *owner,
  * Start this device
  */
 bool ShowNetDevice::StartHook() {
-  m_node = new ShowNetNode(m_preferences->GetValue(IP_KEY));
+  m_node = new ShowNetNode(m_preferences->GetValue(IP_KEY),
+                           m_plugin_adaptor->GetExportMap());
   m_node->SetName(m_preferences->GetValue("name"));
+  ola::network::UDPReceiveOptions receive_options;
+  ReadUDPReceivePreferences(*m_preferences, m_plugin_adaptor->GetExportMap(),
+                            "shownet", &receive_options);
+  m_node->SetReceiveOptions(receive_options);
 
   if (!m_node->Start()) {
     delete m_node;
@@ -20,15 +20,14 @@
 
 #include <string.h>
 #include <algorithm>
-#include <map>
 #include <string>
 
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/NetworkUtils.h"
-#include "ola/stl/STLUtils.h"
 #include "ola/strings/Utils.h"
+#include "ola/util/Trace.h"
 #include "plugins/shownet/ShowNetNode.h"
 
 
@@ -37,7 +36,6 @@ namespace plugin {
 namespace shownet {
 
 using std::string;
-using std::map;
 using ola::network::HostToLittleEndian;
 using ola::network::HostToNetwork;
 using ola::network::IPV4Address;
@@ -52,13 +50,18 @@ using ola::Callback0;
  * Create a new node
  * @param ip_address the IP address to prefer to listen on, if NULL we choose
  * one.
+ * @param export_map the ExportMap to add the receive counters to, may be NULL.
+ * @param socket a UDPSocket or NULL. Ownership is transferred.
  */
-ShowNetNode::ShowNetNode(const std::string &ip_address)
-    : m_running(false),
+ShowNetNode::ShowNetNode(const std::string &ip_address,
+                         ola::ExportMap *export_map,
+                         ola::network::UDPSocketInterface *socket)
+    : UDPNode("shownet", sizeof(shownet_packet), export_map),
+      m_running(false),
       m_packet_count(0),
       m_node_name(),
       m_preferred_ip(ip_address),
-      m_socket(NULL) {
+      m_socket(socket) {
 }
 
 
@@ -67,12 +70,6 @@ ShowNetNode::ShowNetNode(const std::string &ip_address)
  */
 ShowNetNode::~ShowNetNode() {
   Stop();
-
-  std::map<unsigned int, universe_handler>::iterator iter;
-  for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
-    delete iter->second.closure;
-  }
-  m_handlers.clear();
 }
 
 
@@ -107,11 +104,7 @@ bool ShowNetNode::Stop() {
   if (!m_running)
     return false;
 
-  if (m_socket) {
-    delete m_socket;
-    m_socket = NULL;
-  }
-
+  m_socket.reset();
   m_running = false;
   return true;
 }
@@ -134,6 +127,7 @@ void ShowNetNode::SetName(const string &name) {
  */
 bool ShowNetNode::SendDMX(unsigned int universe,
                           const ola::DmxBuffer &buffer) {
+  OLA_TRACE_SCOPE("shownet", "ShowNetNode::SendDMX");
   if (!m_running)
     return false;
 
@@ -169,23 +163,7 @@ bool ShowNetNode::SendDMX(unsigned int universe,
 bool ShowNetNode::SetHandler(unsigned int universe,
                              DmxBuffer *buffer,
                              Callback0<void> *closure) {
-  if (!closure)
-    return false;
-
-  map<unsigned int, universe_handler>::iterator iter =
-    m_handlers.find(universe);
-
-  if (iter == m_handlers.end()) {
-    universe_handler handler;
-    handler.buffer = buffer;
-    handler.closure = closure;
-    m_handlers[universe] = handler;
-  } else {
-    Callback0<void> *old_closure = iter->second.closure;
-    iter->second.closure = closure;
-    delete old_closure;
-  }
-  return true;
+  return SetUniverseHandler(universe, buffer, closure);
 }
 
 
@@ -195,16 +173,7 @@ bool ShowNetNode::SetHandler(unsigned int universe,
  * @param true if removed, false if it didn't exist
  */
 bool ShowNetNode::RemoveHandler(unsigned int universe) {
-  map<unsigned int, universe_handler>::iterator iter =
-    m_handlers.find(universe);
-
-  if (iter != m_handlers.end()) {
-    Callback0<void> *old_closure = iter->second.closure;
-    m_handlers.erase(iter);
-    delete old_closure;
-    return true;
-  }
-  return false;
+  return RemoveUniverseHandler(universe);
 }
 
 
@@ -212,17 +181,19 @@ bool ShowNetNode::RemoveHandler(unsigned int universe) {
  * Called when there is data on this socket
  */
 void ShowNetNode::SocketReady() {
-  shownet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  ola::network::IPV4SocketAddress source;
+  ReceivePackets(m_socket.get());
+}
 
-  if (!m_socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                          &packet_size, &source))
-    return;
 
+/*
+ * Handle a datagram from the receive batch.
+ */
+bool ShowNetNode::HandlePacket(const uint8_t *data, unsigned int length,
+                               const IPV4SocketAddress &source) {
   // skip packets sent by us
-  if (source.Host() != m_interface.ip_address)
-    HandlePacket(&packet, packet_size);
+  if (source.Host() == m_interface.ip_address)
+    return false;
+  return HandlePacket(reinterpret_cast<const shownet_packet*>(data), length);
 }
 
 
@@ -288,7 +259,7 @@ bool ShowNetNode::HandleCompressedPacket(const shownet_compressed_dmx *packet,
   unsigned int start_channel = (net_slot - 1) % DMX_UNIVERSE_SIZE;
   unsigned int universe_id = (net_slot - 1) / DMX_UNIVERSE_SIZE;
 
-  universe_handler *handler = STLFind(&m_handlers, universe_id);
+  UniverseHandler *handler = LookupUniverse(universe_id);
   if (!handler) {
     OLA_DEBUG << "Not interested in universe " << universe_id
               << ", skipping ";
@@ -303,7 +274,7 @@ bool ShowNetNode::HandleCompressedPacket(const shownet_compressed_dmx *packet,
                               packet->data + data_offset,
                               enc_len);
   }
-  handler->closure->Run();
+  DmxReceived(handler);
   return true;
 }
 
@@ -347,27 +318,29 @@ unsigned int ShowNetNode::BuildCompressedPacket(shownet_packet *packet,
  * Setup the networking compoents.
  */
 bool ShowNetNode::InitNetwork() {
-  m_socket = new UDPSocket();
+  std::auto_ptr<ola::network::UDPSocketInterface> socket(m_socket.release());
+
+  if (!socket.get())
+    socket.reset(new UDPSocket());
 
-  if (!m_socket->Init()) {
+  if (!socket->Init()) {
     OLA_WARN << "Socket init failed";
-    delete m_socket;
     return false;
   }
 
-  if (!m_socket->Bind(IPV4SocketAddress(IPV4Address::WildCard(),
-                                        SHOWNET_PORT))) {
-    delete m_socket;
+  if (!socket->Bind(IPV4SocketAddress(IPV4Address::WildCard(),
+                                      SHOWNET_PORT))) {
     return false;
   }
 
-  if (!m_socket->EnableBroadcast()) {
+  if (!socket->EnableBroadcast()) {
     OLA_WARN << "Failed to enable broadcasting";
-    delete m_socket;
     return false;
   }
 
-  m_socket->SetOnData(NewCallback(this, &ShowNetNode::SocketReady));
+  socket->EnableReceiveStats(m_receive_options);
+  socket->SetOnData(NewCallback(this, &ShowNetNode::SocketReady));
+  m_socket.reset(socket.release());
   return true;
 }
 }  // namespace shownet
@@ -21,10 +21,12 @@
 #ifndef PLUGINS_SHOWNET_SHOWNETNODE_H_
 #define PLUGINS_SHOWNET_SHOWNETNODE_H_
 
+#include <memory>
 #include <string>
-#include <map>
+#include "common/network/UDPNode.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/base/Macro.h"
 #include "ola/dmx/RunLengthEncoder.h"
 #include "ola/network/InterfacePicker.h"
@@ -35,14 +37,20 @@ namespace ola {
 namespace plugin {
 namespace shownet {
 
-class ShowNetNode {
+class ShowNetNode: public ola::network::UDPNode {
  public:
-    explicit ShowNetNode(const std::string &ip_address);
+    explicit ShowNetNode(const std::string &ip_address,
+                         ola::ExportMap *export_map = NULL,
+                         ola::network::UDPSocketInterface *socket = NULL);
     virtual ~ShowNetNode();
 
     bool Start();
     bool Stop();
     void SetName(const std::string &name);
+    // This must be called before Start().
+    void SetReceiveOptions(const ola::network::UDPReceiveOptions &options) {
+      m_receive_options = options;
+    }
 
     bool SendDMX(unsigned int universe, const ola::DmxBuffer &buffer);
     bool SetHandler(unsigned int universe,
@@ -54,27 +62,26 @@ class ShowNetNode {
       return m_interface;
     }
 
-    ola::network::UDPSocket* GetSocket() { return m_socket; }
+    ola::network::UDPSocketInterface* GetSocket() { return m_socket.get(); }
     void SocketReady();
 
     static const uint16_t SHOWNET_MAX_UNIVERSES = 8;
 
     friend class ShowNetNodeTest;
 
- private:
-    typedef struct {
-      DmxBuffer *buffer;
-      Callback0<void> *closure;
-    } universe_handler;
+ protected:
+    bool HandlePacket(const uint8_t *data, unsigned int length,
+                      const ola::network::IPV4SocketAddress &source);
 
+ private:
     bool m_running;
     uint16_t m_packet_count;
     std::string m_node_name;
     std::string m_preferred_ip;
-    std::map<unsigned int, universe_handler> m_handlers;
     ola::network::Interface m_interface;
     ola::dmx::RunLengthEncoder m_encoder;
-    ola::network::UDPSocket *m_socket;
+    ola::network::UDPReceiveOptions m_receive_options;
+    std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
 
     bool HandlePacket(const shownet_packet *packet, unsigned int size);
     bool HandleCompressedPacket(const shownet_compressed_dmx *packet,
@@ -0,0 +1,186 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowNetNodeBenchmark.cpp
+ * Measures the receive path of the ShowNetNode.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/base/Array.h"
+#include "ola/dmx/RunLengthEncoder.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/testing/Benchmark.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "ola/testing/UDPCapture.h"
+#include "plugins/shownet/ShowNetNode.h"
+#include "plugins/shownet/ShowNetPackets.h"
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::network::HostToLittleEndian;
+using ola::network::HostToNetwork;
+using ola::network::IPV4Address;
+using ola::plugin::shownet::ShowNetNode;
+using ola::plugin::shownet::shownet_compressed_dmx;
+using ola::plugin::shownet::shownet_packet;
+using ola::testing::Benchmark;
+using ola::testing::MockUDPSocket;
+using std::string;
+using std::vector;
+
+namespace {
+
+const uint16_t SHOWNET_PORT = 2501;
+// See ShowNetNode::MAGIC_INDEX_OFFSET
+const uint16_t MAGIC_INDEX_OFFSET = 11;
+
+/*
+ * Build a compressed DMX packet for a universe.
+ */
+string BuildCompressedPacket(unsigned int universe) {
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    data[i] = static_cast<uint8_t>(i * 7 + universe);
+  }
+  DmxBuffer buffer(data, sizeof(data));
+
+  shownet_packet packet;
+  memset(&packet, 0, sizeof(packet));
+  packet.type = HostToNetwork(
+      static_cast<uint16_t>(ola::plugin::shownet::COMPRESSED_DMX_PACKET));
+
+  shownet_compressed_dmx *compressed_dmx = &packet.data.compressed_dmx;
+  compressed_dmx->netSlot[0] = HostToLittleEndian(
+      static_cast<uint16_t>(universe * ola::DMX_UNIVERSE_SIZE + 1));
+  compressed_dmx->slotSize[0] = HostToLittleEndian(
+      static_cast<uint16_t>(buffer.Size()));
+
+  unsigned int enc_len = sizeof(compressed_dmx->data);
+  ola::dmx::RunLengthEncoder encoder;
+  encoder.Encode(buffer, compressed_dmx->data, &enc_len);
+  compressed_dmx->indexBlock[0] = HostToLittleEndian(MAGIC_INDEX_OFFSET);
+  compressed_dmx->indexBlock[1] = HostToLittleEndian(
+      static_cast<uint16_t>(MAGIC_INDEX_OFFSET + enc_len));
+
+  unsigned int size = (sizeof(packet) - sizeof(packet.data)) +
+      (sizeof(*compressed_dmx) -
+       ola::plugin::shownet::SHOWNET_COMPRESSED_DATA_LENGTH + enc_len);
+  return string(reinterpret_cast<char*>(&packet), size);
+}
+
+
+class ShowNetNodeBenchmark {
+ public:
+  ShowNetNodeBenchmark()
+      : m_socket(NULL),
+        m_frames(0) {
+    ola::network::IPV4Address::FromString("10.0.0.10", &m_peer);
+  }
+
+  /*
+   * Create a node which listens on all universes and replays the packets to
+   * it.
+   */
+  bool Setup(const vector<string> &packets) {
+    m_node.reset();
+    m_packets = packets;
+    if (m_packets.empty()) {
+      return false;
+    }
+
+    m_socket = new MockUDPSocket();
+    m_node.reset(new ShowNetNode("", NULL, m_socket));
+    for (unsigned int i = 0; i < ShowNetNode::SHOWNET_MAX_UNIVERSES; i++) {
+      m_node->SetHandler(i, &m_buffers[i],
+                         NewCallback(this, &ShowNetNodeBenchmark::NewFrame));
+    }
+    // Starting the node requires a network interface, so the socket is
+    // connected to the node directly.
+    m_socket->SetOnData(
+        NewCallback(m_node.get(), &ShowNetNode::SocketReady));
+    return true;
+  }
+
+  void Receive(unsigned int iterations) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      const string &packet = m_packets[i % m_packets.size()];
+      m_socket->InjectData(reinterpret_cast<const uint8_t*>(packet.data()),
+                           packet.size(), m_peer, SHOWNET_PORT);
+    }
+  }
+
+ private:
+  MockUDPSocket *m_socket;
+  std::auto_ptr<ShowNetNode> m_node;
+  DmxBuffer m_buffers[ShowNetNode::SHOWNET_MAX_UNIVERSES];
+  vector<string> m_packets;
+  IPV4Address m_peer;
+  unsigned int m_frames;
+
+  void NewFrame() { m_frames++; }
+};
+}  // namespace
+
+
+/*
+ * With no arguments the benchmark uses generated compressed DMX packets,
+ * otherwise the ShowNet datagrams in the pcap file are replayed.
+ */
+int main(int argc, char *argv[]) {
+  ola::InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_STDERR);
+
+  ShowNetNodeBenchmark fixture;
+  Benchmark benchmark("ShowNetNode", &std::cout);
+
+  if (argc > 1) {
+    vector<string> packets;
+    if (!ola::testing::LoadUDPCapture(argv[1], SHOWNET_PORT, &packets)) {
+      return 1;
+    }
+    if (!fixture.Setup(packets)) {
+      OLA_WARN << "No ShowNet packets in " << argv[1];
+      return 1;
+    }
+    benchmark.Run("Replay", packets.size(),
+                  NewCallback(&fixture, &ShowNetNodeBenchmark::Receive));
+    return 0;
+  }
+
+  const unsigned int universe_counts[] = {
+    1, ShowNetNode::SHOWNET_MAX_UNIVERSES};
+  for (unsigned int i = 0; i < arraysize(universe_counts); i++) {
+    vector<string> packets;
+    for (unsigned int universe = 0; universe < universe_counts[i];
+         universe++) {
+      packets.push_back(BuildCompressedPacket(universe));
+    }
+    fixture.Setup(packets);
+    benchmark.Run("CompressedDmx", universe_counts[i],
+                  NewCallback(&fixture, &ShowNetNodeBenchmark::Receive));
+  }
+  return 0;
+}
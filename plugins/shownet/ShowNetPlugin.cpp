@@ -21,6 +21,7 @@
 #include <string>
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/UDPReceivePreferences.h"
 #include "plugins/shownet/ShowNetDevice.h"
 #include "plugins/shownet/ShowNetPlugin.h"
 #include "plugins/shownet/ShowNetPluginDescription.h"
@@ -91,6 +92,7 @@ bool ShowNetPlugin::SetDefaultPreferences() {
                                          StringValidator(true), "");
   save |= m_preferences->SetDefaultValue(SHOWNET_NAME_KEY, StringValidator(),
                                          SHOWNET_NODE_NAME);
+  save |= SetDefaultUDPReceivePreferences(m_preferences);
 
   if (save) {
     m_preferences->Save();
@@ -43,6 +43,9 @@ class ShowNetPlugin: public Plugin {
     std::string Description() const;
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     bool StartHook();
     bool StopHook();
@@ -50,8 +53,6 @@ class ShowNetPlugin: public Plugin {
 
     ShowNetDevice *m_device;
     static const char SHOWNET_NODE_NAME[];
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
     static const char SHOWNET_NAME_KEY[];
 };
 }  // namespace shownet
@@ -4,6 +4,8 @@ if USE_SPI
 # This is a library which isn't coupled to olad
 lib_LTLIBRARIES += plugins/spi/libolaspicore.la plugins/spi/libolaspi.la
 plugins_spi_libolaspicore_la_SOURCES = \
+    plugins/spi/PixelFormat.cpp \
+    plugins/spi/PixelFormat.h \
     plugins/spi/SPIBackend.cpp \
     plugins/spi/SPIBackend.h \
     plugins/spi/SPIOutput.cpp \
@@ -36,6 +38,7 @@ plugins_spi_libolaspi_la_LIBADD = \
 test_programs += plugins/spi/SPITester
 
 plugins_spi_SPITester_SOURCES = \
+    plugins/spi/PixelFormatTest.cpp \
     plugins/spi/SPIBackendTest.cpp \
     plugins/spi/SPIOutputTest.cpp \
     plugins/spi/FakeSPIWriter.cpp \
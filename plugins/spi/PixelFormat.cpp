@@ -0,0 +1,223 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelFormat.cpp
+ * Converts RGB DMX data to the formats used by the pixel chips.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * The NEON kernels de-interleave 16 RGB pixels with a single vld3q_u8, build
+ * the output channels without any per-pixel branches and then interleave
+ * them again with vst3q_u8 or vst4q_u8. They're selected at compile time,
+ * since NEON is available on all the Raspberry Pi builds that enable it.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+#include "plugins/spi/PixelFormat.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_PIXEL_KERNEL_NEON 1
+#include <arm_neon.h>
+#endif  // __ARM_NEON
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+namespace {
+
+const unsigned int RGB_SIZE = 3;
+
+inline uint8_t LPD8806Value(uint8_t value) {
+  return 0x80 | (value >> 1);
+}
+
+/*
+ * The P9813 flag byte is two 1 bits, followed by the inverse of the top two
+ * bits of blue, green and red. For more information please visit:
+ * https://github.com/CoolNeon/elinux-tcl/blob/master/README.txt
+ */
+inline uint8_t P9813Flag(uint8_t red, uint8_t green, uint8_t blue) {
+  return ~(((red & 0xc0) >> 6) | ((green & 0xc0) >> 4) | ((blue & 0xc0) >> 2));
+}
+
+void ScalarWS2801(uint8_t *dest, const uint8_t *rgb, unsigned int pixels) {
+  memcpy(dest, rgb, pixels * RGB_SIZE);
+}
+
+void ScalarLPD8806(uint8_t *dest, const uint8_t *rgb, unsigned int pixels) {
+  for (unsigned int i = 0; i < pixels; i++, dest += 3, rgb += RGB_SIZE) {
+    dest[0] = LPD8806Value(rgb[1]);
+    dest[1] = LPD8806Value(rgb[0]);
+    dest[2] = LPD8806Value(rgb[2]);
+  }
+}
+
+void ScalarP9813(uint8_t *dest, const uint8_t *rgb, unsigned int pixels) {
+  for (unsigned int i = 0; i < pixels; i++, dest += 4, rgb += RGB_SIZE) {
+    dest[0] = P9813Flag(rgb[0], rgb[1], rgb[2]);
+    dest[1] = rgb[2];
+    dest[2] = rgb[1];
+    dest[3] = rgb[0];
+  }
+}
+
+void ScalarAPA102(uint8_t *dest, const uint8_t *rgb, unsigned int pixels) {
+  for (unsigned int i = 0; i < pixels; i++, dest += 4, rgb += RGB_SIZE) {
+    // The brightness is fixed at 31, which reduces flickering
+    dest[0] = 0xff;
+    dest[1] = rgb[2];
+    dest[2] = rgb[1];
+    dest[3] = rgb[0];
+  }
+}
+
+// Indexed by PixelFormat
+const PixelKernel SCALAR_KERNELS[] = {
+  ScalarWS2801,
+  ScalarLPD8806,
+  ScalarP9813,
+  ScalarAPA102,
+};
+
+#ifdef OLA_PIXEL_KERNEL_NEON
+const unsigned int NEON_WIDTH = 16;
+
+void NEONLPD8806(uint8_t *dest, const uint8_t *rgb, unsigned int pixels) {
+  const uint8x16_t high_bit = vdupq_n_u8(0x80);
+  unsigned int i = 0;
+  for (; i + NEON_WIDTH <= pixels; i += NEON_WIDTH) {
+    uint8x16x3_t in = vld3q_u8(rgb + i * RGB_SIZE);
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(vshrq_n_u8(in.val[1], 1), high_bit);
+    out.val[1] = vorrq_u8(vshrq_n_u8(in.val[0], 1), high_bit);
+    out.val[2] = vorrq_u8(vshrq_n_u8(in.val[2], 1), high_bit);
+    vst3q_u8(dest + i * 3, out);
+  }
+  ScalarLPD8806(dest + i * 3, rgb + i * RGB_SIZE, pixels - i);
+}
+
+void NEONP9813(uint8_t *dest, const uint8_t *rgb, unsigned int pixels) {
+  const uint8x16_t top_bits = vdupq_n_u8(0xc0);
+  unsigned int i = 0;
+  for (; i + NEON_WIDTH <= pixels; i += NEON_WIDTH) {
+    uint8x16x3_t in = vld3q_u8(rgb + i * RGB_SIZE);
+    uint8x16_t flag = vshrq_n_u8(in.val[0], 6);
+    flag = vorrq_u8(flag, vshrq_n_u8(vandq_u8(in.val[1], top_bits), 4));
+    flag = vorrq_u8(flag, vshrq_n_u8(vandq_u8(in.val[2], top_bits), 2));
+    uint8x16x4_t out;
+    out.val[0] = vmvnq_u8(flag);
+    out.val[1] = in.val[2];
+    out.val[2] = in.val[1];
+    out.val[3] = in.val[0];
+    vst4q_u8(dest + i * 4, out);
+  }
+  ScalarP9813(dest + i * 4, rgb + i * RGB_SIZE, pixels - i);
+}
+
+void NEONAPA102(uint8_t *dest, const uint8_t *rgb, unsigned int pixels) {
+  unsigned int i = 0;
+  for (; i + NEON_WIDTH <= pixels; i += NEON_WIDTH) {
+    uint8x16x3_t in = vld3q_u8(rgb + i * RGB_SIZE);
+    uint8x16x4_t out;
+    out.val[0] = vdupq_n_u8(0xff);
+    out.val[1] = in.val[2];
+    out.val[2] = in.val[1];
+    out.val[3] = in.val[0];
+    vst4q_u8(dest + i * 4, out);
+  }
+  ScalarAPA102(dest + i * 4, rgb + i * RGB_SIZE, pixels - i);
+}
+
+// The WS2801 format is a straight copy, which memcpy already vectorizes.
+const PixelKernel NEON_KERNELS[] = {
+  ScalarWS2801,
+  NEONLPD8806,
+  NEONP9813,
+  NEONAPA102,
+};
+#endif  // OLA_PIXEL_KERNEL_NEON
+}  // namespace
+
+
+unsigned int PixelFormatSize(PixelFormat format) {
+  switch (format) {
+    case PIXEL_FORMAT_P9813:
+    case PIXEL_FORMAT_APA102:
+      return 4;
+    case PIXEL_FORMAT_WS2801:
+    case PIXEL_FORMAT_LPD8806:
+      return 3;
+  }
+  return 3;
+}
+
+
+void ConvertPixels(PixelFormat format, uint8_t *dest, const uint8_t *rgb,
+                   unsigned int pixels) {
+#ifdef OLA_PIXEL_KERNEL_NEON
+  NEON_KERNELS[format](dest, rgb, pixels);
+#else
+  SCALAR_KERNELS[format](dest, rgb, pixels);
+#endif  // OLA_PIXEL_KERNEL_NEON
+}
+
+
+PixelKernelImplementation DefaultPixelKernelImplementation() {
+#ifdef OLA_PIXEL_KERNEL_NEON
+  return PIXEL_KERNEL_NEON;
+#else
+  return PIXEL_KERNEL_SCALAR;
+#endif  // OLA_PIXEL_KERNEL_NEON
+}
+
+
+PixelKernel GetPixelKernel(PixelFormat format,
+                           PixelKernelImplementation implementation) {
+  switch (implementation) {
+    case PIXEL_KERNEL_SCALAR:
+      return SCALAR_KERNELS[format];
+    case PIXEL_KERNEL_NEON:
+#ifdef OLA_PIXEL_KERNEL_NEON
+      return NEON_KERNELS[format];
+#else
+      return NULL;
+#endif  // OLA_PIXEL_KERNEL_NEON
+  }
+  return NULL;
+}
+
+
+void FillPixels(uint8_t *dest, const uint8_t *pixel, unsigned int pixel_size,
+                unsigned int count) {
+  if (!count) {
+    return;
+  }
+  // Double the filled region each time, so this is a handful of memcpys.
+  const unsigned int length = pixel_size * count;
+  memcpy(dest, pixel, pixel_size);
+  unsigned int filled = pixel_size;
+  while (filled < length) {
+    const unsigned int chunk = std::min(filled, length - filled);
+    memcpy(dest + filled, dest, chunk);
+    filled += chunk;
+  }
+}
+
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,106 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelFormat.h
+ * Converts RGB DMX data to the formats used by the pixel chips.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_SPI_PIXELFORMAT_H_
+#define PLUGINS_SPI_PIXELFORMAT_H_
+
+#include <stdint.h>
+
+#include "ola/dmx/PixelMap.h"
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+/**
+ * @brief The formats pixels are sent in.
+ */
+typedef enum {
+  PIXEL_FORMAT_WS2801,  /**< RGB, 3 bytes per pixel */
+  PIXEL_FORMAT_LPD8806,  /**< GRB, 7 bits per color with the high bit set */
+  PIXEL_FORMAT_P9813,  /**< A flag & checksum byte, then BGR */
+  PIXEL_FORMAT_APA102  /**< A brightness byte, then BGR */
+} PixelFormat;
+
+/**
+ * @brief The implementations of the pixel kernels.
+ */
+typedef enum {
+  PIXEL_KERNEL_SCALAR,  /**< Plain C++ */
+  PIXEL_KERNEL_NEON  /**< ARM NEON, 16 pixels at a time */
+} PixelKernelImplementation;
+
+/**
+ * @brief A kernel which converts RGB pixels to a pixel format.
+ * @param dest the output, this must have room for
+ *   PixelFormatSize(format) * pixels bytes.
+ * @param rgb the RGB data, 3 bytes per pixel.
+ * @param pixels the number of pixels to convert.
+ */
+typedef void (*PixelKernel)(uint8_t *dest, const uint8_t *rgb,
+                            unsigned int pixels);
+
+/**
+ * @brief Return the number of bytes each pixel uses on the SPI bus.
+ */
+unsigned int PixelFormatSize(PixelFormat format);
+
+/**
+ * @brief Convert RGB pixels to a pixel format, using the fastest kernel for
+ * this CPU.
+ * @param format the format to convert to.
+ * @param dest the output, this must have room for
+ *   PixelFormatSize(format) * pixels bytes.
+ * @param rgb the RGB data, 3 bytes per pixel.
+ * @param pixels the number of pixels to convert.
+ */
+void ConvertPixels(PixelFormat format, uint8_t *dest, const uint8_t *rgb,
+                   unsigned int pixels);
+
+/**
+ * @brief Return the implementation used by ConvertPixels().
+ */
+PixelKernelImplementation DefaultPixelKernelImplementation();
+
+/**
+ * @brief Return the kernel for a format & implementation.
+ * @returns the kernel, or NULL if the implementation isn't available on this
+ *   build.
+ */
+PixelKernel GetPixelKernel(PixelFormat format,
+                           PixelKernelImplementation implementation);
+
+/**
+ * @brief Fill the output with copies of a single converted pixel.
+ * @param dest the output, this must have room for pixel_size * count bytes.
+ * @param pixel the pixel to copy.
+ * @param pixel_size the size of the pixel.
+ * @param count the number of copies.
+ */
+void FillPixels(uint8_t *dest, const uint8_t *pixel, unsigned int pixel_size,
+                unsigned int count);
+
+// The color correction tables are shared with ola::dmx::PixelMap.
+using ola::dmx::ApplyColorTable;
+using ola::dmx::BuildColorTable;
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_SPI_PIXELFORMAT_H_
@@ -0,0 +1,165 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelFormatTest.cpp
+ * Test fixture for the pixel format kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ola/base/Array.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/spi/PixelFormat.h"
+
+using ola::plugin::spi::ApplyColorTable;
+using ola::plugin::spi::BuildColorTable;
+using ola::plugin::spi::ConvertPixels;
+using ola::plugin::spi::FillPixels;
+using ola::plugin::spi::GetPixelKernel;
+using ola::plugin::spi::PIXEL_FORMAT_APA102;
+using ola::plugin::spi::PIXEL_FORMAT_LPD8806;
+using ola::plugin::spi::PIXEL_FORMAT_P9813;
+using ola::plugin::spi::PIXEL_FORMAT_WS2801;
+using ola::plugin::spi::PIXEL_KERNEL_NEON;
+using ola::plugin::spi::PIXEL_KERNEL_SCALAR;
+using ola::plugin::spi::PixelFormat;
+using ola::plugin::spi::PixelFormatSize;
+using ola::plugin::spi::PixelKernel;
+using ola::plugin::spi::PixelKernelImplementation;
+
+class PixelFormatTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PixelFormatTest);
+  CPPUNIT_TEST(testFormats);
+  CPPUNIT_TEST(testImplementationsMatch);
+  CPPUNIT_TEST(testFillPixels);
+  CPPUNIT_TEST(testColorTable);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testFormats();
+  void testImplementationsMatch();
+  void testFillPixels();
+  void testColorTable();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PixelFormatTest);
+
+
+/*
+ * Check the output of each format.
+ */
+void PixelFormatTest::testFormats() {
+  const uint8_t rgb[] = {0xff, 0x80, 0x01, 0x00, 0x40, 0xc0};
+  uint8_t output[8];
+
+  ConvertPixels(PIXEL_FORMAT_WS2801, output, rgb, 2);
+  OLA_ASSERT_DATA_EQUALS(rgb, arraysize(rgb), output, 6);
+
+  const uint8_t lpd8806[] = {0xc0, 0xff, 0x80, 0xa0, 0x80, 0xe0};
+  ConvertPixels(PIXEL_FORMAT_LPD8806, output, rgb, 2);
+  OLA_ASSERT_DATA_EQUALS(lpd8806, arraysize(lpd8806), output, 6);
+
+  const uint8_t p9813[] = {0xf4, 0x01, 0x80, 0xff, 0xcb, 0xc0, 0x40, 0x00};
+  ConvertPixels(PIXEL_FORMAT_P9813, output, rgb, 2);
+  OLA_ASSERT_DATA_EQUALS(p9813, arraysize(p9813), output, 8);
+
+  const uint8_t apa102[] = {0xff, 0x01, 0x80, 0xff, 0xff, 0xc0, 0x40, 0x00};
+  ConvertPixels(PIXEL_FORMAT_APA102, output, rgb, 2);
+  OLA_ASSERT_DATA_EQUALS(apa102, arraysize(apa102), output, 8);
+
+  OLA_ASSERT_EQ(3u, PixelFormatSize(PIXEL_FORMAT_WS2801));
+  OLA_ASSERT_EQ(3u, PixelFormatSize(PIXEL_FORMAT_LPD8806));
+  OLA_ASSERT_EQ(4u, PixelFormatSize(PIXEL_FORMAT_P9813));
+  OLA_ASSERT_EQ(4u, PixelFormatSize(PIXEL_FORMAT_APA102));
+}
+
+
+/*
+ * Check the vector kernels match the scalar ones, including the pixels that
+ * don't fill a whole vector.
+ */
+void PixelFormatTest::testImplementationsMatch() {
+  const unsigned int PIXELS = 37;
+  uint8_t rgb[PIXELS * 3];
+  for (unsigned int i = 0; i < arraysize(rgb); i++) {
+    rgb[i] = static_cast<uint8_t>(i * 67 + 13);
+  }
+
+  const PixelFormat formats[] = {
+    PIXEL_FORMAT_WS2801, PIXEL_FORMAT_LPD8806, PIXEL_FORMAT_P9813,
+    PIXEL_FORMAT_APA102
+  };
+  const PixelKernelImplementation implementations[] = {
+    PIXEL_KERNEL_SCALAR, PIXEL_KERNEL_NEON
+  };
+
+  for (unsigned int i = 0; i < arraysize(formats); i++) {
+    uint8_t expected[PIXELS * 4];
+    GetPixelKernel(formats[i], PIXEL_KERNEL_SCALAR)(expected, rgb, PIXELS);
+
+    for (unsigned int j = 0; j < arraysize(implementations); j++) {
+      PixelKernel kernel = GetPixelKernel(formats[i], implementations[j]);
+      if (!kernel) {
+        continue;
+      }
+      uint8_t output[PIXELS * 4];
+      kernel(output, rgb, PIXELS);
+      OLA_ASSERT_DATA_EQUALS(expected, PIXELS * PixelFormatSize(formats[i]),
+                             output, PIXELS * PixelFormatSize(formats[i]));
+    }
+  }
+}
+
+
+void PixelFormatTest::testFillPixels() {
+  const uint8_t pixel[] = {1, 2, 3, 4};
+  uint8_t output[29];
+  memset(output, 0xaa, arraysize(output));
+
+  FillPixels(output, pixel, arraysize(pixel), 7);
+  for (unsigned int i = 0; i < 28; i++) {
+    OLA_ASSERT_EQ(pixel[i % 4], output[i]);
+  }
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0xaa), output[28]);
+
+  // Nothing is written for 0 pixels
+  FillPixels(output + 28, pixel, arraysize(pixel), 0);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0xaa), output[28]);
+}
+
+
+void PixelFormatTest::testColorTable() {
+  uint8_t table[256];
+  OLA_ASSERT_FALSE(BuildColorTable(1.0, 255, table));
+  for (unsigned int i = 0; i < arraysize(table); i++) {
+    OLA_ASSERT_EQ(static_cast<uint8_t>(i), table[i]);
+  }
+
+  OLA_ASSERT_TRUE(BuildColorTable(1.0, 128, table));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), table[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(64), table[127]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(128), table[255]);
+
+  OLA_ASSERT_TRUE(BuildColorTable(2.0, 255, table));
+  const uint8_t source[] = {0, 128, 255};
+  uint8_t output[3];
+  ApplyColorTable(table, output, source, arraysize(source));
+  const uint8_t expected[] = {0, 64, 255};
+  OLA_ASSERT_DATA_EQUALS(expected, arraysize(expected), output,
+                         arraysize(output));
+}
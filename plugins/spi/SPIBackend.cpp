@@ -19,13 +19,21 @@
  * Copyright (C) 2013 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <errno.h>
 #include <fcntl.h>
+#ifdef HAVE_LINUX_GPIO_H
+#include <linux/gpio.h>
+#endif  // HAVE_LINUX_GPIO_H
 #include <linux/spi/spidev.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
 
+#include <algorithm>
 #include <numeric>
 #include <sstream>
 #include <string>
@@ -35,6 +43,7 @@
 #include "ola/io/IOUtils.h"
 #include "ola/network/SocketCloser.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/thread/ThreadSettings.h"
 #include "plugins/spi/SPIBackend.h"
 
 namespace ola {
@@ -48,61 +57,39 @@ using std::vector;
 const char SPIBackendInterface::SPI_DROP_VAR[] = "spi-drops";
 const char SPIBackendInterface::SPI_DROP_VAR_KEY[] = "device";
 
-uint8_t *HardwareBackend::OutputData::Resize(unsigned int length) {
-  if (length < m_size) {
-    m_size = length;
-    return m_data;
-  } else if (length == m_size) {
-    return m_data;
-  }
-
-  if (length <= m_actual_size) {
-    m_size = length;
-    return m_data;
-  }
-
-  delete[] m_data;
-  m_data = new uint8_t[length];
-  if (m_data) {
-    m_size = m_data ? length : 0;
-    m_actual_size = m_size;
-    memset(m_data, 0, length);
-  }
+/*
+ * Size the buffer for length bytes of data followed by latch_bytes of zeros.
+ */
+uint8_t *HardwareBackend::OutputData::Resize(unsigned int length,
+                                             unsigned int latch_bytes) {
+  const unsigned int size = length + latch_bytes;
+  if (size > m_actual_size) {
+    delete[] m_data;
+    m_data = new uint8_t[size];
+    m_actual_size = size;
+    memset(m_data, 0, size);
+  } else {
+    memset(m_data + length, 0, latch_bytes);
+  }
+  m_size = size;
   return m_data;
 }
 
-void HardwareBackend::OutputData::SetPending() {
-  m_write_pending = true;
-}
-
-void HardwareBackend::OutputData::SetLatchBytes(unsigned int latch_bytes) {
-  m_latch_bytes = latch_bytes;
-}
-
-HardwareBackend::OutputData& HardwareBackend::OutputData::operator=(
-    const HardwareBackend::OutputData &other) {
-  if (this != &other) {
-    uint8_t *data = Resize(other.m_size + other.m_latch_bytes);
-    if (data) {
-      memcpy(data, other.m_data, other.m_size);
-      memset(data + other.m_size, 0, other.m_latch_bytes);
-      m_write_pending = true;
-    } else {
-      m_write_pending = false;
-    }
-  }
-  return *this;
-}
-
 HardwareBackend::HardwareBackend(const Options &options,
                                  SPIWriterInterface *writer,
                                  ExportMap *export_map)
-    : m_spi_writer(writer),
+    : ola::thread::Thread(ola::thread::Thread::Options(
+          "spi-hw-backend", ola::thread::THREAD_CLASS_OUTPUT)),
+      m_spi_writer(writer),
       m_drop_map(NULL),
       m_output_count(1 << options.gpio_pins.size()),
       m_exit(false),
-      m_gpio_pins(options.gpio_pins) {
-  SetupOutputs(&m_output_data);
+      m_gpio_pins(options.gpio_pins),
+      m_gpio_chip(options.gpio_chip),
+      m_gpio_line_fd(-1),
+      m_selected_output(-1) {
+  SetupOutputs(&m_checked_out);
+  SetupOutputs(&m_pending);
   if (export_map) {
     m_drop_map = export_map->GetUIntMapVar(SPI_DROP_VAR,
                                            SPI_DROP_VAR_KEY);
@@ -120,7 +107,8 @@ HardwareBackend::~HardwareBackend() {
   m_cond_var.Signal();
   Join();
 
-  STLDeleteElements(&m_output_data);
+  STLDeleteElements(&m_checked_out);
+  STLDeleteElements(&m_pending);
   CloseGPIOFDs();
 }
 
@@ -143,15 +131,7 @@ uint8_t *HardwareBackend::Checkout(uint8_t output_id,
     return NULL;
   }
 
-  m_mutex.Lock();
-  uint8_t *output = m_output_data[output_id]->Resize(length);
-  if (!output) {
-    m_mutex.Unlock();
-  }
-  m_output_data[output_id]->SetLatchBytes(latch_bytes);
-  // We return with the Mutex locked, the caller must then call Commit()
-  // coverity[LOCK]
-  return output;
+  return m_checked_out[output_id]->Resize(length, latch_bytes);
 }
 
 void HardwareBackend::Commit(uint8_t output) {
@@ -159,13 +139,16 @@ void HardwareBackend::Commit(uint8_t output) {
     return;
   }
 
-  OutputData *output_data = m_output_data[output];
-  if (output_data->IsPending() && m_drop_map) {
-    // There was already another write pending which we're now stomping on
-    (*m_drop_map)[m_spi_writer->DevicePath()]++;
+  m_checked_out[output]->SetPending();
+  {
+    MutexLocker lock(&m_mutex);
+    if (m_pending[output]->IsPending() && m_drop_map) {
+      // There was already another write pending which we're now stomping on
+      (*m_drop_map)[m_spi_writer->DevicePath()]++;
+    }
+    std::swap(m_checked_out[output], m_pending[output]);
   }
-  output_data->SetPending();
-  m_mutex.Unlock();
+  m_checked_out[output]->ResetPending();
   m_cond_var.Signal();
 }
 
@@ -183,8 +166,8 @@ void *HardwareBackend::Run() {
     }
 
     bool action_pending = false;
-    Outputs::const_iterator iter = m_output_data.begin();
-    for (; iter != m_output_data.end(); ++iter) {
+    Outputs::const_iterator iter = m_pending.begin();
+    for (; iter != m_pending.end(); ++iter) {
       if ((*iter)->IsPending()) {
         action_pending = true;
         break;
@@ -200,11 +183,10 @@ void *HardwareBackend::Run() {
       return NULL;
     }
 
-    for (unsigned int i = 0; i < m_output_data.size(); i++) {
-      if (m_output_data[i]->IsPending()) {
-        // take a copy
-        *outputs[i] = *m_output_data[i];
-        m_output_data[i]->ResetPending();
+    for (unsigned int i = 0; i < m_pending.size(); i++) {
+      if (m_pending[i]->IsPending()) {
+        // Swap in the new frame, the one we last wrote is reused by Commit()
+        std::swap(outputs[i], m_pending[i]);
       }
     }
     m_mutex.Unlock();
@@ -225,6 +207,40 @@ void HardwareBackend::SetupOutputs(Outputs *outputs) {
 }
 
 void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
+  if (!SelectOutput(output_id)) {
+    return;
+  }
+  m_spi_writer->WriteSPIData(output->GetData(), output->Size());
+}
+
+/*
+ * Set the GPIO pins to select an output. With the character device all the
+ * pins are set with a single ioctl, with sysfs each pin that changes is a
+ * separate write.
+ */
+bool HardwareBackend::SelectOutput(uint8_t output_id) {
+  if (m_selected_output == output_id) {
+    return true;
+  }
+
+#ifdef HAVE_LINUX_GPIO_H
+  if (m_gpio_line_fd >= 0) {
+    struct gpiohandle_data values;
+    memset(&values, 0, sizeof(values));
+    for (unsigned int i = 0; i < m_gpio_pins.size(); i++) {
+      values.values[i] = (output_id >> i) & 1;
+    }
+    if (ioctl(m_gpio_line_fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &values) < 0) {
+      OLA_WARN << "Failed to set the SPI GPIO lines on " << m_gpio_chip
+               << ": " << strerror(errno);
+      m_selected_output = -1;
+      return false;
+    }
+    m_selected_output = output_id;
+    return true;
+  }
+#endif  // HAVE_LINUX_GPIO_H
+
   const string on("1");
   const string off("0");
 
@@ -241,16 +257,21 @@ void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
         OLA_WARN << "Failed to toggle SPI GPIO pin "
                  << static_cast<int>(m_gpio_pins[i]) << ": "
                  << strerror(errno);
-        return;
+        m_selected_output = -1;
+        return false;
       }
       m_gpio_pin_state[i] = pin;
     }
   }
-
-  m_spi_writer->WriteSPIData(output->GetData(), output->Size());
+  m_selected_output = output_id;
+  return true;
 }
 
 bool HardwareBackend::SetupGPIO() {
+  if (!m_gpio_chip.empty()) {
+    return m_gpio_pins.empty() || SetupGPIOChip();
+  }
+
   /**
    * This relies on the pins being exported:
    *   echo N > /sys/class/gpio/export
@@ -292,24 +313,71 @@ bool HardwareBackend::SetupGPIO() {
   return true;
 }
 
+/*
+ * Request all the pins as outputs from the GPIO character device, this
+ * doesn't need the pins to be exported first.
+ */
+bool HardwareBackend::SetupGPIOChip() {
+#ifdef HAVE_LINUX_GPIO_H
+  int chip_fd;
+  if (!ola::io::Open(m_gpio_chip, O_RDWR, &chip_fd)) {
+    return false;
+  }
+  ola::network::SocketCloser closer(chip_fd);
+
+  struct gpiohandle_request request;
+  memset(&request, 0, sizeof(request));
+  for (unsigned int i = 0; i < m_gpio_pins.size(); i++) {
+    request.lineoffsets[i] = m_gpio_pins[i];
+  }
+  request.lines = m_gpio_pins.size();
+  request.flags = GPIOHANDLE_REQUEST_OUTPUT;
+  strncpy(request.consumer_label, "olad-spi",
+          sizeof(request.consumer_label) - 1);
+
+  if (ioctl(chip_fd, GPIO_GET_LINEHANDLE_IOCTL, &request) < 0) {
+    OLA_WARN << "Failed to request the SPI GPIO lines from " << m_gpio_chip
+             << ": " << strerror(errno);
+    return false;
+  }
+  // The lines start low, which selects output 0.
+  m_gpio_line_fd = request.fd;
+  m_selected_output = 0;
+  return true;
+#else
+  OLA_WARN << "GPIO character devices aren't supported, can't use "
+           << m_gpio_chip;
+  return false;
+#endif  // HAVE_LINUX_GPIO_H
+}
+
 void HardwareBackend::CloseGPIOFDs() {
   GPIOFds::iterator iter = m_gpio_fds.begin();
   for (; iter != m_gpio_fds.end(); ++iter) {
     close(*iter);
   }
   m_gpio_fds.clear();
+
+  if (m_gpio_line_fd >= 0) {
+    close(m_gpio_line_fd);
+    m_gpio_line_fd = -1;
+  }
+  m_selected_output = -1;
 }
 
 SoftwareBackend::SoftwareBackend(const Options &options,
                                  SPIWriterInterface *writer,
                                  ExportMap *export_map)
-    : m_spi_writer(writer),
+    : ola::thread::Thread(ola::thread::Thread::Options(
+          "spi-sw-backend", ola::thread::THREAD_CLASS_OUTPUT)),
+      m_spi_writer(writer),
       m_drop_map(NULL),
       m_write_pending(false),
       m_exit(false),
       m_sync_output(options.sync_output),
       m_output_sizes(options.outputs, 0),
       m_latch_bytes(options.outputs, 0),
+      m_updated_outputs(options.outputs, false),
       m_output(NULL),
       m_length(0) {
   if (export_map) {
@@ -390,7 +458,12 @@ void SoftwareBackend::Commit(uint8_t output) {
     return;
   }
 
-  bool should_write = m_sync_output < 0 || output == m_sync_output;
+  bool should_write;
+  if (m_sync_output == SYNC_ALL_OUTPUTS) {
+    should_write = FrameComplete(output);
+  } else {
+    should_write = m_sync_output < 0 || output == m_sync_output;
+  }
   if (should_write) {
     if (m_write_pending && m_drop_map) {
       // There was already another write pending which we're now stomping on
@@ -404,6 +477,28 @@ void SoftwareBackend::Commit(uint8_t output) {
   }
 }
 
+/*
+ * Record that an output was updated, and return true if the frame is complete.
+ * If an output is updated a second time before the others, their data isn't
+ * coming this frame (e.g. the port isn't patched), so we write what we have
+ * rather than wait.
+ */
+bool SoftwareBackend::FrameComplete(uint8_t output) {
+  if (m_updated_outputs[output]) {
+    std::fill(m_updated_outputs.begin(), m_updated_outputs.end(), false);
+    m_updated_outputs[output] = true;
+    return true;
+  }
+
+  m_updated_outputs[output] = true;
+  if (std::find(m_updated_outputs.begin(), m_updated_outputs.end(), false) !=
+      m_updated_outputs.end()) {
+    return false;
+  }
+  std::fill(m_updated_outputs.begin(), m_updated_outputs.end(), false);
+  return true;
+}
+
 void *SoftwareBackend::Run() {
   uint8_t *output_data = NULL;
   unsigned int length = 0;
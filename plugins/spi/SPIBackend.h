@@ -58,7 +58,13 @@ class SPIBackendInterface {
 
 
 /**
- * A HardwareBackend which uses GPIO pins and an external de-multiplexer
+ * A HardwareBackend which uses GPIO pins and an external de-multiplexer.
+ *
+ * Each output is triple buffered. The caller fills the checked out buffer,
+ * Commit() swaps it with the pending buffer and the writer thread swaps the
+ * pending buffer with the one it last wrote. Only the pointer swaps happen
+ * under the lock, so Checkout() and Commit() never wait for an SPI write.
+ * The checked out buffer doesn't hold the previous frame.
  */
 class HardwareBackend : public ola::thread::Thread,
                         public SPIBackendInterface {
@@ -67,6 +73,10 @@ class HardwareBackend : public ola::thread::Thread,
     // Which GPIO bits to use to select the output. The number of outputs
     // will be 2 ** gpio_pins.size();
     std::vector<uint16_t> gpio_pins;
+    // If set, the GPIO character device (e.g. /dev/gpiochip0) to use. The
+    // gpio_pins are then line offsets on that chip, rather than sysfs GPIO
+    // numbers.
+    std::string gpio_chip;
   };
 
   HardwareBackend(const Options &options,
@@ -97,30 +107,26 @@ class HardwareBackend : public ola::thread::Thread,
         : m_data(NULL),
           m_write_pending(false),
           m_size(0),
-          m_actual_size(0),
-          m_latch_bytes(0) {
+          m_actual_size(0) {
     }
 
     ~OutputData() { delete[] m_data; }
 
-    uint8_t *Resize(unsigned int length);
-    void SetLatchBytes(unsigned int latch_bytes);
-    void SetPending();
+    uint8_t *Resize(unsigned int length, unsigned int latch_bytes);
+    void SetPending() { m_write_pending = true; }
     bool IsPending() const { return m_write_pending; }
     void ResetPending() { m_write_pending = false; }
     const uint8_t *GetData() const { return m_data; }
     unsigned int Size() const { return m_size; }
 
-    OutputData& operator=(const OutputData &other);
-
    private:
     uint8_t *m_data;
     bool m_write_pending;
     unsigned int m_size;
     unsigned int m_actual_size;
-    unsigned int m_latch_bytes;
 
     OutputData(const OutputData&);
+    OutputData& operator=(const OutputData&);
   };
 
   typedef std::vector<int> GPIOFds;
@@ -133,16 +139,26 @@ class HardwareBackend : public ola::thread::Thread,
   ola::thread::ConditionVariable m_cond_var;
   bool m_exit;
 
-  Outputs m_output_data;
+  // The buffers the caller fills, only used by the caller's thread.
+  Outputs m_checked_out;
+  // The buffers waiting to be written, protected by m_mutex.
+  Outputs m_pending;
 
   // GPIO members
   GPIOFds m_gpio_fds;
   const std::vector<uint16_t> m_gpio_pins;
   std::vector<bool> m_gpio_pin_state;
+  const std::string m_gpio_chip;
+  // The line handle from the GPIO character device, if we're using it.
+  int m_gpio_line_fd;
+  // The output the lines currently select, or -1 if they haven't been set.
+  int m_selected_output;
 
   void SetupOutputs(Outputs *outputs);
   void WriteOutput(uint8_t output_id, OutputData *output);
+  bool SelectOutput(uint8_t output_id);
   bool SetupGPIO();
+  bool SetupGPIOChip();
   void CloseGPIOFDs();
 };
 
@@ -163,6 +179,8 @@ class SoftwareBackend : public SPIBackendInterface,
      * Controls if we designate one of the outputs as the 'sync' output.
      * If set >= 0, it denotes the output which triggers the SPI write.
      * If set to -1, we perform an SPI write on each update.
+     * If set to SYNC_ALL_OUTPUTS, we perform an SPI write once every output
+     * has been updated.
      */
     int16_t sync_output;
 
@@ -187,6 +205,13 @@ class SoftwareBackend : public SPIBackendInterface,
 
   std::string DevicePath() const { return m_spi_writer->DevicePath(); }
 
+  /**
+   * The sync_output value which writes the data once every output has been
+   * updated. This lets a long strip be split across several universes, yet
+   * only be latched once per frame.
+   */
+  static const int16_t SYNC_ALL_OUTPUTS = -3;
+
  protected:
   void* Run();
 
@@ -201,8 +226,12 @@ class SoftwareBackend : public SPIBackendInterface,
   const int16_t m_sync_output;
   std::vector<unsigned int> m_output_sizes;
   std::vector<unsigned int> m_latch_bytes;
+  // The outputs updated since the last write, used with SYNC_ALL_OUTPUTS.
+  std::vector<bool> m_updated_outputs;
   uint8_t *m_output;
   unsigned int m_length;
+
+  bool FrameComplete(uint8_t output);
 };
 
 
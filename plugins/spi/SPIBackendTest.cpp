@@ -44,6 +44,7 @@ class SPIBackendTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testInvalidOutputs);
   CPPUNIT_TEST(testSoftwareDrops);
   CPPUNIT_TEST(testSoftwareVariousFrameLengths);
+  CPPUNIT_TEST(testSoftwareSyncAllOutputs);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -63,6 +64,7 @@ class SPIBackendTest: public CppUnit::TestFixture {
   void testInvalidOutputs();
   void testSoftwareDrops();
   void testSoftwareVariousFrameLengths();
+  void testSoftwareSyncAllOutputs();
 
  private:
   ExportMap m_export_map;
@@ -174,34 +176,40 @@ void SPIBackendTest::testHardwareDrops() {
 
 /**
  * Check that we handle the case of frame lengths changing.
+ *
+ * The hardware backend rotates buffers, so the checked out buffer doesn't
+ * hold the previous frame and each frame here fills the whole buffer.
  */
 void SPIBackendTest::testHardwareVariousFrameLengths() {
   HardwareBackend backend(HardwareBackend::Options(), &m_writer,
                           &m_export_map);
   OLA_ASSERT(backend.Init());
 
+  // A new buffer is zeroed.
   OLA_ASSERT(SendSomeData(&backend, 0, DATA1, arraysize(DATA1), m_total_size));
   m_writer.WaitForWrite();
   OLA_ASSERT_EQ(1u, m_writer.WriteCount());
   m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED1, arraysize(EXPECTED1));
   m_writer.ResetWrite();
 
-  OLA_ASSERT(SendSomeData(&backend, 0, DATA1, arraysize(DATA1), m_total_size));
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA3, arraysize(DATA3), m_total_size));
   m_writer.WaitForWrite();
   OLA_ASSERT_EQ(2u, m_writer.WriteCount());
-  m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED1, arraysize(EXPECTED1));
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), DATA3, arraysize(DATA3));
   m_writer.ResetWrite();
 
-  OLA_ASSERT(SendSomeData(&backend, 0, DATA2, arraysize(DATA2), m_total_size));
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA2, arraysize(DATA2),
+                          arraysize(DATA2)));
   m_writer.WaitForWrite();
   OLA_ASSERT_EQ(3u, m_writer.WriteCount());
-  m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED2, arraysize(EXPECTED2));
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), DATA2, arraysize(DATA2));
   m_writer.ResetWrite();
 
-  OLA_ASSERT(SendSomeData(&backend, 0, DATA1, arraysize(DATA1), m_total_size));
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA1, arraysize(DATA1),
+                          arraysize(DATA1)));
   m_writer.WaitForWrite();
   OLA_ASSERT_EQ(4u, m_writer.WriteCount());
-  m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED1, arraysize(EXPECTED1));
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), DATA1, arraysize(DATA1));
   m_writer.ResetWrite();
 
   OLA_ASSERT(SendSomeData(&backend, 0, DATA3, arraysize(DATA3), m_total_size));
@@ -210,20 +218,23 @@ void SPIBackendTest::testHardwareVariousFrameLengths() {
   m_writer.CheckDataMatches(OLA_SOURCELINE(), DATA3, arraysize(DATA3));
   m_writer.ResetWrite();
 
-  // now test the latch bytes
+  // now test the latch bytes, these are zeroed even if the buffer held data.
   OLA_ASSERT(
-      SendSomeData(&backend, 0, DATA1, arraysize(DATA1), m_total_size, 4));
+      SendSomeData(&backend, 0, DATA3, arraysize(DATA3), m_total_size, 4));
   m_writer.WaitForWrite();
   OLA_ASSERT_EQ(6u, m_writer.WriteCount());
   m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED3, arraysize(EXPECTED3));
   m_writer.ResetWrite();
 
-  OLA_ASSERT(
-      SendSomeData(&backend, 0, DATA3, arraysize(DATA3), m_total_size, 4));
-  m_writer.WaitForWrite();
-  OLA_ASSERT_EQ(7u, m_writer.WriteCount());
-  m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED3, arraysize(EXPECTED3));
-  m_writer.ResetWrite();
+  for (unsigned int i = 0; i < 3; i++) {
+    OLA_ASSERT(SendSomeData(&backend, 0, DATA1, arraysize(DATA1),
+                            arraysize(DATA1), 10));
+    m_writer.WaitForWrite();
+    OLA_ASSERT_EQ(7u + i, m_writer.WriteCount());
+    m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED4,
+                              arraysize(EXPECTED4));
+    m_writer.ResetWrite();
+  }
 }
 
 /**
@@ -324,3 +335,36 @@ void SPIBackendTest::testSoftwareVariousFrameLengths() {
   m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED3, arraysize(EXPECTED3));
   m_writer.ResetWrite();
 }
+
+
+/**
+ * Check that SYNC_ALL_OUTPUTS writes once all the outputs are updated.
+ */
+void SPIBackendTest::testSoftwareSyncAllOutputs() {
+  SoftwareBackend::Options options;
+  options.outputs = 3;
+  options.sync_output = SoftwareBackend::SYNC_ALL_OUTPUTS;
+  SoftwareBackend backend(options, &m_writer, &m_export_map);
+  OLA_ASSERT(backend.Init());
+
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA1, 4, 4));
+  OLA_ASSERT(SendSomeData(&backend, 1, DATA2, 4, 4));
+  OLA_ASSERT(SendSomeData(&backend, 2, DATA1, 4, 4));
+  m_writer.WaitForWrite();
+  OLA_ASSERT_EQ(1u, m_writer.WriteCount());
+  const uint8_t expected1[] = {1, 2, 3, 4, 0xa, 0xb, 0xc, 0xd, 1, 2, 3, 4};
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), expected1, arraysize(expected1));
+  m_writer.ResetWrite();
+
+  // Output 0 is updated twice, so the second update triggers the write.
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA2, 4, 4));
+  OLA_ASSERT(SendSomeData(&backend, 1, DATA1, 4, 4));
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA2, 4, 4));
+  m_writer.WaitForWrite();
+  OLA_ASSERT_EQ(2u, m_writer.WriteCount());
+  const uint8_t expected2[] = {
+    0xa, 0xb, 0xc, 0xd, 1, 2, 3, 4, 1, 2, 3, 4
+  };
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), expected2, arraysize(expected2));
+  OLA_ASSERT_EQ(0u, DropCount());
+}
@@ -115,6 +115,21 @@ SPIDevice::SPIDevice(SPIPlugin *owner,
       spi_output_options.pixel_count = pixel_count;
     }
 
+    if (m_preferences->HasKey(GammaKey(i))) {
+      std::istringstream gamma_str(m_preferences->GetValue(GammaKey(i)));
+      double gamma;
+      if (gamma_str >> gamma && gamma > 0) {
+        spi_output_options.gamma = gamma;
+      } else {
+        OLA_WARN << "Invalid gamma for " << GammaKey(i);
+      }
+    }
+
+    uint8_t brightness;
+    if (StringToInt(m_preferences->GetValue(BrightnessKey(i)), &brightness)) {
+      spi_output_options.brightness = brightness;
+    }
+
     auto_ptr<UID> uid(uid_allocator->AllocateNext());
     if (!uid.get()) {
       OLA_WARN << "Insufficient UIDs remaining to allocate a UID for SPI port "
@@ -204,6 +219,10 @@ string SPIDevice::GPIOPinKey() const {
   return m_spi_device_name + "-gpio-pin";
 }
 
+string SPIDevice::GPIOChipKey() const {
+  return m_spi_device_name + "-gpio-chip";
+}
+
 string SPIDevice::DeviceLabelKey(uint8_t port) const {
   return GetPortKey("device-label", port);
 }
@@ -220,6 +239,14 @@ string SPIDevice::PixelCountKey(uint8_t port) const {
   return GetPortKey("pixel-count", port);
 }
 
+string SPIDevice::GammaKey(uint8_t port) const {
+  return GetPortKey("gamma", port);
+}
+
+string SPIDevice::BrightnessKey(uint8_t port) const {
+  return GetPortKey("brightness", port);
+}
+
 string SPIDevice::GetPortKey(const string &suffix, uint8_t port) const {
   std::ostringstream str;
   str << m_spi_device_name << "-" << static_cast<int>(port) << "-" << suffix;
@@ -238,7 +265,7 @@ void SPIDevice::SetDefaults() {
                                  1000000);
   m_preferences->SetDefaultValue(SPICEKey(), BoolValidator(), false);
   m_preferences->SetDefaultValue(PortCountKey(), UIntValidator(1, 8), 1);
-  m_preferences->SetDefaultValue(SyncPortKey(), IntValidator(-2, 8), 0);
+  m_preferences->SetDefaultValue(SyncPortKey(), IntValidator(-3, 8), 0);
   m_preferences->Save();
 }
 
@@ -261,6 +288,10 @@ void SPIDevice::PopulateHardwareBackendOptions(
 
     options->gpio_pins.push_back(pin);
   }
+
+  if (m_preferences->HasKey(GPIOChipKey())) {
+    options->gpio_chip = m_preferences->GetValue(GPIOChipKey());
+  }
 }
 
 void SPIDevice::PopulateSoftwareBackendOptions(
@@ -70,12 +70,15 @@ class SPIDevice: public ola::Device {
   std::string PortCountKey() const;
   std::string SyncPortKey() const;
   std::string GPIOPinKey() const;
+  std::string GPIOChipKey() const;
 
   // Per port options
   std::string DeviceLabelKey(uint8_t port) const;
   std::string PersonalityKey(uint8_t port) const;
   std::string PixelCountKey(uint8_t port) const;
   std::string StartAddressKey(uint8_t port) const;
+  std::string GammaKey(uint8_t port) const;
+  std::string BrightnessKey(uint8_t port) const;
   std::string GetPortKey(const std::string &suffix, uint8_t port) const;
 
   void SetDefaults();
@@ -46,6 +46,7 @@
 #include "ola/rdm/UIDSet.h"
 #include "ola/stl/STLUtils.h"
 
+#include "plugins/spi/PixelFormat.h"
 #include "plugins/spi/SPIBackend.h"
 #include "plugins/spi/SPIOutput.h"
 
@@ -83,6 +84,7 @@ const uint8_t SPIOutput::SPI_MODE = 0;
  * The p9813 uses another byte preceding each of the three bytes as a kind
  * of header.
  */
+const uint16_t SPIOutput::RGB_SLOTS_PER_PIXEL = 3;
 const uint16_t SPIOutput::WS2801_SLOTS_PER_PIXEL = 3;
 const uint16_t SPIOutput::LPD8806_SLOTS_PER_PIXEL = 3;
 const uint16_t SPIOutput::P9813_SLOTS_PER_PIXEL = 3;
@@ -178,6 +180,8 @@ SPIOutput::SPIOutput(const UID &uid, SPIBackendInterface *backend,
       m_start_address(1),
       m_identify_mode(false) {
   m_spi_device_name = FilenameFromPathOrPath(m_backend->DevicePath());
+  m_color_correction = BuildColorTable(options.gamma, options.brightness,
+                                       m_color_table);
 
   PersonalityCollection::PersonalityList personalities;
   personalities.push_back(Personality(m_pixel_count * WS2801_SLOTS_PER_PIXEL,
@@ -293,13 +297,13 @@ void SPIOutput::SendRDMRequest(RDMRequest *request,
 bool SPIOutput::InternalWriteDMX(const DmxBuffer &buffer) {
   switch (m_personality_manager->ActivePersonalityNumber()) {
     case 1:
-      IndividualWS2801Control(buffer);
+      IndividualWS2801Control(HoldPixels(buffer, 1));
       break;
     case 2:
       CombinedWS2801Control(buffer);
       break;
     case 3:
-      IndividualLPD8806Control(buffer);
+      IndividualLPD8806Control(HoldPixels(buffer, LPD8806_SLOTS_PER_PIXEL));
       break;
     case 4:
       CombinedLPD8806Control(buffer);
@@ -311,7 +315,7 @@ bool SPIOutput::InternalWriteDMX(const DmxBuffer &buffer) {
       CombinedP9813Control(buffer);
       break;
     case 7:
-      IndividualAPA102Control(buffer);
+      IndividualAPA102Control(HoldPixels(buffer, APA102_SLOTS_PER_PIXEL));
       break;
     case 8:
       CombinedAPA102Control(buffer);
@@ -322,6 +326,82 @@ bool SPIOutput::InternalWriteDMX(const DmxBuffer &buffer) {
   return true;
 }
 
+/*
+ * The backend buffers don't hold the previous frame, so for the modes that
+ * leave pixels unchanged when a frame is short, we merge the complete pixels
+ * of a short frame into the last one. This only copies when the frame shrinks.
+ */
+const DmxBuffer &SPIOutput::HoldPixels(const DmxBuffer &buffer,
+                                       unsigned int slots_per_pixel) {
+  if (buffer.Size() >= m_last_frame.Size()) {
+    m_last_frame = buffer;
+    return m_last_frame;
+  }
+
+  const unsigned int first_slot = m_start_address - 1;  // 0 offset
+  if (buffer.Size() < first_slot + slots_per_pixel) {
+    // No complete pixels, leave it to the caller to ignore the frame
+    return buffer;
+  }
+  const unsigned int pixel_slots = buffer.Size() - first_slot;
+  m_last_frame.SetRange(
+      0, buffer.GetRaw(),
+      first_slot + pixel_slots - pixel_slots % slots_per_pixel);
+  return m_last_frame;
+}
+
+/*
+ * Return length bytes of pixel data starting at first_slot, with the color
+ * table applied if there is one. The caller must check the buffer is long
+ * enough.
+ */
+const uint8_t *SPIOutput::PixelData(const DmxBuffer &buffer,
+                                    unsigned int first_slot,
+                                    unsigned int length) {
+  if (!m_color_correction) {
+    return buffer.GetRaw() + first_slot;
+  }
+  ApplyColorTable(m_color_table, m_pixel_data, buffer.GetRaw() + first_slot,
+                  length);
+  return m_pixel_data;
+}
+
+/*
+ * Convert the pixel at the start address for the combined modes.
+ * @returns false if there isn't a complete pixel.
+ */
+bool SPIOutput::CombinedPixel(const DmxBuffer &buffer, PixelFormat format,
+                              uint8_t *pixel) {
+  unsigned int pixel_data_length = RGB_SLOTS_PER_PIXEL;
+  uint8_t pixel_data[RGB_SLOTS_PER_PIXEL];
+  buffer.GetRange(m_start_address - 1, pixel_data, &pixel_data_length);
+  if (pixel_data_length != RGB_SLOTS_PER_PIXEL) {
+    OLA_INFO << "Insufficient DMX data, required " << RGB_SLOTS_PER_PIXEL
+             << ", got " << pixel_data_length;
+    return false;
+  }
+
+  if (m_color_correction) {
+    ApplyColorTable(m_color_table, pixel_data, pixel_data,
+                    RGB_SLOTS_PER_PIXEL);
+  }
+  ConvertPixels(format, pixel, pixel_data, 1);
+  return true;
+}
+
+/*
+ * The number of complete pixels the buffer has data for, up to the pixel
+ * count.
+ */
+unsigned int SPIOutput::PixelsAvailable(const DmxBuffer &buffer) const {
+  const unsigned int first_slot = m_start_address - 1;  // 0 offset
+  if (buffer.Size() <= first_slot) {
+    return 0;
+  }
+  return std::min(static_cast<unsigned int>(m_pixel_count),
+                  (buffer.Size() - first_slot) / RGB_SLOTS_PER_PIXEL);
+}
+
 void SPIOutput::IndividualWS2801Control(const DmxBuffer &buffer) {
   // We always check out the entire string length, even if we only have data
   // for part of it
@@ -331,18 +411,19 @@ void SPIOutput::IndividualWS2801Control(const DmxBuffer &buffer) {
     return;
   }
 
-  unsigned int new_length = output_length;
-  buffer.GetRange(m_start_address - 1, output, &new_length);
+  // The WS2801 takes RGB, so this copies any partial pixel as well.
+  const unsigned int first_slot = m_start_address - 1;  // 0 offset
+  if (buffer.Size() > first_slot) {
+    const unsigned int length = std::min(output_length,
+                                         buffer.Size() - first_slot);
+    memcpy(output, PixelData(buffer, first_slot, length), length);
+  }
   m_backend->Commit(m_output_number);
 }
 
 void SPIOutput::CombinedWS2801Control(const DmxBuffer &buffer) {
-  unsigned int pixel_data_length = WS2801_SLOTS_PER_PIXEL;
   uint8_t pixel_data[WS2801_SLOTS_PER_PIXEL];
-  buffer.GetRange(m_start_address - 1, pixel_data, &pixel_data_length);
-  if (pixel_data_length != WS2801_SLOTS_PER_PIXEL) {
-    OLA_INFO << "Insufficient DMX data, required " << WS2801_SLOTS_PER_PIXEL
-             << ", got " << pixel_data_length;
+  if (!CombinedPixel(buffer, PIXEL_FORMAT_WS2801, pixel_data)) {
     return;
   }
 
@@ -352,17 +433,14 @@ void SPIOutput::CombinedWS2801Control(const DmxBuffer &buffer) {
     return;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    memcpy(output + (i * WS2801_SLOTS_PER_PIXEL), pixel_data,
-           pixel_data_length);
-  }
+  FillPixels(output, pixel_data, WS2801_SLOTS_PER_PIXEL, m_pixel_count);
   m_backend->Commit(m_output_number);
 }
 
 void SPIOutput::IndividualLPD8806Control(const DmxBuffer &buffer) {
   const uint8_t latch_bytes = (m_pixel_count + 31) / 32;
-  const unsigned int first_slot = m_start_address - 1;  // 0 offset
-  if (buffer.Size() - first_slot < LPD8806_SLOTS_PER_PIXEL) {
+  const unsigned int pixels = PixelsAvailable(buffer);
+  if (!pixels) {
     // not even 3 bytes of data, don't bother updating
     return;
   }
@@ -375,49 +453,26 @@ void SPIOutput::IndividualLPD8806Control(const DmxBuffer &buffer) {
   if (!output)
     return;
 
-  const unsigned int length = std::min(m_pixel_count * LPD8806_SLOTS_PER_PIXEL,
-                                       buffer.Size() - first_slot);
-
-  for (unsigned int i = 0; i < length / LPD8806_SLOTS_PER_PIXEL; i++) {
-    // Convert RGB to GRB
-    unsigned int offset = first_slot + i * LPD8806_SLOTS_PER_PIXEL;
-    uint8_t r = buffer.Get(offset);
-    uint8_t g = buffer.Get(offset + 1);
-    uint8_t b = buffer.Get(offset + 2);
-    output[i * LPD8806_SLOTS_PER_PIXEL] = 0x80 | (g >> 1);
-    output[i * LPD8806_SLOTS_PER_PIXEL + 1] = 0x80 | (r >> 1);
-    output[i * LPD8806_SLOTS_PER_PIXEL + 2] = 0x80 | (b >> 1);
-  }
+  ConvertPixels(PIXEL_FORMAT_LPD8806, output,
+                PixelData(buffer, m_start_address - 1,
+                          pixels * RGB_SLOTS_PER_PIXEL),
+                pixels);
   m_backend->Commit(m_output_number);
 }
 
 void SPIOutput::CombinedLPD8806Control(const DmxBuffer &buffer) {
   const uint8_t latch_bytes = (m_pixel_count + 31) / 32;
-  unsigned int pixel_data_length = LPD8806_SLOTS_PER_PIXEL;
-
   uint8_t pixel_data[LPD8806_SLOTS_PER_PIXEL];
-  buffer.GetRange(m_start_address - 1, pixel_data, &pixel_data_length);
-  if (pixel_data_length != LPD8806_SLOTS_PER_PIXEL) {
-    OLA_INFO << "Insufficient DMX data, required " << LPD8806_SLOTS_PER_PIXEL
-             << ", got " << pixel_data_length;
+  if (!CombinedPixel(buffer, PIXEL_FORMAT_LPD8806, pixel_data)) {
     return;
   }
 
-  // The leds are GRB format so convert here
-  uint8_t temp = pixel_data[1];
-  pixel_data[1] = pixel_data[0];
-  pixel_data[0] = temp;
-
   const unsigned int length = m_pixel_count * LPD8806_SLOTS_PER_PIXEL;
   uint8_t *output = m_backend->Checkout(m_output_number, length, latch_bytes);
   if (!output)
     return;
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    for (unsigned int j = 0; j < LPD8806_SLOTS_PER_PIXEL; j++) {
-      output[i * LPD8806_SLOTS_PER_PIXEL + j] = 0x80 | (pixel_data[j] >> 1);
-    }
-  }
+  FillPixels(output, pixel_data, LPD8806_SLOTS_PER_PIXEL, m_pixel_count);
   m_backend->Commit(m_output_number);
 }
 
@@ -425,8 +480,8 @@ void SPIOutput::IndividualP9813Control(const DmxBuffer &buffer) {
   // We need 4 bytes of zeros in the beginning and 8 bytes at
   // the end
   const uint8_t latch_bytes = 3 * P9813_SPI_BYTES_PER_PIXEL;
-  const unsigned int first_slot = m_start_address - 1;  // 0 offset
-  if (buffer.Size() - first_slot < P9813_SLOTS_PER_PIXEL) {
+  const unsigned int pixels = PixelsAvailable(buffer);
+  if (!pixels) {
     // not even 3 bytes of data, don't bother updating
     return;
   }
@@ -441,71 +496,42 @@ void SPIOutput::IndividualP9813Control(const DmxBuffer &buffer) {
     return;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    // Convert RGB to P9813 Pixel
-    unsigned int offset = first_slot + i * P9813_SLOTS_PER_PIXEL;
-    // We need to avoid the first 4 bytes of the buffer since that acts as a
-    // start of frame delimiter
-    unsigned int spi_offset = (i + 1) * P9813_SPI_BYTES_PER_PIXEL;
-    uint8_t r = 0;
-    uint8_t b = 0;
-    uint8_t g = 0;
-    if (buffer.Size() - offset >= P9813_SLOTS_PER_PIXEL) {
-      r = buffer.Get(offset);
-      g = buffer.Get(offset + 1);
-      b = buffer.Get(offset + 2);
-    }
-    output[spi_offset] = P9813CreateFlag(r, g, b);
-    output[spi_offset + 1] = b;
-    output[spi_offset + 2] = g;
-    output[spi_offset + 3] = r;
-  }
+  // The first 4 bytes of the buffer act as a start of frame delimiter
+  memset(output, 0, P9813_SPI_BYTES_PER_PIXEL);
+  uint8_t *pixel_output = output + P9813_SPI_BYTES_PER_PIXEL;
+  ConvertPixels(PIXEL_FORMAT_P9813, pixel_output,
+                PixelData(buffer, m_start_address - 1,
+                          pixels * RGB_SLOTS_PER_PIXEL),
+                pixels);
+
+  // Pixels without data are turned off
+  const uint8_t black[RGB_SLOTS_PER_PIXEL] = {0, 0, 0};
+  uint8_t black_pixel[P9813_SPI_BYTES_PER_PIXEL];
+  ConvertPixels(PIXEL_FORMAT_P9813, black_pixel, black, 1);
+  FillPixels(pixel_output + pixels * P9813_SPI_BYTES_PER_PIXEL, black_pixel,
+             P9813_SPI_BYTES_PER_PIXEL, m_pixel_count - pixels);
   m_backend->Commit(m_output_number);
 }
 
 void SPIOutput::CombinedP9813Control(const DmxBuffer &buffer) {
   const uint8_t latch_bytes = 3 * P9813_SPI_BYTES_PER_PIXEL;
-  const unsigned int first_slot = m_start_address - 1;  // 0 offset
-
-  if (buffer.Size() - first_slot < P9813_SLOTS_PER_PIXEL) {
-    OLA_INFO << "Insufficient DMX data, required " << P9813_SLOTS_PER_PIXEL
-             << ", got " << buffer.Size() - first_slot;
+  uint8_t pixel_data[P9813_SPI_BYTES_PER_PIXEL];
+  if (!CombinedPixel(buffer, PIXEL_FORMAT_P9813, pixel_data)) {
     return;
   }
 
-  uint8_t pixel_data[P9813_SPI_BYTES_PER_PIXEL];
-  pixel_data[3] = buffer.Get(first_slot);  // Get Red
-  pixel_data[2] = buffer.Get(first_slot + 1);  // Get Green
-  pixel_data[1] = buffer.Get(first_slot + 2);  // Get Blue
-  pixel_data[0] = P9813CreateFlag(pixel_data[3], pixel_data[2],
-                                  pixel_data[1]);
-
   const unsigned int length = m_pixel_count * P9813_SPI_BYTES_PER_PIXEL;
   uint8_t *output = m_backend->Checkout(m_output_number, length, latch_bytes);
   if (!output) {
     return;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    memcpy(&output[(i + 1) * P9813_SPI_BYTES_PER_PIXEL], pixel_data,
-           P9813_SPI_BYTES_PER_PIXEL);
-  }
+  memset(output, 0, P9813_SPI_BYTES_PER_PIXEL);
+  FillPixels(output + P9813_SPI_BYTES_PER_PIXEL, pixel_data,
+             P9813_SPI_BYTES_PER_PIXEL, m_pixel_count);
   m_backend->Commit(m_output_number);
 }
 
-/**
- * For more information please visit:
- * https://github.com/CoolNeon/elinux-tcl/blob/master/README.txt
- */
-uint8_t SPIOutput::P9813CreateFlag(uint8_t red, uint8_t green, uint8_t blue) {
-  uint8_t flag = 0;
-  flag =  (red & 0xc0) >> 6;
-  flag |= (green & 0xc0) >> 4;
-  flag |= (blue & 0xc0) >> 2;
-  return ~flag;
-}
-
-
 void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
   // some detailed information on the protocol:
   // https://cpldcpu.wordpress.com/2014/11/30/understanding-the-apa102-superled/
@@ -514,13 +540,11 @@ void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
   // LEDFrame: 1 byte FF ; 3 bytes color info (Blue, Green, Red)
   // EndFrame: (n/2)bits; n = pixel_count
 
-  // calculate DMX-start-address
-  const unsigned int first_slot = m_start_address - 1;  // 0 offset
-
   // only do something if at least 1 pixel can be updated..
-  if (buffer.Size() - first_slot < APA102_SLOTS_PER_PIXEL) {
+  const unsigned int pixels = PixelsAvailable(buffer);
+  if (!pixels) {
     OLA_INFO << "Insufficient DMX data, required " << APA102_SLOTS_PER_PIXEL
-             << ", got " << buffer.Size() - first_slot;
+             << ", got " << buffer.Size();
     return;
   }
 
@@ -545,34 +569,18 @@ void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
   if (m_output_number == 0) {
     // set APA102_START_FRAME_BYTES to zero
     memset(output, 0, APA102_START_FRAME_BYTES);
+    output += APA102_START_FRAME_BYTES;
   }
 
-  for (uint16_t i = 0; i < m_pixel_count; i++) {
-    // Convert RGB to APA102 Pixel
-    uint16_t offset = first_slot + (i * APA102_SLOTS_PER_PIXEL);
-
+  ConvertPixels(PIXEL_FORMAT_APA102, output,
+                PixelData(buffer, m_start_address - 1,
+                          pixels * RGB_SLOTS_PER_PIXEL),
+                pixels);
 
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    // only skip APA102_START_FRAME_BYTES on the first port!!
-    if (m_output_number == 0) {
-      // We need to avoid the first 4 bytes of the buffer since that acts as a
-      // start of frame delimiter
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    // set pixel data
-    // first Byte contains:
-    // 3 bits start mark (111) + 5 bits global brightness
-    // set global brightness fixed to 31 --> that reduces flickering
-    // that can be written as 0xE0 & 0x1F
-    output[spi_offset] = 0xFF;
-    // only write pixel data if buffer has complete data for this pixel:
-    if ((buffer.Size() - offset) >= APA102_SLOTS_PER_PIXEL) {
-      // Convert RGB to APA102 Pixel
-      // skip spi_offset + 0 (is already set)
-      output[spi_offset + 1] = buffer.Get(offset + 2);  // blue
-      output[spi_offset + 2] = buffer.Get(offset + 1);  // green
-      output[spi_offset + 3] = buffer.Get(offset);      // red
-    }
+  // The pixels without data keep their color, but still need the brightness
+  // byte.
+  for (unsigned int i = pixels; i < m_pixel_count; i++) {
+    output[i * APA102_SPI_BYTES_PER_PIXEL] = 0xFF;
   }
 
   // write output back
@@ -581,14 +589,8 @@ void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
 
 void SPIOutput::CombinedAPA102Control(const DmxBuffer &buffer) {
   // for Protocol details see IndividualAPA102Control
-
-  // calculate DMX-start-address
-  const uint16_t first_slot = m_start_address - 1;  // 0 offset
-
-  // check if enough data is there.
-  if (buffer.Size() - first_slot < APA102_SLOTS_PER_PIXEL) {
-    OLA_INFO << "Insufficient DMX data, required " << APA102_SLOTS_PER_PIXEL
-             << ", got " << buffer.Size() - first_slot;
+  uint8_t pixel_data[APA102_SPI_BYTES_PER_PIXEL];
+  if (!CombinedPixel(buffer, PIXEL_FORMAT_APA102, pixel_data)) {
     return;
   }
 
@@ -613,24 +615,11 @@ void SPIOutput::CombinedAPA102Control(const DmxBuffer &buffer) {
   if (m_output_number == 0) {
     // set APA102_START_FRAME_BYTES to zero
     memset(output, 0, APA102_START_FRAME_BYTES);
+    output += APA102_START_FRAME_BYTES;
   }
 
-  // create Pixel Data
-  uint8_t pixel_data[APA102_SPI_BYTES_PER_PIXEL];
-  pixel_data[0] = 0xFF;
-  pixel_data[1] = buffer.Get(first_slot + 2);  // Get Blue
-  pixel_data[2] = buffer.Get(first_slot + 1);  // Get Green
-  pixel_data[3] = buffer.Get(first_slot);      // Get Red
-
   // set all pixel to same value
-  for (uint16_t i = 0; i < m_pixel_count; i++) {
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    if (m_output_number == 0) {
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    memcpy(&output[spi_offset], pixel_data,
-           APA102_SPI_BYTES_PER_PIXEL);
-  }
+  FillPixels(output, pixel_data, APA102_SPI_BYTES_PER_PIXEL, m_pixel_count);
 
   // write output back...
   m_backend->Commit(m_output_number);
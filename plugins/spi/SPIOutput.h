@@ -24,6 +24,7 @@
 #include <memory>
 #include <string>
 #include "common/rdm/NetworkManager.h"
+#include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/rdm/RDMControllerInterface.h"
 #include "ola/rdm/UID.h"
@@ -31,6 +32,7 @@
 #include "ola/rdm/ResponderOps.h"
 #include "ola/rdm/ResponderPersonality.h"
 #include "ola/rdm/ResponderSensor.h"
+#include "plugins/spi/PixelFormat.h"
 
 namespace ola {
 namespace plugin {
@@ -42,11 +44,16 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
     std::string device_label;
     uint8_t pixel_count;
     uint8_t output_number;
+    // The gamma & brightness (0 - 255) applied to the pixel values.
+    double gamma;
+    uint8_t brightness;
 
     explicit Options(uint8_t output_number, const std::string &spi_device_name)
         : device_label("SPI Device - " + spi_device_name),
           pixel_count(25),  // For the https://www.adafruit.com/products/738
-          output_number(output_number) {
+          output_number(output_number),
+          gamma(1.0),
+          brightness(255) {
     }
   };
 
@@ -97,6 +104,12 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
   std::string m_device_label;
   uint16_t m_start_address;  // starts from 1
   bool m_identify_mode;
+  // The last frame, with the pixels from any short frames merged into it.
+  DmxBuffer m_last_frame;
+  // The gamma & brightness correction, and space to apply it.
+  bool m_color_correction;
+  uint8_t m_color_table[256];
+  uint8_t m_pixel_data[DMX_UNIVERSE_SIZE];
   std::auto_ptr<ola::rdm::PersonalityCollection> m_personality_collection;
   std::auto_ptr<ola::rdm::PersonalityManager> m_personality_manager;
   ola::rdm::Sensors m_sensors;
@@ -104,6 +117,13 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
 
   // DMX methods
   bool InternalWriteDMX(const DmxBuffer &buffer);
+  const DmxBuffer &HoldPixels(const DmxBuffer &buffer,
+                              unsigned int slots_per_pixel);
+  const uint8_t *PixelData(const DmxBuffer &buffer, unsigned int first_slot,
+                           unsigned int length);
+  bool CombinedPixel(const DmxBuffer &buffer, PixelFormat format,
+                     uint8_t *pixel);
+  unsigned int PixelsAvailable(const DmxBuffer &buffer) const;
 
   void IndividualWS2801Control(const DmxBuffer &buffer);
   void CombinedWS2801Control(const DmxBuffer &buffer);
@@ -172,13 +192,13 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
       const ola::rdm::RDMRequest *request);
 
   // Helpers
-  uint8_t P9813CreateFlag(uint8_t red, uint8_t green, uint8_t blue);
   static uint8_t CalculateAPA102LatchBytes(uint16_t pixel_count);
 
   static const uint8_t SPI_MODE;
   static const uint8_t SPI_BITS_PER_WORD;
   static const uint16_t SPI_DELAY;
   static const uint32_t SPI_SPEED;
+  static const uint16_t RGB_SLOTS_PER_PIXEL;
   static const uint16_t WS2801_SLOTS_PER_PIXEL;
   static const uint16_t LPD8806_SLOTS_PER_PIXEL;
   static const uint16_t P9813_SLOTS_PER_PIXEL;
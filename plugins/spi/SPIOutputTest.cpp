@@ -47,6 +47,7 @@ class SPIOutputTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testCombinedP9813Control);
   CPPUNIT_TEST(testIndividualAPA102Control);
   CPPUNIT_TEST(testCombinedAPA102Control);
+  CPPUNIT_TEST(testColorCorrection);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -65,6 +66,7 @@ class SPIOutputTest: public CppUnit::TestFixture {
   void testCombinedP9813Control();
   void testIndividualAPA102Control();
   void testCombinedAPA102Control();
+  void testColorCorrection();
 
  private:
   UID m_uid;
@@ -738,3 +740,38 @@ void SPIOutputTest::testCombinedAPA102Control() {
   // check if the output writes are 1
   OLA_ASSERT_EQ(1u, backend.Writes(1));
 }
+
+
+/**
+ * Test the gamma & brightness correction.
+ */
+void SPIOutputTest::testColorCorrection() {
+  FakeSPIBackend backend(2);
+  SPIOutput::Options options(0, "Test SPI Device");
+  options.pixel_count = 2;
+  options.brightness = 128;
+  SPIOutput output(m_uid, &backend, options);
+
+  DmxBuffer buffer;
+  unsigned int length = 0;
+  const uint8_t *data = NULL;
+
+  buffer.SetFromString("255,128,0,10,20,30");
+  output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED1[] = { 128, 64, 0, 5, 10, 15 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED1, arraysize(EXPECTED1), data, length);
+
+  // The combined modes correct the single pixel
+  options.brightness = 255;
+  options.gamma = 2.0;
+  SPIOutput gamma_output(m_uid, &backend, options);
+  gamma_output.SetPersonality(8);
+  gamma_output.WriteDMX(buffer);
+  data = backend.GetData(0, &length);
+  const uint8_t EXPECTED2[] = { 0, 0, 0, 0,
+                                0xFF, 0x00, 0x40, 0xFF,
+                                0xFF, 0x00, 0x40, 0xFF,
+                                0};
+  OLA_ASSERT_DATA_EQUALS(EXPECTED2, arraysize(EXPECTED2), data, length);
+}
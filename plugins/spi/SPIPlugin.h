@@ -40,6 +40,9 @@ class SPIPlugin: public ola::Plugin {
   ola_plugin_id Id() const { return OLA_PLUGIN_SPI; }
   std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
  private:
   std::vector<class SPIDevice*> m_devices;
 
@@ -49,8 +52,6 @@ class SPIPlugin: public ola::Plugin {
 
   static const char DEFAULT_BASE_UID[];
   static const char DEFAULT_SPI_DEVICE_PREFIX[];
-  static const char PLUGIN_NAME[];
-  static const char PLUGIN_PREFIX[];
   static const char SPI_BASE_UID_KEY[];
   static const char SPI_DEVICE_PREFIX_KEY[];
 };
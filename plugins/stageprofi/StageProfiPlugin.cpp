@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/file/Util.h"
 #include "ola/stl/STLUtils.h"
 #include "olad/PluginAdaptor.h"
 #include "ola/network/IPV4Address.h"
@@ -118,7 +119,10 @@ void StageProfiPlugin::NewWidget(const std::string &widget_path,
   auto_ptr<StageProfiDevice> device(new StageProfiDevice(
       this,
       new StageProfiWidget(
-          m_plugin_adaptor, descriptor, widget_path,
+          m_plugin_adaptor, m_plugin_adaptor->GetExportMap(), descriptor,
+          widget_path,
+          widget_path.at(0) == ola::file::PATH_SEPARATOR ?
+              StageProfiWidget::USB_BAUD_RATE : 0,
           NewSingleCallback(this, &StageProfiPlugin::DeviceRemoved,
                             widget_path)),
       STAGEPROFI_DEVICE_NAME));
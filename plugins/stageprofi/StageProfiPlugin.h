@@ -46,6 +46,9 @@ class StageProfiPlugin: public Plugin {
   std::string Description() const;
   std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
  private:
   typedef std::map<std::string, StageProfiDevice*> DeviceMap;
 
@@ -63,8 +66,6 @@ class StageProfiPlugin: public Plugin {
 
   static const char STAGEPROFI_DEVICE_PATH[];
   static const char STAGEPROFI_DEVICE_NAME[];
-  static const char PLUGIN_NAME[];
-  static const char PLUGIN_PREFIX[];
   static const char DEVICE_KEY[];
 };
 }  // namespace stageprofi
@@ -27,6 +27,7 @@
 #include <algorithm>
 #include <string>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/util/Utils.h"
@@ -49,17 +50,34 @@ enum stageprofi_packet_type_e {
 
 typedef enum stageprofi_packet_type_e stageprofi_packet_type;
 
+namespace {
+// Slots that haven't changed are skipped, so every slot is resent this often
+// in case the widget missed an update.
+const int64_t FULL_UPDATE_INTERVAL_US = ola::USEC_IN_SECONDS;
+}  // namespace
+
+const char StageProfiWidget::UPDATE_RATE_VAR[] = "stageprofi-update-rate";
+const char StageProfiWidget::DEVICE_KEY[] = "device";
 
 StageProfiWidget::StageProfiWidget(io::SelectServerInterface *ss,
+                                   ExportMap *export_map,
                                    ConnectedDescriptor *descriptor,
                                    const string &widget_path,
+                                   uint32_t baud_rate,
                                    DisconnectCallback *disconnect_cb)
     : m_ss(ss),
       m_descriptor(descriptor),
       m_widget_path(widget_path),
       m_disconnect_cb(disconnect_cb),
       m_timeout_id(INVALID_TIMEOUT),
-      m_got_response(false) {
+      m_got_response(false),
+      m_pacer(baud_rate),
+      m_send_timeout(INVALID_TIMEOUT),
+      m_rate_var(NULL) {
+  if (export_map) {
+    m_rate_var = export_map->GetUIntMapVar(UPDATE_RATE_VAR, DEVICE_KEY);
+    (*m_rate_var)[m_widget_path] = 0;
+  }
   m_descriptor->SetOnData(
       NewCallback<StageProfiWidget>(this, &StageProfiWidget::SocketReady));
   m_ss->AddReadDescriptor(m_descriptor.get());
@@ -74,6 +92,10 @@ StageProfiWidget::~StageProfiWidget() {
     m_ss->RemoveTimeout(m_timeout_id);
   }
 
+  if (m_send_timeout != INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_send_timeout);
+  }
+
   if (m_descriptor.get()) {
     m_ss->RemoveReadDescriptor(m_descriptor.get());
   }
@@ -83,21 +105,94 @@ StageProfiWidget::~StageProfiWidget() {
   }
 }
 
+/*
+ * If the link is still busy with the last frame this is held back until it's
+ * idle, and replaced if another frame arrives first.
+ */
 bool StageProfiWidget::SendDmx(const DmxBuffer &buffer) {
   if (!m_got_response) {
     return false;
   }
 
-  uint16_t index = 0;
-  while (index < buffer.Size()) {
-    unsigned int size = std::min((unsigned int) DMX_MSG_LEN,
-                                 buffer.Size() - index);
-    bool ok = Send255(index, buffer.GetRaw() + index, size);
-    if (!ok) {
+  m_pending = buffer;
+  if (m_send_timeout != INVALID_TIMEOUT) {
+    return true;
+  }
+
+  const TimeInterval wait = m_pacer.TimeUntilIdle(*m_ss->WakeUpTime());
+  if (!wait.IsZero()) {
+    m_send_timeout = m_ss->RegisterSingleTimeout(
+        wait, NewSingleCallback(this, &StageProfiWidget::SendTimeout));
+    return true;
+  }
+  return SendPending();
+}
+
+void StageProfiWidget::SendTimeout() {
+  m_send_timeout = INVALID_TIMEOUT;
+  SendPending();
+}
+
+/*
+ * Send the runs of slots that differ from the last frame sent, or the whole
+ * frame if a full update is due. Runs separated by fewer unchanged slots than
+ * a message header are merged, since that's cheaper than a second message.
+ */
+bool StageProfiWidget::SendPending() {
+  const TimeStamp now = *m_ss->WakeUpTime();
+  const uint8_t *data = m_pending.GetRaw();
+  const unsigned int size = m_pending.Size();
+  const uint8_t *sent = m_sent.GetRaw();
+
+  const bool full_update = (
+      m_sent.Size() != size || !m_last_full_update.IsSet() ||
+      (now - m_last_full_update).AsInt() >= FULL_UPDATE_INTERVAL_US);
+  if (full_update) {
+    m_last_full_update = now;
+  }
+
+  unsigned int bytes_sent = 0;
+  unsigned int index = 0;
+  while (index < size) {
+    if (!full_update) {
+      while (index < size && data[index] == sent[index]) {
+        index++;
+      }
+      if (index == size) {
+        break;
+      }
+    }
+
+    unsigned int end = index + 1;
+    if (full_update) {
+      end = std::min(index + DMX_MSG_LEN, size);
+    } else {
+      unsigned int last_change = index;
+      while (end < size && end - index < DMX_MSG_LEN &&
+             end - last_change <= DMX_HEADER_SIZE) {
+        if (data[end] != sent[end]) {
+          last_change = end;
+        }
+        end++;
+      }
+      end = last_change + 1;
+    }
+
+    if (!Send255(index, data + index, end - index)) {
       OLA_INFO << "Failed to send StageProfi message, closing socket";
       RunDisconnectHandler();
+      return false;
+    }
+    bytes_sent += end - index + DMX_HEADER_SIZE;
+    index = end;
+  }
+
+  m_sent = m_pending;
+  if (bytes_sent) {
+    m_pacer.FrameSent(now, bytes_sent);
+    if (m_rate_var) {
+      (*m_rate_var)[m_widget_path] = m_pacer.FrameRate();
     }
-    index += size;
   }
   return true;
 }
@@ -21,10 +21,13 @@
 #ifndef PLUGINS_STAGEPROFI_STAGEPROFIWIDGET_H_
 #define PLUGINS_STAGEPROFI_STAGEPROFIWIDGET_H_
 
+#include <stdint.h>
 #include <memory>
 #include <string>
+#include "common/io/SerialPacer.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Callback.h"
+#include "ola/ExportMap.h"
 #include "ola/io/Descriptor.h"
 #include "ola/io/SelectServerInterface.h"
 
@@ -39,15 +42,24 @@ class StageProfiWidget {
 
   /**
    * @brief Create a new StageProfiWidget.
+   *
+   * Only the slots which changed are sent, with a full refresh each second.
+   * Frames are held back while the link is still busy with the last one, and
+   * the update rate achieved is exported.
    * @param ss The SelectServer.
+   * @param export_map The ExportMap to use, may be NULL.
    * @param descriptor The descriptor to use for the widget. Ownership is
    *   transferred.
    * @param widget_path the path to the widget.
+   * @param baud_rate the baud rate of the link, or 0 if it's not a serial
+   *   link.
    * @param disconnect_cb Called if the widget is disconnected.
    */
   StageProfiWidget(ola::io::SelectServerInterface *ss,
+                   ExportMap *export_map,
                    ola::io::ConnectedDescriptor *descriptor,
                    const std::string &widget_path,
+                   uint32_t baud_rate,
                    DisconnectCallback *disconnect_cb);
 
   /**
@@ -63,6 +75,11 @@ class StageProfiWidget {
 
   bool SendDmx(const DmxBuffer &buffer);
 
+  /**
+   * @brief The baud rate of the USB widgets.
+   */
+  static const uint32_t USB_BAUD_RATE = 38400;
+
  private:
   enum { DMX_MSG_LEN = 255 };
   enum { DMX_HEADER_SIZE = 4};
@@ -73,12 +90,24 @@ class StageProfiWidget {
   DisconnectCallback *m_disconnect_cb;
   ola::thread::timeout_id m_timeout_id;
   bool m_got_response;
+  // The latest frame, and the frame the widget last received.
+  DmxBuffer m_pending;
+  DmxBuffer m_sent;
+  TimeStamp m_last_full_update;
+  ola::io::SerialPacer m_pacer;
+  ola::thread::timeout_id m_send_timeout;
+  UIntMap *m_rate_var;
 
+  bool SendPending();
+  void SendTimeout();
   void SocketReady();
   void DiscoveryTimeout();
   bool Send255(uint16_t start, const uint8_t *buf, unsigned int len) const;
   void SendQueryPacket();
   void RunDisconnectHandler();
+
+  static const char UPDATE_RATE_VAR[];
+  static const char DEVICE_KEY[];
 };
 }  // namespace stageprofi
 }  // namespace plugin
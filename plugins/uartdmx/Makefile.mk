@@ -13,11 +13,11 @@ plugins/uartdmx/UartDmxPluginDescription.h: plugins/uartdmx/README.md plugins/ua
 plugins_uartdmx_libolauartdmx_la_SOURCES = \
     plugins/uartdmx/UartDmxDevice.cpp \
     plugins/uartdmx/UartDmxDevice.h \
+    plugins/uartdmx/UartDmxOutput.cpp \
+    plugins/uartdmx/UartDmxOutput.h \
     plugins/uartdmx/UartDmxPlugin.cpp \
     plugins/uartdmx/UartDmxPlugin.h \
     plugins/uartdmx/UartDmxPort.h \
-    plugins/uartdmx/UartDmxThread.cpp \
-    plugins/uartdmx/UartDmxThread.h \
     plugins/uartdmx/UartWidget.cpp \
     plugins/uartdmx/UartWidget.h
 plugins_uartdmx_libolauartdmx_la_LIBADD = \
@@ -21,8 +21,10 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/base/Array.h"
 #include "plugins/uartdmx/UartDmxDevice.h"
 #include "plugins/uartdmx/UartDmxPort.h"
 
@@ -31,21 +33,31 @@ namespace plugin {
 namespace uartdmx {
 
 using std::string;
+using std::vector;
 
+const char UartDmxDevice::K_FRAMES_VAR[] = "uartdmx-frames";
+const char UartDmxDevice::K_JITTER_VAR[] = "uartdmx-jitter-us";
+const char UartDmxDevice::K_MAX_JITTER_VAR[] = "uartdmx-max-jitter-us";
 const char UartDmxDevice::K_MALF[] = "-malf";
 const char UartDmxDevice::K_BREAK[] = "-break";
 const unsigned int UartDmxDevice::DEFAULT_BREAK = 100;
 const unsigned int UartDmxDevice::DEFAULT_MALF = 100;
 
+namespace {
+const char PORT_KEY[] = "port";
+}  // namespace
+
 
 UartDmxDevice::UartDmxDevice(AbstractPlugin *owner,
                              class Preferences *preferences,
                              const string &name,
-                             const string &path)
+                             const string &path,
+                             ola::thread::FrameScheduler *scheduler)
     : Device(owner, name),
       m_preferences(preferences),
       m_name(name),
-      m_path(path) {
+      m_path(path),
+      m_scheduler(scheduler) {
   // set up some per-device default configuration if not already set
   SetDefaults();
   // now read per-device configuration
@@ -67,10 +79,42 @@ UartDmxDevice::~UartDmxDevice() {
 }
 
 bool UartDmxDevice::StartHook() {
-  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_breakt, m_malft));
+  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_breakt, m_malft,
+                                m_scheduler));
   return true;
 }
 
+void UartDmxDevice::ExportTimingStats(ExportMap *export_map) const {
+  UIntMap *frames = export_map->GetUIntMapVar(K_FRAMES_VAR, PORT_KEY);
+  UIntMap *jitter = export_map->GetUIntMapVar(K_JITTER_VAR, PORT_KEY);
+  UIntMap *max_jitter = export_map->GetUIntMapVar(K_MAX_JITTER_VAR, PORT_KEY);
+
+  vector<OutputPort*> ports;
+  OutputPorts(&ports);
+  vector<OutputPort*>::const_iterator iter = ports.begin();
+  for (; iter != ports.end(); ++iter) {
+    ola::thread::FrameTimerStats stats;
+    static_cast<UartDmxOutputPort*>(*iter)->GetTimingStats(&stats);
+    const string key = (*iter)->UniqueId();
+    (*frames)[key] = stats.frames;
+    (*jitter)[key] = stats.jitter_us;
+    (*max_jitter)[key] = stats.max_jitter_us;
+  }
+}
+
+void UartDmxDevice::RemoveTimingStats(ExportMap *export_map) const {
+  const char *vars[] = {K_FRAMES_VAR, K_JITTER_VAR, K_MAX_JITTER_VAR};
+  vector<OutputPort*> ports;
+  OutputPorts(&ports);
+  for (unsigned int i = 0; i < arraysize(vars); i++) {
+    UIntMap *var = export_map->GetUIntMapVar(vars[i], PORT_KEY);
+    vector<OutputPort*>::const_iterator iter = ports.begin();
+    for (; iter != ports.end(); ++iter) {
+      var->Remove((*iter)->UniqueId());
+    }
+  }
+}
+
 string UartDmxDevice::DeviceMalfKey() const {
   return m_path + K_MALF;
 }
@@ -25,7 +25,9 @@
 #include <string>
 #include <sstream>
 #include <memory>
+#include "common/thread/FrameScheduler.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
 #include "plugins/uartdmx/UartWidget.h"
@@ -39,12 +41,21 @@ class UartDmxDevice : public Device {
   UartDmxDevice(AbstractPlugin *owner,
                 class Preferences *preferences,
                 const std::string &name,
-                const std::string &path);
+                const std::string &path,
+                ola::thread::FrameScheduler *scheduler);
   ~UartDmxDevice();
 
   std::string DeviceId() const { return m_path; }
   UartWidget* GetWidget() { return m_widget.get(); }
 
+  // Copy the timing statistics of the output thread to the ExportMap.
+  void ExportTimingStats(ExportMap *export_map) const;
+  void RemoveTimingStats(ExportMap *export_map) const;
+
+  static const char K_FRAMES_VAR[];
+  static const char K_JITTER_VAR[];
+  static const char K_MAX_JITTER_VAR[];
+
  protected:
   bool StartHook();
 
@@ -60,6 +71,7 @@ class UartDmxDevice : public Device {
   const std::string m_path;
   unsigned int m_breakt;
   unsigned int m_malft;
+  ola::thread::FrameScheduler *m_scheduler;
 
   static const unsigned int DEFAULT_MALF;
   static const char K_MALF[];
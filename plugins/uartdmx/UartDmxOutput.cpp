@@ -0,0 +1,63 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UartDmxOutput.cpp
+ * The DMX through a UART plugin for ola
+ * Copyright (C) 2011 Rui Barreiros
+ * Copyright (C) 2014 Richard Ash
+ */
+
+#include "plugins/uartdmx/UartDmxOutput.h"
+#include "plugins/uartdmx/UartWidget.h"
+
+namespace ola {
+namespace plugin {
+namespace uartdmx {
+
+UartDmxOutput::UartDmxOutput(UartWidget *widget, unsigned int breakt,
+                             unsigned int malft)
+  : m_widget(widget),
+    m_breakt(breakt),
+    m_malft(malft) {
+  // Setup the widget
+  if (!m_widget->IsOpen())
+    m_widget->SetupOutput();
+}
+
+
+/**
+ * The break, the mark after break, the start code and slots, and then the
+ * mark after last frame.
+ */
+unsigned int UartDmxOutput::FramePeriod(const DmxBuffer &frame) const {
+  return m_breakt + DMX_MAB + (frame.Size() + 1) * DMX_SLOT_TIME + m_malft;
+}
+
+
+/**
+ * Setting the break waits for the previous frame to be sent, so the break
+ * never cuts the end of a frame off.
+ */
+bool UartDmxOutput::SetBreak(bool on) {
+  return m_widget->SetBreak(on);
+}
+
+
+bool UartDmxOutput::WriteFrame(const DmxBuffer &frame) {
+  return m_widget->Write(frame);
+}
+}  // namespace uartdmx
+}  // namespace plugin
+}  // namespace ola
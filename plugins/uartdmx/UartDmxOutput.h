@@ -13,50 +13,51 @@
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  *
- * UartDmxThread.h
+ * UartDmxOutput.h
  * The DMX through a UART plugin for ola
  * Copyright (C) 2011 Rui Barreiros
  * Copyright (C) 2014 Richard Ash
  */
 
-#ifndef PLUGINS_UARTDMX_UARTDMXTHREAD_H_
-#define PLUGINS_UARTDMX_UARTDMXTHREAD_H_
+#ifndef PLUGINS_UARTDMX_UARTDMXOUTPUT_H_
+#define PLUGINS_UARTDMX_UARTDMXOUTPUT_H_
 
+#include "common/thread/FrameScheduler.h"
 #include "ola/DmxBuffer.h"
-#include "ola/thread/Thread.h"
+#include "plugins/uartdmx/UartWidget.h"
 
 namespace ola {
 namespace plugin {
 namespace uartdmx {
 
-class UartDmxThread : public ola::thread::Thread {
+/**
+ * Generates the DMX stream on a UART.
+ *
+ * Each frame is followed by the mark after last frame, once the data has been
+ * sent. The frames are sent by a FrameScheduler, which drives all the UARTs.
+ */
+class UartDmxOutput : public ola::thread::FrameOutput {
  public:
-  UartDmxThread(UartWidget *widget, unsigned int breakt, unsigned int malft);
-  ~UartDmxThread();
+  UartDmxOutput(UartWidget *widget, unsigned int breakt, unsigned int malft);
 
-  bool Stop();
-  void *Run();
-  bool WriteDMX(const DmxBuffer &buffer);
+  unsigned int BreakTime() const { return m_breakt; }
+  unsigned int MarkAfterBreakTime() const { return DMX_MAB; }
+  unsigned int FramePeriod(const DmxBuffer &frame) const;
+  bool SetBreak(bool on);
+  bool WriteFrame(const DmxBuffer &frame);
 
  private:
-  enum TimerGranularity { UNKNOWN, GOOD, BAD };
-
-  TimerGranularity m_granularity;
   UartWidget *m_widget;
-  bool m_term;
   unsigned int m_breakt;
   unsigned int m_malft;
-  DmxBuffer m_buffer;
-  ola::thread::Mutex m_term_mutex;
-  ola::thread::Mutex m_buffer_mutex;
-
-  void CheckTimeGranularity();
 
-  static const uint32_t DMX_MAB = 16;
+  static const unsigned int DMX_MAB = 16;
+  // The time to send one slot at 250kbps, with the start and stop bits.
+  static const unsigned int DMX_SLOT_TIME = 44;
 
-  DISALLOW_COPY_AND_ASSIGN(UartDmxThread);
+  DISALLOW_COPY_AND_ASSIGN(UartDmxOutput);
 };
 }  // namespace uartdmx
 }  // namespace plugin
 }  // namespace ola
-#endif  // PLUGINS_UARTDMX_UARTDMXTHREAD_H_
+#endif  // PLUGINS_UARTDMX_UARTDMXOUTPUT_H_
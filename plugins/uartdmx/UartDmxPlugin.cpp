@@ -26,6 +26,8 @@
 #include <string>
 #include <vector>
 
+#include "ola/Callback.h"
+#include "ola/ExportMap.h"
 #include "ola/StringUtils.h"
 #include "ola/io/IOUtils.h"
 #include "olad/Preferences.h"
@@ -55,6 +57,12 @@ bool UartDmxPlugin::StartHook() {
   vector<string> devices = m_preferences->GetMultipleValue(K_DEVICE);
   vector<string>::const_iterator iter;  // iterate over devices
 
+  m_scheduler.reset(new ola::thread::FrameScheduler());
+  if (!m_scheduler->Start()) {
+    m_scheduler.reset();
+    return false;
+  }
+
   // start counting device ids from 0
 
   for (iter = devices.begin(); iter != devices.end(); ++iter) {
@@ -75,7 +83,7 @@ bool UartDmxPlugin::StartHook() {
     // can open device, so shut the temporary file descriptor
     close(fd);
     std::auto_ptr<UartDmxDevice> device(new UartDmxDevice(
-        this, m_preferences, PLUGIN_NAME, *iter));
+        this, m_preferences, PLUGIN_NAME, *iter, m_scheduler.get()));
 
     // got a device, now lets see if we can configure it before we announce
     // it to the world
@@ -94,6 +102,24 @@ bool UartDmxPlugin::StartHook() {
     m_plugin_adaptor->RegisterDevice(device.get());
     m_devices.push_back(device.release());
   }
+
+  if (m_plugin_adaptor->GetExportMap()) {
+    m_stats_timeout = m_plugin_adaptor->RegisterRepeatingTimeout(
+        STATS_INTERVAL_MS,
+        NewCallback(this, &UartDmxPlugin::ExportTimingStats));
+  }
+  return true;
+}
+
+
+/**
+ * Copy the timing statistics from the output threads to the ExportMap.
+ */
+bool UartDmxPlugin::ExportTimingStats() {
+  UartDeviceVector::iterator iter = m_devices.begin();
+  for (; iter != m_devices.end(); ++iter) {
+    (*iter)->ExportTimingStats(m_plugin_adaptor->GetExportMap());
+  }
   return true;
 }
 
@@ -101,13 +127,27 @@ bool UartDmxPlugin::StartHook() {
  * Stop all the devices.
  */
 bool UartDmxPlugin::StopHook() {
+  if (m_stats_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_plugin_adaptor->RemoveTimeout(m_stats_timeout);
+    m_stats_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  ExportMap *export_map = m_plugin_adaptor->GetExportMap();
   UartDeviceVector::iterator iter;
   for (iter = m_devices.begin(); iter != m_devices.end(); ++iter) {
+    if (export_map) {
+      (*iter)->RemoveTimingStats(export_map);
+    }
     m_plugin_adaptor->UnregisterDevice(*iter);
     (*iter)->Stop();
     delete *iter;
   }
   m_devices.clear();
+
+  if (m_scheduler.get()) {
+    m_scheduler->Stop();
+    m_scheduler.reset();
+  }
   return true;
 }
 
@@ -23,11 +23,14 @@
 #define PLUGINS_UARTDMX_UARTDMXPLUGIN_H_
 
 #include <set>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "common/thread/FrameScheduler.h"
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
+#include "ola/thread/SchedulerInterface.h"
 
 #include "plugins/uartdmx/UartDmxDevice.h"
 
@@ -38,7 +41,8 @@ namespace uartdmx {
 class UartDmxPlugin : public Plugin {
  public:
   explicit UartDmxPlugin(ola::PluginAdaptor *plugin_adaptor)
-      : Plugin(plugin_adaptor) {
+      : Plugin(plugin_adaptor),
+        m_stats_timeout(ola::thread::INVALID_TIMEOUT) {
   }
 
   ola_plugin_id Id() const { return OLA_PLUGIN_UARTDMX; }
@@ -49,21 +53,27 @@ class UartDmxPlugin : public Plugin {
 
   std::string Description() const;
 
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
  private:
   typedef std::vector<UartDmxDevice*> UartDeviceVector;
   UartDeviceVector m_devices;
+  // Generates the DMX frames for all the ports.
+  std::auto_ptr<ola::thread::FrameScheduler> m_scheduler;
+  ola::thread::timeout_id m_stats_timeout;
 
   void AddDevice(UartDmxDevice *device);
+  bool ExportTimingStats();
   bool StartHook();
   bool StopHook();
   bool SetDefaultPreferences();
   unsigned int GetBreak();
   unsigned int GetMalf();
 
-  static const char PLUGIN_NAME[];
-  static const char PLUGIN_PREFIX[];
   static const char K_DEVICE[];
   static const char DEFAULT_DEVICE[];
+  static const unsigned int STATS_INTERVAL_MS = 1000;
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxPlugin);
 };
@@ -24,12 +24,13 @@
 
 #include <string>
 
+#include "common/thread/FrameScheduler.h"
 #include "ola/DmxBuffer.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/uartdmx/UartDmxDevice.h"
 #include "plugins/uartdmx/UartWidget.h"
-#include "plugins/uartdmx/UartDmxThread.h"
+#include "plugins/uartdmx/UartDmxOutput.h"
 
 namespace ola {
 namespace plugin {
@@ -41,23 +42,31 @@ class UartDmxOutputPort : public ola::BasicOutputPort {
                     unsigned int id,
                     UartWidget *widget,
                     unsigned int breakt,
-                    unsigned int malft)
+                    unsigned int malft,
+                    ola::thread::FrameScheduler *scheduler)
       : BasicOutputPort(parent, id),
         m_widget(widget),
-        m_thread(widget, breakt, malft) {
-    m_thread.Start();
+        m_output(widget, breakt, malft),
+        m_scheduler(scheduler) {
+    m_scheduler->AddOutput(&m_output);
   }
-  ~UartDmxOutputPort() { m_thread.Stop(); }
+  ~UartDmxOutputPort() { m_scheduler->RemoveOutput(&m_output); }
 
   bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t) {
-    return m_thread.WriteDMX(buffer);
+    m_output.SetFrame(buffer);
+    return true;
   }
 
   std::string Description() const { return m_widget->Description(); }
 
+  void GetTimingStats(ola::thread::FrameTimerStats *stats) const {
+    m_output.GetStats(stats);
+  }
+
  private:
   UartWidget *m_widget;
-  UartDmxThread m_thread;
+  UartDmxOutput m_output;
+  ola::thread::FrameScheduler *m_scheduler;
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxOutputPort);
 };
@@ -112,6 +112,8 @@ class AsynchronousAVLdiyD512 : public AVLdiyD512 {
 
   bool SendDMX(const DmxBuffer &buffer);
 
+  bool GetTransferStats(UsbTransferStats *stats) const;
+
  private:
   std::auto_ptr<class AVLdiyAsyncUsbSender> m_sender;
 
@@ -38,6 +38,11 @@ const char AVLdiyD512Factory::EXPECTED_PRODUCT[] = "D512";
 const uint16_t AVLdiyD512Factory::PRODUCT_ID = 0x8888;
 const uint16_t AVLdiyD512Factory::VENDOR_ID = 0x03EB;
 
+bool AVLdiyD512Factory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, PRODUCT_ID));
+  return true;
+}
+
 bool AVLdiyD512Factory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
@@ -119,13 +119,11 @@ class AnymaAsyncUsbSender : public AsyncUsbSender {
  public:
   AnymaAsyncUsbSender(LibUsbAdaptor *adaptor, libusb_device *usb_device)
       : AsyncUsbSender(adaptor, usb_device) {
-    m_control_setup_buffer =
-        new uint8_t[LIBUSB_CONTROL_SETUP_SIZE + DMX_UNIVERSE_SIZE];
+    EnablePipelining(LIBUSB_CONTROL_SETUP_SIZE + DMX_UNIVERSE_SIZE);
   }
 
   ~AnymaAsyncUsbSender() {
     CancelTransfer();
-    delete[] m_control_setup_buffer;
   }
 
   libusb_device_handle* SetupHandle() {
@@ -135,9 +133,11 @@ class AnymaAsyncUsbSender : public AsyncUsbSender {
     return ok ? usb_handle : NULL;
   }
 
-  bool PerformTransfer(const DmxBuffer &buffer) {
+  void FillPipelinedTransfer(const DmxBuffer &buffer,
+                             struct libusb_transfer *transfer,
+                             uint8_t *frame) {
     m_adaptor->FillControlSetup(
-        m_control_setup_buffer,
+        frame,
         LIBUSB_REQUEST_TYPE_VENDOR | LIBUSB_RECIPIENT_DEVICE |
         LIBUSB_ENDPOINT_OUT,  // bmRequestType
         UDMX_SET_CHANNEL_RANGE,  // bRequest
@@ -146,15 +146,12 @@ class AnymaAsyncUsbSender : public AsyncUsbSender {
         buffer.Size());  // wLength
 
     unsigned int length = DMX_UNIVERSE_SIZE;
-    buffer.Get(m_control_setup_buffer + LIBUSB_CONTROL_SETUP_SIZE, &length);
+    buffer.Get(frame + LIBUSB_CONTROL_SETUP_SIZE, &length);
 
-    FillControlTransfer(m_control_setup_buffer, URB_TIMEOUT_MS);
-    return (SubmitTransfer() == 0);
+    FillControlTransfer(transfer, frame, URB_TIMEOUT_MS);
   }
 
  private:
-  uint8_t *m_control_setup_buffer;
-
   DISALLOW_COPY_AND_ASSIGN(AnymaAsyncUsbSender);
 };
 
@@ -176,6 +173,11 @@ bool AsynchronousAnymauDMX::Init() {
 bool AsynchronousAnymauDMX::SendDMX(const DmxBuffer &buffer) {
   return m_sender->SendDMX(buffer);
 }
+
+bool AsynchronousAnymauDMX::GetTransferStats(UsbTransferStats *stats) const {
+  m_sender->GetTransferStats(stats);
+  return true;
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
@@ -112,6 +112,8 @@ class AsynchronousAnymauDMX : public AnymauDMX {
 
   bool SendDMX(const DmxBuffer &buffer);
 
+  bool GetTransferStats(UsbTransferStats *stats) const;
+
  private:
   std::auto_ptr<class AnymaAsyncUsbSender> m_sender;
 
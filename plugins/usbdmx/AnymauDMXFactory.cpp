@@ -38,6 +38,11 @@ const char AnymauDMXFactory::EXPECTED_PRODUCT[] = "uDMX";
 const uint16_t AnymauDMXFactory::PRODUCT_ID = 0x05DC;
 const uint16_t AnymauDMXFactory::VENDOR_ID = 0x16C0;
 
+bool AnymauDMXFactory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, PRODUCT_ID));
+  return true;
+}
+
 bool AnymauDMXFactory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
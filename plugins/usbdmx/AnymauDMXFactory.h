@@ -45,6 +45,8 @@ class AnymauDMXFactory : public BaseWidgetFactory<class AnymauDMX> {
       libusb_device *usb_device,
       const struct libusb_device_descriptor &descriptor);
 
+  bool GetProductIds(ProductIds *ids) const;
+
  private:
   bool m_missing_serial_number;
   ola::usb::LibUsbAdaptor *m_adaptor;
@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <libusb.h>
 
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "ola/stl/STLUtils.h"
@@ -67,6 +68,26 @@ using ola::usb::USBDeviceID;
 using ola::NewSingleCallback;
 using std::auto_ptr;
 using ola::thread::Future;
+using std::string;
+
+const char AsyncPluginImpl::K_FRAMES_PER_SECOND_VAR[] =
+    "usbdmx-frames-per-second";
+const char AsyncPluginImpl::K_TRANSFER_LATENCY_VAR[] =
+    "usbdmx-transfer-latency-us";
+
+namespace {
+const char DEVICE_KEY[] = "device";
+
+// Ja Rule widgets don't implement WidgetInterface, so they never have
+// transfer counters.
+WidgetInterface *StatsWidget(WidgetInterface *widget) {
+  return widget;
+}
+
+WidgetInterface *StatsWidget(JaRuleWidget*) {
+  return NULL;
+}
+}  // namespace
 
 class DeviceState {
  public:
@@ -101,7 +122,8 @@ AsyncPluginImpl::AsyncPluginImpl(PluginAdaptor *plugin_adaptor,
       m_debug_level(debug_level),
       m_preferences(preferences),
       m_widget_observer(this, plugin_adaptor),
-      m_usb_adaptor(NULL) {
+      m_usb_adaptor(NULL),
+      m_stats_timeout(ola::thread::INVALID_TIMEOUT) {
 }
 
 AsyncPluginImpl::~AsyncPluginImpl() {
@@ -135,13 +157,24 @@ bool AsyncPluginImpl::Start() {
   m_widget_factories.push_back(new SunliteFactory(m_usb_adaptor));
   m_widget_factories.push_back(new VellemanK8062Factory(m_usb_adaptor));
 
+  WidgetFactories::iterator iter = m_widget_factories.begin();
+  for (; iter != m_widget_factories.end(); ++iter) {
+    m_factory_index.AddFactory(*iter);
+  }
+
   // If we're using hotplug, this starts the hotplug thread.
   if (!agent->Start()) {
+    m_factory_index.Clear();
     STLDeleteElements(&m_widget_factories);
     return false;
   }
 
   m_agent.reset(agent.release());
+
+  m_last_stats_time = *m_plugin_adaptor->WakeUpTime();
+  m_stats_timeout = m_plugin_adaptor->RegisterRepeatingTimeout(
+      STATS_INTERVAL_MS,
+      NewCallback(this, &AsyncPluginImpl::UpdateTransferStats));
   return true;
 }
 
@@ -152,11 +185,17 @@ bool AsyncPluginImpl::Stop() {
 
   m_agent->HaltNotifications();
 
+  if (m_stats_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_plugin_adaptor->RemoveTimeout(m_stats_timeout);
+    m_stats_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
   // Now we're free to use m_device_map.
   USBDeviceMap::iterator iter = m_device_map.begin();
   for (; iter != m_device_map.end(); ++iter) {
     DeviceState *state = iter->second;
     if (state->ola_device) {
+      RemoveTransferStats(state->ola_device);
       m_plugin_adaptor->UnregisterDevice(state->ola_device);
       state->ola_device->Stop();
       delete state->ola_device;
@@ -164,6 +203,7 @@ bool AsyncPluginImpl::Stop() {
     state->DeleteWidget();
   }
   STLDeleteValues(&m_device_map);
+  m_factory_index.Clear();
   STLDeleteElements(&m_widget_factories);
   m_agent->Stop();
   m_agent.reset();
@@ -304,8 +344,11 @@ void AsyncPluginImpl::SetupUSBDevice(libusb_device *usb_device) {
             << strings::ToHex(descriptor.idVendor) << ", product "
             << strings::ToHex(descriptor.idProduct);
 
-  WidgetFactories::iterator factory_iter = m_widget_factories.begin();
-  for (; factory_iter != m_widget_factories.end(); ++factory_iter) {
+  WidgetFactories factories;
+  m_factory_index.GetFactories(descriptor.idVendor, descriptor.idProduct,
+                               &factories);
+  WidgetFactories::iterator factory_iter = factories.begin();
+  for (; factory_iter != factories.end(); ++factory_iter) {
     if ((*factory_iter)->DeviceAdded(&m_widget_observer, usb_device,
                                      descriptor)) {
       OLA_INFO << "Device " << device_id << " claimed by "
@@ -334,6 +377,7 @@ bool AsyncPluginImpl::StartAndRegisterDevice(Widget *widget, Device *device) {
 
   if (state->ola_device) {
     OLA_WARN << "Clobbering an old device!";
+    RemoveTransferStats(state->ola_device);
     m_plugin_adaptor->UnregisterDevice(state->ola_device);
     state->ola_device->Stop();
     delete state->ola_device;
@@ -348,6 +392,7 @@ bool AsyncPluginImpl::StartAndRegisterDevice(Widget *widget, Device *device) {
   m_plugin_adaptor->RegisterDevice(device);
   state->ola_device = device;
   state->SetDeleteCallback(ola::DeletePointerCallback(widget));
+  AddTransferStats(StatsWidget(widget), device);
   return true;
 }
 
@@ -358,6 +403,7 @@ bool AsyncPluginImpl::StartAndRegisterDevice(Widget *widget, Device *device) {
  * This is run within the main thread.
  */
 void AsyncPluginImpl::ShutdownDevice(Device *device, Future<void> *f) {
+  RemoveTransferStats(device);
   m_plugin_adaptor->UnregisterDevice(device);
   device->Stop();
   delete device;
@@ -365,6 +411,76 @@ void AsyncPluginImpl::ShutdownDevice(Device *device, Future<void> *f) {
     f->Set();
   }
 }
+
+/*
+ * @brief Start sampling the transfer counters for a widget, if it has them.
+ *
+ * This is run within the main thread.
+ */
+void AsyncPluginImpl::AddTransferStats(WidgetInterface *widget,
+                                       Device *device) {
+  UsbTransferStats stats;
+  if (!widget || !widget->GetTransferStats(&stats)) {
+    return;
+  }
+  TransferStatsState &state = m_transfer_stats[device->UniqueId()];
+  state.widget = widget;
+  state.last = stats;
+}
+
+/*
+ * @brief Stop sampling the transfer counters for a device.
+ *
+ * This is run within the main thread, before the widget is deleted.
+ */
+void AsyncPluginImpl::RemoveTransferStats(Device *device) {
+  const string id = device->UniqueId();
+  if (!m_transfer_stats.erase(id)) {
+    return;
+  }
+
+  ExportMap *export_map = m_plugin_adaptor->GetExportMap();
+  if (export_map) {
+    export_map->GetUIntMapVar(K_FRAMES_PER_SECOND_VAR, DEVICE_KEY)->Remove(id);
+    export_map->GetUIntMapVar(K_TRANSFER_LATENCY_VAR, DEVICE_KEY)->Remove(id);
+  }
+}
+
+/*
+ * @brief Export the frame rate and the mean transfer latency of each widget
+ * since the last sample.
+ *
+ * This is run within the main thread.
+ */
+bool AsyncPluginImpl::UpdateTransferStats() {
+  const TimeStamp now = *m_plugin_adaptor->WakeUpTime();
+  const int64_t elapsed_ms = (now - m_last_stats_time).InMilliSeconds();
+  m_last_stats_time = now;
+
+  ExportMap *export_map = m_plugin_adaptor->GetExportMap();
+  if (!export_map || elapsed_ms <= 0) {
+    return true;
+  }
+  UIntMap *fps_var = export_map->GetUIntMapVar(K_FRAMES_PER_SECOND_VAR,
+                                               DEVICE_KEY);
+  UIntMap *latency_var = export_map->GetUIntMapVar(K_TRANSFER_LATENCY_VAR,
+                                                   DEVICE_KEY);
+
+  TransferStatsMap::iterator iter = m_transfer_stats.begin();
+  for (; iter != m_transfer_stats.end(); ++iter) {
+    TransferStatsState &state = iter->second;
+    UsbTransferStats stats;
+    state.widget->GetTransferStats(&stats);
+
+    const unsigned int frames = stats.frames - state.last.frames;
+    (*fps_var)[iter->first] = static_cast<unsigned int>(
+        (frames * 1000 + elapsed_ms / 2) / elapsed_ms);
+    (*latency_var)[iter->first] = frames ? static_cast<unsigned int>(
+        (stats.latency_us - state.last.latency_us) / frames) : 0;
+    state.last = stats;
+  }
+  return true;
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
@@ -36,12 +36,16 @@
 #include "libs/usb/Types.h"
 #include "libs/usb/HotplugAgent.h"
 
+#include "ola/Clock.h"
 #include "ola/base/Macro.h"
 #include "ola/thread/Future.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "olad/Preferences.h"
 #include "plugins/usbdmx/PluginImplInterface.h"
 #include "plugins/usbdmx/SyncronizedWidgetObserver.h"
+#include "plugins/usbdmx/Widget.h"
 #include "plugins/usbdmx/WidgetFactory.h"
+#include "plugins/usbdmx/WidgetFactoryIndex.h"
 
 namespace ola {
 namespace usb {
@@ -89,10 +93,22 @@ class AsyncPluginImpl: public PluginImplInterface, public WidgetObserver {
   bool NewWidget(class Sunlite *widget);
   bool NewWidget(class VellemanK8062 *widget);
 
+  static const char K_FRAMES_PER_SECOND_VAR[];
+  static const char K_TRANSFER_LATENCY_VAR[];
+
  private:
   typedef std::vector<class WidgetFactory*> WidgetFactories;
   typedef std::map<ola::usb::USBDeviceID, class DeviceState*> USBDeviceMap;
 
+  // The widgets that keep transfer counters, and the counters when they were
+  // last sampled.
+  struct TransferStatsState {
+    WidgetInterface *widget;
+    UsbTransferStats last;
+  };
+  // Keyed by the unique id of the OLA device. Only used in the main thread.
+  typedef std::map<std::string, TransferStatsState> TransferStatsMap;
+
   PluginAdaptor* const m_plugin_adaptor;
   Plugin* const m_plugin;
   const unsigned int m_debug_level;
@@ -102,7 +118,11 @@ class AsyncPluginImpl: public PluginImplInterface, public WidgetObserver {
   SyncronizedWidgetObserver m_widget_observer;
   ola::usb::AsyncronousLibUsbAdaptor *m_usb_adaptor;  // not owned
   WidgetFactories m_widget_factories;
+  WidgetFactoryIndex m_factory_index;
   USBDeviceMap m_device_map;
+  TransferStatsMap m_transfer_stats;
+  ola::thread::timeout_id m_stats_timeout;
+  TimeStamp m_last_stats_time;
 
   void DeviceEvent(ola::usb::HotplugAgent::EventType event,
                    struct libusb_device *device);
@@ -113,6 +133,12 @@ class AsyncPluginImpl: public PluginImplInterface, public WidgetObserver {
 
   void ShutdownDevice(Device *device, ola::thread::Future<void> *f);
 
+  void AddTransferStats(WidgetInterface *widget, Device *device);
+  void RemoveTransferStats(Device *device);
+  bool UpdateTransferStats();
+
+  static const unsigned int STATS_INTERVAL_MS = 1000;
+
   DISALLOW_COPY_AND_ASSIGN(AsyncPluginImpl);
 };
 }  // namespace usbdmx
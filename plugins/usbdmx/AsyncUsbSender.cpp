@@ -20,22 +20,36 @@
 
 #include "plugins/usbdmx/AsyncUsbSender.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/Logging.h"
+#include "ola/base/Flags.h"
+
+DECLARE_uint8(usb_transfer_depth);
 
 namespace ola {
 namespace plugin {
 namespace usbdmx {
 
 using ola::usb::LibUsbAdaptor;
+using std::vector;
 
 AsyncUsbSender::AsyncUsbSender(LibUsbAdaptor *adaptor,
                                libusb_device *usb_device)
     : AsyncUsbTransceiverBase(adaptor, usb_device),
-      m_pending_tx(false) {
+      m_pending_tx(false),
+      m_in_flight(0) {
 }
 
 AsyncUsbSender::~AsyncUsbSender() {
+  CancelTransfer();
+  vector<PooledTransfer>::iterator iter = m_pool.begin();
+  for (; iter != m_pool.end(); ++iter) {
+    m_adaptor->FreeTransfer(iter->transfer);
+    delete[] iter->frame;
+  }
   m_adaptor->Close(m_usb_handle);
 }
 
@@ -45,7 +59,19 @@ bool AsyncUsbSender::SendDMX(const DmxBuffer &buffer) {
     return false;
   }
   ola::thread::MutexLocker locker(&m_mutex);
-  if (m_transfer_state == IDLE) {
+  if (!m_pool.empty()) {
+    PooledTransfer *pooled = NULL;
+    if (m_transfer_state != DISCONNECTED) {
+      pooled = FreePooledTransfer();
+    }
+    if (pooled) {
+      SubmitPooledTransfer(pooled, buffer);
+    } else {
+      // All the transfers are in flight, only the latest frame is kept.
+      m_pending_tx = true;
+      m_tx_buffer.Set(buffer);
+    }
+  } else if (m_transfer_state == IDLE) {
     PerformTransfer(buffer);
   } else {
     // Buffer incoming data so we can send it when the outstanding transfers
@@ -57,6 +83,11 @@ bool AsyncUsbSender::SendDMX(const DmxBuffer &buffer) {
 }
 
 void AsyncUsbSender::TransferComplete(struct libusb_transfer *transfer) {
+  if (!m_pool.empty()) {
+    PooledTransferComplete(transfer);
+    return;
+  }
+
   if (transfer != m_transfer) {
     OLA_WARN << "Mismatched libusb transfer: " << transfer << " != "
              << m_transfer;
@@ -83,6 +114,132 @@ void AsyncUsbSender::TransferComplete(struct libusb_transfer *transfer) {
     PerformTransfer(m_tx_buffer);
   }
 }
+
+void AsyncUsbSender::GetTransferStats(UsbTransferStats *stats) {
+  ola::thread::MutexLocker locker(&m_mutex);
+  *stats = m_stats;
+}
+
+void AsyncUsbSender::EnablePipelining(unsigned int frame_size) {
+  const unsigned int depth = std::min(
+      std::max(static_cast<unsigned int>(FLAGS_usb_transfer_depth), 1u),
+      MAX_TRANSFER_DEPTH);
+  for (unsigned int i = 0; i < depth; i++) {
+    PooledTransfer pooled;
+    pooled.transfer = m_adaptor->AllocTransfer(0);
+    pooled.frame = new uint8_t[frame_size]();
+    pooled.in_flight = false;
+    m_pool.push_back(pooled);
+  }
+}
+
+void AsyncUsbSender::CancelTransfer() {
+  if (m_pool.empty()) {
+    AsyncUsbTransceiverBase::CancelTransfer();
+    return;
+  }
+
+  {
+    ola::thread::MutexLocker locker(&m_mutex);
+    m_suppress_continuation = true;
+    m_pending_tx = false;
+    vector<PooledTransfer>::iterator iter = m_pool.begin();
+    for (; iter != m_pool.end(); ++iter) {
+      if (iter->in_flight) {
+        m_adaptor->CancelTransfer(iter->transfer);
+      }
+    }
+  }
+
+  // The callbacks for cancelled transfers still run, wait for all of them.
+  while (1) {
+    ola::thread::MutexLocker locker(&m_mutex);
+    if (m_in_flight == 0) {
+      break;
+    }
+  }
+  m_suppress_continuation = false;
+}
+
+AsyncUsbSender::PooledTransfer *AsyncUsbSender::FindPooledTransfer(
+    struct libusb_transfer *transfer) {
+  vector<PooledTransfer>::iterator iter = m_pool.begin();
+  for (; iter != m_pool.end(); ++iter) {
+    if (iter->transfer == transfer) {
+      return &(*iter);
+    }
+  }
+  return NULL;
+}
+
+AsyncUsbSender::PooledTransfer *AsyncUsbSender::FreePooledTransfer() {
+  vector<PooledTransfer>::iterator iter = m_pool.begin();
+  for (; iter != m_pool.end(); ++iter) {
+    if (!iter->in_flight) {
+      return &(*iter);
+    }
+  }
+  return NULL;
+}
+
+bool AsyncUsbSender::SubmitPooledTransfer(PooledTransfer *pooled,
+                                          const DmxBuffer &buffer) {
+  FillPipelinedTransfer(buffer, pooled->transfer, pooled->frame);
+  int ret = m_adaptor->SubmitTransfer(pooled->transfer);
+  if (ret) {
+    OLA_WARN << "libusb_submit_transfer returned "
+             << m_adaptor->ErrorCodeToString(ret);
+    if (ret == LIBUSB_ERROR_NO_DEVICE) {
+      m_transfer_state = DISCONNECTED;
+    }
+    return false;
+  }
+  m_clock.CurrentTime(&pooled->submitted);
+  pooled->in_flight = true;
+  m_in_flight++;
+  m_transfer_state = IN_PROGRESS;
+  return true;
+}
+
+void AsyncUsbSender::PooledTransferComplete(
+    struct libusb_transfer *transfer) {
+  PooledTransfer *pooled = FindPooledTransfer(transfer);
+  if (!pooled) {
+    OLA_WARN << "Unknown libusb transfer: " << transfer;
+    return;
+  }
+
+  if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
+    OLA_WARN << "Transfer returned "
+             << m_adaptor->ErrorCodeToString(transfer->status);
+  }
+
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+
+  ola::thread::MutexLocker locker(&m_mutex);
+  pooled->in_flight = false;
+  m_in_flight--;
+  if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+    m_stats.frames++;
+    m_stats.latency_us += (now - pooled->submitted).AsInt();
+  }
+
+  if (transfer->status == LIBUSB_TRANSFER_NO_DEVICE) {
+    m_transfer_state = DISCONNECTED;
+  } else if (m_transfer_state != DISCONNECTED && m_in_flight == 0) {
+    m_transfer_state = IDLE;
+  }
+
+  if (m_suppress_continuation) {
+    return;
+  }
+
+  if ((m_transfer_state != DISCONNECTED) && m_pending_tx) {
+    m_pending_tx = false;
+    SubmitPooledTransfer(pooled, m_tx_buffer);
+  }
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
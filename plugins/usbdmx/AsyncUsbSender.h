@@ -22,12 +22,17 @@
 #define PLUGINS_USBDMX_ASYNCUSBSENDER_H_
 
 #include <libusb.h>
+#include <stdint.h>
+
+#include <vector>
 
 #include "AsyncUsbTransceiverBase.h"
 #include "libs/usb/LibUsbAdaptor.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/base/Macro.h"
 #include "ola/thread/Mutex.h"
+#include "plugins/usbdmx/Widget.h"
 
 namespace ola {
 namespace plugin {
@@ -38,6 +43,12 @@ namespace usbdmx {
  *
  * This encapsulates much of the asynchronous libusb logic. Subclasses should
  * implement the SetupHandle() and PerformTransfer() methods.
+ *
+ * Widgets that take a whole DMX frame in a single transfer can instead call
+ * EnablePipelining() and implement FillPipelinedTransfer(). Then up to
+ * --usb-transfer-depth transfers are kept in flight, each with its own frame
+ * buffer. If all the transfers are in flight, only the latest DMX frame is
+ * kept and it's sent as soon as a transfer completes.
  */
 class AsyncUsbSender: public AsyncUsbTransceiverBase {
  public:
@@ -68,17 +79,57 @@ class AsyncUsbSender: public AsyncUsbTransceiverBase {
    */
   void TransferComplete(struct libusb_transfer *transfer);
 
+  /**
+   * @brief Get the counters for the frames sent.
+   * @param stats filled in with the counters.
+   */
+  void GetTransferStats(UsbTransferStats *stats);
+
  protected:
   /**
    * @brief Perform the DMX transfer.
    * @param buffer the DMX buffer to send.
    * @returns true if the transfer was scheduled, false otherwise.
    *
-   * This method is implemented by the subclass. The subclass should call
-   * FillControlTransfer() / FillBulkTransfer() as appropriate and then call
-   * SubmitTransfer().
+   * This method is implemented by the subclass, unless it uses
+   * EnablePipelining(). The subclass should call FillControlTransfer() /
+   * FillBulkTransfer() as appropriate and then call SubmitTransfer().
+   */
+  virtual bool PerformTransfer(const DmxBuffer &buffer) {
+    (void) buffer;
+    return false;
+  }
+
+  /**
+   * @brief Use a pool of transfers rather than the single m_transfer.
+   * @param frame_size the size of the frame buffer for each transfer.
+   *
+   * This must be called from the subclass constructor.
+   */
+  void EnablePipelining(unsigned int frame_size);
+
+  /**
+   * @brief Fill one of the pooled transfers with a DMX frame.
+   * @param buffer the DMX buffer to send.
+   * @param transfer the transfer to fill.
+   * @param frame the frame buffer for the transfer.
+   *
+   * This is implemented by subclasses that call EnablePipelining(). The
+   * subclass should call FillControlTransfer() / FillBulkTransfer() with the
+   * transfer, but not submit it.
+   */
+  virtual void FillPipelinedTransfer(const DmxBuffer &buffer,
+                                     struct libusb_transfer *transfer,
+                                     uint8_t *frame) {
+    (void) buffer;
+    (void) transfer;
+    (void) frame;
+  }
+
+  /**
+   * @brief Cancel any pending transfers, including the pooled ones.
    */
-  virtual bool PerformTransfer(const DmxBuffer &buffer) = 0;
+  void CancelTransfer();
 
   /**
    * @brief Called when the transfer completes.
@@ -95,8 +146,26 @@ class AsyncUsbSender: public AsyncUsbTransceiverBase {
   bool TransferPending() const { return m_pending_tx; }
 
  private:
+  struct PooledTransfer {
+    struct libusb_transfer *transfer;
+    uint8_t *frame;
+    bool in_flight;
+    TimeStamp submitted;
+  };
+
   DmxBuffer m_tx_buffer;  // GUARDED_BY(m_mutex);
   bool m_pending_tx;  // GUARDED_BY(m_mutex);
+  std::vector<PooledTransfer> m_pool;
+  unsigned int m_in_flight;  // GUARDED_BY(m_mutex);
+  UsbTransferStats m_stats;  // GUARDED_BY(m_mutex);
+  ola::Clock m_clock;
+
+  PooledTransfer *FindPooledTransfer(struct libusb_transfer *transfer);
+  PooledTransfer *FreePooledTransfer();
+  bool SubmitPooledTransfer(PooledTransfer *pooled, const DmxBuffer &buffer);
+  void PooledTransferComplete(struct libusb_transfer *transfer);
+
+  static const unsigned int MAX_TRANSFER_DEPTH = 8;
 
   DISALLOW_COPY_AND_ASSIGN(AsyncUsbSender);
 };
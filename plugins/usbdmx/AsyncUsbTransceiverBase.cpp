@@ -92,16 +92,14 @@ void AsyncUsbTransceiverBase::CancelTransfer() {
 
 void AsyncUsbTransceiverBase::FillControlTransfer(unsigned char *buffer,
                                                   unsigned int timeout) {
-  m_adaptor->FillControlTransfer(m_transfer, m_usb_handle, buffer,
-                                 &AsyncCallback, this, timeout);
+  FillControlTransfer(m_transfer, buffer, timeout);
 }
 
 void AsyncUsbTransceiverBase::FillBulkTransfer(unsigned char endpoint,
                                                unsigned char *buffer,
                                                int length,
                                                unsigned int timeout) {
-  m_adaptor->FillBulkTransfer(m_transfer, m_usb_handle, endpoint, buffer,
-                              length, &AsyncCallback, this, timeout);
+  FillBulkTransfer(m_transfer, endpoint, buffer, length, timeout);
 }
 
 void AsyncUsbTransceiverBase::FillInterruptTransfer(unsigned char endpoint,
@@ -112,6 +110,23 @@ void AsyncUsbTransceiverBase::FillInterruptTransfer(unsigned char endpoint,
                                    length, &AsyncCallback, this, timeout);
 }
 
+void AsyncUsbTransceiverBase::FillControlTransfer(
+    struct libusb_transfer *transfer,
+    unsigned char *buffer,
+    unsigned int timeout) {
+  m_adaptor->FillControlTransfer(transfer, m_usb_handle, buffer,
+                                 &AsyncCallback, this, timeout);
+}
+
+void AsyncUsbTransceiverBase::FillBulkTransfer(struct libusb_transfer *transfer,
+                                               unsigned char endpoint,
+                                               unsigned char *buffer,
+                                               int length,
+                                               unsigned int timeout) {
+  m_adaptor->FillBulkTransfer(transfer, m_usb_handle, endpoint, buffer,
+                              length, &AsyncCallback, this, timeout);
+}
+
 int AsyncUsbTransceiverBase::SubmitTransfer() {
   int ret = m_adaptor->SubmitTransfer(m_transfer);
   if (ret) {
@@ -120,6 +120,22 @@ class AsyncUsbTransceiverBase {
   void FillInterruptTransfer(unsigned char endpoint, unsigned char *buffer,
                              int length, unsigned int timeout);
 
+  /**
+   * @brief Fill a control transfer other than m_transfer.
+   * @param transfer the transfer to fill, it must be owned by this object.
+   * @param buffer passed to libusb_fill_control_transfer.
+   * @param timeout passed to libusb_fill_control_transfer.
+   */
+  void FillControlTransfer(struct libusb_transfer *transfer,
+                           unsigned char *buffer, unsigned int timeout);
+
+  /**
+   * @brief Fill a bulk transfer other than m_transfer.
+   */
+  void FillBulkTransfer(struct libusb_transfer *transfer,
+                        unsigned char endpoint, unsigned char *buffer,
+                        int length, unsigned int timeout);
+
   /**
    * @brief Submit the transfer for tx.
    * @returns the result of libusb_submit_transfer().
@@ -33,6 +33,11 @@ namespace usbdmx {
 const uint16_t DMXCProjectsNodleU1Factory::VENDOR_ID = 0x16d0;
 const uint16_t DMXCProjectsNodleU1Factory::PRODUCT_ID = 0x0830;
 
+bool DMXCProjectsNodleU1Factory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, PRODUCT_ID));
+  return true;
+}
+
 bool DMXCProjectsNodleU1Factory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
@@ -52,6 +52,8 @@ class DMXCProjectsNodleU1Factory :
       libusb_device *usb_device,
       const struct libusb_device_descriptor &descriptor);
 
+  bool GetProductIds(ProductIds *ids) const;
+
  private:
   ola::usb::LibUsbAdaptor* const m_adaptor;
   PluginAdaptor* const m_plugin_adaptor;
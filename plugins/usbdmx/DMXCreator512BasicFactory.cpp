@@ -36,6 +36,11 @@ using ola::usb::LibUsbAdaptor;
 const uint16_t DMXCreator512BasicFactory::VENDOR_ID = 0x0a30;
 const uint16_t DMXCreator512BasicFactory::PRODUCT_ID = 0x0002;
 
+bool DMXCreator512BasicFactory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, PRODUCT_ID));
+  return true;
+}
+
 bool DMXCreator512BasicFactory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
@@ -196,6 +196,7 @@ class EuroliteProAsyncUsbSender : public AsyncUsbSender {
   EuroliteProAsyncUsbSender(LibUsbAdaptor *adaptor,
                             libusb_device *usb_device)
       : AsyncUsbSender(adaptor, usb_device) {
+    EnablePipelining(EUROLITE_PRO_FRAME_SIZE);
   }
 
   ~EuroliteProAsyncUsbSender() {
@@ -214,16 +215,15 @@ class EuroliteProAsyncUsbSender : public AsyncUsbSender {
     return ok ? usb_handle : NULL;
   }
 
-  bool PerformTransfer(const DmxBuffer &buffer) {
-    CreateFrame(buffer, m_tx_frame);
-    FillBulkTransfer(ENDPOINT, m_tx_frame, EUROLITE_PRO_FRAME_SIZE,
+  void FillPipelinedTransfer(const DmxBuffer &buffer,
+                             struct libusb_transfer *transfer,
+                             uint8_t *frame) {
+    CreateFrame(buffer, frame);
+    FillBulkTransfer(transfer, ENDPOINT, frame, EUROLITE_PRO_FRAME_SIZE,
                      URB_TIMEOUT_MS);
-    return (SubmitTransfer() == 0);
   }
 
  private:
-  uint8_t m_tx_frame[EUROLITE_PRO_FRAME_SIZE];
-
   DISALLOW_COPY_AND_ASSIGN(EuroliteProAsyncUsbSender);
 };
 
@@ -245,6 +245,11 @@ bool AsynchronousEurolitePro::Init() {
 bool AsynchronousEurolitePro::SendDMX(const DmxBuffer &buffer) {
   return m_sender->SendDMX(buffer);
 }
+
+bool AsynchronousEurolitePro::GetTransferStats(UsbTransferStats *stats) const {
+  m_sender->GetTransferStats(stats);
+  return true;
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
@@ -112,6 +112,8 @@ class AsynchronousEurolitePro: public EurolitePro {
 
   bool SendDMX(const DmxBuffer &buffer);
 
+  bool GetTransferStats(UsbTransferStats *stats) const;
+
  private:
   std::auto_ptr<class EuroliteProAsyncUsbSender> m_sender;
 
@@ -37,6 +37,11 @@ const char EuroliteProFactory::EXPECTED_PRODUCT[] = "Eurolite DMX512 Pro";
 const uint16_t EuroliteProFactory::PRODUCT_ID = 0xfa63;
 const uint16_t EuroliteProFactory::VENDOR_ID = 0x04d8;
 
+bool EuroliteProFactory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, PRODUCT_ID));
+  return true;
+}
+
 bool EuroliteProFactory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
@@ -43,6 +43,8 @@ class EuroliteProFactory : public BaseWidgetFactory<class EurolitePro> {
                    libusb_device *usb_device,
                    const struct libusb_device_descriptor &descriptor);
 
+  bool GetProductIds(ProductIds *ids) const;
+
  private:
   ola::usb::LibUsbAdaptor *m_adaptor;
 
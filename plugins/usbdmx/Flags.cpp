@@ -23,3 +23,6 @@
 DEFINE_default_bool(use_async_libusb, true,
     "Disable the use of the asyncronous libusb calls, revert to syncronous");
 
+DEFINE_uint8(usb_transfer_depth, 2,
+    "The number of DMX frames that can be in flight to an asynchronous USB "
+    "widget, between 1 and 8");
@@ -36,6 +36,11 @@ namespace usbdmx {
 const uint16_t JaRuleFactory::PRODUCT_ID = 0xaced;
 const uint16_t JaRuleFactory::VENDOR_ID = 0x1209;
 
+bool JaRuleFactory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, PRODUCT_ID));
+  return true;
+}
+
 bool JaRuleFactory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
@@ -51,6 +51,8 @@ class JaRuleFactory : public BaseWidgetFactory<ola::usb::JaRuleWidget> {
                    libusb_device *usb_device,
                    const struct libusb_device_descriptor &descriptor);
 
+  bool GetProductIds(ProductIds *ids) const;
+
  private:
   ola::io::SelectServerInterface *m_ss;
   ola::usb::AsyncronousLibUsbAdaptor *m_adaptor;
@@ -67,7 +67,9 @@ plugins_usbdmx_libolausbdmxwidget_la_SOURCES = \
     plugins/usbdmx/VellemanK8062Factory.cpp \
     plugins/usbdmx/VellemanK8062Factory.h \
     plugins/usbdmx/Widget.h \
-    plugins/usbdmx/WidgetFactory.h
+    plugins/usbdmx/WidgetFactory.h \
+    plugins/usbdmx/WidgetFactoryIndex.cpp \
+    plugins/usbdmx/WidgetFactoryIndex.h
 plugins_usbdmx_libolausbdmxwidget_la_CXXFLAGS = \
     $(COMMON_CXXFLAGS) \
     $(libusb_CFLAGS)
@@ -286,15 +286,16 @@ class FadecandyAsyncUsbSender : public AsyncUsbSender {
   FadecandyAsyncUsbSender(LibUsbAdaptor *adaptor,
                           libusb_device *usb_device)
       : AsyncUsbSender(adaptor, usb_device) {
+    EnablePipelining(sizeof(fadecandy_packet) * PACKETS_PER_UPDATE);
   }
 
   libusb_device_handle* SetupHandle();
 
-  bool PerformTransfer(const DmxBuffer &buffer);
+  void FillPipelinedTransfer(const DmxBuffer &buffer,
+                             struct libusb_transfer *transfer,
+                             uint8_t *frame);
 
  private:
-  fadecandy_packet m_data_packets[PACKETS_PER_UPDATE];
-
   DISALLOW_COPY_AND_ASSIGN(FadecandyAsyncUsbSender);
 };
 
@@ -312,15 +313,16 @@ libusb_device_handle* FadecandyAsyncUsbSender::SetupHandle() {
   return usb_handle;
 }
 
-bool FadecandyAsyncUsbSender::PerformTransfer(const DmxBuffer &buffer) {
-  UpdatePacketsWithDMX(m_data_packets, buffer);
+void FadecandyAsyncUsbSender::FillPipelinedTransfer(
+    const DmxBuffer &buffer,
+    struct libusb_transfer *transfer,
+    uint8_t *frame) {
+  UpdatePacketsWithDMX(reinterpret_cast<fadecandy_packet*>(frame), buffer);
   // We do a single bulk transfer of the entire data, rather than one transfer
   // for each 64 bytes.
-  FillBulkTransfer(ENDPOINT,
-                   reinterpret_cast<unsigned char*>(&m_data_packets),
-                   sizeof(m_data_packets),
+  FillBulkTransfer(transfer, ENDPOINT, frame,
+                   sizeof(fadecandy_packet) * PACKETS_PER_UPDATE,
                    URB_TIMEOUT_MS);
-  return (SubmitTransfer() == 0);
 }
 
 // AsynchronousScanlimeFadecandy
@@ -341,6 +343,12 @@ bool AsynchronousScanlimeFadecandy::Init() {
 bool AsynchronousScanlimeFadecandy::SendDMX(const DmxBuffer &buffer) {
   return m_sender->SendDMX(buffer);
 }
+
+bool AsynchronousScanlimeFadecandy::GetTransferStats(
+    UsbTransferStats *stats) const {
+  m_sender->GetTransferStats(stats);
+  return true;
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
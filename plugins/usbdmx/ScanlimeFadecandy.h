@@ -113,6 +113,8 @@ class AsynchronousScanlimeFadecandy : public ScanlimeFadecandy {
 
   bool SendDMX(const DmxBuffer &buffer);
 
+  bool GetTransferStats(UsbTransferStats *stats) const;
+
  private:
   std::auto_ptr<class FadecandyAsyncUsbSender> m_sender;
 
@@ -39,6 +39,11 @@ const uint16_t ScanlimeFadecandyFactory::VENDOR_ID = 0x1D50;
 const uint16_t ScanlimeFadecandyFactory::PRODUCT_ID = 0x607A;
 
 
+bool ScanlimeFadecandyFactory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, PRODUCT_ID));
+  return true;
+}
+
 bool ScanlimeFadecandyFactory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
@@ -46,6 +46,8 @@ class ScanlimeFadecandyFactory
       libusb_device *usb_device,
       const struct libusb_device_descriptor &descriptor);
 
+  bool GetProductIds(ProductIds *ids) const;
+
  private:
   bool m_missing_serial_number;
   ola::usb::LibUsbAdaptor *m_adaptor;
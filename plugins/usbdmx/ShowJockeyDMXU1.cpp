@@ -269,24 +269,24 @@ class ShowJockeyDMXU1AsyncUsbSender : public AsyncUsbSender {
                                   m_endpoint(endpoint),
                                   m_max_packet_size_out(max_packet_size_out) {
     m_usb_handle = handle;
-    m_tx_frame = NULL;
     m_nb_sequence = DMX_MAX_SLOT_NUMBER / (m_max_packet_size_out - 2);
     m_nb_sequence += 1;
     m_final_size = DMX_MAX_SLOT_NUMBER + (2 * m_nb_sequence);
-    m_tx_frame = new uint8_t[m_final_size]();
+    EnablePipelining(m_final_size);
   }
 
   ~ShowJockeyDMXU1AsyncUsbSender() {
     CancelTransfer();
-    delete[] m_tx_frame;
   }
 
   libusb_device_handle* SetupHandle() {
     return m_usb_handle;
   }
 
-  bool PerformTransfer(const DmxBuffer &buffer) {
-    uint8_t *p_final_buffer = m_tx_frame;
+  void FillPipelinedTransfer(const DmxBuffer &buffer,
+                             struct libusb_transfer *transfer,
+                             uint8_t *frame) {
+    uint8_t *p_final_buffer = frame;
     unsigned int to_write_size = m_max_packet_size_out - 2;
     uint16_t written_size = 0;
     for (int i = 0; i <= m_nb_sequence; ++i) {
@@ -303,13 +303,11 @@ class ShowJockeyDMXU1AsyncUsbSender : public AsyncUsbSender {
       written_size += to_write_size;
     }
 
-    FillBulkTransfer(m_endpoint, m_tx_frame, m_final_size,
+    FillBulkTransfer(transfer, m_endpoint, frame, m_final_size,
                      URB_TIMEOUT_MS);
-    return SubmitTransfer() == 0;
   }
 
  private:
-  uint8_t *m_tx_frame;
   uint16_t m_nb_sequence;
   int m_endpoint;
   int m_max_packet_size_out;
@@ -360,6 +358,12 @@ bool AsynchronousShowJockeyDMXU1::Init() {
 bool AsynchronousShowJockeyDMXU1::SendDMX(const DmxBuffer &buffer) {
   return m_sender->SendDMX(buffer);
 }
+
+bool AsynchronousShowJockeyDMXU1::GetTransferStats(
+    UsbTransferStats *stats) const {
+  m_sender->GetTransferStats(stats);
+  return true;
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
@@ -124,6 +124,8 @@ class AsynchronousShowJockeyDMXU1: public ShowJockeyDMXU1 {
 
   bool SendDMX(const DmxBuffer &buffer);
 
+  bool GetTransferStats(UsbTransferStats *stats) const;
+
  private:
   std::auto_ptr<class ShowJockeyDMXU1AsyncUsbSender> m_sender;
 
@@ -39,6 +39,11 @@ const char ShowJockeyDMXU1Factory::EXPECTED_PRODUCT[] =
 const uint16_t ShowJockeyDMXU1Factory::PRODUCT_ID = 0x57fe;
 const uint16_t ShowJockeyDMXU1Factory::VENDOR_ID = 0x0483;
 
+bool ShowJockeyDMXU1Factory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, PRODUCT_ID));
+  return true;
+}
+
 bool ShowJockeyDMXU1Factory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
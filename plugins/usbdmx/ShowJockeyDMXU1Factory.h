@@ -43,6 +43,8 @@ class ShowJockeyDMXU1Factory : public BaseWidgetFactory<class ShowJockeyDMXU1> {
                    libusb_device *usb_device,
                    const struct libusb_device_descriptor &descriptor);
 
+  bool GetProductIds(ProductIds *ids) const;
+
  private:
   ola::usb::LibUsbAdaptor *m_adaptor;
 
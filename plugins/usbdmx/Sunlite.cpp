@@ -169,7 +169,7 @@ class SunliteAsyncUsbSender : public AsyncUsbSender {
   SunliteAsyncUsbSender(LibUsbAdaptor *adaptor,
                         libusb_device *usb_device)
       : AsyncUsbSender(adaptor, usb_device) {
-    InitPacket(m_packet);
+    EnablePipelining(SUNLITE_PACKET_SIZE);
   }
 
   ~SunliteAsyncUsbSender() {
@@ -183,15 +183,17 @@ class SunliteAsyncUsbSender : public AsyncUsbSender {
     return ok ? usb_handle : NULL;
   }
 
-  bool PerformTransfer(const DmxBuffer &buffer) {
-    UpdatePacket(buffer, m_packet);
-    FillBulkTransfer(ENDPOINT, m_packet, SUNLITE_PACKET_SIZE, TIMEOUT);
-    return (SubmitTransfer() == 0);
+  void FillPipelinedTransfer(const DmxBuffer &buffer,
+                             struct libusb_transfer *transfer,
+                             uint8_t *frame) {
+    // Each transfer has its own packet, so it may hold the slots of an
+    // older, longer frame.
+    InitPacket(frame);
+    UpdatePacket(buffer, frame);
+    FillBulkTransfer(transfer, ENDPOINT, frame, SUNLITE_PACKET_SIZE, TIMEOUT);
   }
 
  private:
-  uint8_t m_packet[SUNLITE_PACKET_SIZE];
-
   DISALLOW_COPY_AND_ASSIGN(SunliteAsyncUsbSender);
 };
 
@@ -212,6 +214,11 @@ bool AsynchronousSunlite::Init() {
 bool AsynchronousSunlite::SendDMX(const DmxBuffer &buffer) {
   return m_sender->SendDMX(buffer);
 }
+
+bool AsynchronousSunlite::GetTransferStats(UsbTransferStats *stats) const {
+  m_sender->GetTransferStats(stats);
+  return true;
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
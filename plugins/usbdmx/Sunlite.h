@@ -88,6 +88,8 @@ class AsynchronousSunlite: public Sunlite {
 
   bool SendDMX(const DmxBuffer &buffer);
 
+  bool GetTransferStats(UsbTransferStats *stats) const;
+
  private:
   std::auto_ptr<class SunliteAsyncUsbSender> m_sender;
 
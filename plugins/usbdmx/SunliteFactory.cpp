@@ -34,6 +34,12 @@ const uint16_t SunliteFactory::EMPTY_PRODUCT_ID = 0x2000;
 const uint16_t SunliteFactory::FULL_PRODUCT_ID = 0x2001;
 const uint16_t SunliteFactory::VENDOR_ID = 0x0962;
 
+bool SunliteFactory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, EMPTY_PRODUCT_ID));
+  ids->push_back(ProductId(VENDOR_ID, FULL_PRODUCT_ID));
+  return true;
+}
+
 bool SunliteFactory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
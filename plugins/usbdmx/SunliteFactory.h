@@ -44,6 +44,8 @@ class SunliteFactory : public BaseWidgetFactory<Sunlite> {
       libusb_device *usb_device,
       const struct libusb_device_descriptor &descriptor);
 
+  bool GetProductIds(ProductIds *ids) const;
+
  private:
   ola::usb::LibUsbAdaptor* const m_adaptor;
 
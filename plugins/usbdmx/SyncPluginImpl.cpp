@@ -59,6 +59,7 @@ namespace ola {
 namespace plugin {
 namespace usbdmx {
 
+using ola::usb::UsbDeviceMonitor;
 using std::pair;
 using std::string;
 using std::vector;
@@ -71,7 +72,8 @@ SyncPluginImpl::SyncPluginImpl(PluginAdaptor *plugin_adaptor,
       m_plugin(plugin),
       m_debug_level(debug_level),
       m_preferences(preferences),
-      m_context(NULL) {
+      m_context(NULL),
+      m_new_widget(NULL) {
   m_widget_factories.push_back(new AnymauDMXFactory(&m_usb_adaptor));
   m_widget_factories.push_back(new AVLdiyD512Factory(&m_usb_adaptor));
   m_widget_factories.push_back(new DMXCProjectsNodleU1Factory(&m_usb_adaptor,
@@ -82,6 +84,11 @@ SyncPluginImpl::SyncPluginImpl(PluginAdaptor *plugin_adaptor,
   m_widget_factories.push_back(new ShowJockeyDMXU1Factory(&m_usb_adaptor));
   m_widget_factories.push_back(new SunliteFactory(&m_usb_adaptor));
   m_widget_factories.push_back(new VellemanK8062Factory(&m_usb_adaptor));
+
+  WidgetFactories::iterator iter = m_widget_factories.begin();
+  for (; iter != m_widget_factories.end(); ++iter) {
+    m_factory_index.AddFactory(*iter);
+  }
 }
 
 SyncPluginImpl::~SyncPluginImpl() {
@@ -97,10 +104,24 @@ bool SyncPluginImpl::Start() {
   OLA_DEBUG << "libusb debug level set to " << m_debug_level;
   libusb_set_debug(m_context, m_debug_level);
 
+  OLA_WARN << "Using synchronous libusb calls, each USB device will use a "
+           << "separate thread. Drop --no-use-async-libusb to share a single "
+           << "thread between all devices";
+
+  // Listen for uevents before the scan, so we don't miss any devices.
+  m_monitor.reset(new UsbDeviceMonitor(
+      NewCallback(this, &SyncPluginImpl::DeviceEvent)));
+  if (m_monitor->Init()) {
+    m_plugin_adaptor->AddReadDescriptor(m_monitor->GetDescriptor());
+  } else {
+    m_monitor.reset();
+  }
+
   unsigned int devices_claimed = ScanForDevices();
-  if (devices_claimed != m_devices.size()) {
+  if (!m_monitor.get() && devices_claimed != m_devices.size()) {
     // This indicates there is firmware loading going on, schedule a callback
-    // to check for 'new' devices once the firmware has loaded.
+    // to check for 'new' devices once the firmware has loaded. With uevents
+    // we'll be told when the device comes back.
 
     m_plugin_adaptor->RegisterSingleTimeout(
         3500,
@@ -110,6 +131,11 @@ bool SyncPluginImpl::Start() {
 }
 
 bool SyncPluginImpl::Stop() {
+  if (m_monitor.get()) {
+    m_plugin_adaptor->RemoveReadDescriptor(m_monitor->GetDescriptor());
+    m_monitor.reset();
+  }
+
   WidgetToDeviceMap::iterator iter;
   for (iter = m_devices.begin(); iter != m_devices.end(); ++iter) {
     m_plugin_adaptor->UnregisterDevice(iter->second);
@@ -231,10 +257,15 @@ bool SyncPluginImpl::CheckDevice(libusb_device *usb_device) {
     return false;
   }
 
-  WidgetFactories::iterator iter = m_widget_factories.begin();
-  for (; iter != m_widget_factories.end(); ++iter) {
+  WidgetFactories factories;
+  m_factory_index.GetFactories(device_descriptor.idVendor,
+                               device_descriptor.idProduct, &factories);
+  WidgetFactories::iterator iter = factories.begin();
+  for (; iter != factories.end(); ++iter) {
+    m_new_widget = NULL;
     if ((*iter)->DeviceAdded(this, usb_device, device_descriptor)) {
-      m_registered_devices.insert(bus_dev_id);
+      m_registered_devices[bus_dev_id] = m_new_widget;
+      m_new_widget = NULL;
       return true;
     }
   }
@@ -245,6 +276,59 @@ void SyncPluginImpl::ReScanForDevices() {
   ScanForDevices();
 }
 
+/*
+ * @brief Called when the kernel or udev reports a USB device.
+ *
+ * Both of them report each device, and the kernel's event can arrive before
+ * udev has set the permissions on the device, so an add event is ignored if
+ * the device has already been claimed.
+ */
+void SyncPluginImpl::DeviceEvent(UsbDeviceMonitor::EventType event,
+                                 uint8_t bus_number, uint8_t device_address) {
+  if (event == UsbDeviceMonitor::DEVICE_REMOVED) {
+    RemoveDevice(pair<uint8_t, uint8_t>(bus_number, device_address));
+    return;
+  }
+
+  libusb_device **device_list;
+  ssize_t device_count = libusb_get_device_list(m_context, &device_list);
+  for (ssize_t i = 0; i < device_count; i++) {
+    if (libusb_get_bus_number(device_list[i]) == bus_number &&
+        libusb_get_device_address(device_list[i]) == device_address) {
+      CheckDevice(device_list[i]);
+      break;
+    }
+  }
+  if (device_count >= 0) {
+    libusb_free_device_list(device_list, 1);  // unref devices
+  }
+}
+
+/*
+ * @brief Stop & delete the widget for a device that was unplugged.
+ */
+void SyncPluginImpl::RemoveDevice(const pair<uint8_t, uint8_t> &bus_dev_id) {
+  USBDeviceMap::iterator iter = m_registered_devices.find(bus_dev_id);
+  if (iter == m_registered_devices.end()) {
+    return;
+  }
+
+  WidgetInterface *widget = iter->second;
+  m_registered_devices.erase(iter);
+  if (!widget) {
+    return;
+  }
+
+  Device *device = STLLookupAndRemovePtr(&m_devices, widget);
+  if (device) {
+    OLA_INFO << "Removing " << device->Name();
+    m_plugin_adaptor->UnregisterDevice(device);
+    device->Stop();
+    delete device;
+  }
+  delete widget;
+}
+
 /*
  * @brief Signal widget / device addition.
  * @param widget The widget that was added.
@@ -259,6 +343,7 @@ bool SyncPluginImpl::StartAndRegisterDevice(WidgetInterface *widget,
 
   STLReplace(&m_devices, widget, device);
   m_plugin_adaptor->RegisterDevice(device);
+  m_new_widget = widget;
   return true;
 }
 }  // namespace usbdmx
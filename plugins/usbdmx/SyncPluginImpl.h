@@ -23,17 +23,19 @@
 
 #include <libusb.h>
 #include <map>
-#include <set>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "libs/usb/LibUsbAdaptor.h"
+#include "libs/usb/UsbDeviceMonitor.h"
 #include "ola/base/Macro.h"
 #include "olad/Preferences.h"
 #include "plugins/usbdmx/PluginImplInterface.h"
 #include "plugins/usbdmx/Widget.h"
 #include "plugins/usbdmx/WidgetFactory.h"
+#include "plugins/usbdmx/WidgetFactoryIndex.h"
 
 namespace ola {
 
@@ -48,7 +50,8 @@ namespace usbdmx {
  * This implementation spawns a thread for each dongle, and then uses
  * synchronous calls to libusb.
  *
- * This does not support hotplug.
+ * Where uevents are available, devices are added & removed as they're
+ * plugged in & out. Otherwise we only scan for devices when we start.
  */
 class SyncPluginImpl: public PluginImplInterface,  public WidgetObserver {
  public:
@@ -96,6 +99,10 @@ class SyncPluginImpl: public PluginImplInterface,  public WidgetObserver {
  private:
   typedef std::vector<class WidgetFactory*> WidgetFactories;
   typedef std::map<class WidgetInterface*, Device*> WidgetToDeviceMap;
+  // Maps the bus number & device address to the widget, which may be NULL if
+  // the factory claimed the device without creating a widget.
+  typedef std::map<std::pair<uint8_t, uint8_t>, class WidgetInterface*>
+      USBDeviceMap;
 
   PluginAdaptor* const m_plugin_adaptor;
   Plugin* const m_plugin;
@@ -103,15 +110,22 @@ class SyncPluginImpl: public PluginImplInterface,  public WidgetObserver {
   ola::usb::SyncronousLibUsbAdaptor m_usb_adaptor;
   Preferences* const m_preferences;
   WidgetFactories m_widget_factories;
+  WidgetFactoryIndex m_factory_index;
 
   libusb_context *m_context;
+  std::auto_ptr<ola::usb::UsbDeviceMonitor> m_monitor;
 
   WidgetToDeviceMap m_devices;
-  std::set<std::pair<uint8_t, uint8_t> > m_registered_devices;
+  USBDeviceMap m_registered_devices;
+  // The widget started while CheckDevice() runs the factories.
+  class WidgetInterface *m_new_widget;
 
   unsigned int ScanForDevices();
   void ReScanForDevices();
   bool CheckDevice(libusb_device *device);
+  void DeviceEvent(ola::usb::UsbDeviceMonitor::EventType event,
+                   uint8_t bus_number, uint8_t device_address);
+  void RemoveDevice(const std::pair<uint8_t, uint8_t> &bus_dev_id);
 
   bool StartAndRegisterDevice(class WidgetInterface *widget, Device *device);
 
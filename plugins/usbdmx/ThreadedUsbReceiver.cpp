@@ -22,6 +22,7 @@
 
 #include <unistd.h>
 #include "ola/Logging.h"
+#include "ola/thread/ThreadSettings.h"
 
 namespace ola {
 namespace plugin {
@@ -31,7 +32,9 @@ ThreadedUsbReceiver::ThreadedUsbReceiver(libusb_device *usb_device,
                                          libusb_device_handle *usb_handle,
                                          PluginAdaptor *plugin_adaptor,
                                          int interface_number)
-    : m_term(false),
+    : ola::thread::Thread(ola::thread::Thread::Options(
+          "usb-receiver", ola::thread::THREAD_CLASS_USB)),
+      m_term(false),
       m_usb_device(usb_device),
       m_usb_handle(usb_handle),
       m_interface_number(interface_number),
@@ -59,6 +59,9 @@ class UsbDmxPlugin: public ola::Plugin {
   ola_plugin_id Id() const { return OLA_PLUGIN_USBDMX; }
   std::string PluginPrefix() const { return PLUGIN_PREFIX; }
 
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
  private:
   std::auto_ptr<class PluginImplInterface> m_impl;
 
@@ -66,8 +69,6 @@ class UsbDmxPlugin: public ola::Plugin {
   bool StopHook();
   bool SetDefaultPreferences();
 
-  static const char PLUGIN_NAME[];
-  static const char PLUGIN_PREFIX[];
   static const char LIBUSB_DEBUG_LEVEL_KEY[];
   static int LIBUSB_DEFAULT_DEBUG_LEVEL;
   static int LIBUSB_MAX_DEBUG_LEVEL;
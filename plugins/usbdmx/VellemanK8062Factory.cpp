@@ -33,6 +33,11 @@ namespace usbdmx {
 const uint16_t VellemanK8062Factory::VENDOR_ID = 0x10cf;
 const uint16_t VellemanK8062Factory::PRODUCT_ID = 0x8062;
 
+bool VellemanK8062Factory::GetProductIds(ProductIds *ids) const {
+  ids->push_back(ProductId(VENDOR_ID, PRODUCT_ID));
+  return true;
+}
+
 bool VellemanK8062Factory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
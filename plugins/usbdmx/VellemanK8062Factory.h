@@ -44,6 +44,8 @@ class VellemanK8062Factory : public BaseWidgetFactory<class VellemanK8062> {
       libusb_device *usb_device,
       const struct libusb_device_descriptor &descriptor);
 
+  bool GetProductIds(ProductIds *ids) const;
+
  private:
   ola::usb::LibUsbAdaptor* const m_adaptor;
 
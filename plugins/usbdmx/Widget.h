@@ -21,6 +21,8 @@
 #ifndef PLUGINS_USBDMX_WIDGET_H_
 #define PLUGINS_USBDMX_WIDGET_H_
 
+#include <stdint.h>
+
 #include "libs/usb/LibUsbAdaptor.h"
 #include "libs/usb/Types.h"
 #include "ola/DmxBuffer.h"
@@ -29,6 +31,16 @@ namespace ola {
 namespace plugin {
 namespace usbdmx {
 
+/**
+ * @brief The counters for the DMX frames sent to a widget.
+ */
+struct UsbTransferStats {
+  UsbTransferStats() : frames(0), latency_us(0) {}
+
+  unsigned int frames;  // The number of frames delivered to the widget.
+  uint64_t latency_us;  // The sum of the time each frame spent in flight.
+};
+
 /**
  * @brief The interface for a simple widget that supports a single universe of
  * DMX.
@@ -55,6 +67,16 @@ class WidgetInterface {
    * @returns true if the data was sent, false otherwise.
    */
   virtual bool SendDMX(const DmxBuffer &buffer) = 0;
+
+  /**
+   * @brief Get the transfer counters for this widget.
+   * @param stats filled in with the counters since the widget was created.
+   * @returns true if the widget keeps transfer counters, false otherwise.
+   */
+  virtual bool GetTransferStats(UsbTransferStats *stats) const {
+    (void) stats;
+    return false;
+  }
 };
 
 /**
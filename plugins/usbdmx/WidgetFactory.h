@@ -22,8 +22,11 @@
 #define PLUGINS_USBDMX_WIDGETFACTORY_H_
 
 #include <libusb.h>
+#include <stdint.h>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 #include "ola/Logging.h"
 #include "ola/base/Macro.h"
 #include "ola/stl/STLUtils.h"
@@ -151,6 +154,12 @@ class WidgetObserver {
  */
 class WidgetFactory {
  public:
+  /**
+   * @brief A USB vendor ID & product ID.
+   */
+  typedef std::pair<uint16_t, uint16_t> ProductId;
+  typedef std::vector<ProductId> ProductIds;
+
   virtual ~WidgetFactory() {}
 
   /**
@@ -167,6 +176,19 @@ class WidgetFactory {
       libusb_device *usb_device,
       const struct libusb_device_descriptor &descriptor) = 0;
 
+  /**
+   * @brief Get the vendor & product IDs this factory handles.
+   * @param[out] ids the IDs are appended to this.
+   * @returns true if DeviceAdded() only claims devices with these IDs, false
+   *   if it needs to see every device.
+   *
+   * This allows the factory for a device to be found without trying all of
+   * them.
+   */
+  virtual bool GetProductIds(OLA_UNUSED ProductIds *ids) const {
+    return false;
+  }
+
   /**
    * @brief The name of this factory.
    * @returns The name of this factory.
@@ -0,0 +1,59 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * WidgetFactoryIndex.cpp
+ * Finds the WidgetFactories for a USB vendor & product ID.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "plugins/usbdmx/WidgetFactoryIndex.h"
+
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace plugin {
+namespace usbdmx {
+
+void WidgetFactoryIndex::AddFactory(WidgetFactory *factory) {
+  WidgetFactory::ProductIds ids;
+  if (!factory->GetProductIds(&ids)) {
+    m_wildcard_factories.push_back(factory);
+    return;
+  }
+
+  WidgetFactory::ProductIds::const_iterator iter = ids.begin();
+  for (; iter != ids.end(); ++iter) {
+    m_factories[*iter].push_back(factory);
+  }
+}
+
+void WidgetFactoryIndex::Clear() {
+  m_factories.clear();
+  m_wildcard_factories.clear();
+}
+
+void WidgetFactoryIndex::GetFactories(uint16_t vendor_id, uint16_t product_id,
+                                      WidgetFactories *factories) const {
+  const WidgetFactories *matches = STLFind(
+      &m_factories, WidgetFactory::ProductId(vendor_id, product_id));
+  if (matches) {
+    factories->insert(factories->end(), matches->begin(), matches->end());
+  }
+  factories->insert(factories->end(), m_wildcard_factories.begin(),
+                    m_wildcard_factories.end());
+}
+}  // namespace usbdmx
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,80 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * WidgetFactoryIndex.h
+ * Finds the WidgetFactories for a USB vendor & product ID.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_USBDMX_WIDGETFACTORYINDEX_H_
+#define PLUGINS_USBDMX_WIDGETFACTORYINDEX_H_
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+#include "ola/base/Macro.h"
+#include "plugins/usbdmx/WidgetFactory.h"
+
+namespace ola {
+namespace plugin {
+namespace usbdmx {
+
+/**
+ * @brief Maps USB vendor & product IDs to the factories that handle them.
+ *
+ * This means a new USB device is only offered to the factories that may claim
+ * it, rather than every factory in turn.
+ */
+class WidgetFactoryIndex {
+ public:
+  typedef std::vector<WidgetFactory*> WidgetFactories;
+
+  WidgetFactoryIndex() {}
+
+  /**
+   * @brief Add a factory to the index.
+   * @param factory the factory, ownership is not transferred.
+   */
+  void AddFactory(WidgetFactory *factory);
+
+  /**
+   * @brief Remove all the factories.
+   */
+  void Clear();
+
+  /**
+   * @brief Get the factories which may claim a device.
+   * @param vendor_id the USB vendor ID of the device.
+   * @param product_id the USB product ID of the device.
+   * @param[out] factories the factories which handle this ID, in the order
+   *   they were added, followed by the factories which need to see every
+   *   device.
+   */
+  void GetFactories(uint16_t vendor_id, uint16_t product_id,
+                    WidgetFactories *factories) const;
+
+ private:
+  typedef std::map<WidgetFactory::ProductId, WidgetFactories> FactoryMap;
+
+  FactoryMap m_factories;
+  WidgetFactories m_wildcard_factories;
+
+  DISALLOW_COPY_AND_ASSIGN(WidgetFactoryIndex);
+};
+}  // namespace usbdmx
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_USBDMX_WIDGETFACTORYINDEX_H_
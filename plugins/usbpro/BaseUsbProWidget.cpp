@@ -24,11 +24,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <termios.h>
 #include <unistd.h>
 #include <string>
+#include <vector>
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/io/IOUtils.h"
@@ -41,25 +43,54 @@ namespace plugin {
 namespace usbpro {
 
 using std::string;
+using std::vector;
 
 
 const unsigned int BaseUsbProWidget::HEADER_SIZE =
   sizeof(BaseUsbProWidget::message_header);
 
+const char BaseUsbProWidget::K_DMX_FRAMES_VAR[] = "usbpro-dmx-frames";
+const char BaseUsbProWidget::K_DMX_FRAMES_REPLACED_VAR[] =
+  "usbpro-dmx-frames-replaced";
+const char BaseUsbProWidget::K_DMX_QUEUE_LATENCY_VAR[] =
+  "usbpro-dmx-queue-latency-us";
+
+namespace {
+const char DEVICE_KEY[] = "device";
+
+unsigned int *ExportCounter(ola::ExportMap *export_map, const char *name,
+                            const string &key) {
+  UIntMap *var = export_map->GetUIntMapVar(name, DEVICE_KEY);
+  unsigned int &counter = (*var)[key];
+  counter = 0;
+  return &counter;
+}
+}  // namespace
+
 
 BaseUsbProWidget::BaseUsbProWidget(
     ola::io::ConnectedDescriptor *descriptor)
     : m_descriptor(descriptor),
       m_state(PRE_SOM),
-      m_bytes_received(0) {
+      m_bytes_received(0),
+      m_scheduler(NULL),
+      m_flush_timeout(ola::thread::INVALID_TIMEOUT),
+      m_drain_bytes_per_ms(DEFAULT_DRAIN_BYTES_PER_MS),
+      m_last_queue_size(0),
+      m_bytes_written(0) {
   memset(&m_header, 0, sizeof(m_header));
   m_descriptor->SetOnData(
       NewCallback(this, &BaseUsbProWidget::DescriptorReady));
+  memset(m_local_counters, 0, sizeof(m_local_counters));
+  m_frames = &m_local_counters[0];
+  m_frames_replaced = &m_local_counters[1];
+  m_queue_latency = &m_local_counters[2];
 }
 
 
 BaseUsbProWidget::~BaseUsbProWidget() {
   m_descriptor->SetOnData(NULL);
+  DiscardPendingDMX();
 }
 
 
@@ -86,9 +117,9 @@ bool BaseUsbProWidget::SendDMX(const DmxBuffer &buffer) {
   widget_dmx.start_code = DMX512_START_CODE;
   unsigned int length = DMX_UNIVERSE_SIZE;
   buffer.Get(widget_dmx.dmx, &length);
-  return SendMessage(DMX_LABEL,
-                     reinterpret_cast<uint8_t*>(&widget_dmx),
-                     length + 1);
+  return SendDMXMessage(DMX_LABEL,
+                        reinterpret_cast<uint8_t*>(&widget_dmx),
+                        length + 1);
 }
 
 
@@ -112,9 +143,122 @@ bool BaseUsbProWidget::SendMessage(uint8_t label,
 
   memcpy(frame + sizeof(message_header), data, length);
   frame[frame_size - 1] = EOM;
+  return WriteMessage(frame, frame_size);
+}
+
+
+void BaseUsbProWidget::EnableLatestFrameOnly(
+    ola::thread::SchedulerInterface *scheduler,
+    ola::ExportMap *export_map,
+    const string &key) {
+  m_scheduler = scheduler;
+  if (export_map) {
+    m_frames = ExportCounter(export_map, K_DMX_FRAMES_VAR, key);
+    m_frames_replaced = ExportCounter(export_map, K_DMX_FRAMES_REPLACED_VAR,
+                                      key);
+    m_queue_latency = ExportCounter(export_map, K_DMX_QUEUE_LATENCY_VAR, key);
+  }
+}
+
+
+/*
+ * Send a DMX message, or hold it until the widget has caught up.
+ * @return true if the message was sent or held, false otherwise
+ */
+bool BaseUsbProWidget::SendDMXMessage(uint8_t label,
+                                      const uint8_t *data,
+                                      unsigned int length) {
+  if (!m_scheduler) {
+    return SendMessage(label, data, length);
+  }
+
+  if (length && !data)
+    return false;
+
+  PendingFrame *frame = NULL;
+  vector<PendingFrame>::iterator iter = m_pending_frames.begin();
+  for (; iter != m_pending_frames.end(); ++iter) {
+    if (iter->label == label) {
+      frame = &(*iter);
+      break;
+    }
+  }
+  if (!frame) {
+    PendingFrame new_frame;
+    new_frame.label = label;
+    new_frame.pending = false;
+    m_pending_frames.push_back(new_frame);
+    frame = &m_pending_frames.back();
+  }
+
+  if (frame->pending) {
+    (*m_frames_replaced)++;
+  }
+  BuildMessage(label, data, length, &frame->message);
+  m_clock.CurrentTime(&frame->queued);
+  frame->pending = true;
 
-  ssize_t bytes_sent = m_descriptor->Send(frame, frame_size);
-  if (bytes_sent != frame_size)
+  if (m_flush_timeout == ola::thread::INVALID_TIMEOUT) {
+    FlushPendingFrames();
+  }
+  return true;
+}
+
+
+void BaseUsbProWidget::DiscardPendingDMX() {
+  vector<PendingFrame>::iterator iter = m_pending_frames.begin();
+  for (; iter != m_pending_frames.end(); ++iter) {
+    iter->pending = false;
+  }
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_flush_timeout);
+    m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+}
+
+
+/**
+ * The number of bytes in the serial port's output queue, i.e. the data the
+ * widget hasn't consumed yet.
+ */
+unsigned int BaseUsbProWidget::OutputQueueSize() const {
+#ifdef TIOCOUTQ
+  int queued = 0;
+  if (ioctl(ola::io::ToFD(m_descriptor->WriteDescriptor()), TIOCOUTQ,
+            &queued) < 0 || queued < 0) {
+    return 0;
+  }
+  return queued;
+#else
+  return 0;
+#endif  // TIOCOUTQ
+}
+
+
+/*
+ * Build a complete message, including the header and footer.
+ */
+void BaseUsbProWidget::BuildMessage(uint8_t label,
+                                    const uint8_t *data,
+                                    unsigned int length,
+                                    vector<uint8_t> *message) const {
+  message->resize(HEADER_SIZE + length + 1);
+  message_header *header = reinterpret_cast<message_header*>(&(*message)[0]);
+  header->som = SOM;
+  header->label = label;
+  header->len = length & 0xFF;
+  header->len_hi = (length & 0xFF00) >> 8;
+  if (length) {
+    memcpy(&(*message)[HEADER_SIZE], data, length);
+  }
+  (*message)[HEADER_SIZE + length] = EOM;
+}
+
+
+bool BaseUsbProWidget::WriteMessage(const uint8_t *message,
+                                    unsigned int size) const {
+  ssize_t bytes_sent = m_descriptor->Send(message, size);
+  if (bytes_sent != static_cast<ssize_t>(size))
     // we've probably screwed framing at this point
     return false;
 
@@ -122,6 +266,134 @@ bool BaseUsbProWidget::SendMessage(uint8_t label,
 }
 
 
+/*
+ * Write the pending frames the widget has room for. If any are left, try again
+ * once the widget should have consumed enough of the queued data.
+ */
+void BaseUsbProWidget::FlushPendingFrames() {
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  unsigned int queue_size = OutputQueueSize();
+  UpdateDrainRate(now, queue_size);
+
+  unsigned int wait_for_bytes = 0;
+  vector<PendingFrame>::iterator iter = m_pending_frames.begin();
+  for (; iter != m_pending_frames.end(); ++iter) {
+    if (!iter->pending) {
+      continue;
+    }
+
+    const unsigned int size = iter->message.size();
+    if (queue_size >= size) {
+      // The widget still has more than a frame to send.
+      wait_for_bytes = queue_size - size + 1;
+      break;
+    }
+
+    if (!WriteMessage(&iter->message[0], size)) {
+      OLA_WARN << "Failed to write DMX frame to widget";
+    }
+    iter->pending = false;
+    queue_size += size;
+    m_bytes_written += size;
+
+    (*m_frames)++;
+    const unsigned int latency = static_cast<unsigned int>(
+        (now - iter->queued).AsInt());
+    *m_queue_latency = (*m_queue_latency * 7 + latency) / 8;
+  }
+
+  if (wait_for_bytes) {
+    unsigned int delay = wait_for_bytes / m_drain_bytes_per_ms + 1;
+    if (delay > MAX_FLUSH_DELAY_MS) {
+      delay = MAX_FLUSH_DELAY_MS;
+    }
+    m_flush_timeout = m_scheduler->RegisterSingleTimeout(
+        delay, NewSingleCallback(this, &BaseUsbProWidget::FlushTimeout));
+  }
+}
+
+
+void BaseUsbProWidget::FlushTimeout() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  FlushPendingFrames();
+}
+
+
+/*
+ * Estimate how fast the widget consumes data, from how much the output queue
+ * has shrunk since the last sample.
+ */
+void BaseUsbProWidget::UpdateDrainRate(const TimeStamp &now,
+                                       unsigned int queue_size) {
+  const int64_t elapsed_ms = (now - m_last_drain_sample).InMilliSeconds();
+  if (elapsed_ms <= 0) {
+    return;
+  }
+
+  // If the queue emptied we don't know when, so the sample is only useful if
+  // there is still data queued.
+  const unsigned int expected_size = m_last_queue_size + m_bytes_written;
+  if (queue_size && expected_size > queue_size) {
+    const unsigned int rate = static_cast<unsigned int>(
+        (expected_size - queue_size) / elapsed_ms);
+    if (rate) {
+      m_drain_bytes_per_ms = (m_drain_bytes_per_ms * 3 + rate) / 4;
+      if (!m_drain_bytes_per_ms) {
+        m_drain_bytes_per_ms = 1;
+      }
+    }
+  }
+  m_last_drain_sample = now;
+  m_last_queue_size = queue_size;
+  m_bytes_written = 0;
+}
+
+
+/*
+ * A change of state message is the block number (8 slots per block, slot 0 is
+ * the start code), a 40 bit bitmap of the changed slots starting at that
+ * block, and then the new value for each set bit.
+ */
+bool BaseUsbProWidget::ApplyDMXChange(const uint8_t *data,
+                                      unsigned int length,
+                                      DmxBuffer *buffer) {
+  static const unsigned int BITMAP_SIZE = 5;
+  static const unsigned int HEADER_LENGTH = 1 + BITMAP_SIZE;
+
+  // A message without any changed slots would be valid, but there's no
+  // reason for a widget to send one.
+  if (length <= HEADER_LENGTH ||
+      length > HEADER_LENGTH + BITMAP_SIZE * 8) {
+    OLA_WARN << "Change of state packet has an invalid length: " << length;
+    return false;
+  }
+
+  const unsigned int first_slot = data[0] * 8;
+  const uint8_t *bitmap = data + 1;
+  const uint8_t *value = data + HEADER_LENGTH;
+  const uint8_t *end = data + length;
+
+  for (unsigned int i = 0; i < BITMAP_SIZE * 8 && value < end; i++) {
+    if (!(bitmap[i / 8] & (1 << (i % 8)))) {
+      continue;
+    }
+    const unsigned int slot = first_slot + i;
+    if (slot == 0) {
+      // Slot 0 is the start code. The USB Pro doesn't guarantee the order of
+      // the messages, so one with an alternate start code can't be merged.
+      if (*value != DMX512_START_CODE) {
+        return false;
+      }
+    } else if (slot <= DMX_UNIVERSE_SIZE) {
+      buffer->SetChannel(slot - 1, *value);
+    }
+    value++;
+  }
+  return true;
+}
+
+
 /**
  * Open a path and apply the settings required for talking to widgets.
  */
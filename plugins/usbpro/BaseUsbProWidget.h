@@ -24,9 +24,13 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/io/Descriptor.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "plugins/usbpro/SerialWidgetInterface.h"
 
 namespace ola {
@@ -54,8 +58,48 @@ class BaseUsbProWidget: public SerialWidgetInterface {
                    const uint8_t *data,
                    unsigned int length) const;
 
+  /*
+   * Only write a DMX frame once the widget has consumed most of the previous
+   * one. Until then the frame is held, and replaced by any newer frame with
+   * the same label, so at most one frame per label is ever pending.
+   * @param scheduler used to retry once the serial port has drained.
+   * @param export_map if not NULL, the queue statistics are exported.
+   * @param key the key for the exported variables, e.g. the serial number.
+   */
+  void EnableLatestFrameOnly(ola::thread::SchedulerInterface *scheduler,
+                             ola::ExportMap *export_map,
+                             const std::string &key);
+
+  /*
+   * Send a DMX message. If EnableLatestFrameOnly() was called this may be held
+   * and replaced by a later frame, otherwise it's the same as SendMessage().
+   */
+  bool SendDMXMessage(uint8_t label,
+                      const uint8_t *data,
+                      unsigned int length);
+
+  /*
+   * Drop any DMX frame that hasn't been written yet, e.g. before the widget
+   * is switched to receive mode.
+   */
+  void DiscardPendingDMX();
+
   static ola::io::ConnectedDescriptor *OpenDevice(const std::string &path);
 
+  /*
+   * Patch the slots from a change of state message into a buffer. The buffer
+   * should already hold the full frame, i.e. have been blacked out when the
+   * widget was put into change of state mode.
+   * @returns true if the message was valid and applied, false otherwise.
+   */
+  static bool ApplyDMXChange(const uint8_t *data,
+                             unsigned int length,
+                             DmxBuffer *buffer);
+
+  static const char K_DMX_FRAMES_VAR[];
+  static const char K_DMX_FRAMES_REPLACED_VAR[];
+  static const char K_DMX_QUEUE_LATENCY_VAR[];
+
   static const uint8_t DEVICE_LABEL = 78;
   static const uint8_t DMX_LABEL = 6;
   static const uint8_t GET_PARAMS = 3;
@@ -63,7 +107,19 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   static const uint8_t MANUFACTURER_LABEL = 77;
   static const uint8_t SERIAL_LABEL = 10;
 
+ protected:
+  // The number of bytes waiting to be written to the widget.
+  virtual unsigned int OutputQueueSize() const;
+
  private:
+  // A DMX message that's waiting for the widget to catch up.
+  struct PendingFrame {
+    uint8_t label;
+    bool pending;
+    TimeStamp queued;
+    std::vector<uint8_t> message;
+  };
+
   typedef enum {
     PRE_SOM,
     RECV_LABEL,
@@ -88,7 +144,30 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   message_header m_header;
   uint8_t m_recv_buffer[MAX_DATA_SIZE];
 
+  // Latest frame only mode
+  ola::thread::SchedulerInterface *m_scheduler;
+  ola::thread::timeout_id m_flush_timeout;
+  ola::Clock m_clock;
+  std::vector<PendingFrame> m_pending_frames;
+  // The estimated rate the widget consumes data at.
+  unsigned int m_drain_bytes_per_ms;
+  TimeStamp m_last_drain_sample;
+  unsigned int m_last_queue_size;
+  unsigned int m_bytes_written;  // since the last sample
+  // These point to the exported variables, or the local counters if there
+  // isn't an ExportMap.
+  unsigned int *m_frames;
+  unsigned int *m_frames_replaced;
+  unsigned int *m_queue_latency;
+  unsigned int m_local_counters[3];
+
   void ReceiveMessage();
+  void BuildMessage(uint8_t label, const uint8_t *data, unsigned int length,
+                    std::vector<uint8_t> *message) const;
+  bool WriteMessage(const uint8_t *message, unsigned int size) const;
+  void FlushPendingFrames();
+  void FlushTimeout();
+  void UpdateDrainRate(const TimeStamp &now, unsigned int queue_size);
   virtual void HandleMessage(uint8_t label,
                              const uint8_t *data,
                              unsigned int length) = 0;
@@ -96,6 +175,9 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   static const uint8_t EOM = 0xe7;
   static const uint8_t SOM = 0x7e;
   static const unsigned int HEADER_SIZE;
+  // 250kbps with 11 bits per slot.
+  static const unsigned int DEFAULT_DRAIN_BYTES_PER_MS = 22;
+  static const unsigned int MAX_FLUSH_DELAY_MS = 100;
 };
 
 
@@ -27,6 +27,7 @@
 #include "ola/Callback.h"
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/network/NetworkUtils.h"
 #include "plugins/usbpro/BaseUsbProWidget.h"
@@ -34,14 +35,40 @@
 
 
 using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::plugin::usbpro::BaseUsbProWidget;
 using std::auto_ptr;
 using std::queue;
 
+namespace {
+/*
+ * A widget where the size of the output queue can be set.
+ */
+class QueueingUsbProWidget
+    : public ola::plugin::usbpro::DispatchingUsbProWidget {
+ public:
+  explicit QueueingUsbProWidget(ola::io::ConnectedDescriptor *descriptor)
+      : DispatchingUsbProWidget(descriptor, NULL),
+        m_queue_size(0) {
+  }
+
+  void SetOutputQueueSize(unsigned int size) { m_queue_size = size; }
+
+ protected:
+  unsigned int OutputQueueSize() const { return m_queue_size; }
+
+ private:
+  unsigned int m_queue_size;
+};
+}  // namespace
+
 
 class BaseUsbProWidgetTest: public CommonWidgetTest {
   CPPUNIT_TEST_SUITE(BaseUsbProWidgetTest);
   CPPUNIT_TEST(testSend);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testLatestFrameOnly);
+  CPPUNIT_TEST(testApplyDMXChange);
   CPPUNIT_TEST(testReceive);
   CPPUNIT_TEST(testRemove);
   CPPUNIT_TEST_SUITE_END();
@@ -51,6 +78,8 @@ class BaseUsbProWidgetTest: public CommonWidgetTest {
 
     void testSend();
     void testSendDMX();
+    void testLatestFrameOnly();
+    void testApplyDMXChange();
     void testReceive();
     void testRemove();
 
@@ -205,6 +234,98 @@ void BaseUsbProWidgetTest::testSendDMX() {
 }
 
 
+/**
+ * Check that frames are held while the output queue is full, and that only the
+ * latest one is sent.
+ */
+void BaseUsbProWidgetTest::testLatestFrameOnly() {
+  // The widget from setUp() would also read from the descriptor.
+  m_widget.reset();
+  ExportMap export_map;
+  QueueingUsbProWidget widget(&m_descriptor);
+  widget.EnableLatestFrameOnly(&m_ss, &export_map, "1234");
+
+  // An empty queue means the frame is sent straight away.
+  DmxBuffer buffer;
+  buffer.SetFromString("0,1,2,3,4");
+  uint8_t dmx_frame_data[] = {ola::DMX512_START_CODE, 0, 1, 2, 3, 4};
+  m_endpoint->AddExpectedUsbProMessage(
+      DMX_FRAME_LABEL,
+      dmx_frame_data,
+      sizeof(dmx_frame_data),
+      ola::NewSingleCallback(this, &BaseUsbProWidgetTest::Terminate));
+  OLA_ASSERT(widget.SendDMX(buffer));
+  m_ss.Run();
+  m_endpoint->Verify();
+
+  // Now the widget is busy, so the first frame is replaced by the second.
+  widget.SetOutputQueueSize(100);
+  buffer.SetFromString("5,6,7");
+  OLA_ASSERT(widget.SendDMX(buffer));
+  buffer.SetFromString("8,9");
+  OLA_ASSERT(widget.SendDMX(buffer));
+
+  unsigned int &frames = (*export_map.GetUIntMapVar(
+      BaseUsbProWidget::K_DMX_FRAMES_VAR))["1234"];
+  unsigned int &frames_replaced = (*export_map.GetUIntMapVar(
+      BaseUsbProWidget::K_DMX_FRAMES_REPLACED_VAR))["1234"];
+  OLA_ASSERT_EQ(1u, frames);
+  OLA_ASSERT_EQ(1u, frames_replaced);
+
+  uint8_t latest_frame_data[] = {ola::DMX512_START_CODE, 8, 9};
+  m_endpoint->AddExpectedUsbProMessage(
+      DMX_FRAME_LABEL,
+      latest_frame_data,
+      sizeof(latest_frame_data),
+      ola::NewSingleCallback(this, &BaseUsbProWidgetTest::Terminate));
+  widget.SetOutputQueueSize(0);
+  m_ss.RegisterSingleTimeout(
+      30,
+      ola::NewSingleCallback(this, &BaseUsbProWidgetTest::Terminate));
+  m_ss.Run();
+  m_endpoint->Verify();
+  OLA_ASSERT_EQ(2u, frames);
+  OLA_ASSERT_EQ(1u, frames_replaced);
+}
+
+
+/**
+ * Check that change of state messages only update the changed slots.
+ */
+void BaseUsbProWidgetTest::testApplyDMXChange() {
+  DmxBuffer buffer;
+  buffer.Blackout();
+
+  // Slots 1, 2 & 20, and the start code.
+  const uint8_t change[] = {0, 0x07, 0, 0x10, 0, 0, 0, 10, 20, 30};
+  OLA_ASSERT(BaseUsbProWidget::ApplyDMXChange(change, sizeof(change),
+                                              &buffer));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ola::DMX_UNIVERSE_SIZE),
+                buffer.Size());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(10), buffer.Get(0));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(20), buffer.Get(1));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), buffer.Get(2));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(30), buffer.Get(19));
+
+  // Starting at block 63, slots 504, 512 & 520. Anything past 512 is ignored.
+  const uint8_t end_change[] = {63, 0x01, 0x01, 0x01, 0, 0, 1, 2, 3};
+  OLA_ASSERT(BaseUsbProWidget::ApplyDMXChange(end_change, sizeof(end_change),
+                                              &buffer));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), buffer.Get(503));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(2), buffer.Get(511));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(10), buffer.Get(0));
+
+  // A non-0 start code
+  const uint8_t alternate_start_code[] = {0, 0x03, 0, 0, 0, 0, 0xcc, 40};
+  OLA_ASSERT_FALSE(BaseUsbProWidget::ApplyDMXChange(
+      alternate_start_code, sizeof(alternate_start_code), &buffer));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(10), buffer.Get(0));
+
+  // Too short
+  OLA_ASSERT_FALSE(BaseUsbProWidget::ApplyDMXChange(change, 6, &buffer));
+}
+
+
 /*
  * Test receiving works.
  */
@@ -19,6 +19,8 @@
  */
 
 #include <string.h>
+#include <algorithm>
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
@@ -77,8 +79,7 @@ DmxTriWidgetImpl::DmxTriWidgetImpl(
       m_rdm_request_callback(NULL),
       m_pending_rdm_request(NULL),
       m_transaction_number(0),
-      m_last_command(RESERVED_COMMAND_ID),
-      m_expected_command(RESERVED_COMMAND_ID) {
+      m_last_command(RESERVED_COMMAND_ID) {
 }
 
 
@@ -281,12 +282,17 @@ void DmxTriWidgetImpl::HandleMessage(uint8_t label,
     length -= DATA_OFFSET;
     data = length ? data + DATA_OFFSET: NULL;
 
-    if (command_id != m_expected_command) {
+    uint8_t expected_command = RESERVED_COMMAND_ID;
+    if (!m_expected_commands.empty()) {
+      expected_command = m_expected_commands.front();
+      m_expected_commands.pop_front();
+    }
+
+    if (command_id != expected_command) {
       OLA_WARN << "Received an unexpected command response, expected "
-               << ToHex(m_expected_command) << ", got " << ToHex(command_id);
+               << ToHex(expected_command) << ", got " << ToHex(command_id);
     }
-    m_last_command = m_expected_command;
-    m_expected_command = RESERVED_COMMAND_ID;
+    m_last_command = expected_command;
 
     switch (command_id) {
       case SINGLE_TX_COMMAND_ID:
@@ -347,16 +353,34 @@ void DmxTriWidgetImpl::SendDiscoveryAuto() {
 
 
 /*
- * Send a RemoteUID message to fetch UID in TRI register.
+ * Send a RemoteUID message to fetch UID in TRI register. This is pipelined, so
+ * we'll keep being called until all the indices have been requested.
  */
 void DmxTriWidgetImpl::FetchNextUID() {
-  m_discovery_state = NO_DISCOVERY_ACTION;
-  if (!m_uid_count)
+  if (!m_uid_count) {
+    m_discovery_state = NO_DISCOVERY_ACTION;
     return;
+  }
 
   OLA_INFO << "Fetching index  " << static_cast<int>(m_uid_count);
   uint8_t data[] = {REMOTE_UID_COMMAND_ID, m_uid_count};
-  SendCommandToTRI(EXTENDED_COMMAND_LABEL, data, sizeof(data));
+  if (!SendCommandToTRI(EXTENDED_COMMAND_LABEL, data, sizeof(data))) {
+    OLA_WARN << "Failed to fetch UID, returning a partial TOD";
+    m_uid_count = 0;
+    m_discovery_state = NO_DISCOVERY_ACTION;
+    if (m_uid_fetches.empty()) {
+      RDMDiscoveryCallback *callback = m_discovery_callback;
+      m_discovery_callback = NULL;
+      RunDiscoveryCallback(callback);
+    }
+    return;
+  }
+
+  m_uid_fetches.push(m_uid_count);
+  m_uid_count--;
+  if (!m_uid_count) {
+    m_discovery_state = NO_DISCOVERY_ACTION;
+  }
 }
 
 /*
@@ -605,18 +629,22 @@ void DmxTriWidgetImpl::HandleDiscoverStatResponse(uint8_t return_code,
 void DmxTriWidgetImpl::HandleRemoteUIDResponse(uint8_t return_code,
                                                const uint8_t *data,
                                                unsigned int length) {
-  if (!m_uid_count) {
+  if (m_uid_fetches.empty()) {
     // not expecting any responses
     OLA_INFO << "Got an unexpected RemoteUID response";
     return;
   }
 
+  // The TRI responds in order, so this is the oldest index we asked for.
+  const uint8_t index = m_uid_fetches.front();
+  m_uid_fetches.pop();
+
   if (return_code == EC_NO_ERROR) {
     if (length < ola::rdm::UID::UID_SIZE) {
       OLA_INFO << "Short RemoteUID response, was " << length;
     } else {
       const UID uid(data);
-      m_uid_index_map[uid] = m_uid_count;
+      m_uid_index_map[uid] = index;
     }
   } else if (return_code == EC_CONSTRAINT) {
     // this is returned if the index is wrong
@@ -626,10 +654,7 @@ void DmxTriWidgetImpl::HandleRemoteUIDResponse(uint8_t return_code,
     OLA_INFO << "RemoteUID returned " << static_cast<int>(return_code);
   }
 
-  m_uid_count--;
-
-  if (m_uid_count) {
-    m_discovery_state = FETCH_UID_REQUIRED;
+  if (m_uid_count || !m_uid_fetches.empty()) {
     MaybeSendNextRequest();
   } else {
     RDMDiscoveryCallback *callback = m_discovery_callback;
@@ -848,7 +873,35 @@ void DmxTriWidgetImpl::HandleSetFilterResponse(uint8_t return_code,
  * Return true if there is an outstanding transaction pending.
  */
 bool DmxTriWidgetImpl::PendingTransaction() const {
-  return m_expected_command != RESERVED_COMMAND_ID;
+  return !m_expected_commands.empty();
+}
+
+
+/**
+ * Return true if another command can be pipelined behind the ones in flight.
+ * This is only the case if all of them are DMX frames or RemoteUID requests.
+ */
+bool DmxTriWidgetImpl::CanPipeline() const {
+  if (m_expected_commands.size() >= MAX_PIPELINE_DEPTH) {
+    return false;
+  }
+
+  std::deque<uint8_t>::const_iterator iter = m_expected_commands.begin();
+  for (; iter != m_expected_commands.end(); ++iter) {
+    if (*iter != SINGLE_TX_COMMAND_ID && *iter != REMOTE_UID_COMMAND_ID) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/**
+ * Return true if a command is in flight.
+ */
+bool DmxTriWidgetImpl::CommandInFlight(uint8_t command_id) const {
+  return (std::find(m_expected_commands.begin(), m_expected_commands.end(),
+                    command_id) != m_expected_commands.end());
 }
 
 /**
@@ -859,16 +912,30 @@ void DmxTriWidgetImpl::MaybeSendNextRequest() {
   // transaction pending.
   bool first = true;
   while (true) {
-    if (PendingTransaction()) {
+    const bool idle = !PendingTransaction();
+    if (!idle && !CanPipeline()) {
       if (first)
         OLA_DEBUG << "Transaction in progress, delaying send";
       return;
     }
     first = false;
 
-    if (m_outgoing_dmx.Size() && m_last_command != SINGLE_TX_COMMAND_ID) {
+    // Only one DMX frame is in flight at once.
+    const bool dmx_ready = (m_outgoing_dmx.Size() &&
+                            !CommandInFlight(SINGLE_TX_COMMAND_ID));
+
+    if (dmx_ready && m_last_command != SINGLE_TX_COMMAND_ID) {
       // avoid starving out DMX frames
       SendDMXBuffer();
+    } else if (!idle) {
+      // only DMX & RemoteUID requests can be pipelined
+      if (m_discovery_state == FETCH_UID_REQUIRED) {
+        FetchNextUID();
+      } else if (dmx_ready) {
+        SendDMXBuffer();
+      } else {
+        return;
+      }
     } else if (m_pending_rdm_request.get()) {
       // there is an RDM command to send
       SendQueuedRDMCommand();
@@ -910,7 +977,7 @@ bool DmxTriWidgetImpl::SendCommandToTRI(uint8_t label, const uint8_t *data,
   bool r = SendMessage(label, data, length);
   if (r && label == EXTENDED_COMMAND_LABEL && length) {
     OLA_DEBUG << "Sent command " << ToHex(data[0]);
-    m_expected_command = data[0];
+    m_expected_commands.push_back(data[0]);
   }
   return r;
 }
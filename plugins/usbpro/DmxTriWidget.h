@@ -21,6 +21,7 @@
 #ifndef PLUGINS_USBPRO_DMXTRIWIDGET_H_
 #define PLUGINS_USBPRO_DMXTRIWIDGET_H_
 
+#include <deque>
 #include <map>
 #include <string>
 #include <queue>
@@ -39,6 +40,10 @@ namespace usbpro {
 /*
  * A DMX TRI Widget implementation. We separate the Widget from the
  * implementation so we can leverage the QueueingRDMController.
+ *
+ * The TRI processes commands in the order they arrive, so DMX frames and
+ * RemoteUID requests are pipelined, up to MAX_PIPELINE_DEPTH at once. All
+ * other commands wait until the widget is idle.
  */
 class DmxTriWidgetImpl: public BaseUsbProWidget,
                         public ola::rdm::DiscoverableRDMControllerInterface {
@@ -84,7 +89,10 @@ class DmxTriWidgetImpl: public BaseUsbProWidget,
 
     ola::thread::SchedulerInterface *m_scheduler;
     UIDToIndexMap m_uid_index_map;
+    // The next index to fetch with RemoteUID.
     uint8_t m_uid_count;
+    // The indices of the RemoteUID requests in flight.
+    std::queue<uint8_t> m_uid_fetches;
     uint16_t m_last_esta_id;
     bool m_use_raw_rdm;
 
@@ -102,8 +110,10 @@ class DmxTriWidgetImpl: public BaseUsbProWidget,
     ola::rdm::RDMCallback *m_rdm_request_callback;
     std::auto_ptr<ola::rdm::RDMRequest> m_pending_rdm_request;
     uint8_t m_transaction_number;
-    // The command id that we expect to see in the response.
-    uint8_t m_last_command, m_expected_command;
+    // The command id of the last response.
+    uint8_t m_last_command;
+    // The command ids we expect to see in the responses, oldest first.
+    std::deque<uint8_t> m_expected_commands;
 
     void SendDMXBuffer();
     void SendQueuedRDMCommand();
@@ -147,6 +157,8 @@ class DmxTriWidgetImpl: public BaseUsbProWidget,
                                  const uint8_t *data,
                                  unsigned int length);
     bool PendingTransaction() const;
+    bool CanPipeline() const;
+    bool CommandInFlight(uint8_t command_id) const;
     void MaybeSendNextRequest();
     void HandleRDMError(ola::rdm::RDMStatusCode error_code);
     bool SendCommandToTRI(uint8_t label, const uint8_t *data,
@@ -198,6 +210,9 @@ class DmxTriWidgetImpl: public BaseUsbProWidget,
 
     // The ms delay between checking on the RDM discovery process
     static const unsigned int RDM_STATUS_INTERVAL_MS = 100;
+
+    // The max number of pipelined commands in flight.
+    static const unsigned int MAX_PIPELINE_DEPTH = 4;
 };
 
 
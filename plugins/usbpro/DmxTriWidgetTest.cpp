@@ -52,6 +52,8 @@ class DmxTriWidgetTest: public CommonWidgetTest {
   CPPUNIT_TEST(testTod);
   CPPUNIT_TEST(testTodFailure);
   CPPUNIT_TEST(testLockedTod);
+  CPPUNIT_TEST(testPipelinedTod);
+  CPPUNIT_TEST(testPipelinedTodFailure);
   CPPUNIT_TEST(testSendDMX);
   CPPUNIT_TEST(testSendRDM);
   CPPUNIT_TEST(testSendRDMErrors);
@@ -69,6 +71,8 @@ class DmxTriWidgetTest: public CommonWidgetTest {
     void testTod();
     void testTodFailure();
     void testLockedTod();
+    void testPipelinedTod();
+    void testPipelinedTodFailure();
     void testSendDMX();
     void testSendRDM();
     void testSendRDMErrors();
@@ -83,12 +87,19 @@ class DmxTriWidgetTest: public CommonWidgetTest {
     auto_ptr<ola::plugin::usbpro::DmxTriWidget> m_widget;
     unsigned int m_tod_counter;
     bool m_expect_uids_in_tod;
+    ola::rdm::UIDSet m_tod;
 
+    void Terminate() { m_ss.Terminate(); }
     void AckSingleTX();
     void AckSingleTxAndTerminate();
     void AckSingleTxAndExpectData();
     void PopulateTod();
     void ValidateTod(const ola::rdm::UIDSet &uids);
+    void StoreTod(const ola::rdm::UIDSet &uids);
+    void StartPipelinedDiscovery();
+    void ExpectFetchUID(uint8_t index, bool terminate);
+    void SendFetchUIDResponse(uint8_t index);
+    void CheckUIDIndex(uint8_t index);
     void ValidateResponse(ola::rdm::RDMStatusCode expected_code,
                           const RDMResponse *expected_response,
                           RDMReply *reply);
@@ -102,7 +113,13 @@ class DmxTriWidgetTest: public CommonWidgetTest {
                                         const UID &destination,
                                         uint8_t code);
 
+    static UID PipelinedUID(uint8_t index) {
+      return UID(0x7a70, 0x100 + index);
+    }
+
     static const uint8_t EXTENDED_LABEL = 0x58;
+    // The number of devices found by StartPipelinedDiscovery().
+    static const uint8_t PIPELINED_DEVICE_COUNT = 6;
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DmxTriWidgetTest);
@@ -135,6 +152,16 @@ void DmxTriWidgetTest::ValidateTod(const ola::rdm::UIDSet &uids) {
 }
 
 
+/**
+ * Store the TOD.
+ */
+void DmxTriWidgetTest::StoreTod(const ola::rdm::UIDSet &uids) {
+  m_tod = uids;
+  m_tod_counter++;
+  m_ss.Terminate();
+}
+
+
 /**
  * Check the response matches what we expected.
  */
@@ -287,6 +314,101 @@ void DmxTriWidgetTest::PopulateTod() {
 }
 
 
+/**
+ * Start a discovery which finds PIPELINED_DEVICE_COUNT devices, and check that
+ * the first four RemoteUID requests are sent before any response arrives.
+ */
+void DmxTriWidgetTest::StartPipelinedDiscovery() {
+  uint8_t expected_discovery = 0x33;
+  uint8_t discovery_ack[] = {0x33, 0x00};
+  m_endpoint->AddExpectedUsbProDataAndReturn(
+      EXTENDED_LABEL,
+      &expected_discovery,
+      sizeof(expected_discovery),
+      EXTENDED_LABEL,
+      discovery_ack,
+      sizeof(discovery_ack));
+
+  uint8_t expected_stat = 0x34;
+  uint8_t stat_ack[] = {0x34, 0x00, PIPELINED_DEVICE_COUNT, 0x00};
+  m_endpoint->AddExpectedUsbProDataAndReturn(
+      EXTENDED_LABEL,
+      &expected_stat,
+      sizeof(expected_stat),
+      EXTENDED_LABEL,
+      stat_ack,
+      sizeof(stat_ack));
+
+  // The pipeline is four deep, and the TRI hasn't replied to any of these.
+  ExpectFetchUID(6, false);
+  ExpectFetchUID(5, false);
+  ExpectFetchUID(4, false);
+  ExpectFetchUID(3, true);
+
+  m_widget->RunFullDiscovery(
+      NewSingleCallback(this, &DmxTriWidgetTest::StoreTod));
+  m_ss.Run();
+  m_endpoint->Verify();
+
+  // Nothing else is sent until a response arrives.
+  m_ss.RunOnce(ola::TimeInterval(0, 100000));
+  m_endpoint->Verify();
+  OLA_ASSERT_EQ(0u, m_tod_counter);
+}
+
+
+/**
+ * Expect a RemoteUID request, without replying to it.
+ */
+void DmxTriWidgetTest::ExpectFetchUID(uint8_t index, bool terminate) {
+  uint8_t expected_fetch_uid[] = {0x35, index};
+  m_endpoint->AddExpectedUsbProMessage(
+      EXTENDED_LABEL,
+      expected_fetch_uid,
+      sizeof(expected_fetch_uid),
+      terminate ?
+        NewSingleCallback(this, &DmxTriWidgetTest::Terminate) : NULL);
+}
+
+
+/**
+ * Send the response to a RemoteUID request.
+ */
+void DmxTriWidgetTest::SendFetchUIDResponse(uint8_t index) {
+  uint8_t response[2 + UID::UID_SIZE] = {0x35, 0x00};
+  PipelinedUID(index).Pack(response + 2, UID::UID_SIZE);
+  m_endpoint->SendUnsolicitedUsbProData(
+      EXTENDED_LABEL,
+      response,
+      sizeof(response));
+}
+
+
+/**
+ * Check that an RDM request to the UID fetched with an index is sent to that
+ * index.
+ */
+void DmxTriWidgetTest::CheckUIDIndex(uint8_t index) {
+  uint8_t expected_rdm_command[] = {0x38, index, 0x00, 0x0a, 0x01, 0x28};
+  uint8_t transaction_mismatch_response[] = {0x38, 0x13};
+  m_endpoint->AddExpectedUsbProDataAndReturn(
+      EXTENDED_LABEL,
+      expected_rdm_command,
+      sizeof(expected_rdm_command),
+      EXTENDED_LABEL,
+      transaction_mismatch_response,
+      sizeof(transaction_mismatch_response));
+
+  m_widget->SendRDMRequest(
+      NewRequest(UID(1, 2), PipelinedUID(index), NULL, 0),
+      NewSingleCallback(this,
+                        &DmxTriWidgetTest::ValidateStatus,
+                        ola::rdm::RDM_TRANSACTION_MISMATCH));
+  m_ss.Run();
+  m_endpoint->Verify();
+}
+
+
 /**
  * Check that the discovery sequence works correctly.
  */
@@ -401,6 +523,101 @@ void DmxTriWidgetTest::testLockedTod() {
 }
 
 
+/**
+ * Check that RemoteUID requests and DMX frames are pipelined.
+ */
+void DmxTriWidgetTest::testPipelinedTod() {
+  StartPipelinedDiscovery();
+
+  // A DMX frame waits for a free slot, and then takes it.
+  DmxBuffer data, data2;
+  data.SetFromString("1,2,3,45");
+  data2.SetFromString("2,2,3,45");
+  m_widget->SendDMX(data);
+  m_ss.RunOnce(ola::TimeInterval(0, 100000));
+  m_endpoint->Verify();
+
+  uint8_t expected_dmx_command1[] = {0x21, 0x00, 0x00, 1, 2, 3, 45};
+  m_endpoint->AddExpectedUsbProMessage(
+      EXTENDED_LABEL,
+      expected_dmx_command1,
+      sizeof(expected_dmx_command1),
+      NewSingleCallback(this, &DmxTriWidgetTest::Terminate));
+  SendFetchUIDResponse(6);
+  m_ss.Run();
+  m_endpoint->Verify();
+
+  // Only one DMX frame is in flight, so the next slots go to RemoteUID
+  // requests.
+  m_widget->SendDMX(data2);
+  ExpectFetchUID(2, true);
+  SendFetchUIDResponse(5);
+  m_ss.Run();
+  m_endpoint->Verify();
+
+  ExpectFetchUID(1, true);
+  SendFetchUIDResponse(4);
+  m_ss.Run();
+  m_endpoint->Verify();
+
+  // There are no indices left to fetch, and the DMX frame is still in flight.
+  SendFetchUIDResponse(3);
+  m_ss.RunOnce(ola::TimeInterval(0, 100000));
+  m_endpoint->Verify();
+
+  // Once the frame is acked, the next one goes out behind the RemoteUID
+  // requests.
+  uint8_t expected_dmx_command2[] = {0x21, 0x00, 0x00, 2, 2, 3, 45};
+  m_endpoint->AddExpectedUsbProMessage(
+      EXTENDED_LABEL,
+      expected_dmx_command2,
+      sizeof(expected_dmx_command2),
+      NewSingleCallback(this, &DmxTriWidgetTest::Terminate));
+  AckSingleTX();
+  m_ss.Run();
+  m_endpoint->Verify();
+  OLA_ASSERT_EQ(0u, m_tod_counter);
+
+  SendFetchUIDResponse(2);
+  SendFetchUIDResponse(1);
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, m_tod_counter);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(PIPELINED_DEVICE_COUNT),
+                m_tod.Size());
+  AckSingleTX();
+  m_ss.RunOnce(ola::TimeInterval(0, 100000));
+
+  // Each UID was matched with the index it was fetched with.
+  for (uint8_t index = 1; index <= PIPELINED_DEVICE_COUNT; index++) {
+    OLA_ASSERT_TRUE(m_tod.Contains(PipelinedUID(index)));
+    CheckUIDIndex(index);
+  }
+}
+
+
+/**
+ * Check that if a RemoteUID request can't be sent, we return the UIDs that
+ * were fetched.
+ */
+void DmxTriWidgetTest::testPipelinedTodFailure() {
+  StartPipelinedDiscovery();
+
+  // The next request fails, but the ones in flight still complete.
+  m_descriptor.CloseClient();
+  SendFetchUIDResponse(6);
+  SendFetchUIDResponse(5);
+  SendFetchUIDResponse(4);
+  SendFetchUIDResponse(3);
+  m_ss.Run();
+
+  OLA_ASSERT_EQ(1u, m_tod_counter);
+  OLA_ASSERT_EQ(4u, m_tod.Size());
+  for (uint8_t index = 3; index <= PIPELINED_DEVICE_COUNT; index++) {
+    OLA_ASSERT_TRUE(m_tod.Contains(PipelinedUID(index)));
+  }
+}
+
+
 /**
  * Check that we send DMX correctly.
  */
@@ -493,48 +493,8 @@ void EnttecPortImpl::HandleIncomingDataMessage(const uint8_t *data,
  * Handle the dmx change of state frame
  */
 void EnttecPortImpl::HandleDMXDiff(const uint8_t *data, unsigned int length) {
-  typedef struct {
-    uint8_t start;
-    uint8_t changed[5];
-    uint8_t data[40];
-  } widget_data_changed;
-
-  // The minimum packet length is 1 byte start_pos, 5 bytes bitmap
-  // and one changed databyte. A length-6 packet would be valid (if
-  // no bits in the changed bitmap was set), but nonsensical to
-  // transmit. In any case, ignoring it would at least work.
-  if ((length < 7) || (length > sizeof(widget_data_changed))) {
-    OLA_WARN << "Change of state packet has an invalid length: " << length;
-    return;
-  }
-
-  const widget_data_changed *widget_reply =
-      reinterpret_cast<const widget_data_changed*>(data);
-
-  unsigned int start_channel = widget_reply->start * 8;
-  unsigned int offset = 0;
-
-  // skip non-0 start codes, this code is pretty messed up because the USB Pro
-  // doesn't seem to provide a guarantee on the ordering of packets. Packets
-  // with non-0 start codes are almost certainly going to cause problems.
-  if (start_channel == 0 && (widget_reply->changed[0] & 0x01) &&
-      widget_reply->data[offset]) {
-    return;
-  }
-
-  for (int i = 0; i < 40; i++) {
-    if (start_channel + i > DMX_UNIVERSE_SIZE + 1 || offset + 6 >= length) {
-      break;
-    }
-
-    if (widget_reply->changed[i/8] & (1 << (i % 8)) && start_channel + i != 0) {
-      m_input_buffer.SetChannel(start_channel + i - 1,
-                                widget_reply->data[offset]);
-      offset++;
-    }
-  }
-
-  if (m_dmx_callback.get()) {
+  if (BaseUsbProWidget::ApplyDMXChange(data, length, &m_input_buffer) &&
+      m_dmx_callback.get()) {
     m_dmx_callback->Run();
   }
 }
@@ -729,6 +689,9 @@ class EnttecUsbProWidgetImpl : public BaseUsbProWidget {
     unsigned int PortCount() const { return m_ports.size(); }
     EnttecPort *GetPort(unsigned int i);
 
+    void EnableLatestFrameOnly(ola::ExportMap *export_map,
+                               const std::string &key);
+
     bool SendCommand(uint8_t label, const uint8_t *data, unsigned int length);
 
  private:
@@ -740,6 +703,7 @@ class EnttecUsbProWidgetImpl : public BaseUsbProWidget {
 
     vector<EnttecPort*> m_ports;
     vector<EnttecPortImpl*> m_port_impls;
+    vector<OperationLabels> m_port_ops;
     auto_ptr<EnttecPortImpl::SendCallback> m_send_cb;
     UID m_uid;
     PortAssignmentCallbacks m_port_assignment_callbacks;
@@ -820,6 +784,7 @@ void EnttecUsbProWidgetImpl::Stop() {
     m_scheduler->RemoveTimeout(m_watchdog_timer_id);
     m_watchdog_timer_id = ola::thread::INVALID_TIMEOUT;
   }
+  DiscardPendingDMX();
 
   vector<EnttecPortImpl*>::iterator iter = m_port_impls.begin();
   for (; iter != m_port_impls.end(); ++iter) {
@@ -846,12 +811,28 @@ EnttecPort *EnttecUsbProWidgetImpl::GetPort(unsigned int i) {
 }
 
 
+void EnttecUsbProWidgetImpl::EnableLatestFrameOnly(
+    ola::ExportMap *export_map,
+    const std::string &key) {
+  BaseUsbProWidget::EnableLatestFrameOnly(m_scheduler, export_map, key);
+}
+
+
 /**
  * Send a command to the widget
  */
 bool EnttecUsbProWidgetImpl::SendCommand(uint8_t label, const uint8_t *data,
                                          unsigned int length) {
   OLA_DEBUG << "TX: " << IntToString(label) << ", length " << length;
+  vector<OperationLabels>::const_iterator iter = m_port_ops.begin();
+  for (; iter != m_port_ops.end(); ++iter) {
+    if (label == iter->send_dmx) {
+      return SendDMXMessage(label, data, length);
+    } else if (label == iter->change_to_rx_mode) {
+      // Don't let a held frame switch the port back to output.
+      DiscardPendingDMX();
+    }
+  }
   return SendMessage(label, data, length);
 }
 
@@ -924,6 +905,7 @@ void EnttecUsbProWidgetImpl::AddPort(const OperationLabels &ops,
                                      bool enable_rdm) {
   EnttecPortImpl *impl = new EnttecPortImpl(ops, m_uid, m_send_cb.get());
   m_port_impls.push_back(impl);
+  m_port_ops.push_back(ops);
   EnttecPort *port = new EnttecPort(impl, queue_size, enable_rdm);
   m_ports.push_back(port);
 }
@@ -974,6 +956,11 @@ void EnttecUsbProWidget::Stop() {
   m_impl->Stop();
 }
 
+void EnttecUsbProWidget::EnableLatestFrameOnly(ola::ExportMap *export_map,
+                                               const std::string &key) {
+  m_impl->EnableLatestFrameOnly(export_map, key);
+}
+
 unsigned int EnttecUsbProWidget::PortCount() const {
   return m_impl->PortCount();
 }
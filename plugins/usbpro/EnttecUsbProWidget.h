@@ -26,6 +26,7 @@
 #include <string>
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/thread/SchedulerInterface.h"
 #include "ola/rdm/DiscoveryAgent.h"
 #include "ola/rdm/QueueingRDMController.h"
@@ -123,6 +124,14 @@ class EnttecUsbProWidget: public SerialWidgetInterface {
     void GetPortAssignments(EnttecUsbProPortAssignmentCallback *callback);
 
     void Stop();
+
+    /*
+     * Hold each port's DMX frame until the widget has caught up, and only
+     * keep the latest one. See BaseUsbProWidget::EnableLatestFrameOnly().
+     */
+    void EnableLatestFrameOnly(ola::ExportMap *export_map,
+                               const std::string &key);
+
     unsigned int PortCount() const;
     EnttecPort *GetPort(unsigned int i);
     ola::io::ConnectedDescriptor *GetDescriptor() const;
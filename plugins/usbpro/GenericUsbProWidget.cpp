@@ -103,6 +103,8 @@ bool GenericUsbProWidget::ChangeToReceiveMode(bool change_only) {
     return false;
   }
 
+  // Don't let a held frame switch the widget back to output.
+  DiscardPendingDMX();
   uint8_t mode = change_only;
   bool status = SendMessage(DMX_RX_MODE_LABEL, &mode, sizeof(mode));
 
@@ -264,48 +266,7 @@ void GenericUsbProWidget::HandleParameters(const uint8_t *data,
  */
 void GenericUsbProWidget::HandleDMXDiff(const uint8_t *data,
                                         unsigned int length) {
-  typedef struct {
-    uint8_t start;
-    uint8_t changed[5];
-    uint8_t data[40];
-  } widget_data_changed;
-
-  // The minimum packet length is 1 byte start_pos, 5 bytes bitmap
-  // and one changed databyte. A length-6 packet would be valid (if
-  // no bits in the changed bitmap was set), but nonsensical to
-  // transmit. In any case, ignoring it would at least work.
-  if ((length < 7) || (length > sizeof(widget_data_changed))) {
-    OLA_WARN << "Change of state packet has an invalid length: " << length;
-    return;
-  }
-
-  const widget_data_changed *widget_reply =
-    reinterpret_cast<const widget_data_changed*>(data);
-
-  unsigned int start_channel = widget_reply->start * 8;
-  unsigned int offset = 0;
-
-  // skip non-0 start codes, this code is pretty messed up because the USB Pro
-  // doesn't seem to provide a guarantee on the ordering of packets. Packets
-  // with non-0 start codes are almost certainly going to cause problems.
-  if (start_channel == 0 && (widget_reply->changed[0] & 0x01) &&
-      widget_reply->data[offset]) {
-    return;
-  }
-
-  for (int i = 0; i < 40; i++) {
-    if (start_channel + i > DMX_UNIVERSE_SIZE + 1 || offset + 6 >= length) {
-      break;
-    }
-
-    if (widget_reply->changed[i/8] & (1 << (i % 8)) && start_channel + i != 0) {
-      m_input_buffer.SetChannel(start_channel + i - 1,
-                                widget_reply->data[offset]);
-      offset++;
-    }
-  }
-
-  if (m_dmx_callback) {
+  if (ApplyDMXChange(data, length, &m_input_buffer) && m_dmx_callback) {
     m_dmx_callback->Run();
   }
 }
@@ -30,6 +30,8 @@ plugins_usbpro_libolausbprowidget_la_SOURCES = \
     plugins/usbpro/UltraDMXProWidget.h \
     plugins/usbpro/UsbProWidgetDetector.cpp \
     plugins/usbpro/UsbProWidgetDetector.h \
+    plugins/usbpro/WidgetDetectionCache.cpp \
+    plugins/usbpro/WidgetDetectionCache.h \
     plugins/usbpro/WidgetDetectorInterface.h \
     plugins/usbpro/WidgetDetectorThread.cpp \
     plugins/usbpro/WidgetDetectorThread.h
@@ -153,6 +155,7 @@ plugins_usbpro_UsbProWidgetDetectorTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 plugins_usbpro_UsbProWidgetDetectorTester_LDADD = $(COMMON_USBPRO_TEST_LDADD)
 
 plugins_usbpro_WidgetDetectorThreadTester_SOURCES = \
+    plugins/usbpro/WidgetDetectionCacheTest.cpp \
     plugins/usbpro/WidgetDetectorThreadTest.cpp \
     $(common_test_sources)
 plugins_usbpro_WidgetDetectorThreadTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
@@ -54,7 +54,8 @@ UltraDMXProDevice::UltraDMXProDevice(ola::PluginAdaptor *plugin_adaptor,
                                      OLA_UNUSED uint16_t device_id,
                                      uint32_t serial,
                                      uint16_t firmware_version,
-                                     unsigned int fps_limit):
+                                     unsigned int fps_limit,
+                                     bool latest_frame_only):
     UsbSerialDevice(owner, name, widget),
     m_ultra_widget(widget),
     m_serial(),
@@ -74,6 +75,10 @@ UltraDMXProDevice::UltraDMXProDevice(ola::PluginAdaptor *plugin_adaptor,
   str << "Serial #: " << m_serial << ", firmware "
       << (firmware_version >> 8) << "." << (firmware_version & 0xff);
 
+  if (latest_frame_only) {
+    m_ultra_widget->EnableLatestFrameOnly(
+        plugin_adaptor, plugin_adaptor->GetExportMap(), m_serial);
+  }
 
   m_ultra_widget->GetParameters(NewSingleCallback(
     this,
@@ -101,7 +106,8 @@ UltraDMXProDevice::UltraDMXProDevice(ola::PluginAdaptor *plugin_adaptor,
       plugin_adaptor->WakeUpTime(),
       5,  // allow up to 5 burst frames
       fps_limit,
-      true);
+      true,
+      !latest_frame_only);
   AddPort(output_port);
 
   // add the secondary port
@@ -113,7 +119,8 @@ UltraDMXProDevice::UltraDMXProDevice(ola::PluginAdaptor *plugin_adaptor,
       plugin_adaptor->WakeUpTime(),
       5,  // allow up to 5 burst frames
       fps_limit,
-      false);
+      false,
+      !latest_frame_only);
   AddPort(output_port);
 }
 
@@ -49,7 +49,8 @@ class UltraDMXProDevice: public UsbSerialDevice {
                     uint16_t device_id,
                     uint32_t serial,
                     uint16_t firmware_version,
-                    unsigned int fps_limit);
+                    unsigned int fps_limit,
+                    bool latest_frame_only);
 
   std::string DeviceId() const { return m_serial; }
   // both output ports can be bound to the same universe
@@ -130,16 +131,19 @@ class UltraDMXProOutputPort: public BasicOutputPort {
                         const TimeStamp *wake_time,
                         unsigned int max_burst,
                         unsigned int rate,
-                        bool primary)
+                        bool primary,
+                        bool rate_limit)
       : BasicOutputPort(parent, id),
         m_description(description),
         m_widget(widget),
         m_bucket(max_burst, rate, max_burst, *wake_time),
         m_wake_time(wake_time),
-        m_primary(primary) {}
+        m_primary(primary),
+        m_rate_limit(rate_limit) {}
 
   bool WriteDMX(const DmxBuffer &buffer, OLA_UNUSED uint8_t priority) {
-    if (m_bucket.GetToken(*m_wake_time)) {
+    // In latest frame only mode the widget paces the frames itself.
+    if (!m_rate_limit || m_bucket.GetToken(*m_wake_time)) {
       return m_primary ? m_widget->SendDMX(buffer)
           : m_widget->SendSecondaryDMX(buffer);
     } else {
@@ -156,6 +160,7 @@ class UltraDMXProOutputPort: public BasicOutputPort {
   TokenBucket m_bucket;
   const TimeStamp *m_wake_time;
   bool m_primary;
+  const bool m_rate_limit;
 };
 }  // namespace usbpro
 }  // namespace plugin
@@ -35,17 +35,33 @@ UltraDMXProWidget::UltraDMXProWidget(
 
 
 bool UltraDMXProWidget::SendDMX(const DmxBuffer &buffer) {
-  return SendDMXWithLabel(DMX_PRIMARY_PORT, buffer);
+  return SendDMXWithLabel(DMX_PRIMARY_PORT, buffer, &m_primary_frame);
 }
 
 
 bool UltraDMXProWidget::SendSecondaryDMX(const DmxBuffer &buffer) {
-  return SendDMXWithLabel(DMX_SECONDARY_PORT, buffer);
+  return SendDMXWithLabel(DMX_SECONDARY_PORT, buffer, &m_secondary_frame);
+}
+
+
+/*
+ * Once the widget has been in receive mode the output frames need to be sent
+ * again.
+ */
+bool UltraDMXProWidget::ChangeToReceiveMode(bool change_only) {
+  m_primary_frame.Reset();
+  m_secondary_frame.Reset();
+  return GenericUsbProWidget::ChangeToReceiveMode(change_only);
 }
 
 
 bool UltraDMXProWidget::SendDMXWithLabel(uint8_t label,
-                                         const DmxBuffer &data) {
+                                         const DmxBuffer &data,
+                                         DmxBuffer *last_frame) {
+  if (last_frame->Size() && *last_frame == data) {
+    return true;
+  }
+
   struct {
     uint8_t start_code;
     uint8_t dmx[DMX_UNIVERSE_SIZE];
@@ -54,9 +70,13 @@ bool UltraDMXProWidget::SendDMXWithLabel(uint8_t label,
   widget_dmx.start_code = DMX512_START_CODE;
   unsigned int length = DMX_UNIVERSE_SIZE;
   data.Get(widget_dmx.dmx, &length);
-  return SendMessage(label,
-                     reinterpret_cast<uint8_t*>(&widget_dmx),
-                     length + 1);
+  if (!SendDMXMessage(label,
+                      reinterpret_cast<uint8_t*>(&widget_dmx),
+                      length + 1)) {
+    return false;
+  }
+  *last_frame = data;
+  return true;
 }
 }  // namespace usbpro
 }  // namespace plugin
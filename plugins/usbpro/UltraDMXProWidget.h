@@ -33,7 +33,10 @@ namespace plugin {
 namespace usbpro {
 
 /*
- * An Ultra DMX Pro Widget
+ * An Ultra DMX Pro Widget.
+ *
+ * The widget keeps sending the last frame it was given for each port, so a
+ * frame that's the same as the previous one isn't written to the serial port.
  */
 class UltraDMXProWidget: public GenericUsbProWidget {
  public:
@@ -43,9 +46,15 @@ class UltraDMXProWidget: public GenericUsbProWidget {
 
     bool SendDMX(const DmxBuffer &buffer);
     bool SendSecondaryDMX(const DmxBuffer &buffer);
+    bool ChangeToReceiveMode(bool change_only);
 
  private:
-    bool SendDMXWithLabel(uint8_t label, const DmxBuffer &data);
+    // The last frame written for each output port.
+    DmxBuffer m_primary_frame;
+    DmxBuffer m_secondary_frame;
+
+    bool SendDMXWithLabel(uint8_t label, const DmxBuffer &data,
+                          DmxBuffer *last_frame);
 
     static const uint8_t DMX_PRIMARY_PORT = 100;
     static const uint8_t DMX_SECONDARY_PORT = 101;
@@ -25,6 +25,7 @@
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
+#include "ola/testing/TestUtils.h"
 #include "plugins/usbpro/UltraDMXProWidget.h"
 #include "plugins/usbpro/CommonWidgetTest.h"
 
@@ -37,12 +38,14 @@ class UltraDMXProWidgetTest: public CommonWidgetTest {
   CPPUNIT_TEST_SUITE(UltraDMXProWidgetTest);
   CPPUNIT_TEST(testPrimarySendDMX);
   CPPUNIT_TEST(testSecondarySendDMX);
+  CPPUNIT_TEST(testUnchangedFrames);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void setUp();
     void testPrimarySendDMX();
     void testSecondarySendDMX();
+    void testUnchangedFrames();
 
  private:
     auto_ptr<ola::plugin::usbpro::UltraDMXProWidget> m_widget;
@@ -129,3 +132,45 @@ void UltraDMXProWidgetTest::testSecondarySendDMX() {
   m_ss.Run();
   m_endpoint->Verify();
 }
+
+
+/**
+ * Check that a frame that matches the last one for a port isn't sent.
+ */
+void UltraDMXProWidgetTest::testUnchangedFrames() {
+  DmxBuffer buffer;
+  buffer.SetFromString("0,1,2,3,4");
+  uint8_t dmx_frame_data[] = {ola::DMX512_START_CODE, 0, 1, 2, 3, 4};
+  m_endpoint->AddExpectedUsbProMessage(
+      PRIMARY_DMX_LABEL,
+      dmx_frame_data,
+      sizeof(dmx_frame_data),
+      ola::NewSingleCallback(this, &UltraDMXProWidgetTest::Terminate));
+  OLA_ASSERT(m_widget->SendDMX(buffer));
+  m_ss.Run();
+  m_endpoint->Verify();
+
+  // The repeated frame is skipped, so the next message is the changed one.
+  OLA_ASSERT(m_widget->SendDMX(buffer));
+  DmxBuffer buffer2;
+  buffer2.SetFromString("0,1,2,3,5");
+  uint8_t changed_frame_data[] = {ola::DMX512_START_CODE, 0, 1, 2, 3, 5};
+  m_endpoint->AddExpectedUsbProMessage(
+      PRIMARY_DMX_LABEL,
+      changed_frame_data,
+      sizeof(changed_frame_data),
+      ola::NewSingleCallback(this, &UltraDMXProWidgetTest::Terminate));
+  OLA_ASSERT(m_widget->SendDMX(buffer2));
+  m_ss.Run();
+  m_endpoint->Verify();
+
+  // Each port tracks its own frame.
+  m_endpoint->AddExpectedUsbProMessage(
+      SECONDARY_DMX_LABEL,
+      changed_frame_data,
+      sizeof(changed_frame_data),
+      ola::NewSingleCallback(this, &UltraDMXProWidgetTest::Terminate));
+  OLA_ASSERT(m_widget->SendSecondaryDMX(buffer2));
+  m_ss.Run();
+  m_endpoint->Verify();
+}
@@ -55,7 +55,8 @@ UsbProDevice::UsbProDevice(ola::PluginAdaptor *plugin_adaptor,
                            EnttecUsbProWidget *widget,
                            uint32_t serial,
                            uint16_t firmware_version,
-                           unsigned int fps_limit)
+                           unsigned int fps_limit,
+                           bool latest_frame_only)
     : UsbSerialDevice(owner, name, widget),
       m_pro_widget(widget),
       m_serial(SerialToString(serial)) {
@@ -64,6 +65,10 @@ UsbProDevice::UsbProDevice(ola::PluginAdaptor *plugin_adaptor,
       << (firmware_version >> 8) << "." << (firmware_version & 0xff);
   SetName(str.str());
 
+  if (latest_frame_only) {
+    widget->EnableLatestFrameOnly(plugin_adaptor->GetExportMap(), m_serial);
+  }
+
   for (unsigned int i = 0; i < widget->PortCount(); i++) {
     EnttecPort *enttec_port = widget->GetPort(i);
     if (!enttec_port) {
@@ -87,7 +92,8 @@ UsbProDevice::UsbProDevice(ola::PluginAdaptor *plugin_adaptor,
         this, enttec_port, i, port_description.str(),
         plugin_adaptor->WakeUpTime(),
         5,  // allow up to 5 burst frames
-        fps_limit);  // 200 frames per second seems to be the limit
+        fps_limit,  // 200 frames per second seems to be the limit
+        !latest_frame_only);
     AddPort(output_port);
 
     PortParams port_params = {false, 0, 0, 0};
@@ -47,7 +47,8 @@ class UsbProDevice: public UsbSerialDevice {
                EnttecUsbProWidget *widget,
                uint32_t serial,
                uint16_t firmware_version,
-               unsigned int fps_limit);
+               unsigned int fps_limit,
+               bool latest_frame_only);
 
   std::string DeviceId() const { return m_serial; }
 
@@ -148,15 +149,18 @@ class UsbProOutputPort: public BasicOutputPort {
                    const std::string &description,
                    const TimeStamp *wake_time,
                    unsigned int max_burst,
-                   unsigned int rate)
+                   unsigned int rate,
+                   bool rate_limit)
       : BasicOutputPort(parent, id, port->SupportsRDM(), port->SupportsRDM()),
         m_description(description),
         m_port(port),
         m_bucket(max_burst, rate, max_burst, *wake_time),
-        m_wake_time(wake_time) {}
+        m_wake_time(wake_time),
+        m_rate_limit(rate_limit) {}
 
   bool WriteDMX(const DmxBuffer &buffer, uint8_t) {
-    if (m_bucket.GetToken(*m_wake_time)) {
+    // In latest frame only mode the widget paces the frames itself.
+    if (!m_rate_limit || m_bucket.GetToken(*m_wake_time)) {
       return m_port->SendDMX(buffer);
     } else {
       OLA_INFO << "Port rated limited, dropping frame";
@@ -190,6 +194,7 @@ class UsbProOutputPort: public BasicOutputPort {
   EnttecPort *m_port;
   TokenBucket m_bucket;
   const TimeStamp *m_wake_time;
+  const bool m_rate_limit;
 };
 }  // namespace usbpro
 }  // namespace plugin
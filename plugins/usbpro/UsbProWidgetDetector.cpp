@@ -33,6 +33,10 @@
  * (https://wiki.openlighting.org/index.php/USB_Protocol_Extensions) and allow
  * us to determine more specfically what type of device this is.
  *
+ * If the widget has been seen before, the cached information can be passed to
+ * Discover(). Then only SERIAL_LABEL is sent, and the full process is only
+ * run if the serial number doesn't match.
+ *
  * If the widget responds to SERIAL_LABEL the on_success callback is run.
  * Otherwise on_failure is run. It's important you register callbacks for each
  * of these otherwise you'll leak ConnectedDescriptor objects.
@@ -70,6 +74,7 @@ UsbProWidgetInformation& UsbProWidgetInformation::operator=(
   serial = other.serial;
   has_firmware_version = other.has_firmware_version;
   firmware_version = other.firmware_version;
+  dual_port = other.dual_port;
   return *this;
 }
 
@@ -145,6 +150,34 @@ bool UsbProWidgetDetector::Discover(
 }
 
 
+/*
+ * Start the discovery process for a widget we've seen before.
+ */
+bool UsbProWidgetDetector::Discover(
+    ola::io::ConnectedDescriptor *descriptor,
+    const UsbProWidgetInformation &cached) {
+  DispatchingUsbProWidget *widget = new DispatchingUsbProWidget(
+      descriptor,
+      NULL);
+  widget->SetHandler(
+      NewCallback(this, &UsbProWidgetDetector::HandleMessage, widget));
+
+  if (!widget->SendMessage(BaseUsbProWidget::SERIAL_LABEL, NULL, 0)) {
+    delete widget;
+    return false;
+  }
+
+  descriptor->SetOnClose(
+      NewSingleCallback(this, &UsbProWidgetDetector::WidgetRemoved, widget));
+
+  DiscoveryState &discovery_state = m_widgets[widget];
+  discovery_state.discovery_state = DiscoveryState::CACHED_SERIAL_SENT;
+  discovery_state.information = cached;
+  SetupTimeout(widget, &discovery_state);
+  return true;
+}
+
+
 /*
  * Called by the widgets when they receive a response.
  */
@@ -224,6 +257,19 @@ void UsbProWidgetDetector::RemoveTimeout(DiscoveryState *discovery_state) {
 }
 
 
+/**
+ * Send a MANUFACTURER_LABEL request, this starts the full discovery process.
+ */
+void UsbProWidgetDetector::SendManufacturerRequest(
+    DispatchingUsbProWidget *widget) {
+  widget->SendMessage(DispatchingUsbProWidget::MANUFACTURER_LABEL, NULL, 0);
+  DiscoveryState &discovery_state = m_widgets[widget];
+  discovery_state.discovery_state = DiscoveryState::MANUFACTURER_SENT;
+  discovery_state.information = UsbProWidgetInformation();
+  SetupTimeout(widget, &discovery_state);
+}
+
+
 /**
  * Send a DEVICE_LABEL request
  */
@@ -307,6 +353,10 @@ void UsbProWidgetDetector::DiscoveryTimeout(DispatchingUsbProWidget *widget) {
   if (iter != m_widgets.end()) {
     iter->second.timeout_id = ola::thread::INVALID_TIMEOUT;
     switch (iter->second.discovery_state) {
+      case DiscoveryState::CACHED_SERIAL_SENT:
+        OLA_INFO << "Cached USB widget didn't respond, running full discovery";
+        SendManufacturerRequest(widget);
+        break;
       case DiscoveryState::MANUFACTURER_SENT:
         SendNameRequest(widget);
         break;
@@ -402,6 +452,24 @@ void UsbProWidgetDetector::HandleSerialResponse(
   RemoveTimeout(&iter->second);
   UsbProWidgetInformation information = iter->second.information;
 
+  if (iter->second.discovery_state == DiscoveryState::CACHED_SERIAL_SENT) {
+    UsbProWidgetInformation::DeviceSerialNumber serial;
+    if (length == sizeof(serial)) {
+      memcpy(reinterpret_cast<uint8_t*>(&serial), data, sizeof(serial));
+      if (ola::network::LittleEndianToHost(serial) == information.serial) {
+        if (information.dual_port) {
+          SendAPIRequest(widget);
+        }
+        CompleteWidgetDiscovery(widget);
+        return;
+      }
+    }
+    OLA_INFO << "USB widget serial doesn't match the cache, running full "
+             << "discovery";
+    SendManufacturerRequest(widget);
+    return;
+  }
+
   if (length == sizeof(information.serial)) {
     UsbProWidgetInformation::DeviceSerialNumber serial;
     memcpy(reinterpret_cast<uint8_t*>(&serial), data, sizeof(serial));
@@ -98,6 +98,17 @@ class UsbProWidgetDetector: public WidgetDetectorInterface {
 
   bool Discover(ola::io::ConnectedDescriptor *descriptor);
 
+  /**
+   * @brief Start discovery for a widget we've seen before.
+   * @param descriptor the descriptor to run discovery on.
+   * @param cached the information from the last time the widget was found.
+   *
+   * Only the serial number is requested. If it matches the cached serial, the
+   * cached information is used, otherwise the full discovery process runs.
+   */
+  bool Discover(ola::io::ConnectedDescriptor *descriptor,
+                const UsbProWidgetInformation &cached);
+
  private:
   // Hold the discovery state for a widget
   class DiscoveryState {
@@ -111,6 +122,7 @@ class UsbProWidgetDetector: public WidgetDetectorInterface {
     ~DiscoveryState() {}
 
     typedef enum {
+      CACHED_SERIAL_SENT,
       MANUFACTURER_SENT,
       DEVICE_SENT,
       SERIAL_SENT,
@@ -141,6 +153,7 @@ class UsbProWidgetDetector: public WidgetDetectorInterface {
   void SetupTimeout(DispatchingUsbProWidget *widget,
                     DiscoveryState *discovery_state);
   void RemoveTimeout(DiscoveryState *discovery_state);
+  void SendManufacturerRequest(DispatchingUsbProWidget *widget);
   void SendNameRequest(DispatchingUsbProWidget *widget);
   void SendSerialRequest(DispatchingUsbProWidget *widget);
   void SendGetParams(DispatchingUsbProWidget *widget);
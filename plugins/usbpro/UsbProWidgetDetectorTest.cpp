@@ -39,6 +39,8 @@ class UsbProWidgetDetectorTest: public CommonWidgetTest {
   CPPUNIT_TEST_SUITE(UsbProWidgetDetectorTest);
   CPPUNIT_TEST(testExtendedDiscovery);
   CPPUNIT_TEST(testDiscovery);
+  CPPUNIT_TEST(testCachedDiscovery);
+  CPPUNIT_TEST(testCachedSerialMismatch);
   CPPUNIT_TEST(testTimeout);
   CPPUNIT_TEST(testSniffer);
   CPPUNIT_TEST_SUITE_END();
@@ -48,6 +50,8 @@ class UsbProWidgetDetectorTest: public CommonWidgetTest {
 
   void testExtendedDiscovery();
   void testDiscovery();
+  void testCachedDiscovery();
+  void testCachedSerialMismatch();
   void testTimeout();
   void testSniffer();
 
@@ -210,6 +214,78 @@ void UsbProWidgetDetectorTest::testDiscovery() {
 }
 
 
+/*
+ * Check that a cached widget only needs to confirm its serial number.
+ */
+void UsbProWidgetDetectorTest::testCachedDiscovery() {
+  uint8_t serial_data[] = {0x78, 0x56, 0x34, 0x12};
+  UsbProWidgetInformation cached;
+  cached.esta_id = 0x7a70;
+  cached.device_id = 0x534e;
+  cached.serial = 0x12345678;
+  cached.device = "Unittest Device";
+
+  m_endpoint->AddExpectedUsbProDataAndReturn(
+      SERIAL_LABEL,
+      NULL,
+      0,
+      SERIAL_LABEL,
+      serial_data,
+      sizeof(serial_data));
+
+  m_detector->Discover(&m_descriptor, cached);
+  m_ss.Run();
+
+  OLA_ASSERT(m_found_widget);
+  OLA_ASSERT_FALSE(m_failed_widget);
+  OLA_ASSERT_EQ(cached.esta_id, m_device_info.esta_id);
+  OLA_ASSERT_EQ(cached.device_id, m_device_info.device_id);
+  OLA_ASSERT_EQ(cached.device, m_device_info.device);
+  OLA_ASSERT_EQ(cached.serial, m_device_info.serial);
+}
+
+
+/*
+ * Check that the full discovery runs if the serial number has changed.
+ */
+void UsbProWidgetDetectorTest::testCachedSerialMismatch() {
+  uint32_t expected_serial = 0x12345678;
+  uint8_t serial_data[] = {0x78, 0x56, 0x34, 0x12};
+  uint8_t get_params_request[] = {0, 0};
+  UsbProWidgetInformation cached;
+  cached.esta_id = 0x7a70;
+  cached.serial = 0x87654321;
+
+  m_endpoint->AddExpectedUsbProDataAndReturn(
+      SERIAL_LABEL,
+      NULL,
+      0,
+      SERIAL_LABEL,
+      serial_data,
+      sizeof(serial_data));
+  m_endpoint->AddExpectedUsbProMessage(MANUFACTURER_LABEL, NULL, 0);
+  m_endpoint->AddExpectedUsbProMessage(DEVICE_LABEL, NULL, 0);
+  m_endpoint->AddExpectedUsbProDataAndReturn(
+      SERIAL_LABEL,
+      NULL,
+      0,
+      SERIAL_LABEL,
+      serial_data,
+      sizeof(serial_data));
+  m_endpoint->AddExpectedUsbProMessage(GET_PARAMS, &get_params_request[0],
+                                       sizeof(get_params_request));
+  m_endpoint->AddExpectedUsbProMessage(HARDWARE_VERSION_LABEL, NULL, 0);
+
+  m_detector->Discover(&m_descriptor, cached);
+  m_ss.Run();
+
+  OLA_ASSERT(m_found_widget);
+  OLA_ASSERT_FALSE(m_failed_widget);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0), m_device_info.esta_id);
+  OLA_ASSERT_EQ(expected_serial, m_device_info.serial);
+}
+
+
 /**
  * Check a widget that fails to respond
  */
@@ -52,9 +52,11 @@ using std::string;
 using std::vector;
 
 const char UsbSerialPlugin::DEFAULT_DEVICE_DIR[] = "/dev";
+const char UsbSerialPlugin::DETECTION_CACHE_KEY[] = "detection_cache";
 const char UsbSerialPlugin::DEVICE_DIR_KEY[] = "device_dir";
 const char UsbSerialPlugin::DEVICE_PREFIX_KEY[] = "device_prefix";
 const char UsbSerialPlugin::IGNORED_DEVICES_KEY[] = "ignore_device";
+const char UsbSerialPlugin::LATEST_FRAME_ONLY_KEY[] = "latest_frame_only";
 const char UsbSerialPlugin::LINUX_DEVICE_PREFIX[] = "ttyUSB";
 const char UsbSerialPlugin::BSD_DEVICE_PREFIX[] = "ttyU";
 const char UsbSerialPlugin::MAC_DEVICE_PREFIX[] = "cu.usbserial-";
@@ -132,7 +134,9 @@ void UsbSerialPlugin::NewWidget(
 
   AddDevice(new UsbProDevice(m_plugin_adaptor, this, device_name, widget,
                              information.serial, information.firmware_version,
-                             GetProFrameLimit()));
+                             GetProFrameLimit(),
+                             m_preferences->GetValueAsBool(
+                                 LATEST_FRAME_ONLY_KEY)));
 }
 
 
@@ -198,7 +202,8 @@ void UsbSerialPlugin::NewWidget(UltraDMXProWidget *widget,
       information.device_id,
       information.serial,
       information.firmware_version,
-      GetUltraDMXProFrameLimit()));
+      GetUltraDMXProFrameLimit(),
+      m_preferences->GetValueAsBool(LATEST_FRAME_ONLY_KEY)));
 }
 
 
@@ -232,6 +237,8 @@ bool UsbSerialPlugin::StartHook() {
       m_preferences->GetValue(DEVICE_DIR_KEY));
   m_detector_thread.SetDevicePrefixes(
       m_preferences->GetMultipleValue(DEVICE_PREFIX_KEY));
+  m_detector_thread.SetCacheFile(
+      m_preferences->GetValue(DETECTION_CACHE_KEY));
   if (!m_detector_thread.Start()) {
     OLA_FATAL << "Failed to start the widget discovery thread";
     return false;
@@ -278,6 +285,9 @@ bool UsbSerialPlugin::SetDefaultPreferences() {
   save |= m_preferences->SetDefaultValue(DEVICE_DIR_KEY, StringValidator(),
                                          DEFAULT_DEVICE_DIR);
 
+  save |= m_preferences->SetDefaultValue(DETECTION_CACHE_KEY,
+                                         StringValidator(true), "");
+
   save |= m_preferences->SetDefaultValue(USB_PRO_FPS_LIMIT_KEY,
                                          UIntValidator(0, MAX_PRO_FPS_LIMIT),
                                          DEFAULT_PRO_FPS_LIMIT);
@@ -290,6 +300,10 @@ bool UsbSerialPlugin::SetDefaultPreferences() {
                                          BoolValidator(),
                                          false);
 
+  save |= m_preferences->SetDefaultValue(LATEST_FRAME_ONLY_KEY,
+                                         BoolValidator(),
+                                         false);
+
   if (save) {
     m_preferences->Save();
   }
@@ -56,6 +56,9 @@ class UsbSerialPlugin: public ola::Plugin, public NewWidgetHandler {
     void NewWidget(UltraDMXProWidget *widget,
                    const UsbProWidgetInformation &information);
 
+    static const char PLUGIN_NAME[];
+    static const char PLUGIN_PREFIX[];
+
  private:
     void AddDevice(UsbSerialDevice *device);
     bool StartHook();
@@ -71,14 +74,14 @@ class UsbSerialPlugin: public ola::Plugin, public NewWidgetHandler {
     WidgetDetectorThread m_detector_thread;
 
     static const char DEFAULT_DEVICE_DIR[];
+    static const char DETECTION_CACHE_KEY[];
     static const char DEVICE_DIR_KEY[];
     static const char DEVICE_PREFIX_KEY[];
     static const char IGNORED_DEVICES_KEY[];
+    static const char LATEST_FRAME_ONLY_KEY[];
     static const char LINUX_DEVICE_PREFIX[];
     static const char BSD_DEVICE_PREFIX[];
     static const char MAC_DEVICE_PREFIX[];
-    static const char PLUGIN_NAME[];
-    static const char PLUGIN_PREFIX[];
     static const char ROBE_DEVICE_NAME[];
     static const char TRI_USE_RAW_RDM_KEY[];
     static const char USBPRO_DEVICE_NAME[];
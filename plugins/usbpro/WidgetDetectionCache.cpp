@@ -0,0 +1,226 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * WidgetDetectionCache.cpp
+ * Remembers which widget was found on each serial device.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * The file has one widget per line, with tab separated fields:
+ *   robe <path>
+ *   usbpro <path> <esta id> <device id> <serial> <firmware> <dual port>
+ *     <manufacturer> <device>
+ * The firmware is -1 if the widget didn't report it.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "plugins/usbpro/WidgetDetectionCache.h"
+
+namespace ola {
+namespace plugin {
+namespace usbpro {
+
+using std::string;
+using std::vector;
+
+namespace {
+// Tabs & newlines would break the file format.
+string CleanField(const string &field) {
+  string output = field;
+  ola::ReplaceAll(&output, "\t", " ");
+  ola::ReplaceAll(&output, "\n", " ");
+  return output;
+}
+}  // namespace
+
+const char WidgetDetectionCache::USB_PRO_TYPE[] = "usbpro";
+const char WidgetDetectionCache::ROBE_TYPE[] = "robe";
+
+WidgetDetectionCache::WidgetDetectionCache(const string &filename)
+    : m_filename(filename) {
+}
+
+
+void WidgetDetectionCache::SetFilename(const string &filename) {
+  m_filename = filename;
+  m_entries.clear();
+}
+
+
+bool WidgetDetectionCache::Load() {
+  m_entries.clear();
+  if (m_filename.empty()) {
+    return false;
+  }
+
+  std::ifstream cache_file(m_filename.data());
+  if (!cache_file.is_open()) {
+    OLA_INFO << "No widget cache at " << m_filename << ": "
+             << strerror(errno);
+    return false;
+  }
+
+  string line;
+  while (getline(cache_file, line)) {
+    vector<string> tokens;
+    StringSplit(line, &tokens, "\t");
+    if (tokens.size() < 2 || tokens[1].empty()) {
+      continue;
+    }
+
+    CacheEntry entry;
+    if (tokens[0] == ROBE_TYPE) {
+      entry.type = ROBE_WIDGET;
+    } else if (tokens[0] == USB_PRO_TYPE && tokens.size() == 9) {
+      UsbProWidgetInformation &information = entry.information;
+      int firmware;
+      unsigned int dual_port;
+      if (!StringToInt(tokens[2], &information.esta_id) ||
+          !StringToInt(tokens[3], &information.device_id) ||
+          !StringToInt(tokens[4], &information.serial) ||
+          !StringToInt(tokens[5], &firmware) ||
+          !StringToInt(tokens[6], &dual_port)) {
+        OLA_INFO << "Skipping widget cache line: " << line;
+        continue;
+      }
+      if (firmware >= 0) {
+        information.SetFirmware(
+            static_cast<UsbProWidgetInformation::DeviceFirmwareVersion>(
+                firmware));
+      }
+      information.dual_port = dual_port;
+      information.manufacturer = tokens[7];
+      information.device = tokens[8];
+      entry.type = USB_PRO_WIDGET;
+    } else {
+      OLA_INFO << "Skipping widget cache line: " << line;
+      continue;
+    }
+    m_entries[tokens[1]] = entry;
+  }
+  OLA_INFO << "Loaded " << m_entries.size() << " widgets from "
+           << m_filename;
+  return true;
+}
+
+
+bool WidgetDetectionCache::Save() const {
+  if (m_filename.empty()) {
+    return false;
+  }
+
+  // Write to a temporary file, so a crash never leaves a partial cache.
+  const string temp_filename = m_filename + ".new";
+  std::ofstream cache_file(temp_filename.data());
+  if (!cache_file.is_open()) {
+    OLA_WARN << "Could not open " << temp_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  CacheMap::const_iterator iter = m_entries.begin();
+  for (; iter != m_entries.end(); ++iter) {
+    if (iter->second.type == ROBE_WIDGET) {
+      cache_file << ROBE_TYPE << "\t" << iter->first << "\n";
+      continue;
+    }
+    const UsbProWidgetInformation &information = iter->second.information;
+    cache_file << USB_PRO_TYPE << "\t" << iter->first << "\t"
+               << information.esta_id << "\t" << information.device_id << "\t"
+               << information.serial << "\t"
+               << (information.has_firmware_version ?
+                   static_cast<int>(information.firmware_version) : -1)
+               << "\t" << information.dual_port << "\t"
+               << CleanField(information.manufacturer) << "\t"
+               << CleanField(information.device) << "\n";
+  }
+  cache_file.close();
+  if (cache_file.fail()) {
+    OLA_WARN << "Failed to write " << temp_filename;
+    return false;
+  }
+
+  if (rename(temp_filename.c_str(), m_filename.c_str())) {
+    OLA_WARN << "Failed to rename " << temp_filename << ": "
+             << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+
+bool WidgetDetectionCache::Lookup(const string &path, WidgetType *type,
+                                  UsbProWidgetInformation *information) const {
+  CacheMap::const_iterator iter = m_entries.find(path);
+  if (iter == m_entries.end()) {
+    return false;
+  }
+  *type = iter->second.type;
+  if (information && iter->second.type == USB_PRO_WIDGET) {
+    *information = iter->second.information;
+  }
+  return true;
+}
+
+
+bool WidgetDetectionCache::AddUsbProWidget(
+    const string &path,
+    const UsbProWidgetInformation &information) {
+  CacheMap::iterator iter = m_entries.find(path);
+  if (iter != m_entries.end() && iter->second.type == USB_PRO_WIDGET) {
+    const UsbProWidgetInformation &old = iter->second.information;
+    if (old.esta_id == information.esta_id &&
+        old.device_id == information.device_id &&
+        old.serial == information.serial &&
+        old.has_firmware_version == information.has_firmware_version &&
+        old.firmware_version == information.firmware_version &&
+        old.dual_port == information.dual_port &&
+        old.manufacturer == information.manufacturer &&
+        old.device == information.device) {
+      return false;
+    }
+  }
+
+  CacheEntry &entry = m_entries[path];
+  entry.type = USB_PRO_WIDGET;
+  entry.information = information;
+  return true;
+}
+
+
+bool WidgetDetectionCache::AddRobeWidget(const string &path) {
+  CacheMap::iterator iter = m_entries.find(path);
+  if (iter != m_entries.end() && iter->second.type == ROBE_WIDGET) {
+    return false;
+  }
+  CacheEntry &entry = m_entries[path];
+  entry.type = ROBE_WIDGET;
+  entry.information = UsbProWidgetInformation();
+  return true;
+}
+
+
+bool WidgetDetectionCache::Remove(const string &path) {
+  return m_entries.erase(path) > 0;
+}
+}  // namespace usbpro
+}  // namespace plugin
+}  // namespace ola
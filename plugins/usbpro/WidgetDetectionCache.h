@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * WidgetDetectionCache.h
+ * Remembers which widget was found on each serial device.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_USBPRO_WIDGETDETECTIONCACHE_H_
+#define PLUGINS_USBPRO_WIDGETDETECTIONCACHE_H_
+
+#include <map>
+#include <string>
+#include "ola/base/Macro.h"
+#include "plugins/usbpro/UsbProWidgetDetector.h"
+
+namespace ola {
+namespace plugin {
+namespace usbpro {
+
+/**
+ * @brief Remembers which widget was found on each serial device path.
+ *
+ * The cache is saved to a file, so on restart a known device can skip most
+ * of the discovery messages. Entries are only hints, the detectors still
+ * confirm the widget is the same one before using the cached information.
+ */
+class WidgetDetectionCache {
+ public:
+  /**
+   * @brief The types of widget we cache.
+   */
+  enum WidgetType {
+    USB_PRO_WIDGET,
+    ROBE_WIDGET
+  };
+
+  /**
+   * @brief Create a new cache.
+   * @param filename the file to load & save the cache from, if empty the
+   *   cache is only held in memory.
+   */
+  explicit WidgetDetectionCache(const std::string &filename = "");
+
+  /**
+   * @brief Set the file to use, this clears the cache.
+   */
+  void SetFilename(const std::string &filename);
+
+  /**
+   * @brief Load the cache from the file.
+   * @returns false if the file couldn't be read.
+   */
+  bool Load();
+
+  /**
+   * @brief Save the cache to the file.
+   * @returns false if the file couldn't be written.
+   */
+  bool Save() const;
+
+  /**
+   * @brief Look up the widget on a path.
+   * @param path the device path.
+   * @param[out] type the type of widget.
+   * @param[out] information the USB Pro information, this is only set for
+   *   USB_PRO_WIDGET entries. May be NULL.
+   * @returns true if the path was found.
+   */
+  bool Lookup(const std::string &path, WidgetType *type,
+              UsbProWidgetInformation *information) const;
+
+  /**
+   * @brief Record a USB Pro like widget.
+   * @returns true if the cache changed.
+   */
+  bool AddUsbProWidget(const std::string &path,
+                       const UsbProWidgetInformation &information);
+
+  /**
+   * @brief Record a Robe widget.
+   * @returns true if the cache changed.
+   */
+  bool AddRobeWidget(const std::string &path);
+
+  /**
+   * @brief Forget the widget on a path.
+   * @returns true if the cache changed.
+   */
+  bool Remove(const std::string &path);
+
+ private:
+  struct CacheEntry {
+    WidgetType type;
+    UsbProWidgetInformation information;
+  };
+  typedef std::map<std::string, CacheEntry> CacheMap;
+
+  std::string m_filename;
+  CacheMap m_entries;
+
+  static const char USB_PRO_TYPE[];
+  static const char ROBE_TYPE[];
+
+  DISALLOW_COPY_AND_ASSIGN(WidgetDetectionCache);
+};
+}  // namespace usbpro
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_USBPRO_WIDGETDETECTIONCACHE_H_
@@ -0,0 +1,124 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * WidgetDetectionCacheTest.cpp
+ * Test fixture for the WidgetDetectionCache class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+
+#include "ola/testing/TestUtils.h"
+#include "plugins/usbpro/UsbProWidgetDetector.h"
+#include "plugins/usbpro/WidgetDetectionCache.h"
+
+using ola::plugin::usbpro::UsbProWidgetInformation;
+using ola::plugin::usbpro::WidgetDetectionCache;
+using std::string;
+
+class WidgetDetectionCacheTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(WidgetDetectionCacheTest);
+  CPPUNIT_TEST(testCache);
+  CPPUNIT_TEST(testSaveAndLoad);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testCache();
+  void testSaveAndLoad();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WidgetDetectionCacheTest);
+
+
+void WidgetDetectionCacheTest::testCache() {
+  WidgetDetectionCache cache;
+  WidgetDetectionCache::WidgetType type;
+  UsbProWidgetInformation information;
+  OLA_ASSERT_FALSE(cache.Lookup("/dev/ttyUSB0", &type, &information));
+
+  information.esta_id = 0x7a70;
+  information.serial = 0x12345678;
+  OLA_ASSERT_TRUE(cache.AddUsbProWidget("/dev/ttyUSB0", information));
+  OLA_ASSERT_FALSE(cache.AddUsbProWidget("/dev/ttyUSB0", information));
+  OLA_ASSERT_TRUE(cache.AddRobeWidget("/dev/ttyUSB1"));
+  OLA_ASSERT_FALSE(cache.AddRobeWidget("/dev/ttyUSB1"));
+
+  UsbProWidgetInformation cached;
+  OLA_ASSERT_TRUE(cache.Lookup("/dev/ttyUSB0", &type, &cached));
+  OLA_ASSERT_EQ(WidgetDetectionCache::USB_PRO_WIDGET, type);
+  OLA_ASSERT_EQ(information.serial, cached.serial);
+  OLA_ASSERT_TRUE(cache.Lookup("/dev/ttyUSB1", &type, NULL));
+  OLA_ASSERT_EQ(WidgetDetectionCache::ROBE_WIDGET, type);
+
+  OLA_ASSERT_TRUE(cache.Remove("/dev/ttyUSB1"));
+  OLA_ASSERT_FALSE(cache.Remove("/dev/ttyUSB1"));
+  OLA_ASSERT_FALSE(cache.Lookup("/dev/ttyUSB1", &type, NULL));
+
+  // Without a file, nothing is saved.
+  OLA_ASSERT_FALSE(cache.Save());
+}
+
+
+void WidgetDetectionCacheTest::testSaveAndLoad() {
+  char filename[] = "/tmp/ola-widget-cacheXXXXXX";
+  int fd = mkstemp(filename);
+  OLA_ASSERT_TRUE(fd >= 0);
+  close(fd);
+
+  UsbProWidgetInformation information;
+  information.esta_id = 0x6a6b;
+  information.device_id = 2;
+  information.serial = 0xdeadbeef;
+  information.SetFirmware(0x0204);
+  information.dual_port = true;
+  information.manufacturer = "DMXking.com";
+  information.device = "ultraDMX\tPro";
+
+  {
+    WidgetDetectionCache cache(filename);
+    cache.AddUsbProWidget("/dev/ttyUSB0", information);
+    cache.AddUsbProWidget("/dev/ttyUSB1", UsbProWidgetInformation());
+    cache.AddRobeWidget("/dev/ttyUSB2");
+    OLA_ASSERT_TRUE(cache.Save());
+  }
+
+  WidgetDetectionCache cache(filename);
+  OLA_ASSERT_TRUE(cache.Load());
+  unlink(filename);
+
+  WidgetDetectionCache::WidgetType type;
+  UsbProWidgetInformation cached;
+  OLA_ASSERT_TRUE(cache.Lookup("/dev/ttyUSB0", &type, &cached));
+  OLA_ASSERT_EQ(WidgetDetectionCache::USB_PRO_WIDGET, type);
+  OLA_ASSERT_EQ(information.esta_id, cached.esta_id);
+  OLA_ASSERT_EQ(information.device_id, cached.device_id);
+  OLA_ASSERT_EQ(information.serial, cached.serial);
+  OLA_ASSERT_TRUE(cached.has_firmware_version);
+  OLA_ASSERT_EQ(information.firmware_version, cached.firmware_version);
+  OLA_ASSERT_TRUE(cached.dual_port);
+  OLA_ASSERT_EQ(information.manufacturer, cached.manufacturer);
+  OLA_ASSERT_EQ(string("ultraDMX Pro"), cached.device);
+
+  OLA_ASSERT_TRUE(cache.Lookup("/dev/ttyUSB1", &type, &cached));
+  OLA_ASSERT_FALSE(cached.has_firmware_version);
+  OLA_ASSERT_FALSE(cached.dual_port);
+  OLA_ASSERT_TRUE(cached.device.empty());
+
+  OLA_ASSERT_TRUE(cache.Lookup("/dev/ttyUSB2", &type, NULL));
+  OLA_ASSERT_EQ(WidgetDetectionCache::ROBE_WIDGET, type);
+}
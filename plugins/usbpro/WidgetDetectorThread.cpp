@@ -68,6 +68,7 @@ WidgetDetectorThread::WidgetDetectorThread(
   unsigned int robe_timeout)
     : ola::thread::Thread(),
       m_other_ss(ss),
+      m_usb_pro_detector(NULL),
       m_handler(handler),
       m_is_running(false),
       m_usb_pro_timeout(usb_pro_timeout),
@@ -109,6 +110,16 @@ void WidgetDetectorThread::SetIgnoredDevices(const vector<string> &devices) {
   }
 }
 
+
+/**
+ * Set the file used to cache the widgets we've found. This should be called
+ * before Run() since it doesn't do any locking.
+ * @param filename the cache file, or an empty string to disable the cache.
+ */
+void WidgetDetectorThread::SetCacheFile(const string &filename) {
+  m_cache.SetFilename(filename);
+}
+
 /**
  * Run the discovery thread.
  */
@@ -116,17 +127,19 @@ void *WidgetDetectorThread::Run() {
   if (!m_widget_detectors.empty()) {
     OLA_WARN << "List of widget detectors isn't empty!";
   } else {
-    m_widget_detectors.push_back(new UsbProWidgetDetector(
+    m_usb_pro_detector = new UsbProWidgetDetector(
         &m_ss,
         ola::NewCallback(this, &WidgetDetectorThread::UsbProWidgetReady),
         ola::NewCallback(this, &WidgetDetectorThread::DescriptorFailed),
-        m_usb_pro_timeout));
+        m_usb_pro_timeout);
+    m_widget_detectors.push_back(m_usb_pro_detector);
     m_widget_detectors.push_back(new RobeWidgetDetector(
         &m_ss,
         ola::NewCallback(this, &WidgetDetectorThread::RobeWidgetReady),
         ola::NewCallback(this, &WidgetDetectorThread::DescriptorFailed),
         m_robe_timeout));
   }
+  m_cache.Load();
   RunScan();
   m_ss.RegisterRepeatingTimeout(
       SCAN_INTERVAL_MS,
@@ -138,6 +151,7 @@ void *WidgetDetectorThread::Run() {
 
   // This will trigger a call to InternalFreeWidget for any remaining widgets
   STLDeleteElements(&m_widget_detectors);
+  m_usb_pro_detector = NULL;
 
   if (!m_active_descriptors.empty())
     OLA_WARN << m_active_descriptors.size() << " are still active";
@@ -225,11 +239,19 @@ bool WidgetDetectorThread::RunScan() {
 }
 
 /**
- * Start the discovery sequence for a widget.
+ * Start the discovery sequence for a widget. Devices are probed in parallel,
+ * since each detector is driven by m_ss. If the cache says there was a Robe
+ * widget on this path, we start with the Robe detector.
  */
 void WidgetDetectorThread::PerformDiscovery(const string &path,
                                             ConnectedDescriptor *descriptor) {
-  m_active_descriptors[descriptor] = DescriptorInfo(path, -1);
+  int first_detector = USB_PRO_DETECTOR;
+  WidgetDetectionCache::WidgetType type;
+  if (m_cache.Lookup(path, &type, NULL) &&
+      type == WidgetDetectionCache::ROBE_WIDGET) {
+    first_detector = ROBE_DETECTOR;
+  }
+  m_active_descriptors[descriptor] = DescriptorInfo(path, first_detector - 1);
   m_active_paths.insert(path);
   PerformNextDiscoveryStep(descriptor);
 }
@@ -243,6 +265,10 @@ void WidgetDetectorThread::UsbProWidgetReady(
     const UsbProWidgetInformation *information) {
   // we're no longer interested in events from this widget
   m_ss.RemoveReadDescriptor(descriptor);
+  if (m_cache.AddUsbProWidget(m_active_descriptors[descriptor].first,
+                              *information)) {
+    m_cache.Save();
+  }
 
   if (!m_handler) {
     OLA_WARN << "No callback defined for new Usb Pro Widgets.";
@@ -340,6 +366,9 @@ void WidgetDetectorThread::RobeWidgetReady(
     const RobeWidgetInformation *info) {
   // we're no longer interested in events from this descriptor
   m_ss.RemoveReadDescriptor(descriptor);
+  if (m_cache.AddRobeWidget(m_active_descriptors[descriptor].first)) {
+    m_cache.Save();
+  }
   RobeWidget *widget = new RobeWidget(descriptor, info->uid);
 
   if (m_handler) {
@@ -379,12 +408,25 @@ void WidgetDetectorThread::PerformNextDiscoveryStep(
   if (static_cast<unsigned int>(descriptor_info.second) ==
       m_widget_detectors.size()) {
     OLA_INFO << "no more detectors to try for  " << descriptor;
+    // Forget any cached widget, so the next scan runs every detector.
+    if (m_cache.Remove(descriptor_info.first)) {
+      m_cache.Save();
+    }
     FreeDescriptor(descriptor);
   } else {
     OLA_INFO << "trying stage " << descriptor_info.second << " for " <<
       descriptor;
     m_ss.AddReadDescriptor(descriptor);
-    bool ok = m_widget_detectors[descriptor_info.second]->Discover(descriptor);
+    UsbProWidgetInformation cached_information;
+    WidgetDetectionCache::WidgetType type;
+    bool ok;
+    if (descriptor_info.second == USB_PRO_DETECTOR &&
+        m_cache.Lookup(descriptor_info.first, &type, &cached_information) &&
+        type == WidgetDetectionCache::USB_PRO_WIDGET) {
+      ok = m_usb_pro_detector->Discover(descriptor, cached_information);
+    } else {
+      ok = m_widget_detectors[descriptor_info.second]->Discover(descriptor);
+    }
     if (!ok) {
       m_ss.RemoveReadDescriptor(descriptor);
       FreeDescriptor(descriptor);
@@ -36,6 +36,7 @@
 #include "plugins/usbpro/RobeWidgetDetector.h"
 #include "plugins/usbpro/UsbProWidgetDetector.h"
 #include "plugins/usbpro/SerialWidgetInterface.h"
+#include "plugins/usbpro/WidgetDetectionCache.h"
 #include "plugins/usbpro/WidgetDetectorInterface.h"
 
 namespace ola {
@@ -85,6 +86,8 @@ class WidgetDetectorThread: public ola::thread::Thread {
     void SetDevicePrefixes(const std::vector<std::string> &prefixes);
     // Must be called before Run()
     void SetIgnoredDevices(const std::vector<std::string> &devices);
+    // Must be called before Run()
+    void SetCacheFile(const std::string &filename);
 
     // Start the thread, this will call the SuccessHandler whenever a new
     // Widget is located.
@@ -109,6 +112,8 @@ class WidgetDetectorThread: public ola::thread::Thread {
     ola::io::SelectServerInterface *m_other_ss;
     ola::io::SelectServer m_ss;  // ss for this thread
     std::vector<WidgetDetectorInterface*> m_widget_detectors;
+    UsbProWidgetDetector *m_usb_pro_detector;  // owned by m_widget_detectors
+    WidgetDetectionCache m_cache;
     std::string m_directory;  // directory to look for widgets in
     std::vector<std::string> m_prefixes;  // prefixes to try
     std::set<std::string> m_ignored_devices;  // devices to ignore
@@ -151,6 +156,12 @@ class WidgetDetectorThread: public ola::thread::Thread {
 
     static const unsigned int SCAN_INTERVAL_MS = 20000;
 
+    // The order of the detectors in m_widget_detectors.
+    enum {
+      USB_PRO_DETECTOR = 0,
+      ROBE_DETECTOR = 1
+    };
+
     // This is how device identification is done, see
     // https://wiki.openlighting.org/index.php/USB_Protocol_Extensions
     // OPEN_LIGHTING_ESTA_CODE is in Constants.h
@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+#
+# DmxEncoderTest.py
+# Copyright (C) 2026 Simon Newton
+
+import array
+import unittest
+from ola import DmxEncoder
+from ola import Ola_pb2
+
+"""Test cases for the DmxEncoder."""
+
+__author__ = 'nomis52@gmail.com (Simon Newton)'
+
+
+class DmxEncoderTest(unittest.TestCase):
+
+  def testVarint(self):
+    self.assertEqual(b'\x00', DmxEncoder.EncodeVarint(0))
+    self.assertEqual(b'\x7f', DmxEncoder.EncodeVarint(127))
+    self.assertEqual(b'\x80\x01', DmxEncoder.EncodeVarint(128))
+    self.assertEqual(b'\xac\x02', DmxEncoder.EncodeVarint(300))
+    self.assertRaises(ValueError, DmxEncoder.EncodeVarint, -1)
+
+  def testDmxUpdate(self):
+    data = array.array('B', [0, 128, 255])
+    encoded = DmxEncoder.EncodeDmxUpdate(1, data)
+    self.assertEqual(b'\x08\x01\x12\x03\x00\x80\xff', encoded)
+
+    update = Ola_pb2.DmxUpdate()
+    update.ParseFromString(DmxEncoder.EncodeDmxUpdate(1000, data, 150, 10))
+    self.assertEqual(1000, update.universe)
+    self.assertEqual(b'\x00\x80\xff', update.data)
+    self.assertEqual(150, update.priority)
+    self.assertEqual(10, update.offset)
+
+  def testDmxDataBatch(self):
+    frame = bytearray(range(256)) * 2
+    updates = [DmxEncoder.EncodeDmxUpdate(universe, frame)
+               for universe in range(1, 101)]
+    encoded = DmxEncoder.EncodeDmxDataBatch(updates)
+
+    batch = Ola_pb2.DmxDataBatch()
+    batch.ParseFromString(encoded)
+    self.assertEqual(100, len(batch.update))
+    for i, update in enumerate(batch.update):
+      self.assertEqual(i + 1, update.universe)
+      self.assertEqual(bytes(frame), update.data)
+      self.assertFalse(update.HasField('priority'))
+      self.assertFalse(update.HasField('offset'))
+
+    # The encoding must match the protobuf library.
+    self.assertEqual(batch.SerializeToString(), encoded)
+
+  def testEmptyBatch(self):
+    self.assertEqual(b'', DmxEncoder.EncodeDmxDataBatch([]))
+
+
+if __name__ == '__main__':
+  unittest.main()
@@ -27,12 +27,14 @@ nodist_pkgpython_PYTHON = $(output_files)
 pkgpython_PYTHON = \
     python/ola/ClientWrapper.py \
     python/ola/DMXConstants.py \
+    python/ola/DmxEncoder.py \
     python/ola/DUBDecoder.py \
     python/ola/MACAddress.py \
     python/ola/OlaClient.py \
     python/ola/RDMAPI.py \
     python/ola/RDMConstants.py \
     python/ola/PidStore.py \
+    python/ola/SharedMemoryFrames.py \
     python/ola/UID.py \
     python/ola/__init__.py
 endif
@@ -59,12 +61,14 @@ python/ola/Version.py: python/ola/Makefile.mk configure.ac config/ola_version.m4
 ##################################################
 
 dist_check_SCRIPTS += \
+    python/ola/DmxEncoderTest.py \
     python/ola/DUBDecoderTest.py \
     python/ola/MACAddressTest.py \
     python/ola/UIDTest.py
 
 if BUILD_PYTHON_LIBS
 test_scripts += \
+    python/ola/DmxEncoderTest.py \
     python/ola/DUBDecoderTest.py \
     python/ola/MACAddressTest.py \
     python/ola/UIDTest.py
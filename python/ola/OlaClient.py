@@ -20,6 +20,7 @@ import socket
 import struct
 from ola.rpc.StreamRpcChannel import StreamRpcChannel
 from ola.rpc.SimpleRpcController import SimpleRpcController
+from ola import DmxEncoder
 from ola import Ola_pb2
 from ola.UID import UID
 
@@ -888,6 +889,60 @@ class OlaClient(Ola_pb2.OlaClientService):
       raise OLADNotRunningException()
     return True
 
+  def SendDmxBatch(self, frames, priority=None):
+    """Send DMX data for many universes in a single message.
+
+    This is much faster than calling SendDmx() for each universe: the message
+    is encoded without protobuf objects, and no response is sent, so there is
+    nothing to wait for.
+
+    Args:
+      frames: a list of (universe, data) tuples, where data is an array,
+        bytearray or bytes with the DMX data.
+      priority: the priority of the data, or None for the default.
+
+    Returns:
+      True if the data was sent, False otherwise.
+    """
+    if self._socket is None:
+      return False
+
+    updates = [DmxEncoder.EncodeDmxUpdate(universe, data, priority)
+               for universe, data in frames]
+    try:
+      self._channel.SendStreamRequest(
+          'StreamDmxDataBatch', DmxEncoder.EncodeDmxDataBatch(updates))
+    except socket.error:
+      raise OLADNotRunningException()
+    return True
+
+  def RegisterSharedMemory(self, name, action, callback=None):
+    """Ask olad to read DMX data from a shared memory segment.
+
+    Args:
+      name: the name of the segment, see SharedMemoryFrames.SharedMemoryWriter.
+      action: OlaClient.REGISTER or OlaClient.UNREGISTER
+      callback: The function to call once complete, takes one argument, a
+        RequestStatus object.
+
+    Returns:
+      True if the request was sent, False otherwise.
+    """
+    if self._socket is None:
+      return False
+
+    controller = SimpleRpcController()
+    request = Ola_pb2.SharedMemoryRequest()
+    request.name = name
+    request.action = action
+    try:
+      self._stub.RegisterSharedMemory(
+          controller, request,
+          lambda x, y: self._AckMessageComplete(callback, x, y))
+    except socket.error:
+      raise OLADNotRunningException()
+    return True
+
   def SetUniverseName(self, universe, name, callback=None):
     """Set the name of a universe.
 
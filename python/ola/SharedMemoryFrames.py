@@ -0,0 +1,148 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+#
+# SharedMemoryFrames.py
+# Copyright (C) 2026 Simon Newton
+
+import mmap
+import os
+import struct
+from ola.DmxEncoder import DataToBytes
+
+"""Write DMX frames to olad through shared memory.
+
+This is the writer side of ola::dmx::SharedMemoryFrames, see
+include/ola/dmx/SharedMemoryFrames.h for the layout. Register the segment with
+OlaClient.RegisterSharedMemory() once it's created, after which olad polls the
+segment and no messages are needed to send DMX.
+"""
+
+__author__ = 'nomis52@gmail.com (Simon Newton)'
+
+
+class Error(Exception):
+  """The base error class."""
+
+
+class SharedMemoryWriter(object):
+  """Creates a segment and writes frames to it.
+
+  Each slot is guarded by a sequence number, which is odd while the slot is
+  being written. Python has no memory fences, so this relies on stores being
+  visible in program order, which holds on x86. On weakly ordered CPUs olad may
+  occasionally read a frame that is part way through being written; the next
+  frame replaces it.
+  """
+  NAME_PREFIX = '/ola-dmx-'
+  DEFAULT_SLOTS = 32
+  MAX_SLOTS = 1024
+  SHM_DIR = '/dev/shm'
+
+  _MAGIC = 0x4f4c4153
+  _VERSION = 1
+  _DMX_UNIVERSE_SIZE = 512
+  # magic, version, reserved, slot_count, slot_size, padding.
+  _HEADER = struct.Struct('=LHHLL48x')
+  # sequence, universe, length, priority, in_use, data, padding.
+  _SLOT_HEADER = struct.Struct('=LLHBB')
+  _SLOT_SIZE = _SLOT_HEADER.size + _DMX_UNIVERSE_SIZE + 52
+  _SEQUENCE = struct.Struct('=L')
+
+  def __init__(self, name=None, slot_count=DEFAULT_SLOTS):
+    """Create a new segment.
+
+    Args:
+      name: the name of the segment, which must start with NAME_PREFIX. If
+        None, a name unique to this process is used.
+      slot_count: the number of universes the segment can hold.
+    """
+    if name is None:
+      name = '%s%d-py-%d' % (self.NAME_PREFIX, os.getpid(), id(self))
+    if (not name.startswith(self.NAME_PREFIX) or
+        len(name) == len(self.NAME_PREFIX) or '/' in name[1:]):
+      raise Error('Invalid segment name %s' % name)
+    if slot_count < 1 or slot_count > self.MAX_SLOTS:
+      raise Error('Invalid slot count %d' % slot_count)
+
+    self._name = name
+    self._path = os.path.join(self.SHM_DIR, name[1:])
+    self._slot_count = slot_count
+    self._universe_slots = {}
+    self._sequences = []
+
+    size = self._HEADER.size + slot_count * self._SLOT_SIZE
+    fd = os.open(self._path, os.O_RDWR | os.O_CREAT | os.O_EXCL, 0o600)
+    try:
+      # ftruncate zero fills the segment, so all the slots start unused.
+      os.ftruncate(fd, size)
+      self._segment = mmap.mmap(fd, size, mmap.MAP_SHARED,
+                                mmap.PROT_READ | mmap.PROT_WRITE)
+    except (OSError, mmap.error):
+      os.close(fd)
+      os.unlink(self._path)
+      raise
+    os.close(fd)
+
+    self._HEADER.pack_into(self._segment, 0, self._MAGIC, self._VERSION, 0,
+                           slot_count, self._SLOT_SIZE)
+
+  def Name(self):
+    """The name to pass to OlaClient.RegisterSharedMemory()."""
+    return self._name
+
+  def Write(self, universe, data, priority=100):
+    """Write a frame for a universe.
+
+    Args:
+      universe: the universe id.
+      data: the DMX data, see DmxEncoder.DataToBytes().
+      priority: the priority of the data.
+
+    Returns:
+      True if the frame was written, False if all the slots have been claimed
+      by other universes.
+    """
+    slot = self._universe_slots.get(universe)
+    if slot is None:
+      if len(self._universe_slots) >= self._slot_count:
+        return False
+      slot = len(self._universe_slots)
+      self._universe_slots[universe] = slot
+      self._sequences.append(0)
+
+    data = DataToBytes(data)[:self._DMX_UNIVERSE_SIZE]
+    offset = self._HEADER.size + slot * self._SLOT_SIZE
+    # The sequence is always even here, so adding 1 can't overflow.
+    sequence = self._sequences[slot]
+    next_sequence = (sequence + 2) & 0xffffffff
+
+    self._SEQUENCE.pack_into(self._segment, offset, sequence + 1)
+    self._SLOT_HEADER.pack_into(self._segment, offset, sequence + 1, universe,
+                                len(data), priority, 1)
+    data_offset = offset + self._SLOT_HEADER.size
+    self._segment[data_offset:data_offset + len(data)] = data
+    self._SEQUENCE.pack_into(self._segment, offset, next_sequence)
+    self._sequences[slot] = next_sequence
+    return True
+
+  def Close(self):
+    """Unmap and remove the segment."""
+    if self._segment is None:
+      return
+    self._segment.close()
+    self._segment = None
+    try:
+      os.unlink(self._path)
+    except OSError:
+      pass
@@ -48,7 +48,7 @@ class StreamRpcChannel(service.RpcChannel):
   PROTOCOL_VERSION = 1
   VERSION_MASK = 0xf0000000
   SIZE_MASK = 0x0fffffff
-  RECEIVE_BUFFER_SIZE = 8192
+  RECEIVE_BUFFER_SIZE = 65536
 
   def __init__(self, socket, service_impl, close_callback=None):
     """Create a new StreamRpcChannel.
@@ -62,7 +62,7 @@ class StreamRpcChannel(service.RpcChannel):
     self._sequence = 0
     self._outstanding_requests = {}
     self._outstanding_responses = {}
-    self._buffer = []  # The received data
+    self._buffer = bytearray()  # The received data
     self._expected_size = None  # The size of the message we're receiving
     self._skip_message = False  # Skip the current message
     self._close_callback = close_callback
@@ -80,7 +80,7 @@ class StreamRpcChannel(service.RpcChannel):
         self._close_callback()
       return False
 
-    self._buffer.append(data)
+    self._buffer.extend(data)
     self._ProcessIncomingData()
     return True
 
@@ -115,6 +115,25 @@ class StreamRpcChannel(service.RpcChannel):
     response = OutstandingResponse(message.id, controller, done, response_pb)
     self._outstanding_responses[message.id] = response
 
+  def SendStreamRequest(self, method_name, request_data):
+    """Send a request which doesn't have a response.
+
+    This skips the Stub, so the caller can serialize the request however it
+    likes, see ola.DmxEncoder.
+
+    Args:
+      method_name: the name of the method to call.
+      request_data: the serialized request.
+    """
+    message = Rpc_pb2.RpcMessage()
+    message.type = Rpc_pb2.STREAM_REQUEST
+    message.id = self._sequence
+    message.name = method_name
+    message.buffer = request_data
+    self._sequence += 1
+    data = message.SerializeToString()
+    self._socket.sendall(self._EncodeHeader(len(data)) + data)
+
   def RequestComplete(self, request, response):
     """This is called on the server side when a request has completed.
 
@@ -211,24 +230,12 @@ class StreamRpcChannel(service.RpcChannel):
     Returns:
       The next size bytes of data, or None if there isn't enough.
     """
-    data_size = sum([len(s) for s in self._buffer])
-    if data_size < size:
+    if len(self._buffer) < size:
       return None
 
-    data = []
-    size_left = size
-    while size_left > 0:
-      chunk = self._buffer.pop(0)
-      if len(chunk) > size_left:
-        # we only want part of it
-        data.append(chunk[0:size_left])
-        self._buffer.insert(0, chunk[size_left:])
-        size_left = 0
-      else:
-        data.append(chunk)
-        size_left -= len(chunk)
-
-    return b''.join(data)
+    data = bytes(self._buffer[:size])
+    del self._buffer[:size]
+    return data
 
   def _ProcessIncomingData(self):
     """Process the received data."""
@@ -4,6 +4,7 @@ include tools/ola_trigger/Makefile.mk
 include tools/rdm/Makefile.mk
 
 if !USING_WIN32
+include tools/bench/Makefile.mk
 include tools/e133/Makefile.mk
 include tools/usbpro/Makefile.mk
 include tools/rdmpro/Makefile.mk
@@ -0,0 +1,10 @@
+dist_noinst_DATA += tools/bench/olad-perf-baseline.json
+
+# PROGRAMS
+##################################################
+perf_check_programs += tools/bench/olad_perf_check
+
+tools_bench_olad_perf_check_SOURCES = tools/bench/olad-perf-check.cpp
+tools_bench_olad_perf_check_LDADD = common/web/libolaweb.la \
+                                    ola/libola.la \
+                                    $(COMMON_BENCHMARK_LIBS)
@@ -0,0 +1,1205 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * olad-perf-check.cpp
+ * Run olad end to end at several universe counts, report the throughput,
+ * latency, CPU and memory use, and compare them against a baseline.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+#include <ola/StringUtils.h>
+#include <ola/base/Array.h>
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+#include <ola/client/OlaClient.h>
+#include <ola/dmx/SourcePriorities.h>
+#include <ola/io/SelectServer.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/Socket.h>
+#include <ola/network/SocketAddress.h>
+#include <ola/network/TCPSocket.h>
+#include <ola/plugin_id.h>
+#include <ola/stl/STLUtils.h>
+#include <ola/testing/Benchmark.h>
+#include <ola/util/Histogram.h>
+#include <ola/web/Json.h>
+#include <ola/web/JsonParser.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using ola::DmxBuffer;
+using ola::Histogram;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::client::DMXMetadata;
+using ola::client::OlaClient;
+using ola::client::OlaDevice;
+using ola::client::OlaInputPort;
+using ola::client::PortPatch;
+using ola::client::Result;
+using ola::io::SelectServer;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::TCPSocket;
+using ola::network::UDPSocket;
+using ola::testing::Benchmark;
+using ola::web::JsonObject;
+using ola::web::JsonObjectPropertyVisitor;
+using ola::web::JsonParser;
+using ola::web::JsonValue;
+using std::auto_ptr;
+using std::map;
+using std::string;
+using std::vector;
+
+DEFINE_string(olad, "olad/olad", "The olad binary to test.");
+DEFINE_string(paths, "rpc,e131,artnet",
+              "The paths to send the data through, a comma separated list of "
+              "rpc, e131 and artnet.");
+DEFINE_string(universes, "10,100,500,2000",
+              "The universe counts to run each path at. The E1.31 and ArtNet "
+              "paths are limited to the number of ports the plugin supports.");
+DEFINE_s_uint32(rate, r, 40, "The frame rate for each universe, in Hz.");
+DEFINE_s_uint32(duration, d, 5,
+                "How long to measure each run for, in seconds.");
+DEFINE_uint32(warmup_ms, 1000,
+              "How long to send for before the measurement starts.");
+DEFINE_uint32(drain_ms, 500,
+              "How long to wait for frames in flight once sending stops.");
+DEFINE_uint16(rpc_port, 9110,
+              "The RPC port for olad, this shouldn't clash with a running "
+              "olad.");
+DEFINE_uint32(udp_max_recv_buffer, 0,
+              "The udp_max_recv_buffer for the E1.31 and ArtNet plugins, 0 "
+              "uses the plugin's default.");
+DEFINE_s_string(output, o, "",
+                "Write the report to this file rather than stdout.");
+DEFINE_s_string(baseline, b, "", "Compare the results with this report.");
+DEFINE_uint32(tolerance, 25,
+              "How much worse than the baseline, in percent, a result can be "
+              "before it's a regression.");
+
+namespace {
+
+/*
+ * Each frame starts with the time it was sent, in microseconds since the
+ * start of the run, as in ola_load.
+ */
+const unsigned int TIMESTAMP_SIZE = 6;
+const unsigned int CONNECT_TIMEOUT_MS = 10000;
+const unsigned int CONNECT_RETRY_MS = 200;
+const unsigned int RPC_TIMEOUT_MS = 10000;
+const unsigned int SHUTDOWN_TIMEOUT_MS = 5000;
+const unsigned int DUMMY_MAX_PORTS_PER_DEVICE = 512;
+
+// The preference file prefixes of all the plugins, the ones which aren't
+// used by a run are disabled so they don't add any load.
+const char *PLUGIN_PREFIXES[] = {
+  "artnet", "dmx4linux", "dummy", "e131", "espnet", "ftdidmx", "gpio",
+  "karate", "kinet", "milinst", "opendmx", "openpixelcontrol", "osc",
+  "pathport", "renard", "replication", "sandnet", "shownet", "spi",
+  "stageprofi", "uartdmx", "usbdmx", "usbserial",
+};
+
+enum PathType {
+  PATH_RPC,
+  PATH_E131,
+  PATH_ARTNET,
+};
+
+struct Path {
+  const char *name;
+  PathType type;
+  // The plugin which receives the data, NULL if the data is sent over RPC.
+  const char *plugin_prefix;
+  ola::ola_plugin_id plugin_id;
+  // The maximum number of input ports the plugin can have, 0 is no limit.
+  unsigned int max_universes;
+  uint16_t udp_port;
+};
+
+const Path PATHS[] = {
+  {"rpc", PATH_RPC, NULL, ola::OLA_PLUGIN_ALL, 0, 0},
+  {"e131", PATH_E131, "e131", ola::OLA_PLUGIN_E131, 512, 5568},
+  {"artnet", PATH_ARTNET, "artnet", ola::OLA_PLUGIN_ARTNET, 64, 6454},
+};
+
+/*
+ * A metric that's compared with the baseline.
+ * A result is a regression if it's worse than the baseline by more than the
+ * tolerance, plus the slack. The slack stops small values, like a loss of
+ * 0.1%, from failing the check because of noise. The tail latency varies too
+ * much between runs to compare, so it's only reported.
+ */
+struct Metric {
+  const char *name;
+  bool higher_is_better;
+  double slack;
+};
+
+const Metric METRICS[] = {
+  {"frames_per_sec", true, 0},
+  {"loss_percent", false, 1.0},
+  {"latency_p50_us", false, 500},
+  {"olad_cpu_percent", false, 2.0},
+  {"olad_peak_rss_kb", false, 2048},
+  {"client_allocs_per_frame", false, 0.5},
+};
+
+struct RunResult {
+  string path;
+  unsigned int universes;
+  uint64_t frames_sent;
+  uint64_t frames_received;
+  double frames_per_sec;
+  double loss_percent;
+  uint32_t latency_p50_us;
+  uint32_t latency_p99_us;
+  uint32_t latency_max_us;
+  double olad_cpu_percent;
+  uint64_t olad_rss_kb;
+  uint64_t olad_peak_rss_kb;
+  double client_allocs_per_frame;
+
+  RunResult()
+      : universes(0),
+        frames_sent(0),
+        frames_received(0),
+        frames_per_sec(0),
+        loss_percent(0),
+        latency_p50_us(0),
+        latency_p99_us(0),
+        latency_max_us(0),
+        olad_cpu_percent(0),
+        olad_rss_kb(0),
+        olad_peak_rss_kb(0),
+        client_allocs_per_frame(0) {
+  }
+};
+
+uint64_t MicroSecondsSince(const TimeStamp &epoch) {
+  ola::Clock clock;
+  TimeStamp now;
+  clock.CurrentTime(&now);
+  return (now - epoch).AsInt();
+}
+
+/*
+ * The CPU time used by a process, in microseconds, or 0 if it can't be read.
+ */
+uint64_t ProcessCpuTime(pid_t pid) {
+  std::ostringstream path;
+  path << "/proc/" << pid << "/stat";
+  std::ifstream stat_file(path.str().c_str());
+  string line;
+  if (!std::getline(stat_file, line)) {
+    OLA_WARN << "Failed to read " << path.str();
+    return 0;
+  }
+
+  // The command name may contain spaces, so skip to the closing bracket.
+  string::size_type end = line.rfind(')');
+  if (end == string::npos) {
+    return 0;
+  }
+  vector<string> fields;
+  ola::StringSplit(line.substr(end + 2), &fields, " ");
+  // utime and stime are fields 14 and 15, and the state (field 3) is first.
+  unsigned int user_ticks, system_ticks;
+  long ticks_per_second = sysconf(_SC_CLK_TCK);  // NOLINT(runtime/int)
+  if (fields.size() < 13 || ticks_per_second <= 0 ||
+      !ola::StringToInt(fields[11], &user_ticks) ||
+      !ola::StringToInt(fields[12], &system_ticks)) {
+    OLA_WARN << "Failed to parse " << path.str();
+    return 0;
+  }
+  return (static_cast<uint64_t>(user_ticks) + system_ticks) * 1000000 /
+         ticks_per_second;
+}
+
+/*
+ * Read the current and peak resident set size of a process, in kB.
+ */
+void ProcessMemory(pid_t pid, uint64_t *rss_kb, uint64_t *peak_rss_kb) {
+  std::ostringstream path;
+  path << "/proc/" << pid << "/status";
+  std::ifstream status_file(path.str().c_str());
+  string line;
+  while (std::getline(status_file, line)) {
+    uint64_t *value = NULL;
+    if (ola::StringBeginsWith(line, "VmRSS:")) {
+      value = rss_kb;
+    } else if (ola::StringBeginsWith(line, "VmHWM:")) {
+      value = peak_rss_kb;
+    } else {
+      continue;
+    }
+    std::istringstream str(line.substr(line.find(':') + 1));
+    str >> *value;
+  }
+}
+
+/*
+ * Remove a config directory and the files olad wrote to it.
+ */
+void RemoveDirectory(const string &path) {
+  DIR *dir = opendir(path.c_str());
+  if (dir) {
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+      string name(entry->d_name);
+      if (name != "." && name != "..") {
+        unlink((path + "/" + name).c_str());
+      }
+    }
+    closedir(dir);
+  }
+  if (rmdir(path.c_str())) {
+    OLA_WARN << "Failed to remove " << path << ": " << strerror(errno);
+  }
+}
+
+/*
+ * Write the preference files for a run. Only the dummy plugin, which has an
+ * output port on each universe, and the plugin for the path are enabled.
+ */
+bool WriteConfig(const string &config_dir, const Path &path,
+                 unsigned int universes) {
+  for (unsigned int i = 0; i < arraysize(PLUGIN_PREFIXES); i++) {
+    const string prefix = PLUGIN_PREFIXES[i];
+    const string file_name = config_dir + "/ola-" + prefix + ".conf";
+    std::ofstream config(file_name.c_str());
+    if (!config.is_open()) {
+      OLA_WARN << "Failed to create " << file_name;
+      return false;
+    }
+
+    bool enabled = (prefix == "dummy" ||
+                    (path.plugin_prefix && prefix == path.plugin_prefix));
+    config << "enabled = " << (enabled ? "true" : "false") << std::endl;
+
+    if (prefix == "dummy") {
+      unsigned int device_count = (
+          (universes + DUMMY_MAX_PORTS_PER_DEVICE - 1) /
+          DUMMY_MAX_PORTS_PER_DEVICE);
+      config << "device_count = " << device_count << std::endl;
+      config << "output_port_count = "
+             << (universes + device_count - 1) / device_count << std::endl;
+      config << "universe_count = " << universes << std::endl;
+      const char *responder_keys[] = {
+        "ack_timer_count", "advanced_dimmer_count", "dimmer_count",
+        "dummy_device_count", "moving_light_count", "network_device_count",
+        "sensor_device_count",
+      };
+      for (unsigned int j = 0; j < arraysize(responder_keys); j++) {
+        config << responder_keys[j] << " = 0" << std::endl;
+      }
+    } else if (enabled) {
+      config << "ip = 127.0.0.1" << std::endl;
+      config << "input_ports = " << universes << std::endl;
+      config << "output_ports = 0" << std::endl;
+      if (FLAGS_udp_max_recv_buffer) {
+        config << "udp_max_recv_buffer = " << FLAGS_udp_max_recv_buffer
+               << std::endl;
+      }
+      if (path.type == PATH_ARTNET) {
+        config << "use_loopback = true" << std::endl;
+        config << "net = 0" << std::endl;
+        config << "subnet = 0" << std::endl;
+      }
+    }
+  }
+  return true;
+}
+
+
+/*
+ * Build an E1.31 data packet with a full frame.
+ */
+unsigned int BuildE131Packet(uint16_t universe, uint8_t sequence,
+                             const DmxBuffer &data, uint8_t *packet) {
+  const uint8_t ACN_ID[] = {
+    0x41, 0x53, 0x43, 0x2d, 0x45, 0x31, 0x2e, 0x31, 0x37, 0x00, 0x00, 0x00
+  };
+  const char SOURCE_NAME[] = "olad_perf_check";
+  const unsigned int HEADER_SIZE = 126;
+  const unsigned int size = HEADER_SIZE + ola::DMX_UNIVERSE_SIZE;
+  memset(packet, 0, size);
+
+  // Root layer
+  packet[1] = 0x10;
+  memcpy(packet + 4, ACN_ID, sizeof(ACN_ID));
+  packet[16] = 0x70 | ((size - 16) >> 8);
+  packet[17] = (size - 16) & 0xff;
+  packet[21] = 0x04;
+  // The CID, any value other than olad's own will do.
+  for (unsigned int i = 22; i < 38; i++) {
+    packet[i] = static_cast<uint8_t>(i);
+  }
+
+  // Framing layer
+  packet[38] = 0x70 | ((size - 38) >> 8);
+  packet[39] = (size - 38) & 0xff;
+  packet[43] = 0x02;
+  memcpy(packet + 44, SOURCE_NAME, sizeof(SOURCE_NAME));
+  packet[108] = ola::dmx::SOURCE_PRIORITY_DEFAULT;
+  packet[111] = sequence;
+  packet[113] = universe >> 8;
+  packet[114] = universe & 0xff;
+
+  // DMP layer, packet[125] is the start code.
+  packet[115] = 0x70 | ((size - 115) >> 8);
+  packet[116] = (size - 115) & 0xff;
+  packet[117] = 0x02;
+  packet[118] = 0xa1;
+  packet[122] = 0x01;
+  packet[123] = (ola::DMX_UNIVERSE_SIZE + 1) >> 8;
+  packet[124] = (ola::DMX_UNIVERSE_SIZE + 1) & 0xff;
+  unsigned int length = ola::DMX_UNIVERSE_SIZE;
+  data.Get(packet + HEADER_SIZE, &length);
+  return size;
+}
+
+/*
+ * Build an ArtDmx packet with a full frame.
+ */
+unsigned int BuildArtDmxPacket(uint8_t port_address, uint8_t sequence,
+                               const DmxBuffer &data, uint8_t *packet) {
+  const char ARTNET_ID[] = "Art-Net";
+  const unsigned int HEADER_SIZE = 18;
+  const unsigned int size = HEADER_SIZE + ola::DMX_UNIVERSE_SIZE;
+  memset(packet, 0, size);
+
+  memcpy(packet, ARTNET_ID, sizeof(ARTNET_ID));
+  packet[9] = 0x50;  // OpDmx, little endian
+  packet[11] = 14;  // protocol version
+  packet[12] = sequence;
+  packet[14] = port_address;
+  packet[16] = ola::DMX_UNIVERSE_SIZE >> 8;
+  packet[17] = ola::DMX_UNIVERSE_SIZE & 0xff;
+  unsigned int length = ola::DMX_UNIVERSE_SIZE;
+  data.Get(packet + HEADER_SIZE, &length);
+  return size;
+}
+
+/*
+ * The ArtNet port address an input port listens on. The ports are in pages
+ * of four, and each page uses the next sub-net, see the ArtNet README.
+ */
+uint8_t ArtNetPortAddress(unsigned int port_id, unsigned int universe) {
+  return static_cast<uint8_t>((((port_id / 4) & 0x0f) << 4) |
+                              (universe & 0x0f));
+}
+}  // namespace
+
+
+/*
+ * Runs olad in a child process.
+ */
+class OladProcess {
+ public:
+  OladProcess() : m_pid(-1) {}
+  ~OladProcess() { Stop(); }
+
+  bool Start(const string &config_dir);
+  void Stop();
+
+  pid_t Pid() const { return m_pid; }
+
+ private:
+  pid_t m_pid;
+
+  bool WaitForRPC();
+
+  DISALLOW_COPY_AND_ASSIGN(OladProcess);
+};
+
+
+bool OladProcess::Start(const string &config_dir) {
+  const string olad = FLAGS_olad.str();
+  const string rpc_port = ola::IntToString(FLAGS_rpc_port);
+  m_pid = fork();
+  if (m_pid < 0) {
+    OLA_WARN << "fork() failed: " << strerror(errno);
+    return false;
+  }
+
+  if (m_pid == 0) {
+    execl(olad.c_str(), olad.c_str(), "--config-dir", config_dir.c_str(),
+          "--rpc-port", rpc_port.c_str(), "--no-http",
+          "--no-register-with-dns-sd", "--log-level", "1",
+          static_cast<char*>(NULL));
+    std::cerr << "Failed to run " << olad << ": " << strerror(errno)
+              << std::endl;
+    _exit(ola::EXIT_OSERR);
+  }
+  return WaitForRPC();
+}
+
+
+/*
+ * Stop olad, it's killed if it doesn't exit within SHUTDOWN_TIMEOUT_MS.
+ */
+void OladProcess::Stop() {
+  if (m_pid <= 0) {
+    return;
+  }
+
+  kill(m_pid, SIGTERM);
+  ola::Clock clock;
+  TimeStamp start;
+  clock.CurrentTime(&start);
+  while (waitpid(m_pid, NULL, WNOHANG) == 0) {
+    if (MicroSecondsSince(start) > SHUTDOWN_TIMEOUT_MS * 1000ull) {
+      OLA_WARN << "olad didn't exit, killing it";
+      kill(m_pid, SIGKILL);
+      waitpid(m_pid, NULL, 0);
+      break;
+    }
+    usleep(CONNECT_RETRY_MS * 1000);
+  }
+  m_pid = -1;
+}
+
+
+/*
+ * Wait until olad accepts RPC connections.
+ */
+bool OladProcess::WaitForRPC() {
+  IPV4SocketAddress address(IPV4Address::Loopback(), FLAGS_rpc_port);
+  ola::Clock clock;
+  TimeStamp start;
+  clock.CurrentTime(&start);
+  while (MicroSecondsSince(start) < CONNECT_TIMEOUT_MS * 1000ull) {
+    usleep(CONNECT_RETRY_MS * 1000);
+    if (waitpid(m_pid, NULL, WNOHANG) == m_pid) {
+      OLA_WARN << "olad exited during startup";
+      m_pid = -1;
+      return false;
+    }
+
+    auto_ptr<TCPSocket> socket(TCPSocket::Connect(address));
+    if (socket.get()) {
+      socket->Close();
+      return true;
+    }
+  }
+  OLA_WARN << "Timed out waiting for olad to start";
+  return false;
+}
+
+
+/*
+ * Sends DMX to olad through one of the paths, and receives it back on a
+ * second client connection.
+ *
+ * Both clients run on the same SelectServer, so the latency includes the
+ * time to send the rest of the frames in the same period.
+ */
+class PerfRun {
+ public:
+  PerfRun(const Path &path, unsigned int universes, pid_t olad_pid);
+  ~PerfRun();
+
+  bool Setup();
+  bool Run(RunResult *result);
+
+ private:
+  const Path &m_path;
+  const unsigned int m_universes;
+  const pid_t m_olad_pid;
+  SelectServer m_ss;
+  TimeStamp m_epoch;
+  auto_ptr<TCPSocket> m_sender_socket;
+  auto_ptr<OlaClient> m_sender;
+  auto_ptr<TCPSocket> m_receiver_socket;
+  auto_ptr<OlaClient> m_receiver;
+  UDPSocket m_udp_socket;
+  IPV4SocketAddress m_target;
+  vector<unsigned int> m_port_ids;
+  unsigned int m_device_alias;
+  DmxBuffer m_buffer;
+  uint8_t m_packet[ola::DMX_UNIVERSE_SIZE + 126];
+  uint8_t m_sequence;
+  uint64_t m_frames_sent;
+  uint64_t m_frames_received;
+  Histogram m_latency;
+  unsigned int m_pending;
+  bool m_done;
+  bool m_ok;
+  bool m_closed;
+
+  bool Connect(auto_ptr<TCPSocket> *socket, auto_ptr<OlaClient> *client);
+  void Disconnect(auto_ptr<TCPSocket> *socket, auto_ptr<OlaClient> *client);
+  bool Wait();
+  void RunFor(unsigned int duration_ms);
+  bool PatchInputPorts();
+  bool RegisterUniverses();
+  void DeviceInfo(const Result &result, const vector<OlaDevice> &devices);
+  void PatchComplete(const Result &result);
+  void RegisterComplete(const Result &result);
+  void ConnectionClosed();
+  bool SendFrames();
+  void NewDmx(const DMXMetadata &metadata, const DmxBuffer &data);
+
+  DISALLOW_COPY_AND_ASSIGN(PerfRun);
+};
+
+
+PerfRun::PerfRun(const Path &path, unsigned int universes, pid_t olad_pid)
+    : m_path(path),
+      m_universes(universes),
+      m_olad_pid(olad_pid),
+      m_target(IPV4Address::Loopback(), path.udp_port),
+      m_device_alias(0),
+      m_sequence(0),
+      m_frames_sent(0),
+      m_frames_received(0),
+      m_pending(0),
+      m_done(false),
+      m_ok(false),
+      m_closed(false) {
+  m_buffer.Blackout();
+  ola::Clock clock;
+  clock.CurrentTime(&m_epoch);
+}
+
+
+PerfRun::~PerfRun() {
+  Disconnect(&m_sender_socket, &m_sender);
+  Disconnect(&m_receiver_socket, &m_receiver);
+}
+
+
+bool PerfRun::Setup() {
+  if (!Connect(&m_sender_socket, &m_sender) ||
+      !Connect(&m_receiver_socket, &m_receiver)) {
+    return false;
+  }
+
+  if (m_path.type != PATH_RPC) {
+    if (!m_udp_socket.Init()) {
+      return false;
+    }
+    if (!PatchInputPorts()) {
+      return false;
+    }
+  }
+  return RegisterUniverses();
+}
+
+
+/*
+ * Send frames for the warm up period, then measure for the duration.
+ * @returns false if the connection to olad was lost.
+ */
+bool PerfRun::Run(RunResult *result) {
+  ola::thread::timeout_id send_timeout = m_ss.RegisterRepeatingTimeout(
+      TimeInterval(0, 1000000 / FLAGS_rate),
+      NewCallback(this, &PerfRun::SendFrames));
+  RunFor(FLAGS_warmup_ms);
+
+  m_latency.Reset();
+  const uint64_t sent_start = m_frames_sent;
+  const uint64_t received_start = m_frames_received;
+  const uint64_t allocations_start = Benchmark::AllocationCount();
+  const uint64_t cpu_start = ProcessCpuTime(m_olad_pid);
+  const uint64_t start = MicroSecondsSince(m_epoch);
+
+  RunFor(FLAGS_duration * 1000);
+
+  const uint64_t elapsed = MicroSecondsSince(m_epoch) - start;
+  const uint64_t cpu = ProcessCpuTime(m_olad_pid) - cpu_start;
+  const uint64_t allocations = (Benchmark::AllocationCount() -
+                                allocations_start);
+  const uint64_t sent = m_frames_sent - sent_start;
+  m_ss.RemoveTimeout(send_timeout);
+
+  // Pick up the frames still in flight.
+  RunFor(FLAGS_drain_ms);
+  const uint64_t received = m_frames_received - received_start;
+
+  result->path = m_path.name;
+  result->universes = m_universes;
+  result->frames_sent = sent;
+  result->frames_received = received;
+  result->frames_per_sec = elapsed ? received * 1000000.0 / elapsed : 0;
+  result->loss_percent = (sent && received < sent) ?
+      100.0 * (sent - received) / sent : 0;
+  result->latency_p50_us = m_latency.Percentile(50);
+  result->latency_p99_us = m_latency.Percentile(99);
+  result->latency_max_us = m_latency.Max();
+  result->olad_cpu_percent = elapsed ? 100.0 * cpu / elapsed : 0;
+  ProcessMemory(m_olad_pid, &result->olad_rss_kb,
+                &result->olad_peak_rss_kb);
+  result->client_allocs_per_frame = (
+      sent ? static_cast<double>(allocations) / sent : 0);
+  return !m_closed;
+}
+
+
+bool PerfRun::Connect(auto_ptr<TCPSocket> *socket,
+                      auto_ptr<OlaClient> *client) {
+  socket->reset(TCPSocket::Connect(
+      IPV4SocketAddress(IPV4Address::Loopback(), FLAGS_rpc_port)));
+  if (!socket->get()) {
+    return false;
+  }
+  (*socket)->SetNoDelay();
+  client->reset(new OlaClient(socket->get()));
+  if (!m_ss.AddReadDescriptor(socket->get())) {
+    return false;
+  }
+  (*client)->SetPipelining(&m_ss);
+  if (!(*client)->Setup()) {
+    return false;
+  }
+  (*client)->SetCloseHandler(
+      NewSingleCallback(this, &PerfRun::ConnectionClosed));
+  return true;
+}
+
+
+void PerfRun::Disconnect(auto_ptr<TCPSocket> *socket,
+                         auto_ptr<OlaClient> *client) {
+  if (socket->get()) {
+    m_ss.RemoveReadDescriptor(socket->get());
+  }
+  if (client->get()) {
+    (*client)->Stop();
+    client->reset();
+  }
+  socket->reset();
+}
+
+
+/*
+ * Run the SelectServer until a request completes.
+ * @returns true if it completed successfully.
+ */
+bool PerfRun::Wait() {
+  TimeStamp start;
+  ola::Clock clock;
+  clock.CurrentTime(&start);
+  while (!m_done && !m_closed) {
+    if (MicroSecondsSince(start) > RPC_TIMEOUT_MS * 1000ull) {
+      OLA_WARN << "Timed out waiting for olad";
+      return false;
+    }
+    m_ss.RunOnce(TimeInterval(0, 100000));
+  }
+  return m_done && m_ok;
+}
+
+
+void PerfRun::RunFor(unsigned int duration_ms) {
+  if (m_closed) {
+    return;
+  }
+  ola::thread::timeout_id timeout = m_ss.RegisterSingleTimeout(
+      duration_ms, NewSingleCallback(&m_ss, &SelectServer::Terminate));
+  m_ss.Run();
+  if (m_closed) {
+    m_ss.RemoveTimeout(timeout);
+  }
+}
+
+
+/*
+ * Patch the plugin's input ports to universes 1 to N.
+ */
+bool PerfRun::PatchInputPorts() {
+  m_done = false;
+  m_sender->FetchDeviceInfo(m_path.plugin_id,
+                            NewSingleCallback(this, &PerfRun::DeviceInfo));
+  if (!Wait()) {
+    return false;
+  }
+
+  vector<PortPatch> patches;
+  for (unsigned int i = 0; i < m_universes; i++) {
+    patches.push_back(PortPatch(m_device_alias, m_port_ids[i],
+                                ola::client::INPUT_PORT, ola::client::PATCH,
+                                i + 1));
+  }
+  m_done = false;
+  m_sender->PatchPorts(patches,
+                       NewSingleCallback(this, &PerfRun::PatchComplete));
+  return Wait();
+}
+
+
+bool PerfRun::RegisterUniverses() {
+  m_receiver->SetDMXCallback(NewCallback(this, &PerfRun::NewDmx));
+  m_done = false;
+  m_ok = true;
+  m_pending = m_universes;
+  for (unsigned int i = 1; i <= m_universes; i++) {
+    m_receiver->RegisterUniverse(
+        i, ola::client::REGISTER,
+        NewSingleCallback(this, &PerfRun::RegisterComplete));
+  }
+  return Wait();
+}
+
+
+void PerfRun::DeviceInfo(const Result &result,
+                         const vector<OlaDevice> &devices) {
+  m_done = true;
+  m_ok = false;
+  if (!result.Success()) {
+    OLA_WARN << "Failed to fetch the devices: " << result.Error();
+    return;
+  }
+  if (devices.empty()) {
+    OLA_WARN << "The " << m_path.name << " plugin didn't create a device";
+    return;
+  }
+
+  const vector<OlaInputPort> &ports = devices[0].InputPorts();
+  if (ports.size() < m_universes) {
+    OLA_WARN << "The " << m_path.name << " device only has " << ports.size()
+             << " input ports";
+    return;
+  }
+  m_device_alias = devices[0].Alias();
+  for (unsigned int i = 0; i < m_universes; i++) {
+    m_port_ids.push_back(ports[i].Id());
+  }
+  m_ok = true;
+}
+
+
+void PerfRun::PatchComplete(const Result &result) {
+  m_done = true;
+  m_ok = result.Success();
+  if (!m_ok) {
+    OLA_WARN << "Failed to patch the ports: " << result.Error();
+  }
+}
+
+
+void PerfRun::RegisterComplete(const Result &result) {
+  if (!result.Success()) {
+    OLA_WARN << "Failed to register for a universe: " << result.Error();
+    m_ok = false;
+  }
+  if (--m_pending == 0) {
+    m_done = true;
+  }
+}
+
+
+void PerfRun::ConnectionClosed() {
+  OLA_WARN << "olad closed the connection";
+  m_closed = true;
+  m_ss.Terminate();
+}
+
+
+bool PerfRun::SendFrames() {
+  uint64_t now = MicroSecondsSince(m_epoch);
+  for (unsigned int i = 0; i < TIMESTAMP_SIZE; i++) {
+    m_buffer.SetChannel(i, (now >> (8 * (TIMESTAMP_SIZE - 1 - i))) & 0xff);
+  }
+  // A sequence number of 0 disables the sequence checks in ArtNet.
+  m_sequence = m_sequence == 0xff ? 1 : m_sequence + 1;
+
+  for (unsigned int i = 0; i < m_universes; i++) {
+    const unsigned int universe = i + 1;
+    unsigned int size = 0;
+    switch (m_path.type) {
+      case PATH_RPC:
+        m_sender->SendDMX(universe, m_buffer, ola::client::SendDMXArgs());
+        break;
+      case PATH_E131:
+        size = BuildE131Packet(universe, m_sequence, m_buffer, m_packet);
+        break;
+      case PATH_ARTNET:
+        size = BuildArtDmxPacket(ArtNetPortAddress(m_port_ids[i], universe),
+                                 m_sequence, m_buffer, m_packet);
+        break;
+    }
+    if (size) {
+      m_udp_socket.SendTo(m_packet, size, m_target);
+    }
+  }
+  m_frames_sent += m_universes;
+  return true;
+}
+
+
+void PerfRun::NewDmx(const DMXMetadata&, const DmxBuffer &data) {
+  if (data.Size() < TIMESTAMP_SIZE) {
+    return;
+  }
+
+  uint64_t sent = 0;
+  for (unsigned int i = 0; i < TIMESTAMP_SIZE; i++) {
+    sent = (sent << 8) | data.Get(i);
+  }
+  uint64_t now = MicroSecondsSince(m_epoch);
+  if (sent == 0 || sent > now) {
+    // Not one of our frames.
+    return;
+  }
+  m_frames_received++;
+  m_latency.Add(static_cast<uint32_t>(std::min(
+      now - sent,
+      static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()))));
+}
+
+
+/*
+ * Collects the properties of one line of a report.
+ */
+class ReportLineVisitor : public JsonObjectPropertyVisitor,
+                          public ola::web::JsonValueConstVisitorInterface {
+ public:
+  void VisitProperty(const string &property, const JsonValue &value) {
+    m_property = property;
+    value.Accept(this);
+  }
+
+  void Visit(const ola::web::JsonString &value) {
+    m_strings[m_property] = value.Value();
+  }
+  void Visit(const ola::web::JsonBool&) {}
+  void Visit(const ola::web::JsonNull&) {}
+  void Visit(const ola::web::JsonRawValue&) {}
+  void Visit(const ola::web::JsonObject&) {}
+  void Visit(const ola::web::JsonArray&) {}
+  void Visit(const ola::web::JsonUInt &value) {
+    m_numbers[m_property] = value.Value();
+  }
+  void Visit(const ola::web::JsonUInt64 &value) {
+    m_numbers[m_property] = value.Value();
+  }
+  void Visit(const ola::web::JsonInt &value) {
+    m_numbers[m_property] = value.Value();
+  }
+  void Visit(const ola::web::JsonInt64 &value) {
+    m_numbers[m_property] = value.Value();
+  }
+  void Visit(const ola::web::JsonDouble &value) {
+    m_numbers[m_property] = value.Value();
+  }
+
+  const map<string, string> &Strings() const { return m_strings; }
+  const map<string, double> &Numbers() const { return m_numbers; }
+
+ private:
+  string m_property;
+  map<string, string> m_strings;
+  map<string, double> m_numbers;
+};
+
+typedef std::pair<string, unsigned int> RunKey;
+typedef map<RunKey, map<string, double> > Baseline;
+
+
+/*
+ * Load the olad results from a report.
+ */
+bool LoadBaseline(const string &file_name, Baseline *baseline) {
+  std::ifstream input(file_name.c_str());
+  if (!input.is_open()) {
+    OLA_WARN << "Failed to open " << file_name;
+    return false;
+  }
+
+  string line;
+  unsigned int line_number = 0;
+  while (std::getline(input, line)) {
+    line_number++;
+    ola::StripSuffix(&line, "\r");
+    if (line.empty()) {
+      continue;
+    }
+
+    string error;
+    auto_ptr<JsonValue> value(JsonParser::Parse(line, &error));
+    JsonObject *object = value.get() ? ola::web::ObjectCast(value.get()) :
+                         NULL;
+    if (!object) {
+      OLA_WARN << file_name << ":" << line_number << ": invalid report line "
+               << error;
+      return false;
+    }
+
+    ReportLineVisitor visitor;
+    object->VisitProperties(&visitor);
+    const string *suite = ola::STLFind(&visitor.Strings(), string("suite"));
+    const string *benchmark = ola::STLFind(&visitor.Strings(),
+                                           string("benchmark"));
+    const double *param = ola::STLFind(&visitor.Numbers(), string("param"));
+    if (suite && *suite == "olad" && benchmark && param) {
+      (*baseline)[RunKey(*benchmark, static_cast<unsigned int>(*param))] =
+          visitor.Numbers();
+    }
+  }
+  return true;
+}
+
+
+map<string, double> ResultMetrics(const RunResult &result) {
+  map<string, double> metrics;
+  metrics["frames_per_sec"] = result.frames_per_sec;
+  metrics["loss_percent"] = result.loss_percent;
+  metrics["latency_p50_us"] = result.latency_p50_us;
+  metrics["olad_cpu_percent"] = result.olad_cpu_percent;
+  metrics["olad_peak_rss_kb"] = result.olad_peak_rss_kb;
+  metrics["client_allocs_per_frame"] = result.client_allocs_per_frame;
+  return metrics;
+}
+
+
+/*
+ * Compare the results with the baseline.
+ * @returns the number of regressions.
+ */
+unsigned int CompareWithBaseline(const vector<RunResult> &results,
+                                 const Baseline &baseline) {
+  const double tolerance = FLAGS_tolerance / 100.0;
+  unsigned int regressions = 0;
+  vector<RunResult>::const_iterator iter = results.begin();
+  for (; iter != results.end(); ++iter) {
+    Baseline::const_iterator baseline_iter = baseline.find(
+        RunKey(iter->path, iter->universes));
+    if (baseline_iter == baseline.end()) {
+      std::cerr << iter->path << " with " << iter->universes
+                << " universes isn't in the baseline" << std::endl;
+      continue;
+    }
+
+    const map<string, double> metrics = ResultMetrics(*iter);
+    for (unsigned int i = 0; i < arraysize(METRICS); i++) {
+      const Metric &metric = METRICS[i];
+      const double *expected = ola::STLFind(&baseline_iter->second,
+                                            string(metric.name));
+      const double *actual = ola::STLFind(&metrics, string(metric.name));
+      if (!expected || !actual) {
+        continue;
+      }
+
+      bool regressed = metric.higher_is_better ?
+          *actual < *expected * (1 - tolerance) - metric.slack :
+          *actual > *expected * (1 + tolerance) + metric.slack;
+      if (regressed) {
+        std::cerr << "Regression: " << iter->path << " with "
+                  << iter->universes << " universes, " << metric.name
+                  << " is " << *actual << ", the baseline is " << *expected
+                  << std::endl;
+        regressions++;
+      }
+    }
+  }
+  return regressions;
+}
+
+
+void WriteResult(std::ostream *output, const RunResult &result) {
+  *output << "{\"suite\": \"olad\", \"benchmark\": \"" << result.path
+          << "\", \"param\": " << result.universes
+          << ", \"frames_sent\": " << result.frames_sent
+          << ", \"frames_received\": " << result.frames_received
+          << std::fixed << std::setprecision(1)
+          << ", \"frames_per_sec\": " << result.frames_per_sec
+          << std::setprecision(3)
+          << ", \"loss_percent\": " << result.loss_percent
+          << ", \"latency_p50_us\": " << result.latency_p50_us
+          << ", \"latency_p99_us\": " << result.latency_p99_us
+          << ", \"latency_max_us\": " << result.latency_max_us
+          << std::setprecision(1)
+          << ", \"olad_cpu_percent\": " << result.olad_cpu_percent
+          << ", \"olad_rss_kb\": " << result.olad_rss_kb
+          << ", \"olad_peak_rss_kb\": " << result.olad_peak_rss_kb
+          << std::setprecision(3)
+          << ", \"client_allocs_per_frame\": "
+          << result.client_allocs_per_frame << "}" << std::endl;
+}
+
+
+/*
+ * Start olad with a new config and run one path at one universe count.
+ */
+bool RunPath(const Path &path, unsigned int universes, RunResult *result) {
+  char config_dir[] = "/tmp/olad-perf-check-XXXXXX";
+  if (!mkdtemp(config_dir)) {
+    OLA_WARN << "Failed to create a config directory: " << strerror(errno);
+    return false;
+  }
+
+  bool ok = WriteConfig(config_dir, path, universes);
+  if (ok) {
+    OladProcess olad;
+    ok = olad.Start(config_dir);
+    if (ok) {
+      PerfRun run(path, universes, olad.Pid());
+      ok = run.Setup() && run.Run(result);
+    }
+  }
+  RemoveDirectory(config_dir);
+  return ok;
+}
+
+
+bool ParseUniverseCounts(const string &input, vector<unsigned int> *counts) {
+  vector<string> tokens;
+  ola::StringSplit(input, &tokens, ",");
+  vector<string>::const_iterator iter = tokens.begin();
+  for (; iter != tokens.end(); ++iter) {
+    unsigned int count;
+    if (!ola::StringToInt(*iter, &count) || count == 0 ||
+        count > ola::MAX_UNIVERSE) {
+      return false;
+    }
+    counts->push_back(count);
+  }
+  return !counts->empty();
+}
+
+
+bool ParsePaths(const string &input, vector<const Path*> *paths) {
+  vector<string> tokens;
+  ola::StringSplit(input, &tokens, ",");
+  vector<string>::const_iterator iter = tokens.begin();
+  for (; iter != tokens.end(); ++iter) {
+    const Path *path = NULL;
+    for (unsigned int i = 0; i < arraysize(PATHS); i++) {
+      if (*iter == PATHS[i].name) {
+        path = &PATHS[i];
+      }
+    }
+    if (!path) {
+      return false;
+    }
+    paths->push_back(path);
+  }
+  return !paths->empty();
+}
+
+
+/*
+ * Main
+ */
+int main(int argc, char *argv[]) {
+  ola::AppInit(
+      &argc, argv, "[options]",
+      "Run olad with the dummy plugin, send DMX to it over RPC, E1.31 and "
+      "ArtNet at several universe counts and report the throughput, latency, "
+      "CPU and memory use, one JSON object per line. If --baseline is given, "
+      "the results are compared with it and the exit status is 1 if any of "
+      "them regressed.");
+
+  vector<const Path*> paths;
+  if (!ParsePaths(FLAGS_paths.str(), &paths)) {
+    OLA_FATAL << "Invalid --paths " << FLAGS_paths.str();
+    exit(ola::EXIT_USAGE);
+  }
+  vector<unsigned int> universe_counts;
+  if (!ParseUniverseCounts(FLAGS_universes.str(), &universe_counts)) {
+    OLA_FATAL << "Invalid --universes " << FLAGS_universes.str();
+    exit(ola::EXIT_USAGE);
+  }
+  if (!FLAGS_rate || FLAGS_rate > 1000 || !FLAGS_duration) {
+    OLA_FATAL << "--rate must be between 1 and 1000 and --duration non-0";
+    exit(ola::EXIT_USAGE);
+  }
+
+  Baseline baseline;
+  if (!FLAGS_baseline.str().empty() &&
+      !LoadBaseline(FLAGS_baseline.str(), &baseline)) {
+    exit(ola::EXIT_NOINPUT);
+  }
+
+  std::ofstream output_file;
+  std::ostream *output = &std::cout;
+  if (!FLAGS_output.str().empty()) {
+    output_file.open(FLAGS_output.str().c_str());
+    if (!output_file.is_open()) {
+      OLA_FATAL << "Failed to open " << FLAGS_output.str();
+      exit(ola::EXIT_CANTCREAT);
+    }
+    output = &output_file;
+  }
+
+  vector<RunResult> results;
+  bool failed = false;
+  vector<const Path*>::const_iterator path_iter = paths.begin();
+  for (; path_iter != paths.end(); ++path_iter) {
+    const Path &path = **path_iter;
+    vector<unsigned int> counts_run;
+    vector<unsigned int>::const_iterator count_iter = universe_counts.begin();
+    for (; count_iter != universe_counts.end(); ++count_iter) {
+      unsigned int universes = *count_iter;
+      if (path.max_universes && universes > path.max_universes) {
+        universes = path.max_universes;
+      }
+      if (std::find(counts_run.begin(), counts_run.end(), universes) !=
+          counts_run.end()) {
+        continue;
+      }
+      counts_run.push_back(universes);
+
+      std::cerr << "Running " << path.name << " with " << universes
+                << " universes" << std::endl;
+      RunResult result;
+      if (!RunPath(path, universes, &result)) {
+        OLA_WARN << path.name << " with " << universes << " universes failed";
+        failed = true;
+        continue;
+      }
+      WriteResult(output, result);
+      results.push_back(result);
+    }
+  }
+
+  if (failed) {
+    exit(ola::EXIT_SOFTWARE);
+  }
+  if (!FLAGS_baseline.str().empty() &&
+      CompareWithBaseline(results, baseline)) {
+    return EXIT_FAILURE;
+  }
+  return ola::EXIT_OK;
+}
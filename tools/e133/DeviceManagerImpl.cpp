@@ -23,6 +23,7 @@
 #include <ola/acn/ACNPort.h>
 #include <ola/acn/CID.h>
 #include <ola/e133/E133Enums.h>
+#include <ola/io/IOStack.h>
 #include <ola/io/NonBlockingSender.h>
 #include <ola/io/SelectServer.h>
 #include <ola/network/AdvancedTCPConnector.h>
@@ -31,6 +32,7 @@
 #include <ola/network/TCPSocketFactory.h>
 #include <ola/stl/STLUtils.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -41,7 +43,6 @@
 
 #include "tools/e133/DeviceManagerImpl.h"
 #include "tools/e133/E133Endpoint.h"
-#include "tools/e133/E133HealthCheckedConnection.h"
 
 namespace ola {
 namespace e133 {
@@ -49,9 +50,9 @@ namespace e133 {
 using ola::NewCallback;
 using ola::NewSingleCallback;
 using ola::STLContains;
-using ola::STLFindOrNull;
 using ola::TimeInterval;
 using ola::acn::CID;
+using ola::io::IOStack;
 using ola::io::NonBlockingSender;
 using ola::network::GenericSocketAddress;
 using ola::network::IPV4Address;
@@ -63,42 +64,14 @@ using std::auto_ptr;
 using std::string;
 
 
-/**
- * Holds everything we need to manage a TCP connection to a E1.33 device.
- */
-class DeviceState {
- public:
-    DeviceState()
-      : socket(NULL),
-        message_queue(NULL),
-        health_checked_connection(NULL),
-        in_transport(NULL),
-        am_designated_controller(false) {
-    }
-
-    // The following may be NULL.
-    // The socket connected to the E1.33 device
-    auto_ptr<TCPSocket> socket;
-    auto_ptr<NonBlockingSender> message_queue;
-    // The Health Checked connection
-    auto_ptr<E133HealthCheckedConnection> health_checked_connection;
-    auto_ptr<IncomingTCPTransport> in_transport;
-
-    // True if we're the designated controller.
-    bool am_designated_controller;
-
- private:
-    DeviceState(const DeviceState&);
-    DeviceState& operator=(const DeviceState&);
-};
-
-
 // 5 second connect() timeout
 const TimeInterval DeviceManagerImpl::TCP_CONNECT_TIMEOUT(5, 0);
 // retry TCP connects after 5 seconds
 const TimeInterval DeviceManagerImpl::INITIAL_TCP_RETRY_DELAY(5, 0);
 // we grow the retry interval to a max of 30 seconds
 const TimeInterval DeviceManagerImpl::MAX_TCP_RETRY_DELAY(30, 0);
+// with 5 buckets, this gives a 5 second heartbeat interval
+const TimeInterval DeviceManagerImpl::HEALTH_CHECK_TICK(1, 0);
 
 
 /**
@@ -113,11 +86,21 @@ DeviceManagerImpl::DeviceManagerImpl(ola::io::SelectServerInterface *ss,
       m_connector(m_ss, &m_tcp_socket_factory, TCP_CONNECT_TIMEOUT),
       m_backoff_policy(INITIAL_TCP_RETRY_DELAY, MAX_TCP_RETRY_DELAY),
       m_message_builder(message_builder),
+      m_wheel_position(0),
+      m_health_check_timeout(ola::thread::INVALID_TIMEOUT),
       m_root_inflator(NewCallback(this, &DeviceManagerImpl::RLPDataReceived)) {
   m_root_inflator.AddInflator(&m_e133_inflator);
   m_e133_inflator.AddInflator(&m_rdm_inflator);
   m_rdm_inflator.SetRDMHandler(
       NewCallback(this, &DeviceManagerImpl::EndpointRequest));
+
+  IOStack heartbeat(m_message_builder->pool());
+  m_message_builder->BuildNullTCPPacket(&heartbeat);
+  heartbeat.Read(&m_heartbeat, heartbeat.Size());
+
+  m_health_check_timeout = m_ss->RegisterRepeatingTimeout(
+      HEALTH_CHECK_TICK,
+      NewCallback(this, &DeviceManagerImpl::RunHealthChecks));
 }
 
 
@@ -125,8 +108,15 @@ DeviceManagerImpl::DeviceManagerImpl(ola::io::SelectServerInterface *ss,
  * Clean up
  */
 DeviceManagerImpl::~DeviceManagerImpl() {
-  // close out all tcp sockets and free state
-  ola::STLDeleteValues(&m_device_map);
+  if (m_health_check_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_health_check_timeout);
+  }
+
+  // close out all tcp sockets
+  vector<DeviceState>::iterator iter = m_devices.begin();
+  for (; iter != m_devices.end(); ++iter) {
+    CloseConnection(&(*iter));
+  }
 }
 
 
@@ -167,8 +157,8 @@ void DeviceManagerImpl::AddDevice(const IPV4Address &ip_address) {
     return;
   }
 
-  DeviceState *device_state = new DeviceState();
-  m_device_map[ip_address.AsInt()] = device_state;
+  m_device_map[ip_address.AsInt()] = m_devices.size();
+  m_devices.push_back(DeviceState(ip_address));
 
   OLA_INFO << "Adding " << ip_address << ":" << ola::acn::E133_PORT;
   // start the non-blocking connect
@@ -210,10 +200,10 @@ void DeviceManagerImpl::RemoveDeviceIfNotConnected(
  * for.
  */
 void DeviceManagerImpl::ListManagedDevices(vector<IPV4Address> *devices) const {
-  DeviceMap::const_iterator iter = m_device_map.begin();
-  for (; iter != m_device_map.end(); ++iter) {
-    if (iter->second->am_designated_controller)
-      devices->push_back(IPV4Address(iter->first));
+  vector<DeviceState>::const_iterator iter = m_devices.begin();
+  for (; iter != m_devices.end(); ++iter) {
+    if (iter->am_designated_controller)
+      devices->push_back(iter->ip_address);
   }
 }
 
@@ -231,8 +221,7 @@ void DeviceManagerImpl::OnTCPConnect(TCPSocket *socket_ptr) {
     return;
   }
   IPV4SocketAddress v4_address = address.V4Addr();
-  DeviceState *device_state = STLFindOrNull(
-      m_device_map, v4_address.Host().AsInt());
+  DeviceState *device_state = GetDeviceState(v4_address.Host());
   if (!device_state) {
     OLA_FATAL << "Unable to locate socket for " << v4_address;
     return;
@@ -240,13 +229,13 @@ void DeviceManagerImpl::OnTCPConnect(TCPSocket *socket_ptr) {
 
   // setup the incoming transport, we don't need to setup the outgoing one
   // until we've got confirmation that we're the designated controller.
-  device_state->socket.reset(socket.release());
-  device_state->in_transport.reset(new IncomingTCPTransport(&m_root_inflator,
-                                                            socket_ptr));
+  device_state->socket = socket.release();
+  device_state->in_transport = new IncomingTCPTransport(&m_root_inflator,
+                                                        socket_ptr);
 
   device_state->socket->SetOnData(
       NewCallback(this, &DeviceManagerImpl::ReceiveTCPData, v4_address.Host(),
-                  device_state->in_transport.get()));
+                  device_state->in_transport));
   device_state->socket->SetOnClose(
       NewSingleCallback(this, &DeviceManagerImpl::SocketClosed,
                         v4_address.Host()));
@@ -288,7 +277,7 @@ void DeviceManagerImpl::SocketUnhealthy(IPV4Address ip_address) {
 void DeviceManagerImpl::SocketClosed(IPV4Address ip_address) {
   OLA_INFO << "connection to " << ip_address << " was closed";
 
-  DeviceState *device_state = STLFindOrNull(m_device_map, ip_address.AsInt());
+  DeviceState *device_state = GetDeviceState(ip_address);
   if (!device_state) {
     OLA_FATAL << "Unable to locate socket for " << ip_address;
     return;
@@ -307,11 +296,7 @@ void DeviceManagerImpl::SocketClosed(IPV4Address ip_address) {
         IPV4SocketAddress(ip_address, ola::acn::E133_PORT), true);
   }
 
-  device_state->health_checked_connection.reset();
-  device_state->message_queue.reset();
-  device_state->in_transport.reset();
-  m_ss->RemoveReadDescriptor(device_state->socket.get());
-  device_state->socket.reset();
+  CloseConnection(device_state);
 }
 
 
@@ -325,48 +310,137 @@ void DeviceManagerImpl::RLPDataReceived(
     return;
   IPV4Address src_ip = header.Source().Host();
 
-  DeviceState *device_state = STLFindOrNull(m_device_map, src_ip.AsInt());
+  DeviceState *device_state = GetDeviceState(src_ip);
   if (!device_state) {
     OLA_FATAL << "Received data but unable to lookup socket for " <<
       src_ip;
     return;
   }
 
-  // If we're already the designated controller, we just need to notify the
-  // HealthChecker.
+  // If we're already the designated controller, we just need to note that the
+  // connection is alive.
   if (device_state->am_designated_controller) {
-    device_state->health_checked_connection->HeartbeatReceived();
+    device_state->data_received = true;
     return;
   }
 
   // This is the first packet received on this connection, which is a sign
-  // we're now the designated controller. Setup the HealthChecker & outgoing
-  // transports.
+  // we're now the designated controller. Setup the outgoing transport & start
+  // health checking the connection.
   device_state->am_designated_controller = true;
   OLA_INFO << "Now the designated controller for " << header.Source();
   if (m_acquire_device_cb_.get())
     m_acquire_device_cb_->Run(src_ip);
 
-  device_state->message_queue.reset(
-      new NonBlockingSender(device_state->socket.get(), m_ss,
-                            m_message_builder->pool()));
+  if (device_state->message_queue) {
+    OLA_WARN << "pre-existing message queue for " << src_ip;
+    delete device_state->message_queue;
+  }
+  device_state->message_queue = new NonBlockingSender(
+      device_state->socket, m_ss, m_message_builder->pool());
+
+  // Spread the connections over the wheel by their position in the table.
+  if (device_state->wheel_bucket < 0) {
+    unsigned int index = m_device_map[src_ip.AsInt()];
+    unsigned int bucket = index % HEALTH_CHECK_WHEEL_SLOTS;
+    device_state->wheel_bucket = bucket;
+    m_health_check_wheel[bucket].push_back(index);
+  }
+  device_state->data_received = true;
+  device_state->missed_heartbeats = 0;
+  SendHeartbeat(device_state);
+}
+
+
+/**
+ * Called every HEALTH_CHECK_TICK. Check the connections in the next bucket of
+ * the wheel, sending heartbeats if required.
+ */
+bool DeviceManagerImpl::RunHealthChecks() {
+  m_wheel_position = (m_wheel_position + 1) % HEALTH_CHECK_WHEEL_SLOTS;
+  // Take a copy, since SocketUnhealthy() removes entries from the bucket.
+  const vector<unsigned int> bucket = m_health_check_wheel[m_wheel_position];
+
+  vector<unsigned int>::const_iterator iter = bucket.begin();
+  for (; iter != bucket.end(); ++iter) {
+    DeviceState *device_state = &m_devices[*iter];
+    if (device_state->wheel_bucket != static_cast<int>(m_wheel_position)) {
+      continue;
+    }
+
+    if (device_state->data_received) {
+      device_state->missed_heartbeats = 0;
+    } else if (++device_state->missed_heartbeats >= MAX_MISSED_HEARTBEATS) {
+      SocketUnhealthy(device_state->ip_address);
+      continue;
+    }
+    device_state->data_received = false;
+
+    // Other messages act as a heartbeat.
+    if (!device_state->message_sent) {
+      SendHeartbeat(device_state);
+    }
+    device_state->message_sent = false;
+  }
+  return true;
+}
+
+
+/**
+ * Send a heartbeat. This copies the pre-built message into blocks from the
+ * pool.
+ */
+void DeviceManagerImpl::SendHeartbeat(DeviceState *device_state) {
+  IOStack packet(m_message_builder->pool());
+  packet.Write(reinterpret_cast<const uint8_t*>(m_heartbeat.data()),
+               m_heartbeat.size());
+  device_state->message_queue->SendMessage(&packet);
+}
 
-  E133HealthCheckedConnection *health_checked_connection =
-      new E133HealthCheckedConnection(
-          m_message_builder,
-          device_state->message_queue.get(),
-          NewSingleCallback(this, &DeviceManagerImpl::SocketUnhealthy, src_ip),
-          m_ss);
 
-  if (!health_checked_connection->Setup()) {
-    OLA_WARN << "Failed to setup heartbeat controller for " << src_ip;
-    SocketClosed(src_ip);
+/**
+ * Remove a connection from the health check wheel.
+ */
+void DeviceManagerImpl::StopHealthCheck(DeviceState *device_state) {
+  if (device_state->wheel_bucket < 0) {
     return;
   }
 
-  if (device_state->health_checked_connection.get())
-    OLA_WARN << "pre-existing health_checked_connection for " << src_ip;
-  device_state->health_checked_connection.reset(health_checked_connection);
+  vector<unsigned int> *bucket =
+      &m_health_check_wheel[device_state->wheel_bucket];
+  bucket->erase(std::remove(bucket->begin(), bucket->end(),
+                            m_device_map[device_state->ip_address.AsInt()]),
+                bucket->end());
+  device_state->wheel_bucket = -1;
+}
+
+
+/**
+ * Free the connection state for a device.
+ */
+void DeviceManagerImpl::CloseConnection(DeviceState *device_state) {
+  StopHealthCheck(device_state);
+
+  delete device_state->message_queue;
+  device_state->message_queue = NULL;
+  delete device_state->in_transport;
+  device_state->in_transport = NULL;
+  if (device_state->socket) {
+    m_ss->RemoveReadDescriptor(device_state->socket);
+    delete device_state->socket;
+    device_state->socket = NULL;
+  }
+}
+
+
+/**
+ * Lookup the DeviceState for an IP address.
+ * @returns the DeviceState or NULL if the device isn't known.
+ */
+DeviceManagerImpl::DeviceState *DeviceManagerImpl::GetDeviceState(
+    const IPV4Address &ip_address) {
+  DeviceMap::const_iterator iter = m_device_map.find(ip_address.AsInt());
+  return iter == m_device_map.end() ? NULL : &m_devices[iter->second];
 }
 
 
@@ -392,9 +466,9 @@ void DeviceManagerImpl::EndpointRequest(
     return;
   }
 
-  DeviceState *device_state = STLFindOrNull(
-      m_device_map, transport_header->Source().Host().AsInt());
-  if (!device_state) {
+  DeviceState *device_state = GetDeviceState(
+      transport_header->Source().Host());
+  if (!device_state || !device_state->message_queue) {
     OLA_WARN << "Unable to find DeviceState for " << transport_header->Source();
     return;
   }
@@ -404,6 +478,7 @@ void DeviceManagerImpl::EndpointRequest(
       &packet, e133_header->Sequence(), e133_header->Endpoint(),
       ola::e133::SC_E133_ACK, "OK");
   device_state->message_queue->SendMessage(&packet);
+  device_state->message_sent = true;
 }
 }  // namespace e133
 }  // namespace ola
@@ -29,11 +29,13 @@
 #include <ola/Clock.h>
 #include <ola/Constants.h>
 #include <ola/e133/MessageBuilder.h>
+#include <ola/io/NonBlockingSender.h>
 #include <ola/io/SelectServerInterface.h>
 #include <ola/network/AdvancedTCPConnector.h>
 #include <ola/network/IPV4Address.h>
 #include <ola/network/Socket.h>
 #include <ola/network/TCPSocketFactory.h>
+#include <ola/thread/SchedulerInterface.h>
 
 #include <memory>
 #include <string>
@@ -60,6 +62,13 @@ using std::vector;
 
 /**
  * This class is responsible for maintaining connections to E1.33 devices.
+ *
+ * The state for each device is held in a flat table. Rather than a pair of
+ * timers per connection, the connections are health checked by a single
+ * repeating timer which walks a wheel of HEALTH_CHECK_WHEEL_SLOTS buckets,
+ * one bucket per tick, so each connection is visited once per heartbeat
+ * interval and the heartbeats are spread evenly over the interval.
+ *
  * TODO(simon): Some of this code can be re-used for the controller side. See
  * if we can factor it out.
  */
@@ -93,11 +102,51 @@ class DeviceManagerImpl {
     void ListManagedDevices(vector<IPV4Address> *devices) const;
 
  private:
-    // hash_map of IPs to DeviceState
-    typedef HASH_NAMESPACE::HASH_MAP_CLASS<uint32_t, class DeviceState*>
+    // The heartbeat interval is HEALTH_CHECK_WHEEL_SLOTS * HEALTH_CHECK_TICK.
+    static const unsigned int HEALTH_CHECK_WHEEL_SLOTS = 5;
+
+    /**
+     * Holds everything we need to manage a TCP connection to a E1.33 device.
+     * The pointers are owned by the DeviceManagerImpl, and may be NULL.
+     */
+    struct DeviceState {
+      IPV4Address ip_address;
+      // The socket connected to the E1.33 device
+      TCPSocket *socket;
+      ola::io::NonBlockingSender *message_queue;
+      ola::acn::IncomingTCPTransport *in_transport;
+
+      // True if we're the designated controller.
+      bool am_designated_controller;
+
+      // The health check wheel bucket, or -1 if the connection isn't being
+      // health checked.
+      int wheel_bucket;
+      // Set when data is sent or received, and cleared each time the health
+      // check visits the connection.
+      bool message_sent;
+      bool data_received;
+      unsigned int missed_heartbeats;
+
+      explicit DeviceState(const IPV4Address &ip_address)
+          : ip_address(ip_address),
+            socket(NULL),
+            message_queue(NULL),
+            in_transport(NULL),
+            am_designated_controller(false),
+            wheel_bucket(-1),
+            message_sent(false),
+            data_received(false),
+            missed_heartbeats(0) {
+      }
+    };
+
+    // hash_map of IPs to the index in m_devices
+    typedef HASH_NAMESPACE::HASH_MAP_CLASS<uint32_t, unsigned int>
       DeviceMap;
 
     DeviceMap m_device_map;
+    vector<DeviceState> m_devices;
     auto_ptr<RDMMesssageCallback> m_rdm_callback;
     auto_ptr<AcquireDeviceCallback> m_acquire_device_cb_;
     auto_ptr<ReleaseDeviceCallback> m_release_device_cb_;
@@ -109,6 +158,12 @@ class DeviceManagerImpl {
     ola::LinearBackoffPolicy m_backoff_policy;
 
     ola::e133::MessageBuilder *m_message_builder;
+    // The serialized heartbeat, which is the same for every connection.
+    string m_heartbeat;
+
+    vector<unsigned int> m_health_check_wheel[HEALTH_CHECK_WHEEL_SLOTS];
+    unsigned int m_wheel_position;
+    ola::thread::timeout_id m_health_check_timeout;
 
     // inflators
     ola::acn::RootInflator m_root_inflator;
@@ -127,6 +182,11 @@ class DeviceManagerImpl {
     void SocketUnhealthy(IPV4Address address);
     void SocketClosed(IPV4Address address);
     void RLPDataReceived(const ola::acn::TransportHeader &header);
+    bool RunHealthChecks();
+    void SendHeartbeat(DeviceState *device_state);
+    void StopHealthCheck(DeviceState *device_state);
+    void CloseConnection(DeviceState *device_state);
+    DeviceState *GetDeviceState(const IPV4Address &ip_address);
 
     void EndpointRequest(
         const ola::acn::TransportHeader *transport_header,
@@ -136,6 +196,8 @@ class DeviceManagerImpl {
     static const TimeInterval TCP_CONNECT_TIMEOUT;
     static const TimeInterval INITIAL_TCP_RETRY_DELAY;
     static const TimeInterval MAX_TCP_RETRY_DELAY;
+    static const TimeInterval HEALTH_CHECK_TICK;
+    static const unsigned int MAX_MISSED_HEARTBEATS = 3;
 };
 }  // namespace e133
 }  // namespace ola
@@ -38,6 +38,8 @@
 #include "libs/acn/RDMPDU.h"
 #include "libs/acn/RDMInflator.h"
 #include "libs/acn/E133StatusInflator.h"
+#include "libs/acn/E133StatusPDU.h"
+#include "libs/acn/PreamblePacker.h"
 #include "libs/acn/UDPTransport.h"
 
 #include "tools/e133/E133Device.h"
@@ -51,6 +53,7 @@ using ola::io::IOStack;
 using ola::network::HealthCheckedConnection;
 using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
+using ola::acn::PreamblePacker;
 using ola::acn::RDMPDU;
 using std::auto_ptr;
 using std::string;
@@ -99,7 +102,9 @@ E133Device::E133Device(ola::io::SelectServerInterface *ss,
       m_endpoint_manager(endpoint_manager),
       m_root_endpoint(NULL),
       m_root_rdm_device(NULL),
-      m_incoming_udp_transport(&m_udp_socket, &m_root_inflator) {
+      m_incoming_udp_transport(&m_udp_socket, &m_root_inflator,
+                               UDP_RECEIVE_BATCH_SIZE),
+      m_batching_replies(false) {
   m_root_inflator.AddInflator(&m_e133_inflator);
   m_e133_inflator.AddInflator(&m_rdm_inflator);
   m_e133_inflator.AddInflator(&m_rdm_inflator);
@@ -153,9 +158,7 @@ bool E133Device::Init() {
     return false;
   }
 
-  m_udp_socket.SetOnData(
-        NewCallback(&m_incoming_udp_transport,
-                    &ola::acn::IncomingUDPTransport::Receive));
+  m_udp_socket.SetOnData(NewCallback(this, &E133Device::ReceiveUDPData));
 
   m_ss->AddReadDescriptor(&m_udp_socket);
   return true;
@@ -267,13 +270,8 @@ void E133Device::EndpointRequestComplete(
   IOStack packet(m_message_builder.pool());
   ola::rdm::RDMCommandSerializer::Write(*reply->Response(), &packet);
   RDMPDU::PrependPDU(&packet);
-  m_message_builder.BuildUDPRootE133(
-      &packet, ola::acn::VECTOR_FRAMING_RDMNET, sequence_number,
-      endpoint_id);
-
-  if (!m_udp_socket.SendTo(&packet, target)) {
-    OLA_WARN << "Failed to send E1.33 response to " << target;
-  }
+  SendReply(target, &packet, ola::acn::VECTOR_FRAMING_RDMNET,
+            sequence_number, endpoint_id);
 }
 
 
@@ -284,10 +282,93 @@ void E133Device::SendStatusMessage(
     ola::e133::E133StatusCode status_code,
     const string &description) {
   IOStack packet(m_message_builder.pool());
-  m_message_builder.BuildUDPE133StatusPDU(
-      &packet, sequence_number, endpoint_id,
-      status_code, description);
-  if (!m_udp_socket.SendTo(&packet, target)) {
-    OLA_WARN << "Failed to send E1.33 response to " << target;
+  ola::acn::E133StatusPDU::PrependPDU(&packet, status_code, description);
+  SendReply(target, &packet, ola::acn::VECTOR_FRAMING_STATUS,
+            sequence_number, endpoint_id);
+}
+
+
+/**
+ * Read a batch of datagrams. The replies to requests which complete while the
+ * batch is processed are sent together, one datagram per controller.
+ */
+void E133Device::ReceiveUDPData() {
+  m_batching_replies = true;
+  m_incoming_udp_transport.Receive();
+  m_batching_replies = false;
+  FlushReplies();
+}
+
+
+/**
+ * Send a reply, or add it to the pending replies for the controller if we're
+ * processing a batch of requests.
+ */
+void E133Device::SendReply(const IPV4SocketAddress &target,
+                           IOStack *packet,
+                           uint32_t framing_vector,
+                           uint32_t sequence_number,
+                           uint16_t endpoint_id) {
+  if (!m_batching_replies) {
+    m_message_builder.BuildUDPRootE133(packet, framing_vector,
+                                       sequence_number, endpoint_id);
+    if (!m_udp_socket.SendTo(packet, target)) {
+      OLA_WARN << "Failed to send E1.33 response to " << target;
+    }
+    return;
+  }
+
+  m_message_builder.BuildRootE133(packet, framing_vector, sequence_number,
+                                  endpoint_id);
+
+  PendingReplies *pending = NULL;
+  vector<PendingReplies>::iterator iter = m_pending_replies.begin();
+  for (; iter != m_pending_replies.end(); ++iter) {
+    if (iter->target == target) {
+      pending = &(*iter);
+      break;
+    }
+  }
+  if (!pending) {
+    m_pending_replies.push_back(PendingReplies(target));
+    pending = &m_pending_replies.back();
+  }
+
+  const unsigned int max_block_size = PreamblePacker::MAX_DATAGRAM_SIZE -
+                                      PreamblePacker::ACN_HEADER_SIZE;
+  if (pending->pdu_block.size() + packet->Size() > max_block_size) {
+    SendPendingReplies(pending);
+  }
+  packet->Read(&pending->pdu_block, packet->Size());
+}
+
+
+/**
+ * Send the pending replies for a controller as a single datagram.
+ */
+void E133Device::SendPendingReplies(PendingReplies *pending) {
+  if (pending->pdu_block.empty()) {
+    return;
+  }
+
+  IOStack packet(m_message_builder.pool());
+  packet.Write(reinterpret_cast<const uint8_t*>(pending->pdu_block.data()),
+               pending->pdu_block.size());
+  PreamblePacker::AddUDPPreamble(&packet);
+  if (!m_udp_socket.SendTo(&packet, pending->target)) {
+    OLA_WARN << "Failed to send E1.33 response to " << pending->target;
+  }
+  pending->pdu_block.clear();
+}
+
+
+/**
+ * Send all the pending replies.
+ */
+void E133Device::FlushReplies() {
+  vector<PendingReplies>::iterator iter = m_pending_replies.begin();
+  for (; iter != m_pending_replies.end(); ++iter) {
+    SendPendingReplies(&(*iter));
   }
+  m_pending_replies.clear();
 }
@@ -27,6 +27,7 @@
 #include "ola/Clock.h"
 #include "ola/acn/CID.h"
 #include "ola/e133/MessageBuilder.h"
+#include "ola/io/IOStack.h"
 #include "ola/io/SelectServerInterface.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/Socket.h"
@@ -87,6 +88,24 @@ class E133Device {
     // transports
     ola::acn::IncomingUDPTransport m_incoming_udp_transport;
 
+    /**
+     * The replies to a controller that are waiting to be sent. This is a
+     * block of Root Layer PDUs, without the preamble.
+     */
+    struct PendingReplies {
+      ola::network::IPV4SocketAddress target;
+      string pdu_block;
+
+      explicit PendingReplies(const ola::network::IPV4SocketAddress &target)
+          : target(target) {}
+    };
+
+    // True while a batch of datagrams is being processed.
+    bool m_batching_replies;
+    std::vector<PendingReplies> m_pending_replies;
+
+    void ReceiveUDPData();
+
     void EndpointRequest(
         const ola::acn::TransportHeader *transport_header,
         const ola::acn::E133Header *e133_header,
@@ -102,5 +121,16 @@ class E133Device {
                            uint16_t endpoint_id,
                            ola::e133::E133StatusCode status_code,
                            const string &description);
+
+    void SendReply(const ola::network::IPV4SocketAddress &target,
+                   ola::io::IOStack *packet,
+                   uint32_t framing_vector,
+                   uint32_t sequence_number,
+                   uint16_t endpoint_id);
+    void SendPendingReplies(PendingReplies *pending);
+    void FlushReplies();
+
+    // The number of datagrams to read from the UDP socket at once.
+    static const unsigned int UDP_RECEIVE_BATCH_SIZE = 32;
 };
 #endif  // TOOLS_E133_E133DEVICE_H_
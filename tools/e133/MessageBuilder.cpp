@@ -100,6 +100,20 @@ void MessageBuilder::BuildUDPE133StatusPDU(ola::io::IOStack *packet,
 }
 
 
+/**
+ * Append an E133PDU and a RootPDU to a packet. Several of these can be sent
+ * in a single datagram.
+ */
+void MessageBuilder::BuildRootE133(IOStack *packet,
+                                   uint32_t vector,
+                                   uint32_t sequence_number,
+                                   uint16_t endpoint_id) {
+  E133PDU::PrependPDU(packet, vector, m_source_name, sequence_number,
+                      endpoint_id);
+  RootPDU::PrependPDU(packet, ola::acn::VECTOR_ROOT_E133, m_cid);
+}
+
+
 /**
  * Append an E133PDU, a RootPDU and the TCP preamble to a packet.
  */
@@ -107,9 +121,7 @@ void MessageBuilder::BuildTCPRootE133(IOStack *packet,
                                       uint32_t vector,
                                       uint32_t sequence_number,
                                       uint16_t endpoint_id) {
-  E133PDU::PrependPDU(packet, vector, m_source_name, sequence_number,
-                      endpoint_id);
-  RootPDU::PrependPDU(packet, ola::acn::VECTOR_ROOT_E133, m_cid);
+  BuildRootE133(packet, vector, sequence_number, endpoint_id);
   PreamblePacker::AddTCPPreamble(packet);
 }
 
@@ -121,9 +133,7 @@ void MessageBuilder::BuildUDPRootE133(IOStack *packet,
                                       uint32_t vector,
                                       uint32_t sequence_number,
                                       uint16_t endpoint_id) {
-  E133PDU::PrependPDU(packet, vector, m_source_name, sequence_number,
-                      endpoint_id);
-  RootPDU::PrependPDU(packet, ola::acn::VECTOR_ROOT_E133, m_cid);
+  BuildRootE133(packet, vector, sequence_number, endpoint_id);
   PreamblePacker::AddUDPPreamble(packet);
 }
 }  // namespace e133
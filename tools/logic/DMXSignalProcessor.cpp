@@ -38,10 +38,16 @@
  *  rising edge occurs before 35.28 (9 * 3.92) us then it was a start-bit. If
  *  36.72 (9 * 4.08) useconds passes and there was no rising edge it's a break.
  *
- * The implementation is based on a state machine, with a couple of tweaks.
+ * Rather than running a state machine per sample, the samples are scanned a
+ * word at a time for edges. The state machine is then run on each run of
+ * high or low samples. Within a slot, bits are sampled at their centre,
+ * measured from the falling edge of the start bit.
  */
 
 #include <ola/Logging.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
 #include <vector>
 
 #include "tools/logic/DMXSignalProcessor.h"
@@ -52,8 +58,6 @@ const double DMXSignalProcessor::MIN_BREAK_TIME = 88.0;
 const double DMXSignalProcessor::MIN_MAB_TIME = 8.0;
 const double DMXSignalProcessor::MAX_MAB_TIME = 1000000.0;
 const double DMXSignalProcessor::MIN_BIT_TIME = 3.75;
-const double DMXSignalProcessor::MAX_BIT_TIME = 4.08;
-const double DMXSignalProcessor::MIN_LAST_BIT_TIME = 2.64;
 const double DMXSignalProcessor::MAX_MARK_BETWEEN_SLOTS = 1000000.0;
 
 /**
@@ -65,10 +69,14 @@ DMXSignalProcessor::DMXSignalProcessor(DataCallback *callback,
     : m_callback(callback),
       m_sample_rate(sample_rate),
       m_microseconds_per_tick(1000000.0 / sample_rate),
+      m_ticks_per_bit(static_cast<double>(sample_rate) / DMX_BITRATE),
       m_state(IDLE),
+      m_level(true),
       m_ticks(0),
-      m_may_be_in_break(false),
-      m_ticks_in_break(0) {
+      m_run_ticks(0),
+      m_slot_ticks(0),
+      m_bit(0),
+      m_current_byte(0) {
   if (m_sample_rate % DMX_BITRATE) {
     OLA_WARN << "Sample rate is not a multiple of " << DMX_BITRATE;
   }
@@ -85,105 +93,95 @@ DMXSignalProcessor::DMXSignalProcessor(DataCallback *callback,
  */
 void DMXSignalProcessor::Process(uint8_t *ptr, unsigned int size,
                                  uint8_t mask) {
-  for (unsigned int i = 0 ; i < size; i++) {
-    ProcessSample(ptr[i] & mask);
+  unsigned int offset = 0;
+  while (offset < size) {
+    unsigned int edge = FindEdge(ptr, offset, size, mask);
+    m_run_ticks += edge - offset;
+    offset = edge;
+    if (edge < size) {
+      ProcessRun(m_level, m_run_ticks);
+      m_level = !m_level;
+      m_run_ticks = 0;
+    }
+  }
+
+  // A long enough mark ends the frame, so don't wait for the next falling
+  // edge to report it.
+  static const double MAX_MARK = std::min(MAX_MAB_TIME,
+                                          MAX_MARK_BETWEEN_SLOTS);
+  if (m_level && m_run_ticks * m_microseconds_per_tick >= MAX_MARK) {
+    ProcessRun(true, m_run_ticks);
+    m_run_ticks = 0;
   }
 }
 
 /**
- * Process one bit of data through the state machine.
+ * Find the first sample, at or after offset, that differs from the current
+ * level.
+ * @returns the offset of the edge, or size if there isn't one.
  */
-void DMXSignalProcessor::ProcessSample(bool bit) {
-  if (m_may_be_in_break && !bit) {
-    // if we may be in a break, keep track of the time since the falling edge.
-    m_ticks_in_break++;
+unsigned int DMXSignalProcessor::FindEdge(const uint8_t *ptr,
+                                          unsigned int offset,
+                                          unsigned int size,
+                                          uint8_t mask) const {
+  static const uint64_t LOW_BITS = 0x0101010101010101ULL;
+  static const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+  const uint64_t mask_word = LOW_BITS * mask;
+
+  while (offset + sizeof(uint64_t) <= size) {
+    uint64_t word;
+    memcpy(&word, ptr + offset, sizeof(word));
+    word &= mask_word;
+    // When the signal is low, any non-zero byte is an edge. When it's high,
+    // any zero byte is.
+    bool has_edge = m_level ? ((word - LOW_BITS) & ~word & HIGH_BITS) : word;
+    if (has_edge) {
+      break;
+    }
+    offset += sizeof(word);
   }
 
+  while (offset < size && static_cast<bool>(ptr[offset] & mask) == m_level) {
+    offset++;
+  }
+  return offset;
+}
+
+/**
+ * Process a run of samples at the same level through the state machine.
+ */
+void DMXSignalProcessor::ProcessRun(bool level, unsigned int ticks) {
+  m_ticks = ticks;
+
   switch (m_state) {
     case UNDEFINED:
-      if (bit) {
+      if (level) {
         SetState(IDLE);
       }
       break;
     case IDLE:
-      if (bit) {
-        m_ticks++;
-      } else {
-        SetState(BREAK);
-      }
-      break;
-    case BREAK:
-      if (bit) {
+      if (!level) {
         if (DurationExceeds(MIN_BREAK_TIME)) {
-          SetState(MAB);
+          SetState(BREAK);
         } else {
           OLA_WARN << "Break too short, was " << TicksAsMicroSeconds()
                    << " us";
-          SetState(IDLE);
-        }
-      } else {
-        m_ticks++;
-      }
-      break;
-    case MAB:
-      if (bit) {
-        m_ticks++;
-        if (DurationExceeds(MAX_MAB_TIME)) {
-          SetState(IDLE, m_ticks);
-        }
-      } else {
-        if (DurationExceeds(MIN_MAB_TIME)) {
-          // OLA_INFO << "In start bit!";
-          SetState(START_BIT);
-        } else {
-          OLA_WARN << "Mark too short, was " << TicksAsMicroSeconds() << "us";
-          SetState(UNDEFINED);
         }
       }
       break;
-    case START_BIT:
-    case BIT_1:
-    case BIT_2:
-    case BIT_3:
-    case BIT_4:
-    case BIT_5:
-    case BIT_6:
-    case BIT_7:
-    case BIT_8:
-      ProcessBit(bit);
-      break;
-    case STOP_BITS:
-      m_ticks++;
-      if (bit) {
-        if (DurationExceeds(2 * MIN_BIT_TIME)) {
-          AppendDataByte();
-          SetState(MARK_BETWEEN_SLOTS);
-        }
+    case BREAK:
+      // This is the mark after break.
+      if (!DurationExceeds(MIN_MAB_TIME)) {
+        OLA_WARN << "Mark too short, was " << TicksAsMicroSeconds() << "us";
+        SetState(UNDEFINED);
+      } else if (DurationExceeds(MAX_MAB_TIME)) {
+        SetState(IDLE);
       } else {
-        if (m_may_be_in_break) {
-          HandleFrame();
-          SetState(BREAK, m_ticks_in_break);
-        } else {
-          OLA_WARN << "Saw a low during a stop bit";
-          SetState(UNDEFINED);
-        }
+        SetState(SLOT);
       }
       break;
-    case MARK_BETWEEN_SLOTS:
-      // Wait for the falling edge, this could signal the next start bit, or a
-      // new break.
-      m_ticks++;
-      if (bit) {
-        if (DurationExceeds(MAX_MARK_BETWEEN_SLOTS)) {
-          // ok, that was the end of the frame.
-          HandleFrame();
-          SetState(IDLE);
-        }
-      } else {
-        m_may_be_in_break = true;
-        // Assume it's a start bit for now, but flag that we may be in a break.
-        SetState(START_BIT);
-      }
+    case SLOT:
+      ProcessSlotRun(level, ticks);
       break;
     default:
       break;
@@ -191,78 +189,79 @@ void DMXSignalProcessor::ProcessSample(bool bit) {
 }
 
 /**
- * Process a sample that makes up a bit of data.
+ * Process a run of samples within a slot.
  */
-void DMXSignalProcessor::ProcessBit(bool bit) {
-  if (bit) {
-    // a high at this stage means this definitely isn't a break.
-    m_may_be_in_break = false;
+void DMXSignalProcessor::ProcessSlotRun(bool level, unsigned int ticks) {
+  if (!level && m_bit == 0 && DurationExceeds(MIN_BREAK_TIME)) {
+    // What we thought was a start bit was the break for the next frame.
+    HandleFrame();
+    SetState(BREAK);
+    return;
   }
 
-  bool current_bit = SetBitIfNotDefined(bit);
+  if (!DurationExceeds(MIN_BIT_TIME)) {
+    OLA_WARN << "Bit " << m_bit << " was too short, was "
+             << TicksAsMicroSeconds() << "us";
+    SetState(UNDEFINED);
+    return;
+  }
 
-  /*
-  OLA_INFO << "ticks: " << m_ticks << ", current bit " << current_bit
-           << ", our bit " << bit;
-  */
-  m_ticks++;
-  if (bit == current_bit) {
-    if (DurationExceeds(MAX_BIT_TIME)) {
-      SetState(static_cast<State>(m_state + 1));
+  const double run_end = m_slot_ticks + ticks;
+  while (m_bit < BITS_PER_SLOT &&
+         (m_bit + 0.5) * m_ticks_per_bit < run_end) {
+    if (m_bit >= FIRST_STOP_BIT && !level) {
+      if (m_slot_ticks == 0) {
+        OLA_WARN << "Break too short, was " << TicksAsMicroSeconds()
+                 << " us";
+        HandleFrame();
+        SetState(IDLE);
+      } else {
+        OLA_WARN << "Saw a low during a stop bit";
+        SetState(UNDEFINED);
+      }
+      return;
     }
-  } else {
-    // Because we force a transition into the next state (bit) after
-    // MAX_BIT_TIME. The last bit may appear to be too short. This math is as
-    // follows:
-    //  min time for 9 bits = 9 * 3.92 = 35.28
-    //  max time for 8 bits = 8 * 4.08 = 32.64
-    //  difference = 2.64
-    if ((m_state == BIT_8 && DurationExceeds(MIN_LAST_BIT_TIME)) ||
-        DurationExceeds(MIN_BIT_TIME)) {
-      SetState(static_cast<State>(m_state + 1));
+    if (level && m_bit > 0 && m_bit < FIRST_STOP_BIT) {
+      // LSB first
+      m_current_byte |= (1 << (m_bit - 1));
+    }
+    m_bit++;
+  }
+  m_slot_ticks = run_end;
+
+  if (m_bit == BITS_PER_SLOT) {
+    // The rest of this run is the mark between slots.
+    AppendDataByte();
+    double mark = ((m_slot_ticks - BITS_PER_SLOT * m_ticks_per_bit) *
+                   m_microseconds_per_tick);
+    if (mark >= MAX_MARK_BETWEEN_SLOTS) {
+      // ok, that was the end of the frame.
+      HandleFrame();
+      SetState(IDLE);
     } else {
-      OLA_WARN << "Bit " << m_state << " was too short, was "
-               << TicksAsMicroSeconds() << "us";
-      SetState(UNDEFINED);
+      // The next falling edge is either a start bit or a break.
+      StartSlot();
     }
   }
 }
 
 /**
- * This is where we accumulate the bit values, before packing them into a byte.
- * This method does a couple of things:
- *  If there is no known value for the bit, it sets one.
- *  Return the value of the bit.
+ * Get ready to decode a slot.
  */
-bool DMXSignalProcessor::SetBitIfNotDefined(bool bit) {
-  if (m_state == START_BIT) {
-    return false;
-  }
-
-  int offset = m_state - BIT_1;
-  if (!m_bits_defined[offset]) {
-    // OLA_INFO << "Set bit " << offset << " to " << bit;
-    m_current_byte.push_back(bit);
-    m_bits_defined[offset] = true;
-  }
-  return m_current_byte[offset];
+void DMXSignalProcessor::StartSlot() {
+  m_slot_ticks = 0;
+  m_bit = 0;
+  m_current_byte = 0;
 }
 
 /**
- * Pack the 8 bit values into a byte, and append it to the vector of bytes.
+ * Append the byte for the current slot to the vector of bytes.
  */
 void DMXSignalProcessor::AppendDataByte() {
-  uint8_t byte = 0;
-  for (unsigned int i = 0; i < 8; i++) {
-    // LSB first
-    byte |= (m_current_byte[i] << i);
-  }
   OLA_INFO << "Byte " << m_dmx_data.size() << " is "
-           << static_cast<int>(byte) << " ( 0x" << std::hex
-           << static_cast<int>(byte) << " )";
-  m_dmx_data.push_back(byte);
-  m_bits_defined.assign(8, false);
-  m_current_byte.clear();
+           << static_cast<int>(m_current_byte) << " ( 0x" << std::hex
+           << static_cast<int>(m_current_byte) << " )";
+  m_dmx_data.push_back(m_current_byte);
 }
 
 /**
@@ -281,20 +280,17 @@ void DMXSignalProcessor::HandleFrame() {
 /**
  * Used to transition between states
  */
-void DMXSignalProcessor::SetState(State state, unsigned int ticks) {
+void DMXSignalProcessor::SetState(State state) {
   OLA_INFO << "Transition to " << state << ", prev duration was "
            << TicksAsMicroSeconds();
   m_state = state;
-  m_ticks = ticks;
   if (state == UNDEFINED) {
     // if we have a partial frame, we should send that up the stack
     HandleFrame();
-  } else if (state == MAB) {
+  } else if (state == BREAK) {
     m_dmx_data.clear();
-  } else if (state == START_BIT) {
-    // The reset should be done in AppendDataByte but do it again to be safe.
-    m_bits_defined.assign(8, false);
-    m_current_byte.clear();
+  } else if (state == SLOT) {
+    StartSlot();
   }
 }
 
@@ -29,6 +29,10 @@
 
 /**
  * Process a DMX signal.
+ *
+ * The samples are scanned a word at a time for edges, and the state machine
+ * is then run once per run of high or low samples, rather than once per
+ * sample.
  */
 class DMXSignalProcessor {
  public:
@@ -38,6 +42,8 @@ class DMXSignalProcessor {
 
     // Reset the processor. Used if there is a gap in the stream.
     void Reset() {
+      m_level = true;
+      m_run_ticks = 0;
       SetState(IDLE);
     }
 
@@ -48,62 +54,55 @@ class DMXSignalProcessor {
     enum State {
       UNDEFINED,  // when the signal is low and we have no idea where we are.
       IDLE,
-      BREAK,
-      MAB,
-      START_BIT,
-      BIT_1,
-      BIT_2,
-      BIT_3,
-      BIT_4,
-      BIT_5,
-      BIT_6,
-      BIT_7,
-      BIT_8,
-      STOP_BITS,
-      MARK_BETWEEN_SLOTS,
+      BREAK,  // a valid break has been seen, waiting for the MAB.
+      SLOT,  // within a slot, or the mark between slots.
     };
 
     // Set once in the constructor
     DataCallback* const m_callback;
     const unsigned int m_sample_rate;
     const double m_microseconds_per_tick;
+    const double m_ticks_per_bit;
 
     // our current state.
     State m_state;
-    // the number of ticks (samples) we've been in this state.
+    // The level of the current run, and the number of ticks (samples) in it.
+    bool m_level;
     unsigned int m_ticks;
-    // sometimes we may not know if we're in a break or not, see the comments
-    // in DMXSignalProcessor.cpp
-    bool m_may_be_in_break;
-    unsigned int m_ticks_in_break;
+    unsigned int m_run_ticks;
 
-    // Used to accumulate the bits in the current byte.
-    std::vector<bool> m_bits_defined;
-    std::vector<bool> m_current_byte;
+    // The number of ticks since the falling edge of the start bit, and the
+    // next bit to be sampled.
+    double m_slot_ticks;
+    unsigned int m_bit;
+    uint8_t m_current_byte;
 
     // The bytes are stored here.
     std::vector<uint8_t> m_dmx_data;
 
-    void ProcessSample(bool bit);
-    void ProcessBit(bool bit);
-    bool SetBitIfNotDefined(bool bit);
+    unsigned int FindEdge(const uint8_t *ptr, unsigned int offset,
+                          unsigned int size, uint8_t mask) const;
+    void ProcessRun(bool level, unsigned int ticks);
+    void ProcessSlotRun(bool level, unsigned int ticks);
+    void SampleBits(bool level, unsigned int ticks);
+    void StartSlot();
     void AppendDataByte();
     void HandleFrame();
 
-    void SetState(State state, unsigned int ticks = 1);
+    void SetState(State state);
     bool DurationExceeds(double micro_seconds);
     double TicksAsMicroSeconds();
 
     static const unsigned int DMX_BITRATE = 250000;
+    // A slot is a start bit, 8 data bits and two stop bits.
+    static const unsigned int BITS_PER_SLOT = 11;
+    static const unsigned int FIRST_STOP_BIT = 9;
     // These are all in microseconds and are the receiver side limits.
     static const double MIN_BREAK_TIME;
     static const double MIN_MAB_TIME;
     static const double MAX_MAB_TIME;
-    // The minimum bit time, based on a 4MHz sample rate.
-    // TODO(simon): adjust this based on the sample rate.
+    // Runs shorter than this within a slot are treated as noise.
     static const double MIN_BIT_TIME;
-    static const double MAX_BIT_TIME;
-    static const double MIN_LAST_BIT_TIME;
     static const double MAX_MARK_BETWEEN_SLOTS;
 };
 #endif  // TOOLS_LOGIC_DMXSIGNALPROCESSOR_H_
@@ -0,0 +1,288 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMXSignalProcessorTest.cpp
+ * Test fixture for the DMXSignalProcessor class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <ola/Callback.h>
+#include <ola/Logging.h>
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "tools/logic/DMXSignalProcessor.h"
+#include "ola/testing/TestUtils.h"
+
+using std::string;
+using std::vector;
+
+
+class DMXSignalProcessorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DMXSignalProcessorTest);
+  CPPUNIT_TEST(testFrame);
+  CPPUNIT_TEST(testSampleRates);
+  CPPUNIT_TEST(testSplitBuffers);
+  CPPUNIT_TEST(testMask);
+  CPPUNIT_TEST(testMarkBetweenSlots);
+  CPPUNIT_TEST(testShortBreak);
+  CPPUNIT_TEST(testBadStopBit);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testFrame();
+  void testSampleRates();
+  void testSplitBuffers();
+  void testMask();
+  void testMarkBetweenSlots();
+  void testShortBreak();
+  void testBadStopBit();
+
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_STDERR);
+    m_frames.clear();
+  }
+
+ private:
+  vector<string> m_frames;
+
+  void FrameReceived(const uint8_t *data, unsigned int length) {
+    m_frames.push_back(string(reinterpret_cast<const char*>(data), length));
+  }
+
+  DMXSignalProcessor::DataCallback *NewFrameCallback() {
+    return ola::NewCallback(this, &DMXSignalProcessorTest::FrameReceived);
+  }
+
+  void AddLevel(vector<uint8_t> *samples, bool level, double micro_seconds,
+                unsigned int sample_rate);
+  void AddSlot(vector<uint8_t> *samples, uint8_t value,
+               unsigned int sample_rate, double bit_time = 4.0);
+  vector<uint8_t> BuildFrame(const string &data, unsigned int sample_rate,
+                             double mark_between_slots = 0.0);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DMXSignalProcessorTest);
+
+
+/**
+ * Append samples for a level lasting micro_seconds.
+ */
+void DMXSignalProcessorTest::AddLevel(vector<uint8_t> *samples, bool level,
+                                      double micro_seconds,
+                                      unsigned int sample_rate) {
+  unsigned int count = static_cast<unsigned int>(
+      micro_seconds * sample_rate / 1000000.0 + 0.5);
+  samples->insert(samples->end(), count, level ? 1 : 0);
+}
+
+
+/**
+ * Append the samples for one slot.
+ */
+void DMXSignalProcessorTest::AddSlot(vector<uint8_t> *samples, uint8_t value,
+                                     unsigned int sample_rate,
+                                     double bit_time) {
+  AddLevel(samples, false, bit_time, sample_rate);
+  for (unsigned int i = 0; i < 8; i++) {
+    AddLevel(samples, (value >> i) & 1, bit_time, sample_rate);
+  }
+  AddLevel(samples, true, 2 * bit_time, sample_rate);
+}
+
+
+/**
+ * Build the samples for a frame, including the break and mark after break.
+ */
+vector<uint8_t> DMXSignalProcessorTest::BuildFrame(
+    const string &data,
+    unsigned int sample_rate,
+    double mark_between_slots) {
+  vector<uint8_t> samples;
+  AddLevel(&samples, true, 20, sample_rate);
+  AddLevel(&samples, false, 100, sample_rate);
+  AddLevel(&samples, true, 12, sample_rate);
+  for (unsigned int i = 0; i < data.size(); i++) {
+    AddSlot(&samples, data[i], sample_rate);
+    AddLevel(&samples, true, mark_between_slots, sample_rate);
+  }
+  return samples;
+}
+
+
+/**
+ * Check a frame is decoded once the next break arrives.
+ */
+void DMXSignalProcessorTest::testFrame() {
+  const unsigned int sample_rate = 4000000;
+  DMXSignalProcessor processor(NewFrameCallback(), sample_rate);
+
+  const string frame("\x00\x01\x7f\x80\xff\x55\xaa", 7);
+  vector<uint8_t> samples = BuildFrame(frame, sample_rate);
+  processor.Process(&samples[0], samples.size());
+  OLA_ASSERT_TRUE(m_frames.empty());
+
+  vector<uint8_t> next = BuildFrame(string("\x00", 1), sample_rate);
+  processor.Process(&next[0], next.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_EQ(frame, m_frames[0]);
+}
+
+
+/**
+ * Check decoding at different sample rates and bit times within the limits
+ * from E1.11.
+ */
+void DMXSignalProcessorTest::testSampleRates() {
+  const unsigned int sample_rates[] = {1000000, 4000000, 24000000};
+  const double bit_times[] = {3.92, 4.0, 4.08};
+  const string frame("\xcc\x01\x02\x03\x04\xfe", 6);
+
+  for (unsigned int i = 0; i < sizeof(sample_rates) / sizeof(unsigned int);
+       i++) {
+    for (unsigned int j = 0; j < sizeof(bit_times) / sizeof(double); j++) {
+      m_frames.clear();
+      DMXSignalProcessor processor(NewFrameCallback(), sample_rates[i]);
+      vector<uint8_t> samples;
+      AddLevel(&samples, true, 20, sample_rates[i]);
+      AddLevel(&samples, false, 100, sample_rates[i]);
+      AddLevel(&samples, true, 12, sample_rates[i]);
+      for (unsigned int k = 0; k < frame.size(); k++) {
+        AddSlot(&samples, frame[k], sample_rates[i], bit_times[j]);
+      }
+      AddLevel(&samples, false, 100, sample_rates[i]);
+      AddLevel(&samples, true, 12, sample_rates[i]);
+      processor.Process(&samples[0], samples.size());
+      OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+      OLA_ASSERT_EQ(frame, m_frames[0]);
+    }
+  }
+}
+
+
+/**
+ * Check that runs can span calls to Process().
+ */
+void DMXSignalProcessorTest::testSplitBuffers() {
+  const unsigned int sample_rate = 24000000;
+  const string frame("\x00\x10\x20\x30", 4);
+  vector<uint8_t> samples = BuildFrame(frame, sample_rate, 10);
+  vector<uint8_t> next = BuildFrame(string("\x00", 1), sample_rate);
+  samples.insert(samples.end(), next.begin(), next.end());
+
+  const unsigned int chunk_sizes[] = {1, 3, 7, 8, 13, 64, 1000};
+  for (unsigned int i = 0; i < sizeof(chunk_sizes) / sizeof(unsigned int);
+       i++) {
+    m_frames.clear();
+    DMXSignalProcessor processor(NewFrameCallback(), sample_rate);
+    for (unsigned int offset = 0; offset < samples.size();
+         offset += chunk_sizes[i]) {
+      unsigned int size = std::min(
+          chunk_sizes[i], static_cast<unsigned int>(samples.size()) - offset);
+      processor.Process(&samples[offset], size);
+    }
+    OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+    OLA_ASSERT_EQ(frame, m_frames[0]);
+  }
+}
+
+
+/**
+ * Check that only the masked bits are used.
+ */
+void DMXSignalProcessorTest::testMask() {
+  const unsigned int sample_rate = 4000000;
+  DMXSignalProcessor processor(NewFrameCallback(), sample_rate);
+
+  const string frame("\x00\x42", 2);
+  vector<uint8_t> samples = BuildFrame(frame, sample_rate);
+  vector<uint8_t> next = BuildFrame(string("\x00", 1), sample_rate);
+  samples.insert(samples.end(), next.begin(), next.end());
+  // Put noise on the other channels.
+  for (unsigned int i = 0; i < samples.size(); i++) {
+    samples[i] |= (i % 3) << 4;
+  }
+
+  processor.Process(&samples[0], samples.size(), 0x01);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_EQ(frame, m_frames[0]);
+}
+
+
+/**
+ * Check a long mark between slots ends the frame, without waiting for the
+ * next falling edge.
+ */
+void DMXSignalProcessorTest::testMarkBetweenSlots() {
+  const unsigned int sample_rate = 1000000;
+  DMXSignalProcessor processor(NewFrameCallback(), sample_rate);
+
+  const string frame("\x00\x01\x02", 3);
+  vector<uint8_t> samples = BuildFrame(frame, sample_rate, 50);
+  processor.Process(&samples[0], samples.size());
+  OLA_ASSERT_TRUE(m_frames.empty());
+
+  vector<uint8_t> mark(sample_rate / 2, 1);
+  processor.Process(&mark[0], mark.size());
+  OLA_ASSERT_TRUE(m_frames.empty());
+  processor.Process(&mark[0], mark.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_EQ(frame, m_frames[0]);
+}
+
+
+/**
+ * Check a break that's too short is ignored.
+ */
+void DMXSignalProcessorTest::testShortBreak() {
+  const unsigned int sample_rate = 4000000;
+  DMXSignalProcessor processor(NewFrameCallback(), sample_rate);
+
+  vector<uint8_t> samples;
+  AddLevel(&samples, true, 20, sample_rate);
+  AddLevel(&samples, false, 50, sample_rate);
+  AddLevel(&samples, true, 12, sample_rate);
+  AddSlot(&samples, 0, sample_rate);
+  AddSlot(&samples, 1, sample_rate);
+  vector<uint8_t> next = BuildFrame(string("\x00", 1), sample_rate);
+  samples.insert(samples.end(), next.begin(), next.end());
+
+  processor.Process(&samples[0], samples.size());
+  OLA_ASSERT_TRUE(m_frames.empty());
+}
+
+
+/**
+ * Check a low stop bit ends the frame.
+ */
+void DMXSignalProcessorTest::testBadStopBit() {
+  const unsigned int sample_rate = 4000000;
+  DMXSignalProcessor processor(NewFrameCallback(), sample_rate);
+
+  vector<uint8_t> samples = BuildFrame(string("\x00\x05", 2), sample_rate);
+  // A slot with a low stop bit.
+  AddLevel(&samples, false, 4, sample_rate);
+  AddLevel(&samples, true, 32, sample_rate);
+  AddLevel(&samples, false, 8, sample_rate);
+  AddLevel(&samples, true, 20, sample_rate);
+
+  processor.Process(&samples[0], samples.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_EQ(string("\x00\x05", 2), m_frames[0]);
+}
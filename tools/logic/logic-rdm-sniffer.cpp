@@ -48,6 +48,8 @@
 #include <ola/rdm/RDMResponseCodes.h>
 #include <ola/rdm/UID.h>
 #include <ola/StringUtils.h>
+#include <ola/thread/ExecutorThread.h>
+#include <ola/thread/Thread.h>
 
 #include <iostream>
 #include <fstream>
@@ -74,6 +76,7 @@ using ola::rdm::UID;
 using ola::strings::ToHex;
 
 
+using ola::thread::ExecutorThread;
 using ola::thread::Mutex;
 using ola::thread::MutexLocker;
 using ola::NewSingleCallback;
@@ -104,11 +107,13 @@ class LogicReader {
         m_device_id(0),
         m_logic(NULL),
         m_ss(ss),
+        m_decoder_thread(ola::thread::Thread::Options("logic-decoder")),
         m_signal_processor(ola::NewCallback(this, &LogicReader::FrameReceived),
                            sample_rate),
         m_pid_helper(FLAGS_pid_location.str(), 4),
         m_command_printer(&cout, &m_pid_helper) {
       m_pid_helper.Init();
+      m_decoder_thread.Start();
     }
     ~LogicReader();
 
@@ -130,6 +135,9 @@ class LogicReader {
     LogicInterface *m_logic;  // GUARDED_BY(m_mu);
     mutable Mutex m_mu;
     SelectServer *m_ss;
+    // Samples are decoded, and the frames displayed, in this thread so the
+    // capture callback doesn't block.
+    ExecutorThread m_decoder_thread;
     DMXSignalProcessor m_signal_processor;
     PidStoreHelper m_pid_helper;
     CommandPrinter m_command_printer;
@@ -203,7 +211,7 @@ void LogicReader::DataReceived(U64 device, U8 *data, uint32_t data_length) {
       return;
     }
   }
-  m_ss->Execute(
+  m_decoder_thread.Execute(
       NewSingleCallback(this, &LogicReader::ProcessData, data, data_length));
 
   {
@@ -236,15 +244,19 @@ void LogicReader::FrameReceived(const uint8_t *data, unsigned int length) {
 
 
 void LogicReader::Stop() {
-  MutexLocker lock(&m_mu);
-  if (m_logic) {
-    m_logic->Stop();
+  {
+    MutexLocker lock(&m_mu);
+    if (m_logic) {
+      m_logic->Stop();
+    }
   }
+  // Decodes any remaining samples.
+  m_decoder_thread.Stop();
 }
 
 
 /**
- * Called in the main thread.
+ * Called in the decoder thread.
  * @param data pointer to the data, ownership is transferred, use
  *   DeleteU8ArrayPtr to free.
  * @param data_length the size of the data
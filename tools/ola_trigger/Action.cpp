@@ -213,6 +213,9 @@ std::ostream& operator<<(std::ostream &out, const ValueInterval &i) {
 }
 
 
+const uint16_t Slot::NO_ACTION;
+
+
 /**
  * @brief Cleanup
  */
@@ -247,6 +250,7 @@ bool Slot::AddAction(const ValueInterval &interval_arg,
       new ValueInterval(interval_arg),
       rising_action,
       falling_action);
+  m_action_table_valid = false;
 
   if (m_actions.empty()) {
     m_actions.push_back(action_interval);
@@ -395,17 +399,6 @@ string Slot::IntervalsAsString() const {
 }
 
 
-/**
- * @brief Given two interval iterators, first and last, return true if the value is
- *   contained within the lower and upper bounds of the intervals.
- */
-bool Slot::ValueWithinIntervals(uint8_t value,
-                                const ValueInterval &lower_interval,
-                                const ValueInterval &upper_interval) {
-  return lower_interval.Lower() <= value && value <= upper_interval.Upper();
-}
-
-
 /**
  * @brief Check if two ValueIntervals intersect.
  */
@@ -426,53 +419,33 @@ bool Slot::IntervalsIntersect(const ValueInterval *a1,
  * @returns the Action matching the value,  or NULL if there isn't one.
  */
 Action *Slot::LocateMatchingAction(uint8_t value, bool rising) {
-  if (m_actions.empty()) {
-    return NULL;
+  if (!m_action_table_valid) {
+    BuildActionTable();
   }
 
-  ActionVector::iterator lower = m_actions.begin();
-  ActionVector::iterator upper = m_actions.end();
-  upper--;
-  if (!ValueWithinIntervals(value, *(lower->interval), *(upper->interval))) {
+  const uint16_t index = m_action_table[value];
+  if (index == NO_ACTION) {
     return NULL;
   }
+  const ActionInterval &action_interval = m_actions[index];
+  return rising ? action_interval.rising_action :
+                  action_interval.falling_action;
+}
 
-  // ok, we know the value lies between the intervals we have, first exclude
-  // the endpoints
-  if (lower->interval->Contains(value)) {
-    return rising ? lower->rising_action : lower->falling_action;
-  }
-
-  if (upper->interval->Contains(value)) {
-    return rising ? upper->rising_action : upper->falling_action;
-  }
-
-  // value isn't at the lower or upper interval, but lies somewhere between
-  // the two.
-  // @pre lower != upper
-  // @pre !lower.Contains(value) && !upper.Contains(value)
-  while (true) {
-    unsigned int difference = upper - lower;
-    ActionVector::iterator mid = lower + difference / 2;
-
-    if (mid == lower) {
-      // lower doesn't contain the value, so we don't have it
-      return NULL;
-    }
 
-    if (mid->interval->Contains(value)) {
-      return rising ? mid->rising_action : mid->falling_action;
-    } else if (value <= mid->interval->Lower()) {
-      upper = mid;
-    } else if (value >= mid->interval->Upper()) {
-      lower = mid;
-    } else {
-      OLA_WARN << "Inconsistent intervals detected when looking for: "
-               << static_cast<int>(value) << ", intervals: "
-               << IntervalsAsString(lower, upper);
-      return NULL;
+/**
+ * @brief Build the table which maps values to intervals.
+ */
+void Slot::BuildActionTable() {
+  std::fill(m_action_table, m_action_table + ACTION_TABLE_SIZE, NO_ACTION);
+  for (unsigned int i = 0; i < m_actions.size(); i++) {
+    const ValueInterval *interval = m_actions[i].interval;
+    for (unsigned int value = interval->Lower(); value <= interval->Upper();
+         value++) {
+      m_action_table[value] = i;
     }
   }
+  m_action_table_valid = true;
 }
 
 
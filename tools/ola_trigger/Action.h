@@ -148,7 +148,8 @@ class Slot {
       m_default_falling_action(NULL),
       m_slot_offset(slot_offset),
       m_old_value(0),
-      m_old_value_defined(false) {
+      m_old_value_defined(false),
+      m_action_table_valid(false) {
   }
   ~Slot();
 
@@ -243,9 +244,15 @@ class Slot {
   typedef std::vector<ActionInterval> ActionVector;
   ActionVector m_actions;
 
-  bool ValueWithinIntervals(uint8_t value,
-                            const ValueInterval &lower_interval,
-                            const ValueInterval &upper_interval);
+  static const unsigned int ACTION_TABLE_SIZE = 256;
+  static const uint16_t NO_ACTION = 0xffff;
+
+  // Maps each slot value to an index in m_actions, this is rebuilt the next
+  // time it's used after an interval is added.
+  uint16_t m_action_table[ACTION_TABLE_SIZE];
+  bool m_action_table_valid;
+
+  void BuildActionTable();
   bool IntervalsIntersect(const ValueInterval *a1,
                           const ValueInterval *a2);
   Action *LocateMatchingAction(uint8_t value, bool rising);
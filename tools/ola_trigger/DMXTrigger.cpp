@@ -19,6 +19,7 @@
 
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
+#include <string.h>
 #include <algorithm>
 #include <vector>
 
@@ -26,6 +27,13 @@
 
 using ola::DmxBuffer;
 
+namespace {
+
+bool SlotOffsetLessThan(const Slot *a, const Slot *b) {
+  return a->SlotOffset() < b->SlotOffset();
+}
+}  // namespace
+
 
 /**
  * @brief Create a new trigger
@@ -34,7 +42,7 @@ DMXTrigger::DMXTrigger(Context *context,
                        const SlotVector &actions)
     : m_context(context),
       m_slots(actions) {
-  sort(m_slots.begin(), m_slots.end());
+  sort(m_slots.begin(), m_slots.end(), SlotOffsetLessThan);
 }
 
 
@@ -42,13 +50,28 @@ DMXTrigger::DMXTrigger(Context *context,
  * @brief Called when new DMX arrives.
  */
 void DMXTrigger::NewDMX(const DmxBuffer &data) {
+  const unsigned int size = data.Size();
+  const unsigned int last_size = m_last_frame.Size();
+  const uint8_t *new_data = data.GetRaw();
+  const uint8_t *old_data = m_last_frame.GetRaw();
+
+  if (size == last_size && (size == 0 || !memcmp(new_data, old_data, size))) {
+    // nothing has changed
+    return;
+  }
+
   SlotVector::iterator iter = m_slots.begin();
   for (; iter != m_slots.end(); iter++) {
     uint16_t slot_number = (*iter)->SlotOffset();
-    if (slot_number >= data.Size()) {
+    if (slot_number >= size) {
       // the DMX frame was too small
       break;
     }
-    (*iter)->TakeAction(m_context, data.Get(slot_number));
+    if (slot_number < last_size &&
+        new_data[slot_number] == old_data[slot_number]) {
+      continue;
+    }
+    (*iter)->TakeAction(m_context, new_data[slot_number]);
   }
+  m_last_frame.Set(data);
 }
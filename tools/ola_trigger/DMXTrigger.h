@@ -28,6 +28,9 @@
 
 /*
  * @brief The class which manages the triggering.
+ *
+ * Each frame is compared to the previous one, and only the slots which have
+ * changed are evaluated.
  */
 class DMXTrigger {
  public:
@@ -40,6 +43,7 @@ class DMXTrigger {
 
  private:
   Context *m_context;
-  SlotVector m_slots;  // kept sorted
+  SlotVector m_slots;  // kept sorted by slot offset
+  ola::DmxBuffer m_last_frame;
 };
 #endif  // TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
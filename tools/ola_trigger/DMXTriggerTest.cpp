@@ -37,11 +37,13 @@ class DMXTriggerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DMXTriggerTest);
   CPPUNIT_TEST(testRisingEdgeTrigger);
   CPPUNIT_TEST(testFallingEdgeTrigger);
+  CPPUNIT_TEST(testMultipleSlots);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testRisingEdgeTrigger();
   void testFallingEdgeTrigger();
+  void testMultipleSlots();
 
   void setUp() {
     ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
@@ -159,3 +161,46 @@ void DMXTriggerTest::testFallingEdgeTrigger() {
   rising_action->CheckForValue(OLA_SOURCELINE(), 20);
   OLA_ASSERT(falling_action->NoCalls());
 }
+
+
+/**
+ * Check only the slots which changed are evaluated, regardless of the order
+ * the slots were passed in.
+ */
+void DMXTriggerTest::testMultipleSlots() {
+  vector<Slot*> slots;
+  Slot slot1(5);
+  MockAction *action1 = new MockAction();
+  slot1.SetDefaultRisingAction(action1);
+  slots.push_back(&slot1);
+
+  Slot slot2(1);
+  MockAction *action2 = new MockAction();
+  slot2.SetDefaultRisingAction(action2);
+  slots.push_back(&slot2);
+
+  Context context;
+  DMXTrigger trigger(&context, slots);
+  DmxBuffer buffer;
+
+  // slot 5 is beyond the end of the frame
+  buffer.SetFromString("0,1,0");
+  trigger.NewDMX(buffer);
+  action2->CheckForValue(OLA_SOURCELINE(), 1);
+  OLA_ASSERT(action1->NoCalls());
+
+  buffer.SetFromString("0,1,0,0,0,2");
+  trigger.NewDMX(buffer);
+  OLA_ASSERT(action2->NoCalls());
+  action1->CheckForValue(OLA_SOURCELINE(), 2);
+
+  buffer.SetFromString("9,2,9,9,9,2");
+  trigger.NewDMX(buffer);
+  action2->CheckForValue(OLA_SOURCELINE(), 2);
+  OLA_ASSERT(action1->NoCalls());
+
+  buffer.SetFromString("9,2,9,9,9,3");
+  trigger.NewDMX(buffer);
+  OLA_ASSERT(action2->NoCalls());
+  action1->CheckForValue(OLA_SOURCELINE(), 3);
+}
@@ -29,6 +29,7 @@
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/OlaCallbackClient.h>
+#include <ola/StringUtils.h>
 #include <ola/OlaClientWrapper.h>
 #include <ola/base/Flags.h>
 #include <ola/base/Init.h>
@@ -56,12 +57,18 @@ using std::vector;
 DEFINE_s_uint16(offset, o, 0,
                 "Apply an offset to the slot numbers. Valid offsets are 0 to "
                 "512, default is 0.");
-DEFINE_s_uint32(universe, u, 0, "The universe to use, defaults to 0.");
+DEFINE_s_string(universe, u, "0",
+                "A comma separated list of universes to use, defaults to 0. "
+                "Each universe has its own copy of the config.");
 DEFINE_default_bool(validate, false,
                     "Validate the config file, rather than running it.");
 
 // prototype of bison-generated parser function
 int yyparse();
+// used to parse the config more than once, defined in lex.yy.cpp
+void yyrestart(FILE *input_file);
+extern int yylineno;
+extern int column;
 
 // globals modified by the config parser
 Context *global_context;
@@ -71,6 +78,7 @@ SlotActionMap global_slots;
 ola::io::SelectServer *ss = NULL;
 
 typedef vector<Slot*> SlotList;
+typedef map<unsigned int, DMXTrigger*> TriggerMap;
 
 #ifndef _WIN32
 /*
@@ -117,14 +125,17 @@ bool InstallSignals() {
 
 
 /**
- * @brief The DMX Handler, this calls the trigger if the universes match.
+ * @brief The DMX Handler, this calls the trigger for the universe.
  */
-void NewDmx(unsigned int our_universe,
-            DMXTrigger *trigger,
+void NewDmx(const TriggerMap *triggers,
             unsigned int universe,
             const DmxBuffer &data,
-            OLA_UNUSED const string &error) {
-  if (universe == our_universe && error.empty()) {
+            const string &error) {
+  if (!error.empty()) {
+    return;
+  }
+  DMXTrigger *trigger = ola::STLFindOrNull(*triggers, universe);
+  if (trigger) {
     trigger->NewDMX(data);
   }
 }
@@ -162,6 +173,31 @@ bool ApplyOffset(uint16_t offset, SlotList *all_slots) {
 }
 
 
+/**
+ * @brief Parse the config file, this populates global_context and
+ * global_slots.
+ */
+void ParseConfig(const string &config_file, bool reparse) {
+  // open the config file
+  if (freopen(config_file.c_str(), "r", stdin) == NULL) {
+    OLA_FATAL << "File " << config_file << " cannot be opened.\n";
+    exit(ola::EXIT_DATAERR);
+  }
+
+  if (reparse) {
+    yyrestart(stdin);
+    yylineno = 1;
+    column = 0;
+  }
+
+  // setup the default context
+  global_context = new Context();
+  yyparse();
+  global_context->SetConfigFile(config_file);
+  global_context->SetOverallOffset(FLAGS_offset);
+}
+
+
 /*
  * @brief Main
  */
@@ -180,31 +216,31 @@ int main(int argc, char *argv[]) {
     ola::DisplayUsageAndExit();
   }
 
-  string config_file = argv[1];
-
-  // setup the default context
-  global_context = new Context();
-  OLA_INFO << "Loading config from " << config_file;
-
-  // open the config file
-  if (freopen(config_file.c_str(), "r", stdin) == NULL) {
-    OLA_FATAL << "File " << config_file << " cannot be opened.\n";
-    exit(ola::EXIT_DATAERR);
+  vector<unsigned int> universes;
+  vector<string> universe_strs;
+  ola::StringSplit(FLAGS_universe.str(), &universe_strs, ",");
+  vector<string>::const_iterator str_iter = universe_strs.begin();
+  for (; str_iter != universe_strs.end(); ++str_iter) {
+    unsigned int universe;
+    if (!ola::StringToInt(*str_iter, &universe)) {
+      std::cerr << "Invalid universe: " << *str_iter << std::endl;
+      exit(ola::EXIT_USAGE);
+    }
+    universes.push_back(universe);
   }
-
-  yyparse();
-
-  // set the core context stuff up
-  if (global_context) {
-    global_context->SetConfigFile(config_file);
-    global_context->SetOverallOffset(FLAGS_offset);
-    global_context->SetUniverse(FLAGS_universe);
+  if (universes.empty()) {
+    ola::DisplayUsageAndExit();
   }
 
+  string config_file = argv[1];
+  OLA_INFO << "Loading config from " << config_file;
+  ParseConfig(config_file, false);
+
   if (FLAGS_validate) {
     std::cout << "File " << config_file << " is valid." << std::endl;
     // TODO(Peter): Print some stats here, validate the offset if supplied
     STLDeleteValues(&global_slots);
+    delete global_context;
     exit(ola::EXIT_OK);
   }
 
@@ -222,24 +258,50 @@ int main(int argc, char *argv[]) {
     exit(ola::EXIT_OSERR);
   }
 
-  // create the vector of Slot
+  // Each universe has its own Slots & Context, since they hold the state of
+  // the previous values.
+  vector<Context*> contexts;
   SlotList slots;
-  if (ApplyOffset(FLAGS_offset, &slots)) {
-    // setup the trigger
-    DMXTrigger trigger(global_context, slots);
+  TriggerMap triggers;
+  bool ok = true;
+  vector<unsigned int>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    if (iter != universes.begin()) {
+      ParseConfig(config_file, true);
+    }
+    global_context->SetUniverse(*iter);
+    contexts.push_back(global_context);
 
+    SlotList universe_slots;
+    if (!ApplyOffset(FLAGS_offset, &universe_slots)) {
+      ok = false;
+      break;
+    }
+    slots.insert(slots.end(), universe_slots.begin(), universe_slots.end());
+
+    DMXTrigger *trigger = new DMXTrigger(global_context, universe_slots);
+    if (!ola::STLInsertIfNotPresent(&triggers, *iter, trigger)) {
+      OLA_WARN << "Universe " << *iter << " was listed more than once";
+      delete trigger;
+    }
+  }
+
+  if (ok) {
     // register for DMX
     ola::OlaCallbackClient *client = wrapper.GetClient();
-    client->SetDmxCallback(
-        ola::NewCallback(&NewDmx,
-                         static_cast<unsigned int>(FLAGS_universe),
-                         &trigger));
-    client->RegisterUniverse(FLAGS_universe, ola::REGISTER, NULL);
+    const TriggerMap *trigger_map = &triggers;
+    client->SetDmxCallback(ola::NewCallback(&NewDmx, trigger_map));
+    TriggerMap::const_iterator trigger_iter = triggers.begin();
+    for (; trigger_iter != triggers.end(); ++trigger_iter) {
+      client->RegisterUniverse(trigger_iter->first, ola::REGISTER, NULL);
+    }
 
     // start the client
     wrapper.GetSelectServer()->Run();
   }
 
   // cleanup
+  STLDeleteValues(&triggers);
   STLDeleteElements(&slots);
+  STLDeleteElements(&contexts);
 }
@@ -718,12 +718,14 @@ class ResponderTestFixture(TestFixture):
                   include_frames=True)
 
   def _RecordFrameTiming(self, response, override_type=None):
+    # DUB responses don't have a PID, so they aren't added to the histograms.
+    pid = None if override_type is not None else response.pid
     for frame in response.frames:
       frame_type = override_type
       if not frame_type:
         frame_type = TimingStats.FrameTypeFromCommandClass(
             response.command_class)
-      self._timing_stats.RecordFrame(frame_type, frame)
+      self._timing_stats.RecordFrame(frame_type, frame, pid)
 
   def _LogFrameTiming(self, response):
     for frame in response.frames:
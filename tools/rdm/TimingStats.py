@@ -15,6 +15,7 @@
 # TimingStats.py
 # Copyright (C) 2015 Simon Newton
 
+import bisect
 import logging
 import numpy
 from ola.OlaClient import OlaClient
@@ -77,6 +78,30 @@ class FrameTypeStats(object):
     }
 
 
+class ResponseTimeHistogram(object):
+  """A histogram of the response times for a PID.
+
+  The buckets are in microseconds. The last bucket holds the responses slower
+  than the largest bound.
+  """
+  BUCKET_BOUNDS = [500, 1000, 2000, 2800, 5000, 10000, 20000]
+
+  def __init__(self):
+    self._counts = [0] * (len(self.BUCKET_BOUNDS) + 1)
+
+  def Record(self, response_time):
+    self._counts[bisect.bisect_left(self.BUCKET_BOUNDS, response_time)] += 1
+
+  def Count(self):
+    return sum(self._counts)
+
+  def Buckets(self):
+    """Return a list of (label, count) tuples, one for each bucket."""
+    labels = ['<= %dus' % bound for bound in self.BUCKET_BOUNDS]
+    labels.append('> %dus' % self.BUCKET_BOUNDS[-1])
+    return zip(labels, self._counts)
+
+
 class TimingStats(object):
   """Holds the timing stats for all frame types."""
   GET, SET, DISCOVERY, DUB = range(4)
@@ -86,17 +111,27 @@ class TimingStats(object):
     frame_types = [self.GET, self.SET, self.DISCOVERY, self.DUB]
     for frame_type in frame_types:
       self._stats_by_type[frame_type] = FrameTypeStats()
+    self._histograms_by_pid = {}
 
   def GetStatsForType(self, frame_type):
     return self._stats_by_type.get(frame_type)
 
-  def RecordFrame(self, frame_type, frame):
+  def GetHistogramsByPid(self):
+    """Return a dict of PID value to ResponseTimeHistogram."""
+    return self._histograms_by_pid
+
+  def RecordFrame(self, frame_type, frame, pid=None):
     stats = self._stats_by_type.get(frame_type)
     if stats:
       stats.RecordFrame(frame)
     else:
       logging.error('Unknown frame type %s' % frame_type)
 
+    if pid is not None and frame.response_delay:
+      histogram = self._histograms_by_pid.setdefault(pid,
+                                                     ResponseTimeHistogram())
+      histogram.Record(frame.response_delay / 1000.0)
+
   @staticmethod
   def FrameTypeFromCommandClass(command_class):
     types = {
@@ -21,6 +21,7 @@ from ola.testing.rdm.DMXSender import DMXSender
 from ola.testing.rdm.TestState import TestState
 import datetime
 import logging
+import multiprocessing
 import re
 import sys
 import textwrap
@@ -38,7 +39,7 @@ __author__ = 'nomis52@gmail.com (Simon Newton)'
 
 
 def ParseOptions():
-  usage = 'Usage: %prog [options] <uid>'
+  usage = 'Usage: %prog [options] <uid>[@universe] [<uid>[@universe] ...]'
   description = textwrap.dedent("""\
     Run a series of tests on a RDM responder to check the behaviour.
     This requires the OLA server to be running, and the RDM device to have been
@@ -47,6 +48,11 @@ def ParseOptions():
     the start address, device label etc. will be changed for all devices
     connected to the responder. Think twice about running this on your
     production lighting rig.
+
+    If more than one UID is given, the responders on different universes are
+    tested in parallel. Responders on the same universe are tested one after
+    the other, since the broadcast SET commands affect every device on the
+    universe.
   """)
   parser = OptionParser(usage, description=description)
   parser.add_option('-c', '--slot-count', default=10,
@@ -57,6 +63,9 @@ def ParseOptions():
   parser.add_option('-f', '--dmx-frame-rate', default=0,
                     type='int',
                     help='Send DMX frames at this rate in the background.')
+  parser.add_option('-j', '--jobs', default=0, type='int',
+                    help='The number of universes to test in parallel, '
+                         'defaults to all of them.')
   parser.add_option('-l', '--log', metavar='FILE',
                     help='Also log to the file named FILE.uid.timestamp.')
   parser.add_option('--list-tests', action='store_true',
@@ -94,13 +103,24 @@ def ParseOptions():
     parser.print_help()
     sys.exit(2)
 
-  uid = UID.FromString(args[0])
-  if uid is None:
-    parser.print_usage()
-    print 'Invalid UID: %s' % args[0]
-    sys.exit(2)
-
-  options.uid = uid
+  options.targets = []
+  for arg in args:
+    uid_str, _, universe_str = arg.partition('@')
+    uid = UID.FromString(uid_str)
+    if uid is None:
+      parser.print_usage()
+      print 'Invalid UID: %s' % uid_str
+      sys.exit(2)
+
+    universe = options.universe
+    if universe_str:
+      try:
+        universe = int(universe_str)
+      except ValueError:
+        parser.print_usage()
+        print 'Invalid universe: %s' % universe_str
+        sys.exit(2)
+    options.targets.append((universe, uid))
   return options
 
 
@@ -123,13 +143,31 @@ def SetupLogging(options):
       level=level,
       format='%(message)s')
 
-  if options.log:
-    file_name = '%s.%s.%d' % (options.log, options.uid, time.time())
-    file_handler = logging.FileHandler(file_name, 'w')
-    file_handler.addFilter(MyFilter())
-    if options.debug:
-      file_handler.setLevel(logging.DEBUG)
-    logging.getLogger('').addHandler(file_handler)
+
+def AddFileLogging(options, uid):
+  """Log the results for a UID to a file, if requested.
+
+  Returns:
+    The new handler, or None if no file was requested.
+  """
+  if not options.log:
+    return None
+
+  file_name = '%s.%s.%d' % (options.log, uid, time.time())
+  file_handler = logging.FileHandler(file_name, 'w')
+  file_handler.addFilter(MyFilter())
+  if options.debug:
+    file_handler.setLevel(logging.DEBUG)
+  logging.getLogger('').addHandler(file_handler)
+  return file_handler
+
+
+def SetConsolePrefix(prefix):
+  """Prefix each console message, so parallel runs can be told apart."""
+  formatter = logging.Formatter(prefix + '%(message)s')
+  for handler in logging.getLogger('').handlers:
+    if not isinstance(handler, logging.FileHandler):
+      handler.setFormatter(formatter)
 
 
 def LogTimingParam(parameter, data):
@@ -167,7 +205,28 @@ def DisplayTiming(timing_stats):
   LogAllTimingParams('DISCOVERY_UNIQUE_BRANCH', stats)
 
 
-def DisplaySummary(options, runner, tests, device):
+def DisplayPidHistograms(timing_stats, pid_store):
+  """Print the histogram of response times for each PID."""
+  histograms = timing_stats.GetHistogramsByPid()
+  if not histograms:
+    return
+
+  logging.info('----------- Response Time by PID ---------------')
+  for pid_value, histogram in sorted(histograms.iteritems()):
+    pid = pid_store.GetPid(pid_value)
+    name = pid.name if pid else '0x%04hx' % pid_value
+    logging.info('%s [%d frames]' % (name, histogram.Count()))
+    for label, count in histogram.Buckets():
+      if count:
+        logging.info('  %10s: %d' % (label, count))
+
+
+def DisplaySummary(options, uid, runner, tests, device, pid_store):
+  """Log a summary of the tests.
+
+  Returns:
+    A dict of TestState to the number of tests in that state.
+  """
   """Log a summary of the tests."""
   by_category = {}
   warnings = []
@@ -188,7 +247,7 @@ def DisplaySummary(options, runner, tests, device):
   logging.info('------------------- Summary --------------------')
   now = datetime.datetime.now()
   logging.info('Test Run: %s' % now.strftime('%F %r %z'))
-  logging.info('UID: %s' % options.uid)
+  logging.info('UID: %s' % uid)
 
   manufacturer_label = getattr(device, 'manufacturer_label', None)
   if manufacturer_label:
@@ -207,6 +266,7 @@ def DisplaySummary(options, runner, tests, device):
   if options.timing:
     timing_stats = runner.TimingStats()
     DisplayTiming(timing_stats)
+    DisplayPidHistograms(timing_stats, pid_store)
 
   logging.info('------------------- Warnings --------------------')
   for warning in sorted(warnings):
@@ -234,18 +294,34 @@ def DisplaySummary(options, runner, tests, device):
       count_by_state.get(TestState.PASSED, 0),
       count_by_state.get(TestState.FAILED, 0),
       count_by_state.get(TestState.BROKEN, 0)))
-
-
-def main():
-  options = ParseOptions()
-
-  test_classes = TestRunner.GetTestClasses(TestDefinitions)
-  if options.list_tests:
-    for test_name in sorted(c.__name__ for c in test_classes):
-      print test_name
-    sys.exit(0)
-
-  SetupLogging(options)
+  return count_by_state
+
+
+def RunTestsForUID(options, universe, uid, parallel=False):
+  """Run the tests against a single responder.
+
+  Args:
+    options: the command line options.
+    universe: the universe the responder is on.
+    uid: the UID of the responder.
+    parallel: true if other responders are being tested at the same time.
+
+  Returns:
+    A dict of TestState to the number of tests in that state, or None if the
+    tests weren't run.
+  """
+  if parallel:
+    SetConsolePrefix('%s: ' % uid)
+  file_handler = AddFileLogging(options, uid)
+  try:
+    return _RunTestsForUID(options, universe, uid, parallel)
+  finally:
+    if file_handler:
+      logging.getLogger('').removeHandler(file_handler)
+      file_handler.close()
+
+
+def _RunTestsForUID(options, universe, uid, parallel):
   logging.info('OLA Responder Tests Version %s' % Version.version)
   pid_store = PidStore.GetStore(options.pid_location,
                                 ('pids.proto', 'draft_pids.proto'))
@@ -261,34 +337,38 @@ def main():
       logging.error('Fetch failed: %s' % state.message)
       return
 
-    for uid in uids:
-      if uid == options.uid:
-        logging.debug('Found UID %s' % options.uid)
+    for found_uid in uids:
+      if found_uid == uid:
+        logging.debug('Found UID %s' % uid)
         uid_ok = True
 
     if not uid_ok:
-      logging.error('UID %s not found in universe %d' %
-                    (options.uid, options.universe))
+      logging.error('UID %s not found in universe %d' % (uid, universe))
       return
 
     if len(uids) > 1:
       logging.info(
           'The following devices were detected and will be reconfigured')
-      for uid in uids:
-        logging.info(' %s' % uid)
+      for found_uid in uids:
+        logging.info(' %s' % found_uid)
 
       if not options.skip_check:
+        if parallel:
+          # There is no terminal to prompt on when running in parallel.
+          logging.error('Multiple devices found, use -s to test anyway')
+          uid_ok = False
+          return
         logging.info('Continue ? [Y/n]')
         response = raw_input().strip().lower()
         uid_ok = response == 'y' or response == ''
 
   logging.debug('Fetching UID list from server')
-  wrapper.Client().FetchUIDList(options.universe, UIDList)
+  wrapper.Client().FetchUIDList(universe, UIDList)
   wrapper.Run()
   wrapper.Reset()
 
   if not uid_ok:
-    sys.exit()
+    return None
 
   test_filter = None
   if options.tests is not None:
@@ -298,28 +378,93 @@ def main():
   logging.info(
       'Starting tests, universe %d, UID %s, broadcast write delay %dms, '
       'inter-test delay %dms' %
-      (options.universe, options.uid, options.broadcast_write_delay,
+      (universe, uid, options.broadcast_write_delay,
        options.inter_test_delay))
 
-  runner = TestRunner.TestRunner(options.universe,
-                                 options.uid,
+  runner = TestRunner.TestRunner(universe,
+                                 uid,
                                  options.broadcast_write_delay,
                                  options.inter_test_delay,
                                  pid_store,
                                  wrapper,
                                  options.timestamp)
 
-  for test_class in test_classes:
+  for test_class in TestRunner.GetTestClasses(TestDefinitions):
     runner.RegisterTest(test_class)
 
   DMXSender(wrapper,
-            options.universe,
+            universe,
             options.dmx_frame_rate,
             options.slot_count)
 
   tests, device = runner.RunTests(test_filter, options.no_factory_defaults)
 
-  DisplaySummary(options, runner, tests, device)
+  return DisplaySummary(options, uid, runner, tests, device, pid_store)
+
+
+def RunUniverseTests(args):
+  """Test each responder on a universe in turn. This runs in a worker.
+
+  Returns:
+    A list of (uid, count_by_state) tuples.
+  """
+  options, universe, uids = args
+  results = []
+  for uid in uids:
+    results.append((uid, RunTestsForUID(options, universe, uid, True)))
+  return results
+
+
+def RunInParallel(options):
+  """Test the responders on each universe in parallel."""
+  uids_by_universe = {}
+  for universe, uid in options.targets:
+    uids_by_universe.setdefault(universe, []).append(uid)
+
+  jobs = options.jobs or len(uids_by_universe)
+  jobs = min(jobs, len(uids_by_universe))
+  logging.info('Testing %d responders on %d universes with %d jobs' %
+               (len(options.targets), len(uids_by_universe), jobs))
+
+  work = [(options, universe, uids)
+          for universe, uids in sorted(uids_by_universe.iteritems())]
+  pool = multiprocessing.Pool(jobs)
+  try:
+    results = pool.map(RunUniverseTests, work)
+  finally:
+    pool.close()
+    pool.join()
+
+  logging.info('---------------- Overall Summary ----------------')
+  for universe_results in results:
+    for uid, count_by_state in universe_results:
+      if count_by_state is None:
+        logging.info('%s: not tested' % uid)
+        continue
+      logging.info('%s: %d passed, %d failed, %d broken' % (
+          uid,
+          count_by_state.get(TestState.PASSED, 0),
+          count_by_state.get(TestState.FAILED, 0),
+          count_by_state.get(TestState.BROKEN, 0)))
+
+
+def main():
+  options = ParseOptions()
+
+  test_classes = TestRunner.GetTestClasses(TestDefinitions)
+  if options.list_tests:
+    for test_name in sorted(c.__name__ for c in test_classes):
+      print test_name
+    sys.exit(0)
+
+  SetupLogging(options)
+
+  if len(options.targets) == 1:
+    universe, uid = options.targets[0]
+    if RunTestsForUID(options, universe, uid) is None:
+      sys.exit()
+  else:
+    RunInParallel(options)
 
 
 if __name__ == '__main__':